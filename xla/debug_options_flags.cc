@@ -68,6 +68,10 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_dump_fusion_visualization(false);
   opts.set_xla_dump_include_timestamp(false);
   opts.set_xla_dump_max_hlo_modules(-1);
+  opts.set_xla_dump_async(false);
+  opts.set_xla_dump_module_sample_rate(1.0);
+  opts.set_xla_dump_max_bytes(-1);
+  opts.set_xla_dump_compress_text(false);
   opts.set_xla_dump_module_metadata(false);
   opts.set_xla_dump_hlo_as_long_text(false);
   opts.set_xla_dump_large_constants(false);
@@ -80,8 +84,12 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_cpu_use_acl(true);
 #endif
   opts.set_xla_cpu_use_thunk_runtime(false);
+  opts.set_xla_cpu_enable_work_stealing_thunk_executor(false);
   opts.set_xla_cpu_enable_concurrency_optimized_scheduler(false);
   opts.set_xla_cpu_prefer_vector_width(256);
+  opts.set_xla_cpu_parallel_codegen_split_count(1);
+  opts.set_xla_cpu_object_cache_dir("");
+  opts.set_xla_cpu_enable_async_all_reduce(false);
 
   opts.set_xla_cpu_enable_fast_math(false);
   // Disable forms of fast math that have caused users problems in the past.
@@ -263,6 +271,27 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_use_shardonnay(false);
 
   opts.set_xla_gpu_shard_autotuning(false);
+  opts.set_xla_gpu_multi_device_autotuning(false);
+  opts.set_xla_gpu_autotune_max_triton_gemm_configs(0);
+  opts.set_xla_gpu_autotune_verify_nearest_cached_config(false);
+  opts.set_xla_gpu_autotune_fallback_on_cache_miss(false);
+  opts.set_xla_gpu_enable_nccl_all_reduce_coalescing(false);
+  opts.set_xla_gpu_thunk_sampling_period(0);
+  opts.set_xla_gpu_thunk_sampling_buffer_size(1024);
+  opts.set_xla_gpu_enable_whole_program_capture(false);
+  opts.set_xla_gpu_enable_loop_fusion_reuse_tiling(false);
+  opts.set_xla_gpu_enable_scatter_determinism_expander(true);
+  opts.set_xla_gpu_enable_bf16_all_gather(false);
+  opts.set_xla_gpu_layout_search_max_candidates(0);
+  opts.set_xla_gpu_online_pgle_profiled_executions(0);
+  opts.set_xla_gpu_concurrent_fusion_streams(0);
+  opts.set_xla_gpu_enable_pipelined_host_offloading(false);
+  opts.set_xla_gpu_lhs_enable_rematerialization(false);
+  opts.set_xla_gpu_loop_linearization_min_bytes(0);
+  opts.set_xla_gpu_enable_all_to_all_stream(false);
+  opts.set_xla_gpu_host_prefetch_slice_count(1);
+  opts.set_xla_gpu_bidirectional_windowed_einsum(false);
+  opts.set_xla_gpu_enable_profile_guided_combine_threshold(false);
 
   opts.set_xla_gpu_per_fusion_autotune_cache_dir("");
 
@@ -789,11 +818,36 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       debug_options->xla_cpu_enable_concurrency_optimized_scheduler(),
       "Use HLO module scheduler that is optimized for extracting concurrency "
       "from an HLO module by trading off extra memory pressure."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_enable_work_stealing_thunk_executor",
+      bool_setter_for(
+          &DebugOptions::set_xla_cpu_enable_work_stealing_thunk_executor),
+      debug_options->xla_cpu_enable_work_stealing_thunk_executor(),
+      "Use a work-stealing task runner with per-worker LIFO queues to execute "
+      "ready thunks in the XLA:CPU thunk runtime."));
   flag_list->push_back(tsl::Flag(
       "xla_cpu_prefer_vector_width",
       int32_setter_for(&DebugOptions::set_xla_cpu_prefer_vector_width),
       debug_options->xla_cpu_prefer_vector_width(),
       "Preferred vector with for the XLA:CPU LLVM backend."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_parallel_codegen_split_count",
+      int32_setter_for(&DebugOptions::set_xla_cpu_parallel_codegen_split_count),
+      debug_options->xla_cpu_parallel_codegen_split_count(),
+      "Split LLVM module into at most this many parts before codegen and "
+      "compile them concurrently. Values <= 1 disable module splitting."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_object_cache_dir",
+      string_setter_for(&DebugOptions::set_xla_cpu_object_cache_dir),
+      debug_options->xla_cpu_object_cache_dir(),
+      "Directory for caching XLA:CPU compiled object files. Cache entries are "
+      "keyed by the emitted LLVM IR, target machine and debug options."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_enable_async_all_reduce",
+      bool_setter_for(&DebugOptions::set_xla_cpu_enable_async_all_reduce),
+      debug_options->xla_cpu_enable_async_all_reduce(),
+      "Run all-reduces asynchronously on a communication thread and schedule "
+      "independent compute to overlap them. Legacy XLA:CPU runtime only."));
   flag_list->push_back(tsl::Flag(
       "xla_gpu_crash_on_verification_failures",
       bool_setter_for(
@@ -952,6 +1006,30 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
                 bool_setter_for(&DebugOptions::set_xla_dump_compress_protos),
                 debug_options->xla_dump_compress_protos(),
                 "Gzip-compress protos dumped by --xla_dump_hlo_as_proto."));
+  flag_list->push_back(
+      tsl::Flag("xla_dump_async",
+                bool_setter_for(&DebugOptions::set_xla_dump_async),
+                debug_options->xla_dump_async(),
+                "Writes dump files on a background thread. Dumps that don't "
+                "fit into the queue of the writer are dropped."));
+  flag_list->push_back(tsl::Flag(
+      "xla_dump_module_sample_rate",
+      float_setter_for(&DebugOptions::set_xla_dump_module_sample_rate),
+      debug_options->xla_dump_module_sample_rate(),
+      "Fraction of HLO modules (selected by a hash of the module name) that "
+      "are dumped, on top of --xla_dump_hlo_module_re. Values <= 0 or >= 1 "
+      "dump all modules."));
+  flag_list->push_back(
+      tsl::Flag("xla_dump_max_bytes",
+                int64_setter_for(&DebugOptions::set_xla_dump_max_bytes),
+                debug_options->xla_dump_max_bytes(),
+                "Max number of bytes (before compression) dumped to files by "
+                "the process. Set to <= 0 for unbounded."));
+  flag_list->push_back(
+      tsl::Flag("xla_dump_compress_text",
+                bool_setter_for(&DebugOptions::set_xla_dump_compress_text),
+                debug_options->xla_dump_compress_text(),
+                "Gzip-compress text files dumped to --xla_dump_to."));
   flag_list->push_back(tsl::Flag(
       "xla_hlo_graph_addresses",
       bool_setter_for(&DebugOptions::set_xla_hlo_graph_addresses),
@@ -1215,8 +1293,8 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
                 bool_setter_for(
                     &DebugOptions::set_xla_gpu_graph_enable_concurrent_region),
                 debug_options->xla_gpu_graph_enable_concurrent_region(),
-                "Identify concurrent regions in gpu graphs and execute them "
-                "concurrently."));
+                "Identify concurrent regions in gpu graphs from buffer uses of "
+                "recorded commands and execute them concurrently."));
 
   flag_list->push_back(
       tsl::Flag("xla_dump_disable_metadata",
@@ -1746,6 +1824,176 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       debug_options->xla_gpu_shard_autotuning(),
       "Shard autotuning between participating compiler processes (typically in "
       "multi-host setups) and join the results when it's done."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_multi_device_autotuning",
+      bool_setter_for(&DebugOptions::set_xla_gpu_multi_device_autotuning),
+      debug_options->xla_gpu_multi_device_autotuning(),
+      "Spread GEMM fusion autotuning measurements over all local GPUs of the "
+      "same model as the compilation device. Only enable this if the process "
+      "owns all of these GPUs."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_autotune_max_triton_gemm_configs",
+      int32_setter_for(
+          &DebugOptions::set_xla_gpu_autotune_max_triton_gemm_configs),
+      debug_options->xla_gpu_autotune_max_triton_gemm_configs(),
+      "If positive, rank the candidate Triton GEMM configs of each fusion "
+      "with an analytical cost model and only compile and profile that many "
+      "of the best ranked ones. 0 disables the pruning."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_autotune_verify_nearest_cached_config",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_autotune_verify_nearest_cached_config),
+      debug_options->xla_gpu_autotune_verify_nearest_cached_config(),
+      "On a GEMM fusion autotuning cache miss, look up the cached result of "
+      "the fusion that is equal up to constant values and dimension sizes "
+      "and has the nearest shapes, and only profile its config against the "
+      "default configs instead of running the full search."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_autotune_fallback_on_cache_miss",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_autotune_fallback_on_cache_miss),
+      debug_options->xla_gpu_autotune_fallback_on_cache_miss(),
+      "On a GEMM fusion autotuning cache miss, compile with the config "
+      "ranked fastest by the cost model instead of autotuning, and autotune "
+      "the fusion in the background so that later compilations use the "
+      "result. Combine with xla_gpu_per_fusion_autotune_cache_dir to keep "
+      "the results for the next process."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_nccl_all_reduce_coalescing",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_nccl_all_reduce_coalescing),
+      debug_options->xla_gpu_enable_nccl_all_reduce_coalescing(),
+      "Launch adjacent asynchronous all-reduces that share a stream and a "
+      "communicator as a single NCCL group."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_thunk_sampling_period",
+      int64_setter_for(&DebugOptions::set_xla_gpu_thunk_sampling_period),
+      debug_options->xla_gpu_thunk_sampling_period(),
+      "If positive, time every N-th thunk execution on device and keep the "
+      "most recent samples in the GPU executable. Sampled thunks wait for "
+      "their device work to complete. 0 disables sampling."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_thunk_sampling_buffer_size",
+      int64_setter_for(&DebugOptions::set_xla_gpu_thunk_sampling_buffer_size),
+      debug_options->xla_gpu_thunk_sampling_buffer_size(),
+      "Number of most recent thunk samples kept by a GPU executable."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_whole_program_capture",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_whole_program_capture),
+      debug_options->xla_gpu_enable_whole_program_capture(),
+      "Capture all thunks of a GPU executable into a single command buffer "
+      "after the first run and replay it while buffer addresses are stable. "
+      "Executables with host-dependent thunks (loops, conditionals, custom "
+      "calls, infeed/outfeed, host send/recv) always run thunk by thunk."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_performance_model_calibration_file",
+      string_setter_for(
+          &DebugOptions::set_xla_gpu_performance_model_calibration_file),
+      debug_options->xla_gpu_performance_model_calibration_file(),
+      "Path to a DevicePerformanceCalibrations text proto produced by "
+      "hlo_op_profiler_run. Measured memory bandwidth, kernel launch overhead, "
+      "coalescing penalty and op throughput override the defaults used by the "
+      "GPU performance model."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_collective_performance_profile_file",
+      string_setter_for(
+          &DebugOptions::set_xla_gpu_collective_performance_profile_file),
+      debug_options->xla_gpu_collective_performance_profile_file(),
+      "Path to a CollectivePerformanceProfile text proto with collective "
+      "times measured on the target cluster by message size and replica "
+      "group topology. Used by the analytical latency estimator."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_profile_guided_combine_threshold",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_profile_guided_combine_threshold),
+      debug_options->xla_gpu_enable_profile_guided_combine_threshold(),
+      "Lower collective combine thresholds to the largest message size that "
+      "still benefits from combining according to the collective performance "
+      "profile (see xla_gpu_collective_performance_profile_file)."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_loop_fusion_reuse_tiling",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_loop_fusion_reuse_tiling),
+      debug_options->xla_gpu_enable_loop_fusion_reuse_tiling(),
+      "Use symbolic tiling to pick the unroll factor of loop fusions with "
+      "non-scalar broadcasts, so that each thread reuses loaded broadcast "
+      "operands for several output elements."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_scatter_determinism_expander",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_scatter_determinism_expander),
+      debug_options->xla_gpu_enable_scatter_determinism_expander(),
+      "With deterministic ops, rewrite scatters with duplicate indices into a "
+      "sort, a segmented scan and a scatter with unique indices instead of a "
+      "sequential loop."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_bf16_all_gather",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_bf16_all_gather),
+      debug_options->xla_gpu_enable_bf16_all_gather(),
+      "Perform f32 all-gathers in bf16 to halve their communication volume. "
+      "The gathered values lose precision."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_layout_search_max_candidates",
+      int32_setter_for(
+          &DebugOptions::set_xla_gpu_layout_search_max_candidates),
+      debug_options->xla_gpu_layout_search_max_candidates(),
+      "If positive, search the layouts of up to this many dots, convolutions "
+      "and while loop state elements with a global cost model of "
+      "layout-changing copies and transposes. 0 disables the search."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_online_pgle_profiled_executions",
+      int32_setter_for(
+          &DebugOptions::set_xla_gpu_online_pgle_profiled_executions),
+      debug_options->xla_gpu_online_pgle_profiled_executions(),
+      "If positive, time every thunk of the first N executions of a GPU "
+      "executable to collect a profile for recompiling it with the profile "
+      "guided latency estimator. 0 disables online profiling."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_concurrent_fusion_streams",
+      int32_setter_for(&DebugOptions::set_xla_gpu_concurrent_fusion_streams),
+      debug_options->xla_gpu_concurrent_fusion_streams(),
+      "If positive, run independent chains of small fusions concurrently on "
+      "up to this many additional execution streams. 0 disables it."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_pipelined_host_offloading",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_pipelined_host_offloading),
+      debug_options->xla_gpu_enable_pipelined_host_offloading(),
+      "Transfer slices of host-offloaded loop invariant buffers to the device "
+      "one loop iteration ahead of their use."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_lhs_enable_rematerialization",
+      bool_setter_for(&DebugOptions::set_xla_gpu_lhs_enable_rematerialization),
+      debug_options->xla_gpu_lhs_enable_rematerialization(),
+      "Rematerialize cheap producers when the latency hiding schedule does "
+      "not fit in the memory limit, instead of only giving up overlap."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_loop_linearization_min_bytes",
+      int64_setter_for(&DebugOptions::set_xla_gpu_loop_linearization_min_bytes),
+      debug_options->xla_gpu_loop_linearization_min_bytes(),
+      "If positive, while loops with async collectives still order reads of "
+      "loop state elements of at least this many bytes before their update, "
+      "to avoid copying them on every iteration."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_all_to_all_stream",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_all_to_all_stream),
+      debug_options->xla_gpu_enable_all_to_all_stream(),
+      "Run async all-to-all operations on their own stream and communicator, "
+      "so that they can overlap with the other async collectives."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_host_prefetch_slice_count",
+      int64_setter_for(&DebugOptions::set_xla_gpu_host_prefetch_slice_count),
+      debug_options->xla_gpu_host_prefetch_slice_count(),
+      "If greater than 1, host to device copies of offloaded buffers are split "
+      "into this many async slices along their most major dimension."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_bidirectional_windowed_einsum",
+      bool_setter_for(&DebugOptions::set_xla_gpu_bidirectional_windowed_einsum),
+      debug_options->xla_gpu_bidirectional_windowed_einsum(),
+      "Send windowed einsum operands around the ring in both directions, "
+      "halving the number of loop iterations. Requires the number of "
+      "partitions to be a multiple of 4."));
   flag_list->push_back(
       tsl::Flag("xla_gpu_kernel_cache_file",
                 string_setter_for(&DebugOptions::set_xla_gpu_kernel_cache_file),
@@ -759,9 +759,31 @@ struct CtxDecoding;
 //     XLA_FFI_Error* Encode(const XLA_FFI_Api* api, absl::Status status) {...}
 //   }
 //
+// Encodings of results that are not available yet (i.e. asynchronous
+// completion events) can instead define an `Encode` overload that also takes
+// the execution context, to forward the result to the caller:
+//
+//     XLA_FFI_Error* Encode(const XLA_FFI_Api* api,
+//                           XLA_FFI_ExecutionContext* ctx, T result) {...}
+//
 template <typename T>
 struct ResultEncoding;
 
+namespace internal {
+
+// A type trait to detect if result encoding takes the execution context.
+template <typename T, typename = void>
+struct EncodesWithContext : std::false_type {};
+
+template <typename T>
+struct EncodesWithContext<
+    T, std::void_t<decltype(ResultEncoding<T>::Encode(
+           std::declval<const XLA_FFI_Api*>(),
+           std::declval<XLA_FFI_ExecutionContext*>(), std::declval<T>()))>>
+    : std::true_type {};
+
+}  // namespace internal
+
 //===----------------------------------------------------------------------===//
 // Diagnostics
 //===----------------------------------------------------------------------===//
@@ -1328,8 +1350,13 @@ class Handler : public Ffi {
     }
 
     auto result = fn_(std::move(*std::get<Is>(args))...);
-    return ResultEncoding<ResultType>::Encode(call_frame->api,
-                                              std::move(result));
+    if constexpr (internal::EncodesWithContext<ResultType>::value) {
+      return ResultEncoding<ResultType>::Encode(
+          call_frame->api, call_frame->ctx, std::move(result));
+    } else {
+      return ResultEncoding<ResultType>::Encode(call_frame->api,
+                                                std::move(result));
+    }
   }
 
   XLA_FFI_Error* FailedDecodeError(const XLA_FFI_CallFrame* call_frame,
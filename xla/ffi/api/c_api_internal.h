@@ -69,6 +69,18 @@ typedef void* XLA_FFI_INTERNAL_CalledComputation_Get(
 typedef void* XLA_FFI_INTERNAL_ExecutionContext_Get(
     XLA_FFI_ExecutionContext* ctx);
 
+// Returns a pointer to the `xla::ffi::ExecutionState` object of the FFI handler
+// instance, which allows to keep typed state between execution stages.
+typedef void* XLA_FFI_INTERNAL_ExecutionState_Get(
+    XLA_FFI_ExecutionContext* ctx);
+
+// Forwards `tsl::AsyncValueRef<tsl::Chain>` completion event pointed to by
+// `event` to the execution context (event left in moved-from state), so that
+// the caller of the FFI handler can wait for the asynchronous completion.
+// Pointer ownership stays with the caller.
+typedef XLA_FFI_Error* XLA_FFI_INTERNAL_Future_Forward(
+    XLA_FFI_ExecutionContext* ctx, void* event);
+
 //===----------------------------------------------------------------------===//
 // API access
 //===----------------------------------------------------------------------===//
@@ -83,6 +95,8 @@ struct XLA_FFI_InternalApi {
       XLA_FFI_INTERNAL_DeviceMemoryAllocator_Get);
   _XLA_FFI_INTERNAL_API_STRUCT_FIELD(XLA_FFI_INTERNAL_CalledComputation_Get);
   _XLA_FFI_INTERNAL_API_STRUCT_FIELD(XLA_FFI_INTERNAL_ExecutionContext_Get);
+  _XLA_FFI_INTERNAL_API_STRUCT_FIELD(XLA_FFI_INTERNAL_ExecutionState_Get);
+  _XLA_FFI_INTERNAL_API_STRUCT_FIELD(XLA_FFI_INTERNAL_Future_Forward);
 };
 
 #undef _XLA_FFI_INTERNAL_API_STRUCT_FIELD
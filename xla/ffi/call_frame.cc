@@ -28,12 +28,16 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xla/ffi/api/api.h"
 #include "xla/ffi/api/c_api.h"
 #include "xla/ffi/api/c_api_internal.h"  // IWYU pragma: keep
 #include "xla/stream_executor/device_memory.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla::ffi {
 
@@ -219,6 +223,26 @@ CallFrame::CallFrame(absl::Span<const CallFrameBuilder::Buffer> args,
       results_(InitRets(rets)),
       attributes_(InitAttrs(attrs)) {}
 
+CallFrame::CallFrame(std::unique_ptr<Arguments> arguments,
+                     std::unique_ptr<Results> results,
+                     std::shared_ptr<Attributes> attributes)
+    : arguments_(std::move(arguments)),
+      results_(std::move(results)),
+      attributes_(std::move(attributes)) {}
+
+CallFrame::CallFrame(CallFrame&&) = default;
+CallFrame& CallFrame::operator=(CallFrame&&) = default;
+
+absl::StatusOr<CallFrame> CallFrame::CopyWithBuffers(
+    absl::Span<const se::DeviceMemoryBase> args,
+    absl::Span<const se::DeviceMemoryBase> rets) const {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<Arguments> arguments,
+                      CopyArgs(*arguments_, args));
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<Results> results,
+                      CopyRets(*results_, rets));
+  return CallFrame(std::move(arguments), std::move(results), attributes_);
+}
+
 XLA_FFI_CallFrame CallFrame::Build(const XLA_FFI_Api* api,
                                    XLA_FFI_ExecutionContext* ctx,
                                    XLA_FFI_ExecutionStage stage) {
@@ -307,6 +331,35 @@ std::unique_ptr<CallFrame::Arguments> CallFrame::InitArgs(
   return res;
 }
 
+/*static*/ absl::StatusOr<std::unique_ptr<CallFrame::Arguments>>
+CallFrame::CopyArgs(const Arguments& args,
+                    absl::Span<const se::DeviceMemoryBase> memory) {
+  if (args.arguments.size() != memory.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Number of buffer arguments %d does not match the number of call frame "
+        "arguments %d",
+        memory.size(), args.arguments.size()));
+  }
+
+  auto res = std::make_unique<Arguments>(args.arguments.size());
+  res->arguments = args.arguments;
+  res->types = args.types;
+
+  // Update buffer pointers and fix up pointers in XLA FFI structs.
+  for (size_t i = 0; i < res->arguments.size(); ++i) {
+    CallFrame::Buffer& arg = res->arguments[i];
+    arg.buffer.data = const_cast<void*>(memory[i].opaque());
+    arg.buffer.dims = arg.dims.data();
+    res->args.push_back(&arg.buffer);
+  }
+
+  res->ffi_args.size = res->arguments.size();
+  res->ffi_args.types = res->types.data();
+  res->ffi_args.args = res->args.data();
+
+  return res;
+}
+
 //===----------------------------------------------------------------------===//
 // Call frame results
 //===----------------------------------------------------------------------===//
@@ -340,6 +393,35 @@ std::unique_ptr<CallFrame::Results> CallFrame::InitRets(
   return res;
 }
 
+/*static*/ absl::StatusOr<std::unique_ptr<CallFrame::Results>>
+CallFrame::CopyRets(const Results& rets,
+                    absl::Span<const se::DeviceMemoryBase> memory) {
+  if (rets.results.size() != memory.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Number of buffer results %d does not match the number of call frame "
+        "results %d",
+        memory.size(), rets.results.size()));
+  }
+
+  auto res = std::make_unique<Results>(rets.results.size());
+  res->results = rets.results;
+  res->types = rets.types;
+
+  // Update buffer pointers and fix up pointers in XLA FFI structs.
+  for (size_t i = 0; i < res->results.size(); ++i) {
+    CallFrame::Buffer& ret = res->results[i];
+    ret.buffer.data = const_cast<void*>(memory[i].opaque());
+    ret.buffer.dims = ret.dims.data();
+    res->rets.push_back(&ret.buffer);
+  }
+
+  res->ffi_rets.size = res->results.size();
+  res->ffi_rets.types = res->types.data();
+  res->ffi_rets.rets = res->rets.data();
+
+  return res;
+}
+
 //===----------------------------------------------------------------------===//
 // Call frame attributes
 //===----------------------------------------------------------------------===//
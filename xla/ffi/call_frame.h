@@ -24,6 +24,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xla/ffi/api/c_api.h"
 #include "xla/stream_executor/device_memory.h"
@@ -132,6 +133,17 @@ class CallFrame {
  public:
   ~CallFrame();
 
+  CallFrame(CallFrame&&);
+  CallFrame& operator=(CallFrame&&);
+
+  // Returns a copy of the call frame with updated buffer arguments and results.
+  // Attributes are shared with the original call frame and are not re-encoded,
+  // so a call frame can be built once ahead of time and cheaply updated with
+  // buffers for every call. Types and shapes of buffers are not changed.
+  absl::StatusOr<CallFrame> CopyWithBuffers(
+      absl::Span<const se::DeviceMemoryBase> args,
+      absl::Span<const se::DeviceMemoryBase> rets) const;
+
   // Builds an XLA_FFI_CallFrame from owned arguments and attributes.
   XLA_FFI_CallFrame Build(
       const XLA_FFI_Api* api, XLA_FFI_ExecutionContext* ctx,
@@ -157,6 +169,10 @@ class CallFrame {
             absl::Span<const CallFrameBuilder::Buffer> rets,
             const CallFrameBuilder::AttributesMap& attrs);
 
+  CallFrame(std::unique_ptr<Arguments> arguments,
+            std::unique_ptr<Results> results,
+            std::shared_ptr<Attributes> attributes);
+
   static std::unique_ptr<Arguments> InitArgs(
       absl::Span<const CallFrameBuilder::Buffer> args);
 
@@ -168,9 +184,17 @@ class CallFrame {
 
   static Buffer ConvertBuffer(const CallFrameBuilder::Buffer& buffer);
 
+  static absl::StatusOr<std::unique_ptr<Arguments>> CopyArgs(
+      const Arguments& args, absl::Span<const se::DeviceMemoryBase> memory);
+  static absl::StatusOr<std::unique_ptr<Results>> CopyRets(
+      const Results& rets, absl::Span<const se::DeviceMemoryBase> memory);
+
   std::unique_ptr<Arguments> arguments_;
   std::unique_ptr<Results> results_;
-  std::unique_ptr<Attributes> attributes_;
+
+  // Attributes are immutable after construction and can be shared between
+  // multiple call frames (see `CopyWithBuffers`).
+  std::shared_ptr<Attributes> attributes_;
 
   // Declare implementation detail structs to grant access to private members.
   struct ConvertAttribute;
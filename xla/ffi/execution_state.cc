@@ -0,0 +1,65 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/ffi/execution_state.h"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+
+namespace xla::ffi {
+
+ExecutionState::~ExecutionState() {
+  if (deleter_) deleter_(state_);
+}
+
+ExecutionState::TypeId ExecutionState::GetNextTypeId() {
+  static auto* counter = new std::atomic<int64_t>(1);
+  return TypeId(counter->fetch_add(1));
+}
+
+absl::Status ExecutionState::Set(TypeId type_id, void* state,
+                                 Deleter<void> deleter) {
+  if (type_id == TypeId(0)) {
+    return absl::InvalidArgumentError("Type id must be not zero");
+  }
+  if (IsSet()) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("State with type id ", type_id_.value(), " already set"));
+  }
+  type_id_ = type_id;
+  state_ = state;
+  deleter_ = std::move(deleter);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<void*> ExecutionState::Get(TypeId type_id) const {
+  if (type_id_ == TypeId(0)) {
+    return absl::NotFoundError("State is not set");
+  }
+  if (type_id_ != type_id) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Set state type id ", type_id_.value(),
+                     " does not match the requested type id ",
+                     type_id.value()));
+  }
+  return state_;
+}
+
+}  // namespace xla::ffi
@@ -0,0 +1,97 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_FFI_EXECUTION_STATE_H_
+#define XLA_FFI_EXECUTION_STATE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tsl/lib/gtl/int_type.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::ffi {
+
+// Execution state is a container for the state of a single FFI handler
+// instance, i.e. one custom call operation in a compiled executable on one
+// device. It is owned by the XLA runtime and passed to the handler at every
+// execution stage, so that expensive setup (library plans, workspaces, compiled
+// kernels) can be done once in the initialize stage and reused by every
+// execution.
+//
+// In contrast to the ExecutionContext, which is provided by the user for a
+// single XLA execution, execution state lives as long as the executable.
+//
+// Execution state holds at most one object, and it can be set only once.
+class ExecutionState {
+ public:
+  template <typename T>
+  using Deleter = std::function<void(T*)>;
+
+  TSL_LIB_GTL_DEFINE_INT_TYPE(TypeId, int64_t);
+
+  ExecutionState() = default;
+  ~ExecutionState();
+
+  ExecutionState(const ExecutionState&) = delete;
+  ExecutionState& operator=(const ExecutionState&) = delete;
+
+  // Sets opaque state with a given type id and optional deleter.
+  absl::Status Set(TypeId type_id, void* state,
+                   Deleter<void> deleter = nullptr);
+
+  // Sets typed state of type `T`. Execution state becomes the owner of it.
+  template <typename T>
+  absl::Status Set(std::unique_ptr<T> state);
+
+  // Returns opaque state with a given type id.
+  absl::StatusOr<void*> Get(TypeId type_id) const;
+
+  // Returns typed state of type `T`.
+  template <typename T>
+  absl::StatusOr<T*> Get() const {
+    TF_ASSIGN_OR_RETURN(void* state, Get(GetTypeId<T>()));
+    return static_cast<T*>(state);
+  }
+
+  // Returns true if the state was set.
+  bool IsSet() const { return type_id_ != TypeId(0); }
+
+ private:
+  static TypeId GetNextTypeId();
+
+  template <typename T>
+  static TypeId GetTypeId() {
+    static const TypeId id = GetNextTypeId();
+    return id;
+  }
+
+  TypeId type_id_ = TypeId(0);
+  void* state_ = nullptr;
+  Deleter<void> deleter_ = nullptr;
+};
+
+template <typename T>
+absl::Status ExecutionState::Set(std::unique_ptr<T> state) {
+  return Set(GetTypeId<T>(), state.release(),
+             [](void* state) { delete static_cast<T*>(state); });
+}
+
+}  // namespace xla::ffi
+
+#endif  // XLA_FFI_EXECUTION_STATE_H_
@@ -34,12 +34,15 @@ limitations under the License.
 #include "xla/ffi/api/c_api.h"
 #include "xla/ffi/api/c_api_internal.h"  // IWYU pragma: keep
 #include "xla/ffi/execution_context.h"
+#include "xla/ffi/execution_state.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/primitive_util.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/scratch_allocator.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/concurrency/chain.h"
 #include "xla/types.h"  // IWYU pragma: keep
 #include "xla/xla_data.pb.h"
 
@@ -391,6 +394,57 @@ struct CtxDecoding<UserData<T>> {
   }
 };
 
+//===----------------------------------------------------------------------===//
+// State
+//===----------------------------------------------------------------------===//
+
+// Decodes the execution state of the FFI handler instance. Handlers set their
+// state in the initialize stage, i.e. `state->Set(std::make_unique<T>(...))`.
+template <>
+struct CtxDecoding<ExecutionState> {
+  using Type = ExecutionState*;
+
+  static std::optional<Type> Decode(const XLA_FFI_Api* api,
+                                    XLA_FFI_ExecutionContext* ctx,
+                                    DiagnosticEngine& diagnostic) {
+    void* state = api->internal_api->XLA_FFI_INTERNAL_ExecutionState_Get(ctx);
+    if (state == nullptr) {
+      return diagnostic.Emit("Execution state must be not null");
+    }
+    return reinterpret_cast<ExecutionState*>(state);
+  }
+};
+
+// A type tag for automatic decoding of typed state set by the FFI handler in
+// an earlier execution stage.
+template <typename T>
+struct State {};
+
+template <typename T>
+struct CtxDecoding<State<T>> {
+  using Type = T*;
+
+  static std::optional<Type> Decode(const XLA_FFI_Api* api,
+                                    XLA_FFI_ExecutionContext* ctx,
+                                    DiagnosticEngine& diagnostic) {
+    auto* execution_state = reinterpret_cast<const ExecutionState*>(
+        api->internal_api->XLA_FFI_INTERNAL_ExecutionState_Get(ctx));
+
+    if (execution_state == nullptr) {
+      return diagnostic.Emit(
+          "Execution state must be not null to fetch State parameter");
+    }
+
+    auto state = execution_state->Get<T>();
+    if (!state.ok()) {
+      return diagnostic.Emit("Failed to get state from execution state: ")
+             << state.status().message();
+    }
+
+    return *std::move(state);
+  }
+};
+
 //===----------------------------------------------------------------------===//
 // Result encoding
 //===----------------------------------------------------------------------===//
@@ -402,6 +456,19 @@ struct ResultEncoding<absl::Status> {
   }
 };
 
+// Asynchronous FFI handlers return a completion event, and XLA runtime (i.e.
+// CPU thunk executor) can run other work while the handler is in flight.
+// Handler must not access its arguments and results after the event becomes
+// available.
+template <>
+struct ResultEncoding<tsl::AsyncValueRef<tsl::Chain>> {
+  static XLA_FFI_Error* Encode(const XLA_FFI_Api* api,
+                               XLA_FFI_ExecutionContext* ctx,
+                               tsl::AsyncValueRef<tsl::Chain> event) {
+    return api->internal_api->XLA_FFI_INTERNAL_Future_Forward(ctx, &event);
+  }
+};
+
 }  // namespace xla::ffi
 
 #endif  // XLA_FFI_FFI_H_
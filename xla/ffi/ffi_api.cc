@@ -34,10 +34,13 @@ limitations under the License.
 #include "xla/ffi/api/c_api_internal.h"  // IWYU pragma: keep
 #include "xla/ffi/call_frame.h"
 #include "xla/ffi/execution_context.h"
+#include "xla/ffi/execution_state.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/concurrency/chain.h"
 #include "tsl/platform/logging.h"
 
 //===----------------------------------------------------------------------===//
@@ -56,6 +59,10 @@ struct XLA_FFI_ExecutionContext {
 
   const xla::HloComputation* called_computation = nullptr;
   const xla::ffi::ExecutionContext* execution_context = nullptr;
+  xla::ffi::ExecutionState* execution_state = nullptr;
+
+  // Completion event forwarded by asynchronous FFI handlers.
+  tsl::AsyncValueRef<tsl::Chain> future;
 };
 
 //===----------------------------------------------------------------------===//
@@ -71,7 +78,8 @@ static XLA_FFI_ExecutionContext CreateExecutionContext(
   return XLA_FFI_ExecutionContext{
       options.device_ordinal, options.stream, options.allocator,
       options.called_computation,
-      internal::ScopedExecutionContext::GetCallExecutionContext(options)};
+      internal::ScopedExecutionContext::GetCallExecutionContext(options),
+      options.execution_state};
 }
 
 //===----------------------------------------------------------------------===//
@@ -85,12 +93,31 @@ absl::Status TakeStatus(XLA_FFI_Error* error) {
   return status;
 }
 
+// Converts the result of an FFI handler call to a completion event. If the
+// handler forwarded a completion event, returns it, otherwise returns an
+// available (or error) event.
+static tsl::AsyncValueRef<tsl::Chain> TakeFuture(
+    XLA_FFI_Error* error, XLA_FFI_ExecutionContext& ctx) {
+  if (error != nullptr) return TakeStatus(error);
+  if (ctx.future) return std::move(ctx.future);
+  return tsl::MakeAvailableAsyncValueRef<tsl::Chain>();
+}
+
+// Waits for the completion event of an asynchronous FFI handler (if any).
+static absl::Status TakeStatus(XLA_FFI_Error* error,
+                               XLA_FFI_ExecutionContext& ctx) {
+  if (error != nullptr || !ctx.future) return TakeStatus(error);
+  tsl::BlockUntilReady(ctx.future);
+  if (ctx.future.IsError()) return ctx.future.GetError();
+  return absl::OkStatus();
+}
+
 absl::Status Call(Ffi& handler, CallFrame& call_frame,
                   const CallOptions& options, XLA_FFI_ExecutionStage stage) {
   XLA_FFI_ExecutionContext ctx = CreateExecutionContext(options);
   XLA_FFI_CallFrame ffi_call_frame =
       call_frame.Build(GetXlaFfiApi(), &ctx, stage);
-  return TakeStatus(handler.Call(&ffi_call_frame));
+  return TakeStatus(handler.Call(&ffi_call_frame), ctx);
 }
 
 absl::Status Call(XLA_FFI_Handler* handler, CallFrame& call_frame,
@@ -98,7 +125,26 @@ absl::Status Call(XLA_FFI_Handler* handler, CallFrame& call_frame,
   XLA_FFI_ExecutionContext ctx = CreateExecutionContext(options);
   XLA_FFI_CallFrame ffi_call_frame =
       call_frame.Build(GetXlaFfiApi(), &ctx, stage);
-  return TakeStatus((*handler)(&ffi_call_frame));
+  return TakeStatus((*handler)(&ffi_call_frame), ctx);
+}
+
+tsl::AsyncValueRef<tsl::Chain> CallAsync(Ffi& handler, CallFrame& call_frame,
+                                         const CallOptions& options,
+                                         XLA_FFI_ExecutionStage stage) {
+  XLA_FFI_ExecutionContext ctx = CreateExecutionContext(options);
+  XLA_FFI_CallFrame ffi_call_frame =
+      call_frame.Build(GetXlaFfiApi(), &ctx, stage);
+  return TakeFuture(handler.Call(&ffi_call_frame), ctx);
+}
+
+tsl::AsyncValueRef<tsl::Chain> CallAsync(XLA_FFI_Handler* handler,
+                                         CallFrame& call_frame,
+                                         const CallOptions& options,
+                                         XLA_FFI_ExecutionStage stage) {
+  XLA_FFI_ExecutionContext ctx = CreateExecutionContext(options);
+  XLA_FFI_CallFrame ffi_call_frame =
+      call_frame.Build(GetXlaFfiApi(), &ctx, stage);
+  return TakeFuture((*handler)(&ffi_call_frame), ctx);
 }
 
 namespace internal {
@@ -436,6 +482,18 @@ static void* XLA_FFI_INTERNAL_ExecutionContext_Get(
   return const_cast<ffi::ExecutionContext*>(ctx->execution_context);
 }
 
+static void* XLA_FFI_INTERNAL_ExecutionState_Get(
+    XLA_FFI_ExecutionContext* ctx) {
+  return ctx->execution_state;
+}
+
+static XLA_FFI_Error* XLA_FFI_INTERNAL_Future_Forward(
+    XLA_FFI_ExecutionContext* ctx, void* event) {
+  ctx->future =
+      std::move(*reinterpret_cast<tsl::AsyncValueRef<tsl::Chain>*>(event));
+  return nullptr;
+}
+
 //===----------------------------------------------------------------------===//
 // XLA FFI Api access
 //===----------------------------------------------------------------------===//
@@ -449,6 +507,8 @@ static XLA_FFI_InternalApi internal_api = {
     XLA_FFI_INTERNAL_DeviceMemoryAllocator_Get,
     XLA_FFI_INTERNAL_CalledComputation_Get,
     XLA_FFI_INTERNAL_ExecutionContext_Get,
+    XLA_FFI_INTERNAL_ExecutionState_Get,
+    XLA_FFI_INTERNAL_Future_Forward,
 };
 
 static XLA_FFI_Api api = {
@@ -27,9 +27,12 @@ limitations under the License.
 #include "xla/ffi/api/c_api_internal.h"  // IWYU pragma: keep
 #include "xla/ffi/call_frame.h"
 #include "xla/ffi/execution_context.h"
+#include "xla/ffi/execution_state.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/concurrency/chain.h"
 
 namespace xla::ffi {
 
@@ -53,6 +56,10 @@ struct CallOptions {
 
   const HloComputation* called_computation = nullptr;
   const ExecutionContext* execution_context = nullptr;
+
+  // State of the FFI handler instance that persists between calls, i.e. state
+  // created in the initialize stage and used in the execute stage.
+  ExecutionState* execution_state = nullptr;
 };
 
 // Takes ownership of the XLA FFI error and returns underlying status. Frees
@@ -68,6 +75,20 @@ absl::Status Call(
     const CallOptions& options = {},
     XLA_FFI_ExecutionStage stage = XLA_FFI_ExecutionStage_EXECUTE);
 
+// Calls an FFI handler that might complete asynchronously (returns a
+// `tsl::AsyncValueRef<tsl::Chain>` completion event) and returns an event that
+// becomes available when the handler completes. For synchronous handlers the
+// returned event is already available. `Call` above blocks the caller thread
+// until asynchronous handlers complete.
+tsl::AsyncValueRef<tsl::Chain> CallAsync(
+    Ffi& handler, CallFrame& call_frame, const CallOptions& options = {},
+    XLA_FFI_ExecutionStage stage = XLA_FFI_ExecutionStage_EXECUTE);
+
+tsl::AsyncValueRef<tsl::Chain> CallAsync(
+    XLA_FFI_Handler* handler, CallFrame& call_frame,
+    const CallOptions& options = {},
+    XLA_FFI_ExecutionStage stage = XLA_FFI_ExecutionStage_EXECUTE);
+
 namespace internal {
 // This is an internal workaround to override FFI execution context for FFI
 // calls executed in the current thread with `context` in tests that use legacy
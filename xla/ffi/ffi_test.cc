@@ -32,9 +32,12 @@ limitations under the License.
 #include "xla/ffi/ffi_api.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/concurrency/chain.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
 
 namespace xla::ffi {
@@ -100,6 +103,43 @@ TEST(FfiTest, ForwardError) {
   ASSERT_EQ(status.message(), "Ooops!");
 }
 
+TEST(FfiTest, AsyncHandler) {
+  auto call_frame = CallFrameBuilder().Build();
+
+  auto event = tsl::MakeConstructedAsyncValueRef<tsl::Chain>();
+  auto handler = Ffi::Bind().To([&] { return event; });
+
+  auto async_event = CallAsync(*handler, call_frame);
+  EXPECT_FALSE(async_event.IsAvailable());
+
+  event.SetStateConcrete();
+  EXPECT_TRUE(async_event.IsConcrete());
+}
+
+TEST(FfiTest, AsyncHandlerError) {
+  auto call_frame = CallFrameBuilder().Build();
+
+  auto handler = Ffi::Bind().To([] {
+    return tsl::AsyncValueRef<tsl::Chain>(absl::AbortedError("Ooops!"));
+  });
+
+  // Synchronous call waits for the completion event and forwards the error.
+  auto status = Call(*handler, call_frame);
+  ASSERT_EQ(status.message(), "Ooops!");
+
+  auto async_event = CallAsync(*handler, call_frame);
+  ASSERT_TRUE(async_event.IsError());
+  ASSERT_EQ(async_event.GetError().message(), "Ooops!");
+}
+
+TEST(FfiTest, AsyncCallOfSyncHandler) {
+  auto call_frame = CallFrameBuilder().Build();
+  auto handler = Ffi::Bind().To([] { return absl::OkStatus(); });
+
+  auto async_event = CallAsync(*handler, call_frame);
+  EXPECT_TRUE(async_event.IsConcrete());
+}
+
 TEST(FfiTest, WrongNumArgs) {
   CallFrameBuilder builder;
   builder.AddBufferArg(se::DeviceMemoryBase(nullptr), PrimitiveType::F32, {});
@@ -627,6 +667,40 @@ TEST(FfiTest, RemainingRets) {
   TF_ASSERT_OK(status);
 }
 
+TEST(FfiTest, CopyCallFrameWithBuffers) {
+  std::vector<float> storage0(4, 0.0f);
+  std::vector<float> storage1(4, 0.0f);
+  se::DeviceMemoryBase memory0(storage0.data(), 4 * sizeof(float));
+  se::DeviceMemoryBase memory1(storage1.data(), 4 * sizeof(float));
+
+  CallFrameBuilder::AttributesBuilder attrs;
+  attrs.Insert("i32", 42);
+
+  CallFrameBuilder builder;
+  builder.AddBufferArg(memory0, PrimitiveType::F32, /*dims=*/{2, 2});
+  builder.AddBufferRet(memory0, PrimitiveType::F32, /*dims=*/{2, 2});
+  builder.AddAttributes(attrs.Build());
+  auto call_frame = builder.Build();
+
+  TF_ASSERT_OK_AND_ASSIGN(auto updated_call_frame,
+                          call_frame.CopyWithBuffers({memory1}, {memory1}));
+
+  auto fn = [&](AnyBuffer arg, Result<AnyBuffer> ret, int32_t i32) {
+    EXPECT_EQ(arg.data.opaque(), storage1.data());
+    EXPECT_EQ(ret->data.opaque(), storage1.data());
+    EXPECT_EQ(arg.dimensions.size(), 2);
+    EXPECT_EQ(i32, 42);
+    return absl::OkStatus();
+  };
+
+  auto handler =
+      Ffi::Bind().Arg<AnyBuffer>().Ret<AnyBuffer>().Attr<int32_t>("i32").To(fn);
+  TF_ASSERT_OK(Call(*handler, updated_call_frame));
+
+  // Number of buffers must match the number of buffers in the call frame.
+  EXPECT_FALSE(call_frame.CopyWithBuffers({}, {memory1}).ok());
+}
+
 TEST(FfiTest, RunOptionsCtx) {
   auto call_frame = CallFrameBuilder().Build();
   auto* expected = reinterpret_cast<se::Stream*>(0x01234567);
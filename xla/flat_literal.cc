@@ -0,0 +1,238 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/flat_literal.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/layout_util.h"
+#include "xla/literal.h"
+#include "xla/shape.h"
+#include "xla/shape_tree.h"
+#include "xla/shape_util.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_system.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+constexpr absl::string_view kMagic = "XLAFLAT1";
+constexpr size_t kHeaderSize = 16;
+constexpr bool kLittleEndian = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+// Returns the shape indices of the arrays of 'shape' in the order their data
+// is stored, after checking that the shape can be stored in the flat format.
+absl::StatusOr<std::vector<ShapeIndex>> GetArrayIndices(const Shape& shape) {
+  if constexpr (!kLittleEndian) {
+    return Unimplemented("Flat literals require a little endian host.");
+  }
+  TF_RETURN_IF_ERROR(ShapeUtil::ValidateShapeWithOptionalLayout(shape));
+  if (!LayoutUtil::HasLayout(shape)) {
+    return InvalidArgument("Flat literal shape must have a layout: %s",
+                           shape.ToString());
+  }
+  if (shape.is_dynamic()) {
+    return Unimplemented("Flat literals cannot have dynamic shape: %s",
+                         shape.ToString());
+  }
+  std::vector<ShapeIndex> indices;
+  absl::Status status = absl::OkStatus();
+  ShapeUtil::ForEachLeafShape(
+      shape, [&](const Shape& subshape, const ShapeIndex& index) {
+        if (!subshape.IsArray()) {
+          status = InvalidArgument("Flat literals can only hold arrays: %s",
+                                   shape.ToString());
+        }
+        indices.push_back(index);
+      });
+  TF_RETURN_IF_ERROR(status);
+  return indices;
+}
+
+absl::Status AppendPadding(int64_t* offset, tsl::WritableFile* file) {
+  static constexpr char kZeros[kFlatLiteralAlignment] = {};
+  int64_t padding = RoundUpTo(*offset, kFlatLiteralAlignment) - *offset;
+  *offset += padding;
+  return file->Append(absl::string_view(kZeros, padding));
+}
+
+// An in-memory sink for SerializeFlatLiteral.
+class StringWritableFile : public tsl::WritableFile {
+ public:
+  explicit StringWritableFile(std::string* output) : output_(output) {}
+
+  using tsl::WritableFile::Append;
+  absl::Status Append(absl::string_view data) override {
+    output_->append(data);
+    return absl::OkStatus();
+  }
+  absl::Status Close() override { return absl::OkStatus(); }
+  absl::Status Flush() override { return absl::OkStatus(); }
+  absl::Status Sync() override { return absl::OkStatus(); }
+
+ private:
+  std::string* output_;
+};
+
+}  // namespace
+
+/*static*/ absl::StatusOr<std::unique_ptr<FlatLiteralWriter>>
+FlatLiteralWriter::Create(const Shape& shape, tsl::WritableFile* file) {
+  TF_ASSIGN_OR_RETURN(std::vector<ShapeIndex> indices, GetArrayIndices(shape));
+  std::vector<int64_t> array_sizes;
+  array_sizes.reserve(indices.size());
+  for (const ShapeIndex& index : indices) {
+    array_sizes.push_back(
+        ShapeUtil::ByteSizeOf(ShapeUtil::GetSubshape(shape, index)));
+  }
+
+  std::string shape_proto = shape.ToProto().SerializeAsString();
+  uint64_t shape_proto_size = shape_proto.size();
+  char size_bytes[sizeof(shape_proto_size)];
+  std::memcpy(size_bytes, &shape_proto_size, sizeof(shape_proto_size));
+  TF_RETURN_IF_ERROR(file->Append(kMagic));
+  TF_RETURN_IF_ERROR(
+      file->Append(absl::string_view(size_bytes, sizeof(size_bytes))));
+  TF_RETURN_IF_ERROR(file->Append(shape_proto));
+  int64_t offset = kHeaderSize + shape_proto.size();
+  TF_RETURN_IF_ERROR(AppendPadding(&offset, file));
+
+  auto writer = absl::WrapUnique(
+      new FlatLiteralWriter(std::move(array_sizes), offset, file));
+  TF_RETURN_IF_ERROR(writer->FinishArrays());
+  return writer;
+}
+
+FlatLiteralWriter::FlatLiteralWriter(std::vector<int64_t> array_sizes,
+                                     int64_t offset, tsl::WritableFile* file)
+    : array_sizes_(std::move(array_sizes)), offset_(offset), file_(file) {}
+
+absl::Status FlatLiteralWriter::Append(absl::string_view data) {
+  while (!data.empty()) {
+    if (array_index_ == array_sizes_.size()) {
+      return InvalidArgument("Appended %d bytes past the end of the literal.",
+                             data.size());
+    }
+    int64_t size = std::min<int64_t>(
+        data.size(), array_sizes_[array_index_] - array_bytes_written_);
+    TF_RETURN_IF_ERROR(file_->Append(data.substr(0, size)));
+    data.remove_prefix(size);
+    array_bytes_written_ += size;
+    offset_ += size;
+    TF_RETURN_IF_ERROR(FinishArrays());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FlatLiteralWriter::FinishArrays() {
+  while (array_index_ < array_sizes_.size() &&
+         array_bytes_written_ == array_sizes_[array_index_]) {
+    TF_RETURN_IF_ERROR(AppendPadding(&offset_, file_));
+    ++array_index_;
+    array_bytes_written_ = 0;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FlatLiteralWriter::Finish() {
+  if (array_index_ != array_sizes_.size()) {
+    return FailedPrecondition(
+        "Flat literal is missing data: %d of %d arrays written.", array_index_,
+        array_sizes_.size());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WriteFlatLiteral(const LiteralBase& literal,
+                              tsl::WritableFile* file) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<FlatLiteralWriter> writer,
+                      FlatLiteralWriter::Create(literal.shape(), file));
+  TF_ASSIGN_OR_RETURN(std::vector<ShapeIndex> indices,
+                      GetArrayIndices(literal.shape()));
+  for (const ShapeIndex& index : indices) {
+    TF_RETURN_IF_ERROR(writer->Append(absl::string_view(
+        static_cast<const char*>(literal.untyped_data(index)),
+        literal.size_bytes(index))));
+  }
+  return writer->Finish();
+}
+
+absl::StatusOr<std::string> SerializeFlatLiteral(const LiteralBase& literal) {
+  std::string output;
+  StringWritableFile file(&output);
+  TF_RETURN_IF_ERROR(WriteFlatLiteral(literal, &file));
+  return output;
+}
+
+absl::StatusOr<BorrowingLiteral> BorrowFlatLiteral(absl::string_view data) {
+  if (data.size() < kHeaderSize || data.substr(0, kMagic.size()) != kMagic) {
+    return InvalidArgument("Not a flat literal.");
+  }
+  uint64_t shape_proto_size;
+  std::memcpy(&shape_proto_size, data.data() + kMagic.size(),
+              sizeof(shape_proto_size));
+  if (shape_proto_size > data.size() - kHeaderSize) {
+    return InvalidArgument("Flat literal shape is truncated.");
+  }
+  ShapeProto shape_proto;
+  if (!shape_proto.ParseFromArray(data.data() + kHeaderSize,
+                                  shape_proto_size)) {
+    return InvalidArgument("Failed to parse flat literal shape.");
+  }
+  Shape shape(shape_proto);
+  TF_ASSIGN_OR_RETURN(std::vector<ShapeIndex> indices, GetArrayIndices(shape));
+
+  ShapeTree<const char*> buffers(shape, nullptr);
+  int64_t offset = RoundUpTo<int64_t>(kHeaderSize + shape_proto_size,
+                                      kFlatLiteralAlignment);
+  for (const ShapeIndex& index : indices) {
+    int64_t size = ShapeUtil::ByteSizeOf(ShapeUtil::GetSubshape(shape, index));
+    if (offset + size > static_cast<int64_t>(data.size())) {
+      return InvalidArgument("Flat literal data is truncated.");
+    }
+    *buffers.mutable_element(index) = data.data() + offset;
+    offset = RoundUpTo(offset + size, kFlatLiteralAlignment);
+  }
+  return BorrowingLiteral(std::move(buffers));
+}
+
+/*static*/ absl::StatusOr<std::unique_ptr<MappedFlatLiteral>>
+MappedFlatLiteral::Open(tsl::Env* env, const std::string& path) {
+  std::unique_ptr<tsl::ReadOnlyMemoryRegion> region;
+  TF_RETURN_IF_ERROR(env->NewReadOnlyMemoryRegionFromFile(path, &region));
+  TF_ASSIGN_OR_RETURN(
+      BorrowingLiteral literal,
+      BorrowFlatLiteral(absl::string_view(
+          static_cast<const char*>(region->data()), region->length())));
+  return absl::WrapUnique(
+      new MappedFlatLiteral(std::move(region), std::move(literal)));
+}
+
+}  // namespace xla
@@ -0,0 +1,118 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A flat binary format for literals which can be mapped into memory and used
+// as a BorrowingLiteral without deserializing or copying the array data. All
+// integers are little endian:
+//
+//   "XLAFLAT1"                 8 byte magic
+//   uint64                     size N of the serialized ShapeProto
+//   N bytes                    ShapeProto of the literal, including layouts
+//   padding to kFlatLiteralAlignment
+//   for each array in ShapeUtil::ForEachLeafShape order:
+//     ShapeUtil::ByteSizeOf bytes of array data in its in-memory layout
+//     padding to kFlatLiteralAlignment
+//
+// Array data is stored in host byte order, so the format is only supported on
+// little endian hosts. Dynamic shapes are not supported.
+
+#ifndef XLA_FLAT_LITERAL_H_
+#define XLA_FLAT_LITERAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/literal.h"
+#include "xla/shape.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/file_system.h"
+
+namespace xla {
+
+// Alignment of the array data in the flat literal format, relative to the
+// start of the data.
+inline constexpr int64_t kFlatLiteralAlignment = 64;
+
+// Writes a literal in the flat format to a file. The array data can be
+// appended in chunks of any size, e.g. as it is transferred from device
+// buffers, so the whole literal never has to be materialized on the host.
+class FlatLiteralWriter {
+ public:
+  // Writes the header for a literal of the given shape. The shape must have a
+  // layout. 'file' must outlive the writer.
+  static absl::StatusOr<std::unique_ptr<FlatLiteralWriter>> Create(
+      const Shape& shape, tsl::WritableFile* file);
+
+  // Appends the next bytes of array data. Arrays are written back to back in
+  // leaf order, and a chunk may span several arrays.
+  absl::Status Append(absl::string_view data);
+
+  // Checks that the data of all arrays has been appended.
+  absl::Status Finish();
+
+ private:
+  FlatLiteralWriter(std::vector<int64_t> array_sizes, int64_t offset,
+                    tsl::WritableFile* file);
+
+  // Writes the padding after the current array and moves on to the next one
+  // with a non-zero size.
+  absl::Status FinishArrays();
+
+  std::vector<int64_t> array_sizes_;
+  size_t array_index_ = 0;
+  int64_t array_bytes_written_ = 0;
+  int64_t offset_;
+  tsl::WritableFile* file_;
+};
+
+// Writes 'literal' to 'file' in the flat format.
+absl::Status WriteFlatLiteral(const LiteralBase& literal,
+                              tsl::WritableFile* file);
+
+// Returns 'literal' in the flat format.
+absl::StatusOr<std::string> SerializeFlatLiteral(const LiteralBase& literal);
+
+// Returns a literal borrowing the array data in 'data', which holds a literal
+// in the flat format and must outlive the returned literal. The start of
+// 'data' must be aligned to the alignment of the literal's element types.
+absl::StatusOr<BorrowingLiteral> BorrowFlatLiteral(absl::string_view data);
+
+// A literal in the flat format mapped into memory from a file.
+class MappedFlatLiteral {
+ public:
+  static absl::StatusOr<std::unique_ptr<MappedFlatLiteral>> Open(
+      tsl::Env* env, const std::string& path);
+
+  const LiteralBase& literal() const { return literal_; }
+
+ private:
+  MappedFlatLiteral(std::unique_ptr<tsl::ReadOnlyMemoryRegion> region,
+                    BorrowingLiteral literal)
+      : region_(std::move(region)), literal_(std::move(literal)) {}
+
+  std::unique_ptr<tsl::ReadOnlyMemoryRegion> region_;
+  BorrowingLiteral literal_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_FLAT_LITERAL_H_
@@ -0,0 +1,127 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/flat_literal.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/shape_util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace {
+
+Literal MakeTupleLiteral() {
+  Literal matrix =
+      LiteralUtil::CreateR2<float>({{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}});
+  Literal vector = LiteralUtil::CreateR1<int8_t>({7, 8, 9});
+  Literal scalar = LiteralUtil::CreateR0<double>(10.0);
+  Literal empty = LiteralUtil::CreateR1<int32_t>({});
+  Literal inner =
+      LiteralUtil::MakeTupleOwned(std::move(vector), std::move(empty));
+  return LiteralUtil::MakeTupleOwned(std::move(matrix), std::move(inner),
+                                     std::move(scalar));
+}
+
+TEST(FlatLiteralTest, ArrayRoundTrip) {
+  Literal literal = LiteralUtil::CreateR2<int32_t>({{1, 2}, {3, 4}});
+  TF_ASSERT_OK_AND_ASSIGN(std::string flat, SerializeFlatLiteral(literal));
+  TF_ASSERT_OK_AND_ASSIGN(BorrowingLiteral borrowed, BorrowFlatLiteral(flat));
+  EXPECT_EQ(borrowed, literal);
+  // The borrowed literal views the serialized data in place.
+  const char* data = static_cast<const char*>(borrowed.untyped_data());
+  EXPECT_GE(data, flat.data());
+  EXPECT_LT(data, flat.data() + flat.size());
+}
+
+TEST(FlatLiteralTest, NestedTupleRoundTrip) {
+  Literal literal = MakeTupleLiteral();
+  TF_ASSERT_OK_AND_ASSIGN(std::string flat, SerializeFlatLiteral(literal));
+  TF_ASSERT_OK_AND_ASSIGN(BorrowingLiteral borrowed, BorrowFlatLiteral(flat));
+  EXPECT_EQ(borrowed, literal);
+  for (const ShapeIndex& index : {ShapeIndex{0}, ShapeIndex{1, 0},
+                                  ShapeIndex{2}}) {
+    int64_t offset =
+        static_cast<const char*>(borrowed.untyped_data(index)) - flat.data();
+    EXPECT_EQ(offset % kFlatLiteralAlignment, 0);
+  }
+}
+
+TEST(FlatLiteralTest, WriteInChunks) {
+  Literal literal = MakeTupleLiteral();
+  std::string data;
+  for (const ShapeIndex& index : {ShapeIndex{0}, ShapeIndex{1, 0},
+                                  ShapeIndex{1, 1}, ShapeIndex{2}}) {
+    data.append(static_cast<const char*>(literal.untyped_data(index)),
+                literal.size_bytes(index));
+  }
+
+  std::string path = tsl::io::JoinPath(testing::TempDir(), "chunks.flat");
+  tsl::Env* env = tsl::Env::Default();
+  std::unique_ptr<tsl::WritableFile> file;
+  TF_ASSERT_OK(env->NewWritableFile(path, &file));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<FlatLiteralWriter> writer,
+      FlatLiteralWriter::Create(literal.shape(), file.get()));
+  // Chunks which straddle array boundaries.
+  for (size_t i = 0; i < data.size(); i += 5) {
+    TF_ASSERT_OK(writer->Append(absl::string_view(data).substr(i, 5)));
+  }
+  TF_ASSERT_OK(writer->Finish());
+  TF_ASSERT_OK(file->Close());
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<MappedFlatLiteral> mapped,
+                          MappedFlatLiteral::Open(env, path));
+  EXPECT_EQ(mapped->literal(), literal);
+  TF_ASSERT_OK_AND_ASSIGN(std::string flat, SerializeFlatLiteral(literal));
+  std::string written;
+  TF_ASSERT_OK(tsl::ReadFileToString(env, path, &written));
+  EXPECT_EQ(written, flat);
+}
+
+TEST(FlatLiteralTest, Errors) {
+  Literal literal = LiteralUtil::CreateR1<float>({1.0f, 2.0f});
+  TF_ASSERT_OK_AND_ASSIGN(std::string flat, SerializeFlatLiteral(literal));
+  // Cut off the second element of the array along with the padding after it.
+  EXPECT_FALSE(
+      BorrowFlatLiteral(flat.substr(0, flat.size() - kFlatLiteralAlignment + 4))
+          .ok());
+  EXPECT_FALSE(BorrowFlatLiteral("not a literal").ok());
+
+  std::string path = tsl::io::JoinPath(testing::TempDir(), "errors.flat");
+  std::unique_ptr<tsl::WritableFile> file;
+  TF_ASSERT_OK(tsl::Env::Default()->NewWritableFile(path, &file));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<FlatLiteralWriter> writer,
+      FlatLiteralWriter::Create(literal.shape(), file.get()));
+  TF_ASSERT_OK(writer->Append(std::string(4, '\0')));
+  EXPECT_FALSE(writer->Finish().ok());
+  EXPECT_FALSE(writer->Append(std::string(8, '\0')).ok());
+}
+
+}  // namespace
+}  // namespace xla
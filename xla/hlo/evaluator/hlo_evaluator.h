@@ -31,6 +31,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/layout_util.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
 #include "xla/service/call_graph.h"
@@ -463,6 +464,16 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     TF_RET_CHECK(ShapeUtil::SameDimensions(shape, operand->shape()));
 
     Literal result(shape);
+    if (HasSameLayout(operand_literal, result)) {
+      absl::Span<const NativeT> operand_data = operand_literal.data<NativeT>();
+      const ReturnT* result_data = result.data<ReturnT>().data();
+      TF_RETURN_IF_ERROR(result.PopulateInplaceParallel(
+          [&](void* dest, absl::Span<const int64_t>, int) {
+            ReturnT* typed_dest = static_cast<ReturnT*>(dest);
+            *typed_dest = unary_op(operand_data[typed_dest - result_data]);
+          }));
+      return std::move(result);
+    }
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return unary_op(operand_literal.Get<NativeT>(multi_index));
@@ -470,6 +481,14 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     return std::move(result);
   }
 
+  // Returns true if the elements of `operand` are stored in the same order as
+  // the elements of `result`. Elementwise ops can then index the operand with
+  // the linear index of the result element instead of converting a
+  // multi-dimensional index for every element.
+  static bool HasSameLayout(const Literal& operand, const Literal& result) {
+    return LayoutUtil::LayoutsInShapesEqual(operand.shape(), result.shape());
+  }
+
   // Map from a primitive type to its associated (templated) DfsHloVisitor.
   std::unique_ptr<ConstDfsHloVisitor> typed_visitors_[PrimitiveType_ARRAYSIZE];
 
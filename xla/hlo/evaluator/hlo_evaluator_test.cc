@@ -368,6 +368,35 @@ TEST_F(HloEvaluatorTest, DoesAdd) {
   TestBinaryOp(HloOpcode::kAdd, std::move(expected), std::move(lhs),
                std::move(rhs));
 }
+
+TEST_F(HloEvaluatorTest, DoesAddWithDifferentOperandLayouts) {
+  Array2D<float> lhs_array(8, 16);
+  Array2D<float> rhs_array(8, 16);
+  Array2D<float> expected_array(8, 16);
+  for (int64_t i = 0; i < 8; ++i) {
+    for (int64_t j = 0; j < 16; ++j) {
+      lhs_array(i, j) = i * 16 + j;
+      rhs_array(i, j) = 1000 * i - j;
+      expected_array(i, j) = lhs_array(i, j) + rhs_array(i, j);
+    }
+  }
+  auto lhs = LiteralUtil::CreateR2FromArray2DWithLayout<float>(
+      lhs_array, LayoutUtil::MakeLayout({0, 1}));
+  auto rhs = LiteralUtil::CreateR2FromArray2DWithLayout<float>(
+      rhs_array, LayoutUtil::MakeLayout({1, 0}));
+  auto expected = LiteralUtil::CreateR2FromArray2D<float>(expected_array);
+
+  HloComputation::Builder b(TestName());
+  auto c1 = b.AddInstruction(HloInstruction::CreateConstant(std::move(lhs)));
+  auto c2 = b.AddInstruction(HloInstruction::CreateConstant(std::move(rhs)));
+  b.AddInstruction(
+      HloInstruction::CreateBinary(expected.shape(), HloOpcode::kAdd, c1, c2));
+  m_->AddEntryComputation(b.Build());
+
+  TF_ASSERT_OK_AND_ASSIGN(Literal result, Evaluate());
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+}
+
 // Verifies that HloEvaluator evaluates a HLO instruction that performs
 // element-wise and with 2 operands.
 TEST_P(HloEvaluatorBf16Test, DoesAnd) {
@@ -985,6 +1014,37 @@ TEST_P(HloEvaluatorBf16Test, DotRank2AndRank2) {
   EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
 }
 
+TEST_F(HloEvaluatorTest, DotRank2AndRank2F64FastPath) {
+  HloComputation::Builder b(TestName());
+
+  auto lhs_array = std::make_unique<Array2D<double>>(4, 3);
+  lhs_array->FillUnique(1.0);
+  HloInstruction* lhs_instruction =
+      b.AddInstruction(HloInstruction::CreateConstant(
+          LiteralUtil::CreateR2FromArray2D<double>(*lhs_array)));
+  auto rhs_array = std::make_unique<Array2D<double>>(3, 2);
+  rhs_array->FillUnique(1.0);
+  HloInstruction* rhs_instruction =
+      b.AddInstruction(HloInstruction::CreateConstant(
+          LiteralUtil::CreateR2FromArray2D<double>(*rhs_array)));
+
+  Shape shape = ShapeUtil::MakeShape(F64, {4, 2});
+  DotDimensionNumbers dot_dnums;
+  dot_dnums.add_lhs_contracting_dimensions(1);
+  dot_dnums.add_rhs_contracting_dimensions(0);
+  b.AddInstruction(HloInstruction::CreateDot(shape, lhs_instruction,
+                                             rhs_instruction, dot_dnums,
+                                             DefaultPrecisionConfig(2)));
+  m_->AddEntryComputation(b.Build());
+
+  evaluator_.set_use_fast_path(true);
+  TF_ASSERT_OK_AND_ASSIGN(Literal result, Evaluate());
+
+  auto expected = LiteralUtil::CreateR2<double>(
+      {{22., 28.}, {58., 76.}, {94., 124.}, {130., 172.}});
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+}
+
 TEST_P(HloEvaluatorBf16Test, DotRank4AndRank4) {
   HloComputation::Builder b(TestName());
 
@@ -1039,8 +1039,15 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return HandleDotSlowPath(dot);
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  std::is_same_v<NativeT, float>>* = nullptr>
+  // Element types for which HandleDot can use the Eigen based
+  // HloEvaluator::MatmulArray2D.
+  template <typename NativeT>
+  static constexpr bool kHasMatmulFastPath =
+      std::is_same_v<NativeT, float> || std::is_same_v<NativeT, double> ||
+      std::is_same_v<NativeT, complex64> || std::is_same_v<NativeT, complex128>;
+
+  template <typename NativeT,
+            typename std::enable_if_t<kHasMatmulFastPath<NativeT>>* = nullptr>
   absl::Status HandleDot(const HloInstruction* dot) {
     const HloInstruction* lhs = dot->operand(0);
     const HloInstruction* rhs = dot->operand(1);
@@ -1104,8 +1111,8 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return absl::OkStatus();
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  !std::is_same_v<NativeT, float>>* = nullptr>
+  template <typename NativeT,
+            typename std::enable_if_t<!kHasMatmulFastPath<NativeT>>* = nullptr>
   absl::Status HandleDot(const HloInstruction* dot) {
     return HandleDotSlowPath(dot);
   }
@@ -1656,12 +1663,27 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     const Literal& rhs_literal = parent_->GetEvaluatedLiteralFor(rhs);
 
     Literal result(shape);
+    const std::function<ReturnT(ReturnT, ReturnT)> converted_op =
+        ConvertBinaryFunction(binary_op);
+
+    if (HloEvaluator::HasSameLayout(lhs_literal, result) &&
+        HloEvaluator::HasSameLayout(rhs_literal, result)) {
+      absl::Span<const ReturnT> lhs_data = lhs_literal.data<ReturnT>();
+      absl::Span<const ReturnT> rhs_data = rhs_literal.data<ReturnT>();
+      const ReturnT* result_data = result.data<ReturnT>().data();
+      TF_RETURN_IF_ERROR(result.PopulateInplaceParallel(
+          [&](void* dest, absl::Span<const int64_t>, int) {
+            ReturnT* typed_dest = static_cast<ReturnT*>(dest);
+            const int64_t i = typed_dest - result_data;
+            *typed_dest = converted_op(lhs_data[i], rhs_data[i]);
+          }));
+      return std::move(result);
+    }
 
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
-          return ConvertBinaryFunction(binary_op)(
-              lhs_literal.Get<ReturnT>(multi_index),
-              rhs_literal.Get<ReturnT>(multi_index));
+          return converted_op(lhs_literal.Get<ReturnT>(multi_index),
+                              rhs_literal.Get<ReturnT>(multi_index));
         }));
     return std::move(result);
   }
@@ -1684,6 +1706,22 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    if (HloEvaluator::HasSameLayout(lhs_literal, result) &&
+        HloEvaluator::HasSameLayout(rhs_literal, result) &&
+        HloEvaluator::HasSameLayout(ehs_literal, result)) {
+      absl::Span<const LhsType> lhs_data = lhs_literal.data<LhsType>();
+      absl::Span<const RhsType> rhs_data = rhs_literal.data<RhsType>();
+      absl::Span<const EhsType> ehs_data = ehs_literal.data<EhsType>();
+      const ReturnT* result_data = result.data<ReturnT>().data();
+      TF_RETURN_IF_ERROR(result.PopulateInplaceParallel(
+          [&](void* dest, absl::Span<const int64_t>, int) {
+            ReturnT* typed_dest = static_cast<ReturnT*>(dest);
+            const int64_t i = typed_dest - result_data;
+            *typed_dest = ternary_op(lhs_data[i], rhs_data[i], ehs_data[i]);
+          }));
+      return std::move(result);
+    }
+
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return ternary_op(lhs_literal.Get<LhsType>(multi_index),
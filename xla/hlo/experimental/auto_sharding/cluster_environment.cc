@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -251,11 +252,24 @@ double ClusterEnvironment::TryCollectivePermuteForResharding(
 double ClusterEnvironment::ReshardingCost(const Shape& shape,
                                           const HloSharding& src_spec,
                                           const HloSharding& dst_spec) const {
-  // TODO(zhuohan): This function can be wrong and needs more tests.
   if (src_spec == dst_spec || IsUndefined(src_spec) ||
       src_spec.IsReplicated()) {
     return 0.0;
   }
+  auto key = std::make_tuple(shape, src_spec, dst_spec);
+  if (auto it = resharding_cost_cache_.find(key);
+      it != resharding_cost_cache_.end()) {
+    return it->second;
+  }
+  double cost = ComputeReshardingCost(shape, src_spec, dst_spec);
+  resharding_cost_cache_.emplace(std::move(key), cost);
+  return cost;
+}
+
+double ClusterEnvironment::ComputeReshardingCost(
+    const Shape& shape, const HloSharding& src_spec,
+    const HloSharding& dst_spec) const {
+  // TODO(zhuohan): This function can be wrong and needs more tests.
 
   if (src_spec.tile_assignment().num_elements() > device_mesh_.num_elements() ||
       dst_spec.tile_assignment().num_elements() > device_mesh_.num_elements()) {
@@ -20,9 +20,11 @@ limitations under the License.
 #include <cstdint>
 #include <iterator>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_option.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_util.h"
 #include "xla/hlo/experimental/auto_sharding/profiling_result.h"
@@ -148,6 +150,9 @@ class ClusterEnvironment {
                                      const HloSharding& src_spec,
                                      const Array<int64_t>& device_mesh) const;
 
+  // Returns the cost of resharding a tensor of shape `shape` from `src_spec`
+  // to `dst_spec`. Results are memoized, since the strategy generation and
+  // the cost graph query the same (shape, src, dst) triples many times.
   double ReshardingCost(const Shape& shape, const HloSharding& src_spec,
                         const HloSharding& dst_spec) const;
 
@@ -192,6 +197,14 @@ class ClusterEnvironment {
   double AllToAllCostUtil(double num_bytes, int mesh_dim,
                           int64_t num_devices) const;
 
+  double ComputeReshardingCost(const Shape& shape, const HloSharding& src_spec,
+                               const HloSharding& dst_spec) const;
+
+  // Memoized results of ComputeReshardingCost.
+  mutable absl::flat_hash_map<std::tuple<Shape, HloSharding, HloSharding>,
+                              double>
+      resharding_cost_cache_;
+
   void GenerateCachedReplicaGroups() {
     // One vector per device_mesh_ dimension.
     cached_replica_groups_.reserve(device_mesh_.num_dimensions());
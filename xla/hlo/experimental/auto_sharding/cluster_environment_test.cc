@@ -0,0 +1,62 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/experimental/auto_sharding/cluster_environment.h"
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+#include "xla/array.h"
+#include "xla/hlo/experimental/auto_sharding/auto_sharding_option.h"
+#include "xla/hlo/experimental/auto_sharding/profiling_result.h"
+#include "xla/hlo/ir/hlo_sharding.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+namespace spmd {
+namespace {
+
+TEST(ClusterEnvironmentTest, MemoizedReshardingCostDependsOnShape) {
+  Array<int64_t> device_mesh({{0, 1}, {2, 3}});
+  ProfilingResult prof_result;
+  AutoShardingOption option;
+  ClusterEnvironment cluster_env(device_mesh, device_mesh,
+                                 /*mesh_alpha=*/{1.0, 1.0},
+                                 /*mesh_beta=*/{1.0, 1.0}, prof_result,
+                                 option);
+
+  const Shape small_shape = ShapeUtil::MakeShape(F32, {64, 64});
+  const Shape large_shape = ShapeUtil::MakeShape(F32, {128, 64});
+  const HloSharding tiled = HloSharding::IotaTile({2, 2});
+  const HloSharding replicated = HloSharding::Replicate();
+
+  double small_cost =
+      cluster_env.ReshardingCost(small_shape, tiled, replicated);
+  EXPECT_GT(small_cost, 0.0);
+  // Repeated queries return the memoized cost.
+  EXPECT_EQ(cluster_env.ReshardingCost(small_shape, tiled, replicated),
+            small_cost);
+  // A different shape with the same shardings is not served from the memo.
+  EXPECT_GT(cluster_env.ReshardingCost(large_shape, tiled, replicated),
+            small_cost);
+  EXPECT_EQ(cluster_env.ReshardingCost(small_shape, tiled, tiled), 0.0);
+  EXPECT_EQ(cluster_env.ReshardingCost(small_shape, replicated, tiled), 0.0);
+}
+
+}  // namespace
+}  // namespace spmd
+}  // namespace xla
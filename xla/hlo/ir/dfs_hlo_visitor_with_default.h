@@ -375,6 +375,10 @@ class DfsHloRewriteVisitor : public DfsHloVisitorWithDefault {
   // Mark the computation as having changed.
   void MarkAsChanged() { changed_ = true; }
 
+  // Clears the changed state, e.g. to find out whether visiting a single
+  // instruction changed the computation.
+  void ResetChanged() { changed_ = false; }
+
  private:
   bool changed_ = false;
 };
@@ -235,6 +235,9 @@ HloInstruction* HloComputation::AddInstructionInternal(
     instruction->SetUniqueId(parent()->NewUniqueInstructionId());
   }
   instruction->set_parent(this);
+  if (instruction->has_called_computations()) {
+    instruction->NotifyCallGraphChanged();
+  }
   HloInstruction* pinst = instruction.release();  // Take ownership
   HloInstructionInfo info;
   info.opcode_ = pinst->opcode();
@@ -500,6 +503,9 @@ absl::Status HloComputation::RemoveInstructionImpl(HloInstruction* instruction,
 
   HloInstructionInfo* info = &instructions_[instruction->index_in_parent_];
   DCHECK_EQ(info->inst(), instruction);
+  if (instruction->has_called_computations()) {
+    instruction->NotifyCallGraphChanged();
+  }
   info->inst()->set_parent(nullptr);
   to_be_deleted_.push_back(info->inst());  // Takes ownership
   to_be_deleted_.back()->DetachFromOperandsAndUsers();
@@ -1165,9 +1171,9 @@ absl::StatusOr<HloInstruction*> HloComputation::CreateAsyncInstructions(
       async_done->SetAndSanitizeName(absl::StrCat(root->name(), ".call-done"));
     }
   }
-  async_start->set_metadata(instruction->metadata());
+  async_start->CopyMetadataFrom(instruction);
   async_start->CopyBackendConfigFrom(instruction);
-  async_done->set_metadata(instruction->metadata());
+  async_done->CopyMetadataFrom(instruction);
   async_done->CopyBackendConfigFrom(instruction);
   for (HloInstruction* control_pred : instruction->control_predecessors()) {
     TF_RETURN_IF_ERROR(control_pred->AddControlDependencyTo(async_start));
@@ -1409,7 +1415,7 @@ absl::StatusOr<bool> HloComputation::ReplaceInstructionWithDifferentShape(
   bool overwrite_op_name = new_instruction->metadata().op_name().empty() &&
                            !old_instruction->metadata().op_name().empty();
   if (overwrite_op_name) {
-    new_instruction->set_metadata(old_instruction->metadata());
+    new_instruction->CopyMetadataFrom(old_instruction);
   }
   if (new_instruction->frontend_attributes().map().empty()) {
     new_instruction->set_frontend_attributes(
@@ -216,6 +216,13 @@ void HloInstruction::AppendComputation(HloComputation* computation) {
   // In .cc file since PtrVec<T*>::push_back() wants to check the alignment
   // of T and hlo_instruction.h does not include hlo_computation.h.
   mutable_rare()->called_computations.push_back(computation);
+  NotifyCallGraphChanged();
+}
+
+void HloInstruction::NotifyCallGraphChanged() {
+  if (parent_ != nullptr && parent_->parent() != nullptr) {
+    parent_->parent()->InvalidateCachedCallGraph();
+  }
 }
 
 HloInstruction* HloInstruction::AddInstruction(
@@ -1209,7 +1216,7 @@ absl::StatusOr<std::unique_ptr<HloInstruction>> HloInstruction::CreateFromProto(
 
   TF_RET_CHECK(!proto.name().empty());
   instruction->SetAndSanitizeName(proto.name());
-  *instruction->metadata_ = proto.metadata();
+  instruction->set_metadata(proto.metadata());
   instruction->backend_config_ = BackendConfigWrapper(proto.backend_config());
 
   TF_RET_CHECK(proto.id() >= 0)
@@ -2044,7 +2051,7 @@ HloInstruction::CreateBroadcastSequence(
   if (ShapeUtil::IsScalar(operand->shape())) {
     auto broadcast =
         HloInstruction::CreateBroadcast(broadcast_shape, operand, {});
-    broadcast->set_metadata(operand->metadata());
+    broadcast->CopyMetadataFrom(operand);
     if (operand->has_sharding()) {
       broadcast->copy_sharding(operand);
     }
@@ -2071,7 +2078,7 @@ HloInstruction::CreateBroadcastSequence(
       ShapeUtil::MakeShape(operand->shape().element_type(),
                            reshaped_dimensions),
       operand));
-  reshaped_operand->set_metadata(operand->metadata());
+  reshaped_operand->CopyMetadataFrom(operand);
   if (operand->has_sharding()) {
     reshaped_operand->copy_sharding(operand);
   }
@@ -2080,7 +2087,7 @@ HloInstruction::CreateBroadcastSequence(
   // Broadcast 'reshape' up to the larger size.
   auto broadcast = HloInstruction::CreateBroadcast(
       broadcast_shape, reshaped_operand, broadcast_dimensions);
-  broadcast->set_metadata(operand->metadata());
+  broadcast->CopyMetadataFrom(operand);
   if (operand->has_sharding()) {
     broadcast->copy_sharding(operand);
   }
@@ -2167,7 +2174,7 @@ void HloInstruction::SetupDerivedInstruction(
   } else if (!ShapeUtil::CompatibleKind(shape_, derived_instruction->shape())) {
     derived_instruction->clear_sharding();
   }
-  derived_instruction->set_metadata(*metadata_);
+  derived_instruction->CopyMetadataFrom(this);
   if (has_rare()) {
     derived_instruction->set_frontend_attributes(frontend_attributes());
     derived_instruction->set_statistics_viz(statistics_viz());
@@ -3264,6 +3271,7 @@ void HloInstruction::set_to_apply(HloComputation* computation) {
     CHECK_EQ(called_computations().size(), 1)
         << "Expected a to_apply computation for " << opcode();
     rare_->called_computations[0] = computation;
+    NotifyCallGraphChanged();
     return;
   }
   LOG(FATAL) << "Invalid opcode for to_apply(): " << opcode();
@@ -3303,11 +3311,13 @@ HloComputation* HloInstruction::while_body() const {
 void HloInstruction::set_while_condition(HloComputation* computation) {
   CHECK_EQ(HloOpcode::kWhile, opcode_);
   rare_->called_computations[kConditionComputationIndex] = computation;
+  NotifyCallGraphChanged();
 }
 
 void HloInstruction::set_while_body(HloComputation* computation) {
   CHECK_EQ(HloOpcode::kWhile, opcode_);
   rare_->called_computations[kBodyComputationIndex] = computation;
+  NotifyCallGraphChanged();
 }
 
 HloInstruction* HloInstruction::while_init() const {
@@ -3348,6 +3358,7 @@ void HloInstruction::set_branch_computation(int b,
                                             HloComputation* computation) {
   CHECK_EQ(HloOpcode::kConditional, opcode_);
   rare_->called_computations[b] = computation;
+  NotifyCallGraphChanged();
 }
 
 std::string HloInstruction::SignatureString() const {
@@ -3614,11 +3625,11 @@ void HloInstruction::PrintWithCanonicalNameMap(
   PrintExtraAttributes(attr_printer, options);
 
   if (options.print_metadata() &&
-      (!metadata_->op_type().empty() || !metadata_->op_name().empty() ||
-       !metadata_->source_file().empty())) {
+      (!metadata().op_type().empty() || !metadata().op_name().empty() ||
+       !metadata().source_file().empty())) {
     printer->Append(", metadata={");
     printer->Append(xla::OpMetadataToString(
-        *metadata_, options.print_metadata_only_op_name()));
+        metadata(), options.print_metadata_only_op_name()));
     printer->Append("}");
   }
   if (options.print_backend_config() && !backend_config_.empty()) {
@@ -3965,7 +3976,7 @@ HloInstructionProto HloInstruction::ToProto() const {
     proto.add_control_predecessor_ids(control->unique_id());
   }
 
-  *proto.mutable_metadata() = *metadata_;
+  *proto.mutable_metadata() = metadata();
   proto.set_backend_config(backend_config_.GetRawString());
   if (opcode() != HloOpcode::kFusion) {
     for (const HloComputation* computation : called_computations()) {
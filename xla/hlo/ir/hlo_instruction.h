@@ -1975,6 +1975,7 @@ class HloInstruction {
       mutable_rare()->called_computations[i] =
           map_function(rare()->called_computations[i]);
     }
+    NotifyCallGraphChanged();
   }
 
   // Clears out the called computations.
@@ -2067,7 +2068,7 @@ class HloInstruction {
   // if no id has been assigned yet).
   int unique_id() const { return unique_id_; }
 
-  bool preserve_layout() const { return metadata_->preserve_layout(); }
+  bool preserve_layout() const { return metadata().preserve_layout(); }
 
   bool has_backend_config() const { return !backend_config_.empty(); }
 
@@ -2171,26 +2172,53 @@ class HloInstruction {
 
   // Sets the debug metadata for this instruction, excluding creation_pass_id,
   // which should never be copied anywhere.
-  void set_metadata(const OpMetadata& metadata) { *metadata_ = metadata; }
+  void set_metadata(const OpMetadata& metadata) {
+    // Copying the default instance into an instruction without metadata is a
+    // no-op, which keeps cloning instructions without metadata cheap.
+    if (metadata_ == nullptr && &metadata == &OpMetadata::default_instance()) {
+      return;
+    }
+    if (&metadata == metadata_.get()) {
+      return;
+    }
+    metadata_ = std::make_shared<const OpMetadata>(metadata);
+  }
+
+  // Sets the debug metadata of this instruction to the one of `other`. Unlike
+  // `set_metadata`, the metadata is shared with `other` until either of the
+  // instructions updates it.
+  void CopyMetadataFrom(const HloInstruction* other) {
+    metadata_ = other->metadata_;
+  }
 
   void set_size_of_generated_code_in_bytes(int64_t code_size_in_bytes) {
-    metadata_->set_size_of_generated_code_in_bytes(code_size_in_bytes);
+    UpdateMetadata([&](OpMetadata& metadata) {
+      metadata.set_size_of_generated_code_in_bytes(code_size_in_bytes);
+    });
   }
   void set_size_of_memory_working_set_in_bytes(
       int64_t working_set_size_in_bytes) {
-    metadata_->set_size_of_memory_working_set_in_bytes(
-        working_set_size_in_bytes);
+    UpdateMetadata([&](OpMetadata& metadata) {
+      metadata.set_size_of_memory_working_set_in_bytes(
+          working_set_size_in_bytes);
+    });
   }
   void set_metadata_op_name(const std::string& name) {
-    metadata_->set_op_name(name);
+    UpdateMetadata([&](OpMetadata& metadata) { metadata.set_op_name(name); });
   }
   void set_metadata_deduplicated_name(std::string deduplicated_name) {
-    metadata_->set_deduplicated_name(std::move(deduplicated_name));
+    UpdateMetadata([&](OpMetadata& metadata) {
+      metadata.set_deduplicated_name(std::move(deduplicated_name));
+    });
   }
   void set_metadata_preserve_layout(bool preserve_layout) {
-    metadata_->set_preserve_layout(preserve_layout);
+    UpdateMetadata([&](OpMetadata& metadata) {
+      metadata.set_preserve_layout(preserve_layout);
+    });
+  }
+  const OpMetadata& metadata() const {
+    return metadata_ != nullptr ? *metadata_ : OpMetadata::default_instance();
   }
-  const OpMetadata& metadata() const { return *metadata_; }
 
   // Set/get the computation containing this instruction. set_parent should only
   // be called by HloComputation methods which add/remove instructions to
@@ -2559,7 +2587,12 @@ class HloInstruction {
 
   void set_called_computation(int index, HloComputation* computation) {
     mutable_rare()->called_computations[index] = computation;
+    NotifyCallGraphChanged();
   }
+
+  // Invalidates the call graph cached by the module containing this
+  // instruction, if any. Called whenever called computations change.
+  void NotifyCallGraphChanged();
   // Indices of computations in called_computations for instructions which call
   // multiple computations.
   enum {
@@ -2788,9 +2821,25 @@ class HloInstruction {
   // String identifier for instruction.
   std::string name_;
 
+  // Applies `update` to a copy of the metadata and replaces the metadata with
+  // it. The metadata is never updated in place, since it may be shared with
+  // other instructions.
+  template <typename Fn>
+  void UpdateMetadata(Fn&& update) {
+    auto metadata = metadata_ != nullptr
+                        ? std::make_shared<OpMetadata>(*metadata_)
+                        : std::make_shared<OpMetadata>();
+    update(*metadata);
+    metadata_ = std::move(metadata);
+  }
+
   // Metadata for debugging.  Allocate it on heap, so that it does not increase
-  // the memory footprint of HloInstruction.
-  std::unique_ptr<OpMetadata> metadata_ = std::make_unique<OpMetadata>();
+  // the memory footprint of HloInstruction. Allocated lazily on the first
+  // update, since most instructions created by passes have no metadata, and
+  // immutable so that it can be shared between instructions copied from each
+  // other, since clones and the instructions derived by passes usually keep
+  // the metadata.
+  std::shared_ptr<const OpMetadata> metadata_;
 };
 
 // Explicit instantiations in hlo_instruction.cc.
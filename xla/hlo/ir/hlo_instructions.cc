@@ -1765,8 +1765,10 @@ void HloConstantInstruction::RelayoutConstant(const Layout& new_layout,
             new_layout,
             ShapeUtil::GetSubshape(literal().shape(), shape_index).layout())) {
       // Only relayout literals if that's really necessary.
-      Literal new_literal = literal_->Relayout(new_layout, shape_index);
-      *mutable_literal() = std::move(new_literal);
+      // Replace the literal instead of going through mutable_literal(), which
+      // would first copy a literal shared with other instructions.
+      literal_ = std::make_shared<Literal>(
+          literal_->Relayout(new_layout, shape_index));
     }
     *mutable_array_subshape->mutable_layout() = new_layout;
   }
@@ -2140,7 +2142,7 @@ HloFusionInstruction::HloFusionInstruction(const Shape& shape,
   CHECK(fused_root != nullptr);
   SetAndSanitizeName(HloOpcodeString(opcode()));
   set_parent(fused_root->parent());
-  set_metadata(fused_root->metadata());
+  CopyMetadataFrom(fused_root);
   set_frontend_attributes(fused_root->frontend_attributes());
   CHECK(fused_root->IsFusible()) << fused_root->ToString();
   CloneAndAppendInstructionIntoCalledComputation(fused_root);
@@ -2544,7 +2546,7 @@ HloCallInstruction::HloCallInstruction(const Shape& shape,
   CHECK(called_computation_root != nullptr);
   SetAndSanitizeName(HloOpcodeString(opcode()));
   set_parent(called_computation_root->parent());
-  set_metadata(called_computation_root->metadata());
+  CopyMetadataFrom(called_computation_root);
   CloneAndAppendInstructionIntoCalledComputation(called_computation_root);
 }
 
@@ -3342,9 +3344,7 @@ HloCustomCallInstruction::CloneWithNewOperandsImpl(
   if (convolution_dimension_numbers_ != nullptr) {
     cloned->set_convolution_dimension_numbers(*convolution_dimension_numbers_);
   }
-  if (HasLiteral()) {
-    cloned->set_literal(literal().Clone());
-  }
+  cloned->literal_ = literal_;
   cloned->set_feature_group_count(feature_group_count_);
   cloned->set_batch_group_count(batch_group_count_);
   cloned->set_custom_call_has_side_effect(custom_call_has_side_effect_);
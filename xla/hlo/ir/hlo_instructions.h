@@ -2075,9 +2075,11 @@ class HloCustomCallInstruction : public HloCallableInstruction {
   // Returns the literal associated with this instruction.
   const Literal& literal() const { return *literal_; }
   // Set the value of literal to a new one.
-  void set_literal(Literal&& literal) { literal_.emplace(std::move(literal)); }
+  void set_literal(Literal&& literal) {
+    literal_ = std::make_shared<const Literal>(std::move(literal));
+  }
   // Returns whether there is literal associated with this instruction.
-  bool HasLiteral() const { return literal_.has_value(); }
+  bool HasLiteral() const { return literal_ != nullptr; }
 
   const PrecisionConfig& precision_config() const { return precision_config_; }
   PrecisionConfig* mutable_precision_config() { return &precision_config_; }
@@ -2151,7 +2153,8 @@ class HloCustomCallInstruction : public HloCallableInstruction {
   std::vector<Shape> operand_shapes_with_layout_;
   // Whether this custom call has a side-effect.
   bool custom_call_has_side_effect_;
-  std::optional<Literal> literal_;
+  // The literal is immutable, so clones of this instruction share it.
+  std::shared_ptr<const Literal> literal_;
   // A custom-call schedule hint.
   CustomCallSchedule custom_call_schedule_;
   // The version of the API used by the custom call function.
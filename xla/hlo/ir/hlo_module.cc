@@ -87,6 +87,7 @@ absl::Status HloModule::set_schedule(HloSchedule schedule) {
 }
 
 void HloModule::ReplaceEntryComputation(HloComputation* entry_computation) {
+  InvalidateCachedCallGraph();
   entry_computation_ = entry_computation;
   config_.get_mutable().SetDefaultComputationLayout(
       entry_computation_->ComputeProgramShape());
@@ -120,6 +121,7 @@ HloModule::StackFrame HloModule::get_stack_frame(int id) const {
 HloComputation* HloModule::AddComputationInternal(
     std::unique_ptr<HloComputation> computation, bool is_entry,
     bool uniquify_identifiers, bool preserve_entry_layouts) {
+  InvalidateCachedCallGraph();
   if (is_entry) {
     CHECK_EQ(nullptr, entry_computation_);
     entry_computation_ = computation.get();
@@ -188,6 +190,7 @@ HloComputation* HloModule::AddEntryComputationWithLayouts(
 }
 
 absl::Status HloModule::RemoveEmbeddedComputation(HloComputation* to_remove) {
+  InvalidateCachedCallGraph();
   if (has_schedule()) {
     schedule_->remove_computation(to_remove);
   }
@@ -265,6 +268,7 @@ void HloModule::MoveComputationsFrom(HloModule* module,
   }
   // Since the computations no longer belong to the old module, clear the list.
   module->computations_.clear();
+  module->InvalidateCachedCallGraph();
 }
 
 void HloModule::ReplaceComputations(
@@ -336,6 +340,7 @@ void HloModule::ReplaceComputations(
       replacements, entry_computation_, entry_computation_);
 
   computations_ = std::move(new_computations);
+  InvalidateCachedCallGraph();
 }
 
 void HloModule::Print(Printer* printer, const HloPrintOptions& options) const {
@@ -539,6 +544,26 @@ absl::Status HloModule::CheckUniqueNamesAndIdsForComputationsAndInstructions()
   return absl::OkStatus();
 }
 
+namespace {
+
+// Makes instructions with identical metadata share one copy of it. Frontends
+// emit the same op_name and source location for many instructions, so this
+// keeps large deserialized modules from holding a copy per instruction.
+void InternMetadata(HloModule& module) {
+  absl::flat_hash_map<std::string, const HloInstruction*> interned;
+  for (HloComputation* computation : module.computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      const OpMetadata& metadata = instruction->metadata();
+      if (&metadata == &OpMetadata::default_instance()) continue;
+      auto [it, inserted] =
+          interned.try_emplace(metadata.SerializeAsString(), instruction);
+      if (!inserted) instruction->CopyMetadataFrom(it->second);
+    }
+  }
+}
+
+}  // namespace
+
 /* static */
 absl::StatusOr<std::unique_ptr<HloModule>> HloModule::CreateFromProto(
     const HloModuleProto& proto, const HloModuleConfig& module_config,
@@ -613,6 +638,7 @@ absl::StatusOr<std::unique_ptr<HloModule>> HloModule::CreateFromProto(
                                    /*preserve_entry_layouts=*/false);
   }
   TF_RET_CHECK(module->entry_computation_ != nullptr);
+  InternMetadata(*module);
   TF_ASSIGN_OR_RETURN(
       module->input_output_alias_config_,
       HloInputOutputAliasConfig::CreateFromProto(
@@ -1162,7 +1188,11 @@ HloComputation* HloModule::GetComputationWithName(absl::string_view name) {
 }
 
 std::string HloModule::GetFingerprint128(const HloPrintOptions& options) const {
-  const tsl::Fprint128 fingerprint = tsl::Fingerprint128(ToString(options));
+  // Stream the printed module into the fingerprint instead of printing it to
+  // a string first, which is expensive for large modules.
+  FingerprintPrinter printer;
+  Print(&printer, options);
+  const tsl::Fprint128 fingerprint = std::move(printer).ToFingerprint();
   absl::string_view fp_bytes(reinterpret_cast<const char*>(&fingerprint),
                              sizeof(tsl::Fprint128));
   return absl::BytesToHexString(fp_bytes);
@@ -30,6 +30,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/dynamic_parameter_binding.h"
 #include "xla/hlo/ir/hlo_clone_context.h"
@@ -50,6 +51,8 @@ limitations under the License.
 
 namespace xla {
 
+class CallGraph;
+
 using LayoutCanonicalizationCallback =
     std::function<absl::StatusOr<std::pair<std::vector<Shape>, Shape>>(
         const HloModule& module)>;
@@ -716,6 +719,22 @@ class HloModule {
   // Getter for the specific stack frame. Argument is a 1-based index.
   StackFrame get_stack_frame(int id) const;
 
+  // Returns the call graph cached by CallGraph::BuildCached, or nullptr if it
+  // has been invalidated since.
+  std::shared_ptr<const CallGraph> cached_call_graph() const {
+    absl::MutexLock lock(&call_graph_mutex_);
+    return cached_call_graph_;
+  }
+  void set_cached_call_graph(
+      std::shared_ptr<const CallGraph> call_graph) const {
+    absl::MutexLock lock(&call_graph_mutex_);
+    cached_call_graph_ = std::move(call_graph);
+  }
+
+  // Drops the cached call graph. Called whenever computations are added to or
+  // removed from the module, or callsites within it change.
+  void InvalidateCachedCallGraph() { set_cached_call_graph(nullptr); }
+
  private:
   HloComputation* AddComputationInternal(
       std::unique_ptr<HloComputation> computation, bool is_entry,
@@ -733,6 +752,11 @@ class HloModule {
   mutable std::mt19937_64 rng_{42};
   mutable absl::Mutex rng_mutex_;
 
+  // Call graph of all execution threads, valid until the next call graph
+  // mutation. Owned jointly with the passes that are using it.
+  mutable std::shared_ptr<const CallGraph> cached_call_graph_;
+  mutable absl::Mutex call_graph_mutex_;
+
   // Unique name generator for computation and instruction names, which are
   // unique per module.
   NameUniquer computation_name_uniquer_{/*separator=*/"."};
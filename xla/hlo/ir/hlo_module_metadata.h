@@ -110,6 +110,24 @@ class HloModuleMetadata {
           pass_metadata->add_module_group_module_ids(module_id);
         });
   }
+  absl::Status set_current_pass_instruction_count_before(int64_t count) {
+    return MutateCurrentHloPassMetadata(
+        [&count](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_instruction_count_before(count);
+        });
+  }
+  absl::Status set_current_pass_instruction_count_after(int64_t count) {
+    return MutateCurrentHloPassMetadata(
+        [&count](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_instruction_count_after(count);
+        });
+  }
+  absl::Status set_current_pass_peak_memory_bytes(int64_t bytes) {
+    return MutateCurrentHloPassMetadata(
+        [&bytes](HloPassMetadata* pass_metadata) {
+          pass_metadata->set_peak_memory_bytes(bytes);
+        });
+  }
 
  private:
   // Gets mutable metadata for the currently running pass. If passes are nested,
@@ -141,44 +141,67 @@ class HloReachabilityMap {
  private:
   // A dynamically sized bit-set implementation specialized for this use case
   // providing fast bitwise OR (not available in tsl::gtl::BitMap).
+  //
+  // Only the range of words between the lowest and the highest set bit is
+  // stored. Instructions are numbered in post order, so an instruction can
+  // only be reached from instructions with a lower index, and instructions in
+  // independent parts of the graph only store the words spanning their own
+  // ancestors. This at least halves the memory and the work of
+  // `Build` compared to storing every bit.
+  //
+  // TODO: Add a chain decomposition (interval labelling) index as an
+  // alternative backend selectable through this API for very large
+  // computations. Its storage is O(N * number of chains) instead of O(N^2), but
+  // `SetReachable`, `Replace` and `UpdateReachabilityThroughInstruction` need
+  // an update path for it.
   class BitSet {
    public:
     BitSet() = default;
-    explicit BitSet(size_t size)
-        : size_(size), vector_((size + kBits - 1) / kBits, 0) {}
+    explicit BitSet(size_t size) : size_(size) {}
 
     // Returns the bit at the given index.
     bool Get(Index index) const {
       DCHECK(index >= 0 && index < size_);
-      return vector_[index / kBits] & (1ull << (index % kBits));
+      size_t word = index / kBits;
+      if (word < first_word_ || word >= first_word_ + words_.size()) {
+        return false;
+      }
+      return words_[word - first_word_] & (1ull << (index % kBits));
     }
 
     // Sets the bit at the given index.
     void Set(Index index) {
       DCHECK(index >= 0 && index < size_);
-      vector_[index / kBits] |= 1ull << (index % kBits);
+      size_t word = index / kBits;
+      Extend(word, word + 1);
+      words_[word - first_word_] |= 1ull << (index % kBits);
     }
 
     // Sets this bit-set to union of this bit-set and `other`.
     void operator|=(const BitSet& other) {
-      if (this == &other) return;
+      if (this == &other || other.words_.empty()) return;
       DCHECK(size_ == other.size_);
+      Extend(other.first_word_, other.first_word_ + other.words_.size());
 
       // Ease the work of the auto-vectorizer.
-      const Word* a = vector_.data();
-      const Word* b = other.vector_.data();
-      Word* __restrict out = vector_.data();
-      size_t num_words = vector_.size();
+      const Word* b = other.words_.data();
+      Word* __restrict out = words_.data() + (other.first_word_ - first_word_);
+      size_t num_words = other.words_.size();
       for (size_t i = 0; i < num_words; ++i) {
-        out[i] = a[i] | b[i];
+        out[i] |= b[i];
       }
     }
 
     // Sets the bitvector to all zeros.
-    void SetToZero() { absl::c_fill(vector_, 0); }
+    void SetToZero() {
+      words_.clear();
+      first_word_ = 0;
+    }
 
+    // The first and the last stored words are never zero, so equal sets have
+    // equal representations.
     bool operator==(const BitSet& other) const {
-      return vector_ == other.vector_;
+      return first_word_ == other.first_word_ && words_ == other.words_;
     }
     bool operator!=(const BitSet& other) const { return !(*this == other); }
 
@@ -186,8 +209,25 @@ class HloReachabilityMap {
     using Word = uint64_t;
     static constexpr size_t kBits = 64;
 
+    // Extends the stored range of words to include [begin, end).
+    void Extend(size_t begin, size_t end) {
+      if (words_.empty()) {
+        first_word_ = begin;
+        words_.assign(end - begin, 0);
+        return;
+      }
+      if (begin < first_word_) {
+        words_.insert(words_.begin(), first_word_ - begin, 0);
+        first_word_ = begin;
+      }
+      if (end > first_word_ + words_.size()) {
+        words_.resize(end - first_word_, 0);
+      }
+    }
+
     size_t size_;  // Number of bits in the set.
-    std::vector<Word> vector_;
+    size_t first_word_ = 0;  // Index of the first word in `words_`.
+    std::vector<Word> words_;
   };
 
   friend class HloReachabilityMapBitSetBenchmark;
@@ -869,55 +869,30 @@ void MutableLiteralBase::PopulateInplaceInternal(
   DCHECK(LayoutUtil::IsDenseArray(this_shape));
   char* const dest_base = static_cast<char*>(untyped_data());
   if (rank > 0) {
-    StrideConfig stride_config(this_shape, this_shape, this_shape.dimensions());
     const int64_t primitive_size =
         ShapeUtil::ByteSizeOfPrimitiveType(shape().element_type());
-    const int64_t num_elements = ShapeUtil::ElementsIn(shape());
-    // If we are rank-1 and we are `parallel`, it is better to use a smaller
-    // `step` than what `StrideConfig` does: stick the entire dimension in the
-    // inner-most loop.
-    if (parallel && this_shape.rank() == 1) {
-      const int64_t thread_count =
-          ShapeUtil::GetForEachIndexParallelThreadCount();
-      // Let's just divide up the array into small amounts per thread.
-      stride_config.dest_stride = stride_config.minor_loop_size =
-          num_elements > 32 ? std::max<int64_t>(num_elements / thread_count, 1)
-                            : num_elements;
-      stride_config.step = {stride_config.minor_loop_size};
-    }
+    const int64_t minor_dimension = LayoutUtil::Minor(this_shape.layout(), 0);
 
+    // Populates a run of elements that are contiguous in memory.
     auto init_function = [&](absl::Span<const int64_t> indexes,
-                             int thread_id) -> absl::StatusOr<bool> {
-      const int64_t index =
-          IndexUtil::MultidimensionalIndexToLinearIndex(shape(), indexes);
-      DimensionVector minor_scan_indexes(rank, 0);
-      std::copy(indexes.begin(), indexes.end(), minor_scan_indexes.begin());
-      char* dest_ptr = dest_base + index * primitive_size;
-      char* const dest_end =
-          dest_base +
-          // This handles the case where minor_loop_size does not evenly divide
-          // the most minor dimension.
-          std::min(index + stride_config.minor_loop_size, num_elements) *
-              primitive_size;
-      while (dest_ptr < dest_end) {
+                             int64_t linear_index, int64_t run_size,
+                             int thread_id) {
+      DimensionVector minor_scan_indexes(indexes.begin(), indexes.end());
+      char* dest_ptr = dest_base + linear_index * primitive_size;
+      for (int64_t i = 0; i < run_size; ++i) {
         populator(dest_ptr, minor_scan_indexes, thread_id);
-        ++minor_scan_indexes[stride_config.minor_dimension];
+        ++minor_scan_indexes[minor_dimension];
         dest_ptr += primitive_size;
       }
-      return true;
     };
     if (parallel) {
-      ShapeUtil::ForEachIndexParallel(this_shape, stride_config.base,
-                                      stride_config.dimensions,
-                                      stride_config.step, init_function);
+      ShapeUtil::ForEachIndexRunParallel(this_shape, init_function);
     } else {
-      ShapeUtil::ForEachIndex(
-          this_shape, stride_config.base, stride_config.dimensions,
-          stride_config.step,
-          [&init_function](
-              absl::Span<const int64_t> indexes) -> absl::StatusOr<bool> {
-            auto result_ignored = init_function(indexes, /*thread_id=*/-1);
-            return true;
+      ShapeUtil::ForEachIndexRun(
+          this_shape, [&](absl::Span<const int64_t> indexes,
+                          int64_t linear_index, int64_t run_size) {
+            init_function(indexes, linear_index, run_size,
+                          /*thread_id=*/-1);
           });
     }
   } else {
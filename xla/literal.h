@@ -537,6 +537,17 @@ class LiteralBase {
   absl::Status SerializeWithShapeProto(const ShapeProto& proto,
                                        OutputIterator output) const;
 
+  // Whether elements of type NativeT can be serialized to or deserialized from
+  // a char buffer with a single memcpy instead of byte by byte.
+  template <typename Iterator, typename NativeT>
+  static constexpr bool kCanCopyElements =
+      __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ &&
+      (std::is_same_v<Iterator, char*> ||
+       std::is_same_v<Iterator, const char*>) &&
+      primitive_util::BitWidth(
+          primitive_util::NativeToPrimitiveType<NativeT>()) ==
+          sizeof(NativeT) * 8;
+
   template <typename OutputIterator>
   class SerializeState {
    public:
@@ -607,6 +618,15 @@ class LiteralBase {
           }
           WriteElement(byte);
         }
+      } else if constexpr (kCanCopyElements<OutputIterator, NativeT>) {
+        // The serialized form of whole-byte elements is their little endian
+        // representation, so it can be copied in bulk on little endian hosts.
+        int64_t bytes = elements.size() * sizeof(NativeT);
+        if (bytes != 0) {
+          std::memcpy(output_, elements.data(), bytes);
+        }
+        output_ += bytes;
+        num_written_ += bytes;
       } else {
         for (NativeT element : elements) {
           WriteElement(element);
@@ -721,6 +741,16 @@ class LiteralBase {
             byte >>= bits_per_element;
           }
         }
+      } else if constexpr (kCanCopyElements<InputIterator, NativeT>) {
+        int64_t bytes = elements.size() * sizeof(NativeT);
+        if (end_ - input_ < bytes) {
+          return false;
+        }
+        if (bytes != 0) {
+          std::memcpy(elements.data(), input_, bytes);
+        }
+        input_ += bytes;
+        num_read_ += bytes;
       } else {
         for (NativeT& element : elements) {
           if (!ReadElement(element)) {
@@ -20,6 +20,7 @@ limitations under the License.
 #include <complex>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <random>
 #include <string>
@@ -2970,6 +2971,16 @@ TEST_P(LiteralSerializationTest, Test) {
   TF_ASSERT_OK_AND_ASSIGN(Literal deserialized,
                           Literal::DeserializeFromString(serialized));
   EXPECT_EQ(literal, deserialized);
+
+  // Serializing through a generic output iterator and deserializing through a
+  // generic input iterator must agree with the char buffer fast paths.
+  std::string serialized_by_iterator;
+  TF_ASSERT_OK(literal.Serialize(std::back_inserter(serialized_by_iterator)));
+  EXPECT_EQ(serialized, serialized_by_iterator);
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal deserialized_by_iterator,
+      Literal::Deserialize(serialized.begin(), serialized.end()));
+  EXPECT_EQ(literal, deserialized_by_iterator);
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -79,7 +79,7 @@ PJRT_DEFINE_STRUCT_TRAITS(PJRT_Extension_Base, next);
 // Changes include:
 // * Adding a new field to the PJRT_Api or argument structs
 // * Renaming a method or argument (doesn't affect ABI)
-#define PJRT_API_MINOR 54
+#define PJRT_API_MINOR 55
 
 // The plugin should set the major_version and minor_version of
 // PJRT_Api.pjrt_api_version to be the `PJRT_API_MAJOR` and `PJRT_API_MINOR` in
@@ -778,6 +778,26 @@ PJRT_DEFINE_STRUCT_TRAITS(PJRT_Client_BufferFromHostBuffer_Args, buffer);
 typedef PJRT_Error* PJRT_Client_BufferFromHostBuffer(
     PJRT_Client_BufferFromHostBuffer_Args* args);
 
+struct PJRT_Client_BuffersFromHostBuffers_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  // Array of `num_buffers` argument structs, each filled in as for
+  // PJRT_Client_BufferFromHostBuffer. Their `buffer` and
+  // `done_with_host_buffer` fields are set on success. Only needs to stay alive
+  // for the duration of the call.
+  PJRT_Client_BufferFromHostBuffer_Args* buffer_args;
+  size_t num_buffers;
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_Client_BuffersFromHostBuffers_Args,
+                          num_buffers);
+
+// Equivalent to calling PJRT_Client_BufferFromHostBuffer on each element of
+// `buffer_args`, in order, in a single call. If one of the copies fails, the
+// buffers and events already created by this call are destroyed, their output
+// fields are set to nullptr, and the error is returned.
+typedef PJRT_Error* PJRT_Client_BuffersFromHostBuffers(
+    PJRT_Client_BuffersFromHostBuffers_Args* args);
+
 struct PJRT_Client_CreateViewOfDeviceBuffer_Args {
   size_t struct_size;
   PJRT_Extension_Base* extension_start;
@@ -1717,6 +1737,24 @@ PJRT_DEFINE_STRUCT_TRAITS(PJRT_Buffer_ToHostBuffer_Args, event);
 typedef PJRT_Error* PJRT_Buffer_ToHostBuffer(
     PJRT_Buffer_ToHostBuffer_Args* args);
 
+struct PJRT_Buffer_ToHostBuffers_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  // Array of `num_buffers` argument structs, each filled in as for
+  // PJRT_Buffer_ToHostBuffer. Only needs to stay alive for the duration of the
+  // call.
+  PJRT_Buffer_ToHostBuffer_Args* buffer_args;
+  size_t num_buffers;
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_Buffer_ToHostBuffers_Args, num_buffers);
+
+// Equivalent to calling PJRT_Buffer_ToHostBuffer on each element of
+// `buffer_args`, in order, in a single call. If one of the calls fails, the
+// error is returned; copies already started by this call keep their `event`,
+// which the caller must still destroy.
+typedef PJRT_Error* PJRT_Buffer_ToHostBuffers(
+    PJRT_Buffer_ToHostBuffers_Args* args);
+
 struct PJRT_Buffer_OnDeviceSizeInBytes_Args {
   size_t struct_size;
   PJRT_Extension_Base* extension_start;
@@ -2246,6 +2284,9 @@ typedef struct {
 
   _PJRT_API_STRUCT_FIELD(PJRT_ExecuteContext_Create);
   _PJRT_API_STRUCT_FIELD(PJRT_ExecuteContext_Destroy);
+
+  _PJRT_API_STRUCT_FIELD(PJRT_Client_BuffersFromHostBuffers);
+  _PJRT_API_STRUCT_FIELD(PJRT_Buffer_ToHostBuffers);
 } PJRT_Api;
 
 enum {
@@ -76,12 +76,17 @@ PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args) {
           {"allocator", PJRT_NamedValue_Type::PJRT_NamedValue_kString},
           {"memory_fraction", PJRT_NamedValue_Type::PJRT_NamedValue_kFloat},
           {"preallocate", PJRT_NamedValue_Type::PJRT_NamedValue_kBool},
+          {"use_virtual_memory", PJRT_NamedValue_Type::PJRT_NamedValue_kBool},
           {"collective_memory_size",
            PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
+          {"pinned_host_memory_preallocate_size",
+           PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
           {"visible_devices", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64List},
           {"node_id", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
           {"num_nodes", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
           {"enable_mock_nccl", PJRT_NamedValue_Type::PJRT_NamedValue_kBool},
+          {"compilation_cache_dir",
+           PJRT_NamedValue_Type::PJRT_NamedValue_kString},
       });
   PJRT_RETURN_IF_ERROR(
       ValidateCreateOptions(create_options, kExpectedOptionNameAndTypes));
@@ -117,10 +122,19 @@ PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args) {
       it != create_options.end()) {
     allocator_config.preallocate = std::get<bool>(it->second);
   }
+  if (auto it = create_options.find("use_virtual_memory");
+      it != create_options.end()) {
+    allocator_config.use_virtual_memory = std::get<bool>(it->second);
+  }
   if (auto it = create_options.find("collective_memory_size");
       it != create_options.end()) {
     allocator_config.collective_memory_size = std::get<int64_t>(it->second);
   }
+  if (auto it = create_options.find("pinned_host_memory_preallocate_size");
+      it != create_options.end()) {
+    allocator_config.pinned_host_memory_preallocate_size =
+        std::get<int64_t>(it->second);
+  }
   std::optional<std::set<int>> visible_devices;
   if (auto it = create_options.find("visible_devices");
       it != create_options.end()) {
@@ -140,6 +154,11 @@ PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args) {
       it != create_options.end()) {
     enable_mock_nccl = std::get<bool>(it->second);
   }
+  std::string compilation_cache_dir;
+  if (auto it = create_options.find("compilation_cache_dir");
+      it != create_options.end()) {
+    compilation_cache_dir = std::get<std::string>(it->second);
+  }
 
   xla::GpuClientOptions options;
   options.allocator_config = allocator_config;
@@ -151,6 +170,7 @@ PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args) {
       pjrt::ToCppKeyValueStore(args->kv_get_callback, args->kv_get_user_arg,
                                args->kv_put_callback, args->kv_put_user_arg);
   options.enable_mock_nccl = enable_mock_nccl;
+  options.compilation_cache_dir = compilation_cache_dir;
   PJRT_ASSIGN_OR_RETURN(std::unique_ptr<xla::PjRtClient> client,
                         xla::GetStreamExecutorGpuClient(options));
   args->client = pjrt::CreateWrapperClient(std::move(client));
@@ -657,6 +657,42 @@ TEST_F(PjrtCApiBufferTest, ToHostBufferNoHostLayout) {
       xla::LiteralUtil::CreateR1<float>(float_data), *literal));
 }
 
+TEST_F(PjrtCApiBufferTest, ToHostBuffersBatched) {
+  constexpr int kNumTransfers = 2;
+  xla::Shape host_shape = xla::ShapeUtil::MakeShape(xla::F32, {4});
+  std::vector<xla::Literal> literals;
+  std::vector<PJRT_Buffer_ToHostBuffer_Args> buffer_args(kNumTransfers);
+  literals.reserve(kNumTransfers);
+  for (int i = 0; i < kNumTransfers; ++i) {
+    literals.emplace_back(host_shape);
+    buffer_args[i].struct_size = PJRT_Buffer_ToHostBuffer_Args_STRUCT_SIZE;
+    buffer_args[i].extension_start = nullptr;
+    buffer_args[i].src = buffer_.get();
+    buffer_args[i].host_layout = nullptr;
+    buffer_args[i].dst = literals[i].untyped_data();
+    buffer_args[i].dst_size = xla::ShapeUtil::ByteSizeOfElements(host_shape);
+    buffer_args[i].event = nullptr;
+  }
+
+  PJRT_Buffer_ToHostBuffers_Args args;
+  args.struct_size = PJRT_Buffer_ToHostBuffers_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer_args = buffer_args.data();
+  args.num_buffers = kNumTransfers;
+  PJRT_Error* error = api_->PJRT_Buffer_ToHostBuffers(&args);
+  EXPECT_EQ(error, nullptr);
+
+  std::vector<float> float_data(4);
+  std::iota(float_data.begin(), float_data.end(), 41.0f);
+  for (int i = 0; i < kNumTransfers; ++i) {
+    xla::PjRtFuture<> transfer_to_host =
+        ::pjrt::ConvertCEventToCppFuture(buffer_args[i].event, api_);
+    TF_CHECK_OK(transfer_to_host.Await());
+    EXPECT_TRUE(xla::LiteralTestUtil::Equal(
+        xla::LiteralUtil::CreateR1<float>(float_data), literals[i]));
+  }
+}
+
 TEST_F(PjrtCApiBufferTest, IncreaseAndDecreaseReferenceCount) {
   PJRT_Buffer_IncreaseExternalReferenceCount_Args increase_reference_count_args;
   increase_reference_count_args.struct_size =
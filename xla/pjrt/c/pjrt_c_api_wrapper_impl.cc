@@ -29,6 +29,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -747,6 +748,27 @@ PJRT_Error* PJRT_Client_BufferFromHostBuffer(
   return nullptr;
 }
 
+PJRT_Error* PJRT_Client_BuffersFromHostBuffers(
+    PJRT_Client_BuffersFromHostBuffers_Args* args) {
+  PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
+      "PJRT_Client_BuffersFromHostBuffers_Args",
+      PJRT_Client_BuffersFromHostBuffers_Args_STRUCT_SIZE, args->struct_size));
+  for (size_t i = 0; i < args->num_buffers; ++i) {
+    PJRT_Error* error =
+        PJRT_Client_BufferFromHostBuffer(&args->buffer_args[i]);
+    if (error != nullptr) {
+      for (size_t j = 0; j < i; ++j) {
+        delete args->buffer_args[j].buffer;
+        delete args->buffer_args[j].done_with_host_buffer;
+        args->buffer_args[j].buffer = nullptr;
+        args->buffer_args[j].done_with_host_buffer = nullptr;
+      }
+      return error;
+    }
+  }
+  return nullptr;
+}
+
 PJRT_Error* PJRT_Client_CreateViewOfDeviceBuffer(
     PJRT_Client_CreateViewOfDeviceBuffer_Args* args) {
   PJRT_ASSIGN_OR_RETURN(xla::Shape shape,
@@ -1404,34 +1426,39 @@ PJRT_Error* PJRT_LoadedExecutable_Execute(
     }
   }
 
-  std::vector<std::vector<xla::PjRtBuffer*>> cpp_argument_lists =
-      Convert2DCBuffersToCppBuffers(args->argument_lists, args->num_devices,
-                                    args->num_args);
-
   // Set send/recv callbacks in ExecuteOptions. The callbacks
-  // should call the C callbacks provided by the caller.
-  auto cpp_send_callbacks =
-      std::make_shared<std::vector<std::vector<xla::SendCallback>>>();
+  // should call the C callbacks provided by the caller. The lists are only
+  // allocated if there are callbacks, which keeps the common case cheap.
+  std::shared_ptr<std::vector<std::vector<xla::SendCallback>>>
+      cpp_send_callbacks;
   if (args->options->num_send_ops > 0) {
+    cpp_send_callbacks =
+        std::make_shared<std::vector<std::vector<xla::SendCallback>>>();
     CSendCallbackListsToCpp(args->options->send_callbacks, args->num_devices,
                             args->options->num_send_ops, *cpp_send_callbacks);
     options.send_callbacks = *cpp_send_callbacks;
     CHECK_EQ(options.send_callbacks.size(), args->num_devices);
   }
 
-  auto cpp_recv_callbacks =
-      std::make_shared<std::vector<std::vector<xla::RecvCallback>>>();
+  std::shared_ptr<std::vector<std::vector<xla::RecvCallback>>>
+      cpp_recv_callbacks;
   if (args->options->num_recv_ops > 0) {
+    cpp_recv_callbacks =
+        std::make_shared<std::vector<std::vector<xla::RecvCallback>>>();
     CRecvCallbackListsToCpp(args->options->recv_callbacks, args->num_devices,
                             args->options->num_recv_ops, *cpp_recv_callbacks);
     options.recv_callbacks = *cpp_recv_callbacks;
     CHECK_EQ(options.recv_callbacks.size(), args->num_devices);
   }
+  bool has_callbacks =
+      cpp_send_callbacks != nullptr || cpp_recv_callbacks != nullptr;
 
   if (args->execute_device == nullptr) {
+    std::vector<std::vector<xla::PjRtBuffer*>> cpp_argument_lists =
+        Convert2DCBuffersToCppBuffers(args->argument_lists, args->num_devices,
+                                      args->num_args);
     std::vector<std::vector<std::unique_ptr<xla::PjRtBuffer>>> cpp_buffer_lists;
-    if (args->device_complete_events != nullptr ||
-        !cpp_send_callbacks->empty() || !cpp_recv_callbacks->empty()) {
+    if (args->device_complete_events != nullptr || has_callbacks) {
       std::optional<std::vector<xla::PjRtFuture<>>> returned_futures;
       returned_futures.emplace();
       PJRT_ASSIGN_OR_RETURN(cpp_buffer_lists,
@@ -1442,7 +1469,7 @@ PJRT_Error* PJRT_LoadedExecutable_Execute(
       // We assume that these OnReady callbacks will fire even if
       // returned_futures is destroyed first. This is true for the
       // AsyncValue-based implementation of PjRtFuture.
-      if (!cpp_send_callbacks->empty() || !cpp_recv_callbacks->empty()) {
+      if (has_callbacks) {
         for (int i = 0; i < returned_futures->size(); ++i) {
           (*returned_futures)[i].OnReady(
               [cpp_send_callbacks, cpp_recv_callbacks](absl::Status status) {
@@ -1479,28 +1506,40 @@ PJRT_Error* PJRT_LoadedExecutable_Execute(
           "num_devices=%i",
           args->num_devices)};
     }
-    if (!cpp_send_callbacks->empty() || !cpp_recv_callbacks->empty()) {
+    if (has_callbacks) {
       return new PJRT_Error{xla::Unimplemented(
           "PJRT_Executable_Execute doesn't support using send/recv callbacks "
           "with `execute_device`.")};
     }
 
+    absl::InlinedVector<xla::PjRtBuffer*, 8> cpp_argument_list;
+    cpp_argument_list.reserve(args->num_args);
+    for (int i = 0; i < args->num_args; ++i) {
+      cpp_argument_list.push_back(args->argument_lists[0][i]->buffer.get());
+    }
+
     std::vector<std::unique_ptr<xla::PjRtBuffer>> cpp_buffer_list;
     std::optional<xla::PjRtFuture<>> returned_future;
     bool fill_future = args->device_complete_events != nullptr;
-    PJRT_ASSIGN_OR_RETURN(xla::CompileOptions compile_options,
-                          args->executable->get()->GetCompileOptions());
-    if (compile_options.compile_portable_executable) {
+    bool is_portable;
+    if (args->executable->is_portable.has_value()) {
+      is_portable = *args->executable->is_portable;
+    } else {
+      PJRT_ASSIGN_OR_RETURN(xla::CompileOptions compile_options,
+                            args->executable->get()->GetCompileOptions());
+      is_portable = compile_options.compile_portable_executable;
+    }
+    if (is_portable) {
       PJRT_ASSIGN_OR_RETURN(
           cpp_buffer_list,
           args->executable->get()->ExecutePortable(
-              cpp_argument_lists[0], args->execute_device->device, options,
+              cpp_argument_list, args->execute_device->device, options,
               returned_future, fill_future));
     } else {
       PJRT_ASSIGN_OR_RETURN(
           cpp_buffer_list,
           args->executable->get()->ExecuteSharded(
-              cpp_argument_lists[0], args->execute_device->device, options,
+              cpp_argument_list, args->execute_device->device, options,
               returned_future, fill_future));
     }
     for (int i = 0; i < cpp_buffer_list.size(); ++i) {
@@ -1823,6 +1862,19 @@ PJRT_Error* PJRT_Buffer_ToHostBuffer(PJRT_Buffer_ToHostBuffer_Args* args) {
   return nullptr;
 }
 
+PJRT_Error* PJRT_Buffer_ToHostBuffers(PJRT_Buffer_ToHostBuffers_Args* args) {
+  PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
+      "PJRT_Buffer_ToHostBuffers_Args",
+      PJRT_Buffer_ToHostBuffers_Args_STRUCT_SIZE, args->struct_size));
+  for (size_t i = 0; i < args->num_buffers; ++i) {
+    PJRT_Error* error = PJRT_Buffer_ToHostBuffer(&args->buffer_args[i]);
+    if (error != nullptr) {
+      return error;
+    }
+  }
+  return nullptr;
+}
+
 PJRT_Error* PJRT_Buffer_IsOnCpu(PJRT_Buffer_IsOnCpu_Args* args) {
   PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
       "PJRT_Buffer_IsOnCpu_Args", PJRT_Buffer_IsOnCpu_Args_STRUCT_SIZE,
@@ -2341,6 +2393,11 @@ PJRT_LoadedExecutable::PJRT_LoadedExecutable(
     std::shared_ptr<xla::PjRtLoadedExecutable> executable, PJRT_Client* client)
     : executable(std::move(executable)), client(client) {
   pjrt::PopulatePjrtExecutableAddressableDevices(this);
+  absl::StatusOr<xla::CompileOptions> compile_options =
+      this->executable->GetCompileOptions();
+  if (compile_options.ok()) {
+    is_portable = compile_options->compile_portable_executable;
+  }
 }
 
 namespace pjrt {
@@ -2519,6 +2576,10 @@ PJRT_Api CreatePjrtApi(PJRT_Client_Create* create_fn,
 
       /*PJRT_ExecuteContext_Create=*/execute_context_create_fn,
       /*PJRT_ExecuteContext_Destroy=*/pjrt::PJRT_ExecuteContext_Destroy,
+
+      /*PJRT_Client_BuffersFromHostBuffers=*/
+      pjrt::PJRT_Client_BuffersFromHostBuffers,
+      /*PJRT_Buffer_ToHostBuffers=*/pjrt::PJRT_Buffer_ToHostBuffers,
   };
 }
 
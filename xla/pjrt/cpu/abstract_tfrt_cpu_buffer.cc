@@ -466,6 +466,91 @@ PjRtFuture<> AbstractTfrtCpuBuffer::ToLiteralHelper(
   }
 }
 
+PjRtFuture<> AbstractTfrtCpuBuffer::CopyRawToHostHelper(
+    void* dst, int64_t offset, int64_t transfer_size,
+    AsyncWorkRunner* async_work_runner) {
+  std::string message = absl::StrCat(buffer_name(), "::CopyRawToHost");
+  absl::string_view message_view(message);
+  tsl::profiler::TraceMe traceme(message_view);
+  if (on_device_shape_.IsTuple()) {
+    return PjRtFuture<>(
+        InvalidArgument("CopyRawToHost not supported for tuple buffers"));
+  }
+  if (offset < 0 || transfer_size < 0) {
+    return PjRtFuture<>(InvalidArgument(
+        "CopyRawToHost called with negative offset %d or transfer size %d",
+        offset, transfer_size));
+  }
+  auto usage_event = tsl::MakeConstructedAsyncValueRef<CpuEvent>();
+  auto* device_buffer = AcquireUsage(usage_event);
+  if (device_buffer == nullptr) {
+    return PjRtFuture<>(
+        InvalidArgument("CopyRawToHost() called on deleted or donated buffer"));
+  }
+  MarkEventReadyOnExit ready_on_exit(std::move(usage_event));
+
+  int64_t buffer_size = device_buffer->BufferSizes()[0];
+  if (offset + transfer_size > buffer_size) {
+    return PjRtFuture<>(InvalidArgument(
+        "CopyRawToHost requested %d bytes at offset %d, but the buffer has "
+        "only %d bytes",
+        transfer_size, offset, buffer_size));
+  }
+
+  tsl::AsyncValueRef<MaybeOwningCpuMemory> src_buffer =
+      device_buffer->Buffers()[0];
+  tsl::AsyncValueRef<CpuEvent> definition_event =
+      device_buffer->definition_event();
+
+  auto copy_raw = [dst, offset, transfer_size](
+                      const MaybeOwningCpuMemory& src) {
+    std::memcpy(dst, static_cast<const char*>(src.data()) + offset,
+                transfer_size);
+  };
+
+  // Small copies from buffers that are already defined are done inline.
+  if (definition_event.IsAvailable() &&
+      transfer_size < kSmallDataTransferByteSize) {
+    if (auto* error = definition_event.GetErrorIfPresent()) {
+      return PjRtFuture<>(*error);
+    }
+    copy_raw(*src_buffer);
+    return PjRtFuture<>(absl::OkStatus());
+  }
+
+  PjRtFuture<>::Promise promise = PjRtFuture<>::CreatePromise();
+  async_work_runner->ScheduleWhenReady(
+      {definition_event.CopyRCRef()},
+      [definition_event, src_buffer = std::move(src_buffer), promise,
+       copy_raw = std::move(copy_raw),
+       ready_on_exit = std::move(ready_on_exit)]() mutable {
+        tsl::profiler::TraceMe traceme("D2H Raw Dispatch");
+        // Errors in src buffer are surfaced to user.
+        if (auto* error = definition_event.GetErrorIfPresent()) {
+          promise.Set(*error);
+          return;
+        }
+        copy_raw(*src_buffer);
+        promise.Set();
+      });
+  return PjRtFuture<>(
+      std::move(promise),
+      /*on_block_start=*/
+      [message]() {
+        absl::string_view message_view(message);
+        tsl::profiler::TraceMeProducer traceme(message_view);
+        VLOG(1) << message_view;
+        return PjRtFutureHelpers::ProfilingKeys(
+            {/*traceme_context_id =*/traceme.GetContextId()});
+      },
+      /*on_block_end=*/
+      [message](PjRtFutureHelpers::ProfilingKeys keys) {
+        absl::string_view message_view(message);
+        tsl::profiler::TraceMeConsumer traceme(message_view,
+                                               keys.traceme_context_id);
+      });
+}
+
 absl::StatusOr<std::unique_ptr<PjRtBuffer>>
 AbstractTfrtCpuBuffer::CopyToDeviceAcrossClients(PjRtDevice* dst_device) {
   TF_ASSIGN_OR_RETURN(std::shared_ptr<Literal> literal, ToLiteralSync());
@@ -556,6 +641,31 @@ AbstractTfrtCpuBuffer::CopyToDeviceHelper(AsyncWorkRunner* async_work_runner) {
       std::move(dst_buffers_sizes), std::move(dst_definition_events));
 }
 
+absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
+AbstractTfrtCpuBuffer::AliasDeviceBufferHelper() {
+  auto usage_event = tsl::MakeConstructedAsyncValueRef<CpuEvent>();
+  auto* src_device_buffer = AcquireUsage(usage_event);
+  if (src_device_buffer == nullptr) {
+    return InvalidArgument(
+        "CopyToMemorySpace called on deleted or donated buffer");
+  }
+  MarkEventReadyOnExit ready_on_exit(std::move(usage_event));
+
+  absl::Span<const tsl::AsyncValueRef<MaybeOwningCpuMemory>> src_buffers =
+      src_device_buffer->Buffers();
+  absl::Span<const size_t> src_buffer_sizes = src_device_buffer->BufferSizes();
+  absl::InlinedVector<tsl::AsyncValueRef<MaybeOwningCpuMemory>, 4> buffers(
+      src_buffers.begin(), src_buffers.end());
+  absl::InlinedVector<size_t, 4> buffer_sizes(src_buffer_sizes.begin(),
+                                              src_buffer_sizes.end());
+
+  // The alias shares the source's memory and definition event. It does not
+  // own the memory, so executions never write to it in place.
+  return std::make_unique<TrackedTfrtCpuDeviceBuffer>(
+      on_device_shape_.IsTuple(), /*owns_buffers=*/false, std::move(buffers),
+      std::move(buffer_sizes), src_device_buffer->definition_event());
+}
+
 PjRtFuture<> AbstractTfrtCpuBuffer::GetReadyFuture() {
   tsl::AsyncValueRef<CpuEvent> definition_event;
   {
@@ -653,12 +763,14 @@ void AbstractTfrtCpuBuffer::CopyFromLiteral(
 /*static*/ absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
 AbstractTfrtCpuBuffer::AllocateTrackedDeviceBuffer(
     const Shape& on_device_shape,
-    absl::InlinedVector<tsl::AsyncValueRef<CpuEvent>, 4> definition_events) {
+    absl::InlinedVector<tsl::AsyncValueRef<CpuEvent>, 4> definition_events,
+    int numa_node) {
   absl::InlinedVector<tsl::AsyncValueRef<MaybeOwningCpuMemory>, 4> buffers;
   if (!on_device_shape.IsTuple()) {
     size_t byte_size = ShapeUtil::ByteSizeOf(on_device_shape);
-    TF_ASSIGN_OR_RETURN(tsl::AsyncValueRef<MaybeOwningCpuMemory> device_buffer,
-                        MaybeOwningCpuMemory::AllocateAvailableAvr(byte_size));
+    TF_ASSIGN_OR_RETURN(
+        tsl::AsyncValueRef<MaybeOwningCpuMemory> device_buffer,
+        MaybeOwningCpuMemory::AllocateAvailableAvr(byte_size, numa_node));
     buffers.push_back(std::move(device_buffer));
     return std::make_unique<TrackedTfrtCpuDeviceBuffer>(
         /*is_tuple=*/false, /*owns_buffers=*/true, std::move(buffers),
@@ -668,8 +780,9 @@ AbstractTfrtCpuBuffer::AllocateTrackedDeviceBuffer(
   buffers.reserve(on_device_shape.tuple_shapes().size());
   for (const auto& leaf_shape : on_device_shape.tuple_shapes()) {
     size_t byte_size = ShapeUtil::ByteSizeOf(leaf_shape);
-    TF_ASSIGN_OR_RETURN(tsl::AsyncValueRef<MaybeOwningCpuMemory> device_buffer,
-                        MaybeOwningCpuMemory::AllocateAvailableAvr(byte_size));
+    TF_ASSIGN_OR_RETURN(
+        tsl::AsyncValueRef<MaybeOwningCpuMemory> device_buffer,
+        MaybeOwningCpuMemory::AllocateAvailableAvr(byte_size, numa_node));
     buffers.push_back(std::move(device_buffer));
   }
   return std::make_unique<TrackedTfrtCpuDeviceBuffer>(
@@ -697,8 +810,8 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
     std::optional<absl::Span<int64_t const>> byte_strides,
     PjRtClient::HostBufferSemantics host_buffer_semantics,
     absl::AnyInvocable<void() &&> on_done_with_host_buffer, const Shape& shape,
-    AsyncWorkRunner* async_work_runner, absl::Mutex* transpose_mu,
-    TransposePlanCache* transpose_cache) {
+    AsyncWorkRunner* async_work_runner, TransposePlanCache* transpose_cache,
+    int numa_node) {
   bool has_default_layout =
       !byte_strides || HasMajorToMinorLayout(type, dims, *byte_strides);
   const int bit_width = primitive_util::BitWidth(type);
@@ -732,10 +845,10 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
     // For a mutable zero copy semantics we pass a no-op deleter because
     // underlying buffer is owned by the caller and it will free it when
     // PjRt will call `on_done_with_host_buffer` callback.
-    MaybeOwningCpuMemory::OwnedDataPtr::deleter_type no_op = +[](void*) {};
     buffers.push_back(tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>(
         MaybeOwningCpuMemory::OwnedDataPtr(
-            reinterpret_cast<uint8_t*>(const_cast<void*>(data)), no_op),
+            reinterpret_cast<uint8_t*>(const_cast<void*>(data)),
+            [](void*) {}),
         byte_size));
     on_delete_callback = std::move(on_done_with_host_buffer);
 
@@ -751,7 +864,7 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
         is_packed ? CeilOfRatio<size_t>(byte_size, 8 / bit_width) : byte_size;
     TF_ASSIGN_OR_RETURN(
         tsl::AsyncValueRef<MaybeOwningCpuMemory> device_buffer,
-        MaybeOwningCpuMemory::AllocateAvailableAvr(dst_byte_size));
+        MaybeOwningCpuMemory::AllocateAvailableAvr(dst_byte_size, numa_node));
     auto dst_data_ptr = device_buffer->data();
     buffers.push_back(device_buffer);
     if (!has_default_layout || is_packed) {
@@ -769,7 +882,6 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
         options.dims = dims;
         options.permutation = permutation;
         options.input_layout = TransposePlan::Striding{*byte_strides};
-        absl::MutexLock lock(transpose_mu);
         TF_ASSIGN_OR_RETURN(transpose, transpose_cache->GetOrCreate(options));
       }
       if (!is_packed) {
@@ -903,10 +1015,8 @@ absl::Status
 AbstractAsyncHostToHostMemoryTransferManager::TransferRawDataToSubBuffer(
     int buffer_index, const void* data, int64_t offset, int64_t transfer_size,
     bool is_last_transfer, absl::AnyInvocable<void() &&> on_done) {
+  char* dst;
   {
-    // We release the lock when out of scope because
-    // `async_work_runner_->Schedule` might sometimes run the closure in this
-    // thread!
     absl::MutexLock l(&mu_);
 
     CHECK_GE(buffer_index, 0);
@@ -915,19 +1025,20 @@ AbstractAsyncHostToHostMemoryTransferManager::TransferRawDataToSubBuffer(
     CHECK(!last_transfer_finished_[buffer_index]);
     ++buffer_transfers_in_flight_[buffer_index];
     ++transfers_in_flight_;
+
+    const auto& b = device_buffers_[buffer_index]->Buffers()[0];
+    CHECK(b.IsConcrete());
+    dst = reinterpret_cast<char*>(b->data()) + offset;
   }
 
-  CHECK(async_work_runner_ != nullptr);
-  async_work_runner_->Schedule([this, data, offset, transfer_size,
-                                is_last_transfer, on_done = std::move(on_done),
-                                buffer_index]() mutable -> void {
+  // Chunks write disjoint ranges of the destination buffer, so they are copied
+  // without holding `mu_` and may proceed concurrently.
+  auto transfer = [this, dst, data, transfer_size, is_last_transfer,
+                   on_done = std::move(on_done), buffer_index]() mutable {
+    std::memcpy(dst, data, transfer_size);
     tsl::RCReference<tsl::AsyncValue> event;
     {
       absl::MutexLock l(&mu_);
-      const auto& b = device_buffers_[buffer_index]->Buffers()[0];
-      CHECK(b.IsConcrete());
-      std::memcpy(reinterpret_cast<char*>(b->data()) + offset, data,
-                  transfer_size);
       if (is_last_transfer) {
         last_transfer_finished_[buffer_index] = true;
       }
@@ -941,17 +1052,28 @@ AbstractAsyncHostToHostMemoryTransferManager::TransferRawDataToSubBuffer(
     // Call on_done outside the lock because it may call
     // ~AbstractAsyncHostToHostMemoryTransferManager.
     std::move(on_done)();
-    if (event) {
+    if (event && event->IsUnavailable()) {
       event->SetStateConcrete();
     }
-  });
+  };
+
+  // Small chunks are cheaper to copy than to hand off to another thread.
+  if (transfer_size < kSmallDataTransferByteSize) {
+    transfer();
+    return absl::OkStatus();
+  }
+  CHECK(async_work_runner_ != nullptr);
+  async_work_runner_->Schedule(std::move(transfer));
   return absl::OkStatus();
 }
 
 void AbstractAsyncHostToHostMemoryTransferManager::SetBufferError(
     int buffer_index, absl::Status error) {
   absl::MutexLock l(&mu_);
-  avs_[buffer_index]->SetError(error);
+  // The buffer may already be defined by its last transfer.
+  if (avs_[buffer_index] && avs_[buffer_index]->IsUnavailable()) {
+    avs_[buffer_index]->SetError(error);
+  }
 }
 
 /*static*/ absl::Status
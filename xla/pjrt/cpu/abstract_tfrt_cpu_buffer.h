@@ -47,6 +47,7 @@ limitations under the License.
 #include "xla/tsl/concurrency/ref_count.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/numa.h"
 
 namespace xla {
 
@@ -210,11 +211,13 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
       AsyncWorkRunner* async_work_runner);
 
   // Allocates a new `TrackedTfrtCpuDeviceBuffer` with the given shape and
-  // definition events.
+  // definition events. Buffers are placed on `numa_node` if it is not
+  // `tsl::port::kNUMANoAffinity`.
   static absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
   AllocateTrackedDeviceBuffer(
       const Shape& on_device_shape,
-      absl::InlinedVector<tsl::AsyncValueRef<CpuEvent>, 4> definition_events);
+      absl::InlinedVector<tsl::AsyncValueRef<CpuEvent>, 4> definition_events,
+      int numa_node = tsl::port::kNUMANoAffinity);
 
   // Allocates new cpu events to `avs` and `definition_events`. If `shape` is a
   // tuple, multiple events will be allocated. Otherwise, `avs` and
@@ -226,8 +229,8 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
 
   // A helper function for PjRtClient::BufferFromHostBuffer. Creates a new cpu
   // device buffer from the host buffer (maybe zero-copy or async).
-  // `transpose_mu` and `transpose_cache` are used to transpose the input
-  // layout.
+  // `transpose_cache` is used to transpose the input layout. Copied buffers are
+  // placed on `numa_node` if it is not `tsl::port::kNUMANoAffinity`.
   static absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
   BufferFromHostBufferHelper(
       const void* data, PrimitiveType type, absl::Span<int64_t const> dims,
@@ -235,7 +238,8 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
       PjRtClient::HostBufferSemantics host_buffer_semantics,
       absl::AnyInvocable<void() &&> on_done_with_host_buffer,
       const Shape& shape, AsyncWorkRunner* async_work_runner,
-      absl::Mutex* transpose_mu, TransposePlanCache* transpose_cache);
+      TransposePlanCache* transpose_cache,
+      int numa_node = tsl::port::kNUMANoAffinity);
 
  protected:
   virtual absl::string_view buffer_name() const = 0;
@@ -243,12 +247,25 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
   PjRtFuture<> ToLiteralHelper(MutableLiteralBase* literal,
                                AsyncWorkRunner* async_work_runner);
 
+  // Copies `transfer_size` bytes starting at `offset` of the (non-tuple)
+  // buffer into `dst` once the buffer is defined. The copy is dispatched on
+  // `async_work_runner` unless the buffer is already available.
+  PjRtFuture<> CopyRawToHostHelper(void* dst, int64_t offset,
+                                   int64_t transfer_size,
+                                   AsyncWorkRunner* async_work_runner);
+
   absl::StatusOr<std::unique_ptr<PjRtBuffer>> CopyToDeviceAcrossClients(
       PjRtDevice* dst_device);
 
   absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
   CopyToDeviceHelper(AsyncWorkRunner* async_work_runner);
 
+  // Returns a tracked device buffer that aliases the memory of this buffer
+  // without copying. The returned buffer does not own its memory, so it is
+  // never donated to an execution and keeps the source memory alive.
+  absl::StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
+  AliasDeviceBufferHelper();
+
   bool IsEmptyTuple() const {
     return on_device_shape_.IsTuple() &&
            on_device_shape_.tuple_shapes_size() == 0;
@@ -328,6 +345,10 @@ class AbstractAsyncHostToHostMemoryTransferManager
       int buffer_index, absl::string_view data,
       absl::AnyInvocable<void() &&> on_done) override;
 
+  // Copies the chunk straight into the destination buffer. Small chunks are
+  // copied on the calling thread, larger ones on `async_work_runner`. Chunks
+  // of different buffers, or of the same buffer, are copied concurrently; a
+  // buffer becomes ready once its last transfer and all earlier ones landed.
   absl::Status TransferRawDataToSubBuffer(
       int buffer_index, const void* data, int64_t offset, int64_t transfer_size,
       bool is_last_transfer, absl::AnyInvocable<void() &&> on_done) override;
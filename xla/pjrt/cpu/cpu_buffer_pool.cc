@@ -0,0 +1,179 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/numeric/bits.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/cpu_function_runtime.h"
+#include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
+#include "xla/tsl/framework/allocator.h"
+#include "xla/util.h"
+#include "tsl/platform/mem.h"
+
+namespace xla {
+
+std::shared_ptr<CpuBufferPool> CpuBufferPool::Create(
+    size_t max_retained_bytes) {
+  return std::shared_ptr<CpuBufferPool>(new CpuBufferPool(max_retained_bytes));
+}
+
+CpuBufferPool::CpuBufferPool(size_t max_retained_bytes)
+    : max_retained_bytes_(max_retained_bytes) {
+  stats_.pool_bytes = 0;
+  stats_.peak_pool_bytes = 0;
+}
+
+CpuBufferPool::~CpuBufferPool() { Trim(); }
+
+int CpuBufferPool::SizeClassIndex(size_t size) {
+  if (size > kMaxSizeClass) return -1;
+  size_t size_class = absl::bit_ceil(std::max(size, kMinSizeClass));
+  return absl::countr_zero(size_class) - absl::countr_zero(kMinSizeClass);
+}
+
+CpuBufferPool::Shard& CpuBufferPool::ThisThreadShard() {
+  size_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+  return shards_[hash % kNumShards];
+}
+
+void* CpuBufferPool::TakeFreeBuffer(int index) {
+  Shard* own_shard = &ThisThreadShard();
+  void* data = nullptr;
+
+  auto pop = [&](Shard& shard) {
+    absl::MutexLock lock(&shard.mu);
+    std::vector<void*>& free_list = shard.free_lists[index];
+    if (free_list.empty()) return false;
+    data = free_list.back();
+    free_list.pop_back();
+    return true;
+  };
+
+  // Check the calling thread's shard first, then steal from the others.
+  bool found = pop(*own_shard);
+  for (int i = 0; !found && i < kNumShards; ++i) {
+    if (&shards_[i] != own_shard) found = pop(shards_[i]);
+  }
+  if (!found) return nullptr;
+
+  absl::MutexLock lock(&stats_mu_);
+  retained_bytes_ -= SizeClassBytes(index);
+  UpdatePoolBytes();
+  return data;
+}
+
+void CpuBufferPool::Release(void* data, int index) {
+  int64_t bytes = SizeClassBytes(index);
+  {
+    absl::MutexLock lock(&stats_mu_);
+    if (retained_bytes_ + bytes > static_cast<int64_t>(max_retained_bytes_)) {
+      tsl::port::AlignedFree(data);
+      return;
+    }
+    retained_bytes_ += bytes;
+    UpdatePoolBytes();
+  }
+  Shard& shard = ThisThreadShard();
+  absl::MutexLock lock(&shard.mu);
+  shard.free_lists[index].push_back(data);
+}
+
+void CpuBufferPool::UpdatePoolBytes() {
+  stats_.pool_bytes = stats_.bytes_in_use + retained_bytes_;
+  stats_.peak_pool_bytes = std::max(*stats_.peak_pool_bytes,
+                                    *stats_.pool_bytes);
+}
+
+void CpuBufferPool::RecordAllocation(size_t bytes) {
+  absl::MutexLock lock(&stats_mu_);
+  ++stats_.num_allocs;
+  stats_.bytes_in_use += bytes;
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.largest_alloc_size =
+      std::max<int64_t>(stats_.largest_alloc_size, bytes);
+  UpdatePoolBytes();
+}
+
+void CpuBufferPool::RecordDeallocation(size_t bytes) {
+  absl::MutexLock lock(&stats_mu_);
+  stats_.bytes_in_use -= bytes;
+  UpdatePoolBytes();
+}
+
+absl::StatusOr<MaybeOwningCpuMemory> CpuBufferPool::Allocate(size_t size) {
+  int index = SizeClassIndex(size);
+  size_t bytes = index < 0 ? size : SizeClassBytes(index);
+
+  void* data = index < 0 ? nullptr : TakeFreeBuffer(index);
+  if (data == nullptr) {
+    data = tsl::port::AlignedMalloc(bytes, cpu_function_runtime::MinAlign());
+    if (data == nullptr) {
+      return ResourceExhausted("Out of memory allocating %d bytes.", bytes);
+    }
+  }
+  RecordAllocation(bytes);
+
+  auto deleter = [pool = shared_from_this(), index, bytes](void* ptr) {
+    pool->RecordDeallocation(bytes);
+    if (index < 0) {
+      tsl::port::AlignedFree(ptr);
+    } else {
+      pool->Release(ptr, index);
+    }
+  };
+  return MaybeOwningCpuMemory(
+      MaybeOwningCpuMemory::OwnedDataPtr{static_cast<uint8_t*>(data),
+                                         std::move(deleter)},
+      size);
+}
+
+void CpuBufferPool::Trim() {
+  for (Shard& shard : shards_) {
+    std::array<std::vector<void*>, kNumSizeClasses> free_lists;
+    {
+      absl::MutexLock lock(&shard.mu);
+      std::swap(free_lists, shard.free_lists);
+    }
+    size_t freed_bytes = 0;
+    for (int index = 0; index < kNumSizeClasses; ++index) {
+      for (void* data : free_lists[index]) {
+        tsl::port::AlignedFree(data);
+        freed_bytes += SizeClassBytes(index);
+      }
+    }
+    absl::MutexLock lock(&stats_mu_);
+    retained_bytes_ -= freed_bytes;
+    UpdatePoolBytes();
+  }
+}
+
+tsl::AllocatorStats CpuBufferPool::GetStats() const {
+  absl::MutexLock lock(&stats_mu_);
+  return stats_;
+}
+
+}  // namespace xla
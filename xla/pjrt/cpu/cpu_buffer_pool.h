@@ -0,0 +1,116 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_CPU_CPU_BUFFER_POOL_H_
+#define XLA_PJRT_CPU_CPU_BUFFER_POOL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
+#include "xla/tsl/framework/allocator.h"
+
+namespace xla {
+
+// A size-class pooling allocator for host buffers owned by TfrtCpuClient.
+//
+// Allocations are rounded up to a power of two size class and are returned to
+// the pool when the owning MaybeOwningCpuMemory is destroyed. TfrtCpuBuffer
+// destroys its memory only after the last usage event completes, so a pooled
+// buffer is never reused while a computation still reads from it. Reusing
+// buffers avoids both the allocator calls and the page faults on first touch
+// of freshly mapped pages.
+//
+// Free buffers are kept in a small number of shards selected by the calling
+// thread, which acts as a per-thread cache without tying the pool lifetime to
+// thread-local storage. A thread that finds its shard empty steals from other
+// shards before falling back to a fresh allocation.
+class CpuBufferPool : public std::enable_shared_from_this<CpuBufferPool> {
+ public:
+  // Smallest size class; smaller allocations are rounded up to it.
+  static constexpr size_t kMinSizeClass = 64;
+
+  // Allocations larger than this are never pooled.
+  static constexpr size_t kMaxSizeClass = 16 * 1024 * 1024;
+
+  // Creates a pool that retains at most `max_retained_bytes` of free buffers.
+  static std::shared_ptr<CpuBufferPool> Create(size_t max_retained_bytes);
+
+  CpuBufferPool(const CpuBufferPool&) = delete;
+  CpuBufferPool& operator=(const CpuBufferPool&) = delete;
+  ~CpuBufferPool();
+
+  // Allocates owning memory of `size` bytes aligned to
+  // `cpu_function_runtime::MinAlign()`. The memory keeps the pool alive and
+  // goes back to it when destroyed.
+  absl::StatusOr<MaybeOwningCpuMemory> Allocate(size_t size);
+
+  // Frees all buffers retained by the pool.
+  void Trim();
+
+  // Returns allocation stats. `pool_bytes` counts both the bytes in use and
+  // the bytes retained by the pool.
+  tsl::AllocatorStats GetStats() const;
+
+  size_t max_retained_bytes() const { return max_retained_bytes_; }
+
+ private:
+  static constexpr int kNumShards = 16;
+  static constexpr int kNumSizeClasses = 19;  // 64B to 16MiB.
+  static_assert(kMinSizeClass << (kNumSizeClasses - 1) == kMaxSizeClass);
+
+  struct Shard {
+    absl::Mutex mu;
+    std::array<std::vector<void*>, kNumSizeClasses> free_lists
+        ABSL_GUARDED_BY(mu);
+  };
+
+  explicit CpuBufferPool(size_t max_retained_bytes);
+
+  // Returns the size class index for `size`, or -1 if `size` is not pooled.
+  static int SizeClassIndex(size_t size);
+  static size_t SizeClassBytes(int index) { return kMinSizeClass << index; }
+
+  Shard& ThisThreadShard();
+
+  // Pops a free buffer of the given size class, or returns nullptr.
+  void* TakeFreeBuffer(int index);
+
+  // Returns `data` of the given size class to the pool, or frees it if the
+  // pool already retains `max_retained_bytes_`.
+  void Release(void* data, int index);
+
+  // Accounts for `bytes` handed out to the user.
+  void RecordAllocation(size_t bytes);
+  void RecordDeallocation(size_t bytes);
+  void UpdatePoolBytes() ABSL_EXCLUSIVE_LOCKS_REQUIRED(stats_mu_);
+
+  const size_t max_retained_bytes_;
+  std::array<Shard, kNumShards> shards_;
+
+  mutable absl::Mutex stats_mu_;
+  int64_t retained_bytes_ ABSL_GUARDED_BY(stats_mu_) = 0;
+  tsl::AllocatorStats stats_ ABSL_GUARDED_BY(stats_mu_);
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_CPU_CPU_BUFFER_POOL_H_
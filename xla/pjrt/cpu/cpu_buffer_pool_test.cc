@@ -0,0 +1,116 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
+#include "xla/tsl/framework/allocator.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+namespace {
+
+TEST(CpuBufferPoolTest, ReusesFreedBuffers) {
+  auto pool = CpuBufferPool::Create(/*max_retained_bytes=*/1024 * 1024);
+
+  void* data;
+  {
+    TF_ASSERT_OK_AND_ASSIGN(MaybeOwningCpuMemory memory, pool->Allocate(1000));
+    EXPECT_EQ(memory.size(), 1000);
+    EXPECT_TRUE(memory.owns_data());
+    data = memory.data();
+  }
+
+  // Allocations in the same size class get the freed buffer back.
+  TF_ASSERT_OK_AND_ASSIGN(MaybeOwningCpuMemory memory, pool->Allocate(900));
+  EXPECT_EQ(memory.data(), data);
+
+  tsl::AllocatorStats stats = pool->GetStats();
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+  EXPECT_EQ(stats.peak_bytes_in_use, 1024);
+  EXPECT_EQ(stats.largest_alloc_size, 1024);
+  EXPECT_EQ(stats.pool_bytes, 1024);
+}
+
+TEST(CpuBufferPoolTest, RespectsRetainedBytesLimit) {
+  auto pool = CpuBufferPool::Create(/*max_retained_bytes=*/4096);
+
+  std::vector<MaybeOwningCpuMemory> buffers;
+  for (int i = 0; i < 4; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(MaybeOwningCpuMemory memory, pool->Allocate(2048));
+    buffers.push_back(std::move(memory));
+  }
+  EXPECT_EQ(pool->GetStats().bytes_in_use, 4 * 2048);
+
+  buffers.clear();
+  tsl::AllocatorStats stats = pool->GetStats();
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.pool_bytes, 4096);
+  EXPECT_EQ(stats.peak_pool_bytes, 4 * 2048);
+
+  pool->Trim();
+  EXPECT_EQ(pool->GetStats().pool_bytes, 0);
+}
+
+TEST(CpuBufferPoolTest, LargeAllocationsAreNotPooled) {
+  auto pool = CpuBufferPool::Create(/*max_retained_bytes=*/1024 * 1024 * 1024);
+  int64_t size = CpuBufferPool::kMaxSizeClass + 1;
+  {
+    TF_ASSERT_OK_AND_ASSIGN(MaybeOwningCpuMemory memory, pool->Allocate(size));
+    EXPECT_EQ(pool->GetStats().bytes_in_use, size);
+  }
+  tsl::AllocatorStats stats = pool->GetStats();
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.pool_bytes, 0);
+}
+
+TEST(CpuBufferPoolTest, BuffersOutliveThePoolHandle) {
+  auto pool = CpuBufferPool::Create(/*max_retained_bytes=*/1024);
+  TF_ASSERT_OK_AND_ASSIGN(MaybeOwningCpuMemory memory, pool->Allocate(64));
+  pool.reset();
+  static_cast<char*>(memory.data())[0] = 42;
+}
+
+TEST(CpuBufferPoolTest, ConcurrentAllocations) {
+  auto pool = CpuBufferPool::Create(/*max_retained_bytes=*/1024 * 1024);
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 8);
+    for (int i = 0; i < 64; ++i) {
+      thread_pool.Schedule([&pool, i] {
+        for (int j = 0; j < 100; ++j) {
+          auto memory = pool->Allocate(64 << (i % 8));
+          ASSERT_TRUE(memory.ok());
+          static_cast<char*>(memory->data())[0] = 1;
+        }
+      });
+    }
+  }
+  tsl::AllocatorStats stats = pool->GetStats();
+  EXPECT_EQ(stats.num_allocs, 64 * 100);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+}  // namespace
+}  // namespace xla
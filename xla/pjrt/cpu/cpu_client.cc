@@ -30,6 +30,11 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "absl/algorithm/container.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -41,6 +46,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
@@ -60,6 +66,7 @@ limitations under the License.
 #include "xla/literal_util.h"
 #include "xla/pjrt/compile_options.pb.h"
 #include "xla/pjrt/cpu/abstract_tfrt_cpu_buffer.h"
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
 #include "xla/pjrt/cpu/cpu_topology.h"
 #include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
 #include "xla/pjrt/host_memory_spaces.h"
@@ -87,6 +94,7 @@ limitations under the License.
 #include "xla/service/cpu/runtime/task.h"
 #include "xla/service/cpu/runtime/thunk.h"
 #include "xla/service/cpu/runtime/thunk_executor.h"
+#include "xla/service/cpu/runtime/work_stealing_task_runner.h"
 #include "xla/service/cpu/simple_orc_jit.h"
 #include "xla/service/custom_call_status.h"
 #include "xla/service/custom_call_status_internal.h"
@@ -104,11 +112,13 @@ limitations under the License.
 #include "xla/tsl/concurrency/async_value.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
 #include "xla/tsl/concurrency/ref_count.h"
+#include "xla/tsl/framework/allocator.h"
 #include "xla/util.h"
 #include "xla/xla.pb.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/lib/strings/proto_serialization.h"
 #include "tsl/platform/casts.h"
+#include "tsl/platform/cpu_info.h"
 #include "tsl/platform/denormal.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
@@ -129,7 +139,8 @@ absl::StatusOr<std::unique_ptr<TfrtCpuBuffer>> AllocateDestinationBuffer(
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<TrackedTfrtCpuDeviceBuffer> tracked_device_buffer,
       AbstractTfrtCpuBuffer::AllocateTrackedDeviceBuffer(
-          on_device_shape, std::move(definition_events)));
+          on_device_shape, std::move(definition_events),
+          device->numa_node()));
   return std::make_unique<TfrtCpuBuffer>(
       on_device_shape, std::move(tracked_device_buffer), client, device,
       *device->default_memory_space());
@@ -189,6 +200,42 @@ class ThreadPoolAsyncWorkRunner : public AsyncWorkRunner {
   tsl::thread::ThreadPool* pool_;
 };
 
+// An Env that pins the threads it starts to a set of logical CPUs.
+class CpuPinningEnv : public tsl::EnvWrapper {
+ public:
+  CpuPinningEnv(tsl::Env* target, absl::Span<const int> cpus)
+      : tsl::EnvWrapper(target), cpus_(cpus.begin(), cpus.end()) {}
+
+  tsl::Thread* StartThread(const tsl::ThreadOptions& thread_options,
+                           const std::string& name,
+                           absl::AnyInvocable<void()> fn) override {
+    return tsl::EnvWrapper::StartThread(
+        thread_options, name, [cpus = cpus_, fn = std::move(fn)]() mutable {
+          PinCurrentThread(cpus);
+          fn();
+        });
+  }
+
+ private:
+  static void PinCurrentThread(absl::Span<const int> cpus) {
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    if (int error =
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        error != 0) {
+      LOG(WARNING) << "Failed to pin thread to CPUs "
+                   << absl::StrJoin(cpus, ",") << ": " << strerror(error);
+    }
+#endif
+  }
+
+  std::vector<int> cpus_;
+};
+
 class TfrtCpuAsyncHostToDeviceTransferManager
     : public AbstractAsyncHostToHostMemoryTransferManager {
  public:
@@ -227,8 +274,8 @@ class TfrtCpuAsyncHostToDeviceTransferManager
     return absl::WrapUnique(new TfrtCpuAsyncHostToDeviceTransferManager(
         std::move(avs), std::move(buffers), std::move(device_buffers),
         std::move(buffer_sizes), std::move(buffer_transfers_in_flight),
-        std::move(last_transfer_finished), client->async_work_runner(),
-        device));
+        std::move(last_transfer_finished),
+        client->async_work_runner(*device), device));
   }
 
   PjRtDevice* device() const override { return device_; }
@@ -282,8 +329,11 @@ absl::string_view TfrtCpuDeviceDescription::ToString() const {
   std::vector<CpuTopology::CpuDevice> cpu_devices;
   cpu_devices.reserve(devices.size());
   for (auto& device : devices) {
-    cpu_devices.push_back(CpuTopology::CpuDevice{device->process_index(),
-                                                 device->local_hardware_id()});
+    cpu_devices.push_back(CpuTopology::CpuDevice{
+        device->process_index(), device->local_hardware_id(),
+        device->numa_node(),
+        std::vector<int>(device->cpus().begin(), device->cpus().end()),
+        device->l3_domain()});
   }
   return TfrtCpuTopologyDescription(platform_id, platform_name,
                                     platform_version, cpu_devices,
@@ -316,8 +366,12 @@ TfrtCpuTopologyDescription::DeviceDescriptions() const {
 }
 
 TfrtCpuDevice::TfrtCpuDevice(int process_id, int local_device_id,
-                             int max_inflight_computations)
+                             int max_inflight_computations, int numa_node,
+                             std::vector<int> cpus, int l3_domain)
     : description_(process_id, local_device_id),
+      numa_node_(numa_node),
+      cpus_(std::move(cpus)),
+      l3_domain_(l3_domain),
       max_inflight_computations_semaphore_(
           /*capacity=*/max_inflight_computations) {}
 
@@ -373,6 +427,16 @@ absl::StatusOr<PjRtMemorySpace*> TfrtCpuDevice::memory_space_by_kind_id(
   return it->second;
 }
 
+absl::StatusOr<tsl::AllocatorStats> TfrtCpuDevice::GetAllocatorStats() const {
+  CpuBufferPool* buffer_pool =
+      tensorflow::down_cast<TfrtCpuClient*>(client_)->buffer_pool();
+  if (buffer_pool == nullptr) {
+    return Unimplemented(
+        "GetAllocatorStats requires a client with a buffer pool");
+  }
+  return buffer_pool->GetStats();
+}
+
 static int CpuDeviceCount() {
   // By default we fix the number of devices to one.  However we do let the user
   // override this behavior to help run tests on the host that run models in
@@ -386,17 +450,42 @@ absl::StatusOr<std::unique_ptr<PjRtClient>> GetTfrtCpuClient(
   int cpu_device_count = options.cpu_device_count.value_or(CpuDeviceCount());
   size_t num_threads = std::max(DefaultThreadPoolSize(), cpu_device_count);
 
+  // Assign devices to NUMA nodes round-robin if requested.
+  int num_numa_nodes = 0;
+  if (options.numa_aware && tsl::port::NUMAEnabled()) {
+    num_numa_nodes = tsl::port::NUMANumNodes();
+  }
+
+  // Partition the host cores between devices if requested.
+  std::vector<CpuCoreSet> core_sets(cpu_device_count);
+  if (options.pin_devices_to_cores) {
+    std::vector<CpuCore> cores = DetectCpuCores();
+    if (cores.empty()) {
+      LOG(WARNING) << "Host CPU topology is unknown; CPU devices are not "
+                      "pinned to cores.";
+    } else {
+      core_sets = PartitionCpuCores(cores, cpu_device_count);
+    }
+  }
+
   std::vector<std::unique_ptr<TfrtCpuDevice>> devices;
   for (int i = 0; i < cpu_device_count; ++i) {
+    int numa_node =
+        num_numa_nodes > 0 ? i % num_numa_nodes : tsl::port::kNUMANoAffinity;
     auto device = std::make_unique<TfrtCpuDevice>(
         options.process_id, /*local_device_id=*/i,
-        options.max_inflight_computations_per_device);
+        options.max_inflight_computations_per_device, numa_node,
+        std::move(core_sets[i].cpus), core_sets[i].l3_domain);
     devices.push_back(std::move(device));
   }
 
+  size_t intra_op_num_threads =
+      options.intra_op_parallelism.value_or(DefaultThreadPoolSize());
+
   return std::unique_ptr<PjRtClient>(std::make_unique<TfrtCpuClient>(
       options.process_id, std::move(devices), std::move(options.collectives),
-      num_threads, options.asynchronous));
+      num_threads, intra_op_num_threads, options.asynchronous,
+      options.buffer_pool_max_retained_bytes));
 }
 
 static tsl::ThreadOptions GetThreadOptions() {
@@ -412,7 +501,8 @@ static tsl::ThreadOptions GetThreadOptions() {
 TfrtCpuClient::TfrtCpuClient(
     int process_index, std::vector<std::unique_ptr<TfrtCpuDevice>> devices,
     std::shared_ptr<cpu::CollectivesInterface> collectives, size_t num_threads,
-    bool asynchronous)
+    size_t intra_op_num_threads, bool asynchronous,
+    size_t buffer_pool_max_retained_bytes)
     : process_index_(process_index),
       owned_devices_(std::move(devices)),
       computation_placer_(std::make_unique<ComputationPlacer>()),
@@ -422,18 +512,21 @@ TfrtCpuClient::TfrtCpuClient(
       async_work_runner_(std::make_unique<ThreadPoolAsyncWorkRunner>(
           pjrt_client_thread_pool_.get())),
       eigen_intraop_pool_(new tsl::thread::ThreadPool(
-          tsl::Env::Default(), "XLAEigen", DefaultThreadPoolSize())),
+          tsl::Env::Default(), "XLAEigen", intra_op_num_threads)),
       eigen_intraop_device_(
           new Eigen::ThreadPoolDevice(eigen_intraop_pool_->AsEigenThreadPool(),
                                       eigen_intraop_pool_->NumThreads())),
       last_collective_launch_event_(
           tsl::MakeAvailableAsyncValueRef<CpuEvent>()),
-      transpose_cache_(1024),
+      transpose_cache_(1024, /*num_shards=*/16),
       collectives_(std::move(collectives)),
       topology_(TfrtCpuTopologyDescription::Create(
           platform_id(), platform_name(), platform_version(), owned_devices_,
           cpu::DetectMachineAttributes())),
       asynchronous_(asynchronous) {
+  if (buffer_pool_max_retained_bytes > 0) {
+    buffer_pool_ = CpuBufferPool::Create(buffer_pool_max_retained_bytes);
+  }
   for (const std::unique_ptr<TfrtCpuDevice>& device : owned_devices_) {
     devices_.push_back(device.get());
     CHECK(
@@ -450,6 +543,11 @@ TfrtCpuClient::TfrtCpuClient(
       addressable_devices_[idx] = device.get();
     }
   }
+  // Pinned host memory space ids are allocated after the largest device id.
+  int pinned_host_id_base = 0;
+  for (const auto& device : owned_devices_) {
+    pinned_host_id_base = std::max(pinned_host_id_base, device->id() + 1);
+  }
   for (int idx = 0; idx < addressable_devices_.size(); ++idx) {
     auto* const device = addressable_devices_[idx];
     CHECK(device != nullptr) << idx;
@@ -462,11 +560,107 @@ TfrtCpuClient::TfrtCpuClient(
         memory_space.get());
     memory_spaces_.push_back(memory_space.get());
     owned_memory_spaces_.push_back(std::move(memory_space));
+
+    // All host memory is pinned from the CPU's point of view. The pinned host
+    // memory space lets clients alias buffers into it without copying.
+    auto pinned_memory_space = std::make_unique<PinnedHostMemorySpace>(
+        pinned_host_id_base + id, device);
+    tensorflow::down_cast<TfrtCpuDevice*>(device)->AttachMemorySpace(
+        pinned_memory_space.get());
+    memory_spaces_.push_back(pinned_memory_space.get());
+    owned_memory_spaces_.push_back(std::move(pinned_memory_space));
+  }
+
+  // Create intra-op thread pools pinned to NUMA nodes of addressable devices.
+  for (PjRtDevice* device : addressable_devices_) {
+    int numa_node = tensorflow::down_cast<TfrtCpuDevice*>(device)->numa_node();
+    if (numa_node == tsl::port::kNUMANoAffinity) continue;
+
+    if (numa_node >= numa_intraop_pools_.size()) {
+      numa_intraop_pools_.resize(numa_node + 1);
+      numa_intraop_devices_.resize(numa_node + 1);
+    }
+    if (numa_intraop_pools_[numa_node] != nullptr) continue;
+
+    tsl::ThreadOptions thread_options;
+    thread_options.numa_node = numa_node;
+    int num_threads = std::max(
+        1, std::min<int>(intra_op_num_threads,
+                         tsl::port::MaxParallelism(numa_node)));
+    auto& pool = numa_intraop_pools_[numa_node];
+    pool = std::make_unique<tsl::thread::ThreadPool>(
+        tsl::Env::Default(), thread_options,
+        absl::StrCat("XLAEigenNuma", numa_node), num_threads);
+    numa_intraop_devices_[numa_node] =
+        std::make_unique<Eigen::ThreadPoolDevice>(pool->AsEigenThreadPool(),
+                                                  pool->NumThreads());
+  }
+
+  // Create thread pools pinned to the cores of addressable devices.
+  pinned_device_pools_.resize(addressable_devices_.size());
+  for (int idx = 0; idx < addressable_devices_.size(); ++idx) {
+    auto* device =
+        tensorflow::down_cast<TfrtCpuDevice*>(addressable_devices_[idx]);
+    if (device->cpus().empty()) continue;
+
+    auto pools = std::make_unique<PinnedDeviceThreadPools>();
+    pools->env =
+        std::make_unique<CpuPinningEnv>(tsl::Env::Default(), device->cpus());
+    int num_threads = device->cpus().size();
+    pools->pjrt_client_thread_pool = std::make_unique<tsl::thread::ThreadPool>(
+        pools->env.get(), GetThreadOptions(),
+        absl::StrCat("XLATfrtCpuDevice", idx), num_threads);
+    pools->async_work_runner = std::make_unique<ThreadPoolAsyncWorkRunner>(
+        pools->pjrt_client_thread_pool.get());
+    pools->eigen_intraop_pool = std::make_unique<tsl::thread::ThreadPool>(
+        pools->env.get(), tsl::ThreadOptions(),
+        absl::StrCat("XLAEigenDevice", idx),
+        std::min<int>(num_threads, intra_op_num_threads));
+    pools->eigen_intraop_device = std::make_unique<Eigen::ThreadPoolDevice>(
+        pools->eigen_intraop_pool->AsEigenThreadPool(),
+        pools->eigen_intraop_pool->NumThreads());
+    pinned_device_pools_[idx] = std::move(pools);
   }
 
   LOG(INFO) << "TfrtCpuClient created.";
 }
 
+tsl::thread::ThreadPool* TfrtCpuClient::pjrt_client_thread_pool(
+    const TfrtCpuDevice& device) const {
+  int idx = device.local_hardware_id();
+  if (idx < pinned_device_pools_.size() &&
+      pinned_device_pools_[idx] != nullptr) {
+    return pinned_device_pools_[idx]->pjrt_client_thread_pool.get();
+  }
+  return pjrt_client_thread_pool();
+}
+
+AsyncWorkRunner* TfrtCpuClient::async_work_runner(
+    const TfrtCpuDevice& device) const {
+  int idx = device.local_hardware_id();
+  if (idx < pinned_device_pools_.size() &&
+      pinned_device_pools_[idx] != nullptr) {
+    return pinned_device_pools_[idx]->async_work_runner.get();
+  }
+  return async_work_runner();
+}
+
+Eigen::ThreadPoolDevice* TfrtCpuClient::eigen_intraop_device(
+    const TfrtCpuDevice& device) const {
+  int idx = device.local_hardware_id();
+  if (idx < pinned_device_pools_.size() &&
+      pinned_device_pools_[idx] != nullptr) {
+    return pinned_device_pools_[idx]->eigen_intraop_device.get();
+  }
+  int numa_node = device.numa_node();
+  if (numa_node != tsl::port::kNUMANoAffinity &&
+      numa_node < numa_intraop_devices_.size() &&
+      numa_intraop_devices_[numa_node] != nullptr) {
+    return numa_intraop_devices_[numa_node].get();
+  }
+  return eigen_intraop_device();
+}
+
 TfrtCpuClient::~TfrtCpuClient() { LOG(INFO) << "TfrtCpuClient destroyed."; }
 
 absl::StatusOr<PjRtDevice*> TfrtCpuClient::LookupDevice(
@@ -952,8 +1146,10 @@ absl::StatusOr<std::unique_ptr<PjRtBuffer>> TfrtCpuClient::BufferFromHostBuffer(
       std::unique_ptr<TrackedTfrtCpuDeviceBuffer> tracked_device_buffer,
       AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
           data, type, dims, byte_strides, host_buffer_semantics,
-          std::move(on_done_with_host_buffer), shape, async_work_runner(),
-          &transpose_mu_, &transpose_cache_));
+          std::move(on_done_with_host_buffer), shape,
+          async_work_runner(*tensorflow::down_cast<TfrtCpuDevice*>(device)),
+          &transpose_cache_,
+          tensorflow::down_cast<TfrtCpuDevice*>(device)->numa_node()));
 
   return std::unique_ptr<PjRtBuffer>(std::make_unique<TfrtCpuBuffer>(
       shape, std::move(tracked_device_buffer), this,
@@ -1006,7 +1202,9 @@ TfrtCpuClient::BufferFromHostLiteral(const LiteralSlice& literal,
       AllocateDestinationBufferAndAvs(
           shape, &avs, tensorflow::down_cast<TfrtCpuDevice*>(device), this));
 
-  output_buffer->CopyFromLiteral(literal, shape, &avs, async_work_runner());
+  output_buffer->CopyFromLiteral(
+      literal, shape, &avs,
+      async_work_runner(*tensorflow::down_cast<TfrtCpuDevice*>(device)));
 
   return std::unique_ptr<PjRtBuffer>(std::move(output_buffer));
 }
@@ -1039,7 +1237,7 @@ static std::vector<tsl::RCReference<tsl::AsyncValue>> CopyAsyncValues(
 }
 
 PjRtFuture<> TfrtCpuBuffer::ToLiteral(MutableLiteralBase* literal) {
-  return ToLiteralHelper(literal, client()->async_work_runner());
+  return ToLiteralHelper(literal, client()->async_work_runner(*device()));
 }
 
 PjRtFuture<> TfrtCpuBuffer::LazyToLiteral(
@@ -1048,7 +1246,8 @@ PjRtFuture<> TfrtCpuBuffer::LazyToLiteral(
   if (!buffer.ok()) {
     return PjRtFuture<>(buffer.status());
   }
-  return ToLiteralHelper(buffer.value(), client()->async_work_runner());
+  return ToLiteralHelper(buffer.value(),
+                         client()->async_work_runner(*device()));
 }
 
 // TODO(zhangqiaorjc): Consider disallowing multiple CPU devices and assign
@@ -1083,10 +1282,29 @@ absl::StatusOr<std::unique_ptr<PjRtBuffer>> TfrtCpuBuffer::CopyToDevice(
       *dst_device->default_memory_space()));
 }
 
+PjRtFuture<> TfrtCpuBuffer::CopyRawToHost(void* dst, int64_t offset,
+                                          int64_t transfer_size) {
+  return CopyRawToHostHelper(dst, offset, transfer_size,
+                             client()->async_work_runner(*device()));
+}
+
 absl::StatusOr<std::unique_ptr<PjRtBuffer>> TfrtCpuBuffer::CopyToMemorySpace(
     PjRtMemorySpace* dst_memory_space) {
+  tsl::profiler::TraceMe traceme("TfrtCpuBuffer::CopyToMemorySpace");
   CHECK_EQ(dst_memory_space->devices().size(), 1);
-  return CopyToDevice(dst_memory_space->devices()[0]);
+  PjRtDevice* dst_device = dst_memory_space->devices()[0];
+  if (dst_device != device_ || dst_memory_space == memory_space_) {
+    return CopyToDevice(dst_device);
+  }
+
+  // Memory spaces of the same device differ only in kind, the on-device shape
+  // and layout are identical, so the destination buffer can alias the source.
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<TrackedTfrtCpuDeviceBuffer> tracked_device_buffer,
+      AliasDeviceBufferHelper());
+  return std::unique_ptr<PjRtBuffer>(std::make_unique<TfrtCpuBuffer>(
+      on_device_shape_, std::move(tracked_device_buffer), client(), device_,
+      dst_memory_space));
 }
 
 TfrtCpuExecutable::TfrtCpuExecutable(
@@ -1171,14 +1389,32 @@ struct BufferInfo {
   size_t buffer_size;
 };
 
+// Allocates memory for a computation result from `buffer_pool` if it is set
+// and the allocation is not placed on a NUMA node.
+absl::StatusOr<MaybeOwningCpuMemory> AllocateResultMemory(
+    size_t size, int numa_node, CpuBufferPool* buffer_pool) {
+  bool numa_allocation = numa_node != tsl::port::kNUMANoAffinity &&
+                         size >= MaybeOwningCpuMemory::kMinNumaAllocationSize &&
+                         tsl::port::NUMAEnabled();
+  if (buffer_pool != nullptr && !numa_allocation) {
+    return buffer_pool->Allocate(size);
+  }
+  return MaybeOwningCpuMemory::Allocate(size, numa_node);
+}
+
 struct BufferAlloc {
   // All data members should have the same size.
   absl::InlinedVector<tsl::AsyncValueRef<MaybeOwningCpuMemory>, 4> buffers;
   absl::InlinedVector<size_t, 4> allocation_sizes;
+  // NUMA node to allocate buffers on.
+  int numa_node = tsl::port::kNUMANoAffinity;
+  // Pool to allocate buffers from, if any.
+  CpuBufferPool* buffer_pool = nullptr;
 
   void Allocate() {
     for (int i = 0; i < buffers.size(); ++i) {
-      auto memory = MaybeOwningCpuMemory::Allocate(allocation_sizes[i]);
+      auto memory =
+          AllocateResultMemory(allocation_sizes[i], numa_node, buffer_pool);
       if (!memory.ok()) {
         buffers[i].SetError(memory.status());
         return;
@@ -1195,10 +1431,15 @@ struct BufferAllocAndCopy {
   absl::InlinedVector<tsl::AsyncValueRef<MaybeOwningCpuMemory>, 4> src_buffers;
   absl::InlinedVector<tsl::AsyncValueRef<MaybeOwningCpuMemory>, 4> dst_buffers;
   absl::InlinedVector<size_t, 4> allocation_sizes;
+  // NUMA node to allocate destination buffers on.
+  int numa_node = tsl::port::kNUMANoAffinity;
+  // Pool to allocate destination buffers from, if any.
+  CpuBufferPool* buffer_pool = nullptr;
 
   void AllocateAndCopy() {
     for (int i = 0; i < src_buffers.size(); ++i) {
-      auto memory = MaybeOwningCpuMemory::Allocate(allocation_sizes[i]);
+      auto memory =
+          AllocateResultMemory(allocation_sizes[i], numa_node, buffer_pool);
       if (!memory.ok()) {
         dst_buffers[i].SetError(memory.status());
         return;
@@ -1328,6 +1569,23 @@ absl::Status TfrtCpuExecutable::CheckBufferCompatibilities(
   return absl::OkStatus();
 }
 
+// Returns a task runner for executing ready thunks of the `executable` on the
+// intra-op thread pool backing the `eigen_device`.
+static cpu::ThunkExecutor::TaskRunner ThunkTaskRunner(
+    const cpu::CpuExecutable& executable,
+    const Eigen::ThreadPoolDevice* eigen_device) {
+  Eigen::ThreadPoolInterface* pool = eigen_device->getPool();
+  if (executable.module()
+          .config()
+          .debug_options()
+          .xla_cpu_enable_work_stealing_thunk_executor()) {
+    return cpu::WorkStealingTaskRunner(pool);
+  }
+  return [pool](cpu::ThunkExecutor::Task task) {
+    pool->Schedule(cpu::ToCopyableTask(std::move(task)));
+  };
+}
+
 absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     absl::Span<PjRtBuffer* const> argument_handles, int replica, int partition,
     const RunId& run_id, const ExecuteOptions& options,
@@ -1390,9 +1648,13 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
 
   auto donate_it = parameters_that_must_be_donated_.begin();
 
-  // State for `TestBufferDonationClashes`.
+  // State for `TestBufferDonationClashes`. Without donated parameters there
+  // can be no clashes, so the common serving case only acquires usage holds.
+  const bool has_donated_parameters = !parameters_that_must_be_donated_.empty();
   absl::flat_hash_map<const void*, std::pair<bool, int>> donation_clashes;
-  donation_clashes.reserve(argument_handles.size());
+  if (has_donated_parameters) {
+    donation_clashes.reserve(argument_handles.size());
+  }
   for (int i = 0; i < argument_handles.size(); ++i) {
     PjRtBuffer* handle = argument_handles[i];
     auto* tfrt_buffer = tensorflow::down_cast<TfrtCpuBuffer*>(handle);
@@ -1408,8 +1670,10 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     auto get_buffer = [&](int i) -> absl::Status {
       bool must_donate = donate_it != parameters_that_must_be_donated_.end() &&
                          *donate_it == i;
-      TF_RETURN_IF_ERROR(TestBufferDonationClashes(
-          tfrt_buffer, donation_clashes, must_donate, i, replica, partition));
+      if (has_donated_parameters) {
+        TF_RETURN_IF_ERROR(TestBufferDonationClashes(
+            tfrt_buffer, donation_clashes, must_donate, i, replica, partition));
+      }
       if (must_donate) {
         ++donate_it;
         absl::StatusOr<TfrtCpuBuffer::DonationTransaction>
@@ -1487,6 +1751,10 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   // allocation and copy work.
   BufferAlloc buffer_alloc;
   BufferAllocAndCopy buffer_alloc_and_copy;
+  buffer_alloc.numa_node = device->numa_node();
+  buffer_alloc_and_copy.numa_node = device->numa_node();
+  buffer_alloc.buffer_pool = client_->buffer_pool();
+  buffer_alloc_and_copy.buffer_pool = client_->buffer_pool();
   TF_ASSIGN_OR_RETURN(
       std::vector<BufferInfo> buffer_table,
       CreateBufferTable(cpu_executable->buffer_assignment(),
@@ -1508,7 +1776,7 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   run_options.set_device_ordinal(device->id());
   // Need to keep device_assignment alive until execution completes.
   run_options.set_device_assignment(device_assignment.get());
-  run_options.set_intra_op_thread_pool(client_->eigen_intraop_device());
+  run_options.set_intra_op_thread_pool(client_->eigen_intraop_device(*device));
 
   auto cpu_run_options = std::make_shared<cpu::CpuExecutableRunOptions>();
   cpu_run_options->set_collectives(client_->collectives_.get());
@@ -1587,16 +1855,22 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
           cpu::Thunk::CollectiveExecuteParams collective_params,
           cpu::Thunk::CollectiveExecuteParams::Create(&run_options));
 
+      TF_ASSIGN_OR_RETURN(
+          cpu::Thunk::CustomCallExecuteParams custom_call_execute_params,
+          cpu::Thunk::CustomCallExecuteParams::Create(&run_options));
+
       cpu::Thunk::ExecuteParams execute_params = {
-          &cpu_executable->host_kernels(), &allocations,
+          &cpu_executable->host_kernels(),
+          &allocations,
           cpu::runtime::GetXfeedManager(run_options.device_ordinal()),
-          run_options.intra_op_thread_pool(), &collective_params};
+          run_options.intra_op_thread_pool(),
+          &collective_params,
+          &custom_call_execute_params};
 
       auto execute_event = cpu_executable->thunks().Execute(
-          execute_params, [&](cpu::ThunkExecutor::Task task) {
-            client_->eigen_intraop_device()->getPool()->Schedule(
-                cpu::ToCopyableTask(std::move(task)));
-          });
+          execute_params,
+          ThunkTaskRunner(*cpu_executable,
+                          client_->eigen_intraop_device(*device)));
 
       tsl::profiler::TraceMe trace(
           "ThunkExecutor::Execute (wait for completion)");
@@ -1632,8 +1906,7 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     }
     std::vector<tsl::RCReference<tsl::AsyncValue>> input_deps_avs_copy =
         CopyAsyncValues(input_deps);
-    EnqueueWorkWhenReady(
-        client()->pjrt_client_thread_pool(), input_deps,
+    auto compute =
         [cpu_executable, buffer_alloc = std::move(buffer_alloc),
          buffer_alloc_and_copy = std::move(buffer_alloc_and_copy),
          result_buffer_index = result_buffer_index_,
@@ -1647,7 +1920,7 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
          donation_transactions = std::move(donation_transactions),
          execute_event = std::move(ready_on_exit).Release(),
          input_deps_avs = std::move(input_deps_avs_copy),
-         eigen_device = client()->eigen_intraop_device()]() mutable {
+         eigen_device = client()->eigen_intraop_device(*device)]() mutable {
           // Because `input_deps` contains the definition events of all inputs,
           // when it is ready, all input buffers must have been allocated. So,
           // we are safe to allocate and copy memory here. Since `execute_event`
@@ -1713,17 +1986,22 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
                 collective_params =
                     cpu::Thunk::CollectiveExecuteParams::Create(&run_options);
 
-            if (collective_params.ok()) {
+            absl::StatusOr<cpu::Thunk::CustomCallExecuteParams>
+                custom_call_params =
+                    cpu::Thunk::CustomCallExecuteParams::Create(&run_options);
+
+            if (collective_params.ok() && custom_call_params.ok()) {
               cpu::Thunk::ExecuteParams execute_params = {
-                  &cpu_executable->host_kernels(), &allocations,
+                  &cpu_executable->host_kernels(),
+                  &allocations,
                   cpu::runtime::GetXfeedManager(run_options.device_ordinal()),
-                  run_options.intra_op_thread_pool(), &*collective_params};
+                  run_options.intra_op_thread_pool(),
+                  &*collective_params,
+                  &*custom_call_params};
 
               auto execute_event = cpu_executable->thunks().Execute(
-                  execute_params, [&](cpu::ThunkExecutor::Task task) {
-                    eigen_device->getPool()->Schedule(
-                        cpu::ToCopyableTask(std::move(task)));
-                  });
+                  execute_params,
+                  ThunkTaskRunner(*cpu_executable, eigen_device));
 
               tsl::profiler::TraceMe trace(
                   "ThunkExecutor::Execute (wait for completion)");
@@ -1731,7 +2009,8 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
               status = execute_event.IsError() ? execute_event.GetError()
                                                : absl::OkStatus();
             } else {
-              status = collective_params.status();
+              status = collective_params.ok() ? custom_call_params.status()
+                                              : collective_params.status();
             }
 
           } else {
@@ -1751,7 +2030,17 @@ absl::StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
 
           // CPU computation completes.
           execute_event.SetStateConcrete();
-        });
+        };
+
+    // When all inputs are ready there is nothing to wait for, so enqueue the
+    // computation directly instead of going through `RunWhenReady`.
+    if (input_deps.empty()) {
+      EnqueueWork(client()->pjrt_client_thread_pool(*device),
+                  std::move(compute));
+    } else {
+      EnqueueWorkWhenReady(client()->pjrt_client_thread_pool(*device),
+                           input_deps, std::move(compute));
+    }
   }
 
   // Create output TFRT buffers.
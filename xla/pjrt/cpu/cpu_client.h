@@ -42,6 +42,7 @@ limitations under the License.
 #include "xla/layout.h"
 #include "xla/literal.h"
 #include "xla/pjrt/cpu/abstract_tfrt_cpu_buffer.h"
+#include "xla/pjrt/cpu/cpu_buffer_pool.h"
 #include "xla/pjrt/cpu/cpu_topology.h"
 #include "xla/pjrt/cpu/tracked_tfrt_cpu_device_buffer.h"
 #include "xla/pjrt/pjrt_client.h"
@@ -62,10 +63,13 @@ limitations under the License.
 #include "xla/shape.h"
 #include "xla/statusor.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/framework/allocator.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/fingerprint.h"
+#include "tsl/platform/numa.h"
 #include "tsl/platform/threadpool.h"
 
 namespace xla {
@@ -191,7 +195,10 @@ class TfrtCpuTopologyDescription : public PjRtTopologyDescription {
 class TfrtCpuDevice final : public PjRtDevice {
  public:
   explicit TfrtCpuDevice(int process_id, int local_device_id,
-                         int max_inflight_computations = 32);
+                         int max_inflight_computations = 32,
+                         int numa_node = tsl::port::kNUMANoAffinity,
+                         std::vector<int> cpus = {},
+                         int l3_domain = CpuTopology::kNoL3Domain);
 
   const TfrtCpuDeviceDescription& description() const override {
     return description_;
@@ -220,6 +227,17 @@ class TfrtCpuDevice final : public PjRtDevice {
     return PjRtLocalHardwareId(description_.local_hardware_id());
   }
 
+  // NUMA node the device is placed on, or `tsl::port::kNUMANoAffinity` if the
+  // device has no NUMA node affinity.
+  int numa_node() const { return numa_node_; }
+
+  // Logical CPUs the threads of the device are pinned to. Empty if the device
+  // is not pinned and runs on the thread pools shared by the client.
+  absl::Span<const int> cpus() const { return cpus_; }
+
+  // L3 cache domain shared by `cpus()`, or `CpuTopology::kNoL3Domain`.
+  int l3_domain() const { return l3_domain_; }
+
   absl::Status TransferToInfeed(const LiteralSlice& literal) override;
 
   absl::Status TransferFromOutfeed(MutableBorrowingLiteral literal) override;
@@ -235,6 +253,10 @@ class TfrtCpuDevice final : public PjRtDevice {
 
   absl::StatusOr<PjRtMemorySpace*> memory_space_by_kind_id(int id) const;
 
+  // Returns the stats of the client's buffer pool, which is shared by all
+  // devices of the client.
+  absl::StatusOr<tsl::AllocatorStats> GetAllocatorStats() const override;
+
   // Returns a semaphore for admission control on inflight computations.
   Semaphore& max_inflight_computations_semaphore() {
     return max_inflight_computations_semaphore_;
@@ -248,6 +270,9 @@ class TfrtCpuDevice final : public PjRtDevice {
  private:
   PjRtClient* client_ = nullptr;
   TfrtCpuDeviceDescription description_;
+  int numa_node_;
+  std::vector<int> cpus_;
+  int l3_domain_;
   absl::InlinedVector<PjRtMemorySpace*, 1> memory_spaces_;
   absl::flat_hash_map<int, PjRtMemorySpace*> memory_spaces_by_id_;
 
@@ -262,7 +287,8 @@ class TfrtCpuClient final : public PjRtClient {
   TfrtCpuClient(int process_index,
                 std::vector<std::unique_ptr<TfrtCpuDevice>> devices,
                 std::shared_ptr<cpu::CollectivesInterface> collectives,
-                size_t num_threads, bool asynchronous);
+                size_t num_threads, size_t intra_op_num_threads,
+                bool asynchronous, size_t buffer_pool_max_retained_bytes = 0);
   ~TfrtCpuClient() override;
 
   int process_index() const override { return process_index_; }
@@ -404,10 +430,31 @@ class TfrtCpuClient final : public PjRtClient {
     return async_work_runner_.get();
   }
 
+  // Returns the thread pool for dispatching computations to `device`. If the
+  // device is pinned to cores, the thread pool is owned by the device and
+  // pinned to its cores.
+  tsl::thread::ThreadPool* pjrt_client_thread_pool(
+      const TfrtCpuDevice& device) const;
+
+  // Returns the runner for host-side work (e.g. transfers) of `device`,
+  // running on `pjrt_client_thread_pool(device)`.
+  AsyncWorkRunner* async_work_runner(const TfrtCpuDevice& device) const;
+
   Eigen::ThreadPoolDevice* eigen_intraop_device() const {
     return eigen_intraop_device_.get();
   }
 
+  // Returns the intra-op thread pool for running computations on `device`. If
+  // the device is pinned to cores, the thread pool is owned by the device and
+  // pinned to its cores. Otherwise, if the device has NUMA node affinity, the
+  // thread pool is pinned to its node.
+  Eigen::ThreadPoolDevice* eigen_intraop_device(
+      const TfrtCpuDevice& device) const;
+
+  // Returns the pool used to allocate computation results, or nullptr if
+  // buffer pooling is disabled.
+  CpuBufferPool* buffer_pool() const { return buffer_pool_.get(); }
+
   tsl::AsyncValueRef<CpuEvent> GetLastCollectiveLaunchEvent() {
     absl::MutexLock lock(&mu_);
     return last_collective_launch_event_.CopyRef();
@@ -458,6 +505,29 @@ class TfrtCpuClient final : public PjRtClient {
   std::unique_ptr<tsl::thread::ThreadPool> eigen_intraop_pool_;
   std::unique_ptr<Eigen::ThreadPoolDevice> eigen_intraop_device_;
 
+  // Intra-op thread pools pinned to NUMA nodes, indexed by NUMA node. Only
+  // created for NUMA nodes of addressable devices.
+  std::vector<std::unique_ptr<tsl::thread::ThreadPool>> numa_intraop_pools_;
+  std::vector<std::unique_ptr<Eigen::ThreadPoolDevice>> numa_intraop_devices_;
+
+  // Thread pools owned by a device that is pinned to cores. `env` starts the
+  // threads of both pools on the cores of the device.
+  struct PinnedDeviceThreadPools {
+    std::unique_ptr<tsl::Env> env;
+    std::unique_ptr<tsl::thread::ThreadPool> pjrt_client_thread_pool;
+    std::unique_ptr<AsyncWorkRunner> async_work_runner;
+    std::unique_ptr<tsl::thread::ThreadPool> eigen_intraop_pool;
+    std::unique_ptr<Eigen::ThreadPoolDevice> eigen_intraop_device;
+  };
+
+  // Indexed by the local hardware id of addressable devices. Null for devices
+  // that are not pinned to cores.
+  std::vector<std::unique_ptr<PinnedDeviceThreadPools>> pinned_device_pools_;
+
+  // Pool for computation result buffers. Pooled buffers keep the pool alive,
+  // so it may outlive the client.
+  std::shared_ptr<CpuBufferPool> buffer_pool_;
+
   // Launching collectives are prone to deadlock when we use fixed-sized
   // threadpools since ExecuteHelper will block until all replicas reach the
   // barrier. We ensure that
@@ -475,8 +545,7 @@ class TfrtCpuClient final : public PjRtClient {
   // A cache for transpose plans. We use transposes to convert
   // (possibly strided) buffers provided to BufferFromHostBuffer into dense
   // major-to-minor layout.
-  absl::Mutex transpose_mu_;
-  TransposePlanCache transpose_cache_ ABSL_GUARDED_BY(transpose_mu_);
+  TransposePlanCache transpose_cache_;
 
   std::shared_ptr<cpu::CollectivesInterface> collectives_;
 
@@ -517,9 +586,14 @@ class TfrtCpuBuffer final : public AbstractTfrtCpuBuffer {
       absl::AnyInvocable<absl::StatusOr<MutableLiteralBase*>() &&> generator)
       override;
 
+  PjRtFuture<> CopyRawToHost(void* dst, int64_t offset,
+                             int64_t transfer_size) override;
+
   absl::StatusOr<std::unique_ptr<PjRtBuffer>> CopyToDevice(
       PjRtDevice* dst_device) override;
 
+  // Copies to a memory space of the same device alias the source memory
+  // without copying, since all CPU memory spaces share the host layout.
   absl::StatusOr<std::unique_ptr<PjRtBuffer>> CopyToMemorySpace(
       PjRtMemorySpace* dst_memory_space) override;
 
@@ -710,6 +784,29 @@ struct CpuClientOptions {
 
   int max_inflight_computations_per_device = 32;
 
+  // Number of threads in the intra-op (Eigen) thread pool. If not provided,
+  // the default thread pool size is used.
+  std::optional<int> intra_op_parallelism = std::nullopt;
+
+  // If true and the host has multiple NUMA nodes, CPU devices are assigned to
+  // NUMA nodes round-robin. Computations on a device run on an intra-op thread
+  // pool pinned to the device NUMA node (with at most `intra_op_parallelism`
+  // threads), and device buffers are allocated on that node.
+  bool numa_aware = false;
+
+  // If true, the physical cores this process may run on are partitioned
+  // between CPU devices, keeping each device within one L3 cache domain when
+  // the number of devices allows it. Every device gets its own dispatch and
+  // intra-op thread pools pinned to its cores, so devices do not contend for
+  // cores. Ignored if the host CPU topology is unknown (e.g. not on Linux).
+  bool pin_devices_to_cores = false;
+
+  // If non-zero, computation result buffers are allocated from a size-class
+  // pool owned by the client, which retains at most this many bytes of freed
+  // buffers for reuse. Pool statistics are reported by
+  // `PjRtDevice::GetAllocatorStats`.
+  size_t buffer_pool_max_retained_bytes = 0;
+
   // My process ID.
   int process_id = 0;
 
@@ -23,12 +23,14 @@ limitations under the License.
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/notification.h"
 #include "xla/client/xla_computation.h"
@@ -36,6 +38,7 @@ limitations under the License.
 #include "xla/ffi/ffi_api.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
+#include "xla/pjrt/cpu/cpu_topology.h"
 #include "xla/pjrt/host_memory_spaces.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_executable.h"
@@ -44,14 +47,18 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/tests/literal_test_util.h"
 #include "xla/tests/test_utils.h"
+#include "xla/tsl/framework/allocator.h"
 #include "xla/util.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/casts.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/file_system.h"
+#include "tsl/platform/numa.h"
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
 
 namespace xla {
 namespace {
@@ -83,17 +90,115 @@ TEST(TfrtCpuClientTest, MemorySpace) {
   ASSERT_GE(client->devices().size(), 1);
 
   ASSERT_EQ(client->memory_spaces().size(),
-            client->addressable_devices().size());
+            2 * client->addressable_devices().size());
   for (auto* device : client->devices()) {
     TF_ASSERT_OK_AND_ASSIGN(auto* memory_space, device->default_memory_space());
-    EXPECT_THAT(device->memory_spaces(), ElementsAre(memory_space));
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto* pinned_memory_space,
+        device->memory_space_by_kind(PinnedHostMemorySpace::kKind));
+    EXPECT_THAT(device->memory_spaces(),
+                ElementsAre(memory_space, pinned_memory_space));
     EXPECT_EQ(memory_space->kind(), UnpinnedHostMemorySpace::kKind);
     EXPECT_EQ(memory_space->kind_id(), UnpinnedHostMemorySpace::kKindId);
     EXPECT_THAT(device->memory_space_by_kind(UnpinnedHostMemorySpace::kKind),
                 IsOkAndHolds(memory_space));
+    EXPECT_EQ(pinned_memory_space->kind_id(), PinnedHostMemorySpace::kKindId);
+    EXPECT_NE(pinned_memory_space->id(), memory_space->id());
   }
 }
 
+TEST(TfrtCpuClientTest, CopyRawToHost) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  std::vector<float> data(1 << 16);
+  std::iota(data.begin(), data.end(), 0.0f);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostLiteral(LiteralUtil::CreateR1<float>(data),
+                                    client->addressable_devices()[0]));
+
+  // Small copy is done inline, large copy is dispatched asynchronously.
+  for (int64_t count : {4, 1 << 15}) {
+    std::vector<float> dst(count);
+    int64_t offset = 100;
+    TF_ASSERT_OK(buffer
+                     ->CopyRawToHost(dst.data(), offset * sizeof(float),
+                                     count * sizeof(float))
+                     .Await());
+    EXPECT_THAT(dst, ElementsAreArray(data.begin() + offset,
+                                      data.begin() + offset + count));
+  }
+
+  float dst;
+  EXPECT_THAT(
+      buffer->CopyRawToHost(&dst, data.size() * sizeof(float), sizeof(float))
+          .Await(),
+      tsl::testing::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(TfrtCpuClientTest, CopyToPinnedHostMemorySpaceAliasesBuffer) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  PjRtDevice* device = client->addressable_devices()[0];
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto* pinned_memory_space,
+      device->memory_space_by_kind(PinnedHostMemorySpace::kKind));
+
+  Literal literal = LiteralUtil::CreateR1<float>({1.0f, 2.0f, 3.0f, 4.0f});
+  TF_ASSERT_OK_AND_ASSIGN(auto buffer,
+                          client->BufferFromHostLiteral(literal, device));
+  TF_ASSERT_OK_AND_ASSIGN(auto pinned_buffer,
+                          buffer->CopyToMemorySpace(pinned_memory_space));
+  EXPECT_EQ(pinned_buffer->memory_space(), pinned_memory_space);
+  EXPECT_EQ(pinned_buffer->device(), device);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto src_ref, buffer->AcquireExternalReference());
+  TF_ASSERT_OK_AND_ASSIGN(auto dst_ref,
+                          pinned_buffer->AcquireExternalReference());
+  EXPECT_EQ(src_ref->OpaqueDeviceMemoryDataPointer(),
+            dst_ref->OpaqueDeviceMemoryDataPointer());
+
+  // The alias keeps the memory alive after the source buffer is deleted.
+  src_ref.reset();
+  buffer->Delete();
+  TF_ASSERT_OK_AND_ASSIGN(auto received_literal,
+                          pinned_buffer->ToLiteralSync());
+  EXPECT_TRUE(LiteralTestUtil::Equal(literal, *received_literal));
+}
+
+TEST(TfrtCpuClientTest, BufferPoolAllocatorStats) {
+  constexpr char kProgram[] = R"(
+    HloModule Add
+    ENTRY Add {
+      p0 = f32[1024] parameter(0)
+      ROOT add = f32[1024] add(p0, p0)
+    })";
+  CpuClientOptions options;
+  options.buffer_pool_max_retained_bytes = 1024 * 1024;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          client->Compile(xla_computation, {}));
+
+  PjRtDevice* device = client->addressable_devices()[0];
+  Literal literal = LiteralUtil::CreateR1<float>(std::vector<float>(1024, 1));
+  TF_ASSERT_OK_AND_ASSIGN(auto buffer,
+                          client->BufferFromHostLiteral(literal, device));
+
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(auto result,
+                            executable->Execute({{buffer.get()}}, {}));
+    TF_ASSERT_OK_AND_ASSIGN(auto result_literal,
+                            result[0][0]->ToLiteralSync());
+    EXPECT_EQ(result_literal->Get<float>({0}), 2.0f);
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(tsl::AllocatorStats stats,
+                          device->GetAllocatorStats());
+  EXPECT_GE(stats.num_allocs, 3);
+  EXPECT_GT(stats.pool_bytes.value_or(0), 0);
+}
+
 TEST(TfrtCpuClientTest, DonationWithExecutionError) {
   constexpr char kProgram[] =
       R"(
@@ -356,6 +461,47 @@ TEST(TfrtCpuClientTest, AsyncTransferRawDataToSubBuffer) {
   EXPECT_THAT(literal->data<uint32_t>(), Each(0x42424242));
 }
 
+TEST(TfrtCpuClientTest, AsyncTransferChunksToMultipleBuffers) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  constexpr int64_t kNumElements = 1 << 20;
+  xla::Shape shape = ShapeUtil::MakeShape(U32, {kNumElements});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto transfer_manager,
+      client->CreateBuffersForAsyncHostToDevice(
+          {shape, shape}, client->addressable_devices()[0]));
+  auto buffer0 = transfer_manager->RetrieveBuffer(0);
+  auto buffer1 = transfer_manager->RetrieveBuffer(1);
+
+  std::vector<uint32_t> data(kNumElements);
+  std::iota(data.begin(), data.end(), 0);
+  const int64_t buffer_size = transfer_manager->buffer_size(0);
+
+  // Fill the first buffer with a mix of small chunks copied inline and large
+  // chunks copied on the client thread pool, last chunk first.
+  std::vector<int64_t> offsets = {0, 1024, 64 * 1024, 1024 * 1024,
+                                  buffer_size};
+  for (int i = offsets.size() - 2; i >= 0; --i) {
+    TF_ASSERT_OK(transfer_manager->TransferRawDataToSubBuffer(
+        0, reinterpret_cast<const char*>(data.data()) + offsets[i],
+        offsets[i], offsets[i + 1] - offsets[i],
+        /*is_last_transfer=*/i == 0, []() {}));
+  }
+
+  // The first buffer is usable while the second one is still being filled.
+  TF_ASSERT_OK(buffer0->GetReadyFuture().Await());
+  EXPECT_THAT(buffer1->GetReadyFuture().IsReady(), IsFalse());
+  TF_ASSERT_OK_AND_ASSIGN(auto literal0, buffer0->ToLiteralSync());
+  EXPECT_THAT(literal0->data<uint32_t>(), ElementsAreArray(data));
+
+  TF_ASSERT_OK(transfer_manager->TransferRawDataToBuffer(
+      1,
+      absl::string_view(reinterpret_cast<const char*>(data.data()),
+                        buffer_size),
+      []() {}));
+  TF_ASSERT_OK_AND_ASSIGN(auto literal1, buffer1->ToLiteralSync());
+  EXPECT_THAT(literal1->data<uint32_t>(), ElementsAreArray(data));
+}
+
 // User-defined data type to be passed to FFI handler via the execute context
 // side channel.
 struct MemsetValue {
@@ -412,5 +558,109 @@ TEST(TfrtCpuClientTest, ForwardUserDataToFfiHandler) {
       *result_literal));
 }
 
+TEST(TfrtCpuClientTest, NumaAwareDevices) {
+  CpuClientOptions options;
+  options.cpu_device_count = 4;
+  options.numa_aware = true;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+
+  const int num_numa_nodes = tsl::port::NUMANumNodes();
+  for (int i = 0; i < client->addressable_device_count(); ++i) {
+    auto* device =
+        tensorflow::down_cast<TfrtCpuDevice*>(client->addressable_devices()[i]);
+    EXPECT_EQ(device->numa_node(), tsl::port::NUMAEnabled()
+                                       ? i % num_numa_nodes
+                                       : tsl::port::kNUMANoAffinity);
+  }
+
+  // Buffers must be usable regardless of where they are placed.
+  Literal literal = LiteralUtil::CreateR1<float>(std::vector<float>(1 << 16));
+  for (PjRtDevice* device : client->addressable_devices()) {
+    TF_ASSERT_OK_AND_ASSIGN(auto buffer,
+                            client->BufferFromHostLiteral(literal, device));
+    TF_ASSERT_OK_AND_ASSIGN(auto received_literal, buffer->ToLiteralSync());
+    EXPECT_TRUE(LiteralTestUtil::Equal(literal, *received_literal));
+  }
+}
+
+TEST(TfrtCpuClientTest, DevicesPinnedToCores) {
+  CpuClientOptions options;
+  options.cpu_device_count = 2;
+  options.pin_devices_to_cores = true;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(options));
+
+  const bool has_topology = !DetectCpuCores().empty();
+  for (PjRtDevice* device : client->addressable_devices()) {
+    EXPECT_EQ(tensorflow::down_cast<TfrtCpuDevice*>(device)->cpus().empty(),
+              !has_topology);
+  }
+
+  constexpr char kProgram[] = R"(
+    HloModule Add
+    ENTRY Add {
+      p0 = f32[4] parameter(0)
+      ROOT add = f32[4] add(p0, p0)
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  CompileOptions compile_options;
+  compile_options.compile_portable_executable = true;
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          client->Compile(xla_computation, compile_options));
+
+  // Every device runs on its own pinned thread pools.
+  Literal literal = LiteralUtil::CreateR1<float>({1.0f, 2.0f, 3.0f, 4.0f});
+  for (PjRtDevice* device : client->addressable_devices()) {
+    TF_ASSERT_OK_AND_ASSIGN(auto buffer,
+                            client->BufferFromHostLiteral(literal, device));
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto result, executable->ExecuteSharded({buffer.get()}, device, {}));
+    TF_ASSERT_OK_AND_ASSIGN(auto result_literal, result[0]->ToLiteralSync());
+    EXPECT_TRUE(LiteralTestUtil::Equal(
+        LiteralUtil::CreateR1<float>({2.0f, 4.0f, 6.0f, 8.0f}),
+        *result_literal));
+  }
+}
+
+// Measures the latency of enqueueing a tiny computation whose inputs are
+// ready, which is dominated by the ExecuteHelper overheads. Runs inline for
+// `state.range(0) == 0` and on the client thread pool otherwise.
+static void BM_ExecuteTinyComputation(::testing::benchmark::State& state) {
+  constexpr char kProgram[] = R"(
+    HloModule Add
+    ENTRY Add {
+      p0 = f32[4] parameter(0)
+      p1 = f32[4] parameter(1)
+      ROOT add = f32[4] add(p0, p1)
+    })";
+  auto client = GetTfrtCpuClient(CpuClientOptions()).value();
+  auto hlo_module = ParseAndReturnUnverifiedModule(kProgram, {}).value();
+  XlaComputation xla_computation(hlo_module->ToProto());
+  auto executable = client->Compile(xla_computation, {}).value();
+
+  PjRtDevice* device = client->addressable_devices()[0];
+  Literal literal = LiteralUtil::CreateR1<float>({1.0f, 2.0f, 3.0f, 4.0f});
+  auto lhs = client->BufferFromHostLiteral(literal, device).value();
+  auto rhs = client->BufferFromHostLiteral(literal, device).value();
+  CHECK_OK(lhs->GetReadyFuture().Await());
+  CHECK_OK(rhs->GetReadyFuture().Await());
+
+  ExecuteOptions options;
+  options.execution_mode = state.range(0) == 0
+                               ? ExecuteOptions::ExecutionMode::kSynchronous
+                               : ExecuteOptions::ExecutionMode::kAsynchronous;
+
+  std::unique_ptr<PjRtBuffer> last_result;
+  for (auto s : state) {
+    auto result = executable->Execute({{lhs.get(), rhs.get()}}, options);
+    CHECK_OK(result.status());
+    last_result = std::move((*result)[0][0]);
+  }
+  CHECK_OK(last_result->GetReadyFuture().Await());
+}
+
+BENCHMARK(BM_ExecuteTinyComputation)->Arg(0)->Arg(1);
+
 }  // namespace
 }  // namespace xla
@@ -16,11 +16,28 @@ limitations under the License.
 #include "xla/pjrt/cpu/cpu_topology.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/numa.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 namespace xla {
 
 std::unique_ptr<const CpuTopology> CpuTopology::FromProto(
@@ -30,8 +47,17 @@ std::unique_ptr<const CpuTopology> CpuTopology::FromProto(
 
   for (size_t i = 0; i < cpu_topology_proto.cpu_devices_size(); ++i) {
     auto& cpu_device_proto = cpu_topology_proto.cpu_devices(i);
-    devices.push_back(CpuDevice{cpu_device_proto.process_index(),
-                                cpu_device_proto.local_hardware_id()});
+    CpuDevice& device = devices.emplace_back(
+        CpuDevice{cpu_device_proto.process_index(),
+                  cpu_device_proto.local_hardware_id(),
+                  cpu_device_proto.has_numa_node()
+                      ? cpu_device_proto.numa_node()
+                      : tsl::port::kNUMANoAffinity});
+    device.cpus.assign(cpu_device_proto.cpus().begin(),
+                       cpu_device_proto.cpus().end());
+    if (cpu_device_proto.has_l3_domain()) {
+      device.l3_domain = cpu_device_proto.l3_domain();
+    }
   }
 
   std::vector<std::string> machine_attributes;
@@ -50,6 +76,15 @@ CpuTopologyProto CpuTopology::ToProto() const {
     auto* cpu_device_proto = proto.add_cpu_devices();
     cpu_device_proto->set_process_index(cpu_device.process_id);
     cpu_device_proto->set_local_hardware_id(cpu_device.local_device_id);
+    if (cpu_device.numa_node != tsl::port::kNUMANoAffinity) {
+      cpu_device_proto->set_numa_node(cpu_device.numa_node);
+    }
+    for (int cpu : cpu_device.cpus) {
+      cpu_device_proto->add_cpus(cpu);
+    }
+    if (cpu_device.l3_domain != kNoL3Domain) {
+      cpu_device_proto->set_l3_domain(cpu_device.l3_domain);
+    }
   }
   for (const std::string& machine_attribute : machine_attributes_) {
     proto.add_machine_attributes(machine_attribute);
@@ -57,4 +92,96 @@ CpuTopologyProto CpuTopology::ToProto() const {
   return proto;
 }
 
+#if defined(__linux__)
+// Reads a sysfs attribute, or returns nullopt if it does not exist.
+static std::optional<std::string> ReadSysfsAttribute(const std::string& path) {
+  std::string contents;
+  if (!tsl::ReadFileToString(tsl::Env::Default(), path, &contents).ok()) {
+    return std::nullopt;
+  }
+  return std::string(absl::StripAsciiWhitespace(contents));
+}
+#endif
+
+std::vector<CpuCore> DetectCpuCores() {
+#if defined(__linux__)
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return {};
+  }
+
+  // Logical CPUs are grouped into cores by (package, core id), and cores into
+  // L3 domains by the list of CPUs sharing their L3 cache.
+  absl::btree_map<std::pair<int, int>, CpuCore> cores;
+  absl::flat_hash_map<std::string, int> l3_domains;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (!CPU_ISSET(cpu, &allowed)) continue;
+
+    std::string dir = absl::StrCat("/sys/devices/system/cpu/cpu", cpu);
+    std::optional<std::string> package =
+        ReadSysfsAttribute(absl::StrCat(dir, "/topology/physical_package_id"));
+    std::optional<std::string> core_id =
+        ReadSysfsAttribute(absl::StrCat(dir, "/topology/core_id"));
+    CpuCore parsed;
+    if (!package || !core_id || !absl::SimpleAtoi(*package, &parsed.package) ||
+        !absl::SimpleAtoi(*core_id, &parsed.core_id)) {
+      return {};
+    }
+
+    CpuCore& core = cores[{parsed.package, parsed.core_id}];
+    if (core.cpus.empty()) {
+      core = std::move(parsed);
+      std::optional<std::string> level =
+          ReadSysfsAttribute(absl::StrCat(dir, "/cache/index3/level"));
+      std::optional<std::string> shared_cpus = ReadSysfsAttribute(
+          absl::StrCat(dir, "/cache/index3/shared_cpu_list"));
+      if (level == "3" && shared_cpus) {
+        core.l3_domain =
+            l3_domains.try_emplace(*shared_cpus, l3_domains.size())
+                .first->second;
+      }
+    }
+    core.cpus.push_back(cpu);
+  }
+
+  std::vector<CpuCore> result;
+  result.reserve(cores.size());
+  for (auto& [key, core] : cores) {
+    result.push_back(std::move(core));
+  }
+  absl::c_stable_sort(result, [](const CpuCore& a, const CpuCore& b) {
+    return a.l3_domain < b.l3_domain;
+  });
+  return result;
+#else
+  return {};
+#endif
+}
+
+std::vector<CpuCoreSet> PartitionCpuCores(absl::Span<const CpuCore> cores,
+                                          int num_devices) {
+  std::vector<CpuCoreSet> core_sets(num_devices);
+  if (cores.empty()) return core_sets;
+
+  int64_t num_cores = cores.size();
+  for (int64_t device = 0; device < num_devices; ++device) {
+    int64_t begin = device % num_cores;
+    int64_t end = begin + 1;
+    if (num_cores >= num_devices) {
+      begin = device * num_cores / num_devices;
+      end = (device + 1) * num_cores / num_devices;
+    }
+
+    CpuCoreSet& core_set = core_sets[device];
+    core_set.l3_domain = cores[begin].l3_domain;
+    for (int64_t i = begin; i < end; ++i) {
+      absl::c_copy(cores[i].cpus, std::back_inserter(core_set.cpus));
+      if (cores[i].l3_domain != core_set.l3_domain) {
+        core_set.l3_domain = CpuTopology::kNoL3Domain;
+      }
+    }
+  }
+  return core_sets;
+}
+
 }  // namespace xla
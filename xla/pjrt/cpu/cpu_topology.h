@@ -24,17 +24,30 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "xla/pjrt/cpu/cpu_topology.pb.h"
 #include "xla/pjrt/pjrt_common.h"
+#include "tsl/platform/numa.h"
 
 namespace xla {
 class CpuTopology {
  public:
+  static constexpr int kNoL3Domain = -1;
+
   struct CpuDevice {
     int process_id;
     int local_device_id;
+    // NUMA node the device is placed on, or `tsl::port::kNUMANoAffinity` if the
+    // device has no NUMA node affinity.
+    int numa_node = tsl::port::kNUMANoAffinity;
+    // Logical CPUs the threads of the device are pinned to. Empty if the device
+    // is not pinned.
+    std::vector<int> cpus = {};
+    // L3 cache domain shared by `cpus`, or `kNoL3Domain`.
+    int l3_domain = kNoL3Domain;
 
     bool operator==(const CpuDevice& other) const {
       return process_id == other.process_id &&
-             local_device_id == other.local_device_id;
+             local_device_id == other.local_device_id &&
+             numa_node == other.numa_node && cpus == other.cpus &&
+             l3_domain == other.l3_domain;
     }
   };
 
@@ -73,6 +86,35 @@ inline int UnpackCpuDeviceId(PjRtGlobalDeviceId global_device_id) {
   return global_device_id.value() % kMaxCpuDevicesPerProcess;
 }
 
+// A physical core of the host.
+struct CpuCore {
+  int package = 0;
+  int core_id = 0;
+  // L3 cache domain the core belongs to, or `CpuTopology::kNoL3Domain`.
+  int l3_domain = CpuTopology::kNoL3Domain;
+  // Logical CPUs (hyperthreads) of the core.
+  std::vector<int> cpus;
+};
+
+// Returns the physical cores this process may run on, ordered by L3 domain.
+// Returns an empty vector if the host topology is unknown (e.g. on platforms
+// other than Linux).
+std::vector<CpuCore> DetectCpuCores();
+
+// Logical CPUs assigned to one device by `PartitionCpuCores`.
+struct CpuCoreSet {
+  std::vector<int> cpus;
+  // L3 cache domain shared by all `cpus`, or `CpuTopology::kNoL3Domain`.
+  int l3_domain = CpuTopology::kNoL3Domain;
+};
+
+// Splits `cores` into `num_devices` disjoint sets of consecutive cores of
+// roughly equal size, so that a device stays within one L3 domain whenever the
+// number of devices allows it. If there are fewer cores than devices, cores are
+// shared between devices round-robin.
+std::vector<CpuCoreSet> PartitionCpuCores(absl::Span<const CpuCore> cores,
+                                          int num_devices);
+
 }  // namespace xla
 
 #endif  // XLA_PJRT_CPU_CPU_TOPOLOGY_H_
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/pjrt/cpu/cpu_topology.h"
 
 #include <memory>
+#include <vector>
 
 #include "tsl/platform/protobuf.h"
 #include "tsl/platform/test.h"
@@ -23,6 +24,10 @@ limitations under the License.
 namespace xla {
 namespace {
 
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
 TEST(CpuTopology, FromProto) {
   CpuTopologyProto msg;
   ASSERT_TRUE(tsl::protobuf::TextFormat::ParseFromString(
@@ -42,6 +47,23 @@ TEST(CpuTopology, FromProto) {
   EXPECT_EQ(cpu_topology->machine_attributes()[1], "Intel");
 }
 
+TEST(CpuTopology, NumaNodeRoundTrip) {
+  CpuTopology cpu_topology({{0, 0, /*numa_node=*/0}, {0, 1, /*numa_node=*/1},
+                            {0, 2}},
+                           {});
+  CpuTopologyProto msg = cpu_topology.ToProto();
+  ASSERT_EQ(msg.cpu_devices_size(), 3);
+  EXPECT_EQ(msg.cpu_devices(0).numa_node(), 0);
+  EXPECT_TRUE(msg.cpu_devices(0).has_numa_node());
+  EXPECT_EQ(msg.cpu_devices(1).numa_node(), 1);
+  EXPECT_FALSE(msg.cpu_devices(2).has_numa_node());
+
+  std::unique_ptr<const CpuTopology> round_trip = CpuTopology::FromProto(msg);
+  EXPECT_EQ(round_trip->devices()[0].numa_node, 0);
+  EXPECT_EQ(round_trip->devices()[1].numa_node, 1);
+  EXPECT_EQ(round_trip->devices()[2].numa_node, tsl::port::kNUMANoAffinity);
+}
+
 TEST(CpuTopology, ToProto) {
   CpuTopology cpu_topology({{2, 3}}, {"ab", "cd"});
   CpuTopologyProto msg = cpu_topology.ToProto();
@@ -53,5 +75,84 @@ TEST(CpuTopology, ToProto) {
   EXPECT_EQ(msg.machine_attributes(1), "cd");
 }
 
+TEST(CpuTopology, CpusRoundTrip) {
+  CpuTopology cpu_topology(
+      {{0, 0, /*numa_node=*/0, /*cpus=*/{0, 1, 4, 5}, /*l3_domain=*/0},
+       {0, 1}},
+      {});
+  CpuTopologyProto msg = cpu_topology.ToProto();
+  ASSERT_EQ(msg.cpu_devices_size(), 2);
+  EXPECT_THAT(msg.cpu_devices(0).cpus(), ElementsAre(0, 1, 4, 5));
+  EXPECT_TRUE(msg.cpu_devices(0).has_l3_domain());
+  EXPECT_FALSE(msg.cpu_devices(1).has_l3_domain());
+
+  std::unique_ptr<const CpuTopology> round_trip = CpuTopology::FromProto(msg);
+  EXPECT_EQ(round_trip->devices()[0], cpu_topology.devices()[0]);
+  EXPECT_EQ(round_trip->devices()[1], cpu_topology.devices()[1]);
+}
+
+// Returns `num_domains` L3 domains of `cores_per_domain` cores with two
+// hyperthreads each.
+std::vector<CpuCore> MakeCores(int num_domains, int cores_per_domain) {
+  std::vector<CpuCore> cores;
+  for (int domain = 0; domain < num_domains; ++domain) {
+    for (int i = 0; i < cores_per_domain; ++i) {
+      int core_id = domain * cores_per_domain + i;
+      cores.push_back(CpuCore{/*package=*/0, core_id, domain,
+                              /*cpus=*/{2 * core_id, 2 * core_id + 1}});
+    }
+  }
+  return cores;
+}
+
+TEST(CpuTopology, PartitionCpuCoresByL3Domain) {
+  std::vector<CpuCoreSet> sets =
+      PartitionCpuCores(MakeCores(/*num_domains=*/2, /*cores_per_domain=*/2),
+                        /*num_devices=*/2);
+  ASSERT_EQ(sets.size(), 2);
+  EXPECT_THAT(sets[0].cpus, ElementsAre(0, 1, 2, 3));
+  EXPECT_EQ(sets[0].l3_domain, 0);
+  EXPECT_THAT(sets[1].cpus, ElementsAre(4, 5, 6, 7));
+  EXPECT_EQ(sets[1].l3_domain, 1);
+}
+
+TEST(CpuTopology, PartitionCpuCoresAcrossL3Domains) {
+  std::vector<CpuCoreSet> sets =
+      PartitionCpuCores(MakeCores(/*num_domains=*/2, /*cores_per_domain=*/3),
+                        /*num_devices=*/4);
+  ASSERT_EQ(sets.size(), 4);
+  EXPECT_THAT(sets[0].cpus, ElementsAre(0, 1));
+  EXPECT_EQ(sets[0].l3_domain, 0);
+  EXPECT_THAT(sets[1].cpus, ElementsAre(2, 3, 4, 5));
+  EXPECT_EQ(sets[1].l3_domain, 0);
+  EXPECT_THAT(sets[2].cpus, ElementsAre(6, 7));
+  EXPECT_EQ(sets[2].l3_domain, 1);
+  EXPECT_THAT(sets[3].cpus, ElementsAre(8, 9, 10, 11));
+  EXPECT_EQ(sets[3].l3_domain, 1);
+}
+
+TEST(CpuTopology, PartitionCpuCoresSharesCoresBetweenDevices) {
+  std::vector<CpuCoreSet> sets =
+      PartitionCpuCores(MakeCores(/*num_domains=*/1, /*cores_per_domain=*/2),
+                        /*num_devices=*/3);
+  ASSERT_EQ(sets.size(), 3);
+  EXPECT_THAT(sets[0].cpus, ElementsAre(0, 1));
+  EXPECT_THAT(sets[1].cpus, ElementsAre(2, 3));
+  EXPECT_THAT(sets[2].cpus, ElementsAre(0, 1));
+}
+
+TEST(CpuTopology, PartitionNoCores) {
+  std::vector<CpuCoreSet> sets = PartitionCpuCores({}, /*num_devices=*/2);
+  ASSERT_EQ(sets.size(), 2);
+  EXPECT_THAT(sets[0].cpus, IsEmpty());
+  EXPECT_THAT(sets[1].cpus, IsEmpty());
+}
+
+TEST(CpuTopology, DetectCpuCores) {
+  for (const CpuCore& core : DetectCpuCores()) {
+    EXPECT_THAT(core.cpus, Not(IsEmpty()));
+  }
+}
+
 }  // namespace
 }  // namespace xla
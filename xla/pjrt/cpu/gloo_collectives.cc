@@ -38,6 +38,7 @@ limitations under the License.
 #include "gloo/algorithm.h"  // from @gloo
 #include "gloo/allgather.h"  // from @gloo
 #include "gloo/allreduce.h"  // from @gloo
+#include "gloo/allreduce_halving_doubling.h"  // from @gloo
 #include "gloo/context.h"  // from @gloo
 #include "gloo/math.h"  // from @gloo
 #include "gloo/reduce_scatter.h"  // from @gloo
@@ -56,12 +57,14 @@ limitations under the License.
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla::cpu {
 
 GlooCollectivesCommunicator::GlooCollectivesCommunicator(
-    std::shared_ptr<gloo::Context> context)
-    : context_(std::move(context)) {}
+    std::shared_ptr<gloo::Context> context,
+    GlooAllReduceOptions allreduce_options)
+    : context_(std::move(context)), allreduce_options_(allreduce_options) {}
 GlooCollectivesCommunicator::~GlooCollectivesCommunicator() = default;
 
 template <typename T>
@@ -104,84 +107,161 @@ static absl::Status SetAllReduceOptions(ReductionKind reduction_kind,
   return absl::OkStatus();
 }
 
+template <typename T>
+static absl::StatusOr<const gloo::ReductionFunction<T>*> GetReductionFunction(
+    ReductionKind reduction_kind) {
+  if constexpr (is_complex_v<T>) {
+    switch (reduction_kind) {
+      case ReductionKind::SUM:
+        return gloo::ReductionFunction<T>::sum;
+      case ReductionKind::PRODUCT:
+        return gloo::ReductionFunction<T>::product;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Unsupported reduction kind: ", static_cast<int>(reduction_kind)));
+    }
+  } else {
+    switch (reduction_kind) {
+      case ReductionKind::SUM:
+        return gloo::ReductionFunction<T>::sum;
+      case ReductionKind::PRODUCT:
+        return gloo::ReductionFunction<T>::product;
+      case ReductionKind::MAX:
+        return gloo::ReductionFunction<T>::max;
+      case ReductionKind::MIN:
+        return gloo::ReductionFunction<T>::min;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Unsupported reduction kind: ", static_cast<int>(reduction_kind)));
+    }
+  }
+}
+
+GlooAllReduceAlgorithm SelectGlooAllReduceAlgorithm(
+    const GlooAllReduceOptions& options, size_t num_bytes,
+    size_t num_elements, int world_size) {
+  // Halving-doubling splits the message across all participants, so it needs
+  // at least one element per participant.
+  if (num_bytes <= options.halving_doubling_max_bytes &&
+      num_elements >= static_cast<size_t>(world_size)) {
+    return GlooAllReduceAlgorithm::kHalvingDoubling;
+  }
+  if (num_bytes >= options.bcube_min_bytes) {
+    return GlooAllReduceAlgorithm::kBcube;
+  }
+  return GlooAllReduceAlgorithm::kRing;
+}
+
+template <typename T>
+static absl::Status AllReduceHelper(
+    const std::shared_ptr<gloo::Context>& context,
+    const GlooAllReduceOptions& allreduce_options,
+    ReductionKind reduction_kind, const void* input_buffer,
+    void* output_buffer, size_t num_elements, absl::Duration timeout) {
+  size_t num_bytes = num_elements * sizeof(T);
+  GlooAllReduceAlgorithm algorithm = SelectGlooAllReduceAlgorithm(
+      allreduce_options, num_bytes, num_elements, context->size);
+  VLOG(3) << "Gloo all-reduce of " << num_bytes << " bytes uses algorithm "
+          << static_cast<int>(algorithm);
+
+  try {
+    if (algorithm == GlooAllReduceAlgorithm::kHalvingDoubling) {
+      TF_ASSIGN_OR_RETURN(const gloo::ReductionFunction<T>* reduction_function,
+                          GetReductionFunction<T>(reduction_kind));
+      // Halving-doubling reduces in place and uses the context timeout.
+      if (output_buffer != input_buffer) {
+        std::memcpy(output_buffer, input_buffer, num_bytes);
+      }
+      gloo::AllreduceHalvingDoubling<T> allreduce(
+          context, std::vector<T*>{reinterpret_cast<T*>(output_buffer)},
+          num_elements, reduction_function);
+      allreduce.run();
+      return absl::OkStatus();
+    }
+
+    gloo::AllreduceOptions options(context);
+    // TODO(phawkins): how to do tags?
+    // options.setTag(tag);
+    TF_RETURN_IF_ERROR(SetAllReduceOptions<T>(
+        reduction_kind, input_buffer, output_buffer, num_elements, options));
+    options.setAlgorithm(algorithm == GlooAllReduceAlgorithm::kBcube
+                             ? gloo::AllreduceOptions::Algorithm::BCUBE
+                             : gloo::AllreduceOptions::Algorithm::RING);
+    options.setMaxSegmentSize(allreduce_options.max_segment_bytes);
+    options.setTimeout(absl::ToChronoMilliseconds(timeout));
+    gloo::allreduce(options);
+  } catch (std::exception& e) {
+    return absl::UnknownError(
+        absl::StrCat("Gloo all-reduce failed: ", e.what()));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status GlooCollectivesCommunicator::AllReduce(
     const RendezvousKey& key, ReductionKind reduction_kind,
     PrimitiveType element_type, size_t num_elements, const void* input_buffer,
     void* output_buffer, absl::Duration timeout) {
-  gloo::AllreduceOptions options(context_);
-  // TODO(phawkins): how to do tags?
-  // options.setTag(tag);
   switch (element_type) {
     case S8:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<int8_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<int8_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case PRED:
     case U8:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<uint8_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<uint8_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case S16:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<int16_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<int16_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case U16:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<uint16_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<uint16_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case S32:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<int32_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<int32_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case U32:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<uint32_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<uint32_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case S64:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<int64_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<int64_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case U64:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<uint64_t>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<uint64_t>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case F16:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<gloo::float16>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<gloo::float16>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case BF16:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<bfloat16>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<bfloat16>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case F32:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<float>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<float>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case F64:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<double>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<double>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case C64:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<std::complex<float>>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<std::complex<float>>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     case C128:
-      TF_RETURN_IF_ERROR(SetAllReduceOptions<std::complex<double>>(
-          reduction_kind, input_buffer, output_buffer, num_elements, options));
-      break;
+      return AllReduceHelper<std::complex<double>>(
+          context_, allreduce_options_, reduction_kind, input_buffer,
+          output_buffer, num_elements, timeout);
     default:
       return absl::InvalidArgumentError("Unknown datatype in allreduce");
   }
-  options.setAlgorithm(gloo::AllreduceOptions::Algorithm::RING);
-  options.setTimeout(absl::ToChronoMilliseconds(timeout));
-
-  try {
-    gloo::allreduce(options);
-  } catch (std::exception& e) {
-    return absl::UnknownError(
-        absl::StrCat("Gloo all-reduce failed: ", e.what()));
-  }
-  return absl::OkStatus();
 }
 
 static constexpr uint8_t kCollectivePermuteSlotPrefix = 0x40;
@@ -312,38 +392,8 @@ template <typename T>
 absl::Status ReduceScatterHelper(std::shared_ptr<gloo::Context> context,
                                  ReductionKind reduction_kind, void* buffer,
                                  size_t chunk_elems) {
-  const gloo::ReductionFunction<T>* reduction_function = nullptr;
-  if constexpr (is_complex_v<T>) {
-    switch (reduction_kind) {
-      case ReductionKind::SUM:
-        reduction_function = gloo::ReductionFunction<T>::sum;
-        break;
-      case ReductionKind::PRODUCT:
-        reduction_function = gloo::ReductionFunction<T>::product;
-        break;
-      default:
-        return absl::InvalidArgumentError(absl::StrCat(
-            "Unsupported reduction kind: ", static_cast<int>(reduction_kind)));
-    }
-  } else {
-    switch (reduction_kind) {
-      case ReductionKind::SUM:
-        reduction_function = gloo::ReductionFunction<T>::sum;
-        break;
-      case ReductionKind::PRODUCT:
-        reduction_function = gloo::ReductionFunction<T>::product;
-        break;
-      case ReductionKind::MAX:
-        reduction_function = gloo::ReductionFunction<T>::max;
-        break;
-      case ReductionKind::MIN:
-        reduction_function = gloo::ReductionFunction<T>::min;
-        break;
-      default:
-        return absl::InvalidArgumentError(absl::StrCat(
-            "Unsupported reduction kind: ", static_cast<int>(reduction_kind)));
-    }
-  }
+  TF_ASSIGN_OR_RETURN(const gloo::ReductionFunction<T>* reduction_function,
+                      GetReductionFunction<T>(reduction_kind));
   try {
     std::vector<int> recv_elems(context->size, chunk_elems);
     gloo::ReduceScatterHalvingDoubling<T> algorithm(
@@ -431,8 +481,11 @@ absl::Status GlooCollectivesCommunicator::ReduceScatter(
 
 GlooCollectives::GlooCollectives(
     std::unique_ptr<gloo::rendezvous::Store> store,
-    std::shared_ptr<gloo::transport::Device> device)
-    : store_(std::move(store)), device_(std::move(device)) {}
+    std::shared_ptr<gloo::transport::Device> device,
+    GlooAllReduceOptions allreduce_options)
+    : store_(std::move(store)),
+      device_(std::move(device)),
+      allreduce_options_(allreduce_options) {}
 
 GlooCollectives::~GlooCollectives() = default;
 
@@ -461,8 +514,8 @@ GlooCollectives::GetCommunicator(
     return absl::UnknownError(
         absl::StrCat("Gloo context initialization failed: ", e.what()));
   }
-  context =
-      std::make_shared<GlooCollectivesCommunicator>(std::move(gloo_context));
+  context = std::make_shared<GlooCollectivesCommunicator>(
+      std::move(gloo_context), allreduce_options_);
   return context;
 }
 
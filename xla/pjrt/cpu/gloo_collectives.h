@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_PJRT_CPU_GLOO_COLLECTIVES_H_
 
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <tuple>
@@ -39,9 +40,42 @@ limitations under the License.
 
 namespace xla::cpu {
 
+// Gloo algorithms used to implement all-reduce.
+enum class GlooAllReduceAlgorithm {
+  // Recursive halving-doubling: log2(n) steps, lowest latency for small
+  // messages.
+  kHalvingDoubling,
+  // Bandwidth-optimal ring.
+  kRing,
+  // BCube: fewer steps than the ring at the same bandwidth for large groups.
+  kBcube,
+};
+
+// Thresholds used to pick an all-reduce algorithm by message size.
+struct GlooAllReduceOptions {
+  // All-reduces of at most this many bytes use recursive halving-doubling.
+  size_t halving_doubling_max_bytes = 256 * 1024;
+
+  // All-reduces of at least this many bytes use bcube. All-reduces between the
+  // two thresholds use the ring algorithm. Disabled by default.
+  size_t bcube_min_bytes = std::numeric_limits<size_t>::max();
+
+  // Ring and bcube all-reduces are pipelined over segments of at most this
+  // many bytes, so that reducing one segment overlaps sending the next.
+  size_t max_segment_bytes = 1024 * 1024;
+};
+
+// Returns the all-reduce algorithm to use for `num_elements` elements that
+// take `num_bytes` bytes on `world_size` participants.
+GlooAllReduceAlgorithm SelectGlooAllReduceAlgorithm(
+    const GlooAllReduceOptions& options, size_t num_bytes,
+    size_t num_elements, int world_size);
+
 class GlooCollectivesCommunicator : public CollectivesCommunicator {
  public:
-  explicit GlooCollectivesCommunicator(std::shared_ptr<gloo::Context> context);
+  explicit GlooCollectivesCommunicator(
+      std::shared_ptr<gloo::Context> context,
+      GlooAllReduceOptions allreduce_options = {});
   ~GlooCollectivesCommunicator() override;
 
   absl::Status AllReduce(const RendezvousKey& key, ReductionKind reduction_kind,
@@ -68,12 +102,14 @@ class GlooCollectivesCommunicator : public CollectivesCommunicator {
 
  private:
   std::shared_ptr<gloo::Context> context_;
+  GlooAllReduceOptions allreduce_options_;
 };
 
 class GlooCollectives : public CollectivesInterface {
  public:
   GlooCollectives(std::unique_ptr<gloo::rendezvous::Store> store,
-                  std::shared_ptr<gloo::transport::Device> device);
+                  std::shared_ptr<gloo::transport::Device> device,
+                  GlooAllReduceOptions allreduce_options = {});
   ~GlooCollectives() override;
 
   // Thread-safe.
@@ -83,6 +119,7 @@ class GlooCollectives : public CollectivesInterface {
  private:
   std::unique_ptr<gloo::rendezvous::Store> store_;
   std::shared_ptr<gloo::transport::Device> device_;
+  GlooAllReduceOptions allreduce_options_;
   absl::Mutex mu_;
   absl::flat_hash_map<std::tuple<std::vector<GlobalDeviceId>, int>,
                       std::shared_ptr<GlooCollectivesCommunicator>>
@@ -22,7 +22,9 @@ limitations under the License.
 #include <memory>
 #include <vector>
 
+#include "absl/log/check.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "gloo/transport/tcp/attr.h"  // from @gloo
@@ -40,6 +42,7 @@ limitations under the License.
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
 #include "tsl/platform/threadpool.h"
 
 namespace xla::cpu {
@@ -54,10 +57,12 @@ constexpr absl::Duration kTimeout = absl::Seconds(5);
 
 absl::StatusOr<std::shared_ptr<CollectivesCommunicator>> GetCommunicator(
     size_t kNumParticipants, absl::Span<GlobalDeviceId const> global_devices,
-    const std::shared_ptr<xla::KeyValueStoreInterface>& kv_store, int rank) {
+    const std::shared_ptr<xla::KeyValueStoreInterface>& kv_store, int rank,
+    const GlooAllReduceOptions& allreduce_options = {}) {
   auto collectives = std::make_shared<cpu::GlooCollectives>(
       std::make_unique<cpu::GlooKeyValueStore>(kv_store),
-      gloo::transport::tcp::CreateDevice(gloo::transport::tcp::attr()));
+      gloo::transport::tcp::CreateDevice(gloo::transport::tcp::attr()),
+      allreduce_options);
   return collectives->GetCommunicator(global_devices, rank);
 }
 
@@ -72,12 +77,13 @@ RendezvousKey MakeRendezvousKey(std::vector<GlobalDeviceId> global_devices) {
 absl::StatusOr<std::vector<uint8_t>> AllReduce(
     const std::shared_ptr<xla::KeyValueStoreInterface>& kv_store,
     const std::vector<uint8_t>& input_buffer,
-    std::vector<GlobalDeviceId> global_devices, int rank) {
+    std::vector<GlobalDeviceId> global_devices, int rank,
+    const GlooAllReduceOptions& allreduce_options = {}) {
   std::vector<uint8_t> output_buffer(kBufferSize);
   RendezvousKey rendezvous_key = MakeRendezvousKey(global_devices);
-  TF_ASSIGN_OR_RETURN(
-      auto communicator,
-      GetCommunicator(kNumParticipants, global_devices, kv_store, rank));
+  TF_ASSIGN_OR_RETURN(auto communicator,
+                      GetCommunicator(kNumParticipants, global_devices,
+                                      kv_store, rank, allreduce_options));
 
   TF_RETURN_IF_ERROR(communicator->AllReduce(
       rendezvous_key, xla::ReductionKind::SUM, xla::PrimitiveType::U8,
@@ -86,7 +92,7 @@ absl::StatusOr<std::vector<uint8_t>> AllReduce(
   return output_buffer;
 }
 
-TEST(GlooCollectives, AllReduce) {
+void RunAllReduce(const GlooAllReduceOptions& allreduce_options) {
   std::vector<GlobalDeviceId> global_devices;
   global_devices.reserve(kNumParticipants);
   for (int rank = 0; rank < kNumParticipants; ++rank) {
@@ -105,10 +111,12 @@ TEST(GlooCollectives, AllReduce) {
         tsl::Env::Default(), "AllReduceParticipants", kNumParticipants);
     for (int rank = 0; rank < kNumParticipants; ++rank) {
       thread_pool.Schedule(
-          [rank, &output_buffers, &kv_store, &global_devices]() {
+          [rank, &output_buffers, &kv_store, &global_devices,
+           &allreduce_options]() {
             std::vector<uint8_t> input_buffer(kBufferSize, rank + 1);
-            output_buffers[rank] =
-                AllReduce(kv_store, input_buffer, global_devices, rank);
+            output_buffers[rank] = AllReduce(kv_store, input_buffer,
+                                             global_devices, rank,
+                                             allreduce_options);
           });
     }
   }
@@ -124,5 +132,91 @@ TEST(GlooCollectives, AllReduce) {
                 Each(Eq(kNumParticipants * (kNumParticipants + 1) / 2)));
   }
 }
+
+TEST(GlooCollectives, AllReduce) { RunAllReduce(GlooAllReduceOptions()); }
+
+TEST(GlooCollectives, AllReduceHalvingDoubling) {
+  GlooAllReduceOptions options;
+  options.halving_doubling_max_bytes = kBufferSize;
+  RunAllReduce(options);
+}
+
+TEST(GlooCollectives, AllReduceRing) {
+  GlooAllReduceOptions options;
+  options.halving_doubling_max_bytes = 0;
+  options.max_segment_bytes = kBufferSize / 4;
+  RunAllReduce(options);
+}
+
+TEST(GlooCollectives, AllReduceBcube) {
+  GlooAllReduceOptions options;
+  options.halving_doubling_max_bytes = 0;
+  options.bcube_min_bytes = 0;
+  RunAllReduce(options);
+}
+
+TEST(GlooCollectives, SelectAllReduceAlgorithm) {
+  GlooAllReduceOptions options;
+  options.halving_doubling_max_bytes = 1024;
+  options.bcube_min_bytes = 1024 * 1024;
+
+  EXPECT_EQ(SelectGlooAllReduceAlgorithm(options, 1024, 256, 4),
+            GlooAllReduceAlgorithm::kHalvingDoubling);
+  EXPECT_EQ(SelectGlooAllReduceAlgorithm(options, 4096, 1024, 4),
+            GlooAllReduceAlgorithm::kRing);
+  EXPECT_EQ(SelectGlooAllReduceAlgorithm(options, 1024 * 1024, 256 * 1024, 4),
+            GlooAllReduceAlgorithm::kBcube);
+  // Halving-doubling needs at least one element per participant.
+  EXPECT_EQ(SelectGlooAllReduceAlgorithm(options, 8, 2, 4),
+            GlooAllReduceAlgorithm::kRing);
+}
+
+// Benchmarks a two participant f32 all-reduce of `state.range(0)` bytes with
+// the default algorithm selection.
+void BM_AllReduce(::testing::benchmark::State& state) {
+  size_t num_elements = state.range(0) / sizeof(float);
+  std::vector<GlobalDeviceId> global_devices = {GlobalDeviceId(0),
+                                                GlobalDeviceId(1)};
+  RendezvousKey rendezvous_key = MakeRendezvousKey(global_devices);
+  auto kv_store = std::make_shared<xla::InMemoryKeyValueStore>();
+
+  std::vector<std::shared_ptr<CollectivesCommunicator>> communicators(
+      kNumParticipants);
+  std::vector<std::vector<float>> inputs(
+      kNumParticipants, std::vector<float>(num_elements, 1.0f));
+  std::vector<std::vector<float>> outputs(kNumParticipants,
+                                          std::vector<float>(num_elements));
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "BM_AllReduce",
+                                      kNumParticipants);
+
+  auto run_on_all_ranks = [&](auto fn) {
+    absl::BlockingCounter counter(kNumParticipants);
+    for (int rank = 0; rank < kNumParticipants; ++rank) {
+      thread_pool.Schedule([&, rank] {
+        fn(rank);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  };
+
+  run_on_all_ranks([&](int rank) {
+    communicators[rank] =
+        GetCommunicator(kNumParticipants, global_devices, kv_store, rank)
+            .value();
+  });
+
+  for (auto s : state) {
+    run_on_all_ranks([&](int rank) {
+      CHECK_OK(communicators[rank]->AllReduce(
+          rendezvous_key, xla::ReductionKind::SUM, xla::PrimitiveType::F32,
+          num_elements, inputs[rank].data(), outputs[rank].data(), kTimeout));
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AllReduce)->RangeMultiplier(16)->Range(4 << 10, 256 << 20);
+
 }  // namespace
 }  // namespace xla::cpu
@@ -125,6 +125,33 @@ static absl::Status MpiErrorToAbslStatus(int error) {
   return absl::OkStatus();
 }
 
+// Waits for nonblocking operations to complete, or fails once `timeout` has
+// passed. Unlike MPI_Waitall, this honours the collective timeout. Requests
+// that are still pending after a timeout are leaked, since nonblocking
+// collectives cannot be cancelled.
+static absl::Status WaitForRequests(absl::Span<MPI_Request> requests,
+                                    absl::Duration timeout) {
+  absl::Time deadline = absl::Now() + timeout;
+  while (true) {
+    int done = 0;
+    TF_RETURN_IF_ERROR(MpiErrorToAbslStatus(MPI_Testall(
+        requests.size(), requests.data(), &done, MPI_STATUSES_IGNORE)));
+    if (done) {
+      return absl::OkStatus();
+    }
+    if (absl::Now() > deadline) {
+      return absl::DeadlineExceededError(absl::StrCat(
+          "MPI: timed out after ", absl::FormatDuration(timeout),
+          " waiting for ", requests.size(), " operations"));
+    }
+  }
+}
+
+static absl::Status WaitForRequest(MPI_Request request,
+                                   absl::Duration timeout) {
+  return WaitForRequests(absl::MakeSpan(&request, 1), timeout);
+}
+
 MpiCollectivesCommunicator::MpiCollectivesCommunicator(int color, int key) {
   MPI_Comm_split(MPI_COMM_WORLD, color, key, &comm_);
   MPI_Comm_rank(comm_, &mpi_rank_);
@@ -141,8 +168,13 @@ absl::Status MpiCollectivesCommunicator::AllReduce(
     void* output_buffer, absl::Duration timeout) {
   TF_ASSIGN_OR_RETURN(MPI_Datatype type, PrimitiveTypeToMpiType(element_type));
   TF_ASSIGN_OR_RETURN(MPI_Op op, ReductionKindToMpiOp(reduction_kind, type));
-  return MpiErrorToAbslStatus(MPI_Allreduce(input_buffer, output_buffer,
-                                            num_elements, type, op, comm_));
+  // MPI forbids aliasing send and receive buffers unless marked in place.
+  const void* send_buffer =
+      input_buffer == output_buffer ? MPI_IN_PLACE : input_buffer;
+  MPI_Request request;
+  TF_RETURN_IF_ERROR(MpiErrorToAbslStatus(MPI_Iallreduce(
+      send_buffer, output_buffer, num_elements, type, op, comm_, &request)));
+  return WaitForRequest(request, timeout);
 }
 
 absl::Status MpiCollectivesCommunicator::CollectivePermute(
@@ -179,12 +211,7 @@ absl::Status MpiCollectivesCommunicator::CollectivePermute(
     }
   }
 
-  for (auto& request : requests) {
-    TF_RETURN_IF_ERROR(
-        MpiErrorToAbslStatus(MPI_Wait(&request, MPI_STATUS_IGNORE)));
-  }
-
-  return absl::OkStatus();
+  return WaitForRequests(absl::MakeSpan(requests), timeout);
 }
 
 absl::Status MpiCollectivesCommunicator::AllToAll(
@@ -192,7 +219,8 @@ absl::Status MpiCollectivesCommunicator::AllToAll(
     absl::Span<const void* const> input_buffers,
     absl::Span<void* const> output_buffers, absl::Duration timeout) {
   // We can't use MPI_Alltoall directly because it assumes that the inputs and
-  // outputs are contiguous. Therefore here we implement it using MPI_Sendrecv.
+  // outputs are contiguous. Therefore here we implement it using point to
+  // point messages, all posted up front so that they progress concurrently.
 
   int tag = 0;  // TODO use better tags.
   const int rank = mpi_rank_;
@@ -202,16 +230,22 @@ absl::Status MpiCollectivesCommunicator::AllToAll(
 
   std::memcpy(output_buffers[rank], input_buffers[rank], chunk_bytes);
 
+  std::vector<MPI_Request> requests;
+  requests.reserve(2 * (size - 1));
   for (int i = 1; i < size; i++) {
-    int send_rank = (rank + i) % size;
     int recv_rank = (rank + size - i) % size;
     TF_RETURN_IF_ERROR(MpiErrorToAbslStatus(
-        MPI_Sendrecv(input_buffers[send_rank], chunk_bytes, MPI_BYTE, send_rank,
-                     tag, output_buffers[recv_rank], chunk_bytes, MPI_BYTE,
-                     recv_rank, tag, comm_, MPI_STATUS_IGNORE)));
+        MPI_Irecv(output_buffers[recv_rank], chunk_bytes, MPI_BYTE, recv_rank,
+                  tag, comm_, &requests.emplace_back())));
+  }
+  for (int i = 1; i < size; i++) {
+    int send_rank = (rank + i) % size;
+    TF_RETURN_IF_ERROR(MpiErrorToAbslStatus(
+        MPI_Isend(input_buffers[send_rank], chunk_bytes, MPI_BYTE, send_rank,
+                  tag, comm_, &requests.emplace_back())));
   }
 
-  return absl::OkStatus();
+  return WaitForRequests(absl::MakeSpan(requests), timeout);
 }
 
 absl::Status MpiCollectivesCommunicator::AllGather(const RendezvousKey& key,
@@ -219,21 +253,24 @@ absl::Status MpiCollectivesCommunicator::AllGather(const RendezvousKey& key,
                                                    const void* input_buffer,
                                                    void* output_buffer,
                                                    absl::Duration timeout) {
-  return MpiErrorToAbslStatus(MPI_Allgather(input_buffer, chunk_bytes, MPI_BYTE,
-                                            output_buffer, chunk_bytes,
-                                            MPI_BYTE, comm_));
+  MPI_Request request;
+  TF_RETURN_IF_ERROR(MpiErrorToAbslStatus(
+      MPI_Iallgather(input_buffer, chunk_bytes, MPI_BYTE, output_buffer,
+                     chunk_bytes, MPI_BYTE, comm_, &request)));
+  return WaitForRequest(request, timeout);
 }
 
 absl::Status MpiCollectivesCommunicator::ReduceScatter(
     const RendezvousKey& key, ReductionKind reduction_kind,
     PrimitiveType element_type, size_t chunk_elems, const void* input_buffer,
     void* output_buffer, absl::Duration timeout) {
-  const int size = mpi_size_;
-  std::vector<int> recvcounts(size, chunk_elems);
   TF_ASSIGN_OR_RETURN(MPI_Datatype type, PrimitiveTypeToMpiType(element_type));
   TF_ASSIGN_OR_RETURN(MPI_Op op, ReductionKindToMpiOp(reduction_kind, type));
-  return MpiErrorToAbslStatus(MPI_Reduce_scatter(
-      input_buffer, output_buffer, recvcounts.data(), type, op, comm_));
+  MPI_Request request;
+  TF_RETURN_IF_ERROR(MpiErrorToAbslStatus(
+      MPI_Ireduce_scatter_block(input_buffer, output_buffer, chunk_elems, type,
+                                op, comm_, &request)));
+  return WaitForRequest(request, timeout);
 }
 
 void MpiCollectives::Init() {
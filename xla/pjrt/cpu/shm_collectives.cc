@@ -0,0 +1,637 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/shm_collectives.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "xla/pjrt/distributed/key_value_store_interface.h"
+#include "xla/primitive_util.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/service/cpu/collectives_interface.h"
+#include "xla/service/global_device_id.h"
+#include "xla/status_macros.h"
+#include "xla/types.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/host_info.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::cpu {
+namespace {
+
+constexpr uint64_t kShmMagic = 0x786c612d73686d31;  // "xla-shm1"
+constexpr size_t kCacheLineSize = 64;
+constexpr size_t kPageSize = 4096;
+
+// The widest supported element type is C128.
+constexpr size_t kMaxElementBytes = 16;
+
+// Number of failed polls of a barrier before the waiting thread starts to
+// yield, and number of polls between two deadline checks after that.
+constexpr int kSpinsBeforeYield = 1024;
+constexpr int kSpinsPerDeadlineCheck = 1024;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory barriers require lock-free 64-bit atomics");
+
+struct ShmHeader {
+  uint64_t magic;
+  uint64_t world_size;
+  uint64_t slot_bytes;
+};
+
+// Control words live on separate cache lines, so that ranks arriving at a
+// barrier do not invalidate the lines polled by the other ranks.
+struct alignas(kCacheLineSize) RankControl {
+  std::atomic<uint64_t> barrier_count;
+};
+
+static_assert(sizeof(ShmHeader) <= kCacheLineSize);
+
+size_t DataOffset(int world_size) {
+  return RoundUpTo<size_t>(kCacheLineSize * (1 + world_size), kPageSize);
+}
+
+size_t SegmentSize(int world_size, size_t slot_bytes) {
+  return DataOffset(world_size) + 2 * world_size * slot_bytes;
+}
+
+void FormatGlobalId(std::string* out, const GlobalDeviceId& device) {
+  absl::StrAppend(out, device.value());
+}
+
+// Splits `num_elems` elements of `elem_bytes` bytes into `world_size`
+// contiguous ranges that start on cache line boundaries, and returns the
+// [begin, end) range of `rank`.
+std::pair<size_t, size_t> PartitionRange(size_t num_elems, size_t elem_bytes,
+                                         int world_size, int rank) {
+  size_t align = std::max<size_t>(1, kCacheLineSize / elem_bytes);
+  size_t per_rank = RoundUpTo(CeilOfRatio<size_t>(num_elems, world_size),
+                              align);
+  size_t begin = std::min(num_elems, rank * per_rank);
+  size_t end = std::min(num_elems, begin + per_rank);
+  return {begin, end};
+}
+
+// Reduces `input` into `acc` element-wise.
+using ReduceFn = void (*)(void* acc, const void* input, size_t num_elems);
+
+// The staging slots never alias the destination, so the loops below are
+// written over restrict pointers and compile to vector code.
+template <typename T, ReductionKind reduction_kind>
+void ReduceInto(void* acc_ptr, const void* input_ptr, size_t num_elems) {
+  T* __restrict acc = static_cast<T*>(acc_ptr);
+  const T* __restrict input = static_cast<const T*>(input_ptr);
+  for (size_t i = 0; i < num_elems; ++i) {
+    if constexpr (reduction_kind == ReductionKind::SUM) {
+      acc[i] += input[i];
+    } else if constexpr (reduction_kind == ReductionKind::PRODUCT) {
+      acc[i] *= input[i];
+    } else if constexpr (reduction_kind == ReductionKind::MIN) {
+      acc[i] = input[i] < acc[i] ? input[i] : acc[i];
+    } else {
+      acc[i] = input[i] > acc[i] ? input[i] : acc[i];
+    }
+  }
+}
+
+template <typename T>
+absl::StatusOr<ReduceFn> GetReduceFn(ReductionKind reduction_kind) {
+  switch (reduction_kind) {
+    case ReductionKind::SUM:
+      return &ReduceInto<T, ReductionKind::SUM>;
+    case ReductionKind::PRODUCT:
+      return &ReduceInto<T, ReductionKind::PRODUCT>;
+    case ReductionKind::MIN:
+      if constexpr (!is_complex_v<T>) {
+        return &ReduceInto<T, ReductionKind::MIN>;
+      } else {
+        return absl::InvalidArgumentError(
+            "Min reductions not supported for complex types");
+      }
+    case ReductionKind::MAX:
+      if constexpr (!is_complex_v<T>) {
+        return &ReduceInto<T, ReductionKind::MAX>;
+      } else {
+        return absl::InvalidArgumentError(
+            "Max reductions not supported for complex types");
+      }
+  }
+}
+
+absl::StatusOr<ReduceFn> GetReduceFn(PrimitiveType element_type,
+                                     ReductionKind reduction_kind) {
+  switch (element_type) {
+    case S8:
+      return GetReduceFn<int8_t>(reduction_kind);
+    case PRED:
+    case U8:
+      return GetReduceFn<uint8_t>(reduction_kind);
+    case S16:
+      return GetReduceFn<int16_t>(reduction_kind);
+    case U16:
+      return GetReduceFn<uint16_t>(reduction_kind);
+    case S32:
+      return GetReduceFn<int32_t>(reduction_kind);
+    case U32:
+      return GetReduceFn<uint32_t>(reduction_kind);
+    case S64:
+      return GetReduceFn<int64_t>(reduction_kind);
+    case U64:
+      return GetReduceFn<uint64_t>(reduction_kind);
+    case F16:
+      return GetReduceFn<half>(reduction_kind);
+    case BF16:
+      return GetReduceFn<bfloat16>(reduction_kind);
+    case F32:
+      return GetReduceFn<float>(reduction_kind);
+    case F64:
+      return GetReduceFn<double>(reduction_kind);
+    case C64:
+      return GetReduceFn<std::complex<float>>(reduction_kind);
+    case C128:
+      return GetReduceFn<std::complex<double>>(reduction_kind);
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported element type in shared memory reduction: ",
+                       PrimitiveType_Name(element_type)));
+  }
+}
+
+}  // namespace
+
+class ShmSegment {
+ public:
+  // Creates and maps a new segment called `name`.
+  static absl::StatusOr<std::unique_ptr<ShmSegment>> Create(
+      const std::string& name, int world_size, size_t slot_bytes);
+
+  // Maps an existing segment created by another rank.
+  static absl::StatusOr<std::unique_ptr<ShmSegment>> Open(
+      const std::string& name, int world_size);
+
+  ~ShmSegment();
+
+  // Removes the name of the segment. The memory stays mapped until all ranks
+  // destroy their segments.
+  absl::Status Unlink();
+
+  RankControl& control(int rank) const {
+    return reinterpret_cast<RankControl*>(base_ + kCacheLineSize)[rank];
+  }
+
+  std::byte* slot(int rank, int index) const {
+    return base_ + DataOffset(world_size_) + (2 * rank + index) * slot_bytes();
+  }
+
+  int world_size() const { return world_size_; }
+  size_t slot_bytes() const { return header().slot_bytes; }
+
+ private:
+  ShmSegment(std::string name, std::byte* base, size_t size, int world_size,
+             bool owner)
+      : name_(std::move(name)),
+        base_(base),
+        size_(size),
+        world_size_(world_size),
+        owner_(owner) {}
+
+  const ShmHeader& header() const {
+    return *reinterpret_cast<const ShmHeader*>(base_);
+  }
+
+  std::string name_;
+  std::byte* base_;
+  size_t size_;
+  int world_size_;
+
+  // True if this segment created the name and must unlink it.
+  bool owner_;
+};
+
+absl::StatusOr<std::unique_ptr<ShmSegment>> ShmSegment::Create(
+    const std::string& name, int world_size, size_t slot_bytes) {
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return tsl::errors::IOError(absl::StrCat("shm_open ", name), errno);
+  }
+  size_t size = SegmentSize(world_size, slot_bytes);
+  if (ftruncate(fd, size) != 0) {
+    int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    return tsl::errors::IOError(absl::StrCat("ftruncate ", name), error);
+  }
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return tsl::errors::IOError(absl::StrCat("mmap ", name), error);
+  }
+
+  // ftruncate zero-fills the segment, so the barrier counters start at zero.
+  new (base) ShmHeader{kShmMagic, static_cast<uint64_t>(world_size),
+                       slot_bytes};
+  auto* controls =
+      reinterpret_cast<RankControl*>(static_cast<std::byte*>(base) +
+                                     kCacheLineSize);
+  for (int i = 0; i < world_size; ++i) {
+    new (&controls[i]) RankControl{0};
+  }
+  return std::unique_ptr<ShmSegment>(new ShmSegment(
+      name, static_cast<std::byte*>(base), size, world_size, /*owner=*/true));
+}
+
+absl::StatusOr<std::unique_ptr<ShmSegment>> ShmSegment::Open(
+    const std::string& name, int world_size) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return tsl::errors::IOError(absl::StrCat("shm_open ", name), errno);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int error = errno;
+    close(fd);
+    return tsl::errors::IOError(absl::StrCat("fstat ", name), error);
+  }
+  size_t size = st.st_size;
+  if (size < DataOffset(world_size)) {
+    close(fd);
+    return absl::FailedPreconditionError(
+        absl::StrFormat("Shared memory segment %s is too small: %d bytes", name,
+                        size));
+  }
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    return tsl::errors::IOError(absl::StrCat("mmap ", name), error);
+  }
+
+  auto segment = std::unique_ptr<ShmSegment>(new ShmSegment(
+      name, static_cast<std::byte*>(base), size, world_size, /*owner=*/false));
+  const ShmHeader& header = segment->header();
+  if (header.magic != kShmMagic ||
+      header.world_size != static_cast<uint64_t>(world_size) ||
+      size != SegmentSize(world_size, header.slot_bytes)) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Shared memory segment %s does not belong to a clique of %d ranks",
+        name, world_size));
+  }
+  return segment;
+}
+
+ShmSegment::~ShmSegment() {
+  if (owner_) {
+    Unlink().IgnoreError();
+  }
+  munmap(base_, size_);
+}
+
+absl::Status ShmSegment::Unlink() {
+  if (!owner_) return absl::OkStatus();
+  owner_ = false;
+  if (shm_unlink(name_.c_str()) != 0) {
+    return tsl::errors::IOError(absl::StrCat("shm_unlink ", name_), errno);
+  }
+  return absl::OkStatus();
+}
+
+ShmCollectivesCommunicator::ShmCollectivesCommunicator(
+    std::unique_ptr<ShmSegment> segment, int rank)
+    : segment_(std::move(segment)),
+      rank_(rank),
+      world_size_(segment_->world_size()),
+      slot_bytes_(segment_->slot_bytes()) {}
+
+ShmCollectivesCommunicator::~ShmCollectivesCommunicator() = default;
+
+std::byte* ShmCollectivesCommunicator::NextSlot() {
+  ++epoch_;
+  return Slot(rank_);
+}
+
+std::byte* ShmCollectivesCommunicator::Slot(int rank) const {
+  return segment_->slot(rank, epoch_ & 1);
+}
+
+absl::Status ShmCollectivesCommunicator::Barrier(absl::Time deadline) {
+  uint64_t count = ++barrier_count_;
+  segment_->control(rank_).barrier_count.store(count,
+                                               std::memory_order_release);
+  for (int i = 0; i < world_size_; ++i) {
+    std::atomic<uint64_t>& other = segment_->control(i).barrier_count;
+    int64_t spins = 0;
+    while (other.load(std::memory_order_acquire) < count) {
+      if (++spins < kSpinsBeforeYield) continue;
+      std::this_thread::yield();
+      if (spins % kSpinsPerDeadlineCheck == 0 && absl::Now() > deadline) {
+        return absl::DeadlineExceededError(absl::StrFormat(
+            "Rank %d timed out waiting for rank %d at a shared memory barrier",
+            rank_, i));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShmCollectivesCommunicator::AllReduce(
+    const RendezvousKey& key, ReductionKind reduction_kind,
+    PrimitiveType element_type, size_t num_elements, const void* input_buffer,
+    void* output_buffer, absl::Duration timeout) {
+  absl::Time deadline = absl::Now() + timeout;
+  TF_ASSIGN_OR_RETURN(ReduceFn reduce,
+                      GetReduceFn(element_type, reduction_kind));
+  size_t elem_bytes = primitive_util::ByteWidth(element_type);
+  size_t piece_elems = slot_bytes_ / elem_bytes;
+  auto* input = static_cast<const std::byte*>(input_buffer);
+  auto* output = static_cast<std::byte*>(output_buffer);
+
+  for (size_t offset = 0; offset < num_elements; offset += piece_elems) {
+    size_t n = std::min(piece_elems, num_elements - offset);
+    std::byte* slot = NextSlot();
+    std::memcpy(slot, input + offset * elem_bytes, n * elem_bytes);
+    TF_RETURN_IF_ERROR(Barrier(deadline));
+
+    // Every rank reduces its own range of the piece into its slot...
+    auto [begin, end] = PartitionRange(n, elem_bytes, world_size_, rank_);
+    for (int i = 0; i < world_size_ && begin < end; ++i) {
+      if (i != rank_) {
+        reduce(slot + begin * elem_bytes, Slot(i) + begin * elem_bytes,
+               end - begin);
+      }
+    }
+    TF_RETURN_IF_ERROR(Barrier(deadline));
+
+    // ... and then gathers the reduced ranges of all ranks.
+    for (int i = 0; i < world_size_; ++i) {
+      auto [begin, end] = PartitionRange(n, elem_bytes, world_size_, i);
+      std::memcpy(output + (offset + begin) * elem_bytes,
+                  Slot(i) + begin * elem_bytes, (end - begin) * elem_bytes);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShmCollectivesCommunicator::CollectivePermute(
+    const RendezvousKey& key, size_t num_bytes, std::optional<int> source_rank,
+    absl::Span<int const> target_ranks, const void* input_buffer,
+    void* output_buffer, absl::Duration timeout) {
+  absl::Time deadline = absl::Now() + timeout;
+  auto* input = static_cast<const std::byte*>(input_buffer);
+  auto* output = static_cast<std::byte*>(output_buffer);
+  bool sends = absl::c_any_of(target_ranks,
+                              [&](int target) { return target != rank_; });
+  bool receives = source_rank.has_value() && *source_rank != rank_;
+
+  // All ranks take part in the barriers, even the ones that neither send nor
+  // receive.
+  for (size_t offset = 0; offset < num_bytes; offset += slot_bytes_) {
+    size_t n = std::min(slot_bytes_, num_bytes - offset);
+    std::byte* slot = NextSlot();
+    if (sends) {
+      std::memcpy(slot, input + offset, n);
+    }
+    TF_RETURN_IF_ERROR(Barrier(deadline));
+    if (receives) {
+      std::memcpy(output + offset, Slot(*source_rank), n);
+    }
+  }
+
+  if (!source_rank) {
+    std::memset(output_buffer, 0, num_bytes);
+  } else if (*source_rank == rank_) {
+    std::memcpy(output_buffer, input_buffer, num_bytes);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShmCollectivesCommunicator::AllToAll(
+    const RendezvousKey& key, size_t chunk_bytes,
+    absl::Span<const void* const> input_buffers,
+    absl::Span<void* const> output_buffers, absl::Duration timeout) {
+  absl::Time deadline = absl::Now() + timeout;
+  TF_RET_CHECK(world_size_ == input_buffers.size());
+  TF_RET_CHECK(world_size_ == output_buffers.size());
+
+  std::memcpy(output_buffers[rank_], input_buffers[rank_], chunk_bytes);
+
+  // Every epoch stages the same range of the chunks sent to all ranks.
+  size_t piece_bytes = slot_bytes_ / world_size_;
+  for (size_t offset = 0; offset < chunk_bytes; offset += piece_bytes) {
+    size_t n = std::min(piece_bytes, chunk_bytes - offset);
+    std::byte* slot = NextSlot();
+    for (int i = 0; i < world_size_; ++i) {
+      if (i != rank_) {
+        std::memcpy(slot + i * piece_bytes,
+                    static_cast<const std::byte*>(input_buffers[i]) + offset,
+                    n);
+      }
+    }
+    TF_RETURN_IF_ERROR(Barrier(deadline));
+    for (int i = 0; i < world_size_; ++i) {
+      if (i != rank_) {
+        std::memcpy(static_cast<std::byte*>(output_buffers[i]) + offset,
+                    Slot(i) + rank_ * piece_bytes, n);
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShmCollectivesCommunicator::AllGather(const RendezvousKey& key,
+                                                   size_t chunk_bytes,
+                                                   const void* input_buffer,
+                                                   void* output_buffer,
+                                                   absl::Duration timeout) {
+  absl::Time deadline = absl::Now() + timeout;
+  auto* input = static_cast<const std::byte*>(input_buffer);
+  auto* output = static_cast<std::byte*>(output_buffer);
+
+  for (size_t offset = 0; offset < chunk_bytes; offset += slot_bytes_) {
+    size_t n = std::min(slot_bytes_, chunk_bytes - offset);
+    std::byte* slot = NextSlot();
+    std::memcpy(slot, input + offset, n);
+    TF_RETURN_IF_ERROR(Barrier(deadline));
+    for (int i = 0; i < world_size_; ++i) {
+      std::memcpy(output + i * chunk_bytes + offset, Slot(i), n);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShmCollectivesCommunicator::ReduceScatter(
+    const RendezvousKey& key, ReductionKind reduction_kind,
+    PrimitiveType element_type, size_t chunk_elems, const void* input_buffer,
+    void* output_buffer, absl::Duration timeout) {
+  absl::Time deadline = absl::Now() + timeout;
+  TF_ASSIGN_OR_RETURN(ReduceFn reduce,
+                      GetReduceFn(element_type, reduction_kind));
+  size_t elem_bytes = primitive_util::ByteWidth(element_type);
+  auto* input = static_cast<const std::byte*>(input_buffer);
+  auto* output = static_cast<std::byte*>(output_buffer);
+
+  // Every epoch stages the same range of the chunks of all ranks.
+  size_t piece_elems = slot_bytes_ / (world_size_ * elem_bytes);
+  for (size_t offset = 0; offset < chunk_elems; offset += piece_elems) {
+    size_t n = std::min(piece_elems, chunk_elems - offset);
+    size_t piece_bytes = n * elem_bytes;
+    std::byte* slot = NextSlot();
+    for (int i = 0; i < world_size_; ++i) {
+      std::memcpy(slot + i * piece_bytes,
+                  input + (i * chunk_elems + offset) * elem_bytes,
+                  piece_bytes);
+    }
+    TF_RETURN_IF_ERROR(Barrier(deadline));
+
+    std::byte* out = output + offset * elem_bytes;
+    std::memcpy(out, slot + rank_ * piece_bytes, piece_bytes);
+    for (int i = 0; i < world_size_; ++i) {
+      if (i != rank_) {
+        reduce(out, Slot(i) + rank_ * piece_bytes, n);
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+ShmCollectives::ShmCollectives(std::shared_ptr<KeyValueStoreInterface> kv_store,
+                               std::shared_ptr<CollectivesInterface> fallback,
+                               ShmCollectivesOptions options)
+    : kv_store_(std::move(kv_store)),
+      fallback_(std::move(fallback)),
+      options_(options) {}
+
+ShmCollectives::~ShmCollectives() = default;
+
+absl::StatusOr<std::shared_ptr<CollectivesCommunicator>>
+ShmCollectives::GetCommunicator(absl::Span<GlobalDeviceId const> devices,
+                                int rank) {
+  auto key = std::make_tuple(
+      std::vector<GlobalDeviceId>(devices.begin(), devices.end()), rank);
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = contexts_.find(key);
+    if (it != contexts_.end()) {
+      return it->second;
+    }
+  }
+
+  // The rendezvous blocks until all ranks arrive, so it must not hold the
+  // lock: other ranks of the clique may live in this process.
+  TF_ASSIGN_OR_RETURN(std::shared_ptr<CollectivesCommunicator> communicator,
+                      CreateCommunicator(devices, rank));
+  absl::MutexLock lock(&mu_);
+  return contexts_.try_emplace(std::move(key), std::move(communicator))
+      .first->second;
+}
+
+absl::StatusOr<std::shared_ptr<CollectivesCommunicator>>
+ShmCollectives::CreateCommunicator(absl::Span<GlobalDeviceId const> devices,
+                                   int rank) {
+  static std::atomic<int> next_segment_id = 0;
+
+  if (kv_store_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "Shared memory collectives require a key-value store");
+  }
+
+  int world_size = devices.size();
+  absl::Duration timeout = options_.rendezvous_timeout;
+  std::string prefix =
+      absl::StrCat("shm/", absl::StrJoin(devices, ",", FormatGlobalId), "/");
+
+  // Shared memory only works if all ranks run on the same host.
+  std::string hostname = tsl::port::Hostname();
+  TF_RETURN_IF_ERROR(
+      kv_store_->Set(absl::StrCat(prefix, "host/", rank), hostname));
+  bool same_host = true;
+  for (int i = 0; i < world_size; ++i) {
+    TF_ASSIGN_OR_RETURN(
+        std::string other,
+        kv_store_->Get(absl::StrCat(prefix, "host/", i), timeout));
+    same_host &= other == hostname;
+  }
+  if (!same_host) {
+    if (fallback_) {
+      VLOG(1) << "Clique " << prefix << " spans several hosts; using the "
+              << "fallback collectives";
+      return fallback_->GetCommunicator(devices, rank);
+    }
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Shared memory collectives require all ranks to run on one host, but "
+        "clique ",
+        prefix, " spans several hosts"));
+  }
+
+  std::unique_ptr<ShmSegment> segment;
+  if (rank == 0) {
+    size_t slot_bytes = RoundUpTo<size_t>(
+        std::max(options_.slot_bytes, world_size * kMaxElementBytes),
+        kPageSize);
+    std::string name = absl::StrFormat("/xla_cpu_collectives_%d_%d", getpid(),
+                                       next_segment_id++);
+    TF_ASSIGN_OR_RETURN(segment,
+                        ShmSegment::Create(name, world_size, slot_bytes));
+    TF_RETURN_IF_ERROR(kv_store_->Set(absl::StrCat(prefix, "name"), name));
+  } else {
+    TF_ASSIGN_OR_RETURN(std::string name,
+                        kv_store_->Get(absl::StrCat(prefix, "name"), timeout));
+    TF_ASSIGN_OR_RETURN(segment, ShmSegment::Open(name, world_size));
+  }
+
+  ShmSegment* segment_ptr = segment.get();
+  auto communicator =
+      std::make_shared<ShmCollectivesCommunicator>(std::move(segment), rank);
+
+  // Once every rank has mapped the segment it no longer needs a name.
+  TF_RETURN_IF_ERROR(communicator->Barrier(absl::Now() + timeout));
+  TF_RETURN_IF_ERROR(segment_ptr->Unlink());
+  return communicator;
+}
+
+}  // namespace xla::cpu
@@ -0,0 +1,141 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_CPU_SHM_COLLECTIVES_H_
+#define XLA_PJRT_CPU_SHM_COLLECTIVES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "xla/pjrt/distributed/key_value_store_interface.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/service/cpu/collectives_interface.h"
+#include "xla/service/global_device_id.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla::cpu {
+
+struct ShmCollectivesOptions {
+  // Size of each of the two staging buffers every rank owns in the shared
+  // memory segment. Collectives larger than this are processed in pieces.
+  size_t slot_bytes = 4 * 1024 * 1024;
+
+  // Timeout for the rendezvous that creates a communicator.
+  absl::Duration rendezvous_timeout = absl::Minutes(1);
+};
+
+// A shared memory segment mapped by all ranks of a clique.
+//
+// Every rank owns a control word and two staging slots. A collective is a
+// sequence of epochs: in each epoch every rank writes into one of its slots,
+// waits at a barrier and then reads the slots of the other ranks. Epochs
+// alternate between the two slots, so a rank may start writing the next epoch
+// while slower ranks still read the previous one.
+class ShmSegment;
+
+class ShmCollectivesCommunicator : public CollectivesCommunicator {
+ public:
+  ShmCollectivesCommunicator(std::unique_ptr<ShmSegment> segment, int rank);
+  ~ShmCollectivesCommunicator() override;
+
+  absl::Status AllReduce(const RendezvousKey& key, ReductionKind reduction_kind,
+                         PrimitiveType element_type, size_t num_elements,
+                         const void* input_buffer, void* output_buffer,
+                         absl::Duration timeout) override;
+  absl::Status CollectivePermute(const RendezvousKey& key, size_t num_bytes,
+                                 std::optional<int> source_rank,
+                                 absl::Span<int const> target_ranks,
+                                 const void* input_buffer, void* output_buffer,
+                                 absl::Duration timeout) override;
+  absl::Status AllToAll(const RendezvousKey& key, size_t chunk_bytes,
+                        absl::Span<const void* const> input_buffers,
+                        absl::Span<void* const> output_buffers,
+                        absl::Duration timeout) override;
+  absl::Status AllGather(const RendezvousKey& key, size_t chunk_bytes,
+                         const void* input_buffer, void* output_buffer,
+                         absl::Duration timeout) override;
+  absl::Status ReduceScatter(const RendezvousKey& key,
+                             ReductionKind reduction_kind,
+                             PrimitiveType element_type, size_t chunk_elems,
+                             const void* input_buffer, void* output_buffer,
+                             absl::Duration timeout) override;
+
+  // Waits until all ranks have reached the same barrier.
+  absl::Status Barrier(absl::Time deadline);
+
+ private:
+  // Starts the next epoch and returns the slot of `rank` used by it.
+  std::byte* NextSlot();
+  std::byte* Slot(int rank) const;
+
+  std::unique_ptr<ShmSegment> segment_;
+  int rank_;
+  int world_size_;
+  size_t slot_bytes_;
+
+  // Collectives on a communicator are called in the same order by all ranks,
+  // so these counters stay in sync without any communication.
+  uint64_t barrier_count_ = 0;
+  uint64_t epoch_ = 0;
+};
+
+// Collectives between processes on the same host that communicate through
+// POSIX shared memory in /dev/shm instead of sockets.
+//
+// Ranks rendezvous through `kv_store`: rank 0 creates the segment for a clique
+// and publishes its name, and the other ranks map it. The segment is unlinked
+// once all ranks have mapped it, so it does not outlive the processes. Cliques
+// that span several hosts are delegated to `fallback`, or fail if there is no
+// fallback.
+class ShmCollectives : public CollectivesInterface {
+ public:
+  explicit ShmCollectives(std::shared_ptr<KeyValueStoreInterface> kv_store,
+                          std::shared_ptr<CollectivesInterface> fallback =
+                              nullptr,
+                          ShmCollectivesOptions options = {});
+  ~ShmCollectives() override;
+
+  // Thread-safe.
+  absl::StatusOr<std::shared_ptr<CollectivesCommunicator>> GetCommunicator(
+      absl::Span<GlobalDeviceId const> devices, int rank) override;
+
+ private:
+  absl::StatusOr<std::shared_ptr<CollectivesCommunicator>> CreateCommunicator(
+      absl::Span<GlobalDeviceId const> devices, int rank);
+
+  std::shared_ptr<KeyValueStoreInterface> kv_store_;
+  std::shared_ptr<CollectivesInterface> fallback_;
+  ShmCollectivesOptions options_;
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<std::tuple<std::vector<GlobalDeviceId>, int>,
+                      std::shared_ptr<CollectivesCommunicator>>
+      contexts_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_PJRT_CPU_SHM_COLLECTIVES_H_
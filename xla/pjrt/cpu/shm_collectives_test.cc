@@ -0,0 +1,294 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/shm_collectives.h"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
+#include "xla/executable_run_options.h"
+#include "xla/pjrt/distributed/in_memory_key_value_store.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/service/cpu/collectives_interface.h"
+#include "xla/service/global_device_id.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+using ::testing::Each;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+
+constexpr int kNumParticipants = 4;
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+// The smallest slot size, so that the tests below cover collectives that are
+// split into several pieces.
+constexpr size_t kSlotBytes = 4096;
+
+RendezvousKey MakeRendezvousKey(std::vector<GlobalDeviceId> global_devices) {
+  return RendezvousKey(RunId(0), global_devices, kNumParticipants,
+                       RendezvousKey::CollectiveOpKind::kCrossModule,
+                       /*op_id=*/0);
+}
+
+// Creates a communicator per rank, each from its own ShmCollectives as if the
+// ranks ran in separate processes, and runs `fn` on all ranks concurrently.
+absl::Status RunOnAllRanks(
+    std::function<absl::Status(const RendezvousKey&, CollectivesCommunicator&,
+                               int)>
+        fn) {
+  std::vector<GlobalDeviceId> global_devices;
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    global_devices.push_back(GlobalDeviceId(rank));
+  }
+  RendezvousKey key = MakeRendezvousKey(global_devices);
+  auto kv_store = std::make_shared<InMemoryKeyValueStore>();
+
+  ShmCollectivesOptions options;
+  options.slot_bytes = kSlotBytes;
+
+  std::vector<absl::Status> statuses(kNumParticipants);
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "participants",
+                                        kNumParticipants);
+    for (int rank = 0; rank < kNumParticipants; ++rank) {
+      thread_pool.Schedule([&, rank] {
+        ShmCollectives collectives(kv_store, /*fallback=*/nullptr, options);
+        auto communicator = collectives.GetCommunicator(global_devices, rank);
+        statuses[rank] = communicator.ok()
+                             ? fn(key, **communicator, rank)
+                             : communicator.status();
+      });
+    }
+  }
+  for (const absl::Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+TEST(ShmCollectivesTest, AllReduce) {
+  constexpr size_t kNumElements = 3000;  // Larger than a slot.
+  std::vector<std::vector<float>> outputs(kNumParticipants,
+                                          std::vector<float>(kNumElements));
+  TF_ASSERT_OK(RunOnAllRanks([&](const RendezvousKey& key,
+                                 CollectivesCommunicator& communicator,
+                                 int rank) {
+    std::vector<float> input(kNumElements, rank + 1);
+    return communicator.AllReduce(key, ReductionKind::SUM, F32, kNumElements,
+                                  input.data(), outputs[rank].data(),
+                                  kTimeout);
+  }));
+  for (const std::vector<float>& output : outputs) {
+    EXPECT_THAT(output,
+                Each(Eq(kNumParticipants * (kNumParticipants + 1) / 2)));
+  }
+}
+
+TEST(ShmCollectivesTest, AllReduceMax) {
+  constexpr size_t kNumElements = 100;
+  std::vector<std::vector<int32_t>> outputs(
+      kNumParticipants, std::vector<int32_t>(kNumElements));
+  TF_ASSERT_OK(RunOnAllRanks([&](const RendezvousKey& key,
+                                 CollectivesCommunicator& communicator,
+                                 int rank) {
+    std::vector<int32_t> input(kNumElements, rank);
+    return communicator.AllReduce(key, ReductionKind::MAX, S32, kNumElements,
+                                  input.data(), outputs[rank].data(),
+                                  kTimeout);
+  }));
+  for (const std::vector<int32_t>& output : outputs) {
+    EXPECT_THAT(output, Each(Eq(kNumParticipants - 1)));
+  }
+}
+
+TEST(ShmCollectivesTest, AllReduceMinOfComplexFails) {
+  absl::Status status = RunOnAllRanks(
+      [&](const RendezvousKey& key, CollectivesCommunicator& communicator,
+          int rank) {
+        std::vector<std::complex<float>> buffer(8);
+        return communicator.AllReduce(key, ReductionKind::MIN, C64,
+                                      buffer.size(), buffer.data(),
+                                      buffer.data(), kTimeout);
+      });
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+}
+
+TEST(ShmCollectivesTest, ReduceScatter) {
+  constexpr size_t kChunkElems = 2000;
+  std::vector<std::vector<int32_t>> outputs(
+      kNumParticipants, std::vector<int32_t>(kChunkElems));
+  TF_ASSERT_OK(RunOnAllRanks([&](const RendezvousKey& key,
+                                 CollectivesCommunicator& communicator,
+                                 int rank) {
+    // Element `j` of chunk `i` is `i * (rank + 1)`.
+    std::vector<int32_t> input(kChunkElems * kNumParticipants);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input[i] = (i / kChunkElems) * (rank + 1);
+    }
+    return communicator.ReduceScatter(key, ReductionKind::SUM, S32,
+                                      kChunkElems, input.data(),
+                                      outputs[rank].data(), kTimeout);
+  }));
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    EXPECT_THAT(outputs[rank], Each(Eq(rank * kNumParticipants *
+                                       (kNumParticipants + 1) / 2)));
+  }
+}
+
+TEST(ShmCollectivesTest, AllGather) {
+  constexpr size_t kChunkBytes = 5000;
+  std::vector<std::vector<uint8_t>> outputs(
+      kNumParticipants, std::vector<uint8_t>(kChunkBytes * kNumParticipants));
+  TF_ASSERT_OK(RunOnAllRanks([&](const RendezvousKey& key,
+                                 CollectivesCommunicator& communicator,
+                                 int rank) {
+    std::vector<uint8_t> input(kChunkBytes, rank);
+    return communicator.AllGather(key, kChunkBytes, input.data(),
+                                  outputs[rank].data(), kTimeout);
+  }));
+  std::vector<uint8_t> expected;
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    expected.insert(expected.end(), kChunkBytes, rank);
+  }
+  for (const std::vector<uint8_t>& output : outputs) {
+    EXPECT_THAT(output, ElementsAreArray(expected));
+  }
+}
+
+TEST(ShmCollectivesTest, AllToAll) {
+  constexpr size_t kChunkBytes = 3000;
+  // outputs[i][j] is the chunk received by rank `i` from rank `j`.
+  std::vector<std::vector<std::vector<uint8_t>>> outputs(
+      kNumParticipants,
+      std::vector<std::vector<uint8_t>>(kNumParticipants,
+                                        std::vector<uint8_t>(kChunkBytes)));
+  TF_ASSERT_OK(RunOnAllRanks([&](const RendezvousKey& key,
+                                 CollectivesCommunicator& communicator,
+                                 int rank) {
+    std::vector<std::vector<uint8_t>> inputs;
+    std::vector<const void*> input_ptrs;
+    std::vector<void*> output_ptrs;
+    for (int i = 0; i < kNumParticipants; ++i) {
+      inputs.emplace_back(kChunkBytes, rank * kNumParticipants + i);
+    }
+    for (int i = 0; i < kNumParticipants; ++i) {
+      input_ptrs.push_back(inputs[i].data());
+      output_ptrs.push_back(outputs[rank][i].data());
+    }
+    return communicator.AllToAll(key, kChunkBytes, input_ptrs, output_ptrs,
+                                 kTimeout);
+  }));
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    for (int i = 0; i < kNumParticipants; ++i) {
+      EXPECT_THAT(outputs[rank][i], Each(Eq(i * kNumParticipants + rank)));
+    }
+  }
+}
+
+TEST(ShmCollectivesTest, CollectivePermute) {
+  constexpr size_t kNumBytes = 6000;
+  std::vector<std::vector<uint8_t>> outputs(kNumParticipants,
+                                            std::vector<uint8_t>(kNumBytes));
+  // Rank `i` sends to rank `i + 1`, except for the last rank.
+  TF_ASSERT_OK(RunOnAllRanks([&](const RendezvousKey& key,
+                                 CollectivesCommunicator& communicator,
+                                 int rank) {
+    std::vector<uint8_t> input(kNumBytes, rank + 1);
+    std::optional<int> source_rank;
+    if (rank > 0) source_rank = rank - 1;
+    std::vector<int> target_ranks;
+    if (rank + 1 < kNumParticipants) target_ranks.push_back(rank + 1);
+    return communicator.CollectivePermute(key, kNumBytes, source_rank,
+                                          target_ranks, input.data(),
+                                          outputs[rank].data(), kTimeout);
+  }));
+  EXPECT_THAT(outputs[0], Each(Eq(0)));
+  for (int rank = 1; rank < kNumParticipants; ++rank) {
+    EXPECT_THAT(outputs[rank], Each(Eq(rank)));
+  }
+}
+
+// Benchmarks an f32 all-reduce of `state.range(0)` bytes across
+// kNumParticipants threads.
+void BM_AllReduce(::testing::benchmark::State& state) {
+  size_t num_elements = state.range(0) / sizeof(float);
+  std::vector<GlobalDeviceId> global_devices;
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    global_devices.push_back(GlobalDeviceId(rank));
+  }
+  RendezvousKey key = MakeRendezvousKey(global_devices);
+  auto kv_store = std::make_shared<InMemoryKeyValueStore>();
+
+  std::vector<std::unique_ptr<ShmCollectives>> collectives;
+  std::vector<std::shared_ptr<CollectivesCommunicator>> communicators(
+      kNumParticipants);
+  std::vector<std::vector<float>> inputs(
+      kNumParticipants, std::vector<float>(num_elements, 1.0f));
+  std::vector<std::vector<float>> outputs(kNumParticipants,
+                                          std::vector<float>(num_elements));
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    collectives.push_back(std::make_unique<ShmCollectives>(kv_store));
+  }
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "BM_AllReduce",
+                                      kNumParticipants);
+
+  auto run_on_all_ranks = [&](auto fn) {
+    absl::BlockingCounter counter(kNumParticipants);
+    for (int rank = 0; rank < kNumParticipants; ++rank) {
+      thread_pool.Schedule([&, rank] {
+        fn(rank);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  };
+
+  run_on_all_ranks([&](int rank) {
+    communicators[rank] =
+        collectives[rank]->GetCommunicator(global_devices, rank).value();
+  });
+
+  for (auto s : state) {
+    run_on_all_ranks([&](int rank) {
+      CHECK_OK(communicators[rank]->AllReduce(
+          key, ReductionKind::SUM, F32, num_elements, inputs[rank].data(),
+          outputs[rank].data(), kTimeout));
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AllReduce)->RangeMultiplier(16)->Range(4 << 10, 256 << 20);
+
+}  // namespace
+}  // namespace xla::cpu
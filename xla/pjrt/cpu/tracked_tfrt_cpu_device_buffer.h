@@ -32,13 +32,15 @@ limitations under the License.
 #include "xla/tsl/concurrency/async_value_ref.h"
 #include "xla/util.h"
 #include "tsl/platform/mem.h"
+#include "tsl/platform/numa.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla {
 
 class MaybeOwningCpuMemory {
  public:
-  using OwnedDataPtr = std::unique_ptr<uint8_t[], void (*)(void*)>;
+  using OwnedDataPtr =
+      std::unique_ptr<uint8_t[], absl::AnyInvocable<void(void*)>>;
 
   MaybeOwningCpuMemory() = default;
 
@@ -55,16 +57,28 @@ class MaybeOwningCpuMemory {
   MaybeOwningCpuMemory(const MaybeOwningCpuMemory&) = delete;
   MaybeOwningCpuMemory& operator=(const MaybeOwningCpuMemory&) = delete;
 
+  // Allocations smaller than this size are never placed on a NUMA node, as
+  // NUMA allocations are page-granular and significantly slower.
+  static constexpr size_t kMinNumaAllocationSize = 64 * 1024;
+
   // Allocates owning memory wrapped in an available `AsyncValueRef`.
   static absl::StatusOr<tsl::AsyncValueRef<MaybeOwningCpuMemory>>
-  AllocateAvailableAvr(size_t size) {
-    TF_ASSIGN_OR_RETURN(auto memory, Allocate(size));
+  AllocateAvailableAvr(size_t size,
+                       int numa_node = tsl::port::kNUMANoAffinity) {
+    TF_ASSIGN_OR_RETURN(auto memory, Allocate(size, numa_node));
     return tsl::MakeAvailableAsyncValueRef<MaybeOwningCpuMemory>(
         std::move(memory));
   }
 
   // Allocates raw owning memory. The typical usage is for delayed allocation.
-  static absl::StatusOr<MaybeOwningCpuMemory> Allocate(size_t size) {
+  // If `numa_node` is not `tsl::port::kNUMANoAffinity`, large allocations are
+  // placed on the given NUMA node.
+  static absl::StatusOr<MaybeOwningCpuMemory> Allocate(
+      size_t size, int numa_node = tsl::port::kNUMANoAffinity) {
+    if (numa_node != tsl::port::kNUMANoAffinity &&
+        size >= kMinNumaAllocationSize && tsl::port::NUMAEnabled()) {
+      return AllocateOnNumaNode(size, numa_node);
+    }
     uint8_t* data = static_cast<uint8_t*>(
         tsl::port::AlignedMalloc(size, cpu_function_runtime::MinAlign()));
     if (!data) {
@@ -79,6 +93,21 @@ class MaybeOwningCpuMemory {
   bool owns_data() const { return data_ != nullptr; }
 
  private:
+  static absl::StatusOr<MaybeOwningCpuMemory> AllocateOnNumaNode(
+      size_t size, int numa_node) {
+    uint8_t* data = static_cast<uint8_t*>(tsl::port::NUMAMalloc(
+        numa_node, size, cpu_function_runtime::MinAlign()));
+    if (!data) {
+      return ResourceExhausted(
+          "Out of memory allocating %d bytes on NUMA node %d.", size,
+          numa_node);
+    }
+    return MaybeOwningCpuMemory(
+        OwnedDataPtr{data,
+                     [size](void* ptr) { tsl::port::NUMAFree(ptr, size); }},
+        size);
+  }
+
   void* buf_ = nullptr;                  // Non-owning data pointer.
   OwnedDataPtr data_ = {nullptr, free};  // Owning data pointer;
   size_t size_ = 0;                      // Size in number of bytes.
@@ -15,10 +15,15 @@ limitations under the License.
 
 #include "xla/pjrt/event_pool.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <thread>  // NOLINT
 #include <utility>
 
+#include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "xla/pjrt/metrics.h"
 #include "xla/status_macros.h"
 #include "tsl/platform/statusor.h"
 
@@ -26,32 +31,68 @@ namespace xla {
 
 EventPool::Handle::~Handle() {
   if (pool_ && event_) {
-    absl::MutexLock lock(&pool_->mu_free_events_);
-    pool_->free_events_.push(std::move(event_));
+    Shard& shard = pool_->shards_[shard_];
+    absl::MutexLock lock(&shard.mu);
+    shard.free_events.push_back(std::move(event_));
   }
 }
 
 EventPool::EventPool(bool allow_reuse)
     : allow_reuse_(allow_reuse), next_sequence_number_(1) {}
 
+absl::Status EventPool::Preallocate(se::StreamExecutor* executor,
+                                    int num_events) {
+  if (!allow_reuse_) {
+    return absl::OkStatus();
+  }
+  for (int i = 0; i < num_events; ++i) {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<se::Event> event,
+                        executor->CreateEvent());
+    metrics::RecordEventPoolAllocation(/*reused=*/false);
+    Shard& shard = shards_[i % kNumShards];
+    absl::MutexLock lock(&shard.mu);
+    shard.free_events.push_back(std::move(event));
+  }
+  return absl::OkStatus();
+}
+
+std::unique_ptr<se::Event> EventPool::TakeFreeEvent(size_t shard) {
+  for (size_t i = 0; i < kNumShards; ++i) {
+    Shard& s = shards_[(shard + i) % kNumShards];
+    absl::MutexLock lock(&s.mu);
+    if (!s.free_events.empty()) {
+      std::unique_ptr<se::Event> event = std::move(s.free_events.back());
+      s.free_events.pop_back();
+      return event;
+    }
+  }
+  return nullptr;
+}
+
 absl::StatusOr<EventPool::Handle> EventPool::AllocateEvent(
-    se::StreamExecutor* executor) {
+    se::StreamExecutor* executor, size_t shard) {
   Handle event;
 
   if (allow_reuse_) {
     event.pool_ = this;
-    absl::MutexLock lock(&mu_free_events_);
-    if (!free_events_.empty()) {
-      event.event_ = std::move(free_events_.top());
-      free_events_.pop();
-    }
+    event.shard_ = shard;
+    event.event_ = TakeFreeEvent(shard);
   }
+  metrics::RecordEventPoolAllocation(/*reused=*/event.event_ != nullptr);
   if (!event.event_) {
     TF_ASSIGN_OR_RETURN(event.event_, executor->CreateEvent());
   }
   return event;
 }
 
+absl::StatusOr<EventPool::Handle> EventPool::AllocateEvent(
+    se::StreamExecutor* executor) {
+  // Without a stream to go by, spread callers over the free lists by thread.
+  return AllocateEvent(
+      executor, std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                    kNumShards);
+}
+
 void EventPool::ThenRecordEvent(se::Stream* stream, EventPool::Handle& handle) {
   absl::MutexLock lock(&mu_sequence_number_);
   stream->RecordEvent(handle.event_.get()).IgnoreError();
@@ -60,8 +101,10 @@ void EventPool::ThenRecordEvent(se::Stream* stream, EventPool::Handle& handle) {
 
 absl::StatusOr<EventPool::Handle> EventPool::ThenAllocateAndRecordEvent(
     se::Stream* stream) {
-  TF_ASSIGN_OR_RETURN(EventPool::Handle handle,
-                      AllocateEvent(stream->parent()));
+  TF_ASSIGN_OR_RETURN(
+      EventPool::Handle handle,
+      AllocateEvent(stream->parent(),
+                    std::hash<se::Stream*>()(stream) % kNumShards));
   ThenRecordEvent(stream, handle);
   return handle;
 }
@@ -16,9 +16,14 @@ limitations under the License.
 #ifndef XLA_PJRT_EVENT_POOL_H_
 #define XLA_PJRT_EVENT_POOL_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <stack>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/stream_executor/stream_executor.h"
@@ -57,6 +62,8 @@ class EventPool {
     friend class EventPool;
 
     EventPool* pool_ = nullptr;
+    // Free list that `event_` is returned to when the handle is destroyed.
+    size_t shard_ = 0;
     std::unique_ptr<se::Event> event_;
     uint64_t sequence_number_;
   };
@@ -66,6 +73,11 @@ class EventPool {
   // subsequent allocations. Reuse only works on the GPU platform.
   explicit EventPool(bool allow_reuse);
 
+  // Creates `num_events` events on `executor` and adds them to the free lists,
+  // so that the first allocations do not have to call into the driver. Does
+  // nothing if reuse is disabled.
+  absl::Status Preallocate(se::StreamExecutor* executor, int num_events);
+
   // Allocates a new (or reused) event from the pool, and records the event on
   // `stream`.
   //
@@ -84,11 +96,27 @@ class EventPool {
   void ThenRecordEvent(se::Stream* stream, EventPool::Handle& handle);
 
  private:
+  // Free events are kept in several independently locked lists so that
+  // streams (and threads) allocating concurrently rarely contend. Events
+  // allocated for a stream are taken from, and returned to, the list that the
+  // stream maps to.
+  static constexpr size_t kNumShards = 8;
+
+  struct Shard {
+    absl::Mutex mu;
+    std::vector<std::unique_ptr<se::Event>> free_events ABSL_GUARDED_BY(mu);
+  };
+
+  absl::StatusOr<Handle> AllocateEvent(se::StreamExecutor* executor,
+                                       size_t shard);
+
+  // Pops a free event, preferring `shard`. Returns nullptr if all lists are
+  // empty.
+  std::unique_ptr<se::Event> TakeFreeEvent(size_t shard);
+
   const bool allow_reuse_;
 
-  absl::Mutex mu_free_events_;
-  std::stack<std::unique_ptr<se::Event>> free_events_
-      ABSL_GUARDED_BY(mu_free_events_);
+  std::array<Shard, kNumShards> shards_;
 
   absl::Mutex mu_sequence_number_;
   uint64_t next_sequence_number_ ABSL_GUARDED_BY(mu_sequence_number_);
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/pjrt/gpu/gpu_helpers.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -166,9 +167,10 @@ absl::StatusOr<std::unique_ptr<tsl::BFCAllocator>> CreateCollectiveBFCAllocator(
 // Returns a GPU pinned host memory allocator to use when staging host->GPU
 // transfers. We use a fixed 64GB pool of pinned memory.
 std::unique_ptr<tsl::BFCAllocator> GetGpuHostAllocator(
-    se::StreamExecutor* executor) {
+    se::StreamExecutor* executor, size_t preallocate_size) {
+  int numa_node = executor->GetDeviceDescription().numa_node();
   std::unique_ptr<tsl::SubAllocator> sub_allocator(
-      new se::DeviceHostAllocator(executor, /*numa_node=*/0,
+      new se::DeviceHostAllocator(executor, numa_node,
                                   /*alloc_visitors=*/{},
                                   /*free_visitors=*/{}));
 
@@ -186,9 +188,24 @@ std::unique_ptr<tsl::BFCAllocator> GetGpuHostAllocator(
 
   tsl::BFCAllocator::Options opts;
   opts.allow_growth = true;
-  return std::make_unique<tsl::BFCAllocator>(std::move(sub_allocator),
-                                             kGpuHostMemoryLimitBytes,
-                                             /*name=*/"xla_gpu_host_bfc", opts);
+  auto allocator = std::make_unique<tsl::BFCAllocator>(
+      std::move(sub_allocator), kGpuHostMemoryLimitBytes,
+      /*name=*/"xla_gpu_host_bfc", opts);
+
+  // The BFC allocator keeps the region backing the first allocation, so
+  // allocating and freeing pins the requested amount of memory for later use.
+  if (preallocate_size > 0) {
+    void* ptr = allocator->AllocateRaw(tsl::Allocator::kAllocatorAlignment,
+                                       preallocate_size);
+    if (ptr == nullptr) {
+      LOG(WARNING) << "Failed to preallocate " << preallocate_size
+                   << " bytes of pinned host memory on NUMA node "
+                   << numa_node;
+    } else {
+      allocator->DeallocateRaw(ptr);
+    }
+  }
+  return allocator;
 }
 
 }  // namespace xla
@@ -68,16 +68,30 @@ struct GpuAllocatorConfig {
   // allocator will allocate more memory as allocations are requested.
   bool preallocate = true;
 
+  // Only used if kind == kBFC. If true, the BFC allocator is backed by a single
+  // reservation of virtual addresses that is mapped to physical memory as the
+  // arena grows (CUDA only). Adjacent regions can then be coalesced, which
+  // avoids fragmentation across regions when preallocate is false.
+  bool use_virtual_memory = false;
+
   // Amount of collective memory (ncclMemAlloc) to preallocate. If this value is
   // 0, collective memory space will be grown as needed to fit the application's
   // usage, with the drawback of potentially higher fragmentation. If set,
   // should be set to a multiple of 512MB to avoid wasting memory due to
   // granularity requirements.
   size_t collective_memory_size = 0;
+
+  // Amount of pinned host memory to allocate up front for the pinned host
+  // memory space of each NUMA node, so that offloading to host memory does not
+  // pay for pinning on first use. The pool still grows on demand.
+  size_t pinned_host_memory_preallocate_size = 0;
 };
 
+// Returns a BFC allocator of pinned host memory, allocated by `executor` and
+// accessible from all devices. If `preallocate_size` is non-zero, that much
+// memory is pinned before returning.
 std::unique_ptr<tsl::BFCAllocator> GetGpuHostAllocator(
-    se::StreamExecutor* executor);
+    se::StreamExecutor* executor, size_t preallocate_size = 0);
 
 // Builds a BFCAllocator for all local GPUs.
 absl::StatusOr<std::unique_ptr<tsl::BFCAllocator>> CreateBFCAllocator(
@@ -0,0 +1,115 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/pjrt/gpu/online_pgle.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xla/client/executable_build_options.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_async_compiler.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/pjrt_stream_executor_client.h"
+#include "xla/service/gpu/gpu_executable.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/profiler/protobuf/profiled_instructions.pb.h"
+
+namespace xla {
+namespace {
+
+absl::StatusOr<gpu::GpuExecutable*> GetGpuExecutable(
+    PjRtLoadedExecutable* executable) {
+  auto* se_executable =
+      dynamic_cast<PjRtStreamExecutorLoadedExecutable*>(executable);
+  if (se_executable == nullptr || se_executable->executables().empty()) {
+    return absl::InvalidArgumentError(
+        "Online PGLE requires a stream executor GPU client");
+  }
+  // All partitions run the same schedule, so the profile of the first one is
+  // used for the recompilation.
+  auto* gpu_executable = dynamic_cast<gpu::GpuExecutable*>(
+      se_executable->executables().front()->executable());
+  if (gpu_executable == nullptr) {
+    return absl::InvalidArgumentError(
+        "Online PGLE requires a stream executor GPU client");
+  }
+  return gpu_executable;
+}
+
+}  // namespace
+
+absl::StatusOr<std::shared_ptr<PjRtSwappableExecutable>> CompileWithOnlinePgle(
+    PjRtClient* client, PjRtAsyncCompiler* compiler, XlaComputation computation,
+    CompileOptions options) {
+  const ExecutableBuildOptions& build_options =
+      options.executable_build_options;
+  if (!build_options.has_debug_options() ||
+      build_options.debug_options().xla_gpu_online_pgle_profiled_executions() <=
+          0) {
+    return absl::InvalidArgumentError(
+        "xla_gpu_online_pgle_profiled_executions must be positive for online "
+        "PGLE");
+  }
+  // Every process profiles and recompiles on its own. Processes could end up
+  // with different schedules, or swap in their recompiled executables at
+  // different steps, and either would deadlock collectives between them.
+  if (client->addressable_device_count() != client->device_count()) {
+    return absl::UnimplementedError(
+        "Online PGLE is not supported with multiple processes");
+  }
+
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> profiling,
+                      client->Compile(computation, options));
+  TF_ASSIGN_OR_RETURN(gpu::GpuExecutable * gpu_executable,
+                      GetGpuExecutable(profiling.get()));
+
+  auto executable =
+      std::make_shared<PjRtSwappableExecutable>(std::move(profiling));
+
+  // The callback is owned by the profiling executable, which is owned by the
+  // swappable executable, so it must not keep the latter alive.
+  std::weak_ptr<PjRtSwappableExecutable> weak_executable = executable;
+  gpu_executable->SetOnlinePgleCallback(
+      [weak_executable, compiler, computation = std::move(computation),
+       options = std::move(options)](
+          tensorflow::profiler::ProfiledInstructionsProto profile) mutable {
+        if (weak_executable.expired()) return;
+
+        options.executable_build_options.set_fdo_profile(
+            profile.SerializeAsString());
+        options.executable_build_options.mutable_debug_options()
+            ->set_xla_gpu_online_pgle_profiled_executions(0);
+
+        compiler
+            ->Compile(std::move(computation), std::move(options),
+                      PjRtCompilePriority::kLow)
+            .OnReady([weak_executable](
+                         absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
+                             optimized) {
+              if (auto executable = weak_executable.lock()) {
+                executable->SetOptimized(std::move(optimized));
+              }
+            });
+      });
+  return executable;
+}
+
+}  // namespace xla
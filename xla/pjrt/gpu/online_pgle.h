@@ -0,0 +1,49 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#ifndef XLA_PJRT_GPU_ONLINE_PGLE_H_
+#define XLA_PJRT_GPU_ONLINE_PGLE_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_async_compiler.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+
+namespace xla {
+
+// Compiles `computation` on a GPU client with online profile guided latency
+// estimation (PGLE). The returned executable times every thunk of its first
+// `xla_gpu_online_pgle_profiled_executions` executions (which must be set in
+// the debug options of `options`). The collected per-op device times are then
+// used as the PGLE profile to recompile the computation on `compiler`, and the
+// recompiled executable is swapped in when it is ready. This replaces the
+// manual workflow of profiling a job and recompiling it with
+// `xla_gpu_pgle_profile_file_or_directory_path`.
+//
+// Only single-process clients are supported, as the profile is neither shared
+// between processes nor is the swap synchronized with them.
+//
+// `compiler` must outlive the returned executable.
+absl::StatusOr<std::shared_ptr<PjRtSwappableExecutable>> CompileWithOnlinePgle(
+    PjRtClient* client, PjRtAsyncCompiler* compiler, XlaComputation computation,
+    CompileOptions options);
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_GPU_ONLINE_PGLE_H_
@@ -0,0 +1,130 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/pjrt/gpu/online_pgle.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xla/client/xla_computation.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/pjrt/gpu/se_gpu_pjrt_client.h"
+#include "xla/pjrt/pjrt_async_compiler.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/service/hlo_parser.h"
+#include "xla/test.h"
+#include "xla/tests/literal_test_util.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+constexpr char kProgram[] = R"(
+  HloModule add
+  ENTRY add {
+    x = f32[2] parameter(0)
+    y = f32[2] parameter(1)
+    ROOT add = f32[2] add(x, y)
+  })";
+
+absl::StatusOr<XlaComputation> ParseComputation() {
+  TF_ASSIGN_OR_RETURN(auto hlo_module,
+                      ParseAndReturnUnverifiedModule(kProgram, {}));
+  return XlaComputation(hlo_module->ToProto());
+}
+
+TEST(OnlinePgleTest, RecompilesAfterProfiledExecutions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetStreamExecutorGpuClient(GpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+  PjRtAsyncCompiler compiler(client.get(), /*num_threads=*/1);
+
+  constexpr int kProfiledExecutions = 2;
+  CompileOptions options;
+  options.executable_build_options.mutable_debug_options()
+      ->set_xla_gpu_online_pgle_profiled_executions(kProfiledExecutions);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto executable, CompileWithOnlinePgle(client.get(), &compiler,
+                                             computation, std::move(options)));
+
+  PjRtDevice* device = client->addressable_devices()[0];
+  Literal x = LiteralUtil::CreateR1<float>({1, 2});
+  Literal y = LiteralUtil::CreateR1<float>({3, 4});
+  TF_ASSERT_OK_AND_ASSIGN(auto x_buffer,
+                          client->BufferFromHostLiteral(x, device));
+  TF_ASSERT_OK_AND_ASSIGN(auto y_buffer,
+                          client->BufferFromHostLiteral(y, device));
+
+  auto execute = [&]() -> absl::StatusOr<Literal> {
+    TF_ASSIGN_OR_RETURN(
+        auto results,
+        executable->Get()->Execute({{x_buffer.get(), y_buffer.get()}},
+                                   ExecuteOptions()));
+    TF_ASSIGN_OR_RETURN(auto literal, results[0][0]->ToLiteralSync());
+    return std::move(*literal);
+  };
+
+  for (int i = 0; i < kProfiledExecutions; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(Literal result, execute());
+    EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<float>({4, 6}),
+                                       result));
+  }
+
+  TF_ASSERT_OK(executable->GetOptimizedFuture().Await());
+  TF_ASSERT_OK_AND_ASSIGN(Literal result, execute());
+  EXPECT_TRUE(
+      LiteralTestUtil::Equal(LiteralUtil::CreateR1<float>({4, 6}), result));
+}
+
+TEST(OnlinePgleTest, RequiresProfiledExecutions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetStreamExecutorGpuClient(GpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+  PjRtAsyncCompiler compiler(client.get(), /*num_threads=*/1);
+
+  EXPECT_THAT(CompileWithOnlinePgle(client.get(), &compiler, computation,
+                                    CompileOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(OnlinePgleTest, RejectsMultipleProcesses) {
+  GpuClientOptions client_options;
+  client_options.num_nodes = 2;
+  client_options.enable_mock_nccl = true;
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetStreamExecutorGpuClient(client_options));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+  PjRtAsyncCompiler compiler(client.get(), /*num_threads=*/1);
+
+  CompileOptions options;
+  options.executable_build_options.mutable_debug_options()
+      ->set_xla_gpu_online_pgle_profiled_executions(1);
+  EXPECT_THAT(CompileWithOnlinePgle(client.get(), &compiler, computation,
+                                    std::move(options)),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace xla
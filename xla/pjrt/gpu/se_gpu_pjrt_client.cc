@@ -41,12 +41,14 @@ limitations under the License.
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xla/client/local_client.h"
 #include "xla/client/xla_computation.h"
+#include "xla/debug_options_flags.h"
 #include "xla/layout.h"
 #include "xla/layout_util.h"
 #include "xla/literal.h"
@@ -65,9 +67,12 @@ limitations under the License.
 #include "xla/pjrt/pjrt_stream_executor_client.h"
 #include "xla/pjrt/stream_executor_executable.h"
 #include "xla/pjrt/tracked_device_buffer.h"
+#include "xla/pjrt/utils.h"
 #include "xla/service/compiler.h"
 #include "xla/service/computation_placer.h"
 #include "xla/service/global_device_id.h"
+#include "xla/service/gpu/runtime/nccl_api.h"
+#include "xla/service/gpu/runtime/nccl_clique_key.h"
 #include "xla/service/shaped_buffer.h"
 #include "xla/service/transfer_manager.h"
 #include "xla/shape.h"
@@ -80,10 +85,14 @@ limitations under the License.
 #include "xla/stream_executor/stream.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "xla/tsl/framework/allocator.h"
+#include "xla/tsl/framework/bfc_allocator.h"
+#include "xla/tsl/framework/device_id.h"
 #include "tsl/lib/strings/proto_serialization.h"
 #include "tsl/platform/casts.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/fingerprint.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/threadpool.h"
@@ -103,6 +112,7 @@ limitations under the License.
 #include "third_party/gpus/cuda/include/cuda.h"
 #include "third_party/gpus/cuda/include/cuda_runtime_api.h"
 #include "xla/stream_executor/gpu/gpu_cudamallocasync_allocator.h"
+#include "xla/stream_executor/gpu/gpu_virtual_mem_allocator.h"
 #elif TENSORFLOW_USE_ROCM
 #include "rocm/rocm_config.h"
 #endif
@@ -486,7 +496,8 @@ StreamExecutorGpuClient::StreamExecutorGpuClient(
     std::unique_ptr<tsl::Allocator> host_memory_allocator,
     bool should_stage_host_to_device_transfers,
     std::unique_ptr<gpu::GpuExecutableRunOptions> gpu_run_options,
-    std::shared_ptr<KeyValueStoreInterface> kv_store)
+    std::shared_ptr<KeyValueStoreInterface> kv_store,
+    std::string compilation_cache_dir)
     : xla::PjRtStreamExecutorClient(
           platform_name, client, std::move(devices), process_index,
           std::move(allocator), std::move(host_memory_allocator),
@@ -494,7 +505,11 @@ StreamExecutorGpuClient::StreamExecutorGpuClient(
       topology_(xla::StreamExecutorGpuTopologyDescription::Create(
           tsl::Fingerprint64(platform_name), platform_name,
           devices_.back()->device_kind(), devices_)),
-      kv_store_(std::move(kv_store)) {
+      kv_store_(std::move(kv_store)),
+      compilation_cache_dir_(std::move(compilation_cache_dir)),
+      cross_host_transfer_pool_(std::make_unique<tsl::thread::ThreadPool>(
+          tsl::Env::Default(), "gpu_cross_host_transfers",
+          DefaultThreadPoolSize())) {
   for (auto* device : addressable_devices()) {
     // Use the device id to construct a globally unique memory space id. We do
     // not promise that memory space ids and device ids are the same.
@@ -523,6 +538,11 @@ StreamExecutorGpuClient::StreamExecutorGpuClient(
                });
 }
 
+StreamExecutorGpuClient::~StreamExecutorGpuClient() {
+  // Background compilations call Compile(), which is overridden here.
+  ShutdownAsyncCompiler();
+}
+
 absl::string_view StreamExecutorGpuClient::platform_version() const {
 #define STRINGIFY2(X) #X
 #define STRINGIFY(X) STRINGIFY2(X)
@@ -723,14 +743,440 @@ PjRtFuture<> StreamExecutorGpuClient::CopyRawSubBufferToHost(
       });
 }
 
-absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
-StreamExecutorGpuClient::Compile(const XlaComputation& computation,
-                                 CompileOptions options) {
-  options.executable_build_options.set_key_value_store(kv_store_);
-  auto executable = PjRtStreamExecutorClient::Compile(computation, options);
+namespace {
+
+// Every cross-host transfer uses its own two-rank NCCL clique in which the
+// sender and the receiver have fixed ranks.
+constexpr int32_t kCrossHostSendRank = 0;
+constexpr int32_t kCrossHostRecvRank = 1;
+
+// A contiguous byte range of a local device buffer together with the NCCL
+// clique that connects it to the remote end of the transfer.
+struct CrossHostTransfer {
+  se::DeviceMemoryBase memory;
+  gpu::NcclCliqueId clique_id;
+};
+
+// Returns the size of the combined major `dimensions` of `shape`, after
+// checking that they are the untiled major dimensions of its layout, as
+// required by scattered sends and gathered receives.
+absl::StatusOr<int64_t> CombinedMajorDimensionSize(
+    const Shape& shape, absl::Span<const int> dimensions) {
+  if (!shape.IsArray() || !shape.has_layout()) {
+    return InvalidArgument(
+        "Cross-host scatter/gather requires an array with a layout, got %s",
+        shape.ToString(/*print_layout=*/true));
+  }
+  if (!shape.layout().tiles().empty()) {
+    return InvalidArgument(
+        "Cross-host scatter/gather does not support tiled layouts, got %s",
+        shape.ToString(/*print_layout=*/true));
+  }
+  if (dimensions.empty() || dimensions.size() > shape.rank()) {
+    return InvalidArgument(
+        "Cross-host scatter/gather of %s has invalid dimensions [%s]",
+        shape.ToString(), absl::StrJoin(dimensions, ","));
+  }
+  const auto& minor_to_major = shape.layout().minor_to_major();
+  int64_t size = 1;
+  for (int i = 0; i < dimensions.size(); ++i) {
+    int64_t major_dimension = minor_to_major[shape.rank() - 1 - i];
+    if (!absl::c_linear_search(dimensions, major_dimension)) {
+      return InvalidArgument(
+          "Cross-host scatter/gather dimensions [%s] are not the major "
+          "dimensions of %s",
+          absl::StrJoin(dimensions, ","),
+          shape.ToString(/*print_layout=*/true));
+    }
+    size *= shape.dimensions(major_dimension);
+  }
+  return size;
+}
 
+// Splits `memory` into the byte ranges covered by `slices`, which are given as
+// [start, end) indices into the combined major `dimensions` of `shape`.
+absl::StatusOr<std::vector<se::DeviceMemoryBase>> SliceMajorDimensions(
+    const Shape& shape, se::DeviceMemoryBase memory,
+    absl::Span<const int> dimensions,
+    absl::Span<const std::pair<int64_t, int64_t>> slices) {
+  TF_ASSIGN_OR_RETURN(int64_t num_indices,
+                      CombinedMajorDimensionSize(shape, dimensions));
+  int64_t stride = num_indices == 0 ? 0 : memory.size() / num_indices;
+  std::vector<se::DeviceMemoryBase> result;
+  result.reserve(slices.size());
+  for (const auto& [start, end] : slices) {
+    if (start < 0 || start > end || end > num_indices) {
+      return InvalidArgument(
+          "Cross-host scatter/gather slice [%d, %d) is out of bounds for %d "
+          "major indices",
+          start, end, num_indices);
+    }
+    result.push_back(
+        memory.GetByteSlice(start * stride, (end - start) * stride));
+  }
+  return result;
+}
+
+// Joins the two-rank cliques named by `transfers` as `rank`, and enqueues a
+// send (for kCrossHostSendRank) or a receive (for kCrossHostRecvRank) of every
+// transfer on `stream`. All communicators are created and all operations are
+// issued inside single NCCL groups, so a transfer involving several peers can
+// not deadlock on the order in which the peers show up. The returned
+// communicators must be kept alive until the enqueued operations complete.
+absl::StatusOr<std::vector<gpu::NcclApi::OwnedNcclComm>>
+EnqueueCrossHostTransfers(gpu::NcclApi* nccl_api, se::Stream* stream,
+                          int32_t rank,
+                          absl::Span<const CrossHostTransfer> transfers) {
+  tsl::profiler::TraceMe traceme("EnqueueCrossHostTransfers");
+  gpu::NcclApi::DeviceRank device_rank(stream->parent(), rank);
+
+  std::vector<gpu::NcclApi::OwnedNcclComm> comms;
+  comms.reserve(transfers.size());
+  TF_RETURN_IF_ERROR(nccl_api->GroupStart());
+  for (const CrossHostTransfer& transfer : transfers) {
+    absl::StatusOr<std::vector<gpu::NcclApi::OwnedNcclComm>> clique_comms =
+        nccl_api->CommInitRanks(/*nranks=*/2, transfer.clique_id,
+                                {device_rank}, gpu::NcclApi::Config());
+    if (!clique_comms.ok()) {
+      nccl_api->GroupEnd().IgnoreError();
+      return clique_comms.status();
+    }
+    comms.push_back(std::move(clique_comms->front()));
+  }
+  TF_RETURN_IF_ERROR(nccl_api->GroupEnd());
+
+  const int32_t peer = rank == kCrossHostSendRank ? kCrossHostRecvRank
+                                                  : kCrossHostSendRank;
+  TF_RETURN_IF_ERROR(nccl_api->GroupStart());
+  for (int i = 0; i < transfers.size(); ++i) {
+    const se::DeviceMemoryBase& memory = transfers[i].memory;
+    absl::Status status =
+        rank == kCrossHostSendRank
+            ? nccl_api->Send(memory, U8, memory.size(), peer, comms[i].get(),
+                             stream)
+            : nccl_api->Recv(memory, U8, memory.size(), peer, comms[i].get(),
+                             stream);
+    if (!status.ok()) {
+      nccl_api->GroupEnd().IgnoreError();
+      return status;
+    }
+  }
+  TF_RETURN_IF_ERROR(nccl_api->GroupEnd());
+  return comms;
+}
+
+int64_t TotalTransferSize(absl::Span<const CrossHostTransfer> transfers) {
+  int64_t size = 0;
+  for (const CrossHostTransfer& transfer : transfers) {
+    size += transfer.memory.size();
+  }
+  return size;
+}
+
+}  // namespace
+
+absl::Status StreamExecutorGpuClient::EnqueueCrossHostReceive(
+    absl::Span<const std::unique_ptr<PjRtBuffer>> buffers,
+    std::shared_ptr<BufferSequencingEvent> definition_event,
+    PjRtCrossHostRecvNotifier notifier,
+    std::optional<std::vector<GatherDetails>> gather_details) const {
+  gpu::NcclApi* nccl_api = gpu::NcclApi::Default();
+  PjRtStreamExecutorDevice* device =
+      tensorflow::down_cast<PjRtStreamExecutorBuffer*>(buffers[0].get())
+          ->device();
+  LocalDeviceState* local_device = device->local_device_state();
+
+  PjRtCrossHostRecvState state;
+  state.descriptors.resize(buffers.size());
+  std::vector<CrossHostTransfer> transfers;
+  // Keep the destination allocations alive until the receives complete, even
+  // if the caller drops the buffers in the meantime.
+  std::vector<std::shared_ptr<TrackedDeviceBuffer>> device_buffers;
+  device_buffers.reserve(buffers.size());
+
+  // The destination buffers are defined by the receive, so failing to set it
+  // up must poison them rather than leave them undefined forever.
+  auto prepare = [&]() -> absl::Status {
+    for (int i = 0; i < buffers.size(); ++i) {
+      auto* buffer =
+          tensorflow::down_cast<PjRtStreamExecutorBuffer*>(buffers[i].get());
+      PjRtStreamExecutorBuffer::ScopedHold hold(
+          buffer->GetBufferWithUsageHold());
+      TF_RETURN_IF_ERROR(hold.status());
+      if (hold->device_memory().size() != 1) {
+        return InvalidArgument(
+            "Cross-host receives into tuple buffers are not supported");
+      }
+      se::DeviceMemoryBase memory = hold->device_memory()[0];
+
+      std::vector<se::DeviceMemoryBase> slices;
+      if (gather_details.has_value()) {
+        const GatherDetails& details = (*gather_details)[i];
+        std::vector<std::pair<int64_t, int64_t>> ranges;
+        ranges.reserve(details.slice_boundaries.size());
+        int64_t start = 0;
+        for (int64_t end : details.slice_boundaries) {
+          ranges.emplace_back(start, end);
+          start = end;
+        }
+        TF_ASSIGN_OR_RETURN(
+            slices, SliceMajorDimensions(buffer->on_device_shape(), memory,
+                                         details.dimensions, ranges));
+      } else {
+        slices.push_back(memory);
+      }
+
+      for (const se::DeviceMemoryBase& slice : slices) {
+        TF_ASSIGN_OR_RETURN(gpu::NcclCliqueId clique_id,
+                            nccl_api->GetUniqueId());
+        state.descriptors[i].serialized_descriptors.push_back(
+            clique_id.ToString());
+        transfers.push_back({slice, clique_id});
+      }
+      device_buffers.push_back(hold.buffer());
+    }
+    return absl::OkStatus();
+  };
+  if (absl::Status status = prepare(); !status.ok()) {
+    definition_event->SetDefinedStatus(status);
+    return status;
+  }
+
+  state.cancel_notifier = [](absl::string_view serialized_descriptor,
+                             absl::Status reason,
+                             std::function<void(absl::Status)> on_canceled) {
+    on_canceled(Unimplemented(
+        "Canceling cross-host receives is not supported by the GPU client"));
+  };
+  notifier(std::move(state));
+
+  const int64_t transfer_size = TotalTransferSize(transfers);
+  cross_host_transfer_pool_->Schedule(
+      [nccl_api, local_device, transfer_size,
+       transfers = std::move(transfers),
+       device_buffers = std::move(device_buffers),
+       definition_event = std::move(definition_event)]() mutable {
+        se::Stream* stream =
+            local_device->GetDeviceToDeviceStream(transfer_size);
+        auto receive = [&]() -> absl::Status {
+          // The destination memory may still be in use by work on the compute
+          // stream that preceded its allocation.
+          TF_RETURN_IF_ERROR(stream->WaitFor(local_device->compute_stream()));
+          TF_ASSIGN_OR_RETURN(
+              auto comms, EnqueueCrossHostTransfers(
+                              nccl_api, stream, kCrossHostRecvRank, transfers));
+          TF_ASSIGN_OR_RETURN(
+              EventPool::Handle event,
+              local_device->event_pool().ThenAllocateAndRecordEvent(stream));
+          definition_event->SetSequencingEvent(std::move(event), stream);
+          return local_device->ThenExecuteCallback(
+              stream,
+              [local_device, stream, transfer_size,
+               comms = std::make_shared<decltype(comms)>(std::move(comms)),
+               device_buffers = std::move(device_buffers)]() {
+                local_device->ReleaseTransferBytes(stream, transfer_size);
+              });
+        };
+        if (absl::Status status = receive(); !status.ok()) {
+          LOG(ERROR) << "Cross-host receive failed: " << status;
+          local_device->ReleaseTransferBytes(stream, transfer_size);
+          if (!definition_event->IsDefined()) {
+            definition_event->SetDefinedStatus(status);
+          }
+        }
+      });
+  return absl::OkStatus();
+}
+
+void StreamExecutorGpuClient::CopyToRemoteDevice(
+    PjRtBuffer* buffer, absl::string_view serialized_descriptor,
+    PjRtBuffer::RemoteSendCallback on_done) const {
+  std::vector<std::string> serialized_descriptors;
+  serialized_descriptors.emplace_back(serialized_descriptor);
+  std::vector<PjRtBuffer::RemoteSendCallback> callbacks;
+  callbacks.push_back(std::move(on_done));
+  EnqueueCrossHostSends(buffer, std::move(serialized_descriptors),
+                        std::move(callbacks), std::nullopt);
+}
+
+void StreamExecutorGpuClient::CopyToRemoteDeviceScattered(
+    PjRtBuffer* buffer, std::vector<std::string> serialized_descriptors,
+    std::vector<PjRtBuffer::RemoteSendCallback> callbacks,
+    const PjRtBuffer::ScatterDetails& scatter_details) const {
+  EnqueueCrossHostSends(buffer, std::move(serialized_descriptors),
+                        std::move(callbacks), scatter_details);
+}
+
+void StreamExecutorGpuClient::EnqueueCrossHostSends(
+    PjRtBuffer* pjrt_buffer, std::vector<std::string> serialized_descriptors,
+    std::vector<PjRtBuffer::RemoteSendCallback> callbacks,
+    std::optional<PjRtBuffer::ScatterDetails> scatter_details) const {
+  auto done = [callbacks = std::make_shared<decltype(callbacks)>(
+                   std::move(callbacks))](absl::Status status,
+                                          bool sends_were_enqueued) {
+    for (const PjRtBuffer::RemoteSendCallback& callback : *callbacks) {
+      callback(status, sends_were_enqueued);
+    }
+  };
+
+  auto* buffer = tensorflow::down_cast<PjRtStreamExecutorBuffer*>(pjrt_buffer);
+  LocalDeviceState* local_device = buffer->device()->local_device_state();
+
+  // Acquire the usage hold inline so that the buffer is kept alive until the
+  // sends have been enqueued.
+  PjRtStreamExecutorBuffer::ScopedHold hold(buffer->GetBufferWithUsageHold());
+  if (!hold.ok()) {
+    done(hold.status(), /*sends_were_enqueued=*/false);
+    return;
+  }
+  std::shared_ptr<TrackedDeviceBuffer> device_buffer = hold.buffer();
+  if (device_buffer->device_memory().size() != 1) {
+    done(InvalidArgument("Cross-host sends of tuple buffers are not supported"),
+         /*sends_were_enqueued=*/false);
+    return;
+  }
+  se::DeviceMemoryBase memory = device_buffer->device_memory()[0];
+
+  std::vector<se::DeviceMemoryBase> slices;
+  if (scatter_details.has_value()) {
+    absl::StatusOr<std::vector<se::DeviceMemoryBase>> scattered =
+        SliceMajorDimensions(buffer->on_device_shape(), memory,
+                             scatter_details->dimensions,
+                             scatter_details->slices);
+    if (!scattered.ok()) {
+      done(scattered.status(), /*sends_were_enqueued=*/false);
+      return;
+    }
+    slices = *std::move(scattered);
+  } else {
+    slices.push_back(memory);
+  }
+  if (slices.size() != serialized_descriptors.size()) {
+    done(InvalidArgument("Cross-host send has %d slices but %d descriptors",
+                         slices.size(), serialized_descriptors.size()),
+         /*sends_were_enqueued=*/false);
+    return;
+  }
+
+  std::vector<CrossHostTransfer> transfers;
+  transfers.reserve(slices.size());
+  for (int i = 0; i < slices.size(); ++i) {
+    absl::StatusOr<gpu::NcclCliqueId> clique_id =
+        gpu::NcclCliqueId::FromString(serialized_descriptors[i]);
+    if (!clique_id.ok()) {
+      done(clique_id.status(), /*sends_were_enqueued=*/false);
+      return;
+    }
+    transfers.push_back({slices[i], *clique_id});
+  }
+
+  const int64_t transfer_size = TotalTransferSize(transfers);
+  se::Stream* stream = local_device->GetDeviceToDeviceStream(transfer_size);
+  auto usage_event =
+      std::make_shared<BufferSequencingEvent>(cross_host_transfer_pool_.get());
+  hold.ConvertUsageHold(stream, usage_event, /*reference_held=*/true);
+
+  auto send = [nccl_api = gpu::NcclApi::Default(), local_device, stream,
+               transfer_size, transfers = std::move(transfers), device_buffer,
+               usage_event, done]() mutable {
+    auto enqueue = [&]() -> absl::Status {
+      TF_RETURN_IF_ERROR(
+          device_buffer->definition_events()[0]->GetDefinedStatus());
+      WaitForBufferDefinitionEventsOnStream(*device_buffer, stream);
+      TF_ASSIGN_OR_RETURN(
+          auto comms, EnqueueCrossHostTransfers(nccl_api, stream,
+                                                kCrossHostSendRank, transfers));
+      TF_ASSIGN_OR_RETURN(
+          EventPool::Handle event,
+          local_device->event_pool().ThenAllocateAndRecordEvent(stream));
+      usage_event->SetSequencingEvent(std::move(event), stream);
+      return local_device->ThenExecuteCallback(
+          stream,
+          [local_device, stream, transfer_size, done,
+           comms = std::make_shared<decltype(comms)>(std::move(comms)),
+           device_buffer = std::move(device_buffer)]() {
+            local_device->ReleaseTransferBytes(stream, transfer_size);
+            done(absl::OkStatus(), /*sends_were_enqueued=*/true);
+          });
+    };
+    if (absl::Status status = enqueue(); !status.ok()) {
+      local_device->ReleaseTransferBytes(stream, transfer_size);
+      bool sends_were_enqueued = usage_event->IsDefined();
+      if (!sends_were_enqueued) {
+        usage_event->SetDefinedStatus(status);
+      }
+      done(status, sends_were_enqueued);
+    }
+  };
+
+  // Joining the clique blocks until the receiver joins too, so the sends are
+  // set up on the cross-host transfer pool once the source data is defined.
+  tsl::thread::ThreadPool* pool = cross_host_transfer_pool_.get();
+  device_buffer->definition_events()[0]->ExecuteOrAddToFutureTasks(
+      absl::StrFormat("cross_host_send_%p", device_buffer.get()),
+      [pool, send = std::move(send)]() mutable {
+        pool->Schedule(std::move(send));
+      });
+}
+
+namespace {
+
+// Version of the persistent compilation cache entries. Must be incremented
+// when the serialized executable format or the cache key changes.
+constexpr int kCompilationCacheVersion = 2;
+
+// Returns a file name for the executable compiled from `computation` with
+// `options` in the persistent compilation cache.
+absl::StatusOr<std::string> CompilationCacheFileName(
+    const XlaComputation& computation, const CompileOptions& options,
+    absl::string_view device_kind, absl::string_view platform_version) {
+  TF_ASSIGN_OR_RETURN(CompileOptionsProto options_proto, options.ToProto());
+  // Compile options only carry debug options that were set explicitly. The
+  // compiler otherwise uses the ones from XLA_FLAGS, which must be part of the
+  // key too.
+  const ExecutableBuildOptions& build_options =
+      options.executable_build_options;
+  DebugOptions debug_options = build_options.has_debug_options()
+                                   ? build_options.debug_options()
+                                   : GetDebugOptionsFromFlags();
+  std::string serialized_computation;
+  std::string serialized_options;
+  std::string serialized_debug_options;
+  if (!tsl::SerializeToStringDeterministic(computation.proto(),
+                                           &serialized_computation) ||
+      !tsl::SerializeToStringDeterministic(options_proto,
+                                           &serialized_options) ||
+      !tsl::SerializeToStringDeterministic(debug_options,
+                                           &serialized_debug_options)) {
+    return Internal("Failed to serialize the compilation cache key");
+  }
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(absl::StrCat(
+      serialized_computation, "::", serialized_options, "::",
+      serialized_debug_options, "::", device_kind, "::", platform_version,
+      "::", kCompilationCacheVersion));
+  return absl::StrFormat("%016x%016x.pjrt_executable", fingerprint.high64,
+                         fingerprint.low64);
+}
+
+// Writes `serialized` to `path` through a temporary file, so that concurrent
+// readers in other processes never see a partially written entry.
+absl::Status WriteCompilationCacheEntry(const std::string& path,
+                                        const std::string& serialized) {
+  tsl::Env* env = tsl::Env::Default();
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return Internal("Failed to create temporary file name for %s", path);
+  }
+  absl::Status written = tsl::WriteStringToFile(env, tmp_path, serialized);
+  if (written.ok()) written = env->RenameFile(tmp_path, path);
+  if (!written.ok()) env->DeleteFile(tmp_path).IgnoreError();
+  return written;
+}
+
+// Records the free memory of the given GPUs after a compilation.
+void RecordFreeGpuMemory(absl::Span<PjRtDevice* const> devices) {
 #if defined(GOOGLE_CUDA) || defined(TENSORFLOW_USE_ROCM)
-  for (const PjRtDevice* device : addressable_devices()) {
+  for (const PjRtDevice* device : devices) {
     LocalDeviceState* local_device_state =
         tensorflow::down_cast<const PjRtStreamExecutorDevice*>(device)
             ->local_device_state();
@@ -747,6 +1193,71 @@ StreamExecutorGpuClient::Compile(const XlaComputation& computation,
     }
   }
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
+StreamExecutorGpuClient::Compile(const XlaComputation& computation,
+                                 CompileOptions options) {
+  options.executable_build_options.set_key_value_store(kv_store_);
+
+  // Try to load the executable from the persistent compilation cache. The
+  // serialized GPU executable contains the optimized HLO module with the
+  // autotuning results in backend configs and the compiled kernels, so a
+  // cache hit skips both autotuning and code generation.
+  std::string cache_path;
+  if (!compilation_cache_dir_.empty()) {
+    auto file_name = CompilationCacheFileName(
+        computation, options, devices_.back()->device_kind(),
+        platform_version());
+    if (file_name.ok()) {
+      cache_path = tsl::io::JoinPath(compilation_cache_dir_, *file_name);
+    } else {
+      VLOG(1) << "Compilation cache is disabled for " << computation.name()
+              << ": " << file_name.status();
+    }
+  }
+
+  tsl::Env* env = tsl::Env::Default();
+  if (!cache_path.empty() && env->FileExists(cache_path).ok()) {
+    std::string serialized;
+    absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> loaded =
+        tsl::ReadFileToString(env, cache_path, &serialized);
+    if (loaded.status().ok()) {
+      loaded = LoadSerializedExecutable(serialized, options, LoadOptions());
+    }
+    if (loaded.ok()) {
+      VLOG(1) << "Loaded " << computation.name()
+              << " from compilation cache entry " << cache_path;
+      RecordFreeGpuMemory(addressable_devices());
+      return loaded;
+    }
+    LOG(WARNING) << "Failed to load compilation cache entry " << cache_path
+                 << ": " << loaded.status();
+  }
+
+  auto executable = PjRtStreamExecutorClient::Compile(computation, options);
+
+  if (!cache_path.empty() && executable.ok()) {
+    absl::StatusOr<std::string> serialized = SerializeExecutable(**executable);
+    absl::Status stored = serialized.status();
+    if (stored.ok()) {
+      stored = env->RecursivelyCreateDir(compilation_cache_dir_);
+    }
+    if (stored.ok()) {
+      stored = WriteCompilationCacheEntry(cache_path, *serialized);
+    }
+    if (stored.ok()) {
+      VLOG(1) << "Stored " << computation.name()
+              << " to compilation cache entry " << cache_path;
+    } else {
+      LOG(WARNING) << "Failed to store compilation cache entry " << cache_path
+                   << ": " << stored;
+    }
+  }
+
+  RecordFreeGpuMemory(addressable_devices());
   return executable;
 }
 
@@ -853,6 +1364,70 @@ CreateCudaAsyncAllocator(
 
 #endif  // defined(GOOGLE_CUDA) && CUDA_VERSION >= 11020
 
+#if GOOGLE_CUDA
+
+// Builds a BFCAllocator for `device` whose arena is a single range of virtual
+// addresses, mapped to physical memory as the allocator grows.
+absl::StatusOr<std::unique_ptr<tsl::BFCAllocator>>
+CreateVirtualMemoryBFCAllocator(
+    const LocalDeviceState& device,
+    const std::map<int, std::unique_ptr<LocalDeviceState>>& addressable_devices,
+    const GpuAllocatorConfig& allocator_config) {
+  se::StreamExecutor* executor = device.executor();
+  int device_ordinal = executor->device_ordinal();
+
+  int64_t free_memory;
+  int64_t total_memory;
+  if (!executor->DeviceMemoryUsage(&free_memory, &total_memory)) {
+    return Unavailable("Failed to query available memory from device %i",
+                       device_ordinal);
+  }
+  size_t allocator_memory = allocator_config.gpu_system_memory_size.value_or(
+      total_memory * allocator_config.memory_fraction);
+
+  // Peer access is fixed when memory is mapped, so collect every device that
+  // may read this device's buffers up front.
+  std::vector<tsl::PlatformDeviceId> peer_gpu_ids;
+  for (const auto& [ordinal, peer] : addressable_devices) {
+    if (ordinal != device_ordinal &&
+        peer->executor()->CanEnablePeerAccessTo(executor)) {
+      peer_gpu_ids.push_back(tsl::PlatformDeviceId(ordinal));
+    }
+  }
+
+  TF_ASSIGN_OR_RETURN(
+      auto sub_allocator,
+      se::GpuVirtualMemAllocator::Create(
+          /*alloc_visitors=*/{}, /*free_visitors=*/{}, executor,
+          tsl::PlatformDeviceId(device_ordinal), allocator_memory,
+          peer_gpu_ids));
+  LOG(INFO) << "XLA backend will use up to " << allocator_memory
+            << " bytes of virtual memory on device " << device_ordinal
+            << " for BFCAllocator.";
+
+  tsl::BFCAllocator::Options opts;
+  opts.allow_growth = !allocator_config.preallocate;
+  return std::make_unique<tsl::BFCAllocator>(
+      std::move(sub_allocator), allocator_memory,
+      absl::StrCat("GPU_", device_ordinal, "_vmem_bfc"), opts);
+}
+
+#else  // GOOGLE_CUDA
+
+absl::StatusOr<std::unique_ptr<tsl::BFCAllocator>>
+CreateVirtualMemoryBFCAllocator(
+    const LocalDeviceState& device,
+    const std::map<int, std::unique_ptr<LocalDeviceState>>& addressable_devices,
+    const GpuAllocatorConfig& allocator_config) {
+  return FailedPrecondition("Virtual memory BFC allocator requires CUDA");
+}
+
+#endif  // GOOGLE_CUDA
+
+// Number of events created up front for each GPU, so that the event pool
+// does not call into the driver while the first executions are enqueued.
+constexpr int kNumPreallocatedEvents = 64;
+
 // Builds a LocalDeviceState for each GPU present.
 absl::StatusOr<std::map<int, std::unique_ptr<LocalDeviceState>>>
 BuildLocalDeviceStates(LocalClient* xla_client) {
@@ -864,7 +1439,9 @@ BuildLocalDeviceStates(LocalClient* xla_client) {
         std::make_unique<LocalDeviceState>(
             executor, xla_client, LocalDeviceState::kComputeSynchronized,
             /*max_inflight_computations=*/32,
-            /*allow_event_reuse=*/true, /*use_callback_stream=*/true));
+            /*allow_event_reuse=*/true, /*use_callback_stream=*/true,
+            /*device_ordinal=*/-1, /*stream_options=*/std::nullopt,
+            /*num_preallocated_events=*/kNumPreallocatedEvents));
   }
   return std::move(addressable_devices);
 }
@@ -896,6 +1473,20 @@ GetStreamExecutorGpuDeviceAllocator(
     case GpuAllocatorConfig::Kind::kBFC: {
       LOG(INFO) << "Using BFC allocator.";
       for (const auto& ordinal_and_device : addressable_devices) {
+        if (allocator_config.use_virtual_memory) {
+          auto bfc_allocator = CreateVirtualMemoryBFCAllocator(
+              *ordinal_and_device.second, addressable_devices,
+              allocator_config);
+          if (bfc_allocator.ok()) {
+            allocators.emplace_back(
+                std::move(bfc_allocator).value(),
+                ordinal_and_device.second->compute_stream(),
+                /*memory_space=*/0);
+            continue;
+          }
+          LOG(ERROR) << "Failed to initialize virtual memory BFC allocator: "
+                     << bfc_allocator.status() << "; falling back to BFC.";
+        }
         TF_ASSIGN_OR_RETURN(
             auto bfc_allocator,
             CreateBFCAllocator(ordinal_and_device.second->executor(),
@@ -934,10 +1525,18 @@ GetStreamExecutorGpuDeviceAllocator(
                             /*memory_space=*/1);
   }
 
+  // Devices attached to the same NUMA node share one pool of pinned host
+  // memory. Pinned allocations are portable, so every device can DMA to them.
+  absl::flat_hash_map<int, std::shared_ptr<tsl::Allocator>> host_allocators;
   for (const auto& ordinal_and_device : addressable_devices) {
-    auto host_allocator =
-        GetGpuHostAllocator(ordinal_and_device.second->executor());
-    allocators.emplace_back(std::move(host_allocator),
+    se::StreamExecutor* executor = ordinal_and_device.second->executor();
+    std::shared_ptr<tsl::Allocator>& host_allocator =
+        host_allocators[executor->GetDeviceDescription().numa_node()];
+    if (host_allocator == nullptr) {
+      host_allocator = GetGpuHostAllocator(
+          executor, allocator_config.pinned_host_memory_preallocate_size);
+    }
+    allocators.emplace_back(host_allocator,
                             ordinal_and_device.second->compute_stream(),
                             /*memory_space=*/
                             static_cast<int>(se::MemoryType::kHost));
@@ -1095,6 +1694,17 @@ absl::string_view StreamExecutorGpuDevice::device_vendor() const {
 
 absl::StatusOr<tsl::AllocatorStats> StreamExecutorGpuDevice::GetAllocatorStats()
     const {
+  return GetMemorySpaceAllocatorStats(/*memory_space=*/0);
+}
+
+absl::StatusOr<tsl::AllocatorStats>
+StreamExecutorGpuDevice::GetPinnedHostAllocatorStats() const {
+  return GetMemorySpaceAllocatorStats(static_cast<int>(se::MemoryType::kHost));
+}
+
+absl::StatusOr<tsl::AllocatorStats>
+StreamExecutorGpuDevice::GetMemorySpaceAllocatorStats(
+    int64_t memory_space) const {
   if (!IsAddressable()) {
     return FailedPrecondition(
         "GetAllocatorStats() is allowed only for addressable devices");
@@ -1108,8 +1718,9 @@ absl::StatusOr<tsl::AllocatorStats> StreamExecutorGpuDevice::GetAllocatorStats()
         "allocator");
   }
 
-  TF_ASSIGN_OR_RETURN(auto allocator, allocator_adapter->GetAllocator(
-                                          local_device_id().value()));
+  TF_ASSIGN_OR_RETURN(auto allocator,
+                      allocator_adapter->GetAllocator(
+                          local_device_id().value(), memory_space));
 
   auto stats = allocator->GetStats();
   TF_RET_CHECK(stats.has_value());
@@ -1180,7 +1791,7 @@ absl::StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
       pjrt_platform_name, xla_client, std::move(devices), options.node_id,
       std::move(allocator), std::move(host_memory_allocator),
       options.should_stage_host_to_device_transfers, std::move(gpu_run_options),
-      std::move(kv_store)));
+      std::move(kv_store), options.compilation_cache_dir));
 }
 
 absl::StatusOr<std::string> StreamExecutorGpuTopologyDescription::Serialize()
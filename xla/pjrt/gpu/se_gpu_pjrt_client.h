@@ -45,6 +45,7 @@ limitations under the License.
 #include "xla/pjrt/pjrt_executable.h"
 #include "xla/pjrt/pjrt_future.h"
 #include "xla/pjrt/pjrt_stream_executor_client.h"
+#include "xla/pjrt/tracked_device_buffer.h"
 #include "xla/service/computation_placer.h"
 #include "xla/service/gpu/gpu_executable_run_options.h"
 #include "xla/shape.h"
@@ -53,6 +54,7 @@ limitations under the License.
 #include "xla/tsl/framework/allocator.h"
 #include "tsl/platform/casts.h"
 #include "tsl/platform/fingerprint.h"
+#include "tsl/platform/threadpool.h"
 
 namespace stream_executor {
 
@@ -178,6 +180,10 @@ class StreamExecutorGpuDevice : public PjRtStreamExecutorDevice {
 
   absl::StatusOr<tsl::AllocatorStats> GetAllocatorStats() const override;
 
+  // Returns stats of the pool backing the pinned host memory space. The pool is
+  // shared by all devices attached to the same NUMA node.
+  absl::StatusOr<tsl::AllocatorStats> GetPinnedHostAllocatorStats() const;
+
   absl::Span<int const> coords() const;
 
   int core_on_chip() const;
@@ -185,6 +191,9 @@ class StreamExecutorGpuDevice : public PjRtStreamExecutorDevice {
   absl::StatusOr<PjRtMemorySpace*> default_memory_space() const override;
 
  private:
+  absl::StatusOr<tsl::AllocatorStats> GetMemorySpaceAllocatorStats(
+      int64_t memory_space) const;
+
   std::string device_vendor_;
   int slice_index_;
 };
@@ -209,7 +218,9 @@ class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
       std::unique_ptr<tsl::Allocator> host_memory_allocator,
       bool should_stage_host_to_device_transfers,
       std::unique_ptr<gpu::GpuExecutableRunOptions> gpu_run_options,
-      std::shared_ptr<KeyValueStoreInterface> kv_store);
+      std::shared_ptr<KeyValueStoreInterface> kv_store,
+      std::string compilation_cache_dir = "");
+  ~StreamExecutorGpuClient() override;
 
   absl::StatusOr<xla::DeviceAssignment> GetDefaultDeviceAssignment(
       int num_replicas, int num_partitions) const override;
@@ -252,12 +263,53 @@ class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
       absl::string_view serialized, std::optional<CompileOptions> options,
       const LoadOptions& load_options);
 
+  // If the client has a compilation cache directory, loads the executable
+  // from it when it was already compiled by this or another process, and
+  // stores newly compiled executables to it.
   absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> Compile(
       const XlaComputation& computation, CompileOptions options) override;
 
+ protected:
+  // Cross-host transfers are implemented with NCCL point-to-point operations.
+  // The receiver creates a fresh NCCL clique id for every destination buffer
+  // (or gather slice) and hands it out as the serialized descriptor; the sender
+  // joins the two-rank clique named by the descriptor and sends the data
+  // straight from its device buffer into the destination buffer.
+  absl::Status EnqueueCrossHostReceive(
+      absl::Span<const std::unique_ptr<PjRtBuffer>> buffers,
+      std::shared_ptr<BufferSequencingEvent> definition_event,
+      PjRtCrossHostRecvNotifier notifier,
+      std::optional<std::vector<GatherDetails>> gather_details) const override;
+
+  void CopyToRemoteDevice(
+      PjRtBuffer* buffer, absl::string_view serialized_descriptor,
+      PjRtBuffer::RemoteSendCallback on_done) const override;
+
+  void CopyToRemoteDeviceScattered(
+      PjRtBuffer* buffer, std::vector<std::string> serialized_descriptors,
+      std::vector<PjRtBuffer::RemoteSendCallback> callbacks,
+      const PjRtBuffer::ScatterDetails& scatter_details) const override;
+
  private:
+  // Sends `buffer` to the remote devices named by `serialized_descriptors`,
+  // one per slice of `scatter_details`, or the whole buffer if
+  // `scatter_details` is not set. Every entry of `callbacks` is called exactly
+  // once.
+  void EnqueueCrossHostSends(
+      PjRtBuffer* buffer, std::vector<std::string> serialized_descriptors,
+      std::vector<PjRtBuffer::RemoteSendCallback> callbacks,
+      std::optional<PjRtBuffer::ScatterDetails> scatter_details) const;
+
   xla::StreamExecutorGpuTopologyDescription topology_;
   std::shared_ptr<KeyValueStoreInterface> kv_store_;
+
+  // Directory of the persistent compilation cache, or empty if disabled.
+  std::string compilation_cache_dir_;
+
+  // Threads that set up NCCL communicators for cross-host transfers. Joining a
+  // clique blocks until the remote peer joins as well, so this is kept apart
+  // from the client's thread pool.
+  std::unique_ptr<tsl::thread::ThreadPool> cross_host_transfer_pool_;
 };
 
 std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> BuildLocalDevices(
@@ -293,6 +345,11 @@ struct GpuClientOptions {
   std::shared_ptr<KeyValueStoreInterface> kv_store = nullptr;
 
   bool enable_mock_nccl = false;
+
+  // If non-empty, compiled executables are serialized into this directory
+  // and reused by clients (in this or other processes) that compile the same
+  // computation with the same options for the same kind of device.
+  std::string compilation_cache_dir;
 };
 
 absl::StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
@@ -32,6 +32,7 @@ limitations under the License.
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "xla/client/xla_computation.h"
@@ -52,13 +53,17 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/statusor.h"
+#include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/stream.h"
 #include "xla/test.h"
 #include "xla/tests/literal_test_util.h"
+#include "xla/tsl/framework/allocator.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/casts.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
@@ -180,6 +185,68 @@ ENTRY %Add.6 (a.1: f32[], b.2: f32[]) -> (f32[], f32[]) {
   EXPECT_EQ(result[0][0]->GetReadyFuture().Await(), input_error);
 }
 
+TEST(StreamExecutorGpuClientTest, CompilationCache) {
+  GpuClientOptions options;
+  options.compilation_cache_dir =
+      tsl::io::JoinPath(::testing::TempDir(), "pjrt_gpu_compilation_cache");
+  tsl::Env* env = tsl::Env::Default();
+  int64_t undeleted_files, undeleted_dirs;
+  env->DeleteRecursively(options.compilation_cache_dir, &undeleted_files,
+                         &undeleted_dirs)
+      .IgnoreError();
+
+  static constexpr char const* kAddProgram = R"(
+HloModule Add
+
+ENTRY %Add (a: f32[2], b: f32[2]) -> f32[2] {
+  %a = f32[2] parameter(0)
+  %b = f32[2] parameter(1)
+  ROOT %add = f32[2] add(%a, %b)
+}
+)";
+
+  // The first client compiles the program and stores it in the cache.
+  {
+    TF_ASSERT_OK_AND_ASSIGN(auto client, GetStreamExecutorGpuClient(options));
+    TF_ASSERT_OK(CompileExecutable(kAddProgram, *client).status());
+  }
+  std::vector<std::string> entries;
+  TF_ASSERT_OK(env->GetChildren(options.compilation_cache_dir, &entries));
+  ASSERT_EQ(entries.size(), 1);
+
+  // The second client loads the executable from the cache.
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetStreamExecutorGpuClient(options));
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          CompileExecutable(kAddProgram, *client));
+  entries.clear();
+  TF_ASSERT_OK(env->GetChildren(options.compilation_cache_dir, &entries));
+  EXPECT_EQ(entries.size(), 1);
+
+  auto literal = LiteralUtil::CreateR1<float>({1.0f, 2.0f});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostLiteral(literal, client->addressable_devices()[0]));
+  auto result =
+      executable->Execute({{buffer.get(), buffer.get()}}, /*options=*/{});
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> result_literal,
+                          ExtractSingleResult(result));
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<float>({2.0f, 4.0f}),
+                                     *result_literal));
+
+  // Different debug options produce a different executable, so they don't
+  // hit the cached entry.
+  CompileOptions compile_options;
+  DebugOptions* debug_options =
+      compile_options.executable_build_options.mutable_debug_options();
+  debug_options->set_xla_gpu_enable_fast_min_max(
+      !debug_options->xla_gpu_enable_fast_min_max());
+  TF_ASSERT_OK(
+      CompileExecutable(kAddProgram, *client, compile_options).status());
+  entries.clear();
+  TF_ASSERT_OK(env->GetChildren(options.compilation_cache_dir, &entries));
+  EXPECT_EQ(entries.size(), 2);
+}
+
 TEST(StreamExecutorGpuClientTest, SendRecvChunked) {
   TF_ASSERT_OK_AND_ASSIGN(auto client,
                           GetStreamExecutorGpuClient(GpuClientOptions()));
@@ -621,6 +688,50 @@ TEST(StreamExecutorGpuClientTest, AsyncCopyToDevice) {
             literal->Relayout(src_literal.shape().layout()).data<float>());
 }
 
+TEST(StreamExecutorGpuClientTest, CopyToRemoteDeviceLoopback) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetStreamExecutorGpuClient(GpuClientOptions()));
+  ASSERT_GE(client->addressable_devices().size(), 2);
+
+  // Both ends of the "cross-host" transfer live in this process, which
+  // exercises the same descriptor handshake as a real remote copy.
+  auto* src_device = client->addressable_devices()[0];
+  auto* dst_device = client->addressable_devices()[1];
+
+  auto src_literal = LiteralUtil::CreateR1<float>({41.0f, 42.0f, 43.0f, 44.0f});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto src_buffer, client->BufferFromHostLiteral(src_literal, src_device));
+
+  auto descriptor_promise = PjRtFuture<std::string>::CreatePromise();
+  PjRtFuture<std::string> descriptor_future(descriptor_promise);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto dst_buffers,
+      client->MakeCrossHostReceiveBuffers(
+          {src_literal.shape()}, dst_device,
+          [&](absl::StatusOr<PjRtCrossHostRecvState> state) {
+            if (!state.ok()) {
+              descriptor_promise.Set(state.status());
+              return;
+            }
+            descriptor_promise.Set(
+                state->descriptors[0].serialized_descriptors[0]);
+          }));
+  ASSERT_EQ(dst_buffers.size(), 1);
+
+  absl::Notification sent;
+  absl::Status send_status;
+  src_buffer->CopyToRemoteDevice(
+      descriptor_future, [&](absl::Status status, bool sends_were_enqueued) {
+        send_status = status;
+        sent.Notify();
+      });
+
+  TF_ASSERT_OK_AND_ASSIGN(auto literal, dst_buffers[0]->ToLiteralSync());
+  sent.WaitForNotification();
+  TF_EXPECT_OK(send_status);
+  EXPECT_TRUE(LiteralTestUtil::Equal(src_literal, *literal));
+}
+
 TEST(StreamExecutorGpuClientTest, CreateMixOfErrorBuffers) {
   TF_ASSERT_OK_AND_ASSIGN(auto client,
                           GetStreamExecutorGpuClient(GpuClientOptions()));
@@ -745,6 +856,46 @@ TEST(StreamExecutorGpuClientTest, GetAllocatorStatsTest) {
   }
 }
 
+TEST(StreamExecutorGpuClientTest, PinnedHostMemoryPoolIsSharedPerNumaNode) {
+  constexpr int64_t kPreallocateSize = 1 << 20;
+  GpuClientOptions options;
+  options.allocator_config.pinned_host_memory_preallocate_size =
+      kPreallocateSize;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetStreamExecutorGpuClient(options));
+
+  auto* device0 = tensorflow::down_cast<StreamExecutorGpuDevice*>(
+      client->addressable_devices()[0]);
+  TF_ASSERT_OK_AND_ASSIGN(tsl::AllocatorStats stats,
+                          device0->GetPinnedHostAllocatorStats());
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_GE(*stats.pool_bytes, kPreallocateSize);
+
+  auto* allocator =
+      tensorflow::down_cast<PjRtStreamExecutorClient*>(client.get())
+          ->allocator();
+  TF_ASSERT_OK_AND_ASSIGN(
+      se::OwningDeviceMemory buffer,
+      allocator->Allocate(device0->local_device_id().value(), 1024,
+                          /*retry_on_failure=*/false,
+                          static_cast<int>(se::MemoryType::kHost)));
+
+  int numa_node = device0->local_device_state()
+                      ->executor()
+                      ->GetDeviceDescription()
+                      .numa_node();
+  for (PjRtDevice* device : client->addressable_devices()) {
+    auto* gpu_device = tensorflow::down_cast<StreamExecutorGpuDevice*>(device);
+    if (gpu_device->local_device_state()
+            ->executor()
+            ->GetDeviceDescription()
+            .numa_node() != numa_node) {
+      continue;
+    }
+    TF_ASSERT_OK_AND_ASSIGN(stats, gpu_device->GetPinnedHostAllocatorStats());
+    EXPECT_GE(stats.bytes_in_use, 1024);
+  }
+}
+
 TEST(StreamExecutorGpuClientTest, GpuDeviceDescriptionTest) {
   TF_ASSERT_OK_AND_ASSIGN(auto client,
                           GetStreamExecutorGpuClient(GpuClientOptions()));
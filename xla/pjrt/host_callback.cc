@@ -16,12 +16,14 @@ limitations under the License.
 #include "xla/pjrt/host_callback.h"
 
 #include <cstddef>
+#include <deque>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_executable.h"
 #include "xla/shape_util.h"
@@ -71,26 +73,28 @@ absl::Status HostCallbackContext::OnSend(int arg_num,
   // supposed to be invoked sequentially.
   ready_count_.store(args_.size());
 
-  std::vector<void*> arg_ptrs;
-  arg_ptrs.reserve(args_.size());
-  for (auto& arg : args_) {
-    arg_ptrs.push_back(arg.data());
+  if (host_callback_.run_asynchronously) {
+    // Hand the arguments over to the callback thread and let the device
+    // continue. Taking them here leaves `args_` empty for the next invocation.
+    std::vector<PjRtChunk> args;
+    args.reserve(args_.size());
+    for (auto& arg : args_) {
+      args.push_back(std::exchange(arg, PjRtChunk{}));
+    }
+    absl::MutexLock lock(&async_mu_);
+    pending_args_.push_back(std::move(args));
+    return absl::OkStatus();
   }
 
   std::vector<PjRtChunk> results;
-  std::vector<void*> result_ptrs;
   results.reserve(result_channels_.size());
-  result_ptrs.reserve(result_channels_.size());
   for (int i = 0; i < result_channels_.size(); ++i) {
     const auto& host_shape = host_callback_.results.at(i).shape;
     size_t host_size = ShapeUtil::ByteSizeOf(host_shape);
     results.push_back(PjRtChunk::AllocateDefault(host_size));
-    result_ptrs.push_back(results.back().data());
   }
 
-  EnterHostCallback();
-  auto status = host_callback_.callback(result_ptrs.data(), arg_ptrs.data());
-  LeaveHostCallback();
+  auto status = InvokeCallback(args_, results);
 
   // TODO(chky): Consider populating garbage data in results upon errors.
 
@@ -110,6 +114,66 @@ absl::Status HostCallbackContext::OnSend(int arg_num,
   return status;
 }
 
+HostCallbackContext::~HostCallbackContext() {
+  {
+    absl::MutexLock lock(&async_mu_);
+    shutdown_ = true;
+  }
+  if (async_thread_ == nullptr) {
+    return;
+  }
+  // Joins the callback thread after it has drained `pending_args_`.
+  auto wait = [this] { async_thread_.reset(); };
+  if (host_callback_.wrap_blocking_wait) {
+    host_callback_.wrap_blocking_wait(wait);
+  } else {
+    wait();
+  }
+}
+
+absl::Status HostCallbackContext::InvokeCallback(
+    std::vector<PjRtChunk>& args, std::vector<PjRtChunk>& results) {
+  std::vector<void*> arg_ptrs;
+  arg_ptrs.reserve(args.size());
+  for (auto& arg : args) {
+    arg_ptrs.push_back(arg.data());
+  }
+  std::vector<void*> result_ptrs;
+  result_ptrs.reserve(results.size());
+  for (auto& result : results) {
+    result_ptrs.push_back(result.data());
+  }
+
+  EnterHostCallback();
+  auto status = host_callback_.callback(result_ptrs.data(), arg_ptrs.data());
+  LeaveHostCallback();
+  return status;
+}
+
+void HostCallbackContext::RunAsyncCallbacks() {
+  std::vector<PjRtChunk> no_results;
+  while (true) {
+    std::deque<std::vector<PjRtChunk>> batch;
+    {
+      absl::MutexLock lock(&async_mu_);
+      auto ready = [this]() ABSL_SHARED_LOCKS_REQUIRED(async_mu_) {
+        return shutdown_ || !pending_args_.empty();
+      };
+      async_mu_.Await(absl::Condition(&ready));
+      if (pending_args_.empty()) {
+        return;
+      }
+      batch.swap(pending_args_);
+    }
+    for (auto& args : batch) {
+      absl::Status status = InvokeCallback(args, no_results);
+      if (!status.ok()) {
+        LOG(ERROR) << "Asynchronous host callback failed: " << status;
+      }
+    }
+  }
+}
+
 void HostCallbackContext::Receive(int res_num,
                                   const PjRtTransferMetadata& metadata,
                                   std::unique_ptr<CopyToDeviceStream> stream) {
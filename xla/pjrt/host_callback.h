@@ -25,6 +25,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
@@ -32,6 +33,7 @@ limitations under the License.
 #include "xla/pjrt/pjrt_executable.h"
 #include "xla/pjrt/pjrt_future.h"
 #include "xla/shape.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"
 
 // The following provides an API for implementing host callbacks on top of
@@ -104,6 +106,19 @@ struct HostCallback {
   // callback can also return error status to indicate the entire execution
   // should fail.
   std::function<absl::Status(void**, void**)> callback;
+
+  // If true, the callback is invoked on a dedicated host thread instead of in
+  // the send callback, so the device does not wait for it to finish. Pending
+  // invocations are drained in order, in batches. Only valid for callbacks
+  // without results. Errors returned by the callback cannot fail the execution
+  // and are logged instead.
+  bool run_asynchronously = false;
+
+  // If set, the destructor of an asynchronous callback's context passes the
+  // wait for its pending invocations to this function instead of waiting
+  // directly. Lets the owner release locks that the callback acquires, e.g.,
+  // the Python GIL, while the pending invocations run.
+  std::function<void(absl::FunctionRef<void()> wait)> wrap_blocking_wait;
 };
 
 // A helper class that maintains the send/recv states for a host callback.
@@ -126,8 +141,18 @@ class HostCallbackContext {
     for (auto& channel : result_channels_) {
       channel = std::make_unique<ThreadSafePjRtChunkQueue>();
     }
+    if (host_callback_.run_asynchronously) {
+      CHECK(host_callback_.results.empty())
+          << "Asynchronous host callbacks cannot have results";
+      async_thread_.reset(tsl::Env::Default()->StartThread(
+          tsl::ThreadOptions(), "host_callback",
+          [this] { RunAsyncCallbacks(); }));
+    }
   }
 
+  // Waits for all pending asynchronous invocations to finish.
+  ~HostCallbackContext();
+
   absl::Status OnSend(int arg_num, const PjRtTransferMetadata& metadata,
                       PjRtChunk data);
 
@@ -137,12 +162,25 @@ class HostCallbackContext {
   const HostCallback& host_callback() const { return host_callback_; }
 
  private:
+  // Invokes the callback with `args` and the preallocated `results`.
+  absl::Status InvokeCallback(std::vector<PjRtChunk>& args,
+                              std::vector<PjRtChunk>& results);
+
+  // Body of `async_thread_`: drains `pending_args_` until shutdown.
+  void RunAsyncCallbacks();
+
   HostCallback host_callback_;
   bool use_major_to_minor_data_layout_for_callbacks_;
   PjRtHostMemoryForDeviceManager* host_memory_for_device_manager_ = nullptr;
   std::vector<PjRtChunk> args_;
   std::vector<std::unique_ptr<ThreadSafePjRtChunkQueue>> result_channels_;
   std::atomic<int> ready_count_;
+
+  absl::Mutex async_mu_;
+  // Arguments of asynchronous invocations that have not run yet.
+  std::deque<std::vector<PjRtChunk>> pending_args_ ABSL_GUARDED_BY(async_mu_);
+  bool shutdown_ ABSL_GUARDED_BY(async_mu_) = false;
+  std::unique_ptr<tsl::Thread> async_thread_;
 };
 
 // The execution states for host callbacks for all replicas. The states are kept
@@ -18,9 +18,12 @@ limitations under the License.
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/tests/literal_test_util.h"
 #include "tsl/lib/core/status_test_util.h"
@@ -170,5 +173,102 @@ TEST(HostCallbackTest, NonBlockingRecv) {
   EXPECT_TRUE(LiteralTestUtil::Equal(literal, borrowing_literal));
 }
 
+TEST(HostCallbackTest, AsynchronousCallback) {
+  HostCallback host_callback;
+
+  Shape shape = ShapeUtil::MakeShape(F32, {2});
+  size_t byte_size = ShapeUtil::ByteSizeOf(shape);
+
+  absl::Mutex mu;
+  std::vector<float> received;
+  host_callback.operands = {HostCallbackArgInfo{/*channel_id=*/1, shape}};
+  host_callback.run_asynchronously = true;
+  host_callback.callback = [&](void** outputs, void** inputs) {
+    absl::MutexLock lock(&mu);
+    const float* data = static_cast<const float*>(inputs[0]);
+    received.insert(received.end(), data, data + 2);
+    return absl::OkStatus();
+  };
+
+  HostCallbackStates states;
+
+  auto& send_callbacks = states.send_callbacks.emplace_back();
+  auto& recv_callbacks = states.recv_callbacks.emplace_back();
+
+  auto context = CreateHostCallbackStateAndAppendSendRecvCallbacks(
+      std::move(host_callback), /*host_memory_for_device_manager=*/nullptr,
+      send_callbacks, recv_callbacks,
+      /*use_major_to_minor_data_layout_for_callbacks=*/true);
+
+  PjRtTransferMetadata metadata;
+  metadata.device_shape = shape;
+
+  for (int i = 0; i < 3; ++i) {
+    float values[2] = {static_cast<float>(2 * i),
+                       static_cast<float>(2 * i + 1)};
+    auto chunk = PjRtChunk::AllocateDefault(/*size=*/byte_size);
+    std::memcpy(chunk.data(), values, byte_size);
+    TF_ASSERT_OK(context->OnSend(/*arg_num=*/0, metadata, std::move(chunk)));
+  }
+
+  // Destroying the context waits for the pending invocations.
+  context.reset();
+
+  absl::MutexLock lock(&mu);
+  EXPECT_EQ(received, std::vector<float>({0, 1, 2, 3, 4, 5}));
+}
+
+TEST(HostCallbackTest, AsynchronousCallbackWrapsBlockingWait) {
+  HostCallback host_callback;
+
+  Shape shape = ShapeUtil::MakeShape(F32, {2});
+  size_t byte_size = ShapeUtil::ByteSizeOf(shape);
+
+  // Stands in for a lock like the Python GIL, which the callback needs and
+  // which the destroying thread holds.
+  absl::Mutex lock_needed_by_callback;
+  int invocations = 0;
+  int wrapped_waits = 0;
+  host_callback.operands = {HostCallbackArgInfo{/*channel_id=*/1, shape}};
+  host_callback.run_asynchronously = true;
+  host_callback.callback = [&](void** outputs, void** inputs) {
+    absl::MutexLock lock(&lock_needed_by_callback);
+    ++invocations;
+    return absl::OkStatus();
+  };
+  host_callback.wrap_blocking_wait = [&](absl::FunctionRef<void()> wait) {
+    ++wrapped_waits;
+    lock_needed_by_callback.Unlock();
+    wait();
+    lock_needed_by_callback.Lock();
+  };
+
+  HostCallbackStates states;
+
+  auto& send_callbacks = states.send_callbacks.emplace_back();
+  auto& recv_callbacks = states.recv_callbacks.emplace_back();
+
+  auto context = CreateHostCallbackStateAndAppendSendRecvCallbacks(
+      std::move(host_callback), /*host_memory_for_device_manager=*/nullptr,
+      send_callbacks, recv_callbacks,
+      /*use_major_to_minor_data_layout_for_callbacks=*/true);
+
+  PjRtTransferMetadata metadata;
+  metadata.device_shape = shape;
+
+  absl::MutexLock lock(&lock_needed_by_callback);
+  for (int i = 0; i < 3; ++i) {
+    auto chunk = PjRtChunk::AllocateDefault(/*size=*/byte_size);
+    std::memset(chunk.data(), 0, byte_size);
+    TF_ASSERT_OK(context->OnSend(/*arg_num=*/0, metadata, std::move(chunk)));
+  }
+
+  // Would deadlock if the wait did not go through `wrap_blocking_wait`.
+  context.reset();
+
+  EXPECT_EQ(wrapped_waits, 1);
+  EXPECT_EQ(invocations, 3);
+}
+
 }  // namespace
 }  // namespace xla
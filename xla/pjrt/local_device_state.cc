@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/pjrt/local_device_state.h"
 
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -39,7 +40,8 @@ LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
                                    int max_inflight_computations,
                                    bool allow_event_reuse,
                                    bool use_callback_stream, int device_ordinal,
-                                   std::optional<StreamOptions> stream_options)
+                                   std::optional<StreamOptions> stream_options,
+                                   int num_preallocated_events)
     : allocation_model_(allocation_model),
       event_pool_(allow_event_reuse),
       compute_semaphore_(
@@ -88,10 +90,24 @@ LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
   for (int i = 0; i < kNumExternalReadyEventStreams; ++i) {
     external_ready_event_streams_.emplace_back(create_stream());
   }
+  // Platforms without stream priorities get a regular, but still dedicated,
+  // stream.
+  auto create_high_priority_stream = [&]() {
+    auto stream = executor->CreateStream(se::StreamPriority::Highest);
+    return stream.ok() ? std::move(stream).value() : create_stream();
+  };
+  high_priority_device_to_host_stream_ = create_high_priority_stream();
+  high_priority_device_to_device_stream_ = create_high_priority_stream();
   execute_thread_ =
       std::make_unique<WorkerThread>(tsl::Env::Default(), "py_xla_execute");
   callback_thread_ =
       std::make_unique<WorkerThread>(tsl::Env::Default(), "py_xla_callback");
+  absl::Status status =
+      event_pool_.Preallocate(executor_, num_preallocated_events);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to preallocate " << num_preallocated_events
+                 << " events: " << status;
+  }
 }
 
 LocalDeviceState::~LocalDeviceState() {
@@ -118,6 +134,7 @@ absl::Status LocalDeviceState::SynchronizeAllActivity() {
   for (auto& stream : device_to_host_streams_) {
     status.Update(stream->BlockHostUntilDone());
   }
+  status.Update(high_priority_device_to_host_stream_->BlockHostUntilDone());
   bool ok = compute_stream_->parent()->SynchronizeAllActivity();
   if (!ok) {
     status.Update(Unknown("SynchronizeAllActivity failed."));
@@ -155,20 +172,66 @@ absl::Status LocalDeviceState::ThenExecuteCallback(
       });
 }
 
-se::Stream* LocalDeviceState::GetDeviceToHostStream() {
+se::Stream* LocalDeviceState::PickLeastLoadedStream(
+    const std::vector<std::unique_ptr<se::Stream>>& streams, int* next,
+    int64_t transfer_size) {
+  int best = *next;
+  int64_t best_bytes = std::numeric_limits<int64_t>::max();
+  for (int k = 0; k < streams.size(); ++k) {
+    int i = (*next + k) % streams.size();
+    auto it = outstanding_transfer_bytes_.find(streams[i].get());
+    int64_t bytes = it == outstanding_transfer_bytes_.end() ? 0 : it->second;
+    if (bytes < best_bytes) {
+      best = i;
+      best_bytes = bytes;
+    }
+  }
+  *next = (best + 1) % streams.size();
+  se::Stream* stream = streams.at(best).get();
+  if (transfer_size > 0) {
+    outstanding_transfer_bytes_[stream] += transfer_size;
+  }
+  return stream;
+}
+
+se::Stream* LocalDeviceState::GetDeviceToHostStream(int64_t transfer_size,
+                                                    TransferPriority priority) {
   absl::MutexLock lock(&mu_);
-  int i = next_device_to_host_stream_;
-  next_device_to_host_stream_ =
-      (next_device_to_host_stream_ + 1) % device_to_host_streams_.size();
-  return device_to_host_streams_.at(i).get();
+  if (priority == TransferPriority::kHigh) {
+    if (transfer_size > 0) {
+      outstanding_transfer_bytes_[high_priority_device_to_host_stream_.get()] +=
+          transfer_size;
+    }
+    return high_priority_device_to_host_stream_.get();
+  }
+  return PickLeastLoadedStream(device_to_host_streams_,
+                               &next_device_to_host_stream_, transfer_size);
+}
+
+se::Stream* LocalDeviceState::GetDeviceToDeviceStream(
+    int64_t transfer_size, TransferPriority priority) {
+  absl::MutexLock lock(&mu_);
+  if (priority == TransferPriority::kHigh) {
+    if (transfer_size > 0) {
+      outstanding_transfer_bytes_[high_priority_device_to_device_stream_
+                                      .get()] += transfer_size;
+    }
+    return high_priority_device_to_device_stream_.get();
+  }
+  return PickLeastLoadedStream(device_to_device_streams_,
+                               &next_device_to_device_stream_, transfer_size);
 }
 
-se::Stream* LocalDeviceState::GetDeviceToDeviceStream() {
+void LocalDeviceState::ReleaseTransferBytes(se::Stream* stream,
+                                            int64_t transfer_size) {
+  if (transfer_size <= 0) {
+    return;
+  }
   absl::MutexLock lock(&mu_);
-  int i = next_device_to_device_stream_;
-  next_device_to_device_stream_ =
-      (next_device_to_device_stream_ + 1) % device_to_device_streams_.size();
-  return device_to_device_streams_.at(i).get();
+  auto it = outstanding_transfer_bytes_.find(stream);
+  CHECK(it != outstanding_transfer_bytes_.end() &&
+        it->second >= transfer_size);
+  it->second -= transfer_size;
 }
 
 se::Stream* LocalDeviceState::GetFixedSizePoolUsageStream() {
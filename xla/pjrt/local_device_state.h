@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_PJRT_LOCAL_DEVICE_STATE_H_
 #define XLA_PJRT_LOCAL_DEVICE_STATE_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -23,6 +24,8 @@ limitations under the License.
 #include <stack>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/client/local_client.h"
@@ -105,11 +108,16 @@ class LocalDeviceState {
   // `local_hardware_id()`). In general, different PJRT devices have different
   // logical device ordinals, and several PJRT devices can have the same
   // physical device ordinal if they share the same physical device.
+  //
+  // If `allow_event_reuse` is true, `num_preallocated_events` events are
+  // created up front so that the event pool does not have to create them on
+  // the execute path.
   LocalDeviceState(se::StreamExecutor* executor, LocalClient* client,
                    AllocationModel allocation_model,
                    int max_inflight_computations, bool allow_event_reuse,
                    bool use_callback_stream, int device_ordinal = -1,
-                   std::optional<StreamOptions> stream_options = std::nullopt);
+                   std::optional<StreamOptions> stream_options = std::nullopt,
+                   int num_preallocated_events = 0);
   virtual ~LocalDeviceState();
 
   se::StreamExecutor* executor() const { return executor_; }
@@ -128,13 +136,27 @@ class LocalDeviceState {
     return host_to_device_stream_.get();
   }
 
-  // Returns a device to host stream. Allocates streams in a round-robin fashion
-  // amongst the available streams.
-  se::Stream* GetDeviceToHostStream();
-
-  // Returns a device to device stream. Allocates streams in a round-robin
-  // fashion amongst the available streams.
-  se::Stream* GetDeviceToDeviceStream();
+  // Returns a device to host stream for a transfer of `transfer_size` bytes.
+  // kHigh transfers get a dedicated high-priority stream. Other transfers get
+  // the stream with the fewest outstanding bytes, so that small copies do not
+  // queue up behind large ones; idle streams are handed out round-robin.
+  //
+  // The bytes are counted against the stream until the caller passes them to
+  // ReleaseTransferBytes(), which it must do once the transfer has completed.
+  se::Stream* GetDeviceToHostStream(
+      int64_t transfer_size = 0,
+      TransferPriority priority = TransferPriority::kDefault);
+
+  // Returns a device to device stream. Streams are chosen the same way as in
+  // GetDeviceToHostStream().
+  se::Stream* GetDeviceToDeviceStream(
+      int64_t transfer_size = 0,
+      TransferPriority priority = TransferPriority::kDefault);
+
+  // Stops counting `transfer_size` bytes against `stream`, a stream returned
+  // by GetDeviceToHostStream() or GetDeviceToDeviceStream(). May be called
+  // from any thread, including stream callbacks.
+  void ReleaseTransferBytes(se::Stream* stream, int64_t transfer_size);
 
   // Returns a usage stream. Allocates streams in a round-robin fashion amongst
   // the available streams. When the overhead from BorrowStreamFromPool is too
@@ -202,6 +224,13 @@ class LocalDeviceState {
  private:
   absl::Status SynchronizeAllActivity();
 
+  // Returns the stream in `streams` with the fewest outstanding transfer
+  // bytes, starting the search at `*next`, and counts `transfer_size` bytes
+  // against it.
+  se::Stream* PickLeastLoadedStream(
+      const std::vector<std::unique_ptr<se::Stream>>& streams, int* next,
+      int64_t transfer_size) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   AllocationModel allocation_model_;
 
   EventPool event_pool_;
@@ -220,6 +249,9 @@ class LocalDeviceState {
   std::vector<std::unique_ptr<se::Stream>> device_to_device_streams_;
   std::vector<std::unique_ptr<se::Stream>> fixed_size_pool_usage_streams_;
   std::vector<std::unique_ptr<se::Stream>> external_ready_event_streams_;
+  // Dedicated streams for TransferPriority::kHigh transfers.
+  std::unique_ptr<se::Stream> high_priority_device_to_host_stream_;
+  std::unique_ptr<se::Stream> high_priority_device_to_device_stream_;
 
   static constexpr int kNumDeviceToHostStreams = 4;
   static constexpr int kNumDeviceToDeviceStreams = 4;
@@ -231,6 +263,10 @@ class LocalDeviceState {
   int next_device_to_device_stream_ ABSL_GUARDED_BY(mu_) = 0;
   int next_fixed_size_pool_usage_stream_ ABSL_GUARDED_BY(mu_) = 0;
   int next_external_ready_event_stream_ ABSL_GUARDED_BY(mu_) = 0;
+  // Bytes of transfers handed a device to host or device to device stream
+  // that have not been released yet, per stream.
+  absl::flat_hash_map<se::Stream*, int64_t> outstanding_transfer_bytes_
+      ABSL_GUARDED_BY(mu_);
 
   std::random_device prng_seed_device_ ABSL_GUARDED_BY(mu_);
   std::mt19937 prng_seed_generator_ ABSL_GUARDED_BY(mu_);
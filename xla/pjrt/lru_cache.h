@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef XLA_PJRT_LRU_CACHE_H_
 #define XLA_PJRT_LRU_CACHE_H_
 
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <unordered_map>
 
@@ -74,6 +76,18 @@ class LRUCache {
     LRUListEntry head_;
   };
 
+  // Identifies an entry of an LRUCache, which can then be used again with
+  // `Touch` without looking up its key.
+  class Handle {
+   public:
+    Handle() = default;
+
+   private:
+    friend class LRUCache;
+    LRUListEntry* entry_ = nullptr;
+    int64_t removals_ = -1;
+  };
+
   explicit LRUCache(LRUList* lru_list) : lru_list_(lru_list) {}
   ~LRUCache();
 
@@ -86,6 +100,17 @@ class LRUCache {
   // and inserts it if absent.
   Value GetOrCreateIfAbsent(const Key& key,
                             const std::function<Value(const Key&)>& factory);
+  // As above, and sets `*handle` to identify the entry of `key`.
+  Value GetOrCreateIfAbsent(const Key& key,
+                            const std::function<Value(const Key&)>& factory,
+                            Handle* handle);
+
+  // Returns the value of the entry identified by `handle`, which must have
+  // been returned by this cache, and marks it as the most recently used.
+  // Unlike `GetOrCreateIfAbsent`, does not hash or compare the key. Returns
+  // std::nullopt if any entry has been removed from the cache since `handle`
+  // was returned, in which case the caller must look up the key again.
+  std::optional<Value> Touch(const Handle& handle);
 
   void Remove(const Key& key);
 
@@ -115,6 +140,13 @@ class LRUCache {
   // for keys and values, and (b) we need exception safety so we can't use
   // absl hashtables.
   std::unordered_map<Key, Entry, Hash, Eq> entries_;
+
+  // Number of times entries have been removed from the cache, which
+  // invalidates the outstanding `Handle`s.
+  int64_t removals_ = 0;
+
+  // Moves `entry`, which is not in the LRU list, to the back of the list.
+  void AddToBack(Entry& entry);
 };
 
 template <typename Key, typename Value, typename Hash, typename Eq>
@@ -134,6 +166,7 @@ void LRUCache<Key, Value, Hash, Eq>::Clear() {
     --lru_list_->size_;
   }
   entries_.clear();
+  ++removals_;
 }
 
 template <typename Key, typename Value, typename Hash, typename Eq>
@@ -149,11 +182,45 @@ void LRUCache<Key, Value, Hash, Eq>::Remove(const Key& key) {
   --lru_list_->size_;
 
   entries_.erase(key);
+  ++removals_;
+}
+
+template <typename Key, typename Value, typename Hash, typename Eq>
+void LRUCache<Key, Value, Hash, Eq>::AddToBack(Entry& entry) {
+  // Since the entry is now the most recently used element, it goes at the
+  // back.
+  LRUListEntry& lru_head = lru_list_->head_;
+  entry.container = this;
+  entry.prev = lru_head.prev;
+  entry.next = &lru_head;
+  lru_head.prev->next = &entry;
+  lru_head.prev = &entry;
+}
+
+template <typename Key, typename Value, typename Hash, typename Eq>
+std::optional<Value> LRUCache<Key, Value, Hash, Eq>::Touch(
+    const Handle& handle) {
+  if (handle.entry_ == nullptr || handle.removals_ != removals_) {
+    return std::nullopt;
+  }
+  Entry& entry = *static_cast<Entry*>(handle.entry_);
+  entry.prev->next = entry.next;
+  entry.next->prev = entry.prev;
+  AddToBack(entry);
+  return *entry.value;
 }
 
 template <typename Key, typename Value, typename Hash, typename Eq>
 Value LRUCache<Key, Value, Hash, Eq>::GetOrCreateIfAbsent(
     const Key& key, const std::function<Value(const Key&)>& factory) {
+  Handle handle;
+  return GetOrCreateIfAbsent(key, factory, &handle);
+}
+
+template <typename Key, typename Value, typename Hash, typename Eq>
+Value LRUCache<Key, Value, Hash, Eq>::GetOrCreateIfAbsent(
+    const Key& key, const std::function<Value(const Key&)>& factory,
+    Handle* handle) {
   auto [it, inserted] = entries_.try_emplace(key);
   Entry& entry = it->second;
   if (inserted) {
@@ -166,18 +233,15 @@ Value LRUCache<Key, Value, Hash, Eq>::GetOrCreateIfAbsent(
     entry.prev->next = entry.next;
     entry.next->prev = entry.prev;
   }
-  // (Re-)adds entry to the back of the LRU list. Since it is now the
-  // most recently used element, it goes at the back.
-  LRUListEntry& lru_head = lru_list_->head_;
-  entry.container = this;
-  entry.prev = lru_head.prev;
-  entry.next = &lru_head;
-  lru_head.prev->next = &entry;
-  lru_head.prev = &entry;
+  // (Re-)adds entry to the back of the LRU list.
+  AddToBack(entry);
 
   Value v = *entry.value;
+  handle->entry_ = &entry;
+  handle->removals_ = removals_;
 
   // Evict an LRU entry if we are over capacity.
+  LRUListEntry& lru_head = lru_list_->head_;
   if (lru_list_->size_ > lru_list_->capacity_) {
     Entry* to_remove = static_cast<Entry*>(lru_head.next);
     to_remove->next->prev = &lru_head;
@@ -186,6 +250,7 @@ Value LRUCache<Key, Value, Hash, Eq>::GetOrCreateIfAbsent(
     // whose destruction could call back into this code. Extract causes the
     // dtor to be delayed until the kv pair is fully removed from the map.
     to_remove->container->entries_.extract(*to_remove->key);
+    ++to_remove->container->removals_;
     --lru_list_->size_;
   }
   return v;
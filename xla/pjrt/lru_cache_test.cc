@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/pjrt/lru_cache.h"
 
+#include <optional>
 #include <random>
 
 #include "xla/test.h"
@@ -95,6 +96,35 @@ TEST(LRUCache, SharedLRUList) {
   EXPECT_EQ(2, cache1.GetOrCreateIfAbsent(2, [](int) { return 2; }));
 }
 
+TEST(LRUCache, Touch) {
+  LRUCache<int, int>::LRUList list(2);
+  LRUCache<int, int> cache1(&list);
+  LRUCache<int, int> cache2(&list);
+  LRUCache<int, int>::Handle handle;
+  EXPECT_EQ(std::nullopt, cache1.Touch(handle));
+
+  EXPECT_EQ(0, cache1.GetOrCreateIfAbsent(0, [](int) { return 0; }, &handle));
+  EXPECT_EQ(1, cache2.GetOrCreateIfAbsent(1, [](int) { return 1; }));
+  // Touching entry 0 makes entry 1 the least recently used one, which is then
+  // evicted by the next insertion.
+  EXPECT_EQ(0, cache1.Touch(handle));
+  EXPECT_EQ(2, cache2.GetOrCreateIfAbsent(2, [](int) { return 2; }));
+  EXPECT_EQ(1, cache1.Size());
+  EXPECT_EQ(1, cache2.Size());
+  EXPECT_EQ(0, cache1.Touch(handle));
+
+  // Evicting any entry of a cache invalidates its handles.
+  EXPECT_EQ(3, cache2.GetOrCreateIfAbsent(3, [](int) { return 3; }));
+  EXPECT_EQ(4, cache2.GetOrCreateIfAbsent(4, [](int) { return 4; }));
+  EXPECT_EQ(0, cache1.Size());
+  EXPECT_EQ(std::nullopt, cache1.Touch(handle));
+
+  EXPECT_EQ(5, cache1.GetOrCreateIfAbsent(5, [](int) { return 5; }, &handle));
+  EXPECT_EQ(5, cache1.Touch(handle));
+  cache1.Clear();
+  EXPECT_EQ(std::nullopt, cache1.Touch(handle));
+}
+
 TEST(LRUCache, RandomInsertions) {
   LRUCache<int, int>::LRUList list(7);
   LRUCache<int, int> cache(&list);
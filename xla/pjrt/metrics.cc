@@ -41,6 +41,23 @@ auto* pjrt_compiler_is_compiling_module = tsl::monitoring::Gauge<bool, 0>::New(
     metrics::kPjrtCompilerCompileModuleMetricName,
     "Whether the PjRT compiler is compiling modules.");
 
+auto* pjrt_transpose_plan_cache_hits = tsl::monitoring::Counter<0>::New(
+    "/jax/pjrt/transpose_plan_cache_hits",
+    "The number of TransposePlanCache lookups that found a cached plan.");
+
+auto* pjrt_transpose_plan_cache_misses = tsl::monitoring::Counter<0>::New(
+    "/jax/pjrt/transpose_plan_cache_misses",
+    "The number of TransposePlanCache lookups that built a new plan.");
+
+auto* pjrt_event_pool_events_created = tsl::monitoring::Counter<0>::New(
+    "/jax/pjrt/event_pool_events_created",
+    "The number of events created by EventPools, including preallocated "
+    "events.");
+
+auto* pjrt_event_pool_events_reused = tsl::monitoring::Counter<0>::New(
+    "/jax/pjrt/event_pool_events_reused",
+    "The number of EventPool allocations served from a free list.");
+
 }  // namespace
 
 namespace metrics {
@@ -64,5 +81,17 @@ void RecordPjrtCompilerCompileModuleStatus(bool is_compiling) {
   pjrt_compiler_is_compiling_module->GetCell()->Set(is_compiling);
 }
 
+void RecordTransposePlanCacheLookup(bool hit) {
+  static auto* hits_cell = pjrt_transpose_plan_cache_hits->GetCell();
+  static auto* misses_cell = pjrt_transpose_plan_cache_misses->GetCell();
+  (hit ? hits_cell : misses_cell)->IncrementBy(1);
+}
+
+void RecordEventPoolAllocation(bool reused) {
+  static auto* created_cell = pjrt_event_pool_events_created->GetCell();
+  static auto* reused_cell = pjrt_event_pool_events_reused->GetCell();
+  (reused ? reused_cell : created_cell)->IncrementBy(1);
+}
+
 }  // namespace metrics
 }  // namespace xla
@@ -36,6 +36,14 @@ void RecordPjrtCompilerCompileComputationStatus(bool is_compiling);
 
 void RecordPjrtCompilerCompileModuleStatus(bool is_compiling);
 
+// Counts a lookup in a TransposePlanCache that found (`hit`) or had to build
+// the requested plan.
+void RecordTransposePlanCacheLookup(bool hit);
+
+// Counts an event handed out by an EventPool, either taken from its free lists
+// (`reused`) or newly created through the driver.
+void RecordEventPoolAllocation(bool reused);
+
 }  // namespace metrics
 }  // namespace xla
 
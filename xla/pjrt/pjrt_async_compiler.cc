@@ -0,0 +1,161 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/pjrt/pjrt_async_compiler.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/pjrt_future.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+
+PjRtSwappableExecutable::PjRtSwappableExecutable(
+    std::unique_ptr<PjRtLoadedExecutable> executable)
+    : executable_(std::move(executable)),
+      optimized_promise_(PjRtFuture<>::CreatePromise()) {}
+
+std::shared_ptr<PjRtLoadedExecutable> PjRtSwappableExecutable::Get() const {
+  absl::ReaderMutexLock lock(&mu_);
+  return executable_;
+}
+
+void PjRtSwappableExecutable::Swap(
+    std::unique_ptr<PjRtLoadedExecutable> executable) {
+  std::shared_ptr<PjRtLoadedExecutable> old_executable;
+  {
+    absl::MutexLock lock(&mu_);
+    old_executable = std::exchange(executable_, std::move(executable));
+  }
+  // The old executable is destroyed outside of the lock, unless it is still
+  // in use by in-flight executions.
+}
+
+void PjRtSwappableExecutable::SetOptimized(
+    absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> optimized) {
+  if (!optimized.ok()) {
+    LOG(WARNING) << "Failed to compile the optimized executable, keep serving "
+                    "the current one: "
+                 << optimized.status();
+    optimized_promise_.Set(optimized.status());
+    return;
+  }
+  Swap(*std::move(optimized));
+  optimized_promise_.Set();
+}
+
+PjRtAsyncCompiler::PjRtAsyncCompiler(PjRtClient* client, int num_threads)
+    : PjRtAsyncCompiler(
+          [client](const XlaComputation& computation, CompileOptions options) {
+            return client->Compile(computation, std::move(options));
+          },
+          num_threads) {}
+
+PjRtAsyncCompiler::PjRtAsyncCompiler(CompileFn compile_fn, int num_threads)
+    : compile_fn_(std::move(compile_fn)),
+      thread_pool_(tsl::Env::Default(), "pjrt_async_compiler", num_threads) {}
+
+PjRtAsyncCompiler::~PjRtAsyncCompiler() { Shutdown(); }
+
+void PjRtAsyncCompiler::Shutdown() {
+  std::vector<Task> cancelled;
+  {
+    absl::MutexLock lock(&mu_);
+    shutting_down_ = true;
+    for (auto& [key, task] : pending_) {
+      cancelled.push_back(std::move(task));
+    }
+    pending_.clear();
+  }
+  for (Task& task : cancelled) {
+    task.promise.Set(absl::CancelledError(
+        "PjRtAsyncCompiler was shut down before the compilation started"));
+  }
+
+  absl::MutexLock lock(&mu_);
+  auto idle = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return num_running_ == 0;
+  };
+  mu_.Await(absl::Condition(&idle));
+}
+
+PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>> PjRtAsyncCompiler::Compile(
+    XlaComputation computation, CompileOptions options,
+    PjRtCompilePriority priority) {
+  auto promise = PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>::
+      CreatePromise();
+  {
+    absl::MutexLock lock(&mu_);
+    if (shutting_down_) {
+      return PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>(
+          absl::CancelledError("PjRtAsyncCompiler is shut down"));
+    }
+    TaskKey key(-static_cast<int>(priority), next_sequence_number_++);
+    pending_.emplace(key,
+                     Task{std::move(computation), std::move(options), promise});
+  }
+  // Every scheduled closure runs the pending task with the highest priority at
+  // the time it starts, not necessarily the task added here.
+  thread_pool_.Schedule([this] { RunNextTask(); });
+  return PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>(std::move(promise));
+}
+
+void PjRtAsyncCompiler::RunNextTask() {
+  Task task;
+  {
+    absl::MutexLock lock(&mu_);
+    // Pending tasks are cancelled on shutdown.
+    if (pending_.empty()) return;
+    auto it = pending_.begin();
+    task = std::move(it->second);
+    pending_.erase(it);
+    ++num_running_;
+  }
+  task.promise.Set(compile_fn_(task.computation, std::move(task.options)));
+  absl::MutexLock lock(&mu_);
+  --num_running_;
+}
+
+absl::StatusOr<std::shared_ptr<PjRtSwappableExecutable>>
+PjRtAsyncCompiler::CompileWithFallback(XlaComputation computation,
+                                       CompileOptions options,
+                                       CompileOptions fallback_options,
+                                       PjRtCompilePriority priority) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> fallback,
+                      compile_fn_(computation, std::move(fallback_options)));
+  auto executable =
+      std::make_shared<PjRtSwappableExecutable>(std::move(fallback));
+
+  Compile(std::move(computation), std::move(options), priority)
+      .OnReady([executable](
+                   absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
+                       optimized) {
+        executable->SetOptimized(std::move(optimized));
+      });
+  return executable;
+}
+
+}  // namespace xla
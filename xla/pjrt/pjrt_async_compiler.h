@@ -0,0 +1,141 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#ifndef XLA_PJRT_PJRT_ASYNC_COMPILER_H_
+#define XLA_PJRT_PJRT_ASYNC_COMPILER_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/pjrt_future.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+
+// A loaded executable that can be replaced while it is in use, e.g. a cheap
+// fallback executable that serves traffic until the optimized executable for
+// the same computation is compiled.
+class PjRtSwappableExecutable {
+ public:
+  explicit PjRtSwappableExecutable(
+      std::unique_ptr<PjRtLoadedExecutable> executable);
+
+  // Returns the current executable. Executions that started with an
+  // executable keep it alive by holding the returned pointer, even if it is
+  // replaced in the meantime.
+  std::shared_ptr<PjRtLoadedExecutable> Get() const;
+
+  // Atomically replaces the current executable.
+  void Swap(std::unique_ptr<PjRtLoadedExecutable> executable);
+
+  // Swaps in the optimized executable and makes the optimized future ready.
+  // If `optimized` is an error the current executable keeps serving and the
+  // optimized future is set to the error.
+  void SetOptimized(
+      absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> optimized);
+
+  // Returns a future that becomes ready when the optimized executable
+  // replaced the fallback, or with an error if it failed to compile. In the
+  // latter case the fallback executable keeps serving.
+  PjRtFuture<> GetOptimizedFuture() const {
+    return PjRtFuture<>(optimized_promise_);
+  }
+
+ private:
+  mutable absl::Mutex mu_;
+  std::shared_ptr<PjRtLoadedExecutable> executable_ ABSL_GUARDED_BY(mu_);
+
+  PjRtFuture<>::Promise optimized_promise_;
+};
+
+// Compiles computations for a PjRtClient on a bounded pool of background
+// threads, so that the callers are not blocked for the duration of a compile.
+//
+// Pending compilations with a higher priority start first, compilations with
+// the same priority start in the order they were requested. Compilations that
+// haven't started when the compiler is shut down fail with a Cancelled error.
+class PjRtAsyncCompiler {
+ public:
+  using CompileFn =
+      std::function<absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>(
+          const XlaComputation&, CompileOptions)>;
+
+  // Compiles with `client->Compile`.
+  PjRtAsyncCompiler(PjRtClient* client, int num_threads);
+  // Compiles with `compile_fn`, which may be called concurrently from several
+  // threads.
+  PjRtAsyncCompiler(CompileFn compile_fn, int num_threads);
+
+  // Shuts down the compiler, see Shutdown().
+  ~PjRtAsyncCompiler();
+
+  // Cancels the pending compilations, rejects new ones and waits for the
+  // running ones to finish. Owners that compile with a virtual method of their
+  // own must shut down the compiler before their destruction starts. Calling
+  // it again has no effect.
+  void Shutdown();
+
+  PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>> Compile(
+      XlaComputation computation, CompileOptions options,
+      PjRtCompilePriority priority = PjRtCompilePriority::kNormal);
+
+  // Compiles `computation` with `fallback_options` (e.g. without autotuning
+  // or at a lower optimization level) on the calling thread, and with
+  // `options` in the background. The returned executable serves the fallback
+  // until the optimized executable is ready and swapped in.
+  absl::StatusOr<std::shared_ptr<PjRtSwappableExecutable>> CompileWithFallback(
+      XlaComputation computation, CompileOptions options,
+      CompileOptions fallback_options,
+      PjRtCompilePriority priority = PjRtCompilePriority::kLow);
+
+ private:
+  struct Task {
+    XlaComputation computation;
+    CompileOptions options;
+    PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>::Promise promise;
+  };
+
+  // Pending tasks are ordered by decreasing priority and then by increasing
+  // sequence number.
+  using TaskKey = std::pair<int, int64_t>;
+
+  // Runs the pending task with the highest priority.
+  void RunNextTask();
+
+  CompileFn compile_fn_;
+
+  absl::Mutex mu_;
+  std::map<TaskKey, Task> pending_ ABSL_GUARDED_BY(mu_);
+  int64_t next_sequence_number_ ABSL_GUARDED_BY(mu_) = 0;
+  int64_t num_running_ ABSL_GUARDED_BY(mu_) = 0;
+  bool shutting_down_ ABSL_GUARDED_BY(mu_) = false;
+
+  // Destroyed first, which waits for the scheduled tasks.
+  tsl::thread::ThreadPool thread_pool_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_PJRT_ASYNC_COMPILER_H_
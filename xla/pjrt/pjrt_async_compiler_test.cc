@@ -0,0 +1,228 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/pjrt/pjrt_async_compiler.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/cpu/cpu_client.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/pjrt_future.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/service/hlo_parser.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace {
+
+constexpr char kProgram[] = R"(
+  HloModule add
+  ENTRY add {
+    x = f32[3,2] parameter(0)
+    y = f32[3,2] parameter(1)
+    ROOT add = f32[3,2] add(x, y)
+  })";
+
+absl::StatusOr<XlaComputation> ParseComputation() {
+  TF_ASSIGN_OR_RETURN(auto hlo_module,
+                      ParseAndReturnUnverifiedModule(kProgram, {}));
+  return XlaComputation(hlo_module->ToProto());
+}
+
+TEST(PjRtAsyncCompilerTest, CompileInBackground) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+
+  PjRtAsyncCompiler compiler(client.get(), /*num_threads=*/2);
+  std::vector<PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>> futures;
+  for (PjRtCompilePriority priority :
+       {PjRtCompilePriority::kLow, PjRtCompilePriority::kNormal,
+        PjRtCompilePriority::kHigh}) {
+    futures.push_back(
+        compiler.Compile(computation, CompileOptions(), priority));
+  }
+  for (auto& future : futures) {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PjRtLoadedExecutable> executable,
+                            std::move(future).Await());
+    EXPECT_NE(executable, nullptr);
+  }
+}
+
+TEST(PjRtAsyncCompilerTest, CompileErrorIsReturned) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+
+  // There are not enough devices for this many replicas.
+  CompileOptions options;
+  options.executable_build_options.set_num_replicas(
+      client->device_count() + 1);
+
+  PjRtAsyncCompiler compiler(client.get(), /*num_threads=*/1);
+  absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> executable =
+      compiler.Compile(computation, options).Await();
+  EXPECT_FALSE(executable.ok());
+}
+
+TEST(PjRtAsyncCompilerTest, FallbackIsSwappedForOptimizedExecutable) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+
+  PjRtAsyncCompiler compiler(client.get(), /*num_threads=*/1);
+  CompileOptions fallback_options;
+  fallback_options.executable_build_options.mutable_debug_options()
+      ->set_xla_backend_optimization_level(0);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PjRtSwappableExecutable> executable,
+      compiler.CompileWithFallback(computation, CompileOptions(),
+                                   fallback_options));
+
+  std::shared_ptr<PjRtLoadedExecutable> fallback = executable->Get();
+  ASSERT_NE(fallback, nullptr);
+
+  TF_ASSERT_OK(executable->GetOptimizedFuture().Await());
+  std::shared_ptr<PjRtLoadedExecutable> optimized = executable->Get();
+  ASSERT_NE(optimized, nullptr);
+  EXPECT_NE(optimized, fallback);
+}
+
+// Compiles nothing, but records the names of the compiled computations. The
+// first compilation blocks until `unblock` is notified.
+class RecordingCompiler {
+ public:
+  PjRtAsyncCompiler::CompileFn CompileFn() {
+    return [this](const XlaComputation& computation, CompileOptions)
+               -> absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> {
+      bool first;
+      {
+        absl::MutexLock lock(&mu_);
+        first = names_.empty();
+        names_.push_back(computation.name());
+      }
+      if (first) {
+        started.Notify();
+        unblock.WaitForNotification();
+      }
+      return absl::UnimplementedError("Not compiled");
+    };
+  }
+
+  std::vector<std::string> names() {
+    absl::MutexLock lock(&mu_);
+    return names_;
+  }
+
+  absl::Notification started;
+  absl::Notification unblock;
+
+ private:
+  absl::Mutex mu_;
+  std::vector<std::string> names_;
+};
+
+XlaComputation NamedComputation(const std::string& name) {
+  HloModuleProto proto;
+  proto.set_name(name);
+  return XlaComputation(std::move(proto));
+}
+
+TEST(PjRtAsyncCompilerTest, HigherPriorityStartsFirst) {
+  RecordingCompiler recorder;
+  PjRtAsyncCompiler compiler(recorder.CompileFn(), /*num_threads=*/1);
+
+  // Keep the only thread busy while the other compilations are queued.
+  auto blocker =
+      compiler.Compile(NamedComputation("blocker"), CompileOptions());
+  recorder.started.WaitForNotification();
+
+  std::vector<PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>> futures;
+  futures.push_back(compiler.Compile(NamedComputation("low0"),
+                                     CompileOptions(),
+                                     PjRtCompilePriority::kLow));
+  futures.push_back(compiler.Compile(NamedComputation("normal"),
+                                     CompileOptions(),
+                                     PjRtCompilePriority::kNormal));
+  futures.push_back(compiler.Compile(NamedComputation("low1"),
+                                     CompileOptions(),
+                                     PjRtCompilePriority::kLow));
+  futures.push_back(compiler.Compile(NamedComputation("high"),
+                                     CompileOptions(),
+                                     PjRtCompilePriority::kHigh));
+  recorder.unblock.Notify();
+
+  EXPECT_FALSE(std::move(blocker).Await().ok());
+  for (auto& future : futures) {
+    EXPECT_FALSE(std::move(future).Await().ok());
+  }
+  EXPECT_THAT(recorder.names(), ::testing::ElementsAre("blocker", "high",
+                                                       "normal", "low0",
+                                                       "low1"));
+}
+
+TEST(PjRtAsyncCompilerTest, ShutdownCancelsPendingCompilations) {
+  RecordingCompiler recorder;
+  PjRtAsyncCompiler compiler(recorder.CompileFn(), /*num_threads=*/1);
+
+  auto running =
+      compiler.Compile(NamedComputation("running"), CompileOptions());
+  recorder.started.WaitForNotification();
+  auto pending =
+      compiler.Compile(NamedComputation("pending"), CompileOptions());
+
+  // Shutdown waits for the running compilation, which is unblocked once the
+  // pending one has been cancelled.
+  pending.OnReady([&](const absl::StatusOr<
+                      std::unique_ptr<PjRtLoadedExecutable>>&) {
+    recorder.unblock.Notify();
+  });
+  compiler.Shutdown();
+
+  EXPECT_EQ(std::move(pending).Await().status().code(),
+            absl::StatusCode::kCancelled);
+  EXPECT_EQ(std::move(running).Await().status().code(),
+            absl::StatusCode::kUnimplemented);
+  EXPECT_EQ(compiler.Compile(NamedComputation("late"), CompileOptions())
+                .Await()
+                .status()
+                .code(),
+            absl::StatusCode::kCancelled);
+  EXPECT_THAT(recorder.names(), ::testing::ElementsAre("running"));
+}
+
+TEST(PjRtAsyncCompilerTest, ClientCompileAsync) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(CpuClientOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation, ParseComputation());
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PjRtLoadedExecutable> executable,
+      client->CompileAsync(computation, CompileOptions()).Await());
+  EXPECT_NE(executable, nullptr);
+}
+
+}  // namespace
+}  // namespace xla
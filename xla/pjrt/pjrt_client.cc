@@ -16,9 +16,12 @@ limitations under the License.
 #include "xla/pjrt/pjrt_client.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/casts.h"
 #include "absl/status/status.h"
 #include "absl/strings/substitute.h"
@@ -26,6 +29,7 @@ limitations under the License.
 #include "xla/pjrt/utils.h"
 #include "xla/util.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 
@@ -45,6 +49,13 @@ absl::StatusOr<std::uintptr_t> PjRtClient::UnsafeBufferPointer(
   return absl::bit_cast<std::uintptr_t>(ptr);
 }
 
+PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>> PjRtClient::CompileAsync(
+    const XlaComputation& computation, CompileOptions options,
+    PjRtCompilePriority priority) {
+  return PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>(
+      Compile(computation, std::move(options)));
+}
+
 PjRtFuture<> PjRtBuffer::CopyRawToHostFuture(PjRtFuture<void*> dst,
                                              int64_t offset,
                                              int64_t transfer_size) {
@@ -86,4 +97,84 @@ PjRtLoadedExecutable::GetCostAnalysis() const {
   return PjRtExecutableUtil::RunHloCostAnalysis(*this, hlo_cost_analysis.get());
 }
 
+absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+PjRtLoadedExecutable::ExecuteChain(absl::Span<const ChainStep> steps,
+                                   PjRtDevice* device,
+                                   const ExecuteOptions& options,
+                                   std::optional<PjRtFuture<>>& returned_future,
+                                   bool fill_future) {
+  if (steps.empty()) {
+    return InvalidArgument("ExecuteChain called with an empty chain.");
+  }
+  PjRtClient* client = steps.front().executable->client();
+  for (int i = 0; i < steps.size(); ++i) {
+    if (steps[i].executable->client() != client) {
+      return InvalidArgument(
+          "ExecuteChain: all executables must belong to the same client; step "
+          "%d does not.",
+          i);
+    }
+    for (const ChainArgument& arg : steps[i].arguments) {
+      if (arg.buffer != nullptr) {
+        continue;
+      }
+      if (arg.step < 0 || arg.step >= i || arg.output < 0) {
+        return InvalidArgument(
+            "ExecuteChain: step %d refers to output %d of step %d, which is "
+            "not an earlier step.",
+            i, arg.output, arg.step);
+      }
+    }
+  }
+  return steps.front().executable->ExecuteChainOnDevice(
+      steps, device, options, returned_future, fill_future);
+}
+
+absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+PjRtLoadedExecutable::ExecuteChainOnDevice(
+    absl::Span<const ChainStep> steps, PjRtDevice* device,
+    const ExecuteOptions& options, std::optional<PjRtFuture<>>& returned_future,
+    bool fill_future) {
+  std::vector<std::vector<std::unique_ptr<PjRtBuffer>>> outputs(steps.size());
+  std::vector<PjRtBuffer*> arguments;
+  for (int i = 0; i < steps.size(); ++i) {
+    const ChainStep& step = steps[i];
+    arguments.clear();
+    arguments.reserve(step.arguments.size());
+    for (const ChainArgument& arg : step.arguments) {
+      if (arg.buffer != nullptr) {
+        arguments.push_back(arg.buffer);
+        continue;
+      }
+      if (arg.output >= outputs[arg.step].size()) {
+        return InvalidArgument(
+            "ExecuteChain: step %d refers to output %d of step %d, which has "
+            "only %d outputs.",
+            i, arg.output, arg.step, outputs[arg.step].size());
+      }
+      arguments.push_back(outputs[arg.step][arg.output].get());
+    }
+
+    bool is_last = i + 1 == steps.size();
+    bool step_fill_future = is_last && fill_future;
+    std::optional<PjRtFuture<>> step_future;
+    PjRtLoadedExecutable* executable = step.executable;
+    if (absl::c_linear_search(executable->addressable_devices(), device)) {
+      TF_ASSIGN_OR_RETURN(
+          outputs[i], executable->ExecuteSharded(arguments, device, options,
+                                                 step_future,
+                                                 step_fill_future));
+    } else {
+      TF_ASSIGN_OR_RETURN(
+          outputs[i], executable->ExecutePortable(arguments, device, options,
+                                                  step_future,
+                                                  step_fill_future));
+    }
+    if (step_fill_future) {
+      returned_future = std::move(step_future);
+    }
+  }
+  return std::move(outputs.back());
+}
+
 }  // namespace xla
@@ -448,6 +448,9 @@ struct PjRtPluginAttributes {
   absl::flat_hash_map<std::string, PjRtValueType> attributes;
 };
 
+// Priority of an asynchronous compilation, see PjRtClient::CompileAsync.
+enum class PjRtCompilePriority { kLow = 0, kNormal = 1, kHigh = 2 };
+
 // Encapsulates the state of Python session with XLA.
 //
 // It is the responsibility of the client of this API to keep the PjRtClient
@@ -597,6 +600,14 @@ class PjRtClient {
   virtual absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> Compile(
       mlir::ModuleOp module, CompileOptions options) = 0;
 
+  // Variant of `Compile` that doesn't block the caller. Clients that support
+  // it compile on a bounded pool of background threads, where pending
+  // compilations with a higher `priority` start first. The default
+  // implementation compiles on the calling thread and returns a ready future.
+  virtual PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>> CompileAsync(
+      const XlaComputation& computation, CompileOptions options,
+      PjRtCompilePriority priority = PjRtCompilePriority::kNormal);
+
   // Deserializes a serialized executable as produced by
   // PjRtExecutable::SerializeExecutable(). `serialized` must have been
   // produced by a compiler of the same platform and version as this one.
@@ -1542,6 +1553,43 @@ class PjRtLoadedExecutable : public PjRtExecutable {
                            returned_future, /*fill_future=*/false);
   }
 
+  // An argument of a step in a chain passed to ExecuteChain(): either a
+  // buffer owned by the caller, or output `output` of the earlier step `step`.
+  struct ChainArgument {
+    static ChainArgument Buffer(PjRtBuffer* buffer) {
+      return ChainArgument{buffer, -1, -1};
+    }
+    static ChainArgument StepOutput(int step, int output) {
+      return ChainArgument{nullptr, step, output};
+    }
+
+    PjRtBuffer* buffer = nullptr;
+    int step = -1;
+    int output = -1;
+  };
+
+  // One step of a chain passed to ExecuteChain().
+  struct ChainStep {
+    PjRtLoadedExecutable* executable;
+    std::vector<ChainArgument> arguments;
+  };
+
+  // Enqueues `steps` in order on `device`, feeding outputs of earlier steps
+  // into later ones, and returns the outputs of the last step. All
+  // executables must belong to the same client and be runnable on `device`,
+  // either through ExecuteSharded() or ExecutePortable().
+  //
+  // Outputs of intermediate steps are never returned to the caller; they are
+  // released once the chain has been enqueued. If fill_future is true,
+  // returned_future becomes ready once the whole chain has completed.
+  //
+  // If a step fails to enqueue, the error is returned; steps enqueued before
+  // it are not rolled back.
+  static absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+  ExecuteChain(absl::Span<const ChainStep> steps, PjRtDevice* device,
+               const ExecuteOptions& options,
+               std::optional<PjRtFuture<>>& returned_future, bool fill_future);
+
   // Asynchronously free resources after the last execution completes.
   virtual void Delete() = 0;
 
@@ -1565,6 +1613,17 @@ class PjRtLoadedExecutable : public PjRtExecutable {
     std::optional<PjRtFuture<>> future;
     std::vector<std::unique_ptr<PjRtBuffer>> buffers;
   };
+
+  // Implementation of ExecuteChain(), called on the executable of the first
+  // step once the chain has been validated. The default implementation
+  // enqueues the steps one after another and only asks the last one for a
+  // future; clients whose executions on a device complete in order may
+  // override it to share more of the per-launch work between steps.
+  virtual absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+  ExecuteChainOnDevice(absl::Span<const ChainStep> steps, PjRtDevice* device,
+                       const ExecuteOptions& options,
+                       std::optional<PjRtFuture<>>& returned_future,
+                       bool fill_future);
 };
 
 }  // namespace xla
@@ -373,6 +373,61 @@ TEST_P(PjRtClientTest, ExecuteWithConcurrentUsageAndDonation) {
                                      *literal));
 }
 
+TEST_P(PjRtClientTest, ExecuteChain) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetClient());
+  auto executable =
+      MakeIncrementProgram(client.get(), /*alias=*/false, /*device=*/0);
+
+  std::vector<int32_t> data(4, 0);
+  Shape shape = ShapeUtil::MakeShape(S32, {4});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostBuffer(
+          data.data(), shape.element_type(), shape.dimensions(),
+          /*byte_strides=*/std::nullopt,
+          PjRtClient::HostBufferSemantics::kImmutableOnlyDuringCall, nullptr,
+          client->addressable_devices()[0]));
+
+  using Argument = PjRtLoadedExecutable::ChainArgument;
+  std::vector<PjRtLoadedExecutable::ChainStep> steps = {
+      {executable.get(), {Argument::Buffer(buffer.get())}},
+      {executable.get(), {Argument::StepOutput(0, 0)}},
+      {executable.get(), {Argument::StepOutput(1, 0)}},
+  };
+  ExecuteOptions options;
+  options.execution_mode = GetParam();
+  std::optional<PjRtFuture<>> future;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto results,
+      PjRtLoadedExecutable::ExecuteChain(steps, client->addressable_devices()[0],
+                                         options, future,
+                                         /*fill_future=*/true));
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_TRUE(future.has_value());
+  EXPECT_TRUE(future->Await().ok());
+  TF_ASSERT_OK_AND_ASSIGN(auto literal, results[0]->ToLiteralSync());
+
+  std::vector<int32_t> expected(4, 3);
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<int32_t>(expected),
+                                     *literal));
+}
+
+TEST_P(PjRtClientTest, ExecuteChainRejectsForwardReference) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetClient());
+  auto executable =
+      MakeIncrementProgram(client.get(), /*alias=*/false, /*device=*/0);
+
+  using Argument = PjRtLoadedExecutable::ChainArgument;
+  std::vector<PjRtLoadedExecutable::ChainStep> steps = {
+      {executable.get(), {Argument::StepOutput(0, 0)}},
+  };
+  std::optional<PjRtFuture<>> future;
+  EXPECT_FALSE(PjRtLoadedExecutable::ExecuteChain(
+                   steps, client->addressable_devices()[0], ExecuteOptions(),
+                   future, /*fill_future=*/false)
+                   .ok());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     PjRtClientTestSuite, PjRtClientTest,
     ::testing::Values(ExecuteOptions::ExecutionMode::kSynchronous,
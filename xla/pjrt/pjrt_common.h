@@ -37,6 +37,11 @@ TSL_LIB_GTL_DEFINE_INT_TYPE(PjRtGlobalDeviceId, int32_t);
 TSL_LIB_GTL_DEFINE_INT_TYPE(PjRtLocalDeviceId, int32_t);
 TSL_LIB_GTL_DEFINE_INT_TYPE(PjRtLocalHardwareId, int32_t);
 
+// Priority class of a device-to-host or device-to-device transfer. Clients
+// that support it run kHigh transfers on dedicated streams, so that they do
+// not queue up behind large transfers of default priority.
+enum class TransferPriority { kDefault = 0, kHigh };
+
 }  // namespace xla
 
 #endif  // XLA_PJRT_PJRT_COMMON_H_
@@ -182,6 +182,15 @@ absl::StatusOr<ExecuteOptionsProto> ExecuteOptions::ToProto() const {
   proto.mutable_non_donatable_input_indices()->Add(
       non_donatable_input_indices.begin(), non_donatable_input_indices.end());
 
+  switch (transfer_priority) {
+    case TransferPriority::kDefault:
+      proto.set_transfer_priority(TRANSFER_PRIORITY_DEFAULT);
+      break;
+    case TransferPriority::kHigh:
+      proto.set_transfer_priority(TRANSFER_PRIORITY_HIGH);
+      break;
+  }
+
   return proto;
 }
 
@@ -215,6 +224,18 @@ absl::StatusOr<ExecuteOptions> ExecuteOptions::FromProto(
       proto.non_donatable_input_indices().begin(),
       proto.non_donatable_input_indices().end());
 
+  switch (proto.transfer_priority()) {
+    case TRANSFER_PRIORITY_DEFAULT:
+      options.transfer_priority = TransferPriority::kDefault;
+      break;
+    case TRANSFER_PRIORITY_HIGH:
+      options.transfer_priority = TransferPriority::kHigh;
+      break;
+    default:
+      return absl::UnimplementedError(absl::StrCat(
+          "Unknown transfer priority: ", proto.transfer_priority()));
+  }
+
   return options;
 }
 
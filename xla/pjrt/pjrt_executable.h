@@ -261,6 +261,10 @@ struct ExecuteOptions {
   enum class ExecutionMode { kDefault = 0, kSynchronous, kAsynchronous };
   ExecutionMode execution_mode = ExecutionMode::kDefault;
 
+  // Priority class of the transfers an execution issues to the host, e.g. for
+  // outfeeds and host callbacks. Set to kHigh for latency-sensitive outputs.
+  TransferPriority transfer_priority = TransferPriority::kDefault;
+
   // A set of indices denoting the input buffers that should not be donated.
   // An input buffer may be non-donable, for example, if it is referenced more
   // than once. Since such runtime information is not available at compile time,
@@ -245,7 +245,7 @@ PjRtStreamExecutorClient::PjRtStreamExecutorClient(
       thread_pool_(
           tsl::Env::Default(), "pjrt_thread_pool",
           std::max<int>(DefaultThreadPoolSize(), client->device_count())),
-      transpose_cache_(1024) {
+      transpose_cache_(1024, /*num_shards=*/16) {
   if (owned_allocator_ != nullptr) {
     allocator_ = owned_allocator_.get();
   } else {
@@ -848,7 +848,6 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
     options.dims = dims;
     options.permutation = permutation;
     options.input_layout = TransposePlan::Striding{*byte_strides};
-    absl::MutexLock lock(&transpose_mu_);
     TF_ASSIGN_OR_RETURN(transpose, transpose_cache_.GetOrCreate(options));
   }
 
@@ -1638,12 +1637,16 @@ PjRtFuture<> PjRtStreamExecutorBuffer::LazyToLiteral(
 }
 
 PjRtFuture<> PjRtStreamExecutorBuffer::ToLiteral(MutableLiteralBase* literal) {
+  return ToLiteral(literal, TransferPriority::kDefault);
+}
+
+PjRtFuture<> PjRtStreamExecutorBuffer::ToLiteral(MutableLiteralBase* literal,
+                                                 TransferPriority priority) {
   VLOG(1) << "PjRtStreamExecutorBuffer::ToLiteral";
   if (IsEmptyTuple()) {
     return PjRtFuture<>(InvalidArgument("ToLiteral called on empty tuple"));
   }
   LocalDeviceState* local_device = device_->local_device_state();
-  se::Stream* stream = local_device->GetDeviceToHostStream();
   ScopedHold device_buffer(this, ScopedHold::kUsage);
   {
     absl::MutexLock lock(&mu_);
@@ -1655,6 +1658,12 @@ PjRtFuture<> PjRtStreamExecutorBuffer::ToLiteral(MutableLiteralBase* literal) {
     }
     AcquireHoldLocked(&device_buffer);
   }
+  int64_t transfer_size = 0;
+  for (const se::DeviceMemoryBase& memory : device_buffer->device_memory()) {
+    transfer_size += memory.size();
+  }
+  se::Stream* stream =
+      local_device->GetDeviceToHostStream(transfer_size, priority);
 
   auto promise = PjRtFuture<>::CreatePromise();
   auto usage_event =
@@ -1679,12 +1688,14 @@ PjRtFuture<> PjRtStreamExecutorBuffer::ToLiteral(MutableLiteralBase* literal) {
   device_buffer.ConvertUsageHold(stream, usage_event, /*reference_held=*/true);
 
   auto async_to_literal = [usage_event, tracked_device_buffer, stream,
+                           transfer_size,
                            transfer_manager = std::move(transfer_manager),
                            on_device_shape{on_device_shape_}, literal, promise,
                            local_device]() mutable {
     absl::StatusOr<EventPool::Handle> event_or =
         local_device->event_pool().AllocateEvent(stream->parent());
     if (!event_or.ok()) {
+      local_device->ReleaseTransferBytes(stream, transfer_size);
       promise.Set(event_or.status());
       return;
     }
@@ -1692,6 +1703,7 @@ PjRtFuture<> PjRtStreamExecutorBuffer::ToLiteral(MutableLiteralBase* literal) {
     absl::Status defined_status =
         tracked_device_buffer->definition_events()[0]->GetDefinedStatus();
     if (!defined_status.ok()) {
+      local_device->ReleaseTransferBytes(stream, transfer_size);
       promise.Set(defined_status);
       return;
     }
@@ -1711,7 +1723,9 @@ PjRtFuture<> PjRtStreamExecutorBuffer::ToLiteral(MutableLiteralBase* literal) {
 
     transfer_manager->TransferLiteralFromDevice(
         stream, shaped_buffer, literal,
-        [promise](absl::Status status) mutable {
+        [promise, local_device, stream,
+         transfer_size](absl::Status status) mutable {
+          local_device->ReleaseTransferBytes(stream, transfer_size);
           promise.Set(std::move(status));
         },
         transfer_metadata_ptr);
@@ -1795,7 +1809,7 @@ absl::StatusOr<std::pair<std::unique_ptr<PjRtBuffer>,
 PjRtStreamExecutorBuffer::CopyToDeviceHelper(
     PjRtDevice* dst_device, LocalDeviceState* dst_local_device,
     LocalDeviceState* transfer_local_device, LocalDeviceState* src_local_device,
-    se::Stream* transfer_stream,
+    se::Stream* transfer_stream, int64_t transfer_size,
     std::shared_ptr<TrackedDeviceBuffer> src_device_buffer) {
   TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtStreamExecutorBuffer> py_buffer,
                       AllocateDestinationBuffer(
@@ -1814,7 +1828,7 @@ PjRtStreamExecutorBuffer::CopyToDeviceHelper(
                                dst_device_buffer =
                                    std::move(dst_device_buffer.buffer()),
                                transfer_stream = std::move(transfer_stream),
-                               copy_event,
+                               transfer_size, copy_event,
                                on_device_shape{py_buffer->on_device_shape()},
                                src_local_device = std::move(src_local_device),
                                transfer_local_device =
@@ -1862,6 +1876,8 @@ PjRtStreamExecutorBuffer::CopyToDeviceHelper(
                 LOG(ERROR) << "ThenRelease failed due to: " << status;
               }
             }
+            transfer_local_device->ReleaseTransferBytes(transfer_stream,
+                                                        transfer_size);
             return;
           }
         }
@@ -1873,6 +1889,8 @@ PjRtStreamExecutorBuffer::CopyToDeviceHelper(
       if (!event_or.ok()) {
         StallStreamOnError(transfer_local_device, transfer_stream);
         LOG(ERROR) << event_or.status();
+        transfer_local_device->ReleaseTransferBytes(transfer_stream,
+                                                    transfer_size);
         return;
       }
       copy_event->SetSequencingEvent(std::move(event_or).value(),
@@ -1881,10 +1899,19 @@ PjRtStreamExecutorBuffer::CopyToDeviceHelper(
       copy_event->SetDefinedStatus(defined_status);
     }
 
-    auto status = src_local_device->ThenRelease(transfer_stream,
-                                                std::move(src_device_buffer));
+    // Releases the source buffer and the transfer bytes counted against
+    // `transfer_stream` once the copy has completed.
+    auto status = src_local_device->ThenExecuteCallback(
+        transfer_stream,
+        [src_device_buffer = std::move(src_device_buffer),
+         transfer_local_device, transfer_stream, transfer_size]() {
+          transfer_local_device->ReleaseTransferBytes(transfer_stream,
+                                                      transfer_size);
+        });
     if (!status.ok()) {
       LOG(ERROR) << "ThenRelease failed due to: " << status;
+      transfer_local_device->ReleaseTransferBytes(transfer_stream,
+                                                  transfer_size);
     }
   };
 
@@ -1905,6 +1932,12 @@ PjRtStreamExecutorBuffer::CopyToDeviceHelper(
 
 absl::StatusOr<std::unique_ptr<PjRtBuffer>>
 PjRtStreamExecutorBuffer::CopyToDevice(PjRtDevice* dst_device) {
+  return CopyToDevice(dst_device, TransferPriority::kDefault);
+}
+
+absl::StatusOr<std::unique_ptr<PjRtBuffer>>
+PjRtStreamExecutorBuffer::CopyToDevice(PjRtDevice* dst_device,
+                                       TransferPriority priority) {
   tsl::profiler::TraceMe traceme("PjRtStreamExecutorBuffer::CopyToDevice");
   VLOG(1) << "PjRtStreamExecutorBuffer::CopyToDevice";
   if (dst_device == device_) {
@@ -1939,9 +1972,6 @@ PjRtStreamExecutorBuffer::CopyToDevice(PjRtDevice* dst_device) {
   CHECK_EQ(dst_local_device->allocation_model(),
            transfer_local_device->allocation_model());
 
-  se::Stream* transfer_stream =
-      transfer_local_device->GetDeviceToDeviceStream();
-
   ScopedHold src_device_buffer(this, ScopedHold::kUsage);
   {
     absl::MutexLock lock(&mu_);
@@ -1953,14 +1983,23 @@ PjRtStreamExecutorBuffer::CopyToDevice(PjRtDevice* dst_device) {
     }
     AcquireHoldLocked(&src_device_buffer);
   }
+  int64_t transfer_size = 0;
+  for (const se::DeviceMemoryBase& memory :
+       src_device_buffer->device_memory()) {
+    transfer_size += memory.size();
+  }
+  se::Stream* transfer_stream =
+      transfer_local_device->GetDeviceToDeviceStream(transfer_size, priority);
 
   absl::StatusOr<std::pair<std::unique_ptr<PjRtBuffer>,
                            std::shared_ptr<BufferSequencingEvent>>>
       buffer_and_event_or = CopyToDeviceHelper(
           dst_device, dst_local_device, transfer_local_device,
-          device_->local_device_state(), transfer_stream,
+          device_->local_device_state(), transfer_stream, transfer_size,
           src_device_buffer.buffer());
   if (!buffer_and_event_or.ok()) {
+    transfer_local_device->ReleaseTransferBytes(transfer_stream,
+                                                transfer_size);
     return buffer_and_event_or.status();
   }
 
@@ -2232,21 +2271,30 @@ absl::StatusOr<TupleHandle> MakeTupleHelper(
 
 // Converts a ScopedShapedBuffer returned from an execution into a
 // PjRtBuffer.
+// Wraps an output of an execution in a PjRtBuffer, and records the execution
+// as a usage of the output on the compute stream.
 std::unique_ptr<PjRtBuffer> OutputBufferHelper(
     ScopedShapedBuffer* result_buffer,
-    std::shared_ptr<BufferSequencingEvent> definition_event, PjRtClient* client,
-    PjRtDevice* device, LocalDeviceState* local_device,
+    const std::shared_ptr<BufferSequencingEvent>& definition_event,
+    PjRtClient* client, PjRtDevice* device, PjRtMemorySpace* memory_space,
+    LocalDeviceState* local_device,
     std::vector<std::shared_ptr<TrackedDeviceBuffer>>& buffers_to_release) {
   std::shared_ptr<TrackedDeviceBuffer> out_buffer =
       TrackedDeviceBuffer::FromScopedShapedBuffer(result_buffer,
                                                   {definition_event});
-  auto pjrt_buffer = std::make_unique<PjRtStreamExecutorBuffer>(
+  // This is what RecordUsage() does with prefer_to_retain_reference=false, but
+  // the buffer is not shared yet, so the usage event is added directly instead
+  // of through a usage hold on the PjRtBuffer.
+  bool retain_buffer_until_completion =
+      local_device->allocation_model() == LocalDeviceState::kSynchronous;
+  if (retain_buffer_until_completion) {
+    buffers_to_release.push_back(out_buffer);
+  }
+  out_buffer->AddUsageEvent(local_device->compute_stream(), definition_event,
+                            retain_buffer_until_completion);
+  return std::make_unique<PjRtStreamExecutorBuffer>(
       result_buffer->on_device_shape(), std::move(out_buffer), client, device,
-      device->default_memory_space().value_or(nullptr));
-  RecordUsage(pjrt_buffer->GetBufferWithUsageHold(), local_device, local_device,
-              definition_event, local_device->compute_stream(),
-              /*prefer_to_retain_reference=*/false, &buffers_to_release);
-  return std::unique_ptr<PjRtBuffer>(std::move(pjrt_buffer));
+      memory_space);
 }
 
 bool IsAllZeros(const DeviceAssignment& assignment) {
@@ -2780,7 +2828,8 @@ PjRtStreamExecutorLoadedExecutable::EnqueueExecution(
   ExecutableRunOptions run_options;
   run_options.set_stream(device_state->compute_stream());
   run_options.set_host_to_device_stream(device_state->host_to_device_stream());
-  run_options.set_device_to_host_stream(device_state->GetDeviceToHostStream());
+  run_options.set_device_to_host_stream(device_state->GetDeviceToHostStream(
+      /*transfer_size=*/0, options.transfer_priority));
   run_options.set_allocator(client_->allocator());
   run_options.set_intra_op_thread_pool(
       client_->client()->backend().eigen_intra_op_thread_pool_device());
@@ -2873,16 +2922,21 @@ PjRtStreamExecutorLoadedExecutable::MakeOutputBuffers(
   tsl::profiler::TraceMe traceme("MakeOutputBuffers");
   std::vector<std::unique_ptr<PjRtBuffer>> outputs;
   LocalDeviceState* device_state = &(client_->device_state(device_ordinal));
+  PjRtMemorySpace* memory_space =
+      device->default_memory_space().value_or(nullptr);
   if (options.untuple_result && result_buffer.on_device_shape().IsTuple()) {
     int tuple_count = result_buffer.on_device_shape().tuple_shapes_size();
     outputs.reserve(tuple_count);
+    if (device_state->allocation_model() == LocalDeviceState::kSynchronous) {
+      buffers_to_release.reserve(buffers_to_release.size() + tuple_count);
+    }
     // Take ownership of each of the output values, leaving only the root table
     // in result_buffer.
     for (int i = 0; i < tuple_count; ++i) {
       ScopedShapedBuffer tuple_buffer = result_buffer.TakeSubTree({i});
       outputs.push_back(OutputBufferHelper(&tuple_buffer, definition_event,
-                                           client_, device, device_state,
-                                           buffers_to_release));
+                                           client_, device, memory_space,
+                                           device_state, buffers_to_release));
     }
     if (device_state->allocation_model() == LocalDeviceState::kSynchronous) {
       // Don't release the root buffer until after execution completes.
@@ -2895,8 +2949,8 @@ PjRtStreamExecutorLoadedExecutable::MakeOutputBuffers(
     }
   } else {
     outputs.push_back(OutputBufferHelper(&result_buffer, definition_event,
-                                         client_, device, device_state,
-                                         buffers_to_release));
+                                         client_, device, memory_space,
+                                         device_state, buffers_to_release));
   }
   return outputs;
 }
@@ -3337,6 +3391,27 @@ PjRtStreamExecutorClient::GetExecutableExtras(CompileOptions* options) {
   return extras;
 }
 
+PjRtStreamExecutorClient::~PjRtStreamExecutorClient() {
+  ShutdownAsyncCompiler();
+}
+
+void PjRtStreamExecutorClient::ShutdownAsyncCompiler() {
+  if (async_compiler_ != nullptr) {
+    async_compiler_->Shutdown();
+  }
+}
+
+PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>>
+PjRtStreamExecutorClient::CompileAsync(const XlaComputation& computation,
+                                       CompileOptions options,
+                                       PjRtCompilePriority priority) {
+  absl::call_once(async_compiler_once_, [this] {
+    async_compiler_ =
+        std::make_unique<PjRtAsyncCompiler>(this, kNumAsyncCompileThreads);
+  });
+  return async_compiler_->Compile(computation, std::move(options), priority);
+}
+
 absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
 PjRtStreamExecutorClient::Compile(const XlaComputation& computation,
                                   CompileOptions options) {
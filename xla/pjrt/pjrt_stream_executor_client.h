@@ -28,6 +28,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -48,6 +49,7 @@ limitations under the License.
 #include "xla/layout.h"
 #include "xla/literal.h"
 #include "xla/pjrt/local_device_state.h"
+#include "xla/pjrt/pjrt_async_compiler.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_common.h"
 #include "xla/pjrt/pjrt_compiler.h"
@@ -263,7 +265,7 @@ class PjRtStreamExecutorClient : public PjRtClient {
       std::unique_ptr<tsl::Allocator> host_memory_allocator,
       bool should_stage_host_to_device_transfers,
       std::unique_ptr<gpu::GpuExecutableRunOptions> gpu_run_options);
-  ~PjRtStreamExecutorClient() override = default;
+  ~PjRtStreamExecutorClient() override;
 
   int process_index() const override { return process_index_; }
 
@@ -312,6 +314,13 @@ class PjRtStreamExecutorClient : public PjRtClient {
   absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>> Compile(
       mlir::ModuleOp mlir_module, CompileOptions options) override;
 
+  // Compiles on a pool of kNumAsyncCompileThreads background threads, which
+  // is created on first use.
+  PjRtFuture<std::unique_ptr<PjRtLoadedExecutable>> CompileAsync(
+      const XlaComputation& computation, CompileOptions options,
+      PjRtCompilePriority priority) override;
+  static constexpr int kNumAsyncCompileThreads = 2;
+
   virtual absl::StatusOr<std::string> SerializeExecutable(
       const PjRtLoadedExecutable& executable) const;
 
@@ -436,6 +445,11 @@ class PjRtStreamExecutorClient : public PjRtClient {
  protected:
   friend class PjRtStreamExecutorBuffer;
 
+  // Cancels pending asynchronous compilations and waits for the running ones.
+  // Background compilations call the virtual Compile(), so subclasses that
+  // override it must call this at the start of their destructor.
+  void ShutdownAsyncCompiler();
+
   virtual absl::Status EnqueueCrossHostReceive(
       absl::Span<const std::unique_ptr<PjRtBuffer>> buffers,
       std::shared_ptr<BufferSequencingEvent> definition_event,
@@ -514,8 +528,11 @@ class PjRtStreamExecutorClient : public PjRtClient {
 
   tsl::thread::ThreadPool thread_pool_;
 
-  absl::Mutex transpose_mu_;
-  TransposePlanCache transpose_cache_ ABSL_GUARDED_BY(transpose_mu_);
+  TransposePlanCache transpose_cache_;
+
+  // Shut down by the destructors, see ShutdownAsyncCompiler().
+  absl::once_flag async_compiler_once_;
+  std::unique_ptr<PjRtAsyncCompiler> async_compiler_;
 };
 
 // Converts a 2D set of Device objects indexed by [replica][partition] into an
@@ -733,6 +750,9 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
 
   using PjRtBuffer::ToLiteralSync;
   PjRtFuture<> ToLiteral(MutableLiteralBase* literal) override;
+  // Like ToLiteral(), but copies on a stream chosen for `priority`.
+  PjRtFuture<> ToLiteral(MutableLiteralBase* literal,
+                         TransferPriority priority);
   PjRtFuture<> LazyToLiteral(
       absl::AnyInvocable<absl::StatusOr<MutableLiteralBase*>() &&> generator)
       override;
@@ -774,6 +794,9 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
 
   absl::StatusOr<std::unique_ptr<PjRtBuffer>> CopyToDevice(
       PjRtDevice* dst_device) override;
+  // Like CopyToDevice(), but copies on a stream chosen for `priority`.
+  absl::StatusOr<std::unique_ptr<PjRtBuffer>> CopyToDevice(
+      PjRtDevice* dst_device, TransferPriority priority);
 
   absl::StatusOr<std::unique_ptr<PjRtBuffer>> CopyToMemorySpace(
       PjRtMemorySpace* dst_memory_space) override;
@@ -856,7 +879,7 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
   CopyToDeviceHelper(PjRtDevice* dst_device, LocalDeviceState* dst_local_device,
                      LocalDeviceState* transfer_local_device,
                      LocalDeviceState* src_local_device,
-                     se::Stream* transfer_stream,
+                     se::Stream* transfer_stream, int64_t transfer_size,
                      std::shared_ptr<TrackedDeviceBuffer> src_device_buffer);
 
   PjRtStreamExecutorClient* const client_;
@@ -163,5 +163,26 @@ TEST(PjRtStreamExecutorClientTest, DonateWithControlDependency) {
   TF_ASSERT_OK(literal_comparison::Equal(literal, *result_literal));
 }
 
+TEST(PjRtStreamExecutorClientTest, DeviceToHostStreamsAreLoadAware) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetClient());
+  LocalDeviceState& device_state = client->device_state(0);
+
+  constexpr int64_t kLargeTransfer = 1 << 20;
+  se::Stream* busy = device_state.GetDeviceToHostStream(kLargeTransfer);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_NE(device_state.GetDeviceToHostStream(), busy);
+  }
+  EXPECT_NE(device_state.GetDeviceToHostStream(/*transfer_size=*/0,
+                                               TransferPriority::kHigh),
+            busy);
+
+  device_state.ReleaseTransferBytes(busy, kLargeTransfer);
+  bool reused = false;
+  for (int i = 0; i < 8; ++i) {
+    reused |= device_state.GetDeviceToHostStream() == busy;
+  }
+  EXPECT_TRUE(reused);
+}
+
 }  // namespace
 }  // namespace xla
@@ -0,0 +1,152 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/shape_bucketing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/client/xla_computation.h"
+#include "xla/literal.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/util.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+
+absl::StatusOr<Shape> GetBucketedShape(
+    const Shape& shape, absl::Span<const int64_t> dynamic_dimensions,
+    absl::Span<const int64_t> buckets) {
+  if (!shape.IsArray() || !shape.is_static()) {
+    return InvalidArgument("Expected a static array shape, got %s",
+                           ShapeUtil::HumanString(shape));
+  }
+  if (!std::is_sorted(buckets.begin(), buckets.end())) {
+    return InvalidArgument("Shape buckets must be sorted: [%s]",
+                           absl::StrJoin(buckets, ", "));
+  }
+  Shape bucketed = shape;
+  for (int64_t dim : dynamic_dimensions) {
+    if (dim < 0 || dim >= shape.rank()) {
+      return InvalidArgument("Dynamic dimension %d out of range for %s", dim,
+                             ShapeUtil::HumanString(shape));
+    }
+    auto bucket = std::lower_bound(buckets.begin(), buckets.end(),
+                                   shape.dimensions(dim));
+    if (bucket == buckets.end()) {
+      return InvalidArgument(
+          "Dimension %d of %s is larger than the largest shape bucket", dim,
+          ShapeUtil::HumanString(shape));
+    }
+    bucketed.set_dimensions(dim, *bucket);
+    bucketed.set_dynamic_dimension(dim, true);
+  }
+  return bucketed;
+}
+
+ShapeBucketedExecutable::ShapeBucketedExecutable(
+    PjRtClient* client, ShapeBucketingOptions options,
+    BuildComputationFn build_computation, CompileOptions compile_options)
+    : client_(client),
+      options_(std::move(options)),
+      build_computation_(std::move(build_computation)),
+      compile_options_(std::move(compile_options)) {}
+
+absl::StatusOr<PjRtLoadedExecutable*> ShapeBucketedExecutable::GetOrCompile(
+    absl::Span<const Shape> bucketed_shapes) {
+  std::vector<Shape> key(bucketed_shapes.begin(), bucketed_shapes.end());
+  // Compiling under the lock ensures that concurrent calls falling in the same
+  // buckets compile only once.
+  absl::MutexLock lock(&mu_);
+  auto it = executables_.find(key);
+  if (it != executables_.end()) {
+    return it->second.get();
+  }
+  VLOG(1) << "Compiling for shape bucket "
+          << absl::StrJoin(key, ", ", [](std::string* out, const Shape& s) {
+               absl::StrAppend(out, ShapeUtil::HumanString(s));
+             });
+  TF_ASSIGN_OR_RETURN(XlaComputation computation, build_computation_(key));
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> executable,
+                      client_->Compile(computation, compile_options_));
+  PjRtLoadedExecutable* result = executable.get();
+  executables_.emplace(std::move(key), std::move(executable));
+  return result;
+}
+
+absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+ShapeBucketedExecutable::Execute(absl::Span<const LiteralSlice> arguments,
+                                 PjRtDevice* device,
+                                 const ExecuteOptions& options) {
+  if (arguments.size() != options_.dynamic_dimensions.size()) {
+    return InvalidArgument("Expected %d arguments, got %d",
+                           options_.dynamic_dimensions.size(),
+                           arguments.size());
+  }
+  std::vector<Shape> bucketed_shapes;
+  std::vector<Literal> padded_arguments;
+  bucketed_shapes.reserve(arguments.size());
+  padded_arguments.reserve(arguments.size());
+  for (int i = 0; i < arguments.size(); ++i) {
+    TF_ASSIGN_OR_RETURN(
+        Shape bucketed_shape,
+        GetBucketedShape(arguments[i].shape(), options_.dynamic_dimensions[i],
+                         options_.buckets));
+    padded_arguments.push_back(
+        bucketed_shape.is_static()
+            ? arguments[i].Clone()
+            : arguments[i].ToBoundedDynamic(bucketed_shape));
+    bucketed_shapes.push_back(std::move(bucketed_shape));
+  }
+  TF_ASSIGN_OR_RETURN(PjRtLoadedExecutable * executable,
+                      GetOrCompile(bucketed_shapes));
+
+  std::vector<std::unique_ptr<PjRtBuffer>> buffers;
+  std::vector<PjRtBuffer*> argument_handles;
+  buffers.reserve(padded_arguments.size());
+  argument_handles.reserve(padded_arguments.size());
+  for (const Literal& argument : padded_arguments) {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtBuffer> buffer,
+                        client_->BufferFromHostLiteral(argument, device));
+    argument_handles.push_back(buffer.get());
+    buffers.push_back(std::move(buffer));
+  }
+  // The padded literals must outlive the transfers.
+  for (const std::unique_ptr<PjRtBuffer>& buffer : buffers) {
+    TF_RETURN_IF_ERROR(buffer->GetReadyFuture().Await());
+  }
+  return executable->ExecuteSharded(argument_handles, device, options);
+}
+
+int64_t ShapeBucketedExecutable::num_compilations() const {
+  absl::MutexLock lock(&mu_);
+  return executables_.size();
+}
+
+}  // namespace xla
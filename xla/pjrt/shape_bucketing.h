@@ -0,0 +1,103 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_SHAPE_BUCKETING_H_
+#define XLA_PJRT_SHAPE_BUCKETING_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/client/xla_computation.h"
+#include "xla/literal.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/shape.h"
+
+namespace xla {
+
+// Options for compiling a computation once per shape bucket instead of once
+// per distinct input shape.
+struct ShapeBucketingOptions {
+  // Sizes a dynamic dimension is padded up to, in increasing order. Sizes
+  // larger than the last bucket are rejected, which bounds the number of
+  // compilations.
+  std::vector<int64_t> buckets;
+
+  // For each parameter, the dimensions whose size varies between calls. Other
+  // dimensions must have the same size on every call.
+  std::vector<std::vector<int64_t>> dynamic_dimensions;
+};
+
+// Returns `shape` with each dimension in `dynamic_dimensions` rounded up to the
+// smallest bucket that holds it and marked as bounded dynamic. The bucket
+// becomes the bound of the dimension.
+absl::StatusOr<Shape> GetBucketedShape(
+    const Shape& shape, absl::Span<const int64_t> dynamic_dimensions,
+    absl::Span<const int64_t> buckets);
+
+// Compiles and runs a computation whose inputs vary in size, by padding the
+// inputs to shape buckets. One executable is compiled per combination of
+// buckets and reused for every call that falls in it, avoiding a recompilation
+// for each new input shape.
+//
+// The computation is built by `build_computation` for the bucketed parameter
+// shapes, which have bounded dynamic dimensions. The compiler's DynamicPadder
+// lowers these to static shapes carrying the runtime sizes, so the results of
+// an execution only contain the valid part of the padded inputs.
+class ShapeBucketedExecutable {
+ public:
+  using BuildComputationFn = std::function<absl::StatusOr<XlaComputation>(
+      absl::Span<const Shape> parameter_shapes)>;
+
+  ShapeBucketedExecutable(PjRtClient* client, ShapeBucketingOptions options,
+                          BuildComputationFn build_computation,
+                          CompileOptions compile_options = {});
+
+  // Pads `arguments` to their buckets and runs the executable compiled for
+  // them on `device`, compiling it first if this is the first call that falls
+  // in these buckets.
+  absl::StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>> Execute(
+      absl::Span<const LiteralSlice> arguments, PjRtDevice* device,
+      const ExecuteOptions& options = {});
+
+  // Returns the executable for the given bucketed parameter shapes, compiling
+  // it if needed.
+  absl::StatusOr<PjRtLoadedExecutable*> GetOrCompile(
+      absl::Span<const Shape> bucketed_shapes);
+
+  // Returns the number of executables compiled so far.
+  int64_t num_compilations() const;
+
+ private:
+  PjRtClient* client_;
+  ShapeBucketingOptions options_;
+  BuildComputationFn build_computation_;
+  CompileOptions compile_options_;
+
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<std::vector<Shape>, std::unique_ptr<PjRtLoadedExecutable>>
+      executables_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_SHAPE_BUCKETING_H_
@@ -0,0 +1,74 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/shape_bucketing.h"
+
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/test.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+TEST(ShapeBucketingTest, RoundsDynamicDimensionsUpToBucket) {
+  Shape shape = ShapeUtil::MakeShape(F32, {37, 16});
+  TF_ASSERT_OK_AND_ASSIGN(Shape bucketed,
+                          GetBucketedShape(shape, {0}, {32, 64, 128}));
+  EXPECT_EQ(bucketed, ShapeUtil::MakeShape(F32, {64, 16}, {true, false}));
+}
+
+TEST(ShapeBucketingTest, ExactBucketSize) {
+  Shape shape = ShapeUtil::MakeShape(F32, {32, 64});
+  TF_ASSERT_OK_AND_ASSIGN(Shape bucketed,
+                          GetBucketedShape(shape, {0, 1}, {32, 64, 128}));
+  EXPECT_EQ(bucketed, ShapeUtil::MakeShape(F32, {32, 64}, {true, true}));
+}
+
+TEST(ShapeBucketingTest, SameBucketForDifferentSizes) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      Shape a,
+      GetBucketedShape(ShapeUtil::MakeShape(S32, {65}), {0}, {64, 128}));
+  TF_ASSERT_OK_AND_ASSIGN(
+      Shape b,
+      GetBucketedShape(ShapeUtil::MakeShape(S32, {100}), {0}, {64, 128}));
+  EXPECT_EQ(a, b);
+}
+
+TEST(ShapeBucketingTest, StaticWithoutDynamicDimensions) {
+  Shape shape = ShapeUtil::MakeShape(F32, {37, 16});
+  TF_ASSERT_OK_AND_ASSIGN(Shape bucketed, GetBucketedShape(shape, {}, {64}));
+  EXPECT_EQ(bucketed, shape);
+  EXPECT_TRUE(bucketed.is_static());
+}
+
+TEST(ShapeBucketingTest, RejectsSizeLargerThanBuckets) {
+  EXPECT_FALSE(
+      GetBucketedShape(ShapeUtil::MakeShape(F32, {129}), {0}, {64, 128}).ok());
+}
+
+TEST(ShapeBucketingTest, RejectsInvalidDimension) {
+  EXPECT_FALSE(
+      GetBucketedShape(ShapeUtil::MakeShape(F32, {16}), {1}, {64}).ok());
+}
+
+TEST(ShapeBucketingTest, RejectsUnsortedBuckets) {
+  EXPECT_FALSE(
+      GetBucketedShape(ShapeUtil::MakeShape(F32, {16}), {0}, {64, 32}).ok());
+}
+
+}  // namespace
+}  // namespace xla
@@ -25,6 +25,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
@@ -162,8 +163,7 @@ TrackedDeviceBuffer::FromScopedShapedBuffer(
         definition_events) {
   ShapeTree<se::DeviceMemoryBase>::iterator iterator =
       shaped_buffer->buffers().begin();
-  std::vector<se::DeviceMemoryBase> buffers;
-  buffers.reserve(1);
+  absl::InlinedVector<se::DeviceMemoryBase, 1> buffers;
 
   ShapeUtil::ForEachSubshape(
       shaped_buffer->on_device_shape(), [&](const Shape&, const ShapeIndex&) {
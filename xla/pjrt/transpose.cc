@@ -85,18 +85,25 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/call_once.h"
+#include "absl/base/casts.h"
 #include "absl/base/optimization.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "xla/ef57.h"
 #include "xla/permutation_util.h"
+#include "xla/pjrt/metrics.h"
 #include "xla/pjrt/transpose_kernels.h"
+#include "xla/pjrt/transpose_kernels_avx2.h"
+#include "xla/types.h"
 #include "xla/util.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
@@ -138,6 +145,38 @@ struct TransposePlan::Node {
   bool is_inner_dim_in_b = false;
 };
 
+// Returns true if `transformation` converts every element from a wider input
+// type to the output type, without changing the layout.
+constexpr bool ConvertsElementType(
+    TransposePlan::Transformation transformation) {
+  return transformation == TransposePlan::Transformation::kF32ToBf16 ||
+         transformation == TransposePlan::Transformation::kF32ToF16;
+}
+
+// Copies `n` contiguous elements from `a` to `b`, applying `transformation`.
+// `T` is the output element type.
+template <typename T, TransposePlan::Transformation transformation>
+inline void CopyElements(const char* __restrict a, char* __restrict b,
+                         int64_t n) {
+  if constexpr (transformation == TransposePlan::Transformation::kNone) {
+    std::memcpy(b, a, n * sizeof(T));
+  } else if constexpr (ConvertsElementType(transformation)) {
+    static_assert(sizeof(T) == sizeof(uint16_t));
+    using Out = std::conditional_t<
+        transformation == TransposePlan::Transformation::kF32ToBf16, bfloat16,
+        half>;
+    for (int64_t i = 0; i < n; ++i) {
+      float x;
+      std::memcpy(&x, a + i * sizeof(float), sizeof(float));
+      T y = absl::bit_cast<T>(static_cast<Out>(x));
+      std::memcpy(b + i * sizeof(T), &y, sizeof(T));
+    }
+  } else {
+    LOG(FATAL) << "Transformation " << static_cast<int>(transformation)
+               << " cannot be applied to contiguous elements";
+  }
+}
+
 template <typename T, int inner_bs,
           TransposePlan::Transformation transformation>
 void MacroKernel(const char* __restrict a, int64_t lda, int outer_bs_a,
@@ -172,6 +211,17 @@ void MacroKernel(const char* __restrict a, int64_t lda, int outer_bs_a,
     }
     a = reinterpret_cast<const char*>(scratch);
     lda = outer_bs_a * inner_bs * sizeof(float);
+  } else if constexpr (ConvertsElementType(transformation)) {
+    // Converts the block into `scratch` first, then transposes the converted
+    // elements. The block is small enough to stay in L1.
+    char* p = reinterpret_cast<char*>(scratch);
+    const int64_t row_bytes = outer_bs_a * inner_bs * sizeof(T);
+    for (int i = 0; i < outer_bs_b * inner_bs; ++i) {
+      CopyElements<T, transformation>(a + lda * i, p + row_bytes * i,
+                                      outer_bs_a * inner_bs);
+    }
+    a = p;
+    lda = row_bytes;
   }
 
   for (int i = 0; i < outer_bs_a; ++i) {
@@ -183,13 +233,30 @@ void MacroKernel(const char* __restrict a, int64_t lda, int outer_bs_a,
   }
 }
 
+// Runs `macro_kernel` if there is one, which is then a faster variant of
+// MacroKernel<T, inner_bs, kNone> built for a wider instruction set.
+template <typename T, int inner_bs,
+          TransposePlan::Transformation transformation>
+inline void RunMacroKernel(const char* __restrict a, int64_t lda,
+                           int outer_bs_a, char* __restrict b, int64_t ldb,
+                           int outer_bs_b, void* __restrict scratch,
+                           TransposeMacroKernelFn macro_kernel) {
+  if (macro_kernel != nullptr) {
+    DCHECK(transformation == TransposePlan::Transformation::kNone);
+    macro_kernel(a, lda, outer_bs_a, b, ldb, outer_bs_b);
+  } else {
+    MacroKernel<T, inner_bs, transformation>(a, lda, outer_bs_a, b, ldb,
+                                             outer_bs_b, scratch);
+  }
+}
+
 // Transpose() is a driver function that implements a multidimensional loop nest
 // following by iterating over the linked Node data structure.
 template <typename T, int inner_bs,
           TransposePlan::Transformation transformation>
 void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
                int outer_bs_b, TransposePlan::Node const* __restrict node,
-               void* __restrict scratch) {
+               void* __restrict scratch, TransposeMacroKernelFn macro_kernel) {
   tsl::profiler::TraceMe traceme([&]() {
     return tsl::profiler::TraceMeEncode("Transpose",
                                         {{"inner_bs", inner_bs},
@@ -214,9 +281,9 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
     const int64_t ldb_block = next_node->ldb;
     int64_t i;
     for (i = start; i < stop; i += inc) {
-      MacroKernel<T, inner_bs, transformation>(a + i * lda, lda_block,
-                                               outer_bs_a, b + i * ldb,
-                                               ldb_block, outer_bs_b, scratch);
+      RunMacroKernel<T, inner_bs, transformation>(
+          a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
+          outer_bs_b, scratch, macro_kernel);
     }
     // Handle trailing elements that didn't fit in a complete macrokernel.
     // Only the innermost dimensions have non-trivial outer_bs blocking.
@@ -226,9 +293,9 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (node->is_inner_dim_in_a) {
         outer_bs_a = (end - i) / inner_bs;
         if (outer_bs_a > 0) {
-          MacroKernel<T, inner_bs, transformation>(
+          RunMacroKernel<T, inner_bs, transformation>(
               a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
-              outer_bs_b, scratch);
+              outer_bs_b, scratch, macro_kernel);
           i += outer_bs_a * inner_bs;
         }
         // If there are still trailing elements left over that don't fit in the
@@ -241,9 +308,9 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       } else if (node->is_inner_dim_in_b) {
         outer_bs_b = (end - i) / inner_bs;
         if (outer_bs_b > 0) {
-          MacroKernel<T, inner_bs, transformation>(
+          RunMacroKernel<T, inner_bs, transformation>(
               a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
-              outer_bs_b, scratch);
+              outer_bs_b, scratch, macro_kernel);
           i += outer_bs_b * inner_bs;
         }
         if (i < end) {
@@ -263,13 +330,13 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (trailing_next_node->inc < 0) {
         const int64_t lda_block = trailing_next_node->lda;
         const int64_t ldb_block = trailing_next_node->ldb;
-        MacroKernel<T, inner_bs, transformation>(
+        RunMacroKernel<T, inner_bs, transformation>(
             a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
-            outer_bs_b, scratch);
+            outer_bs_b, scratch, macro_kernel);
       } else {
-        Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                               b + i * ldb, outer_bs_b,
-                                               trailing_next_node, scratch);
+        Transpose<T, inner_bs, transformation>(
+            a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b,
+            trailing_next_node, scratch, macro_kernel);
       }
     }
   } else {
@@ -278,8 +345,9 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
     // but we call Transpose() recursively instead of MacroKernel().
     int64_t i;
     for (i = start; i < stop; i += inc) {
-      Transpose<T, inner_bs, transformation>(
-          a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b, next_node, scratch);
+      Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
+                                             b + i * ldb, outer_bs_b, next_node,
+                                             scratch, macro_kernel);
     }
     if (i < end) {
       DCHECK_EQ(node->trailing_tile_next_node_inc, 0);
@@ -287,28 +355,28 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (node->is_inner_dim_in_a) {
         outer_bs_a = (end - i) / inner_bs;
         if (outer_bs_a > 0) {
-          Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                                 b + i * ldb, outer_bs_b,
-                                                 next_node, scratch);
+          Transpose<T, inner_bs, transformation>(
+              a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b, next_node,
+              scratch, macro_kernel);
           i += outer_bs_a * inner_bs;
         }
         if (i < end) {
           Transpose<T, 1, transformation>(a + i * lda, end - i, b + i * ldb,
                                           outer_bs_b * inner_bs, next_node,
-                                          scratch);
+                                          scratch, nullptr);
         }
       } else if (node->is_inner_dim_in_b) {
         outer_bs_b = (end - i) / inner_bs;
         if (outer_bs_b > 0) {
-          Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                                 b + i * ldb, outer_bs_b,
-                                                 next_node, scratch);
+          Transpose<T, inner_bs, transformation>(
+              a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b, next_node,
+              scratch, macro_kernel);
           i += outer_bs_b * inner_bs;
         }
         if (i < end) {
           Transpose<T, 1, transformation>(a + i * lda, outer_bs_a * inner_bs,
                                           b + i * ldb, end - i, next_node,
-                                          scratch);
+                                          scratch, nullptr);
         }
       }
     } else if (node->trailing_tile_next_node_inc) {
@@ -317,43 +385,43 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (trailing_next_node->inc < 0) {
         const int64_t lda_block = trailing_next_node->lda;
         const int64_t ldb_block = trailing_next_node->ldb;
-        MacroKernel<T, inner_bs, transformation>(
+        RunMacroKernel<T, inner_bs, transformation>(
             a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
-            outer_bs_b, scratch);
+            outer_bs_b, scratch, macro_kernel);
       } else {
-        Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                               b + i * ldb, outer_bs_b,
-                                               trailing_next_node, scratch);
+        Transpose<T, inner_bs, transformation>(
+            a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b,
+            trailing_next_node, scratch, macro_kernel);
       }
     }
   }
 }
 
-template <typename T>
+template <typename T, TransposePlan::Transformation transformation>
 void TransposeConstStride1(const char* __restrict a, char* __restrict b,
                            TransposePlan::Node const* __restrict node) {
   a += node[0].start * node[0].lda;
   b += node[0].start * node[0].ldb;
   if (node[0].is_inner_dim_in_a) {
-    int64_t num_bytes = (node->end - node->start) * sizeof(T);
-    std::memcpy(b, a, num_bytes);
+    CopyElements<T, transformation>(a, b, node->end - node->start);
   } else if (node[1].is_inner_dim_in_a) {
     int64_t offset_a = node[1].start * node[1].lda;
     int64_t offset_b = node[1].start * node[1].ldb;
-    int64_t num_bytes = (node[1].end - node[1].start) * sizeof(T);
+    int64_t num_elems = node[1].end - node[1].start;
     a += offset_a;
     b += offset_b;
     for (int64_t i = node[0].start; i < node[0].end; ++i) {
-      std::memcpy(b, a, num_bytes);
+      CopyElements<T, transformation>(a, b, num_elems);
       a += node[0].lda;
       b += node[0].ldb;
     }
     if (node[0].trailing_tile_next_node_inc) {
-      TransposeConstStride1<T>(a - offset_a, b - offset_b,
-                               node + node[0].trailing_tile_next_node_inc);
+      TransposeConstStride1<T, transformation>(
+          a - offset_a, b - offset_b,
+          node + node[0].trailing_tile_next_node_inc);
     }
   } else if (node[2].is_inner_dim_in_a) {
-    int64_t num_bytes = (node[2].end - node[2].start) * sizeof(T);
+    int64_t num_elems = node[2].end - node[2].start;
     int64_t offset_a1 = node[1].start * node[1].lda;
     int64_t offset_b1 = node[1].start * node[1].ldb;
     int64_t offset_a2 = node[2].start * node[2].lda;
@@ -364,12 +432,12 @@ void TransposeConstStride1(const char* __restrict a, char* __restrict b,
       const char* a1 = a;
       char* b1 = b;
       for (int64_t j = node[1].start; j < node[1].end; ++j) {
-        std::memcpy(b1, a1, num_bytes);
+        CopyElements<T, transformation>(a1, b1, num_elems);
         a1 += node[1].lda;
         b1 += node[1].ldb;
       }
       if (node[1].trailing_tile_next_node_inc) {
-        TransposeConstStride1<T>(
+        TransposeConstStride1<T, transformation>(
             a1 - offset_a2, b1 - offset_b2,
             &node[1] + node[1].trailing_tile_next_node_inc);
       }
@@ -377,29 +445,29 @@ void TransposeConstStride1(const char* __restrict a, char* __restrict b,
       b += node[0].ldb;
     }
     if (node[0].trailing_tile_next_node_inc) {
-      TransposeConstStride1<T>(a - offset_a1 - offset_a2,
-                               b - offset_b1 - offset_b2,
-                               node + node[0].trailing_tile_next_node_inc);
+      TransposeConstStride1<T, transformation>(
+          a - offset_a1 - offset_a2, b - offset_b1 - offset_b2,
+          node + node[0].trailing_tile_next_node_inc);
     }
   } else {
     for (int64_t i = node[0].start; i < node[0].end; ++i) {
       const char* a1 = a + node[1].start * node[1].lda;
       char* b1 = b + node[1].start * node[1].ldb;
       for (int64_t j = node[1].start; j < node[1].end; ++j) {
-        TransposeConstStride1<T>(a1, b1, node + 2);
+        TransposeConstStride1<T, transformation>(a1, b1, node + 2);
         a1 += node[1].lda;
         b1 += node[1].ldb;
       }
       if (node[1].trailing_tile_next_node_inc) {
-        TransposeConstStride1<T>(
+        TransposeConstStride1<T, transformation>(
             a1, b1, &node[1] + node[1].trailing_tile_next_node_inc);
       }
       a += node[0].lda;
       b += node[0].ldb;
     }
     if (node[0].trailing_tile_next_node_inc) {
-      TransposeConstStride1<T>(a, b,
-                               node + node[0].trailing_tile_next_node_inc);
+      TransposeConstStride1<T, transformation>(
+          a, b, node + node[0].trailing_tile_next_node_inc);
     }
   }
 }
@@ -415,23 +483,24 @@ void TransposePlan::ExecuteTyped(const char* a, char* b,
   });
 
   if (inner_kernel_is_memcpy_) {
-    DCHECK(transformation_ == Transformation::kNone);
-    TransposeConstStride1<T>(a, b, nodes.data());
+    DCHECK(transformation_ != Transformation::kF64ToEf57);
+    TransposeConstStride1<T, transformation>(a, b, nodes.data());
   } else {
     std::unique_ptr<char[]> scratch;
     if (scratch_size_ > 0) {
       scratch.reset(new char[scratch_size_]);
     }
-    DCHECK_LE(sizeof(T) * inner_block_elems_, kMaxInnerBlockSizeBytes);
+    DCHECK(macro_kernel_ != nullptr ||
+           sizeof(T) * inner_block_elems_ <= kMaxInnerBlockSizeBytes);
     auto handle_inner_block_elems = [&](auto const_inner_block_elems) {
       if (nodes.size() > 1) {
         Transpose<T, const_inner_block_elems, transformation>(
             a, outer_block_elems_a_, b, outer_block_elems_b_, nodes.data(),
-            scratch.get());
+            scratch.get(), macro_kernel_);
       } else {
-        MacroKernel<T, const_inner_block_elems, transformation>(
+        RunMacroKernel<T, const_inner_block_elems, transformation>(
             a, nodes.back().lda, outer_block_elems_a_, b, nodes.back().ldb,
-            outer_block_elems_b_, scratch.get());
+            outer_block_elems_b_, scratch.get(), macro_kernel_);
       }
     };
     switch (inner_block_elems_) {
@@ -479,7 +548,14 @@ void TransposePlan::Execute(
         ExecuteTyped<uint8_t, Transformation::kNone>(ac, bc, nodes);
         break;
       case 2:
-        ExecuteTyped<uint16_t, Transformation::kNone>(ac, bc, nodes);
+        if (transformation_ == Transformation::kNone) {
+          ExecuteTyped<uint16_t, Transformation::kNone>(ac, bc, nodes);
+        } else if (transformation_ == Transformation::kF32ToBf16) {
+          ExecuteTyped<uint16_t, Transformation::kF32ToBf16>(ac, bc, nodes);
+        } else {
+          DCHECK(transformation_ == Transformation::kF32ToF16);
+          ExecuteTyped<uint16_t, Transformation::kF32ToF16>(ac, bc, nodes);
+        }
         break;
       case 4:
         if (transformation_ == Transformation::kNone) {
@@ -921,6 +997,9 @@ absl::StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
   auto plan = std::make_unique<TransposePlan>();
   plan->num_threads_requested_ = o.num_threads;
   plan->elem_size_in_bytes_ = o.elem_size_in_bytes;
+  plan->input_elem_size_in_bytes_ =
+      ConvertsElementType(o.transformation) ? sizeof(float)
+                                            : o.elem_size_in_bytes;
   switch (o.elem_size_in_bytes) {
     case 1:
     case 2:
@@ -962,7 +1041,7 @@ absl::StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
       int64_t stride = input_strides_in_bytes.at(k);
       // If there is a dimension with size equal to the element size, sort it
       // last. This ensures that we place any stride-1 dimension last.
-      bool is_stride1 = stride == o.elem_size_in_bytes;
+      bool is_stride1 = stride == plan->input_elem_size_in_bytes_;
       // If there are multiple stride-1 dimensions, we'd prefer the one that
       // matches the stride-1 dimension of the output.
       // Failing that, we'd just prefer the largest stride-1 dimension last.
@@ -999,8 +1078,8 @@ absl::StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
     plan->a_dims_ = plan->original_a_dims_;
     plan->permutation_.resize(ndim);
     absl::c_copy(o.permutation, plan->permutation_.begin());
-    ComputeStrides(plan->elem_size_in_bytes_, plan->a_dims_, plan->a_tiling_,
-                   plan->lda_, plan->lda_tile_);
+    ComputeStrides(plan->input_elem_size_in_bytes_, plan->a_dims_,
+                   plan->a_tiling_, plan->lda_, plan->lda_tile_);
   }
 
   auto is_not_one = [](int64_t x) { return x != 1; };
@@ -1033,6 +1112,16 @@ absl::StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
             "multiple of 2",
             sizeof(float));
       }
+      break;
+    case Transformation::kF32ToBf16:
+    case Transformation::kF32ToF16:
+      if (o.elem_size_in_bytes != sizeof(uint16_t)) {
+        return InvalidArgument(
+            "Conversion from F32 requires an output element size of %d bytes, "
+            "got %d",
+            sizeof(uint16_t), o.elem_size_in_bytes);
+      }
+      break;
   }
 
   plan->Initialize();
@@ -1065,12 +1154,12 @@ void TransposePlan::Initialize() {
   // If the plan is 0-dimensional, or the innermost dimension of A is not of
   // stride 1, adds a trivial size 1 dimension. The transpose kernels rely on
   // the presence of a stride-1 innermost dimension in the input.
-  if (lda_.empty() || stride_pos1a != elem_size_in_bytes_) {
+  if (lda_.empty() || stride_pos1a != input_elem_size_in_bytes_) {
     int dim = static_cast<int>(a_dims_.size());
     permutation_.push_back(dim);
     inverse_permutation.push_back(dim);
     a_dims_.push_back(1);
-    lda_.push_back(elem_size_in_bytes_);
+    lda_.push_back(input_elem_size_in_bytes_);
     lda_tile_.push_back(1);
     a_tiling_.push_back(1);
     b_tiling_.push_back(1);
@@ -1115,6 +1204,15 @@ void TransposePlan::Initialize() {
     outer_block_elems_a_ = -1;
     outer_block_elems_b_ = -1;
   } else {
+    // Binaries built for a baseline x86-64 target can still use the wider
+    // AVX2 kernels if the host supports them. They don't fuse transformations.
+    bool use_avx2_kernels =
+        transformation_ == Transformation::kNone && HasAvx2TransposeKernels();
+    const int max_inner_block_size_bytes =
+        use_avx2_kernels
+            ? std::max(kMaxInnerBlockSizeBytes, kAvx2MaxInnerBlockSizeBytes)
+            : kMaxInnerBlockSizeBytes;
+
     // What are the smallest and largest block sizes for which we have a
     // vectorized kernel for this element size?
     int min_inner_block_elems;
@@ -1125,8 +1223,9 @@ void TransposePlan::Initialize() {
       case 4:
       case 8:
         min_inner_block_elems = 1;
-        max_inner_block_elems = std::min<int>(
-            kMaxOuterBlockElems, kMaxInnerBlockSizeBytes / elem_size_in_bytes_);
+        max_inner_block_elems =
+            std::min<int>(kMaxOuterBlockElems,
+                          max_inner_block_size_bytes / elem_size_in_bytes_);
         break;
       case 16:
         min_inner_block_elems = 1;
@@ -1144,6 +1243,10 @@ void TransposePlan::Initialize() {
       // path.
       inner_block_elems_ = 1;
     }
+    if (use_avx2_kernels) {
+      macro_kernel_ = GetAvx2TransposeMacroKernel(elem_size_in_bytes_,
+                                                  inner_block_elems_);
+    }
     outer_block_elems_a_ = FloorOfRatio<int64_t>(
         std::min<int64_t>(kMaxOuterBlockElems, a_stride1_size),
         inner_block_elems_);
@@ -1217,6 +1320,15 @@ void TransposePlan::Initialize() {
                       outer_block_elems_a_ * outer_block_elems_b_;
       DCHECK(!inner_kernel_is_memcpy_);
       break;
+    case Transformation::kF32ToBf16:
+    case Transformation::kF32ToF16:
+      // The memcpy kernel converts in place and needs no scratch space.
+      scratch_size_ = inner_kernel_is_memcpy_
+                          ? 0
+                          : elem_size_in_bytes_ * inner_block_elems_ *
+                                inner_block_elems_ * outer_block_elems_a_ *
+                                outer_block_elems_b_;
+      break;
   }
 }
 
@@ -1318,6 +1430,12 @@ std::string TransposePlan::ToString() const {
     case Transformation::kF64ToEf57:
       transformation_str = "ef57";
       break;
+    case Transformation::kF32ToBf16:
+      transformation_str = "f32_to_bf16";
+      break;
+    case Transformation::kF32ToF16:
+      transformation_str = "f32_to_f16";
+      break;
   }
   return absl::StrFormat(
       "elem_size=%d a_dims=%s b_dims=%s permutation=%s a_tiling=%s b_tiling=%s "
@@ -1356,8 +1474,14 @@ H AbslHashValue(H h, const TransposePlanCacheKey& key) {
                     key.input_layout, key.output_tiling);
 }
 
-TransposePlanCache::TransposePlanCache(int capacity)
-    : lru_list_(capacity), cache_(&lru_list_) {}
+TransposePlanCache::TransposePlanCache(int capacity, int num_shards) {
+  num_shards = std::clamp(num_shards, 1, std::max(capacity, 1));
+  int shard_capacity = CeilOfRatio(capacity, num_shards);
+  shards_.reserve(num_shards);
+  for (int i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(shard_capacity));
+  }
+}
 
 TransposePlanCache::~TransposePlanCache() = default;
 
@@ -1386,14 +1510,35 @@ absl::StatusOr<std::shared_ptr<TransposePlan>> TransposePlanCache::GetOrCreate(
   absl::c_copy(o.output_tiling.tiling, key.output_tiling.begin());
   key.transformation = o.transformation;
   key.num_threads = o.num_threads;
-  return cache_.GetOrCreateIfAbsent(
-      key,
-      [&](const TransposePlanCacheKey& key)
-          -> absl::StatusOr<std::shared_ptr<TransposePlan>> {
-        TF_ASSIGN_OR_RETURN(std::unique_ptr<TransposePlan> plan,
-                            TransposePlan::Create(o));
-        return std::shared_ptr<TransposePlan>(std::move(plan));
-      });
+
+  // Salt the shard hash so that the keys of a shard do not share the low bits
+  // of the hash used by the shard's own hash table.
+  Shard& shard = *shards_[absl::HashOf(key, shards_.size()) % shards_.size()];
+  bool hit = true;
+  std::shared_ptr<Entry> entry;
+  {
+    absl::MutexLock lock(&shard.mu);
+    entry = shard.cache.GetOrCreateIfAbsent(
+        key, [&](const TransposePlanCacheKey& key) {
+          hit = false;
+          return std::make_shared<Entry>();
+        });
+  }
+  metrics::RecordTransposePlanCacheLookup(hit);
+
+  // Threads that look up a plan while it is being built wait for it here
+  // instead of building it again. A plan evicted in the meantime stays alive
+  // for as long as `entry` does.
+  absl::call_once(entry->once, [&] {
+    absl::StatusOr<std::unique_ptr<TransposePlan>> plan =
+        TransposePlan::Create(o);
+    if (plan.ok()) {
+      entry->plan = std::shared_ptr<TransposePlan>(*std::move(plan));
+    } else {
+      entry->plan = plan.status();
+    }
+  });
+  return entry->plan;
 }
 
 }  // namespace xla
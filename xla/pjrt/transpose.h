@@ -34,11 +34,15 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/base/call_once.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "xla/pjrt/lru_cache.h"
+#include "xla/pjrt/transpose_kernels_avx2.h"
 
 namespace xla {
 
@@ -86,6 +90,12 @@ class TransposePlan {
     // Convert doubles into the ef57 extended precision pair-of-floats
     // representation used on TPU.
     kF64ToEf57 = 1,
+
+    // Convert F32 input elements to BF16 or F16 while transposing, rounding to
+    // nearest even. `elem_size_in_bytes` is the size of the output elements
+    // (2), and input strides are in bytes of the F32 input.
+    kF32ToBf16 = 2,
+    kF32ToF16 = 3,
   };
 
   struct Options {
@@ -176,6 +186,10 @@ class TransposePlan {
   // Size of each element in bytes.
   int64_t elem_size_in_bytes_;
 
+  // Size of each input element in bytes. Differs from `elem_size_in_bytes_` if
+  // the transformation converts the element type.
+  int64_t input_elem_size_in_bytes_;
+
   // Number of elements in the input array.
   int64_t num_elems_;
 
@@ -235,6 +249,11 @@ class TransposePlan {
   int outer_block_elems_a_ = 4;
   int outer_block_elems_b_ = 4;
 
+  // If not null, a macrokernel for the inner block size that was compiled for
+  // a wider instruction set than the rest of this file, and is supported by the
+  // host. Selected when the plan is created.
+  TransposeMacroKernelFn macro_kernel_ = nullptr;
+
   // Transformations to apply to the input before transposition.
   // Currently the only supported transformation is EF57 conversion, which is
   // a pair-of-floats extended precision representation used on TPU. We
@@ -267,13 +286,18 @@ struct TransposePlanCacheKey {
 template <typename H>
 H AbslHashValue(H h, const TransposePlanCacheKey& key);
 
-// An LRU cache for transpose plans. Not thread-safe.
+// An LRU cache for transpose plans. Thread-safe.
 // Transpose plans aren't cheap to build, but once computed for a particular set
 // of inputs can be cached and reused for arrays. TransposePlanCache implements
 // such a cache.
+//
+// The cache is split into `num_shards` shards, each with its own lock and an
+// equal share of `capacity`, so that concurrent lookups of different plans
+// rarely contend. Plans are built outside of the shard lock, and exactly once
+// even if several threads ask for the same plan concurrently.
 class TransposePlanCache {
  public:
-  explicit TransposePlanCache(int capacity);
+  explicit TransposePlanCache(int capacity, int num_shards = 1);
   ~TransposePlanCache();
 
   TransposePlanCache(const TransposePlanCache&) = delete;
@@ -286,11 +310,23 @@ class TransposePlanCache {
       const TransposePlan::Options& options);
 
  private:
-  LRUCache<TransposePlanCacheKey,
-           absl::StatusOr<std::shared_ptr<TransposePlan>>>::LRUList lru_list_;
-  LRUCache<TransposePlanCacheKey,
-           absl::StatusOr<std::shared_ptr<TransposePlan>>>
-      cache_;
+  // A plan built by the first thread that needs it.
+  struct Entry {
+    absl::once_flag once;
+    absl::StatusOr<std::shared_ptr<TransposePlan>> plan;
+  };
+
+  struct Shard {
+    explicit Shard(int capacity) : lru_list(capacity), cache(&lru_list) {}
+
+    absl::Mutex mu;
+    LRUCache<TransposePlanCacheKey, std::shared_ptr<Entry>>::LRUList lru_list
+        ABSL_GUARDED_BY(mu);
+    LRUCache<TransposePlanCacheKey, std::shared_ptr<Entry>> cache
+        ABSL_GUARDED_BY(mu);
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 }  // namespace xla
@@ -24,8 +24,6 @@ limitations under the License.
 
 #include "xla/compiler_macros.h"
 
-namespace xla {
-
 #ifdef XLA_HAS_SSE2
 #include <immintrin.h>  // IWYU pragma: keep
 #endif
@@ -34,10 +32,26 @@ namespace xla {
 #include <arm_neon.h>
 #endif  // XLA_HAS_ARM_NEON
 
+namespace xla {
+
 #if defined(XLA_HAS_SSE2) || defined(XLA_HAS_ARM_NEON)
 #define XLA_HAS_VEC128
 #endif  // defined(XLA_HAS_SSE2) || defined(XLA_HAS_ARM_NEON)
 
+// The kernels below differ depending on the instruction set extensions the
+// including translation unit is compiled for. Each variant lives in its own
+// inline namespace so that translation units built for a wider target, such as
+// transpose_kernels_avx2.cc, do not violate the one definition rule.
+#if defined(__AVX2__)
+#define XLA_TRANSPOSE_KERNELS_NAMESPACE kernels_avx2
+#elif defined(__AVX__)
+#define XLA_TRANSPOSE_KERNELS_NAMESPACE kernels_avx
+#else
+#define XLA_TRANSPOSE_KERNELS_NAMESPACE kernels_baseline
+#endif
+
+inline namespace XLA_TRANSPOSE_KERNELS_NAMESPACE {
+
 // The transpose microkernels use a general approach of zipping elements from
 // different rows together. We start zipping together elements of size 1, size 2
 // and so-on until we have achieved our transpose. As we increase the number of
@@ -691,6 +705,9 @@ struct TransposeMicroKernel {
   }
 };
 
+}  // namespace XLA_TRANSPOSE_KERNELS_NAMESPACE
 }  // namespace xla
 
+#undef XLA_TRANSPOSE_KERNELS_NAMESPACE
+
 #endif  // XLA_PJRT_TRANSPOSE_KERNELS_H_
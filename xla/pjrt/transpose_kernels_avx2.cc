@@ -0,0 +1,103 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// This file is compiled with AVX2 enabled, so that binaries built for a
+// baseline x86-64 target can still use the 256-bit transpose kernels on hosts
+// that support them. Nothing in here may run before HasAvx2TransposeKernels()
+// has checked the host CPU.
+
+#include "xla/pjrt/transpose_kernels_avx2.h"
+
+#include <cstdint>
+
+#include "xla/pjrt/transpose_kernels.h"
+#include "tsl/platform/cpu_info.h"
+
+namespace xla {
+
+#ifdef __AVX2__
+namespace {
+
+template <typename T, int inner_bs>
+void Avx2MacroKernel(const char* __restrict a, int64_t lda, int outer_bs_a,
+                     char* __restrict b, int64_t ldb, int outer_bs_b) {
+  for (int i = 0; i < outer_bs_a; ++i) {
+    for (int j = 0; j < outer_bs_b; ++j) {
+      TransposeMicroKernel<T, inner_bs>::Apply(
+          a + inner_bs * j * lda + i * inner_bs * sizeof(T), lda,
+          b + inner_bs * i * ldb + j * inner_bs * sizeof(T), ldb);
+    }
+  }
+}
+
+template <typename T>
+TransposeMacroKernelFn GetMacroKernel(int inner_bs) {
+  constexpr int kMaxInnerBs = kAvx2MaxInnerBlockSizeBytes / sizeof(T);
+  switch (inner_bs) {
+    case 2:
+      return &Avx2MacroKernel<T, 2>;
+    case 4:
+      return &Avx2MacroKernel<T, 4>;
+    case 8:
+      if constexpr (kMaxInnerBs >= 8) {
+        return &Avx2MacroKernel<T, 8>;
+      }
+      return nullptr;
+    case 16:
+      if constexpr (kMaxInnerBs >= 16) {
+        return &Avx2MacroKernel<T, 16>;
+      }
+      return nullptr;
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+bool HasAvx2TransposeKernels() {
+  static const bool has_avx2 =
+      tsl::port::TestCPUFeature(tsl::port::CPUFeature::AVX2);
+  return has_avx2;
+}
+
+TransposeMacroKernelFn GetAvx2TransposeMacroKernel(int64_t elem_size_in_bytes,
+                                                   int inner_bs) {
+  switch (elem_size_in_bytes) {
+    case 1:
+      return GetMacroKernel<uint8_t>(inner_bs);
+    case 2:
+      return GetMacroKernel<uint16_t>(inner_bs);
+    case 4:
+      return GetMacroKernel<uint32_t>(inner_bs);
+    case 8:
+      return GetMacroKernel<uint64_t>(inner_bs);
+    default:
+      return nullptr;
+  }
+}
+
+#else  // __AVX2__
+
+bool HasAvx2TransposeKernels() { return false; }
+
+TransposeMacroKernelFn GetAvx2TransposeMacroKernel(int64_t elem_size_in_bytes,
+                                                   int inner_bs) {
+  return nullptr;
+}
+
+#endif  // __AVX2__
+
+}  // namespace xla
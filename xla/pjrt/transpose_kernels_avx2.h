@@ -0,0 +1,44 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_TRANSPOSE_KERNELS_AVX2_H_
+#define XLA_PJRT_TRANSPOSE_KERNELS_AVX2_H_
+
+#include <cstdint>
+
+namespace xla {
+
+// Transposes `outer_bs_a` x `outer_bs_b` inner blocks, each a square of
+// `inner_bs` x `inner_bs` elements. `lda` and `ldb` are strides in bytes.
+using TransposeMacroKernelFn = void (*)(const char* __restrict a, int64_t lda,
+                                        int outer_bs_a, char* __restrict b,
+                                        int64_t ldb, int outer_bs_b);
+
+// Largest inner block, in bytes, for which there is an AVX2 kernel.
+inline constexpr int kAvx2MaxInnerBlockSizeBytes = 32;
+
+// Returns true if this binary contains the AVX2 transpose kernels and the host
+// CPU supports AVX2.
+bool HasAvx2TransposeKernels();
+
+// Returns the AVX2 macrokernel for elements of `elem_size_in_bytes` bytes and
+// square inner blocks of `inner_bs` elements, or nullptr if there is none. Only
+// valid if HasAvx2TransposeKernels() is true.
+TransposeMacroKernelFn GetAvx2TransposeMacroKernel(int64_t elem_size_in_bytes,
+                                                   int inner_bs);
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_TRANSPOSE_KERNELS_AVX2_H_
@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <ostream>
 #include <string>
@@ -31,8 +32,10 @@ limitations under the License.
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "xla/array.h"
 #include "xla/permutation_util.h"
+#include "xla/pjrt/transpose_kernels_avx2.h"
 #include "xla/shape_util.h"
 #include "xla/test.h"
+#include "xla/types.h"
 #include "xla/util.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test_benchmark.h"
@@ -398,6 +401,40 @@ class TransposeTest : public ::testing::TestWithParam<TransposeTestCase> {
 
     EXPECT_EQ(expected_tiled_output, output);
   }
+
+  // Transposes an F32 array while converting it to `Out`.
+  template <typename Out>
+  void TestConvertingTranspose(TransposePlan::Transformation transformation) {
+    const TransposeTestCase test = GetParam();
+    std::vector<int64_t> output_dims = Permute(test.dims, test.permutation);
+    TransposePlan::Options options;
+    options.elem_size_in_bytes = sizeof(Out);
+    options.dims = test.dims;
+    options.permutation = test.permutation;
+    options.input_layout = TransposePlan::Tiling{test.input_tiling};
+    options.output_tiling = TransposePlan::Tiling{test.output_tiling};
+    options.transformation = transformation;
+    TF_ASSERT_OK_AND_ASSIGN(auto plan, TransposePlan::Create(options));
+    VLOG(1) << plan->ToString();
+    xla::Array<float> untiled_input(test.dims);
+    untiled_input.FillIota(0.5f);
+    xla::Array<float> expected_untiled_output(output_dims);
+    TransposeUsingEigen(untiled_input.data(), expected_untiled_output.data(),
+                        test.dims, output_dims, test.permutation);
+
+    auto tiled_input = TileArray(untiled_input, test.input_tiling);
+    std::vector<float> expected_tiled_output =
+        TileArray(expected_untiled_output, test.output_tiling);
+    std::vector<Out> expected(expected_tiled_output.begin(),
+                              expected_tiled_output.end());
+
+    std::vector<Out> output(
+        SizeOfTiledArray(plan->OutputDims(), test.output_tiling),
+        static_cast<Out>(-1));
+    plan->Execute(tiled_input.data(), output.data());
+
+    EXPECT_EQ(expected, output);
+  }
 };
 
 TEST_P(TransposeTest, TransposeInt8) { TestTranspose<int8_t>(1); }
@@ -409,6 +446,14 @@ TEST_P(TransposeTest, TransposeInt128) { TestTranspose<absl::int128>(1); }
 TEST_P(TransposeTest, ParallelTransposeInt8) { TestTranspose<int8_t>(16); }
 TEST_P(TransposeTest, ParallelTransposeInt32) { TestTranspose<int32_t>(16); }
 
+TEST_P(TransposeTest, TransposeF32ToBf16) {
+  TestConvertingTranspose<bfloat16>(
+      TransposePlan::Transformation::kF32ToBf16);
+}
+TEST_P(TransposeTest, TransposeF32ToF16) {
+  TestConvertingTranspose<half>(TransposePlan::Transformation::kF32ToF16);
+}
+
 INSTANTIATE_TEST_SUITE_P(TransposeTestInstance, TransposeTest,
                          ::testing::ValuesIn(GetTransposeTestCases()));
 
@@ -582,6 +627,41 @@ static void* benchmarks = []() {
   return nullptr;
 }();
 
+template <typename T>
+void TestAvx2MacroKernel(int inner_bs) {
+  constexpr int kOuterBs = 2;
+  const int n = inner_bs * kOuterBs;
+  TransposeMacroKernelFn kernel =
+      GetAvx2TransposeMacroKernel(sizeof(T), inner_bs);
+  ASSERT_NE(kernel, nullptr) << sizeof(T) << " " << inner_bs;
+  std::vector<T> a(n * n);
+  std::iota(a.begin(), a.end(), 0);
+  std::vector<T> b(n * n);
+  kernel(reinterpret_cast<const char*>(a.data()), n * sizeof(T), kOuterBs,
+         reinterpret_cast<char*>(b.data()), n * sizeof(T), kOuterBs);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      ASSERT_EQ(b[i * n + j], a[j * n + i]) << i << " " << j;
+    }
+  }
+}
+
+TEST(TransposeTest, Avx2MacroKernels) {
+  if (!HasAvx2TransposeKernels()) {
+    GTEST_SKIP() << "AVX2 transpose kernels are not available";
+  }
+  for (int inner_bs : {2, 4, 8, 16}) {
+    TestAvx2MacroKernel<uint8_t>(inner_bs);
+    TestAvx2MacroKernel<uint16_t>(inner_bs);
+  }
+  for (int inner_bs : {2, 4, 8}) {
+    TestAvx2MacroKernel<uint32_t>(inner_bs);
+  }
+  for (int inner_bs : {2, 4}) {
+    TestAvx2MacroKernel<uint64_t>(inner_bs);
+  }
+}
+
 TEST(TransposePlanCache, Basics) {
   std::vector<int64_t> dims = {1, 2, 3};
   std::vector<int64_t> permutation_210 = {2, 1, 0};
@@ -611,4 +691,38 @@ TEST(TransposePlanCache, Basics) {
   EXPECT_TRUE(p1.get() != p1b.get());
 }
 
+TEST(TransposePlanCache, ConcurrentLookups) {
+  constexpr int kNumPlans = 8;
+  std::vector<std::vector<int64_t>> dims(kNumPlans);
+  for (int i = 0; i < kNumPlans; ++i) {
+    dims[i] = {i + 1, 3, 5};
+  }
+  std::vector<int64_t> permutation = {2, 0, 1};
+  TransposePlanCache cache(/*capacity=*/64, /*num_shards=*/4);
+
+  constexpr int kNumLookups = 64;
+  std::vector<std::shared_ptr<TransposePlan>> plans(kNumLookups);
+  {
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "Transpose", 8);
+    for (int i = 0; i < kNumLookups; ++i) {
+      pool.Schedule([&, i] {
+        TransposePlan::Options o;
+        o.elem_size_in_bytes = 4;
+        o.dims = dims[i % kNumPlans];
+        o.permutation = permutation;
+        auto plan = cache.GetOrCreate(o);
+        ASSERT_TRUE(plan.ok());
+        plans[i] = *std::move(plan);
+      });
+    }
+  }
+  // Each plan is built once and shared by all lookups of its key.
+  for (int i = kNumPlans; i < kNumLookups; ++i) {
+    EXPECT_EQ(plans[i].get(), plans[i % kNumPlans].get());
+  }
+  for (int i = 1; i < kNumPlans; ++i) {
+    EXPECT_NE(plans[i].get(), plans[0].get());
+  }
+}
+
 }  // namespace xla
@@ -15,43 +15,160 @@ limitations under the License.
 
 #include "xla/pjrt/worker_thread.h"
 
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/log/check.h"
+#include "absl/synchronization/mutex.h"
+#include "tsl/platform/env.h"
+
 namespace xla {
 
-WorkerThread::WorkerThread(tsl::Env* env, const std::string& name) {
+static_assert((WorkerThread::kRingSize & (WorkerThread::kRingSize - 1)) == 0,
+              "kRingSize must be a power of two");
+
+// Number of times the worker polls for new work before parking.
+static constexpr int kSpinIterations = 2000;
+
+static inline void CpuRelax() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+WorkerThread::WorkerThread(tsl::Env* env, const std::string& name)
+    : ring_(std::make_unique<Slot[]>(kRingSize)) {
+  for (size_t i = 0; i < kRingSize; ++i) {
+    ring_[i].sequence.store(i, std::memory_order_relaxed);
+  }
   thread_.reset(
       env->StartThread(tsl::ThreadOptions(), name, [this]() { WorkLoop(); }));
 }
 
-WorkerThread::~WorkerThread() {
+WorkerThread::~WorkerThread() { Push(nullptr); }
+
+void WorkerThread::Schedule(Task fn) {
+  CHECK(fn != nullptr);
+  Push(std::move(fn));
+}
+
+void WorkerThread::Push(Task fn) {
+  if (overflow_size_.load(std::memory_order_acquire) == 0 && TryPushRing(fn)) {
+    MaybeWakeWorker();
+    return;
+  }
   absl::MutexLock lock(&mu_);
-  work_queue_.push(nullptr);
+  overflow_.push_back(std::move(fn));
+  overflow_size_.store(overflow_.size(), std::memory_order_release);
+  cv_.Signal();
 }
 
-void WorkerThread::Schedule(std::function<void()> fn) {
-  CHECK(fn != nullptr);
+bool WorkerThread::TryPushRing(Task& fn) {
+  size_t pos = ring_head_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = ring_[pos & (kRingSize - 1)];
+    size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+    if (diff == 0) {
+      if (ring_head_.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        slot.task = std::move(fn);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // The slot still holds the task from the previous lap: the ring is full.
+      return false;
+    } else {
+      pos = ring_head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool WorkerThread::TryPopRing(Task& fn) {
+  Slot& slot = ring_[ring_tail_ & (kRingSize - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != ring_tail_ + 1) {
+    return false;
+  }
+  fn = std::move(slot.task);
+  slot.task = nullptr;
+  slot.sequence.store(ring_tail_ + kRingSize, std::memory_order_release);
+  ++ring_tail_;
+  return true;
+}
+
+bool WorkerThread::TryPop(Task& fn) {
+  if (!pending_.empty()) {
+    fn = std::move(pending_.front());
+    pending_.pop_front();
+    return true;
+  }
+  if (TryPopRing(fn)) {
+    return true;
+  }
+  // Overflow tasks were scheduled after everything already claimed in the
+  // ring, so they may only run once the ring is drained.
+  if (overflow_size_.load(std::memory_order_acquire) == 0 ||
+      ring_head_.load(std::memory_order_acquire) != ring_tail_) {
+    return false;
+  }
+  {
+    absl::MutexLock lock(&mu_);
+    pending_.swap(overflow_);
+    overflow_size_.store(0, std::memory_order_release);
+  }
+  fn = std::move(pending_.front());
+  pending_.pop_front();
+  return true;
+}
+
+bool WorkerThread::HasWork() const {
+  return !pending_.empty() ||
+         ring_head_.load(std::memory_order_relaxed) != ring_tail_ ||
+         overflow_size_.load(std::memory_order_relaxed) != 0;
+}
+
+void WorkerThread::WaitForWork() {
+  for (int i = 0; i < kSpinIterations; ++i) {
+    if (HasWork()) {
+      return;
+    }
+    CpuRelax();
+  }
   absl::MutexLock lock(&mu_);
-  work_queue_.push(std::move(fn));
+  sleeping_.store(true, std::memory_order_relaxed);
+  // Pairs with the fence in MaybeWakeWorker(): either the producer sees
+  // `sleeping_` or we see its task.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!HasWork()) {
+    cv_.Wait(&mu_);
+  }
+  sleeping_.store(false, std::memory_order_relaxed);
 }
 
-bool WorkerThread::WorkAvailable() { return !work_queue_.empty(); }
+void WorkerThread::MaybeWakeWorker() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    absl::MutexLock lock(&mu_);
+    cv_.Signal();
+  }
+}
 
 void WorkerThread::WorkLoop() {
   while (true) {
-    std::function<void()> fn;
-    {
-      absl::MutexLock lock(&mu_);
-      mu_.Await(absl::Condition(this, &WorkerThread::WorkAvailable));
-      fn = std::move(work_queue_.front());
-      work_queue_.pop();
+    Task fn;
+    while (!TryPop(fn)) {
+      WaitForWork();
     }
-    if (!fn) {
+    if (fn == nullptr) {
       return;
     }
-    fn();
+    std::move(fn)();
   }
 }
 
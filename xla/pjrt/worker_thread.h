@@ -16,11 +16,14 @@ limitations under the License.
 #ifndef XLA_PJRT_WORKER_THREAD_H_
 #define XLA_PJRT_WORKER_THREAD_H_
 
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <memory>
-#include <queue>
 #include <string>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/synchronization/mutex.h"
 #include "tsl/platform/env.h"
 
@@ -28,8 +31,21 @@ namespace xla {
 
 // A worker thread that runs a sequence of closures. Equivalent to a thread
 // pool of size 1.
+//
+// Closures are handed to the worker through a bounded lock-free
+// multi-producer/single-consumer ring, so Schedule() does not take a lock in
+// the common case. If the ring is full, closures spill into a mutex-protected
+// overflow queue; closures are still run in the order they were scheduled.
+// When it runs out of work the worker spins for a short while before parking
+// on a condition variable, which keeps the latency of short bursts of small
+// closures low.
 class WorkerThread {
  public:
+  using Task = absl::AnyInvocable<void() &&>;
+
+  // Number of slots of the lock-free ring. Must be a power of two.
+  static constexpr size_t kRingSize = 1024;
+
   // 'name' is a name for the thread for debugging purposes.
   WorkerThread(tsl::Env* env, const std::string& name);
 
@@ -37,14 +53,55 @@ class WorkerThread {
   ~WorkerThread();
 
   // Adds 'fn' to the queue of closures to be executed by the worker thread.
-  void Schedule(std::function<void()> fn);
+  void Schedule(Task fn);
 
  private:
-  bool WorkAvailable() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // A ring slot. `sequence` tells producers and the consumer whose turn it is
+  // to access `task`: the slot is free for position `p` if `sequence == p` and
+  // holds the task of position `p` if `sequence == p + 1`.
+  struct Slot {
+    std::atomic<size_t> sequence;
+    Task task;
+  };
+
+  // Enqueues `fn`, which may be null to ask the worker to stop.
+  void Push(Task fn);
+
+  // Tries to enqueue `fn` into the ring. Leaves `fn` untouched on failure.
+  bool TryPushRing(Task& fn);
+
+  // Consumer side: dequeues the next task if one is ready.
+  bool TryPop(Task& fn);
+  bool TryPopRing(Task& fn);
+  bool HasWork() const;
+
+  // Spins for a while and then parks until HasWork() may have become true.
+  void WaitForWork();
+
+  // Wakes the worker if it is parked.
+  void MaybeWakeWorker();
+
   void WorkLoop();
 
+  std::unique_ptr<Slot[]> ring_;
+
+  // Next position to be claimed by a producer.
+  alignas(64) std::atomic<size_t> ring_head_{0};
+  // Next position to be consumed. Worker thread only.
+  alignas(64) size_t ring_tail_ = 0;
+
+  // Number of tasks in `overflow_`. While it is non-zero producers bypass the
+  // ring, so that tasks in the ring never overtake tasks in `overflow_`.
+  alignas(64) std::atomic<size_t> overflow_size_{0};
+  // True while the worker is parked (or about to park) on `cv_`.
+  std::atomic<bool> sleeping_{false};
+
   absl::Mutex mu_;
-  std::queue<std::function<void()>> work_queue_ ABSL_GUARDED_BY(mu_);
+  absl::CondVar cv_;
+  std::deque<Task> overflow_ ABSL_GUARDED_BY(mu_);
+
+  // Overflow tasks taken by the worker but not yet run. Worker thread only.
+  std::deque<Task> pending_;
 
   std::unique_ptr<tsl::Thread> thread_;
 };
@@ -0,0 +1,105 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/worker_thread.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+namespace {
+
+TEST(WorkerThreadTest, RunsClosuresInOrder) {
+  std::vector<int> order;
+  {
+    WorkerThread worker(tsl::Env::Default(), "test");
+    for (int i = 0; i < 100; ++i) {
+      worker.Schedule([&order, i] { order.push_back(i); });
+    }
+  }
+  ASSERT_EQ(order.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(WorkerThreadTest, KeepsOrderWhenRingOverflows) {
+  constexpr int kNumClosures = 3 * WorkerThread::kRingSize;
+  std::vector<int> order;
+  {
+    WorkerThread worker(tsl::Env::Default(), "test");
+    // Blocks the worker so that the following closures fill up the ring.
+    absl::Notification start;
+    worker.Schedule([&start] { start.WaitForNotification(); });
+    for (int i = 0; i < kNumClosures; ++i) {
+      worker.Schedule([&order, i] { order.push_back(i); });
+    }
+    start.Notify();
+  }
+  ASSERT_EQ(order.size(), kNumClosures);
+  for (int i = 0; i < kNumClosures; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(WorkerThreadTest, MoveOnlyClosures) {
+  int result = 0;
+  {
+    WorkerThread worker(tsl::Env::Default(), "test");
+    auto value = std::make_unique<int>(42);
+    worker.Schedule([&result, value = std::move(value)] { result = *value; });
+  }
+  EXPECT_EQ(result, 42);
+}
+
+TEST(WorkerThreadTest, ConcurrentProducers) {
+  constexpr int kNumProducers = 8;
+  constexpr int kClosuresPerProducer = 1000;
+  absl::Mutex mu;
+  std::vector<std::vector<int>> seen(kNumProducers);
+  {
+    WorkerThread worker(tsl::Env::Default(), "test");
+    {
+      tsl::thread::ThreadPool producers(tsl::Env::Default(), "producers",
+                                        kNumProducers);
+      for (int p = 0; p < kNumProducers; ++p) {
+        producers.Schedule([&, p] {
+          for (int i = 0; i < kClosuresPerProducer; ++i) {
+            worker.Schedule([&, p, i] {
+              absl::MutexLock lock(&mu);
+              seen[p].push_back(i);
+            });
+          }
+        });
+      }
+    }
+  }
+  // Closures of one producer run in the order that producer scheduled them.
+  for (int p = 0; p < kNumProducers; ++p) {
+    ASSERT_EQ(seen[p].size(), kClosuresPerProducer);
+    for (int i = 0; i < kClosuresPerProducer; ++i) {
+      EXPECT_EQ(seen[p][i], i);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace xla
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "xla/printer.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <string>
 #include <utility>
@@ -22,6 +24,8 @@ limitations under the License.
 #include "absl/strings/cord.h"
 #include "absl/strings/cord_buffer.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/logging.h"
 
 namespace xla {
@@ -67,4 +71,30 @@ absl::Cord CordPrinter::ToCord() && {
   return std::move(result_);
 }
 
+void FingerprintPrinter::Append(const absl::AlphaNum& a) {
+  constexpr size_t kChunkSize = 64 << 10;
+  absl::string_view piece = a.Piece();
+  while (!piece.empty()) {
+    if (chunk_.capacity() < kChunkSize) chunk_.reserve(kChunkSize);
+    size_t size = std::min(piece.size(), kChunkSize - chunk_.size());
+    chunk_.append(piece.data(), size);
+    piece.remove_prefix(size);
+    if (chunk_.size() == kChunkSize) HashChunk();
+  }
+}
+
+void FingerprintPrinter::HashChunk() {
+  tsl::Fprint128 chunk_fingerprint = tsl::Fingerprint128(chunk_);
+  fingerprint_ = has_fingerprint_
+                     ? tsl::FingerprintCat128(fingerprint_, chunk_fingerprint)
+                     : chunk_fingerprint;
+  has_fingerprint_ = true;
+  chunk_.clear();
+}
+
+tsl::Fprint128 FingerprintPrinter::ToFingerprint() && {
+  if (!has_fingerprint_ || !chunk_.empty()) HashChunk();
+  return fingerprint_;
+}
+
 }  // namespace xla
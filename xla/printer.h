@@ -24,6 +24,7 @@ limitations under the License.
 #include "absl/strings/cord_buffer.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "tsl/platform/fingerprint.h"
 
 namespace xla {
 
@@ -67,6 +68,26 @@ class CordPrinter : public Printer {
   absl::Cord result_;
 };
 
+// A printer implementation that computes a 128-bit fingerprint of the printed
+// string without materializing it. Printed bytes are hashed in fixed-size
+// chunks whose fingerprints are chained, so memory use is bounded and the
+// result only depends on the printed bytes, not on how they were split into
+// `Append` calls. Strings shorter than one chunk have the same fingerprint as
+// `tsl::Fingerprint128` of the whole string.
+class FingerprintPrinter : public Printer {
+ public:
+  void Append(const absl::AlphaNum& a) override;
+
+  tsl::Fprint128 ToFingerprint() &&;
+
+ private:
+  void HashChunk();
+
+  std::string chunk_;
+  tsl::Fprint128 fingerprint_ = {0, 0};
+  bool has_fingerprint_ = false;
+};
+
 // Utility functions that appends a list of elements to a Printer as if by
 // calling printer->Append(absl::StrJoin(...)), but does it in-place.
 template <typename Range, typename PrintFunc>
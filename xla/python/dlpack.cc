@@ -239,6 +239,19 @@ absl::StatusOr<std::vector<int64_t>> StridesToLayout(
     }
     stride *= dims[d];
   }
+  // Dimensions of size 1 may have arbitrary strides, e.g. PyTorch does not
+  // normalize them, so sorting by stride can place them anywhere. If the other
+  // dimensions are in major-to-minor order, the default layout describes the
+  // same memory, and using it avoids rejecting or relayouting the array.
+  std::vector<int64_t> non_trivial_dims;
+  for (int64_t d : minor_to_major) {
+    if (dims[d] > 1) {
+      non_trivial_dims.push_back(d);
+    }
+  }
+  if (absl::c_is_sorted(non_trivial_dims, std::greater<int64_t>())) {
+    std::iota(minor_to_major.rbegin(), minor_to_major.rend(), 0);
+  }
   return minor_to_major;
 }
 
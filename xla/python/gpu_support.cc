@@ -49,8 +49,11 @@ void RegisterGpuClientAndDefineGpuAllocatorConfig(nanobind::module_& m_nb) {
       .def_rw("kind", &GpuAllocatorConfig::kind)
       .def_rw("memory_fraction", &GpuAllocatorConfig::memory_fraction)
       .def_rw("preallocate", &GpuAllocatorConfig::preallocate)
+      .def_rw("use_virtual_memory", &GpuAllocatorConfig::use_virtual_memory)
       .def_rw("collective_memory_size",
-              &GpuAllocatorConfig::collective_memory_size);
+              &GpuAllocatorConfig::collective_memory_size)
+      .def_rw("pinned_host_memory_preallocate_size",
+              &GpuAllocatorConfig::pinned_host_memory_preallocate_size);
   nb::enum_<GpuAllocatorConfig::Kind>(alloc_config, "Kind")
       .value("DEFAULT", GpuAllocatorConfig::Kind::kDefault)
       .value("PLATFORM", GpuAllocatorConfig::Kind::kPlatform)
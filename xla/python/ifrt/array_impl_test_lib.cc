@@ -25,6 +25,7 @@ limitations under the License.
 #include "xla/python/ifrt/client.h"
 #include "xla/python/ifrt/device.h"
 #include "xla/python/ifrt/dtype.h"
+#include "xla/python/ifrt/index_domain.h"
 #include "xla/python/ifrt/memory.h"
 #include "xla/python/ifrt/shape.h"
 #include "xla/python/ifrt/sharding.h"
@@ -294,6 +295,73 @@ TEST(ArrayImplTest, MakeArrayFromHostBufferAndCopyToHostBufferWithByteStrides) {
   EXPECT_THAT(out_data, ElementsAreArray(expected_out_data));
 }
 
+TEST(ArrayImplTest, MakeShardedArrayFromHostBufferAndCopyToHostBuffer) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, test_util::GetClient());
+
+  DType dtype(DType::kF32);
+  Shape shape({4, 6});
+  Shape shard_shape({2, 3});
+  std::vector<float> data(24);
+  absl::c_iota(data, 0);
+  TF_ASSERT_OK_AND_ASSIGN(DeviceList devices,
+                          test_util::GetDevices(client.get(), {0, 1, 2, 3}));
+  ShardingParam sharding_param(
+      /*dim_shards=*/{2, 2}, {/*permutation=*/{0, 1}, /*axis_sizes=*/{2, 2}});
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<const Sharding> sharding,
+      ShardingParamSharding::Create(std::move(sharding_param), devices,
+                                    MemoryKind()));
+
+  absl::Notification done_with_host_buffer;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto array,
+      client->MakeArrayFromHostBuffer(
+          data.data(), dtype, shape, /*byte_strides=*/std::nullopt, sharding,
+          Client::HostBufferSemantics::kImmutableUntilTransferCompletes,
+          [&]() { done_with_host_buffer.Notify(); }));
+  done_with_host_buffer.WaitForNotification();
+
+  // Every shard holds its own window of the host buffer.
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<IndexDomain> index_domains,
+                          sharding->IndexDomains(shape));
+  std::vector<std::vector<float>> expected_per_shard_data;
+  for (const IndexDomain& index_domain : index_domains) {
+    std::vector<float>& shard_data = expected_per_shard_data.emplace_back();
+    for (int i = 0; i < shard_shape.dims()[0]; ++i) {
+      for (int j = 0; j < shard_shape.dims()[1]; ++j) {
+        shard_data.push_back(
+            data[(index_domain.origin().elements()[0] + i) * 6 +
+                 index_domain.origin().elements()[1] + j]);
+      }
+    }
+  }
+  std::vector<absl::Span<const float>> expected_per_shard_spans(
+      expected_per_shard_data.begin(), expected_per_shard_data.end());
+  test_util::AssertPerShardData<float>(array, dtype, shard_shape,
+                                       expected_per_shard_spans, devices);
+
+  // The shards are reassembled into the whole host buffer.
+  std::vector<float> out_data(24);
+  TF_ASSERT_OK(array
+                   ->CopyToHostBuffer(out_data.data(),
+                                      /*byte_strides=*/std::nullopt,
+                                      ArrayCopySemantics::kAlwaysCopy)
+                   .Await());
+  EXPECT_THAT(out_data, ElementsAreArray(data));
+
+  // And into a minor-to-major host buffer.
+  std::vector<int64_t> byte_strides = {4, 16};
+  TF_ASSERT_OK(array
+                   ->CopyToHostBuffer(out_data.data(), byte_strides,
+                                      ArrayCopySemantics::kAlwaysCopy)
+                   .Await());
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      EXPECT_EQ(out_data[j * 4 + i], data[i * 6 + j]);
+    }
+  }
+}
+
 TEST(ArrayImplTest, AssembleArray) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, test_util::GetClient());
 
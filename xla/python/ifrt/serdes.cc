@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "xla/python/ifrt/serdes.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -24,6 +26,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -36,6 +39,9 @@ namespace ifrt {
 namespace {
 
 struct Registry {
+  // Registration happens once per type at startup, while lookups happen on
+  // every (de)serialization and may run concurrently, so lookups only take
+  // the reader lock.
   absl::Mutex mu;
 
   // Mapping from LLVM RTTI type ids of `Serializable` to `SerDes`. Used during
@@ -54,12 +60,75 @@ Registry* registry() {
   return r;
 }
 
+absl::StatusOr<SerDes*> LookupSerDes(const Serializable& serializable) {
+  Registry* const r = registry();
+  absl::ReaderMutexLock l(&r->mu);
+  auto it = r->type_id_to_serdes.find(serializable.dynamicClassID());
+  if (it == r->type_id_to_serdes.end()) {
+    return absl::UnimplementedError(
+        "Serialize call failed. Serializable has no associated SerDes "
+        "implementation");
+  }
+  return it->second;
+}
+
+absl::StatusOr<SerDes*> LookupSerDes(absl::string_view type_name) {
+  Registry* const r = registry();
+  absl::ReaderMutexLock l(&r->mu);
+  auto it = r->name_to_serdes.find(type_name);
+  if (it == r->name_to_serdes.end()) {
+    return absl::UnimplementedError(absl::StrCat(
+        "Deserialize call failed. Serializable has no associated SerDes ",
+        "implementation. type_name: ", type_name));
+  }
+  return it->second;
+}
+
+// Field numbers of `Serialized`. Both fields are length-delimited.
+constexpr uint64_t kTypeNameField = 1;
+constexpr uint64_t kDataField = 2;
+constexpr uint64_t kLengthDelimited = 2;
+
+void AppendVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// Reads a varint from the start of `cord` and removes it from `cord`.
+absl::StatusOr<uint64_t> ConsumeVarint(absl::Cord& cord) {
+  uint64_t value = 0;
+  size_t size = 0;
+  for (auto it = cord.char_begin(); it != cord.char_end() && size < 10; ++it) {
+    const uint8_t byte = static_cast<uint8_t>(*it);
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * size);
+    ++size;
+    if ((byte & 0x80) == 0) {
+      cord.RemovePrefix(size);
+      return value;
+    }
+  }
+  return absl::DataLossError("Malformed varint in serialized IFRT object");
+}
+
 }  // namespace
 
 char Serializable::ID = 0;
 char DeserializeOptions::ID = 0;
 char SerDes::ID = 0;
 
+absl::StatusOr<absl::Cord> SerDes::SerializeToCord(Serializable& serializable) {
+  TF_ASSIGN_OR_RETURN(std::string data, Serialize(serializable));
+  return absl::Cord(std::move(data));
+}
+
+absl::StatusOr<std::unique_ptr<Serializable>> SerDes::DeserializeFromCord(
+    const absl::Cord& serialized, std::unique_ptr<DeserializeOptions> options) {
+  return Deserialize(std::string(serialized), std::move(options));
+}
+
 void RegisterSerDes(const void* type_id, std::unique_ptr<SerDes> serdes) {
   Registry* const r = registry();
   absl::MutexLock l(&r->mu);
@@ -81,18 +150,7 @@ void RegisterSerDes(const void* type_id, std::unique_ptr<SerDes> serdes) {
 }
 
 absl::StatusOr<Serialized> Serialize(Serializable& serializable) {
-  SerDes* serdes;
-  {
-    Registry* const r = registry();
-    absl::MutexLock l(&r->mu);
-    auto it = r->type_id_to_serdes.find(serializable.dynamicClassID());
-    if (it == r->type_id_to_serdes.end()) {
-      return absl::UnimplementedError(
-          "Serialize call failed. Serializable has no associated SerDes "
-          "implementation");
-    }
-    serdes = it->second;
-  }
+  TF_ASSIGN_OR_RETURN(SerDes * serdes, LookupSerDes(serializable));
   TF_ASSIGN_OR_RETURN(std::string data, serdes->Serialize(serializable));
 
   Serialized proto;
@@ -101,23 +159,65 @@ absl::StatusOr<Serialized> Serialize(Serializable& serializable) {
   return proto;
 }
 
+absl::StatusOr<absl::Cord> SerializeToCord(Serializable& serializable) {
+  TF_ASSIGN_OR_RETURN(SerDes * serdes, LookupSerDes(serializable));
+  TF_ASSIGN_OR_RETURN(absl::Cord data, serdes->SerializeToCord(serializable));
+
+  // Encode the fields the same way as `Serialized::SerializeAsString()`:
+  // in field number order, with empty fields omitted.
+  const absl::string_view type_name = serdes->type_name();
+  std::string header;
+  if (!type_name.empty()) {
+    AppendVarint(kTypeNameField << 3 | kLengthDelimited, header);
+    AppendVarint(type_name.size(), header);
+    header.append(type_name.data(), type_name.size());
+  }
+  if (!data.empty()) {
+    AppendVarint(kDataField << 3 | kLengthDelimited, header);
+    AppendVarint(data.size(), header);
+  }
+
+  absl::Cord result(std::move(header));
+  result.Append(std::move(data));
+  return result;
+}
+
 namespace serdes_internal {
 
 absl::StatusOr<std::unique_ptr<Serializable>> DeserializeUnchecked(
     const Serialized& serialized, std::unique_ptr<DeserializeOptions> options) {
-  SerDes* serdes;
-  {
-    Registry* const r = registry();
-    absl::MutexLock l(&r->mu);
-    auto it = r->name_to_serdes.find(serialized.type_name());
-    if (it == r->name_to_serdes.end()) {
-      return absl::UnimplementedError(absl::StrCat(
-          "Deserialize call failed. Serializable has no associated SerDes ",
-          "implementation. type_name: ", serialized.type_name()));
+  TF_ASSIGN_OR_RETURN(SerDes * serdes, LookupSerDes(serialized.type_name()));
+  return serdes->Deserialize(serialized.data(), std::move(options));
+}
+
+absl::StatusOr<std::unique_ptr<Serializable>> DeserializeUncheckedFromCord(
+    const absl::Cord& serialized, std::unique_ptr<DeserializeOptions> options) {
+  // Parse the `Serialized` fields by hand so that `data` can be passed on as a
+  // subrange of `serialized`. As in proto parsing, the last occurrence of a
+  // field wins and unknown length-delimited fields are skipped.
+  std::string type_name;
+  absl::Cord data;
+  absl::Cord rest = serialized;
+  while (!rest.empty()) {
+    TF_ASSIGN_OR_RETURN(const uint64_t tag, ConsumeVarint(rest));
+    if ((tag & 7) != kLengthDelimited) {
+      return absl::DataLossError(absl::StrCat(
+          "Unexpected wire type in serialized IFRT object: ", tag & 7));
     }
-    serdes = it->second;
+    TF_ASSIGN_OR_RETURN(const uint64_t size, ConsumeVarint(rest));
+    if (size > rest.size()) {
+      return absl::DataLossError("Truncated serialized IFRT object");
+    }
+    if ((tag >> 3) == kTypeNameField) {
+      type_name = std::string(rest.Subcord(0, size));
+    } else if ((tag >> 3) == kDataField) {
+      data = rest.Subcord(0, size);
+    }
+    rest.RemovePrefix(size);
   }
-  return serdes->Deserialize(serialized.data(), std::move(options));
+
+  TF_ASSIGN_OR_RETURN(SerDes * serdes, LookupSerDes(type_name));
+  return serdes->DeserializeFromCord(data, std::move(options));
 }
 
 }  // namespace serdes_internal
@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ExtensibleRTTI.h"
@@ -62,6 +63,18 @@ class SerDes : public llvm::RTTIExtends<SerDes, llvm::RTTIRoot> {
       const std::string& serialized,
       std::unique_ptr<DeserializeOptions> options) = 0;
 
+  // Cord variants of `Serialize()` and `Deserialize()` used by
+  // `SerializeToCord()` and `DeserializeFromCord()`. Implementations for types
+  // that hold large blobs (e.g., executables or constants) can override them
+  // to append the blobs as Cord fragments and to read them back without
+  // flattening. The defaults forward to the `std::string` variants.
+  virtual absl::StatusOr<absl::Cord> SerializeToCord(
+      Serializable& serializable);
+
+  virtual absl::StatusOr<std::unique_ptr<Serializable>> DeserializeFromCord(
+      const absl::Cord& serialized,
+      std::unique_ptr<DeserializeOptions> options);
+
   static char ID;  // NOLINT
 };
 
@@ -89,6 +102,22 @@ namespace serdes_internal {
 absl::StatusOr<std::unique_ptr<Serializable>> DeserializeUnchecked(
     const Serialized& serialized, std::unique_ptr<DeserializeOptions> options);
 
+// Internal implementation of DeserializeFromCord().
+absl::StatusOr<std::unique_ptr<Serializable>> DeserializeUncheckedFromCord(
+    const absl::Cord& serialized, std::unique_ptr<DeserializeOptions> options);
+
+// Downcasts a deserialized object to the type requested by the caller.
+template <typename InterfaceType>
+absl::StatusOr<std::unique_ptr<InterfaceType>> CastDeserialized(
+    std::unique_ptr<Serializable> result) {
+  if (!llvm::isa<InterfaceType>(result.get())) {
+    return absl::InternalError(
+        "Unexpected Serializable type after deserialization");
+  }
+  return std::unique_ptr<InterfaceType>(
+      static_cast<InterfaceType*>(result.release()));
+}
+
 }  // namespace serdes_internal
 
 // Serializes the given `Serializable` object. The returned proto message can be
@@ -114,12 +143,27 @@ absl::StatusOr<std::unique_ptr<InterfaceType>> Deserialize(
     std::unique_ptr<typename InterfaceType::DeserializeOptions> options) {
   TF_ASSIGN_OR_RETURN(auto result, serdes_internal::DeserializeUnchecked(
                                        serialized, std::move(options)));
-  if (!llvm::isa<InterfaceType>(result.get())) {
-    return absl::InternalError(
-        "Unexpected Serializable type after deserialization");
-  }
-  return std::unique_ptr<InterfaceType>(
-      static_cast<InterfaceType*>(result.release()));
+  return serdes_internal::CastDeserialized<InterfaceType>(std::move(result));
+}
+
+// Serializes the given `Serializable` object into the wire format of the
+// `Serialized` proto, i.e., the result can be parsed as `Serialized` and is
+// byte-for-byte what `Serialize()` would produce. Unlike `Serialize()`, the
+// output of `SerDes::SerializeToCord()` is appended without being copied, so
+// large blobs that a `SerDes` provides as Cord fragments stay shared.
+absl::StatusOr<absl::Cord> SerializeToCord(Serializable& serializable);
+
+// Deserializes the output of `SerializeToCord()`, or any other `Serialized`
+// proto in wire format, without flattening it. The serialized object is passed
+// to `SerDes::DeserializeFromCord()` as a subrange of `serialized`.
+template <typename InterfaceType>
+absl::StatusOr<std::unique_ptr<InterfaceType>> DeserializeFromCord(
+    const absl::Cord& serialized,
+    std::unique_ptr<typename InterfaceType::DeserializeOptions> options) {
+  TF_ASSIGN_OR_RETURN(auto result,
+                      serdes_internal::DeserializeUncheckedFromCord(
+                          serialized, std::move(options)));
+  return serdes_internal::CastDeserialized<InterfaceType>(std::move(result));
 }
 
 }  // namespace ifrt
@@ -18,11 +18,13 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -120,6 +122,103 @@ TEST_F(TestNumberTest, WithOptions) {
               StatusIs(absl::StatusCode::kInternal, "injected failure"));
 }
 
+TEST_F(TestNumberTest, CordMatchesProtoWireFormat) {
+  auto obj = std::make_unique<TestNumber>(1234);
+  TF_ASSERT_OK_AND_ASSIGN(Serialized serialized, Serialize(*obj));
+  TF_ASSERT_OK_AND_ASSIGN(absl::Cord cord, SerializeToCord(*obj));
+  EXPECT_EQ(std::string(cord), serialized.SerializeAsString());
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto deserialized,
+      DeserializeFromCord<TestNumber>(
+          absl::Cord(serialized.SerializeAsString()), /*options=*/nullptr));
+  EXPECT_EQ(obj->number, deserialized->number);
+}
+
+TEST_F(TestNumberTest, DeserializeFromCordRejectsTruncatedInput) {
+  auto obj = std::make_unique<TestNumber>(1234);
+  TF_ASSERT_OK_AND_ASSIGN(absl::Cord cord, SerializeToCord(*obj));
+  cord.RemoveSuffix(1);
+  EXPECT_THAT(DeserializeFromCord<TestNumber>(cord, /*options=*/nullptr),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+// A serializable that holds a large blob, which its SerDes passes around as a
+// Cord fragment.
+struct TestBlob : llvm::RTTIExtends<TestBlob, Serializable> {
+  absl::Cord blob;
+
+  explicit TestBlob(absl::Cord blob) : blob(std::move(blob)) {}
+
+  static char ID;  // NOLINT
+};
+
+[[maybe_unused]] char TestBlob::ID = 0;  // NOLINT
+
+class TestBlobSerDes : public llvm::RTTIExtends<TestBlobSerDes, SerDes> {
+ public:
+  absl::string_view type_name() const override { return "xla::ifrt::TestBlob"; }
+
+  absl::StatusOr<std::string> Serialize(Serializable& serializable) override {
+    return std::string(llvm::cast<TestBlob>(serializable).blob);
+  }
+
+  absl::StatusOr<std::unique_ptr<Serializable>> Deserialize(
+      const std::string& serialized,
+      std::unique_ptr<DeserializeOptions> options) override {
+    return std::make_unique<TestBlob>(absl::Cord(serialized));
+  }
+
+  absl::StatusOr<absl::Cord> SerializeToCord(
+      Serializable& serializable) override {
+    return llvm::cast<TestBlob>(serializable).blob;
+  }
+
+  absl::StatusOr<std::unique_ptr<Serializable>> DeserializeFromCord(
+      const absl::Cord& serialized,
+      std::unique_ptr<DeserializeOptions> options) override {
+    return std::make_unique<TestBlob>(serialized);
+  }
+
+  static char ID;  // NOLINT
+};
+
+[[maybe_unused]] char TestBlobSerDes::ID = 0;  // NOLINT
+
+class TestBlobTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    RegisterSerDes<TestBlob>(std::make_unique<TestBlobSerDes>());
+  }
+};
+
+// Returns the start addresses of the chunks of `cord`.
+std::vector<const char*> ChunkData(const absl::Cord& cord) {
+  std::vector<const char*> result;
+  for (absl::string_view chunk : cord.Chunks()) {
+    result.push_back(chunk.data());
+  }
+  return result;
+}
+
+TEST_F(TestBlobTest, CordRoundTripDoesNotCopyBlob) {
+  const std::string contents(1024 * 1024, 'x');
+  auto obj = std::make_unique<TestBlob>(
+      absl::MakeCordFromExternal(contents, [](absl::string_view) {}));
+
+  TF_ASSERT_OK_AND_ASSIGN(absl::Cord cord, SerializeToCord(*obj));
+  TF_ASSERT_OK_AND_ASSIGN(Serialized serialized, Serialize(*obj));
+  EXPECT_EQ(std::string(cord), serialized.SerializeAsString());
+  EXPECT_THAT(ChunkData(cord), testing::Contains(contents.data()));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto deserialized,
+      DeserializeFromCord<TestBlob>(cord, /*options=*/nullptr));
+  EXPECT_EQ(deserialized->blob, contents);
+  EXPECT_THAT(ChunkData(deserialized->blob),
+              testing::ElementsAre(contents.data()));
+}
+
 }  // namespace
 }  // namespace ifrt
 }  // namespace xla
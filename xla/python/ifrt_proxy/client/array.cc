@@ -71,10 +71,6 @@ Array::MakeArrayFromHostBuffer(
 
   const uint64_t host_buffer_handle =
       rpc_helper->host_buffer_store()->NextHandle();
-  TF_RETURN_IF_ERROR(
-      rpc_helper->host_buffer_store()
-          ->Store(host_buffer_handle, array_mem_region.mem_region())
-          .Await());
 
   auto req = std::make_unique<MakeArrayFromHostBufferRequest>();
   req->set_host_buffer_handle(host_buffer_handle);
@@ -85,9 +81,24 @@ Array::MakeArrayFromHostBuffer(
     *req->mutable_byte_strides() = ToByteStridesProto(*byte_strides);
   }
 
-  TF_ASSIGN_OR_RETURN(
-      auto response,
-      rpc_helper->MakeArrayFromHostBuffer(std::move(req)).Await());
+  std::shared_ptr<MakeArrayFromHostBufferResponse> response;
+  if (rpc_helper->version().protocol_version() >= 4) {
+    // The server waits for the host buffer to arrive, so the request is sent
+    // first and its round trip overlaps with storing the buffer.
+    auto response_future = rpc_helper->MakeArrayFromHostBuffer(std::move(req));
+    TF_RETURN_IF_ERROR(
+        rpc_helper->host_buffer_store()
+            ->Store(host_buffer_handle, array_mem_region.mem_region())
+            .Await());
+    TF_ASSIGN_OR_RETURN(response, response_future.Await());
+  } else {
+    TF_RETURN_IF_ERROR(
+        rpc_helper->host_buffer_store()
+            ->Store(host_buffer_handle, array_mem_region.mem_region())
+            .Await());
+    TF_ASSIGN_OR_RETURN(
+        response, rpc_helper->MakeArrayFromHostBuffer(std::move(req)).Await());
+  }
   const ArrayHandle handle{response->array_handle()};
 
   if (on_done_with_host_buffer != nullptr) {
@@ -23,6 +23,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/strings/string_view.h"
 #include "llvm/Support/Casting.h"
 #include "xla/pjrt/host_callback.h"
@@ -42,6 +43,7 @@
 #include "xla/python/pjrt_ifrt/pjrt_host_callback.h"
 #include "xla/python/pjrt_ifrt/xla_compiler.h"
 #include "xla/tsl/concurrency/ref_count.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/status_to_from_proto.h"
 #include "tsl/platform/statusor.h"
 
@@ -58,6 +60,26 @@ absl::StatusOr<std::unique_ptr<xla::ifrt::LoadedExecutable>> Compiler::Compile(
     std::unique_ptr<xla::ifrt::CompileOptions> options) {
   auto request = std::make_unique<CompileRequest>();
   TF_ASSIGN_OR_RETURN(*request->mutable_program(), Serialize(*program));
+  // The server remembers recently compiled programs by fingerprint, so a
+  // program that it has acknowledged before is only referenced. The program is
+  // kept aside in case the server has evicted it in the meantime.
+  std::optional<tsl::Fprint128> program_fingerprint;
+  std::optional<Serialized> omitted_program;
+  if (rpc_helper_->version().protocol_version() >= 5) {
+    tsl::Fprint128 fingerprint = tsl::Fingerprint128(request->program().data());
+    fingerprint.low64 = tsl::FingerprintCat64(
+        fingerprint.low64, tsl::Fingerprint64(request->program().type_name()));
+    if (fingerprint.low64 != 0 || fingerprint.high64 != 0) {
+      program_fingerprint = fingerprint;
+      request->set_program_fingerprint_low(fingerprint.low64);
+      request->set_program_fingerprint_high(fingerprint.high64);
+      absl::MutexLock lock(&mu_);
+      if (sent_program_fingerprints_.contains(fingerprint)) {
+        omitted_program = std::move(*request->mutable_program());
+        request->clear_program();
+      }
+    }
+  }
 
   // Extract host callbacks from the XLA compile options. `XlaCompileOptions`'s
   // SerDes fails when it contains host callbacks, so the following
@@ -94,8 +116,32 @@ absl::StatusOr<std::unique_ptr<xla::ifrt::LoadedExecutable>> Compiler::Compile(
   TF_ASSIGN_OR_RETURN(*request->mutable_compile_options(), Serialize(*options));
 
   // TODO(b/266635130): Avoid blocking the caller.
+  absl::StatusOr<std::shared_ptr<CompileResponse>> compile_response;
+  if (omitted_program.has_value()) {
+    compile_response =
+        rpc_helper_->Compile(std::make_unique<CompileRequest>(*request))
+            .Await();
+    if (compile_response.ok() && (*compile_response)->program_not_found()) {
+      // The server no longer knows the program, so send it in full.
+      *request->mutable_program() = *std::move(omitted_program);
+      compile_response = rpc_helper_->Compile(std::move(request)).Await();
+    }
+  } else {
+    compile_response = rpc_helper_->Compile(std::move(request)).Await();
+  }
   TF_ASSIGN_OR_RETURN(std::shared_ptr<CompileResponse> response,
-                      rpc_helper_->Compile(std::move(request)).Await());
+                      std::move(compile_response));
+  if (response->program_not_found()) {
+    return absl::InternalError(
+        "IFRT proxy server did not accept the program of a compile request");
+  }
+  if (program_fingerprint.has_value()) {
+    // Only programs that the server acknowledged are referenced by fingerprint
+    // later, so that a failed or concurrent request never causes a lookup of
+    // a program that the server hasn't received.
+    absl::MutexLock lock(&mu_);
+    sent_program_fingerprints_.insert(*program_fingerprint);
+  }
 
   std::vector<xla::ifrt::LoadedExecutable::LogicalDeviceIds>
       addressable_device_logical_device_ids;
@@ -17,16 +17,21 @@
 #ifndef XLA_PYTHON_IFRT_PROXY_CLIENT_COMPILER_H_
 #define XLA_PYTHON_IFRT_PROXY_CLIENT_COMPILER_H_
 
+#include <cstdint>
 #include <memory>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/python/ifrt/client.h"
 #include "xla/python/ifrt/compiler.h"
 #include "xla/python/ifrt/executable.h"
 #include "xla/python/ifrt/program.h"
 #include "xla/python/ifrt/topology.h"
 #include "xla/python/ifrt_proxy/client/rpc_helper.h"
+#include "tsl/platform/fingerprint.h"
 
 namespace xla {
 namespace ifrt {
@@ -55,6 +60,11 @@ class Compiler final : public llvm::RTTIExtends<Compiler, xla::ifrt::Compiler> {
  private:
   xla::ifrt::Client* client_;
   std::shared_ptr<RpcHelper> rpc_helper_;
+
+  absl::Mutex mu_;
+  // Fingerprints of the programs that the server acknowledged in this session.
+  absl::flat_hash_set<tsl::Fprint128, tsl::Fprint128Hasher>
+      sent_program_fingerprints_ ABSL_GUARDED_BY(mu_);
 };
 
 }  // namespace proxy
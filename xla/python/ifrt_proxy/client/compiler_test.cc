@@ -14,8 +14,10 @@
 
 #include "xla/python/ifrt_proxy/client/compiler.h"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -37,6 +39,7 @@
 #include "xla/python/ifrt_proxy/client/rpc_helper.h"
 #include "xla/python/ifrt_proxy/client/version.h"
 #include "xla/python/ifrt_proxy/common/ifrt_service.pb.h"
+#include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/protobuf.h"  // IWYU pragma: keep
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
@@ -53,6 +56,7 @@ using ::testing::FieldsAre;
 using ::testing::Invoke;
 using ::testing::Optional;
 using ::testing::Pointee;
+using ::testing::Property;
 using ::testing::Return;
 using ::tsl::protobuf::TextFormat;
 using ::tsl::testing::IsOkAndHolds;
@@ -219,6 +223,111 @@ TEST_F(CompilerTest, Compile) {
 }
 #endif
 
+class CompilerProgramFingerprintTest : public CompilerTest {
+ protected:
+  void SetUp() override {
+    CompilerTest::SetUp();
+    IfrtProxyVersion version;
+    version.set_protocol_version(5);
+    rpc_helper_ = std::make_shared<RpcHelper>(version, session_);
+    rpc_helper_->set_host_buffer_store(host_buffer_store_);
+  }
+
+  // Handles compile requests with `handler`, and records them.
+  void HandleCompileRequests(
+      std::function<Future<ClientSession::Response>(const IfrtRequest&)>
+          handler) {
+    EXPECT_CALL(*session_, Enqueue(Pointee(Property(
+                               &IfrtRequest::has_compile_request, true))))
+        .WillRepeatedly([this, handler = std::move(handler)](
+                            std::unique_ptr<IfrtRequest> request) {
+          compile_requests_.push_back(request->compile_request());
+          return handler(*request);
+        });
+  }
+
+  absl::Status Compile(Compiler& compiler) {
+    return compiler
+        .Compile(std::make_unique<TestProgram>(),
+                 std::make_unique<TestCompileOptions>())
+        .status();
+  }
+
+  std::vector<CompileRequest> compile_requests_;
+};
+
+// Returns a successful compile response, or `program_not_found` if the
+// request references its program only by fingerprint and the server does not
+// have it.
+Future<ClientSession::Response> MakeCompileResponse(const IfrtRequest& request,
+                                                    bool server_has_program) {
+  auto response = std::make_unique<IfrtResponse>();
+  response->mutable_response_metadata()->set_op_id(
+      request.request_metadata().op_id());
+  if (!request.compile_request().has_program() && !server_has_program) {
+    response->mutable_compile_response()->set_program_not_found(true);
+  } else {
+    response->mutable_compile_response()->set_loaded_executable_handle(1234);
+  }
+  return Future<ClientSession::Response>(std::move(response));
+}
+
+TEST_F(CompilerProgramFingerprintTest, ReferencesAcknowledgedProgram) {
+  MockClient client;
+  Compiler compiler(&client, rpc_helper_);
+  HandleCompileRequests([](const IfrtRequest& request) {
+    return MakeCompileResponse(request, /*server_has_program=*/true);
+  });
+
+  TF_ASSERT_OK(Compile(compiler));
+  TF_ASSERT_OK(Compile(compiler));
+
+  ASSERT_EQ(compile_requests_.size(), 2);
+  EXPECT_TRUE(compile_requests_[0].has_program());
+  EXPECT_TRUE(compile_requests_[0].program_fingerprint_low() != 0 ||
+              compile_requests_[0].program_fingerprint_high() != 0);
+  EXPECT_FALSE(compile_requests_[1].has_program());
+  EXPECT_EQ(compile_requests_[1].program_fingerprint_low(),
+            compile_requests_[0].program_fingerprint_low());
+  EXPECT_EQ(compile_requests_[1].program_fingerprint_high(),
+            compile_requests_[0].program_fingerprint_high());
+}
+
+TEST_F(CompilerProgramFingerprintTest, ResendsProgramThatServerDoesNotKnow) {
+  MockClient client;
+  Compiler compiler(&client, rpc_helper_);
+  HandleCompileRequests([](const IfrtRequest& request) {
+    return MakeCompileResponse(request, /*server_has_program=*/false);
+  });
+
+  TF_ASSERT_OK(Compile(compiler));
+  TF_ASSERT_OK(Compile(compiler));
+
+  ASSERT_EQ(compile_requests_.size(), 3);
+  EXPECT_TRUE(compile_requests_[0].has_program());
+  EXPECT_FALSE(compile_requests_[1].has_program());
+  EXPECT_TRUE(compile_requests_[2].has_program());
+}
+
+TEST_F(CompilerProgramFingerprintTest, DoesNotResendOnCompileErrors) {
+  MockClient client;
+  Compiler compiler(&client, rpc_helper_);
+  HandleCompileRequests([&](const IfrtRequest& request) {
+    if (compile_requests_.size() == 1) {
+      return MakeCompileResponse(request, /*server_has_program=*/true);
+    }
+    return Future<ClientSession::Response>(
+        absl::NotFoundError("injected error"));
+  });
+
+  TF_ASSERT_OK(Compile(compiler));
+  EXPECT_THAT(Compile(compiler),
+              StatusIs(absl::StatusCode::kNotFound, "injected error"));
+
+  ASSERT_EQ(compile_requests_.size(), 2);
+  EXPECT_FALSE(compile_requests_[1].has_program());
+}
+
 }  // namespace
 }  // namespace proxy
 }  // namespace ifrt
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -37,6 +38,7 @@
 #include "xla/python/ifrt_proxy/client/version.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.pb.h"
 #include "xla/python/ifrt_proxy/common/ifrt_service.pb.h"
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
 
@@ -53,7 +55,8 @@ namespace {
 absl::StatusOr<std::unique_ptr<Client>> AttemptConnection(
     absl::string_view server_address,
     std::function<void(absl::Status)> on_disconnect, int attempt_no,
-    absl::AnyInvocable<void(absl::string_view)> log_initial_connection) {
+    absl::AnyInvocable<void(absl::string_view)> log_initial_connection,
+    int64_t host_buffer_shared_memory_size) {
   std::unique_ptr<RpcHelper> rpc_helper;
   auto init_response_promise =
       Future<std::shared_ptr<InitResponse>>::CreatePromise();
@@ -110,6 +113,21 @@ absl::StatusOr<std::unique_ptr<Client>> AttemptConnection(
     *metadata.mutable_version() = response.version();
   }
 
+  std::shared_ptr<SharedMemoryRegion> shared_memory;
+  if (host_buffer_shared_memory_size > 0) {
+    auto region = SharedMemoryRegion::Create(host_buffer_shared_memory_size);
+    if (region.ok()) {
+      shared_memory = *std::move(region);
+      GrpcSharedMemoryRegion* offer =
+          metadata.mutable_host_buffer_shared_memory();
+      offer->set_name(shared_memory->name());
+      offer->set_size(shared_memory->size());
+      offer->set_token(shared_memory->token());
+    } else {
+      LOG(WARNING) << "Streaming host buffers: " << region.status();
+    }
+  }
+
   auto session =
       GrpcClientSession::Create(stub, metadata, session_disconnect_cb);
   rpc_helper =
@@ -130,7 +148,8 @@ absl::StatusOr<std::unique_ptr<Client>> AttemptConnection(
       Future<std::shared_ptr<InitResponse>>(init_response_promise).Await());
 
   auto host_buffer_store = std::make_unique<GrpcClientHostBufferStore>(
-      stub, metadata.version(), init_response->session_id());
+      stub, metadata.version(), init_response->session_id(),
+      std::move(shared_memory));
   rpc_helper->set_host_buffer_store(std::move(host_buffer_store));
 
   return Client::Create(std::move(rpc_helper), std::move(*init_response));
@@ -153,7 +172,8 @@ absl::StatusOr<std::unique_ptr<Client>> CreateGrpcClient(
                                         server_address, ", attempt #", i,
                                         "..."));
     absl::StatusOr<std::unique_ptr<Client>> result = AttemptConnection(
-        server_address, options.on_disconnect, i, log_initial_connection);
+        server_address, options.on_disconnect, i, log_initial_connection,
+        options.host_buffer_shared_memory_size);
     if (result.ok()) {
       log_initial_connection(absl::StrCat("Connected to IFRT proxy server on ",
                                           "attempt #", i, "."));
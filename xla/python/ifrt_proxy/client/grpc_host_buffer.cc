@@ -15,16 +15,22 @@
 #include "xla/python/ifrt_proxy/client/grpc_host_buffer.h"
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
+#include "absl/cleanup/cleanup.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "grpcpp/client_context.h"
 #include "grpcpp/support/client_callback.h"
 #include "grpcpp/support/status.h"
@@ -33,6 +39,7 @@
 #include "xla/python/ifrt/future.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.grpc.pb.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.pb.h"
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/unbounded_work_queue.h"
 #include "tsl/protobuf/status.pb.h"
@@ -45,10 +52,13 @@ static constexpr int64_t kChunkSize = 1024 * 1024;
 
 GrpcClientHostBufferStore::GrpcClientHostBufferStore(
     std::shared_ptr<grpc::GrpcIfrtService::StubInterface> stub,
-    IfrtProxyVersion version, uint64_t session_id)
+    IfrtProxyVersion version, uint64_t session_id,
+    std::shared_ptr<SharedMemoryRegion> shared_memory)
     : stub_(std::move(stub)),
       version_(std::move(version)),
       session_id_(session_id),
+      shared_memory_(std::move(shared_memory)),
+      use_shared_memory_(shared_memory_ != nullptr),
       lookup_work_queue_(std::make_unique<tsl::UnboundedWorkQueue>(
           tsl::Env::Default(), "HostBufferStoreLookupsWorkQueue")) {}
 
@@ -62,8 +72,48 @@ uint64_t GrpcClientHostBufferStore::NextHandle() {
   return next_handle_.fetch_add(1, std::memory_order_relaxed);
 }
 
+std::optional<absl::Status> GrpcClientHostBufferStore::StoreInSharedMemory(
+    uint64_t handle, size_t size, absl::FunctionRef<void(char*)> write) {
+  if (!use_shared_memory_.load(std::memory_order_relaxed) ||
+      size > shared_memory_->size() || !shared_memory_mu_.TryLock()) {
+    return std::nullopt;
+  }
+  absl::Cleanup unlock = [this] { shared_memory_mu_.Unlock(); };
+  write(shared_memory_->data());
+
+  GrpcHostBufferStoreMetadata metadata;
+  metadata.set_session_id(session_id_);
+  metadata.set_handle(handle);
+  metadata.set_buffer_size(size);
+  metadata.set_in_shared_memory(true);
+
+  ::grpc::ClientContext context;
+  context.AddMetadata("ifrt-proxy-grpc-host-buffer-store-metadata-bin",
+                      metadata.SerializeAsString());
+
+  GrpcHostBufferStoreResponse response;
+  auto writer = stub_->HostBufferStore(&context, &response);
+  writer->WritesDone();
+  absl::Status status = xla::FromGrpcStatus(writer->Finish());
+  if (!status.ok()) {
+    // Servers that cannot use the region, including servers that predate
+    // shared memory transfers, fail the request. Stream from now on.
+    LOG(WARNING) << "Disabling shared memory host buffer transfers: "
+                 << status;
+    use_shared_memory_.store(false, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  return status;
+}
+
 Future<> GrpcClientHostBufferStore::Store(uint64_t handle,
                                           absl::string_view data) {
+  if (std::optional<absl::Status> status = StoreInSharedMemory(
+          handle, data.size(),
+          [&](char* dst) { std::memcpy(dst, data.data(), data.size()); })) {
+    return Future<>(*std::move(status));
+  }
+
   // The current implementation synchronously sends host buffer chunks. We may
   // consider making it asynchronous if the caller can leverage such asynchrony.
 
@@ -100,6 +150,16 @@ Future<> GrpcClientHostBufferStore::Store(uint64_t handle,
 
 Future<> GrpcClientHostBufferStore::Store(uint64_t handle,
                                           const absl::Cord& data) {
+  if (std::optional<absl::Status> status =
+          StoreInSharedMemory(handle, data.size(), [&](char* dst) {
+            for (absl::string_view chunk : data.Chunks()) {
+              std::memcpy(dst, chunk.data(), chunk.size());
+              dst += chunk.size();
+            }
+          })) {
+    return Future<>(*std::move(status));
+  }
+
   // The current implementation synchronously sends host buffer chunks. We may
   // consider making it asynchronous if the caller can leverage such asynchrony.
 
@@ -143,18 +203,55 @@ Future<absl::Cord> GrpcClientHostBufferStore::Lookup(uint64_t handle) {
     request.set_handle(handle);
     request.set_session_id(session_id_);
 
+    // The server may only use the shared memory region while this lookup
+    // holds it.
+    const bool shared_memory_locked =
+        use_shared_memory_.load(std::memory_order_relaxed) &&
+        shared_memory_mu_.TryLock();
+    absl::Cleanup unlock = [&] {
+      if (shared_memory_locked) {
+        shared_memory_mu_.Unlock();
+      }
+    };
+    request.set_allow_shared_memory(shared_memory_locked);
+
     ::grpc::ClientContext context;
 
     std::unique_ptr<::grpc::ClientReaderInterface<GrpcHostBufferLookupResponse>>
         stream = stub_->HostBufferLookup(&context, request);
 
     absl::Cord data;
+    bool invalid_shared_memory_response = false;
     GrpcHostBufferLookupResponse response;
     while (stream->Read(&response)) {
+      if (response.in_shared_memory()) {
+        if (!shared_memory_locked || response.shared_memory_size() < 0 ||
+            static_cast<size_t>(response.shared_memory_size()) >
+                shared_memory_->size()) {
+          invalid_shared_memory_response = true;
+          context.TryCancel();
+          break;
+        }
+        data = absl::Cord(absl::string_view(shared_memory_->data(),
+                                            response.shared_memory_size()));
+        continue;
+      }
+#if defined(PLATFORM_GOOGLE)
       data.Append(response.data());
+#else
+      // Hand the chunk's string over to the cord instead of copying it. The
+      // next Read() reparses into a fresh string.
+      data.Append(std::move(*response.mutable_data()));
+#endif
     }
 
     absl::Status status = xla::FromGrpcStatus(stream->Finish());
+    std::move(unlock).Invoke();
+    if (invalid_shared_memory_response) {
+      status = absl::InternalError(
+          "Server returned a host buffer in shared memory that the client "
+          "did not offer");
+    }
     if (status.ok()) {
       promise.Set(std::move(data));
     } else {
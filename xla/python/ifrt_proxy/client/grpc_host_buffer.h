@@ -18,15 +18,22 @@
 #define XLA_PYTHON_IFRT_PROXY_CLIENT_GRPC_HOST_BUFFER_H_
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/python/ifrt/future.h"
 #include "xla/python/ifrt_proxy/client/host_buffer.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.grpc.pb.h"
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
 #include "tsl/platform/unbounded_work_queue.h"
 
 namespace xla {
@@ -35,9 +42,14 @@ namespace proxy {
 
 class GrpcClientHostBufferStore : public ClientHostBufferStore {
  public:
+  // If `shared_memory` is not null, it is the region that was offered to the
+  // server in the session metadata. Host buffers that fit into it are then
+  // passed through it instead of being streamed, as long as the server accepts
+  // the region.
   GrpcClientHostBufferStore(
       std::shared_ptr<grpc::GrpcIfrtService::StubInterface> stub,
-      IfrtProxyVersion version, uint64_t session_id);
+      IfrtProxyVersion version, uint64_t session_id,
+      std::shared_ptr<SharedMemoryRegion> shared_memory = nullptr);
 
   ~GrpcClientHostBufferStore() override;
 
@@ -50,11 +62,25 @@ class GrpcClientHostBufferStore : public ClientHostBufferStore {
   Future<> Delete(uint64_t handle) override;
 
  private:
+  // Stores a `size`-byte host buffer that `write` copies into the shared
+  // memory region. Returns std::nullopt without calling `write` if the region
+  // cannot be used, in which case the caller streams the buffer instead.
+  std::optional<absl::Status> StoreInSharedMemory(
+      uint64_t handle, size_t size, absl::FunctionRef<void(char*)> write);
+
   const std::shared_ptr<grpc::GrpcIfrtService::StubInterface> stub_;
   const IfrtProxyVersion version_;
   const uint64_t session_id_;
   std::atomic<uint64_t> next_handle_ = 0;
 
+  // The shared memory region holds at most one buffer at a time. Transfers
+  // that find it busy are streamed instead of waiting for it.
+  const std::shared_ptr<SharedMemoryRegion> shared_memory_;
+  absl::Mutex shared_memory_mu_;
+  // Cleared when the server rejects the region, e.g. because it runs on a
+  // different machine.
+  std::atomic<bool> use_shared_memory_;
+
   // Implementation note: `lookup_work_queue_` may have closures that invoke
   // user-defined code. Each `Lookup()` call is associated with a scheduled
   // closure, and the closure is used to first perform synchronous reads of the
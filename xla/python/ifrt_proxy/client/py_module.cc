@@ -13,6 +13,7 @@
 // limitations under the License.
 #include "xla/python/ifrt_proxy/client/py_module.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -48,6 +49,7 @@ namespace {
 struct PyClientConnectionOptions {
   std::optional<std::function<void(std::string)>> on_disconnect;
   std::optional<std::function<void(std::string)>> on_connection_update;
+  int64_t host_buffer_shared_memory_size = 0;
 };
 
 absl::StatusOr<nb_class_ptr<PyClient>> GetClient(
@@ -90,6 +92,9 @@ absl::StatusOr<nb_class_ptr<PyClient>> GetClient(
     };
   }
 
+  options.host_buffer_shared_memory_size =
+      py_options.host_buffer_shared_memory_size;
+
   {
     nb::gil_scoped_release gil_release;
     TF_ASSIGN_OR_RETURN(client, CreateClient(proxy_server_address, options));
@@ -110,7 +115,9 @@ void BuildIfrtProxySubmodule(nb::module_& m) {
               nb::arg().none())
       .def_rw("on_connection_update",
               &PyClientConnectionOptions::on_connection_update,
-              nb::arg().none());
+              nb::arg().none())
+      .def_rw("host_buffer_shared_memory_size",
+              &PyClientConnectionOptions::host_buffer_shared_memory_size);
 
   sub_module.def("get_client", xla::ValueOrThrowWrapper(GetClient),
                  nb::arg("proxy_server_address"), nb::arg("options"));
@@ -17,6 +17,7 @@
 #ifndef XLA_PYTHON_IFRT_PROXY_CLIENT_REGISTRY_H_
 #define XLA_PYTHON_IFRT_PROXY_CLIENT_REGISTRY_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -45,6 +46,12 @@ struct ClientConnectionOptions {
   // synchronously from a thread that performs various important activities,
   // so the function should not block (or deadlocks may happen).
   std::function<void(absl::string_view)> on_connection_update = nullptr;
+
+  // Size of a shared memory region that the client offers to the server for
+  // host buffer transfers. If the server runs on the same machine, host
+  // buffers that fit into the region are copied through it instead of being
+  // streamed over the connection. 0 disables the region.
+  int64_t host_buffer_shared_memory_size = 0;
 };
 
 // Registers a new factory for client backend implementation. Crashes if the
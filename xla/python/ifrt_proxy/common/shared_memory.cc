@@ -0,0 +1,201 @@
+/*
+ * Copyright 2023 The OpenXLA Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/cleanup/cleanup.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "tsl/platform/random.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace xla {
+namespace ifrt {
+namespace proxy {
+
+#if defined(__linux__)
+
+namespace {
+
+// Prefix of the memfd names of regions. Open() only accepts memfds with it.
+constexpr absl::string_view kMemfdNamePrefix = "ifrt_proxy_";
+
+absl::Status ErrnoError(absl::string_view what, absl::string_view name) {
+  return absl::InternalError(
+      absl::StrCat(what, " failed for shared memory region ", name, ": ",
+                   std::strerror(errno)));
+}
+
+// Returns whether `name` is a /proc/<pid>/fd/<fd> path.
+bool IsProcFdPath(absl::string_view name) {
+  if (!absl::ConsumePrefix(&name, "/proc/")) {
+    return false;
+  }
+  std::vector<absl::string_view> parts = absl::StrSplit(name, '/');
+  uint32_t pid, fd;
+  return parts.size() == 3 && absl::SimpleAtoi(parts[0], &pid) &&
+         parts[1] == "fd" && absl::SimpleAtoi(parts[2], &fd);
+}
+
+// Returns whether `fd` refers to a memfd created by `Create()`. The link of an
+// open memfd reads "/memfd:<name> (deleted)".
+bool IsRegionMemfd(int fd) {
+  const std::string path = absl::StrCat("/proc/self/fd/", fd);
+  char target[256];
+  const ssize_t length = readlink(path.c_str(), target, sizeof(target));
+  return length > 0 && absl::StartsWith(absl::string_view(target, length),
+                                        absl::StrCat("/memfd:",
+                                                     kMemfdNamePrefix));
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<SharedMemoryRegion>> SharedMemoryRegion::Create(
+    size_t size) {
+  const std::string memfd_name =
+      absl::StrCat(kMemfdNamePrefix, absl::Hex(tsl::random::New64()));
+  int fd = memfd_create(memfd_name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) {
+    return ErrnoError("memfd_create", memfd_name);
+  }
+  // Seal the size, so that no process mapping the region can fault on
+  // accesses after another process truncated it.
+  if (ftruncate(fd, kHeaderSize + size) != 0 ||
+      fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+    absl::Status status = ErrnoError("ftruncate and seal", memfd_name);
+    close(fd);
+    return status;
+  }
+  void* base = mmap(nullptr, kHeaderSize + size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    absl::Status status = ErrnoError("mmap", memfd_name);
+    close(fd);
+    return status;
+  }
+
+  uint64_t token;
+  do {
+    token = tsl::random::New64();
+  } while (token == 0);
+  std::memcpy(base, &token, sizeof(token));
+  return std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion(
+      absl::StrCat("/proc/", getpid(), "/fd/", fd), static_cast<char*>(base),
+      size, token, fd));
+}
+
+absl::StatusOr<std::unique_ptr<SharedMemoryRegion>> SharedMemoryRegion::Open(
+    const std::string& name, size_t size, uint64_t token) {
+  if (!IsProcFdPath(name)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid shared memory region name ", name));
+  }
+  if (token == 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Shared memory region ", name, " has no token"));
+  }
+  int fd = open(name.c_str(), O_RDWR | O_CLOEXEC);
+  if (fd < 0) {
+    return ErrnoError("open", name);
+  }
+  absl::Cleanup close_fd = [fd] { close(fd); };
+  if (!IsRegionMemfd(fd)) {
+    return absl::PermissionDeniedError(absl::StrCat(
+        "Shared memory region ", name, " is not an IFRT proxy region"));
+  }
+  // Without the seal, the creator could shrink the file while it is mapped
+  // here, which turns accesses to the mapping into SIGBUS.
+  const int seals = fcntl(fd, F_GET_SEALS);
+  if (seals < 0 || (seals & F_SEAL_SHRINK) == 0) {
+    return absl::PermissionDeniedError(absl::StrCat(
+        "Shared memory region ", name, " is not sealed against shrinking"));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return ErrnoError("fstat", name);
+  }
+  if (st.st_size < 0 || static_cast<size_t>(st.st_size) < kHeaderSize + size) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Shared memory region ", name, " has ", st.st_size,
+                     " bytes; expected at least ", kHeaderSize + size));
+  }
+  void* base = mmap(nullptr, kHeaderSize + size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    return ErrnoError("mmap", name);
+  }
+
+  uint64_t region_token;
+  std::memcpy(&region_token, base, sizeof(region_token));
+  if (region_token != token) {
+    munmap(base, kHeaderSize + size);
+    return absl::PermissionDeniedError(absl::StrCat(
+        "Shared memory region ", name, " does not hold the expected token"));
+  }
+  return std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion(
+      name, static_cast<char*>(base), size, token, /*fd=*/-1));
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+  munmap(base_, kHeaderSize + size_);
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+#else  // defined(__linux__)
+
+absl::StatusOr<std::unique_ptr<SharedMemoryRegion>> SharedMemoryRegion::Create(
+    size_t size) {
+  return absl::UnimplementedError(
+      "Shared memory regions are only supported on Linux");
+}
+
+absl::StatusOr<std::unique_ptr<SharedMemoryRegion>> SharedMemoryRegion::Open(
+    const std::string& name, size_t size, uint64_t token) {
+  return absl::UnimplementedError(
+      "Shared memory regions are only supported on Linux");
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() = default;
+
+#endif  // defined(__linux__)
+
+}  // namespace proxy
+}  // namespace ifrt
+}  // namespace xla
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2023 The OpenXLA Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef XLA_PYTHON_IFRT_PROXY_COMMON_SHARED_MEMORY_H_
+#define XLA_PYTHON_IFRT_PROXY_COMMON_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+
+namespace xla {
+namespace ifrt {
+namespace proxy {
+
+// A shared memory region that lets an IFRT proxy client and a server running
+// on the same machine exchange host buffers without streaming them through
+// gRPC. The region is a sealed memfd whose size cannot change, so a peer
+// cannot make accesses to a mapping fault by truncating the file. It starts
+// with a header holding a random nonzero token, so that a server only uses a
+// region that it can prove it shares with the client.
+class SharedMemoryRegion {
+ public:
+  // Creates a new region that can hold `size` bytes of data. Its name is a
+  // /proc/<pid>/fd/<fd> path, valid until the region is destroyed; mappings
+  // that other processes opened stay valid.
+  static absl::StatusOr<std::unique_ptr<SharedMemoryRegion>> Create(
+      size_t size);
+
+  // Maps a region created by `Create()` in another process. Fails unless
+  // `name` is a /proc/<pid>/fd/<fd> path of a memfd created by `Create()`
+  // that is sealed against shrinking, is at least `size` bytes large and
+  // holds `token`, which must be nonzero.
+  static absl::StatusOr<std::unique_ptr<SharedMemoryRegion>> Open(
+      const std::string& name, size_t size, uint64_t token);
+
+  ~SharedMemoryRegion();
+
+  SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+  SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+  const std::string& name() const { return name_; }
+  uint64_t token() const { return token_; }
+
+  // The data part of the region, excluding the header.
+  char* data() const { return base_ + kHeaderSize; }
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr size_t kHeaderSize = 64;
+
+  SharedMemoryRegion(std::string name, char* base, size_t size, uint64_t token,
+                     int fd)
+      : name_(std::move(name)),
+        base_(base),
+        size_(size),
+        token_(token),
+        fd_(fd) {}
+
+  const std::string name_;
+  char* const base_;
+  const size_t size_;
+  const uint64_t token_;
+  // The memfd of a region made by `Create()`, which keeps `name_` valid, or -1.
+  const int fd_;
+};
+
+}  // namespace proxy
+}  // namespace ifrt
+}  // namespace xla
+
+#endif  // XLA_PYTHON_IFRT_PROXY_COMMON_SHARED_MEMORY_H_
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 The OpenXLA Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/cleanup/cleanup.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace ifrt {
+namespace proxy {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+TEST(SharedMemoryRegionTest, OpenSeesCreatedRegion) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharedMemoryRegion> created,
+                          SharedMemoryRegion::Create(1024));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryRegion> opened,
+      SharedMemoryRegion::Open(created->name(), 1024, created->token()));
+
+  const std::string data = "host buffer";
+  std::memcpy(created->data(), data.data(), data.size());
+  EXPECT_EQ(absl::string_view(opened->data(), data.size()), data);
+
+  std::memcpy(opened->data() + 512, data.data(), data.size());
+  EXPECT_EQ(absl::string_view(created->data() + 512, data.size()), data);
+}
+
+TEST(SharedMemoryRegionTest, OpenChecksTokenAndSize) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharedMemoryRegion> created,
+                          SharedMemoryRegion::Create(1024));
+  EXPECT_THAT(
+      SharedMemoryRegion::Open(created->name(), 1024, created->token() + 1),
+      StatusIs(absl::StatusCode::kPermissionDenied));
+  EXPECT_THAT(
+      SharedMemoryRegion::Open(created->name(), 4096, created->token()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+#if defined(__linux__)
+TEST(SharedMemoryRegionTest, OpenRejectsOtherFiles) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharedMemoryRegion> created,
+                          SharedMemoryRegion::Create(16));
+  EXPECT_NE(created->token(), 0);
+  EXPECT_THAT(SharedMemoryRegion::Open(created->name(), 16, 0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(SharedMemoryRegion::Open("/dev/shm/ifrt_proxy_region", 16, 1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      SharedMemoryRegion::Open(absl::StrCat(created->name(), "/../../maps"),
+                               16, created->token()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // A memfd that is not sealed could be truncated while it is mapped.
+  int fd = memfd_create("ifrt_proxy_unsealed", MFD_CLOEXEC);
+  ASSERT_GE(fd, 0);
+  absl::Cleanup close_fd = [fd] { close(fd); };
+  ASSERT_EQ(ftruncate(fd, 4096), 0);
+  EXPECT_THAT(SharedMemoryRegion::Open(
+                  absl::StrCat("/proc/", getpid(), "/fd/", fd), 16, 1),
+              StatusIs(absl::StatusCode::kPermissionDenied));
+}
+
+TEST(SharedMemoryRegionTest, RegionCannotBeResized) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharedMemoryRegion> created,
+                          SharedMemoryRegion::Create(16));
+  int fd = open(created->name().c_str(), O_RDWR | O_CLOEXEC);
+  ASSERT_GE(fd, 0);
+  absl::Cleanup close_fd = [fd] { close(fd); };
+  EXPECT_NE(ftruncate(fd, 0), 0);
+  EXPECT_NE(ftruncate(fd, 1 << 20), 0);
+}
+#endif  // defined(__linux__)
+
+TEST(SharedMemoryRegionTest, NameIsInvalidAfterDestruction) {
+  std::string name;
+  uint64_t token;
+  {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharedMemoryRegion> created,
+                            SharedMemoryRegion::Create(16));
+    name = created->name();
+    token = created->token();
+  }
+  EXPECT_FALSE(SharedMemoryRegion::Open(name, 16, token).ok());
+}
+
+}  // namespace
+}  // namespace proxy
+}  // namespace ifrt
+}  // namespace xla
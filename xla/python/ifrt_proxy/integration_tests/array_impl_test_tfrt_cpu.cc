@@ -28,6 +28,7 @@ int main(int argc, char** argv) {
       // TODO(b/282757875): Enable the test once IFRT implements
       // `ShardingParamShardingSerDes`.
       "ArrayImplTest.AssembleAndDisassembleArray",
+      "ArrayImplTest.MakeShardedArrayFromHostBufferAndCopyToHostBuffer",
   };
 
   const std::string filter = absl::StrCat("-", absl::StrJoin(disabled, ":"));
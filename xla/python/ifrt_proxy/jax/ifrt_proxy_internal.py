@@ -35,10 +35,15 @@ class ConnectionOptions:
     on_connection_update: Optional, a callback that will be called with status
       updates about initial connection establishment. The updates will be
       provided as human-readable strings, and an end-user may find them helpful.
+    host_buffer_shared_memory_size: Optional, the size in bytes of a shared
+      memory region offered to the proxy server. If the server runs on the
+      same machine, host buffers that fit into the region are copied through it
+      instead of being sent over the connection. 0 disables the region.
   """
 
   on_disconnect: Optional[Callable[[str], None]] = None
   on_connection_update: Optional[Callable[[str], None]] = None
+  host_buffer_shared_memory_size: int = 0
 
 
 _backend_created: bool = False
@@ -53,6 +58,9 @@ def get_client(proxy_server_address: str) -> xla_client.Client:
   cpp_options = py_module.ClientConnectionOptions()
   cpp_options.on_disconnect = _connection_options.on_disconnect
   cpp_options.on_connection_update = _connection_options.on_connection_update
+  cpp_options.host_buffer_shared_memory_size = (
+      _connection_options.host_buffer_shared_memory_size
+  )
   client = py_module.get_client(proxy_server_address, cpp_options)
   return client
 
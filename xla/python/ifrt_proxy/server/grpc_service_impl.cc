@@ -15,7 +15,9 @@
 #include "xla/python/ifrt_proxy/server/grpc_service_impl.h"
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -33,6 +35,7 @@
 #include "xla/pjrt/distributed/util.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.pb.h"
 #include "xla/python/ifrt_proxy/common/proto_util.h"
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
 #include "xla/python/ifrt_proxy/server/host_buffer.h"
 #include "xla/python/ifrt_proxy/server/version.h"
 
@@ -77,16 +80,41 @@ namespace proxy {
 
   VLOG(0) << "Starting a new IFRT session with session_id=" << session_id;
 
+  // Use the client's shared memory region for host buffers if the client runs
+  // on this machine. Otherwise host buffers are streamed.
+  std::shared_ptr<SharedMemoryRegion> shared_memory;
+  if (metadata.has_host_buffer_shared_memory() &&
+      metadata.host_buffer_shared_memory().size() > 0) {
+    // `Open` only accepts sealed regions made by `SharedMemoryRegion::Create`
+    // that hold the nonzero token, so the region cannot be any other file
+    // and cannot shrink under the copies in `HostBufferStore` and `Lookup`.
+    const GrpcSharedMemoryRegion& region = metadata.host_buffer_shared_memory();
+    auto opened =
+        SharedMemoryRegion::Open(region.name(), region.size(), region.token());
+    if (opened.ok()) {
+      VLOG(1) << "Session " << session_id << " uses shared memory region "
+              << region.name() << " for host buffers";
+      shared_memory = *std::move(opened);
+    } else {
+      VLOG(1) << "Session " << session_id
+              << " streams host buffers: " << opened.status();
+    }
+  }
+
   // Create a host buffer store for the session.
   auto host_buffer_store =
       std::make_shared<xla::ifrt::proxy::HostBufferStore>();
   {
     absl::MutexLock l(&host_buffer_store_mu_);
     CHECK(host_buffer_stores_.insert({session_id, host_buffer_store}).second);
+    if (shared_memory != nullptr) {
+      shared_memory_regions_[session_id] = std::move(shared_memory);
+    }
   }
   absl::Cleanup cleanup = [&] {
     absl::MutexLock l(&host_buffer_store_mu_);
     CHECK_GT(host_buffer_stores_.erase(session_id), 0);
+    shared_memory_regions_.erase(session_id);
   };
 
   auto backend = backend_factory_(metadata.version(), session_id,
@@ -147,10 +175,36 @@ namespace proxy {
   }
 
   std::string data;
+  if (metadata.in_shared_memory()) {
+    std::shared_ptr<SharedMemoryRegion> shared_memory =
+        GetSharedMemoryRegion(metadata.session_id());
+    if (shared_memory == nullptr || metadata.buffer_size() < 0 ||
+        static_cast<size_t>(metadata.buffer_size()) > shared_memory->size()) {
+      return ::grpc::Status(
+          ::grpc::StatusCode::FAILED_PRECONDITION,
+          absl::StrCat("Session ", metadata.session_id(),
+                       " has no shared memory region for a host buffer of ",
+                       metadata.buffer_size(), " bytes"));
+    }
+    data.assign(shared_memory->data(), metadata.buffer_size());
+    auto store = GetHostBufferStore(metadata.session_id());
+    if (!store.ok()) {
+      return xla::ToGrpcStatus(store.status());
+    }
+    return xla::ToGrpcStatus(
+        (*store)->Store(metadata.handle(), std::move(data)));
+  }
   data.reserve(metadata.buffer_size());
 
   GrpcHostBufferStoreRequest request;
   while (stream->Read(&request)) {
+#if !defined(PLATFORM_GOOGLE)
+    // Buffers that fit into a single chunk are taken over without a copy.
+    if (data.empty() && request.data().size() == metadata.buffer_size()) {
+      data = std::move(*request.mutable_data());
+      continue;
+    }
+#endif
     data.append(request.data());
   }
   if (data.size() != metadata.buffer_size()) {
@@ -183,6 +237,18 @@ namespace proxy {
   }
 
   GrpcHostBufferLookupResponse response;
+  if (request->allow_shared_memory()) {
+    std::shared_ptr<SharedMemoryRegion> shared_memory =
+        GetSharedMemoryRegion(request->session_id());
+    if (shared_memory != nullptr && (*data)->size() <= shared_memory->size()) {
+      std::memcpy(shared_memory->data(), (*data)->data(), (*data)->size());
+      response.set_in_shared_memory(true);
+      response.set_shared_memory_size((*data)->size());
+      stream->Write(response);
+      return ::grpc::Status::OK;
+    }
+  }
+
   if (!(*data)->empty()) {
     for (int64_t offset = 0; offset < (*data)->size(); offset += kChunkSize) {
 #if defined(PLATFORM_GOOGLE)
@@ -222,9 +288,16 @@ bool GrpcServiceImpl::Test_InsertHostBufferStore(
 
 bool GrpcServiceImpl::Test_DeleteHostBufferStore(uint64_t session_id) {
   absl::MutexLock l(&host_buffer_store_mu_);
+  shared_memory_regions_.erase(session_id);
   return host_buffer_stores_.erase(session_id) > 0;
 }
 
+bool GrpcServiceImpl::Test_InsertSharedMemoryRegion(
+    uint64_t session_id, std::shared_ptr<SharedMemoryRegion> region) {
+  absl::MutexLock l(&host_buffer_store_mu_);
+  return shared_memory_regions_.insert({session_id, std::move(region)}).second;
+}
+
 absl::StatusOr<std::shared_ptr<xla::ifrt::proxy::HostBufferStore>>
 GrpcServiceImpl::GetHostBufferStore(uint64_t session_id) {
   absl::MutexLock l(&host_buffer_store_mu_);
@@ -236,6 +309,16 @@ GrpcServiceImpl::GetHostBufferStore(uint64_t session_id) {
   return it->second;
 }
 
+std::shared_ptr<SharedMemoryRegion> GrpcServiceImpl::GetSharedMemoryRegion(
+    uint64_t session_id) {
+  absl::MutexLock l(&host_buffer_store_mu_);
+  const auto it = shared_memory_regions_.find(session_id);
+  if (it == shared_memory_regions_.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
 }  // namespace proxy
 }  // namespace ifrt
 }  // namespace xla
@@ -34,6 +34,7 @@
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.grpc.pb.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.pb.h"
 #include "xla/python/ifrt_proxy/common/ifrt_service.pb.h"
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
 #include "xla/python/ifrt_proxy/server/host_buffer.h"
 #include "xla/python/ifrt_proxy/server/ifrt_backend.h"
 
@@ -86,11 +87,21 @@ class GrpcServiceImpl : public grpc::GrpcIfrtService::Service {
   // store map. Returns false if the session id does not exist.
   bool Test_DeleteHostBufferStore(uint64_t session_id);
 
+  // Test-only method that makes the given session use `region` for host
+  // buffer transfers. Returns false if the session already uses a region.
+  bool Test_InsertSharedMemoryRegion(
+      uint64_t session_id, std::shared_ptr<SharedMemoryRegion> region);
+
  private:
   absl::StatusOr<std::shared_ptr<xla::ifrt::proxy::HostBufferStore>>
   GetHostBufferStore(uint64_t session_id)
       ABSL_LOCKS_EXCLUDED(host_buffer_store_mu_);
 
+  // Returns the shared memory region of the session, or nullptr if the
+  // session's host buffers are streamed.
+  std::shared_ptr<SharedMemoryRegion> GetSharedMemoryRegion(uint64_t session_id)
+      ABSL_LOCKS_EXCLUDED(host_buffer_store_mu_);
+
   BackendFactory backend_factory_;
   std::atomic<uint64_t> next_session_id_ = 1;
 
@@ -98,6 +109,8 @@ class GrpcServiceImpl : public grpc::GrpcIfrtService::Service {
   absl::flat_hash_map<uint64_t,
                       std::shared_ptr<xla::ifrt::proxy::HostBufferStore>>
       host_buffer_stores_ ABSL_GUARDED_BY(host_buffer_store_mu_);
+  absl::flat_hash_map<uint64_t, std::shared_ptr<SharedMemoryRegion>>
+      shared_memory_regions_ ABSL_GUARDED_BY(host_buffer_store_mu_);
 };
 
 }  // namespace proxy
@@ -14,6 +14,7 @@
 
 #include "xla/python/ifrt_proxy/server/grpc_service_impl.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -33,10 +34,12 @@
 #include "xla/python/ifrt_proxy/client/grpc_host_buffer.h"
 #include "xla/python/ifrt_proxy/common/grpc_ifrt_service.grpc.pb.h"
 #include "xla/python/ifrt_proxy/common/ifrt_service.pb.h"
+#include "xla/python/ifrt_proxy/common/shared_memory.h"
 #include "xla/python/ifrt_proxy/server/grpc_server.h"
 #include "xla/python/ifrt_proxy/server/host_buffer.h"
 #include "xla/python/ifrt_proxy/server/version.h"
 #include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
 
 namespace xla {
@@ -138,6 +141,55 @@ TEST_P(GrpcIfrtServiceImplHostBufferTest, StoreAndLookupCord) {
   EXPECT_TRUE(impl_.Test_DeleteHostBufferStore(kSessionId));
 }
 
+TEST_P(GrpcIfrtServiceImplHostBufferTest, StoreAndLookupInSharedMemory) {
+  static constexpr uint64_t kSessionId = 1;
+  static constexpr size_t kSharedMemorySize = 64 * 1024;
+
+  auto store = std::make_shared<HostBufferStore>();
+  ASSERT_TRUE(impl_.Test_InsertHostBufferStore(kSessionId, store));
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<SharedMemoryRegion> client_region,
+                          SharedMemoryRegion::Create(kSharedMemorySize));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<SharedMemoryRegion> server_region,
+      SharedMemoryRegion::Open(client_region->name(), kSharedMemorySize,
+                               client_region->token()));
+  ASSERT_TRUE(impl_.Test_InsertSharedMemoryRegion(kSessionId, server_region));
+  GrpcClientHostBufferStore client(stub_, Version(), kSessionId,
+                                   client_region);
+
+  // Buffers that do not fit into the region are streamed.
+  constexpr uint64_t kHandle = 2;
+  const std::string data = GetTestData();
+  ASSERT_THAT(client.Store(kHandle, absl::Cord(data)).Await(), IsOk());
+  EXPECT_THAT(store->Lookup(kHandle),
+              IsOkAndHolds(testing::Pointee(data)));
+  EXPECT_THAT(client.Lookup(kHandle).Await(), IsOkAndHolds(data));
+  if (data.size() <= kSharedMemorySize) {
+    EXPECT_EQ(absl::string_view(server_region->data(), data.size()), data);
+  }
+
+  EXPECT_TRUE(impl_.Test_DeleteHostBufferStore(kSessionId));
+}
+
+TEST_P(GrpcIfrtServiceImplHostBufferTest,
+       FallsBackToStreamingIfServerHasNoSharedMemory) {
+  static constexpr uint64_t kSessionId = 1;
+
+  auto store = std::make_shared<HostBufferStore>();
+  ASSERT_TRUE(impl_.Test_InsertHostBufferStore(kSessionId, store));
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<SharedMemoryRegion> client_region,
+                          SharedMemoryRegion::Create(GetParam() + 1));
+  GrpcClientHostBufferStore client(stub_, Version(), kSessionId,
+                                   client_region);
+
+  constexpr uint64_t kHandle = 2;
+  const std::string data = GetTestData();
+  ASSERT_THAT(client.Store(kHandle, absl::string_view(data)).Await(), IsOk());
+  EXPECT_THAT(client.Lookup(kHandle).Await(), IsOkAndHolds(data));
+
+  EXPECT_TRUE(impl_.Test_DeleteHostBufferStore(kSessionId));
+}
+
 TEST_P(GrpcIfrtServiceImplHostBufferTest, Lookup) {
   static constexpr uint64_t kSessionId = 1;
 
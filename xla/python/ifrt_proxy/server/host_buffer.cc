@@ -14,28 +14,87 @@
 
 #include "xla/python/ifrt_proxy/server/host_buffer.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xla/python/ifrt/future.h"
+#include "tsl/platform/env.h"
 
 namespace xla {
 namespace ifrt {
 namespace proxy {
 
+HostBufferStore::~HostBufferStore() {
+  CancelPendingTakes();
+  std::unique_ptr<tsl::Thread> sweeper;
+  {
+    absl::MutexLock lock(&mu_);
+    shutting_down_ = true;
+    sweeper = std::move(sweeper_);
+  }
+  deadlines_changed_.Signal();
+  // The thread's destructor waits for the sweeper to exit.
+  sweeper.reset();
+}
+
+void HostBufferStore::CancelPendingTakes() {
+  std::vector<std::pair<uint64_t, Promise<std::shared_ptr<const std::string>>>>
+      promises;
+  {
+    absl::MutexLock lock(&mu_);
+    for (auto& [handle, pending] : pending_takes_) {
+      if (pending.promise.has_value()) {
+        promises.push_back({handle, *std::move(pending.promise)});
+        pending.promise.reset();
+      }
+    }
+  }
+  for (auto& [handle, promise] : promises) {
+    promise.Set(absl::CancelledError(absl::StrCat(
+        "Waiting for host buffer handle ", handle, " was cancelled")));
+  }
+}
+
+void HostBufferStore::ErasePendingTake(uint64_t handle) {
+  auto it = pending_takes_.find(handle);
+  if (it == pending_takes_.end()) return;
+  deadlines_.erase({it->second.deadline, handle});
+  pending_takes_.erase(it);
+}
+
 absl::Status HostBufferStore::Store(uint64_t handle, std::string data) {
-  absl::MutexLock lock(&mu_);
-  const bool inserted =
-      buffers_.insert({handle, std::make_shared<std::string>(std::move(data))})
-          .second;
-  if (!inserted) {
-    return absl::AlreadyExistsError(
-        absl::StrCat("Host buffer handle ", handle, " already exists"));
+  auto buffer = std::make_shared<const std::string>(std::move(data));
+
+  std::optional<Promise<std::shared_ptr<const std::string>>> promise;
+  {
+    absl::MutexLock lock(&mu_);
+    if (buffers_.contains(handle)) {
+      return absl::AlreadyExistsError(
+          absl::StrCat("Host buffer handle ", handle, " already exists"));
+    }
+    auto it = pending_takes_.find(handle);
+    if (it == pending_takes_.end()) {
+      buffers_.insert({handle, std::move(buffer)});
+      return absl::OkStatus();
+    }
+    promise = std::move(it->second.promise);
+    ErasePendingTake(handle);
+  }
+
+  // Hand the buffer to the waiting take. If the take has already timed out,
+  // nobody will claim the buffer and it is dropped here.
+  if (promise.has_value()) {
+    promise->Set(std::move(buffer));
   }
   return absl::OkStatus();
 }
@@ -51,6 +110,85 @@ absl::StatusOr<std::shared_ptr<const std::string>> HostBufferStore::Lookup(
   return it->second;
 }
 
+Future<std::shared_ptr<const std::string>> HostBufferStore::Take(
+    uint64_t handle, absl::Duration timeout) {
+  auto promise = Future<std::shared_ptr<const std::string>>::CreatePromise();
+  absl::MutexLock lock(&mu_);
+  if (auto it = buffers_.find(handle); it != buffers_.end()) {
+    std::shared_ptr<const std::string> buffer = std::move(it->second);
+    buffers_.erase(it);
+    return Future<std::shared_ptr<const std::string>>(std::move(buffer));
+  }
+  if (auto it = pending_takes_.find(handle); it != pending_takes_.end()) {
+    if (it->second.promise.has_value()) {
+      return Future<std::shared_ptr<const std::string>>(
+          absl::AlreadyExistsError(absl::StrCat(
+              "Host buffer handle ", handle, " is already being taken")));
+    }
+    // A new take for the handle of a tombstone replaces it.
+    ErasePendingTake(handle);
+  }
+
+  absl::Time deadline = absl::InfiniteFuture();
+  if (timeout != absl::InfiniteDuration()) {
+    deadline = absl::Now() + timeout;
+    if (deadlines_.empty() || deadline < deadlines_.begin()->first) {
+      deadlines_changed_.Signal();
+    }
+    deadlines_.insert({deadline, handle});
+    if (sweeper_ == nullptr) {
+      sweeper_.reset(tsl::Env::Default()->StartThread(
+          tsl::ThreadOptions(), "host_buffer_store_sweeper",
+          [this]() { SweepPendingTakes(); }));
+    }
+  }
+  pending_takes_.insert({handle, PendingTake{promise, timeout, deadline}});
+  return Future<std::shared_ptr<const std::string>>(std::move(promise));
+}
+
+void HostBufferStore::SweepPendingTakes() {
+  absl::MutexLock lock(&mu_);
+  while (!shutting_down_) {
+    absl::Time now = absl::Now();
+    std::vector<std::pair<uint64_t, PendingTake>> timed_out;
+    while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+      uint64_t handle = deadlines_.begin()->second;
+      deadlines_.erase(deadlines_.begin());
+      auto it = pending_takes_.find(handle);
+      PendingTake& pending = it->second;
+      if (!pending.promise.has_value()) {
+        // The tombstone's grace period is over.
+        pending_takes_.erase(it);
+        continue;
+      }
+      // Keep a tombstone for another timeout, so that a buffer which arrives
+      // shortly after is dropped rather than kept until the end of the
+      // session.
+      timed_out.push_back({handle, PendingTake{*std::move(pending.promise),
+                                               pending.timeout,
+                                               pending.deadline}});
+      pending.promise.reset();
+      pending.deadline = now + pending.timeout;
+      deadlines_.insert({pending.deadline, handle});
+    }
+
+    if (!timed_out.empty()) {
+      mu_.Unlock();
+      for (auto& [handle, pending] : timed_out) {
+        pending.promise->Set(absl::NotFoundError(absl::StrCat(
+            "Host buffer handle ", handle, " not found after waiting for ",
+            absl::FormatDuration(pending.timeout))));
+      }
+      mu_.Lock();
+      continue;
+    }
+
+    absl::Time next_deadline =
+        deadlines_.empty() ? absl::InfiniteFuture() : deadlines_.begin()->first;
+    deadlines_changed_.WaitWithDeadline(&mu_, next_deadline);
+  }
+}
+
 absl::Status HostBufferStore::Delete(uint64_t handle) {
   absl::MutexLock lock(&mu_);
   if (buffers_.erase(handle) == 0) {
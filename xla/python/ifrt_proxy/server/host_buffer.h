@@ -17,13 +17,20 @@
 #ifndef XLA_PYTHON_IFRT_PROXY_SERVER_HOST_BUFFER_H_
 #define XLA_PYTHON_IFRT_PROXY_SERVER_HOST_BUFFER_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xla/python/ifrt/future.h"
+#include "tsl/platform/env.h"
 
 namespace xla {
 namespace ifrt {
@@ -36,6 +43,15 @@ namespace proxy {
 // instance) so that host buffers are cleaned up on session termination.
 class HostBufferStore {
  public:
+  HostBufferStore() = default;
+
+  // Fails all pending `Take`s with a cancelled error.
+  ~HostBufferStore();
+
+  // Fails all pending `Take`s with a cancelled error. Buffers stored later for
+  // their handles are dropped.
+  void CancelPendingTakes();
+
   // Stores the data associated with the given handle. Returns an error if the
   // handle already exists.
   absl::Status Store(uint64_t handle, std::string data);
@@ -44,14 +60,50 @@ class HostBufferStore {
   // handle does not exist.
   absl::StatusOr<std::shared_ptr<const std::string>> Lookup(uint64_t handle);
 
+  // Retrieves the data associated with the handle and removes it from the
+  // store. If the handle has not been stored yet, the returned future becomes
+  // ready when it is. This allows clients to send requests that consume a host
+  // buffer before the buffer's store has completed. If the handle is not stored
+  // within `timeout`, the future fails with a not-found error. Data stored for
+  // the handle within another `timeout` after that is dropped, so that an
+  // unclaimed buffer is not kept until the end of the session.
+  Future<std::shared_ptr<const std::string>> Take(uint64_t handle,
+                                                  absl::Duration timeout);
+
   // Deletes the host buffer associated with the handle. Returns an error if the
   // handle does not exist.
   absl::Status Delete(uint64_t handle);
 
  private:
+  // A `Take` waiting for its handle to be stored.
+  struct PendingTake {
+    // Reset once the take is cancelled or times out. The entry then remains as
+    // a tombstone, so that data stored later for the handle is dropped.
+    std::optional<Promise<std::shared_ptr<const std::string>>> promise;
+    absl::Duration timeout;
+    // When the take times out, or the tombstone is erased. Infinite if the
+    // take has no timeout.
+    absl::Time deadline;
+  };
+
+  // Erases the entry of `handle` from `pending_takes_` and `deadlines_`.
+  void ErasePendingTake(uint64_t handle) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Runs on `sweeper_`. Fails takes that time out and erases tombstones whose
+  // grace period is over, in deadline order.
+  void SweepPendingTakes();
+
   absl::Mutex mu_;
+  absl::CondVar deadlines_changed_;
   absl::flat_hash_map<uint64_t, std::shared_ptr<const std::string>> buffers_
       ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<uint64_t, PendingTake> pending_takes_
+      ABSL_GUARDED_BY(mu_);
+  // Finite deadlines of `pending_takes_`, earliest first.
+  std::set<std::pair<absl::Time, uint64_t>> deadlines_ ABSL_GUARDED_BY(mu_);
+  bool shutting_down_ ABSL_GUARDED_BY(mu_) = false;
+  // Started by the first `Take` with a finite timeout.
+  std::unique_ptr<tsl::Thread> sweeper_ ABSL_GUARDED_BY(mu_);
 };
 
 }  // namespace proxy
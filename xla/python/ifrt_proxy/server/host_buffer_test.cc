@@ -15,11 +15,16 @@
 #include "xla/python/ifrt_proxy/server/host_buffer.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/log/check.h"
 #include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/status_matchers.h"
 
 namespace xla {
@@ -51,6 +56,92 @@ TEST(HostBufferStoreTest, UnknownHandle) {
   EXPECT_THAT(store.Delete(kHandle), StatusIs(absl::StatusCode::kNotFound));
 }
 
+TEST(HostBufferStoreTest, TakeStoredBuffer) {
+  HostBufferStore store;
+  const uint64_t kHandle = 1;
+
+  ASSERT_THAT(store.Store(kHandle, "foo"), IsOk());
+  EXPECT_THAT(store.Take(kHandle, absl::InfiniteDuration()).Await(),
+              IsOkAndHolds(Pointee(std::string("foo"))));
+  EXPECT_THAT(store.Lookup(kHandle), StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(HostBufferStoreTest, TakeWaitsForStore) {
+  HostBufferStore store;
+  const uint64_t kHandle = 1;
+
+  auto buffer = store.Take(kHandle, absl::InfiniteDuration());
+  EXPECT_FALSE(buffer.IsReady());
+
+  std::unique_ptr<tsl::Thread> thread(tsl::Env::Default()->StartThread(
+      tsl::ThreadOptions(), "store", [&]() {
+        absl::SleepFor(absl::Milliseconds(10));
+        CHECK_OK(store.Store(kHandle, "foo"));
+      }));
+  EXPECT_THAT(buffer.Await(), IsOkAndHolds(Pointee(std::string("foo"))));
+  thread.reset();
+  EXPECT_THAT(store.Lookup(kHandle), StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(HostBufferStoreTest, TakeTimesOutAndDropsLateBuffer) {
+  HostBufferStore store;
+  const uint64_t kHandle = 1;
+
+  EXPECT_THAT(store.Take(kHandle, absl::Milliseconds(1)).Await(),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  // Nobody claims a buffer that arrives after the timeout, so it isn't kept.
+  ASSERT_THAT(store.Store(kHandle, "foo"), IsOk());
+  EXPECT_THAT(store.Lookup(kHandle), StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(HostBufferStoreTest, TombstoneOfTimedOutTakeExpires) {
+  HostBufferStore store;
+  const uint64_t kHandle = 1;
+  const absl::Duration kTimeout = absl::Milliseconds(1);
+
+  EXPECT_THAT(store.Take(kHandle, kTimeout).Await(),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  // Once the grace period after the timeout is over, the handle is forgotten
+  // and a buffer stored for it is kept again.
+  absl::SleepFor(10 * kTimeout);
+  ASSERT_THAT(store.Store(kHandle, "foo"), IsOk());
+  EXPECT_THAT(store.Lookup(kHandle), IsOkAndHolds(Pointee(std::string("foo"))));
+}
+
+TEST(HostBufferStoreTest, ShortTimeoutExpiresBeforeLongerOnes) {
+  HostBufferStore store;
+
+  auto long_take = store.Take(1, absl::Hours(1));
+  EXPECT_THAT(store.Take(2, absl::Milliseconds(1)).Await(),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_FALSE(long_take.IsReady());
+
+  ASSERT_THAT(store.Store(1, "foo"), IsOk());
+  EXPECT_THAT(long_take.Await(), IsOkAndHolds(Pointee(std::string("foo"))));
+}
+
+TEST(HostBufferStoreTest, ResolvedTakesDoNotOutliveTheStore) {
+  // Takes with a long timeout which are resolved by a store must not keep
+  // anything waiting for their timeout, e.g. the destruction of the store.
+  HostBufferStore store;
+  for (uint64_t handle = 0; handle < 1000; ++handle) {
+    auto buffer = store.Take(handle, absl::Minutes(10));
+    ASSERT_THAT(store.Store(handle, "foo"), IsOk());
+    EXPECT_THAT(buffer.Await(), IsOkAndHolds(Pointee(std::string("foo"))));
+  }
+}
+
+TEST(HostBufferStoreTest, CancelPendingTakes) {
+  HostBufferStore store;
+  const uint64_t kHandle = 1;
+
+  auto buffer = store.Take(kHandle, absl::InfiniteDuration());
+  store.CancelPendingTakes();
+  EXPECT_THAT(buffer.Await(), StatusIs(absl::StatusCode::kCancelled));
+}
+
 }  // namespace
 }  // namespace proxy
 }  // namespace ifrt
@@ -14,9 +14,11 @@
 
 #include "xla/python/ifrt_proxy/server/ifrt_backend.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <list>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -36,6 +38,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "llvm/Support/Casting.h"
 #include "xla/layout.h"
@@ -78,6 +81,13 @@ namespace xla {
 namespace ifrt {
 namespace proxy {
 
+// How long a request waits for a host buffer that the client is still
+// storing. Large buffers over slow links can take a while.
+constexpr absl::Duration kHostBufferLookupTimeout = absl::Minutes(10);
+
+// Maximum number of programs the server remembers by fingerprint.
+constexpr size_t kMaxCachedPrograms = 64;
+
 IfrtBackend::IfrtBackend(IfrtProxyVersion version, uint64_t session_id,
                          std::shared_ptr<xla::ifrt::Client> ifrt_client,
                          std::shared_ptr<HostBufferStore> host_buffer_store)
@@ -136,7 +146,12 @@ IfrtBackend::~IfrtBackend() {
         .status.Set(absl::CancelledError("IFRT backend has shut down"));
   }
 
-  // Wait until all async work from `AsyncExecute` finishes execution.
+  // Fail requests that still wait for their host buffers, so that the wait
+  // below doesn't block until their lookups time out.
+  host_buffer_store_->CancelPendingTakes();
+
+  // Wait until all async work from `AsyncExecute` and in-flight
+  // `MakeArrayFromHostBuffer` requests finish execution.
   {
     auto done = [this]() ABSL_SHARED_LOCKS_REQUIRED(in_flight_count_mutex_) {
       return in_flight_count_ == 0;
@@ -153,8 +168,7 @@ Future<BackendInterface::Response> IfrtBackend::Process(
     case IfrtRequest::RequestCase::kCheckFutureRequest:
       return HandleCheckFutureRequest(std::move(request));
     case IfrtRequest::RequestCase::kMakeArrayFromHostBufferRequest:
-      return Future<Response>(
-          HandleMakeArrayFromHostBufferRequest(std::move(request)));
+      return HandleMakeArrayFromHostBufferRequest(std::move(request));
     case IfrtRequest::RequestCase::kAssembleArrayFromSingleDeviceArraysRequest:
       return Future<Response>(
           HandleAssembleArrayFromSingleDeviceArraysRequest(std::move(request)));
@@ -378,14 +392,45 @@ Future<BackendInterface::Response> IfrtBackend::HandleCheckValueReadyRequest(
   return ifrt_response_future;
 }
 
-absl::StatusOr<BackendInterface::Response>
+Future<BackendInterface::Response>
 IfrtBackend::HandleMakeArrayFromHostBufferRequest(
     std::unique_ptr<IfrtRequest> request) {
   if (!request->has_make_array_from_host_buffer_request()) {
-    return absl::InternalError(
+    return Future<Response>(absl::InternalError(
         "MakeArrayFromHostBuffer got an IfrtRequest with no "
-        "MakeArrayFromHostBufferRequest in it.");
+        "MakeArrayFromHostBufferRequest in it."));
+  }
+  const uint64_t host_buffer_handle =
+      request->make_array_from_host_buffer_request().host_buffer_handle();
+
+  // Since protocol version 4, clients may send this request before the store
+  // of the host buffer has completed. The array is made once the buffer
+  // arrives, without blocking the processing of the requests that follow.
+  {
+    absl::MutexLock lock(&in_flight_count_mutex_);
+    ++in_flight_count_;
   }
+  auto promise = Future<Response>::CreatePromise();
+  host_buffer_store_->Take(host_buffer_handle, kHostBufferLookupTimeout)
+      .OnReady([this, promise, request = std::move(request)](
+                   absl::StatusOr<std::shared_ptr<const std::string>>
+                       host_buffer) mutable {
+        if (host_buffer.ok()) {
+          promise.Set(MakeArrayFromHostBuffer(std::move(request),
+                                              *std::move(host_buffer)));
+        } else {
+          promise.Set(host_buffer.status());
+        }
+        absl::MutexLock lock(&in_flight_count_mutex_);
+        --in_flight_count_;
+      });
+  return Future<Response>(std::move(promise));
+}
+
+absl::StatusOr<BackendInterface::Response>
+IfrtBackend::MakeArrayFromHostBuffer(
+    std::unique_ptr<IfrtRequest> request,
+    std::shared_ptr<const std::string> host_buffer) {
   auto* make_array_request =
       request->mutable_make_array_from_host_buffer_request();
 
@@ -403,14 +448,6 @@ IfrtBackend::HandleMakeArrayFromHostBufferRequest(
   TF_ASSIGN_OR_RETURN(const auto dtype,
                       DType::FromProto(make_array_request->dtype()));
 
-  const uint64_t host_buffer_handle = make_array_request->host_buffer_handle();
-  absl::Cleanup cleanup = [&] {
-    CHECK_OK(host_buffer_store_->Delete(host_buffer_handle));
-  };
-  TF_ASSIGN_OR_RETURN(std::shared_ptr<const std::string> host_buffer,
-                      host_buffer_store_->Lookup(host_buffer_handle));
-  std::move(cleanup).Invoke();
-
   TF_ASSIGN_OR_RETURN(const auto mem_region,
                       ArrayMemRegion::FromMinimalMemRegion(
                           *host_buffer, dtype, shape, byte_strides));
@@ -794,11 +831,57 @@ IfrtBackend::HandleDestructArrayRequest(std::unique_ptr<IfrtRequest> request) {
 
 Future<BackendInterface::Response> IfrtBackend::HandleCompileRequest(
     std::unique_ptr<IfrtRequest> request) {
+  // Resolve the program before going to the thread pool, so that a request
+  // referencing a program by fingerprint sees all programs sent before it.
+  std::shared_ptr<const Serialized> serialized_program;
+  {
+    CompileRequest* compile_request = request->mutable_compile_request();
+    const tsl::Fprint128 fingerprint{
+        compile_request->program_fingerprint_low(),
+        compile_request->program_fingerprint_high()};
+    const bool has_fingerprint =
+        fingerprint.low64 != 0 || fingerprint.high64 != 0;
+    if (compile_request->has_program() || !has_fingerprint) {
+      serialized_program = std::make_shared<const Serialized>(
+          std::move(*compile_request->mutable_program()));
+      if (has_fingerprint) {
+        absl::MutexLock lock(&programs_mutex_);
+        auto [it, inserted] = programs_.try_emplace(fingerprint);
+        if (inserted) {
+          programs_lru_.push_front(fingerprint);
+        } else {
+          programs_lru_.splice(programs_lru_.begin(), programs_lru_,
+                               it->second.lru_position);
+        }
+        it->second = {serialized_program, programs_lru_.begin()};
+        if (programs_.size() > kMaxCachedPrograms) {
+          programs_.erase(programs_lru_.back());
+          programs_lru_.pop_back();
+        }
+      }
+    } else {
+      absl::MutexLock lock(&programs_mutex_);
+      auto it = programs_.find(fingerprint);
+      if (it == programs_.end()) {
+        // Not an error, so that the client can tell this apart from failures
+        // of the compilation itself and resend the program.
+        std::unique_ptr<IfrtResponse> ifrt_resp =
+            NewIfrtResponse(request->request_metadata().op_id());
+        ifrt_resp->mutable_compile_response()->set_program_not_found(true);
+        return Future<Response>(std::move(ifrt_resp));
+      }
+      programs_lru_.splice(programs_lru_.begin(), programs_lru_,
+                           it->second.lru_position);
+      serialized_program = it->second.program;
+    }
+  }
+
   // Perform compilation on a thread pool in order to (1) avoid blocking the RPC
   // thread during compilation and (2) run compilation with bigger stacks (often
   // necessary for XLA).
-  auto f = [this, request = std::shared_ptr<IfrtRequest>(
-                      std::move(request))]() -> absl::StatusOr<Response> {
+  auto f = [this, serialized_program = std::move(serialized_program),
+            request = std::shared_ptr<IfrtRequest>(
+                std::move(request))]() -> absl::StatusOr<Response> {
     const CompileRequest& compile_request = request->compile_request();
 
     auto deserialize_program_options =
@@ -807,7 +890,7 @@ Future<BackendInterface::Response> IfrtBackend::HandleCompileRequest(
     TF_ASSIGN_OR_RETURN(
         auto program,
         Deserialize<xla::ifrt::Program>(
-            compile_request.program(), std::move(deserialize_program_options)));
+            *serialized_program, std::move(deserialize_program_options)));
     TF_ASSIGN_OR_RETURN(auto options, Deserialize<xla::ifrt::CompileOptions>(
                                           compile_request.compile_options(),
                                           /*options=*/nullptr));
@@ -19,7 +19,9 @@
 
 #include <cstdint>
 #include <functional>
+#include <list>
 #include <memory>
+#include <string>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -31,10 +33,12 @@
 #include "xla/python/ifrt/executable.h"
 #include "xla/python/ifrt/future.h"
 #include "xla/python/ifrt/host_callback.h"
+#include "xla/python/ifrt/serdes.pb.h"
 #include "xla/python/ifrt_proxy/common/ifrt_service.pb.h"
 #include "xla/python/ifrt_proxy/server/host_buffer.h"
 #include "xla/python/ifrt_proxy/server/host_callback.h"
 #include "xla/tsl/concurrency/ref_count.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/threadpool.h"
 
 namespace xla {
@@ -117,8 +121,13 @@ class IfrtBackend final : public BackendInterface {
   Future<Response> HandleCheckValueReadyRequest(
       std::unique_ptr<IfrtRequest> request);
 
-  absl::StatusOr<Response> HandleMakeArrayFromHostBufferRequest(
+  Future<Response> HandleMakeArrayFromHostBufferRequest(
       std::unique_ptr<IfrtRequest> request);
+  // Makes the array of a `MakeArrayFromHostBufferRequest` once its host buffer
+  // has been received.
+  absl::StatusOr<Response> MakeArrayFromHostBuffer(
+      std::unique_ptr<IfrtRequest> request,
+      std::shared_ptr<const std::string> host_buffer);
   absl::StatusOr<Response> HandleAssembleArrayFromSingleDeviceArraysRequest(
       std::unique_ptr<IfrtRequest> request);
   absl::StatusOr<Response> HandleRemapArraysRequest(
@@ -201,6 +210,21 @@ class IfrtBackend final : public BackendInterface {
       host_callback_executions_
           ABSL_GUARDED_BY(host_callback_executions_mutex_);
 
+  // Programs recently received in this session, keyed by the client-provided
+  // fingerprint. See `CompileRequest.program_fingerprint`. Least recently used
+  // programs are evicted; clients resend a program in full if the server no
+  // longer knows its fingerprint.
+  struct CachedProgram {
+    std::shared_ptr<const Serialized> program;
+    // Position of the fingerprint in `programs_lru_`.
+    std::list<tsl::Fprint128>::iterator lru_position;
+  };
+  absl::Mutex programs_mutex_;
+  absl::flat_hash_map<tsl::Fprint128, CachedProgram, tsl::Fprint128Hasher>
+      programs_ ABSL_GUARDED_BY(programs_mutex_);
+  // Fingerprints in `programs_`, most recently used first.
+  std::list<tsl::Fprint128> programs_lru_ ABSL_GUARDED_BY(programs_mutex_);
+
   absl::Mutex in_flight_count_mutex_;
   int64_t in_flight_count_ ABSL_GUARDED_BY(in_flight_count_mutex_) = 0;
 
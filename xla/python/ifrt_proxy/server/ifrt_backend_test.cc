@@ -530,6 +530,45 @@ TEST_F(IfrtBackendHandlerTest, MakeArrayFromHostBufferSuccess) {
   EXPECT_NE(response->make_array_from_host_buffer_response().array_handle(), 0);
 }
 
+TEST_F(IfrtBackendHandlerTest, MakeArrayFromHostBufferBeforeStore) {
+  const uint64_t kHostBufferHandle = 1234;
+
+  auto ifrt_request = NewIfrtRequest(NewOpId());
+  {
+    auto* make_array =
+        ifrt_request->mutable_make_array_from_host_buffer_request();
+    ASSERT_TRUE(
+        TextFormat::ParseFromString(R"pb(
+                                      dtype { kind: KIND_F64 }
+                                      shape { dims: [ 5, 3, 4 ] }
+                                    )pb",
+                                    make_array));
+    make_array->set_host_buffer_handle(kHostBufferHandle);
+    TF_ASSERT_OK_AND_ASSIGN(auto* device,
+                            mock_client_->LookupDevice(DeviceId(1)));
+    TF_ASSERT_OK_AND_ASSIGN(
+        *make_array->mutable_sharding(),
+        SingleDeviceSharding::Create(device, MemoryKind())->ToProto());
+  }
+
+  EXPECT_CALL(*mock_client_, MakeArrayFromHostBuffer(_, _, _, _, _, _, _))
+      .WillOnce(Return(tsl::MakeRef<xla::ifrt::MockArray>()));
+
+  // The request doesn't block on the host buffer, which arrives later.
+  auto response_future = backend_->Process(std::move(ifrt_request));
+  EXPECT_FALSE(response_future.IsReady());
+
+  ASSERT_THAT(
+      host_buffer_store_->Store(kHostBufferHandle, std::string(480, 'a')),
+      IsOk());
+  TF_ASSERT_OK_AND_ASSIGN(auto response, std::move(response_future).Await());
+  EXPECT_NE(response->make_array_from_host_buffer_response().array_handle(), 0);
+
+  // The consumed host buffer is removed from the store.
+  EXPECT_THAT(host_buffer_store_->Lookup(kHostBufferHandle),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
 TEST_F(IfrtBackendHandlerTest, AssembleArrayFromSingleDeviceArrays) {
   auto ifrt_request = NewIfrtRequest(NewOpId());
   {
@@ -962,6 +1001,79 @@ TEST_F(IfrtBackendHandlerTest, CompileFailure) {
       StatusIs(absl::StatusCode::kInternal, StrEq("injected error")));
 }
 
+TEST_F(IfrtBackendHandlerTest, CompileReusesProgramByFingerprint) {
+  constexpr uint64_t kFingerprint = 1234;
+  TestCompileOptions compile_options;
+  for (bool send_program : {true, false}) {
+    auto request = NewIfrtRequest(NewOpId());
+    CompileRequest* compile_request = request->mutable_compile_request();
+    if (send_program) {
+      TestProgram program;
+      TF_ASSERT_OK_AND_ASSIGN(*compile_request->mutable_program(),
+                              Serialize(program));
+    }
+    compile_request->set_program_fingerprint_low(kFingerprint);
+    TF_ASSERT_OK_AND_ASSIGN(*compile_request->mutable_compile_options(),
+                            Serialize(compile_options));
+
+    // Reaching the compiler shows that the program was deserialized.
+    EXPECT_CALL(mock_compiler_, Compile(_, _))
+        .WillOnce(Return(ByMove(absl::InternalError("injected error"))));
+    EXPECT_THAT(CallBackend(std::move(request)),
+                StatusIs(absl::StatusCode::kInternal, StrEq("injected error")));
+  }
+}
+
+TEST_F(IfrtBackendHandlerTest, CompileEvictsLeastRecentlyUsedPrograms) {
+  TestProgram program;
+  TestCompileOptions compile_options;
+  auto compile = [&](uint64_t fingerprint, bool send_program) {
+    auto request = NewIfrtRequest(NewOpId());
+    CompileRequest* compile_request = request->mutable_compile_request();
+    if (send_program) {
+      *compile_request->mutable_program() = *Serialize(program);
+    }
+    // Only the high half differs, so that the whole 128 bits are compared.
+    compile_request->set_program_fingerprint_low(1);
+    compile_request->set_program_fingerprint_high(fingerprint);
+    *compile_request->mutable_compile_options() = *Serialize(compile_options);
+    return CallBackend(std::move(request));
+  };
+  EXPECT_CALL(mock_compiler_, Compile(_, _))
+      .WillRepeatedly(
+          [](auto, auto) { return absl::InternalError("injected error"); });
+
+  // Send many more programs than the server remembers. The first one is kept
+  // recently used, so only the others are evicted.
+  constexpr uint64_t kNumPrograms = 1000;
+  for (uint64_t fingerprint = 1; fingerprint <= kNumPrograms; ++fingerprint) {
+    EXPECT_THAT(compile(fingerprint, /*send_program=*/true),
+                StatusIs(absl::StatusCode::kInternal));
+    EXPECT_THAT(compile(1, /*send_program=*/false),
+                StatusIs(absl::StatusCode::kInternal));
+  }
+  TF_ASSERT_OK_AND_ASSIGN(auto response, compile(2, /*send_program=*/false));
+  EXPECT_TRUE(response->compile_response().program_not_found());
+  EXPECT_THAT(compile(kNumPrograms, /*send_program=*/false),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST_F(IfrtBackendHandlerTest, CompileWithUnknownProgramFingerprint) {
+  auto request = NewIfrtRequest(NewOpId());
+  CompileRequest* compile_request = request->mutable_compile_request();
+  compile_request->set_program_fingerprint_low(1234);
+  TestCompileOptions compile_options;
+  TF_ASSERT_OK_AND_ASSIGN(*compile_request->mutable_compile_options(),
+                          Serialize(compile_options));
+
+  // The compiler is not called, and the response tells the client to resend
+  // the program instead of failing.
+  EXPECT_CALL(mock_compiler_, Compile(_, _)).Times(0);
+  TF_ASSERT_OK_AND_ASSIGN(auto response, CallBackend(std::move(request)));
+  EXPECT_TRUE(response->compile_response().program_not_found());
+  EXPECT_EQ(response->compile_response().loaded_executable_handle(), 0);
+}
+
 // TODO(b/315809436): Test needs rewrite because protobuf matchers are not OSS
 #if defined(PLATFORM_GOOGLE)
 TEST_F(IfrtBackendHandlerTest, LoadedExecutableMetadata) {
@@ -319,11 +319,12 @@ void OutfeedReceiverImpl::DeviceListenerThreadLoop(int device_idx) {
     ++num_listening_threads_;
   }
   ifrt::PjRtDevice* device = devices_[device_idx];
+  // The header is consumed before the next one is received, so a single
+  // literal is reused for all of them.
+  Literal header(ShapeUtil::MakeShape(U32, {kOutfeedHeaderWords}));
   while (true) {
-    Shape header_shape = ShapeUtil::MakeShape(U32, {kOutfeedHeaderWords});
-    std::unique_ptr<Literal> header =
-        ReceiveRawFromOutfeed(device, header_shape).value();
-    absl::Span<uint32_t> header_data = header->data<uint32_t>();
+    TF_CHECK_OK(device->client()->TransferFromOutfeed(device, &header));
+    absl::Span<const uint32_t> header_data = header.data<uint32_t>();
     CHECK_EQ(header_data.size(), kOutfeedHeaderWords);
     CHECK_EQ(header_data[0], kOutfeedHeaderStart);
     uint32_t consumer_id = header_data[1];
@@ -389,7 +390,11 @@ void OutfeedReceiverImpl::CallbackThreadLoop(int device_idx) {
     num_working_callback_threads_++;
   }
   while (true) {
-    std::unique_ptr<OutfeedData> received;
+    // Takes all the received data for this device at once, so that the lock
+    // is not awaited again for every item when the callbacks fall behind. The
+    // queued bytes are only released once each callback has run, so that the
+    // batch still counts against the listener's queue size limit.
+    std::vector<std::unique_ptr<OutfeedData>> batch;
     {
       absl::MutexLock lock(&mu_);
       mu_.Await(absl::Condition(
@@ -397,18 +402,38 @@ void OutfeedReceiverImpl::CallbackThreadLoop(int device_idx) {
             return !queue->empty();
           },
           &callback_queues_[device_idx]));
-      received = std::move(callback_queues_[device_idx].front());
-      callback_queues_[device_idx].pop();
-      callback_queue_size_bytes_ -= received->literal_size_bytes();
-      VLOG(2) << "[" << device->DebugString() << "] Dequeued callback for "
-              << received->DebugString() << "; "
-              << callback_queues_[device_idx].size()
-              << " callbacks in queue of total size "
-              << callback_queue_size_bytes_ << " bytes.\n";
+      auto& queue = callback_queues_[device_idx];
+      while (!queue.empty()) {
+        batch.push_back(std::move(queue.front()));
+        queue.pop();
+      }
+      VLOG(2) << "[" << device->DebugString() << "] Dequeued "
+              << batch.size() << " callbacks";
     }
-    if (received->consumer_id() == kOutfeedCidShutdown) {
-      VLOG(2) << "[" << device->DebugString()
-              << "] Callback loop received shutdown signal";
+    bool shutdown = false;
+    for (std::unique_ptr<OutfeedData>& received : batch) {
+      if (received->consumer_id() == kOutfeedCidShutdown) {
+        VLOG(2) << "[" << device->DebugString()
+                << "] Callback loop received shutdown signal";
+        CHECK(received == batch.back());
+        shutdown = true;
+        break;
+      }
+      {
+        tsl::profiler::TraceMe traceme("OutfeedReceiver::Callback");
+        callback_(received->device(), received->consumer_id(),
+                  received->literal());
+      }
+      ssize_t literal_size_bytes = received->literal_size_bytes();
+      // Drops our reference to the literal before releasing its bytes.
+      received.reset();
+      absl::MutexLock lock(&mu_);
+      callback_queue_size_bytes_ -= literal_size_bytes;
+      VLOG(2) << "[" << device->DebugString() << "] Ran callback; total size "
+              << "of callback queues is " << callback_queue_size_bytes_
+              << " bytes.\n";
+    }
+    if (shutdown) {
       {
         absl::MutexLock lock(&mu_);
         CHECK(callback_queues_[device_idx].empty());
@@ -417,11 +442,6 @@ void OutfeedReceiverImpl::CallbackThreadLoop(int device_idx) {
       VLOG(2) << "[" << device->DebugString() << "] Callback loop done";
       return;
     }
-    {
-      tsl::profiler::TraceMe traceme("OutfeedReceiver::Callback");
-      callback_(received->device(), received->consumer_id(),
-                received->literal());
-    }
   }
 }
 
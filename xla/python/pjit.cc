@@ -259,7 +259,10 @@ class PjitFunction {
 
   int cache_capacity() const { return executables_->Size(); }
 
-  void ClearCache() { executables_->Clear(); }
+  void ClearCache() {
+    executables_->Clear();
+    last_call_signature_.reset();
+  }
 
   nb::object PythonSignature() {
     if (!fun_.has_value()) {
@@ -293,6 +296,15 @@ class PjitFunction {
   nb::callable shard_arg_fallback_;
   std::shared_ptr<PjitFunctionCache> cache_;
   std::shared_ptr<PjitFunctionCache::Cache> executables_;
+
+  // The signature and a handle to the completed cache entry of the most recent
+  // call that hit in `executables_`. Steady-state calls usually repeat the
+  // previous signature, which is then recognized by comparing it with
+  // `last_call_signature_` instead of hashing it for the LRU cache lookup.
+  // The handle still marks the entry as recently used, and is invalidated when
+  // entries are evicted from or cleared out of `executables_`.
+  std::optional<CallSignature> last_call_signature_;
+  PjitFunctionCache::Cache::Handle last_cache_entry_handle_;
 };
 
 // thread-compatible.
@@ -583,6 +595,10 @@ absl::StatusOr<nb::object> PjitFunction::Call(nb::handle callable,
     }
   }
 
+  // TODO: Skip ComputeCallSignature when every argument is a PyArray whose
+  // aval and committed sharding match the previous call, e.g. by comparing
+  // per-array version stamps, and reuse the previous argument-to-buffer
+  // mapping as well.
   status = ComputeCallSignature(flat_dynamic_args, call_signature);
   if (!status.ok()) {
     VLOG(2) << "ComputeCallSignature failed: " << status;
@@ -591,12 +607,29 @@ absl::StatusOr<nb::object> PjitFunction::Call(nb::handle callable,
 
   VLOG(2) << "CallSignature:\n" << call_signature.DebugString();
   bool inserted = false;
-  std::shared_ptr<PjitCacheEntry> cache_entry =
-      executables_->GetOrCreateIfAbsent(
-          call_signature, [this, &inserted](const CallSignature& unused) {
-            inserted = true;
-            return std::make_shared<PjitCacheEntry>(pytree_registry_.get());
-          });
+  std::optional<std::shared_ptr<PjitCacheEntry>> last_cache_entry;
+  if (last_call_signature_.has_value() &&
+      *last_call_signature_ == call_signature) {
+    last_cache_entry = executables_->Touch(last_cache_entry_handle_);
+  }
+  std::shared_ptr<PjitCacheEntry> cache_entry;
+  if (last_cache_entry.has_value()) {
+    cache_entry = *std::move(last_cache_entry);
+  } else {
+    PjitFunctionCache::Cache::Handle handle;
+    cache_entry = executables_->GetOrCreateIfAbsent(
+        call_signature,
+        [this, &inserted](const CallSignature& unused) {
+          inserted = true;
+          return std::make_shared<PjitCacheEntry>(pytree_registry_.get());
+        },
+        &handle);
+    if (!inserted && cache_entry->compilation_complete.HasBeenNotified() &&
+        !cache_entry->fall_back_to_python) {
+      last_call_signature_ = call_signature;
+      last_cache_entry_handle_ = handle;
+    }
+  }
 
   if (!cache_entry->compilation_complete.HasBeenNotified()) {
     // In case of several threads attempting to compile the executable, only
@@ -836,6 +869,7 @@ void PjitFunction::ClearPythonReferences() {
   std::swap(cache_miss_, cache_miss);
   std::swap(fun_, fun);
   std::swap(shard_arg_fallback_, shard_arg_fallback);
+  last_call_signature_.reset();
 }
 
 struct PjitFunctionObject {
@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "xla/python/pjrt_ifrt/pjrt_array.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <string>
@@ -23,6 +26,7 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -35,10 +39,12 @@ limitations under the License.
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_layout.h"
 #include "xla/pjrt/utils.h"
+#include "xla/primitive_util.h"
 #include "xla/python/ifrt/array.h"
 #include "xla/python/ifrt/device.h"
 #include "xla/python/ifrt/dtype.h"
 #include "xla/python/ifrt/future.h"
+#include "xla/python/ifrt/index_domain.h"
 #include "xla/python/ifrt/memory.h"
 #include "xla/python/ifrt/shape.h"
 #include "xla/python/ifrt/sharding.h"
@@ -50,8 +56,11 @@ limitations under the License.
 #include "xla/tsl/concurrency/ref_count.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace ifrt {
@@ -123,6 +132,125 @@ absl::StatusOr<MemoryKind> GetMemoryKindFromPjRtBuffers(
   return first_memory_kind;
 }
 
+// Copies a shard stored densely in major-to-minor order at `src` into its
+// window of a host buffer. `dst` points to the first element of the window and
+// `dst_byte_strides` are the byte strides of the whole host buffer. Rows are
+// copied at once when the minor-most dimension is dense in the host buffer.
+void CopyShardToHostBuffer(const char* src, absl::Span<const int64_t> dims,
+                           int64_t elem_size, char* dst,
+                           absl::Span<const int64_t> dst_byte_strides) {
+  if (absl::c_linear_search(dims, 0)) {
+    return;
+  }
+  const int64_t outer_rank = std::max<int64_t>(dims.size(), 1) - 1;
+  const int64_t row_size = dims.empty() ? 1 : dims.back();
+  const bool dense_rows =
+      dims.empty() || dst_byte_strides.back() == elem_size;
+  std::vector<int64_t> index(outer_rank, 0);
+  while (true) {
+    char* row = dst;
+    for (int64_t i = 0; i < outer_rank; ++i) {
+      row += index[i] * dst_byte_strides[i];
+    }
+    if (dense_rows) {
+      std::memcpy(row, src, row_size * elem_size);
+      src += row_size * elem_size;
+    } else {
+      for (int64_t j = 0; j < row_size; ++j) {
+        std::memcpy(row + j * dst_byte_strides.back(), src, elem_size);
+        src += elem_size;
+      }
+    }
+    int64_t d = outer_rank - 1;
+    for (; d >= 0; --d) {
+      if (++index[d] < dims[d]) break;
+      index[d] = 0;
+    }
+    if (d < 0) break;
+  }
+}
+
+// Copies an array with more than one shard into a host buffer. Every distinct
+// shard is fetched into its own literal and copied into its window of the host
+// buffer on the shard copy thread pool as soon as it arrives, so that the
+// device-to-host transfers and the reassembly of all shards overlap.
+Future<> CopyShardsToHostBuffer(
+    const Sharding& sharding, const Shape& shape,
+    absl::Span<const std::shared_ptr<PjRtBuffer>> pjrt_buffers,
+    xla::PrimitiveType type, void* data,
+    std::optional<absl::Span<const int64_t>> byte_strides,
+    ArrayCopySemantics semantics) {
+  absl::StatusOr<std::vector<IndexDomain>> index_domains =
+      sharding.IndexDomains(shape);
+  if (!index_domains.ok()) {
+    return Future<>(std::move(index_domains).status());
+  }
+
+  std::vector<int64_t> dst_byte_strides(shape.dims().size());
+  if (byte_strides.has_value()) {
+    if (byte_strides->size() != shape.dims().size()) {
+      return Future<>(InvalidArgument(
+          "byte_strides must have the same rank as the array: %d vs. %d",
+          byte_strides->size(), shape.dims().size()));
+    }
+    absl::c_copy(*byte_strides, dst_byte_strides.begin());
+  } else if (absl::Status s = ShapeUtil::ByteStrides(
+                 ShapeUtil::MakeShapeWithDescendingLayout(type, shape.dims()),
+                 absl::MakeSpan(dst_byte_strides));
+             !s.ok()) {
+    return Future<>(std::move(s));
+  }
+  const int64_t elem_size = primitive_util::ByteWidth(type);
+
+  std::vector<Future<>> futures;
+  futures.reserve(index_domains->size());
+  for (size_t i = 0; i < index_domains->size(); ++i) {
+    const IndexDomain& index_domain = (*index_domains)[i];
+    // Replicated shards only need to be copied once.
+    if (std::find(index_domains->begin(), index_domains->begin() + i,
+                  index_domain) != index_domains->begin() + i) {
+      continue;
+    }
+    char* shard_data = static_cast<char*>(data);
+    for (size_t d = 0; d < dst_byte_strides.size(); ++d) {
+      shard_data += index_domain.origin().elements()[d] * dst_byte_strides[d];
+    }
+    std::vector<int64_t> dims(index_domain.shape().dims().begin(),
+                              index_domain.shape().dims().end());
+    auto literal = std::make_shared<Literal>(
+        ShapeUtil::MakeShapeWithDescendingLayout(type, dims));
+    auto promise = Future<>::CreatePromise();
+    futures.push_back(Future<>(promise));
+    pjrt_buffers[i]
+        ->ToLiteral(literal.get())
+        .OnReady([literal, promise = std::move(promise), shard_data,
+                  dims = std::move(dims), elem_size,
+                  dst_byte_strides](absl::Status s) mutable {
+          if (!s.ok()) {
+            promise.Set(std::move(s));
+            return;
+          }
+          GetShardCopyThreadPool()->Schedule(
+              [literal = std::move(literal), promise = std::move(promise),
+               shard_data, dims = std::move(dims), elem_size,
+               dst_byte_strides = std::move(dst_byte_strides)]() mutable {
+                CopyShardToHostBuffer(
+                    static_cast<const char*>(literal->untyped_data()), dims,
+                    elem_size, shard_data, dst_byte_strides);
+                promise.Set(absl::OkStatus());
+              });
+        });
+  }
+  // Donated buffers are deleted once all copies are enqueued. Their device
+  // memory is freed after the pending copies complete.
+  if (semantics == ArrayCopySemantics::kDonateInput) {
+    for (const std::shared_ptr<PjRtBuffer>& pjrt_buffer : pjrt_buffers) {
+      pjrt_buffer->Delete();
+    }
+  }
+  return JoinFutures(futures);
+}
+
 }  // namespace
 
 char PjRtCompatibleArray::ID = 0;
@@ -211,6 +339,13 @@ MemoryKind MakeMemoryKindFromPjRtBuffer(PjRtBuffer* pjrt_buffer) {
   return MemoryKind(pjrt_buffer->memory_space()->kind());
 }
 
+tsl::thread::ThreadPool* GetShardCopyThreadPool() {
+  static tsl::thread::ThreadPool* const thread_pool =
+      new tsl::thread::ThreadPool(tsl::Env::Default(), "ifrt_shard_copy",
+                                  tsl::port::MaxParallelism());
+  return thread_pool;
+}
+
 absl::StatusOr<tsl::RCReference<PjRtArray>> PjRtArray::Create(
     PjRtCompatibleClient* client, DType dtype, Shape shape,
     std::shared_ptr<const Sharding> sharding, PjRtBuffers pjrt_buffers) {
@@ -371,17 +506,23 @@ Future<> PjRtArray::CopyToHostBuffer(
     void* data, std::optional<absl::Span<const int64_t>> byte_strides,
     ArrayCopySemantics semantics) {
   DCHECK(this);
-  if (sharding_->devices().size() != 1) {
-    return Future<>(
-        InvalidArgument("Only single-shard is implemented, but got %d",
-                        sharding_->devices().size()));
-  }
-
   auto dtype = ToPrimitiveType(dtype_);
   if (!dtype.ok()) {
     return Future<>(std::move(dtype).status());
   }
 
+  if (sharding_->devices().size() != 1) {
+    if (!std::holds_alternative<Shape>(shape_)) {
+      return Future<>(InvalidArgument(
+          "Copying an array with a dynamic shape and %d shards to a host "
+          "buffer is not supported",
+          sharding_->devices().size()));
+    }
+    return CopyShardsToHostBuffer(*sharding_, std::get<Shape>(shape_),
+                                  pjrt_buffers_, *dtype, data, byte_strides,
+                                  semantics);
+  }
+
   PjRtBuffer* pjrt_buffer = pjrt_buffers_.front().get();
   absl::Span<const int64_t> dims;
   absl::StatusOr<std::vector<int64_t>> logical_dims;
@@ -29,6 +29,7 @@ limitations under the License.
 #include "xla/python/ifrt/shape.h"
 #include "xla/python/pjrt_ifrt/pjrt_client.h"
 #include "xla/tsl/concurrency/ref_count.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace ifrt {
@@ -42,6 +43,11 @@ absl::StatusOr<DType> ToDType(xla::PrimitiveType primitive_type);
 // Creates IFRT `MemoryKind` from an XLA `PjRtBuffer`.
 MemoryKind MakeMemoryKindFromPjRtBuffer(PjRtBuffer* pjrt_buffer);
 
+// Returns a process-wide thread pool on which the shards of a sharded host
+// buffer are transferred (`MakeArrayFromHostBuffer`) and reassembled
+// (`CopyToHostBuffer`) in parallel.
+tsl::thread::ThreadPool* GetShardCopyThreadPool();
+
 // PjRt-compatible `Array` interface that wraps a list of `xla::PjRtBuffer`s.
 class PjRtCompatibleArray
     : public llvm::RTTIExtends<PjRtCompatibleArray, Array> {
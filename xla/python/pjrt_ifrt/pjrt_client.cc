@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/python/pjrt_ifrt/pjrt_client.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -25,6 +26,7 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
@@ -37,6 +39,7 @@ limitations under the License.
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "llvm/Support/Casting.h"
@@ -55,6 +58,7 @@ limitations under the License.
 #include "xla/python/ifrt/device.h"
 #include "xla/python/ifrt/dtype.h"
 #include "xla/python/ifrt/future.h"
+#include "xla/python/ifrt/index_domain.h"
 #include "xla/python/ifrt/memory.h"
 #include "xla/python/ifrt/remap_plan.h"
 #include "xla/python/ifrt/shape.h"
@@ -70,9 +74,11 @@ limitations under the License.
 #include "xla/python/pjrt_ifrt/pjrt_topology.h"
 #include "xla/python/pjrt_ifrt/pjrt_tuple.h"
 #include "xla/python/pjrt_ifrt/xla_sharding.h"
+#include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/tsl/concurrency/ref_count.h"
 #include "xla/util.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/casts.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
@@ -292,6 +298,53 @@ AssembleStringArrayFromSingleDeviceStringArrays(
                                   std::move(on_done_with_buffer));
 }
 
+// Transfers a host buffer, or a shard of it, to `device`.
+absl::StatusOr<std::unique_ptr<PjRtBuffer>> MakePjRtBufferFromHostBuffer(
+    xla::PjRtClient* pjrt_client, const void* data,
+    xla::PrimitiveType primitive_type, absl::Span<const int64_t> dims,
+    std::optional<absl::Span<const int64_t>> byte_strides,
+    Client::HostBufferSemantics semantics,
+    std::function<void()> on_done_with_host_buffer, Device* device,
+    MemoryKind memory_kind) {
+  // If the sharding has memory_kind specified, use a version of
+  // `PjRtClient::BufferFromHostBuffer` that accepts `PjRtMemorySpace`.
+  // Otherwise, use a non-`PjRtMemorySpace` version that is compatible with
+  // PjRt implementations without memories support.
+  if (memory_kind.memory_kind().has_value()) {
+    // Find `PjRtMemorySpace` that is associated with the sharding's device
+    // and matches the sharding's memory_kind.
+    Memory* memory = nullptr;
+    for (Memory* ms : device->Memories()) {
+      if (ms->Kind() == memory_kind) {
+        memory = ms;
+        break;
+      }
+    }
+    if (memory == nullptr) {
+      return InvalidArgument(
+          "Invalid memory kind: %s; available memory kinds: %s",
+          *memory_kind.memory_kind(),
+          absl::StrJoin(device->Memories(), ", ",
+                        [](std::string* out, Memory* ms) {
+                          absl::StrAppend(out, *ms->Kind().memory_kind());
+                        }));
+    }
+    return pjrt_client->BufferFromHostBuffer(
+        data, primitive_type, dims, byte_strides, semantics,
+        FromStdFunction(std::move(on_done_with_host_buffer)),
+        tensorflow::down_cast<PjRtMemory*>(memory)->pjrt_memory(),
+        /*device_layout=*/nullptr);
+  }
+  if (!device->IsAddressable()) {
+    return InvalidArgument("Cannot copy array to non-addressable device %s",
+                           device->DebugString());
+  }
+  return pjrt_client->BufferFromHostBuffer(
+      data, primitive_type, dims, byte_strides, semantics,
+      FromStdFunction(std::move(on_done_with_host_buffer)),
+      tensorflow::down_cast<PjRtDevice*>(device)->pjrt_device());
+}
+
 }  // namespace
 
 char PjRtCompatibleClient::ID = 0;
@@ -546,60 +599,83 @@ absl::StatusOr<tsl::RCReference<Array>> PjRtClient::MakeArrayFromHostBuffer(
                                          sharding, semantics,
                                          on_done_with_host_buffer);
   }
-  if (!llvm::isa<const SingleDeviceSharding>(sharding.get())) {
-    return InvalidArgument(
-        "Only SingleDeviceSharding is supported: sharding=%s",
-        sharding->DebugString());
-  }
   TF_ASSIGN_OR_RETURN(auto primitive_type, ToPrimitiveType(dtype));
 
-  std::unique_ptr<PjRtBuffer> buffer;
-  // If the sharding has memory_kind specified, use a version of
-  // `PjRtClient::BufferFromHostBuffer` that accepts `PjRtMemorySpace`.
-  // Otherwise, use a non-`PjRtMemorySpace` version that is compatible with
-  // PjRt implementations without memories support.
-  if (sharding->memory_kind().memory_kind().has_value()) {
-    // Find `PjRtMemorySpace` that is associated with the sharding's device
-    // and matches the sharding's memory_kind.
-    Memory* memory = nullptr;
-    for (Memory* ms : sharding->devices().front()->Memories()) {
-      if (ms->Kind() == sharding->memory_kind()) {
-        memory = ms;
-        break;
-      }
-    }
-    if (memory == nullptr) {
+  if (llvm::isa<const SingleDeviceSharding>(sharding.get())) {
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<PjRtBuffer> buffer,
+        MakePjRtBufferFromHostBuffer(
+            pjrt_client_.get(), data, primitive_type, shape.dims(),
+            byte_strides, semantics, std::move(on_done_with_host_buffer),
+            sharding->devices().front(), sharding->memory_kind()));
+    return PjRtArray::Create(
+        this, dtype, std::move(shape), std::move(sharding),
+        PjRtArray::PjRtBuffers(
+            {std::shared_ptr<PjRtBuffer>(buffer.release())}));
+  }
+
+  // Every shard is a window of the host buffer, so it is transferred directly
+  // from `data` with the byte strides of the whole host buffer. Any slicing
+  // and transposing into the device layout happens in the per-shard
+  // `BufferFromHostBuffer` calls, which run in parallel.
+  TF_ASSIGN_OR_RETURN(std::vector<IndexDomain> index_domains,
+                      sharding->IndexDomains(shape));
+  absl::InlinedVector<int64_t, 4> host_byte_strides(shape.dims().size());
+  if (byte_strides.has_value()) {
+    if (byte_strides->size() != shape.dims().size()) {
       return InvalidArgument(
-          "Invalid memory kind: %s; available memory kinds: %s",
-          *sharding->memory_kind().memory_kind(),
-          absl::StrJoin(sharding->devices().front()->Memories(), ", ",
-                        [](std::string* out, Memory* ms) {
-                          absl::StrAppend(out, *ms->Kind().memory_kind());
-                        }));
+          "byte_strides must have the same rank as the array: %d vs. %d",
+          byte_strides->size(), shape.dims().size());
     }
-    TF_ASSIGN_OR_RETURN(
-        buffer, pjrt_client_->BufferFromHostBuffer(
-                    data, primitive_type, shape.dims(), byte_strides, semantics,
-                    FromStdFunction(std::move(on_done_with_host_buffer)),
-                    tensorflow::down_cast<PjRtMemory*>(memory)->pjrt_memory(),
-                    /*device_layout=*/nullptr));
+    absl::c_copy(*byte_strides, host_byte_strides.begin());
+  } else {
+    TF_RETURN_IF_ERROR(ShapeUtil::ByteStrides(
+        ShapeUtil::MakeShapeWithDescendingLayout(primitive_type, shape.dims()),
+        absl::MakeSpan(host_byte_strides)));
+  }
+
+  // Calls `on_done_with_host_buffer` once every shard is done with `data`.
+  std::shared_ptr<void> host_buffer_ref(
+      nullptr, [on_done = std::move(on_done_with_host_buffer)](void*) {
+        if (on_done) on_done();
+      });
+
+  const int num_shards = index_domains.size();
+  std::vector<absl::StatusOr<std::unique_ptr<PjRtBuffer>>> buffers(num_shards);
+  auto transfer_shard = [&](int i) {
+    const IndexDomain& index_domain = index_domains[i];
+    const char* shard_data = static_cast<const char*>(data);
+    for (size_t d = 0; d < host_byte_strides.size(); ++d) {
+      shard_data += index_domain.origin().elements()[d] * host_byte_strides[d];
+    }
+    buffers[i] = MakePjRtBufferFromHostBuffer(
+        pjrt_client_.get(), shard_data, primitive_type,
+        index_domain.shape().dims(), host_byte_strides, semantics,
+        [host_buffer_ref]() mutable { host_buffer_ref.reset(); },
+        sharding->devices()[i], sharding->memory_kind());
+  };
+  if (num_shards == 1) {
+    transfer_shard(0);
   } else {
-    Device* device = sharding->devices().front();
-    if (!device->IsAddressable()) {
-      return InvalidArgument("Cannot copy array to non-addressable device %s",
-                             device->DebugString());
+    absl::BlockingCounter counter(num_shards);
+    for (int i = 0; i < num_shards; ++i) {
+      GetShardCopyThreadPool()->Schedule([&, i] {
+        transfer_shard(i);
+        counter.DecrementCount();
+      });
     }
-    TF_ASSIGN_OR_RETURN(
-        buffer,
-        pjrt_client_->BufferFromHostBuffer(
-            data, primitive_type, shape.dims(), byte_strides, semantics,
-            FromStdFunction(std::move(on_done_with_host_buffer)),
-            tensorflow::down_cast<PjRtDevice*>(sharding->devices().front())
-                ->pjrt_device()));
+    counter.Wait();
   }
-  return PjRtArray::Create(
-      this, dtype, std::move(shape), std::move(sharding),
-      PjRtArray::PjRtBuffers({std::shared_ptr<PjRtBuffer>(buffer.release())}));
+  host_buffer_ref.reset();
+
+  PjRtArray::PjRtBuffers pjrt_buffers;
+  pjrt_buffers.reserve(num_shards);
+  for (auto& buffer : buffers) {
+    TF_RETURN_IF_ERROR(buffer.status());
+    pjrt_buffers.push_back(std::shared_ptr<PjRtBuffer>(std::move(*buffer)));
+  }
+  return PjRtArray::Create(this, dtype, std::move(shape), std::move(sharding),
+                           std::move(pjrt_buffers));
 }
 
 absl::StatusOr<tsl::RCReference<Array>>
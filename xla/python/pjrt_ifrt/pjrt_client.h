@@ -138,6 +138,11 @@ class PjRtClient final
   //   (2) `byte_strides` are not supported, and non-`nullopt` values cause this
   //   function to fail.
   //   (3) only the `kImmutableDuringCall` semantics is supported currently.
+  //
+  // For other dtypes, `sharding` may have multiple devices as long as it can
+  // compute the index domains of `shape`. Each shard is transferred from its
+  // window of the host buffer, and the shards are transferred in parallel.
+  // `on_done_with_host_buffer` is called once all shards are done with `data`.
   absl::StatusOr<tsl::RCReference<Array>> MakeArrayFromHostBuffer(
       const void* data, DType dtype, Shape shape,
       std::optional<absl::Span<const int64_t>> byte_strides,
@@ -45,12 +45,23 @@ PjRtCompatibleClientRemapArrays(
     absl::Span<tsl::RCReference<xla::ifrt::Array>> arrays,
     ArrayCopySemantics semantics) {
   const int num_inputs = arrays.size();
+  if (num_inputs != plan.input_specs.size()) {
+    return InvalidArgument("RemapPlan expects %d inputs, but got %d",
+                           plan.input_specs.size(), num_inputs);
+  }
+  // Several mappings usually read from the same input array, so its buffers
+  // are fetched once up front rather than once per mapping.
+  std::vector<absl::Span<std::shared_ptr<xla::PjRtBuffer>>> in_buffers_list;
+  in_buffers_list.reserve(num_inputs);
   for (int i = 0; i < num_inputs; ++i) {
-    if (!llvm::isa<PjRtCompatibleArray>(arrays[i].get())) {
+    auto* array = llvm::dyn_cast<PjRtCompatibleArray>(arrays[i].get());
+    if (array == nullptr) {
       return InvalidArgument(
           "Only PjRtCompatibleArray is supported: arrays[%d]=%s", i,
           arrays[i]->DebugString());
     }
+    TF_ASSIGN_OR_RETURN(in_buffers_list.emplace_back(),
+                        array->mutable_pjrt_buffers());
   }
   if (plan.input_specs.size() > 1) {
     if (semantics != ArrayCopySemantics::kDonateInput) {
@@ -66,10 +77,8 @@ PjRtCompatibleClientRemapArrays(
   }
 
   for (const RemapPlan::Mapping& mapping : *plan.mappings) {
-    TF_ASSIGN_OR_RETURN(
-        absl::Span<std::shared_ptr<xla::PjRtBuffer>> in_buffers,
-        static_cast<PjRtCompatibleArray*>(arrays[mapping.in_array].get())
-            ->mutable_pjrt_buffers());
+    absl::Span<std::shared_ptr<xla::PjRtBuffer>> in_buffers =
+        in_buffers_list[mapping.in_array];
     PjRtArray::PjRtBuffers& out_buffers = out_buffers_list[mapping.out_array];
     for (int s = 0; s < mapping.from.size(); ++s) {
       const RemapPlan::Interval& in_interval = mapping.from[s];
@@ -41,6 +41,7 @@ limitations under the License.
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/types/span.h"
 #include "llvm/Support/Casting.h"
 #include "nanobind/nanobind.h"  // from @nanobind
@@ -94,9 +95,12 @@ limitations under the License.
 #endif
 #include "xla/tsl/concurrency/ref_count.h"
 #include "xla/util.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace {
@@ -1104,6 +1108,49 @@ absl::StatusOr<std::vector<PyArray>> PyArray::BatchedCopyToDeviceWithSharding(
   return results;
 }
 
+namespace {
+
+// Runs the host-to-device transfers of a batched device_put. Each shard is
+// copied independently, so with more than one shard the transfers are spread
+// over a process-wide thread pool instead of being issued one after another.
+// Must be called without the GIL held. Returns the first error in shard order.
+//
+// TODO: Coalesce small shards headed to the same device into one staging
+// buffer, transfer it once and split it on device. This needs a transfer API
+// in the IFRT client that produces several arrays from one host buffer.
+absl::StatusOr<std::vector<DevicePutResult>> RunDevicePutFns(
+    std::vector<DevicePutResultFn> device_put_fns) {
+  std::vector<DevicePutResult> device_puts;
+  device_puts.reserve(device_put_fns.size());
+  if (device_put_fns.size() <= 1) {
+    for (auto& device_put_fn : device_put_fns) {
+      TF_ASSIGN_OR_RETURN(auto device_put, std::move(device_put_fn)());
+      device_puts.push_back(std::move(device_put));
+    }
+    return device_puts;
+  }
+
+  static tsl::thread::ThreadPool* const thread_pool =
+      new tsl::thread::ThreadPool(tsl::Env::Default(), "py_device_put",
+                                  tsl::port::MaxParallelism());
+  std::vector<absl::StatusOr<DevicePutResult>> results(device_put_fns.size());
+  absl::BlockingCounter counter(device_put_fns.size());
+  for (size_t i = 0; i < device_put_fns.size(); ++i) {
+    thread_pool->Schedule([&, i] {
+      results[i] = std::move(device_put_fns[i])();
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  for (auto& result : results) {
+    TF_RETURN_IF_ERROR(result.status());
+    device_puts.push_back(*std::move(result));
+  }
+  return device_puts;
+}
+
+}  // namespace
+
 absl::StatusOr<PyArray> PyArray::BatchedDevicePut(
     nb::object aval, nb::object sharding, std::vector<nb::object> xs,
     absl::Span<const PyDevice* const> dst_devices, bool committed,
@@ -1165,13 +1212,10 @@ absl::StatusOr<PyArray> PyArray::BatchedDevicePut(
     ++i;
   }
   std::vector<DevicePutResult> device_puts;
-  device_puts.reserve(device_put_fns.size());
   {
     nb::gil_scoped_release gil_release;
-    for (auto& device_put_fn : device_put_fns) {
-      TF_ASSIGN_OR_RETURN(auto device_put, std::move(device_put_fn)());
-      device_puts.push_back(std::move(device_put));
-    }
+    TF_ASSIGN_OR_RETURN(device_puts,
+                        RunDevicePutFns(std::move(device_put_fns)));
   }
   for (auto& device_put : device_puts) {
     ifrt_arrays.push_back(std::move(device_put.ifrt_array));
@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "google/protobuf/any.pb.h"
 #include "absl/algorithm/container.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -191,6 +192,16 @@ PyHostSendAndRecvLoadedHostCallback::Create(
                                 void** outputs, void** inputs) {
     return cpu_callback->PrepareAndCall(outputs, inputs);
   };
+  // Asynchronous invocations of the callback acquire the GIL, so the GIL must
+  // not be held while waiting for them to finish.
+  host_callback->wrap_blocking_wait = [](absl::FunctionRef<void()> wait) {
+    if (PyGILState_Check()) {
+      nb::gil_scoped_release gil_release;
+      wait();
+    } else {
+      wait();
+    }
+  };
   return tsl::RCReference<PyHostSendAndRecvLoadedHostCallback>(
       tsl::MakeRef<PyHostSendAndRecvLoadedHostCallback>(
           ifrt_client, std::move(host_callback), callable, operand_shapes,
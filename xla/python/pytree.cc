@@ -767,6 +767,145 @@ nb::list PyTreeDef::FlattenUpTo(nb::handle xs) const {
   return leaves;
 }
 
+bool PyTreeDef::FlattenWithStructure(nb::handle x,
+                                     std::vector<nb::object>& leaves) const {
+  leaves.clear();
+  leaves.resize(num_leaves());
+  std::vector<nb::object> agenda;
+  agenda.push_back(nb::borrow<nb::object>(x));
+  auto it = traversal_.rbegin();
+  int leaf = num_leaves() - 1;
+  while (!agenda.empty()) {
+    if (it == traversal_.rend()) {
+      return false;
+    }
+    const Node& node = *it;
+    nb::object object = std::move(agenda.back());
+    agenda.pop_back();
+    ++it;
+
+    switch (node.kind) {
+      case PyTreeKind::kLeaf: {
+        const PyTreeRegistry::Registration* custom;
+        if (leaf < 0 ||
+            registry_->KindOfObject(object, &custom) != PyTreeKind::kLeaf) {
+          return false;
+        }
+        leaves[leaf--] = std::move(object);
+        break;
+      }
+
+      case PyTreeKind::kNone:
+        if (!object.is_none()) {
+          return false;
+        }
+        break;
+
+      case PyTreeKind::kTuple: {
+        if (!PyTuple_CheckExact(object.ptr()) ||
+            PyTuple_GET_SIZE(object.ptr()) != node.arity) {
+          return false;
+        }
+        for (int i = 0; i < node.arity; ++i) {
+          agenda.push_back(
+              nb::borrow<nb::object>(PyTuple_GET_ITEM(object.ptr(), i)));
+        }
+        break;
+      }
+
+      case PyTreeKind::kList: {
+        if (!PyList_CheckExact(object.ptr()) ||
+            PyList_GET_SIZE(object.ptr()) != node.arity) {
+          return false;
+        }
+        for (int i = 0; i < node.arity; ++i) {
+          agenda.push_back(
+              nb::borrow<nb::object>(PyList_GET_ITEM(object.ptr(), i)));
+        }
+        break;
+      }
+
+      case PyTreeKind::kDict: {
+        // A dict with the same number of entries that contains all of the
+        // expected keys has exactly the expected keys, so there is no need to
+        // sort its keys.
+        if (!PyDict_CheckExact(object.ptr()) ||
+            PyDict_Size(object.ptr()) != node.arity) {
+          return false;
+        }
+        for (const nb::object& key : node.sorted_dict_keys) {
+          PyObject* value = PyDict_GetItemWithError(object.ptr(), key.ptr());
+          if (value == nullptr) {
+            if (PyErr_Occurred()) {
+              throw nb::python_error();
+            }
+            return false;
+          }
+          agenda.push_back(nb::borrow<nb::object>(value));
+        }
+        break;
+      }
+
+      case PyTreeKind::kNamedTuple: {
+        if (object.type().ptr() != node.node_data.ptr() ||
+            registry_->Lookup(object.type()) != nullptr) {
+          return false;
+        }
+        nb::tuple tuple = nb::borrow<nb::tuple>(object);
+        if (tuple.size() != node.arity) {
+          return false;
+        }
+        for (nb::handle entry : tuple) {
+          agenda.push_back(nb::borrow<nb::object>(entry));
+        }
+        break;
+      }
+
+      case PyTreeKind::kCustom: {
+        if (registry_->Lookup(object.type()) != node.custom) {
+          return false;
+        }
+        auto [children, aux_data] = node.custom->ToIterable(object);
+        if (node.node_data.not_equal(aux_data)) {
+          return false;
+        }
+        int arity = 0;
+        for (nb::handle entry : children) {
+          ++arity;
+          agenda.push_back(nb::borrow<nb::object>(entry));
+        }
+        if (arity != node.arity) {
+          return false;
+        }
+        break;
+      }
+
+      case PyTreeKind::kDataclass: {
+        if (registry_->Lookup(object.type()) != node.custom) {
+          return false;
+        }
+        auto meta_size = node.custom->meta_fields.size();
+        nb::object aux_data = nb::steal(PyTuple_New(meta_size));
+        for (size_t meta_leaf = 0; meta_leaf < meta_size; ++meta_leaf) {
+          PyTuple_SET_ITEM(
+              aux_data.ptr(), meta_leaf,
+              nb::getattr(object, node.custom->meta_fields[meta_leaf])
+                  .release()
+                  .ptr());
+        }
+        if (node.node_data.not_equal(aux_data)) {
+          return false;
+        }
+        for (const nb::str& field : node.custom->data_fields) {
+          agenda.push_back(nb::getattr(object, field));
+        }
+        break;
+      }
+    }
+  }
+  return it == traversal_.rend() && leaf == -1;
+}
+
 nb::object PyTreeDef::Walk(const nb::callable& f_node, nb::handle f_leaf,
                            nb::iterable leaves) const {
   std::vector<nb::object> agenda;
@@ -1300,6 +1439,20 @@ void BuildPytreeSubmodule(nb::module_& m) {
               static_cast<nb::object (PyTreeDef::*)(nb::iterable leaves) const>(
                   &PyTreeDef::Unflatten));
   treedef.def("flatten_up_to", &PyTreeDef::FlattenUpTo, nb::arg("tree").none());
+  treedef.def(
+      "flatten_with_structure",
+      [](const PyTreeDef& t, nb::handle tree) -> std::optional<nb::list> {
+        std::vector<nb::object> leaves;
+        if (!t.FlattenWithStructure(tree, leaves)) {
+          return std::nullopt;
+        }
+        nb::list result = nb::steal<nb::list>(PyList_New(leaves.size()));
+        for (size_t i = 0; i < leaves.size(); ++i) {
+          PyList_SET_ITEM(result.ptr(), i, leaves[i].release().ptr());
+        }
+        return result;
+      },
+      nb::arg("tree").none());
   treedef.def("compose", &PyTreeDef::Compose);
   treedef.def(
       "walk", &PyTreeDef::Walk,
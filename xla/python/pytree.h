@@ -170,6 +170,15 @@ class PyTreeDef {
   // list of leaves [1, (2, 3), {"foo": 4}].
   nanobind::list FlattenUpTo(nanobind::handle x) const;
 
+  // Flattens `x`, assuming that it has the same tree structure as this
+  // PyTreeDef. This is cheaper than Flatten() for callers that flatten values
+  // of a previously seen structure repeatedly: no PyTreeDef is built and dict
+  // keys are looked up instead of sorted. Returns false if the structure of
+  // `x` differs, in which case the contents of `leaves` are unspecified and
+  // the caller should fall back to Flatten().
+  bool FlattenWithStructure(nanobind::handle x,
+                            std::vector<nanobind::object>& leaves) const;
+
   // Returns an unflattened PyTree given an iterable of leaves and a PyTreeDef.
   nanobind::object Unflatten(nanobind::iterable leaves) const;
   nanobind::object Unflatten(absl::Span<const nanobind::object> leaves) const;
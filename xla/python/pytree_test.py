@@ -92,6 +92,24 @@ class PyTreeTest(absltest.TestCase):
     y = registry.flatten((0, 0))[1]
     self.assertEqual((x.compose(y)).num_leaves, 2)
 
+  def testFlattenWithStructure(self):
+    o = object()
+    example = ({"a": o, "b": [o, None]}, ExampleType(field0=o, field1=o),
+               ExampleType2(field0=o, field1=o))
+    leaves, treedef = registry.flatten(example)
+    self.assertEqual(treedef.flatten_with_structure(example), leaves)
+
+    # Structures that differ from the treedef are rejected.
+    self.assertIsNone(treedef.flatten_with_structure((o, o, o)))
+    self.assertIsNone(
+        treedef.flatten_with_structure(
+            ({"a": o, "c": [o, None]}, ExampleType(field0=o, field1=o),
+             ExampleType2(field0=o, field1=o))))
+    self.assertIsNone(
+        treedef.flatten_with_structure(
+            ({"a": o, "b": [o, (o,)]}, ExampleType(field0=o, field1=o),
+             ExampleType2(field0=o, field1=o))))
+
 
 if __name__ == "__main__":
   absltest.main()
@@ -27,6 +27,7 @@ limitations under the License.
 #include "absl/base/thread_annotations.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
@@ -77,6 +78,25 @@ class HashablePyDictIter : protected HashablePyDictValue {
   void operator++() { ++iter_; }
 };
 
+// Hashes the Python parts of a cache key. This calls into Python __hash__
+// methods, so it is done once per call before acquiring the cache mutex.
+struct HashablePyCacheKey {
+  const nb::object& context;
+  const nb::args& args;
+  const nb::kwargs& kwargs;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const HashablePyCacheKey& key) {
+    h = H::combine(std::move(h), xla::nb_hash(key.context),
+                   xla::nb_hash(key.args));
+    h = H::combine_unordered(std::move(h),
+                             HashablePyDictIter(key.kwargs.begin()),
+                             HashablePyDictIter(key.kwargs.end()));
+    h = H::combine(std::move(h), key.kwargs.size());
+    return h;
+  }
+};
+
 }  // namespace
 
 class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
@@ -85,21 +105,18 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
     nb::object context;
     nb::args args;
     nb::kwargs kwargs;
+    size_t cached_hash;
 
+    // Keys with different hashes are rejected without calling into Python.
     bool operator==(const Key& other) const {
-      return context.equal(other.context) && args.equal(other.args) &&
+      return cached_hash == other.cached_hash &&
+             context.equal(other.context) && args.equal(other.args) &&
              kwargs.equal(other.kwargs);
     }
 
     template <typename H>
     friend H AbslHashValue(H h, const Key& key) {
-      h = H::combine(std::move(h), xla::nb_hash(key.context),
-                     xla::nb_hash(key.args));
-      h = H::combine_unordered(std::move(h),
-                               HashablePyDictIter(key.kwargs.begin()),
-                               HashablePyDictIter(key.kwargs.end()));
-      h = H::combine(std::move(h), key.kwargs.size());
-      return h;
+      return H::combine(std::move(h), key.cached_hash);
     }
   };
 
@@ -192,6 +209,10 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
         weakref_key, this, static_cast<size_t>(xla::nb_hash(weakref_key))});
     Cache& cache = *cache_ptr;
     ++total_queries_;
+    // Hash the key while holding only the GIL, so that the critical section
+    // below is limited to the table lookup and equality checks.
+    Key key{context, args, kwargs,
+            absl::HashOf(HashablePyCacheKey{context, args, kwargs})};
 
     bool inserted = false;
     std::shared_ptr<CacheEntry> entry;
@@ -209,7 +230,6 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
       // released if that happens.
       absl::Cleanup unlock = [this]()
                                  ABSL_UNLOCK_FUNCTION(mu_) { mu_.Unlock(); };
-      Key key{context, args, kwargs};
       entry = cache.GetOrCreateIfAbsent(key, [&inserted](const Key& key) {
         inserted = true;
         return std::make_shared<CacheEntry>();
@@ -276,6 +296,10 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
 
   nb::callable cache_context_fn_;
   nb::callable fn_;
+  // TODO: Shard `lru_list_`, `entries_` and `mu_` by weakref key hash, and add
+  // a read path that does not take `mu_` exclusively, so that dispatch threads
+  // of free-threaded Python don't contend on a single lock. Sharding splits
+  // `maxsize` across shards, which changes the eviction order.
   Cache::LRUList lru_list_;
   absl::node_hash_map<WeakrefCacheEntry, std::shared_ptr<Cache>, WeakrefKeyHash,
                       WeakrefKeyEq>
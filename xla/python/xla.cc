@@ -70,6 +70,7 @@ limitations under the License.
 #include "gloo/transport/tcp/device.h"  // from @gloo
 #include "xla/pjrt/cpu/gloo_collectives.h"
 #include "xla/pjrt/cpu/gloo_kv_store.h"
+#include "xla/pjrt/cpu/shm_collectives.h"
 #endif  // __linux__
 
 #if !defined(_WIN32) && !defined(PLATFORM_GOOGLE)
@@ -280,6 +281,26 @@ NB_MODULE(xla_extension, m_nb) {
       nb::arg("distributed_client"), nb::arg("hostname").none() = std::nullopt,
       nb::arg("interface").none() = std::nullopt);
 
+  m_nb.def(
+      "make_shm_collectives",
+      [](std::shared_ptr<DistributedRuntimeClient> distributed_client,
+         std::shared_ptr<xla::cpu::CollectivesInterface> fallback)
+          -> std::shared_ptr<xla::cpu::CollectivesInterface> {
+#ifdef __linux__
+        std::shared_ptr<KeyValueStoreInterface> kv_store = nullptr;
+        if (distributed_client != nullptr) {
+          kv_store = GetDistributedKeyValueStore(distributed_client,
+                                                 /*key_prefix=*/"cpu:");
+        }
+        return std::make_shared<cpu::ShmCollectives>(std::move(kv_store),
+                                                     std::move(fallback));
+#else   // __linux__
+        throw xla::XlaRuntimeError(
+            "make_shm_collectives only implemented for linux");
+#endif  // __linux__
+      },
+      nb::arg("distributed_client"), nb::arg("fallback").none() = nullptr);
+
 #if !defined(_WIN32) && !defined(PLATFORM_GOOGLE)
   nb::class_<cpu::MpiCollectives> mpi_collectives(m_nb, "MpiCollectives",
                                                   cpu_collectives);
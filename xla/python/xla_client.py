@@ -50,7 +50,7 @@ profiler = _xla.profiler
 
 # Just an internal arbitrary increasing number to help with backward-compatible
 # changes. In JAX, reference this via jax._src.lib.xla_extension_version.
-_version = 271
+_version = 274
 
 # Version number for MLIR:Python components.
 mlir_api_version = 57
@@ -108,6 +108,10 @@ def make_gpu_client(
     config.preallocate = options['preallocate']
   if 'collective_memory_size' in options:
     config.collective_memory_size = options['collective_memory_size']
+  if 'pinned_host_memory_preallocate_size' in options:
+    config.pinned_host_memory_preallocate_size = options[
+        'pinned_host_memory_preallocate_size'
+    ]
   register_custom_call_handler('CUDA', _xla.register_custom_call_target)
   register_custom_call_handler('ROCM', _xla.register_custom_call_target)
 
@@ -225,6 +229,9 @@ def generate_pjrt_gpu_plugin_options() -> _NameValueMapping:
   collective_memory_size = os.getenv(
       'XLA_PYTHON_CLIENT_COLLECTIVE_MEM_SIZE_MB', ''
   )
+  pinned_host_memory_size = os.getenv(
+      'XLA_PYTHON_CLIENT_PINNED_HOST_MEM_SIZE_MB', ''
+  )
   if allocator not in ('default', 'platform', 'bfc', 'cuda_async'):
     raise ValueError(
         'XLA_PYTHON_CLIENT_ALLOCATOR env var must be "default", "platform", '
@@ -237,6 +244,10 @@ def generate_pjrt_gpu_plugin_options() -> _NameValueMapping:
     options['preallocate'] = preallocate not in ('false', 'False', '0')
   if collective_memory_size:
     options['collective_memory_size'] = int(collective_memory_size) * (1 << 20)
+  if pinned_host_memory_size:
+    options['pinned_host_memory_preallocate_size'] = int(
+        pinned_host_memory_size
+    ) * (1 << 20)
   return options
 
 
@@ -2860,6 +2860,19 @@ module @jit__lambda_ attributes {mhlo.num_partitions = 1 : i32,
       np.testing.assert_array_equal(x, np.asarray(y))
       np.testing.assert_array_equal(x, np.asarray(z))
 
+    @parameterized.parameters(0, 100)
+    def testSizeOneDimensionWithArbitraryStride(self, stride):
+      base = np.arange(12, dtype=np.float32)
+      itemsize = base.itemsize
+      # Sorting the dimensions by stride moves the size-1 dimension out of
+      # major-to-minor order, although the memory is laid out row-major.
+      x = np.lib.stride_tricks.as_strided(
+          base, shape=(3, 1, 4),
+          strides=(4 * itemsize, stride * itemsize, itemsize))
+      y = xla_client._xla.dlpack_managed_tensor_to_buffer(
+          x.__dlpack__(), self.cpu_backend, self.gpu_backend)
+      np.testing.assert_array_equal(x, np.asarray(y))
+
   tests.append(DLPackTest)
 
   class BufferProtocolTest(parameterized.TestCase):
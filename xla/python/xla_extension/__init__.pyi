@@ -470,6 +470,8 @@ class GpuAllocatorConfig:
       memory_fraction: float = ...,
       preallocate: bool = ...,
       collective_memory_size: int = ...,
+      use_virtual_memory: bool = ...,
+      pinned_host_memory_preallocate_size: int = ...,
   ) -> None: ...
 
 class HostBufferSemantics(enum.IntEnum):
@@ -546,6 +548,11 @@ def make_gloo_tcp_collectives(
     interface: Optional[str] = ...,
 ) -> CpuCollectives: ...
 
+def make_shm_collectives(
+    distributed_client: Optional[DistributedRuntimeClient] = ...,
+    fallback: Optional[CpuCollectives] = ...,
+) -> CpuCollectives: ...
+
 class MpiCollectives(CpuCollectives):
   def Init(self): ...
   def Finalize(self): ...
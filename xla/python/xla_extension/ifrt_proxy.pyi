@@ -24,6 +24,7 @@ Client = xla_extension.Client
 class ClientConnectionOptions:
   on_disconnect: Optional[Callable[[_Status], None]] = None
   on_connection_update: Optional[Callable[[str], None]] = None
+  host_buffer_shared_memory_size: int = 0
 
 
 def get_client(
@@ -20,6 +20,7 @@ limitations under the License.
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <iterator>
 #include <memory>
 #include <numeric>
@@ -501,10 +502,122 @@ bool AlgebraicSimplifierVisitor::Run(HloComputation* computation,
                                      const AlgebraicSimplifierOptions& options,
                                      AlgebraicSimplifier* simplifier) {
   ResetState(computation);
-  TF_CHECK_OK(computation->Accept(this));
+  if (options.use_worklist()) {
+    TF_CHECK_OK(RunWithWorklist());
+  } else {
+    TF_CHECK_OK(computation->Accept(this));
+  }
   return changed();
 }
 
+absl::Status AlgebraicSimplifierVisitor::RunWithWorklist() {
+  // Upper bound on the number of visits per instruction, the same as the
+  // iteration limit of HloPassFix. Guards against rewrites that undo each
+  // other.
+  constexpr int64_t kMaxVisitsPerInstruction = 25;
+
+  const bool changed_before = changed();
+  bool changed_any = false;
+
+  std::deque<HloInstruction*> worklist;
+  absl::flat_hash_set<HloInstruction*> in_worklist;
+  int64_t max_unique_id = -1;
+  for (HloInstruction* instruction :
+       computation_->MakeInstructionPostOrder()) {
+    worklist.push_back(instruction);
+    in_worklist.insert(instruction);
+    max_unique_id = std::max(max_unique_id, instruction->unique_id());
+  }
+  const int64_t max_visits = kMaxVisitsPerInstruction * (worklist.size() + 1);
+
+  auto enqueue = [&](HloInstruction* instruction) {
+    if (instruction->parent() == computation_ &&
+        !instruction->IsMarkedAsDead() &&
+        in_worklist.insert(instruction).second) {
+      worklist.push_back(instruction);
+    }
+  };
+  // Instructions added by a rewrite have unique ids above every id seen
+  // before. They are reachable from the users of the rewritten instruction
+  // (or from the root), so a walk over the operands that stops at older
+  // instructions finds all of them.
+  auto enqueue_new_operands = [&](HloInstruction* instruction) {
+    int64_t new_max_unique_id = max_unique_id;
+    std::vector<HloInstruction*> stack = {instruction};
+    absl::flat_hash_set<HloInstruction*> visited;
+    while (!stack.empty()) {
+      HloInstruction* current = stack.back();
+      stack.pop_back();
+      for (HloInstruction* operand : current->operands()) {
+        if (operand->unique_id() > max_unique_id &&
+            visited.insert(operand).second) {
+          new_max_unique_id = std::max(new_max_unique_id, operand->unique_id());
+          enqueue(operand);
+          stack.push_back(operand);
+        }
+      }
+    }
+    return new_max_unique_id;
+  };
+
+  int64_t visits = 0;
+  while (!worklist.empty()) {
+    if (++visits > max_visits) {
+      VLOG(1) << "Algebraic simplifier did not converge on computation "
+              << computation_->name() << " after " << max_visits
+              << " instruction visits";
+      break;
+    }
+    HloInstruction* instruction = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(instruction);
+    // Removed instructions are only deallocated after the pass, so the
+    // pointers in the worklist stay valid.
+    if (instruction->IsMarkedAsDead()) {
+      continue;
+    }
+
+    std::vector<HloInstruction*> operands(instruction->operands().begin(),
+                                          instruction->operands().end());
+    std::vector<HloInstruction*> users = instruction->users();
+
+    ResetChanged();
+    TF_RETURN_IF_ERROR(instruction->Visit(this));
+    if (!changed()) {
+      continue;
+    }
+    changed_any = true;
+
+    // Revisit the rewritten instruction and its neighbors, and visit the
+    // instructions created by the rewrite.
+    std::vector<HloInstruction*> anchors = std::move(users);
+    anchors.push_back(instruction);
+    anchors.push_back(computation_->root_instruction());
+    int64_t new_max_unique_id = max_unique_id;
+    for (HloInstruction* anchor : anchors) {
+      if (anchor->IsMarkedAsDead()) {
+        continue;
+      }
+      new_max_unique_id =
+          std::max(new_max_unique_id, enqueue_new_operands(anchor));
+      enqueue(anchor);
+      for (HloInstruction* user : anchor->users()) {
+        enqueue(user);
+      }
+    }
+    max_unique_id = new_max_unique_id;
+    for (HloInstruction* operand : operands) {
+      enqueue(operand);
+    }
+  }
+
+  ResetChanged();
+  if (changed_before || changed_any) {
+    MarkAsChanged();
+  }
+  return absl::OkStatus();
+}
+
 bool AlgebraicSimplifierVisitor::SameShape(const HloInstruction* lhs,
                                            const HloInstruction* rhs) const {
   return SameShape(lhs->shape(), rhs->shape());
@@ -247,6 +247,13 @@ class AlgebraicSimplifierOptions {
         enable_unconditional_reduce_of_concat_replacement;
   }
 
+  // If enabled, the simplifier runs to a fixed point by itself: after the
+  // first sweep over a computation it only revisits instructions whose
+  // operands or users were rewritten, instead of relying on HloPassFix to
+  // sweep the whole module again.
+  bool use_worklist() const { return use_worklist_; }
+  void set_use_worklist(bool use_worklist) { use_worklist_ = use_worklist; }
+
  private:
   // Metadata struct can be used to store any metadata information encapsulated
   // with the AlgebraicSimplierOptions that can be later used in an
@@ -279,6 +286,7 @@ class AlgebraicSimplifierOptions {
   int64_t very_small_gather_size_{4};
   bool minmax_propagate_nan_{true};
   bool enable_unconditional_reduce_of_concat_replacement_{true};
+  bool use_worklist_{false};
   bool use_associative_reordering_{false};
   double associative_reordering_threshold_{2.0};
   Metadata metadata_;
@@ -631,6 +639,10 @@ class AlgebraicSimplifierVisitor : public DfsHloRewriteVisitor {
   // Useful when we want to use the same visitor over multiple computations.
   void ResetState(HloComputation* computation);
 
+  // Simplifies the current computation to a fixed point, revisiting only the
+  // instructions around the ones that were rewritten.
+  absl::Status RunWithWorklist();
+
   // Current HloComputation instance the AlgebraicSimplifierVisitor is
   // traversing.
   HloComputation* computation_;
@@ -11255,5 +11255,32 @@ ENTRY main.1 {
             HloOpcode::kParameter);
 }
 
+TEST_F(AlgebraicSimplifierTest, WorklistRunsToFixedPoint) {
+  const char* kModuleStr = R"(
+    HloModule m
+    test {
+      p0 = f32[8,16] parameter(0)
+      zero = f32[] constant(0)
+      one = f32[] constant(1)
+      bzero = f32[8,16] broadcast(zero), dimensions={}
+      bone = f32[8,16] broadcast(one), dimensions={}
+      add = f32[8,16] add(p0, bzero)
+      multiply = f32[8,16] multiply(add, bone)
+      transpose = f32[16,8] transpose(multiply), dimensions={1,0}
+      transpose.1 = f32[8,16] transpose(transpose), dimensions={1,0}
+      reshape = f32[128] reshape(transpose.1)
+      ROOT reshape.1 = f32[8,16] reshape(reshape)
+    }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto m, ParseAndReturnVerifiedModule(kModuleStr));
+  AlgebraicSimplifierOptions options = default_options_;
+  options.set_use_worklist(true);
+  ASSERT_TRUE(AlgebraicSimplifier(options).Run(m.get()).value());
+  EXPECT_THAT(m->entry_computation()->root_instruction(),
+              GmockMatch(m::Parameter(0)));
+  // A single worklist run reaches the fixed point of HloPassFix.
+  EXPECT_FALSE(AlgebraicSimplifier(default_options_).Run(m.get()).value());
+}
+
 }  // namespace
 }  // namespace xla
@@ -297,6 +297,10 @@ BufferAllocationProto BufferAllocation::ToProto() const {
                  return assign1.logical_buffer_id() <
                         assign2.logical_buffer_id();
                });
+  proto.set_fragmentation_bytes(fragmentation_bytes_);
+  for (const HloValue* value : peak_buffers_) {
+    proto.add_peak_buffer_ids(value->id());
+  }
   return proto;
 }
 
@@ -805,6 +809,26 @@ std::string BufferAssignment::Stats::ToString() const {
   return s;
 }
 
+BufferAssignmentProto::Stats BufferAssignment::Stats::ToProto() const {
+  BufferAssignmentProto::Stats proto;
+  proto.set_parameter_allocation_count(parameter_allocation_count);
+  proto.set_parameter_allocation_bytes(parameter_allocation_bytes);
+  proto.set_constant_allocation_count(constant_allocation_count);
+  proto.set_constant_allocation_bytes(constant_allocation_bytes);
+  proto.set_maybe_live_out_allocation_count(maybe_live_out_allocation_count);
+  proto.set_maybe_live_out_allocation_bytes(maybe_live_out_allocation_bytes);
+  proto.set_preallocated_temp_allocation_count(
+      preallocated_temp_allocation_count);
+  proto.set_preallocated_temp_allocation_bytes(
+      preallocated_temp_allocation_bytes);
+  proto.set_preallocated_temp_fragmentation_bytes(
+      preallocated_temp_fragmentation_bytes);
+  proto.set_total_allocation_count(total_allocation_count);
+  proto.set_total_allocation_bytes(total_allocation_bytes);
+  proto.set_total_fragmentation_bytes(total_fragmentation_bytes);
+  return proto;
+}
+
 std::string BufferAssignment::ToString() const {
   std::string output;
   absl::StrAppend(&output, "BufferAssignment:\n");
@@ -999,6 +1023,7 @@ BufferAssignmentProto BufferAssignment::ToProto() const {
       *proto.add_heap_simulator_traces() = heap_trace;
     }
   }
+  *proto.mutable_stats() = stats_.ToProto();
   return proto;
 }
 
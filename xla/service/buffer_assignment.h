@@ -507,6 +507,7 @@ class BufferAssignment {
     int64_t total_fragmentation_bytes = -1;
 
     std::string ToString() const;
+    BufferAssignmentProto::Stats ToProto() const;
   };
   const Stats& GetStats() const { return stats_; }
 
@@ -2071,6 +2071,22 @@ TEST_F(BufferAssignmentTest, PeakBuffers) {
     peak_instructions.push_back(logical_buffer->instruction());
   }
   EXPECT_THAT(peak_instructions, UnorderedElementsAre(rev, neg, concat));
+
+  // The peak buffers, fragmentation and summary stats are part of the proto.
+  BufferAssignmentProto proto = buffers->ToProto();
+  const BufferAllocationProto& buffer_proto =
+      proto.buffer_allocations(buffer.index());
+  std::vector<int64_t> peak_buffer_ids;
+  for (const HloValue* logical_buffer : peak_buffers) {
+    peak_buffer_ids.push_back(logical_buffer->id());
+  }
+  EXPECT_THAT(buffer_proto.peak_buffer_ids(),
+              ::testing::UnorderedElementsAreArray(peak_buffer_ids));
+  EXPECT_EQ(buffer_proto.fragmentation_bytes(), buffer.fragmentation_bytes());
+  EXPECT_EQ(proto.stats().total_allocation_bytes(),
+            buffers->GetStats().total_allocation_bytes);
+  EXPECT_EQ(proto.stats().total_fragmentation_bytes(),
+            buffers->GetStats().total_fragmentation_bytes);
 }
 
 TEST_F(BufferAssignmentTest, AliasedBuffersShouldntCoexistInPeakBuffers) {
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/call_graph.h"
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <queue>
@@ -23,6 +24,7 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -277,33 +279,29 @@ void CallGraph::SetCallContexts() {
 }
 
 void CallGraph::SetNodeDepths() {
-  std::queue<CallGraphNode*> worklist;
-
-  // Initialize node depths to -1.
+  // Collect the nodes in post order, i.e. callees before callers.
+  std::vector<const HloComputation*> post_order;
+  post_order.reserve(nodes_.size());
+  CHECK_OK(VisitNodes(
+      [&](const CallGraphNode& node) {
+        post_order.push_back(node.computation());
+        return absl::OkStatus();
+      },
+      /*visit_unreachable_nodes=*/true));
+
+  // Roots of the call graph (computations without callers) have depth zero.
   for (CallGraphNode& node : nodes_) {
-    node.set_depth(-1);
-  }
-
-  // Initialize worklist with all roots of the call graph (computations without
-  // callers).
-  for (const HloComputation* computation :
-       module_->computations(execution_threads_)) {
-    CallGraphNode& node = GetNode(computation);
-    if (node.callers().empty()) {
-      node.set_depth(0);
-      worklist.push(&node);
-    }
+    node.set_depth(node.callers().empty() ? 0 : -1);
   }
 
-  while (!worklist.empty()) {
-    CallGraphNode* node = worklist.front();
-    worklist.pop();
-    for (const HloComputation* callee : node->callees()) {
+  // In reverse post order every caller is visited before its callees, so the
+  // depth of a node is final when it is propagated to its callees. This takes
+  // linear time, unlike relaxing the depths along every path from the roots.
+  for (auto it = post_order.rbegin(); it != post_order.rend(); ++it) {
+    const CallGraphNode& node = GetNode(*it);
+    for (const HloComputation* callee : node.callees()) {
       CallGraphNode& callee_node = GetNode(callee);
-      if (callee_node.depth() < node->depth() + 1) {
-        callee_node.set_depth(node->depth() + 1);
-        worklist.push(&callee_node);
-      }
+      callee_node.set_depth(std::max(callee_node.depth(), node.depth() + 1));
     }
   }
 
@@ -312,6 +310,17 @@ void CallGraph::SetNodeDepths() {
   }
 }
 
+/* static */
+std::shared_ptr<const CallGraph> CallGraph::BuildCached(
+    const HloModule* module) {
+  if (std::shared_ptr<const CallGraph> cached = module->cached_call_graph()) {
+    return cached;
+  }
+  std::shared_ptr<const CallGraph> call_graph = Build(module);
+  module->set_cached_call_graph(call_graph);
+  return call_graph;
+}
+
 /* static */
 std::unique_ptr<CallGraph> CallGraph::Build(
     const HloModule* module,
@@ -323,6 +332,9 @@ std::unique_ptr<CallGraph> CallGraph::Build(
   VLOG(3) << "Building call graph for:";
   XLA_VLOG_LINES(3, module->ToString());
 
+  call_graph->nodes_.reserve(module->computation_count());
+  call_graph->node_indices_.reserve(module->computation_count());
+
   // Construct nodes of the call graph and populate the callsites.
   for (HloComputation* computation : module->computations(execution_threads)) {
     auto it_added = call_graph->node_indices_.insert(
@@ -197,10 +197,22 @@ class CallGraph {
       const HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads = {});
 
+  // Returns the call graph of all execution threads of the given HLO module.
+  // The graph is cached on the module and shared between callers until a
+  // computation is added to or removed from the module, or the computations
+  // called by one of its instructions change. Mutations which leave the call
+  // edges intact, the bulk of what passes do, keep the cached graph valid.
+  static std::shared_ptr<const CallGraph> BuildCached(const HloModule* module);
+
   // Returns the node associated with the given computation.
   const CallGraphNode& GetNode(const HloComputation* computation) const;
   CallGraphNode& GetNode(const HloComputation* computation);
 
+  // Returns whether the call graph has a node for the given computation.
+  bool Contains(const HloComputation* computation) const {
+    return node_indices_.contains(computation);
+  }
+
   // Returns the vector of all nodes in the call graph.
   const std::vector<CallGraphNode>& nodes() const { return nodes_; }
 
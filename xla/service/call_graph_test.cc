@@ -111,6 +111,12 @@ TEST_F(CallGraphTest, SingletonComputation) {
   EXPECT_TRUE(node.caller_callsites().empty());
   EXPECT_TRUE(node.callers().empty());
   EXPECT_EQ(CallContext::kControlFlow, node.context());
+
+  // Computations added after the graph was built have no nodes.
+  EXPECT_TRUE(call_graph->Contains(computation));
+  HloComputation* added_computation =
+      module->AddEmbeddedComputation(MakeScalarComputation());
+  EXPECT_FALSE(call_graph->Contains(added_computation));
 }
 
 TEST_F(CallGraphTest, UnreachableComputation) {
@@ -776,5 +782,51 @@ TEST_F(CallGraphTest, ExecutionThread) {
   }
 }
 
+TEST_F(CallGraphTest, CachedCallGraph) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* callee =
+      module->AddEmbeddedComputation(MakeScalarComputation());
+  HloComputation* entry =
+      module->AddEntryComputation(MakeCallingComputation(callee, 1));
+
+  std::shared_ptr<const CallGraph> call_graph =
+      CallGraph::BuildCached(module.get());
+  EXPECT_EQ(call_graph->nodes().size(), 2);
+  EXPECT_EQ(CallGraph::BuildCached(module.get()), call_graph);
+
+  // Adding instructions which do not call computations keeps the graph.
+  HloInstruction* negate = entry->AddInstruction(HloInstruction::CreateUnary(
+      kScalarShape, HloOpcode::kNegate, entry->root_instruction()));
+  entry->set_root_instruction(negate);
+  EXPECT_EQ(CallGraph::BuildCached(module.get()), call_graph);
+
+  // Retargeting a callsite invalidates the graph.
+  HloComputation* other_callee =
+      module->AddEmbeddedComputation(MakeScalarComputation(HloOpcode::kExp));
+  std::shared_ptr<const CallGraph> with_other_callee =
+      CallGraph::BuildCached(module.get());
+  EXPECT_NE(with_other_callee, call_graph);
+  EXPECT_EQ(with_other_callee->nodes().size(), 3);
+  EXPECT_TRUE(with_other_callee->GetNode(other_callee).callers().empty());
+
+  HloInstruction* call = negate->mutable_operand(0);
+  ASSERT_EQ(call->opcode(), HloOpcode::kCall);
+  call->set_to_apply(other_callee);
+  std::shared_ptr<const CallGraph> retargeted =
+      CallGraph::BuildCached(module.get());
+  EXPECT_NE(retargeted, with_other_callee);
+  EXPECT_TRUE(retargeted->GetNode(callee).callers().empty());
+  EXPECT_THAT(retargeted->GetNode(other_callee).callers(),
+              UnorderedElementsAre(entry));
+
+  // So does removing a callsite.
+  TF_ASSERT_OK(call->ReplaceAllUsesWith(entry->parameter_instruction(0)));
+  TF_ASSERT_OK(entry->RemoveInstruction(call));
+  std::shared_ptr<const CallGraph> without_call =
+      CallGraph::BuildCached(module.get());
+  EXPECT_NE(without_call, retargeted);
+  EXPECT_TRUE(without_call->GetNode(other_callee).callers().empty());
+}
+
 }  // namespace
 }  // namespace xla
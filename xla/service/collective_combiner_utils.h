@@ -65,6 +65,8 @@ absl::StatusOr<bool> CombineInstructionsByKey(
   }
 
   bool changed = false;
+  std::unique_ptr<HloReachabilityMap> reachability;
+  std::vector<HloInstruction*> post_order;
 
   // Keys are removed after the instruction is combined (or never will be).
   while (!keys.empty()) {
@@ -72,14 +74,16 @@ absl::StatusOr<bool> CombineInstructionsByKey(
     int64_t to_combine_bytes = 0;
     absl::flat_hash_set<HloInstruction*>* group = nullptr;
 
-    // Recompute reachability after every combine group because we can't
+    // Recompute reachability after every combined group because we can't
     // maintain a cross group topological order to be able to rely on the
-    // transitive dependencies to detect cycles.
-    std::unique_ptr<HloReachabilityMap> reachability =
-        HloReachabilityMap::Build(computation);
+    // transitive dependencies to detect cycles. Groups that end up not being
+    // combined leave the computation unchanged, so the analyses are reused.
+    if (reachability == nullptr) {
+      reachability = HloReachabilityMap::Build(computation);
+      post_order = computation->MakeInstructionPostOrder();
+    }
 
-    for (HloInstruction* instruction :
-         computation->MakeInstructionPostOrder()) {
+    for (HloInstruction* instruction : post_order) {
       auto it = keys.find(instruction);
       if (it == keys.end()) continue;
 
@@ -152,6 +156,7 @@ absl::StatusOr<bool> CombineInstructionsByKey(
 
     if (to_combine.size() > 1) {
       TF_RETURN_IF_ERROR(combine_fn(to_combine));
+      reachability.reset();
       changed = true;
     }
   }
@@ -1736,7 +1736,6 @@ absl::Status TransformLoopForward(
     TF_RETURN_IF_ERROR(replace_instructions_with(
         absl::MakeSpan(loop_output_to_replace), output_stacked_data));
   }
-  TF_RETURN_IF_ERROR(loop_computation->parent()->RemoveUnusedComputations());
   return absl::OkStatus();
 }
 
@@ -2236,7 +2235,6 @@ absl::Status TransformLoopForwardSink(const WhileLoopAnalysis& loop_analysis,
   TF_RETURN_IF_ERROR(while_loop->ReplaceAllUsesWithDifferentShape(new_tuple));
   TF_RETURN_IF_ERROR(
       loop_computation->RemoveInstructionAndUnusedOperands(while_loop));
-  TF_RETURN_IF_ERROR(loop_computation->parent()->RemoveUnusedComputations());
   return absl::OkStatus();
 }
 
@@ -2263,7 +2261,8 @@ absl::Status TransformLoopForwardSink(const WhileLoopAnalysis& loop_analysis,
 //   x_ag = p0_ag_next
 // }
 // x_last = computation(p0_ag_next)
-static absl::Status TransformLoopBackward(
+// Returns the new while loop.
+static absl::StatusOr<HloInstruction*> TransformLoopBackward(
     const WhileLoopAnalysis& loop_analysis, bool insert_non_alias_custom_call,
     int64_t level_to_operate_on, bool process_different_sized_ops,
     HloPredicate should_process, HloPredicate acceptable_formatting,
@@ -2571,8 +2570,7 @@ static absl::Status TransformLoopBackward(
       while_loop->ReplaceAllUsesWithDifferentShape(final_loop_output));
   TF_RETURN_IF_ERROR(
       loop_computation->RemoveInstructionAndUnusedOperands(while_loop));
-  TF_RETURN_IF_ERROR(loop_computation->parent()->RemoveUnusedComputations());
-  return absl::OkStatus();
+  return new_while_loop;
 }
 
 absl::StatusOr<bool> CollectivePipeliner::Run(
@@ -2595,7 +2593,26 @@ absl::StatusOr<bool> CollectivePipeliner::Run(
   int64_t next_channel_id = hlo_query::NextChannelId(*module);
   VLOG(1) << "Pipelining on direction: "
           << GetPipelineDirectionString(config_.pipelining_direction);
-  for (HloInstruction* instruction : while_loop_instructions) {
+  if (config_.pipelining_depth > 1 &&
+      config_.pipelining_direction != PipeliningDirection::kBackward) {
+    return InvalidArgument(
+        "Pipelining depth greater than 1 is only supported for backward "
+        "pipelining.");
+  }
+  // Each stage of backward pipelining peels one more iteration of the loop
+  // produced by the previous stage, so the collectives start one more
+  // iteration ahead of their uses. The results of the earlier stages rotate
+  // through the loop tuple. Loops are processed in post order, with the stages
+  // of a loop right after each other, so inner loops are transformed before
+  // the bodies containing them are cloned.
+  std::vector<std::pair<HloInstruction*, int64_t>> worklist;
+  for (auto it = while_loop_instructions.rbegin();
+       it != while_loop_instructions.rend(); ++it) {
+    worklist.push_back({*it, config_.pipelining_depth});
+  }
+  while (!worklist.empty()) {
+    auto [instruction, remaining_depth] = worklist.back();
+    worklist.pop_back();
     VLOG(1) << "While: " << instruction->ToString();
     WhileLoopAnalysis loop_analysis(
         instruction, config_.max_pipelining_per_loop, config_.pipeline_use_tree,
@@ -2642,11 +2659,17 @@ absl::StatusOr<bool> CollectivePipeliner::Run(
           config_.should_process, next_channel_id));
     } else {
       CHECK_EQ(config_.pipelining_direction, PipeliningDirection::kBackward);
-      TF_RETURN_IF_ERROR(TransformLoopBackward(
-          loop_analysis, !config_.last_run, config_.level_to_operate_on,
-          config_.process_different_sized_ops, config_.should_process,
-          config_.acceptable_formatting, config_.postprocess_backward_peeled_op,
-          config_.postprocess_backward_rotated_op, next_channel_id));
+      TF_ASSIGN_OR_RETURN(
+          HloInstruction * new_while_loop,
+          TransformLoopBackward(
+              loop_analysis, !config_.last_run, config_.level_to_operate_on,
+              config_.process_different_sized_ops, config_.should_process,
+              config_.acceptable_formatting,
+              config_.postprocess_backward_peeled_op,
+              config_.postprocess_backward_rotated_op, next_channel_id));
+      if (remaining_depth > 1) {
+        worklist.push_back({new_while_loop, remaining_depth - 1});
+      }
     }
     ++transformed_loops;
     changed = true;
@@ -2677,6 +2700,9 @@ absl::StatusOr<bool> CollectivePipeliner::Run(
           << " for pipelining direction: "
           << GetPipelineDirectionString(config_.pipelining_direction);
   // Run necessary cleanup to make sure unused code doesn't trigger HloVerifier.
+  // This also removes the original bodies and conditions of the transformed
+  // loops, which is much cheaper than cloning the module after every loop to
+  // find them.
   if (changed) {
     TF_RETURN_IF_ERROR(HloDCE().Run(module, execution_threads).status());
   }
@@ -102,6 +102,10 @@ class CollectivePipeliner : public HloModulePass {
     // Determines whether a loop invariant instruction can be considered
     // in the pipelining chain.
     bool should_add_loop_invariant_op_in_chain = false;
+    // Number of iterations ahead of their uses that collectives are started.
+    // Each extra stage peels another iteration and keeps one more result live
+    // across iterations. Only supported for kBackward pipelining.
+    int64_t pipelining_depth = 1;
   };
   static const char* const kInsertedByPreviousStep;
   static const char* const kSunkByPreviousStep;
@@ -1338,6 +1338,161 @@ ENTRY entry {
   EXPECT_EQ(add_instr_loop->opcode(), HloOpcode::kAdd);
 }
 
+TEST_F(CollectivePipelinerTest, TransformIncrementIndexByOneBackwardDepthTwo) {
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+while_cond {
+  param = (s32[], bf16[4,8,128], bf16[4,1,2,128]) parameter(0)
+  gte = s32[] get-tuple-element(param), index=0
+  constant.1 = s32[] constant(4)
+  ROOT cmp = pred[] compare(gte, constant.1), direction=LT
+}
+
+while_body {
+  param = (s32[], bf16[4,8,128], bf16[4,1,2,128]) parameter(0)
+  i = s32[] get-tuple-element(param), index=0
+  output = bf16[4,8,128] get-tuple-element(param), index=1
+  weights = bf16[4,1,2,128] get-tuple-element(param), index=2
+  zero = s32[] constant(0)
+  one = s32[] constant(1)
+  next_i = s32[] add(i, one)
+  ds.w = bf16[1,1,2,128] dynamic-slice(weights, i, zero, zero, zero), dynamic_slice_sizes={1,1,2,128}
+  r = bf16[1,2,128] reshape(ds.w)
+  ag = bf16[1,8,128] all-gather(r), dimensions={1}, replica_groups={}
+  ds.o = bf16[1,8,128] dynamic-slice(output, i, zero, zero), dynamic_slice_sizes={1,8,128}
+  mul = bf16[1,8,128] multiply(ds.o, ag)
+  dus = bf16[4,8,128] dynamic-update-slice(output, mul, i, zero, zero)
+  ROOT tuple = (s32[], bf16[4,8,128], bf16[4,1,2,128]) tuple(next_i, dus, weights)
+}
+
+ENTRY entry {
+  c0 = s32[] constant(0)
+  p0 = bf16[4,8,128] parameter(0)
+  p1 = bf16[4,1,2,128] parameter(1)
+  tuple = (s32[], bf16[4,8,128], bf16[4,1,2,128]) tuple(c0, p0, p1)
+  while = (s32[], bf16[4,8,128], bf16[4,1,2,128]) while(tuple), condition=while_cond, body=while_body
+  ROOT gte1 = bf16[4,8,128] get-tuple-element(while), index=1
+}
+)";
+  auto module = ParseAndReturnUnverifiedModule(hlo_string, config_).value();
+  CollectivePipeliner::Config config;
+  config.max_pipelining_per_loop = INT64_MAX;
+  config.pipelining_direction =
+      CollectivePipeliner::PipeliningDirection::kBackward;
+  config.should_process = HloPredicateIsOp<HloOpcode::kAllGather>;
+  config.acceptable_formatting = HloPredicateTrue;
+  config.reuse_pipelined_op_buffer = HloPredicateTrue;
+  config.pipelining_depth = 2;
+  HloPassPipeline pass("optimizer");
+  pass.AddPass<HloVerifier>(/*layout_sensitive=*/false,
+                            /*allow_mixed_precision=*/false);
+  pass.AddPass<CollectivePipeliner>(config);
+  pass.AddPass<HloVerifier>(/*layout_sensitive=*/false,
+                            /*allow_mixed_precision=*/false);
+  EXPECT_TRUE(pass.Run(module.get()).value());
+  XLA_VLOG_LINES(1, module->ToString());
+  // The all-gathers of the first two iterations are peeled before the loop,
+  // which gathers the weights two iterations ahead.
+  auto count = [](const HloComputation* computation, HloOpcode opcode) {
+    return absl::c_count_if(computation->instructions(),
+                            [&](const HloInstruction* instruction) {
+                              return instruction->opcode() == opcode;
+                            });
+  };
+  EXPECT_EQ(count(module->entry_computation(), HloOpcode::kWhile), 1);
+  EXPECT_EQ(count(module->entry_computation(), HloOpcode::kAllGather), 2);
+  const HloInstruction* while_instr =
+      FindInstruction(module.get(), HloOpcode::kWhile);
+  EXPECT_EQ(count(while_instr->while_body(), HloOpcode::kAllGather), 1);
+  EXPECT_EQ(while_instr->shape().tuple_shapes_size(), 5);
+}
+
+TEST_F(CollectivePipelinerTest, PipeliningDepthRequiresBackward) {
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  ROOT p0 = bf16[8] parameter(0)
+}
+)";
+  auto module = ParseAndReturnUnverifiedModule(hlo_string, config_).value();
+  CollectivePipeliner::Config config;
+  config.should_process = HloPredicateIsOp<HloOpcode::kAllReduce>;
+  config.acceptable_formatting = HloPredicateTrue;
+  config.reuse_pipelined_op_buffer = HloPredicateTrue;
+  config.pipelining_depth = 2;
+  EXPECT_FALSE(CollectivePipeliner(config).Run(module.get()).ok());
+}
+
+TEST_F(CollectivePipelinerTest,
+       TransformIncrementIndexByOneBackwardMoveToDevice) {
+  // Host-offloaded weights of every layer are transferred to the device one
+  // iteration ahead of their use.
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+while_cond {
+  param = (s32[], bf16[3,8,128], bf16[8,128]) parameter(0)
+  gte = s32[] get-tuple-element(param), index=0
+  constant.1 = s32[] constant(3)
+  ROOT cmp = pred[] compare(gte, constant.1), direction=LT
+}
+
+while_body {
+  param = (s32[], bf16[3,8,128], bf16[8,128]) parameter(0)
+  i = s32[] get-tuple-element(param), index=0
+  weights = bf16[3,8,128] get-tuple-element(param), index=1
+  acc = bf16[8,128] get-tuple-element(param), index=2
+  constant.0 = s32[] constant(0)
+  constant.1 = s32[] constant(1)
+  next_i = s32[] add(i, constant.1)
+  slice = bf16[1,8,128] dynamic-slice(weights, i, constant.0, constant.0), dynamic_slice_sizes={1,8,128}
+  on_device = bf16[1,8,128] custom-call(slice), custom_call_target="MoveToDevice"
+  layer_weights = bf16[8,128] reshape(on_device)
+  next_acc = bf16[8,128] multiply(acc, layer_weights)
+  ROOT tuple = (s32[], bf16[3,8,128], bf16[8,128]) tuple(next_i, weights, next_acc)
+}
+
+ENTRY entry {
+  c0 = s32[] constant(0)
+  p0 = bf16[3,8,128] parameter(0)
+  p1 = bf16[8,128] parameter(1)
+  tuple = (s32[], bf16[3,8,128], bf16[8,128]) tuple(c0, p0, p1)
+  while = (s32[], bf16[3,8,128], bf16[8,128]) while(tuple), condition=while_cond, body=while_body
+  ROOT gte1 = bf16[8,128] get-tuple-element(while), index=2
+}
+)";
+  auto module = ParseAndReturnUnverifiedModule(hlo_string, config_).value();
+  auto is_move_to_device = [](const HloInstruction* instr) {
+    return instr->IsCustomCall("MoveToDevice");
+  };
+  EXPECT_TRUE(RunOptimizer(module.get(), /*last_run=*/true, 0,
+                           /*pipeline_use_tree=*/false,
+                           /*process_different_sized_ops=*/true,
+                           CollectivePipeliner::PipeliningDirection::kBackward,
+                           is_move_to_device)
+                  .value());
+  XLA_VLOG_LINES(1, module->ToString());
+  // The weights of the first layer are transferred before the loop.
+  EXPECT_EQ(absl::c_count_if(module->entry_computation()->instructions(),
+                             is_move_to_device),
+            1);
+  // The loop transfers the weights of the next layer and passes them to the
+  // next iteration, where they are used.
+  const HloInstruction* while_instr =
+      FindInstruction(module.get(), HloOpcode::kWhile);
+  const HloComputation* body = while_instr->while_body();
+  EXPECT_EQ(body->root_instruction()->operand_count(), 4);
+  EXPECT_TRUE(absl::c_any_of(body->root_instruction()->operands(),
+                             is_move_to_device));
+  const HloInstruction* multiply =
+      FindInstruction(module.get(), HloOpcode::kMultiply);
+  EXPECT_THAT(multiply,
+              op::Multiply(_, op::Reshape(op::GetTupleElement(
+                                  op::Parameter(0)))));
+}
+
 TEST_F(CollectivePipelinerTest,
        TransformIncrementIndexByOneBackwardsCollectivePermute) {
   constexpr absl::string_view hlo_string = R"(
@@ -15,12 +15,25 @@ limitations under the License.
 
 #include "xla/service/compilation_cache.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <utility>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/service/compiler.h"
+#include "xla/service/executable.h"
+#include "xla/stream_executor/stream_executor.h"
 #include "xla/types.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/strcat.h"
 
 namespace xla {
@@ -37,6 +50,9 @@ int64_t GetUniqueId() {
 
 }  // namespace
 
+CompilationCache::CompilationCache(Options options)
+    : options_(std::move(options)) {}
+
 ExecutionHandle CompilationCache::Insert(
     std::unique_ptr<Executable> executable) {
   absl::MutexLock lock(&mutex_);
@@ -44,7 +60,12 @@ ExecutionHandle CompilationCache::Insert(
   CacheKey key = GetUniqueId();
   VLOG(2) << "inserting cache key: " << key;
   CHECK_EQ(cache_.count(key), 0);
-  cache_.emplace(key, std::move(executable));
+  int64_t size_in_bytes =
+      std::max<int64_t>(executable->SizeOfGeneratedCodeInBytes(), 0);
+  cache_.emplace(key, Entry{std::move(executable), size_in_bytes,
+                            lru_.insert(lru_.end(), key)});
+  size_in_bytes_ += size_in_bytes;
+  EvictIfNeeded();
 
   ExecutionHandle handle;
   handle.set_handle(key);
@@ -52,19 +73,161 @@ ExecutionHandle CompilationCache::Insert(
 }
 
 absl::StatusOr<std::shared_ptr<Executable>> CompilationCache::LookUp(
-    const ExecutionHandle& handle) const {
+    const ExecutionHandle& handle) {
   absl::MutexLock lock(&mutex_);
 
   CacheKey key = handle.handle();
   VLOG(2) << "looking up cache key: " << key;
-  if (cache_.count(key) == 0) {
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
     VLOG(2) << "cache key not found: " << key;
+    return InvalidArgumentStrCat(
+        "can not find executable with handle ", key,
+        " (it may have been evicted from the compilation cache)");
+  }
+  Entry& entry = it->second;
+  lru_.splice(lru_.end(), lru_, entry.lru_it);
+  VLOG(2) << "hit executable: " << entry.executable->module().name();
+  return entry.executable;
+}
+
+absl::Status CompilationCache::Remove(const ExecutionHandle& handle) {
+  absl::MutexLock lock(&mutex_);
+
+  CacheKey key = handle.handle();
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
     return InvalidArgumentStrCat("can not find executable with handle ", key);
-  } else {
-    auto& result = cache_.at(key);
-    VLOG(2) << "hit executable: " << result->module().name();
-    return result;
   }
+  size_in_bytes_ -= it->second.size_in_bytes;
+  lru_.erase(it->second.lru_it);
+  cache_.erase(it);
+  return absl::OkStatus();
+}
+
+void CompilationCache::EvictIfNeeded() {
+  auto over_limit = [&] {
+    return (options_.max_entries > 0 &&
+            static_cast<int64_t>(cache_.size()) > options_.max_entries) ||
+           (options_.max_bytes > 0 && size_in_bytes_ > options_.max_bytes);
+  };
+
+  // The most recently used entry is never evicted, as it is the one that was
+  // just inserted and its handle has not been returned to the caller yet.
+  auto lru_it = lru_.begin();
+  while (over_limit() && lru_it != lru_.end() &&
+         std::next(lru_it) != lru_.end()) {
+    auto it = cache_.find(*lru_it);
+    // Executables referenced outside of the cache are in use, and evicting
+    // them would not release any memory.
+    if (it->second.executable.use_count() > 1) {
+      ++lru_it;
+      continue;
+    }
+    VLOG(2) << "evicting cache key: " << it->first << " ("
+            << it->second.size_in_bytes << " bytes)";
+    size_in_bytes_ -= it->second.size_in_bytes;
+    lru_it = lru_.erase(lru_it);
+    cache_.erase(it);
+  }
+
+  if (over_limit()) {
+    VLOG(1) << "compilation cache is over its limits after eviction: "
+            << cache_.size() << " executables, " << size_in_bytes_ << " bytes";
+  }
+}
+
+int64_t CompilationCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return cache_.size();
+}
+
+int64_t CompilationCache::size_in_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return size_in_bytes_;
+}
+
+absl::StatusOr<std::unique_ptr<Executable>>
+CompilationCache::LoadFromPersistentCache(
+    const std::string& key, Compiler* compiler,
+    const se::StreamExecutor* executor) const {
+  if (options_.persistent_cache_dir.empty()) return nullptr;
+
+  tsl::Env* env = tsl::Env::Default();
+  std::string path = tsl::io::JoinPath(options_.persistent_cache_dir,
+                                       absl::StrCat(key, ".xla_executable"));
+  if (!env->FileExists(path).ok()) return nullptr;
+
+  std::string serialized;
+  if (auto read = tsl::ReadFileToString(env, path, &serialized); !read.ok()) {
+    LOG(WARNING) << "Failed to read persistent compilation cache entry " << path
+                 << ": " << read;
+    return nullptr;
+  }
+
+  auto aot_result = compiler->LoadAotCompilationResult(serialized);
+  if (!aot_result.ok()) {
+    LOG(WARNING) << "Failed to deserialize persistent compilation cache entry "
+                 << path << ": " << aot_result.status();
+    return nullptr;
+  }
+
+  auto executable = (*aot_result)->LoadExecutable(compiler, executor);
+  if (!executable.ok()) {
+    LOG(WARNING) << "Failed to load persistent compilation cache entry "
+                 << path << ": " << executable.status();
+    return nullptr;
+  }
+
+  VLOG(1) << "Loaded executable from persistent compilation cache entry "
+          << path;
+  return std::move(executable).value();
+}
+
+void CompilationCache::StoreToPersistentCache(const std::string& key,
+                                              Executable* executable,
+                                              const Compiler* compiler) const {
+  if (options_.persistent_cache_dir.empty()) return;
+
+  auto aot_result = compiler->Export(executable);
+  if (!aot_result.ok()) {
+    VLOG(1) << "Can't export executable for persistent compilation cache: "
+            << aot_result.status();
+    return;
+  }
+  auto serialized = (*aot_result)->SerializeAsString();
+  if (!serialized.ok()) {
+    VLOG(1) << "Can't serialize executable for persistent compilation cache: "
+            << serialized.status();
+    return;
+  }
+
+  tsl::Env* env = tsl::Env::Default();
+  std::string path = tsl::io::JoinPath(options_.persistent_cache_dir,
+                                       absl::StrCat(key, ".xla_executable"));
+
+  // Write to a temporary file first and rename it, so that concurrent readers
+  // in other processes never see a partially written entry.
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    LOG(WARNING) << "Failed to create temporary file name for " << path;
+    return;
+  }
+
+  absl::Status stored =
+      env->RecursivelyCreateDir(options_.persistent_cache_dir);
+  if (stored.ok()) stored = tsl::WriteStringToFile(env, tmp_path, *serialized);
+  if (stored.ok()) stored = env->RenameFile(tmp_path, path);
+
+  if (!stored.ok()) {
+    LOG(WARNING) << "Failed to store persistent compilation cache entry "
+                 << path << ": " << stored;
+    env->DeleteFile(tmp_path).IgnoreError();
+    return;
+  }
+
+  VLOG(1) << "Stored executable to persistent compilation cache entry "
+          << path;
 }
 
 }  // namespace xla
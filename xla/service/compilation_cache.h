@@ -16,43 +16,111 @@ limitations under the License.
 #ifndef XLA_SERVICE_COMPILATION_CACHE_H_
 #define XLA_SERVICE_COMPILATION_CACHE_H_
 
-#include <map>
+#include <cstdint>
+#include <list>
 #include <memory>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/service/compiler.h"
 #include "xla/service/executable.h"
 #include "xla/service/hlo_module_config.h"
+#include "xla/stream_executor/stream_executor.h"
 #include "xla/types.h"
+#include "xla/xla_data.pb.h"
 
 namespace xla {
 
 // A cache which stores Executables indexed by computation handle and version.
 //
-// TODO(b/119042872): Provide mechanism for removing computations from the
-// compilation cache.
+// The cache can be bounded by the number of executables and by the total size
+// of their generated code. When a bound is exceeded the least recently used
+// executables are evicted, except the ones that are still in use (i.e. someone
+// outside of the cache holds a reference to them, for example a running
+// execution), and the most recently inserted one. Handles of evicted
+// executables become invalid.
+//
+// Optionally, executables can also be stored in a persistent cache directory
+// in serialized form, so that other processes sharing the directory can load
+// them instead of compiling the same computation again.
 class CompilationCache {
  public:
-  CompilationCache() {}
+  struct Options {
+    // The maximum number of executables in the cache, or 0 if unlimited.
+    int64_t max_entries = 0;
+
+    // The maximum total size of generated code of executables in the cache, or
+    // 0 if unlimited. Executables that don't know their size count as empty.
+    int64_t max_bytes = 0;
+
+    // If non-empty, executables are serialized into this directory, and
+    // loaded from it on a cache miss in LoadFromPersistentCache.
+    std::string persistent_cache_dir;
+  };
+
+  CompilationCache() = default;
+  explicit CompilationCache(Options options);
 
   ExecutionHandle Insert(std::unique_ptr<Executable> executable);
 
   // Lookup the Executable for the specified handle in the cache. Return a
   // shared_ptr to the Executable if it exists in the cache.
   absl::StatusOr<std::shared_ptr<Executable>> LookUp(
-      const ExecutionHandle& handle) const;
+      const ExecutionHandle& handle);
+
+  // Removes the Executable for the specified handle from the cache. Executions
+  // that already looked it up keep it alive until they finish.
+  absl::Status Remove(const ExecutionHandle& handle);
+
+  // Loads an executable stored under `key` (which must be a valid file name)
+  // from the persistent cache directory. Returns nullptr if the persistent
+  // cache is disabled or doesn't have a usable entry for `key`.
+  absl::StatusOr<std::unique_ptr<Executable>> LoadFromPersistentCache(
+      const std::string& key, Compiler* compiler,
+      const se::StreamExecutor* executor) const;
+
+  // Serializes `executable` into the persistent cache directory under `key`.
+  // Failures are logged and otherwise ignored, as the executable can always
+  // be compiled again.
+  void StoreToPersistentCache(const std::string& key, Executable* executable,
+                              const Compiler* compiler) const;
+
+  const Options& options() const { return options_; }
+
+  int64_t size() const;
+  int64_t size_in_bytes() const;
 
  protected:
   mutable absl::Mutex mutex_;
 
   using CacheKey = int64_t;
 
-  absl::flat_hash_map<CacheKey, std::shared_ptr<Executable>> cache_
-      ABSL_GUARDED_BY(mutex_);
+  struct Entry {
+    std::shared_ptr<Executable> executable;
+    int64_t size_in_bytes;
+    // Position of the key in `lru_`.
+    std::list<CacheKey>::iterator lru_it;
+  };
+
+  // Evicts least recently used entries until the cache is within bounds or
+  // the remaining entries can't be evicted.
+  void EvictIfNeeded() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::flat_hash_map<CacheKey, Entry> cache_ ABSL_GUARDED_BY(mutex_);
+
+  // Cache keys in order from least recently used to most recently used.
+  std::list<CacheKey> lru_ ABSL_GUARDED_BY(mutex_);
+
+  int64_t size_in_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
 
  private:
   CompilationCache(const CompilationCache&) = delete;
   CompilationCache& operator=(const CompilationCache&) = delete;
+
+  Options options_;
 };
 
 }  // namespace xla
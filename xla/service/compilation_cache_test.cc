@@ -0,0 +1,135 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/compilation_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/statusor.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/executable.h"
+#include "xla/service/hlo_execution_profile.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace {
+
+// An executable that can't be executed but reports the size of its code.
+class FakeExecutable : public Executable {
+ public:
+  explicit FakeExecutable(int64_t size_in_bytes)
+      : Executable(std::make_shared<HloModule>("fake", HloModuleConfig())),
+        size_in_bytes_(size_in_bytes) {}
+
+  absl::StatusOr<ExecutionOutput> ExecuteAsyncOnStream(
+      const ServiceExecutableRunOptions* run_options,
+      std::vector<ExecutionInput> arguments,
+      HloExecutionProfile* hlo_execution_profile) override {
+    return Unimplemented("FakeExecutable can't be executed");
+  }
+
+  int64_t SizeOfGeneratedCodeInBytes() const override {
+    return size_in_bytes_;
+  }
+
+ private:
+  int64_t size_in_bytes_;
+};
+
+TEST(CompilationCacheTest, UnboundedCacheKeepsAllExecutables) {
+  CompilationCache cache;
+  std::vector<ExecutionHandle> handles;
+  for (int i = 0; i < 8; ++i) {
+    handles.push_back(cache.Insert(std::make_unique<FakeExecutable>(100)));
+  }
+  EXPECT_EQ(cache.size(), 8);
+  EXPECT_EQ(cache.size_in_bytes(), 800);
+  for (const ExecutionHandle& handle : handles) {
+    EXPECT_TRUE(cache.LookUp(handle).ok());
+  }
+}
+
+TEST(CompilationCacheTest, EvictsLeastRecentlyUsedEntries) {
+  CompilationCache cache({/*max_entries=*/2});
+  ExecutionHandle a = cache.Insert(std::make_unique<FakeExecutable>(1));
+  ExecutionHandle b = cache.Insert(std::make_unique<FakeExecutable>(1));
+
+  // Use `a` so that `b` becomes the least recently used entry.
+  TF_ASSERT_OK(cache.LookUp(a).status());
+
+  ExecutionHandle c = cache.Insert(std::make_unique<FakeExecutable>(1));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(cache.LookUp(a).ok());
+  EXPECT_FALSE(cache.LookUp(b).ok());
+  EXPECT_TRUE(cache.LookUp(c).ok());
+}
+
+TEST(CompilationCacheTest, EvictsByGeneratedCodeSize) {
+  CompilationCache cache({/*max_entries=*/0, /*max_bytes=*/250});
+  ExecutionHandle a = cache.Insert(std::make_unique<FakeExecutable>(100));
+  ExecutionHandle b = cache.Insert(std::make_unique<FakeExecutable>(100));
+  ExecutionHandle c = cache.Insert(std::make_unique<FakeExecutable>(100));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.size_in_bytes(), 200);
+  EXPECT_FALSE(cache.LookUp(a).ok());
+  EXPECT_TRUE(cache.LookUp(b).ok());
+  EXPECT_TRUE(cache.LookUp(c).ok());
+
+  // The most recently inserted executable is kept even if it doesn't fit.
+  ExecutionHandle d = cache.Insert(std::make_unique<FakeExecutable>(1000));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.LookUp(d).ok());
+}
+
+TEST(CompilationCacheTest, DoesNotEvictExecutablesInUse) {
+  CompilationCache cache({/*max_entries=*/1});
+  ExecutionHandle a = cache.Insert(std::make_unique<FakeExecutable>(1));
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Executable> in_use,
+                          cache.LookUp(a));
+
+  ExecutionHandle b = cache.Insert(std::make_unique<FakeExecutable>(1));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(cache.LookUp(a).ok());
+  EXPECT_TRUE(cache.LookUp(b).ok());
+
+  // Once released, `a` is evicted with the next insertion.
+  in_use.reset();
+  TF_ASSERT_OK(cache.LookUp(b).status());
+  ExecutionHandle c = cache.Insert(std::make_unique<FakeExecutable>(1));
+  EXPECT_FALSE(cache.LookUp(a).ok());
+  EXPECT_TRUE(cache.LookUp(c).ok());
+}
+
+TEST(CompilationCacheTest, RemovesExecutables) {
+  CompilationCache cache;
+  ExecutionHandle a = cache.Insert(std::make_unique<FakeExecutable>(100));
+  TF_ASSERT_OK(cache.Remove(a));
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.size_in_bytes(), 0);
+  EXPECT_FALSE(cache.LookUp(a).ok());
+  EXPECT_FALSE(cache.Remove(a).ok());
+}
+
+}  // namespace
+}  // namespace xla
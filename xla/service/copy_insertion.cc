@@ -20,6 +20,8 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
@@ -2001,7 +2003,8 @@ absl::Status CopyInsertion::AddCopiesToResolveInterference(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
   TF_ASSIGN_OR_RETURN(std::unique_ptr<HloAliasAnalysis> alias_analysis,
-                      HloAliasAnalysis::Run(module, can_share_buffer_));
+                      TakeOrRunAliasAnalysis(module));
+  int64_t instruction_count_before = module->instruction_count();
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
     if (computation->IsAsyncComputation()) {
@@ -2068,13 +2071,27 @@ absl::Status CopyInsertion::AddCopiesToResolveInterference(
 
   TF_RETURN_IF_ERROR(
       AddCopiesForAliasedInputOutputs(module, execution_threads));
+  if (module->instruction_count() == instruction_count_before) {
+    reusable_alias_analysis_ = std::move(alias_analysis);
+  }
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::unique_ptr<HloAliasAnalysis>>
+CopyInsertion::TakeOrRunAliasAnalysis(HloModule* module) {
+  if (reusable_alias_analysis_ != nullptr) {
+    VLOG(2) << "Reusing alias analysis of unchanged module " << module->name();
+    return std::move(reusable_alias_analysis_);
+  }
+  return HloAliasAnalysis::Run(module, can_share_buffer_);
+}
+
 absl::Status CopyInsertion::AddSpecialCaseCopies(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
-  std::unique_ptr<CallGraph> call_graph = CallGraph::Build(module);
+  // The module may have been changed by other passes since the last analysis.
+  reusable_alias_analysis_.reset();
+  std::shared_ptr<const CallGraph> call_graph = CallGraph::BuildCached(module);
   return AddSpecialCaseCopies(*call_graph, execution_threads, module);
 }
 
@@ -2083,7 +2100,7 @@ absl::Status CopyInsertion::AddSpecialCaseCopies(
     const absl::flat_hash_set<absl::string_view>& execution_threads,
     HloModule* module) {
   TF_ASSIGN_OR_RETURN(std::unique_ptr<HloAliasAnalysis> alias_analysis,
-                      HloAliasAnalysis::Run(module, can_share_buffer_));
+                      TakeOrRunAliasAnalysis(module));
 
   // Identify which shape indices of which instructions need to be copied. Store
   // these results in 'instructions_to_copy'.
@@ -2248,6 +2265,18 @@ static int64_t GetNumExistingCopies(
 absl::Status CopyInsertion::RemoveUnnecessaryCopies(
     HloModule* module, bool check_live_range_ordering,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  // Outside of Run the module may have been changed by other passes in between
+  // calls, so neither consume nor leave behind an alias analysis.
+  reusable_alias_analysis_.reset();
+  absl::Status status = RemoveUnnecessaryCopiesImpl(
+      module, check_live_range_ordering, execution_threads);
+  reusable_alias_analysis_.reset();
+  return status;
+}
+
+absl::Status CopyInsertion::RemoveUnnecessaryCopiesImpl(
+    HloModule* module, bool check_live_range_ordering,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
   XLA_VLOG_LINES(
       4, module->ToString(HloPrintOptions().set_syntax_sugar_async_ops(false)));
 
@@ -2262,7 +2291,7 @@ absl::Status CopyInsertion::RemoveUnnecessaryCopies(
   }
 
   TF_ASSIGN_OR_RETURN(std::unique_ptr<HloAliasAnalysis> alias_analysis,
-                      HloAliasAnalysis::Run(module, can_share_buffer_));
+                      TakeOrRunAliasAnalysis(module));
   CopyRemover copy_remover(*module, *alias_analysis, ordering.get(),
                            check_live_range_ordering, execution_threads);
   if (VLOG_IS_ON(3)) {
@@ -2273,9 +2302,21 @@ absl::Status CopyInsertion::RemoveUnnecessaryCopies(
     }
   }
 
-  std::unique_ptr<CallGraph> call_graph = CallGraph::Build(module);
-
   int64_t num_existing_copies = GetNumExistingCopies(module, execution_threads);
+  // Elision only rewires the users of copies and never adds instructions, so
+  // the copies can be collected once instead of rescanning every instruction
+  // in each fixpoint iteration.
+  std::vector<std::pair<HloComputation*, std::vector<HloInstruction*>>>
+      copies_per_computation;
+  for (HloComputation* computation : module->computations(execution_threads)) {
+    std::vector<HloInstruction*> copies;
+    for (HloInstruction* instruction : computation->instructions()) {
+      if (instruction->opcode() == HloOpcode::kCopy) {
+        copies.push_back(instruction);
+      }
+    }
+    copies_per_computation.emplace_back(computation, std::move(copies));
+  }
   bool changed = true;
   int64_t num_iterations = -1;
   VLOG(6) << "Copy Insertion analyzing module with instruction count = "
@@ -2286,12 +2327,9 @@ absl::Status CopyInsertion::RemoveUnnecessaryCopies(
     changed = false;
     VLOG(2) << "Running fixpoint iteration " << num_iterations
             << " of copy elision";
-    for (HloComputation* computation :
-         module->computations(execution_threads)) {
+    for (const auto& [computation, copies] : copies_per_computation) {
       VLOG(2) << "computation:" << computation->name();
-      for (HloInstruction* instruction : computation->instructions()) {
-        if (instruction->opcode() != HloOpcode::kCopy) continue;
-
+      for (HloInstruction* instruction : copies) {
         // The region_analysis_cost_now is always set to
         // use_region_based_live_range_analysis_ if it is < 0, in which case the
         // analysis is always performed.
@@ -2317,6 +2355,11 @@ absl::Status CopyInsertion::RemoveUnnecessaryCopies(
       }
     }
   }
+  // If no copy was elided the module is unchanged and the analysis is still
+  // valid for the special-case copies that follow.
+  if (num_iterations == 0) {
+    reusable_alias_analysis_ = std::move(alias_analysis);
+  }
   return absl::OkStatus();
 }
 
@@ -2347,7 +2390,7 @@ absl::StatusOr<bool> CopyInsertion::Run(
   // interference. If all copies were added in step (1) then copy removal would
   // also have to reason about things like constants and parameters live out of
   // the computation.
-  std::unique_ptr<CallGraph> call_graph = CallGraph::Build(module);
+  std::shared_ptr<const CallGraph> call_graph = CallGraph::BuildCached(module);
   if (!call_graph->IsFlattened()) {
     return FailedPrecondition(
         "Call graph must be flattened before copy insertion.");
@@ -2355,6 +2398,9 @@ absl::StatusOr<bool> CopyInsertion::Run(
 
   int64_t num_copies_before = GetNumExistingCopies(module, execution_threads);
 
+  // Each step hands its alias analysis to the next one if it did not change
+  // the module, saving a full dataflow analysis on large modules.
+  reusable_alias_analysis_.reset();
   TF_RETURN_IF_ERROR(AddCopiesToResolveInterference(module, execution_threads));
 
   // Simplify the tuple structures introduced by the deep copies. This should be
@@ -2364,20 +2410,24 @@ absl::StatusOr<bool> CopyInsertion::Run(
   // instructions introduced by tuple simplification.
   TupleSimplifier tuple_simplifier;
   HloDCE dce;
-  TF_RETURN_IF_ERROR(tuple_simplifier.Run(module, execution_threads).status());
-  TF_RETURN_IF_ERROR(dce.Run(module, execution_threads).status());
+  TF_ASSIGN_OR_RETURN(bool tuples_simplified,
+                      tuple_simplifier.Run(module, execution_threads));
+  TF_ASSIGN_OR_RETURN(bool dce_changed, dce.Run(module, execution_threads));
+  if (tuples_simplified || dce_changed) {
+    reusable_alias_analysis_.reset();
+  }
   DumpHloModuleDuringPassIfEnabled(
       name(), "after adding copies to resolve interference", *module);
 
-  TF_RETURN_IF_ERROR(RemoveUnnecessaryCopies(module,
-                                             /*check_live_range_ordering=*/true,
-                                             execution_threads));
+  TF_RETURN_IF_ERROR(RemoveUnnecessaryCopiesImpl(
+      module, /*check_live_range_ordering=*/true, execution_threads));
   DumpHloModuleDuringPassIfEnabled(name(), "after removing unnecessary copies",
                                    *module);
   TF_RETURN_IF_ERROR(
       AddSpecialCaseCopies(*call_graph, execution_threads, module));
   DumpHloModuleDuringPassIfEnabled(name(), "after adding special-case copies",
                                    *module);
+  reusable_alias_analysis_.reset();
 
   TF_RETURN_IF_ERROR(tuple_simplifier.Run(module, execution_threads).status());
   TF_RETURN_IF_ERROR(dce.Run(module, execution_threads).status());
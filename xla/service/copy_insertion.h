@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef XLA_SERVICE_COPY_INSERTION_H_
 #define XLA_SERVICE_COPY_INSERTION_H_
 
+#include <cstdint>
+#include <memory>
+
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
@@ -109,7 +112,23 @@ class CopyInsertion : public HloModulePass {
   absl::Status AddCopiesToResolveInterference(
       HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads);
+
+  // Implements RemoveUnnecessaryCopies. Consumes the alias analysis left by
+  // the previous step of Run and leaves it behind if no copy was elided.
+  absl::Status RemoveUnnecessaryCopiesImpl(
+      HloModule* module, bool check_live_range_ordering,
+      const absl::flat_hash_set<absl::string_view>& execution_threads);
+
+  // Returns the alias analysis left by the previous step of Run if that step
+  // did not change the module, and otherwise runs a new analysis.
+  absl::StatusOr<std::unique_ptr<HloAliasAnalysis>> TakeOrRunAliasAnalysis(
+      HloModule* module);
+
   int64_t use_region_based_live_range_analysis_;
+
+  // Alias analysis of the module as left by the last step of Run, valid only
+  // until the module is changed.
+  std::unique_ptr<HloAliasAnalysis> reusable_alias_analysis_;
 };
 
 }  // namespace xla
@@ -141,6 +141,31 @@ TEST_F(CopyInsertionTest, SingleConstant) {
               op::Tuple(op::Copy(constant)));
 }
 
+TEST_F(CopyInsertionTest, PassInstanceReusedAcrossModules) {
+  // Neither module needs copies to resolve interference, so the alias analysis
+  // is handed from step to step within a run. It must not leak into the run on
+  // the next module.
+  const char* const kModuleString = R"(
+HloModule module
+
+ENTRY entry {
+  p0 = f32[] parameter(0)
+  c0 = f32[] constant(1)
+  ROOT tuple = (f32[], f32[]) tuple(p0, c0)
+}
+)";
+  CopyInsertion copy_insertion;
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(auto module,
+                            ParseAndReturnVerifiedModule(kModuleString));
+    ASSERT_IS_OK(copy_insertion.Run(module.get()).status());
+    EXPECT_EQ(CountCopies(*module), 2);
+    EXPECT_THAT(
+        module->entry_computation()->root_instruction(),
+        op::Tuple(op::Copy(op::Parameter(0)), op::Copy(op::Constant())));
+  }
+}
+
 TEST_F(CopyInsertionTest, ExistingCopiesNotRemoved) {
   // Verify that kCopy instructions which change layout and exist before
   // copy-insertion remain in the graph after copy-insertion.
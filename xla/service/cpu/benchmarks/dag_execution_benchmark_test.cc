@@ -29,9 +29,8 @@ limitations under the License.
 
 namespace xla::cpu {
 
-static void BM_DagExecution(benchmark::State& state) {
-  int64_t d0 = state.range(0);
-
+static void RunDagExecution(benchmark::State& state, int64_t d0,
+                            const HloBenchmarkOptions& options) {
   // We use this benchmark to test how well XLA does the scheduling of the HLO
   // module to extract available parallelism, and how well ThunkExecutor
   // exploits that parallelism at run time.
@@ -87,7 +86,23 @@ static void BM_DagExecution(benchmark::State& state) {
   auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
 
   std::vector<const Literal*> args = {&p0};
-  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}}));
+  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}},
+                           options));
+}
+
+static void BM_DagExecution(benchmark::State& state) {
+  RunDagExecution(state, state.range(0), HloBenchmarkOptions());
+}
+
+// Measures how thunk executor scales with the number of intra-op threads, with
+// and without the work-stealing task runner. We measure wall time because the
+// goal is to see the speedup from adding more threads.
+static void BM_DagExecutionScaling(benchmark::State& state) {
+  HloBenchmarkOptions options;
+  options.intra_op_parallelism = state.range(1);
+  options.use_thunk_runtime = true;
+  options.use_work_stealing_thunk_executor = state.range(2);
+  RunDagExecution(state, state.range(0), options);
 }
 
 BENCHMARK(BM_DagExecution)
@@ -99,4 +114,9 @@ BENCHMARK(BM_DagExecution)
     ->Arg(8192)
     ->Arg(16384);
 
+BENCHMARK(BM_DagExecutionScaling)
+    ->UseRealTime()
+    ->ArgNames({"d0", "threads", "work_stealing"})
+    ->ArgsProduct({{1024, 8192}, {1, 2, 4, 8, 16, 32, 64}, {0, 1}});
+
 }  // namespace xla::cpu
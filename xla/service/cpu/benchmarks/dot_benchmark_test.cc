@@ -84,4 +84,65 @@ BENCHMARK(BM_BatchedDotF32)
     ->ArgPair(8, 256)
     ->ArgPair(8, 512);
 
+// Small matrix multiplications compiled to tiled LLVM IR kernels (when
+// multi-threaded Eigen is disabled) or to calls to Eigen runtime.
+static void BM_SmallDotF32(benchmark::State& state, bool tiled_llvm_ir) {
+  int64_t m = state.range(0);
+  int64_t k = state.range(1);
+  int64_t n = state.range(2);
+
+  std::string_view hlo = R"(
+    HloModule dot_f32_$m_$k_$n
+
+    ENTRY e {
+      p0 = f32[$m,$k] parameter(0)
+      p1 = f32[$k,$n] parameter(1)
+      ROOT dot = f32[$m,$n] dot(p0, p1),
+        lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto lhs_shape = ShapeUtil::MakeShape(F32, {m, k});
+  auto rhs_shape = ShapeUtil::MakeShape(F32, {k, n});
+  auto p0 =
+      *LiteralUtil::CreateRandomLiteral<F32>(lhs_shape, &engine, 1.0f, 0.1f);
+  auto p1 =
+      *LiteralUtil::CreateRandomLiteral<F32>(rhs_shape, &engine, 1.0f, 0.1f);
+
+  HloBenchmarkOptions options;
+  options.disable_multi_thread_eigen = tiled_llvm_ir;
+
+  std::vector<const Literal*> args = {&p0, &p1};
+  CHECK_OK(RunHloBenchmark(state, hlo, args,
+                           {{"$m", absl::StrCat(m)},
+                            {"$k", absl::StrCat(k)},
+                            {"$n", absl::StrCat(n)}},
+                           options));
+}
+
+static void BM_SmallDotF32Eigen(benchmark::State& state) {
+  BM_SmallDotF32(state, /*tiled_llvm_ir=*/false);
+}
+
+static void BM_SmallDotF32TiledLlvmIr(benchmark::State& state) {
+  BM_SmallDotF32(state, /*tiled_llvm_ir=*/true);
+}
+
+#define BENCHMARK_SMALL_DOT(name) \
+  BENCHMARK(name)                 \
+      ->MeasureProcessCPUTime()   \
+      ->Args({8, 8, 8})           \
+      ->Args({16, 16, 16})        \
+      ->Args({32, 32, 32})        \
+      ->Args({14, 64, 32})        \
+      ->Args({32, 128, 128})      \
+      ->Args({128, 128, 32})      \
+      ->Args({28, 64, 96})        \
+      ->Args({100, 100, 30})
+
+BENCHMARK_SMALL_DOT(BM_SmallDotF32Eigen);
+BENCHMARK_SMALL_DOT(BM_SmallDotF32TiledLlvmIr);
+
 }  // namespace xla::cpu
@@ -0,0 +1,114 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+// Returns `num_indices` random row indices in the [0, num_rows) range as a
+// s32[num_indices, 1] literal.
+static Literal CreateRowIndices(int64_t num_indices, int64_t num_rows,
+                                std::minstd_rand0* engine) {
+  std::uniform_int_distribution<int32_t> distribution(0, num_rows - 1);
+  std::vector<int32_t> indices(num_indices);
+  for (int32_t& index : indices) index = distribution(*engine);
+  return *LiteralUtil::CreateR1<int32_t>(indices).Reshape({num_indices, 1});
+}
+
+// Gathers random rows of a row-major matrix (embedding lookup).
+static void BM_GatherRowsF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule gather_rows_f32_$d0_$d1
+
+    ENTRY e {
+      operand = f32[$d0,256] parameter(0)
+      indices = s32[$d1,1] parameter(1)
+      ROOT gather = f32[$d1,256] gather(operand, indices),
+        offset_dims={1}, collapsed_slice_dims={0}, start_index_map={0},
+        index_vector_dim=1, slice_sizes={1,256}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, 256});
+  auto operand =
+      *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+  auto indices = CreateRowIndices(d1, d0, &engine);
+
+  std::vector<const Literal*> args = {&operand, &indices};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+// Gathers random scalar elements of a vector.
+static void BM_GatherScalarsF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule gather_scalars_f32_$d0_$d1
+
+    ENTRY e {
+      operand = f32[$d0] parameter(0)
+      indices = s32[$d1,1] parameter(1)
+      ROOT gather = f32[$d1] gather(operand, indices),
+        offset_dims={}, collapsed_slice_dims={0}, start_index_map={0},
+        index_vector_dim=1, slice_sizes={1}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0});
+  auto operand =
+      *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+  auto indices = CreateRowIndices(d1, d0, &engine);
+
+  std::vector<const Literal*> args = {&operand, &indices};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+BENCHMARK(BM_GatherRowsF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1024, 128})
+    ->Args({1024, 4096})
+    ->Args({65536, 4096})
+    ->Args({65536, 16384});
+
+BENCHMARK(BM_GatherScalarsF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1024, 1024})
+    ->Args({1048576, 1024})
+    ->Args({1048576, 65536});
+
+}  // namespace xla::cpu
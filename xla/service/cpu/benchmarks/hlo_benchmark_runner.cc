@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_replace.h"
 #include "absl/types/span.h"
 #include "xla/client/xla_computation.h"
@@ -28,9 +29,13 @@ limitations under the License.
 #include "xla/pjrt/cpu/cpu_client.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_executable.h"
+#include "xla/service/cpu/benchmarks/perf_counters.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/service/hlo_parser.h"
+#include "xla/tsl/util/env_var.h"
+#include "xla/xla.pb.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test_benchmark.h"
 
@@ -39,9 +44,32 @@ namespace xla::cpu {
 absl::Status RunHloBenchmark(benchmark::State& state,
                              std::string_view hlo_module,
                              absl::Span<const Literal* const> args,
-                             StrToStrMapping replacements) {
+                             StrToStrMapping replacements,
+                             const HloBenchmarkOptions& options) {
+  // Perf counters must be opened before the CPU client, so that they are
+  // inherited by the threads of the intra-op thread pool.
+  bool collect_perf_counters = options.collect_perf_counters;
+  if (!collect_perf_counters) {
+    TF_RETURN_IF_ERROR(tsl::ReadBoolFromEnvVar(
+        "XLA_CPU_BENCHMARK_PERF_COUNTERS", false, &collect_perf_counters));
+  }
+
+  std::unique_ptr<PerfCounters> perf_counters;
+  if (collect_perf_counters) {
+    absl::StatusOr<std::unique_ptr<PerfCounters>> counters =
+        PerfCounters::Create();
+    if (counters.ok()) {
+      perf_counters = *std::move(counters);
+    } else {
+      LOG(WARNING) << "Skip perf counters collection: " << counters.status();
+    }
+  }
+
+  CpuClientOptions client_options;
+  client_options.intra_op_parallelism = options.intra_op_parallelism;
+
   TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtClient> client,
-                      GetTfrtCpuClient(CpuClientOptions()));
+                      GetTfrtCpuClient(client_options));
   PjRtDevice* device = client->devices().front();
 
   HloModuleConfig config;
@@ -54,6 +82,17 @@ absl::Status RunHloBenchmark(benchmark::State& state,
 
   // Compile HLO module to executable.
   CompileOptions compile_options;
+  DebugOptions* debug_options =
+      compile_options.executable_build_options.mutable_debug_options();
+  if (options.use_thunk_runtime) {
+    debug_options->set_xla_cpu_use_thunk_runtime(true);
+  }
+  if (options.use_work_stealing_thunk_executor) {
+    debug_options->set_xla_cpu_enable_work_stealing_thunk_executor(true);
+  }
+  if (options.disable_multi_thread_eigen) {
+    debug_options->set_xla_cpu_multi_thread_eigen(false);
+  }
   TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> executable,
                       client->Compile(computation, compile_options));
 
@@ -83,10 +122,15 @@ absl::Status RunHloBenchmark(benchmark::State& state,
       executable->ExecuteSharded(args_ptrs, device, execute_options));
 
   // Benchmark executable.
+  if (perf_counters) perf_counters->Start();
   for (auto _ : state) {
     TF_ASSIGN_OR_RETURN(results, executable->ExecuteSharded(args_ptrs, device,
                                                             execute_options));
   }
+  if (perf_counters) {
+    perf_counters->Stop();
+    TF_RETURN_IF_ERROR(perf_counters->Report(state));
+  }
 
   return absl::OkStatus();
 }
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
 #define XLA_SERVICE_CPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
 
+#include <optional>
 #include <string_view>
 
 #include "absl/status/status.h"
@@ -29,10 +30,37 @@ namespace xla::cpu {
 using StrToStrMapping =
     std::initializer_list<std::pair<absl::string_view, absl::string_view>>;
 
+// Options for compiling and running HLO benchmarks.
+struct HloBenchmarkOptions {
+  // Number of threads in the intra-op thread pool. If not set, the default
+  // thread pool size of the CPU client is used.
+  std::optional<int> intra_op_parallelism;
+
+  // If true, compiles HLO module for the thunk runtime, otherwise the value
+  // from the debug options flags is used.
+  bool use_thunk_runtime = false;
+
+  // If true, executes thunks with a work-stealing task runner.
+  bool use_work_stealing_thunk_executor = false;
+
+  // If true, disables multi-threaded Eigen, so that small matrix
+  // multiplications are compiled to tiled LLVM IR kernels instead of calls to
+  // Eigen runtime.
+  bool disable_multi_thread_eigen = false;
+
+  // If true, collects hardware performance counters (cycles, instructions,
+  // cache and branch misses) for the benchmark loop and reports them as
+  // benchmark user counters (see perf_counters.h). Can also be enabled for all
+  // benchmarks with the XLA_CPU_BENCHMARK_PERF_COUNTERS=1 environment
+  // variable.
+  bool collect_perf_counters = false;
+};
+
 absl::Status RunHloBenchmark(benchmark::State& state,
                              std::string_view hlo_module,
                              absl::Span<const Literal* const> args,
-                             StrToStrMapping replacements = {});
+                             StrToStrMapping replacements = {},
+                             const HloBenchmarkOptions& options = {});
 
 }  // namespace xla::cpu
 
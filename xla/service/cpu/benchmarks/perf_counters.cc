@@ -0,0 +1,144 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/benchmarks/perf_counters.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif  // defined(__linux__)
+
+namespace xla::cpu {
+
+#if defined(__linux__)
+
+namespace {
+
+struct CounterConfig {
+  const char* name;
+  uint64_t config;
+};
+
+constexpr CounterConfig kCounterConfigs[] = {
+    {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+    {"llc_misses", PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int OpenCounter(uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                 /*group_fd=*/-1, /*flags=*/0);
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<PerfCounters>> PerfCounters::Create() {
+  std::vector<Counter> counters;
+  for (const CounterConfig& config : kCounterConfigs) {
+    int fd = OpenCounter(config.config);
+    if (fd < 0) {
+      LOG(WARNING) << "Failed to open perf counter " << config.name << ": "
+                   << std::strerror(errno);
+      continue;
+    }
+    counters.push_back({config.name, fd});
+  }
+
+  if (counters.empty()) {
+    return absl::UnavailableError(
+        "Hardware performance counters are not available");
+  }
+  return absl::WrapUnique(new PerfCounters(std::move(counters)));
+}
+
+PerfCounters::~PerfCounters() {
+  for (const Counter& counter : counters_) close(counter.fd);
+}
+
+void PerfCounters::Start() {
+  for (const Counter& counter : counters_) {
+    ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void PerfCounters::Stop() {
+  for (const Counter& counter : counters_) {
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+}
+
+absl::Status PerfCounters::Report(benchmark::State& state) const {
+  for (const Counter& counter : counters_) {
+    uint64_t value = 0;
+    if (read(counter.fd, &value, sizeof(value)) != sizeof(value)) {
+      return absl::InternalError(
+          absl::StrCat("Failed to read perf counter ", counter.name));
+    }
+    state.counters[counter.name] = benchmark::Counter(
+        static_cast<double>(value), benchmark::Counter::kAvgIterations);
+  }
+  return absl::OkStatus();
+}
+
+#else  // defined(__linux__)
+
+absl::StatusOr<std::unique_ptr<PerfCounters>> PerfCounters::Create() {
+  return absl::UnimplementedError(
+      "Hardware performance counters are supported only on Linux");
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Start() {}
+void PerfCounters::Stop() {}
+
+absl::Status PerfCounters::Report(benchmark::State& state) const {
+  return absl::OkStatus();
+}
+
+#endif  // defined(__linux__)
+
+PerfCounters::PerfCounters(std::vector<Counter> counters)
+    : counters_(std::move(counters)) {}
+
+}  // namespace xla::cpu
@@ -0,0 +1,77 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_BENCHMARKS_PERF_COUNTERS_H_
+#define XLA_SERVICE_CPU_BENCHMARKS_PERF_COUNTERS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+// Hardware performance counters collected with Linux perf_event_open(2) for
+// the calling thread and all threads it creates after the counters are opened
+// (i.e. the intra-op thread pool of a CPU client created afterwards).
+//
+// Counters are reported as per-iteration averages in benchmark user counters,
+// so they are exported together with the timings in the benchmark JSON output
+// (--benchmark_format=json or --benchmark_out=<file>):
+//
+//   cycles          CPU cycles
+//   instructions    retired instructions
+//   llc_misses      last level cache misses
+//   branch_misses   mispredicted branches
+//
+// Counters that are not supported by the hardware (or not permitted by
+// /proc/sys/kernel/perf_event_paranoid) are skipped.
+class PerfCounters {
+ public:
+  // Opens all supported counters in the disabled state. Returns an error if
+  // none of the counters can be opened (or on non-Linux platforms).
+  static absl::StatusOr<std::unique_ptr<PerfCounters>> Create();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // Starts and stops counting. Counters accumulate across multiple Start/Stop
+  // intervals.
+  void Start();
+  void Stop();
+
+  // Reads counter values and adds them to the benchmark user counters as
+  // averages per benchmark iteration.
+  absl::Status Report(benchmark::State& state) const;
+
+ private:
+  struct Counter {
+    std::string name;
+    int fd;
+  };
+
+  explicit PerfCounters(std::vector<Counter> counters);
+
+  std::vector<Counter> counters_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_BENCHMARKS_PERF_COUNTERS_H_
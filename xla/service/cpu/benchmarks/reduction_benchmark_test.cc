@@ -66,4 +66,84 @@ BENCHMARK(BM_ReduceAddF32)
     ->Arg(8192)
     ->Arg(16384);
 
+// Reduces the major dimension of a row-major matrix, every output element
+// reads a column of the input.
+static void BM_ColumnReduceAddF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule column_reduce_add_f32_$d0_$d1
+
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY e {
+      p0 = f32[$d0,$d1] parameter(0)
+      c0 = f32[] constant(0)
+      ROOT reduce = f32[$d1] reduce(p0, c0), dimensions={0}, to_apply=add
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+// Reduces the middle dimension of a rank 3 tensor, the outer dimension of the
+// result can be partitioned into parallel tasks.
+static void BM_BatchedColumnReduceAddF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule batched_column_reduce_add_f32_$d0_$d1
+
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY e {
+      p0 = f32[16,$d0,$d1] parameter(0)
+      c0 = f32[] constant(0)
+      ROOT reduce = f32[16,$d1] reduce(p0, c0), dimensions={1}, to_apply=add
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {16, d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+BENCHMARK(BM_ColumnReduceAddF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1024, 1024})
+    ->Args({4096, 4096})
+    ->Args({16384, 1024})
+    ->Args({1024, 16384})
+    ->Args({65536, 256});
+
+BENCHMARK(BM_BatchedColumnReduceAddF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1024, 1024})
+    ->Args({4096, 1024})
+    ->Args({1024, 4096});
+
 }  // namespace xla::cpu
@@ -0,0 +1,93 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+static void BM_RngUniformF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+
+  std::string_view hlo = R"(
+    HloModule rng_uniform_f32_$d0
+
+    ENTRY e {
+      c0 = f32[] constant(0)
+      c1 = f32[] constant(1)
+      ROOT rng = f32[$d0] rng(c0, c1), distribution=rng_uniform
+    }
+  )";
+
+  CHECK_OK(RunHloBenchmark(state, hlo, {}, {{"$d0", absl::StrCat(d0)}}));
+}
+
+static void BM_RngBitGeneratorU32(benchmark::State& state,
+                                  std::string_view algorithm) {
+  int64_t d0 = state.range(0);
+
+  std::string_view hlo = R"(
+    HloModule rng_bit_generator_$algorithm_$d0
+
+    ENTRY e {
+      state = u64[2] parameter(0)
+      ROOT rng = (u64[2], u32[$d0]) rng-bit-generator(state),
+        algorithm=$algorithm
+    }
+  )";
+
+  auto p0 = LiteralUtil::CreateR1<uint64_t>({42, 43});
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$algorithm", algorithm}}));
+}
+
+static void BM_RngBitGeneratorThreeFryU32(benchmark::State& state) {
+  BM_RngBitGeneratorU32(state, "rng_three_fry");
+}
+
+static void BM_RngBitGeneratorPhiloxU32(benchmark::State& state) {
+  BM_RngBitGeneratorU32(state, "rng_philox");
+}
+
+BENCHMARK(BM_RngUniformF32)
+    ->MeasureProcessCPUTime()
+    ->Arg(1024)
+    ->Arg(65536)
+    ->Arg(1048576);
+
+BENCHMARK(BM_RngBitGeneratorThreeFryU32)
+    ->MeasureProcessCPUTime()
+    ->Arg(1024)
+    ->Arg(65536)
+    ->Arg(1048576);
+
+BENCHMARK(BM_RngBitGeneratorPhiloxU32)
+    ->MeasureProcessCPUTime()
+    ->Arg(1024)
+    ->Arg(65536)
+    ->Arg(1048576);
+
+}  // namespace xla::cpu
@@ -0,0 +1,111 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+static void BM_SortF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule sort_f32_$d0_$d1
+
+    compare {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT lt = pred[] compare(p0, p1), direction=LT
+    }
+
+    ENTRY e {
+      p0 = f32[$d0,$d1] parameter(0)
+      ROOT sort = f32[$d0,$d1] sort(p0), dimensions={1}, to_apply=compare
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+// Sorts keys together with values, i.e. computes a permutation of the values
+// that sorts the keys.
+static void BM_SortKeyValueF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule sort_key_value_f32_$d0_$d1
+
+    compare {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      p2 = s32[] parameter(2)
+      p3 = s32[] parameter(3)
+      ROOT lt = pred[] compare(p0, p1), direction=LT
+    }
+
+    ENTRY e {
+      p0 = f32[$d0,$d1] parameter(0)
+      iota = s32[$d0,$d1] iota(), iota_dimension=1
+      ROOT sort = (f32[$d0,$d1], s32[$d0,$d1]) sort(p0, iota), dimensions={1},
+        to_apply=compare
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+BENCHMARK(BM_SortF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1, 1024})
+    ->Args({1, 65536})
+    ->Args({1, 1048576})
+    ->Args({128, 1024})
+    ->Args({1024, 128});
+
+BENCHMARK(BM_SortKeyValueF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1, 1024})
+    ->Args({1, 65536})
+    ->Args({128, 1024});
+
+}  // namespace xla::cpu
@@ -0,0 +1,94 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+static void BM_Transpose2DF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule transpose_2d_f32_$d0_$d1
+
+    ENTRY e {
+      p0 = f32[$d0,$d1] parameter(0)
+      ROOT transpose = f32[$d1,$d0] transpose(p0), dimensions={1,0}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+// Swaps the two minor dimensions of a batch of matrices.
+static void BM_BatchedTransposeF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule batched_transpose_f32_$d0_$d1
+
+    ENTRY e {
+      p0 = f32[32,$d0,$d1] parameter(0)
+      ROOT transpose = f32[32,$d1,$d0] transpose(p0), dimensions={0,2,1}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {32, d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+BENCHMARK(BM_Transpose2DF32)
+    ->MeasureProcessCPUTime()
+    ->Args({128, 128})
+    ->Args({1024, 1024})
+    ->Args({4096, 4096})
+    ->Args({16384, 256})
+    ->Args({256, 16384});
+
+BENCHMARK(BM_BatchedTransposeF32)
+    ->MeasureProcessCPUTime()
+    ->Args({128, 128})
+    ->Args({512, 512})
+    ->Args({1024, 64});
+
+}  // namespace xla::cpu
@@ -0,0 +1,87 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::cpu {
+
+// While loop with a cheap body, measures the per-iteration overhead of
+// evaluating the loop condition and dispatching the body.
+static void BM_WhileLoopF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t num_iters = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule while_loop_f32_$d0_$num_iters
+
+    body {
+      p0 = (s32[], f32[$d0]) parameter(0)
+      i = s32[] get-tuple-element(p0), index=0
+      x = f32[$d0] get-tuple-element(p0), index=1
+      one = s32[] constant(1)
+      next_i = s32[] add(i, one)
+      c = f32[] constant(0.5)
+      bcast = f32[$d0] broadcast(c), dimensions={}
+      next_x = f32[$d0] multiply(x, bcast)
+      ROOT result = (s32[], f32[$d0]) tuple(next_i, next_x)
+    }
+
+    cond {
+      p0 = (s32[], f32[$d0]) parameter(0)
+      i = s32[] get-tuple-element(p0), index=0
+      n = s32[] constant($num_iters)
+      ROOT lt = pred[] compare(i, n), direction=LT
+    }
+
+    ENTRY e {
+      p0 = f32[$d0] parameter(0)
+      zero = s32[] constant(0)
+      init = (s32[], f32[$d0]) tuple(zero, p0)
+      while = (s32[], f32[$d0]) while(init), condition=cond, body=body
+      ROOT result = f32[$d0] get-tuple-element(while), index=1
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(state, hlo, args,
+                           {{"$d0", absl::StrCat(d0)},
+                            {"$num_iters", absl::StrCat(num_iters)}}));
+}
+
+BENCHMARK(BM_WhileLoopF32)
+    ->MeasureProcessCPUTime()
+    ->Args({1, 100})
+    ->Args({1, 1000})
+    ->Args({1024, 100})
+    ->Args({1024, 1000})
+    ->Args({65536, 100});
+
+}  // namespace xla::cpu
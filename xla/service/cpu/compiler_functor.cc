@@ -92,6 +92,36 @@ static std::vector<llvm::VecDesc> VectorFunctionsForTargetLibraryInfoImpl() {
        false, "_ZGV_LLVM_N16v"},
       {"llvm.log.f32", runtime::kLogV16F32SymbolName,
        llvm::ElementCount::getFixed(16), false, "_ZGV_LLVM_N16v"},
+
+      {"sinf", runtime::kSinV4F32SymbolName, llvm::ElementCount::getFixed(4),
+       false, "_ZGV_LLVM_N4v"},
+      {"llvm.sin.f32", runtime::kSinV4F32SymbolName,
+       llvm::ElementCount::getFixed(4), false, "_ZGV_LLVM_N4v"},
+
+      {"sinf", runtime::kSinV8F32SymbolName, llvm::ElementCount::getFixed(8),
+       false, "_ZGV_LLVM_N8v"},
+      {"llvm.sin.f32", runtime::kSinV8F32SymbolName,
+       llvm::ElementCount::getFixed(8), false, "_ZGV_LLVM_N8v"},
+
+      {"sinf", runtime::kSinV16F32SymbolName, llvm::ElementCount::getFixed(16),
+       false, "_ZGV_LLVM_N16v"},
+      {"llvm.sin.f32", runtime::kSinV16F32SymbolName,
+       llvm::ElementCount::getFixed(16), false, "_ZGV_LLVM_N16v"},
+
+      {"cosf", runtime::kCosV4F32SymbolName, llvm::ElementCount::getFixed(4),
+       false, "_ZGV_LLVM_N4v"},
+      {"llvm.cos.f32", runtime::kCosV4F32SymbolName,
+       llvm::ElementCount::getFixed(4), false, "_ZGV_LLVM_N4v"},
+
+      {"cosf", runtime::kCosV8F32SymbolName, llvm::ElementCount::getFixed(8),
+       false, "_ZGV_LLVM_N8v"},
+      {"llvm.cos.f32", runtime::kCosV8F32SymbolName,
+       llvm::ElementCount::getFixed(8), false, "_ZGV_LLVM_N8v"},
+
+      {"cosf", runtime::kCosV16F32SymbolName, llvm::ElementCount::getFixed(16),
+       false, "_ZGV_LLVM_N16v"},
+      {"llvm.cos.f32", runtime::kCosV16F32SymbolName,
+       llvm::ElementCount::getFixed(16), false, "_ZGV_LLVM_N16v"},
   };
   return result;
 }
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/cpu/cpu_compiler.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -39,27 +40,41 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalValue.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
 #include "llvm/TargetParser/Triple.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"  // from @llvm-project
 #include "mlir/Dialect/Vector/IR/VectorOps.h"  // from @llvm-project
 #include "mlir/Pass/PassManager.h"  // from @llvm-project
@@ -85,6 +100,7 @@ limitations under the License.
 #include "xla/service/algebraic_simplifier.h"
 #include "xla/service/all_reduce_promotion.h"
 #include "xla/service/all_to_all_decomposer.h"
+#include "xla/service/async_collective_creator.h"
 #include "xla/service/batch_dot_simplification.h"
 #include "xla/service/batchnorm_expander.h"
 #include "xla/service/bitcast_dtypes_expander.h"
@@ -105,12 +121,15 @@ limitations under the License.
 #include "xla/service/cpu/compiler_functor.h"
 #include "xla/service/cpu/conv_canonicalization.h"
 #include "xla/service/cpu/cpu_executable.h"
+#include "xla/service/cpu/cpu_float_support.h"
 #include "xla/service/cpu/cpu_instruction_fusion.h"
 #include "xla/service/cpu/cpu_layout_assignment.h"
 #include "xla/service/cpu/cpu_options.h"
+#include "xla/service/cpu/cpu_runtime.h"
 #include "xla/service/cpu/dot_op_emitter.h"
 #include "xla/service/cpu/ir_emitter.h"
 #include "xla/service/cpu/ir_emitter2.h"
+#include "xla/service/cpu/object_cache.h"
 #include "xla/service/cpu/parallel_task_assignment.h"
 #include "xla/service/cpu/runtime/thunk.h"
 #include "xla/service/cpu/simple_orc_jit.h"
@@ -143,6 +162,7 @@ limitations under the License.
 #include "xla/service/hlo_profile_printer_data.pb.h"
 #include "xla/service/hlo_verifier.h"
 #include "xla/service/indexed_array_analysis.h"
+#include "xla/service/latency_hiding_scheduler.h"
 #include "xla/service/layout_assignment.h"
 #include "xla/service/llvm_compiler.h"
 #include "xla/service/llvm_ir/llvm_command_line_options.h"
@@ -178,6 +198,7 @@ limitations under the License.
 #include "xla/service/while_loop_constant_sinking.h"
 #include "xla/service/while_loop_invariant_code_motion.h"
 #include "xla/service/while_loop_simplifier.h"
+#include "xla/service/while_loop_trip_count_annotator.h"
 #include "xla/service/zero_sized_hlo_elimination.h"
 #include "xla/shape.h"
 #include "xla/shape_util.h"
@@ -191,17 +212,19 @@ limitations under the License.
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/casts.h"
 #include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"  // IWYU pragma: keep
+#include "tsl/platform/path.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 #ifdef TF_LLVM_X86_AVAILABLE
 #include "llvm/TargetParser/X86TargetParser.h"
 #endif
 
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
-#include "xla/service/cpu/cpu_float_support.h"
 #include "xla/service/cpu/onednn_matmul_rewriter.h"
 #include "xla/service/cpu/onednn_ops_rewriter.h"
 #include "xla/service/simplify_fp_conversions.h"
@@ -474,7 +497,16 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
   HloPassPipeline pipeline("HLO passes through layout assignment");
   AddHloVerifier(&pipeline);
 
-  pipeline.AddPass<OperandUpcaster>();
+  // Dots that can accumulate low precision operands natively (see
+  // DotSupportsLowPrecisionOperands) keep their BF16 and S8 operands.
+  auto supports_low_precision_dot = [&](const HloInstruction& dot) {
+    return DotSupportsLowPrecisionOperands(module->config(), dot,
+                                           *target_machine_features);
+  };
+
+  pipeline.AddPass<OperandUpcaster>([&](const HloInstruction* instr) {
+    return !supports_low_precision_dot(*instr);
+  });
   pipeline.AddPass<ResultCaster>();
 
   // Expand random number generation.
@@ -531,15 +563,16 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
   // Convert BF16 and F8 operations to F32 and F16 respectively so that the CPU
   // backend can support BF16/F8 operations without directly implementing a
   // BF16/F8 lowering for most ops.
-  FloatSupport bf16_support(BF16);
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
-  CpuFloatSupport onednn_bf16_support(BF16);
+  FloatSupport bf16_support(BF16);
+  CpuFloatSupport onednn_bf16_support(BF16, supports_low_precision_dot);
   if (!is_aot_compile) {
     pipeline.AddPass<FloatNormalization>(&onednn_bf16_support);
   } else {
     pipeline.AddPass<FloatNormalization>(&bf16_support);
   }
 #else
+  CpuFloatSupport bf16_support(BF16, supports_low_precision_dot);
   pipeline.AddPass<FloatNormalization>(&bf16_support);
 #endif
   FloatSupport f8e5m2_support(F8E5M2, F16);
@@ -660,7 +693,8 @@ absl::Status CpuCompiler::RunHloPassesThroughLayoutAssn(
   // support libcalls. Disable this for now.
   if (!is_mlir_compile) {
     pipeline.AddPass<TopkRewriter>([](const HloSortInstruction* sort, int64_t) {
-      return sort->operand(0)->shape().element_type() == F32;
+      PrimitiveType type = sort->operand(0)->shape().element_type();
+      return type == F32 || type == BF16 || type == F16 || type == S32;
     });
   }
   pipeline.AddPass<IndexedArrayAnalysisPrinterPass>();
@@ -754,7 +788,7 @@ absl::Status CpuCompiler::RunHloPassesAfterLayoutAssn(
 #endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 
   // Add a fusion pass now that layout assignment is done.
-  pipeline.AddPass<CpuInstructionFusion>();
+  pipeline.AddPass<CpuInstructionFusion>(target_machine_features);
 
   // The LayoutAssignment pass may leave behind kCopy instructions which are
   // duplicate or NOPs, so remove them with algebraic simplification and CSE.
@@ -789,6 +823,23 @@ absl::Status CpuCompiler::RunHloPassesAfterLayoutAssn(
     pipeline.AddPass<ParallelTaskAssigner>(
         max_parallelism, ShapeSizeBytesFunction(), target_machine_features);
   }
+
+  // Split all-reduces into start/done pairs so that the latency hiding
+  // scheduler can overlap them with independent compute. Only the legacy
+  // runtime emits asynchronous all-reduces.
+  if (!is_aot_compile &&
+      module->config().debug_options().xla_cpu_enable_async_all_reduce() &&
+      !module->config().debug_options().xla_cpu_use_thunk_runtime()) {
+    AsyncCollectiveCreator::CollectiveCreatorConfig config;
+    config.convert_all_reduce = HloPredicateTrue;
+    pipeline.AddPass<AsyncCollectiveCreator>(std::move(config));
+  }
+
+  // Annotate while loops with statically known trip counts, so that thunk
+  // runtime can execute them without evaluating the loop condition.
+  if (module->config().debug_options().xla_cpu_use_thunk_runtime()) {
+    pipeline.AddPass<WhileLoopTripCountAnnotator>();
+  }
   // Copy insertion should be performed immediately before IR emission to
   // avoid inserting unnecessary copies (later pass adds an instruction which
   // materializes the value) or missing a necessary copy (later pass removes
@@ -845,6 +896,21 @@ llvm::CodeGenOptLevel CodeGenOptLevel(const HloModuleConfig& module_config) {
   }
 }
 
+// Name of the LLVM module with all XLA:CPU functions and kernels.
+constexpr absl::string_view kComputeModuleName = "__compute_module";
+
+// Returns a file name suffix for dumping LLVM module IR. Parts of the split
+// compute module are compiled separately (see `AddModuleToJit`), and we dump
+// each part into a separate file.
+std::string GetIrDumpSuffix(const llvm::Module& llvm_module) {
+  absl::string_view name = llvm_module.getModuleIdentifier();
+  if (absl::ConsumePrefix(&name, kComputeModuleName) &&
+      absl::ConsumePrefix(&name, ".")) {
+    return std::string(name);
+  }
+  return "";
+}
+
 std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
     const HloModule& hlo_module,
     const LLVMCompiler::ModuleHook& user_pre_optimization_hook,
@@ -863,7 +929,8 @@ std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
     if (user_hook) {
       user_hook(llvm_module);
     }
-    llvm_ir::DumpIrIfEnabled(*hlo_module_ptr, llvm_module, optimized);
+    llvm_ir::DumpIrIfEnabled(*hlo_module_ptr, llvm_module, optimized,
+                             GetIrDumpSuffix(llvm_module));
   };
   return {[hook](const llvm::Module& llvm_module) {
             return hook(/*optimized=*/false, llvm_module);
@@ -948,17 +1015,159 @@ namespace {
 static absl::AnyInvocable<void(const llvm::object::ObjectFile& obj_file)>
 CreateOrcJITPostCompilationHook(const HloModule* module,
                                 std::vector<std::string>* obj_files) {
-  return [=](const llvm::object::ObjectFile& obj_file) {
+  return [=, num_obj_files = 0](
+             const llvm::object::ObjectFile& obj_file) mutable {
     if (obj_files) obj_files->push_back(obj_file.getData().str());
 
+    // With parallel codegen a single module is compiled to multiple object
+    // files, and we give each of them a unique file suffix. Object files are
+    // reported in the order of module parts (see `SimpleOrcJIT::AddModules`),
+    // so the suffix matches the IR dump of the part.
+    std::string file_suffix =
+        num_obj_files == 0 ? "o" : absl::StrCat("part_", num_obj_files, ".o");
+    ++num_obj_files;
+
     if (DumpingEnabledForHloModule(*module)) {
-      DumpToFileInDir(*module, /*file_prefix=*/"", /*file_suffix=*/"o",
+      DumpToFileInDir(*module, /*file_prefix=*/"", file_suffix,
                       absl::string_view(obj_file.getData().data(),
                                         obj_file.getData().size()));
     }
   };
 }
 
+// Copies LLVM module to a new LLVM context by round-tripping it through the
+// bitcode.
+absl::StatusOr<std::unique_ptr<llvm::Module>> CopyToContext(
+    const llvm::Module& module, llvm::LLVMContext& context) {
+  llvm::SmallString<0> bitcode;
+  llvm::raw_svector_ostream bitcode_ostream(bitcode);
+  llvm::WriteBitcodeToFile(module, bitcode_ostream);
+
+  llvm::Expected<std::unique_ptr<llvm::Module>> new_module =
+      llvm::parseBitcodeFile(
+          llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()),
+                                "split_module"),
+          context);
+  if (!new_module) {
+    return Internal("Failed to parse bitcode of module %s: %s",
+                    module.getModuleIdentifier(),
+                    llvm::toString(new_module.takeError()));
+  }
+
+  return std::move(new_module.get());
+}
+
+// Returns a thread pool for compiling parts of split LLVM modules. The thread
+// pool is shared by all XLA:CPU compilations in the process.
+tsl::thread::ThreadPool* GetCodegenThreadPool() {
+  static auto* thread_pool = new tsl::thread::ThreadPool(
+      tsl::Env::Default(), "xla-cpu-codegen", tsl::port::MaxParallelism());
+  return thread_pool;
+}
+
+// Adds LLVM module to the JIT. If parallel codegen is enabled, splits module
+// into multiple parts, and compiles them concurrently on a thread pool. Symbol
+// references between parts (and to the XLA:CPU runtime) are resolved when the
+// JIT links compiled object files.
+//
+// If object cache is enabled, tries to load compiled object files from the
+// cache, and on a cache miss compiles the module eagerly and stores all object
+// files (collected by the post codegen hook into `obj_files`) to the cache.
+absl::Status AddModuleToJit(SimpleOrcJIT& jit,
+                            std::unique_ptr<llvm::Module> llvm_module,
+                            std::unique_ptr<llvm::LLVMContext> llvm_context,
+                            const DebugOptions& debug_options,
+                            std::vector<std::string>* obj_files) {
+  std::string cache_path;
+  if (const std::string& cache_dir = debug_options.xla_cpu_object_cache_dir();
+      !cache_dir.empty() && obj_files != nullptr) {
+    cache_path = tsl::io::JoinPath(
+        cache_dir, absl::StrCat(GetObjectCacheKey(*llvm_module,
+                                                  *jit.target_machine(),
+                                                  debug_options),
+                                ".pb"));
+    if (std::optional<std::vector<std::string>> cached =
+            LoadObjectCacheEntry(cache_path)) {
+      for (std::string& obj_file : *cached) {
+        auto buffer = llvm::MemoryBuffer::getMemBufferCopy(
+            llvm::StringRef(obj_file.data(), obj_file.size()), cache_path);
+        if (auto err = jit.AddObjFile(std::move(buffer))) {
+          return Internal("Failed to add cached object file %s: %s",
+                          cache_path, llvm::toString(std::move(err)));
+        }
+        obj_files->push_back(std::move(obj_file));
+      }
+      return absl::OkStatus();
+    }
+  }
+
+  bool use_cache = !cache_path.empty();
+
+  int64_t num_parts = std::min<int64_t>(
+      debug_options.xla_cpu_parallel_codegen_split_count(),
+      tsl::port::MaxParallelism());
+
+  // Without object cache we can add a single module to the JIT and compile it
+  // lazily when we look up compiled symbols.
+  if (num_parts <= 1 && !use_cache) {
+    cantFail(jit.AddModule(llvm::orc::ThreadSafeModule(
+        std::move(llvm_module), std::move(llvm_context))));
+    return absl::OkStatus();
+  }
+
+  std::vector<llvm::orc::ThreadSafeModule> modules;
+
+  if (num_parts <= 1) {
+    modules.emplace_back(std::move(llvm_module), std::move(llvm_context));
+
+  } else {
+    // Each module part gets its own LLVM context, so that we can compile them
+    // concurrently. Locals stay together with their users. The first part
+    // keeps the module name, and its IR and object file are dumped to the same
+    // files as for an unsplit module.
+    absl::Status copied = absl::OkStatus();
+    llvm::SplitModule(
+        *llvm_module, num_parts,
+        [&](std::unique_ptr<llvm::Module> llvm_module_part) {
+          if (!copied.ok()) return;
+          auto context = std::make_unique<llvm::LLVMContext>();
+          absl::StatusOr<std::unique_ptr<llvm::Module>> module =
+              CopyToContext(*llvm_module_part, *context);
+          if (!module.ok()) {
+            copied = module.status();
+            return;
+          }
+          (*module)->setModuleIdentifier(
+              modules.empty()
+                  ? std::string(kComputeModuleName)
+                  : absl::StrCat(kComputeModuleName, ".part_", modules.size()));
+          modules.emplace_back(std::move(*module), std::move(context));
+        },
+        /*PreserveLocals=*/true);
+
+    // Original module is no longer needed, and the module must be destroyed
+    // before its context.
+    llvm_module.reset();
+    llvm_context.reset();
+    TF_RETURN_IF_ERROR(copied);
+
+    VLOG(2) << "Split LLVM module into " << modules.size() << " parts";
+  }
+
+  // Compile a single module in the caller thread.
+  tsl::thread::ThreadPool* thread_pool =
+      modules.size() > 1 ? GetCodegenThreadPool() : nullptr;
+
+  if (auto err = jit.AddModules(std::move(modules), thread_pool)) {
+    return Internal("Failed to compile LLVM module: %s",
+                    llvm::toString(std::move(err)));
+  }
+
+  if (use_cache) StoreObjectCacheEntry(cache_path, *obj_files);
+
+  return absl::OkStatus();
+}
+
 void InitializeLLVMCommandLineOptions(const HloModuleConfig& config) {
   llvm_ir::InitializeLLVMCommandLineOptions(
       config.debug_options().xla_backend_extra_options());
@@ -1121,7 +1330,7 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
   mlir::MLIRContext mlir_context;
   auto llvm_context = std::make_unique<llvm::LLVMContext>();
   auto llvm_module =
-      std::make_unique<llvm::Module>("__compute_module", *llvm_context);
+      std::make_unique<llvm::Module>(kComputeModuleName, *llvm_context);
 
   const DebugOptions& debug_options = module->config().debug_options();
 
@@ -1177,6 +1386,23 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
                      ComputationSchedulerToModuleScheduler(scheduler)));
   TF_RETURN_IF_ERROR(module->set_schedule(schedule));
 
+  // Move independent compute between asynchronous all-reduce start/done
+  // pairs, so that it runs while the all-reduce is in flight.
+  if (debug_options.xla_cpu_enable_async_all_reduce()) {
+    SchedulerConfig config;
+    auto latency_estimator = std::make_unique<ApproximateLatencyEstimator>();
+    auto async_tracker = std::make_unique<AsyncTracker>(config);
+    auto scheduler_core = std::make_unique<DefaultSchedulerCore>(
+        BufferSizeBytesFunction(), async_tracker.get(),
+        latency_estimator.get(), config);
+    HloPassPipeline pipeline("latency-hiding-scheduler");
+    pipeline.AddPass<LatencyHidingScheduler>(
+        std::move(latency_estimator), std::move(async_tracker),
+        std::move(scheduler_core), BufferSizeBytesFunction());
+    TF_RETURN_IF_ERROR(pipeline.Run(module.get()).status());
+    schedule = module->schedule();
+  }
+
   // Run buffer allocation on the HLO graph.
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<BufferAssignment> assignment,
@@ -1247,8 +1473,9 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
 
     // JIT compile the LLVM IR module to in-memory machine code.
     TF_RETURN_IF_ERROR(VerifyLlvmModule(*llvm_module));
-    cantFail((*jit)->AddModule(llvm::orc::ThreadSafeModule(
-        std::move(llvm_module), std::move(llvm_context))));
+    TF_RETURN_IF_ERROR(AddModuleToJit(**jit, std::move(llvm_module),
+                                      std::move(llvm_context), debug_options,
+                                      &obj_files));
 
     // TODO(ezhulenev): We should be able to make it lazy on-demand, but today
     // we capture obj_files by reference and it leads to asan errors. Figure out
@@ -1320,9 +1547,9 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
   TF_RETURN_IF_ERROR(VerifyLlvmModule(*llvm_module));
 
   // JIT compile the LLVM IR module to in-memory machine code.
-  llvm::orc::ThreadSafeModule thread_safe_module(std::move(llvm_module),
-                                                 std::move(llvm_context));
-  cantFail((*jit)->AddModule(std::move(thread_safe_module)));
+  TF_RETURN_IF_ERROR(AddModuleToJit(**jit, std::move(llvm_module),
+                                    std::move(llvm_context), debug_options,
+                                    &obj_files));
 
   TF_ASSIGN_OR_RETURN(
       auto cpu_executable,
@@ -1364,6 +1591,140 @@ absl::StatusOr<std::unique_ptr<Executable>> CpuCompiler::RunBackend(
   return std::unique_ptr<Executable>(std::move(cpu_executable));
 }
 
+// Prepares an LLVM module holding one ISA specialized version of a compiled
+// computation for linking with the other versions: all functions are compiled
+// for `cpu_name` and `features`, and all definitions except `entry_name` get
+// internal linkage so that the versions can't clash.
+static void PrepareTargetVariantModule(llvm::Module& module,
+                                       absl::string_view entry_name,
+                                       absl::string_view cpu_name,
+                                       absl::string_view features) {
+  for (llvm::Function& function : module.functions()) {
+    if (function.isDeclaration()) continue;
+    if (!cpu_name.empty()) {
+      function.addFnAttr("target-cpu", llvm_ir::AsStringRef(cpu_name));
+    }
+    if (!features.empty()) {
+      function.addFnAttr("target-features", llvm_ir::AsStringRef(features));
+    }
+    if (function.getName() != llvm_ir::AsStringRef(entry_name)) {
+      function.setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+  }
+  for (llvm::GlobalVariable& global : module.globals()) {
+    if (global.isDeclaration()) continue;
+    global.setLinkage(llvm::GlobalValue::InternalLinkage);
+  }
+}
+
+// Emits `entry_name` into `module` as a dispatcher that forwards to the first
+// of `variant_entries` (entry name and target features) supported by the host
+// CPU, or to `fallback_entry` if none of them is. The selection is done on the
+// first call and cached in a global variable.
+static absl::Status EmitTargetVariantDispatcher(
+    llvm::Module& module, absl::string_view entry_name,
+    absl::string_view fallback_entry,
+    absl::Span<const std::pair<std::string, std::string>> variant_entries) {
+  llvm::LLVMContext& context = module.getContext();
+
+  std::vector<llvm::Function*> targets;
+  for (const auto& [variant_entry, features] : variant_entries) {
+    targets.push_back(module.getFunction(variant_entry));
+  }
+  targets.push_back(module.getFunction(fallback_entry));
+  for (llvm::Function* target : targets) {
+    TF_RET_CHECK(target != nullptr);
+  }
+
+  llvm::FunctionType* function_type = targets.back()->getFunctionType();
+  llvm::Function* dispatcher = llvm::Function::Create(
+      function_type, llvm::GlobalValue::ExternalLinkage,
+      llvm_ir::AsStringRef(entry_name), module);
+  dispatcher->copyAttributesFrom(targets.back());
+  dispatcher->removeFnAttr("target-cpu");
+  dispatcher->removeFnAttr("target-features");
+
+  llvm::IRBuilder<> b(context);
+  llvm::Type* i32 = b.getInt32Ty();
+  auto* selected_variant = new llvm::GlobalVariable(
+      module, i32, /*isConstant=*/false, llvm::GlobalValue::InternalLinkage,
+      llvm::ConstantInt::get(i32, -1),
+      llvm_ir::AsStringRef(absl::StrCat(entry_name, ".selected_variant")));
+
+  llvm::BasicBlock* entry_bb =
+      llvm::BasicBlock::Create(context, "entry", dispatcher);
+  llvm::BasicBlock* select_bb =
+      llvm::BasicBlock::Create(context, "select", dispatcher);
+  llvm::BasicBlock* dispatch_bb =
+      llvm::BasicBlock::Create(context, "dispatch", dispatcher);
+
+  // Load the cached selection, it is -1 before the first call.
+  b.SetInsertPoint(entry_bb);
+  llvm::LoadInst* cached = b.CreateAlignedLoad(i32, selected_variant,
+                                               llvm::Align(4), "cached");
+  cached->setAtomic(llvm::AtomicOrdering::Monotonic);
+  b.CreateCondBr(b.CreateICmpSGE(cached, b.getInt32(0)), dispatch_bb,
+                 select_bb);
+
+  // Pick the first supported variant. Racing threads store the same value.
+  b.SetInsertPoint(select_bb);
+  llvm::FunctionCallee host_supports_features = module.getOrInsertFunction(
+      runtime::kHostSupportsTargetFeaturesSymbolName,
+      llvm::FunctionType::get(i32, {b.getPtrTy()}, /*isVarArg=*/false));
+  llvm::Value* selection = b.getInt32(variant_entries.size());
+  for (int64_t i = variant_entries.size() - 1; i >= 0; --i) {
+    llvm::Value* supported = b.CreateCall(
+        host_supports_features,
+        {b.CreateGlobalStringPtr(variant_entries[i].second)});
+    selection = b.CreateSelect(b.CreateICmpNE(supported, b.getInt32(0)),
+                               b.getInt32(i), selection);
+  }
+  llvm::StoreInst* store =
+      b.CreateAlignedStore(selection, selected_variant, llvm::Align(4));
+  store->setAtomic(llvm::AtomicOrdering::Monotonic);
+  b.CreateBr(dispatch_bb);
+
+  b.SetInsertPoint(dispatch_bb);
+  llvm::PHINode* index = b.CreatePHI(i32, 2, "index");
+  index->addIncoming(cached, entry_bb);
+  index->addIncoming(selection, select_bb);
+
+  std::vector<llvm::Value*> args;
+  for (llvm::Argument& arg : dispatcher->args()) {
+    args.push_back(&arg);
+  }
+
+  // Every target is called from its own block, the fallback is the default
+  // destination of the switch.
+  std::vector<llvm::BasicBlock*> call_bbs;
+  for (int64_t i = 0; i < targets.size(); ++i) {
+    llvm::BasicBlock* call_bb = llvm::BasicBlock::Create(
+        context, absl::StrCat("call.", i), dispatcher);
+    b.SetInsertPoint(call_bb);
+    llvm::CallInst* call = b.CreateCall(targets[i], args);
+    call->setTailCall();
+    if (function_type->getReturnType()->isVoidTy()) {
+      b.CreateRetVoid();
+    } else {
+      b.CreateRet(call);
+    }
+    call_bbs.push_back(call_bb);
+  }
+
+  b.SetInsertPoint(dispatch_bb);
+  llvm::SwitchInst* switch_inst =
+      b.CreateSwitch(index, call_bbs.back(), variant_entries.size());
+  for (int64_t i = 0; i < variant_entries.size(); ++i) {
+    switch_inst->addCase(b.getInt32(i), call_bbs[i]);
+  }
+
+  // The ISA specialized versions are only reachable through the dispatcher.
+  for (llvm::Function* target : targets) {
+    target->setLinkage(llvm::GlobalValue::InternalLinkage);
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<std::vector<std::unique_ptr<AotCompilationResult>>>
 CpuCompiler::CompileAheadOfTime(std::unique_ptr<HloModuleGroup> module_group,
                                 const AotCompilationOptions& aot_options) {
@@ -1500,57 +1861,115 @@ CpuCompiler::CompileAheadOfTime(std::unique_ptr<HloModuleGroup> module_group,
             &hlo_profile_index_map, &hlo_profile_printer_data));
       }
 
-      LLVMTargetMachineFeatures target_machine_features(target_machine.get());
       std::vector<BufferInfo> buffer_infos =
           CreateBufferInfosFromBufferAssignment(*module, *assignment);
       HloComputation* computation = module->entry_computation();
 
-      // Set required information before emitting IR
-      auto llvm_module =
-          std::make_unique<llvm::Module>("__compute_module", llvm_context);
-      llvm_module->setDataLayout(target_machine->createDataLayout());
-      llvm_module->setTargetTriple(triple.getTriple());
-      if (pic_level != llvm::PICLevel::NotPIC) {
-        llvm_module->setPICLevel(pic_level);
-      }
-      if (pie_level != llvm::PIELevel::Default) {
-        llvm_module->setPIELevel(pie_level);
-      }
-      IrEmitter ir_emitter(
-          &mlir_context, *module, *assignment, llvm_module.get(),
-          std::move(instruction_to_profile_idx),
-          std::move(computation_to_profile_idx),
-          ModuleComputationsTransitivelyContainCustomCall(*module),
-          &target_machine_features,
-          // TODO(b/66051036): Run full msan for AOT.
-          /*emit_code_for_msan=*/false);
-
-      TF_RETURN_IF_ERROR(ir_emitter.EmitConstantGlobals());
-
-      for (ComputationToEmit subcomputation :
-           SubcomputationEmissionOrder(computation)) {
-        if (subcomputation.computation->IsFusionComputation()) {
-          continue;
+      // Emits the computations of `module` for `variant_target_machine` into a
+      // new LLVM module, with the entry computation named `entry_name`.
+      auto emit_llvm_module = [&](llvm::TargetMachine* variant_target_machine,
+                                  const std::string& entry_name)
+          -> absl::StatusOr<std::unique_ptr<llvm::Module>> {
+        LLVMTargetMachineFeatures target_machine_features(
+            variant_target_machine);
+
+        // Set required information before emitting IR
+        auto llvm_module =
+            std::make_unique<llvm::Module>("__compute_module", llvm_context);
+        llvm_module->setDataLayout(target_machine->createDataLayout());
+        llvm_module->setTargetTriple(triple.getTriple());
+        if (pic_level != llvm::PICLevel::NotPIC) {
+          llvm_module->setPICLevel(pic_level);
         }
-        TF_RETURN_IF_ERROR(
-            ir_emitter
-                .EmitComputation(subcomputation.computation,
-                                 subcomputation.computation->name(),
-                                 /*is_top_level_computation=*/false,
-                                 schedule.sequence(subcomputation.computation)
-                                     .instructions(),
-                                 subcomputation.allow_reassociation)
-                .status());
-      }
-      const std::string& entry_point_name = options.entry_point_name();
-      TF_ASSIGN_OR_RETURN(llvm::Function * entry_function,
-                          ir_emitter.EmitComputation(
-                              computation, entry_point_name,
-                              /*is_top_level_computation=*/true,
-                              schedule.sequence(computation).instructions(),
-                              /*allow_reassociation=*/false));
+        if (pie_level != llvm::PIELevel::Default) {
+          llvm_module->setPIELevel(pie_level);
+        }
+        IrEmitter ir_emitter(
+            &mlir_context, *module, *assignment, llvm_module.get(),
+            instruction_to_profile_idx, computation_to_profile_idx,
+            ModuleComputationsTransitivelyContainCustomCall(*module),
+            &target_machine_features,
+            // TODO(b/66051036): Run full msan for AOT.
+            /*emit_code_for_msan=*/false);
+
+        TF_RETURN_IF_ERROR(ir_emitter.EmitConstantGlobals());
+
+        for (ComputationToEmit subcomputation :
+             SubcomputationEmissionOrder(computation)) {
+          if (subcomputation.computation->IsFusionComputation()) {
+            continue;
+          }
+          TF_RETURN_IF_ERROR(
+              ir_emitter
+                  .EmitComputation(
+                      subcomputation.computation,
+                      subcomputation.computation->name(),
+                      /*is_top_level_computation=*/false,
+                      schedule.sequence(subcomputation.computation)
+                          .instructions(),
+                      subcomputation.allow_reassociation)
+                  .status());
+        }
+        TF_ASSIGN_OR_RETURN(llvm::Function * entry_function,
+                            ir_emitter.EmitComputation(
+                                computation, entry_name,
+                                /*is_top_level_computation=*/true,
+                                schedule.sequence(computation).instructions(),
+                                /*allow_reassociation=*/false));
+
+        CHECK(entry_function->getName() == entry_name);
+        return llvm_module;
+      };
 
-      CHECK(entry_function->getName() == entry_point_name);
+      const std::string& entry_point_name = options.entry_point_name();
+      std::unique_ptr<llvm::Module> llvm_module;
+      if (options.target_variants().empty()) {
+        TF_ASSIGN_OR_RETURN(
+            llvm_module,
+            emit_llvm_module(target_machine.get(), entry_point_name));
+      } else {
+        // Every ISA specialized version is emitted into its own module and
+        // linked into the module of the baseline version, which is compiled
+        // with per function target attributes.
+        std::string fallback_entry = absl::StrCat(entry_point_name, ".base");
+        TF_ASSIGN_OR_RETURN(llvm_module, emit_llvm_module(target_machine.get(),
+                                                          fallback_entry));
+        PrepareTargetVariantModule(*llvm_module, fallback_entry,
+                                   options.cpu_name(), options.features());
+
+        std::vector<std::pair<std::string, std::string>> variant_entries;
+        for (int64_t v = 0; v < options.target_variants().size(); ++v) {
+          const CpuAotCompilationOptions::TargetVariant& variant =
+              options.target_variants()[v];
+          if (variant.features.empty()) {
+            return InvalidArgument(
+                "Target variant %d of %s must specify its target features", v,
+                module->name());
+          }
+          std::unique_ptr<llvm::TargetMachine> variant_target_machine =
+              absl::WrapUnique(target->createTargetMachine(
+                  triple.getTriple(), variant.cpu_name, variant.features,
+                  CompilerTargetOptions(module->config()), reloc_model,
+                  std::nullopt, opt_level));
+
+          std::string variant_entry =
+              absl::StrCat(entry_point_name, ".variant.", v);
+          TF_ASSIGN_OR_RETURN(
+              std::unique_ptr<llvm::Module> variant_module,
+              emit_llvm_module(variant_target_machine.get(), variant_entry));
+          PrepareTargetVariantModule(*variant_module, variant_entry,
+                                     variant.cpu_name, variant.features);
+          if (llvm::Linker::linkModules(*llvm_module,
+                                        std::move(variant_module))) {
+            return Internal("Failed to link target variant %d of %s", v,
+                            module->name());
+          }
+          variant_entries.emplace_back(std::move(variant_entry),
+                                       variant.features);
+        }
+        TF_RETURN_IF_ERROR(EmitTargetVariantDispatcher(
+            *llvm_module, entry_point_name, fallback_entry, variant_entries));
+      }
 
       ModuleHook pre_optimization_ir_hook;
       ModuleHook post_optimization_ir_hook;
@@ -1622,11 +2041,13 @@ class CpuExecutableAotCompilationResult : public AotCompilationResult {
   CpuExecutableAotCompilationResult(const HloModule* hlo_module,
                                     const BufferAssignment* buffer_assignment,
                                     std::string_view function_name,
-                                    std::string_view obj_file) {
+                                    absl::Span<const std::string> obj_files) {
     *proto_.mutable_hlo_module()->mutable_hlo_module() = hlo_module->ToProto();
     *proto_.mutable_buffer_assignment() = buffer_assignment->ToProto();
     proto_.set_entry_function_name(std::string(function_name));
-    proto_.set_obj_file(std::string(obj_file));
+    for (const std::string& obj_file : obj_files) {
+      proto_.add_obj_files(obj_file);
+    }
     *proto_.mutable_hlo_module()->mutable_config() =
         hlo_module->config().ToProto();
     module_ = hlo_module->Clone();
@@ -1700,12 +2121,15 @@ CpuExecutableAotCompilationResult::LoadExecutable(
     return Internal("Creating JIT failed: %s", llvm::toString(jit.takeError()));
   }
 
-  // Create a named buffer from compiled object file.
-  llvm::StringRef data(proto_.obj_file().data(), proto_.obj_file().size());
-  auto obj_file =
-      llvm::MemoryBuffer::getMemBuffer(data, proto_.entry_function_name());
+  // Create named buffers from compiled object files.
+  auto add_obj_file = [&](const std::string& obj_file) {
+    llvm::StringRef data(obj_file.data(), obj_file.size());
+    cantFail((*jit)->AddObjFile(
+        llvm::MemoryBuffer::getMemBuffer(data, proto_.entry_function_name())));
+  };
 
-  cantFail((*jit)->AddObjFile(std::move(obj_file)));
+  if (!proto_.obj_file().empty()) add_obj_file(proto_.obj_file());
+  for (const std::string& obj_file : proto_.obj_files()) add_obj_file(obj_file);
 
   TF_ASSIGN_OR_RETURN(
       auto cpu_executable,
@@ -1730,16 +2154,14 @@ absl::StatusOr<std::unique_ptr<AotCompilationResult>> CpuCompiler::Export(
   if (!cpu_executable)
     return Internal("Could not downcast Executable to CpuExecutable");
 
-  if (cpu_executable->obj_files().size() != 1) {
+  if (cpu_executable->obj_files().empty()) {
     return absl::InternalError(
-        absl::StrCat("Can't export CPU execuable, expected exactly one object "
-                     "file but got: ",
-                     cpu_executable->obj_files().size()));
+        "Can't export CPU execuable, expected at least one object file");
   }
 
   return {std::make_unique<CpuExecutableAotCompilationResult>(
       &cpu_executable->module(), &cpu_executable->buffer_assignment(),
-      cpu_executable->module_name(), cpu_executable->obj_files()[0])};
+      cpu_executable->module_name(), cpu_executable->obj_files())};
 }
 
 absl::StatusOr<std::unique_ptr<AotCompilationResult>>
@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -91,6 +92,28 @@ class CpuAotCompilationOptions : public AotCompilationOptions {
   bool use_mlir_hlo_lowering() const { return use_mlir_hlo_lowering_; }
   void set_use_mlir_hlo_lowering(bool value) { use_mlir_hlo_lowering_ = value; }
 
+  // An ISA specialized version of the compiled computation. The CPU name only
+  // tunes code generation, `features` must list every ISA extension the
+  // version relies on as it is checked against the host CPU at runtime.
+  struct TargetVariant {
+    std::string cpu_name;
+    std::string features;
+  };
+
+  // Additional versions of every compiled computation. If not empty the entry
+  // point becomes a dispatcher that, on the first call, selects the first
+  // variant whose features are all supported by the host CPU, and falls back
+  // to the version compiled for `cpu_name` and `features` otherwise. Variants
+  // should be ordered from the most to the least specialized. The object file
+  // refers to `__xla_cpu_runtime_HostSupportsTargetFeatures` (see
+  // runtime_cpu_features.h).
+  const std::vector<TargetVariant>& target_variants() const {
+    return target_variants_;
+  }
+  void set_target_variants(std::vector<TargetVariant> target_variants) {
+    target_variants_ = std::move(target_variants);
+  }
+
  private:
   const std::string triple_;
   const std::string cpu_name_;
@@ -98,6 +121,7 @@ class CpuAotCompilationOptions : public AotCompilationOptions {
   const std::string entry_point_name_;
   const RelocationModel relocation_model_;
   bool use_mlir_hlo_lowering_ = false;
+  std::vector<TargetVariant> target_variants_;
 };
 
 class CpuAotCompilationResult : public AotCompilationResult {
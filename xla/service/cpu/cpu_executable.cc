@@ -160,8 +160,13 @@ absl::StatusOr<std::unique_ptr<CpuExecutable>> CpuExecutable::Create(
   executable->jit_ = std::move(jit);
   executable->host_kernels_ = HostKernels(executable->jit_.get());
 
+  // Merge linear chains of kernel thunks to avoid paying for task dispatch
+  // between dependent kernels at run time.
+  ThunkExecutor::Options options;
+  options.fuse_kernel_chains = true;
+
   TF_ASSIGN_OR_RETURN(executable->thunks_,
-                      ThunkExecutor::Create(std::move(thunks)));
+                      ThunkExecutor::Create(std::move(thunks), options));
 
   // Re-index constants by their allocation index to allow efficient lookup.
   for (auto& constant : constants) {
@@ -358,10 +363,17 @@ absl::Status CpuExecutable::ExecuteThunks(
   TF_ASSIGN_OR_RETURN(Thunk::CollectiveExecuteParams collective_execute_params,
                       Thunk::CollectiveExecuteParams::Create(run_options));
 
+  // Prepare for executing XLA custom calls.
+  TF_ASSIGN_OR_RETURN(Thunk::CustomCallExecuteParams custom_call_execute_params,
+                      Thunk::CustomCallExecuteParams::Create(run_options));
+
   Thunk::ExecuteParams execute_params = {
-      &*host_kernels_, &allocations,
+      &*host_kernels_,
+      &allocations,
       runtime::GetXfeedManager(run_options->device_ordinal()),
-      run_options->intra_op_thread_pool(), &collective_execute_params};
+      run_options->intra_op_thread_pool(),
+      &collective_execute_params,
+      &custom_call_execute_params};
 
   auto executed_event = thunks_->Execute(execute_params);
   tsl::BlockUntilReady(executed_event);
@@ -13,16 +13,20 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
-
 #include "xla/service/cpu/cpu_float_support.h"
 
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
 #include "xla/service/cpu/onednn_matmul_rewriter.h"
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 
 namespace xla {
 namespace cpu {
 
 bool CpuFloatSupport::IsSupported(const HloInstruction& hlo) const {
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
   switch (hlo.opcode()) {
     // oneDNN rewritable ops
     case HloOpcode::kDot:
@@ -57,9 +61,10 @@ bool CpuFloatSupport::IsSupported(const HloInstruction& hlo) const {
     default:
       return false;
   }
+#else
+  return false;
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 }
 
 }  // namespace cpu
 }  // namespace xla
-
-#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
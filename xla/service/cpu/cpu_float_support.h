@@ -16,37 +16,60 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_CPU_FLOAT_SUPPORT_H_
 #define XLA_SERVICE_CPU_CPU_FLOAT_SUPPORT_H_
 
-#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+#include <cstdint>
+#include <functional>
+#include <utility>
 
+#include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/service/float_support.h"
+#include "xla/xla_data.pb.h"
 
 namespace xla {
 namespace cpu {
 
+// Tells FloatNormalization which low precision ops the CPU backend handles
+// without upcasting them to the high precision type.
+//
+// Dots accepted by `low_precision_dot` keep their low precision operands and
+// get a high precision result, which is then lowered to a mixed precision
+// runtime kernel. With oneDNN, dots that can be rewritten to oneDNN matmuls
+// and data movement ops stay entirely in low precision.
 class CpuFloatSupport : public FloatSupport {
  public:
-  explicit CpuFloatSupport(PrimitiveType low_precision_type)
-      : FloatSupport(low_precision_type) {}
+  using DotChecker = std::function<bool(const HloInstruction& dot)>;
+
+  explicit CpuFloatSupport(PrimitiveType low_precision_type,
+                           DotChecker low_precision_dot = nullptr)
+      : FloatSupport(low_precision_type),
+        low_precision_dot_(std::move(low_precision_dot)) {}
 
   bool SupportsLowPrecisionOperand(const HloInstruction& hlo,
                                    int64_t operand_index) const override {
     return FloatSupport::SupportsLowPrecisionOperand(hlo, operand_index) ||
-           IsSupported(hlo);
+           IsSupported(hlo) || LowPrecisionDotSupported(hlo);
   }
 
   bool SupportsLowPrecisionOutput(const HloInstruction& hlo) const override {
     return FloatSupport::SupportsLowPrecisionOutput(hlo) || IsSupported(hlo);
   }
 
+  bool SupportsMixedPrecisions(const HloInstruction& hlo) const override {
+    return FloatSupport::SupportsMixedPrecisions(hlo) ||
+           LowPrecisionDotSupported(hlo);
+  }
+
  private:
   bool IsSupported(const HloInstruction& hlo) const;
-  // Performs early check for things that cannot be delayed becuase some later
-  // passes may change the shape of dot inputs.
-  bool DotSupported(const HloInstruction& hlo) const;
+
+  bool LowPrecisionDotSupported(const HloInstruction& hlo) const {
+    return hlo.opcode() == HloOpcode::kDot && low_precision_dot_ &&
+           low_precision_dot_(hlo);
+  }
+
+  DotChecker low_precision_dot_;
 };
 
 }  // namespace cpu
 }  // namespace xla
 
-#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 #endif  // XLA_SERVICE_CPU_CPU_FLOAT_SUPPORT_H_
@@ -15,10 +15,18 @@ limitations under the License.
 
 #include "xla/service/cpu/cpu_instruction_fusion.h"
 
+#include <cstdint>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/cpu/dot_op_emitter.h"
 #include "xla/service/fusion_node_indexing_evaluation.h"
 #include "xla/service/instruction_fusion.h"
 #include "xla/service/llvm_ir/fused_ir_emitter.h"
+#include "xla/shape_util.h"
 
 namespace xla {
 namespace cpu {
@@ -67,8 +75,83 @@ bool CanBeOutputFusedIntoSomeOperand(const HloInstruction* consumer) {
          (CanBeOutputFused(consumer->operand(0), consumer) ||
           CanBeOutputFused(consumer->operand(1), consumer));
 }
+
+// Returns true if all transitive users of `instr` are elementwise in `instr`
+// and have the same dimensions, i.e. every element of the result depends only
+// on the element of `instr` at the same index.
+bool IsOnlyUsedElementwise(const HloInstruction* instr) {
+  std::vector<const HloInstruction*> worklist = {instr};
+  absl::flat_hash_set<const HloInstruction*> visited = {instr};
+
+  while (!worklist.empty()) {
+    const HloInstruction* operand = worklist.back();
+    worklist.pop_back();
+
+    for (const HloInstruction* user : operand->users()) {
+      if (!user->IsElementwiseOnOperand(user->operand_index(operand)) ||
+          !ShapeUtil::SameDimensions(user->shape(), instr->shape())) {
+        return false;
+      }
+      if (visited.insert(user).second) worklist.push_back(user);
+    }
+  }
+
+  return true;
+}
 }  // namespace
 
+bool CpuInstructionFusion::CanFuseDotEpilogue(
+    const HloInstruction* producer, const HloInstruction* consumer) const {
+  if (target_machine_features_ == nullptr ||
+      producer->opcode() != HloOpcode::kDot || !HasExactlyOneUse(*producer)) {
+    return false;
+  }
+
+  // Epilogue is applied in place to the dot result, so it must have exactly
+  // the same shape (including layout) as the dot.
+  if (!ShapeUtil::Equal(producer->shape(), consumer->shape()) ||
+      !DotImplementationCanFuseEpilogue(*producer, *target_machine_features_)) {
+    return false;
+  }
+
+  // Buffer assignment can share the buffer of the addend of an output fusion
+  // with a root `add` with the fusion result (see HloDataflowAnalysis), which
+  // doesn't work with computing the dot in place. We only fuse broadcasted
+  // addends (i.e. bias) into the root `add`.
+  auto is_aliasable_addend = [](const HloInstruction* add,
+                                const HloInstruction* dot) {
+    if (add->opcode() != HloOpcode::kAdd) return false;
+    for (int64_t i = 0; i < 2; ++i) {
+      if (add->operand(i) == dot) {
+        return add->operand(1 - i)->opcode() != HloOpcode::kBroadcast;
+      }
+    }
+    return false;
+  };
+
+  int64_t operand_index = consumer->operand_index(producer);
+  if (consumer->opcode() == HloOpcode::kFusion) {
+    const HloInstruction* fused_dot = consumer->fused_parameter(operand_index);
+    return consumer->IsLoopFusion() && !consumer->IsMultiOutputFusion() &&
+           IsOnlyUsedElementwise(fused_dot) &&
+           !is_aliasable_addend(consumer->fused_expression_root(), fused_dot);
+  }
+  return consumer->IsElementwiseOnOperand(operand_index) &&
+         !is_aliasable_addend(consumer, producer);
+}
+
+bool CpuInstructionFusion::IsDotEpilogueOperand(const HloInstruction* consumer,
+                                                int64_t operand_index) const {
+  if (target_machine_features_ == nullptr) return false;
+
+  const HloInstruction* dot =
+      FindDotWithEpilogue(*consumer, *target_machine_features_);
+  if (dot == nullptr) return false;
+
+  return !absl::c_linear_search(dot->operands(),
+                                consumer->fused_parameter(operand_index));
+}
+
 FusionDecision CpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
                                                 int64_t operand_index) {
   HloInstruction* producer = consumer->mutable_operand(operand_index);
@@ -82,6 +165,11 @@ FusionDecision CpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
     return {};
   }
 
+  if (CanFuseDotEpilogue(producer, consumer)) {
+    VLOG(2) << "Fusion OK: Can fuse elementwise epilogue into dot.";
+    return {};
+  }
+
   if (CanBeOutputFusedIntoSomeOperand(producer)) {
     return "Bailing because producer can be output-fused into some operand.";
   }
@@ -180,6 +268,11 @@ FusionDecision CpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
     return {};
   }
 
+  if (IsDotEpilogueOperand(consumer, operand_index)) {
+    VLOG(2) << "Fusing: consumer is a dot epilogue fusion.";
+    return {};
+  }
+
   if (CanBeLoopFused(*consumer)) {
     VLOG(2) << "Fusing: consumer is elementwise or fusible.";
     return {};
@@ -190,9 +283,17 @@ FusionDecision CpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
 
 HloInstruction::FusionKind CpuInstructionFusion::ChooseKind(
     const HloInstruction* producer, const HloInstruction* consumer) {
-  return CanBeOutputFused(producer, consumer)
-             ? HloInstruction::FusionKind::kOutput
-             : HloInstruction::FusionKind::kLoop;
+  if (CanBeOutputFused(producer, consumer) ||
+      CanFuseDotEpilogue(producer, consumer)) {
+    return HloInstruction::FusionKind::kOutput;
+  }
+
+  // Fusing epilogue operands into dot epilogue fusion keeps the fusion kind.
+  if (consumer->IsOutputFusion()) {
+    return HloInstruction::FusionKind::kOutput;
+  }
+
+  return HloInstruction::FusionKind::kLoop;
 }
 
 HloInstruction* CpuInstructionFusion::FuseInstruction(
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/cpu/target_machine_features.h"
 #include "xla/service/fusion_node_indexing_evaluation.h"
 #include "xla/service/instruction_fusion.h"
 
@@ -26,8 +27,13 @@ namespace cpu {
 
 class CpuInstructionFusion : public InstructionFusion {
  public:
-  CpuInstructionFusion()
-      : InstructionFusion(CpuInstructionFusion::IsExpensive) {}
+  // If `target_machine_features` is not null, elementwise consumers (e.g. bias
+  // add and activation) are fused into dots that are lowered to tiled LLVM IR
+  // GEMM kernels, which apply them as an epilogue to every result tile.
+  explicit CpuInstructionFusion(
+      const TargetMachineFeatures* target_machine_features = nullptr)
+      : InstructionFusion(CpuInstructionFusion::IsExpensive),
+        target_machine_features_(target_machine_features) {}
   ~CpuInstructionFusion() override = default;
 
   using HloPassInterface::Run;
@@ -48,6 +54,18 @@ class CpuInstructionFusion : public InstructionFusion {
   HloInstruction* FuseInstruction(HloInstruction* fusion_instruction,
                                   HloInstruction* producer) override;
 
+  // Returns true if `consumer` can be fused into the dot `producer` as an
+  // elementwise epilogue.
+  bool CanFuseDotEpilogue(const HloInstruction* producer,
+                          const HloInstruction* consumer) const;
+
+  // Returns true if `consumer` is a dot fusion with an elementwise epilogue,
+  // and its operand `operand_index` is used only by the epilogue.
+  bool IsDotEpilogueOperand(const HloInstruction* consumer,
+                            int64_t operand_index) const;
+
+  const TargetMachineFeatures* target_machine_features_;
+
   // Keep track of the number of times each instruction inside a fusion node is
   // indexed with different index vectors.
   absl::flat_hash_map<const HloInstruction*, FusionNodeIndexingEvaluation>
@@ -22,6 +22,8 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "xla/hlo/utils/hlo_matchers.h"
+#include "xla/service/cpu/dot_op_emitter.h"
+#include "xla/service/cpu/target_machine_features_fake.h"
 #include "xla/service/transpose_folding.h"
 #include "xla/shape.h"
 #include "xla/tests/hlo_test_base.h"
@@ -901,6 +903,102 @@ ENTRY main {
               Not(op::Fusion()));
 }
 
+// Returns a module config that allows lowering small dots to tiled LLVM IR.
+HloModuleConfig GetConfigWithTiledLlvmIrGemm(HloModuleConfig config) {
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_cpu_multi_thread_eigen(false);
+  config.set_debug_options(debug_options);
+  return config;
+}
+
+TEST_F(InstructionFusionTest, DotBiasAddReluEpilogueFusion) {
+  absl::string_view module_string = R"(
+HloModule module
+
+ENTRY main {
+  lhs = f32[32,64]{1,0} parameter(0)
+  rhs = f32[64,32]{1,0} parameter(1)
+  bias = f32[32]{0} parameter(2)
+  dot = f32[32,32]{1,0} dot(lhs, rhs),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  bias_bcast = f32[32,32]{1,0} broadcast(bias), dimensions={1}
+  add = f32[32,32]{1,0} add(dot, bias_bcast)
+  zero = f32[] constant(0)
+  zero_bcast = f32[32,32]{1,0} broadcast(zero), dimensions={}
+  ROOT relu = f32[32,32]{1,0} maximum(add, zero_bcast)
+}
+)";
+
+  HloModuleConfig config =
+      GetConfigWithTiledLlvmIrGemm(GetModuleConfigForTest());
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(module_string, config));
+
+  TargetMachineFeaturesWithFakeAlignmentLogic target_machine_features(
+      [](int64_t size) { return 16; });
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool fused_something,
+      CpuInstructionFusion(&target_machine_features).Run(module.get()));
+  EXPECT_TRUE(fused_something);
+
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  ASSERT_THAT(root, op::Fusion());
+  EXPECT_EQ(root->fusion_kind(), HloInstruction::FusionKind::kOutput);
+  EXPECT_EQ(root->operand_count(), 3);
+  EXPECT_NE(FindDotWithEpilogue(*root, target_machine_features), nullptr);
+}
+
+TEST_F(InstructionFusionTest, DotEpilogueFusionRequiresTargetMachineFeatures) {
+  absl::string_view module_string = R"(
+HloModule module
+
+ENTRY main {
+  lhs = f32[32,64]{1,0} parameter(0)
+  rhs = f32[64,32]{1,0} parameter(1)
+  dot = f32[32,32]{1,0} dot(lhs, rhs),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  ROOT tanh = f32[32,32]{1,0} tanh(dot)
+}
+)";
+
+  HloModuleConfig config =
+      GetConfigWithTiledLlvmIrGemm(GetModuleConfigForTest());
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(module_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(bool fused_something,
+                          CpuInstructionFusion().Run(module.get()));
+  EXPECT_FALSE(fused_something);
+}
+
+TEST_F(InstructionFusionTest, DotEpilogueFusionDoesNotFuseSameShapeAddend) {
+  // Buffer assignment can alias `addend` with the output fusion result, which
+  // is not compatible with computing the dot in place.
+  absl::string_view module_string = R"(
+HloModule module
+
+ENTRY main {
+  lhs = f32[32,64]{1,0} parameter(0)
+  rhs = f32[64,32]{1,0} parameter(1)
+  addend = f32[32,32]{1,0} parameter(2)
+  dot = f32[32,32]{1,0} dot(lhs, rhs),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  ROOT add = f32[32,32]{1,0} add(dot, addend)
+}
+)";
+
+  HloModuleConfig config =
+      GetConfigWithTiledLlvmIrGemm(GetModuleConfigForTest());
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(module_string, config));
+
+  TargetMachineFeaturesWithFakeAlignmentLogic target_machine_features(
+      [](int64_t size) { return 16; });
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool fused_something,
+      CpuInstructionFusion(&target_machine_features).Run(module.get()));
+  EXPECT_FALSE(fused_something);
+}
+
 TEST_F(InstructionFusionTest, FuseReduceMinor) {
   absl::string_view module_string = R"(
 HloModule module
@@ -28,6 +28,8 @@ const char* const kLlvmIrGemmTileSize = "xla_llvm_ir_gemm_tile_size";
 const char* const kDisableSlpVectorizer = "xla_cpu_disable_slp_vectorizer";
 const char* const kXlaCpuExperimentalOverridePipeline =
     "xla_cpu_experimental_override_pipeline";
+const char* const kXlaCpuEnablePersistentForkJoin =
+    "xla_cpu_enable_persistent_fork_join";
 
 }  // namespace
 
@@ -71,6 +73,12 @@ bool ForceEnableExperimentalLlvmIrGemm(const HloModuleConfig& config) {
   return extra_options_map.count(kXlaForceEnableExperimentalLlvmIrGemm) > 0;
 }
 
+bool PersistentForkJoinEnabled(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  return extra_options_map.count(kXlaCpuEnablePersistentForkJoin) > 0;
+}
+
 static absl::string_view RemoveSuffix(absl::string_view str,
                                       absl::string_view suffix) {
   CHECK_GE(str.size(), suffix.size());
@@ -23,6 +23,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -30,12 +31,14 @@ limitations under the License.
 #include "absl/base/attributes.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xla/executable_run_options.h"
@@ -53,6 +56,7 @@ limitations under the License.
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/status.h"
@@ -86,6 +90,10 @@ extern const char* const kEigenMatMulC128SymbolName =
     "__xla_cpu_runtime_EigenMatMulC128";
 extern const char* const kEigenMatMulS32SymbolName =
     "__xla_cpu_runtime_EigenMatMulS32";
+extern const char* const kEigenMatMulBF16F32SymbolName =
+    "__xla_cpu_runtime_EigenMatMulBF16F32";
+extern const char* const kEigenMatMulS8S32SymbolName =
+    "__xla_cpu_runtime_EigenMatMulS8S32";
 extern const char* const kEigenBatchMatMulF32SymbolName =
     "__xla_cpu_runtime_EigenBatchMatMulF32";
 extern const char* const kMKLConv2DF32SymbolName =
@@ -119,6 +127,10 @@ extern const char* const kEigenSingleThreadedMatMulC128SymbolName =
     "__xla_cpu_runtime_EigenSingleThreadedMatMulC128";
 extern const char* const kEigenSingleThreadedMatMulS32SymbolName =
     "__xla_cpu_runtime_EigenSingleThreadedMatMulS32";
+extern const char* const kEigenSingleThreadedMatMulBF16F32SymbolName =
+    "__xla_cpu_runtime_EigenSingleThreadedMatMulBF16F32";
+extern const char* const kEigenSingleThreadedMatMulS8S32SymbolName =
+    "__xla_cpu_runtime_EigenSingleThreadedMatMulS8S32";
 extern const char* const kEigenSingleThreadedConv2DF16SymbolName =
     "__xla_cpu_runtime_EigenSingleThreadedConv2DF16";
 extern const char* const kEigenSingleThreadedConv2DF32SymbolName =
@@ -137,18 +149,29 @@ extern const char* const kReleaseOutfeedBufferAfterPopulationSymbolName =
     "__xla_cpu_runtime_ReleaseOutfeedBufferAfterPopulation";
 extern const char* const kParallelForkJoinSymbolName =
     "__xla_cpu_runtime_ParallelForkJoin";
+extern const char* const kPersistentParallelForkJoinSymbolName =
+    "__xla_cpu_runtime_PersistentParallelForkJoin";
 extern const char* const kPrintfToStderrSymbolName =
     "__xla_cpu_runtime_PrintfToStderr";
 extern const char* const kStatusIsSuccessSymbolName =
     "__xla_cpu_runtime_StatusIsSuccess";
 extern const char* const kKeyValueSortSymbolName =
     "__xla_cpu_runtime_KeyValueSort";
+extern const char* const kHostSupportsTargetFeaturesSymbolName =
+    "__xla_cpu_runtime_HostSupportsTargetFeatures";
 extern const char* const kTopKF32SymbolName = "__xla_cpu_runtime_TopKF32";
+extern const char* const kTopKBF16SymbolName = "__xla_cpu_runtime_TopKBF16";
+extern const char* const kTopKF16SymbolName = "__xla_cpu_runtime_TopKF16";
+extern const char* const kTopKS32SymbolName = "__xla_cpu_runtime_TopKS32";
 extern const char* const kTracingStartSymbolName =
     "__xla_cpu_runtime_TracingStart";
 extern const char* const kTracingEndSymbolName = "__xla_cpu_runtime_TracingEnd";
 extern const char* const kXlaCpuRuntimeSymbolNamePrefix = "__xla_cpu_runtime_";
 extern const char* const kAllReduceSymbolName = "__xla_cpu_runtime_AllReduce";
+extern const char* const kAllReduceStartSymbolName =
+    "__xla_cpu_runtime_AllReduceStart";
+extern const char* const kAllReduceDoneSymbolName =
+    "__xla_cpu_runtime_AllReduceDone";
 extern const char* const kAllGatherSymbolName = "__xla_cpu_runtime_AllGather";
 extern const char* const kReduceScatterSymbolName =
     "__xla_cpu_runtime_ReduceScatter";
@@ -443,6 +466,24 @@ void ReduceScatterImpl(const ExecutableRunOptions* run_options,
       output_buffer, DefaultCollectiveTimeout()));
 }
 
+// All-reduces every array of `shape` from `input_buffers` into
+// `output_buffers`.
+absl::Status AllReduceBuffers(CollectivesCommunicator& communicator,
+                              const RendezvousKey& rendezvous_key,
+                              ReductionKind reduction_kind, const Shape& shape,
+                              absl::Span<void* const> input_buffers,
+                              absl::Span<void* const> output_buffers) {
+  for (int i = 0; i < input_buffers.size(); i++) {
+    const Shape& subshape =
+        input_buffers.size() == 1 ? shape : shape.tuple_shapes(i);
+    TF_RETURN_IF_ERROR(communicator.AllReduce(
+        rendezvous_key, reduction_kind, subshape.element_type(),
+        ShapeUtil::ElementsIn(subshape), input_buffers[i], output_buffers[i],
+        DefaultCollectiveTimeout()));
+  }
+  return absl::OkStatus();
+}
+
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY
 void AllReduceImpl(const ExecutableRunOptions* run_options,
                    const void* replica_groups_str,
@@ -474,13 +515,125 @@ void AllReduceImpl(const ExecutableRunOptions* run_options,
 
   auto communicator =
       collectives->GetCommunicator(rendezvous_key.global_devices, rank).value();
-  for (int i = 0; i < num_buffers; i++) {
-    Shape subshape = num_buffers == 1 ? shape : shape.tuple_shapes(i);
-    TF_CHECK_OK(communicator->AllReduce(
-        rendezvous_key, static_cast<ReductionKind>(reduction_kind),
-        subshape.element_type(), ShapeUtil::ElementsIn(subshape),
-        input_buffers[i], output_buffers[i], DefaultCollectiveTimeout()));
+  TF_CHECK_OK(AllReduceBuffers(
+      *communicator, rendezvous_key, static_cast<ReductionKind>(reduction_kind),
+      shape, absl::MakeSpan(input_buffers, num_buffers),
+      absl::MakeSpan(output_buffers, num_buffers)));
+}
+
+// All-reduces started by AllReduceStartImpl that were not yet awaited by
+// AllReduceDoneImpl. Keyed by run id, device ordinal and async id, since the
+// same executable may run concurrently on several devices and runs.
+class PendingAllReduces {
+ public:
+  using Key = std::tuple<int64_t, int, int64_t>;
+
+  static PendingAllReduces& Get() {
+    static auto* pending = new PendingAllReduces();
+    return *pending;
+  }
+
+  // Runs `fn` on its own thread. Collectives block until all participants
+  // arrive, so sharing a bounded pool between devices could deadlock.
+  void Start(Key key, absl::AnyInvocable<absl::Status()> fn) {
+    auto pending = std::make_shared<Pending>();
+    {
+      absl::MutexLock lock(&mu_);
+      CHECK(pending_.emplace(key, pending).second)
+          << "All-reduce " << std::get<2>(key) << " started twice";
+    }
+    tsl::Env::Default()->SchedClosure(
+        [pending, fn = std::move(fn)]() mutable {
+          pending->status = fn();
+          pending->done.Notify();
+        });
   }
+
+  absl::Status Wait(const Key& key) {
+    std::shared_ptr<Pending> pending;
+    {
+      absl::MutexLock lock(&mu_);
+      auto it = pending_.find(key);
+      if (it == pending_.end()) {
+        return Internal("All-reduce %d was not started", std::get<2>(key));
+      }
+      pending = std::move(it->second);
+      pending_.erase(it);
+    }
+    pending->done.WaitForNotification();
+    return pending->status;
+  }
+
+ private:
+  struct Pending {
+    absl::Notification done;
+    absl::Status status;
+  };
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<Key, std::shared_ptr<Pending>> pending_
+      ABSL_GUARDED_BY(mu_);
+};
+
+PendingAllReduces::Key GetPendingAllReduceKey(
+    const ExecutableRunOptions* run_options, int64_t async_id) {
+  return {run_options->run_id().ToInt(), GetDeviceOrdinal(run_options),
+          async_id};
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY
+void AllReduceStartImpl(const ExecutableRunOptions* run_options,
+                        const void* replica_groups_str,
+                        int32_t replica_groups_str_size,
+                        int32_t channel_id_present,
+                        int32_t use_global_device_ids, int64_t op_id,
+                        int32_t reduction_kind, const void* shape_ptr,
+                        int32_t shape_length, int32_t num_buffers,
+                        void** input_buffers, void** output_buffers,
+                        int64_t async_id) {
+  GlobalDeviceId device(GetDeviceOrdinal(run_options));
+  std::string_view replica_groups_serialized(
+      static_cast<const char*>(replica_groups_str), replica_groups_str_size);
+  std::vector<ReplicaGroup> group =
+      ParseReplicaGroupsOnly(replica_groups_serialized).value();
+  RendezvousKey rendezvous_key =
+      GetRendezvousKey(run_options, device, group, channel_id_present,
+                       use_global_device_ids, op_id);
+  VLOG(2) << "All-reduce-start input/output shape : "
+          << ShapeString(shape_ptr, shape_length);
+
+  Shape shape =
+      DecodeSelfDescribingShapeConstant(shape_ptr, shape_length).value();
+
+  CHECK((num_buffers > 1 && shape.IsTuple()) ||
+        (num_buffers == 1 && LayoutUtil::IsDenseArray(shape)));
+
+  int rank = RankInGlobalDevices(rendezvous_key.global_devices, device).value();
+
+  CollectivesInterface* collectives = GetCollectivesImpl(run_options);
+
+  std::shared_ptr<CollectivesCommunicator> communicator =
+      collectives->GetCommunicator(rendezvous_key.global_devices, rank).value();
+
+  // The buffer tables live in the caller's stack frame, copy them.
+  std::vector<void*> inputs(input_buffers, input_buffers + num_buffers);
+  std::vector<void*> outputs(output_buffers, output_buffers + num_buffers);
+  PendingAllReduces::Get().Start(
+      GetPendingAllReduceKey(run_options, async_id),
+      [communicator = std::move(communicator),
+       rendezvous_key = std::move(rendezvous_key), reduction_kind,
+       shape = std::move(shape), inputs = std::move(inputs),
+       outputs = std::move(outputs)] {
+        return AllReduceBuffers(*communicator, rendezvous_key,
+                                static_cast<ReductionKind>(reduction_kind),
+                                shape, inputs, outputs);
+      });
+}
+
+void AllReduceDoneImpl(const ExecutableRunOptions* run_options,
+                       int64_t async_id) {
+  TF_CHECK_OK(PendingAllReduces::Get().Wait(
+      GetPendingAllReduceKey(run_options, async_id)));
 }
 
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY
@@ -641,6 +794,25 @@ void __xla_cpu_runtime_AllReduce(const xla::ExecutableRunOptions* run_options,
       shape_ptr, shape_length, num_buffers, input_buffers, output_buffers);
 }
 
+void __xla_cpu_runtime_AllReduceStart(
+    const xla::ExecutableRunOptions* run_options,
+    const void* replica_groups_str, int32_t replica_groups_str_size,
+    int32_t channel_id_present, int32_t use_global_device_ids, int64_t op_id,
+    int32_t reduction_kind, const void* shape_ptr, int32_t shape_length,
+    int32_t num_buffers, void** input_buffers, void** output_buffers,
+    int64_t async_id) {
+  return xla::cpu::runtime::AllReduceStartImpl(
+      run_options, replica_groups_str, replica_groups_str_size,
+      channel_id_present, use_global_device_ids, op_id, reduction_kind,
+      shape_ptr, shape_length, num_buffers, input_buffers, output_buffers,
+      async_id);
+}
+
+void __xla_cpu_runtime_AllReduceDone(
+    const xla::ExecutableRunOptions* run_options, int64_t async_id) {
+  return xla::cpu::runtime::AllReduceDoneImpl(run_options, async_id);
+}
+
 void __xla_cpu_runtime_ReplicaId(const xla::ExecutableRunOptions* run_options,
                                  void* output_buffer) {
   return xla::cpu::runtime::ReplicaIdImpl(run_options, output_buffer);
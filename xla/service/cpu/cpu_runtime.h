@@ -47,6 +47,8 @@ extern const char* const kEigenMatMulF64SymbolName;
 extern const char* const kEigenMatMulC64SymbolName;
 extern const char* const kEigenMatMulC128SymbolName;
 extern const char* const kEigenMatMulS32SymbolName;
+extern const char* const kEigenMatMulBF16F32SymbolName;
+extern const char* const kEigenMatMulS8S32SymbolName;
 extern const char* const kEigenBatchMatMulF32SymbolName;
 extern const char* const kMKLConv2DF32SymbolName;
 extern const char* const kACLConv2DF32SymbolName;
@@ -64,6 +66,8 @@ extern const char* const kEigenSingleThreadedMatMulF64SymbolName;
 extern const char* const kEigenSingleThreadedMatMulC64SymbolName;
 extern const char* const kEigenSingleThreadedMatMulC128SymbolName;
 extern const char* const kEigenSingleThreadedMatMulS32SymbolName;
+extern const char* const kEigenSingleThreadedMatMulBF16F32SymbolName;
+extern const char* const kEigenSingleThreadedMatMulS8S32SymbolName;
 extern const char* const kEigenSingleThreadedConv2DF16SymbolName;
 extern const char* const kEigenSingleThreadedConv2DF32SymbolName;
 extern const char* const kEigenSingleThreadedConv3DF16SymbolName;
@@ -73,11 +77,18 @@ extern const char* const kReleaseInfeedBufferAfterDequeueSymbolName;
 extern const char* const kAcquireOutfeedBufferForPopulationSymbolName;
 extern const char* const kReleaseOutfeedBufferAfterPopulationSymbolName;
 extern const char* const kParallelForkJoinSymbolName;
+extern const char* const kPersistentParallelForkJoinSymbolName;
 extern const char* const kPrintfToStderrSymbolName;
 extern const char* const kStatusIsSuccessSymbolName;
 extern const char* const kKeyValueSortSymbolName;
+extern const char* const kHostSupportsTargetFeaturesSymbolName;
 extern const char* const kTopKF32SymbolName;
+extern const char* const kTopKBF16SymbolName;
+extern const char* const kTopKF16SymbolName;
+extern const char* const kTopKS32SymbolName;
 extern const char* const kAllReduceSymbolName;
+extern const char* const kAllReduceStartSymbolName;
+extern const char* const kAllReduceDoneSymbolName;
 extern const char* const kCollectivePermuteSymbolName;
 extern const char* const kPartitionIdSymbolName;
 extern const char* const kReplicaIdSymbolName;
@@ -190,6 +201,23 @@ extern void __xla_cpu_runtime_AllReduce(
     int32_t reduction_kind, const void* shape_ptr, int32_t shape_length,
     int32_t num_buffers, void** input_buffers, void** output_buffers);
 
+// Starts the all reduce described by the same arguments as
+// __xla_cpu_runtime_AllReduce on a communication thread and returns without
+// waiting for it. `async_id` identifies the all-reduce in the executable; the
+// all reduce must be awaited with __xla_cpu_runtime_AllReduceDone before its
+// output buffers are read.
+extern void __xla_cpu_runtime_AllReduceStart(
+    const xla::ExecutableRunOptions* run_options,
+    const void* replica_groups_str, int32_t replica_groups_str_size,
+    int32_t channel_id_present, int32_t use_global_device_ids, int64_t op_id,
+    int32_t reduction_kind, const void* shape_ptr, int32_t shape_length,
+    int32_t num_buffers, void** input_buffers, void** output_buffers,
+    int64_t async_id);
+
+// Waits for the all reduce started with the same `async_id`.
+extern void __xla_cpu_runtime_AllReduceDone(
+    const xla::ExecutableRunOptions* run_options, int64_t async_id);
+
 extern void __xla_cpu_runtime_CollectivePermute(
     const xla::ExecutableRunOptions* run_options, int32_t channel_id_present,
     int64_t op_id, int32_t byte_size, void* input_buffer, void* output_buffer,
@@ -15,9 +15,12 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 #include "xla/service/cpu/cpu_runtime.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "absl/strings/str_format.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
@@ -168,6 +171,62 @@ INSTANTIATE_TEST_SUITE_P(EigenMatMulTestInstantiaion, EigenMatMulTest,
                                             ::testing::Bool()),
                          EigenMatMulTest::Name);
 
+TEST_F(CpuRuntimeTest, EigenMatMulBF16F32) {
+  // Column major 2x3 lhs times 3x2 rhs, accumulated in F32. All values are
+  // exactly representable in BF16.
+  constexpr int64_t m = 2, k = 3, n = 2;
+  std::vector<Eigen::bfloat16> lhs = {
+      Eigen::bfloat16(1.0f), Eigen::bfloat16(4.0f), Eigen::bfloat16(2.0f),
+      Eigen::bfloat16(5.0f), Eigen::bfloat16(3.0f), Eigen::bfloat16(6.0f)};
+  std::vector<Eigen::bfloat16> rhs = {
+      Eigen::bfloat16(0.5f), Eigen::bfloat16(1.0f), Eigen::bfloat16(-1.0f),
+      Eigen::bfloat16(2.0f), Eigen::bfloat16(0.0f), Eigen::bfloat16(1.0f)};
+  std::vector<float> expected = {-0.5f, 1.0f, 5.0f, 14.0f};
+
+  std::vector<float> out(m * n);
+  __xla_cpu_runtime_EigenSingleThreadedMatMulBF16F32(
+      nullptr, out.data(), lhs.data(), rhs.data(), m, n, k,
+      /*transpose_lhs=*/0, /*transpose_rhs=*/0);
+  EXPECT_EQ(out, expected);
+
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 2);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  std::fill(out.begin(), out.end(), 0.0f);
+  __xla_cpu_runtime_EigenMatMulBF16F32(&run_options, out.data(), lhs.data(),
+                                       rhs.data(), m, n, k,
+                                       /*transpose_lhs=*/0,
+                                       /*transpose_rhs=*/0);
+  EXPECT_EQ(out, expected);
+}
+
+TEST_F(CpuRuntimeTest, EigenMatMulS8S32) {
+  // A dot product of length 64 with values that overflow S8 accumulation.
+  constexpr int64_t m = 1, k = 64, n = 1;
+  std::vector<int8_t> lhs(k, 127);
+  std::vector<int8_t> rhs(k, -128);
+  std::vector<int32_t> expected = {64 * 127 * -128};
+
+  std::vector<int32_t> out(m * n);
+  __xla_cpu_runtime_EigenSingleThreadedMatMulS8S32(
+      nullptr, out.data(), lhs.data(), rhs.data(), m, n, k,
+      /*transpose_lhs=*/0, /*transpose_rhs=*/0);
+  EXPECT_EQ(out, expected);
+
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 2);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  out[0] = 0;
+  __xla_cpu_runtime_EigenMatMulS8S32(&run_options, out.data(), lhs.data(),
+                                     rhs.data(), m, n, k,
+                                     /*transpose_lhs=*/0, /*transpose_rhs=*/0);
+  EXPECT_EQ(out, expected);
+}
+
 TEST_F(CpuRuntimeTest, SuccessStatus) {
   XlaCustomCallStatus success_status;
   // Success is the default state.
@@ -41,6 +41,7 @@ limitations under the License.
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/Casting.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
@@ -64,6 +65,7 @@ limitations under the License.
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 
@@ -161,6 +163,16 @@ bool CanEmitTiledLlvmIrGemm(
   return true;
 }
 
+// Returns true if there is a mixed precision Eigen runtime kernel for the
+// element types of `dot_info`.
+bool HasLowPrecisionGemmKernel(const DotInfo& dot_info) {
+  PrimitiveType lhs_type = dot_info.lhs_shape.element_type();
+  PrimitiveType rhs_type = dot_info.rhs_shape.element_type();
+  PrimitiveType result_type = dot_info.result_shape.element_type();
+  return lhs_type == rhs_type && ((lhs_type == BF16 && result_type == F32) ||
+                                  (lhs_type == S8 && result_type == S32));
+}
+
 // Returns dot implementation strategy for non-batch dot operations.
 DotImplementationStrategy GetNonBatchDotImplementationStrategy(
     const HloModuleConfig& config, const DotInfo& dot_info,
@@ -173,6 +185,18 @@ DotImplementationStrategy GetNonBatchDotImplementationStrategy(
          dot_info.dim_nums.rhs_batch_dimensions_size() == 0)
       << "Dot operations must be non-batch";
 
+  // Dots with low precision operands and a wider result are only kept by
+  // DotSupportsLowPrecisionOperands for GEMMs that we hand off to the mixed
+  // precision Eigen kernels; the LLVM IR emitters other than the naive loop
+  // assume a single element type.
+  if (dot_info.lhs_shape.element_type() != element_type ||
+      dot_info.rhs_shape.element_type() != element_type) {
+    return IsAlignedGemm(dot_info, target_machine_features) &&
+                   HasLowPrecisionGemmKernel(dot_info)
+               ? DotImplementationStrategy::kEigen
+               : DotImplementationStrategy::kNaiveLlvmIr;
+  }
+
   // Any Matrix-Vector product of floating point or integral type, or
   // a transpose-dot fusion of the same can be lowered to a tiled LLVM
   // IR implementation.
@@ -217,6 +241,7 @@ class DotOpEmitter {
                         const llvm_ir::IrArray& lhs_array,
                         const llvm_ir::IrArray& rhs_array,
                         const llvm_ir::IrArray* addend_array,
+                        const llvm_ir::ElementGenerator* epilogue,
                         llvm::Value* executable_run_options_value,
                         llvm::IRBuilder<>* b,
                         const HloModuleConfig& hlo_module_config,
@@ -279,29 +304,65 @@ class DotOpEmitter {
   void EmitTiledLlvmIrGemv();
 
   // Lowers the dot operation as a tiled Matrix*Matrix loop.
-  void EmitTiledLlvmIrGemm();
+  absl::Status EmitTiledLlvmIrGemm();
+
+  // Emits the epilogue for the [`tile_size_m`, `tile_size_n`] tile of the
+  // result starting at {`m_start`, `n_start`}. If `transposed` is true, the
+  // tile coordinates are in the transposed result matrix.
+  absl::Status EmitEpilogueForTile(llvm::Value* m_start, int64_t tile_size_m,
+                                   llvm::Value* n_start, int64_t tile_size_n,
+                                   bool transposed);
 
   // Lowers the dot operation as a naive nested loop that computes the result
   // one element at a time.
   void EmitNaiveLlvmIrGemm();
 
+  // Returns the number of vector registers of the target we are compiling for.
+  int64_t GetVectorRegisterCount() const {
+    return target_machine_features_.vector_register_count(
+        *b_->GetInsertBlock()->getParent());
+  }
+
   // When doing a tiled GEMV in LLVM IR, a "tile" consists of this many vector
   // registers.
-  int64_t GetGemvTilingFactor() const {
+  int64_t GetGemvTilingFactor(bool is_row_major) const {
+    if (auto tiling_factor =
+            options::LlvmIrGemvTilingFactor(hlo_module_config_)) {
+      return *tiling_factor;
+    }
+
+    // Row major GEMV keeps one accumulator register per row of the tile, and
+    // with 32 vector registers (AVX-512 on x86, NEON on AArch64) we can keep
+    // twice as many rows in registers without spilling.
     const int64_t kDefaultTilingFactor = 8;
-    return options::LlvmIrGemvTilingFactor(hlo_module_config_)
-        .value_or(kDefaultTilingFactor);
+    const int64_t kLargeRegisterFileTilingFactor = 16;
+    return is_row_major && GetVectorRegisterCount() >= 32
+               ? kLargeRegisterFileTilingFactor
+               : kDefaultTilingFactor;
   }
 
   std::tuple<int64_t, int64_t, int64_t> GetGemmTileSize() const {
+    if (auto tile_size = options::LlvmIrGemmTileSize(hlo_module_config_)) {
+      return *tile_size;
+    }
+
+    // With 32 vector registers (AVX-512 on x86, NEON on AArch64) we emit a
+    // register blocked micro-kernel: a [tile_size_m, 2 vectors] block of the
+    // result stays in registers, and for every k we load 2 vectors of the RHS
+    // and broadcast one element of the LHS for each row. With 32 registers
+    // this gives the classic 14x2 vectors micro-kernel.
+    if (int64_t num_registers = GetVectorRegisterCount(); num_registers >= 32) {
+      const int64_t kVectorCount = 2;
+      int64_t tile_size_m = (num_registers - kVectorCount - 1) / kVectorCount;
+      return std::tuple<int64_t, int64_t, int64_t>(tile_size_m, 1,
+                                                   kVectorCount);
+    }
+
     // Tuned for broadwell - Intel(R) Xeon(R) CPU E5-2690 v4 @ 2.60GHz
     //
     // TODO(b/80093688): Tune for other architectures and centralize this
     // information in one place.
-    const std::tuple<int64_t, int64_t, int64_t> kDefaultTileSize =
-        std::tuple<int64_t, int64_t, int64_t>(11, 9, 1);
-    return options::LlvmIrGemmTileSize(hlo_module_config_)
-        .value_or(kDefaultTileSize);
+    return std::tuple<int64_t, int64_t, int64_t>(11, 9, 1);
   }
 
   DotInfo dot_info_;
@@ -310,6 +371,7 @@ class DotOpEmitter {
   const llvm_ir::IrArray& lhs_array_;
   const llvm_ir::IrArray& rhs_array_;
   const llvm_ir::IrArray* addend_array_;
+  const llvm_ir::ElementGenerator* epilogue_;
   llvm::Value* executable_run_options_value_;
   llvm::IRBuilder<>* b_;
   const HloModuleConfig& hlo_module_config_;
@@ -323,6 +385,7 @@ DotOpEmitter::DotOpEmitter(DotInfo dot_info, std::string dot_hlo_name,
                            const llvm_ir::IrArray& lhs_array,
                            const llvm_ir::IrArray& rhs_array,
                            const llvm_ir::IrArray* addend_array,
+                           const llvm_ir::ElementGenerator* epilogue,
                            llvm::Value* executable_run_options_value,
                            llvm::IRBuilder<>* b,
                            const HloModuleConfig& hlo_module_config,
@@ -334,13 +397,14 @@ DotOpEmitter::DotOpEmitter(DotInfo dot_info, std::string dot_hlo_name,
       lhs_array_(lhs_array),
       rhs_array_(rhs_array),
       addend_array_(addend_array),
+      epilogue_(epilogue),
       executable_run_options_value_(executable_run_options_value),
       b_(b),
       hlo_module_config_(hlo_module_config),
       target_machine_features_(target_machine_features),
       allow_runtime_calls_(allow_runtime_calls) {}
 
-void DotOpEmitter::EmitTiledLlvmIrGemm() {
+absl::Status DotOpEmitter::EmitTiledLlvmIrGemm() {
   PrimitiveType primitive_type = dot_info_.result_shape.element_type();
   MatMultDims mat_mult_dims = GetMatMultDims();
 
@@ -369,6 +433,20 @@ void DotOpEmitter::EmitTiledLlvmIrGemm() {
   std::tie(tile_size_m, tile_size_k, tile_size_n_in_vector_width) =
       GetGemmTileSize();
 
+  // Run the epilogue for every result tile once it is fully computed. We
+  // remember the first error and skip emitting epilogues for remaining tiles.
+  absl::Status epilogue_status;
+  GemmTileEpilogue tile_epilogue;
+  if (epilogue_) {
+    tile_epilogue = [&, transposed = mat_mult_dims.lhs_column_major](
+                        llvm::Value* m_start, int64_t tile_size_m,
+                        llvm::Value* n_start, int64_t tile_size_n) {
+      if (!epilogue_status.ok()) return;
+      epilogue_status = EmitEpilogueForTile(m_start, tile_size_m, n_start,
+                                            tile_size_n, transposed);
+    };
+  }
+
   EmitSmallGemm(
       /*scalar_type=*/primitive_type,
       /*m=*/m, /*k=*/k, /*n=*/n,
@@ -376,7 +454,36 @@ void DotOpEmitter::EmitTiledLlvmIrGemm() {
       /*max_vector_count=*/tile_size_n_in_vector_width,
       /*min_vectorization_width=*/std::min<int64_t>(4, max_target_vector_width),
       /*tile_size_m=*/tile_size_m, /*tile_size_k=*/tile_size_k, /*lhs=*/lhs,
-      /*rhs=*/rhs, /*result=*/target, b_, hlo_module_config_);
+      /*rhs=*/rhs, /*result=*/target, b_, hlo_module_config_,
+      std::move(tile_epilogue));
+
+  return epilogue_status;
+}
+
+absl::Status DotOpEmitter::EmitEpilogueForTile(llvm::Value* m_start,
+                                               int64_t tile_size_m,
+                                               llvm::Value* n_start,
+                                               int64_t tile_size_n,
+                                               bool transposed) {
+  KernelSupportLibrary ksl(b_);
+  return ksl.ForWithStatus(
+      "epilogue.m", /*start=*/0, /*end=*/tile_size_m, /*step=*/1,
+      [&](llvm::Value* m_i) {
+        llvm::Value* row = b_->CreateAdd(m_start, m_i);
+        return ksl.ForWithStatus(
+            "epilogue.n", /*start=*/0, /*end=*/tile_size_n, /*step=*/1,
+            [&](llvm::Value* n_i) -> absl::Status {
+              llvm::Value* col = b_->CreateAdd(n_start, n_i);
+              std::vector<llvm::Value*> multidim =
+                  transposed ? std::vector<llvm::Value*>{col, row}
+                             : std::vector<llvm::Value*>{row, col};
+              llvm_ir::IrArray::Index index(multidim, target_array_.GetShape(),
+                                            b_->getInt64Ty());
+              TF_ASSIGN_OR_RETURN(llvm::Value * value, (*epilogue_)(index));
+              target_array_.EmitWriteArrayElement(index, value, b_);
+              return absl::OkStatus();
+            });
+      });
 }
 
 void DotOpEmitter::EmitTiledLlvmIrGemv() {
@@ -449,7 +556,8 @@ void DotOpEmitter::EmitTiledLlvmIrGemv() {
 
   CHECK(is_column_major_matrix_vector_gemv || is_row_major_matrix_vector_gemv);
 
-  int64_t tiling_factor = GetGemvTilingFactor();
+  int64_t tiling_factor =
+      GetGemvTilingFactor(/*is_row_major=*/is_row_major_matrix_vector_gemv);
   CHECK_GT(tiling_factor, 0);
 
   llvm::Value* result_op = target_array_.GetBasePointer();
@@ -537,8 +645,7 @@ absl::Status DotOpEmitter::Emit() {
       return absl::OkStatus();
 
     case DotImplementationStrategy::kTiledLlvmIrGemm:
-      EmitTiledLlvmIrGemm();
-      return absl::OkStatus();
+      return EmitTiledLlvmIrGemm();
 
     case DotImplementationStrategy::kEigen:
       return EmitCallToRuntime();
@@ -658,6 +765,20 @@ void DotOpEmitter::EmitNaiveLlvmIrGemm() {
   llvm::Value* lhs_element = lhs_array_.EmitReadArrayElement(lhs_index, b_);
   llvm::Value* rhs_element = rhs_array_.EmitReadArrayElement(rhs_index, b_);
 
+  // Low precision operands are accumulated in the (wider) result type.
+  auto upcast_to_accum_type = [&](llvm::Value* element,
+                                  PrimitiveType element_type) {
+    if (element->getType() == accum_type) return element;
+    return primitive_util::IsFloatingPointType(element_type)
+               ? b_->CreateFPExt(element, accum_type)
+               : b_->CreateIntCast(
+                     element, accum_type,
+                     primitive_util::IsSignedIntegralType(element_type));
+  };
+  lhs_element = upcast_to_accum_type(lhs_element, lhs_shape.element_type());
+  rhs_element =
+      upcast_to_accum_type(rhs_element, rhs_array_.GetShape().element_type());
+
   llvm::Value* accum = b_->CreateLoad(accum_type, accum_address);
   llvm::Value* updated_accum;
   if (ShapeUtil::ElementIsComplex(lhs_shape)) {
@@ -769,51 +890,70 @@ absl::Status DotOpEmitter::EmitCallToRuntime() {
   bool multi_threaded = ShouldUseMultiThreadedEigen(hlo_module_config_);
   bool use_acl = hlo_module_config_.debug_options().xla_cpu_use_acl();
   PrimitiveType type = target_array_.GetShape().element_type();
+  PrimitiveType operand_type = lhs_array_.GetShape().element_type();
   llvm::Function* function = b_->GetInsertBlock()->getParent();
   llvm::Module* module = function->getParent();
   llvm::Type* float_type;
   const char* fn_name;
-  switch (type) {
-    case F16:
-      fn_name = multi_threaded
-                    ? runtime::kEigenMatMulF16SymbolName
-                    : runtime::kEigenSingleThreadedMatMulF16SymbolName;
-      float_type = b_->getHalfTy();
-      break;
-    case F32:
-      fn_name = multi_threaded
-                    ? (use_acl ? runtime::kACLMatMulF32SymbolName
-                               : runtime::kEigenMatMulF32SymbolName)
-                    : runtime::kEigenSingleThreadedMatMulF32SymbolName;
-      float_type = b_->getFloatTy();
-      break;
-    case F64:
-      fn_name = multi_threaded
-                    ? runtime::kEigenMatMulF64SymbolName
-                    : runtime::kEigenSingleThreadedMatMulF64SymbolName;
-      float_type = b_->getDoubleTy();
-      break;
-    case C64:
+  if (operand_type != type) {
+    // Mixed precision GEMM, see `HasLowPrecisionGemmKernel`.
+    if (operand_type == BF16 && type == F32) {
       fn_name = multi_threaded
-                    ? runtime::kEigenMatMulC64SymbolName
-                    : runtime::kEigenSingleThreadedMatMulC64SymbolName;
-      float_type = llvm_ir::PrimitiveTypeToIrType(C64, module);
-      break;
-    case C128:
-      fn_name = multi_threaded
-                    ? runtime::kEigenMatMulC128SymbolName
-                    : runtime::kEigenSingleThreadedMatMulC128SymbolName;
-      float_type = llvm_ir::PrimitiveTypeToIrType(C128, module);
-      break;
-    case S32:
+                    ? runtime::kEigenMatMulBF16F32SymbolName
+                    : runtime::kEigenSingleThreadedMatMulBF16F32SymbolName;
+    } else if (operand_type == S8 && type == S32) {
       fn_name = multi_threaded
-                    ? runtime::kEigenMatMulS32SymbolName
-                    : runtime::kEigenSingleThreadedMatMulS32SymbolName;
-      float_type = b_->getInt32Ty();
-      break;
-    default:
-      return Unimplemented("Invalid type %s for dot operation",
+                    ? runtime::kEigenMatMulS8S32SymbolName
+                    : runtime::kEigenSingleThreadedMatMulS8S32SymbolName;
+    } else {
+      return Unimplemented("Invalid types %s x %s -> %s for dot operation",
+                           PrimitiveType_Name(operand_type),
+                           PrimitiveType_Name(operand_type),
                            PrimitiveType_Name(type));
+    }
+  } else {
+    switch (type) {
+      case F16:
+        fn_name = multi_threaded
+                      ? runtime::kEigenMatMulF16SymbolName
+                      : runtime::kEigenSingleThreadedMatMulF16SymbolName;
+        float_type = b_->getHalfTy();
+        break;
+      case F32:
+        fn_name = multi_threaded
+                      ? (use_acl ? runtime::kACLMatMulF32SymbolName
+                                 : runtime::kEigenMatMulF32SymbolName)
+                      : runtime::kEigenSingleThreadedMatMulF32SymbolName;
+        float_type = b_->getFloatTy();
+        break;
+      case F64:
+        fn_name = multi_threaded
+                      ? runtime::kEigenMatMulF64SymbolName
+                      : runtime::kEigenSingleThreadedMatMulF64SymbolName;
+        float_type = b_->getDoubleTy();
+        break;
+      case C64:
+        fn_name = multi_threaded
+                      ? runtime::kEigenMatMulC64SymbolName
+                      : runtime::kEigenSingleThreadedMatMulC64SymbolName;
+        float_type = llvm_ir::PrimitiveTypeToIrType(C64, module);
+        break;
+      case C128:
+        fn_name = multi_threaded
+                      ? runtime::kEigenMatMulC128SymbolName
+                      : runtime::kEigenSingleThreadedMatMulC128SymbolName;
+        float_type = llvm_ir::PrimitiveTypeToIrType(C128, module);
+        break;
+      case S32:
+        fn_name = multi_threaded
+                      ? runtime::kEigenMatMulS32SymbolName
+                      : runtime::kEigenSingleThreadedMatMulS32SymbolName;
+        float_type = b_->getInt32Ty();
+        break;
+      default:
+        return Unimplemented("Invalid type %s for dot operation",
+                             PrimitiveType_Name(type));
+    }
   }
 
   llvm::Type* ptr_type = b_->getPtrTy();
@@ -1070,6 +1210,7 @@ absl::Status EmitNonBatchDotOperation(
     DotInfo dot_info, std::string hlo_name,
     const llvm_ir::IrArray& target_array, const llvm_ir::IrArray& lhs_array,
     const llvm_ir::IrArray& rhs_array, const llvm_ir::IrArray* addend_array,
+    const llvm_ir::ElementGenerator* epilogue,
     llvm::Value* executable_run_options_value, llvm::IRBuilder<>* b,
     const HloModuleConfig& hlo_module_config,
     const TargetMachineFeatures& target_machine_features,
@@ -1081,8 +1222,9 @@ absl::Status EmitNonBatchDotOperation(
                C64 == type || C128 == type);
   DotOpEmitter dot_emitter(std::move(dot_info), std::move(hlo_name),
                            target_array, lhs_array, rhs_array, addend_array,
-                           executable_run_options_value, b, hlo_module_config,
-                           target_machine_features, allow_runtime_calls);
+                           epilogue, executable_run_options_value, b,
+                           hlo_module_config, target_machine_features,
+                           allow_runtime_calls);
   return dot_emitter.Emit();
 }
 
@@ -1226,8 +1368,9 @@ absl::Status EmitBatchDotOperation(
           b, hlo_module_config, target_machine_features, dot_info)) {
     DotOpEmitter dot_emitter(dot_info, std::string(dot.name()), target_array,
                              lhs_array, rhs_array, nullptr /*addend_array*/,
-                             executable_run_options_value, b, hlo_module_config,
-                             target_machine_features, allow_runtime_calls);
+                             nullptr /*epilogue*/, executable_run_options_value,
+                             b, hlo_module_config, target_machine_features,
+                             allow_runtime_calls);
 
     return dot_emitter.EmitBatch();
   } else {
@@ -1287,8 +1430,9 @@ absl::Status EmitBatchDotOperation(
           // Emit the inner non-batch dot operation.
           return EmitNonBatchDotOperation(
               dot_info, std::string(dot.name()), target_slice, lhs_slice,
-              rhs_slice, nullptr, executable_run_options_value, b,
-              hlo_module_config, target_machine_features, allow_runtime_calls);
+              rhs_slice, /*addend_array=*/nullptr, /*epilogue=*/nullptr,
+              executable_run_options_value, b, hlo_module_config,
+              target_machine_features, allow_runtime_calls);
         });
   }
 }
@@ -1343,6 +1487,54 @@ DotImplementationStrategy GetDotImplementationStrategy(
       target_machine_features);
 }
 
+bool DotSupportsLowPrecisionOperands(
+    const HloModuleConfig& config, const HloInstruction& dot,
+    const TargetMachineFeatures& target_machine_features) {
+  if (dot.opcode() != HloOpcode::kDot || IsBatchDot(dot)) {
+    return false;
+  }
+
+  PrimitiveType operand_type = dot.operand(0)->shape().element_type();
+  if (dot.operand(1)->shape().element_type() != operand_type) {
+    return false;
+  }
+
+  PrimitiveType accum_type;
+  switch (operand_type) {
+    case BF16:
+      accum_type = F32;
+      break;
+    case S8:
+      accum_type = S32;
+      break;
+    default:
+      return false;
+  }
+
+  // A BF16 result is fine, FloatNormalization will compute it in F32 and
+  // convert it back.
+  PrimitiveType result_type = dot.shape().element_type();
+  if (result_type != accum_type &&
+      !(operand_type == BF16 && result_type == BF16)) {
+    return false;
+  }
+
+  if (!target_machine_features.has_low_precision_dot(operand_type)) {
+    return false;
+  }
+
+  // Keep low precision operands only for dots that we would otherwise lower to
+  // an Eigen GEMM. Small dots are compute bound and are better served by the
+  // tiled LLVM IR emitters.
+  DotInfo dot_info(dot);
+  dot_info.lhs_shape.set_element_type(accum_type);
+  dot_info.rhs_shape.set_element_type(accum_type);
+  dot_info.result_shape.set_element_type(accum_type);
+  return GetNonBatchDotImplementationStrategy(config, dot_info,
+                                              target_machine_features) ==
+         DotImplementationStrategy::kEigen;
+}
+
 bool DotImplementationCanHandleTranspose(
     const HloInstruction& dot_instr,
     const TargetMachineFeatures& target_machine_features) {
@@ -1403,8 +1595,59 @@ absl::Status EmitDotOperation(
 
   return EmitNonBatchDotOperation(
       DotInfo(dot), std::string(dot.name()), target_array, lhs_array, rhs_array,
-      addend_array, executable_run_options_value, b, hlo_module_config,
-      target_machine_features, allow_runtime_calls);
+      addend_array, /*epilogue=*/nullptr, executable_run_options_value, b,
+      hlo_module_config, target_machine_features, allow_runtime_calls);
+}
+
+bool DotImplementationCanFuseEpilogue(
+    const HloInstruction& dot,
+    const TargetMachineFeatures& target_machine_features) {
+  if (dot.opcode() != HloOpcode::kDot || IsBatchDot(dot) ||
+      dot.shape().rank() != 2) {
+    return false;
+  }
+
+  DotImplementationStrategy impl_strategy =
+      GetNonBatchDotImplementationStrategy(dot.GetModule()->config(),
+                                           DotInfo(dot),
+                                           target_machine_features);
+  return impl_strategy == DotImplementationStrategy::kTiledLlvmIrGemm;
+}
+
+const HloInstruction* FindDotWithEpilogue(
+    const HloInstruction& fusion,
+    const TargetMachineFeatures& target_machine_features) {
+  if (!fusion.IsOutputFusion()) return nullptr;
+
+  const HloInstruction* dot = nullptr;
+  for (const HloInstruction* instr :
+       fusion.fused_instructions_computation()->instructions()) {
+    if (instr->opcode() != HloOpcode::kDot) continue;
+    if (dot != nullptr) return nullptr;
+    dot = instr;
+  }
+
+  if (dot == nullptr ||
+      !DotImplementationCanFuseEpilogue(*dot, target_machine_features)) {
+    return nullptr;
+  }
+  return dot;
+}
+
+absl::Status EmitDotOperationWithEpilogue(
+    const HloInstruction& dot, const llvm_ir::IrArray& target_array,
+    const llvm_ir::IrArray& lhs_array, const llvm_ir::IrArray& rhs_array,
+    const llvm_ir::ElementGenerator& epilogue, llvm::IRBuilder<>* b,
+    const HloModuleConfig& hlo_module_config,
+    const TargetMachineFeatures& target_machine_features) {
+  TF_RET_CHECK(DotImplementationCanFuseEpilogue(dot, target_machine_features))
+      << "Dot does not support fused epilogue: " << dot.ToString();
+
+  return EmitNonBatchDotOperation(
+      DotInfo(dot), std::string(dot.name()), target_array, lhs_array, rhs_array,
+      /*addend_array=*/nullptr, &epilogue,
+      /*executable_run_options_value=*/nullptr, b, hlo_module_config,
+      target_machine_features, /*allow_runtime_calls=*/false);
 }
 
 }  // namespace cpu
@@ -27,6 +27,7 @@ limitations under the License.
 #include "xla/service/cpu/target_machine_features.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/service/llvm_ir/ir_array.h"
+#include "xla/service/llvm_ir/loop_emitter.h"
 #include "xla/shape.h"
 #include "tsl/platform/logging.h"
 
@@ -47,8 +48,9 @@ enum class DotImplementationStrategy {
   kTiledLlvmIrGemv,
 
   // The dot operation is lowered into LLVM IR that implements a tiled
-  // Matrix*Matrix operation.  No fusions are supported.  The two inputs
-  // and the output have to be row major.
+  // Matrix*Matrix operation.  This strategy also allows fusing in an
+  // elementwise epilogue (e.g. bias add and activation) applied to every result
+  // tile.  The two inputs and the output have to be row major.
   kTiledLlvmIrGemm,
 
   // The dot operation is lowered into a call into an Eigen routine.  No fusions
@@ -94,6 +96,15 @@ DotImplementationStrategy GetDotImplementationStrategy(
     const HloModuleConfig& config, const HloInstruction& instr,
     const TargetMachineFeatures& target_machine_features);
 
+// Returns true if `dot` can read its BF16 (or S8) operands directly and
+// accumulate in F32 (or S32), instead of having them upcast by
+// FloatNormalization (or OperandUpcaster). We only do this for dots that would
+// otherwise be lowered to an Eigen GEMM, when the target has native low
+// precision dot instructions.
+bool DotSupportsLowPrecisionOperands(
+    const HloModuleConfig& config, const HloInstruction& dot,
+    const TargetMachineFeatures& target_machine_features);
+
 // Returns true if the two operands and the output of `dot_instr` must have row
 // major layout.
 bool DotOperandsAndResultMustHaveRowMajorLayout(
@@ -133,6 +144,32 @@ absl::Status EmitDotOperation(
     const TargetMachineFeatures& target_machine_features,
     bool allow_runtime_calls = true);
 
+// Returns true if the lowering strategy for `dot` can fuse an elementwise
+// epilogue into the dot kernel (see `EmitDotOperationWithEpilogue`).
+bool DotImplementationCanFuseEpilogue(
+    const HloInstruction& dot,
+    const TargetMachineFeatures& target_machine_features);
+
+// Returns the dot instruction of the `fusion` if it is an output fusion of a
+// dot with an elementwise epilogue, otherwise returns nullptr.
+const HloInstruction* FindDotWithEpilogue(
+    const HloInstruction& fusion,
+    const TargetMachineFeatures& target_machine_features);
+
+// Emit LLVM IR to perform the dot operation on lhs_array and rhs_array followed
+// by an elementwise `epilogue`, and place the result in target_array.
+//
+// The epilogue is emitted for every tile of the result right after the tile is
+// computed, while it is still in L1. When the epilogue is called for an index,
+// target_array holds the dot result at that index, and the epilogue value is
+// written back to the same index.
+absl::Status EmitDotOperationWithEpilogue(
+    const HloInstruction& dot, const llvm_ir::IrArray& target_array,
+    const llvm_ir::IrArray& lhs_array, const llvm_ir::IrArray& rhs_array,
+    const llvm_ir::ElementGenerator& epilogue, llvm::IRBuilder<>* b,
+    const HloModuleConfig& hlo_module_config,
+    const TargetMachineFeatures& target_machine_features);
+
 }  // namespace xla::cpu
 
 #endif  // XLA_SERVICE_CPU_DOT_OP_EMITTER_H_
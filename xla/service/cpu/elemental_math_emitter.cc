@@ -19,13 +19,34 @@ limitations under the License.
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "llvm/IR/CallingConv.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/Value.h"
 #include "llvm/Support/Casting.h"
+#include "xla/service/llvm_ir/llvm_util.h"
 #include "xla/service/llvm_ir/math_ops.h"
 
 namespace xla::cpu {
+namespace {
+
+// Emits a call to a unary floating point intrinsic, upcasting F16 to F32.
+llvm::Value* EmitUnaryIntrinsic(llvm::IRBuilder<>& b, PrimitiveType prim_type,
+                                llvm::Intrinsic::ID intrinsic,
+                                llvm::Value* value,
+                                absl::string_view name = "") {
+  if (prim_type == F16) {
+    llvm::Value* x = b.CreateFPCast(value, b.getFloatTy());
+    llvm::Value* result =
+        llvm_ir::EmitCallToIntrinsic(intrinsic, {x}, {x->getType()}, &b, name);
+    return b.CreateFPCast(result, value->getType());
+  }
+  return llvm_ir::EmitCallToIntrinsic(intrinsic, {value}, {value->getType()},
+                                      &b, name);
+}
+
+}  // namespace
 
 absl::StatusOr<llvm::Value*> EmitAtan2(llvm::Module* module,
                                        llvm::IRBuilder<>& b,
@@ -130,4 +151,29 @@ absl::StatusOr<llvm::Value*> EmitErf(llvm::Module* module, llvm::IRBuilder<>& b,
   return absl::UnimplementedError("erf");
 }
 
+absl::StatusOr<llvm::Value*> EmitSin(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value) {
+  return EmitUnaryIntrinsic(b, prim_type, llvm::Intrinsic::sin, value);
+}
+
+absl::StatusOr<llvm::Value*> EmitCos(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value) {
+  return EmitUnaryIntrinsic(b, prim_type, llvm::Intrinsic::cos, value);
+}
+
+absl::StatusOr<llvm::Value*> EmitExp(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value,
+                                     absl::string_view name) {
+  return EmitUnaryIntrinsic(b, prim_type, llvm::Intrinsic::exp, value, name);
+}
+
+absl::StatusOr<llvm::Value*> EmitLog(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value) {
+  return EmitUnaryIntrinsic(b, prim_type, llvm::Intrinsic::log, value);
+}
+
 }  // namespace xla::cpu
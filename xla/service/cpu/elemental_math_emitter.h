@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_CPU_ELEMENTAL_MATH_EMITTER_H_
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
@@ -38,6 +39,27 @@ absl::StatusOr<llvm::Value*> EmitErf(llvm::Module* module, llvm::IRBuilder<>& b,
                                      PrimitiveType prim_type,
                                      llvm::Value* value);
 
+// Sin, cos, exp and log are emitted as LLVM intrinsics that get rewritten into
+// vectorized polynomial approximations (see llvm_ir_runtime.h). Those only
+// exist for F32, so F16 values are computed in F32 to stay on the vectorized
+// path instead of ending up as scalar libm calls.
+absl::StatusOr<llvm::Value*> EmitSin(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value);
+
+absl::StatusOr<llvm::Value*> EmitCos(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value);
+
+absl::StatusOr<llvm::Value*> EmitExp(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value,
+                                     absl::string_view name);
+
+absl::StatusOr<llvm::Value*> EmitLog(llvm::IRBuilder<>& b,
+                                     PrimitiveType prim_type,
+                                     llvm::Value* value);
+
 }  // namespace xla::cpu
 
 #endif  // XLA_SERVICE_CPU_ELEMENTAL_MATH_EMITTER_H_
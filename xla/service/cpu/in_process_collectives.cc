@@ -19,12 +19,13 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -38,6 +39,7 @@ limitations under the License.
 #include "xla/service/cpu/collectives_interface.h"
 #include "xla/service/global_device_id.h"
 #include "xla/status_macros.h"
+#include "xla/types.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
@@ -72,24 +74,6 @@ struct AllReduceParticipantData : ParticipantData {
   }
 };
 
-template <typename T>
-T GetInitialValue(ReductionKind reduction_kind) {
-  switch (reduction_kind) {
-    case ReductionKind::SUM:
-      return static_cast<T>(0);
-    case ReductionKind::PRODUCT:
-      return static_cast<T>(1);
-    case ReductionKind::MIN:
-      return std::numeric_limits<T>::has_infinity
-                 ? std::numeric_limits<T>::infinity()
-                 : std::numeric_limits<T>::max();
-    case ReductionKind::MAX:
-      return std::numeric_limits<T>::has_infinity
-                 ? -std::numeric_limits<T>::infinity()
-                 : std::numeric_limits<T>::lowest();
-  }
-}
-
 // We cannot use static_assert(false), because the C++ standard (prior to
 // CWG2518) does not allow the statement discarded by a constexpr if to
 // be ill-formed for every possible specialization.
@@ -97,35 +81,89 @@ T GetInitialValue(ReductionKind reduction_kind) {
 template <ReductionKind>
 constexpr bool always_false_v = false;
 
+// Inputs are reduced one block at a time, so that a block of the output stays
+// in L1 while all inputs are reduced into it.
+constexpr int64_t kReduceBlockBytes = 4096;
+
+// Reduces `input` into `acc`. The pointers never alias, which lets the
+// compiler vectorize the loop.
 template <ReductionKind reduction_kind, typename T>
-void ReduceHelper(absl::Span<T> acc, absl::Span<T const* const> inputs) {
-  // TODO(penporn): make sure this gets vectorized.
-  if constexpr (reduction_kind == ReductionKind::SUM) {
-    for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] += inputs[j][i];
-      }
+void ReduceInto(T* __restrict acc, const T* __restrict input, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    if constexpr (reduction_kind == ReductionKind::SUM) {
+      acc[i] += input[i];
+    } else if constexpr (reduction_kind == ReductionKind::PRODUCT) {
+      acc[i] *= input[i];
+    } else if constexpr (reduction_kind == ReductionKind::MIN) {
+      acc[i] = std::min(acc[i], input[i]);
+    } else if constexpr (reduction_kind == ReductionKind::MAX) {
+      acc[i] = std::max(acc[i], input[i]);
+    } else {
+      static_assert(always_false_v<reduction_kind>,
+                    "Unsupported reduction kind");
     }
-  } else if constexpr (reduction_kind == ReductionKind::PRODUCT) {
-    for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] *= inputs[j][i];
-      }
+  }
+}
+
+// Reduces `inputs` into `output`, which may alias one of the inputs.
+template <ReductionKind reduction_kind, typename T>
+void ReduceHelper(absl::Span<T const* const> inputs, T* output,
+                  int64_t num_elems) {
+  constexpr int64_t kBlockElems =
+      std::max<int64_t>(1, kReduceBlockBytes / sizeof(T));
+
+  // Accumulate into the input that aliases the output, if any, so that it is
+  // never overwritten before it is read.
+  auto aliased = absl::c_find(inputs, output);
+  size_t first = aliased == inputs.end() ? 0 : aliased - inputs.begin();
+
+  for (int64_t start = 0; start < num_elems; start += kBlockElems) {
+    int64_t n = std::min(kBlockElems, num_elems - start);
+    T* acc = output + start;
+    if (inputs[first] != output) {
+      std::memcpy(acc, inputs[first] + start, n * sizeof(T));
     }
-  } else if constexpr (reduction_kind == ReductionKind::MIN) {
     for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] = std::min(acc[i], inputs[j][i]);
+      if (j != first) {
+        ReduceInto<reduction_kind>(acc, inputs[j] + start, n);
       }
     }
-  } else if constexpr (reduction_kind == ReductionKind::MAX) {
-    for (size_t j = 0; j < inputs.size(); ++j) {
-      for (size_t i = 0; i < acc.size(); ++i) {
-        acc[i] = std::max(acc[i], inputs[j][i]);
+  }
+}
+
+// CPUs have little or no native f16 and bf16 arithmetic, so each block is
+// widened to f32, reduced in f32 and rounded back once. Reading all inputs of
+// a block before writing it also makes aliasing the output harmless.
+template <ReductionKind reduction_kind, typename T>
+void ReduceHalfHelper(absl::Span<T const* const> inputs, T* output,
+                      int64_t num_elems) {
+  constexpr int64_t kBlockElems = kReduceBlockBytes / sizeof(float);
+  float acc[kBlockElems];
+  float widened[kBlockElems];
+
+  for (int64_t start = 0; start < num_elems; start += kBlockElems) {
+    int64_t n = std::min(kBlockElems, num_elems - start);
+    for (int64_t i = 0; i < n; ++i) {
+      acc[i] = static_cast<float>(inputs[0][start + i]);
+    }
+    for (size_t j = 1; j < inputs.size(); ++j) {
+      for (int64_t i = 0; i < n; ++i) {
+        widened[i] = static_cast<float>(inputs[j][start + i]);
       }
+      ReduceInto<reduction_kind>(acc, widened, n);
+    }
+    for (int64_t i = 0; i < n; ++i) {
+      output[start + i] = static_cast<T>(acc[i]);
     }
+  }
+}
+
+template <ReductionKind reduction_kind, typename T>
+void Reduce(absl::Span<T const* const> inputs, T* output, int64_t num_elems) {
+  if constexpr (std::is_same_v<T, half> || std::is_same_v<T, bfloat16>) {
+    ReduceHalfHelper<reduction_kind, T>(inputs, output, num_elems);
   } else {
-    static_assert(always_false_v<reduction_kind>, "Unsupported reduction kind");
+    ReduceHelper<reduction_kind, T>(inputs, output, num_elems);
   }
 }
 
@@ -134,26 +172,19 @@ absl::Status ReduceScatter(ReductionKind reduction_kind,
                            absl::Span<const void* const> inputs, void* output,
                            int64_t num_elems) {
   using T = typename primitive_util::PrimitiveTypeToNative<PT>::type;
-  T initial_value = GetInitialValue<T>(reduction_kind);
-
-  absl::Span<T> out_chunk =
-      absl::MakeSpan(reinterpret_cast<T*>(output), num_elems);
-  for (int64_t i = 0; i < num_elems; ++i) {
-    out_chunk[i] = initial_value;
-  }
-
+  T* out_chunk = reinterpret_cast<T*>(output);
   absl::Span<T const* const> input_chunks(
       reinterpret_cast<T const* const*>(inputs.data()), inputs.size());
   switch (reduction_kind) {
     case ReductionKind::SUM:
-      ReduceHelper<ReductionKind::SUM, T>(out_chunk, input_chunks);
+      Reduce<ReductionKind::SUM, T>(input_chunks, out_chunk, num_elems);
       break;
     case ReductionKind::PRODUCT:
-      ReduceHelper<ReductionKind::PRODUCT, T>(out_chunk, input_chunks);
+      Reduce<ReductionKind::PRODUCT, T>(input_chunks, out_chunk, num_elems);
       break;
     case ReductionKind::MIN:
       if constexpr (!is_complex_v<T>) {
-        ReduceHelper<ReductionKind::MIN, T>(out_chunk, input_chunks);
+        Reduce<ReductionKind::MIN, T>(input_chunks, out_chunk, num_elems);
       } else {
         return absl::InvalidArgumentError(
             "Min reductions not supported for complex types");
@@ -161,7 +192,7 @@ absl::Status ReduceScatter(ReductionKind reduction_kind,
       break;
     case ReductionKind::MAX:
       if constexpr (!is_complex_v<T>) {
-        ReduceHelper<ReductionKind::MAX, T>(out_chunk, input_chunks);
+        Reduce<ReductionKind::MAX, T>(input_chunks, out_chunk, num_elems);
       } else {
         return absl::InvalidArgumentError(
             "Max reductions not supported for complex types");
@@ -245,6 +276,10 @@ class CpuAllReduceRendezvous
         TF_RETURN_IF_ERROR(ReduceScatter<F16>(me.reduction_kind, inputs,
                                               reduce_output, chunk_elems));
         break;
+      case BF16:
+        TF_RETURN_IF_ERROR(ReduceScatter<BF16>(me.reduction_kind, inputs,
+                                               reduce_output, chunk_elems));
+        break;
       case F32:
         TF_RETURN_IF_ERROR(ReduceScatter<F32>(me.reduction_kind, inputs,
                                               reduce_output, chunk_elems));
@@ -481,6 +516,10 @@ class CpuReduceScatterRendezvous
         TF_RETURN_IF_ERROR(ReduceScatter<F16>(
             me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
         break;
+      case BF16:
+        TF_RETURN_IF_ERROR(ReduceScatter<BF16>(
+            me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
+        break;
       case F32:
         TF_RETURN_IF_ERROR(ReduceScatter<F32>(
             me.reduction_kind, inputs, me.destination_buffer, me.chunk_elems));
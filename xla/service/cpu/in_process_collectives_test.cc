@@ -0,0 +1,200 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/in_process_collectives.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
+#include "xla/executable_run_options.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/service/cpu/collectives_interface.h"
+#include "xla/service/global_device_id.h"
+#include "xla/types.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu::runtime {
+namespace {
+
+using ::testing::Each;
+using ::testing::Eq;
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+// Runs `fn` concurrently on `num_participants` ranks of one clique.
+void RunOnAllRanks(
+    int num_participants,
+    std::function<absl::Status(const RendezvousKey&, CollectivesCommunicator&,
+                               int)>
+        fn) {
+  std::vector<GlobalDeviceId> devices;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    devices.push_back(GlobalDeviceId(rank));
+  }
+  RendezvousKey key(RunId(0), devices, num_participants,
+                    RendezvousKey::CollectiveOpKind::kCrossReplica,
+                    /*op_id=*/0);
+  InProcessCollectives collectives;
+
+  std::vector<absl::Status> statuses(num_participants);
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "participants",
+                                        num_participants);
+    for (int rank = 0; rank < num_participants; ++rank) {
+      thread_pool.Schedule([&, rank] {
+        auto communicator = collectives.GetCommunicator(devices, rank);
+        statuses[rank] = communicator.ok()
+                             ? fn(key, **communicator, rank)
+                             : communicator.status();
+      });
+    }
+  }
+  for (const absl::Status& status : statuses) {
+    TF_EXPECT_OK(status);
+  }
+}
+
+TEST(InProcessCollectivesTest, AllReduceSum) {
+  constexpr int kNumParticipants = 4;
+  constexpr size_t kNumElements = 10000;  // Several reduction blocks.
+  std::vector<std::vector<float>> buffers(kNumParticipants);
+  RunOnAllRanks(kNumParticipants, [&](const RendezvousKey& key,
+                                      CollectivesCommunicator& communicator,
+                                      int rank) {
+    // Even ranks reduce in place.
+    std::vector<float> input(kNumElements, rank + 1);
+    buffers[rank].resize(kNumElements, rank + 1);
+    const void* source = rank % 2 == 0 ? buffers[rank].data() : input.data();
+    return communicator.AllReduce(key, ReductionKind::SUM, F32, kNumElements,
+                                  source, buffers[rank].data(), kTimeout);
+  });
+  for (const std::vector<float>& buffer : buffers) {
+    EXPECT_THAT(buffer,
+                Each(Eq(kNumParticipants * (kNumParticipants + 1) / 2)));
+  }
+}
+
+TEST(InProcessCollectivesTest, AllReduceMaxS32) {
+  constexpr int kNumParticipants = 3;
+  constexpr size_t kNumElements = 1001;
+  std::vector<std::vector<int32_t>> outputs(
+      kNumParticipants, std::vector<int32_t>(kNumElements));
+  RunOnAllRanks(kNumParticipants, [&](const RendezvousKey& key,
+                                      CollectivesCommunicator& communicator,
+                                      int rank) {
+    std::vector<int32_t> input(kNumElements, -rank);
+    return communicator.AllReduce(key, ReductionKind::MAX, S32, kNumElements,
+                                  input.data(), outputs[rank].data(),
+                                  kTimeout);
+  });
+  for (const std::vector<int32_t>& output : outputs) {
+    EXPECT_THAT(output, Each(Eq(0)));
+  }
+}
+
+TEST(InProcessCollectivesTest, AllReduceSumBF16) {
+  constexpr int kNumParticipants = 4;
+  constexpr size_t kNumElements = 3000;
+  std::vector<std::vector<bfloat16>> outputs(
+      kNumParticipants, std::vector<bfloat16>(kNumElements));
+  RunOnAllRanks(kNumParticipants, [&](const RendezvousKey& key,
+                                      CollectivesCommunicator& communicator,
+                                      int rank) {
+    std::vector<bfloat16> input(kNumElements,
+                                static_cast<bfloat16>(rank + 1));
+    return communicator.AllReduce(key, ReductionKind::SUM, BF16, kNumElements,
+                                  input.data(), outputs[rank].data(),
+                                  kTimeout);
+  });
+  for (const std::vector<bfloat16>& output : outputs) {
+    EXPECT_THAT(output, Each(Eq(static_cast<bfloat16>(10))));
+  }
+}
+
+TEST(InProcessCollectivesTest, ReduceScatterSumF16) {
+  constexpr int kNumParticipants = 2;
+  constexpr size_t kChunkElems = 2500;
+  std::vector<std::vector<half>> outputs(kNumParticipants,
+                                         std::vector<half>(kChunkElems));
+  RunOnAllRanks(kNumParticipants, [&](const RendezvousKey& key,
+                                      CollectivesCommunicator& communicator,
+                                      int rank) {
+    // Chunk `i` of every rank holds `i + 1`.
+    std::vector<half> input(kChunkElems * kNumParticipants);
+    for (size_t i = 0; i < input.size(); ++i) {
+      input[i] = static_cast<half>(i / kChunkElems + 1);
+    }
+    return communicator.ReduceScatter(key, ReductionKind::SUM, F16,
+                                      kChunkElems, input.data(),
+                                      outputs[rank].data(), kTimeout);
+  });
+  for (int rank = 0; rank < kNumParticipants; ++rank) {
+    EXPECT_THAT(outputs[rank],
+                Each(Eq(static_cast<half>((rank + 1) * kNumParticipants))));
+  }
+}
+
+// Benchmarks an f32 all-reduce of 4MiB across `state.range(0)` participants.
+void BM_AllReduce(::testing::benchmark::State& state) {
+  int num_participants = state.range(0);
+  constexpr size_t kNumElements = 1024 * 1024;
+  std::vector<GlobalDeviceId> devices;
+  for (int rank = 0; rank < num_participants; ++rank) {
+    devices.push_back(GlobalDeviceId(rank));
+  }
+  InProcessCollectives collectives;
+  std::vector<std::vector<float>> inputs(
+      num_participants, std::vector<float>(kNumElements, 1.0f));
+  std::vector<std::vector<float>> outputs(num_participants,
+                                          std::vector<float>(kNumElements));
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "BM_AllReduce",
+                                      num_participants);
+
+  int64_t op_id = 0;
+  for (auto s : state) {
+    RendezvousKey key(RunId(0), devices, num_participants,
+                      RendezvousKey::CollectiveOpKind::kCrossReplica, op_id++);
+    absl::BlockingCounter counter(num_participants);
+    for (int rank = 0; rank < num_participants; ++rank) {
+      thread_pool.Schedule([&, rank] {
+        auto communicator = collectives.GetCommunicator(devices, rank);
+        CHECK_OK(communicator.status());
+        CHECK_OK((*communicator)->AllReduce(
+            key, ReductionKind::SUM, F32, kNumElements, inputs[rank].data(),
+            outputs[rank].data(), kTimeout));
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetBytesProcessed(state.iterations() * kNumElements * sizeof(float));
+}
+
+BENCHMARK(BM_AllReduce)->Arg(2)->Arg(4)->Arg(8);
+
+}  // namespace
+}  // namespace xla::cpu::runtime
@@ -127,6 +127,27 @@ class IrEmitter::CpuElementalIrEmitter : public ElementalIrEmitter {
     return xla::cpu::EmitErf(module(), *b(), prim_type, value);
   }
 
+  absl::StatusOr<llvm::Value*> EmitSin(PrimitiveType prim_type,
+                                       llvm::Value* value) override {
+    return xla::cpu::EmitSin(*b(), prim_type, value);
+  }
+
+  absl::StatusOr<llvm::Value*> EmitCos(PrimitiveType prim_type,
+                                       llvm::Value* value) override {
+    return xla::cpu::EmitCos(*b(), prim_type, value);
+  }
+
+  absl::StatusOr<llvm::Value*> EmitExp(PrimitiveType prim_type,
+                                       llvm::Value* value,
+                                       absl::string_view name) override {
+    return xla::cpu::EmitExp(*b(), prim_type, value, name);
+  }
+
+  absl::StatusOr<llvm::Value*> EmitLog(PrimitiveType prim_type,
+                                       llvm::Value* value) override {
+    return xla::cpu::EmitLog(*b(), prim_type, value);
+  }
+
   absl::StatusOr<std::vector<llvm::Value*>> EmitThreadLocalCall(
       const HloComputation& callee, absl::Span<llvm::Value* const> parameters,
       absl::string_view name, bool is_reducer) override {
@@ -918,10 +939,13 @@ absl::Status IrEmitter::HandleSelectAndScatter(
 absl::Status IrEmitter::HandleDot(HloInstruction* dot) {
   auto lhs = dot->operand(0);
   auto rhs = dot->operand(1);
+  // BF16 operands are only left by FloatNormalization for dots with an F32
+  // result (see DotSupportsLowPrecisionOperands).
   TF_RETURN_IF_ERROR(ElementTypesSameAndSupported(
       /*instruction=*/*dot, /*operands=*/{lhs, rhs},
       /*supported_types=*/
-      {PRED, S8, U8, S16, U16, S32, U32, S64, U64, F16, F32, F64, C64, C128}));
+      {PRED, S8, U8, S16, U16, S32, U32, S64, U64, F16, BF16, F32, F64, C64,
+       C128}));
   const DotDimensionNumbers& dnums = dot->dot_dimension_numbers();
 
   if (dnums.lhs_contracting_dimensions_size() != 1) {
@@ -1247,7 +1271,8 @@ static bool DataTypeIsSupportedByReduceScatter(PrimitiveType datatype) {
   }
 }
 
-absl::Status IrEmitter::HandleAllReduceMultipleReplica(HloInstruction* crs) {
+absl::Status IrEmitter::HandleAllReduceMultipleReplica(HloInstruction* crs,
+                                                       bool is_async) {
   CHECK_GE(crs->operand_count(), 1);
   PrimitiveType datatype = crs->operand(0)->shape().element_type();
   TF_RETURN_IF_ERROR(EmitTargetAddressForOp(crs));
@@ -1302,31 +1327,51 @@ absl::Status IrEmitter::HandleAllReduceMultipleReplica(HloInstruction* crs) {
                       llvm_ir::EncodeSelfDescribingShapeConstant(
                           crs->shape(), &shape_length, &b_));
 
+  // The output of an asynchronous all-reduce is written after the start
+  // returns, so only start it asynchronously if no other instruction can
+  // observe a partially reduced buffer, i.e. it reduces in place.
+  if (is_async) {
+    for (int64_t i = 0; i < crs->operand_count(); ++i) {
+      TF_ASSIGN_OR_RETURN(BufferAllocation::Slice input_slice,
+                          assignment_.GetUniqueSlice(crs->operand(i), {}));
+      TF_ASSIGN_OR_RETURN(
+          BufferAllocation::Slice output_slice,
+          assignment_.GetUniqueSlice(crs, is_tuple ? ShapeIndex({i})
+                                                   : ShapeIndex({})));
+      is_async &= input_slice == output_slice;
+    }
+  }
+
   bool use_global_device_ids =
       Cast<HloAllReduceInstruction>(crs)->use_global_device_ids();
-  EmitCallToFunc(
-      runtime::kAllReduceSymbolName,
-      {/*run_options=*/GetExecutableRunOptionsArgument(),
-       /*replica_groups=*/replica_groups_v,
-       /*replica_groups_size=*/b_.getInt32(replica_groups_size),
-
-       /*channel_id_present=*/
-       b_.getInt32(static_cast<int32_t>(crs->channel_id().has_value())),
-       /*use_global_device_ids=*/
-       b_.getInt32(static_cast<int32_t>(use_global_device_ids)),
-       /*op_id=*/
-       b_.getInt64(crs->channel_id().has_value()
-                       ? *crs->channel_id()
-                       : crs->GetModule()->unique_id()),
-       /*reduction_kind=*/
-       b_.getInt32(
-           static_cast<int32_t>(*MatchReductionComputation(crs->to_apply()))),
-       /*shape_ptr=*/shape_ptr,
-       /*shape_length=*/b_.getInt32(shape_length),
-       /*num_buffers=*/b_.getInt32(crs->operand_count()),
-       /*input_buffers=*/input_buffers,
-       /*output_buffers=*/output_buffers},
-      b_.getVoidTy());
+  std::vector<llvm::Value*> args = {
+      /*run_options=*/GetExecutableRunOptionsArgument(),
+      /*replica_groups=*/replica_groups_v,
+      /*replica_groups_size=*/b_.getInt32(replica_groups_size),
+
+      /*channel_id_present=*/
+      b_.getInt32(static_cast<int32_t>(crs->channel_id().has_value())),
+      /*use_global_device_ids=*/
+      b_.getInt32(static_cast<int32_t>(use_global_device_ids)),
+      /*op_id=*/
+      b_.getInt64(crs->channel_id().has_value()
+                      ? *crs->channel_id()
+                      : crs->GetModule()->unique_id()),
+      /*reduction_kind=*/
+      b_.getInt32(
+          static_cast<int32_t>(*MatchReductionComputation(crs->to_apply()))),
+      /*shape_ptr=*/shape_ptr,
+      /*shape_length=*/b_.getInt32(shape_length),
+      /*num_buffers=*/b_.getInt32(crs->operand_count()),
+      /*input_buffers=*/input_buffers,
+      /*output_buffers=*/output_buffers};
+  if (is_async) {
+    args.push_back(/*async_id=*/b_.getInt64(crs->unique_id()));
+    async_all_reduce_starts_.insert(crs);
+  }
+  EmitCallToFunc(is_async ? runtime::kAllReduceStartSymbolName
+                          : runtime::kAllReduceSymbolName,
+                 args, b_.getVoidTy());
 
   return absl::OkStatus();
 }
@@ -1339,6 +1384,28 @@ absl::Status IrEmitter::HandleAllReduce(HloInstruction* crs) {
   return HandleAllReduceMultipleReplica(crs);
 }
 
+absl::Status IrEmitter::HandleAllReduceStart(HloInstruction* crs) {
+  if (hlo_module_config_.replica_count() == 1 &&
+      hlo_module_config_.num_partitions() == 1) {
+    return HandleAllReduceSingleReplica(crs);
+  }
+  return HandleAllReduceMultipleReplica(crs, /*is_async=*/true);
+}
+
+absl::Status IrEmitter::HandleAllReduceDone(HloInstruction* done) {
+  // The all-reduce-done aliases the output buffer of its all-reduce-start.
+  TF_RETURN_IF_ERROR(EmitTargetAddressForOp(done));
+  const HloInstruction* start = done->operand(0);
+  if (!async_all_reduce_starts_.contains(start)) {
+    return absl::OkStatus();
+  }
+  EmitCallToFunc(runtime::kAllReduceDoneSymbolName,
+                 {/*run_options=*/GetExecutableRunOptionsArgument(),
+                  /*async_id=*/b_.getInt64(start->unique_id())},
+                 b_.getVoidTy());
+  return absl::OkStatus();
+}
+
 absl::Status IrEmitter::HandleReduceScatter(HloInstruction* rs) {
   CHECK_EQ(rs->operand_count(), 1);
   PrimitiveType datatype = rs->operand(0)->shape().element_type();
@@ -1568,6 +1635,17 @@ absl::Status IrEmitter::HandleParameter(HloInstruction* parameter) {
   return EmitTargetAddressForOp(parameter);
 }
 
+// Reductions over major dimensions that read more than this many bytes per
+// vectorized strip of the output are emitted as cache tiles. Ideally this
+// should come from llvm::TargetTransformInfo::getCacheSize, but it is not
+// populated for most targets, so use a typical L1 data cache size.
+static constexpr int64_t kReductionL1CacheSizeInBytes = 32 * 1024;
+
+// Size of the cache tile of the output used as the accumulator. A page sized
+// contiguous row segment keeps the hardware prefetchers busy, and leaves most
+// of L1 to the streamed input.
+static constexpr int64_t kReductionTileSizeInBytes = 4 * 1024;
+
 // Returns true if the relative order of the unreduced dimensions stays the same
 // through the reduce operation.
 static bool ReductionPreservesLayout(const HloInstruction& reduce) {
@@ -1880,6 +1958,96 @@ void IrEmitter::EmitShardedVectorStore(
   }
 }
 
+absl::Status IrEmitter::EmitTiledLoopForVectorizedReduction(
+    const ReductionGenerator& reduction_generator,
+    std::vector<llvm::Value*> output_multi_index, llvm::Value* tile_start,
+    int64_t tile_size, int64_t vectorization_factor, HloInstruction* reduce,
+    HloInstruction* init_value, HloInstruction* arg,
+    absl::Span<const int64_t> dimensions, llvm::Align element_alignment) {
+  int64_t innermost_dimension = LayoutUtil::Minor(reduce->shape().layout(), 0);
+  ShardedVectorType strip_type = CreateShardedVectorType(
+      reduce->shape().element_type(), vectorization_factor);
+  llvm_ir::IrArray target_array = GetIrArrayFor(reduce);
+  llvm_ir::IrArray arg_array(GetIrArrayFor(arg));
+
+  llvm::Value* init_value_ssa =
+      Load(IrShapeType(init_value->shape()), GetEmittedValueFor(init_value));
+  ShardedVector init_vector;
+  init_vector.reserve(strip_type.size());
+  for (llvm::Type* shard_type : strip_type) {
+    if (auto* vector_type = llvm::dyn_cast<llvm::VectorType>(shard_type)) {
+      init_vector.push_back(
+          VectorSplat(vector_type->getElementCount(), init_value_ssa));
+    } else {
+      init_vector.push_back(init_value_ssa);
+    }
+  }
+
+  // The output tile is used as the accumulator, start with the init value.
+  llvm_ir::ForLoopNest init_loop_nest(IrName(reduce, "tile_init"), &b_);
+  std::unique_ptr<llvm_ir::ForLoop> init_loop =
+      init_loop_nest.AddLoop(0, tile_size, vectorization_factor, "strip");
+  SetToFirstInsertPoint(init_loop->GetBodyBasicBlock(), &b_);
+  output_multi_index[innermost_dimension] =
+      Add(tile_start, init_loop->GetIndVarValue());
+  llvm_ir::IrArray::Index init_index(output_multi_index, reduce->shape(),
+                                     b_.getInt64Ty());
+  EmitShardedVectorStore(target_array.EmitArrayElementAddress(init_index, &b_),
+                         init_vector, element_alignment, target_array);
+  SetToFirstInsertPoint(init_loop_nest.GetOuterLoopExitBasicBlock(), &b_);
+
+  // Stream through the reduced rows of the input one tile wide row segment at
+  // a time. The output tile stays resident in L1 while we do this.
+  llvm_ir::ForLoopNest reduction_loop_nest(IrName(arg, "tiled_inner"), &b_);
+  std::vector<llvm::Value*> input_multi_index =
+      reduction_loop_nest.AddLoopsForShapeOnDimensions(arg->shape(), dimensions,
+                                                       "reduction_dim");
+  std::unique_ptr<llvm_ir::ForLoop> strip_loop =
+      reduction_loop_nest.AddLoop(0, tile_size, vectorization_factor, "strip");
+  SetToFirstInsertPoint(strip_loop->GetBodyBasicBlock(), &b_);
+
+  output_multi_index[innermost_dimension] =
+      Add(tile_start, strip_loop->GetIndVarValue());
+  llvm_ir::IrArray::Index output_index(output_multi_index, reduce->shape(),
+                                       b_.getInt64Ty());
+  llvm_ir::IrArray::Index::const_iterator it = output_index.begin();
+  for (auto& i : input_multi_index) {
+    if (i == nullptr) {
+      i = *it++;
+    }
+  }
+  CHECK(output_index.end() == it);
+  llvm_ir::IrArray::Index input_index(input_multi_index, arg->shape(),
+                                      b_.getInt64Ty());
+
+  llvm::Value* input_address =
+      arg_array.EmitArrayElementAddress(input_index, &b_);
+  llvm::Value* output_address =
+      target_array.EmitArrayElementAddress(output_index, &b_);
+
+  for (int i = 0; i < strip_type.size(); i++) {
+    llvm::LoadInst* accumulator =
+        AlignedLoad(strip_type[i], output_address, element_alignment);
+    target_array.AnnotateLoadStoreInstructionWithMetadata(accumulator);
+    llvm::LoadInst* addend =
+        AlignedLoad(strip_type[i], input_address, element_alignment);
+    arg_array.AnnotateLoadStoreInstructionWithMetadata(addend);
+
+    llvm::Value* reduced_result =
+        reduction_generator(&b_, accumulator, addend);
+    target_array.AnnotateLoadStoreInstructionWithMetadata(
+        AlignedStore(reduced_result, output_address, element_alignment));
+
+    if (i != (strip_type.size() - 1)) {
+      input_address = ConstInBoundsGEP1_32(strip_type[i], input_address, 1);
+      output_address = ConstInBoundsGEP1_32(strip_type[i], output_address, 1);
+    }
+  }
+
+  SetToFirstInsertPoint(reduction_loop_nest.GetOuterLoopExitBasicBlock(), &b_);
+  return absl::OkStatus();
+}
+
 absl::StatusOr<bool> IrEmitter::EmitVectorizedReduce(
     HloInstruction* reduce, HloInstruction* arg, HloInstruction* init_value,
     absl::Span<const int64_t> dimensions, HloComputation* function,
@@ -1930,6 +2098,16 @@ absl::StatusOr<bool> IrEmitter::EmitVectorizedReduce(
     return false;
   }
 
+  // Parallel tasks partition the outer dimensions of the output (see
+  // ParallelTaskAssigner). The most minor dimension is strided by the
+  // vectorization factor below and can't be partitioned.
+  const bool emit_parallel_loop = ShouldEmitParallelLoopFor(*reduce);
+  if (emit_parallel_loop &&
+      num_dynamic_loop_bounds_ >= reduce->shape().dimensions_size()) {
+    *failure_reason = "parallel partition of the minor dimension";
+    return false;
+  }
+
   CHECK(!reduce->shape().IsTuple());
   TF_RETURN_IF_ERROR(EmitTargetAddressForOp(reduce));
 
@@ -1952,17 +2130,33 @@ absl::StatusOr<bool> IrEmitter::EmitVectorizedReduce(
   //      output[d1, d0] = vector_acc
   //    }
   //  }
+  //
+  // When the rows touched by one `VS` wide strip don't fit into L1, every
+  // strip misses in cache on every row. In that case the d0 loop is tiled
+  // into cache tiles that use the output as the accumulator, and the input is
+  // streamed through row by row (see EmitTiledLoopForVectorizedReduction).
 
+  std::vector<std::pair<llvm::Value*, llvm::Value*>> dynamic_loop_bounds;
+  if (emit_parallel_loop) {
+    dynamic_loop_bounds = compute_function_->GetDynamicLoopBounds();
+  }
+
+  const int64_t num_dims = reduce->shape().dimensions_size();
   llvm_ir::ForLoopNest loop_nest(IrName(reduce), &b_);
-  std::vector<llvm::Value*> array_multi_index(
-      reduce->shape().dimensions_size());
+  std::vector<llvm::Value*> array_multi_index(num_dims);
   for (int i = LayoutUtil::MinorToMajor(reduce->shape()).size() - 1; i > 0;
        --i) {
     int64_t dimension = LayoutUtil::Minor(reduce->shape().layout(), i);
-    int64_t start_index = 0;
-    int64_t end_index = reduce->shape().dimensions(dimension);
-    std::unique_ptr<llvm_ir::ForLoop> loop = loop_nest.AddLoop(
-        start_index, end_index, absl::StrFormat("dim.%d", dimension));
+    const int bounds_index = num_dims - 1 - i;
+    std::unique_ptr<llvm_ir::ForLoop> loop;
+    if (bounds_index < dynamic_loop_bounds.size()) {
+      loop = loop_nest.AddLoop(absl::StrFormat("dim.%d", dimension),
+                               dynamic_loop_bounds[bounds_index].first,
+                               dynamic_loop_bounds[bounds_index].second);
+    } else {
+      loop = loop_nest.AddLoop(0, reduce->shape().dimensions(dimension),
+                               absl::StrFormat("dim.%d", dimension));
+    }
     array_multi_index[dimension] = loop->GetIndVarValue();
   }
 
@@ -1977,7 +2171,51 @@ absl::StatusOr<bool> IrEmitter::EmitVectorizedReduce(
 
   auto outermost_loop_exit_block = loop_nest.GetOuterLoopExitBasicBlock();
 
-  if (innermost_dimension_size >= vectorization_factor) {
+  int64_t reduction_size = 1;
+  for (int64_t dimension : dimensions) {
+    reduction_size *= arg->shape().dimensions(dimension);
+  }
+  const int64_t element_size =
+      ShapeUtil::ByteSizeOfPrimitiveType(reduce->shape().element_type());
+  const int64_t tile_size =
+      std::max<int64_t>(kReductionTileSizeInBytes / element_size /
+                            vectorization_factor * vectorization_factor,
+                        vectorization_factor);
+  const int64_t vectorized_size =
+      (innermost_dimension_size / vectorization_factor) * vectorization_factor;
+  const bool use_cache_tiles =
+      !dimensions.empty() && vectorized_size >= 2 * vectorization_factor &&
+      reduction_size * vectorization_factor_in_bytes >
+          kReductionL1CacheSizeInBytes;
+
+  if (use_cache_tiles) {
+    int64_t num_full_tiles = vectorized_size / tile_size;
+    if (num_full_tiles > 0) {
+      std::unique_ptr<llvm_ir::ForLoop> loop = loop_nest.AddLoop(
+          0, num_full_tiles * tile_size, tile_size,
+          absl::StrFormat("dim.%d.tile", innermost_dimension));
+      SetToFirstInsertPoint(loop->GetBodyBasicBlock(), &b_);
+      TF_RETURN_IF_ERROR(EmitTiledLoopForVectorizedReduction(
+          reduction_generator, array_multi_index, loop->GetIndVarValue(),
+          tile_size, vectorization_factor, reduce, init_value, arg, dimensions,
+          element_alignment));
+
+      if (auto exit_terminator = loop->GetExitBasicBlock()->getTerminator()) {
+        b_.SetInsertPoint(exit_terminator);
+      } else {
+        b_.SetInsertPoint(loop->GetExitBasicBlock());
+      }
+    }
+
+    // The last, partial cache tile has a static size.
+    if (int64_t last_tile_size = vectorized_size % tile_size) {
+      TF_RETURN_IF_ERROR(EmitTiledLoopForVectorizedReduction(
+          reduction_generator, array_multi_index,
+          b_.getInt64(num_full_tiles * tile_size), last_tile_size,
+          vectorization_factor, reduce, init_value, arg, dimensions,
+          element_alignment));
+    }
+  } else if (innermost_dimension_size >= vectorization_factor) {
     int64_t start_index = 0;
     int64_t end_index = (innermost_dimension_size / vectorization_factor) *
                         vectorization_factor;
@@ -2343,6 +2581,32 @@ absl::Status IrEmitter::HandleFusion(HloInstruction* fusion) {
     TF_ASSIGN_OR_RETURN(auto generator, fused_emitter.GetGenerator(
                                             *fusion->fused_expression_root()));
     return EmitTargetElementLoop(fusion, generator);
+  } else if (const HloInstruction* dot =
+                 FindDotWithEpilogue(*fusion, target_machine_features_)) {
+    VLOG(3) << "HandleFusion kOutput with dot epilogue";
+    TF_RETURN_IF_ERROR(EmitTargetAddressForOp(fusion));
+    llvm_ir::IrArray target_array = GetIrArrayFor(fusion);
+
+    llvm_ir::IrArray lhs_array(
+        GetIrArrayFor(fusion->operand(dot->operand(0)->parameter_number())));
+    llvm_ir::IrArray rhs_array(
+        GetIrArrayFor(fusion->operand(dot->operand(1)->parameter_number())));
+
+    // Dot result is computed in place in the target buffer, and the epilogue
+    // reads it back from the same index.
+    CpuElementalIrEmitter elemental_emitter(hlo_module_config_, this, module_);
+    FusedIrEmitter fused_emitter(elemental_emitter);
+    BindFusionArguments(fusion, &fused_emitter);
+    fused_emitter.BindGenerator(
+        *dot, [&](llvm_ir::IrArray::Index index) {
+          return target_array.EmitReadArrayElement(index, &b_);
+        });
+    TF_ASSIGN_OR_RETURN(auto epilogue, fused_emitter.GetGenerator(*root));
+
+    return EmitDotOperationWithEpilogue(*dot, target_array, lhs_array,
+                                        rhs_array, epilogue, &b_,
+                                        hlo_module_config_,
+                                        target_machine_features_);
   } else if (fusion->IsOutputFusion()) {
     VLOG(3) << "HandleFusion kOutput";
     int64_t dot_op_index =
@@ -2411,7 +2675,8 @@ absl::Status IrEmitter::HandleCall(HloInstruction* call) {
     TF_RETURN_IF_ERROR(EmitCallToParallelForkJoin(
         call_args, root->shape(),
         backend_config_or->outer_dimension_partitions(), &b_, call_ir_function,
-        computation->name()));
+        computation->name(),
+        options::PersistentForkJoinEnabled(hlo_module_config_)));
 
     if (ComputationTransitivelyContainsCustomCall(computation)) {
       EmitEarlyReturnIfErrorStatus();
@@ -2536,7 +2801,24 @@ absl::Status IrEmitter::HandleTopK(HloInstruction* hlo) {
   const HloInstruction* input = hlo->operand(0);
   const int64_t k = hlo->shape().tuple_shapes(0).dimensions().back();
   const bool has_batch = hlo->shape().tuple_shapes(0).dimensions_size() == 2;
-  TF_RET_CHECK(input->shape().element_type() == F32) << hlo->ToString();
+  const char* topk_symbol_name;
+  switch (input->shape().element_type()) {
+    case F32:
+      topk_symbol_name = runtime::kTopKF32SymbolName;
+      break;
+    case BF16:
+      topk_symbol_name = runtime::kTopKBF16SymbolName;
+      break;
+    case F16:
+      topk_symbol_name = runtime::kTopKF16SymbolName;
+      break;
+    case S32:
+      topk_symbol_name = runtime::kTopKS32SymbolName;
+      break;
+    default:
+      return Unimplemented("Unsupported TopK element type: %s",
+                           hlo->ToString());
+  }
   TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(
       hlo->shape().tuple_shapes(0).layout()))
       << hlo->ToString();
@@ -2559,7 +2841,7 @@ absl::Status IrEmitter::HandleTopK(HloInstruction* hlo) {
       EmitBufferPointer(out_values_slice, hlo->shape().tuple_shapes(0));
   llvm::Value* out_indices_ptr =
       EmitBufferPointer(out_indices_slice, hlo->shape().tuple_shapes(1));
-  EmitCallToFunc(runtime::kTopKF32SymbolName,
+  EmitCallToFunc(topk_symbol_name,
                  {b_.getInt64(has_batch ? input->shape().dimensions(0) : 1),
                   b_.getInt64(input->shape().dimensions().back()),
                   b_.getInt64(k), values_ptr, out_values_ptr, out_indices_ptr},
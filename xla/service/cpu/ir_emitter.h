@@ -27,6 +27,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "llvm/IR/Attributes.h"
@@ -179,6 +180,8 @@ class IrEmitter : public DfsHloVisitorWithDefault,
   absl::Status HandleConvolution(HloInstruction* convolution) override;
   absl::Status HandleFft(HloInstruction* fft) override;
   absl::Status HandleAllReduce(HloInstruction* crs) override;
+  absl::Status HandleAllReduceStart(HloInstruction* crs) override;
+  absl::Status HandleAllReduceDone(HloInstruction* done) override;
   absl::Status HandleReduceScatter(HloInstruction* crs) override;
   absl::Status HandleCollectivePermute(HloInstruction* crs) override;
   absl::Status HandleInfeed(HloInstruction* instruction) override;
@@ -228,7 +231,11 @@ class IrEmitter : public DfsHloVisitorWithDefault,
   absl::Status HandlePadToStatic(HloInstruction* hlo);
   absl::Status HandleTopK(HloInstruction* hlo);
   absl::Status HandleAllReduceSingleReplica(HloInstruction* crs);
-  absl::Status HandleAllReduceMultipleReplica(HloInstruction* crs);
+  // If `is_async`, `crs` is an all-reduce-start that is emitted as an
+  // asynchronous call when it reduces in place, and awaited by the matching
+  // all-reduce-done.
+  absl::Status HandleAllReduceMultipleReplica(HloInstruction* crs,
+                                              bool is_async = false);
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
   absl::Status HandleOneDnnMatMulCalls(HloInstruction* hlo,
                                        std::string runtime_symbol_name);
@@ -446,6 +453,18 @@ class IrEmitter : public DfsHloVisitorWithDefault,
       HloInstruction* arg, absl::Span<const int64_t> dimensions,
       llvm::Align element_alignment);
 
+  // Emits a cache tile of a reduction over major dimensions: the output
+  // elements [tile_start, tile_start + tile_size) of the most minor output
+  // dimension are initialized, then every reduced row of the tile is streamed
+  // through and accumulated into the output in `vectorization_factor` wide
+  // strips.  Helper function for EmitVectorizedReduce.
+  absl::Status EmitTiledLoopForVectorizedReduction(
+      const ReductionGenerator& reduction_generator,
+      std::vector<llvm::Value*> output_multi_index, llvm::Value* tile_start,
+      int64_t tile_size, int64_t vectorization_factor,
+      HloInstruction* reduce, HloInstruction* init_value, HloInstruction* arg,
+      absl::Span<const int64_t> dimensions, llvm::Align element_alignment);
+
   // Tries to emit a fast concatenate operation using memcpy.  Returns true if
   // successful, and false on failure.  On failure, sets "failure_reason" to a
   // string describing why it could not emit a fast concatenate.
@@ -573,6 +592,9 @@ class IrEmitter : public DfsHloVisitorWithDefault,
   // Maps HLOs to Values emitted for them.
   absl::flat_hash_map<const HloInstruction*, llvm::Value*> emitted_value_;
 
+  // All-reduce-starts emitted as asynchronous runtime calls.
+  absl::flat_hash_set<const HloInstruction*> async_all_reduce_starts_;
+
   llvm_ir::AliasAnalysis alias_analysis_;
 
   // The number of outer dimensions of the root instruction's shape that
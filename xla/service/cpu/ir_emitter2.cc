@@ -162,6 +162,27 @@ class IrEmitter2::ElementalIrEmitter : public xla::ElementalIrEmitter {
     return xla::cpu::EmitErf(module(), *b(), prim_type, value);
   }
 
+  absl::StatusOr<llvm::Value*> EmitSin(PrimitiveType prim_type,
+                                       llvm::Value* value) override {
+    return xla::cpu::EmitSin(*b(), prim_type, value);
+  }
+
+  absl::StatusOr<llvm::Value*> EmitCos(PrimitiveType prim_type,
+                                       llvm::Value* value) override {
+    return xla::cpu::EmitCos(*b(), prim_type, value);
+  }
+
+  absl::StatusOr<llvm::Value*> EmitExp(PrimitiveType prim_type,
+                                       llvm::Value* value,
+                                       absl::string_view name) override {
+    return xla::cpu::EmitExp(*b(), prim_type, value, name);
+  }
+
+  absl::StatusOr<llvm::Value*> EmitLog(PrimitiveType prim_type,
+                                       llvm::Value* value) override {
+    return xla::cpu::EmitLog(*b(), prim_type, value);
+  }
+
   absl::StatusOr<std::vector<llvm::Value*>> EmitThreadLocalCall(
       const HloComputation& callee, absl::Span<llvm::Value* const> parameters,
       absl::string_view name, bool is_reducer) override {
@@ -362,6 +383,11 @@ absl::StatusOr<IrEmitter2::KernelInfo> IrEmitter2::EmitDotFusionHostKernel(
     const HloFusionInstruction* fusion) {
   VLOG(2) << "Emit dot fusion host kernel: " << fusion->name();
 
+  if (const HloInstruction* dot = FindDotWithEpilogue(
+          *fusion, nested_ir_emitter_->target_machine_features())) {
+    return EmitDotEpilogueFusionHostKernel(fusion, dot);
+  }
+
   // Dot fusion only supports adding a side input to the dot product.
   const HloInstruction* add = fusion->fused_expression_root();
   if (add->opcode() != HloOpcode::kAdd) {
@@ -415,6 +441,52 @@ absl::StatusOr<IrEmitter2::KernelInfo> IrEmitter2::EmitDotFusionHostKernel(
                  se::ThreadDim()});
 }
 
+absl::StatusOr<IrEmitter2::KernelInfo>
+IrEmitter2::EmitDotEpilogueFusionHostKernel(const HloFusionInstruction* fusion,
+                                            const HloInstruction* dot) {
+  VLOG(2) << "Emit dot epilogue fusion host kernel: " << fusion->name();
+
+  KernelPrototype kernel_prototype = EmitKernelPrototype(fusion);
+
+  llvm::IRBuilder<> b(module_->getContext());
+  b.SetInsertPoint(kernel_prototype.function->getEntryBlock().getTerminator());
+
+  llvm_ir::IrArray lhs_array =
+      kernel_prototype.arguments[dot->operand(0)->parameter_number()];
+  llvm_ir::IrArray rhs_array =
+      kernel_prototype.arguments[dot->operand(1)->parameter_number()];
+  llvm_ir::IrArray target_array = kernel_prototype.results[0];
+
+  ElementalIrEmitter elemental_emitter(module_, &b, &hlo_module_,
+                                       nested_ir_emitter_, fast_min_max());
+  FusedIrEmitter fused_emitter(elemental_emitter);
+
+  for (int i = 0; i < fusion->operand_count(); i++) {
+    fused_emitter.BindGenerator(
+        *fusion->fused_parameter(i), [&, i](llvm_ir::IrArray::Index idx) {
+          return kernel_prototype.arguments[i].EmitReadArrayElement(idx, &b);
+        });
+  }
+
+  // Dot result is computed in place in the result buffer, and the epilogue
+  // reads it back from the same index.
+  fused_emitter.BindGenerator(*dot, [&](llvm_ir::IrArray::Index idx) {
+    return target_array.EmitReadArrayElement(idx, &b);
+  });
+
+  TF_ASSIGN_OR_RETURN(
+      auto epilogue,
+      fused_emitter.GetGenerator(*fusion->fused_expression_root()));
+
+  TF_RETURN_IF_ERROR(EmitDotOperationWithEpilogue(
+      *dot, target_array, lhs_array, rhs_array, epilogue, &b,
+      hlo_module_.config(), nested_ir_emitter_->target_machine_features()));
+
+  return kernels_.emplace_back(
+      KernelInfo{kernel_prototype.function->getName().str(), se::BlockDim(),
+                 se::ThreadDim()});
+}
+
 //===----------------------------------------------------------------------===//
 // Building HostKernel prototypes.
 //===----------------------------------------------------------------------===//
@@ -639,31 +711,41 @@ absl::StatusOr<se::ThreadDim> IrEmitter2::EmitElementalLoops(
         HloOpcodeString(instr->opcode()));
   }
 
-  // TODO(ezhulenev): Support multiple results for parallel loops.
-  if (multiple_results) {
-    TF_RETURN_IF_ERROR(
-        llvm_ir::LoopEmitter(element_generator, kernel_prototype.results, &b)
-            .EmitLoop(llvm_ir::IrName(instr)));
-    return se::ThreadDim();
-  }
-
-  const llvm_ir::IrArray& result = kernel_prototype.results.front();
-
   // Emit a loop for a single parallel partition with dynamic bounds computed
-  // from thread index.
+  // from thread index. For multi-output fusions all results have the same
+  // dimensions, and we partition the iteration space of the first result.
   if (has_parallel_config) {
+    const Shape& shape = kernel_prototype.results.front().GetShape();
     ParallelPartitionBounds parallel_bounds = EmitParallelPartitionBounds(
-        b, kernel_prototype, *parallel_config, instr->shape(), instr->name());
-    TF_RETURN_IF_ERROR(
-        ParallelLoopEmitter(element_generator, result, &parallel_bounds, &b)
-            .EmitLoop(llvm_ir::IrName(instr)));
+        b, kernel_prototype, *parallel_config, shape, instr->name());
+
+    if (multiple_results) {
+      TF_RETURN_IF_ERROR(ParallelLoopEmitter(element_generator,
+                                             kernel_prototype.results,
+                                             &parallel_bounds, &b)
+                             .EmitLoop(llvm_ir::IrName(instr)));
+    } else {
+      TF_RETURN_IF_ERROR(ParallelLoopEmitter(element_generator,
+                                             kernel_prototype.results.front(),
+                                             &parallel_bounds, &b)
+                             .EmitLoop(llvm_ir::IrName(instr)));
+    }
+
     return se::ThreadDim(ShapePartitionAssigner::GetTotalPartitionCount(
         parallel_config->outer_dimension_partitions));
   }
 
   // Emit a whole loop for the instruction.
-  TF_RETURN_IF_ERROR(llvm_ir::LoopEmitter(element_generator, result, &b)
-                         .EmitLoop(llvm_ir::IrName(instr)));
+  if (multiple_results) {
+    TF_RETURN_IF_ERROR(
+        llvm_ir::LoopEmitter(element_generator, kernel_prototype.results, &b)
+            .EmitLoop(llvm_ir::IrName(instr)));
+  } else {
+    TF_RETURN_IF_ERROR(llvm_ir::LoopEmitter(element_generator,
+                                            kernel_prototype.results.front(),
+                                            &b)
+                           .EmitLoop(llvm_ir::IrName(instr)));
+  }
   return se::ThreadDim();
 }
 
@@ -152,6 +152,10 @@ class IrEmitter2 {
 
   KernelThread EmitKernelThread(llvm::IRBuilder<>& b, llvm::Value* call_frame);
 
+  // Emits a host kernel for the dot fusion with an elementwise epilogue.
+  absl::StatusOr<KernelInfo> EmitDotEpilogueFusionHostKernel(
+      const HloFusionInstruction* fusion, const HloInstruction* dot);
+
   llvm_ir::IrArray EmitKernelArgument(llvm::IRBuilder<>& b,
                                       llvm::Value* call_frame, int64_t index,
                                       const Shape& shape);
@@ -20,7 +20,9 @@ limitations under the License.
 
 #include "absl/status/statusor.h"
 #include "llvm/IR/LLVMContext.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/service/hlo_parser.h"
 #include "xla/service/llvm_ir/llvm_util.h"
@@ -150,5 +152,47 @@ TEST_F(IrEmitter2Test, EmitParallelKernel) {
   )"));
 }
 
+TEST_F(IrEmitter2Test, EmitParallelMultiOutputFusionKernel) {
+  llvm::LLVMContext context;
+  auto module = std::make_unique<llvm::Module>("test", context);
+
+  const char* hlo_text = R"(
+    HloModule m
+    fused_computation {
+      p0 = f32[16384,256] parameter(0)
+      negate = f32[16384,256] negate(p0)
+      convert = s32[16384,256] convert(p0)
+      ROOT tuple = (f32[16384,256], s32[16384,256]) tuple(negate, convert)
+    }
+
+    ENTRY main {
+      p0 = f32[16384,256] parameter(0)
+      ROOT fusion = (f32[16384,256], s32[16384,256]) fusion(p0), kind=kLoop,
+        calls=fused_computation,
+        backend_config={"outer_dimension_partitions":["4"]}
+    })";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo, ParseAndReturnUnverifiedModule(hlo_text));
+  HloInstruction* instr = FindInstruction(hlo.get(), "fusion");
+  ASSERT_NE(instr, nullptr);
+  auto* fusion = Cast<HloFusionInstruction>(instr);
+
+  IrEmitter2 ir_emitter(*hlo, module.get(), /*nested_ir_emitter=*/nullptr);
+  TF_ASSERT_OK_AND_ASSIGN(IrEmitter2::KernelInfo kernel,
+                          ir_emitter.EmitFusionHostKernel(fusion));
+  EXPECT_EQ(kernel.thread_dims.x, 4);
+
+  ASSERT_TRUE(*RunFileCheck(llvm_ir::DumpToString(module.get()), R"(
+    CHECK: @fusion_parallel_bounds = private constant [4 x [1 x [2 x i64]]]
+
+    CHECK: define ptr @fusion(ptr %0) #0 {
+    CHECK:   %lo_dim_0_gep = getelementptr{{.*}} i32 0, i64 %tid_x, i32 0, i32 0
+    CHECK:   %up_dim_0_gep = getelementptr{{.*}} i32 0, i64 %tid_x, i32 0, i32 1
+    CHECK-DAG:   fneg float
+    CHECK-DAG:   fptosi float {{.*}} to i32
+    CHECK: }
+  )"));
+}
+
 }  // namespace
 }  // namespace xla::cpu
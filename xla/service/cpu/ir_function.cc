@@ -233,11 +233,14 @@ std::vector<llvm::Value*> GetArrayFunctionCallArguments(
 }
 
 // Emits a call to a runtime fork/join function which dispatches parallel
-// calls to 'parallel_function' (and joins threads before returning).
+// calls to 'parallel_function' (and joins threads before returning). If
+// 'use_persistent_fork_join' is true, emits a call to the fork/join runtime
+// backed by a team of persistent worker threads.
 absl::Status EmitCallToParallelForkJoin(
     const std::vector<llvm::Value*>& arguments, const Shape& shape,
     absl::Span<const int64_t> dimension_partition_counts, llvm::IRBuilder<>* b,
-    llvm::Function* parallel_function, absl::string_view name) {
+    llvm::Function* parallel_function, absl::string_view name,
+    bool use_persistent_fork_join) {
   llvm::Module* module = b->GetInsertBlock()->getModule();
 
   // Build ParallelForkJoin function type.
@@ -262,8 +265,11 @@ absl::Status EmitCallToParallelForkJoin(
 
   llvm::Function* fork_join_func = llvm::dyn_cast<llvm::Function>(
       module
-          ->getOrInsertFunction(runtime::kParallelForkJoinSymbolName,
-                                fork_join_type)
+          ->getOrInsertFunction(
+              use_persistent_fork_join
+                  ? runtime::kPersistentParallelForkJoinSymbolName
+                  : runtime::kParallelForkJoinSymbolName,
+              fork_join_type)
           .getCallee());
   fork_join_func->setCallingConv(llvm::CallingConv::C);
   fork_join_func->setDoesNotThrow();
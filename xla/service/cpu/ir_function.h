@@ -144,11 +144,14 @@ std::vector<llvm::Value*> GetArrayFunctionCallArguments(
     llvm::Value* status_arg, llvm::Value* profile_counters_arg);
 
 // Emits a call to a runtime fork/join function which dispatches parallel
-// calls to 'parallel_function' (and joins threads before returning).
+// calls to 'parallel_function' (and joins threads before returning). If
+// 'use_persistent_fork_join' is true, emits a call to the fork/join runtime
+// backed by a team of persistent worker threads.
 absl::Status EmitCallToParallelForkJoin(
     const std::vector<llvm::Value*>& arguments, const Shape& shape,
     absl::Span<const int64_t> dimension_partition_counts, llvm::IRBuilder<>* b,
-    llvm::Function* parallel_function, absl::string_view name);
+    llvm::Function* parallel_function, absl::string_view name,
+    bool use_persistent_fork_join);
 
 }  // namespace cpu
 }  // namespace xla
@@ -37,6 +37,12 @@ const char* const kExpV16F32SymbolName = "__xla_cpu_runtime_ExpV16F32";
 const char* const kLogV4F32SymbolName = "__xla_cpu_runtime_LogV4F32AVX";
 const char* const kLogV8F32SymbolName = "__xla_cpu_runtime_LogV8F32AVX";
 const char* const kLogV16F32SymbolName = "__xla_cpu_runtime_LogV16F32AVX";
+const char* const kSinV4F32SymbolName = "__xla_cpu_runtime_SinV4F32";
+const char* const kSinV8F32SymbolName = "__xla_cpu_runtime_SinV8F32";
+const char* const kSinV16F32SymbolName = "__xla_cpu_runtime_SinV16F32";
+const char* const kCosV4F32SymbolName = "__xla_cpu_runtime_CosV4F32";
+const char* const kCosV8F32SymbolName = "__xla_cpu_runtime_CosV8F32";
+const char* const kCosV16F32SymbolName = "__xla_cpu_runtime_CosV16F32";
 
 namespace {
 
@@ -390,6 +396,105 @@ llvm::Value* GenerateVF32Log(llvm::IRBuilder<>* b, llvm::Value* input,
                      vsl.FloatAndNot(vsl.FloatOr(is_zero_mask, is_pos_inf_mask),
                                      result_finite_or_nan));
 }
+
+// Computes sin(x) (or cos(x) if `is_cos` is true) using the Cephes polynomials
+// for sinf/cosf on the reduced argument r = x - q * pi/2, |r| <= pi/4.
+//
+// If the builder allows approximate functions we do a three-part Cody-Waite
+// reduction in f32, which is exact for |q| < 2^13. Otherwise we do the
+// reduction in f64 with a two-part pi/2, which keeps r accurate for
+// |x| < 2^20 at the cost of converting to f64 and back.
+llvm::Value* GenerateVF32SinCos(llvm::IRBuilder<>* b, llvm::Value* input,
+                                int32_t vector_width, bool is_cos) {
+  VectorSupportLibrary vsl(F32, vector_width, b,
+                           is_cos ? "cos_f32" : "sin_f32");
+
+  const llvm::APFloat half = GetIeeeF32(0.5);
+  const llvm::APFloat one = GetIeeeF32(1.0);
+  const llvm::APFloat two_over_pi = GetIeeeF32(0.636619772367581343);
+
+  const llvm::APFloat cephes_sin_p0 = GetIeeeF32(-1.9515295891E-4);
+  const llvm::APFloat cephes_sin_p1 = GetIeeeF32(8.3321608736E-3);
+  const llvm::APFloat cephes_sin_p2 = GetIeeeF32(-1.6666654611E-1);
+  const llvm::APFloat cephes_cos_p0 = GetIeeeF32(2.443315711809948E-5);
+  const llvm::APFloat cephes_cos_p1 = GetIeeeF32(-1.388731625493765E-3);
+  const llvm::APFloat cephes_cos_p2 = GetIeeeF32(4.166664568298827E-2);
+
+  // q = round(x * 2/pi). Clamp before converting to an integer so that inf and
+  // nan inputs don't produce poison; the reduced argument is nan for them
+  // anyway, so the quadrant we pick doesn't matter.
+  llvm::Value* q = b->CreateUnaryIntrinsic(llvm::Intrinsic::rint,
+                                           vsl.Mul(two_over_pi, input));
+  llvm::Value* q_clamped =
+      vsl.Clamp(q, GetIeeeF32(-16777216.0), GetIeeeF32(16777216.0));
+  llvm::Type* i32_vector_type =
+      llvm::VectorType::get(b->getInt32Ty(), vector_width, false);
+  llvm::Value* n = b->CreateFPToSI(q_clamped, i32_vector_type);
+
+  llvm::Value* r;
+  if (b->getFastMathFlags().approxFunc()) {
+    const llvm::APFloat pio2_1 = GetIeeeF32(1.5703125);
+    const llvm::APFloat pio2_2 = GetIeeeF32(4.837512969970703125e-4);
+    const llvm::APFloat pio2_3 = GetIeeeF32(7.54978995489188216e-8);
+    r = vsl.Sub(input, vsl.Mul(pio2_1, q));
+    r = vsl.Sub(r, vsl.Mul(pio2_2, q));
+    r = vsl.Sub(r, vsl.Mul(pio2_3, q));
+  } else {
+    // VectorSupportLibrary only handles a single type, so drop down to
+    // IRBuilder for the f64 part.
+    llvm::Type* f64_vector_type =
+        llvm::VectorType::get(b->getDoubleTy(), vector_width, false);
+    llvm::Value* x_f64 = b->CreateFPExt(input, f64_vector_type);
+    llvm::Value* q_f64 = b->CreateFPExt(q, f64_vector_type);
+    auto splat_f64 = [&](double v) {
+      return llvm::ConstantFP::get(f64_vector_type, v);
+    };
+    llvm::Value* r_f64 = b->CreateFSub(
+        x_f64, b->CreateFMul(q_f64, splat_f64(1.57079632673412561417)));
+    r_f64 = b->CreateFSub(
+        r_f64, b->CreateFMul(q_f64, splat_f64(6.07710050650619224932e-11)));
+    r = b->CreateFPTrunc(r_f64, vsl.vector_type());
+  }
+
+  llvm::Value* z = vsl.Mul(r, r);
+
+  // sin(r) ~= r + r * z * (p2 + z * (p1 + z * p0)).
+  llvm::Value* sin_r = vsl.MulAdd(z, cephes_sin_p0, cephes_sin_p1);
+  sin_r = vsl.MulAdd(sin_r, z, cephes_sin_p2);
+  sin_r = vsl.MulAdd(vsl.Mul(sin_r, z), r, r);
+
+  // cos(r) ~= 1 - z / 2 + z * z * (p2 + z * (p1 + z * p0)).
+  llvm::Value* cos_r = vsl.MulAdd(z, cephes_cos_p0, cephes_cos_p1);
+  cos_r = vsl.MulAdd(cos_r, z, cephes_cos_p2);
+  cos_r = vsl.MulAdd(vsl.Mul(cos_r, z), z, vsl.Sub(one, vsl.Mul(half, z)));
+
+  // cos(x) = sin(x + pi/2), so shift the quadrant by one for cos. Odd quadrants
+  // use the cos polynomial, and quadrants 2 and 3 flip the sign.
+  if (is_cos) {
+    n = b->CreateAdd(n, b->CreateVectorSplat(vector_width, b->getInt32(1)));
+  }
+  llvm::Value* use_cos = b->CreateICmpNE(
+      b->CreateAnd(n, b->CreateVectorSplat(vector_width, b->getInt32(1))),
+      llvm::ConstantInt::get(i32_vector_type, 0));
+  llvm::Value* result = b->CreateSelect(use_cos, cos_r, sin_r);
+
+  llvm::Value* sign_bit = b->CreateShl(
+      b->CreateAnd(n, b->CreateVectorSplat(vector_width, b->getInt32(2))),
+      b->CreateVectorSplat(vector_width, b->getInt32(30)));
+  return b->CreateBitCast(
+      b->CreateXor(b->CreateBitCast(result, i32_vector_type), sign_bit),
+      vsl.vector_type());
+}
+
+llvm::Value* GenerateVF32Sin(llvm::IRBuilder<>* b, llvm::Value* input,
+                             int32_t vector_width) {
+  return GenerateVF32SinCos(b, input, vector_width, /*is_cos=*/false);
+}
+
+llvm::Value* GenerateVF32Cos(llvm::IRBuilder<>* b, llvm::Value* input,
+                             int32_t vector_width) {
+  return GenerateVF32SinCos(b, input, vector_width, /*is_cos=*/true);
+}
 }  // namespace
 
 void RewriteIRRuntimeFunctions(llvm::Module* module,
@@ -416,6 +521,18 @@ void RewriteIRRuntimeFunctions(llvm::Module* module,
   rewrite_calls(kLogV4F32SymbolName, GenerateVF32Log, /*vector_width=*/4);
   rewrite_calls(kLogV8F32SymbolName, GenerateVF32Log, /*vector_width=*/8);
   rewrite_calls(kLogV16F32SymbolName, GenerateVF32Log, /*vector_width=*/16);
+
+  rewrite_calls("sinf", GenerateVF32Sin, /*vector_width=*/1);
+  rewrite_calls("llvm.sin.f32", GenerateVF32Sin, /*vector_width=*/1);
+  rewrite_calls(kSinV4F32SymbolName, GenerateVF32Sin, /*vector_width=*/4);
+  rewrite_calls(kSinV8F32SymbolName, GenerateVF32Sin, /*vector_width=*/8);
+  rewrite_calls(kSinV16F32SymbolName, GenerateVF32Sin, /*vector_width=*/16);
+
+  rewrite_calls("cosf", GenerateVF32Cos, /*vector_width=*/1);
+  rewrite_calls("llvm.cos.f32", GenerateVF32Cos, /*vector_width=*/1);
+  rewrite_calls(kCosV4F32SymbolName, GenerateVF32Cos, /*vector_width=*/4);
+  rewrite_calls(kCosV8F32SymbolName, GenerateVF32Cos, /*vector_width=*/8);
+  rewrite_calls(kCosV16F32SymbolName, GenerateVF32Cos, /*vector_width=*/16);
 }
 
 }  // namespace runtime
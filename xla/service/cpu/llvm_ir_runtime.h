@@ -33,6 +33,12 @@ extern const char* const kExpV16F32SymbolName;
 extern const char* const kLogV4F32SymbolName;
 extern const char* const kLogV8F32SymbolName;
 extern const char* const kLogV16F32SymbolName;
+extern const char* const kSinV4F32SymbolName;
+extern const char* const kSinV8F32SymbolName;
+extern const char* const kSinV16F32SymbolName;
+extern const char* const kCosV4F32SymbolName;
+extern const char* const kCosV8F32SymbolName;
+extern const char* const kCosV16F32SymbolName;
 
 // The following CPU runtime functions have LLVM-IR only implementations:
 //
@@ -41,6 +47,11 @@ extern const char* const kLogV16F32SymbolName;
 //
 // |LinkIRRuntimeFunctions| rewrites calls to these functions into generic LLVM
 // IR.
+//
+// The generated sin and cos come in two accuracy tiers selected by the fast
+// math flags of the module: with `afn` set we reduce the argument in f32 (fast,
+// accurate for |x| < 8192), otherwise we reduce it in f64 and stay within a few
+// ULPs of the correctly rounded result for |x| < 2^20.
 
 void RewriteIRRuntimeFunctions(llvm::Module* module,
                                llvm::FastMathFlags fast_math_flags);
@@ -0,0 +1,163 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/object_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBufferRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "xla/service/cpu/executable.pb.h"
+#include "xla/xla.pb.h"
+#include "tsl/lib/strings/proto_serialization.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/logging.h"
+
+namespace xla::cpu {
+
+// Returns a fingerprint of all object files in the cache entry, which detects
+// truncated and corrupted entries.
+static uint64_t ObjectFilesFingerprint(
+    absl::Span<const std::string> obj_files) {
+  uint64_t fingerprint = obj_files.size();
+  for (const std::string& obj_file : obj_files) {
+    fingerprint =
+        tsl::FingerprintCat64(fingerprint, tsl::Fingerprint64(obj_file));
+  }
+  return fingerprint;
+}
+
+std::string GetObjectCacheKey(const llvm::Module& llvm_module,
+                              const llvm::TargetMachine& target_machine,
+                              const DebugOptions& debug_options) {
+  llvm::SmallString<0> bitcode;
+  llvm::raw_svector_ostream bitcode_ostream(bitcode);
+  llvm::WriteBitcodeToFile(llvm_module, bitcode_ostream);
+
+  // Options that do not affect compiled code should not invalidate the cache.
+  DebugOptions codegen_options = debug_options;
+  codegen_options.clear_xla_cpu_object_cache_dir();
+  codegen_options.clear_xla_dump_to();
+
+  std::string serialized_options;
+  tsl::SerializeToStringDeterministic(codegen_options, &serialized_options);
+
+  std::string triple = target_machine.getTargetTriple().str();
+
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(
+      absl::string_view(bitcode.data(), bitcode.size()));
+  for (absl::string_view str :
+       {absl::string_view(triple),
+        absl::string_view(target_machine.getTargetCPU()),
+        absl::string_view(target_machine.getTargetFeatureString()),
+        absl::string_view(serialized_options)}) {
+    fingerprint =
+        tsl::FingerprintCat128(fingerprint, tsl::Fingerprint128(str));
+  }
+
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+std::optional<std::vector<std::string>> LoadObjectCacheEntry(
+    const std::string& path) {
+  tsl::Env* env = tsl::Env::Default();
+  if (!env->FileExists(path).ok()) return std::nullopt;
+
+  std::string serialized;
+  if (auto read = tsl::ReadFileToString(env, path, &serialized); !read.ok()) {
+    LOG(WARNING) << "Failed to read XLA:CPU object cache entry " << path << ": "
+                 << read;
+    return std::nullopt;
+  }
+
+  ObjectFilesProto proto;
+  if (!proto.ParseFromString(serialized) || proto.obj_files().empty()) {
+    LOG(WARNING) << "Failed to parse XLA:CPU object cache entry " << path;
+    return std::nullopt;
+  }
+
+  std::vector<std::string> obj_files(proto.obj_files().begin(),
+                                     proto.obj_files().end());
+
+  if (proto.fingerprint() != ObjectFilesFingerprint(obj_files)) {
+    LOG(WARNING) << "Fingerprint mismatch in XLA:CPU object cache entry "
+                 << path;
+    return std::nullopt;
+  }
+
+  // Check that all object files can be loaded before we add any of them to the
+  // JIT, as we can't remove object files from the JIT once they are added.
+  for (const std::string& obj_file : obj_files) {
+    llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> object =
+        llvm::object::ObjectFile::createObjectFile(
+            llvm::MemoryBufferRef(obj_file, path));
+    if (!object) {
+      LOG(WARNING) << "Invalid object file in XLA:CPU object cache entry "
+                   << path << ": " << llvm::toString(object.takeError());
+      return std::nullopt;
+    }
+  }
+
+  VLOG(1) << "Load " << obj_files.size()
+          << " object files from XLA:CPU object cache entry " << path;
+
+  return obj_files;
+}
+
+void StoreObjectCacheEntry(const std::string& path,
+                           absl::Span<const std::string> obj_files) {
+  ObjectFilesProto proto;
+  for (const std::string& obj_file : obj_files) proto.add_obj_files(obj_file);
+  proto.set_fingerprint(ObjectFilesFingerprint(obj_files));
+
+  tsl::Env* env = tsl::Env::Default();
+
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    LOG(WARNING) << "Failed to create temporary file name for " << path;
+    return;
+  }
+
+  absl::Status stored =
+      tsl::WriteStringToFile(env, tmp_path, proto.SerializeAsString());
+  if (stored.ok()) stored = env->RenameFile(tmp_path, path);
+
+  if (!stored.ok()) {
+    LOG(WARNING) << "Failed to store XLA:CPU object cache entry " << path
+                 << ": " << stored;
+    env->DeleteFile(tmp_path).IgnoreError();
+    return;
+  }
+
+  VLOG(1) << "Stored " << obj_files.size()
+          << " object files to XLA:CPU object cache entry " << path;
+}
+
+}  // namespace xla::cpu
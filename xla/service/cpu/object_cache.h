@@ -0,0 +1,57 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_OBJECT_CACHE_H_
+#define XLA_SERVICE_CPU_OBJECT_CACHE_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+#include "xla/xla.pb.h"
+
+namespace xla::cpu {
+
+// XLA:CPU object cache stores object files compiled from an LLVM module in a
+// directory configured by `xla_cpu_object_cache_dir`, one file per module.
+
+// Returns a key for the XLA:CPU object cache. Compiled object files depend on
+// the emitted LLVM module (which captures the HLO module, buffer assignment and
+// the XLA version that emitted it), the target machine and debug options that
+// configure LLVM.
+std::string GetObjectCacheKey(const llvm::Module& llvm_module,
+                              const llvm::TargetMachine& target_machine,
+                              const DebugOptions& debug_options);
+
+// Loads object files from the object cache entry at `path`. Returns
+// std::nullopt if the entry does not exist or can't be used (it can't be read
+// or parsed, it is truncated or it contains invalid object files), and callers
+// must compile the module instead.
+std::optional<std::vector<std::string>> LoadObjectCacheEntry(
+    const std::string& path);
+
+// Stores object files to the object cache entry at `path`. We write cache entry
+// to a temporary file first, and then atomically rename it, so that concurrent
+// readers never observe partially written entries. Failures are logged and
+// otherwise ignored, as the cache is only an optimization.
+void StoreObjectCacheEntry(const std::string& path,
+                           absl::Span<const std::string> obj_files);
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_OBJECT_CACHE_H_
@@ -0,0 +1,212 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/object_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include "llvm/TargetParser/Triple.h"
+#include "xla/service/cpu/executable.pb.h"
+#include "xla/xla.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/test.h"
+
+namespace xla::cpu {
+namespace {
+
+constexpr absl::string_view kTriple = "x86_64-unknown-linux-gnu";
+
+class ObjectCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    LLVMInitializeX86Target();
+    LLVMInitializeX86TargetInfo();
+    LLVMInitializeX86TargetMC();
+    LLVMInitializeX86AsmPrinter();
+
+    // A module with a single function that returns its argument plus one.
+    module_ = std::make_unique<llvm::Module>("test", context_);
+    module_->setTargetTriple(std::string(kTriple));
+    llvm::IRBuilder<> b(context_);
+    auto* fn = llvm::Function::Create(
+        llvm::FunctionType::get(b.getInt32Ty(), {b.getInt32Ty()}, false),
+        llvm::GlobalValue::ExternalLinkage, "add_one", *module_);
+    b.SetInsertPoint(llvm::BasicBlock::Create(context_, "entry", fn));
+    b.CreateRet(b.CreateAdd(fn->getArg(0), b.getInt32(1)));
+  }
+
+  static std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(
+      absl::string_view cpu, absl::string_view features = "") {
+    std::string error;
+    const llvm::Target* target =
+        llvm::TargetRegistry::lookupTarget(std::string(kTriple), error);
+    CHECK(target) << error;
+    return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+        std::string(kTriple), cpu, features, llvm::TargetOptions(),
+        std::nullopt));
+  }
+
+  // Compiles the test module to an object file.
+  std::string CompileToObjFile() {
+    auto target_machine = CreateTargetMachine("haswell");
+    llvm::SmallString<0> obj_file;
+    llvm::raw_svector_ostream ostream(obj_file);
+    llvm::legacy::PassManager pm;
+    CHECK(!target_machine->addPassesToEmitFile(
+        pm, ostream, nullptr, llvm::CodeGenFileType::ObjectFile));
+    pm.run(*module_);
+    return std::string(obj_file.str());
+  }
+
+  static std::string CachePath() {
+    const ::testing::TestInfo* test_info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    return tsl::io::JoinPath(::testing::TempDir(),
+                             absl::StrCat(test_info->name(), ".pb"));
+  }
+
+  llvm::LLVMContext context_;
+  std::unique_ptr<llvm::Module> module_;
+};
+
+TEST_F(ObjectCacheTest, KeyIsDeterministic) {
+  auto target_machine = CreateTargetMachine("haswell");
+  DebugOptions debug_options;
+  EXPECT_EQ(GetObjectCacheKey(*module_, *target_machine, debug_options),
+            GetObjectCacheKey(*module_, *target_machine, debug_options));
+}
+
+TEST_F(ObjectCacheTest, KeyChangesWithDebugOptions) {
+  auto target_machine = CreateTargetMachine("haswell");
+  DebugOptions debug_options;
+  std::string key = GetObjectCacheKey(*module_, *target_machine, debug_options);
+
+  DebugOptions fast_math = debug_options;
+  fast_math.set_xla_cpu_enable_fast_math(true);
+  EXPECT_NE(GetObjectCacheKey(*module_, *target_machine, fast_math), key);
+
+  DebugOptions vector_width = debug_options;
+  vector_width.set_xla_cpu_prefer_vector_width(512);
+  EXPECT_NE(GetObjectCacheKey(*module_, *target_machine, vector_width), key);
+
+  // Options that do not affect compiled code do not change the key.
+  DebugOptions dump = debug_options;
+  dump.set_xla_dump_to("/tmp/dump");
+  dump.set_xla_cpu_object_cache_dir("/tmp/cache");
+  EXPECT_EQ(GetObjectCacheKey(*module_, *target_machine, dump), key);
+}
+
+TEST_F(ObjectCacheTest, KeyChangesWithTarget) {
+  DebugOptions debug_options;
+  std::string key = GetObjectCacheKey(
+      *module_, *CreateTargetMachine("haswell"), debug_options);
+
+  EXPECT_NE(GetObjectCacheKey(*module_, *CreateTargetMachine("skylake-avx512"),
+                              debug_options),
+            key);
+  EXPECT_NE(GetObjectCacheKey(*module_,
+                              *CreateTargetMachine("haswell", "-avx2"),
+                              debug_options),
+            key);
+}
+
+TEST_F(ObjectCacheTest, KeyChangesWithModule) {
+  auto target_machine = CreateTargetMachine("haswell");
+  DebugOptions debug_options;
+  std::string key = GetObjectCacheKey(*module_, *target_machine, debug_options);
+
+  module_->getFunction("add_one")->setName("add_two");
+  EXPECT_NE(GetObjectCacheKey(*module_, *target_machine, debug_options), key);
+}
+
+TEST_F(ObjectCacheTest, StoreAndLoad) {
+  std::vector<std::string> obj_files = {CompileToObjFile(),
+                                        CompileToObjFile()};
+  StoreObjectCacheEntry(CachePath(), obj_files);
+
+  std::optional<std::vector<std::string>> loaded =
+      LoadObjectCacheEntry(CachePath());
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(*loaded, obj_files);
+}
+
+TEST_F(ObjectCacheTest, MissingEntry) {
+  EXPECT_FALSE(LoadObjectCacheEntry(CachePath()).has_value());
+}
+
+TEST_F(ObjectCacheTest, TruncatedEntry) {
+  StoreObjectCacheEntry(CachePath(), {CompileToObjFile()});
+
+  std::string serialized;
+  TF_ASSERT_OK(
+      tsl::ReadFileToString(tsl::Env::Default(), CachePath(), &serialized));
+  serialized.resize(serialized.size() / 2);
+  TF_ASSERT_OK(
+      tsl::WriteStringToFile(tsl::Env::Default(), CachePath(), serialized));
+
+  EXPECT_FALSE(LoadObjectCacheEntry(CachePath()).has_value());
+}
+
+TEST_F(ObjectCacheTest, CorruptedEntry) {
+  StoreObjectCacheEntry(CachePath(), {CompileToObjFile()});
+
+  ObjectFilesProto proto;
+  std::string serialized;
+  TF_ASSERT_OK(
+      tsl::ReadFileToString(tsl::Env::Default(), CachePath(), &serialized));
+  ASSERT_TRUE(proto.ParseFromString(serialized));
+
+  // Flip a byte in the middle of the object file.
+  std::string& obj_file = *proto.mutable_obj_files(0);
+  obj_file[obj_file.size() / 2] ^= 0xFF;
+  TF_ASSERT_OK(tsl::WriteStringToFile(tsl::Env::Default(), CachePath(),
+                                      proto.SerializeAsString()));
+
+  EXPECT_FALSE(LoadObjectCacheEntry(CachePath()).has_value());
+}
+
+TEST_F(ObjectCacheTest, EntryWithInvalidObjectFile) {
+  // An entry without a fingerprint (or with a garbage object file) is rejected.
+  ObjectFilesProto proto;
+  proto.add_obj_files("not an object file");
+  TF_ASSERT_OK(tsl::WriteStringToFile(tsl::Env::Default(), CachePath(),
+                                      proto.SerializeAsString()));
+
+  EXPECT_FALSE(LoadObjectCacheEntry(CachePath()).has_value());
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -29,13 +29,18 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/layout_util.h"
 #include "xla/service/cpu/backend_config.pb.h"
+#include "xla/service/cpu/cpu_options.h"
 #include "xla/service/cpu/ir_emission_utils.h"
 #include "xla/service/cpu/shape_partition.h"
 #include "xla/service/cpu/target_machine_features.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/llvm_ir/dynamic_update_slice_util.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
 #include "xla/statusor.h"
 #include "xla/util.h"
 #include "tsl/platform/cpu_info.h"
@@ -45,6 +50,75 @@ limitations under the License.
 namespace xla {
 namespace cpu {
 
+// Returns true if `instruction` is a multi-output loop fusion with all results
+// having the same dimensions, so that all of them can be computed by a single
+// partitioned loop nest. Parallel loops for multi-output fusions are only
+// supported by the thunk runtime (see `IrEmitter2::EmitElementalLoops`).
+static bool IsParallelizableMultiOutputFusion(
+    const HloInstruction* instruction) {
+  if (!instruction->IsLoopFusion() || !instruction->IsMultiOutputFusion()) {
+    return false;
+  }
+
+  const HloModule* module = instruction->GetModule();
+  if (module == nullptr ||
+      !module->config().debug_options().xla_cpu_use_thunk_runtime()) {
+    return false;
+  }
+
+  const Shape& shape = instruction->shape();
+  if (shape.tuple_shapes_size() == 0) return false;
+
+  return absl::c_all_of(shape.tuple_shapes(), [&](const Shape& result) {
+    return result.IsArray() &&
+           ShapeUtil::SameDimensions(result, shape.tuple_shapes(0));
+  });
+}
+
+// Returns the shape of the iteration space of `instruction`. For multi-output
+// fusions it is the shape of the first result.
+static const Shape& GetIterationShape(const HloInstruction* instruction) {
+  const Shape& shape = instruction->shape();
+  return shape.IsTuple() ? shape.tuple_shapes(0) : shape;
+}
+
+// Returns true if `instruction` is a reduction that IrEmitter vectorizes along
+// the most minor dimension of its result (see
+// `IrEmitter::EmitVectorizedReduce`). Such reductions can only be partitioned
+// along the outer dimensions of the result.
+static bool IsVectorizedReduceAlongMinorDimension(
+    const HloInstruction* instruction) {
+  if (instruction->opcode() != HloOpcode::kReduce ||
+      !instruction->shape().IsArray() ||
+      instruction->shape().dimensions_size() == 0) {
+    return false;
+  }
+
+  // The thunk runtime emits reductions as partitioned elemental loops.
+  const HloModule* module = instruction->GetModule();
+  if (module == nullptr ||
+      module->config().debug_options().xla_cpu_use_thunk_runtime() ||
+      options::VectorizedReduceDisabled(module->config())) {
+    return false;
+  }
+
+  const Shape& operand_shape = instruction->operand(0)->shape();
+  return !absl::c_linear_search(instruction->dimensions(),
+                                LayoutUtil::Minor(operand_shape.layout(), 0));
+}
+
+// Returns the total size in bytes of all arrays produced by `instruction`.
+static int64_t GetResultsSizeBytes(
+    const HloCostAnalysis::ShapeSizeFunction& shape_size,
+    const HloInstruction* instruction) {
+  int64_t size = 0;
+  ShapeUtil::ForEachSubshape(
+      instruction->shape(), [&](const Shape& subshape, const ShapeIndex&) {
+        if (subshape.IsArray()) size += shape_size(subshape);
+      });
+  return size;
+}
+
 class SimpleCostModel : public ParallelCostModel {
  public:
   SimpleCostModel(const int64_t max_parallelism,
@@ -54,7 +128,8 @@ class SimpleCostModel : public ParallelCostModel {
 
   int64_t GetParallelTaskCount(HloInstruction* instruction) override {
     // Simple cost model based on hlo size and typical L2 cache size.
-    const int64_t instruction_cost = shape_size_(instruction->shape());
+    const int64_t instruction_cost =
+        GetResultsSizeBytes(shape_size_, instruction);
     const int64_t min_cost_per_thread = 256LL << 10;  // 256KB L2 Cache size.
     // Return target parallel task count in [1, max_parallelism_].
     return std::min(
@@ -96,7 +171,7 @@ class DefaultCostModel : public ParallelCostModel {
       max_parallelism = std::min<int64_t>(
           max_parallelism_, std::ceil(std::sqrt(tsl::port::MaxParallelism())));
       // Use shape size instruction cost and L2 cache size min per-thread cost.
-      instruction_cost = shape_size_(instruction->shape());
+      instruction_cost = GetResultsSizeBytes(shape_size_, instruction);
       min_cost_per_thread = 256LL << 10;  // 256KB L2 Cache size.
     } else {
       // Use max parallelism for compute bound instructions.
@@ -155,7 +230,7 @@ int64_t ParallelTaskAssignment::GetTargetParallelTaskCount(
   // *) Internal threading (library calls to kConv, kDot, kFft, kCustomCall).
   // *) Emit custom loops (kSelectAndScatter).
   // *) Operations that are not thread safe (like infeed and rng).
-  // *) Tuple-shaped.
+  // *) Tuple-shaped (except multi-output loop fusions in the thunk runtime).
   // *) Operations that might be implemented as an in-place
   //    dynamic-update-slice, because we can't know how many output elements
   //    they will write (out-of-place will touch the whole output buffer, while
@@ -163,11 +238,16 @@ int64_t ParallelTaskAssignment::GetTargetParallelTaskCount(
   // TODO(b/27458679) Parallelize instructions which are skipped here.
   auto opcode = instruction->opcode();
   if (llvm_ir::MayBeImplementedAsInPlaceDynamicUpdateSlice(instruction) ||
-      instruction->shape().IsTuple() || opcode == HloOpcode::kRng ||
-      opcode == HloOpcode::kConstant) {
+      opcode == HloOpcode::kRng || opcode == HloOpcode::kConstant) {
     return 1;
   }
 
+  if (instruction->shape().IsTuple()) {
+    return IsParallelizableMultiOutputFusion(instruction)
+               ? cost_model_->GetParallelTaskCount(instruction)
+               : 1;
+  }
+
   // Only allow instructions that can be trivially parallelized (where all
   // outputs can be computed independently of each other).
   if (instruction->IsElementwise() || instruction->IsLoopFusion() ||
@@ -240,9 +320,19 @@ bool ParallelTaskAssigner::AssignParallelTasksHelper(
     }
     // Get target parallel task count computed for 'instruction'.
     const int64_t target_parallel_task_count = (*it).second;
+    // Vectorized reductions keep the most minor dimension of the result out of
+    // the partitioned dimensions.
+    Shape partition_shape = GetIterationShape(instruction);
+    if (IsVectorizedReduceAlongMinorDimension(instruction)) {
+      if (partition_shape.dimensions_size() <= 1) {
+        continue;
+      }
+      partition_shape = ShapeUtil::DeleteDimension(
+          LayoutUtil::Minor(partition_shape.layout(), 0), partition_shape);
+    }
     // Assign feasible dimension partitions (based on actual dimension sizes).
-    auto dim_partition_counts = ShapePartitionAssigner(instruction->shape())
-                                    .Run(target_parallel_task_count);
+    auto dim_partition_counts =
+        ShapePartitionAssigner(partition_shape).Run(target_parallel_task_count);
     const int64_t total_partition_count =
         ShapePartitionAssigner::GetTotalPartitionCount(dim_partition_counts);
     if (total_partition_count <= 1) {
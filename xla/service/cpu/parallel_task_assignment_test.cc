@@ -15,10 +15,15 @@ limitations under the License.
 
 #include "xla/service/cpu/parallel_task_assignment.h"
 
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/cpu/backend_config.pb.h"
 #include "xla/service/cpu/cpu_executable.h"
 #include "xla/service/cpu/target_machine_features_fake.h"
+#include "xla/service/hlo_module_config.h"
 #include "xla/test.h"
 #include "xla/tests/hlo_test_base.h"
+#include "xla/xla.pb.h"
 #include "tsl/lib/core/status_test_util.h"
 
 namespace xla {
@@ -206,5 +211,128 @@ TEST_F(ParallelTaskAssignmentTest, ConstantNotParallelized) {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(ParallelTaskAssignmentTest, MultiOutputFusionParallelizedWithThunks) {
+  constexpr char hlo_string[] = R"(
+  HloModule TestTaskParallel_multi_output_fusion
+    fused_computation {
+      p0 = f32[1024,1024] parameter(0)
+      m1 = f32[1024,1024] multiply(p0, p0)
+      m2 = f32[1024,1024] multiply(m1, p0)
+      m3 = f32[1024,1024] multiply(m2, p0)
+      m4 = f32[1024,1024] multiply(m3, p0)
+      m5 = f32[1024,1024] multiply(m4, p0)
+      m6 = f32[1024,1024] multiply(m5, p0)
+      m7 = f32[1024,1024] multiply(m6, p0)
+      m8 = f32[1024,1024] multiply(m7, p0)
+      m9 = f32[1024,1024] multiply(m8, p0)
+      m10 = f32[1024,1024] multiply(m9, p0)
+      m11 = f32[1024,1024] multiply(m10, p0)
+      m12 = f32[1024,1024] multiply(m11, p0)
+      m13 = f32[1024,1024] multiply(m12, p0)
+      m14 = f32[1024,1024] multiply(m13, p0)
+      m15 = f32[1024,1024] multiply(m14, p0)
+      m16 = f32[1024,1024] multiply(m15, p0)
+      ROOT tuple = (f32[1024,1024], f32[1024,1024]) tuple(m8, m16)
+    }
+
+    ENTRY main {
+      p0 = f32[1024,1024] parameter(0)
+      ROOT fusion = (f32[1024,1024], f32[1024,1024]) fusion(p0), kind=kLoop,
+        calls=fused_computation
+    }
+  )";
+
+  HloModuleConfig config = GetModuleConfigForTest();
+  DebugOptions debug_options = config.debug_options();
+
+  // Legacy runtime does not support parallel multi-output fusions.
+  debug_options.set_xla_cpu_use_thunk_runtime(false);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m0,
+                          ParseAndReturnVerifiedModule(hlo_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m0.get()));
+  EXPECT_FALSE(changed);
+
+  // Thunk runtime partitions the iteration space of the first result.
+  debug_options.set_xla_cpu_use_thunk_runtime(true);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m1,
+                          ParseAndReturnVerifiedModule(hlo_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(changed, RunParallelTaskAssigner(m1.get()));
+  EXPECT_TRUE(changed);
+
+  HloInstruction* root = m1->entry_computation()->root_instruction();
+  ASSERT_EQ(root->opcode(), HloOpcode::kCall);
+
+  HloInstruction* fusion = root->to_apply()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(auto backend_config,
+                          fusion->backend_config<cpu::BackendConfig>());
+  EXPECT_FALSE(backend_config.outer_dimension_partitions().empty());
+}
+
+TEST_F(ParallelTaskAssignmentTest, VectorizedReducePartitionsOuterDimensions) {
+  constexpr char hlo_string[] = R"(
+  HloModule TestTaskParallel_column_reduce
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY main {
+      p0 = f32[4096,16,1024] parameter(0)
+      c0 = f32[] constant(0)
+      ROOT reduce = f32[16,1024] reduce(p0, c0), dimensions={0}, to_apply=add
+    }
+  )";
+
+  HloModuleConfig config = GetModuleConfigForTest();
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_cpu_use_thunk_runtime(false);
+  config.set_debug_options(debug_options);
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_TRUE(changed);
+
+  HloInstruction* root = m->entry_computation()->root_instruction();
+  ASSERT_EQ(root->opcode(), HloOpcode::kCall);
+
+  // The most minor dimension of the result is vectorized and never
+  // partitioned.
+  HloInstruction* reduce = root->to_apply()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(auto backend_config,
+                          reduce->backend_config<cpu::BackendConfig>());
+  EXPECT_EQ(backend_config.outer_dimension_partitions_size(), 1);
+}
+
+TEST_F(ParallelTaskAssignmentTest, VectorizedReduceOfVectorNotParallelized) {
+  constexpr char hlo_string[] = R"(
+  HloModule TestTaskParallel_column_reduce
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY main {
+      p0 = f32[16384,1024] parameter(0)
+      c0 = f32[] constant(0)
+      ROOT reduce = f32[1024] reduce(p0, c0), dimensions={0}, to_apply=add
+    }
+  )";
+
+  HloModuleConfig config = GetModuleConfigForTest();
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_cpu_use_thunk_runtime(false);
+  config.set_debug_options(debug_options);
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_FALSE(changed);
+}
+
 }  // namespace
 }  // namespace xla
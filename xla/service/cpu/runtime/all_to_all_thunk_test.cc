@@ -0,0 +1,220 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/all_to_all_thunk.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xla/executable_run_options.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/computation_placer.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/collective_thunk.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+constexpr int kNumDevices = 4;
+constexpr int64_t kNumElements = 2;
+
+// Buffers of a single device: chunk `i` of the all-to-all is sent from
+// `sources[i]` and received into `destinations[i]`.
+struct DeviceBuffers {
+  std::vector<std::vector<int32_t>> sources;
+  std::vector<std::vector<int32_t>> destinations;
+};
+
+// Returns buffers for `num_operands` operands with device-unique source data
+// and destinations filled with a sentinel value.
+std::vector<DeviceBuffers> MakeDeviceBuffers(int num_operands) {
+  std::vector<DeviceBuffers> buffers(kNumDevices);
+  for (int device = 0; device < kNumDevices; ++device) {
+    for (int i = 0; i < num_operands; ++i) {
+      int32_t base = 100 * device + 10 * i;
+      buffers[device].sources.push_back({base, base + 1});
+      buffers[device].destinations.push_back({-1, -1});
+    }
+  }
+  return buffers;
+}
+
+// Returns op buffers for `num_operands` operands, with sources assigned to
+// allocations [0, num_operands) and destinations to the ones after them.
+CollectiveThunk::OpBuffers MakeOpBuffers(
+    int num_operands, std::vector<BufferAllocation>& allocations) {
+  size_t size_in_bytes = kNumElements * sizeof(int32_t);
+  Shape shape = ShapeUtil::MakeShape(S32, {kNumElements});
+
+  allocations.reserve(2 * num_operands);
+  for (int i = 0; i < 2 * num_operands; ++i) {
+    allocations.emplace_back(i, size_in_bytes, 0);
+  }
+
+  CollectiveThunk::OpBuffers op_buffers;
+  for (int i = 0; i < num_operands; ++i) {
+    op_buffers.source_buffers.emplace_back(&allocations[i], 0, size_in_bytes);
+    op_buffers.source_shapes.push_back(shape);
+    op_buffers.destination_buffers.emplace_back(
+        &allocations[num_operands + i], 0, size_in_bytes);
+    op_buffers.destination_shapes.push_back(shape);
+  }
+  return op_buffers;
+}
+
+// Executes `thunk` concurrently on all replicas using in-process collectives.
+void ExecuteOnAllDevices(Thunk& thunk, std::vector<DeviceBuffers>& buffers) {
+  DeviceAssignment device_assignment(kNumDevices, 1);
+  for (int device = 0; device < kNumDevices; ++device) {
+    device_assignment(device, 0) = device;
+  }
+
+  std::vector<absl::Status> statuses(kNumDevices);
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "devices",
+                                        kNumDevices);
+    for (int device = 0; device < kNumDevices; ++device) {
+      thread_pool.Schedule([&, device] {
+        std::vector<MaybeOwningDeviceMemory> memory;
+        for (auto* data : {&buffers[device].sources,
+                           &buffers[device].destinations}) {
+          for (std::vector<int32_t>& buffer : *data) {
+            memory.emplace_back(se::DeviceMemoryBase(
+                buffer.data(), buffer.size() * sizeof(int32_t)));
+          }
+        }
+        BufferAllocations allocations(memory);
+
+        ExecutableRunOptions run_options;
+        run_options.set_device_ordinal(device);
+        run_options.set_device_assignment(&device_assignment);
+        run_options.set_run_id(RunId(0));
+
+        absl::StatusOr<Thunk::CollectiveExecuteParams> collective_params =
+            Thunk::CollectiveExecuteParams::Create(&run_options);
+        if (!collective_params.ok()) {
+          statuses[device] = collective_params.status();
+          return;
+        }
+
+        Thunk::ExecuteParams params;
+        params.buffer_allocations = &allocations;
+        params.collective_params = &*collective_params;
+
+        auto execute_event = thunk.Execute(params);
+        tsl::BlockUntilReady(execute_event);
+        statuses[device] = execute_event.IsError() ? execute_event.GetError()
+                                                   : absl::OkStatus();
+      });
+    }
+  }
+
+  for (const absl::Status& status : statuses) {
+    TF_EXPECT_OK(status);
+  }
+}
+
+// Returns a replica group with the given replica ids.
+ReplicaGroup MakeReplicaGroup(std::vector<int64_t> replica_ids) {
+  ReplicaGroup group;
+  for (int64_t replica_id : replica_ids) {
+    group.add_replica_ids(replica_id);
+  }
+  return group;
+}
+
+TEST(AllToAllThunkTest, MultipleOperands) {
+  std::vector<BufferAllocation> allocations;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      AllToAllThunk::Create(
+          {"all-to-all"},
+          {/*op_id=*/0, /*has_channel_id=*/false, std::nullopt, {}},
+          MakeOpBuffers(/*num_operands=*/kNumDevices, allocations)));
+
+  std::vector<DeviceBuffers> buffers =
+      MakeDeviceBuffers(/*num_operands=*/kNumDevices);
+  ExecuteOnAllDevices(*thunk, buffers);
+
+  // Device `d` receives chunk `d` of every device, ordered by sender.
+  for (int device = 0; device < kNumDevices; ++device) {
+    for (int sender = 0; sender < kNumDevices; ++sender) {
+      EXPECT_EQ(buffers[device].destinations[sender],
+                buffers[sender].sources[device]);
+    }
+  }
+}
+
+TEST(AllToAllThunkTest, UnorderedReplicaGroups) {
+  std::vector<ReplicaGroup> groups = {MakeReplicaGroup({0, 3}),
+                                      MakeReplicaGroup({2, 1})};
+
+  std::vector<BufferAllocation> allocations;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      AllToAllThunk::Create(
+          {"all-to-all"},
+          {/*op_id=*/0, /*has_channel_id=*/false, std::nullopt, groups},
+          MakeOpBuffers(/*num_operands=*/2, allocations)));
+
+  std::vector<DeviceBuffers> buffers = MakeDeviceBuffers(/*num_operands=*/2);
+  ExecuteOnAllDevices(*thunk, buffers);
+
+  // Chunks are exchanged by rank within the group, not by replica id.
+  for (const ReplicaGroup& group : groups) {
+    for (int rank = 0; rank < 2; ++rank) {
+      int64_t device = group.replica_ids(rank);
+      for (int sender_rank = 0; sender_rank < 2; ++sender_rank) {
+        int64_t sender = group.replica_ids(sender_rank);
+        EXPECT_EQ(buffers[device].destinations[sender_rank],
+                  buffers[sender].sources[rank]);
+      }
+    }
+  }
+}
+
+TEST(AllToAllThunkTest, RejectsChunksOfDifferentSizes) {
+  std::vector<BufferAllocation> allocations;
+  CollectiveThunk::OpBuffers op_buffers =
+      MakeOpBuffers(/*num_operands=*/2, allocations);
+  op_buffers.destination_shapes.back() =
+      ShapeUtil::MakeShape(S32, {2 * kNumElements});
+
+  auto thunk = AllToAllThunk::Create(
+      {"all-to-all"},
+      {/*op_id=*/0, /*has_channel_id=*/false, std::nullopt, {}},
+      std::move(op_buffers));
+  EXPECT_EQ(thunk.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace xla::cpu
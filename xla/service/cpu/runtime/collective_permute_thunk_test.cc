@@ -0,0 +1,213 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/collective_permute_thunk.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xla/executable_run_options.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/computation_placer.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/collective_thunk.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+constexpr int kNumDevices = 4;
+constexpr int64_t kNumElements = 2;
+
+// Buffers of a single device: operand `i` is copied from `sources[i]` into
+// `destinations[i]`.
+struct DeviceBuffers {
+  std::vector<std::vector<int32_t>> sources;
+  std::vector<std::vector<int32_t>> destinations;
+};
+
+// Returns buffers for `num_operands` operands with device-unique source data
+// and destinations filled with a sentinel value.
+std::vector<DeviceBuffers> MakeDeviceBuffers(int num_operands) {
+  std::vector<DeviceBuffers> buffers(kNumDevices);
+  for (int device = 0; device < kNumDevices; ++device) {
+    for (int i = 0; i < num_operands; ++i) {
+      int32_t base = 100 * device + 10 * i;
+      buffers[device].sources.push_back({base, base + 1});
+      buffers[device].destinations.push_back({-1, -1});
+    }
+  }
+  return buffers;
+}
+
+// Returns op buffers for `num_operands` operands, with sources assigned to
+// allocations [0, num_operands) and destinations to the ones after them.
+CollectiveThunk::OpBuffers MakeOpBuffers(
+    int num_operands, std::vector<BufferAllocation>& allocations) {
+  size_t size_in_bytes = kNumElements * sizeof(int32_t);
+  Shape shape = ShapeUtil::MakeShape(S32, {kNumElements});
+
+  allocations.reserve(2 * num_operands);
+  for (int i = 0; i < 2 * num_operands; ++i) {
+    allocations.emplace_back(i, size_in_bytes, 0);
+  }
+
+  CollectiveThunk::OpBuffers op_buffers;
+  for (int i = 0; i < num_operands; ++i) {
+    op_buffers.source_buffers.emplace_back(&allocations[i], 0, size_in_bytes);
+    op_buffers.source_shapes.push_back(shape);
+    op_buffers.destination_buffers.emplace_back(
+        &allocations[num_operands + i], 0, size_in_bytes);
+    op_buffers.destination_shapes.push_back(shape);
+  }
+  return op_buffers;
+}
+
+// Executes `thunk` concurrently on all replicas using in-process collectives.
+void ExecuteOnAllDevices(Thunk& thunk, std::vector<DeviceBuffers>& buffers) {
+  DeviceAssignment device_assignment(kNumDevices, 1);
+  for (int device = 0; device < kNumDevices; ++device) {
+    device_assignment(device, 0) = device;
+  }
+
+  std::vector<absl::Status> statuses(kNumDevices);
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "devices",
+                                        kNumDevices);
+    for (int device = 0; device < kNumDevices; ++device) {
+      thread_pool.Schedule([&, device] {
+        std::vector<MaybeOwningDeviceMemory> memory;
+        for (auto* data : {&buffers[device].sources,
+                           &buffers[device].destinations}) {
+          for (std::vector<int32_t>& buffer : *data) {
+            memory.emplace_back(se::DeviceMemoryBase(
+                buffer.data(), buffer.size() * sizeof(int32_t)));
+          }
+        }
+        BufferAllocations allocations(memory);
+
+        ExecutableRunOptions run_options;
+        run_options.set_device_ordinal(device);
+        run_options.set_device_assignment(&device_assignment);
+        run_options.set_run_id(RunId(0));
+
+        absl::StatusOr<Thunk::CollectiveExecuteParams> collective_params =
+            Thunk::CollectiveExecuteParams::Create(&run_options);
+        if (!collective_params.ok()) {
+          statuses[device] = collective_params.status();
+          return;
+        }
+
+        Thunk::ExecuteParams params;
+        params.buffer_allocations = &allocations;
+        params.collective_params = &*collective_params;
+
+        auto execute_event = thunk.Execute(params);
+        tsl::BlockUntilReady(execute_event);
+        statuses[device] = execute_event.IsError() ? execute_event.GetError()
+                                                   : absl::OkStatus();
+      });
+    }
+  }
+
+  for (const absl::Status& status : statuses) {
+    TF_EXPECT_OK(status);
+  }
+}
+
+TEST(CollectivePermuteThunkTest, UnevenSourceTargetPairs) {
+  // Device 1 only receives and device 3 only sends, so device 3 must get its
+  // destination zeroed.
+  std::vector<std::pair<int64_t, int64_t>> source_target_pairs = {
+      {0, 2}, {2, 1}, {3, 0}};
+
+  std::vector<BufferAllocation> allocations;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      CollectivePermuteThunk::Create(
+          {"collective-permute"},
+          {/*op_id=*/0, /*has_channel_id=*/false, std::nullopt, {}},
+          MakeOpBuffers(/*num_operands=*/1, allocations),
+          source_target_pairs));
+
+  std::vector<DeviceBuffers> buffers = MakeDeviceBuffers(/*num_operands=*/1);
+  ExecuteOnAllDevices(*thunk, buffers);
+
+  EXPECT_EQ(buffers[0].destinations[0], buffers[3].sources[0]);
+  EXPECT_EQ(buffers[1].destinations[0], buffers[2].sources[0]);
+  EXPECT_EQ(buffers[2].destinations[0], buffers[0].sources[0]);
+  EXPECT_THAT(buffers[3].destinations[0], ElementsAre(0, 0));
+}
+
+TEST(CollectivePermuteThunkTest, OneSourceManyTargetsMultipleOperands) {
+  std::vector<std::pair<int64_t, int64_t>> source_target_pairs = {
+      {0, 1}, {0, 2}, {0, 3}};
+
+  std::vector<BufferAllocation> allocations;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      CollectivePermuteThunk::Create(
+          {"collective-permute"},
+          {/*op_id=*/0, /*has_channel_id=*/false, std::nullopt, {}},
+          MakeOpBuffers(/*num_operands=*/2, allocations),
+          source_target_pairs));
+
+  std::vector<DeviceBuffers> buffers = MakeDeviceBuffers(/*num_operands=*/2);
+  ExecuteOnAllDevices(*thunk, buffers);
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(buffers[0].destinations[i], ElementsAre(0, 0));
+    for (int device = 1; device < kNumDevices; ++device) {
+      EXPECT_THAT(buffers[device].destinations[i],
+                  ElementsAreArray(buffers[0].sources[i]));
+    }
+  }
+}
+
+TEST(CollectivePermuteThunkTest, RejectsMismatchedBuffers) {
+  std::vector<BufferAllocation> allocations;
+  CollectiveThunk::OpBuffers op_buffers =
+      MakeOpBuffers(/*num_operands=*/2, allocations);
+  op_buffers.destination_buffers.pop_back();
+  op_buffers.destination_shapes.pop_back();
+  std::vector<std::pair<int64_t, int64_t>> source_target_pairs = {{0, 1}};
+
+  auto thunk = CollectivePermuteThunk::Create(
+      {"collective-permute"},
+      {/*op_id=*/0, /*has_channel_id=*/false, std::nullopt, {}},
+      std::move(op_buffers), source_target_pairs);
+  EXPECT_EQ(thunk.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace xla::cpu
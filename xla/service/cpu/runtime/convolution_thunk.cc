@@ -0,0 +1,356 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/convolution_thunk.h"
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "Eigen/Core"  // from @eigen_archive
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+#include "xla/layout_util.h"
+#include "xla/runtime/buffer_use.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/cpu/runtime_conv2d_mkl.h"
+#include "xla/service/cpu/runtime_conv_impl.h"
+#include "xla/shape.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace xla::cpu {
+namespace {
+
+// Keeps track of pending convolution tasks and an event that signals completion
+// of the convolution operation to the caller.
+struct ExecuteState {
+  explicit ExecuteState(int64_t num_tasks)
+      : pending_tasks(num_tasks),
+        event(tsl::MakeConstructedAsyncValueRef<Thunk::ExecuteEvent>()) {}
+
+  void Notify() {
+    if (pending_tasks.load(std::memory_order_relaxed) == 1 ||
+        pending_tasks.fetch_sub(1, std::memory_order_relaxed) == 1) {
+      event.SetStateConcrete();
+    }
+  }
+
+  std::atomic<int64_t> pending_tasks;
+  tsl::AsyncValueRef<Thunk::ExecuteEvent> event;
+};
+
+}  // namespace
+
+bool ConvolutionThunk::IsSupportedElementType(PrimitiveType type) {
+  return type == F16 || type == F32;
+}
+
+absl::StatusOr<std::unique_ptr<ConvolutionThunk>> ConvolutionThunk::Create(
+    Info info, Options options, BufferAllocation::Slice input_buffer,
+    const Shape& input_shape, BufferAllocation::Slice kernel_buffer,
+    const Shape& kernel_shape, BufferAllocation::Slice output_buffer,
+    const Shape& output_shape, const ConvolutionDimensionNumbers& dnums,
+    const Window& window, int64_t feature_group_count) {
+  PrimitiveType element_type = input_shape.element_type();
+  if (!IsSupportedElementType(element_type) ||
+      kernel_shape.element_type() != element_type ||
+      output_shape.element_type() != element_type) {
+    return InvalidArgument(
+        "ConvolutionThunk requires F16 or F32 operands of the same type: "
+        "input_shape=[%s], kernel_shape=[%s], output_shape=[%s]",
+        input_shape.ToString(true), kernel_shape.ToString(true),
+        output_shape.ToString(true));
+  }
+
+  // All shapes must be in dim0-major layout.
+  if (!LayoutUtil::IsMonotonicWithDim0Major(input_shape.layout()) ||
+      !LayoutUtil::IsMonotonicWithDim0Major(kernel_shape.layout()) ||
+      !LayoutUtil::IsMonotonicWithDim0Major(output_shape.layout())) {
+    return InvalidArgument(
+        "ConvolutionThunk requires all operands and outputs to be in "
+        "dim0-major layout: input_shape=[%s], kernel_shape=[%s], "
+        "output_shape=[%s]",
+        input_shape.ToString(true), kernel_shape.ToString(true),
+        output_shape.ToString(true));
+  }
+
+  int64_t num_spatial_dims = dnums.input_spatial_dimensions_size();
+  if (num_spatial_dims < 1 || num_spatial_dims > 3 ||
+      window.dimensions_size() != num_spatial_dims) {
+    return InvalidArgument(
+        "ConvolutionThunk supports only 1D, 2D and 3D convolutions: "
+        "num_spatial_dims=%d, window_dims=%d",
+        num_spatial_dims, window.dimensions_size());
+  }
+
+  Dims dims;
+
+  // We execute 1D convolutions as 2D convolutions with the leading spatial
+  // dimension of size 1 and adjust padding and dilation parameters accordingly.
+  if (num_spatial_dims == 1) {
+    dims.input_dims.push_back(1);
+    dims.kernel_dims.push_back(1);
+    dims.output_dims.push_back(1);
+    dims.strides.push_back(1);
+    dims.padding_before.push_back(0);
+    dims.padding_after.push_back(0);
+    dims.base_dilation.push_back(1);
+    dims.window_dilation.push_back(1);
+  }
+
+  // Input tensor.
+  dims.input_batch = input_shape.dimensions(dnums.input_batch_dimension());
+  for (int64_t d : dnums.input_spatial_dimensions()) {
+    dims.input_dims.push_back(input_shape.dimensions(d));
+  }
+  dims.input_channels = input_shape.dimensions(dnums.input_feature_dimension());
+
+  // Kernel tensor.
+  for (int64_t d : dnums.kernel_spatial_dimensions()) {
+    dims.kernel_dims.push_back(kernel_shape.dimensions(d));
+  }
+  dims.kernel_channels =
+      kernel_shape.dimensions(dnums.kernel_input_feature_dimension());
+  dims.kernel_filters =
+      kernel_shape.dimensions(dnums.kernel_output_feature_dimension());
+
+  // Output tensor.
+  for (int64_t d : dnums.output_spatial_dimensions()) {
+    dims.output_dims.push_back(output_shape.dimensions(d));
+  }
+
+  // Convolution window.
+  for (const WindowDimension& d : window.dimensions()) {
+    dims.strides.push_back(d.stride());
+    dims.padding_before.push_back(d.padding_low());
+    dims.padding_after.push_back(d.padding_high());
+    dims.base_dilation.push_back(d.base_dilation());
+    dims.window_dilation.push_back(d.window_dilation());
+  }
+
+  dims.feature_group_count = feature_group_count;
+
+  // oneDNN is used only for multi-threaded 2D F32 convolutions without feature
+  // groups, all other convolutions fall back to Eigen.
+  options.use_mkl_dnn = options.use_mkl_dnn && options.multi_threaded &&
+                        element_type == F32 && dims.input_dims.size() == 2 &&
+                        feature_group_count == 1;
+
+  return absl::WrapUnique(new ConvolutionThunk(
+      std::move(info), options, input_buffer, input_shape, kernel_buffer,
+      kernel_shape, output_buffer, output_shape, std::move(dims)));
+}
+
+ConvolutionThunk::ConvolutionThunk(
+    Info info, Options options, BufferAllocation::Slice input_buffer,
+    const Shape& input_shape, BufferAllocation::Slice kernel_buffer,
+    const Shape& kernel_shape, BufferAllocation::Slice output_buffer,
+    const Shape& output_shape, Dims dims)
+    : Thunk(Kind::kConvolution, std::move(info)),
+      options_(options),
+      input_buffer_(input_buffer),
+      input_shape_(input_shape),
+      kernel_buffer_(kernel_buffer),
+      kernel_shape_(kernel_shape),
+      output_buffer_(output_buffer),
+      output_shape_(output_shape),
+      dims_(std::move(dims)) {}
+
+template <typename T, typename EigenDevice>
+void ConvolutionThunk::EigenConvolution(
+    const EigenDevice& device, T* out, T* lhs, T* rhs, int64_t batch,
+    std::optional<std::function<void()>> done_callback) const {
+  const Dims& d = dims_;
+
+  if (d.input_dims.size() == 2) {
+    tensorflow::xla::EigenConv2DImpl(
+        device, out, lhs, rhs, batch, d.input_dims[0], d.input_dims[1],
+        d.input_channels, d.kernel_dims[0], d.kernel_dims[1],
+        d.kernel_channels, d.kernel_filters, d.output_dims[0],
+        d.output_dims[1], d.strides[0], d.strides[1], d.padding_before[0],
+        d.padding_after[0], d.padding_before[1], d.padding_after[1],
+        d.base_dilation[0], d.base_dilation[1], d.window_dilation[0],
+        d.window_dilation[1], d.feature_group_count, std::move(done_callback));
+  } else {
+    tensorflow::xla::EigenConv3DImpl(
+        device, out, lhs, rhs, batch, d.input_dims[0], d.input_dims[1],
+        d.input_dims[2], d.input_channels, d.kernel_dims[0], d.kernel_dims[1],
+        d.kernel_dims[2], d.kernel_channels, d.kernel_filters,
+        d.output_dims[0], d.output_dims[1], d.output_dims[2], d.strides[0],
+        d.strides[1], d.strides[2], d.padding_before[0], d.padding_after[0],
+        d.padding_before[1], d.padding_after[1], d.padding_before[2],
+        d.padding_after[2], d.base_dilation[0], d.base_dilation[1],
+        d.base_dilation[2], d.window_dilation[0], d.window_dilation[1],
+        d.window_dilation[2], d.feature_group_count, std::move(done_callback));
+  }
+}
+
+template <typename T>
+tsl::AsyncValueRef<Thunk::ExecuteEvent>
+ConvolutionThunk::ParallelBatchConvolution(
+    const Eigen::ThreadPoolDevice* device, T* out, T* lhs, T* rhs) const {
+  const Dims& d = dims_;
+
+  // Input and output tensors are in dim0-major layout with the batch dimension
+  // being the outermost one, so we can split them into contiguous sub-batches.
+  int64_t input_stride = d.input_channels;
+  for (int64_t dim : d.input_dims) input_stride *= dim;
+
+  int64_t output_stride = d.kernel_filters;
+  for (int64_t dim : d.output_dims) output_stride *= dim;
+
+  // Eigen convolution kernels require 16-byte aligned buffers, so we split the
+  // batch into blocks that keep all sub-batch pointers aligned.
+  auto aligned_step = [](int64_t stride) {
+    return 16 / std::gcd<int64_t, int64_t>(stride * sizeof(T), 16);
+  };
+  int64_t step =
+      std::lcm(aligned_step(input_stride), aligned_step(output_stride));
+  int64_t num_blocks = CeilOfRatio(d.input_batch, step);
+
+  int64_t num_tasks = std::max<int64_t>(
+      1, std::min<int64_t>(num_blocks, device->numThreads()));
+
+  auto state = std::make_shared<ExecuteState>(num_tasks);
+
+  for (int64_t i = 0; i < num_tasks; ++i) {
+    int64_t begin = std::min(d.input_batch, num_blocks * i / num_tasks * step);
+    int64_t end =
+        std::min(d.input_batch, num_blocks * (i + 1) / num_tasks * step);
+
+    device->getPool()->Schedule([this, state, begin, end, input_stride,
+                                 output_stride, out, lhs, rhs] {
+      EigenConvolution(Eigen::DefaultDevice(), out + begin * output_stride,
+                       lhs + begin * input_stride, rhs, end - begin,
+                       std::nullopt);
+      state->Notify();
+    });
+  }
+
+  return state->event;
+}
+
+tsl::AsyncValueRef<Thunk::ExecuteEvent> ConvolutionThunk::Execute(
+    const ExecuteParams& params) {
+  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+
+  TF_ASSIGN_OR_RETURN(
+      se::DeviceMemoryBase input_data,
+      params.buffer_allocations->GetDeviceAddress(input_buffer_));
+  TF_ASSIGN_OR_RETURN(
+      se::DeviceMemoryBase kernel_data,
+      params.buffer_allocations->GetDeviceAddress(kernel_buffer_));
+  TF_ASSIGN_OR_RETURN(
+      se::DeviceMemoryBase output_data,
+      params.buffer_allocations->GetDeviceAddress(output_buffer_));
+
+  void* out = output_data.opaque();
+  void* lhs = input_data.opaque();
+  void* rhs = kernel_data.opaque();
+
+  if (options_.multi_threaded && params.intra_op_threadpool == nullptr) {
+    return InvalidArgument(
+        "Intra-op threadpool must be provided for multi-threaded "
+        "ConvolutionThunk");
+  }
+
+  // oneDNN convolution manages its own threads and completes synchronously.
+  if (options_.use_mkl_dnn) {
+    ExecutableRunOptions run_options;
+    run_options.set_intra_op_thread_pool(params.intra_op_threadpool);
+
+    const Dims& d = dims_;
+    __xla_cpu_runtime_MKLConv2DF32(
+        &run_options, static_cast<float*>(out), static_cast<float*>(lhs),
+        static_cast<float*>(rhs), d.input_batch, d.input_dims[0],
+        d.input_dims[1], d.input_channels, d.kernel_dims[0], d.kernel_dims[1],
+        d.kernel_channels, d.kernel_filters, d.output_dims[0],
+        d.output_dims[1], d.strides[0], d.strides[1], d.padding_before[0],
+        d.padding_after[0], d.padding_before[1], d.padding_after[1],
+        d.base_dilation[0], d.base_dilation[1], d.window_dilation[0],
+        d.window_dilation[1]);
+    return OkExecuteEvent();
+  }
+
+  PrimitiveType element_type = input_shape_.element_type();
+
+  // Single-threaded convolution runs in the caller thread.
+  if (!options_.multi_threaded) {
+    Eigen::DefaultDevice device;
+    if (element_type == F16) {
+      EigenConvolution(device, static_cast<Eigen::half*>(out),
+                       static_cast<Eigen::half*>(lhs),
+                       static_cast<Eigen::half*>(rhs), dims_.input_batch,
+                       std::nullopt);
+    } else {
+      EigenConvolution(device, static_cast<float*>(out),
+                       static_cast<float*>(lhs), static_cast<float*>(rhs),
+                       dims_.input_batch, std::nullopt);
+    }
+    return OkExecuteEvent();
+  }
+
+  // Multi-threaded 2D convolutions without feature groups are launched
+  // asynchronously in the intra-op thread pool, and we never block the caller
+  // thread waiting for results.
+  if (dims_.input_dims.size() == 2 && dims_.feature_group_count == 1) {
+    auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+    std::function<void()> done = [event] { event.SetStateConcrete(); };
+
+    if (element_type == F16) {
+      EigenConvolution(*params.intra_op_threadpool,
+                       static_cast<Eigen::half*>(out),
+                       static_cast<Eigen::half*>(lhs),
+                       static_cast<Eigen::half*>(rhs), dims_.input_batch,
+                       std::move(done));
+    } else {
+      EigenConvolution(*params.intra_op_threadpool, static_cast<float*>(out),
+                       static_cast<float*>(lhs), static_cast<float*>(rhs),
+                       dims_.input_batch, std::move(done));
+    }
+    return event;
+  }
+
+  // Eigen can't evaluate grouped and 3D convolutions asynchronously, and
+  // blocking on the intra-op thread pool from a thunk might deadlock, so we
+  // parallelize them over the input batch instead.
+  if (element_type == F16) {
+    return ParallelBatchConvolution(params.intra_op_threadpool,
+                                    static_cast<Eigen::half*>(out),
+                                    static_cast<Eigen::half*>(lhs),
+                                    static_cast<Eigen::half*>(rhs));
+  }
+  return ParallelBatchConvolution(params.intra_op_threadpool,
+                                  static_cast<float*>(out),
+                                  static_cast<float*>(lhs),
+                                  static_cast<float*>(rhs));
+}
+
+}  // namespace xla::cpu
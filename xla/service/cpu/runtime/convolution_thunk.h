@@ -0,0 +1,130 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_CONVOLUTION_THUNK_H_
+#define XLA_SERVICE_CPU_RUNTIME_CONVOLUTION_THUNK_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/statusor.h"
+#include "xla/runtime/buffer_use.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/shape.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla::cpu {
+
+// Performs 1D, 2D or 3D convolution using Eigen convolution kernels shared with
+// the XLA:CPU jit-compiled runtime (or oneDNN for 2D F32 convolutions if
+// enabled). 1D convolutions are executed as 2D convolutions with an extra
+// spatial dimension of size 1.
+//
+// Multi-threaded convolutions are launched asynchronously in the intra-op
+// thread pool, and the returned execute event becomes available when all
+// convolution tasks are completed.
+class ConvolutionThunk final : public Thunk {
+ public:
+  struct Options {
+    bool multi_threaded = false;
+    bool use_mkl_dnn = false;
+  };
+
+  static absl::StatusOr<std::unique_ptr<ConvolutionThunk>> Create(
+      Info info, Options options, BufferAllocation::Slice input_buffer,
+      const Shape& input_shape, BufferAllocation::Slice kernel_buffer,
+      const Shape& kernel_shape, BufferAllocation::Slice output_buffer,
+      const Shape& output_shape, const ConvolutionDimensionNumbers& dnums,
+      const Window& window, int64_t feature_group_count);
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
+
+  BufferUses buffer_uses() const final {
+    return {BufferUse::Read(input_buffer_), BufferUse::Read(kernel_buffer_),
+            BufferUse::Write(output_buffer_)};
+  }
+
+  // Returns true if the convolution of the given element type can be
+  // executed by the convolution thunk.
+  static bool IsSupportedElementType(PrimitiveType type);
+
+ private:
+  // Convolution dimensions canonicalized to match the ABI of Eigen convolution
+  // kernels. All spatial vectors have 2 (2D convolution) or 3 (3D convolution)
+  // elements.
+  struct Dims {
+    int64_t input_batch;
+    absl::InlinedVector<int64_t, 3> input_dims;
+    int64_t input_channels;
+
+    absl::InlinedVector<int64_t, 3> kernel_dims;
+    int64_t kernel_channels;
+    int64_t kernel_filters;
+
+    absl::InlinedVector<int64_t, 3> output_dims;
+
+    absl::InlinedVector<int64_t, 3> strides;
+    absl::InlinedVector<int64_t, 3> padding_before;
+    absl::InlinedVector<int64_t, 3> padding_after;
+    absl::InlinedVector<int64_t, 3> base_dilation;
+    absl::InlinedVector<int64_t, 3> window_dilation;
+
+    int64_t feature_group_count;
+  };
+
+  ConvolutionThunk(Info info, Options options,
+                   BufferAllocation::Slice input_buffer,
+                   const Shape& input_shape,
+                   BufferAllocation::Slice kernel_buffer,
+                   const Shape& kernel_shape,
+                   BufferAllocation::Slice output_buffer,
+                   const Shape& output_shape, Dims dims);
+
+  // Runs Eigen convolution for `batch` input images on the given device. If
+  // `done_callback` is not empty, it is called on completion, and convolution
+  // might be launched asynchronously (see runtime_conv_impl.h for details).
+  template <typename T, typename EigenDevice>
+  void EigenConvolution(
+      const EigenDevice& device, T* out, T* lhs, T* rhs, int64_t batch,
+      std::optional<std::function<void()>> done_callback) const;
+
+  // Launches Eigen convolution in the intra-op thread pool by splitting input
+  // batch into independent single-threaded convolution tasks.
+  template <typename T>
+  tsl::AsyncValueRef<ExecuteEvent> ParallelBatchConvolution(
+      const Eigen::ThreadPoolDevice* device, T* out, T* lhs, T* rhs) const;
+
+  Options options_;
+
+  BufferAllocation::Slice input_buffer_;
+  Shape input_shape_;
+
+  BufferAllocation::Slice kernel_buffer_;
+  Shape kernel_shape_;
+
+  BufferAllocation::Slice output_buffer_;
+  Shape output_shape_;
+
+  Dims dims_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_CONVOLUTION_THUNK_H_
@@ -0,0 +1,171 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/convolution_thunk.h"
+
+#define EIGEN_USE_THREADS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+// Convolution dimension numbers for NHWC input, HWIO kernel and NHWC output.
+ConvolutionDimensionNumbers MakeConvolutionDimensionNumbers() {
+  ConvolutionDimensionNumbers dnums;
+  dnums.set_input_batch_dimension(0);
+  dnums.add_input_spatial_dimensions(1);
+  dnums.add_input_spatial_dimensions(2);
+  dnums.set_input_feature_dimension(3);
+  dnums.add_kernel_spatial_dimensions(0);
+  dnums.add_kernel_spatial_dimensions(1);
+  dnums.set_kernel_input_feature_dimension(2);
+  dnums.set_kernel_output_feature_dimension(3);
+  dnums.set_output_batch_dimension(0);
+  dnums.add_output_spatial_dimensions(1);
+  dnums.add_output_spatial_dimensions(2);
+  dnums.set_output_feature_dimension(3);
+  return dnums;
+}
+
+Window MakeWindow(int64_t size) {
+  Window window;
+  for (int64_t i = 0; i < 2; ++i) {
+    WindowDimension* dim = window.add_dimensions();
+    dim->set_size(size);
+    dim->set_stride(1);
+    dim->set_padding_low(0);
+    dim->set_padding_high(0);
+    dim->set_window_dilation(1);
+    dim->set_base_dilation(1);
+  }
+  return window;
+}
+
+// Runs 3x3 convolution of all-ones input and kernel and returns the output.
+absl::StatusOr<std::vector<float>> RunConvolution(
+    ConvolutionThunk::Options options, int64_t batch, int64_t input_channels,
+    int64_t output_channels, int64_t feature_group_count) {
+  std::vector<float> input(batch * 4 * 4 * input_channels, 1.0f);
+  std::vector<float> kernel(
+      3 * 3 * (input_channels / feature_group_count) * output_channels, 1.0f);
+  std::vector<float> output(batch * 2 * 2 * output_channels, 0.0f);
+
+  size_t input_size = input.size() * sizeof(float);
+  size_t kernel_size = kernel.size() * sizeof(float);
+  size_t output_size = output.size() * sizeof(float);
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(se::DeviceMemoryBase(input.data(), input_size));
+  buffers.emplace_back(se::DeviceMemoryBase(kernel.data(), kernel_size));
+  buffers.emplace_back(se::DeviceMemoryBase(output.data(), output_size));
+
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation input_alloc(0, input_size, 0);
+  BufferAllocation kernel_alloc(1, kernel_size, 0);
+  BufferAllocation output_alloc(2, output_size, 0);
+
+  BufferAllocation::Slice input_slice(&input_alloc, 0, input_size);
+  BufferAllocation::Slice kernel_slice(&kernel_alloc, 0, kernel_size);
+  BufferAllocation::Slice output_slice(&output_alloc, 0, output_size);
+
+  Shape input_shape = ShapeUtil::MakeShape(F32, {batch, 4, 4, input_channels});
+  Shape kernel_shape = ShapeUtil::MakeShape(
+      F32, {3, 3, input_channels / feature_group_count, output_channels});
+  Shape output_shape =
+      ShapeUtil::MakeShape(F32, {batch, 2, 2, output_channels});
+
+  TF_ASSIGN_OR_RETURN(
+      auto thunk,
+      ConvolutionThunk::Create(
+          {"convolution"}, options, input_slice, input_shape, kernel_slice,
+          kernel_shape, output_slice, output_shape,
+          MakeConvolutionDimensionNumbers(), MakeWindow(3),
+          feature_group_count));
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "conv", 8);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  Thunk::ExecuteParams params = {nullptr, &allocations, nullptr, &device};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  if (execute_event.IsError()) return execute_event.GetError();
+
+  return output;
+}
+
+TEST(ConvolutionThunkTest, SingleThreaded) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<float> output,
+      RunConvolution({/*multi_threaded=*/false}, /*batch=*/2,
+                     /*input_channels=*/2, /*output_channels=*/3,
+                     /*feature_group_count=*/1));
+  EXPECT_EQ(output, std::vector<float>(2 * 2 * 2 * 3, 18.0f));
+}
+
+TEST(ConvolutionThunkTest, MultiThreaded) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<float> output,
+      RunConvolution({/*multi_threaded=*/true}, /*batch=*/2,
+                     /*input_channels=*/2, /*output_channels=*/3,
+                     /*feature_group_count=*/1));
+  EXPECT_EQ(output, std::vector<float>(2 * 2 * 2 * 3, 18.0f));
+}
+
+TEST(ConvolutionThunkTest, MultiThreadedFeatureGroups) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<float> output,
+      RunConvolution({/*multi_threaded=*/true}, /*batch=*/5,
+                     /*input_channels=*/4, /*output_channels=*/4,
+                     /*feature_group_count=*/2));
+  EXPECT_EQ(output, std::vector<float>(5 * 2 * 2 * 4, 18.0f));
+}
+
+TEST(ConvolutionThunkTest, RejectsUnsupportedElementType) {
+  BufferAllocation alloc(0, 1024, 0);
+  BufferAllocation::Slice slice(&alloc, 0, 1024);
+
+  Shape shape = ShapeUtil::MakeShape(S32, {1, 4, 4, 1});
+  auto thunk = ConvolutionThunk::Create(
+      {"convolution"}, {}, slice, shape, slice, shape, slice, shape,
+      MakeConvolutionDimensionNumbers(), MakeWindow(3),
+      /*feature_group_count=*/1);
+  EXPECT_FALSE(thunk.ok());
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -0,0 +1,283 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/custom_call_thunk.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "mlir/AsmParser/AsmParser.h"  // from @llvm-project
+#include "mlir/IR/Attributes.h"  // from @llvm-project
+#include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
+#include "mlir/IR/MLIRContext.h"  // from @llvm-project
+#include "xla/ffi/api/c_api.h"
+#include "xla/ffi/attribute_map.h"
+#include "xla/ffi/call_frame.h"
+#include "xla/ffi/ffi_api.h"
+#include "xla/runtime/buffer_use.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/custom_call_status.h"
+#include "xla/service/custom_call_status_internal.h"
+#include "xla/service/custom_call_target_registry.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/util.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace xla::cpu {
+namespace {
+
+// Builds a call frame for a typed FFI custom call with all the attributes
+// decoded from the backend config. Buffers are added with null addresses and
+// are replaced with real buffers at run time (see `CallFrame::CopyWithBuffers`).
+absl::StatusOr<ffi::CallFrame> BuildCallFrame(
+    const CustomCallThunk::OpBuffers& op_buffers,
+    absl::string_view backend_config) {
+  // For FFI handlers backend config must be a compatible MLIR dictionary.
+  mlir::MLIRContext mlir_context;
+  ffi::CallFrameBuilder::FlatAttributesMap attributes;
+  if (!backend_config.empty()) {
+    mlir::Attribute attr = mlir::parseAttribute(backend_config, &mlir_context);
+    if (auto dict = attr.dyn_cast_or_null<mlir::DictionaryAttr>()) {
+      TF_ASSIGN_OR_RETURN(attributes, ffi::BuildAttributesMap(dict));
+    } else {
+      return Internal(
+          "Unsupported backend config. Expected a string parsable into "
+          "dictionary attribute");
+    }
+  }
+
+  ffi::CallFrameBuilder builder;
+
+  ffi::CallFrameBuilder::AttributesBuilder attrs;
+  attrs.Append(std::move(attributes));
+  builder.AddAttributes(attrs.Build());
+
+  for (const Shape& shape : op_buffers.arguments_shapes) {
+    builder.AddBufferArg(
+        se::DeviceMemoryBase(nullptr, ShapeUtil::ByteSizeOf(shape)),
+        shape.element_type(), shape.dimensions());
+  }
+
+  for (const Shape& shape : op_buffers.results_shapes) {
+    builder.AddBufferRet(
+        se::DeviceMemoryBase(nullptr, ShapeUtil::ByteSizeOf(shape)),
+        shape.element_type(), shape.dimensions());
+  }
+
+  return builder.Build();
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<CustomCallThunk>> CustomCallThunk::Create(
+    Info info, absl::string_view target_name, OpBuffers op_buffers,
+    absl::string_view backend_config, CustomCallApiVersion api_version) {
+  if (op_buffers.arguments_buffers.size() !=
+          op_buffers.arguments_shapes.size() ||
+      op_buffers.results_buffers.size() != op_buffers.results_shapes.size()) {
+    return InvalidArgument(
+        "Custom call %s must have the same number of buffers and shapes",
+        target_name);
+  }
+
+  for (const Shape& shape : op_buffers.arguments_shapes) {
+    if (!shape.IsArray()) {
+      return InvalidArgument(
+          "Custom call %s operands must be arrays, got %s", target_name,
+          shape.ToString());
+    }
+  }
+
+  // Typed FFI custom calls: find the handler and pre-build the call frame.
+  if (api_version == CustomCallApiVersion::API_VERSION_TYPED_FFI) {
+    absl::StatusOr<ffi::HandlerRegistration> registration =
+        ffi::FindHandler(target_name, "Host");
+    if (!registration.ok()) {
+      return Unimplemented(
+          "No registered implementation for FFI custom call to %s for Host",
+          target_name);
+    }
+
+    TF_ASSIGN_OR_RETURN(ffi::CallFrame call_frame,
+                        BuildCallFrame(op_buffers, backend_config));
+
+    return absl::WrapUnique(new CustomCallThunk(
+        std::move(info), target_name, std::move(op_buffers),
+        std::string(backend_config), api_version, /*legacy_target=*/nullptr,
+        registration->bundle, std::move(call_frame)));
+  }
+
+  // Legacy custom calls: find the target in the custom call target registry.
+  void* legacy_target = CustomCallTargetRegistry::Global()->Lookup(
+      std::string(target_name), "Host");
+  if (legacy_target == nullptr) {
+    return Unimplemented(
+        "No registered implementation for custom call to %s for Host",
+        target_name);
+  }
+
+  return absl::WrapUnique(new CustomCallThunk(
+      std::move(info), target_name, std::move(op_buffers),
+      std::string(backend_config), api_version, legacy_target,
+      /*bundle=*/std::nullopt, /*call_frame=*/std::nullopt));
+}
+
+CustomCallThunk::CustomCallThunk(Info info, absl::string_view target_name,
+                                 OpBuffers op_buffers,
+                                 std::string backend_config,
+                                 CustomCallApiVersion api_version,
+                                 void* legacy_target,
+                                 std::optional<XLA_FFI_Handler_Bundle> bundle,
+                                 std::optional<ffi::CallFrame> call_frame)
+    : Thunk(Kind::kCustomCall, std::move(info)),
+      target_name_(target_name),
+      op_buffers_(std::move(op_buffers)),
+      backend_config_(std::move(backend_config)),
+      api_version_(api_version),
+      legacy_target_(legacy_target),
+      bundle_(std::move(bundle)),
+      call_frame_(std::move(call_frame)) {}
+
+tsl::AsyncValueRef<Thunk::ExecuteEvent> CustomCallThunk::Execute(
+    const ExecuteParams& params) {
+  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+
+  if (api_version_ == CustomCallApiVersion::API_VERSION_TYPED_FFI) {
+    return CallTypedFfi(params);
+  }
+
+  TF_RETURN_IF_ERROR(CallLegacyTarget(params));
+  return OkExecuteEvent();
+}
+
+tsl::AsyncValueRef<Thunk::ExecuteEvent> CustomCallThunk::CallTypedFfi(
+    const ExecuteParams& params) {
+  absl::InlinedVector<se::DeviceMemoryBase, 8> arguments;
+  arguments.reserve(op_buffers_.arguments_buffers.size());
+  for (const BufferAllocation::Slice& slice : op_buffers_.arguments_buffers) {
+    TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase buffer,
+                        params.buffer_allocations->GetDeviceAddress(slice));
+    arguments.push_back(buffer);
+  }
+
+  absl::InlinedVector<se::DeviceMemoryBase, 4> results;
+  results.reserve(op_buffers_.results_buffers.size());
+  for (const BufferAllocation::Slice& slice : op_buffers_.results_buffers) {
+    TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase buffer,
+                        params.buffer_allocations->GetDeviceAddress(slice));
+    results.push_back(buffer);
+  }
+
+  // Patch pre-built call frame with buffers for this execution.
+  TF_ASSIGN_OR_RETURN(ffi::CallFrame call_frame,
+                      call_frame_->CopyWithBuffers(arguments, results));
+
+  // Forward custom call execute parameters to the FFI handler.
+  ffi::CallOptions call_options;
+  if (const CustomCallExecuteParams* custom_call_params =
+          params.custom_call_params) {
+    call_options.device_ordinal = custom_call_params->device_ordinal;
+    call_options.allocator = custom_call_params->allocator;
+    call_options.execution_context = custom_call_params->ffi_execution_context;
+  }
+
+  return ffi::CallAsync(bundle_->execute, call_frame, call_options);
+}
+
+absl::Status CustomCallThunk::CallLegacyTarget(const ExecuteParams& params) {
+  absl::InlinedVector<const void*, 8> arguments;
+  arguments.reserve(op_buffers_.arguments_buffers.size());
+  for (const BufferAllocation::Slice& slice : op_buffers_.arguments_buffers) {
+    TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase arg,
+                        params.buffer_allocations->GetDeviceAddress(slice));
+    arguments.push_back(arg.opaque());
+  }
+
+  absl::InlinedVector<void*, 4> results;
+  results.reserve(op_buffers_.results_buffers.size());
+  for (const BufferAllocation::Slice& slice : op_buffers_.results_buffers) {
+    TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase res,
+                        params.buffer_allocations->GetDeviceAddress(slice));
+    results.push_back(res.opaque());
+  }
+
+  // For tuple results legacy custom calls expect a pointer to the array of
+  // result buffers, otherwise a pointer to the result buffer itself.
+  void* out = op_buffers_.is_tuple_result ? results.data()
+              : results.empty()           ? nullptr
+                                          : results[0];
+  const void** in = arguments.data();
+
+  using OriginalTarget = void (*)(void*, const void**);
+  using StatusReturningTarget = void (*)(void*, const void**,
+                                         XlaCustomCallStatus*);
+  using UnifiedTarget = void (*)(void*, const void**, const char*, size_t,
+                                 XlaCustomCallStatus*);
+
+  XlaCustomCallStatus status;
+
+  switch (api_version_) {
+    case CustomCallApiVersion::API_VERSION_ORIGINAL:
+      reinterpret_cast<OriginalTarget>(legacy_target_)(out, in);
+      return absl::OkStatus();
+    case CustomCallApiVersion::API_VERSION_STATUS_RETURNING:
+      reinterpret_cast<StatusReturningTarget>(legacy_target_)(out, in,
+                                                              &status);
+      break;
+    case CustomCallApiVersion::API_VERSION_STATUS_RETURNING_UNIFIED:
+      reinterpret_cast<UnifiedTarget>(legacy_target_)(
+          out, in, backend_config_.data(), backend_config_.size(), &status);
+      break;
+    default:
+      return Internal("Unknown custom call API version %s for target %s",
+                      CustomCallApiVersion_Name(api_version_), target_name_);
+  }
+
+  if (std::optional<absl::string_view> message =
+          CustomCallStatusGetMessage(&status)) {
+    return Internal("CustomCall %s failed: %s", target_name_, *message);
+  }
+
+  return absl::OkStatus();
+}
+
+CustomCallThunk::BufferUses CustomCallThunk::buffer_uses() const {
+  BufferUses buffer_uses;
+  for (const BufferAllocation::Slice& slice : op_buffers_.arguments_buffers) {
+    buffer_uses.push_back(BufferUse::Read(slice));
+  }
+  for (const BufferAllocation::Slice& slice : op_buffers_.results_buffers) {
+    buffer_uses.push_back(BufferUse::Write(slice));
+  }
+  return buffer_uses;
+}
+
+}  // namespace xla::cpu
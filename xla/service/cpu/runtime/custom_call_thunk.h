@@ -0,0 +1,92 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_CUSTOM_CALL_THUNK_H_
+#define XLA_SERVICE_CPU_RUNTIME_CUSTOM_CALL_THUNK_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/ffi/api/c_api.h"
+#include "xla/ffi/call_frame.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/shape.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+
+namespace xla::cpu {
+
+// Calls a custom call target registered for the "Host" platform. Supports
+// legacy custom calls registered in the custom call target registry and typed
+// XLA FFI handlers. For FFI handlers the call frame (including all encoded
+// attributes) is built once at construction time, and at run time we only
+// patch it with the buffer addresses, so attributes are never re-encoded.
+class CustomCallThunk final : public Thunk {
+ public:
+  // Buffers and shapes of custom call operands and results. Tuple results are
+  // flattened into a list of array buffers.
+  struct OpBuffers {
+    std::vector<BufferAllocation::Slice> arguments_buffers;
+    std::vector<Shape> arguments_shapes;
+
+    std::vector<BufferAllocation::Slice> results_buffers;
+    std::vector<Shape> results_shapes;
+
+    bool is_tuple_result = false;
+  };
+
+  static absl::StatusOr<std::unique_ptr<CustomCallThunk>> Create(
+      Info info, absl::string_view target_name, OpBuffers op_buffers,
+      absl::string_view backend_config, CustomCallApiVersion api_version);
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
+
+  BufferUses buffer_uses() const final;
+
+ private:
+  CustomCallThunk(Info info, absl::string_view target_name,
+                  OpBuffers op_buffers, std::string backend_config,
+                  CustomCallApiVersion api_version, void* legacy_target,
+                  std::optional<XLA_FFI_Handler_Bundle> bundle,
+                  std::optional<ffi::CallFrame> call_frame);
+
+  absl::Status CallLegacyTarget(const ExecuteParams& params);
+  // Calls typed FFI handler and returns its completion event. Asynchronous FFI
+  // handlers return an event that is not yet available, and thunk executor
+  // keeps running other thunks while the custom call is in flight.
+  tsl::AsyncValueRef<ExecuteEvent> CallTypedFfi(const ExecuteParams& params);
+
+  std::string target_name_;
+  OpBuffers op_buffers_;
+  std::string backend_config_;
+  CustomCallApiVersion api_version_;
+
+  // Address of the legacy custom call target (for all non-FFI API versions).
+  void* legacy_target_;
+
+  // Handler bundle and a pre-built call frame for typed FFI custom calls.
+  std::optional<XLA_FFI_Handler_Bundle> bundle_;
+  std::optional<ffi::CallFrame> call_frame_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_CUSTOM_CALL_THUNK_H_
@@ -0,0 +1,215 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/custom_call_thunk.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/ffi/ffi.h"
+#include "xla/ffi/ffi_api.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/custom_call_status.h"
+#include "xla/service/custom_call_target_registry.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/tsl/concurrency/chain.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla::cpu {
+namespace {
+
+// Legacy custom call that adds the value parsed from the opaque string to
+// every element of the input.
+static void AddOpaque(void* out, const void** in, const char* opaque,
+                      size_t opaque_len, XlaCustomCallStatus* status) {
+  std::string value(opaque, opaque_len);
+  if (value.empty()) {
+    std::string message = "empty opaque";
+    XlaCustomCallStatusSetFailure(status, message.data(), message.size());
+    return;
+  }
+  float increment = std::stof(value);
+  const float* src = static_cast<const float*>(in[0]);
+  float* dst = static_cast<float*>(out);
+  for (size_t i = 0; i < 4; ++i) dst[i] = src[i] + increment;
+}
+
+XLA_CPU_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("__xla_test$$AddOpaque",
+                                             AddOpaque);
+
+// Typed FFI custom call that adds an attribute value to every element.
+static absl::Status AddAttr(ffi::AnyBuffer src, ffi::Result<ffi::AnyBuffer> dst,
+                            float value) {
+  const float* src_data = static_cast<const float*>(src.data.opaque());
+  float* dst_data = static_cast<float*>(dst->data.opaque());
+  for (size_t i = 0; i < 4; ++i) dst_data[i] = src_data[i] + value;
+  return absl::OkStatus();
+}
+
+XLA_FFI_DEFINE_HANDLER(kAddAttr, AddAttr,
+                       ffi::Ffi::Bind()
+                           .Arg<ffi::AnyBuffer>()
+                           .Ret<ffi::AnyBuffer>()
+                           .Attr<float>("value"));
+
+XLA_FFI_REGISTER_HANDLER(ffi::GetXlaFfiApi(), "__xla_test$$AddAttr", "Host",
+                         kAddAttr);
+
+// Completion event returned by the asynchronous typed FFI custom call below.
+static tsl::AsyncValueRef<tsl::Chain>& AsyncCopyEvent() {
+  static auto* event = new tsl::AsyncValueRef<tsl::Chain>();
+  return *event;
+}
+
+// Typed FFI custom call that copies the input to the output and completes
+// when the test makes the completion event available.
+static tsl::AsyncValueRef<tsl::Chain> AsyncCopy(
+    ffi::AnyBuffer src, ffi::Result<ffi::AnyBuffer> dst) {
+  std::memcpy(dst->data.opaque(), src.data.opaque(), 4 * sizeof(float));
+  return AsyncCopyEvent();
+}
+
+XLA_FFI_DEFINE_HANDLER(kAsyncCopy, AsyncCopy,
+                       ffi::Ffi::Bind()
+                           .Arg<ffi::AnyBuffer>()
+                           .Ret<ffi::AnyBuffer>());
+
+XLA_FFI_REGISTER_HANDLER(ffi::GetXlaFfiApi(), "__xla_test$$AsyncCopy", "Host",
+                         kAsyncCopy);
+
+class CustomCallThunkTest : public ::testing::Test {
+ protected:
+  CustomCallThunkTest()
+      : size_in_bytes_(src_.size() * sizeof(float)),
+        src_alloc_(0, size_in_bytes_, 0),
+        dst_alloc_(1, size_in_bytes_, 0) {
+    buffers_.emplace_back(se::DeviceMemoryBase(src_.data(), size_in_bytes_));
+    buffers_.emplace_back(se::DeviceMemoryBase(dst_.data(), size_in_bytes_));
+  }
+
+  CustomCallThunk::OpBuffers op_buffers() {
+    Shape shape = ShapeUtil::MakeShape(F32, {2, 2});
+    CustomCallThunk::OpBuffers op_buffers;
+    op_buffers.arguments_buffers = {
+        BufferAllocation::Slice(&src_alloc_, 0, size_in_bytes_)};
+    op_buffers.arguments_shapes = {shape};
+    op_buffers.results_buffers = {
+        BufferAllocation::Slice(&dst_alloc_, 0, size_in_bytes_)};
+    op_buffers.results_shapes = {shape};
+    return op_buffers;
+  }
+
+  std::vector<float> src_ = {1.0, 2.0, 3.0, 4.0};
+  std::vector<float> dst_ = std::vector<float>(4, 0.0);
+  size_t size_in_bytes_;
+
+  BufferAllocation src_alloc_;
+  BufferAllocation dst_alloc_;
+  std::vector<MaybeOwningDeviceMemory> buffers_;
+};
+
+TEST_F(CustomCallThunkTest, LegacyCustomCall) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      CustomCallThunk::Create(
+          {"custom-call"}, "__xla_test$$AddOpaque", op_buffers(), "10",
+          CustomCallApiVersion::API_VERSION_STATUS_RETURNING_UNIFIED));
+
+  BufferAllocations allocations(buffers_);
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_EQ(dst_, std::vector<float>({11.0, 12.0, 13.0, 14.0}));
+}
+
+TEST_F(CustomCallThunkTest, LegacyCustomCallFailure) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      CustomCallThunk::Create(
+          {"custom-call"}, "__xla_test$$AddOpaque", op_buffers(), "",
+          CustomCallApiVersion::API_VERSION_STATUS_RETURNING_UNIFIED));
+
+  BufferAllocations allocations(buffers_);
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_TRUE(execute_event.IsError());
+  EXPECT_EQ(execute_event.GetError().code(), absl::StatusCode::kInternal);
+}
+
+TEST_F(CustomCallThunkTest, TypedFfiCustomCall) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, CustomCallThunk::Create(
+                      {"custom-call"}, "__xla_test$$AddAttr", op_buffers(),
+                      "{value = 42.0 : f32}",
+                      CustomCallApiVersion::API_VERSION_TYPED_FFI));
+
+  BufferAllocations allocations(buffers_);
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  // Execute twice to check that the pre-built call frame is reusable.
+  for (int i = 0; i < 2; ++i) {
+    std::fill(dst_.begin(), dst_.end(), 0.0f);
+    auto execute_event = thunk->Execute(params);
+    tsl::BlockUntilReady(execute_event);
+    ASSERT_FALSE(execute_event.IsError());
+    EXPECT_EQ(dst_, std::vector<float>({43.0, 44.0, 45.0, 46.0}));
+  }
+}
+
+TEST_F(CustomCallThunkTest, AsyncTypedFfiCustomCall) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, CustomCallThunk::Create(
+                      {"custom-call"}, "__xla_test$$AsyncCopy", op_buffers(),
+                      "", CustomCallApiVersion::API_VERSION_TYPED_FFI));
+
+  BufferAllocations allocations(buffers_);
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  AsyncCopyEvent() = tsl::MakeConstructedAsyncValueRef<tsl::Chain>();
+  auto execute_event = thunk->Execute(params);
+  EXPECT_FALSE(execute_event.IsAvailable());
+
+  AsyncCopyEvent().SetStateConcrete();
+  ASSERT_TRUE(execute_event.IsConcrete());
+  EXPECT_EQ(dst_, src_);
+}
+
+TEST_F(CustomCallThunkTest, UnknownTarget) {
+  auto thunk = CustomCallThunk::Create(
+      {"custom-call"}, "__xla_test$$Unknown", op_buffers(), "",
+      CustomCallApiVersion::API_VERSION_TYPED_FFI);
+  EXPECT_EQ(thunk.status().code(), absl::StatusCode::kUnimplemented);
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -292,11 +292,13 @@ tsl::AsyncValueRef<DotThunk::ExecuteEvent> DotThunk::Execute(
   }
 
   PrimitiveType element_type = lhs_matmul_shape_.element_type();
+  PrimitiveType out_element_type = out_matmul_shape_.element_type();
   int64_t byte_width = primitive_util::ByteWidth(element_type);
+  int64_t out_byte_width = primitive_util::ByteWidth(out_element_type);
 
   int64_t lhs_stride = matmul_dims.m * matmul_dims.k * byte_width;
   int64_t rhs_stride = matmul_dims.k * matmul_dims.n * byte_width;
-  int64_t out_stride = matmul_dims.m * matmul_dims.n * byte_width;
+  int64_t out_stride = matmul_dims.m * matmul_dims.n * out_byte_width;
 
   auto batch_ptr = [&](void* ptr, int64_t stride, int64_t index) -> void* {
     return static_cast<uint8_t*>(ptr) + stride * index;
@@ -304,9 +306,9 @@ tsl::AsyncValueRef<DotThunk::ExecuteEvent> DotThunk::Execute(
 
   auto state = std::make_shared<ExecuteState>(batch_size_);
 
-  auto dispatch = [&](auto type_tag) {
+  auto dispatch = [&](auto type_tag, auto out_type_tag) {
     for (int64_t i = 0; i < batch_size_; ++i) {
-      TypedMatMul<decltype(type_tag)>(
+      TypedMatMul<decltype(type_tag), decltype(out_type_tag)>(
           params.intra_op_threadpool, batch_ptr(out, out_stride, i),
           batch_ptr(lhs, lhs_stride, i), batch_ptr(rhs, rhs_stride, i),
           matmul_dims.m, matmul_dims.n, matmul_dims.k, transpose_lhs,
@@ -314,24 +316,41 @@ tsl::AsyncValueRef<DotThunk::ExecuteEvent> DotThunk::Execute(
     }
   };
 
+  // Low precision operands with a wide result, see
+  // DotSupportsLowPrecisionOperands.
+  if (element_type != out_element_type) {
+    if (element_type == BF16 && out_element_type == F32) {
+      dispatch(bfloat16{}, float{});
+    } else if (element_type == S8 && out_element_type == S32) {
+      dispatch(int8_t{}, int32_t{});
+    } else {
+      return Unimplemented(
+          "Unsupported element types for DotThunk::Execute: %s x %s -> %s",
+          primitive_util::LowercasePrimitiveTypeName(element_type),
+          primitive_util::LowercasePrimitiveTypeName(element_type),
+          primitive_util::LowercasePrimitiveTypeName(out_element_type));
+    }
+    return state->event;
+  }
+
   switch (element_type) {
     case F16:
-      dispatch(half{});
+      dispatch(half{}, half{});
       break;
     case F32:
-      dispatch(float{});
+      dispatch(float{}, float{});
       break;
     case F64:
-      dispatch(double{});
+      dispatch(double{}, double{});
       break;
     case S32:
-      dispatch(int32_t{});
+      dispatch(int32_t{}, int32_t{});
       break;
     case C64:
-      dispatch(std::complex<float>{});
+      dispatch(std::complex<float>{}, std::complex<float>{});
       break;
     case C128:
-      dispatch(std::complex<double>{});
+      dispatch(std::complex<double>{}, std::complex<double>{});
       break;
     default:
       return Unimplemented(
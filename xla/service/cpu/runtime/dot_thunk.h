@@ -21,6 +21,7 @@ limitations under the License.
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
 #include "absl/base/optimization.h"
@@ -63,14 +64,15 @@ class DotThunk final : public Thunk {
 
   using DoneCallback = absl::AnyInvocable<void()>;
 
-  // Col-major x Col-major MatMul implementation as Eigen contraction.
-  template <typename T, Eigen::AlignmentType alignment>
-  static void MatMul(const Eigen::ThreadPoolDevice* device, T* out, T* lhs,
+  // Col-major x Col-major MatMul implementation as Eigen contraction. If
+  // `OutT` differs from `T` operands are converted to `OutT` while packing.
+  template <typename T, Eigen::AlignmentType alignment, typename OutT = T>
+  static void MatMul(const Eigen::ThreadPoolDevice* device, OutT* out, T* lhs,
                      T* rhs, int64_t m, int64_t n, int64_t k,
                      int32_t transpose_lhs, int32_t transpose_rhs,
                      DoneCallback done);
 
-  template <typename T>
+  template <typename T, typename OutT = T>
   static void TypedMatMul(const Eigen::ThreadPoolDevice* device, void* out,
                           void* lhs, void* rhs, int64_t m, int64_t n, int64_t k,
                           bool transpose_lhs, bool transpose_rhs,
@@ -104,8 +106,8 @@ class DotThunk final : public Thunk {
 // DotThunk implementation details.
 //===----------------------------------------------------------------------===//
 
-template <typename T, Eigen::AlignmentType alignment>
-void DotThunk::MatMul(const Eigen::ThreadPoolDevice* device, T* out, T* lhs,
+template <typename T, Eigen::AlignmentType alignment, typename OutT>
+void DotThunk::MatMul(const Eigen::ThreadPoolDevice* device, OutT* out, T* lhs,
                       T* rhs, int64_t m, int64_t n, int64_t k,
                       int32_t transpose_lhs, int32_t transpose_rhs,
                       DoneCallback done) {
@@ -121,17 +123,22 @@ void DotThunk::MatMul(const Eigen::ThreadPoolDevice* device, T* out, T* lhs,
                                                                  lhs_cols);
   const Eigen::TensorMap<Eigen::Tensor<const T, 2>, alignment> b(rhs, rhs_rows,
                                                                  rhs_cols);
-  Eigen::TensorMap<Eigen::Tensor<T, 2>, alignment> c(out, m, n);
+  Eigen::TensorMap<Eigen::Tensor<OutT, 2>, alignment> c(out, m, n);
 
   typedef typename Eigen::Tensor<T, 2>::DimensionPair DimPair;
   int lhs_contract_dim = transpose_lhs ? 0 : 1;
   int rhs_contract_dim = transpose_rhs ? 1 : 0;
   std::array<DimPair, 1> dims({DimPair(lhs_contract_dim, rhs_contract_dim)});
 
-  c.device(*device, std::move(done)) = a.contract(b, dims);
+  if constexpr (std::is_same_v<T, OutT>) {
+    c.device(*device, std::move(done)) = a.contract(b, dims);
+  } else {
+    c.device(*device, std::move(done)) =
+        a.template cast<OutT>().contract(b.template cast<OutT>(), dims);
+  }
 }
 
-template <typename T>
+template <typename T, typename OutT>
 void DotThunk::TypedMatMul(const Eigen::ThreadPoolDevice* device, void* out,
                            void* lhs, void* rhs, int64_t m, int64_t n,
                            int64_t k, bool transpose_lhs, bool transpose_rhs,
@@ -144,15 +151,15 @@ void DotThunk::TypedMatMul(const Eigen::ThreadPoolDevice* device, void* out,
                     is_16_byte_aligned(out);
 
   if (ABSL_PREDICT_TRUE(is_aligned)) {
-    MatMul<T, Eigen::Aligned16>(device, static_cast<T*>(out),
-                                static_cast<T*>(lhs), static_cast<T*>(rhs), m,
-                                n, k, transpose_lhs, transpose_rhs,
-                                std::move(done));
+    MatMul<T, Eigen::Aligned16, OutT>(
+        device, static_cast<OutT*>(out), static_cast<T*>(lhs),
+        static_cast<T*>(rhs), m, n, k, transpose_lhs, transpose_rhs,
+        std::move(done));
   } else {
-    MatMul<T, Eigen::Unaligned>(device, static_cast<T*>(out),
-                                static_cast<T*>(lhs), static_cast<T*>(rhs), m,
-                                n, k, transpose_lhs, transpose_rhs,
-                                std::move(done));
+    MatMul<T, Eigen::Unaligned, OutT>(
+        device, static_cast<OutT*>(out), static_cast<T*>(lhs),
+        static_cast<T*>(rhs), m, n, k, transpose_lhs, transpose_rhs,
+        std::move(done));
   }
 }
 
@@ -173,6 +180,18 @@ DOT_THUNK_EXTERN_MATMUL_TEMPLATE(std::complex<double>);
 
 #undef DOT_THUNK_EXTERN_MATMUL_TEMPLATE
 
+// Mixed precision MatMuls with low precision operands and a wide result.
+#define DOT_THUNK_EXTERN_MIXED_MATMUL_TEMPLATE(T, OutT)                        \
+  extern template void DotThunk::TypedMatMul<T, OutT>(                         \
+      const Eigen::ThreadPoolDevice* device, void* out, void* lhs, void* rhs,  \
+      int64_t m, int64_t n, int64_t k, bool transpose_lhs, bool transpose_rhs, \
+      DoneCallback done)
+
+DOT_THUNK_EXTERN_MIXED_MATMUL_TEMPLATE(Eigen::bfloat16, float);
+DOT_THUNK_EXTERN_MIXED_MATMUL_TEMPLATE(int8_t, int32_t);
+
+#undef DOT_THUNK_EXTERN_MIXED_MATMUL_TEMPLATE
+
 }  // namespace xla::cpu
 
 #endif  // XLA_SERVICE_CPU_RUNTIME_DOT_THUNK_H_
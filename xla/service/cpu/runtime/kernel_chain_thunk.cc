@@ -0,0 +1,107 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/kernel_chain_thunk.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_join.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/util.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace xla::cpu {
+
+absl::StatusOr<std::unique_ptr<KernelChainThunk>> KernelChainThunk::Create(
+    ThunkSequence thunks) {
+  if (thunks.empty()) {
+    return InvalidArgument("Kernel chain must have at least one thunk");
+  }
+
+  std::vector<std::string> op_names;
+  op_names.reserve(thunks.size());
+  for (const auto& thunk : thunks) {
+    if (thunk->kind() != Kind::kKernel) {
+      return InvalidArgument("Kernel chain can't contain %s thunk (op_name=%s)",
+                             KindToString(thunk->kind()),
+                             thunk->info().op_name);
+    }
+    op_names.push_back(thunk->info().op_name);
+  }
+
+  // Kernel chain inherits module info from the first thunk in the chain.
+  Info info = thunks.front()->info();
+  info.op_name = absl::StrJoin(op_names, "+");
+
+  return absl::WrapUnique(
+      new KernelChainThunk(std::move(info), std::move(thunks)));
+}
+
+KernelChainThunk::KernelChainThunk(Info info, ThunkSequence thunks)
+    : Thunk(Kind::kKernelChain, std::move(info)), thunks_(std::move(thunks)) {}
+
+tsl::AsyncValueRef<Thunk::ExecuteEvent> KernelChainThunk::Execute(
+    const ExecuteParams& params) {
+  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+  return ExecuteFrom(params, 0);
+}
+
+tsl::AsyncValueRef<Thunk::ExecuteEvent> KernelChainThunk::ExecuteFrom(
+    const ExecuteParams& params, size_t index) {
+  for (; index < thunks_.size(); ++index) {
+    auto execute_event = thunks_[index]->Execute(params);
+
+    // If kernel execution is not completed yet, resume chain execution from
+    // the next kernel when it becomes available.
+    if (ABSL_PREDICT_FALSE(!execute_event.IsAvailable())) {
+      auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+      execute_event.AndThen([this, &params, index, event,
+                             execute_event = execute_event.AsPtr()] {
+        if (ABSL_PREDICT_FALSE(execute_event.IsError())) {
+          event.SetError(execute_event.GetError());
+          return;
+        }
+
+        auto tail_event = ExecuteFrom(params, index + 1);
+        tail_event.AndThen([event, tail_event = tail_event.AsPtr()] {
+          if (ABSL_PREDICT_FALSE(tail_event.IsError())) {
+            event.SetError(tail_event.GetError());
+          } else {
+            event.SetStateConcrete();
+          }
+        });
+      });
+      return event;
+    }
+
+    if (ABSL_PREDICT_FALSE(execute_event.IsError())) return execute_event;
+  }
+
+  return OkExecuteEvent();
+}
+
+KernelChainThunk::BufferUses KernelChainThunk::buffer_uses() const {
+  return thunks_.buffer_uses();
+}
+
+}  // namespace xla::cpu
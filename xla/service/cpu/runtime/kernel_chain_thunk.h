@@ -0,0 +1,60 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_KERNEL_CHAIN_THUNK_H_
+#define XLA_SERVICE_CPU_RUNTIME_KERNEL_CHAIN_THUNK_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+
+namespace xla::cpu {
+
+// A composite thunk that executes a linear chain of kernel thunks one after
+// another in the caller thread. ThunkExecutor merges chains of kernel thunks,
+// where each thunk depends only on the previous one, into a single chain thunk
+// to avoid paying for task dispatch, async value allocation and counter update
+// for every link in the chain.
+//
+// If one of the kernels completes asynchronously (i.e. it was parallelized
+// over the intra-op thread pool), execution resumes on the thread that marked
+// its execute event available.
+class KernelChainThunk final : public Thunk {
+ public:
+  static absl::StatusOr<std::unique_ptr<KernelChainThunk>> Create(
+      ThunkSequence thunks);
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
+
+  BufferUses buffer_uses() const final;
+
+  const ThunkSequence& thunks() const { return thunks_; }
+
+ private:
+  KernelChainThunk(Info info, ThunkSequence thunks);
+
+  // Executes thunks starting from `index` till the end of the chain.
+  tsl::AsyncValueRef<ExecuteEvent> ExecuteFrom(const ExecuteParams& params,
+                                               size_t index);
+
+  ThunkSequence thunks_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_KERNEL_CHAIN_THUNK_H_
@@ -0,0 +1,480 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/sort_thunk.h"
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/comparison_util.h"
+#include "xla/layout_util.h"
+#include "xla/primitive_util.h"
+#include "xla/runtime/buffer_use.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/types.h"
+#include "xla/util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace xla::cpu {
+
+// We sort rows in the caller thread if the total number of elements is smaller
+// than this threshold, as the cost of offloading work to the thread pool is
+// higher than the cost of sorting.
+static constexpr int64_t kMinParallelSortElements = 1 << 15;
+
+bool SortThunk::IsSupportedKeyType(PrimitiveType type) {
+  switch (type) {
+    case S8:
+    case S16:
+    case S32:
+    case S64:
+    case U8:
+    case U16:
+    case U32:
+    case U64:
+    case F16:
+    case BF16:
+    case F32:
+    case F64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+absl::StatusOr<std::unique_ptr<SortThunk>> SortThunk::Create(
+    Info info, absl::Span<const Input> inputs, int64_t dimension,
+    bool is_stable, SortDirection direction, Comparison::Order order) {
+  if (inputs.empty()) {
+    return InvalidArgument("Sort thunk requires at least one input");
+  }
+
+  const Shape& keys_shape = inputs.front().shape;
+  if (!IsSupportedKeyType(keys_shape.element_type())) {
+    return Unimplemented("Sort thunk doesn't support %s keys",
+                         PrimitiveType_Name(keys_shape.element_type()));
+  }
+
+  if (dimension < 0 || dimension >= keys_shape.rank()) {
+    return InvalidArgument("Sort dimension %d is out of bounds for shape %s",
+                           dimension, keys_shape.ToString(true));
+  }
+
+  for (const Input& input : inputs) {
+    if (!ShapeUtil::EqualIgnoringElementType(keys_shape, input.shape) ||
+        !LayoutUtil::LayoutsInShapesEqual(keys_shape, input.shape)) {
+      return InvalidArgument(
+          "All sort inputs must have the same dimensions and layout: %s vs %s",
+          keys_shape.ToString(true), input.shape.ToString(true));
+    }
+  }
+
+  return absl::WrapUnique(new SortThunk(std::move(info), inputs, dimension,
+                                        is_stable, direction, order));
+}
+
+SortThunk::SortThunk(Info info, absl::Span<const Input> inputs,
+                     int64_t dimension, bool is_stable,
+                     SortDirection direction, Comparison::Order order)
+    : Thunk(Kind::kSort, std::move(info)),
+      inputs_(inputs.begin(), inputs.end()),
+      dimension_(dimension),
+      is_stable_(is_stable),
+      direction_(direction),
+      order_(order) {
+  // Normalize the shape and the dimension to sort.
+  const Shape& keys_shape = inputs_.front().shape;
+  Shape normalized_shape =
+      ShapeUtil::MakeShapeWithDescendingLayoutAndSamePhysicalLayout(keys_shape);
+  int64_t physical_dimension =
+      LayoutUtil::MakeLogicalToPhysical(keys_shape.layout())[dimension_];
+
+  sort_dimension_elements_ = normalized_shape.dimensions(physical_dimension);
+  higher_dimensions_ = 1;
+  for (int64_t i = 0; i < physical_dimension; ++i) {
+    higher_dimensions_ *= normalized_shape.dimensions(i);
+  }
+  lower_dimensions_ = 1;
+  for (int64_t i = normalized_shape.rank() - 1; i > physical_dimension; --i) {
+    lower_dimensions_ *= normalized_shape.dimensions(i);
+  }
+}
+
+namespace {
+
+// Sorted buffers split into rows of `n` elements with a stride `c` between
+// consecutive elements in a row.
+struct RowsLayout {
+  // Returns the index of the `i`-th element in the row.
+  int64_t Index(int64_t row, int64_t i) const {
+    return row % c + (row - row % c) * n + i * c;
+  }
+
+  int64_t n;
+  int64_t c;
+};
+
+template <typename T>
+T Load(const std::byte* data, int64_t index) {
+  T value;
+  std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+  return value;
+}
+
+template <typename T>
+void Store(std::byte* data, int64_t index, T value) {
+  std::memcpy(data + index * sizeof(T), &value, sizeof(T));
+}
+
+template <size_t size>
+using UnsignedOfSize = std::conditional_t<
+    size == 1, uint8_t,
+    std::conditional_t<size == 2, uint16_t,
+                       std::conditional_t<size == 4, uint32_t, uint64_t>>>;
+
+// Keys of type `T` compared with their own comparison operators.
+template <typename T>
+struct NativeOrder {
+  using Key = T;
+  static Key ToKey(T value) { return value; }
+  static T FromKey(Key key) { return key; }
+};
+
+// Floating point keys mapped to signed integers with the same total order:
+// -NaN < -Inf < -Finite < -0 < +0 < +Finite < +Inf < +NaN.
+template <typename T>
+struct TotalOrder {
+  using Key = std::make_signed_t<UnsignedOfSize<sizeof(T)>>;
+  static constexpr int kSignShift = sizeof(Key) * 8 - 1;
+
+  // Flips all bits except the sign bit of negative numbers. This operation is
+  // an involution, so we use it for both directions of the conversion.
+  static Key Flip(Key bits) {
+    return bits ^ ((bits >> kSignShift) & std::numeric_limits<Key>::max());
+  }
+
+  static Key ToKey(T value) {
+    Key bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return Flip(bits);
+  }
+
+  static T FromKey(Key key) {
+    Key bits = Flip(key);
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+};
+
+struct Ascending {
+  template <typename K>
+  bool operator()(const K& a, const K& b) const {
+    return a < b;
+  }
+};
+
+struct Descending {
+  template <typename K>
+  bool operator()(const K& a, const K& b) const {
+    return b < a;
+  }
+};
+
+template <typename Iterator, typename Compare>
+void Sort(Iterator begin, Iterator end, bool is_stable, Compare compare) {
+  if (is_stable) {
+    std::stable_sort(begin, end, compare);
+  } else {
+    std::sort(begin, end, compare);
+  }
+}
+
+// Sorts keys without values.
+template <typename T, typename Order, typename Less>
+void SortKeys(const RowsLayout& layout, std::byte* keys, int64_t begin,
+              int64_t end, bool is_stable) {
+  using Key = typename Order::Key;
+  std::vector<Key> row(layout.n);
+
+  for (int64_t r = begin; r < end; ++r) {
+    for (int64_t i = 0; i < layout.n; ++i) {
+      row[i] = Order::ToKey(Load<T>(keys, layout.Index(r, i)));
+    }
+    Sort(row.begin(), row.end(), is_stable, Less());
+    for (int64_t i = 0; i < layout.n; ++i) {
+      Store<T>(keys, layout.Index(r, i), Order::FromKey(row[i]));
+    }
+  }
+}
+
+// Sorts keys together with a single value buffer. We don't care about the type
+// of values, and move them around as unsigned integers of the same size.
+template <typename T, typename Order, typename Less, typename V>
+void SortKeyValues(const RowsLayout& layout, std::byte* keys, std::byte* values,
+                   int64_t begin, int64_t end, bool is_stable) {
+  using Key = typename Order::Key;
+  std::vector<std::pair<Key, V>> row(layout.n);
+
+  auto less = [](const std::pair<Key, V>& a, const std::pair<Key, V>& b) {
+    return Less()(a.first, b.first);
+  };
+
+  for (int64_t r = begin; r < end; ++r) {
+    for (int64_t i = 0; i < layout.n; ++i) {
+      int64_t index = layout.Index(r, i);
+      row[i] = {Order::ToKey(Load<T>(keys, index)), Load<V>(values, index)};
+    }
+    Sort(row.begin(), row.end(), is_stable, less);
+    for (int64_t i = 0; i < layout.n; ++i) {
+      int64_t index = layout.Index(r, i);
+      Store<T>(keys, index, Order::FromKey(row[i].first));
+      Store<V>(values, index, row[i].second);
+    }
+  }
+}
+
+// Sorts keys together with an arbitrary number of value buffers by sorting
+// indices into the row and then permuting all buffers.
+template <typename T, typename Order, typename Less>
+void SortKeysAndValues(const RowsLayout& layout,
+                       absl::Span<std::byte* const> data,
+                       absl::Span<const size_t> byte_sizes, int64_t begin,
+                       int64_t end, bool is_stable) {
+  using Key = typename Order::Key;
+  std::vector<Key> row(layout.n);
+  std::vector<int64_t> indices(layout.n);
+  std::vector<std::byte> scratch(
+      layout.n * *std::max_element(byte_sizes.begin() + 1, byte_sizes.end()));
+
+  auto less = [&](int64_t a, int64_t b) { return Less()(row[a], row[b]); };
+
+  for (int64_t r = begin; r < end; ++r) {
+    for (int64_t i = 0; i < layout.n; ++i) {
+      row[i] = Order::ToKey(Load<T>(data[0], layout.Index(r, i)));
+    }
+
+    std::iota(indices.begin(), indices.end(), 0);
+    Sort(indices.begin(), indices.end(), is_stable, less);
+
+    for (int64_t i = 0; i < layout.n; ++i) {
+      Store<T>(data[0], layout.Index(r, i), Order::FromKey(row[indices[i]]));
+    }
+
+    for (size_t j = 1; j < data.size(); ++j) {
+      size_t byte_size = byte_sizes[j];
+      for (int64_t i = 0; i < layout.n; ++i) {
+        std::memcpy(&scratch[i * byte_size],
+                    data[j] + layout.Index(r, indices[i]) * byte_size,
+                    byte_size);
+      }
+      for (int64_t i = 0; i < layout.n; ++i) {
+        std::memcpy(data[j] + layout.Index(r, i) * byte_size,
+                    &scratch[i * byte_size], byte_size);
+      }
+    }
+  }
+}
+
+template <typename T, typename Order, typename Less>
+void SortRowsImpl(const RowsLayout& layout, absl::Span<std::byte* const> data,
+                  absl::Span<const size_t> byte_sizes, int64_t begin,
+                  int64_t end, bool is_stable) {
+  // Specialized paths for sorting keys and for sorting key-value pairs.
+  if (data.size() == 1) {
+    return SortKeys<T, Order, Less>(layout, data[0], begin, end, is_stable);
+  }
+
+  if (data.size() == 2) {
+    switch (byte_sizes[1]) {
+      case 1:
+        return SortKeyValues<T, Order, Less, uint8_t>(
+            layout, data[0], data[1], begin, end, is_stable);
+      case 2:
+        return SortKeyValues<T, Order, Less, uint16_t>(
+            layout, data[0], data[1], begin, end, is_stable);
+      case 4:
+        return SortKeyValues<T, Order, Less, uint32_t>(
+            layout, data[0], data[1], begin, end, is_stable);
+      case 8:
+        return SortKeyValues<T, Order, Less, uint64_t>(
+            layout, data[0], data[1], begin, end, is_stable);
+      default:
+        break;
+    }
+  }
+
+  SortKeysAndValues<T, Order, Less>(layout, data, byte_sizes, begin, end,
+                                    is_stable);
+}
+
+template <typename T, typename Order>
+void SortRowsImpl(SortThunk::SortDirection direction, const RowsLayout& layout,
+                  absl::Span<std::byte* const> data,
+                  absl::Span<const size_t> byte_sizes, int64_t begin,
+                  int64_t end, bool is_stable) {
+  switch (direction) {
+    case SortThunk::SortDirection::kAscending:
+      return SortRowsImpl<T, Order, Ascending>(layout, data, byte_sizes,
+                                               begin, end, is_stable);
+    case SortThunk::SortDirection::kDescending:
+      return SortRowsImpl<T, Order, Descending>(layout, data, byte_sizes,
+                                                begin, end, is_stable);
+  }
+}
+
+template <typename T>
+void SortRowsImpl(SortThunk::SortDirection direction, Comparison::Order order,
+                  const RowsLayout& layout, absl::Span<std::byte* const> data,
+                  absl::Span<const size_t> byte_sizes, int64_t begin,
+                  int64_t end, bool is_stable) {
+  // Integers are always totally ordered by their comparison operators.
+  if (order == Comparison::Order::kTotal &&
+      !std::numeric_limits<T>::is_integer) {
+    return SortRowsImpl<T, TotalOrder<T>>(direction, layout, data, byte_sizes,
+                                          begin, end, is_stable);
+  }
+  SortRowsImpl<T, NativeOrder<T>>(direction, layout, data, byte_sizes, begin,
+                                  end, is_stable);
+}
+
+}  // namespace
+
+void SortThunk::SortRows(absl::Span<std::byte* const> data, int64_t begin,
+                         int64_t end) const {
+  RowsLayout layout = {sort_dimension_elements_, lower_dimensions_};
+
+  absl::InlinedVector<size_t, 2> byte_sizes;
+  for (const Input& input : inputs_) {
+    byte_sizes.push_back(
+        primitive_util::ByteWidth(input.shape.element_type()));
+  }
+
+  auto sort = [&](auto type_tag) {
+    using T = decltype(type_tag);
+    SortRowsImpl<T>(direction_, order_, layout, data, byte_sizes, begin, end,
+                    is_stable_);
+  };
+
+  switch (inputs_.front().shape.element_type()) {
+    case S8:
+      return sort(int8_t{});
+    case S16:
+      return sort(int16_t{});
+    case S32:
+      return sort(int32_t{});
+    case S64:
+      return sort(int64_t{});
+    case U8:
+      return sort(uint8_t{});
+    case U16:
+      return sort(uint16_t{});
+    case U32:
+      return sort(uint32_t{});
+    case U64:
+      return sort(uint64_t{});
+    case F16:
+      return sort(half{});
+    case BF16:
+      return sort(bfloat16{});
+    case F32:
+      return sort(float{});
+    case F64:
+      return sort(double{});
+    default:
+      LOG(FATAL) << "Unsupported sort key type: "  // Crash Ok
+                 << PrimitiveType_Name(inputs_.front().shape.element_type());
+  }
+}
+
+tsl::AsyncValueRef<SortThunk::ExecuteEvent> SortThunk::Execute(
+    const ExecuteParams& params) {
+  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+
+  absl::InlinedVector<std::byte*, 2> data;
+  for (const Input& input : inputs_) {
+    TF_ASSIGN_OR_RETURN(
+        se::DeviceMemoryBase buffer,
+        params.buffer_allocations->GetDeviceAddress(input.slice));
+    data.push_back(static_cast<std::byte*>(buffer.opaque()));
+  }
+
+  int64_t num_rows = higher_dimensions_ * lower_dimensions_;
+  int64_t num_elements = num_rows * sort_dimension_elements_;
+
+  // Sort all rows in the caller thread if we don't have a thread pool or if
+  // there is not enough work to parallelize.
+  if (params.intra_op_threadpool == nullptr || num_rows == 1 ||
+      num_elements < kMinParallelSortElements) {
+    SortRows(data, 0, num_rows);
+    return OkExecuteEvent();
+  }
+
+  // Split rows into a task per thread and sort them in parallel.
+  auto* pool = params.intra_op_threadpool->getPool();
+  int64_t num_tasks = std::min<int64_t>(num_rows, pool->NumThreads());
+  int64_t rows_per_task = CeilOfRatio(num_rows, num_tasks);
+  num_tasks = CeilOfRatio(num_rows, rows_per_task);
+
+  auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+  auto pending_tasks = std::make_shared<std::atomic<int64_t>>(num_tasks);
+
+  for (int64_t t = 0; t < num_tasks; ++t) {
+    int64_t begin = t * rows_per_task;
+    int64_t end = std::min(num_rows, begin + rows_per_task);
+    pool->Schedule([this, data, begin, end, event, pending_tasks] {
+      SortRows(data, begin, end);
+      if (pending_tasks->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        event.SetStateConcrete();
+      }
+    });
+  }
+
+  return event;
+}
+
+SortThunk::BufferUses SortThunk::buffer_uses() const {
+  BufferUses buffer_uses;
+  buffer_uses.reserve(inputs_.size());
+  for (const Input& input : inputs_) {
+    buffer_uses.emplace_back(BufferUse::Write(input.slice));
+  }
+  return buffer_uses;
+}
+
+}  // namespace xla::cpu
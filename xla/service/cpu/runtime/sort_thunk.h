@@ -0,0 +1,92 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_SORT_THUNK_H_
+#define XLA_SERVICE_CPU_RUNTIME_SORT_THUNK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xla/comparison_util.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/shape.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla::cpu {
+
+// Sorts data in the input buffers along the `dimension` in place. The first
+// input buffer holds the keys, and all other buffers hold values that are
+// permuted together with the keys.
+//
+// Sort thunk supports only default comparators that compare keys with `LT` or
+// `GT` comparison direction, and compares keys directly in C++ instead of
+// calling into the jit-compiled comparator for every pair of elements.
+// Independent rows (all dimensions except the sort dimension) are sorted in
+// parallel in the intra-op thread pool.
+class SortThunk final : public Thunk {
+ public:
+  enum class SortDirection {
+    kAscending,
+    kDescending,
+  };
+
+  struct Input {
+    BufferAllocation::Slice slice;
+    Shape shape;
+  };
+
+  static absl::StatusOr<std::unique_ptr<SortThunk>> Create(
+      Info info, absl::Span<const Input> inputs, int64_t dimension,
+      bool is_stable, SortDirection direction,
+      Comparison::Order order = Comparison::Order::kPartial);
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
+
+  BufferUses buffer_uses() const final;
+
+  // Returns true if keys of the given type can be sorted by the sort thunk.
+  static bool IsSupportedKeyType(PrimitiveType type);
+
+ private:
+  SortThunk(Info info, absl::Span<const Input> inputs, int64_t dimension,
+            bool is_stable, SortDirection direction, Comparison::Order order);
+
+  // Sorts rows in the [begin, end) range.
+  void SortRows(absl::Span<std::byte* const> data, int64_t begin,
+                int64_t end) const;
+
+  std::vector<Input> inputs_;
+  int64_t dimension_;
+  bool is_stable_;
+  SortDirection direction_;
+  Comparison::Order order_;
+
+  // Sorted shape is normalized into a 3-dimensional shape [a, b, c], where `b`
+  // is the dimension to sort, `a` is the product of the more major dimensions
+  // and `c` is the product of the more minor dimensions.
+  int64_t higher_dimensions_;
+  int64_t sort_dimension_elements_;
+  int64_t lower_dimensions_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_SORT_THUNK_H_
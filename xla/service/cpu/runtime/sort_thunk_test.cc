@@ -0,0 +1,201 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/sort_thunk.h"
+
+#define EIGEN_USE_THREADS
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/comparison_util.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+using ::testing::ElementsAre;
+
+template <typename T>
+se::DeviceMemoryBase AsDeviceMemory(std::vector<T>& data) {
+  return se::DeviceMemoryBase(data.data(), data.size() * sizeof(T));
+}
+
+TEST(SortThunkTest, SortKeys) {
+  std::vector<float> keys = {3.0, 1.0, 4.0, 2.0, 1.5, 0.5};
+  size_t size_in_bytes = keys.size() * sizeof(float);
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(AsDeviceMemory(keys));
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation alloc(0, size_in_bytes, 0);
+  BufferAllocation::Slice slice(&alloc, 0, size_in_bytes);
+
+  // Sort along the minor dimension of a [2, 3] shape.
+  Shape shape = ShapeUtil::MakeShape(F32, {2, 3});
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, {{slice, shape}}, /*dimension=*/1,
+                                    /*is_stable=*/false,
+                                    SortThunk::SortDirection::kAscending));
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_THAT(keys, ElementsAre(1.0, 3.0, 4.0, 0.5, 1.5, 2.0));
+}
+
+TEST(SortThunkTest, SortKeyValuesMajorDimension) {
+  std::vector<int32_t> keys = {3, 1, 1, 2, 2, 3};
+  std::vector<float> values = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(AsDeviceMemory(keys));
+  buffers.emplace_back(AsDeviceMemory(values));
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation keys_alloc(0, keys.size() * sizeof(int32_t), 0);
+  BufferAllocation values_alloc(1, values.size() * sizeof(float), 0);
+
+  BufferAllocation::Slice keys_slice(&keys_alloc, 0, keys_alloc.size());
+  BufferAllocation::Slice values_slice(&values_alloc, 0, values_alloc.size());
+
+  // Sort along the major dimension of a [3, 2] shape in descending order.
+  Shape keys_shape = ShapeUtil::MakeShape(S32, {3, 2});
+  Shape values_shape = ShapeUtil::MakeShape(F32, {3, 2});
+
+  SortThunk::Input inputs[] = {{keys_slice, keys_shape},
+                               {values_slice, values_shape}};
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, inputs, /*dimension=*/0,
+                                    /*is_stable=*/true,
+                                    SortThunk::SortDirection::kDescending));
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_THAT(keys, ElementsAre(3, 3, 2, 2, 1, 1));
+  EXPECT_THAT(values, ElementsAre(0.0, 5.0, 4.0, 3.0, 2.0, 1.0));
+}
+
+TEST(SortThunkTest, SortTotalOrder) {
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  float inf = std::numeric_limits<float>::infinity();
+
+  std::vector<float> keys = {nan, 1.0, -0.0, -inf, 0.0, inf, -1.0};
+  std::vector<int64_t> values = {0, 1, 2, 3, 4, 5, 6};
+  std::vector<int8_t> extra = {0, 1, 2, 3, 4, 5, 6};
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(AsDeviceMemory(keys));
+  buffers.emplace_back(AsDeviceMemory(values));
+  buffers.emplace_back(AsDeviceMemory(extra));
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation keys_alloc(0, keys.size() * sizeof(float), 0);
+  BufferAllocation values_alloc(1, values.size() * sizeof(int64_t), 0);
+  BufferAllocation extra_alloc(2, extra.size() * sizeof(int8_t), 0);
+
+  SortThunk::Input inputs[] = {
+      {BufferAllocation::Slice(&keys_alloc, 0, keys_alloc.size()),
+       ShapeUtil::MakeShape(F32, {7})},
+      {BufferAllocation::Slice(&values_alloc, 0, values_alloc.size()),
+       ShapeUtil::MakeShape(S64, {7})},
+      {BufferAllocation::Slice(&extra_alloc, 0, extra_alloc.size()),
+       ShapeUtil::MakeShape(S8, {7})},
+  };
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, inputs, /*dimension=*/0,
+                                    /*is_stable=*/true,
+                                    SortThunk::SortDirection::kAscending,
+                                    Comparison::Order::kTotal));
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_THAT(values, ElementsAre(3, 6, 2, 4, 1, 5, 0));
+  EXPECT_THAT(extra, ElementsAre(3, 6, 2, 4, 1, 5, 0));
+  EXPECT_TRUE(std::signbit(keys[2]));
+  EXPECT_TRUE(std::isnan(keys[6]));
+}
+
+TEST(SortThunkTest, SortInParallel) {
+  static constexpr int64_t kRows = 64;
+  static constexpr int64_t kCols = 1024;
+
+  std::vector<uint32_t> keys(kRows * kCols);
+  for (int64_t i = 0; i < keys.size(); ++i) keys[i] = (i * 7919) % kCols;
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(AsDeviceMemory(keys));
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation alloc(0, keys.size() * sizeof(uint32_t), 0);
+  BufferAllocation::Slice slice(&alloc, 0, alloc.size());
+
+  Shape shape = ShapeUtil::MakeShape(U32, {kRows, kCols});
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, SortThunk::Create({"sort"}, {{slice, shape}}, /*dimension=*/1,
+                                    /*is_stable=*/false,
+                                    SortThunk::SortDirection::kAscending));
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "sort", 8);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  Thunk::ExecuteParams params = {nullptr, &allocations, nullptr, &device};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  for (int64_t r = 0; r < kRows; ++r) {
+    for (int64_t c = 1; c < kCols; ++c) {
+      ASSERT_LE(keys[r * kCols + c - 1], keys[r * kCols + c]);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace xla::cpu
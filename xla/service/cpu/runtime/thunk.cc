@@ -42,12 +42,20 @@ std::string_view Thunk::KindToString(Kind kind) {
       return "all-gather";
     case Kind::kAllReduce:
       return "all-reduce";
+    case Kind::kAllToAll:
+      return "all-to-all";
     case Kind::kCall:
       return "call";
+    case Kind::kCollectivePermute:
+      return "collective-permute";
     case Kind::kConditional:
       return "conditional";
+    case Kind::kConvolution:
+      return "convolution";
     case Kind::kCopy:
       return "copy";
+    case Kind::kCustomCall:
+      return "custom-call";
     case Kind::kDot:
       return "dot";
     case Kind::kFft:
@@ -56,6 +64,8 @@ std::string_view Thunk::KindToString(Kind kind) {
       return "infeed";
     case Kind::kKernel:
       return "kernel";
+    case Kind::kKernelChain:
+      return "kernel-chain";
     case Kind::kOutfeed:
       return "outfeed";
     case Kind::kPartitionId:
@@ -66,6 +76,10 @@ std::string_view Thunk::KindToString(Kind kind) {
       return "replica-id";
     case Kind::kRngGetAndUpdateState:
       return "rng-get-and-update-state";
+    case Kind::kSort:
+      return "sort";
+    case Kind::kTopK:
+      return "topk";
     case Kind::kWhile:
       return "while";
   }
@@ -105,6 +119,27 @@ Thunk::CollectiveExecuteParams::CollectiveExecuteParams(
       device_assignment(device_assignment),
       collectives(collectives) {}
 
+absl::StatusOr<Thunk::CustomCallExecuteParams>
+Thunk::CustomCallExecuteParams::Create(
+    const ExecutableRunOptions* run_options) {
+  // Device ordinal must be set by caller and passed in run options, if not,
+  // we use the device ordinal from the parent StreamExecutor.
+  int32_t device_ordinal =
+      run_options->device_ordinal() >= 0
+          ? run_options->device_ordinal()
+          : run_options->stream()->parent()->device_ordinal();
+
+  return CustomCallExecuteParams{device_ordinal, run_options->allocator(),
+                                 run_options->ffi_execution_context()};
+}
+
+Thunk::CustomCallExecuteParams::CustomCallExecuteParams(
+    int32_t device_ordinal, stream_executor::DeviceMemoryAllocator* allocator,
+    const ffi::ExecutionContext* ffi_execution_context)
+    : device_ordinal(device_ordinal),
+      allocator(allocator),
+      ffi_execution_context(ffi_execution_context) {}
+
 tsl::AsyncValueRef<Thunk::ExecuteEvent> Thunk::OkExecuteEvent() {
   static tsl::AsyncValueOwningRef<ExecuteEvent>* event = [] {
     auto* storage = new tsl::internal::AsyncValueStorage<ExecuteEvent>();
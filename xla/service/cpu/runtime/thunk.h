@@ -63,18 +63,25 @@ class Thunk {
   enum class Kind {
     kAllGather,
     kAllReduce,
+    kAllToAll,
     kCall,
+    kCollectivePermute,
     kCopy,
     kConditional,
+    kConvolution,
+    kCustomCall,
     kDot,
     kFft,
     kInfeed,
     kKernel,
+    kKernelChain,
     kOutfeed,
     kPartitionId,
     kReduceScatter,
     kReplicaId,
     kRngGetAndUpdateState,
+    kSort,
+    kTopK,
     kWhile,
   };
 
@@ -140,6 +147,26 @@ class Thunk {
                             CollectivesInterface* collectives);
   };
 
+  //===--------------------------------------------------------------------===//
+  // CustomCallExecuteParams
+  //===--------------------------------------------------------------------===//
+
+  // Parameters capturing all the details required for custom call execution of
+  // XLA executables.
+  struct CustomCallExecuteParams {
+    static absl::StatusOr<CustomCallExecuteParams> Create(
+        const ExecutableRunOptions* run_options);
+
+    int32_t device_ordinal;
+    stream_executor::DeviceMemoryAllocator* allocator = nullptr;
+    const ffi::ExecutionContext* ffi_execution_context = nullptr;
+
+   private:
+    CustomCallExecuteParams(int32_t device_ordinal,
+                            stream_executor::DeviceMemoryAllocator* allocator,
+                            const ffi::ExecutionContext* ffi_execution_context);
+  };
+
   //===--------------------------------------------------------------------===//
   // ExecuteParams
   //===--------------------------------------------------------------------===//
@@ -152,6 +179,7 @@ class Thunk {
     runtime::XfeedManager* xfeed = nullptr;
     const Eigen::ThreadPoolDevice* intra_op_threadpool = nullptr;
     CollectiveExecuteParams* collective_params = nullptr;
+    CustomCallExecuteParams* custom_call_params = nullptr;
   };
 
   // An execute event that becomes ready when all tasks are completed.
@@ -15,15 +15,19 @@ limitations under the License.
 
 #include "xla/service/cpu/runtime/thunk_executor.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -31,17 +35,31 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xla/runtime/buffer_use.h"
+#include "xla/service/cpu/runtime/kernel_chain_thunk.h"
 #include "xla/service/cpu/runtime/thunk.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
 #include "tsl/profiler/lib/traceme.h"
+#include "tsl/profiler/protobuf/xplane.pb.h"
+#include "tsl/profiler/utils/xplane_builder.h"
 
 namespace xla::cpu {
 
+static int64_t NowNanos() { return tsl::Env::Default()->NowNanos(); }
+
+// The maximum number of execute states we keep in the pool. Most of the time
+// the executor is executed by a single caller, but it can be executed
+// concurrently, i.e. for different devices of a multi-device CPU client.
+static constexpr size_t kMaxPooledExecuteStates = 8;
+
 ThunkExecutor::ThunkExecutor(ThunkSequence thunk_sequence,
                              std::vector<NodeDef> nodes_defs)
     : thunk_sequence_(std::move(thunk_sequence)),
-      nodes_defs_(std::move(nodes_defs)) {
+      nodes_defs_(std::move(nodes_defs)),
+      is_sequential_(true),
+      state_pool_(std::make_shared<ExecuteStatePool>()) {
   for (NodeId i = 0; i < nodes_defs_.size(); ++i) {
     // Mark nodes with empty in-edges as source nodes.
     if (nodes_defs_[i].in_edges.empty()) {
@@ -57,10 +75,18 @@ ThunkExecutor::ThunkExecutor(ThunkSequence thunk_sequence,
   // Erase redundant edges between nodes.
   int64_t num_erased_edges = TransitiveReduction();
 
+  // Check if the dataflow graph is a linear chain of thunks, where each thunk
+  // depends only on the previous one.
+  for (NodeId i = 1; i < nodes_defs_.size(); ++i) {
+    const std::vector<NodeId>& in_edges = nodes_defs_[i].in_edges;
+    is_sequential_ &= in_edges.size() == 1 && in_edges[0] == i - 1;
+  }
+
   VLOG(2) << absl::StreamFormat(
       "Constructed ThunkExecutor with %d nodes: #source_nodes=%d "
-      "#sink_nodes=%d, #erased_edges=%d",
-      nodes_defs_.size(), source_.size(), sink_.size(), num_erased_edges);
+      "#sink_nodes=%d, #erased_edges=%d, is_sequential=%v",
+      nodes_defs_.size(), source_.size(), sink_.size(), num_erased_edges,
+      is_sequential_);
 
   // Sanity check that all vectors are empty or all vectors are non-empty.
   DCHECK((!source_.empty() && !sink_.empty() && !thunk_sequence_.empty()) ||
@@ -69,6 +95,11 @@ ThunkExecutor::ThunkExecutor(ThunkSequence thunk_sequence,
 
 absl::StatusOr<ThunkExecutor> ThunkExecutor::Create(
     ThunkSequence thunk_sequence) {
+  return Create(std::move(thunk_sequence), Options());
+}
+
+absl::StatusOr<ThunkExecutor> ThunkExecutor::Create(
+    ThunkSequence thunk_sequence, const Options& options) {
   std::vector<NodeDef> defs(thunk_sequence.size());
 
   std::vector<BufferUse::ReadWriteSet> rwsets(thunk_sequence.size());
@@ -94,7 +125,72 @@ absl::StatusOr<ThunkExecutor> ThunkExecutor::Create(
     }
   }
 
-  return ThunkExecutor(std::move(thunk_sequence), std::move(defs));
+  ThunkExecutor executor(std::move(thunk_sequence), std::move(defs));
+  if (options.fuse_kernel_chains) {
+    TF_ASSIGN_OR_RETURN(executor, FuseKernelChains(std::move(executor)));
+  }
+  if (options.enable_profiling) {
+    executor.profile_state_ = std::make_unique<ProfileState>();
+  }
+  return executor;
+}
+
+absl::StatusOr<ThunkExecutor> ThunkExecutor::FuseKernelChains(
+    ThunkExecutor executor) {
+  ThunkSequence& thunks = executor.thunk_sequence_;
+  absl::Span<const NodeDef> defs = executor.nodes_defs_;
+
+  // Returns true if node `id` is a kernel that can be fused with the next
+  // kernel in the chain. We rely on the transitive reduction of the DAG: if the
+  // only out-edge of `id` points to a node with a single in-edge, then none of
+  // the thunks in between in the sequence order conflict with any of them.
+  auto is_kernel = [&](NodeId id) {
+    return thunks[id]->kind() == Thunk::Kind::kKernel;
+  };
+  auto fuses_with_next = [&](NodeId id) {
+    if (!is_kernel(id) || defs[id].out_edges.size() != 1) return false;
+    NodeId next = defs[id].out_edges.front();
+    return is_kernel(next) && defs[next].in_edges.size() == 1;
+  };
+
+  // Assign each node to a chain identified by the chain head.
+  std::vector<NodeId> chain_head(thunks.size(), kInvalidNodeId);
+  int64_t num_fused_thunks = 0;
+  for (NodeId id = 0; id < thunks.size(); ++id) {
+    if (chain_head[id] != kInvalidNodeId) continue;
+    chain_head[id] = id;
+    for (NodeId n = id; fuses_with_next(n); n = defs[n].out_edges.front()) {
+      chain_head[defs[n].out_edges.front()] = id;
+      ++num_fused_thunks;
+    }
+  }
+
+  if (num_fused_thunks == 0) return executor;
+
+  // Collect thunks of each chain in execution order.
+  std::vector<ThunkSequence> chains(thunks.size());
+  for (NodeId id = 0; id < thunks.size(); ++id) {
+    chains[chain_head[id]].push_back(std::move(thunks[id]));
+  }
+
+  // Place fused chains at the position of the chain head. It's safe to do
+  // because thunks in between chain nodes don't conflict with the chain.
+  ThunkSequence fused_sequence;
+  for (NodeId id = 0; id < thunks.size(); ++id) {
+    if (chains[id].empty()) continue;
+    if (chains[id].size() == 1) {
+      fused_sequence.push_back(std::move(chains[id].front()));
+      continue;
+    }
+    TF_ASSIGN_OR_RETURN(fused_sequence.emplace_back(),
+                        KernelChainThunk::Create(std::move(chains[id])));
+  }
+
+  VLOG(2) << absl::StreamFormat(
+      "Fused %d kernel thunks into kernel chains: #thunks=%d #fused_thunks=%d",
+      num_fused_thunks, thunks.size(), fused_sequence.size());
+
+  return Create(std::move(fused_sequence));
 }
 
 ThunkExecutor::ExecuteState::ExecuteState(ThunkExecutor* executor,
@@ -105,7 +201,9 @@ ThunkExecutor::ExecuteState::ExecuteState(ThunkExecutor* executor,
       nodes(executor->nodes_defs().size()),
       abort(false),
       pending_sink_nodes(executor->sink().size()),
-      execute_event(tsl::MakeConstructedAsyncValueRef<ExecuteEvent>()) {
+      execute_event(tsl::MakeConstructedAsyncValueRef<ExecuteEvent>()),
+      start_ns(executor->profile_state_ ? NowNanos() : 0),
+      profile(executor->profile_state_ ? nodes.size() : 0) {
   for (NodeId id = 0; id < nodes.size(); ++id) {
     const NodeDef& node_def = executor->node_def(id);
     counters[id].store(node_def.in_edges.size(), std::memory_order_release);
@@ -113,31 +211,159 @@ ThunkExecutor::ExecuteState::ExecuteState(ThunkExecutor* executor,
   }
 }
 
+void ThunkExecutor::ExecuteState::Reset(ThunkExecutor* executor,
+                                        TaskRunner runner) {
+  this->executor = executor;
+  this->runner = std::move(runner);
+
+  for (NodeId id = 0; id < nodes.size(); ++id) {
+    const NodeDef& node_def = executor->node_def(id);
+    counters[id].store(node_def.in_edges.size(), std::memory_order_release);
+    nodes[id] = Node{id, &counters[id], &node_def.out_edges};
+  }
+
+  {
+    absl::MutexLock lock(&abort_mutex);
+    abort.store(false, std::memory_order_relaxed);
+    abort_status = absl::OkStatus();
+  }
+
+  pending_sink_nodes.store(executor->sink().size(), std::memory_order_release);
+  execute_event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+  start_ns = executor->profile_state_ ? NowNanos() : 0;
+}
+
+std::unique_ptr<ThunkExecutor::ExecuteState>
+ThunkExecutor::AcquireExecuteState(TaskRunner runner) {
+  std::unique_ptr<ExecuteState> state;
+  {
+    absl::MutexLock lock(&state_pool_->mu);
+    if (!state_pool_->states.empty()) {
+      state = std::move(state_pool_->states.back());
+      state_pool_->states.pop_back();
+    }
+  }
+
+  if (ABSL_PREDICT_FALSE(state == nullptr)) {
+    return std::make_unique<ExecuteState>(this, std::move(runner));
+  }
+
+  state->Reset(this, std::move(runner));
+  return state;
+}
+
+void ThunkExecutor::ReleaseExecuteState(ExecuteStatePool* pool,
+                                        std::unique_ptr<ExecuteState> state) {
+  // Drop the runner to release all resources captured by it.
+  state->runner = nullptr;
+
+  absl::MutexLock lock(&pool->mu);
+  if (pool->states.size() < kMaxPooledExecuteStates) {
+    pool->states.push_back(std::move(state));
+  }
+}
+
 tsl::AsyncValueRef<ThunkExecutor::ExecuteEvent> ThunkExecutor::Execute(
     const Thunk::ExecuteParams& params, TaskRunner runner) {
   // Short-circuit execution of trivial thunk sequences.
   if (ABSL_PREDICT_FALSE(thunk_sequence_.empty())) {
     return Thunk::OkExecuteEvent();
   }
-  if (ABSL_PREDICT_FALSE(thunk_sequence_.size() == 1)) {
+  if (ABSL_PREDICT_FALSE(thunk_sequence_.size() == 1 && !profile_state_)) {
     return thunk_sequence_[0]->Execute(params);
   }
 
-  auto state = std::make_unique<ExecuteState>(this, std::move(runner));
+  // Linear chains of thunks can't run concurrently, and we execute them in the
+  // caller thread without any dataflow graph bookkeeping.
+  if (is_sequential_ && !profile_state_) {
+    return ExecuteSequential(params);
+  }
+
+  std::unique_ptr<ExecuteState> state = AcquireExecuteState(std::move(runner));
   Execute(state.get(), params, ReadyQueue(source_.begin(), source_.end()));
 
   // Move execute state to the execute event callback to ensure that it is kept
-  // alive while thunk executor has pending tasks.
+  // alive while thunk executor has pending tasks. Once execution is completed,
+  // we return the execute state back to the pool.
   auto execute_event = state->execute_event;
-  execute_event.AndThen([state = std::move(state)] {
-    CHECK_EQ(state->pending_sink_nodes.load(std::memory_order_acquire), 0)
-        << "All sink nodes must be completed before execute_event is marked "
-           "available.";
-  });
+  execute_event.AndThen(
+      [pool = state_pool_, state = std::move(state)]() mutable {
+        CHECK_EQ(state->pending_sink_nodes.load(std::memory_order_acquire), 0)
+            << "All sink nodes must be completed before execute_event is "
+               "marked available.";
+        // Keep execute event alive until the end of the callback, as the
+        // execute state can be immediately reused by a concurrent execution.
+        auto execute_event = std::move(state->execute_event);
+        ReleaseExecuteState(pool.get(), std::move(state));
+      });
 
   return execute_event;
 }
 
+tsl::AsyncValueRef<ThunkExecutor::ExecuteEvent>
+ThunkExecutor::ExecuteSequential(const Thunk::ExecuteParams& params) {
+  for (int64_t i = 0; i < thunk_sequence_.size(); ++i) {
+    Thunk& thunk = *thunk_sequence_[i];
+    auto execute_event = thunk.Execute(params);
+
+    // If thunk execution is not completed yet, attach a continuation to
+    // resume sequential execution starting from the next thunk.
+    if (ABSL_PREDICT_FALSE(!execute_event.IsAvailable())) {
+      auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+      execute_event.AndThen([this, &params, i, event](absl::Status status) {
+        if (ABSL_PREDICT_FALSE(!status.ok())) {
+          event.SetError(std::move(status));
+        } else {
+          ResumeExecuteSequential(i + 1, params, event);
+        }
+      });
+      return event;
+    }
+
+    // Abort execution if any of the thunks failed.
+    if (ABSL_PREDICT_FALSE(execute_event.IsError())) {
+      return execute_event;
+    }
+  }
+
+  // If we got to the end of the sequence it means that all thunks have
+  // succeeded.
+  return Thunk::OkExecuteEvent();
+}
+
+void ThunkExecutor::ResumeExecuteSequential(
+    int64_t index, const Thunk::ExecuteParams& params,
+    tsl::AsyncValueRef<ExecuteEvent> event) {
+  for (int64_t i = index; i < thunk_sequence_.size(); ++i) {
+    Thunk& thunk = *thunk_sequence_[i];
+    auto execute_event = thunk.Execute(params);
+
+    // If thunk execution is not completed yet, attach a continuation to
+    // resume sequential execution starting from the next thunk.
+    if (ABSL_PREDICT_FALSE(!execute_event.IsAvailable())) {
+      execute_event.AndThen(
+          [this, &params, i, event = std::move(event)](absl::Status status) {
+            if (ABSL_PREDICT_FALSE(!status.ok())) {
+              event.SetError(std::move(status));
+            } else {
+              ResumeExecuteSequential(i + 1, params, event);
+            }
+          });
+      return;
+    }
+
+    // Abort execution if any of the thunks failed.
+    if (ABSL_PREDICT_FALSE(execute_event.IsError())) {
+      event.SetError(execute_event.GetError());
+      return;
+    }
+  }
+
+  // If we got to the end of the sequence it means that all thunks have
+  // succeeded.
+  event.SetStateConcrete();
+}
+
 void ThunkExecutor::Execute(ExecuteState* state,
                             const Thunk::ExecuteParams& params,
                             ReadyQueue ready_queue) {
@@ -170,6 +396,11 @@ void ThunkExecutor::Execute(ExecuteState* state,
     // Execute thunk for the given node id. If execution is aborted, we keep
     // processing the nodes DAG without executing thunks.
     Thunk& thunk = *state->executor->thunk_sequence_[id];
+    if (ABSL_PREDICT_FALSE(!state->profile.empty())) {
+      NodeProfile& profile = state->profile[id];
+      profile.start_ns = NowNanos();
+      profile.thread_id = tsl::Env::Default()->GetCurrentThreadId();
+    }
     auto execute_event = state->abort.load(std::memory_order_relaxed)
                              ? Thunk::OkExecuteEvent()
                              : thunk.Execute(params);
@@ -194,6 +425,10 @@ void ThunkExecutor::Execute(ExecuteState* state,
 void ThunkExecutor::ProcessOutEdges(
     ExecuteState* state, tsl::AsyncValuePtr<Thunk::ExecuteEvent> node_event,
     Node& node, ReadyQueue& ready_queue) {
+  if (ABSL_PREDICT_FALSE(!state->profile.empty())) {
+    state->profile[node.id].end_ns = NowNanos();
+  }
+
   // If thunk execution failed, mark execution as aborted and record the error.
   // We still continue processing the nodes DAG to eventually mark sink nodes
   // completed as it's easier than to add a special abort handling logic.
@@ -225,6 +460,12 @@ void ThunkExecutor::ProcessOutEdges(
         state->pending_sink_nodes.fetch_sub(1, std::memory_order_acq_rel) == 1;
     if (ABSL_PREDICT_TRUE(!is_done)) return;
 
+    // Record the execution profile before the execute event becomes available
+    // so that it's visible to the caller waiting for the event.
+    if (ABSL_PREDICT_FALSE(!state->profile.empty())) {
+      state->executor->RecordProfile(state);
+    }
+
     // In the unlikely event of an execution error during thunk execution,
     // forward it to the caller via the execute event.
     if (ABSL_PREDICT_FALSE(state->abort.load(std::memory_order_relaxed))) {
@@ -241,6 +482,103 @@ void ThunkExecutor::ProcessOutEdges(
   }
 }
 
+void ThunkExecutor::RecordProfile(ExecuteState* state) {
+  ExecuteProfile profile;
+  profile.start_ns = state->start_ns;
+  profile.end_ns = NowNanos();
+  profile.nodes.assign(state->profile.begin(), state->profile.end());
+
+  // Nodes are sorted in topological order (all in-edges point to nodes with
+  // smaller ids), so we find the longest path through the DAG in one pass.
+  std::vector<int64_t> path_ns(profile.nodes.size(), 0);
+  std::vector<NodeId> prev(profile.nodes.size(), kInvalidNodeId);
+  NodeId last = kInvalidNodeId;
+
+  for (NodeId id = 0; id < profile.nodes.size(); ++id) {
+    for (NodeId in_edge : nodes_defs_[id].in_edges) {
+      if (prev[id] == kInvalidNodeId || path_ns[in_edge] > path_ns[prev[id]]) {
+        prev[id] = in_edge;
+      }
+    }
+    const NodeProfile& node = profile.nodes[id];
+    path_ns[id] = (node.end_ns - node.start_ns) +
+                  (prev[id] == kInvalidNodeId ? 0 : path_ns[prev[id]]);
+    if (last == kInvalidNodeId || path_ns[id] > path_ns[last]) last = id;
+  }
+
+  for (NodeId id = last; id != kInvalidNodeId; id = prev[id]) {
+    profile.critical_path.push_back(id);
+  }
+  absl::c_reverse(profile.critical_path);
+  profile.critical_path_ns = last == kInvalidNodeId ? 0 : path_ns[last];
+
+  // Aggregate busy time of all worker threads that executed thunks.
+  absl::flat_hash_map<int64_t, WorkerProfile> workers;
+  for (const NodeProfile& node : profile.nodes) {
+    WorkerProfile& worker = workers[node.thread_id];
+    worker.thread_id = node.thread_id;
+    worker.num_thunks += 1;
+    worker.busy_ns += node.end_ns - node.start_ns;
+  }
+
+  int64_t wall_time_ns = profile.end_ns - profile.start_ns;
+  for (auto& [thread_id, worker] : workers) {
+    worker.idle_ns = std::max<int64_t>(0, wall_time_ns - worker.busy_ns);
+    profile.workers.push_back(worker);
+  }
+  absl::c_sort(profile.workers, [](const auto& a, const auto& b) {
+    return a.thread_id < b.thread_id;
+  });
+
+  absl::MutexLock lock(&profile_state_->mu);
+  profile_state_->profile = std::move(profile);
+}
+
+std::optional<ThunkExecutor::ExecuteProfile> ThunkExecutor::profile() const {
+  if (profile_state_ == nullptr) return std::nullopt;
+  absl::MutexLock lock(&profile_state_->mu);
+  return profile_state_->profile;
+}
+
+void ThunkExecutor::ExportProfile(tensorflow::profiler::XPlane* plane) const {
+  std::optional<ExecuteProfile> profile = this->profile();
+  if (!profile.has_value()) return;
+
+  // Thread ids are non-negative, so we use a negative line id for the line
+  // with thunks on the critical path.
+  static constexpr int64_t kCriticalPathLineId = -1;
+
+  tsl::profiler::XPlaneBuilder builder(plane);
+
+  auto add_event = [&](tsl::profiler::XLineBuilder& line, NodeId id) {
+    const NodeProfile& node = profile->nodes[id];
+    tsl::profiler::XEventMetadata* metadata =
+        builder.GetOrCreateEventMetadata(thunk_sequence_[id]->info().op_name);
+    tsl::profiler::XEventBuilder event = line.AddEvent(*metadata);
+    event.SetTimestampNs(node.start_ns);
+    event.SetDurationNs(node.end_ns - node.start_ns);
+  };
+
+  for (const WorkerProfile& worker : profile->workers) {
+    tsl::profiler::XLineBuilder line =
+        builder.GetOrCreateLine(worker.thread_id);
+    line.SetName(absl::StrFormat("Worker #%d", worker.thread_id));
+    line.SetTimestampNs(profile->start_ns);
+  }
+
+  for (NodeId id = 0; id < profile->nodes.size(); ++id) {
+    tsl::profiler::XLineBuilder line =
+        builder.GetOrCreateLine(profile->nodes[id].thread_id);
+    add_event(line, id);
+  }
+
+  tsl::profiler::XLineBuilder critical_path =
+      builder.GetOrCreateLine(kCriticalPathLineId);
+  critical_path.SetName("Critical path");
+  critical_path.SetTimestampNs(profile->start_ns);
+  for (NodeId id : profile->critical_path) add_event(critical_path, id);
+}
+
 int64_t ThunkExecutor::TransitiveReduction() {
   int64_t num_erased_edges = 0;
 
@@ -312,6 +650,8 @@ std::string ThunkExecutor::ToString() const {
       "ThunkExecutor: #thunks=%d #source_nodes=%d #sink_nodes=%d",
       thunk_sequence_.size(), source_.size(), sink_.size());
 
+  std::optional<ExecuteProfile> profile = this->profile();
+
   // Collect names of `in_edges`.
   std::vector<std::vector<std::string>> in_edges(thunk_sequence_.size());
   for (const auto& node_def : nodes_defs_) {
@@ -330,6 +670,37 @@ std::string ThunkExecutor::ToString() const {
         "\n thunk #%05d: op_name=%s, dependencies=[%s], source=%v, sink=%v", i,
         thunk.info().op_name, absl::StrJoin(in_edges[i], ", "), is_source,
         is_sink);
+
+    // Print kernels fused into the kernel chain.
+    if (thunk.kind() == Thunk::Kind::kKernelChain) {
+      const auto& chain = static_cast<const KernelChainThunk&>(thunk);
+      absl::StrAppendFormat(&str, ", fused_kernels=%d", chain.thunks().size());
+    }
+
+    // Print measured execution time of the thunk in the last execution.
+    if (profile.has_value()) {
+      const NodeProfile& node = profile->nodes[i];
+      absl::StrAppendFormat(&str, ", time=%dns, thread=%d",
+                            node.end_ns - node.start_ns, node.thread_id);
+    }
+  }
+
+  if (!profile.has_value()) return str;
+
+  // Print the critical path and per-worker utilization.
+  std::vector<std::string> critical_path;
+  for (NodeId id : profile->critical_path) {
+    critical_path.push_back(thunk_sequence_[id]->info().op_name);
+  }
+  absl::StrAppendFormat(
+      &str, "\n profile: wall_time=%dns, critical_path_time=%dns",
+      profile->end_ns - profile->start_ns, profile->critical_path_ns);
+  absl::StrAppendFormat(&str, "\n critical path: [%s]",
+                        absl::StrJoin(critical_path, ", "));
+  for (const WorkerProfile& worker : profile->workers) {
+    absl::StrAppendFormat(
+        &str, "\n worker #%d: #thunks=%d, busy_time=%dns, idle_time=%dns",
+        worker.thread_id, worker.num_thunks, worker.busy_ns, worker.idle_ns);
   }
 
   return str;
@@ -19,6 +19,8 @@ limitations under the License.
 #include <atomic>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -32,6 +34,7 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "xla/service/cpu/runtime/thunk.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/profiler/protobuf/xplane.pb.h"
 
 namespace xla::cpu {
 
@@ -57,7 +60,22 @@ class ThunkExecutor {
   ThunkExecutor(ThunkExecutor&&) = default;
   ThunkExecutor& operator=(ThunkExecutor&&) = default;
 
+  struct Options {
+    // If true, merges linear chains of kernel thunks, where each thunk depends
+    // only on the previous one in the chain, into a single KernelChainThunk
+    // that executes all kernels in one task.
+    bool fuse_kernel_chains = false;
+
+    // If true, records start and end timestamps and the worker thread of every
+    // executed thunk, and computes the measured critical path of the execution.
+    // Profile of the last completed execution is available via `profile()`,
+    // `ExportProfile()` and `ToString()`.
+    bool enable_profiling = false;
+  };
+
   static absl::StatusOr<ThunkExecutor> Create(ThunkSequence thunk_sequence);
+  static absl::StatusOr<ThunkExecutor> Create(ThunkSequence thunk_sequence,
+                                              const Options& options);
 
   // NodeDef defines an execution order for all thunks in a sequence.
   struct NodeDef {
@@ -66,9 +84,39 @@ class ThunkExecutor {
     std::vector<NodeId> out_edges;
   };
 
+  // Measured execution of a single node.
+  struct NodeProfile {
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    int64_t thread_id = 0;
+  };
+
+  // Time spent executing thunks by a single worker thread. Idle time is the
+  // part of the execution wall time when the worker did not execute thunks.
+  struct WorkerProfile {
+    int64_t thread_id = 0;
+    int64_t num_thunks = 0;
+    int64_t busy_ns = 0;
+    int64_t idle_ns = 0;
+  };
+
+  // Profile of a completed thunk sequence execution.
+  struct ExecuteProfile {
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    std::vector<NodeProfile> nodes;
+    std::vector<WorkerProfile> workers;
+
+    // The longest path through the DAG weighted by measured thunk durations.
+    std::vector<NodeId> critical_path;
+    int64_t critical_path_ns = 0;
+  };
+
   // Executes the thunk sequence using the prepared dataflow graph. Executor
   // uses runner to execute ready tasks concurrently. If runner is not provided,
-  // executes all tasks in the caller thread.
+  // executes all tasks in the caller thread. If the dataflow graph is a linear
+  // chain of thunks, executes them sequentially in the caller thread without
+  // using the runner.
   //
   // Returned execute event becomes ready when all thunks completed execution.
   // If any of the thunks failed, the event will be in error state.
@@ -83,6 +131,17 @@ class ThunkExecutor {
 
   BufferUses buffer_uses() const { return thunk_sequence_.buffer_uses(); }
 
+  // Returns the profile of the last completed execution. Returns nullopt if
+  // profiling is disabled or if executor didn't complete any executions yet.
+  std::optional<ExecuteProfile> profile() const;
+
+  // Exports the profile of the last completed execution to the `plane` with a
+  // line per worker thread and an extra line for the critical path.
+  void ExportProfile(tensorflow::profiler::XPlane* plane) const;
+
+  // Returns true if all thunks in the sequence depend on the previous one.
+  bool is_sequential() const { return is_sequential_; }
+
   std::string ToString() const;
 
  private:
@@ -98,10 +157,14 @@ class ThunkExecutor {
     const std::vector<NodeId>* out_edges = nullptr;
   };
 
-  // A struct to keep the state of a running executor.
+  // A struct to keep the state of a running executor. Execute states are
+  // pooled and reused between executions (see `ExecuteStatePool`).
   struct ExecuteState {
     ExecuteState(ThunkExecutor* executor, TaskRunner runner);
 
+    // Resets the state in place for a new execution.
+    void Reset(ThunkExecutor* executor, TaskRunner runner);
+
     ThunkExecutor* executor;
     TaskRunner runner;
 
@@ -119,8 +182,46 @@ class ThunkExecutor {
     // completed and we set `execute_event` as concrete or error.
     std::atomic<int64_t> pending_sink_nodes;
     tsl::AsyncValueRef<ExecuteEvent> execute_event;
+
+    // Per-node profiles, empty if profiling is disabled.
+    int64_t start_ns;
+    absl::FixedArray<NodeProfile> profile;
   };
 
+  // A pool of execute states of completed executions. We keep it in a shared
+  // pointer because the state is returned to the pool from the execute event
+  // callback, that might run after the executor itself is destroyed.
+  struct ExecuteStatePool {
+    absl::Mutex mu;
+    std::vector<std::unique_ptr<ExecuteState>> states ABSL_GUARDED_BY(mu);
+  };
+
+  // Returns a pooled execute state reset for a new execution, or creates a new
+  // one if the pool is empty.
+  std::unique_ptr<ExecuteState> AcquireExecuteState(TaskRunner runner);
+
+  // Returns execute state of a completed execution back to the pool.
+  static void ReleaseExecuteState(ExecuteStatePool* pool,
+                                  std::unique_ptr<ExecuteState> state);
+
+  // Last execution profile guarded by a mutex, as the executor can be
+  // concurrently executed from multiple threads.
+  struct ProfileState {
+    mutable absl::Mutex mu;
+    std::optional<ExecuteProfile> profile ABSL_GUARDED_BY(mu);
+  };
+
+  // Executes a thunk sequence with a linear dataflow graph in the caller thread
+  // without any synchronization between thunks.
+  tsl::AsyncValueRef<ExecuteEvent> ExecuteSequential(
+      const Thunk::ExecuteParams& params);
+
+  // Resumes sequential execution starting from the thunk at `index` after one
+  // of the thunks completed asynchronously, and forwards the result to `event`.
+  void ResumeExecuteSequential(int64_t index,
+                               const Thunk::ExecuteParams& params,
+                               tsl::AsyncValueRef<ExecuteEvent> event);
+
   // Executes nodes in the ready queue with given thunk parameters.
   void Execute(ExecuteState* state, const Thunk::ExecuteParams& params,
                ReadyQueue ready_queue);
@@ -132,6 +233,15 @@ class ThunkExecutor {
                        tsl::AsyncValuePtr<Thunk::ExecuteEvent> node_event,
                        Node& node, ReadyQueue& ready_queue);
 
+  // Merges linear chains of kernel thunks into KernelChainThunks and returns
+  // a new executor for the fused thunk sequence. Returns the executor itself
+  // if there is nothing to fuse.
+  static absl::StatusOr<ThunkExecutor> FuseKernelChains(ThunkExecutor executor);
+
+  // Computes the execution profile from the recorded node profiles, and saves
+  // it as the last execution profile.
+  void RecordProfile(ExecuteState* state);
+
   // Runs a transitive reduction on the NodeDef graph to remove redundant edges.
   // Returns the number of removed edges.
   //
@@ -143,6 +253,14 @@ class ThunkExecutor {
 
   std::vector<NodeId> source_;
   std::vector<NodeId> sink_;
+
+  // True if the dataflow graph is a linear chain of thunks.
+  bool is_sequential_;
+
+  std::shared_ptr<ExecuteStatePool> state_pool_;
+
+  // Not null if profiling is enabled.
+  std::unique_ptr<ProfileState> profile_state_;
 };
 
 }  // namespace xla::cpu
@@ -37,6 +37,7 @@ limitations under the License.
 #include "xla/service/cpu/runtime/buffer_allocations.h"
 #include "xla/service/cpu/runtime/task.h"
 #include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/cpu/runtime/work_stealing_task_runner.h"
 #include "xla/service/maybe_owning_device_memory.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
@@ -47,11 +48,13 @@ limitations under the License.
 #include "tsl/platform/test.h"
 #include "tsl/platform/test_benchmark.h"
 #include "tsl/platform/threadpool.h"
+#include "tsl/profiler/protobuf/xplane.pb.h"
 
 namespace xla::cpu {
 namespace {
 
 using ::testing::ElementsAre;
+using ::testing::HasSubstr;
 
 // A test-only thunk for verifying thunk executor implementation:
 //
@@ -261,6 +264,216 @@ TEST(ThunkExecutorTest, Execute) {
                                 2, 2, 2, 2, 2));               // slice1
 }
 
+TEST(ThunkExecutorTest, FuseKernelChains) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+
+  BufferAllocation::Slice slice0(&alloc, /*offset=*/0, /*size=*/40);
+  BufferAllocation::Slice slice1(&alloc, /*offset=*/40, /*size=*/40);
+
+  std::vector<std::string> trace;
+
+  // Two independent chains: a -> b -> c and d -> e.
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice0}, {slice0},
+                                         /*inject_error=*/false, &trace));
+  sequence.push_back(AddI32Thunk::Create("d", {slice1}, {slice1},
+                                         /*inject_error=*/false, &trace));
+  sequence.push_back(AddI32Thunk::Create("b", {slice0}, {slice0},
+                                         /*inject_error=*/false, &trace));
+  sequence.push_back(AddI32Thunk::Create("c", {slice0}, {slice0},
+                                         /*inject_error=*/false, &trace));
+  sequence.push_back(AddI32Thunk::Create("e", {slice1}, {slice1},
+                                         /*inject_error=*/false, &trace));
+
+  ThunkExecutor::Options options;
+  options.fuse_kernel_chains = true;
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence), options));
+
+  ASSERT_EQ(executor.nodes_defs().size(), 2);
+  EXPECT_THAT(executor.source(), ElementsAre(0, 1));
+  EXPECT_THAT(executor.sink(), ElementsAre(0, 1));
+  EXPECT_THAT(executor.ToString(),
+              HasSubstr("op_name=a+b+c, dependencies=[], source=true, "
+                        "sink=true, fused_kernels=3"));
+
+  std::vector<int32_t> data(20, 1);  // shared src and dst allocation
+
+  auto buffers = AddI32Thunk::AsDeviceMemory({&data});
+  BufferAllocations allocations(buffers);
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+  auto execute_event = executor.Execute(params);
+
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_TRUE(execute_event.IsConcrete());
+
+  EXPECT_THAT(trace, ElementsAre("a", "b", "c", "d", "e"));
+  EXPECT_THAT(data, ElementsAre(8, 8, 8, 8, 8, 8, 8, 8, 8, 8,    // slice0
+                                4, 4, 4, 4, 4, 4, 4, 4, 4, 4));  // slice1
+}
+
+TEST(ThunkExecutorTest, ExecuteSequential) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+  BufferAllocation::Slice slice(&alloc, /*offset=*/0, /*size=*/40);
+
+  std::vector<std::string> trace;
+
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice}, {slice},
+                                         /*inject_error=*/false, &trace));
+  sequence.push_back(AddI32Thunk::Create("b", {slice}, {slice},
+                                         /*inject_error=*/false, &trace));
+  sequence.push_back(AddI32Thunk::Create("c", {slice}, {slice},
+                                         /*inject_error=*/false, &trace));
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence)));
+  ASSERT_TRUE(executor.is_sequential());
+
+  std::vector<int32_t> data(20, 1);  // shared src and dst allocation
+
+  auto buffers = AddI32Thunk::AsDeviceMemory({&data});
+  BufferAllocations allocations(buffers);
+
+  // Sequential thunk sequences are executed in the caller thread and never
+  // use the task runner.
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+  auto execute_event = executor.Execute(params, [&](ThunkExecutor::Task task) {
+    trace.push_back("<TaskRunner>");
+    task();
+  });
+
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_TRUE(execute_event.IsConcrete());
+
+  EXPECT_THAT(trace, ElementsAre("a", "b", "c"));
+  EXPECT_THAT(data, ElementsAre(8, 8, 8, 8, 8, 8, 8, 8, 8, 8,    // slice
+                                1, 1, 1, 1, 1, 1, 1, 1, 1, 1));  // untouched
+}
+
+TEST(ThunkExecutorTest, ExecuteSequentialAsync) {
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "thunk-executor", 4);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+  BufferAllocation::Slice slice(&alloc, /*offset=*/0, /*size=*/40);
+
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice}, {slice}));
+  sequence.push_back(AddI32Thunk::Create("b", {slice}, {slice}));
+  sequence.push_back(AddI32Thunk::Create("c", {slice}, {slice},
+                                         /*inject_error=*/true));
+  sequence.push_back(AddI32Thunk::Create("d", {slice}, {slice}));
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence)));
+  ASSERT_TRUE(executor.is_sequential());
+
+  std::vector<int32_t> data(20, 1);  // shared src and dst allocation
+
+  auto buffers = AddI32Thunk::AsDeviceMemory({&data});
+  BufferAllocations allocations(buffers);
+
+  // All thunks are executed asynchronously in the intra-op thread pool, and
+  // execution stops at the first failed thunk.
+  Thunk::ExecuteParams params = {nullptr, &allocations, nullptr, &device};
+  auto execute_event = executor.Execute(params);
+
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_TRUE(execute_event.IsError());
+  EXPECT_EQ(execute_event.GetError(), absl::InternalError("Injected error"));
+
+  EXPECT_THAT(data, ElementsAre(4, 4, 4, 4, 4, 4, 4, 4, 4, 4,    // slice
+                                1, 1, 1, 1, 1, 1, 1, 1, 1, 1));  // untouched
+}
+
+TEST(ThunkExecutorTest, ReuseExecuteState) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+
+  BufferAllocation::Slice slice0(&alloc, /*offset=*/0, /*size=*/40);
+  BufferAllocation::Slice slice1(&alloc, /*offset=*/40, /*size=*/40);
+  BufferAllocation::Slice slice2(&alloc, /*offset=*/20, /*size=*/40);
+
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice0}, {slice0}));
+  sequence.push_back(AddI32Thunk::Create("b", {slice1}, {slice1}));
+  sequence.push_back(AddI32Thunk::Create("c", {slice2}, {slice2}));
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence)));
+  ASSERT_FALSE(executor.is_sequential());
+
+  std::vector<int32_t> data(20, 1);  // shared src and dst allocation
+
+  auto buffers = AddI32Thunk::AsDeviceMemory({&data});
+  BufferAllocations allocations(buffers);
+
+  // Second and third executions reuse the execute state of the first one.
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+  for (int i = 0; i < 3; ++i) {
+    auto execute_event = executor.Execute(params);
+    tsl::BlockUntilReady(execute_event);
+    ASSERT_TRUE(execute_event.IsConcrete());
+  }
+
+  EXPECT_THAT(data, ElementsAre(8, 8, 8, 8, 8,                      // a
+                                64, 64, 64, 64, 64, 64, 64, 64, 64,  // a+b+c
+                                64, 8, 8, 8, 8, 8));                 // b
+}
+
+TEST(ThunkExecutorTest, Profile) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/80, /*color=*/0);
+
+  BufferAllocation::Slice slice0(&alloc, /*offset=*/0, /*size=*/40);
+  BufferAllocation::Slice slice1(&alloc, /*offset=*/40, /*size=*/40);
+  BufferAllocation::Slice slice2(&alloc, /*offset=*/20, /*size=*/40);
+
+  ThunkSequence sequence;
+  sequence.push_back(AddI32Thunk::Create("a", {slice0}, {slice0}));
+  sequence.push_back(AddI32Thunk::Create("b", {slice1}, {slice1}));
+  sequence.push_back(AddI32Thunk::Create("c", {slice2}, {slice2}));
+
+  ThunkExecutor::Options options;
+  options.enable_profiling = true;
+
+  TF_ASSERT_OK_AND_ASSIGN(ThunkExecutor executor,
+                          ThunkExecutor::Create(std::move(sequence), options));
+  EXPECT_FALSE(executor.profile().has_value());
+
+  std::vector<int32_t> data(20, 1);  // shared src and dst allocation
+
+  auto buffers = AddI32Thunk::AsDeviceMemory({&data});
+  BufferAllocations allocations(buffers);
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+  auto execute_event = executor.Execute(params);
+
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_TRUE(execute_event.IsConcrete());
+
+  std::optional<ThunkExecutor::ExecuteProfile> profile = executor.profile();
+  ASSERT_TRUE(profile.has_value());
+  ASSERT_EQ(profile->nodes.size(), 3);
+
+  // All thunks executed in the caller thread.
+  ASSERT_EQ(profile->workers.size(), 1);
+  EXPECT_EQ(profile->workers[0].num_thunks, 3);
+
+  // Thunk `c` depends on both `a` and `b`, so it's always on a critical path.
+  ASSERT_EQ(profile->critical_path.size(), 2);
+  EXPECT_EQ(profile->critical_path.back(), 2);
+  EXPECT_LE(profile->critical_path_ns, profile->end_ns - profile->start_ns);
+
+  EXPECT_THAT(executor.ToString(), HasSubstr("critical path: ["));
+
+  tensorflow::profiler::XPlane plane;
+  executor.ExportProfile(&plane);
+  EXPECT_EQ(plane.lines_size(), 2);  // worker thread + critical path
+}
+
 //===----------------------------------------------------------------------===//
 // ThunkExecutor stress testing
 //===----------------------------------------------------------------------===//
@@ -437,6 +650,56 @@ static void BM_AsyncThunkExecutor(benchmark::State& state) {
   }
 }
 
+static void BM_WorkStealingThunkExecutor(benchmark::State& state) {
+  const size_t num_thunks = state.range(0);
+  const size_t num_threads = state.range(1);
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "thunk-executor",
+                                      num_threads);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  auto g = GenerateThunkSequence(/*num_elements=*/1024, num_thunks).value();
+  auto e = ThunkExecutor::Create(std::move(g->sequence)).value();
+
+  BufferAllocations allocations(g->buffers);
+  Thunk::ExecuteParams params = {nullptr, &allocations, nullptr, &device};
+
+  for (auto _ : state) {
+    auto execute_event = e.Execute(
+        params, WorkStealingTaskRunner(thread_pool.AsEigenThreadPool()));
+    tsl::BlockUntilReady(execute_event);
+    CHECK(execute_event.IsConcrete());
+  }
+}
+
+static void BM_SequentialThunkExecutor(benchmark::State& state) {
+  const size_t num_thunks = state.range(0);
+
+  BufferAllocation alloc(/*index=*/0, /*size=*/1024, /*color=*/0);
+  BufferAllocation::Slice slice(&alloc, /*offset=*/0, /*size=*/1024);
+
+  // All thunks update the same slice and form a linear chain.
+  ThunkSequence sequence;
+  for (int i = 0; i < num_thunks; ++i) {
+    sequence.push_back(AddI32Thunk::Create(absl::StrCat(i), {slice}, {slice}));
+  }
+
+  auto e = ThunkExecutor::Create(std::move(sequence)).value();
+  CHECK(e.is_sequential());
+
+  std::vector<int32_t> data(256, 0);
+  auto buffers = AddI32Thunk::AsDeviceMemory({&data});
+  BufferAllocations allocations(buffers);
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  for (auto _ : state) {
+    auto execute_event = e.Execute(params, nullptr);
+    tsl::BlockUntilReady(execute_event);
+    CHECK(execute_event.IsConcrete());
+  }
+}
+
 BENCHMARK(BM_SyncThunkExecutor)
     ->MeasureProcessCPUTime()
     ->Arg(1)
@@ -446,6 +709,13 @@ BENCHMARK(BM_SyncThunkExecutor)
     ->Arg(258)
     ->Arg(512);
 
+BENCHMARK(BM_SequentialThunkExecutor)
+    ->MeasureProcessCPUTime()
+    ->Arg(2)
+    ->Arg(16)
+    ->Arg(64)
+    ->Arg(128);
+
 BENCHMARK(BM_AsyncThunkExecutor)
     ->MeasureProcessCPUTime()
     ->Arg(1)
@@ -455,5 +725,10 @@ BENCHMARK(BM_AsyncThunkExecutor)
     ->Arg(258)
     ->Arg(512);
 
+BENCHMARK(BM_WorkStealingThunkExecutor)
+    ->UseRealTime()
+    ->ArgNames({"thunks", "threads"})
+    ->ArgsProduct({{64, 512}, {1, 2, 4, 8, 16}});
+
 }  // namespace
 }  // namespace xla::cpu
@@ -0,0 +1,162 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/service/cpu/runtime/topk_thunk.h"
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "Eigen/Core"  // from @eigen_archive
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/primitive_util.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/cpu/runtime_topk.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace xla::cpu {
+
+// We compute top-k in the caller thread if the total number of elements is
+// smaller than this threshold, as the cost of offloading work to the thread
+// pool is higher than the cost of the selection.
+static constexpr int64_t kMinParallelTopKElements = 1 << 15;
+
+bool TopKThunk::IsSupportedType(PrimitiveType type) {
+  return type == F32 || type == BF16 || type == F16 || type == S32;
+}
+
+absl::StatusOr<std::unique_ptr<TopKThunk>> TopKThunk::Create(
+    Info info, PrimitiveType element_type,
+    BufferAllocation::Slice values_buffer,
+    BufferAllocation::Slice output_buffer,
+    BufferAllocation::Slice indices_buffer, int64_t batch_size,
+    int64_t input_size, int64_t k) {
+  if (!IsSupportedType(element_type)) {
+    return InvalidArgument("Unsupported top-k element type: %s",
+                           PrimitiveType_Name(element_type));
+  }
+  if (k < 0 || k > input_size) {
+    return InvalidArgument("Invalid top-k: k=%d, input_size=%d", k,
+                           input_size);
+  }
+  return absl::WrapUnique(new TopKThunk(std::move(info), element_type,
+                                        values_buffer, output_buffer,
+                                        indices_buffer, batch_size,
+                                        input_size, k));
+}
+
+TopKThunk::TopKThunk(Info info, PrimitiveType element_type,
+                     BufferAllocation::Slice values_buffer,
+                     BufferAllocation::Slice output_buffer,
+                     BufferAllocation::Slice indices_buffer,
+                     int64_t batch_size, int64_t input_size, int64_t k)
+    : Thunk(Kind::kTopK, std::move(info)),
+      element_type_(element_type),
+      values_buffer_(values_buffer),
+      output_buffer_(output_buffer),
+      indices_buffer_(indices_buffer),
+      batch_size_(batch_size),
+      input_size_(input_size),
+      k_(k) {}
+
+void TopKThunk::TopKRows(const void* values, void* output, int32_t* indices,
+                         int64_t begin, int64_t end) const {
+  auto topk = [&](auto type_tag) {
+    using T = decltype(type_tag);
+    TopK(end - begin, input_size_, k_,
+         static_cast<const T*>(values) + begin * input_size_,
+         static_cast<T*>(output) + begin * k_, indices + begin * k_);
+  };
+
+  switch (element_type_) {
+    case F32:
+      return topk(float{});
+    case BF16:
+      return topk(Eigen::bfloat16{});
+    case F16:
+      return topk(Eigen::half{});
+    case S32:
+      return topk(int32_t{});
+    default:
+      LOG(FATAL) << "Unsupported top-k element type: "  // Crash Ok
+                 << PrimitiveType_Name(element_type_);
+  }
+}
+
+tsl::AsyncValueRef<TopKThunk::ExecuteEvent> TopKThunk::Execute(
+    const ExecuteParams& params) {
+  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+
+  TF_ASSIGN_OR_RETURN(
+      se::DeviceMemoryBase values_data,
+      params.buffer_allocations->GetDeviceAddress(values_buffer_));
+  TF_ASSIGN_OR_RETURN(
+      se::DeviceMemoryBase output_data,
+      params.buffer_allocations->GetDeviceAddress(output_buffer_));
+  TF_ASSIGN_OR_RETURN(
+      se::DeviceMemoryBase indices_data,
+      params.buffer_allocations->GetDeviceAddress(indices_buffer_));
+
+  const void* values = values_data.opaque();
+  void* output = output_data.opaque();
+  int32_t* indices = static_cast<int32_t*>(indices_data.opaque());
+
+  // Process all rows in the caller thread if we don't have a thread pool or if
+  // there is not enough work to parallelize.
+  if (params.intra_op_threadpool == nullptr || batch_size_ == 1 ||
+      batch_size_ * input_size_ < kMinParallelTopKElements) {
+    TopKRows(values, output, indices, 0, batch_size_);
+    return OkExecuteEvent();
+  }
+
+  // Split rows into a task per thread and process them in parallel.
+  auto* pool = params.intra_op_threadpool->getPool();
+  int64_t num_tasks = std::min<int64_t>(batch_size_, pool->NumThreads());
+  int64_t rows_per_task = CeilOfRatio(batch_size_, num_tasks);
+  num_tasks = CeilOfRatio(batch_size_, rows_per_task);
+
+  auto event = tsl::MakeConstructedAsyncValueRef<ExecuteEvent>();
+  auto pending_tasks = std::make_shared<std::atomic<int64_t>>(num_tasks);
+
+  for (int64_t t = 0; t < num_tasks; ++t) {
+    int64_t begin = t * rows_per_task;
+    int64_t end = std::min(batch_size_, begin + rows_per_task);
+    pool->Schedule(
+        [this, values, output, indices, begin, end, event, pending_tasks] {
+          TopKRows(values, output, indices, begin, end);
+          if (pending_tasks->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            event.SetStateConcrete();
+          }
+        });
+  }
+
+  return event;
+}
+
+}  // namespace xla::cpu
@@ -0,0 +1,80 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_TOPK_THUNK_H_
+#define XLA_SERVICE_CPU_RUNTIME_TOPK_THUNK_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "xla/runtime/buffer_use.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla::cpu {
+
+// Computes top-k values and their indices along the minor dimension of a
+// [batch_size, input_size] (or [input_size]) row-major input. Values are
+// compared in total order and equal values are returned in the order of their
+// indices, which matches the `TopK` custom call produced by the TopkRewriter.
+// Independent batch rows are processed in parallel in the intra-op thread
+// pool.
+class TopKThunk final : public Thunk {
+ public:
+  static absl::StatusOr<std::unique_ptr<TopKThunk>> Create(
+      Info info, PrimitiveType element_type,
+      BufferAllocation::Slice values_buffer,
+      BufferAllocation::Slice output_buffer,
+      BufferAllocation::Slice indices_buffer, int64_t batch_size,
+      int64_t input_size, int64_t k);
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
+
+  BufferUses buffer_uses() const final {
+    return {BufferUse::Read(values_buffer_), BufferUse::Write(output_buffer_),
+            BufferUse::Write(indices_buffer_)};
+  }
+
+  // Returns true if the top-k of values of the given type can be computed by
+  // the top-k thunk.
+  static bool IsSupportedType(PrimitiveType type);
+
+ private:
+  TopKThunk(Info info, PrimitiveType element_type,
+            BufferAllocation::Slice values_buffer,
+            BufferAllocation::Slice output_buffer,
+            BufferAllocation::Slice indices_buffer, int64_t batch_size,
+            int64_t input_size, int64_t k);
+
+  // Computes top-k for rows in the [begin, end) range.
+  void TopKRows(const void* values, void* output, int32_t* indices,
+                int64_t begin, int64_t end) const;
+
+  PrimitiveType element_type_;
+  BufferAllocation::Slice values_buffer_;
+  BufferAllocation::Slice output_buffer_;
+  BufferAllocation::Slice indices_buffer_;
+  int64_t batch_size_;
+  int64_t input_size_;
+  int64_t k_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_TOPK_THUNK_H_
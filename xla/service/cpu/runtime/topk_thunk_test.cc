@@ -0,0 +1,148 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/service/cpu/runtime/topk_thunk.h"
+
+#define EIGEN_USE_THREADS
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+using ::testing::ElementsAre;
+
+template <typename T>
+se::DeviceMemoryBase AsDeviceMemory(std::vector<T>& data) {
+  return se::DeviceMemoryBase(data.data(), data.size() * sizeof(T));
+}
+
+BufferAllocation::Slice AsSlice(const BufferAllocation& alloc) {
+  return BufferAllocation::Slice(&alloc, 0, alloc.size());
+}
+
+TEST(TopKThunkTest, TopKFloat) {
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  float inf = std::numeric_limits<float>::infinity();
+
+  std::vector<float> values = {3.0, 1.0, nan, 2.0, -inf, 0.0, 2.0, -nan};
+  std::vector<float> output(4);
+  std::vector<int32_t> indices(4);
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(AsDeviceMemory(values));
+  buffers.emplace_back(AsDeviceMemory(output));
+  buffers.emplace_back(AsDeviceMemory(indices));
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation values_alloc(0, values.size() * sizeof(float), 0);
+  BufferAllocation output_alloc(1, output.size() * sizeof(float), 0);
+  BufferAllocation indices_alloc(2, indices.size() * sizeof(int32_t), 0);
+
+  // Top-2 of each row of a [2, 4] input.
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      TopKThunk::Create({"topk"}, F32, AsSlice(values_alloc),
+                        AsSlice(output_alloc), AsSlice(indices_alloc),
+                        /*batch_size=*/2, /*input_size=*/4, /*k=*/2));
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_TRUE(std::isnan(output[0]));
+  EXPECT_EQ(output[1], 3.0);
+  EXPECT_EQ(output[2], 2.0);
+  EXPECT_EQ(output[3], 0.0);
+  EXPECT_THAT(indices, ElementsAre(2, 0, 2, 1));
+}
+
+TEST(TopKThunkTest, TopKStableInParallel) {
+  static constexpr int64_t kRows = 64;
+  static constexpr int64_t kCols = 1024;
+  static constexpr int64_t kK = 8;
+
+  std::vector<int32_t> values(kRows * kCols);
+  for (int64_t i = 0; i < values.size(); ++i) values[i] = (i * 7919) % 100;
+  std::vector<int32_t> output(kRows * kK);
+  std::vector<int32_t> indices(kRows * kK);
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(AsDeviceMemory(values));
+  buffers.emplace_back(AsDeviceMemory(output));
+  buffers.emplace_back(AsDeviceMemory(indices));
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation values_alloc(0, values.size() * sizeof(int32_t), 0);
+  BufferAllocation output_alloc(1, output.size() * sizeof(int32_t), 0);
+  BufferAllocation indices_alloc(2, indices.size() * sizeof(int32_t), 0);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      TopKThunk::Create({"topk"}, S32, AsSlice(values_alloc),
+                        AsSlice(output_alloc), AsSlice(indices_alloc), kRows,
+                        kCols, kK));
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "topk", 8);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  Thunk::ExecuteParams params = {nullptr, &allocations, nullptr, &device};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  // Every row has at least `kK` copies of the maximum value 99, which must be
+  // returned in the order of their indices.
+  for (int64_t r = 0; r < kRows; ++r) {
+    for (int64_t i = 0; i < kK; ++i) {
+      int32_t index = indices[r * kK + i];
+      ASSERT_EQ(output[r * kK + i], 99);
+      ASSERT_EQ(values[r * kCols + index], 99);
+      if (i > 0) ASSERT_LT(indices[r * kK + i - 1], index);
+    }
+  }
+}
+
+TEST(TopKThunkTest, UnsupportedType) {
+  BufferAllocation alloc(0, 1024, 0);
+  BufferAllocation::Slice slice(&alloc, 0, alloc.size());
+  EXPECT_FALSE(TopKThunk::Create({"topk"}, F64, slice, slice, slice,
+                                 /*batch_size=*/1, /*input_size=*/16,
+                                 /*k=*/4)
+                   .ok());
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -15,10 +15,14 @@ limitations under the License.
 
 #include "xla/service/cpu/runtime/while_thunk.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
 
+#include "absl/base/optimization.h"
 #include "absl/memory/memory.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xla/runtime/buffer_use.h"
 #include "xla/service/buffer_assignment.h"
@@ -26,6 +30,8 @@ limitations under the License.
 #include "xla/service/cpu/runtime/thunk_executor.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/profiler/lib/traceme.h"
 
@@ -33,48 +39,78 @@ namespace xla::cpu {
 
 absl::StatusOr<std::unique_ptr<WhileThunk>> WhileThunk::Create(
     Info info, BufferAllocation::Slice cond_buffer, ThunkSequence cond_sequence,
-    ThunkSequence body_sequence) {
+    ThunkSequence body_sequence, std::optional<int64_t> trip_count) {
   TF_ASSIGN_OR_RETURN(ThunkExecutor cond_executor,
                       ThunkExecutor::Create(std::move(cond_sequence)));
   TF_ASSIGN_OR_RETURN(ThunkExecutor body_executor,
                       ThunkExecutor::Create(std::move(body_sequence)));
-  return absl::WrapUnique(new WhileThunk(std::move(info), cond_buffer,
-                                         std::move(cond_executor),
-                                         std::move(body_executor)));
+  return absl::WrapUnique(new WhileThunk(
+      std::move(info), cond_buffer, std::move(cond_executor),
+      std::move(body_executor), trip_count));
 }
 
 WhileThunk::WhileThunk(Info info, BufferAllocation::Slice cond_buffer,
-                       ThunkExecutor cond_executor, ThunkExecutor body_executor)
+                       ThunkExecutor cond_executor, ThunkExecutor body_executor,
+                       std::optional<int64_t> trip_count)
     : Thunk(Kind::kWhile, std::move(info)),
       cond_buffer_(cond_buffer),
       cond_executor_(std::move(cond_executor)),
-      body_executor_(std::move(body_executor)) {}
+      body_executor_(std::move(body_executor)),
+      trip_count_(trip_count) {}
 
-tsl::AsyncValueRef<Thunk::ExecuteEvent> WhileThunk::Execute(
-    const ExecuteParams& params) {
-  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+absl::Status WhileThunk::ExecuteAndWait(ThunkExecutor& executor,
+                                        const ExecuteParams& params) {
+  auto event = executor.Execute(params);
 
+  // Sequential executors run thunks inline in the caller thread, and most of
+  // the time we get back an already available event.
+  if (ABSL_PREDICT_FALSE(!event.IsAvailable())) {
+    tsl::BlockUntilReady(event);
+  }
+
+  return ABSL_PREDICT_FALSE(event.IsError()) ? event.GetError()
+                                             : absl::OkStatus();
+}
+
+absl::Status WhileThunk::ExecuteForLoop(const ExecuteParams& params,
+                                        int64_t trip_count) {
+  VLOG(3) << "Run while loop with trip count " << trip_count;
+
+  for (int64_t loop_counter = 0; loop_counter < trip_count; ++loop_counter) {
+    TF_RETURN_IF_ERROR(ExecuteAndWait(body_executor_, params));
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status WhileThunk::ExecuteWhileLoop(const ExecuteParams& params) {
   TF_ASSIGN_OR_RETURN(
       se::DeviceMemoryBase cond_data,
       params.buffer_allocations->GetDeviceAddress(cond_buffer_));
 
   bool* condition = reinterpret_cast<bool*>(cond_data.opaque());
 
-  // TODO(ezhulenev): Remove `BlockUntilReady` calls and make WhileThunk
-  // asynchronous by chaining `Execute` calls via `AndThen` callbacks.
-
-  auto init_event = cond_executor_.Execute(params);
-  tsl::BlockUntilReady(init_event);
-  if (init_event.IsError()) return init_event.GetError();
+  TF_RETURN_IF_ERROR(ExecuteAndWait(cond_executor_, params));
 
   while (*condition) {
-    auto body_event = body_executor_.Execute(params);
-    tsl::BlockUntilReady(body_event);
-    if (body_event.IsError()) return body_event.GetError();
+    TF_RETURN_IF_ERROR(ExecuteAndWait(body_executor_, params));
+    TF_RETURN_IF_ERROR(ExecuteAndWait(cond_executor_, params));
+  }
+
+  return absl::OkStatus();
+}
+
+tsl::AsyncValueRef<Thunk::ExecuteEvent> WhileThunk::Execute(
+    const ExecuteParams& params) {
+  tsl::profiler::TraceMe trace([&] { return TraceMeEncode(); });
+
+  // TODO(ezhulenev): Remove blocking waits and make WhileThunk asynchronous by
+  // chaining `Execute` calls via `AndThen` callbacks.
 
-    auto cond_event = cond_executor_.Execute(params);
-    tsl::BlockUntilReady(cond_event);
-    if (cond_event.IsError()) return cond_event.GetError();
+  if (trip_count_.has_value()) {
+    TF_RETURN_IF_ERROR(ExecuteForLoop(params, *trip_count_));
+  } else {
+    TF_RETURN_IF_ERROR(ExecuteWhileLoop(params));
   }
 
   return OkExecuteEvent();
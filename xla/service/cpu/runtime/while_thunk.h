@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_RUNTIME_WHILE_THUNK_H_
 #define XLA_SERVICE_CPU_RUNTIME_WHILE_THUNK_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -34,11 +36,16 @@ namespace xla::cpu {
 // }
 //
 // Condition buffer must be a i1 (bool) buffer that holds a loop predicate.
+//
+// If `trip_count` is available it means that the while loop trip count is known
+// statically (i.e. annotated by `WhileLoopTripCountAnnotator`), and the body
+// sequence is executed `trip_count` times without evaluating the condition.
 class WhileThunk final : public Thunk {
  public:
   static absl::StatusOr<std::unique_ptr<WhileThunk>> Create(
       Info info, BufferAllocation::Slice cond_buffer,
-      ThunkSequence cond_sequence, ThunkSequence body_sequence);
+      ThunkSequence cond_sequence, ThunkSequence body_sequence,
+      std::optional<int64_t> trip_count = std::nullopt);
 
   tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final;
 
@@ -46,11 +53,24 @@ class WhileThunk final : public Thunk {
 
  private:
   WhileThunk(Info info, BufferAllocation::Slice cond_buffer,
-             ThunkExecutor cond_executor, ThunkExecutor body_executor);
+             ThunkExecutor cond_executor, ThunkExecutor body_executor,
+             std::optional<int64_t> trip_count);
+
+  // Executes `executor` and waits for its completion. Sequential executors that
+  // complete inline return an available event and never block.
+  static absl::Status ExecuteAndWait(ThunkExecutor& executor,
+                                     const ExecuteParams& params);
+
+  // Executes while loop with a statically known trip count.
+  absl::Status ExecuteForLoop(const ExecuteParams& params, int64_t trip_count);
+
+  // Executes while loop by evaluating the condition before every iteration.
+  absl::Status ExecuteWhileLoop(const ExecuteParams& params);
 
   BufferAllocation::Slice cond_buffer_;
   ThunkExecutor cond_executor_;
   ThunkExecutor body_executor_;
+  std::optional<int64_t> trip_count_;
 };
 
 }  // namespace xla::cpu
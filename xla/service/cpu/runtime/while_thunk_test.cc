@@ -0,0 +1,179 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/while_thunk.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/runtime/buffer_use.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/runtime/buffer_allocations.h"
+#include "xla/service/cpu/runtime/thunk.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/tsl/concurrency/async_value_ref.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla::cpu {
+namespace {
+
+// A test-only thunk that increments a counter and writes `counter < limit` to a
+// condition buffer.
+class CondThunk : public Thunk {
+ public:
+  CondThunk(BufferAllocation::Slice counter, BufferAllocation::Slice cond,
+            int32_t limit)
+      : Thunk(Kind::kKernel, {"cond"}),
+        counter_(counter),
+        cond_(cond),
+        limit_(limit) {}
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final {
+    TF_ASSIGN_OR_RETURN(
+        se::DeviceMemoryBase counter,
+        params.buffer_allocations->GetDeviceAddress(counter_));
+    TF_ASSIGN_OR_RETURN(se::DeviceMemoryBase cond,
+                        params.buffer_allocations->GetDeviceAddress(cond_));
+    *reinterpret_cast<bool*>(cond.opaque()) =
+        *reinterpret_cast<int32_t*>(counter.opaque()) < limit_;
+    return OkExecuteEvent();
+  }
+
+  BufferUses buffer_uses() const final {
+    return {BufferUse::Read(counter_), BufferUse::Write(cond_)};
+  }
+
+ private:
+  BufferAllocation::Slice counter_;
+  BufferAllocation::Slice cond_;
+  int32_t limit_;
+};
+
+// A test-only thunk that increments a counter.
+class BodyThunk : public Thunk {
+ public:
+  explicit BodyThunk(BufferAllocation::Slice counter)
+      : Thunk(Kind::kKernel, {"body"}), counter_(counter) {}
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams& params) final {
+    TF_ASSIGN_OR_RETURN(
+        se::DeviceMemoryBase counter,
+        params.buffer_allocations->GetDeviceAddress(counter_));
+    *reinterpret_cast<int32_t*>(counter.opaque()) += 1;
+    return OkExecuteEvent();
+  }
+
+  BufferUses buffer_uses() const final {
+    return {BufferUse::Write(counter_)};
+  }
+
+ private:
+  BufferAllocation::Slice counter_;
+};
+
+// A test-only thunk that always fails.
+class ErrorThunk : public Thunk {
+ public:
+  ErrorThunk() : Thunk(Kind::kKernel, {"error"}) {}
+
+  tsl::AsyncValueRef<ExecuteEvent> Execute(const ExecuteParams&) final {
+    return absl::InternalError("Must not be executed");
+  }
+
+  BufferUses buffer_uses() const final { return {}; }
+};
+
+TEST(WhileThunkTest, WhileLoop) {
+  int32_t counter = 0;
+  bool cond = false;
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(se::DeviceMemoryBase(&counter, sizeof(int32_t)));
+  buffers.emplace_back(se::DeviceMemoryBase(&cond, sizeof(bool)));
+
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation counter_alloc(0, sizeof(int32_t), 0);
+  BufferAllocation cond_alloc(1, sizeof(bool), 0);
+
+  BufferAllocation::Slice counter_slice(&counter_alloc, 0, sizeof(int32_t));
+  BufferAllocation::Slice cond_slice(&cond_alloc, 0, sizeof(bool));
+
+  ThunkSequence cond_sequence;
+  cond_sequence.push_back(
+      std::make_unique<CondThunk>(counter_slice, cond_slice, /*limit=*/5));
+
+  ThunkSequence body_sequence;
+  body_sequence.push_back(std::make_unique<BodyThunk>(counter_slice));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk, WhileThunk::Create({"while"}, cond_slice,
+                                     std::move(cond_sequence),
+                                     std::move(body_sequence)));
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_EQ(counter, 5);
+  EXPECT_FALSE(cond);
+}
+
+TEST(WhileThunkTest, KnownTripCount) {
+  int32_t counter = 0;
+  bool cond = false;
+
+  std::vector<MaybeOwningDeviceMemory> buffers;
+  buffers.emplace_back(se::DeviceMemoryBase(&counter, sizeof(int32_t)));
+  buffers.emplace_back(se::DeviceMemoryBase(&cond, sizeof(bool)));
+
+  BufferAllocations allocations(buffers);
+
+  BufferAllocation counter_alloc(0, sizeof(int32_t), 0);
+  BufferAllocation cond_alloc(1, sizeof(bool), 0);
+
+  BufferAllocation::Slice counter_slice(&counter_alloc, 0, sizeof(int32_t));
+  BufferAllocation::Slice cond_slice(&cond_alloc, 0, sizeof(bool));
+
+  // With a known trip count condition sequence must never be executed.
+  ThunkSequence cond_sequence;
+  cond_sequence.push_back(std::make_unique<ErrorThunk>());
+
+  ThunkSequence body_sequence;
+  body_sequence.push_back(std::make_unique<BodyThunk>(counter_slice));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      WhileThunk::Create({"while"}, cond_slice, std::move(cond_sequence),
+                         std::move(body_sequence), /*trip_count=*/7));
+
+  Thunk::ExecuteParams params = {nullptr, &allocations};
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  EXPECT_EQ(counter, 7);
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -0,0 +1,93 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/work_stealing_task_runner.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "Eigen/ThreadPool"  // from @eigen_archive
+#include "tsl/profiler/lib/traceme.h"
+
+namespace xla::cpu {
+
+WorkStealingTaskRunner::State::State(Eigen::ThreadPoolInterface* thread_pool)
+    : thread_pool(thread_pool), queues(thread_pool->NumThreads() + 1) {}
+
+WorkStealingTaskRunner::WorkStealingTaskRunner(
+    Eigen::ThreadPoolInterface* thread_pool)
+    : state_(std::make_shared<State>(thread_pool)) {}
+
+size_t WorkStealingTaskRunner::QueueIndex(const State& state) {
+  int thread_id = state.thread_pool->CurrentThreadId();
+  return thread_id >= 0 ? thread_id : state.queues.size() - 1;
+}
+
+void WorkStealingTaskRunner::operator()(Task task) const {
+  Queue& queue = state_->queues[QueueIndex(*state_)];
+  {
+    absl::MutexLock lock(&queue.mu);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  // Wakeup captures the shared state to keep queues alive, as the last task
+  // might complete the thunk executor (and destroy the task runner owned by
+  // the caller) while other wakeups are still scanning the queues.
+  state_->thread_pool->Schedule([state = state_] { RunNextTask(*state); });
+}
+
+void WorkStealingTaskRunner::RunNextTask(State& state) {
+  size_t num_queues = state.queues.size();
+  size_t local = QueueIndex(state);
+
+  auto pop_back = [](Queue& queue) -> Task {
+    absl::MutexLock lock(&queue.mu);
+    if (queue.tasks.empty()) return nullptr;
+    Task task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return task;
+  };
+
+  auto pop_front = [](Queue& queue) -> Task {
+    absl::MutexLock lock(&queue.mu);
+    if (queue.tasks.empty()) return nullptr;
+    Task task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return task;
+  };
+
+  // The number of tasks in the queues is never smaller than the number of
+  // wakeups that did not pick up a task yet, so we are guaranteed to find a
+  // task. We might miss it on a single pass if it was stolen concurrently by
+  // another worker, in which case we do another pass.
+  while (true) {
+    if (Task task = pop_back(state.queues[local])) {
+      task();
+      return;
+    }
+
+    for (size_t i = 1; i < num_queues; ++i) {
+      if (Task task = pop_front(state.queues[(local + i) % num_queues])) {
+        tsl::profiler::TraceMe trace("WorkStealingTaskRunner::Steal");
+        task();
+        return;
+      }
+    }
+  }
+}
+
+}  // namespace xla::cpu
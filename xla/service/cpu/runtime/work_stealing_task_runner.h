@@ -0,0 +1,86 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_WORK_STEALING_TASK_RUNNER_H_
+#define XLA_SERVICE_CPU_RUNTIME_WORK_STEALING_TASK_RUNNER_H_
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/fixed_array.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/service/cpu/runtime/thunk_executor.h"
+
+namespace Eigen {
+class ThreadPoolInterface;
+}  // namespace Eigen
+
+namespace xla::cpu {
+
+// A ThunkExecutor task runner that keeps ready tasks in per-worker queues on
+// top of an Eigen thread pool. Tasks submitted from a thread pool worker are
+// pushed to the worker's local queue, and every worker pops tasks from its
+// local queue in LIFO order (to keep the working set of recently completed
+// thunks hot in cache) and steals from the other queues in FIFO order when the
+// local queue is empty. Tasks submitted from threads outside of the thread pool
+// go to a shared queue that all workers steal from.
+//
+// Every scheduled task also schedules one "wakeup" into the underlying thread
+// pool, and each wakeup runs exactly one task, which guarantees that all tasks
+// eventually run even if the worker that submitted them is busy.
+//
+// Task runner is cheap to copy, all copies share the same queues, and the
+// queues are kept alive until all scheduled wakeups are completed.
+class WorkStealingTaskRunner {
+ public:
+  using Task = ThunkExecutor::Task;
+
+  explicit WorkStealingTaskRunner(Eigen::ThreadPoolInterface* thread_pool);
+
+  void operator()(Task task) const;
+
+  size_t num_queues() const { return state_->queues.size(); }
+
+ private:
+  struct Queue {
+    absl::Mutex mu;
+    std::deque<Task> tasks ABSL_GUARDED_BY(mu);
+  };
+
+  struct State {
+    explicit State(Eigen::ThreadPoolInterface* thread_pool);
+
+    Eigen::ThreadPoolInterface* thread_pool;
+
+    // One queue per thread pool worker plus a shared queue (the last one) for
+    // tasks submitted from external threads.
+    absl::FixedArray<Queue> queues;
+  };
+
+  // Returns the index of the queue owned by the caller thread.
+  static size_t QueueIndex(const State& state);
+
+  // Pops a task from the local queue or steals it from other queues and runs
+  // it in the caller thread.
+  static void RunNextTask(State& state);
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace xla::cpu
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_WORK_STEALING_TASK_RUNNER_H_
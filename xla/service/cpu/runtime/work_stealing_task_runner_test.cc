@@ -0,0 +1,71 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime/work_stealing_task_runner.h"
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/synchronization/blocking_counter.h"
+#include "xla/service/cpu/runtime/thunk_executor.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+TEST(WorkStealingTaskRunnerTest, RunsAllTasks) {
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 8);
+  WorkStealingTaskRunner runner(thread_pool.AsEigenThreadPool());
+  EXPECT_EQ(runner.num_queues(), 9);
+
+  static constexpr int64_t kNumTasks = 1000;
+  static constexpr int64_t kNumSubtasks = 10;
+
+  std::atomic<int64_t> counter = 0;
+  absl::BlockingCounter done(kNumTasks * (kNumSubtasks + 1));
+
+  // Tasks scheduled from the external thread spawn subtasks from thread pool
+  // workers, which go to the worker local queues.
+  for (int64_t i = 0; i < kNumTasks; ++i) {
+    runner([&] {
+      for (int64_t j = 0; j < kNumSubtasks; ++j) {
+        runner([&] {
+          counter.fetch_add(1, std::memory_order_relaxed);
+          done.DecrementCount();
+        });
+      }
+      counter.fetch_add(1, std::memory_order_relaxed);
+      done.DecrementCount();
+    });
+  }
+
+  done.Wait();
+  EXPECT_EQ(counter.load(), kNumTasks * (kNumSubtasks + 1));
+}
+
+TEST(WorkStealingTaskRunnerTest, AsThunkExecutorTaskRunner) {
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 4);
+  ThunkExecutor::TaskRunner runner =
+      WorkStealingTaskRunner(thread_pool.AsEigenThreadPool());
+
+  absl::BlockingCounter done(1);
+  runner([&] { done.DecrementCount(); });
+  done.Wait();
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -15,6 +15,11 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_RUNTIME_CONV_IMPL_H_
 #define XLA_SERVICE_CPU_RUNTIME_CONV_IMPL_H_
 
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "xla/tsl/framework/convolution/eigen_spatial_convolutions.h"
 
@@ -26,6 +31,13 @@ limitations under the License.
 namespace tensorflow {
 namespace xla {
 
+// Convolution implementations below evaluate the convolution on the given
+// device and block the caller thread until results are computed. If
+// `done_callback` is provided, it is called when the output is ready. For 2D
+// convolutions without feature groups on Eigen::ThreadPoolDevice, evaluation
+// is asynchronous and the caller thread does not wait for the results (Eigen
+// does not support asynchronous evaluation of chipping and volume patch ops).
+
 template <typename EigenDevice, typename ScalarType>
 void EigenConv2DImpl(
     const EigenDevice& device, ScalarType* out, ScalarType* lhs,
@@ -37,7 +49,8 @@ void EigenConv2DImpl(
     Eigen::Index padding_x_after, Eigen::Index padding_y_before,
     Eigen::Index padding_y_after, Eigen::Index lhs_x_dilation,
     Eigen::Index lhs_y_dilation, Eigen::Index rhs_x_dilation,
-    Eigen::Index rhs_y_dilation, Eigen::Index feature_group_count) {
+    Eigen::Index rhs_y_dilation, Eigen::Index feature_group_count,
+    std::optional<std::function<void()>> done_callback = std::nullopt) {
   const Eigen::TensorMap<Eigen::Tensor<const ScalarType, 4, Eigen::RowMajor>,
                          Eigen::Aligned>
       input(lhs, input_batch, input_x, input_y, input_channels);
@@ -87,6 +100,29 @@ void EigenConv2DImpl(
   kernel_dims[1] = feature_group_count;
   kernel_dims[2] = kernel_filters / feature_group_count;
 
+#if defined(EIGEN_USE_THREADS)
+  if constexpr (std::is_same_v<EigenDevice, Eigen::ThreadPoolDevice>) {
+    if (done_callback.has_value() && feature_group_count == 1) {
+      Eigen::DSizes<Eigen::Index, 2> kernel_dims_2d;
+      kernel_dims_2d[0] = kernel_channels * kernel_y * kernel_x;
+      kernel_dims_2d[1] = kernel_filters;
+
+      // The row and column dimensions must be flipped when passed to Eigen.
+      output.device(device, std::move(*done_callback)) =
+          input
+              .extract_image_patches(
+                  kernel_y, kernel_x, y_stride, x_stride, rhs_y_dilation,
+                  rhs_x_dilation, lhs_y_dilation, lhs_x_dilation,
+                  padding_y_before, padding_y_after, padding_x_before,
+                  padding_x_after, static_cast<ScalarType>(0.0f))
+              .reshape(pre_contract_dims)
+              .contract(kernel.reshape(kernel_dims_2d), contract_dims)
+              .reshape(post_contract_dims);
+      return;
+    }
+  }
+#endif  // EIGEN_USE_THREADS
+
   for (Eigen::Index i = 0; i < feature_group_count; ++i) {
     // The row and column dimensions must be flipped when passed to Eigen.
     output.reshape(output_reshaped_dims).chip(i, 3).device(device) =
@@ -101,6 +137,8 @@ void EigenConv2DImpl(
             .contract(kernel.reshape(kernel_dims).chip(i, 1), contract_dims)
             .reshape(post_contract_dims);
   }
+
+  if (done_callback.has_value()) (*done_callback)();
 }
 
 template <typename EigenDevice, typename ScalarType>
@@ -118,7 +156,8 @@ void EigenConv3DImpl(
     Eigen::Index lhs_x_dilation, Eigen::Index lhs_y_dilation,
     Eigen::Index lhs_z_dilation, Eigen::Index rhs_x_dilation,
     Eigen::Index rhs_y_dilation, Eigen::Index rhs_z_dilation,
-    Eigen::Index feature_group_count) {
+    Eigen::Index feature_group_count,
+    std::optional<std::function<void()>> done_callback = std::nullopt) {
   using ConstTType =
       Eigen::TensorMap<Eigen::Tensor<const ScalarType, 5, Eigen::RowMajor>,
                        Eigen::Aligned>;
@@ -189,6 +228,8 @@ void EigenConv3DImpl(
             .contract(kernel.reshape(kernel_dims).chip(i, 1), contract_dims)
             .reshape(post_contract_dims);
   }
+
+  if (done_callback.has_value()) (*done_callback)();
 }
 
 }  // namespace xla
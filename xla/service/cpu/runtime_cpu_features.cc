@@ -0,0 +1,99 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime_cpu_features.h"
+
+#include <cstdint>
+
+#include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "tsl/platform/cpu_info.h"
+
+namespace {
+
+using tsl::port::CPUFeature;
+
+// Maps LLVM X86 target feature names to the features detected with CPUID.
+const absl::flat_hash_map<absl::string_view, CPUFeature>& X86Features() {
+  static const auto* features =
+      new absl::flat_hash_map<absl::string_view, CPUFeature>({
+          {"mmx", CPUFeature::MMX},
+          {"sse", CPUFeature::SSE},
+          {"sse2", CPUFeature::SSE2},
+          {"sse3", CPUFeature::SSE3},
+          {"ssse3", CPUFeature::SSSE3},
+          {"sse4.1", CPUFeature::SSE4_1},
+          {"sse4.2", CPUFeature::SSE4_2},
+          {"cmov", CPUFeature::CMOV},
+          {"cx8", CPUFeature::CMPXCHG8B},
+          {"cx16", CPUFeature::CMPXCHG16B},
+          {"popcnt", CPUFeature::POPCNT},
+          {"aes", CPUFeature::AES},
+          {"avx", CPUFeature::AVX},
+          {"rdrnd", CPUFeature::RDRAND},
+          {"avx2", CPUFeature::AVX2},
+          {"fma", CPUFeature::FMA},
+          {"f16c", CPUFeature::F16C},
+          {"pclmul", CPUFeature::PCLMULQDQ},
+          {"rdseed", CPUFeature::RDSEED},
+          {"adx", CPUFeature::ADX},
+          {"smap", CPUFeature::SMAP},
+          {"prefetchwt1", CPUFeature::PREFETCHWT1},
+          {"bmi", CPUFeature::BMI1},
+          {"bmi2", CPUFeature::BMI2},
+          {"prfchw", CPUFeature::PREFETCHW},
+          {"avx512f", CPUFeature::AVX512F},
+          {"avx512cd", CPUFeature::AVX512CD},
+          {"avx512er", CPUFeature::AVX512ER},
+          {"avx512pf", CPUFeature::AVX512PF},
+          {"avx512vl", CPUFeature::AVX512VL},
+          {"avx512bw", CPUFeature::AVX512BW},
+          {"avx512dq", CPUFeature::AVX512DQ},
+          {"avx512vbmi", CPUFeature::AVX512VBMI},
+          {"avx512ifma", CPUFeature::AVX512IFMA},
+          {"avx5124vnniw", CPUFeature::AVX512_4VNNIW},
+          {"avx5124fmaps", CPUFeature::AVX512_4FMAPS},
+          {"avx512vnni", CPUFeature::AVX512_VNNI},
+          {"avx512bf16", CPUFeature::AVX512_BF16},
+          {"avxvnni", CPUFeature::AVX_VNNI},
+          {"amx-tile", CPUFeature::AMX_TILE},
+          {"amx-int8", CPUFeature::AMX_INT8},
+          {"amx-bf16", CPUFeature::AMX_BF16},
+          {"avx512fp16", CPUFeature::AVX512_FP16},
+          {"amx-fp16", CPUFeature::AMX_FP16},
+          {"avxneconvert", CPUFeature::AVX_NE_CONVERT},
+          {"avxvnniint8", CPUFeature::AVX_VNNI_INT8},
+      });
+  return *features;
+}
+
+}  // namespace
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY int32_t
+__xla_cpu_runtime_HostSupportsTargetFeatures(const char* features) {
+  for (absl::string_view feature :
+       absl::StrSplit(features, ',', absl::SkipWhitespace())) {
+    if (!absl::ConsumePrefix(&feature, "+")) {
+      continue;
+    }
+    auto it = X86Features().find(feature);
+    if (it == X86Features().end() || !tsl::port::TestCPUFeature(it->second)) {
+      return 0;
+    }
+  }
+  return 1;
+}
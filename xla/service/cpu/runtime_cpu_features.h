@@ -0,0 +1,32 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_CPU_FEATURES_H_
+#define XLA_SERVICE_CPU_RUNTIME_CPU_FEATURES_H_
+
+#include <stdint.h>
+
+extern "C" {
+
+// Returns 1 if the host CPU supports every feature enabled in `features`, a
+// comma separated LLVM target feature string ("+avx2,+fma"), and 0 otherwise.
+// Disabled ("-feature") entries are ignored. Features that can't be detected
+// on the host are treated as unsupported. Used by ahead-of-time compiled code
+// to pick an ISA specialized version of a computation at runtime.
+extern int32_t __xla_cpu_runtime_HostSupportsTargetFeatures(
+    const char* features);
+}
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_CPU_FEATURES_H_
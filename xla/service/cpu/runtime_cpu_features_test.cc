@@ -0,0 +1,43 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime_cpu_features.h"
+
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/test.h"
+
+namespace xla::cpu {
+namespace {
+
+TEST(RuntimeCpuFeaturesTest, EmptyFeatures) {
+  EXPECT_EQ(__xla_cpu_runtime_HostSupportsTargetFeatures(""), 1);
+  EXPECT_EQ(__xla_cpu_runtime_HostSupportsTargetFeatures("-avx512f"), 1);
+}
+
+TEST(RuntimeCpuFeaturesTest, UnknownFeatureIsUnsupported) {
+  EXPECT_EQ(__xla_cpu_runtime_HostSupportsTargetFeatures("+not-a-feature"), 0);
+}
+
+TEST(RuntimeCpuFeaturesTest, MatchesCpuInfo) {
+  bool avx2 = tsl::port::TestCPUFeature(tsl::port::CPUFeature::AVX2);
+  bool fma = tsl::port::TestCPUFeature(tsl::port::CPUFeature::FMA);
+  EXPECT_EQ(__xla_cpu_runtime_HostSupportsTargetFeatures("+avx2"), avx2);
+  EXPECT_EQ(__xla_cpu_runtime_HostSupportsTargetFeatures("+avx2,+fma"),
+            avx2 && fma);
+  EXPECT_EQ(__xla_cpu_runtime_HostSupportsTargetFeatures("+avx2,-fma"), avx2);
+}
+
+}  // namespace
+}  // namespace xla::cpu
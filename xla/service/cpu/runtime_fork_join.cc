@@ -17,9 +17,24 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/base/const_init.h"
 #include "absl/base/dynamic_annotations.h"
+#include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "xla/executable_run_options.h"
 #include "xla/service/custom_call_status_internal.h"
@@ -29,6 +44,228 @@ limitations under the License.
 using ComputeFunctionType = void (*)(void*, const void*, const void**, void**,
                                      void*, int64_t*, uint64_t*);
 
+namespace {
+
+// The persistent fork-join runs all partitions inline in the caller thread if
+// the number of partitions is not larger than this threshold. Parallel loops
+// with so few partitions are cheap, and waking up worker threads for them is
+// not worth it.
+constexpr int32_t kMaxInlinePartitions = 2;
+
+// Number of iterations a worker thread spins waiting for the next parallel
+// loop before parking on a mutex, and the caller thread spins waiting for
+// workers to complete before yielding.
+constexpr int64_t kSpinIterations = 1 << 14;
+
+// A team of persistent worker threads executing fork-join parallel loops.
+//
+// Workers spin for a short period of time waiting for the next parallel loop
+// before parking, and are woken up through their own (cache-line padded) task
+// slot, so that back-to-back parallel loops do not pay for a thread pool
+// enqueue, a thread wakeup and a blocking counter on every call.
+class ForkJoinTeam {
+ public:
+  explicit ForkJoinTeam(int num_workers);
+  ~ForkJoinTeam();
+
+  ForkJoinTeam(const ForkJoinTeam&) = delete;
+  ForkJoinTeam& operator=(const ForkJoinTeam&) = delete;
+
+  // Returns a process-wide team with `num_workers` worker threads.
+  static ForkJoinTeam* Get(int num_workers);
+
+  // Tries to acquire the team for running a parallel loop. Returns false if
+  // the team is busy running another parallel loop (concurrent executions or
+  // nested parallel loops).
+  bool TryAcquire() {
+    return !busy_.exchange(true, std::memory_order_acquire);
+  }
+  void Release() { busy_.store(false, std::memory_order_release); }
+
+  // Calls `task(i)` for all `i` in [0, num_tasks) using the caller thread and
+  // team workers, and returns when all tasks are completed. The team must be
+  // acquired by the caller.
+  void ParallelFor(int32_t num_tasks, absl::FunctionRef<void(int32_t)> task);
+
+ private:
+  // A parallel loop shared by the caller thread and woken up workers.
+  struct Job {
+    Job(int32_t num_tasks, absl::FunctionRef<void(int32_t)> task)
+        : num_tasks(num_tasks), task(task) {}
+
+    int32_t num_tasks;
+    absl::FunctionRef<void(int32_t)> task;
+    alignas(ABSL_CACHELINE_SIZE) std::atomic<int32_t> next_task = 0;
+  };
+
+  // A per-worker task slot. The caller publishes a job by writing it into the
+  // slot and incrementing the epoch.
+  struct alignas(ABSL_CACHELINE_SIZE) WorkerSlot {
+    std::atomic<int64_t> epoch = 0;
+    std::atomic<bool> parked = false;
+    Job* job = nullptr;
+    absl::Mutex mu;
+  };
+
+  static void RunTasks(Job& job);
+
+  void Wake(WorkerSlot& slot, Job* job);
+  int64_t WaitForNextEpoch(WorkerSlot& slot, int64_t epoch);
+  void WorkerLoop(WorkerSlot& slot);
+
+  std::atomic<bool> busy_ = false;
+  std::atomic<bool> shutdown_ = false;
+
+  // Number of woken up workers that did not yet complete the current job.
+  alignas(ABSL_CACHELINE_SIZE) std::atomic<int32_t> pending_ = 0;
+
+  std::vector<std::unique_ptr<WorkerSlot>> slots_;
+  std::vector<std::thread> workers_;
+};
+
+ForkJoinTeam::ForkJoinTeam(int num_workers) {
+  slots_.reserve(num_workers);
+  workers_.reserve(num_workers);
+  for (int i = 0; i < num_workers; ++i) {
+    slots_.push_back(std::make_unique<WorkerSlot>());
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    WorkerSlot* slot = slots_[i].get();
+    workers_.emplace_back([this, slot] { WorkerLoop(*slot); });
+  }
+}
+
+ForkJoinTeam::~ForkJoinTeam() {
+  shutdown_.store(true, std::memory_order_release);
+  for (auto& slot : slots_) Wake(*slot, nullptr);
+  for (auto& worker : workers_) worker.join();
+}
+
+ForkJoinTeam* ForkJoinTeam::Get(int num_workers) {
+  static absl::Mutex mu(absl::kConstInit);
+  static auto* teams =
+      new absl::flat_hash_map<int, std::unique_ptr<ForkJoinTeam>>();
+
+  absl::MutexLock lock(&mu);
+  std::unique_ptr<ForkJoinTeam>& team = (*teams)[num_workers];
+  if (team == nullptr) team = std::make_unique<ForkJoinTeam>(num_workers);
+  return team.get();
+}
+
+void ForkJoinTeam::RunTasks(Job& job) {
+  for (int32_t i = job.next_task.fetch_add(1, std::memory_order_relaxed);
+       i < job.num_tasks;
+       i = job.next_task.fetch_add(1, std::memory_order_relaxed)) {
+    job.task(i);
+  }
+}
+
+void ForkJoinTeam::Wake(WorkerSlot& slot, Job* job) {
+  slot.job = job;
+  slot.epoch.fetch_add(1, std::memory_order_seq_cst);
+  // If the worker is parked (or about to park) acquire and release its mutex
+  // to force re-evaluation of the condition it is waiting on.
+  if (slot.parked.load(std::memory_order_seq_cst)) {
+    absl::MutexLock lock(&slot.mu);
+  }
+}
+
+int64_t ForkJoinTeam::WaitForNextEpoch(WorkerSlot& slot, int64_t epoch) {
+  for (int64_t i = 0; i < kSpinIterations; ++i) {
+    int64_t next = slot.epoch.load(std::memory_order_acquire);
+    if (ABSL_PREDICT_FALSE(next != epoch)) return next;
+  }
+
+  absl::MutexLock lock(&slot.mu);
+  slot.parked.store(true, std::memory_order_seq_cst);
+  auto epoch_changed = [&] {
+    return slot.epoch.load(std::memory_order_seq_cst) != epoch;
+  };
+  slot.mu.Await(absl::Condition(&epoch_changed));
+  slot.parked.store(false, std::memory_order_relaxed);
+  return slot.epoch.load(std::memory_order_acquire);
+}
+
+void ForkJoinTeam::WorkerLoop(WorkerSlot& slot) {
+  int64_t epoch = 0;
+  while (true) {
+    epoch = WaitForNextEpoch(slot, epoch);
+    if (shutdown_.load(std::memory_order_acquire)) return;
+    RunTasks(*slot.job);
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+void ForkJoinTeam::ParallelFor(int32_t num_tasks,
+                               absl::FunctionRef<void(int32_t)> task) {
+  Job job(num_tasks, task);
+
+  // Wake up at most one worker per task that is not run by the caller thread.
+  int32_t num_woken = std::min<int32_t>(slots_.size(), num_tasks - 1);
+  pending_.store(num_woken, std::memory_order_relaxed);
+  for (int32_t i = 0; i < num_woken; ++i) Wake(*slots_[i], &job);
+
+  RunTasks(job);
+
+  // Wait for all woken up workers to complete. Workers might still be running
+  // their last task even if all tasks were already claimed.
+  for (int64_t i = 0; pending_.load(std::memory_order_acquire) != 0; ++i) {
+    if (i >= kSpinIterations) std::this_thread::yield();
+  }
+}
+
+// Dispatches 'num_partitions - 1' partitions to the intra-op thread pool, runs
+// the first partition inline and waits for all partitions to complete.
+void ForkJoinWithThreadPool(const xla::ExecutableRunOptions* run_options,
+                            int32_t num_partitions,
+                            absl::FunctionRef<void(int32_t)> run_partition) {
+  tsl::BlockingCounter bc(num_partitions - 1);
+  for (int32_t i = 1; i < num_partitions; ++i) {
+    run_options->intra_op_thread_pool()->enqueueNoNotification(
+        [i, run_partition, &bc]() {
+          run_partition(i);
+          bc.DecrementCount();
+          VLOG(3) << "ParallelForkJoin partition " << i << " done.";
+        });
+  }
+
+  // Call first compute function inline.
+  run_partition(0);
+  VLOG(3) << "ParallelForkJoin partition 0 done.";
+  bc.Wait();
+}
+
+// Collects error messages of all failed partitions (if any) into `status`.
+void SetForkJoinStatus(std::vector<XlaCustomCallStatus>& statuses,
+                       void* status) {
+  std::vector<std::pair<int32_t, absl::string_view>> error_messages;
+  for (int32_t i = 0; i < statuses.size(); ++i) {
+    std::optional<absl::string_view> msg =
+        xla::CustomCallStatusGetMessage(&statuses[i]);
+    if (msg) {
+      error_messages.emplace_back(i, *msg);
+    }
+  }
+
+  if (!error_messages.empty()) {
+    // Join all error messages into a single string to serve as the message for
+    // the returned status.
+    std::string error_message = absl::StrJoin(
+        error_messages, "\n",
+        [](std::string* out, std::pair<int32_t, absl::string_view> p) {
+          int32_t idx = p.first;
+          absl::string_view msg = p.second;
+          absl::StrAppend(out,
+                          absl::StrFormat("Partition %d error: %s", idx, msg));
+        });
+    XlaCustomCallStatusSetFailure(
+        reinterpret_cast<XlaCustomCallStatus*>(status), error_message.data(),
+        error_message.length());
+  }
+}
+
+}  // namespace
+
 // Dispatches 'num_partitions - 1' calls to 'function_ptr' in parallel.
 // Calls 'function_ptr' for first partition inline.
 // Uses blocking counter to synchronize threads after parallel calls complete.
@@ -81,50 +318,65 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ParallelForkJoin(
 
   std::vector<XlaCustomCallStatus> statuses(num_partitions);
 
-  // Dispatch 'num_partitions - 1' compute functions to run in parallel.
-  tsl::BlockingCounter bc(num_partitions - 1);
-  for (int32_t i = 1; i < num_partitions; ++i) {
-    const int64_t offset = i * stride;
-    run_options->intra_op_thread_pool()->enqueueNoNotification(
-        [i, function, result_ptr, run_options_ptr, buffer_table, prof_counters,
-         partitions, offset, &bc, &statuses]() {
-          function(result_ptr, run_options_ptr, nullptr, buffer_table,
-                   &statuses[i], &partitions[offset], prof_counters);
-          bc.DecrementCount();
-          VLOG(3) << "ParallelForkJoin partition " << i << " done.";
-        });
-  }
+  ForkJoinWithThreadPool(run_options, num_partitions, [&](int32_t i) {
+    function(result_ptr, run_options_ptr, params, buffer_table, &statuses[i],
+             &partitions[i * stride], prof_counters);
+  });
 
-  // Call first compute function inline.
-  function(result_ptr, run_options_ptr, params, buffer_table, statuses.data(),
-           partitions, prof_counters);
-  VLOG(3) << "ParallelForkJoin partition 0 done.";
-  bc.Wait();
+  SetForkJoinStatus(statuses, status);
+  VLOG(2) << "ParallelForkJoin EXIT";
+}
 
-  // Collect all error messages (if any).
-  std::vector<std::pair<int32_t, absl::string_view>> error_messages;
-  for (int32_t i = 0; i < num_partitions; ++i) {
-    std::optional<absl::string_view> msg =
-        xla::CustomCallStatusGetMessage(&statuses[i]);
-    if (msg) {
-      error_messages.emplace_back(i, *msg);
-    }
-  }
+// Same as '__xla_cpu_runtime_ParallelForkJoin' but dispatches partitions to a
+// team of persistent worker threads sized after the intra-op thread pool. Runs
+// all partitions inline if the number of partitions is small, and falls back
+// to the intra-op thread pool if the team is busy running another parallel
+// loop.
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void
+__xla_cpu_runtime_PersistentParallelForkJoin(
+    void* result_ptr, const void* run_options_ptr, const void** params,
+    void** buffer_table, void* status, uint64_t* prof_counters,
+    int32_t num_partitions, int64_t* partitions, int32_t num_partitioned_dims,
+    void* function_ptr) {
+  VLOG(2) << "PersistentParallelForkJoin ENTRY"
+          << " num_partitions: " << num_partitions
+          << " num_partitioned_dims: " << num_partitioned_dims;
+  CHECK_EQ(params, nullptr);
+  CHECK_GT(num_partitions, 1);
+  CHECK_GT(num_partitioned_dims, 0);
+  CHECK_NE(function_ptr, nullptr);
+  CHECK_NE(partitions, nullptr);
+  const xla::ExecutableRunOptions* run_options =
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
+  CHECK_NE(run_options, nullptr);
+  CHECK_NE(run_options->intra_op_thread_pool(), nullptr);
 
-  if (!error_messages.empty()) {
-    // Join all error messages into a single string to serve as the message for
-    // the returned status.
-    std::string error_message = absl::StrJoin(
-        error_messages, "\n",
-        [](std::string* out, std::pair<int32_t, absl::string_view> p) {
-          int32_t idx = p.first;
-          absl::string_view msg = p.second;
-          absl::StrAppend(out,
-                          absl::StrFormat("Partition %d error: %s", idx, msg));
-        });
-    XlaCustomCallStatusSetFailure(
-        reinterpret_cast<XlaCustomCallStatus*>(status), error_message.data(),
-        error_message.length());
+  ComputeFunctionType function =
+      reinterpret_cast<ComputeFunctionType>(function_ptr);
+  // Compute partition stride in 'partitions' array.
+  const int64_t stride = 2 * num_partitioned_dims;
+
+  std::vector<XlaCustomCallStatus> statuses(num_partitions);
+
+  auto run_partition = [&](int32_t i) {
+    function(result_ptr, run_options_ptr, params, buffer_table, &statuses[i],
+             &partitions[i * stride], prof_counters);
+  };
+
+  // The caller thread participates in the fork-join, so the team needs one
+  // less worker than the number of threads in the intra-op thread pool.
+  const int num_workers = run_options->intra_op_thread_pool()->numThreads() - 1;
+
+  if (num_partitions <= kMaxInlinePartitions || num_workers <= 0) {
+    for (int32_t i = 0; i < num_partitions; ++i) run_partition(i);
+  } else if (ForkJoinTeam* team = ForkJoinTeam::Get(num_workers);
+             team->TryAcquire()) {
+    team->ParallelFor(num_partitions, run_partition);
+    team->Release();
+  } else {
+    ForkJoinWithThreadPool(run_options, num_partitions, run_partition);
   }
-  VLOG(2) << "ParallelForkJoin EXIT";
+
+  SetForkJoinStatus(statuses, status);
+  VLOG(2) << "PersistentParallelForkJoin EXIT";
 }
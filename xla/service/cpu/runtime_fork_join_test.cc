@@ -0,0 +1,134 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime_fork_join.h"
+
+#define EIGEN_USE_THREADS
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+#include "xla/service/custom_call_status.h"
+#include "xla/service/custom_call_status_internal.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::cpu {
+namespace {
+
+using ForkJoinFunction = void (*)(void*, const void*, const void**, void**,
+                                  void*, uint64_t*, int32_t, int64_t*, int32_t,
+                                  void*);
+
+// A compute function with a single partitioned dimension that increments all
+// elements of the partition in `buffer_table[0]`.
+void IncrementPartition(void* result, const void* run_options,
+                        const void** params, void** buffer_table, void* status,
+                        int64_t* partition, uint64_t* prof_counters) {
+  int32_t* data = reinterpret_cast<int32_t*>(buffer_table[0]);
+  for (int64_t i = partition[0]; i < partition[1]; ++i) {
+    data[i] += 1;
+  }
+}
+
+// A compute function that fails for all partitions starting at `0`.
+void FailFirstPartition(void* result, const void* run_options,
+                        const void** params, void** buffer_table, void* status,
+                        int64_t* partition, uint64_t* prof_counters) {
+  if (partition[0] == 0) {
+    std::string msg = "boom";
+    XlaCustomCallStatusSetFailure(
+        reinterpret_cast<XlaCustomCallStatus*>(status), msg.data(),
+        msg.size());
+  }
+}
+
+// Returns partitions of [0, size) into `num_partitions` partitions.
+std::vector<int64_t> MakePartitions(int64_t size, int32_t num_partitions) {
+  std::vector<int64_t> partitions;
+  for (int32_t i = 0; i < num_partitions; ++i) {
+    partitions.push_back(i * size / num_partitions);
+    partitions.push_back((i + 1) * size / num_partitions);
+  }
+  return partitions;
+}
+
+class ForkJoinTest : public testing::TestWithParam<ForkJoinFunction> {};
+
+TEST_P(ForkJoinTest, RunsAllPartitions) {
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "fork-join", 8);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  // Run repeatedly to exercise going back and forth between spinning and
+  // parked workers.
+  for (int32_t num_partitions : {2, 3, 8, 16, 64}) {
+    std::vector<int32_t> data(1024, 0);
+    void* buffer_table[] = {data.data()};
+    std::vector<int64_t> partitions =
+        MakePartitions(data.size(), num_partitions);
+    XlaCustomCallStatus status;
+
+    for (int32_t i = 0; i < 10; ++i) {
+      GetParam()(nullptr, &run_options, nullptr, buffer_table, &status,
+                 nullptr, num_partitions, partitions.data(),
+                 /*num_partitioned_dims=*/1,
+                 reinterpret_cast<void*>(&IncrementPartition));
+    }
+
+    EXPECT_FALSE(CustomCallStatusGetMessage(&status).has_value());
+    for (int32_t value : data) {
+      ASSERT_EQ(value, 10);
+    }
+  }
+}
+
+TEST_P(ForkJoinTest, ReportsPartitionErrors) {
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "fork-join", 4);
+  Eigen::ThreadPoolDevice device(thread_pool.AsEigenThreadPool(),
+                                 thread_pool.NumThreads());
+
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  std::vector<int64_t> partitions = MakePartitions(16, 4);
+  XlaCustomCallStatus status;
+
+  GetParam()(nullptr, &run_options, nullptr, nullptr, &status, nullptr,
+             /*num_partitions=*/4, partitions.data(),
+             /*num_partitioned_dims=*/1,
+             reinterpret_cast<void*>(&FailFirstPartition));
+
+  std::optional<absl::string_view> msg = CustomCallStatusGetMessage(&status);
+  ASSERT_TRUE(msg.has_value());
+  EXPECT_EQ(*msg, "Partition 0 error: boom");
+}
+
+INSTANTIATE_TEST_SUITE_P(ForkJoin, ForkJoinTest,
+                         testing::Values(
+                             &__xla_cpu_runtime_ParallelForkJoin,
+                             &__xla_cpu_runtime_PersistentParallelForkJoin));
+
+}  // namespace
+}  // namespace xla::cpu
@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_CPU_RUNTIME_MATMUL_COMMON_H_
 
 #include <cstdint>
+#include <type_traits>
 
 #define EIGEN_USE_THREADS
 
@@ -35,8 +36,11 @@ static inline bool Is16BytesAligned(void* ptr) {
   return reinterpret_cast<uintptr_t>(ptr) % 16 == 0;
 }
 
-template <typename T, Eigen::AlignmentType Alignment>
-void MatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs, int64_t m,
+// Computes `out = lhs x rhs`. If `OutT` differs from `T` the operands are read
+// in `T` and converted to `OutT` by Eigen while packing them for the GEMM
+// kernel, so the wider operands are never materialized in memory.
+template <typename T, Eigen::AlignmentType Alignment, typename OutT = T>
+void MatMul(const void* run_options_ptr, OutT* out, T* lhs, T* rhs, int64_t m,
             int64_t n, int64_t k, int32_t transpose_lhs,
             int32_t transpose_rhs) {
   const xla::ExecutableRunOptions* run_options =
@@ -58,7 +62,7 @@ void MatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs, int64_t m,
                                                                  lhs_cols);
   const Eigen::TensorMap<Eigen::Tensor<const T, 2>, Alignment> B(rhs, rhs_rows,
                                                                  rhs_cols);
-  Eigen::TensorMap<Eigen::Tensor<T, 2>, Alignment> C(out, m, n);
+  Eigen::TensorMap<Eigen::Tensor<OutT, 2>, Alignment> C(out, m, n);
 
   typedef typename Eigen::Tensor<T, 2>::DimensionPair DimPair;
   int lhs_contract_dim = transpose_lhs ? 0 : 1;
@@ -70,7 +74,12 @@ void MatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs, int64_t m,
   // the contraction is performed along dimension 1 of the lhs and dimension
   // 0 of the rhs.
   XLA_LIGHTWEIGHT_CHECK(run_options->intra_op_thread_pool() != nullptr);
-  C.device(*run_options->intra_op_thread_pool()) = A.contract(B, dims);
+  if constexpr (std::is_same_v<T, OutT>) {
+    C.device(*run_options->intra_op_thread_pool()) = A.contract(B, dims);
+  } else {
+    C.device(*run_options->intra_op_thread_pool()) =
+        A.template cast<OutT>().contract(B.template cast<OutT>(), dims);
+  }
 }
 
 template <typename T, Eigen::AlignmentType Alignment>
@@ -116,21 +125,21 @@ void MatMul_Batch(const void* run_options_ptr, T* out, T* lhs, T* rhs,
   }
 }
 
-template <typename T>
-void MatMulDispatch(const void* run_options_ptr, T* out, T* lhs, T* rhs,
+template <typename T, typename OutT = T>
+void MatMulDispatch(const void* run_options_ptr, OutT* out, T* lhs, T* rhs,
                     int64_t m, int64_t n, int64_t k, int32_t transpose_lhs,
                     int32_t transpose_rhs) {
   bool all_buffers_16b_aligned =
       Is16BytesAligned(out) && Is16BytesAligned(lhs) && Is16BytesAligned(rhs);
 
   if (!all_buffers_16b_aligned) {
-    MatMul<T, Eigen::Unaligned>(run_options_ptr, out, lhs, rhs, m, n, k,
-                                transpose_lhs, transpose_rhs);
+    MatMul<T, Eigen::Unaligned, OutT>(run_options_ptr, out, lhs, rhs, m, n, k,
+                                      transpose_lhs, transpose_rhs);
     return;
   }
 
-  MatMul<T, Eigen::Aligned16>(run_options_ptr, out, lhs, rhs, m, n, k,
-                              transpose_lhs, transpose_rhs);
+  MatMul<T, Eigen::Aligned16, OutT>(run_options_ptr, out, lhs, rhs, m, n, k,
+                                    transpose_lhs, transpose_rhs);
 }
 
 template <typename T>
@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_CPU_RUNTIME_SINGLE_THREADED_MATMUL_COMMON_H_
 
 #include <cstdint>
+#include <type_traits>
 
 #include "absl/base/attributes.h"
 #include "Eigen/Core"  // from @eigen_archive
@@ -32,9 +33,12 @@ static inline bool Is16BytesAligned(void* ptr) {
   return reinterpret_cast<uintptr_t>(ptr) % 16 == 0;
 }
 
-template <typename T, Eigen::AlignmentType Alignment>
-void SingleThreadedMatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs,
-                          int64_t m, int64_t n, int64_t k,
+// Computes `out = lhs x rhs`. If `OutT` differs from `T` the operands are read
+// in `T` and converted to `OutT` by Eigen while packing them for the GEMM
+// kernel.
+template <typename T, Eigen::AlignmentType Alignment, typename OutT = T>
+void SingleThreadedMatMul(const void* run_options_ptr, OutT* out, T* lhs,
+                          T* rhs, int64_t m, int64_t n, int64_t k,
                           int32_t transpose_lhs, int32_t transpose_rhs) {
   int64_t lhs_rows = m;
   int64_t lhs_cols = k;
@@ -52,7 +56,7 @@ void SingleThreadedMatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs,
                                                                  lhs_cols);
   const Eigen::TensorMap<Eigen::Tensor<const T, 2>, Alignment> B(rhs, rhs_rows,
                                                                  rhs_cols);
-  Eigen::TensorMap<Eigen::Tensor<T, 2>, Alignment> C(out, m, n);
+  Eigen::TensorMap<Eigen::Tensor<OutT, 2>, Alignment> C(out, m, n);
 
   typedef typename Eigen::Tensor<T, 2>::DimensionPair DimPair;
   int lhs_contract_dim = transpose_lhs ? 0 : 1;
@@ -63,24 +67,29 @@ void SingleThreadedMatMul(const void* run_options_ptr, T* out, T* lhs, T* rhs,
   // Matrix multiply is a special case of the "contract" operation where
   // the contraction is performed along dimension 1 of the lhs and dimension
   // 0 of the rhs.
-  C = A.contract(B, dims);
+  if constexpr (std::is_same_v<T, OutT>) {
+    C = A.contract(B, dims);
+  } else {
+    C = A.template cast<OutT>().contract(B.template cast<OutT>(), dims);
+  }
 }
 
-template <typename T>
-void SingleThreadedMatMulDispatch(const void* run_options_ptr, T* out, T* lhs,
-                                  T* rhs, int64_t m, int64_t n, int64_t k,
-                                  int32_t transpose_lhs,
+template <typename T, typename OutT = T>
+void SingleThreadedMatMulDispatch(const void* run_options_ptr, OutT* out,
+                                  T* lhs, T* rhs, int64_t m, int64_t n,
+                                  int64_t k, int32_t transpose_lhs,
                                   int32_t transpose_rhs) {
   bool all_buffers_16b_aligned =
       Is16BytesAligned(out) && Is16BytesAligned(lhs) && Is16BytesAligned(rhs);
 
   if (!all_buffers_16b_aligned) {
-    SingleThreadedMatMul<T, Eigen::Unaligned>(
+    SingleThreadedMatMul<T, Eigen::Unaligned, OutT>(
         run_options_ptr, out, lhs, rhs, m, n, k, transpose_lhs, transpose_rhs);
+    return;
   }
 
-  SingleThreadedMatMul<T, Eigen::Aligned16>(run_options_ptr, out, lhs, rhs, m,
-                                            n, k, transpose_lhs, transpose_rhs);
+  SingleThreadedMatMul<T, Eigen::Aligned16, OutT>(
+      run_options_ptr, out, lhs, rhs, m, n, k, transpose_lhs, transpose_rhs);
 }
 
 }  // namespace xla
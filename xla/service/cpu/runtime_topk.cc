@@ -16,60 +16,183 @@ limitations under the License.
 #include "xla/service/cpu/runtime_topk.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <limits>
-#include <memory>
-#include <numeric>
+#include <type_traits>
 #include <vector>
 
 #include "absl/base/dynamic_annotations.h"
+#include "Eigen/Core"  // from @eigen_archive
+
+namespace xla::cpu {
+namespace {
+
+// Number of values checked against the current top-k threshold at once. The
+// check is a branch-free loop that the compiler vectorizes, and most blocks
+// of a large input are skipped without touching the heap.
+constexpr int64_t kBlockSize = 64;
 
 template <typename T>
-static void TopK(int64_t batch_size, int64_t input_size, int64_t k,
-                 const T* values, T* out_values, int32_t* out_indices) {
-  // 'values' is managed by the JIT code, so msan can't tell they are
-  // initialized.
-  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values,
-                                      input_size * batch_size * sizeof(T));
+struct OrderedKeyType {
+  using Type = T;
+};
+template <>
+struct OrderedKeyType<float> {
+  using Type = int32_t;
+};
+template <>
+struct OrderedKeyType<Eigen::bfloat16> {
+  using Type = int16_t;
+};
+template <>
+struct OrderedKeyType<Eigen::half> {
+  using Type = int16_t;
+};
 
-  std::vector<int32_t> temp_indices(input_size);
-  for (int64_t batch = 0; batch != batch_size; ++batch) {
-    std::iota(temp_indices.begin(), temp_indices.end(), 0);
-
-    const T* values_batch = values + batch * input_size;
-
-    auto convert_to_int = [](T value) {
-      uint32_t x;
-      std::memcpy(&x, &value, sizeof(x));
-      return static_cast<int32_t>(x) < 0
-                 ? std::numeric_limits<int32_t>::max() - x
-                 : x;
-    };
-
-    auto kth_element = temp_indices.begin() + k;
-    std::partial_sort(temp_indices.begin(), kth_element, temp_indices.end(),
-                      [&](size_t i1, size_t i2) {
-                        // Do the comparison in integers to enforce a total
-                        // order of -NaN < -Inf < -0 < +0 < +Inf < +NaN.
-                        int32_t v1 = convert_to_int(values_batch[i1]);
-                        int32_t v2 = convert_to_int(values_batch[i2]);
-                        if (v1 == v2) {
-                          return i1 < i2;  // Stabilize sorting.
-                        }
-                        return v1 > v2;
-                      });
-
-    T* out_values_batch = out_values + batch * k;
-    int32_t* out_indices_batch = out_indices + batch * k;
-    std::copy(temp_indices.begin(), kth_element, out_indices_batch);
-    for (int64_t i = 0; i < k; i++) {
-      out_values_batch[i] = values_batch[temp_indices[i]];
+// Maps a value to a signed integer key, such that comparing keys gives a total
+// order of the values: -NaN < -Inf < -0 < +0 < +Inf < +NaN.
+template <typename T, typename Key = typename OrderedKeyType<T>::Type>
+inline Key ToOrderedKey(T value) {
+  if constexpr (std::is_integral_v<T>) {
+    return value;
+  } else {
+    static_assert(sizeof(Key) == sizeof(T));
+    Key key;
+    std::memcpy(&key, &value, sizeof(Key));
+    return key < 0 ? static_cast<Key>(key ^ std::numeric_limits<Key>::max())
+                   : key;
+  }
+}
+
+template <typename Key>
+struct Candidate {
+  Key key;
+  int32_t index;
+};
+
+// Returns true if `a` goes before `b` in the top-k result. Values are sorted
+// in descending order, and equal values in the order of their indices.
+template <typename Key>
+inline bool Precedes(const Candidate<Key>& a, const Candidate<Key>& b) {
+  return a.key > b.key || (a.key == b.key && a.index < b.index);
+}
+
+// Selects the top-k values of a single row. The heap holds the best `k`
+// candidates seen so far, with the worst one on top. A candidate with a later
+// index enters the heap only if its value is strictly larger than the worst
+// one, which keeps the result stable.
+template <typename T, typename Key = typename OrderedKeyType<T>::Type>
+void TopKRow(int64_t input_size, int64_t k, const T* values, T* out_values,
+             int32_t* out_indices, std::vector<Candidate<Key>>& heap) {
+  heap.clear();
+  for (int64_t i = 0; i < k; ++i) {
+    heap.push_back({ToOrderedKey(values[i]), static_cast<int32_t>(i)});
+  }
+  std::make_heap(heap.begin(), heap.end(), Precedes<Key>);
+
+  auto push = [&](int64_t i) {
+    Key key = ToOrderedKey(values[i]);
+    if (key > heap.front().key) {
+      std::pop_heap(heap.begin(), heap.end(), Precedes<Key>);
+      heap.back() = {key, static_cast<int32_t>(i)};
+      std::push_heap(heap.begin(), heap.end(), Precedes<Key>);
+    }
+  };
+
+  int64_t i = k;
+  for (; i + kBlockSize <= input_size; i += kBlockSize) {
+    Key threshold = heap.front().key;
+    bool has_candidates = false;
+    for (int64_t j = 0; j < kBlockSize; ++j) {
+      has_candidates |= ToOrderedKey(values[i + j]) > threshold;
     }
+    if (!has_candidates) continue;
+    for (int64_t j = 0; j < kBlockSize; ++j) push(i + j);
+  }
+  for (; i < input_size; ++i) push(i);
+
+  std::sort_heap(heap.begin(), heap.end(), Precedes<Key>);
+  for (int64_t r = 0; r < k; ++r) {
+    out_values[r] = values[heap[r].index];
+    out_indices[r] = heap[r].index;
+  }
+}
+
+template <typename T>
+void TopKImpl(int64_t batch_size, int64_t input_size, int64_t k,
+              const T* values, T* out_values, int32_t* out_indices) {
+  if (k == 0) return;
+
+  std::vector<Candidate<typename OrderedKeyType<T>::Type>> heap;
+  heap.reserve(k);
+  for (int64_t batch = 0; batch < batch_size; ++batch) {
+    TopKRow(input_size, k, values + batch * input_size,
+            out_values + batch * k, out_indices + batch * k, heap);
   }
 }
 
+}  // namespace
+
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const float* values, float* out_values, int32_t* out_indices) {
+  TopKImpl(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const Eigen::bfloat16* values, Eigen::bfloat16* out_values,
+          int32_t* out_indices) {
+  TopKImpl(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const Eigen::half* values, Eigen::half* out_values,
+          int32_t* out_indices) {
+  TopKImpl(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const int32_t* values, int32_t* out_values, int32_t* out_indices) {
+  TopKImpl(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+}  // namespace xla::cpu
+
+// 'values' are managed by the JIT code, so msan can't tell they are
+// initialized.
+template <typename T>
+static void AnnotateValues(int64_t batch_size, int64_t input_size,
+                           const T* values) {
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values,
+                                      input_size * batch_size * sizeof(T));
+}
+
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKF32(
     int64_t batch_size, int64_t input_size, int64_t k, const float* values,
     float* out_values, int32_t* out_indices) {
-  TopK(batch_size, input_size, k, values, out_values, out_indices);
+  AnnotateValues(batch_size, input_size, values);
+  xla::cpu::TopK(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKBF16(
+    int64_t batch_size, int64_t input_size, int64_t k,
+    const Eigen::bfloat16* values, Eigen::bfloat16* out_values,
+    int32_t* out_indices) {
+  AnnotateValues(batch_size, input_size, values);
+  xla::cpu::TopK(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKF16(
+    int64_t batch_size, int64_t input_size, int64_t k,
+    const Eigen::half* values, Eigen::half* out_values,
+    int32_t* out_indices) {
+  AnnotateValues(batch_size, input_size, values);
+  xla::cpu::TopK(batch_size, input_size, k, values, out_values, out_indices);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKS32(
+    int64_t batch_size, int64_t input_size, int64_t k, const int32_t* values,
+    int32_t* out_values, int32_t* out_indices) {
+  AnnotateValues(batch_size, input_size, values);
+  xla::cpu::TopK(batch_size, input_size, k, values, out_values, out_indices);
 }
@@ -18,6 +18,28 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include "Eigen/Core"  // from @eigen_archive
+
+namespace xla::cpu {
+
+// Computes `batch_size` top-k operations with `input_size` inputs each in the
+// calling thread. Values are compared in total order (-NaN < -Inf < -0 < +0 <
+// +Inf < +NaN for floating point types), and equal values are returned in the
+// order of their indices. The outputs are written to `out_values` and
+// `out_indices`, `k` elements per batch row.
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const float* values, float* out_values, int32_t* out_indices);
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const Eigen::bfloat16* values, Eigen::bfloat16* out_values,
+          int32_t* out_indices);
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const Eigen::half* values, Eigen::half* out_values,
+          int32_t* out_indices);
+void TopK(int64_t batch_size, int64_t input_size, int64_t k,
+          const int32_t* values, int32_t* out_values, int32_t* out_indices);
+
+}  // namespace xla::cpu
+
 extern "C" {
 
 // Calculates `batch_size` topk operations with `input_size` inputs each. The
@@ -25,6 +47,19 @@ extern "C" {
 extern void __xla_cpu_runtime_TopKF32(int64_t batch_size, int64_t input_size,
                                       int64_t k, const float* values,
                                       float* out_values, int32_t* out_indices);
+extern void __xla_cpu_runtime_TopKBF16(int64_t batch_size, int64_t input_size,
+                                       int64_t k,
+                                       const Eigen::bfloat16* values,
+                                       Eigen::bfloat16* out_values,
+                                       int32_t* out_indices);
+extern void __xla_cpu_runtime_TopKF16(int64_t batch_size, int64_t input_size,
+                                      int64_t k, const Eigen::half* values,
+                                      Eigen::half* out_values,
+                                      int32_t* out_indices);
+extern void __xla_cpu_runtime_TopKS32(int64_t batch_size, int64_t input_size,
+                                      int64_t k, const int32_t* values,
+                                      int32_t* out_values,
+                                      int32_t* out_indices);
 }
 
 #endif  // XLA_SERVICE_CPU_RUNTIME_TOPK_H_
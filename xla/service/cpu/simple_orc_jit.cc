@@ -28,6 +28,9 @@ limitations under the License.
 #include <vector>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
@@ -36,8 +39,10 @@ limitations under the License.
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/IR/Operator.h"
+#include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/Memory.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Process.h"
@@ -49,6 +54,7 @@ limitations under the License.
 #include "xla/service/cpu/runtime_conv2d_acl.h"
 #include "xla/service/cpu/runtime_conv2d_mkl.h"
 #include "xla/service/cpu/runtime_conv3d.h"
+#include "xla/service/cpu/runtime_cpu_features.h"
 #include "xla/service/cpu/runtime_custom_call_status.h"
 #include "xla/service/cpu/runtime_fft.h"
 #include "xla/service/cpu/runtime_fork_join.h"
@@ -68,6 +74,7 @@ limitations under the License.
 #include "xla/types.h"
 #include "xla/util.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/threadpool.h"
 
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
 #include "xla/service/cpu/onednn_layer_norm.h"
@@ -324,6 +331,15 @@ SimpleOrcJIT::SimpleOrcJIT(
     : target_machine_(InferTargetMachineForJIT(target_options, opt_level)),
       target_triple_(target_machine_->getTargetTriple()),
       data_layout_(target_machine_->createDataLayout()),
+      target_options_(target_options),
+      opt_level_(opt_level),
+      optimize_for_size_(optimize_for_size),
+      disable_expensive_passes_(disable_expensive_passes),
+      disable_slp_vectorizer_(disable_slp_vectorizer),
+      fast_math_flags_(fast_math_flags),
+      pre_optimization_hook_(std::move(pre_optimization_hook)),
+      post_optimization_hook_(std::move(post_optimization_hook)),
+      post_codegen_hook_(std::move(post_codegen_hook)),
       target_process_control_(std::move(target_process_control)),
       execution_session_(std::move(execution_session)),
       object_layer_(*execution_session_,
@@ -331,14 +347,8 @@ SimpleOrcJIT::SimpleOrcJIT(
                       return std::make_unique<ContiguousSectionMemoryManager>(
                           orc_jit_memory_mapper::GetInstance());
                     }),
-      compile_layer_(
-          *execution_session_, object_layer_,
-          std::make_unique<CompilerFunctor>(
-              target_machine_.get(), static_cast<int>(opt_level),
-              optimize_for_size, disable_expensive_passes,
-              disable_slp_vectorizer, fast_math_flags,
-              std::move(pre_optimization_hook),
-              std::move(post_optimization_hook), std::move(post_codegen_hook))),
+      compile_layer_(*execution_session_, object_layer_,
+                     CreateCompilerFunctor(target_machine_.get())),
       main_jit_dylib_(&execution_session_->createBareJITDylib("<main>")),
       gdb_jit_event_listener_(
           llvm::JITEventListener::createGDBRegistrationListener()),
@@ -462,6 +472,95 @@ llvm::Error SimpleOrcJIT::AddModule(llvm::orc::ThreadSafeModule module) {
   return compile_layer_.add(*main_jit_dylib_, std::move(module));
 }
 
+llvm::Error SimpleOrcJIT::AddModules(
+    std::vector<llvm::orc::ThreadSafeModule> modules,
+    tsl::thread::ThreadPool* thread_pool) {
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> obj_files(modules.size());
+  std::vector<std::string> errors(modules.size());
+
+  // Compiles module at the given index to an object file. Every compilation
+  // task uses its own target machine, as target machines are not thread safe.
+  // Post codegen hook is called below in the module order, so that object
+  // files are reported (and dumped) deterministically.
+  auto compile = [&](size_t index) {
+    std::unique_ptr<llvm::TargetMachine> target_machine =
+        InferTargetMachineForJIT(target_options_, opt_level_);
+    std::unique_ptr<CompilerFunctor> compiler = CreateCompilerFunctor(
+        target_machine.get(), /*with_post_codegen_hook=*/false);
+
+    modules[index].withModuleDo([&](llvm::Module& module) {
+      llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> obj_file =
+          (*compiler)(module);
+      if (obj_file) {
+        obj_files[index] = std::move(*obj_file);
+      } else {
+        errors[index] = llvm::toString(obj_file.takeError());
+      }
+    });
+  };
+
+  if (thread_pool == nullptr) {
+    for (size_t i = 0; i < modules.size(); ++i) compile(i);
+  } else {
+    absl::BlockingCounter counter(modules.size());
+    for (size_t i = 0; i < modules.size(); ++i) {
+      thread_pool->Schedule([&, i] {
+        compile(i);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+
+  for (size_t i = 0; i < modules.size(); ++i) {
+    if (!errors[i].empty()) {
+      return llvm::make_error<llvm::StringError>(
+          absl::StrCat("Failed to compile module #", i, ": ", errors[i]),
+          llvm::inconvertibleErrorCode());
+    }
+  }
+
+  for (std::unique_ptr<llvm::MemoryBuffer>& obj_file : obj_files) {
+    if (post_codegen_hook_) {
+      llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> object =
+          llvm::object::ObjectFile::createObjectFile(*obj_file);
+      if (!object) return object.takeError();
+      absl::MutexLock lock(&hooks_mu_);
+      post_codegen_hook_(**object);
+    }
+    if (auto err = AddObjFile(std::move(obj_file))) return err;
+  }
+
+  return llvm::Error::success();
+}
+
+std::unique_ptr<CompilerFunctor> SimpleOrcJIT::CreateCompilerFunctor(
+    llvm::TargetMachine* target_machine, bool with_post_codegen_hook) {
+  auto pre_optimization_hook = [this](const llvm::Module& module) {
+    absl::MutexLock lock(&hooks_mu_);
+    if (pre_optimization_hook_) pre_optimization_hook_(module);
+  };
+
+  auto post_optimization_hook = [this](const llvm::Module& module) {
+    absl::MutexLock lock(&hooks_mu_);
+    if (post_optimization_hook_) post_optimization_hook_(module);
+  };
+
+  absl::AnyInvocable<void(const llvm::object::ObjectFile&)> post_codegen_hook;
+  if (with_post_codegen_hook) {
+    post_codegen_hook = [this](const llvm::object::ObjectFile& obj_file) {
+      absl::MutexLock lock(&hooks_mu_);
+      if (post_codegen_hook_) post_codegen_hook_(obj_file);
+    };
+  }
+
+  return std::make_unique<CompilerFunctor>(
+      target_machine, static_cast<int>(opt_level_), optimize_for_size_,
+      disable_expensive_passes_, disable_slp_vectorizer_, fast_math_flags_,
+      std::move(pre_optimization_hook), std::move(post_optimization_hook),
+      std::move(post_codegen_hook));
+}
+
 void SimpleOrcJIT::DoneCompiling() {
   // The target machine takes a non-trivial amount of memory, so once we are
   // done compiling throw it away.
@@ -500,6 +599,8 @@ bool RegisterKnownJITSymbols() {
   REGISTER_CPU_RUNTIME_SYMBOL(AcquireInfeedBufferForDequeue);
   REGISTER_CPU_RUNTIME_SYMBOL(AcquireOutfeedBufferForPopulation);
   REGISTER_CPU_RUNTIME_SYMBOL(AllReduce);
+  REGISTER_CPU_RUNTIME_SYMBOL(AllReduceStart);
+  REGISTER_CPU_RUNTIME_SYMBOL(AllReduceDone);
   REGISTER_CPU_RUNTIME_SYMBOL(CollectivePermute);
   REGISTER_CPU_RUNTIME_SYMBOL(AllToAll);
   REGISTER_CPU_RUNTIME_SYMBOL(AllGather);
@@ -518,6 +619,8 @@ bool RegisterKnownJITSymbols() {
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulC64);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulC128);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulS32);
+  REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulBF16F32);
+  REGISTER_CPU_RUNTIME_SYMBOL(EigenMatMulS8S32);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenBatchMatMulF32);
   REGISTER_CPU_RUNTIME_SYMBOL(ACLMatMulF32);
   REGISTER_CPU_RUNTIME_SYMBOL(ACLBatchMatMulF32);
@@ -533,13 +636,20 @@ bool RegisterKnownJITSymbols() {
   REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulC64);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulC128);
   REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulS32);
+  REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulBF16F32);
+  REGISTER_CPU_RUNTIME_SYMBOL(EigenSingleThreadedMatMulS8S32);
   REGISTER_CPU_RUNTIME_SYMBOL(ParallelForkJoin);
+  REGISTER_CPU_RUNTIME_SYMBOL(PersistentParallelForkJoin);
   REGISTER_CPU_RUNTIME_SYMBOL(PrintfToStderr);
   REGISTER_CPU_RUNTIME_SYMBOL(ReleaseInfeedBufferAfterDequeue);
   REGISTER_CPU_RUNTIME_SYMBOL(ReleaseOutfeedBufferAfterPopulation);
   REGISTER_CPU_RUNTIME_SYMBOL(StatusIsSuccess);
   REGISTER_CPU_RUNTIME_SYMBOL(KeyValueSort);
+  REGISTER_CPU_RUNTIME_SYMBOL(HostSupportsTargetFeatures);
   REGISTER_CPU_RUNTIME_SYMBOL(TopKF32);
+  REGISTER_CPU_RUNTIME_SYMBOL(TopKBF16);
+  REGISTER_CPU_RUNTIME_SYMBOL(TopKF16);
+  REGISTER_CPU_RUNTIME_SYMBOL(TopKS32);
   REGISTER_CPU_RUNTIME_SYMBOL(TracingStart);
   REGISTER_CPU_RUNTIME_SYMBOL(TracingEnd);
   REGISTER_CPU_RUNTIME_SYMBOL(HandleFfiCall);
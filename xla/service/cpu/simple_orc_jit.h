@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_SIMPLE_ORC_JIT_H_
 #define XLA_SERVICE_CPU_SIMPLE_ORC_JIT_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
@@ -30,9 +32,12 @@ limitations under the License.
 #include "llvm/IR/Module.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Triple.h"
 #include "xla/service/cpu/compiler_functor.h"
+#include "xla/service/llvm_compiler.h"
 #include "xla/types.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace cpu {
@@ -86,6 +91,17 @@ class SimpleOrcJIT : public llvm::JITEventListener {
   llvm::Error AddObjFile(std::unique_ptr<llvm::MemoryBuffer> obj_file);
   llvm::Error AddModule(llvm::orc::ThreadSafeModule module);
 
+  // Compiles modules to object files concurrently using `thread_pool` and adds
+  // them to the JIT. Each module must be owned by its own LLVM context, as LLVM
+  // contexts are not thread safe. Modules can reference symbols defined in
+  // other modules, all references are resolved when objects are linked. If
+  // thread pool is nullptr, compiles modules sequentially in the caller thread.
+  //
+  // Unlike `AddModule`, compilation is eager and all post codegen hooks are
+  // called before this function returns, in the order of `modules`.
+  llvm::Error AddModules(std::vector<llvm::orc::ThreadSafeModule> modules,
+                         tsl::thread::ThreadPool* thread_pool);
+
   // Discards objects we no longer need once we are done compiling.
   void DoneCompiling();
 
@@ -109,6 +125,13 @@ class SimpleOrcJIT : public llvm::JITEventListener {
  private:
   llvm::orc::ExecutorSymbolDef ResolveRuntimeSymbol(llvm::StringRef name);
 
+  // Creates a compiler functor that compiles LLVM modules with the given target
+  // machine. All functors share the compilation hooks of this JIT. If
+  // `with_post_codegen_hook` is false, the caller is responsible for calling
+  // the post codegen hook.
+  std::unique_ptr<CompilerFunctor> CreateCompilerFunctor(
+      llvm::TargetMachine* target_machine, bool with_post_codegen_hook = true);
+
   void notifyObjectLoaded(
       llvm::JITEventListener::ObjectKey key,
       const llvm::object::ObjectFile& object,
@@ -118,6 +141,22 @@ class SimpleOrcJIT : public llvm::JITEventListener {
   std::unique_ptr<llvm::TargetMachine> target_machine_;
   llvm::Triple target_triple_;
   const llvm::DataLayout data_layout_;
+
+  // Options required to construct target machines and compiler functors for
+  // compiling modules concurrently (see `AddModules`).
+  const llvm::TargetOptions target_options_;
+  const llvm::CodeGenOptLevel opt_level_;
+  const bool optimize_for_size_;
+  const bool disable_expensive_passes_;
+  const bool disable_slp_vectorizer_;
+  const llvm::FastMathFlags fast_math_flags_;
+
+  // Compilation hooks can be called concurrently from multiple compiler
+  // functors, and we serialize all calls with a mutex.
+  absl::Mutex hooks_mu_;
+  LLVMCompiler::ModuleHook pre_optimization_hook_;
+  LLVMCompiler::ModuleHook post_optimization_hook_;
+  absl::AnyInvocable<void(const llvm::object::ObjectFile&)> post_codegen_hook_;
   std::unique_ptr<llvm::orc::ExecutorProcessControl> target_process_control_;
   std::unique_ptr<llvm::orc::ExecutionSession> execution_session_;
   ObjLayerT object_layer_;
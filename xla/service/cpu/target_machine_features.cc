@@ -17,7 +17,10 @@ limitations under the License.
 
 #include <algorithm>
 
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "xla/cpu_function_runtime.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/logging.h"
 
 namespace xla {
@@ -51,5 +54,30 @@ int64_t LLVMTargetMachineFeatures::minimum_alignment_for_allocation(
                            cpu_function_runtime::MinAlign());
 }
 
+bool LLVMTargetMachineFeatures::has_low_precision_dot(
+    PrimitiveType operand_type) const {
+  auto has_feature = [&](absl::string_view feature) {
+    for (absl::string_view f : absl::StrSplit(
+             target_machine_->getTargetFeatureString(), ',')) {
+      if (!f.empty() && f.front() == '+' && f.substr(1) == feature) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  switch (operand_type) {
+    case BF16:
+      // x86 AVX512-BF16 (vdpbf16ps) and AArch64 BF16 (bfdot, bfmmla).
+      return has_feature("avx512bf16") || has_feature("bf16");
+    case S8:
+      // x86 VNNI (vpdpbusd) and AArch64 dot product (sdot) extensions.
+      return has_feature("avx512vnni") || has_feature("avxvnni") ||
+             has_feature("dotprod");
+    default:
+      return false;
+  }
+}
+
 }  // namespace cpu
 }  // namespace xla
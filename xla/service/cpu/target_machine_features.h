@@ -62,6 +62,11 @@ class TargetMachineFeatures {
   virtual int64_t minimum_alignment_for_allocation(
       int64_t size_bytes) const = 0;
 
+  // Returns true if the target has instructions that multiply `operand_type`
+  // values and accumulate them in a wider type (BF16 into F32, S8 into S32),
+  // so that dots don't need their operands upcast before the multiplication.
+  virtual bool has_low_precision_dot(PrimitiveType operand_type) const = 0;
+
   virtual ~TargetMachineFeatures() = default;
 };
 
@@ -101,6 +106,8 @@ class LLVMTargetMachineFeatures : public TargetMachineFeatures {
 
   int64_t minimum_alignment_for_allocation(int64_t size_bytes) const override;
 
+  bool has_low_precision_dot(PrimitiveType operand_type) const override;
+
  private:
   llvm::TargetTransformInfo* GetTargetTransformInfoFor(
       const llvm::Function& function) const;
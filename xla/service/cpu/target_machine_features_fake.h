@@ -52,6 +52,10 @@ class TargetMachineFeaturesWithFakeAlignmentLogic
     return fake_alignment_logic_(size_bytes);
   }
 
+  bool has_low_precision_dot(PrimitiveType operand_type) const override {
+    return false;
+  }
+
  private:
   std::function<int64_t(int64_t)> fake_alignment_logic_;
 };
@@ -0,0 +1,84 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "xla/debug_options_flags.h"
+#include "xla/service/cpu/tests/cpu_codegen_test.h"
+#include "xla/service/hlo_module_config.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+class CpuAsyncAllReduceTest : public CpuCodegenTest {
+ protected:
+  absl::StatusOr<std::unique_ptr<HloModule>> ParseModule(
+      bool enable_async_all_reduce) {
+    constexpr char kHloText[] = R"(
+HloModule module
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY main {
+  p0 = f32[1024] parameter(0)
+  p1 = f32[1024] parameter(1)
+  all-reduce = f32[1024] all-reduce(p0), replica_groups={}, to_apply=add
+  multiply = f32[1024] multiply(p1, p1)
+  ROOT tuple = (f32[1024], f32[1024]) tuple(all-reduce, multiply)
+})";
+
+    HloModuleConfig config;
+    config.set_replica_count(2);
+    DebugOptions debug_options = GetDebugOptionsFromFlags();
+    debug_options.set_xla_cpu_enable_async_all_reduce(enable_async_all_reduce);
+    config.set_debug_options(debug_options);
+    return ParseAndReturnVerifiedModule(kHloText, config);
+  }
+};
+
+TEST_F(CpuAsyncAllReduceTest, EmitsStartAndDone) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseModule(/*enable_async_all_reduce=*/true));
+  CompileAndVerifyIr(std::move(module), R"(
+CHECK-NOT: call void @__xla_cpu_runtime_AllReduce(
+CHECK: call void @__xla_cpu_runtime_AllReduceStart(
+CHECK: call void @__xla_cpu_runtime_AllReduceDone(
+)",
+                     /*match_optimized_ir=*/false);
+}
+
+TEST_F(CpuAsyncAllReduceTest, EmitsBlockingAllReduceByDefault) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseModule(/*enable_async_all_reduce=*/false));
+  CompileAndVerifyIr(std::move(module), R"(
+CHECK-NOT: call void @__xla_cpu_runtime_AllReduceStart(
+CHECK: call void @__xla_cpu_runtime_AllReduce(
+)",
+                     /*match_optimized_ir=*/false);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -0,0 +1,161 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/tests/hlo_test_base.h"
+#include "xla/tests/literal_test_util.h"
+#include "xla/xla.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/status.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::cpu {
+namespace {
+
+constexpr absl::string_view kHlo = R"(
+HloModule m
+
+ENTRY e {
+  a = f32[4] parameter(0)
+  b = f32[4] parameter(1)
+  exp = f32[4] exponential(a)
+  ROOT add = f32[4] add(exp, b)
+})";
+
+class CpuObjectCacheTest : public HloTestBase {
+ protected:
+  void SetUp() override {
+    HloTestBase::SetUp();
+    const ::testing::TestInfo* test_info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    cache_dir_ = tsl::io::JoinPath(::testing::TempDir(), test_info->name());
+    TF_ASSERT_OK(tsl::Env::Default()->RecursivelyCreateDir(cache_dir_));
+  }
+
+  absl::StatusOr<std::unique_ptr<HloModule>> ParseModule(
+      const DebugOptions& debug_options) {
+    HloModuleConfig config = GetModuleConfigForTest();
+    config.set_debug_options(debug_options);
+    return ParseAndReturnVerifiedModule(kHlo, config);
+  }
+
+  DebugOptions GetDebugOptionsWithCache() {
+    DebugOptions debug_options = GetDebugOptionsForTest();
+    debug_options.set_xla_cpu_object_cache_dir(cache_dir_);
+    return debug_options;
+  }
+
+  // Returns paths of all entries in the object cache directory.
+  std::vector<std::string> CacheEntries() {
+    std::vector<std::string> entries;
+    TF_CHECK_OK(tsl::Env::Default()->GetMatchingPaths(
+        tsl::io::JoinPath(cache_dir_, "*.pb"), &entries));
+    return entries;
+  }
+
+  // Returns the number of dumped object files in `dump_dir`.
+  int64_t NumDumpedObjFiles(const std::string& dump_dir) {
+    std::vector<std::string> files;
+    TF_CHECK_OK(tsl::Env::Default()->GetMatchingPaths(
+        tsl::io::JoinPath(dump_dir, "*.o"), &files));
+    return files.size();
+  }
+
+  // Compiles and runs the test module, and checks the result.
+  void CompileAndRun(const DebugOptions& debug_options) {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                            ParseModule(debug_options));
+    Literal a = LiteralUtil::CreateR1<float>({0, 0, 0, 0});
+    Literal b = LiteralUtil::CreateR1<float>({1, 2, 3, 4});
+    TF_ASSERT_OK_AND_ASSIGN(Literal result,
+                            Execute(std::move(module), {&a, &b}));
+    EXPECT_TRUE(LiteralTestUtil::Equal(
+        LiteralUtil::CreateR1<float>({2, 3, 4, 5}), result));
+  }
+
+  std::string cache_dir_;
+};
+
+TEST_F(CpuObjectCacheTest, SecondCompilationLoadsFromCache) {
+  std::string dump0 = tsl::io::JoinPath(cache_dir_, "dump0");
+  std::string dump1 = tsl::io::JoinPath(cache_dir_, "dump1");
+
+  DebugOptions debug_options = GetDebugOptionsWithCache();
+  debug_options.set_xla_dump_to(dump0);
+  CompileAndRun(debug_options);
+  ASSERT_EQ(CacheEntries().size(), 1);
+  EXPECT_GT(NumDumpedObjFiles(dump0), 0);
+
+  // Object files are dumped only when LLVM compiles the module, and on a cache
+  // hit the second compilation does not dump anything.
+  debug_options.set_xla_dump_to(dump1);
+  CompileAndRun(debug_options);
+  EXPECT_EQ(CacheEntries().size(), 1);
+  EXPECT_EQ(NumDumpedObjFiles(dump1), 0);
+}
+
+TEST_F(CpuObjectCacheTest, DifferentDebugOptionsUseDifferentEntries) {
+  DebugOptions debug_options = GetDebugOptionsWithCache();
+  CompileAndRun(debug_options);
+  ASSERT_EQ(CacheEntries().size(), 1);
+
+  debug_options.set_xla_cpu_prefer_vector_width(128);
+  CompileAndRun(debug_options);
+  EXPECT_EQ(CacheEntries().size(), 2);
+}
+
+TEST_F(CpuObjectCacheTest, CorruptedEntryFallsBackToCompilation) {
+  DebugOptions debug_options = GetDebugOptionsWithCache();
+  CompileAndRun(debug_options);
+  std::vector<std::string> entries = CacheEntries();
+  ASSERT_EQ(entries.size(), 1);
+
+  // Truncate the cache entry.
+  std::string serialized;
+  TF_ASSERT_OK(
+      tsl::ReadFileToString(tsl::Env::Default(), entries[0], &serialized));
+  TF_ASSERT_OK(tsl::WriteStringToFile(
+      tsl::Env::Default(), entries[0],
+      absl::string_view(serialized).substr(0, serialized.size() / 2)));
+
+  // Compilation ignores the corrupted entry, compiles the module and
+  // overwrites the entry with a valid one.
+  std::string dump = tsl::io::JoinPath(cache_dir_, "dump");
+  debug_options.set_xla_dump_to(dump);
+  CompileAndRun(debug_options);
+  EXPECT_GT(NumDumpedObjFiles(dump), 0);
+
+  std::string restored;
+  TF_ASSERT_OK(
+      tsl::ReadFileToString(tsl::Env::Default(), entries[0], &restored));
+  EXPECT_EQ(restored, serialized);
+}
+
+}  // namespace
+}  // namespace xla::cpu
@@ -0,0 +1,139 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/literal.h"
+#include "xla/service/cpu/cpu_executable.h"
+#include "xla/service/executable.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/tests/hlo_test_base.h"
+#include "xla/tests/literal_test_util.h"
+#include "xla/tests/test_utils.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::cpu {
+namespace {
+
+// A module with a few independent computations, so that the LLVM module has
+// enough functions to be split into multiple parts.
+constexpr absl::string_view kHlo = R"(
+HloModule m
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  ROOT lt = pred[] compare(p0, p1), direction=LT
+}
+
+ENTRY e {
+  a = f32[64,64] parameter(0)
+  b = f32[64,64] parameter(1)
+  exp = f32[64,64] exponential(a)
+  mul = f32[64,64] multiply(exp, b)
+  dot = f32[64,64] dot(mul, b), lhs_contracting_dims={1},
+                                rhs_contracting_dims={0}
+  zero = f32[] constant(0)
+  reduce = f32[64] reduce(dot, zero), dimensions={1}, to_apply=add
+  sort = f32[64,64] sort(a), dimensions={1}, to_apply=compare
+  tanh = f32[64,64] tanh(sort)
+  ROOT tuple = (f32[64], f32[64,64]) tuple(reduce, tanh)
+})";
+
+class CpuParallelCodegenTest : public HloTestBase,
+                               public ::testing::WithParamInterface<bool> {
+ protected:
+  absl::StatusOr<std::unique_ptr<HloModule>> ParseModule(int32_t split_count) {
+    HloModuleConfig config = GetModuleConfigForTest();
+    DebugOptions debug_options = GetDebugOptionsForTest();
+    debug_options.set_xla_cpu_use_thunk_runtime(GetParam());
+    debug_options.set_xla_cpu_parallel_codegen_split_count(split_count);
+    config.set_debug_options(debug_options);
+    return ParseAndReturnVerifiedModule(kHlo, config);
+  }
+
+  // Compiles the module with the given split count and returns the object
+  // files of the compiled executable.
+  absl::StatusOr<std::vector<std::string>> CompileToObjFiles(
+      int32_t split_count) {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                        ParseModule(split_count));
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<Executable> executable,
+                        CreateExecutable(std::move(module),
+                                         /*run_hlo_passes=*/true));
+    auto* cpu_executable = static_cast<CpuExecutable*>(executable.get());
+    return std::vector<std::string>(cpu_executable->obj_files().begin(),
+                                    cpu_executable->obj_files().end());
+  }
+};
+
+TEST_P(CpuParallelCodegenTest, DisabledByDefault) {
+  EXPECT_LE(GetDebugOptionsForTest().xla_cpu_parallel_codegen_split_count(), 1);
+}
+
+TEST_P(CpuParallelCodegenTest, SplitAndUnsplitModulesComputeSameResults) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> unsplit, ParseModule(1));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> split, ParseModule(4));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<Literal> args,
+                          MakeFakeArguments(unsplit.get()));
+  std::vector<Literal*> arg_ptrs = {&args[0], &args[1]};
+
+  TF_ASSERT_OK_AND_ASSIGN(Literal expected,
+                          Execute(std::move(unsplit), arg_ptrs));
+  TF_ASSERT_OK_AND_ASSIGN(Literal result, Execute(std::move(split), arg_ptrs));
+
+  // Module parts contain the same functions as the unsplit module, and results
+  // must be bitwise identical.
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+}
+
+TEST_P(CpuParallelCodegenTest, ObjFilesAreOrderedByModulePart) {
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<std::string> obj_files0,
+                          CompileToObjFiles(4));
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<std::string> obj_files1,
+                          CompileToObjFiles(4));
+
+  // Parts are compiled concurrently, but object files must be reported in the
+  // order of module parts regardless of which part finished compiling first.
+  ASSERT_GE(obj_files0.size(), 1);
+  ASSERT_LE(obj_files0.size(), 4);
+  EXPECT_EQ(obj_files0, obj_files1);
+}
+
+INSTANTIATE_TEST_SUITE_P(CpuParallelCodegen, CpuParallelCodegenTest,
+                         ::testing::Bool(),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                           return info.param ? "ThunkRuntime"
+                                             : "LegacyRuntime";
+                         });
+
+}  // namespace
+}  // namespace xla::cpu
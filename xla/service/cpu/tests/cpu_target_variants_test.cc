@@ -0,0 +1,75 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "xla/service/cpu/cpu_compiler.h"
+#include "xla/service/cpu/tests/cpu_codegen_test.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+using CpuTargetVariantsTest = CpuCodegenTest;
+
+TEST_F(CpuTargetVariantsTest, EntryPointDispatchesToTargetVariants) {
+  const std::string hlo_text = R"(
+HloModule TargetVariants
+
+ENTRY main {
+  a = f32[1024] parameter(0)
+  b = f32[1024] parameter(1)
+  ROOT add = f32[1024] add(a, b)
+}
+)";
+
+  std::string filecheck_pattern = R"(
+CHECK: @entry.selected_variant = internal global i32 -1
+CHECK: define internal void @entry.base(
+CHECK: define internal void @entry.variant.0({{.*}} #[[AVX512:[0-9]+]]
+CHECK: define internal void @entry.variant.1({{.*}} #[[AVX2:[0-9]+]]
+CHECK: define void @entry(
+CHECK: load atomic i32, ptr @entry.selected_variant monotonic
+CHECK: call i32 @__xla_cpu_runtime_HostSupportsTargetFeatures
+CHECK: call i32 @__xla_cpu_runtime_HostSupportsTargetFeatures
+CHECK: store atomic i32 {{.*}}, ptr @entry.selected_variant monotonic
+CHECK: switch i32
+CHECK-DAG: tail call void @entry.variant.0(
+CHECK-DAG: tail call void @entry.variant.1(
+CHECK-DAG: tail call void @entry.base(
+CHECK-DAG: attributes #[[AVX512]] = {{.*}}"target-cpu"="skylake-avx512"{{.*}}"target-features"="+avx512f,+avx512bw"
+CHECK-DAG: attributes #[[AVX2]] = {{.*}}"target-cpu"="haswell"{{.*}}"target-features"="+avx2,+fma"
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo_text));
+
+  CpuAotCompilationOptions options{
+      /*triple=*/"x86_64-pc-linux", /*cpu_name=*/"x86-64",
+      /*features=*/"",
+      /*entry_point_name=*/"entry",
+      /*relocation_model=*/CpuAotCompilationOptions::RelocationModel::Static};
+  options.set_target_variants({{"skylake-avx512", "+avx512f,+avx512bw"},
+                               {"haswell", "+avx2,+fma"}});
+
+  CompileAheadOfTimeAndVerifyIr(std::move(module), options, filecheck_pattern,
+                                /*match_optimized_ir=*/false);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/cpu/thunk_emitter.h"
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <utility>
@@ -24,6 +25,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
+#include "xla/comparison_util.h"
 #include "xla/cpu_function_runtime.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -32,16 +34,22 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/ir/hlo_schedule.h"
+#include "xla/layout_util.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/collective_ops_utils.h"
 #include "xla/service/cpu/dot_op_emitter.h"
+#include "xla/service/cpu/ir_emission_utils.h"
 #include "xla/service/cpu/ir_emitter2.h"
 #include "xla/service/cpu/runtime/all_gather_thunk.h"
 #include "xla/service/cpu/runtime/all_reduce_thunk.h"
+#include "xla/service/cpu/runtime/all_to_all_thunk.h"
 #include "xla/service/cpu/runtime/call_thunk.h"
+#include "xla/service/cpu/runtime/collective_permute_thunk.h"
 #include "xla/service/cpu/runtime/collective_thunk.h"
 #include "xla/service/cpu/runtime/conditional_thunk.h"
+#include "xla/service/cpu/runtime/convolution_thunk.h"
 #include "xla/service/cpu/runtime/copy_thunk.h"
+#include "xla/service/cpu/runtime/custom_call_thunk.h"
 #include "xla/service/cpu/runtime/dot_thunk.h"
 #include "xla/service/cpu/runtime/fft_thunk.h"
 #include "xla/service/cpu/runtime/infeed_thunk.h"
@@ -50,6 +58,8 @@ limitations under the License.
 #include "xla/service/cpu/runtime/reduce_scatter_thunk.h"
 #include "xla/service/cpu/runtime/replica_id_thunk.h"
 #include "xla/service/cpu/runtime/rng_state_thunk.h"
+#include "xla/service/cpu/runtime/sort_thunk.h"
+#include "xla/service/cpu/runtime/topk_thunk.h"
 #include "xla/service/cpu/runtime/thunk.h"
 #include "xla/service/cpu/runtime/while_thunk.h"
 #include "xla/service/cpu/target_machine_features.h"
@@ -58,6 +68,8 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/util.h"
+#include "xla/xla.pb.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/statusor.h"
@@ -212,6 +224,10 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitHloInstruction(
       return EmitAllGatherThunk(instruction);
     case HloOpcode::kAllReduce:
       return EmitAllReduceThunk(instruction);
+    case HloOpcode::kAllToAll:
+      return EmitAllToAllThunk(instruction);
+    case HloOpcode::kCollectivePermute:
+      return EmitCollectivePermuteThunk(instruction);
     case HloOpcode::kReduceScatter:
       return EmitReduceScatterThunk(instruction);
 
@@ -249,12 +265,21 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitHloInstruction(
     case HloOpcode::kCopy:
       return EmitCopyThunk(instruction);
 
+    case HloOpcode::kConvolution:
+      return EmitConvolutionThunk(instruction);
+
+    case HloOpcode::kCustomCall:
+      return EmitCustomCallThunk(instruction);
+
     case HloOpcode::kDot:
       return EmitDotThunk(instruction);
 
     case HloOpcode::kFft:
       return EmitFftThunk(instruction);
 
+    case HloOpcode::kSort:
+      return EmitSortThunk(instruction);
+
     default:
       return absl::UnimplementedError(
           absl::StrCat("HLO opcode `", HloOpcodeString(instruction->opcode()),
@@ -348,6 +373,57 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitAllReduceThunk(
       std::move(op_buffers), single_replica);
 }
 
+absl::StatusOr<ThunkSequence> ThunkEmitter::EmitAllToAllThunk(
+    const HloInstruction* instruction) {
+  auto* all_to_all = Cast<HloAllToAllInstruction>(instruction);
+
+  // Similar to IrEmitter we support only the tuple form of all-to-all.
+  if (all_to_all->split_dimension().has_value() ||
+      !all_to_all->shape().IsTuple()) {
+    return Unimplemented("Only tuple AllToAll is supported: %s",
+                         all_to_all->ToString());
+  }
+
+  AllToAllThunk::OpParams op_params = {
+      /*op_id=*/all_to_all->channel_id().has_value()
+          ? all_to_all->channel_id().value()
+          : all_to_all->GetModule()->unique_id(),
+      /*has_channel_id=*/all_to_all->channel_id().has_value(),
+      /*use_global_device_ids=*/std::nullopt,
+      /*group=*/all_to_all->replica_groups(),
+  };
+
+  TF_ASSIGN_OR_RETURN(AllToAllThunk::OpBuffers op_buffers,
+                      GetCollectiveOpBuffers(all_to_all, buffer_assignment_));
+
+  return ThunkSequence::Of<AllToAllThunk>(
+      ThunkInfo(all_to_all), std::move(op_params), std::move(op_buffers));
+}
+
+absl::StatusOr<ThunkSequence> ThunkEmitter::EmitCollectivePermuteThunk(
+    const HloInstruction* instruction) {
+  auto* collective_permute = Cast<HloCollectivePermuteInstruction>(instruction);
+
+  // Collective permute participants are defined by source-target pairs, and
+  // the rendezvous includes all devices in the collective op group mode.
+  CollectivePermuteThunk::OpParams op_params = {
+      /*op_id=*/collective_permute->channel_id().has_value()
+          ? collective_permute->channel_id().value()
+          : collective_permute->GetModule()->unique_id(),
+      /*has_channel_id=*/collective_permute->channel_id().has_value(),
+      /*use_global_device_ids=*/std::nullopt,
+      /*group=*/{},
+  };
+
+  TF_ASSIGN_OR_RETURN(
+      CollectivePermuteThunk::OpBuffers op_buffers,
+      GetCollectiveOpBuffers(collective_permute, buffer_assignment_));
+
+  return ThunkSequence::Of<CollectivePermuteThunk>(
+      ThunkInfo(collective_permute), std::move(op_params),
+      std::move(op_buffers), collective_permute->source_target_pairs());
+}
+
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitReduceScatterThunk(
     const HloInstruction* instruction) {
   auto* reduce_scatter = Cast<HloReduceScatterInstruction>(instruction);
@@ -501,9 +577,19 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitWhileThunk(
   TF_ASSIGN_OR_RETURN(ThunkSequence body_thunk,
                       EmitHloComputation(instruction->while_body()));
 
+  // Check if while loop has a statically known trip count.
+  TF_ASSIGN_OR_RETURN(
+      auto loop_config,
+      instruction->backend_config<xla::WhileLoopBackendConfig>());
+
+  std::optional<int64_t> trip_count;
+  if (loop_config.has_known_trip_count()) {
+    trip_count = loop_config.known_trip_count().n();
+  }
+
   return ThunkSequence::Of<WhileThunk>(ThunkInfo(instruction), cond_buffer,
                                        std::move(cond_thunk),
-                                       std::move(body_thunk));
+                                       std::move(body_thunk), trip_count);
 }
 
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitDotThunk(
@@ -511,10 +597,13 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitDotThunk(
   const HloInstruction* lhs = instruction->operand(0);
   const HloInstruction* rhs = instruction->operand(1);
 
+  // BF16 operands are only left by FloatNormalization for dots with an F32
+  // result (see DotSupportsLowPrecisionOperands).
   TF_RETURN_IF_ERROR(ElementTypesSameAndSupported(
       *instruction, /*operands=*/{lhs, rhs},
       /*supported_types=*/
-      {PRED, S8, U8, S16, U16, S32, U32, S64, U64, F16, F32, F64, C64, C128}));
+      {PRED, S8, U8, S16, U16, S32, U32, S64, U64, F16, BF16, F32, F64, C64,
+       C128}));
 
   const DotDimensionNumbers& dnums = instruction->dot_dimension_numbers();
   if (dnums.lhs_contracting_dimensions_size() != 1) {
@@ -556,6 +645,132 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitDotThunk(
   }
 }
 
+absl::StatusOr<ThunkSequence> ThunkEmitter::EmitConvolutionThunk(
+    const HloInstruction* instruction) {
+  const HloInstruction* input = instruction->operand(0);
+  const HloInstruction* kernel = instruction->operand(1);
+
+  // Convolution thunk supports only convolutions that can be implemented with
+  // Eigen kernels, and we emit all other convolutions as elemental kernels.
+  bool is_eigen_convolution =
+      PotentiallyImplementedAsEigenConvolution(*instruction,
+                                               target_machine_features_) &&
+      LayoutUtil::IsMonotonicWithDim0Major(input->shape().layout()) &&
+      LayoutUtil::IsMonotonicWithDim0Major(kernel->shape().layout()) &&
+      LayoutUtil::IsMonotonicWithDim0Major(instruction->shape().layout()) &&
+      instruction->shape().element_type() == input->shape().element_type() &&
+      kernel->shape().element_type() == input->shape().element_type();
+
+  if (!is_eigen_convolution) {
+    return EmitElementalKernelThunk(instruction);
+  }
+
+  TF_ASSIGN_OR_RETURN(BufferAllocation::Slice input_slice,
+                      GetAllocationSlice(input));
+  TF_ASSIGN_OR_RETURN(BufferAllocation::Slice kernel_slice,
+                      GetAllocationSlice(kernel));
+  TF_ASSIGN_OR_RETURN(BufferAllocation::Slice output_slice,
+                      GetAllocationSlice(instruction));
+
+  const DebugOptions& debug_options = hlo_module_config_.debug_options();
+
+  ConvolutionThunk::Options options;
+  options.multi_threaded = debug_options.xla_cpu_multi_thread_eigen();
+  options.use_mkl_dnn = debug_options.xla_cpu_use_mkl_dnn();
+
+  return ThunkSequence::Of<ConvolutionThunk>(
+      ThunkInfo(instruction), options, input_slice, input->shape(),
+      kernel_slice, kernel->shape(), output_slice, instruction->shape(),
+      instruction->convolution_dimension_numbers(), instruction->window(),
+      instruction->feature_group_count());
+}
+
+absl::StatusOr<ThunkSequence> ThunkEmitter::EmitCustomCallThunk(
+    const HloInstruction* instruction) {
+  auto* custom_call = Cast<HloCustomCallInstruction>(instruction);
+
+  // TopK custom calls are produced by the TopkRewriter and implemented by a
+  // dedicated thunk.
+  if (custom_call->custom_call_target() == "TopK") {
+    return EmitTopKThunk(custom_call);
+  }
+
+  CustomCallThunk::OpBuffers op_buffers;
+
+  for (const HloInstruction* operand : custom_call->operands()) {
+    if (!operand->shape().IsArray()) {
+      return Unimplemented(
+          "Custom call %s with non-array operands is not supported by "
+          "XLA:CPU ThunkEmitter",
+          custom_call->custom_call_target());
+    }
+    TF_ASSIGN_OR_RETURN(BufferAllocation::Slice slice,
+                        GetAllocationSlice(operand));
+    op_buffers.arguments_buffers.push_back(slice);
+    op_buffers.arguments_shapes.push_back(operand->shape());
+  }
+
+  // We do not materialize tuples at run time, and pass a flattened list of
+  // result buffers to the custom call thunk.
+  const Shape& shape = custom_call->shape();
+  op_buffers.is_tuple_result = shape.IsTuple();
+
+  if (shape.IsTuple()) {
+    for (int64_t i = 0; i < ShapeUtil::TupleElementCount(shape); ++i) {
+      const Shape& elem_shape = ShapeUtil::GetTupleElementShape(shape, i);
+      if (!elem_shape.IsArray()) {
+        return Unimplemented(
+            "Custom call %s with nested tuple results is not supported by "
+            "XLA:CPU ThunkEmitter",
+            custom_call->custom_call_target());
+      }
+      TF_ASSIGN_OR_RETURN(BufferAllocation::Slice slice,
+                          GetAllocationSlice(custom_call, {i}));
+      op_buffers.results_buffers.push_back(slice);
+      op_buffers.results_shapes.push_back(elem_shape);
+    }
+  } else {
+    TF_ASSIGN_OR_RETURN(BufferAllocation::Slice slice,
+                        GetAllocationSlice(custom_call));
+    op_buffers.results_buffers.push_back(slice);
+    op_buffers.results_shapes.push_back(shape);
+  }
+
+  return ThunkSequence::Of<CustomCallThunk>(
+      ThunkInfo(instruction), custom_call->custom_call_target(),
+      std::move(op_buffers), custom_call->opaque(),
+      custom_call->api_version());
+}
+
+absl::StatusOr<ThunkSequence> ThunkEmitter::EmitTopKThunk(
+    const HloCustomCallInstruction* custom_call) {
+  const HloInstruction* values = custom_call->operand(0);
+  const Shape& output_shape = custom_call->shape().tuple_shapes(0);
+  const Shape& indices_shape = custom_call->shape().tuple_shapes(1);
+
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(values->shape().layout()))
+      << custom_call->ToString();
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(output_shape.layout()))
+      << custom_call->ToString();
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(indices_shape.layout()))
+      << custom_call->ToString();
+
+  TF_ASSIGN_OR_RETURN(BufferAllocation::Slice values_slice,
+                      GetAllocationSlice(values));
+  TF_ASSIGN_OR_RETURN(BufferAllocation::Slice output_slice,
+                      GetAllocationSlice(custom_call, {0}));
+  TF_ASSIGN_OR_RETURN(BufferAllocation::Slice indices_slice,
+                      GetAllocationSlice(custom_call, {1}));
+
+  bool has_batch = values->shape().rank() == 2;
+  return ThunkSequence::Of<TopKThunk>(
+      ThunkInfo(custom_call), values->shape().element_type(), values_slice,
+      output_slice, indices_slice,
+      /*batch_size=*/has_batch ? values->shape().dimensions(0) : 1,
+      /*input_size=*/values->shape().dimensions().back(),
+      /*k=*/output_shape.dimensions().back());
+}
+
 absl::StatusOr<ThunkSequence> ThunkEmitter::EmitReplicaIdThunk(
     const HloInstruction* instruction) {
   TF_ASSIGN_OR_RETURN(BufferAllocation::Slice replica_id_buffer,
@@ -585,6 +800,84 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitFftThunk(
       /*output_shape=*/instruction->shape());
 }
 
+// Returns sort direction if `comparator` is a default comparator that compares
+// keys (first operand of the sort instruction) with `LT` or `GT` direction.
+static std::optional<SortThunk::SortDirection> MatchSortDirection(
+    const HloComputation* comparator) {
+  const HloInstruction* root = comparator->root_instruction();
+  if (root->opcode() != HloOpcode::kCompare) return std::nullopt;
+
+  auto is_parameter = [](const HloInstruction* instr, int64_t number) {
+    return instr->opcode() == HloOpcode::kParameter &&
+           instr->parameter_number() == number;
+  };
+
+  auto* compare = Cast<HloCompareInstruction>(root);
+  bool is_natural = is_parameter(compare->operand(0), 0) &&
+                    is_parameter(compare->operand(1), 1);
+  bool is_swapped = is_parameter(compare->operand(0), 1) &&
+                    is_parameter(compare->operand(1), 0);
+  if (!is_natural && !is_swapped) return std::nullopt;
+
+  switch (compare->direction()) {
+    case ComparisonDirection::kLt:
+      return is_natural ? SortThunk::SortDirection::kAscending
+                        : SortThunk::SortDirection::kDescending;
+    case ComparisonDirection::kGt:
+      return is_natural ? SortThunk::SortDirection::kDescending
+                        : SortThunk::SortDirection::kAscending;
+    default:
+      return std::nullopt;
+  }
+}
+
+absl::StatusOr<ThunkSequence> ThunkEmitter::EmitSortThunk(
+    const HloInstruction* instruction) {
+  auto* sort = Cast<HloSortInstruction>(instruction);
+
+  std::optional<SortThunk::SortDirection> direction =
+      MatchSortDirection(sort->to_apply());
+  if (!direction.has_value()) {
+    return Unimplemented(
+        "Sort comparator is not supported by XLA:CPU ThunkEmitter: %s",
+        sort->to_apply()->ToString());
+  }
+
+  ThunkSequence thunks;
+  std::vector<SortThunk::Input> inputs;
+
+  // Sort is implemented in-place, therefore we first copy operands to the
+  // result buffers if they are not the same.
+  for (int64_t i = 0; i < sort->operand_count(); ++i) {
+    const HloInstruction* operand = sort->operand(i);
+    ShapeIndex shape_index =
+        sort->values_count() > 0 ? ShapeIndex({i}) : ShapeIndex({});
+
+    TF_ASSIGN_OR_RETURN(BufferAllocation::Slice source_buffer,
+                        GetAllocationSlice(operand));
+    TF_ASSIGN_OR_RETURN(BufferAllocation::Slice destination_buffer,
+                        GetAllocationSlice(sort, shape_index));
+
+    if (source_buffer != destination_buffer) {
+      TF_ASSIGN_OR_RETURN(
+          thunks.emplace_back(),
+          CopyThunk::Create(ThunkInfo(sort), source_buffer, operand->shape(),
+                            destination_buffer, operand->shape()));
+    }
+
+    inputs.push_back({destination_buffer, operand->shape()});
+  }
+
+  auto* compare =
+      Cast<HloCompareInstruction>(sort->to_apply()->root_instruction());
+  TF_ASSIGN_OR_RETURN(
+      thunks.emplace_back(),
+      SortThunk::Create(ThunkInfo(sort), inputs, sort->sort_dimension(),
+                        sort->is_stable(), *direction, compare->order()));
+
+  return thunks;
+}
+
 absl::StatusOr<ThunkEmitter::HostKernelAllocationSlices>
 ThunkEmitter::GetHostKernelAllocationSlices(const HloInstruction* instruction) {
   HostKernelAllocationSlices slices;
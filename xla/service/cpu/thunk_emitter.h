@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/cpu/ir_emitter2.h"
@@ -104,15 +105,33 @@ class ThunkEmitter {
 
   absl::StatusOr<ThunkSequence> EmitDotThunk(const HloInstruction* instruction);
 
+  absl::StatusOr<ThunkSequence> EmitConvolutionThunk(
+      const HloInstruction* instruction);
+
+  absl::StatusOr<ThunkSequence> EmitCustomCallThunk(
+      const HloInstruction* instruction);
+
+  absl::StatusOr<ThunkSequence> EmitTopKThunk(
+      const HloCustomCallInstruction* custom_call);
+
   absl::StatusOr<ThunkSequence> EmitReplicaIdThunk(
       const HloInstruction* instruction);
 
+  absl::StatusOr<ThunkSequence> EmitSortThunk(
+      const HloInstruction* instruction);
+
   absl::StatusOr<ThunkSequence> EmitAllGatherThunk(
       const HloInstruction* instruction);
 
   absl::StatusOr<ThunkSequence> EmitAllReduceThunk(
       const HloInstruction* instruction);
 
+  absl::StatusOr<ThunkSequence> EmitAllToAllThunk(
+      const HloInstruction* instruction);
+
+  absl::StatusOr<ThunkSequence> EmitCollectivePermuteThunk(
+      const HloInstruction* instruction);
+
   absl::StatusOr<ThunkSequence> EmitReduceScatterThunk(
       const HloInstruction* instruction);
 
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "xla/service/cpu/tiled_dot_emitter.h"
 
+#include <utility>
+
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/cpu/vector_support_library.h"
 #include "xla/service/llvm_ir/kernel_support_library.h"
@@ -678,8 +680,9 @@ class TiledSmallGemmEmitter {
     std::string GetCacheKey() const {
       return absl::StrCat("gemm_", PrimitiveType_Name(scalar_type()), "_",
                           dims().ToString(), "_", max_vectorization_width(),
-                          "_", min_vectorization_width(), "_", tile_size_m(),
-                          "_", tile_size_k());
+                          "_", max_vector_count(), "_",
+                          min_vectorization_width(), "_", tile_size_m(), "_",
+                          tile_size_k());
     }
 
     PrimitiveType scalar_type() const { return scalar_type_; }
@@ -702,14 +705,17 @@ class TiledSmallGemmEmitter {
   };
 
   // Creates an instance of TiledSmallGemmEmitter that matrix-multiplies
-  // `lhs` with `rhs` and stores the result in `result`.
+  // `lhs` with `rhs` and stores the result in `result`. If `epilogue` is not
+  // null, it is called for every fully computed tile of the result.
   explicit TiledSmallGemmEmitter(Config config, llvm::Value* lhs,
                                  llvm::Value* rhs, llvm::Value* result,
-                                 llvm::IRBuilder<>* b)
+                                 llvm::IRBuilder<>* b,
+                                 GemmTileEpilogue epilogue = nullptr)
       : lhs_(lhs),
         rhs_(rhs),
         result_(result),
         config_(config),
+        epilogue_(std::move(epilogue)),
         b_(b),
         ksl_(b_) {
     CHECK(
@@ -736,15 +742,17 @@ class TiledSmallGemmEmitter {
                          llvm::Value* n_end);
   void HandleResiduesOnM(VectorSupportLibrary* vsl, int64_t tile_size_k,
                          llvm::Value* k_start, llvm::Value* k_end,
-                         llvm::Value* n_start, llvm::Value* n_end);
+                         llvm::Value* n_start, llvm::Value* n_end,
+                         bool is_last_k_tile);
 
   // This emits a tiled GEMM kernel.  For a detailed description see the comment
-  // on the implementation.
+  // on the implementation. If `is_last_k_tile` is true, the emitted kernel
+  // computes the final value of the result tiles and runs the epilogue.
   void EmitTiledGemm(VectorSupportLibrary* vsl, int64_t tile_size_k,
                      llvm::Value* k_start, llvm::Value* k_end,
                      llvm::Value* n_start, llvm::Value* n_end,
                      int64_t tile_size_m, llvm::Value* m_start,
-                     llvm::Value* m_end);
+                     llvm::Value* m_end, bool is_last_k_tile);
 
   llvm::Value* GetInt64(int64_t value) { return b_->getInt64(value); }
 
@@ -766,6 +774,7 @@ class TiledSmallGemmEmitter {
   llvm::Value* rhs_;
   llvm::Value* result_;
   Config config_;
+  GemmTileEpilogue epilogue_;
 
   llvm::IRBuilder<>* b_;
   KernelSupportLibrary ksl_;
@@ -819,26 +828,29 @@ void TiledSmallGemmEmitter::HandleResiduesOnK(VectorSupportLibrary* vsl,
   int64_t k_end = dims().k() - (dims().k() % tile_size_k());
   if (k_end != k_start) {
     HandleResiduesOnM(vsl, tile_size_k(), GetInt64(k_start), GetInt64(k_end),
-                      n_start, n_end);
+                      n_start, n_end, /*is_last_k_tile=*/k_end == dims().k());
     k_start = k_end;
   }
 
   if (k_start != dims().k()) {
     HandleResiduesOnM(vsl, dims().k() - k_start, GetInt64(k_start),
-                      GetInt64(dims().k()), n_start, n_end);
+                      GetInt64(dims().k()), n_start, n_end,
+                      /*is_last_k_tile=*/true);
   }
 }
 
 void TiledSmallGemmEmitter::HandleResiduesOnM(
     VectorSupportLibrary* vsl, int64_t tile_size_k, llvm::Value* k_start,
-    llvm::Value* k_end, llvm::Value* n_start, llvm::Value* n_end) {
+    llvm::Value* k_end, llvm::Value* n_start, llvm::Value* n_end,
+    bool is_last_k_tile) {
   const int64_t m_end = dims().m() - dims().m() % tile_size_m();
   EmitTiledGemm(vsl, tile_size_k, k_start, k_end, n_start, n_end, tile_size_m(),
-                GetInt64(0), GetInt64(m_end));
+                GetInt64(0), GetInt64(m_end), is_last_k_tile);
 
   if (m_end != dims().m()) {
     EmitTiledGemm(vsl, tile_size_k, k_start, k_end, n_start, n_end,
-                  dims().m() - m_end, GetInt64(m_end), GetInt64(dims().m()));
+                  dims().m() - m_end, GetInt64(m_end), GetInt64(dims().m()),
+                  is_last_k_tile);
   }
 }
 
@@ -915,7 +927,8 @@ void TiledSmallGemmEmitter::HandleResiduesOnM(
 void TiledSmallGemmEmitter::EmitTiledGemm(
     VectorSupportLibrary* vsl, int64_t tile_size_k, llvm::Value* k_start,
     llvm::Value* k_end, llvm::Value* n_start, llvm::Value* n_end,
-    int64_t tile_size_m, llvm::Value* m_start, llvm::Value* m_end) {
+    int64_t tile_size_m, llvm::Value* m_start, llvm::Value* m_end,
+    bool is_last_k_tile) {
   ksl_.For("dot.m", m_start, m_end, tile_size_m, [&](llvm::Value* m_i) {
     MemoryTile result_memory_tile(vsl, b_, /*matrix=*/result_,
                                   /*matrix_size_along_minor_dim=*/dims().n(),
@@ -946,6 +959,10 @@ void TiledSmallGemmEmitter::EmitTiledGemm(
           });
 
           result_memory_tile.StoreTile(result_tile_var.Get(), n_i);
+
+          if (epilogue_ && is_last_k_tile) {
+            epilogue_(m_i, tile_size_m, n_i, vsl->vector_size());
+          }
         });
   });
 }
@@ -998,7 +1015,8 @@ void EmitSmallGemm(PrimitiveType scalar_type, int64_t m, int64_t k, int64_t n,
                    int64_t min_vectorization_width, int64_t tile_size_m,
                    int64_t tile_size_k, llvm::Value* lhs, llvm::Value* rhs,
                    llvm::Value* result, llvm::IRBuilder<>* b,
-                   const HloModuleConfig& module_config) {
+                   const HloModuleConfig& module_config,
+                   GemmTileEpilogue epilogue) {
   TiledSmallGemmEmitter::Config config(
       /*scalar_type=*/scalar_type,
       TiledSmallGemmEmitter::Dimensions{/*m=*/m, /*k=*/k, /*n=*/n},
@@ -1007,6 +1025,14 @@ void EmitSmallGemm(PrimitiveType scalar_type, int64_t m, int64_t k, int64_t n,
       /*min_vectorization_width=*/min_vectorization_width,
       /*tile_size_m=*/tile_size_m, /*tile_size_k=*/tile_size_k);
 
+  if (epilogue) {
+    TiledSmallGemmEmitter small_gemm_emitter(config, /*lhs=*/lhs, /*rhs=*/rhs,
+                                             /*result=*/result, b,
+                                             std::move(epilogue));
+    small_gemm_emitter.Emit();
+    return;
+  }
+
   KernelSupportLibrary::EmitAndCallOutlinedKernel(
       module_config, b, config.GetCacheKey(), lhs, rhs, result,
       [&](llvm::Value* lhs, llvm::Value* rhs, llvm::Value* result) {
@@ -16,7 +16,11 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_TILED_DOT_EMITTER_H_
 #define XLA_SERVICE_CPU_TILED_DOT_EMITTER_H_
 
+#include <cstdint>
+#include <functional>
+
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Value.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/xla_data.pb.h"
 
@@ -38,12 +42,25 @@ void EmitColumnMajorGemv(PrimitiveType scalar_type, int64_t tile_rows,
                          llvm::IRBuilder<>* b,
                          const HloModuleConfig& module_config);
 
+// A callback that emits LLVM IR for the epilogue of a small GEMM. It is called
+// for every fully computed tile of the result matrix with rows
+// [`m_start`, `m_start` + `tile_size_m`) and columns
+// [`n_start`, `n_start` + `tile_size_n`), right after the tile was stored to
+// the result buffer, so that the epilogue reads it from L1.
+using GemmTileEpilogue =
+    std::function<void(llvm::Value* m_start, int64_t tile_size_m,
+                       llvm::Value* n_start, int64_t tile_size_n)>;
+
+// If `epilogue` is not null, the GEMM kernel is emitted inline at the current
+// insert point instead of an outlined (and shared) kernel function, as the
+// epilogue can refer to values defined in the enclosing function.
 void EmitSmallGemm(PrimitiveType scalar_type, int64_t m, int64_t k, int64_t n,
                    int64_t max_vectorization_width, int64_t max_vector_count,
                    int64_t min_vectorization_width, int64_t tile_size_m,
                    int64_t tile_size_k, llvm::Value* lhs, llvm::Value* rhs,
                    llvm::Value* result, llvm::IRBuilder<>* b,
-                   const HloModuleConfig& module_config);
+                   const HloModuleConfig& module_config,
+                   GemmTileEpilogue epilogue = nullptr);
 
 }  // namespace cpu
 }  // namespace xla
@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "xla/service/dump.h"
 
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -57,6 +60,7 @@ limitations under the License.
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/file_system.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/regexp.h"
 #include "tsl/platform/status.h"
@@ -97,6 +101,9 @@ struct CanonicalDebugOptions {
         dump_snapshots(opts.xla_dump_hlo_snapshots()),
         dump_include_timestamp(opts.xla_dump_include_timestamp()),
         dump_max_hlo_modules(opts.xla_dump_max_hlo_modules()),
+        dump_async(opts.xla_dump_async()),
+        dump_max_bytes(opts.xla_dump_max_bytes()),
+        dump_compress_text(opts.xla_dump_compress_text()),
         dump_module_metadata(opts.xla_dump_module_metadata()),
         dump_compress_protos(opts.xla_dump_compress_protos()),
         dump_hlo_metadata(!opts.xla_dump_disable_metadata()),
@@ -156,6 +163,19 @@ struct CanonicalDebugOptions {
       should_dump_module = [](string_view) { return false; };
     }
 
+    // Sample modules by a hash of their name, so that all dumps of a module
+    // are either written or skipped. A rate <= 0 (the proto default) dumps
+    // all modules.
+    if (float rate = opts.xla_dump_module_sample_rate();
+        rate > 0.0 && rate < 1.0) {
+      should_dump_module = [rate, should_dump = std::move(should_dump_module)](
+                               string_view module_name) {
+        constexpr uint64_t kBuckets = 1000000;
+        return should_dump(module_name) &&
+               tsl::Fingerprint64(module_name) % kBuckets < rate * kBuckets;
+      };
+    }
+
     // Initialize should_dump_pass.  This one is easy: We only dump per-pass
     // data if the user asked for it explicitly.
     if (!opts.xla_dump_hlo_pass_re().empty()) {
@@ -214,6 +234,9 @@ struct CanonicalDebugOptions {
   bool dump_snapshots;
   bool dump_include_timestamp;
   int64_t dump_max_hlo_modules;
+  bool dump_async;
+  int64_t dump_max_bytes;
+  bool dump_compress_text;
   bool dump_module_metadata;
   bool dump_compress_protos;
   bool dump_hlo_metadata;
@@ -281,6 +304,8 @@ static absl::Status WriteStringToFile(tsl::Env* env, const std::string& fname,
   return gz_file.Close();
 }
 
+// Returns the path of `filename` in the dump directory, or nullopt if dumps
+// are not written to files.
 static std::optional<std::string> GetDumpFilePath(
     string_view filename, const CanonicalDebugOptions& opts) {
   if (opts.dumping_to_stdout()) {
@@ -293,8 +318,24 @@ static std::optional<std::string> GetDumpFilePath(
     return std::nullopt;
   }
 
-  const std::string& dir = opts.dump_to;
-  VLOG(1) << "Dumping " << filename << " to " << dir;
+  return tsl::io::JoinPath(opts.dump_to,
+                           SanitizeFileName(std::string(filename)));
+}
+
+// A dump file to be written to the dump directory.
+struct DumpFile {
+  std::string dir;
+  std::string filename;
+  std::string path;
+  bool compress;
+  int64_t dump_max_hlo_modules;
+};
+
+// Creates the dump directory if needed and checks that writing `file` doesn't
+// exceed the limit on the number of dumped modules.
+static bool PrepareDumpFile(const DumpFile& file) {
+  const std::string& dir = file.dir;
+  VLOG(1) << "Dumping " << file.filename << " to " << dir;
 
   tsl::Env* env = tsl::Env::Default();
   // Two threads can race to observe the absence of the dump directory and
@@ -306,12 +347,12 @@ static std::optional<std::string> GetDumpFilePath(
     if (!status.ok() && !env->IsDirectory(dir).ok()) {
       LOG(ERROR) << "Could not create directory " << dir
                  << " for dumping XLA debug data: " << status;
-      return std::nullopt;
+      return false;
     }
   }
 
   // Make sure we are not going to dump more modules than the user has asked.
-  if (opts.dump_max_hlo_modules > 0) {
+  if (file.dump_max_hlo_modules > 0) {
     std::vector<std::string> matches;
     auto pattern = tsl::io::JoinPath(dir, "*module_*.*");
     auto status = env->GetMatchingPaths(pattern, &matches);
@@ -327,53 +368,207 @@ static std::optional<std::string> GetDumpFilePath(
         dumped_module_ids.insert(dumped_module_id);
       }
     }
-    if (dumped_module_ids.size() >= opts.dump_max_hlo_modules) {
+    if (dumped_module_ids.size() >= file.dump_max_hlo_modules) {
       int64_t module_id;
-      if (RE2::FullMatch(filename, *module_id_regex, &module_id) &&
+      if (RE2::FullMatch(file.filename, *module_id_regex, &module_id) &&
           !dumped_module_ids.contains(module_id)) {
         LOG(ERROR) << "Have already dumped " << dumped_module_ids.size()
                    << " modules, more than the limit of "
-                   << opts.dump_max_hlo_modules;
-        return std::nullopt;
+                   << file.dump_max_hlo_modules;
+        return false;
       }
     }
   }
+  return true;
+}
 
-  return tsl::io::JoinPath(dir, SanitizeFileName(std::string(filename)));
+static bool WriteDumpFile(const DumpFile& file, absl::string_view contents) {
+  if (!PrepareDumpFile(file)) return false;
+  auto status = WriteStringToFile(tsl::Env::Default(), file.path, contents,
+                                  file.compress);
+  if (!status.ok()) {
+    LOG(ERROR) << "Could not write XLA debug data to " << file.path << ": "
+               << status;
+    return false;
+  }
+  return true;
 }
 
-static std::optional<std::string> DumpToFileInDirImpl(
-    string_view filename, string_view contents,
-    const CanonicalDebugOptions& opts, bool compress = false) {
+static bool WriteDumpFile(const DumpFile& file, DataProducer& data_producer) {
+  if (!PrepareDumpFile(file)) return false;
+  auto status = WriteStringToFile(tsl::Env::Default(), file.path,
+                                  data_producer, file.compress);
+  if (!status.ok()) {
+    LOG(ERROR) << "Could not write XLA debug data to " << file.path << ": "
+               << status;
+    return false;
+  }
+  return true;
+}
+
+// Number of bytes dumped to files by this process.
+static std::atomic<int64_t> dumped_bytes{0};
+
+// Accounts `size` bytes against --xla_dump_max_bytes. Returns false if the
+// dump doesn't fit into the budget.
+static bool ReserveDumpBytes(string_view filename, int64_t size,
+                             const CanonicalDebugOptions& opts) {
+  if (opts.dump_max_bytes <= 0) {
+    dumped_bytes.fetch_add(size, std::memory_order_relaxed);
+    return true;
+  }
+  int64_t current = dumped_bytes.load(std::memory_order_relaxed);
+  do {
+    if (current + size > opts.dump_max_bytes) {
+      LOG_FIRST_N(ERROR, 1)
+          << "Not dumping " << filename << " and further XLA debug data, as "
+          << current << " bytes were already dumped and the limit is "
+          << opts.dump_max_bytes << " bytes (--xla_dump_max_bytes)";
+      return false;
+    }
+  } while (!dumped_bytes.compare_exchange_weak(current, current + size,
+                                               std::memory_order_relaxed));
+  return true;
+}
+
+// Returns `size` bytes reserved by ReserveDumpBytes for a dump that was not
+// written.
+static void ReleaseDumpBytes(int64_t size) {
+  dumped_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// Writes dump files on a background thread (--xla_dump_async), so that
+// compilation doesn't wait for the file system and for compression. Memory
+// used by queued dumps is bounded, and dumps that don't fit are dropped.
+class AsyncDumpWriter {
+ public:
+  static AsyncDumpWriter& Get() {
+    static auto* writer = new AsyncDumpWriter();
+    return *writer;
+  }
+
+  // Returns false if the dump was dropped.
+  bool Enqueue(DumpFile file, std::string contents) {
+    absl::MutexLock lock(&mu_);
+    if (queued_bytes_ + contents.size() > kMaxQueuedBytes) {
+      LOG(WARNING) << "Dropping XLA debug data " << file.path << " ("
+                   << contents.size() << " bytes), as the dump queue is full";
+      return false;
+    }
+    queued_bytes_ += contents.size();
+    queue_.push_back({std::move(file), std::move(contents)});
+    return true;
+  }
+
+  // Blocks until all queued dumps are written.
+  void Flush() {
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(this, &AsyncDumpWriter::IsIdle));
+  }
+
+ private:
+  static constexpr int64_t kMaxQueuedBytes = 1024 * 1024 * 1024;
+
+  AsyncDumpWriter() {
+    thread_.reset(tsl::Env::Default()->StartThread(
+        tsl::ThreadOptions(), "xla_dump_writer", [this] { Run(); }));
+    // Don't lose queued dumps when the process exits normally.
+    std::atexit([] { AsyncDumpWriter::Get().Flush(); });
+  }
+
+  void Run() {
+    while (true) {
+      std::pair<DumpFile, std::string> next;
+      {
+        absl::MutexLock lock(&mu_);
+        mu_.Await(absl::Condition(this, &AsyncDumpWriter::HasQueuedDumps));
+        next = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+      }
+      if (!WriteDumpFile(next.first, next.second)) {
+        ReleaseDumpBytes(next.second.size());
+      }
+      absl::MutexLock lock(&mu_);
+      queued_bytes_ -= next.second.size();
+      busy_ = false;
+    }
+  }
+
+  bool IsIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return queue_.empty() && !busy_;
+  }
+  bool HasQueuedDumps() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return !queue_.empty();
+  }
+
+  absl::Mutex mu_;
+  std::deque<std::pair<DumpFile, std::string>> queue_ ABSL_GUARDED_BY(mu_);
+  int64_t queued_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  bool busy_ ABSL_GUARDED_BY(mu_) = false;
+  std::unique_ptr<tsl::Thread> thread_;
+};
+
+// Returns the dump file for `filename`, or nullopt if dumps are not written to
+// files. Text files are compressed if requested by --xla_dump_compress_text.
+static std::optional<DumpFile> GetDumpFile(string_view filename,
+                                           const CanonicalDebugOptions& opts,
+                                           bool compress) {
   auto file_path = GetDumpFilePath(filename, opts);
   if (!file_path) return std::nullopt;
 
-  auto status =
-      WriteStringToFile(tsl::Env::Default(), *file_path, contents, compress);
-  if (!status.ok()) {
-    LOG(ERROR) << "Could not write XLA debug data to " << *file_path << ": "
-               << status;
-    return std::nullopt;
+  DumpFile file{opts.dump_to, std::string(filename), *std::move(file_path),
+                compress, opts.dump_max_hlo_modules};
+  if (!compress && opts.dump_compress_text &&
+      absl::EndsWith(filename, ".txt")) {
+    file.compress = true;
+    absl::StrAppend(&file.path, ".gz");
   }
+  return file;
+}
 
+static std::optional<std::string> DumpToFileInDirImpl(
+    string_view filename, string_view contents,
+    const CanonicalDebugOptions& opts, bool compress = false) {
+  auto file = GetDumpFile(filename, opts, compress);
+  if (!file) return std::nullopt;
+  if (!ReserveDumpBytes(filename, contents.size(), opts)) return std::nullopt;
+
+  // Dumps that are dropped or fail to be written don't count against the
+  // budget.
+  std::string file_path = file->path;
+  if (opts.dump_async) {
+    if (!AsyncDumpWriter::Get().Enqueue(*std::move(file),
+                                        std::string(contents))) {
+      ReleaseDumpBytes(contents.size());
+      return std::nullopt;
+    }
+    return file_path;
+  }
+  if (!WriteDumpFile(*file, contents)) {
+    ReleaseDumpBytes(contents.size());
+    return std::nullopt;
+  }
   return file_path;
 }
 
 static std::optional<std::string> DumpToFileInDirImpl(
     string_view filename, DataProducer& data_producer,
     const CanonicalDebugOptions& opts, bool compress = false) {
-  auto file_path = GetDumpFilePath(filename, opts);
-  if (!file_path) return std::nullopt;
-
-  auto status = WriteStringToFile(tsl::Env::Default(), *file_path,
-                                  data_producer, compress);
-  if (!status.ok()) {
-    LOG(ERROR) << "Could not write XLA debug data to " << *file_path << ": "
-               << status;
-    return std::nullopt;
+  // Asynchronous dumps and the dump budget need the contents up front, as
+  // data producers may reference the module that is being dumped.
+  if (opts.dump_async || opts.dump_max_bytes > 0) {
+    std::string contents;
+    while (auto next_producer = data_producer.Next()) {
+      absl::StrAppend(&contents, next_producer());
+    }
+    return DumpToFileInDirImpl(filename, contents, opts, compress);
   }
 
-  return file_path;
+  auto file = GetDumpFile(filename, opts, compress);
+  if (!file) return std::nullopt;
+  if (!WriteDumpFile(*file, data_producer)) return std::nullopt;
+  return file->path;
 }
 
 static absl::Mutex stdout_dump_mutex(absl::kConstInit);
@@ -754,6 +949,8 @@ bool DumpingToStdout(const DebugOptions& opts) {
   return CanonicalDebugOptions(opts).dumping_to_stdout();
 }
 
+void WaitForAsyncDumps() { AsyncDumpWriter::Get().Flush(); }
+
 std::vector<std::string> DumpHloModuleBetweenPassesIfEnabled(
     string_view pipeline_name, string_view before_pass_name,
     string_view after_pass_name, const HloModule& module) {
@@ -169,6 +169,10 @@ inline bool DumpingEnabledForHloModule(const HloModule& module) {
 // writing to two files, but you don't want to print twice.
 bool DumpingToStdout(const DebugOptions& opts);
 
+// Blocks until all files dumped asynchronously (--xla_dump_async) are written.
+// Paths returned by the dump functions refer to such files before they exist.
+void WaitForAsyncDumps();
+
 }  // namespace xla
 
 #endif  // XLA_SERVICE_DUMP_H_
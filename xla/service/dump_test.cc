@@ -85,5 +85,101 @@ TEST(DumpHloIfEnabled, LargeConstantPrinted) {
   EXPECT_TRUE(!absl::StrContains(data, "{...}"));
 }
 
+constexpr char kMultiplyModule[] = R"(
+  HloModule m
+  test {
+    p0 = s32[11] parameter(0)
+    p1 = s32[11] parameter(1)
+    ROOT x = s32[11] multiply(p0, p1)
+  }
+)";
+
+TEST(DumpHloIfEnabled, AsyncDump) {
+  HloModuleConfig config;
+  DebugOptions options = config.debug_options();
+  auto env = tsl::Env::Default();
+  std::string dump_dir;
+  EXPECT_TRUE(env->LocalTempFilename(&dump_dir));
+  options.set_xla_dump_to(dump_dir);
+  options.set_xla_dump_hlo_as_text(true);
+  options.set_xla_dump_async(true);
+  config.set_debug_options(options);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto m, ParseAndReturnUnverifiedModule(kMultiplyModule, config));
+  auto paths = DumpHloModuleIfEnabled(*m, "dump");
+  ASSERT_EQ(paths.size(), 1);
+  WaitForAsyncDumps();
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(env, paths[0], &data));
+  EXPECT_TRUE(absl::StrContains(data, "multiply"));
+}
+
+TEST(DumpHloIfEnabled, SampledOutModuleIsNotDumped) {
+  HloModuleConfig config;
+  DebugOptions options = config.debug_options();
+  std::string dump_dir;
+  EXPECT_TRUE(tsl::Env::Default()->LocalTempFilename(&dump_dir));
+  options.set_xla_dump_to(dump_dir);
+  options.set_xla_dump_hlo_as_text(true);
+  options.set_xla_dump_module_sample_rate(1e-9);
+  config.set_debug_options(options);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto m, ParseAndReturnUnverifiedModule(kMultiplyModule, config));
+  EXPECT_FALSE(DumpingEnabledForHloModule(*m));
+  EXPECT_TRUE(DumpHloModuleIfEnabled(*m, "dump").empty());
+}
+
+TEST(DumpHloIfEnabled, ZeroSampleRateDumpsAllModules) {
+  HloModuleConfig config;
+  DebugOptions options = config.debug_options();
+  std::string dump_dir;
+  EXPECT_TRUE(tsl::Env::Default()->LocalTempFilename(&dump_dir));
+  options.set_xla_dump_to(dump_dir);
+  options.set_xla_dump_hlo_as_text(true);
+  // The proto3 default of an unset sample rate.
+  options.set_xla_dump_module_sample_rate(0.0);
+  config.set_debug_options(options);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto m, ParseAndReturnUnverifiedModule(kMultiplyModule, config));
+  EXPECT_TRUE(DumpingEnabledForHloModule(*m));
+  EXPECT_EQ(DumpHloModuleIfEnabled(*m, "dump").size(), 1);
+}
+
+TEST(DumpHloIfEnabled, DumpOverBudgetIsSkipped) {
+  HloModuleConfig config;
+  DebugOptions options = config.debug_options();
+  std::string dump_dir;
+  EXPECT_TRUE(tsl::Env::Default()->LocalTempFilename(&dump_dir));
+  options.set_xla_dump_to(dump_dir);
+  options.set_xla_dump_hlo_as_text(true);
+  options.set_xla_dump_max_bytes(1);
+  config.set_debug_options(options);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto m, ParseAndReturnUnverifiedModule(kMultiplyModule, config));
+  EXPECT_TRUE(DumpHloModuleIfEnabled(*m, "dump").empty());
+}
+
+TEST(DumpHloIfEnabled, CompressedText) {
+  HloModuleConfig config;
+  DebugOptions options = config.debug_options();
+  auto env = tsl::Env::Default();
+  std::string dump_dir;
+  EXPECT_TRUE(env->LocalTempFilename(&dump_dir));
+  options.set_xla_dump_to(dump_dir);
+  options.set_xla_dump_hlo_as_text(true);
+  options.set_xla_dump_compress_text(true);
+  config.set_debug_options(options);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto m, ParseAndReturnUnverifiedModule(kMultiplyModule, config));
+  auto paths = DumpHloModuleIfEnabled(*m, "dump");
+  ASSERT_EQ(paths.size(), 1);
+  EXPECT_TRUE(absl::EndsWith(paths[0], ".txt.gz"));
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(env, paths[0], &data));
+  // GZip magic number.
+  ASSERT_GE(data.size(), 2);
+  EXPECT_EQ(data.substr(0, 2), "\x1f\x8b");
+}
+
 }  // namespace
 }  // namespace xla
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/generic_transfer_manager.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -23,6 +24,8 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/cleanup/cleanup.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
@@ -84,6 +87,9 @@ void GenericTransferManager::TransferLiteralFromDevice(
     TF_RET_CHECK(stream->parent()->device_ordinal() ==
                  device_buffer.device_ordinal());
 
+    // Array buffers are collected as chunks and transferred at once, so that
+    // they can be spread over multiple streams.
+    std::vector<TransferChunk> chunks;
     TF_RETURN_IF_ERROR(ShapeUtil::ForEachSubshapeWithStatus(
         device_buffer.on_device_shape(),
         [&](const Shape& subshape, const ShapeIndex& index) -> absl::Status {
@@ -101,20 +107,33 @@ void GenericTransferManager::TransferLiteralFromDevice(
                   /*num_elements=*/ShapeUtil::ElementsIn(subshape),
                   /*destination=*/literal.untyped_data(index));
             } else {
-              TF_RETURN_IF_ERROR(TransferBufferFromDevice(
-                  stream,
-                  /*source=*/device_buffer.buffer(index),
-                  // With bounded dynamic shapes, the shape of the device buffer
-                  // (bounded allocation) can be bigger than the literal.
-                  /*size=*/
-                  GetByteSizeRequirement(
-                      ShapeUtil::GetSubshape(literal.shape(), index)),
-                  /*destination=*/literal.untyped_data(index)));
+              se::DeviceMemoryBase source = device_buffer.buffer(index);
+              // With bounded dynamic shapes, the shape of the device buffer
+              // (bounded allocation) can be bigger than the literal.
+              int64_t size = GetByteSizeRequirement(
+                  ShapeUtil::GetSubshape(literal.shape(), index));
+              auto* destination =
+                  static_cast<char*>(literal.untyped_data(index));
+
+              // Buffers that are too small for the literal are not split, so
+              // that TransferBufferFromDevice reports the error.
+              int64_t chunk_size = MaxTransferFromDeviceStreams() > 1
+                                       ? TransferFromDeviceChunkSize()
+                                       : size;
+              if (size <= chunk_size || source.size() < size) {
+                chunks.push_back({source, size, destination});
+                return absl::OkStatus();
+              }
+              for (int64_t offset = 0; offset < size; offset += chunk_size) {
+                int64_t length = std::min(chunk_size, size - offset);
+                chunks.push_back({source.GetByteSlice(offset, length), length,
+                                  destination + offset});
+              }
             }
           }
           return absl::OkStatus();
         }));
-    return absl::OkStatus();
+    return TransferChunksFromDevice(stream, chunks);
   }();
 
   if (!status.ok()) {
@@ -142,6 +161,60 @@ void GenericTransferManager::TransferLiteralFromDevice(
   }
 }
 
+absl::Status GenericTransferManager::TransferChunksFromDevice(
+    se::Stream* stream, absl::Span<const TransferChunk> chunks) {
+  int64_t num_streams = std::min<int64_t>(MaxTransferFromDeviceStreams(),
+                                          chunks.size());
+  if (num_streams <= 1) {
+    for (const TransferChunk& chunk : chunks) {
+      TF_RETURN_IF_ERROR(TransferBufferFromDevice(
+          stream, chunk.source, chunk.size, chunk.destination));
+    }
+    return absl::OkStatus();
+  }
+
+  // Sub-streams start the transfers once all work enqueued into `stream` (i.e.
+  // the computation that produced the buffers) is done.
+  std::vector<se::Stream*> sub_streams;
+  absl::Cleanup return_sub_streams = [&] {
+    for (se::Stream* sub_stream : sub_streams) {
+      stream->ReturnSubStream(sub_stream);
+    }
+  };
+  for (int64_t i = 0; i < num_streams; ++i) {
+    TF_ASSIGN_OR_RETURN(se::Stream * sub_stream,
+                        stream->GetOrCreateSubStream());
+    sub_streams.push_back(sub_stream);
+    TF_RETURN_IF_ERROR(sub_stream->WaitFor(stream));
+  }
+
+  // Assign the largest chunks first, each to the least loaded sub-stream.
+  std::vector<const TransferChunk*> sorted_chunks;
+  sorted_chunks.reserve(chunks.size());
+  for (const TransferChunk& chunk : chunks) sorted_chunks.push_back(&chunk);
+  absl::c_stable_sort(sorted_chunks,
+                      [](const TransferChunk* a, const TransferChunk* b) {
+                        return a->size > b->size;
+                      });
+
+  std::vector<int64_t> bytes_per_stream(num_streams, 0);
+  for (const TransferChunk* chunk : sorted_chunks) {
+    int64_t i =
+        absl::c_min_element(bytes_per_stream) - bytes_per_stream.begin();
+    bytes_per_stream[i] += chunk->size;
+    TF_RETURN_IF_ERROR(TransferBufferFromDevice(
+        sub_streams[i], chunk->source, chunk->size, chunk->destination));
+  }
+
+  VLOG(3) << "Transferred " << chunks.size() << " chunks from device on "
+          << num_streams << " streams";
+
+  for (se::Stream* sub_stream : sub_streams) {
+    TF_RETURN_IF_ERROR(stream->WaitFor(sub_stream));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status GenericTransferManager::TransferLiteralToDeviceAsync(
     se::Stream* stream, const LiteralSlice& literal,
     const ShapedBuffer& device_buffer,
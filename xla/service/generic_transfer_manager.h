@@ -84,6 +84,29 @@ class GenericTransferManager : public TransferManager {
   Shape HostShapeToDeviceShape(const Shape& host_shape) const override;
 
  private:
+  // A contiguous part of a device buffer that is transferred to the host.
+  struct TransferChunk {
+    se::DeviceMemoryBase source;
+    int64_t size;
+    void* destination;
+  };
+
+  // Returns the maximum number of streams used to transfer a literal from the
+  // device. If larger than one, array buffers of the literal are split into
+  // chunks of at most TransferFromDeviceChunkSize() bytes, and the chunks are
+  // transferred concurrently on sub-streams of the stream passed to
+  // TransferLiteralFromDevice. By default all buffers are transferred on the
+  // given stream.
+  virtual int64_t MaxTransferFromDeviceStreams() const { return 1; }
+  virtual int64_t TransferFromDeviceChunkSize() const {
+    return 64 * 1024 * 1024;
+  }
+
+  // Transfers `chunks` on up to MaxTransferFromDeviceStreams() sub-streams of
+  // `stream`. When this function returns, `stream` waits for all transfers.
+  absl::Status TransferChunksFromDevice(se::Stream* stream,
+                                        absl::Span<const TransferChunk> chunks);
+
   // Transfer a memory block of the given size from the device source into the
   // 'destination' buffer.
   //
@@ -48,9 +48,17 @@ class PackingTransferManager : public GenericTransferManager {
  public:
   using GenericTransferManager::GenericTransferManager;
   bool pack_subbyte_types_ = true;
+  int64_t max_transfer_from_device_streams_ = 1;
+  int64_t transfer_from_device_chunk_size_ = 64 * 1024 * 1024;
 
  private:
   bool PackSubbyteTypes() const override { return pack_subbyte_types_; }
+  int64_t MaxTransferFromDeviceStreams() const override {
+    return max_transfer_from_device_streams_;
+  }
+  int64_t TransferFromDeviceChunkSize() const override {
+    return transfer_from_device_chunk_size_;
+  }
 };
 
 class GenericTransferManagerTest : public ::testing::Test {
@@ -181,5 +189,39 @@ TEST_F(GenericTransferManagerTest, TransferLiteralFromDeviceInt4) {
   }
 }
 
+TEST_F(GenericTransferManagerTest, TransferLiteralFromDeviceOnSubStreams) {
+  transfer_manager_.max_transfer_from_device_streams_ = 3;
+  transfer_manager_.transfer_from_device_chunk_size_ = 8;
+
+  ScopedShapedBuffer buffer = AllocateBuffer(ShapeUtil::MakeTupleShape(
+      {ShapeUtil::MakeShape(F32, {10}), ShapeUtil::MakeShape(U16, {2, 2}),
+       ShapeUtil::MakeShape(F32, {3})}));
+
+  float* f32_ptr = static_cast<float*>(buffer.buffers().element({0}).opaque());
+  for (int i = 0; i < 10; i++) {
+    f32_ptr[i] = i;
+  }
+  uint16_t* u16_ptr =
+      static_cast<uint16_t*>(buffer.buffers().element({1}).opaque());
+  for (int i = 0; i < 4; i++) {
+    u16_ptr[i] = i + 1;
+  }
+  float* small_f32_ptr =
+      static_cast<float*>(buffer.buffers().element({2}).opaque());
+  for (int i = 0; i < 3; i++) {
+    small_f32_ptr[i] = -i;
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal literal,
+      transfer_manager_.TransferManager::TransferLiteralFromDevice(
+          stream_.get(), buffer));
+  Literal expected = LiteralUtil::MakeTupleOwned(
+      LiteralUtil::CreateR1<float>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}),
+      LiteralUtil::CreateR2<uint16_t>({{1, 2}, {3, 4}}),
+      LiteralUtil::CreateR1<float>({0, -1, -2}));
+  EXPECT_TRUE(LiteralTestUtil::Equal(literal, expected));
+}
+
 }  // namespace
 }  // namespace xla
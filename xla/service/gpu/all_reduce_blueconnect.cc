@@ -193,9 +193,13 @@ TryDecomposeReplicaGroups(const HloAllReduceInstruction& all_reduce,
 // different hosts.
 //
 // When applied repeatedly, this transformation will reproduce the same pattern
-// as described in the BlueConnect paper.
-absl::StatusOr<bool> TryDecomposeAllReduce(HloAllReduceInstruction* all_reduce,
-                                           size_t num_devices_per_host) {
+// as described in the BlueConnect paper. With multiple levels, the first level
+// groups devices by host and every recursive step moves one level outwards,
+// staying at the outermost level once it is reached.
+absl::StatusOr<bool> TryDecomposeAllReduce(
+    HloAllReduceInstruction* all_reduce,
+    absl::Span<const size_t> num_devices_per_level) {
+  const size_t num_devices_per_host = num_devices_per_level.front();
   TF_RET_CHECK(all_reduce);
   TF_RET_CHECK(!all_reduce->has_sharding());
 
@@ -274,9 +278,12 @@ absl::StatusOr<bool> TryDecomposeAllReduce(HloAllReduceInstruction* all_reduce,
   TF_RETURN_IF_ERROR(computation.ReplaceInstruction(all_reduce, replacement));
 
   // Try to apply decomposition recursively.
+  if (num_devices_per_level.size() > 1) {
+    num_devices_per_level.remove_prefix(1);
+  }
   TF_RETURN_IF_ERROR(
       TryDecomposeAllReduce(Cast<HloAllReduceInstruction>(new_all_reduce),
-                            num_devices_per_host)
+                            num_devices_per_level)
           .status());
   return true;
 }
@@ -287,6 +294,7 @@ absl::StatusOr<bool> AllReduceBlueConnect::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
   VLOG(1) << "Running AllReduceBlueConnect";
+  TF_RET_CHECK(!num_devices_per_level_.empty());
 
   if (hlo_query::ContainsLayoutConstrainedAllReduce(*module)) {
     VLOG(1)
@@ -315,7 +323,7 @@ absl::StatusOr<bool> AllReduceBlueConnect::Run(
   for (HloAllReduceInstruction* all_reduce : all_reduces) {
     TF_ASSIGN_OR_RETURN(
         bool all_reduce_changed,
-        TryDecomposeAllReduce(all_reduce, num_devices_per_host_));
+        TryDecomposeAllReduce(all_reduce, num_devices_per_level_));
     changed |= all_reduce_changed;
   }
 
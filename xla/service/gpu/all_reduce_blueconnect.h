@@ -17,6 +17,8 @@ limitations under the License.
 #define XLA_SERVICE_GPU_ALL_REDUCE_BLUECONNECT_H_
 
 #include <cstddef>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
@@ -38,7 +40,15 @@ namespace xla {
 class AllReduceBlueConnect : public HloModulePass {
  public:
   explicit AllReduceBlueConnect(size_t num_devices_per_host)
-      : num_devices_per_host_(num_devices_per_host) {}
+      : num_devices_per_level_({num_devices_per_host}) {}
+
+  // Decomposes all-reduces over a multi-level network hierarchy.
+  // `num_devices_per_level` holds the number of devices within one unit of
+  // each level, from the innermost level outwards, e.g. {devices per host,
+  // devices per rack}. Each level must contain a whole number of units of the
+  // previous one.
+  explicit AllReduceBlueConnect(std::vector<size_t> num_devices_per_level)
+      : num_devices_per_level_(std::move(num_devices_per_level)) {}
 
   absl::string_view name() const override { return "all-reduce-blueconnect"; }
 
@@ -48,7 +58,7 @@ class AllReduceBlueConnect : public HloModulePass {
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
  private:
-  size_t num_devices_per_host_;
+  std::vector<size_t> num_devices_per_level_;
 };
 
 }  // namespace xla
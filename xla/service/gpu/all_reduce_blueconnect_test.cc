@@ -144,6 +144,59 @@ ENTRY %comp {
               GmockMatch(m::Bitcast(all_gather1).WithShape(F32, {4, 4})));
 }
 
+TEST_F(AllReduceBlueConnectTest, MultiLevel) {
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+%add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY %comp {
+  p0 = f32[4,4] parameter(0)
+  ROOT crs = f32[4,4] all-reduce(p0), to_apply=add
+})";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  SetModuleConfig(*module, /*replica_count=*/16);
+
+  // Two devices per host and eight devices per rack.
+  AllReduceBlueConnect pass(std::vector<size_t>{2, 8});
+  EXPECT_THAT(pass.Run(module.get()), IsOkAndHolds(true));
+
+  // clang-format off
+  std::vector<std::vector<int64_t>> host_scatter_gather_groups = {
+      {0, 1}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}, {12, 13}, {14, 15}};
+  std::vector<std::vector<int64_t>> rack_scatter_gather_groups = {
+      {0, 2, 4, 6}, {8, 10, 12, 14}, {1, 3, 5, 7}, {9, 11, 13, 15}};
+  std::vector<std::vector<int64_t>> new_all_reduce_groups = {
+      {0, 8}, {2, 10}, {4, 12}, {6, 14}, {1, 9}, {3, 11}, {5, 13}, {7, 15}};
+  // clang-format on
+
+  auto bitcast0 = m::Bitcast(m::Parameter(0)).WithShape(F32, {16});
+  auto reduce_scatter0 =
+      m::ReduceScatter(bitcast0).WithShape(F32, {8}).WithReplicaGroups(
+          host_scatter_gather_groups);
+  auto bitcast1 = m::Bitcast(reduce_scatter0).WithShape(F32, {8});
+  auto reduce_scatter1 =
+      m::ReduceScatter(bitcast1).WithShape(F32, {2}).WithReplicaGroups(
+          rack_scatter_gather_groups);
+  auto all_reduce = m::AllReduce(reduce_scatter1)
+                        .WithShape(F32, {2})
+                        .WithReplicaGroups(new_all_reduce_groups);
+  auto all_gather0 = m::AllGather(all_reduce)
+                         .WithShape(F32, {8})
+                         .WithReplicaGroups(rack_scatter_gather_groups);
+  auto bitcast2 = m::Bitcast(all_gather0).WithShape(F32, {8});
+  auto all_gather1 =
+      m::AllGather(bitcast2).WithShape(F32, {16}).WithReplicaGroups(
+          host_scatter_gather_groups);
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Bitcast(all_gather1).WithShape(F32, {4, 4})));
+}
+
 TEST_F(AllReduceBlueConnectTest, TwoOperands) {
   constexpr absl::string_view hlo_string = R"(
 HloModule module
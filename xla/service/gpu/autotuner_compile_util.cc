@@ -161,6 +161,20 @@ absl::StatusOr<std::unique_ptr<Executable>> AutotunerCompileUtil::Compile(
   return out;
 }
 
+absl::StatusOr<std::unique_ptr<Executable>>
+AutotunerCompileUtil::CompileCandidate(const HloModule& prepared_module,
+                                       ModifyModuleFn modifier) {
+  return Compile([&](const DebugOptions&)
+                     -> absl::StatusOr<std::unique_ptr<HloModule>> {
+    // Cloning with a copy of the config, as HloModule::Clone(suffix) would
+    // freeze the config of the shared module, which is not thread-safe.
+    std::unique_ptr<HloModule> module =
+        prepared_module.Clone(prepared_module.config(), /*suffix=*/"");
+    TF_RETURN_IF_ERROR(modifier(*module));
+    return module;
+  });
+}
+
 absl::StatusOr<std::unique_ptr<HloModule>> AutotunerCompileUtil::ExtractModule(
     GenerateModuleFn extractor) {
   return extractor(opts_);
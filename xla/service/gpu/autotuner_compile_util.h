@@ -58,6 +58,10 @@ class AutotunerCompileUtil {
       absl::AnyInvocable<absl::StatusOr<std::unique_ptr<HloModule>>(
           const DebugOptions&)>;
 
+  // The ModifyModuleFn must turn a clone of a prepared module into the module
+  // of a single candidate, e.g. by setting the candidate's backend config.
+  using ModifyModuleFn = absl::AnyInvocable<absl::Status(HloModule&)>;
+
   // Generates a compile util for a platform associated with the `stream`.
   //
   // Returns an empty optional if the AutotuneConfig is deviceless, as
@@ -93,6 +97,18 @@ class AutotunerCompileUtil {
   absl::StatusOr<std::unique_ptr<Executable>> Compile(
       GenerateModuleFn extractor);
 
+  // Compiles a clone of `prepared_module` modified by `modifier` in isolation.
+  //
+  // `prepared_module` is typically extracted once per fusion with
+  // ExtractModule and shared by all candidates of the fusion, so that only the
+  // candidate specific part of the module preparation is repeated for each
+  // candidate. `prepared_module` is not modified, so it may be shared by
+  // concurrent compilations.
+  //
+  // Returns the same as Compile.
+  absl::StatusOr<std::unique_ptr<Executable>> CompileCandidate(
+      const HloModule& prepared_module, ModifyModuleFn modifier);
+
   // Generic method to extract an HLO using the debug options of the
   // AutotunerCompileUtil.
   //
@@ -15,11 +15,16 @@ limitations under the License.
 
 #include "xla/service/gpu/autotuner_compile_util.h"
 
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/executable.h"
 #include "xla/service/gpu/autotuner_util.h"
 #include "xla/service/platform_util.h"
 #include "xla/stream_executor/platform.h"
@@ -192,5 +197,64 @@ ENTRY main {
   EXPECT_EQ(rzb3.output_shape(), root.shape().tuple_shapes(0));
 }
 
+TEST_F(AutotunerCompileUtilTest, CompileCandidateKeepsPreparedModule) {
+  constexpr absl::string_view kHlo = R"(
+HloModule hlo
+
+fused_negate {
+  p0 = f32[16] parameter(0)
+  ROOT negate = f32[16] negate(p0)
+}
+
+ENTRY main {
+  p0 = f32[16] parameter(0)
+  ROOT fusion = f32[16] fusion(p0), kind=kLoop, calls=fused_negate
+}
+)";
+
+  se::Platform* platform = PlatformUtil::GetDefaultPlatform().value();
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<se::StreamExecutor*> executors,
+                          PlatformUtil::GetStreamExecutors(platform));
+
+  AutotuneConfig autotune_config{DeviceConfig{executors.at(0), nullptr},
+                                 GetDebugOptionsForTest()};
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::optional<AutotunerCompileUtil> util,
+      AutotunerCompileUtil::Create(autotune_config, GetDebugOptionsForTest()));
+  ASSERT_TRUE(util.has_value());
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<HloModule> prepared,
+      util->ExtractModule([&](const DebugOptions& debug_opts)
+                              -> absl::StatusOr<std::unique_ptr<HloModule>> {
+        TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                            ParseAndReturnVerifiedModule(kHlo));
+        module->mutable_config().set_debug_options(debug_opts);
+        return module;
+      }));
+
+  int num_candidates = 0;
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Executable> executable,
+                            util->CompileCandidate(
+                                *prepared, [&](HloModule& module) {
+                                  EXPECT_NE(&module, prepared.get());
+                                  module.set_name("candidate");
+                                  ++num_candidates;
+                                  return absl::OkStatus();
+                                }));
+    EXPECT_NE(executable, nullptr);
+  }
+  EXPECT_EQ(num_candidates, 2);
+  EXPECT_EQ(prepared->name(), "hlo");
+
+  EXPECT_FALSE(util
+                   ->CompileCandidate(*prepared,
+                                      [](HloModule&) {
+                                        return absl::InternalError("failed");
+                                      })
+                   .ok());
+}
+
 }  // namespace
 }  // namespace xla::gpu
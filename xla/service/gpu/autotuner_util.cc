@@ -17,11 +17,13 @@ limitations under the License.
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/const_init.h"
 #include "absl/base/thread_annotations.h"
@@ -30,10 +32,13 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/SHA256.h"
 #include "xla/autotune_results.pb.h"
@@ -75,6 +80,25 @@ static absl::Mutex autotune_cache_mu(absl::kConstInit);
 static auto& autotune_cache ABSL_GUARDED_BY(autotune_cache_mu) =
     *new AutotuneCacheMap();
 
+namespace {
+
+// An in-memory cache entry, indexed by the structure of its HLO.
+struct StructuralIndexEntry {
+  // The dimension sizes of all shapes in the HLO, in order of appearance.
+  std::vector<int64_t> dimensions;
+  AutotuneCacheKey key;
+};
+
+// Maps keys whose HLO has been reduced to its structure (see
+// SplitStructuralHlo) to the in-memory cache entries with that structure.
+using StructuralIndexMap =
+    absl::flat_hash_map<AutotuneCacheKey, std::vector<StructuralIndexEntry>>;
+
+}  // namespace
+
+static auto& structural_index ABSL_GUARDED_BY(autotune_cache_mu) =
+    *new StructuralIndexMap();
+
 absl::StatusOr<std::string> GetBase64EncodedSha256Hash(absl::string_view s) {
   llvm::SHA256 sha256;
   sha256.update(llvm::StringRef(s));
@@ -101,6 +125,73 @@ absl::StatusOr<std::string> GetCacheFilePath(absl::string_view cache_dir,
   return tsl::io::JoinPath(cache_dir, absl::StrCat(key_hash, ".textproto"));
 }
 
+// Splits canonical HLO text into its structure and the dimension sizes of the
+// shapes in it. The structure has the values of constants and the dimension
+// sizes of shapes elided, so that e.g. the same fusion at a different batch
+// size, or with a different scalar constant, has the same structure.
+std::string SplitStructuralHlo(absl::string_view hlo,
+                               std::vector<int64_t>& dimensions) {
+  constexpr absl::string_view kConstant = "constant(";
+  std::string structure;
+  structure.reserve(hlo.size());
+  size_t i = 0;
+  while (i < hlo.size()) {
+    if (absl::StartsWith(hlo.substr(i), kConstant)) {
+      size_t end = hlo.find(')', i + kConstant.size());
+      if (end == absl::string_view::npos) {
+        break;
+      }
+      absl::StrAppend(&structure, kConstant, ")");
+      i = end + 1;
+      continue;
+    }
+    if (hlo[i] == '[') {
+      // Only consume dimension lists, e.g. "[16,128]", and leave anything
+      // else in brackets (e.g. slice bounds) as part of the structure.
+      size_t end = hlo.find_first_not_of("0123456789,", i + 1);
+      if (end != absl::string_view::npos && hlo[end] == ']') {
+        for (absl::string_view dim : absl::StrSplit(
+                 hlo.substr(i + 1, end - i - 1), ',', absl::SkipEmpty())) {
+          int64_t size;
+          if (absl::SimpleAtoi(dim, &size)) {
+            dimensions.push_back(size);
+          }
+        }
+        structure.append("[]");
+        i = end + 1;
+        continue;
+      }
+    }
+    structure.push_back(hlo[i++]);
+  }
+  structure.append(hlo.substr(i));
+  return structure;
+}
+
+AutotuneCacheKey GetStructuralKey(const AutotuneCacheKey& key,
+                                  std::vector<int64_t>& dimensions) {
+  return AutotuneCacheKey(key.GetModelStr(),
+                          SplitStructuralHlo(key.GetHlo(), dimensions));
+}
+
+void AddToStructuralIndex(const AutotuneCacheKey& key)
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(autotune_cache_mu) {
+  std::vector<int64_t> dimensions;
+  AutotuneCacheKey structural_key = GetStructuralKey(key, dimensions);
+  structural_index[structural_key].push_back({std::move(dimensions), key});
+}
+
+// Distance between two shapes, as the sum of the log-ratios of their
+// dimension sizes. Doubling one dimension is as far as halving it.
+double ShapeDistance(absl::Span<const int64_t> a, absl::Span<const int64_t> b) {
+  double distance = 0;
+  for (int i = 0; i < a.size(); ++i) {
+    distance += std::abs(std::log2(static_cast<double>(a[i] + 1)) -
+                         std::log2(static_cast<double>(b[i] + 1)));
+  }
+  return distance;
+}
+
 struct ResultAndInserted {
   // The result that ended up in the cache. This is the existing result if
   // inserted is false, and the new result if inserted is true.
@@ -116,6 +207,9 @@ ResultAndInserted AddResultToInMemoryCache(const AutotuneCacheKey& key,
     ABSL_LOCKS_EXCLUDED(autotune_cache_mu) {
   absl::MutexLock lock(&autotune_cache_mu);
   auto [it, inserted] = autotune_cache.emplace(key, std::move(result));
+  if (inserted) {
+    AddToStructuralIndex(key);
+  }
   return {it->second, inserted};
 }
 
@@ -259,6 +353,7 @@ void SerializeAutotuneEntry(AutotuneResults* results, const AutotuneCacheKey& k,
       return absl::InternalError(absl::StrCat(
           "Duplicate autotuning result for ", it->first.ToString()));
     }
+    AddToStructuralIndex(AutotuneCacheKey(result.device(), result.hlo()));
   }
   return absl::OkStatus();
 }
@@ -266,6 +361,7 @@ void SerializeAutotuneEntry(AutotuneResults* results, const AutotuneCacheKey& k,
 /*static*/ void AutotunerUtil::ClearAutotuneResults() {
   absl::MutexLock lock(&autotune_cache_mu);
   autotune_cache.clear();
+  structural_index.clear();
 }
 
 /*static*/ bool AutotunerUtil::ResultCacheIsEmpty() {
@@ -359,6 +455,37 @@ absl::StatusOr<std::optional<AutotuneResult>> TryFindInCache(
   return opt_res.has_value();
 }
 
+/*static*/ std::optional<AutotuneResult> AutotunerUtil::FindNearestResult(
+    const AutotuneCacheKey& key) {
+  std::vector<int64_t> dimensions;
+  AutotuneCacheKey structural_key = GetStructuralKey(key, dimensions);
+
+  absl::MutexLock lock(&autotune_cache_mu);
+  auto it = structural_index.find(structural_key);
+  if (it == structural_index.end()) {
+    return std::nullopt;
+  }
+  const StructuralIndexEntry* nearest = nullptr;
+  double nearest_distance = std::numeric_limits<double>::infinity();
+  for (const StructuralIndexEntry& entry : it->second) {
+    // Equal structure implies the same number of dimensions.
+    if (entry.dimensions.size() != dimensions.size()) {
+      continue;
+    }
+    double distance = ShapeDistance(entry.dimensions, dimensions);
+    if (distance < nearest_distance) {
+      nearest = &entry;
+      nearest_distance = distance;
+    }
+  }
+  if (nearest == nullptr) {
+    return std::nullopt;
+  }
+  VLOG(2) << "Nearest autotune result for " << key.ToString() << " is "
+          << nearest->key.ToString() << " at distance " << nearest_distance;
+  return autotune_cache.at(nearest->key);
+}
+
 /*static*/ absl::StatusOr<bool> AutotunerUtil::AddResult(
     const AutotuneCacheKey& key, AutotuneResult result,
     const AutotuneConfig& config) {
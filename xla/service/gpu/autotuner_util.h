@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <variant>
@@ -212,6 +213,15 @@ struct AutotunerUtil {
   static absl::StatusOr<bool> IsInCache(const AutotuneCacheKey& key,
                                         const AutotuneConfig& config);
 
+  // Returns the in-memory cached result whose HLO is structurally equal to the
+  // one of `key` -- i.e. equal up to the values of constants and the sizes of
+  // dimensions -- and whose shapes are nearest to it, if any.
+  //
+  // Such a result is not guaranteed to be valid, let alone optimal, for `key`,
+  // so callers should verify it before use.
+  static std::optional<AutotuneResult> FindNearestResult(
+      const AutotuneCacheKey& key);
+
   // Adds the result to the autotune cache.
   //
   // Returns true if the entry is inserted.
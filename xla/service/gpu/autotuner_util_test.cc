@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/autotuner_util.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -256,6 +257,58 @@ TEST_F(AutotunerUtilTest, OkIfJitAutotuningDisabledButAlreadyLoadedAOT) {
                }).status());
 }
 
+AutotuneResults::Entry MakeTritonEntry(absl::string_view device,
+                                       absl::string_view hlo, int block_m) {
+  AutotuneResults::Entry entry;
+  entry.set_device(std::string(device));
+  entry.set_hlo(std::string(hlo));
+  entry.mutable_result()->mutable_triton()->set_block_m(block_m);
+  return entry;
+}
+
+TEST_F(AutotunerUtilTest, FindNearestResultPicksTheNearestShape) {
+  AutotuneResults results;
+  *results.add_results() =
+      MakeTritonEntry("gpu", "ROOT tmp_0 = f32[16,64]{1,0} parameter(0)", 64);
+  *results.add_results() =
+      MakeTritonEntry("gpu", "ROOT tmp_0 = f32[16,512]{1,0} parameter(0)", 512);
+  TF_EXPECT_OK(AutotunerUtil::LoadAutotuneResults(results));
+
+  std::optional<AutotuneResult> nearest = AutotunerUtil::FindNearestResult(
+      AutotuneCacheKey("gpu", "ROOT tmp_0 = f32[16,128]{1,0} parameter(0)"));
+  ASSERT_TRUE(nearest.has_value());
+  EXPECT_EQ(nearest->triton().block_m(), 64);
+}
+
+TEST_F(AutotunerUtilTest, FindNearestResultIgnoresConstantValues) {
+  AutotuneResults results;
+  *results.add_results() =
+      MakeTritonEntry("gpu", "ROOT tmp_0 = f32[] constant(1)", 16);
+  TF_EXPECT_OK(AutotunerUtil::LoadAutotuneResults(results));
+
+  EXPECT_TRUE(AutotunerUtil::FindNearestResult(
+                  AutotuneCacheKey("gpu", "ROOT tmp_0 = f32[] constant(2)"))
+                  .has_value());
+}
+
+TEST_F(AutotunerUtilTest, FindNearestResultRequiresEqualStructure) {
+  AutotuneResults results;
+  *results.add_results() =
+      MakeTritonEntry("gpu", "ROOT tmp_0 = f32[16,64]{1,0} parameter(0)", 64);
+  TF_EXPECT_OK(AutotunerUtil::LoadAutotuneResults(results));
+
+  // Different element type.
+  EXPECT_FALSE(
+      AutotunerUtil::FindNearestResult(
+          AutotuneCacheKey("gpu", "ROOT tmp_0 = f16[16,64]{1,0} parameter(0)"))
+          .has_value());
+  // Different device.
+  EXPECT_FALSE(
+      AutotunerUtil::FindNearestResult(
+          AutotuneCacheKey("gpu2", "ROOT tmp_0 = f32[16,64]{1,0} parameter(0)"))
+          .has_value());
+}
+
 class FileBasedCacheTest : public AutotunerUtilTest {
  public:
   static std::string ToString(const proto2::Message& message) {
@@ -0,0 +1,69 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/gpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::gpu {
+
+// Concatenates three matrices along the minor dimension and applies an
+// elementwise op, which is emitted with the concatenate emitter.
+static void BM_ConcatenateF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule concatenate_f32_$d0_$d1
+
+    ENTRY e {
+      p0 = f32[$d0,$d1] parameter(0)
+      p1 = f32[$d0,$d1] parameter(1)
+      p2 = f32[$d0,$d1] parameter(2)
+      concat = f32[$d0,$d2] concatenate(p0, p1, p2), dimensions={1}
+      ROOT neg = f32[$d0,$d2] negate(concat)
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+  auto p1 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+  auto p2 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0, &p1, &p2};
+  CHECK_OK(RunHloBenchmark(state, hlo, args,
+                           {{"$d0", absl::StrCat(d0)},
+                            {"$d1", absl::StrCat(d1)},
+                            {"$d2", absl::StrCat(3 * d1)}}));
+}
+
+BENCHMARK(BM_ConcatenateF32)
+    ->UseRealTime()
+    ->Args({1024, 16})
+    ->Args({1024, 1024})
+    ->Args({16384, 128});
+
+}  // namespace xla::gpu
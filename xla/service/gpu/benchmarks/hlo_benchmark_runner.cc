@@ -0,0 +1,206 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/benchmarks/hlo_benchmark_runner.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/btree_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "xla/client/xla_computation.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/literal.h"
+#include "xla/pjrt/gpu/se_gpu_pjrt_client.h"
+#include "xla/pjrt/local_device_state.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/pjrt_stream_executor_client.h"
+#include "xla/service/gpu/hlo_fusion_analysis.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/service/hlo_parser.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/tools/hlo_cost_report.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/casts.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::gpu {
+namespace {
+
+// GpuPerformanceModel estimates for the whole HLO module.
+struct RooflineEstimate {
+  int64_t flops = 0;
+  int64_t bytes = 0;
+  absl::Duration exec_time;
+  absl::btree_set<std::string> emitters;
+};
+
+std::string_view EmitterFusionKindName(
+    HloFusionAnalysis::EmitterFusionKind kind) {
+  switch (kind) {
+    case HloFusionAnalysis::EmitterFusionKind::kLoop:
+      return "loop";
+    case HloFusionAnalysis::EmitterFusionKind::kCustomFusion:
+      return "custom";
+    case HloFusionAnalysis::EmitterFusionKind::kTriton:
+      return "triton";
+    case HloFusionAnalysis::EmitterFusionKind::kReduction:
+      return "reduction";
+    case HloFusionAnalysis::EmitterFusionKind::kTranspose:
+      return "transpose";
+    case HloFusionAnalysis::EmitterFusionKind::kConcatenate:
+      return "concatenate";
+    case HloFusionAnalysis::EmitterFusionKind::kInputSlices:
+      return "input_slices";
+    case HloFusionAnalysis::EmitterFusionKind::kScatter:
+      return "scatter";
+    case HloFusionAnalysis::EmitterFusionKind::kCuDnn:
+      return "cudnn";
+  }
+}
+
+absl::StatusOr<RooflineEstimate> EstimateRoofline(
+    const HloModule& module, const se::DeviceDescription& device_info) {
+  HloCostReportOptions options;
+  options.gpu_device_info = device_info;
+  TF_ASSIGN_OR_RETURN(HloCostReport report,
+                      ComputeHloCostReport(module, options));
+
+  RooflineEstimate estimate;
+  estimate.flops = report.flops;
+  estimate.bytes = report.bytes_accessed;
+  estimate.exec_time = report.time;
+  for (const HloInstruction* instr :
+       module.entry_computation()->instructions()) {
+    if (auto* fusion = DynCast<HloFusionInstruction>(instr)) {
+      HloFusionAnalysis analysis =
+          HloFusionAnalysis::Create(fusion, &device_info);
+      estimate.emitters.insert(
+          std::string(EmitterFusionKindName(analysis.GetEmitterFusionKind())));
+    }
+  }
+  return estimate;
+}
+
+}  // namespace
+
+absl::Status RunHloBenchmark(benchmark::State& state,
+                             std::string_view hlo_module,
+                             absl::Span<const Literal* const> args,
+                             StrToStrMapping replacements,
+                             const HloBenchmarkOptions& options) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtClient> client,
+                      GetStreamExecutorGpuClient(GpuClientOptions()));
+  PjRtDevice* device = client->addressable_devices().front();
+
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<HloModule> module,
+      ParseAndReturnUnverifiedModule(
+          absl::StrReplaceAll(hlo_module, replacements), HloModuleConfig()));
+
+  XlaComputation computation(module->ToProto());
+
+  // Compile HLO module to executable.
+  CompileOptions compile_options;
+  DebugOptions* debug_options =
+      compile_options.executable_build_options.mutable_debug_options();
+  if (options.disable_triton_gemm) {
+    debug_options->set_xla_gpu_enable_triton_gemm(false);
+  }
+  if (options.enable_triton_softmax_fusion) {
+    debug_options->set_xla_gpu_enable_triton_softmax_fusion(true);
+  }
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> executable,
+                      client->Compile(computation, compile_options));
+
+  // Estimate the roofline for the optimized HLO module.
+  TF_ASSIGN_OR_RETURN(std::vector<std::shared_ptr<HloModule>> hlo_modules,
+                      executable->GetHloModules());
+  const se::DeviceDescription& device_info =
+      tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)
+          ->local_device_state()
+          ->executor()
+          ->GetDeviceDescription();
+  TF_ASSIGN_OR_RETURN(RooflineEstimate estimate,
+                      EstimateRoofline(*hlo_modules.front(), device_info));
+
+  // Convert literals to PjRtBuffers.
+  std::vector<std::unique_ptr<PjRtBuffer>> args_buffers;
+  args_buffers.reserve(args.size());
+
+  for (const Literal* arg : args) {
+    TF_ASSIGN_OR_RETURN(args_buffers.emplace_back(),
+                        client->BufferFromHostLiteral(*arg, device));
+    TF_RETURN_IF_ERROR(args_buffers.back()->GetReadyFuture().Await());
+  }
+
+  std::vector<PjRtBuffer*> args_ptrs;
+  args_ptrs.reserve(args_buffers.size());
+  for (const auto& arg : args_buffers) {
+    args_ptrs.push_back(arg.get());
+  }
+
+  // Executes the benchmark and waits for all results to become ready.
+  ExecuteOptions execute_options;
+  auto execute = [&]() -> absl::Status {
+    TF_ASSIGN_OR_RETURN(
+        std::vector<std::unique_ptr<PjRtBuffer>> results,
+        executable->ExecuteSharded(args_ptrs, device, execute_options));
+    for (const auto& result : results) {
+      TF_RETURN_IF_ERROR(result->GetReadyFuture().Await());
+    }
+    return absl::OkStatus();
+  };
+
+  // Warmup executable.
+  TF_RETURN_IF_ERROR(execute());
+
+  // Benchmark executable.
+  absl::Time start = absl::Now();
+  for (auto _ : state) {
+    TF_RETURN_IF_ERROR(execute());
+  }
+  absl::Duration elapsed = absl::Now() - start;
+
+  state.SetLabel(absl::StrJoin(estimate.emitters, ","));
+  state.counters["bytes"] = benchmark::Counter(
+      estimate.bytes, benchmark::Counter::kIsIterationInvariantRate,
+      benchmark::Counter::kIs1024);
+  state.counters["flops"] = benchmark::Counter(
+      estimate.flops, benchmark::Counter::kIsIterationInvariantRate);
+  if (state.iterations() > 0 && elapsed > absl::ZeroDuration()) {
+    state.counters["roofline"] =
+        absl::FDivDuration(estimate.exec_time * state.iterations(), elapsed);
+  }
+
+  return absl::OkStatus();
+}
+
+}  // namespace xla::gpu
@@ -0,0 +1,65 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
+#define XLA_SERVICE_GPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
+
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/literal.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::gpu {
+
+// A string-to-string mapping that allows to parametrize HLO benchmarks.
+using StrToStrMapping =
+    std::initializer_list<std::pair<absl::string_view, absl::string_view>>;
+
+// Options for compiling and running HLO benchmarks.
+struct HloBenchmarkOptions {
+  // If true, disables Triton GEMM fusions, so that dots are compiled to
+  // library (cuBLAS) calls.
+  bool disable_triton_gemm = false;
+
+  // If true, enables Triton softmax fusions.
+  bool enable_triton_softmax_fusion = false;
+};
+
+// Compiles `hlo_module` for the first GPU device and benchmarks its execution.
+// Besides timings, reports the following benchmark user counters derived from
+// the GpuPerformanceModel estimates for the optimized HLO module, so that
+// regressions of individual fusion emitters show up against the roofline:
+//
+//   bytes       achieved memory bandwidth (bytes read and written per second)
+//   flops       achieved FLOP/s
+//   roofline    estimated execution time divided by the measured execution
+//               time (1.0 means the kernels run at the modeled roofline)
+//
+// The benchmark label lists the emitters selected for the fusions of the
+// optimized module (i.e. "loop,reduction").
+absl::Status RunHloBenchmark(benchmark::State& state,
+                             std::string_view hlo_module,
+                             absl::Span<const Literal* const> args,
+                             StrToStrMapping replacements = {},
+                             const HloBenchmarkOptions& options = {});
+
+}  // namespace xla::gpu
+
+#endif  // XLA_SERVICE_GPU_BENCHMARKS_HLO_BENCHMARK_RUNNER_H_
@@ -0,0 +1,99 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/gpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::gpu {
+
+// Elementwise fusion of a chain of cheap ops, bound by the memory bandwidth.
+static void BM_LoopFusionF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+
+  std::string_view hlo = R"(
+    HloModule loop_fusion_f32_$d0
+
+    ENTRY e {
+      p0 = f32[$d0,1024] parameter(0)
+      p1 = f32[$d0,1024] parameter(1)
+      add = f32[$d0,1024] add(p0, p1)
+      mul = f32[$d0,1024] multiply(add, p1)
+      ROOT exp = f32[$d0,1024] exponential(mul)
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, 1024});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+  auto p1 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0, &p1};
+  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}}));
+}
+
+// Elementwise fusion with a broadcasted operand.
+static void BM_LoopFusionBroadcastF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+
+  std::string_view hlo = R"(
+    HloModule loop_fusion_broadcast_f32_$d0
+
+    ENTRY e {
+      p0 = f32[$d0,1024] parameter(0)
+      p1 = f32[1024] parameter(1)
+      bcast = f32[$d0,1024] broadcast(p1), dimensions={1}
+      ROOT add = f32[$d0,1024] add(p0, bcast)
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto p0_shape = ShapeUtil::MakeShape(F32, {d0, 1024});
+  auto p1_shape = ShapeUtil::MakeShape(F32, {1024});
+  auto p0 =
+      *LiteralUtil::CreateRandomLiteral<F32>(p0_shape, &engine, 1.0f, 0.1f);
+  auto p1 =
+      *LiteralUtil::CreateRandomLiteral<F32>(p1_shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0, &p1};
+  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}}));
+}
+
+BENCHMARK(BM_LoopFusionF32)
+    ->UseRealTime()
+    ->Arg(128)
+    ->Arg(1024)
+    ->Arg(16384)
+    ->Arg(65536);
+
+BENCHMARK(BM_LoopFusionBroadcastF32)
+    ->UseRealTime()
+    ->Arg(128)
+    ->Arg(1024)
+    ->Arg(16384)
+    ->Arg(65536);
+
+}  // namespace xla::gpu
@@ -0,0 +1,82 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/gpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::gpu {
+
+// Scatter-adds rows of updates to random rows of the operand.
+static void BM_ScatterAddRowsF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule scatter_add_rows_f32_$d0_$d1
+
+    add {
+      lhs = f32[] parameter(0)
+      rhs = f32[] parameter(1)
+      ROOT add = f32[] add(lhs, rhs)
+    }
+
+    ENTRY e {
+      operand = f32[$d0,256] parameter(0)
+      indices = s32[$d1,1] parameter(1)
+      updates = f32[$d1,256] parameter(2)
+      ROOT scatter = f32[$d0,256] scatter(operand, indices, updates),
+        update_window_dims={1}, inserted_window_dims={0},
+        scatter_dims_to_operand_dims={0}, index_vector_dim=1, to_apply=add
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto operand_shape = ShapeUtil::MakeShape(F32, {d0, 256});
+  auto updates_shape = ShapeUtil::MakeShape(F32, {d1, 256});
+  auto operand = *LiteralUtil::CreateRandomLiteral<F32>(operand_shape, &engine,
+                                                        1.0f, 0.1f);
+  auto updates = *LiteralUtil::CreateRandomLiteral<F32>(updates_shape, &engine,
+                                                        1.0f, 0.1f);
+
+  std::uniform_int_distribution<int32_t> distribution(0, d0 - 1);
+  std::vector<int32_t> indices_data(d1);
+  for (int32_t& index : indices_data) index = distribution(engine);
+  auto indices = *LiteralUtil::CreateR1<int32_t>(indices_data).Reshape({d1, 1});
+
+  std::vector<const Literal*> args = {&operand, &indices, &updates};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args,
+      {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}}));
+}
+
+BENCHMARK(BM_ScatterAddRowsF32)
+    ->UseRealTime()
+    ->Args({1024, 128})
+    ->Args({1024, 4096})
+    ->Args({65536, 4096})
+    ->Args({65536, 65536});
+
+}  // namespace xla::gpu
@@ -0,0 +1,155 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/gpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/test_benchmark.h"
+
+namespace xla::gpu {
+
+static void BM_DotF32(benchmark::State& state, bool disable_triton_gemm) {
+  int64_t d0 = state.range(0);
+
+  std::string_view hlo = R"(
+    HloModule dot_f32_$d0
+
+    ENTRY e {
+      p0 = f32[$d0,$d0] parameter(0)
+      p1 = f32[$d0,$d0] parameter(1)
+      ROOT dot = f32[$d0,$d0] dot(p0, p1),
+        lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d0});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+  auto p1 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  HloBenchmarkOptions options;
+  options.disable_triton_gemm = disable_triton_gemm;
+
+  std::vector<const Literal*> args = {&p0, &p1};
+  CHECK_OK(
+      RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}}, options));
+}
+
+// Dot with an elementwise prologue, that can't be fused into cuBLAS calls,
+// and is a candidate for Triton GEMM fusion.
+static void BM_TritonGemmF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+
+  std::string_view hlo = R"(
+    HloModule triton_gemm_f32_$d0
+
+    ENTRY e {
+      p0 = bf16[$d0,$d0] parameter(0)
+      p1 = f32[$d0,$d0] parameter(1)
+      convert = f32[$d0,$d0] convert(p0)
+      ROOT dot = f32[$d0,$d0] dot(convert, p1),
+        lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto p0_shape = ShapeUtil::MakeShape(BF16, {d0, d0});
+  auto p1_shape = ShapeUtil::MakeShape(F32, {d0, d0});
+  auto p0 =
+      *LiteralUtil::CreateRandomLiteral<BF16>(p0_shape, &engine, 1.0f, 0.1f);
+  auto p1 =
+      *LiteralUtil::CreateRandomLiteral<F32>(p1_shape, &engine, 1.0f, 0.1f);
+
+  std::vector<const Literal*> args = {&p0, &p1};
+  CHECK_OK(RunHloBenchmark(state, hlo, args, {{"$d0", absl::StrCat(d0)}}));
+}
+
+static void BM_TritonSoftmaxF32(benchmark::State& state) {
+  int64_t d0 = state.range(0);
+  int64_t d1 = state.range(1);
+
+  std::string_view hlo = R"(
+    HloModule triton_softmax_f32_$d0_$d1
+
+    max {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT max = f32[] maximum(p0, p1)
+    }
+
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY e {
+      p0 = f32[$d0,$d1] parameter(0)
+      ninf = f32[] constant(-inf)
+      max = f32[$d0] reduce(p0, ninf), dimensions={1}, to_apply=max
+      max_bcast = f32[$d0,$d1] broadcast(max), dimensions={0}
+      sub = f32[$d0,$d1] subtract(p0, max_bcast)
+      exp = f32[$d0,$d1] exponential(sub)
+      zero = f32[] constant(0)
+      sum = f32[$d0] reduce(exp, zero), dimensions={1}, to_apply=add
+      sum_bcast = f32[$d0,$d1] broadcast(sum), dimensions={0}
+      ROOT div = f32[$d0,$d1] divide(exp, sum_bcast)
+    }
+  )";
+
+  std::minstd_rand0 engine;
+
+  auto shape = ShapeUtil::MakeShape(F32, {d0, d1});
+  auto p0 = *LiteralUtil::CreateRandomLiteral<F32>(shape, &engine, 1.0f, 0.1f);
+
+  HloBenchmarkOptions options;
+  options.enable_triton_softmax_fusion = true;
+
+  std::vector<const Literal*> args = {&p0};
+  CHECK_OK(RunHloBenchmark(
+      state, hlo, args, {{"$d0", absl::StrCat(d0)}, {"$d1", absl::StrCat(d1)}},
+      options));
+}
+
+static void BM_TritonDotF32(benchmark::State& state) {
+  BM_DotF32(state, /*disable_triton_gemm=*/false);
+}
+
+static void BM_CublasDotF32(benchmark::State& state) {
+  BM_DotF32(state, /*disable_triton_gemm=*/true);
+}
+
+BENCHMARK(BM_TritonDotF32)->UseRealTime()->Arg(256)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_CublasDotF32)->UseRealTime()->Arg(256)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_TritonGemmF32)->UseRealTime()->Arg(256)->Arg(1024)->Arg(4096);
+
+BENCHMARK(BM_TritonSoftmaxF32)
+    ->UseRealTime()
+    ->Args({1024, 128})
+    ->Args({1024, 1024})
+    ->Args({16384, 256})
+    ->Args({128, 16384});
+
+}  // namespace xla::gpu
@@ -0,0 +1,130 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/captured_program.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/runtime/for_all_thunks.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "xla/stream_executor/command_buffer.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/stream_executor/trace_command_buffer_factory.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+
+namespace xla::gpu {
+
+bool IsCapturable(const ThunkSequence& thunks) {
+  bool capturable = true;
+  ForAllThunks(
+      [&](const Thunk* thunk) {
+        switch (thunk->kind()) {
+          case Thunk::kCommandBuffer:
+          case Thunk::kConditional:
+          case Thunk::kCustomCall:
+          case Thunk::kInfeed:
+          case Thunk::kOutfeed:
+          case Thunk::kRecv:
+          case Thunk::kRecvDone:
+          case Thunk::kSend:
+          case Thunk::kSendDone:
+          case Thunk::kWhile:
+            VLOG(2) << "Thunk " << thunk->profile_annotation()
+                    << " can't be captured into a command buffer";
+            capturable = false;
+            break;
+          default:
+            break;
+        }
+      },
+      &thunks);
+  return capturable;
+}
+
+absl::StatusOr<bool> CapturedProgram::Submit(
+    const ThunkSequence& thunks, const Thunk::ExecuteParams& params) {
+  absl::MutexLock lock(&mutex_);
+  if (capture_failed_) return false;
+
+  // The first execution runs thunks one by one, so that they complete lazy
+  // initialization and first call rendezvous that can't be captured.
+  if (!executed_) {
+    executed_ = true;
+    return false;
+  }
+
+  std::vector<se::DeviceMemoryBase> allocs;
+  allocs.reserve(params.buffer_allocations->size());
+  for (BufferAllocation::Index i = 0; i < params.buffer_allocations->size();
+       ++i) {
+    allocs.push_back(params.buffer_allocations->GetDeviceAddress(i));
+  }
+
+  se::Stream* stream = params.stream;
+  se::StreamExecutor* executor = stream->parent();
+
+  auto same_address = [](const se::DeviceMemoryBase& a,
+                         const se::DeviceMemoryBase& b) {
+    return a.IsSameAs(b);
+  };
+
+  if (command_buffer_ == nullptr ||
+      !absl::c_equal(allocs, recorded_allocs_, same_address)) {
+    VLOG(2) << "Capture thunk sequence into a command buffer on device "
+            << executor->device_ordinal();
+    auto trace = [&](se::Stream*) -> absl::Status {
+      for (const std::unique_ptr<Thunk>& thunk : thunks) {
+        TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(params));
+      }
+      return absl::OkStatus();
+    };
+    absl::StatusOr<std::unique_ptr<se::CommandBuffer>> command_buffer =
+        se::TraceCommandBufferFactory::Create(
+            executor, stream, trace, se::CommandBuffer::Mode::kPrimary);
+    if (!command_buffer.ok()) {
+      LOG(WARNING) << "Failed to capture thunk sequence into a command buffer, "
+                      "fall back to thunk execution: "
+                   << command_buffer.status();
+      capture_failed_ = true;
+      command_buffer_ = nullptr;
+      return false;
+    }
+    command_buffer_ = std::move(*command_buffer);
+    recorded_allocs_ = std::move(allocs);
+    ++num_captures_;
+  }
+
+  TF_RETURN_IF_ERROR(executor->Submit(stream, *command_buffer_));
+  return true;
+}
+
+int64_t CapturedProgram::num_captures() const {
+  absl::MutexLock lock(&mutex_);
+  return num_captures_;
+}
+
+}  // namespace xla::gpu
@@ -0,0 +1,64 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_CAPTURED_PROGRAM_H_
+#define XLA_SERVICE_GPU_CAPTURED_PROGRAM_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "xla/stream_executor/command_buffer.h"
+#include "xla/stream_executor/device_memory.h"
+
+namespace xla::gpu {
+
+// Returns true if the execution of all thunks can be captured into a single
+// command buffer. Thunks that read device values on the host, exchange data
+// with the host, or run arbitrary host code can't be replayed without
+// re-executing them on the host.
+bool IsCapturable(const ThunkSequence& thunks);
+
+// A command buffer captured by tracing the execution of a whole thunk sequence
+// on a single executor (see `xla_gpu_enable_whole_program_capture`). The
+// command buffer is replayed with a single launch as long as buffer
+// allocations have the same addresses as at capture time.
+class CapturedProgram {
+ public:
+  // Submits the captured command buffer to the main stream, captures it first
+  // if buffer addresses changed since the last capture. Returns false if thunks
+  // must be executed one by one instead.
+  absl::StatusOr<bool> Submit(const ThunkSequence& thunks,
+                              const Thunk::ExecuteParams& params);
+
+  // Returns the number of times the thunk sequence was captured successfully.
+  int64_t num_captures() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  bool executed_ ABSL_GUARDED_BY(mutex_) = false;
+  bool capture_failed_ ABSL_GUARDED_BY(mutex_) = false;
+  int64_t num_captures_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::vector<se::DeviceMemoryBase> recorded_allocs_ ABSL_GUARDED_BY(mutex_);
+  std::unique_ptr<se::CommandBuffer> command_buffer_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xla::gpu
+
+#endif  // XLA_SERVICE_GPU_CAPTURED_PROGRAM_H_
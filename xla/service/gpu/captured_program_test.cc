@@ -0,0 +1,203 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/captured_program.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/runtime/copy_thunk.h"
+#include "xla/service/gpu/runtime/infeed_thunk.h"
+#include "xla/service/gpu/runtime/outfeed_thunk.h"
+#include "xla/service/gpu/runtime/sequential_thunk.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "xla/service/platform_util.h"
+#include "xla/service/service_executable_run_options.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/platform.h"
+#include "xla/stream_executor/platform_manager.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/stream_executor/stream_executor_memory_allocator.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla::gpu {
+namespace {
+
+se::StreamExecutor* GpuExecutor() {
+  auto name =
+      absl::AsciiStrToUpper(PlatformUtil::CanonicalPlatformName("gpu").value());
+  auto* platform = se::PlatformManager::PlatformWithName(name).value();
+  return platform->ExecutorForDevice(0).value();
+}
+
+// A thunk that counts its executions and returns `status` from each of them.
+class CountingThunk : public Thunk {
+ public:
+  explicit CountingThunk(absl::Status status)
+      : Thunk(Kind::kKernel, ThunkInfo()), status_(std::move(status)) {}
+
+  absl::Status ExecuteOnStream(const ExecuteParams& params) override {
+    ++num_executions_;
+    return status_;
+  }
+
+  int64_t num_executions() const { return num_executions_; }
+
+ private:
+  absl::Status status_;
+  int64_t num_executions_ = 0;
+};
+
+TEST(CapturedProgramTest, HostDependentThunksAreNotCapturable) {
+  BufferAllocation alloc(/*index=*/0, /*size=*/4, /*color=*/0);
+  BufferAllocation::Slice slice(&alloc, 0, 4);
+
+  ThunkSequence copy;
+  copy.emplace_back(std::make_unique<DeviceToDeviceCopyThunk>(
+      Thunk::ThunkInfo(), slice, slice, 4));
+  EXPECT_TRUE(IsCapturable(copy));
+
+  ThunkSequence infeed;
+  infeed.emplace_back(std::make_unique<InfeedThunk>(
+      Thunk::ThunkInfo(), std::vector<ShapedSlice>{}));
+  EXPECT_FALSE(IsCapturable(infeed));
+
+  // Host-dependent thunks are found in nested thunk sequences too.
+  ThunkSequence outfeed;
+  outfeed.emplace_back(std::make_unique<OutfeedThunk>(
+      Thunk::ThunkInfo(), std::vector<ShapedSlice>{}));
+  ThunkSequence nested;
+  nested.emplace_back(std::make_unique<DeviceToDeviceCopyThunk>(
+      Thunk::ThunkInfo(), slice, slice, 4));
+  nested.emplace_back(std::make_unique<SequentialThunk>(Thunk::ThunkInfo(),
+                                                        std::move(outfeed)));
+  EXPECT_FALSE(IsCapturable(nested));
+}
+
+TEST(CapturedProgramTest, RecapturesWhenAddressesChange) {
+  se::StreamExecutor* executor = GpuExecutor();
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, executor->CreateStream());
+
+  int64_t length = 4;
+  int64_t byte_length = sizeof(int32_t) * length;
+
+  se::DeviceMemory<int32_t> a = executor->AllocateArray<int32_t>(length, 0);
+  se::DeviceMemory<int32_t> b = executor->AllocateArray<int32_t>(length, 0);
+  se::DeviceMemory<int32_t> c = executor->AllocateArray<int32_t>(length, 0);
+  TF_ASSERT_OK(stream->Memset32(&a, 42, byte_length));
+  TF_ASSERT_OK(stream->MemZero(&b, byte_length));
+  TF_ASSERT_OK(stream->MemZero(&c, byte_length));
+
+  BufferAllocation alloc_a(/*index=*/0, byte_length, /*color=*/0);
+  BufferAllocation alloc_b(/*index=*/1, byte_length, /*color=*/0);
+  BufferAllocation::Slice slice_a(&alloc_a, 0, byte_length);
+  BufferAllocation::Slice slice_b(&alloc_b, 0, byte_length);
+
+  ThunkSequence thunks;
+  thunks.emplace_back(std::make_unique<DeviceToDeviceCopyThunk>(
+      Thunk::ThunkInfo(), slice_a, slice_b, byte_length));
+
+  se::StreamExecutorMemoryAllocator allocator(executor);
+  ServiceExecutableRunOptions run_options;
+  BufferAllocations allocations_ab({a, b}, 0, &allocator);
+  BufferAllocations allocations_ac({a, c}, 0, &allocator);
+
+  Thunk::ExecuteParams params_ab = Thunk::ExecuteParams::Create(
+      run_options, allocations_ab, stream.get(), stream.get(), nullptr,
+      nullptr);
+  Thunk::ExecuteParams params_ac =
+      Thunk::ExecuteParams::CloneWithNewAllocations(params_ab, allocations_ac);
+
+  CapturedProgram program;
+
+  // The first execution is always left to thunks.
+  TF_ASSERT_OK_AND_ASSIGN(bool submitted, program.Submit(thunks, params_ab));
+  EXPECT_FALSE(submitted);
+  EXPECT_EQ(program.num_captures(), 0);
+
+  std::vector<int32_t> dst(length, 0);
+  auto copied_to = [&](se::DeviceMemory<int32_t>& mem) {
+    TF_CHECK_OK(stream->BlockHostUntilDone());
+    TF_CHECK_OK(stream->Memcpy(dst.data(), mem, byte_length));
+    TF_CHECK_OK(stream->BlockHostUntilDone());
+    return dst == std::vector<int32_t>(length, 42);
+  };
+
+  TF_ASSERT_OK_AND_ASSIGN(submitted, program.Submit(thunks, params_ab));
+  EXPECT_TRUE(submitted);
+  EXPECT_EQ(program.num_captures(), 1);
+  EXPECT_TRUE(copied_to(b));
+
+  // Same addresses replay the captured command buffer.
+  TF_ASSERT_OK(stream->MemZero(&b, byte_length));
+  TF_ASSERT_OK_AND_ASSIGN(submitted, program.Submit(thunks, params_ab));
+  EXPECT_TRUE(submitted);
+  EXPECT_EQ(program.num_captures(), 1);
+  EXPECT_TRUE(copied_to(b));
+
+  // A new destination address forces a new capture that writes to it.
+  TF_ASSERT_OK(stream->MemZero(&b, byte_length));
+  TF_ASSERT_OK_AND_ASSIGN(submitted, program.Submit(thunks, params_ac));
+  EXPECT_TRUE(submitted);
+  EXPECT_EQ(program.num_captures(), 2);
+  EXPECT_TRUE(copied_to(c));
+  EXPECT_FALSE(copied_to(b));
+}
+
+TEST(CapturedProgramTest, FallsBackToThunksWhenCaptureFails) {
+  se::StreamExecutor* executor = GpuExecutor();
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, executor->CreateStream());
+
+  ThunkSequence thunks;
+  auto thunk = std::make_unique<CountingThunk>(
+      absl::InternalError("can't be captured"));
+  CountingThunk* counting_thunk = thunk.get();
+  thunks.push_back(std::move(thunk));
+
+  se::StreamExecutorMemoryAllocator allocator(executor);
+  ServiceExecutableRunOptions run_options;
+  BufferAllocations allocations({}, 0, &allocator);
+  Thunk::ExecuteParams params = Thunk::ExecuteParams::Create(
+      run_options, allocations, stream.get(), stream.get(), nullptr, nullptr);
+
+  CapturedProgram program;
+
+  TF_ASSERT_OK_AND_ASSIGN(bool submitted, program.Submit(thunks, params));
+  EXPECT_FALSE(submitted);
+  EXPECT_EQ(counting_thunk->num_executions(), 0);
+
+  // A failed capture is not an execution error: the caller runs thunks.
+  TF_ASSERT_OK_AND_ASSIGN(submitted, program.Submit(thunks, params));
+  EXPECT_FALSE(submitted);
+  EXPECT_EQ(counting_thunk->num_executions(), 1);
+  EXPECT_EQ(program.num_captures(), 0);
+
+  // Capture is not attempted again, and the stream is still usable.
+  TF_ASSERT_OK_AND_ASSIGN(submitted, program.Submit(thunks, params));
+  EXPECT_FALSE(submitted);
+  EXPECT_EQ(counting_thunk->num_executions(), 1);
+  TF_ASSERT_OK(stream->BlockHostUntilDone());
+}
+
+}  // namespace
+}  // namespace xla::gpu
@@ -0,0 +1,68 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/collective_memory_arena.h"
+
+#include <cstdint>
+
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/device_memory_allocator.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::gpu {
+
+absl::StatusOr<se::DeviceMemoryBase> CollectiveMemoryArena::Acquire(
+    se::DeviceMemoryAllocator* allocator, int device_ordinal, uint64_t size,
+    int64_t memory_space) {
+  absl::MutexLock lock(&mutex_);
+  Buffer& buffer = buffers_[device_ordinal];
+
+  // Concurrent executions on the same device fall back to allocating
+  // collective memory from the allocator.
+  if (buffer.in_use) return se::DeviceMemoryBase();
+
+  // (Re)allocate persistent collective memory if we don't have one yet, or if
+  // the executable runs with a different allocator.
+  if (buffer.memory.is_null() || buffer.memory.allocator() != allocator) {
+    buffer.memory = se::OwningDeviceMemory();
+    TF_ASSIGN_OR_RETURN(buffer.memory,
+                        allocator->Allocate(device_ordinal, size,
+                                            /*retry_on_failure=*/true,
+                                            memory_space));
+    VLOG(3) << "Allocated " << size
+            << " bytes of persistent collective memory on device #"
+            << device_ordinal;
+  }
+
+  buffer.in_use = true;
+  return *buffer.memory;
+}
+
+bool CollectiveMemoryArena::Release(int device_ordinal,
+                                    se::DeviceMemoryBase buffer) {
+  absl::MutexLock lock(&mutex_);
+  auto it = buffers_.find(device_ordinal);
+  if (it == buffers_.end() || !it->second.in_use ||
+      !buffer.IsSameAs(*it->second.memory)) {
+    return false;
+  }
+  it->second.in_use = false;
+  return true;
+}
+
+}  // namespace xla::gpu
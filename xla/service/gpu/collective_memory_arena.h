@@ -0,0 +1,65 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_COLLECTIVE_MEMORY_ARENA_H_
+#define XLA_SERVICE_GPU_COLLECTIVE_MEMORY_ARENA_H_
+
+#include <cstdint>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/device_memory_allocator.h"
+
+namespace xla::gpu {
+
+namespace se = ::stream_executor;
+
+// Temp buffers in the collective memory space that are kept alive across
+// executions of an executable, one per device, so that NCCL user buffer
+// registration happens once per communicator, and collectives always run on
+// registered buffers instead of registering every new chunk returned by the
+// collective memory allocator (see `xla_gpu_enable_nccl_user_buffers`).
+//
+// Only one execution at a time can use the buffer of a device. Concurrent
+// executions get a null buffer and must allocate their own temp buffer.
+class CollectiveMemoryArena {
+ public:
+  // Returns the persistent buffer for `device_ordinal`, allocating it from
+  // `allocator` on first use or if the executable now runs with a different
+  // allocator. Returns a null buffer if it is used by a concurrent execution.
+  absl::StatusOr<se::DeviceMemoryBase> Acquire(
+      se::DeviceMemoryAllocator* allocator, int device_ordinal, uint64_t size,
+      int64_t memory_space);
+
+  // Returns `buffer` to the arena if it is the persistent buffer acquired for
+  // `device_ordinal`. Returns false if `buffer` is not owned by the arena.
+  bool Release(int device_ordinal, se::DeviceMemoryBase buffer);
+
+ private:
+  struct Buffer {
+    se::OwningDeviceMemory memory;
+    bool in_use = false;
+  };
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<int, Buffer> buffers_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xla::gpu
+
+#endif  // XLA_SERVICE_GPU_COLLECTIVE_MEMORY_ARENA_H_
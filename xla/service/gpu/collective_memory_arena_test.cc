@@ -0,0 +1,199 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/collective_memory_arena.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/device_memory_allocator.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla::gpu {
+namespace {
+
+constexpr uint64_t kSize = 1024;
+constexpr int64_t kMemorySpace = 1;
+
+// Allocates host memory and counts allocations.
+class TestAllocator : public se::DeviceMemoryAllocator {
+ public:
+  TestAllocator() : se::DeviceMemoryAllocator(/*platform=*/nullptr) {}
+
+  ~TestAllocator() override {
+    if (!allocations_.empty()) {
+      ADD_FAILURE() << "Some allocations not freed!";
+    }
+  }
+
+  using se::DeviceMemoryAllocator::Allocate;
+
+  absl::StatusOr<se::OwningDeviceMemory> Allocate(
+      int device_ordinal, uint64_t size, bool /*retry_on_failure*/,
+      int64_t memory_space) override {
+    EXPECT_EQ(memory_space, kMemorySpace);
+    void* buf = malloc(size);
+    absl::MutexLock lock(&mutex_);
+    allocations_.insert(buf);
+    ++num_allocations_;
+    return se::OwningDeviceMemory(se::DeviceMemoryBase(buf, size),
+                                  device_ordinal, this);
+  }
+
+  absl::Status Deallocate(int device_ordinal,
+                          se::DeviceMemoryBase mem) override {
+    if (mem.is_null()) return absl::OkStatus();
+    absl::MutexLock lock(&mutex_);
+    if (!allocations_.erase(mem.opaque())) {
+      ADD_FAILURE() << "Allocation not found (double free?)";
+    }
+    free(mem.opaque());
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<se::Stream*> GetStream(int device_ordinal) override {
+    return absl::UnimplementedError("Not implemented");
+  }
+
+  int64_t num_allocations() {
+    absl::MutexLock lock(&mutex_);
+    return num_allocations_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_set<void*> allocations_ ABSL_GUARDED_BY(mutex_);
+  int64_t num_allocations_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+TEST(CollectiveMemoryArenaTest, ReusesBufferAcrossExecutions) {
+  TestAllocator allocator;
+  CollectiveMemoryArena arena;
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase first,
+                          arena.Acquire(&allocator, 0, kSize, kMemorySpace));
+  ASSERT_FALSE(first.is_null());
+  EXPECT_EQ(first.size(), kSize);
+  EXPECT_TRUE(arena.Release(0, first));
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase second,
+                          arena.Acquire(&allocator, 0, kSize, kMemorySpace));
+  EXPECT_TRUE(second.IsSameAs(first));
+  EXPECT_TRUE(arena.Release(0, second));
+  EXPECT_EQ(allocator.num_allocations(), 1);
+}
+
+TEST(CollectiveMemoryArenaTest, ConcurrentExecutionFallsBack) {
+  TestAllocator allocator;
+  CollectiveMemoryArena arena;
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase first,
+                          arena.Acquire(&allocator, 0, kSize, kMemorySpace));
+  ASSERT_FALSE(first.is_null());
+
+  // The buffer is still used by the first execution.
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase second,
+                          arena.Acquire(&allocator, 0, kSize, kMemorySpace));
+  EXPECT_TRUE(second.is_null());
+
+  // The fallback execution allocates its own buffer that the arena must not
+  // take ownership of.
+  TF_ASSERT_OK_AND_ASSIGN(
+      se::OwningDeviceMemory fallback,
+      allocator.Allocate(0, kSize, /*retry_on_failure=*/true, kMemorySpace));
+  EXPECT_FALSE(arena.Release(0, *fallback));
+
+  EXPECT_TRUE(arena.Release(0, first));
+  EXPECT_FALSE(arena.Release(0, first));
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase third,
+                          arena.Acquire(&allocator, 0, kSize, kMemorySpace));
+  EXPECT_TRUE(third.IsSameAs(first));
+  EXPECT_TRUE(arena.Release(0, third));
+}
+
+TEST(CollectiveMemoryArenaTest, KeepsBufferPerDevice) {
+  TestAllocator allocator;
+  CollectiveMemoryArena arena;
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase device0,
+                          arena.Acquire(&allocator, 0, kSize, kMemorySpace));
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase device1,
+                          arena.Acquire(&allocator, 1, kSize, kMemorySpace));
+  ASSERT_FALSE(device1.is_null());
+  EXPECT_FALSE(device1.IsSameAs(device0));
+
+  EXPECT_FALSE(arena.Release(1, device0));
+  EXPECT_TRUE(arena.Release(0, device0));
+  EXPECT_TRUE(arena.Release(1, device1));
+}
+
+TEST(CollectiveMemoryArenaTest, ReallocatesForNewAllocator) {
+  TestAllocator allocator0;
+  TestAllocator allocator1;
+  CollectiveMemoryArena arena;
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase first,
+                          arena.Acquire(&allocator0, 0, kSize, kMemorySpace));
+  EXPECT_TRUE(arena.Release(0, first));
+
+  TF_ASSERT_OK_AND_ASSIGN(se::DeviceMemoryBase second,
+                          arena.Acquire(&allocator1, 0, kSize, kMemorySpace));
+  EXPECT_TRUE(arena.Release(0, second));
+  EXPECT_EQ(allocator0.num_allocations(), 1);
+  EXPECT_EQ(allocator1.num_allocations(), 1);
+}
+
+TEST(CollectiveMemoryArenaTest, ConcurrentExecutionsNeverShareBuffer) {
+  TestAllocator allocator;
+  CollectiveMemoryArena arena;
+
+  std::atomic<int> num_holders = 0;
+  std::atomic<int> num_fallbacks = 0;
+  {
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "executions", 8);
+    for (int i = 0; i < 8; ++i) {
+      thread_pool.Schedule([&] {
+        for (int j = 0; j < 1000; ++j) {
+          absl::StatusOr<se::DeviceMemoryBase> buffer =
+              arena.Acquire(&allocator, 0, kSize, kMemorySpace);
+          ASSERT_TRUE(buffer.ok());
+          if (buffer->is_null()) {
+            ++num_fallbacks;
+            continue;
+          }
+          EXPECT_EQ(num_holders.fetch_add(1), 0);
+          num_holders.fetch_sub(1);
+          EXPECT_TRUE(arena.Release(0, *buffer));
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(allocator.num_allocations(), 1);
+  EXPECT_LT(num_fallbacks.load(), 8 * 1000);
+}
+
+}  // namespace
+}  // namespace xla::gpu
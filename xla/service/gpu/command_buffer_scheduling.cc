@@ -172,7 +172,8 @@ static bool IsCommand(const HloInstruction* hlo,
           &custom_call_adaptor->instruction());
       return IsCommand(custom_call, config);
     }
-    if (custom_config.name() == "dynamic_address_computation") {
+    if (custom_config.name() == "dynamic_address_computation" ||
+        custom_config.name() == "paged_address_computation") {
       return false;
     }
     return config.enabled_commands.contains(DebugOptions::FUSION);
@@ -212,12 +213,14 @@ static bool IsCommand(const HloInstruction* hlo,
 static bool IsAsyncStartCommand(const HloInstruction* hlo,
                                 const CommandBufferConfig& config) {
   if (hlo->opcode() == HloOpcode::kAllReduceStart ||
-      hlo->opcode() == HloOpcode::kAllGatherStart) {
+      hlo->opcode() == HloOpcode::kAllGatherStart ||
+      hlo->opcode() == HloOpcode::kCollectivePermuteStart) {
     return config.enabled_commands.contains(DebugOptions::COLLECTIVES);
   }
 
   if (hlo->opcode() == HloOpcode::kAsyncStart) {
-    if (hlo->async_wrapped_opcode() == HloOpcode::kReduceScatter) {
+    if (hlo->async_wrapped_opcode() == HloOpcode::kReduceScatter ||
+        hlo->async_wrapped_opcode() == HloOpcode::kAllToAll) {
       return config.enabled_commands.contains(DebugOptions::COLLECTIVES);
     }
   }
@@ -228,12 +231,14 @@ static bool IsAsyncStartCommand(const HloInstruction* hlo,
 static bool IsAsyncDoneCommand(const HloInstruction* hlo,
                                const CommandBufferConfig& config) {
   if (hlo->opcode() == HloOpcode::kAllReduceDone ||
-      hlo->opcode() == HloOpcode::kAllGatherDone) {
+      hlo->opcode() == HloOpcode::kAllGatherDone ||
+      hlo->opcode() == HloOpcode::kCollectivePermuteDone) {
     return config.enabled_commands.contains(DebugOptions::COLLECTIVES);
   }
 
   if (hlo->opcode() == HloOpcode::kAsyncDone) {
-    if (hlo->async_wrapped_opcode() == HloOpcode::kReduceScatter) {
+    if (hlo->async_wrapped_opcode() == HloOpcode::kReduceScatter ||
+        hlo->async_wrapped_opcode() == HloOpcode::kAllToAll) {
       return config.enabled_commands.contains(DebugOptions::COLLECTIVES);
     }
   }
@@ -244,7 +249,8 @@ static bool IsAsyncDoneCommand(const HloInstruction* hlo,
 // Finds an async-done HLO operation corresponding on an async-start one.
 static HloInstruction* FindAsyncDoneCommand(const HloInstruction* start) {
   if (start->opcode() == HloOpcode::kAllReduceStart ||
-      start->opcode() == HloOpcode::kAllGatherStart) {
+      start->opcode() == HloOpcode::kAllGatherStart ||
+      start->opcode() == HloOpcode::kCollectivePermuteStart) {
     CHECK(start->users().size() == 1);  // NOLINT, checked by HLO verifier
     return start->users().front();
   } else if (start->opcode() == HloOpcode::kAsyncStart) {
@@ -296,15 +302,21 @@ CommandBufferScheduling::CollectCommandBufferSequences(
 
   HloInstructionSequence current_seq;
   int64_t num_commands_in_current_seq = 0;
+  bool current_seq_has_control_flow = false;
 
-  // Adds `current_seq` to `sequences` if it has enough commands in it.
+  // Adds `current_seq` to `sequences` if it has enough commands in it. Control
+  // flow commands evaluate their predicates on device instead of synchronizing
+  // with the host, e.g. on every loop iteration, so they are worth a command
+  // buffer of their own.
   auto collect_current_seq = [&]() {
-    if (num_commands_in_current_seq >= std::max(1, min_num_commands)) {
+    if (num_commands_in_current_seq >= std::max(1, min_num_commands) ||
+        current_seq_has_control_flow) {
       RemoveTrailingNoOps(current_seq);
       sequences.push_back(std::move(current_seq));
     }
     current_seq = HloInstructionSequence();
     num_commands_in_current_seq = 0;
+    current_seq_has_control_flow = false;
   };
 
   auto& instructions = schedule.instructions();
@@ -381,6 +393,9 @@ CommandBufferScheduling::CollectCommandBufferSequences(
     // Synchronous commands always can be added to instruction sequence.
     if (IsCommand(inst, config)) {
       num_commands_in_current_seq++;
+      current_seq_has_control_flow |=
+          inst->opcode() == HloOpcode::kWhile ||
+          inst->opcode() == HloOpcode::kConditional;
       current_seq.push_back(inst);
       continue;
     }
@@ -301,6 +301,76 @@ TEST_F(CommandBufferSchedulingTest, ReduceScatterStartFollowedByDone) {
       });
 }
 
+TEST_F(CommandBufferSchedulingTest, AllToAllStartFollowedByDone) {
+  const char* hlo = R"(
+    HloModule TestModule, is_scheduled=true
+
+    ENTRY %main (a: s32[4]) -> s32[4] {
+      %a = s32[4] parameter(0)
+
+      %start = ((s32[4]{0}), s32[4]{0}) all-to-all-start(%a),
+        channel_id=555, replica_groups={{0,1}}, dimensions={0},
+        backend_config={"collective_backend_config": {"is_sync":true,"no_parallel_custom_call":false}}
+
+      ROOT %done = s32[4]{0} all-to-all-done(%start)
+    })";
+
+  const char* expected = R"(
+    CHECK: %command_buffer ([[P0:.+]]: s32[4]) -> s32[4] {
+    CHECK:   %[[P0]] = s32[4]{0} parameter(0)
+    CHECK:   %[[START:.+]] = {{.*}} all-to-all-start(%[[P0]])
+    CHECK:   ROOT %[[DONE:.+]] = s32[4]{0} all-to-all-done(%[[START]])
+    CHECK: }
+
+    CHECK: ENTRY %main (a: s32[4]) -> s32[4] {
+    CHECK:   %[[A:.+]] = s32[4]{0} parameter(0)
+    CHECK:   ROOT %[[CALL:.+]] = s32[4]{0} call(%[[A]]),
+    CHECK:     to_apply=%command_buffer
+    CHECK: })";
+
+  RunAndFilecheckHloRewrite(
+      hlo, CommandBufferScheduling(device_desc(), kCudaVersion, kCudaVersion),
+      expected, [](HloModule* module) {
+        EXPECT_TRUE(module->has_schedule());
+        TF_CHECK_OK(module->schedule().Verify());
+      });
+}
+
+TEST_F(CommandBufferSchedulingTest, CollectivePermuteStartFollowedByDone) {
+  const char* hlo = R"(
+    HloModule TestModule, is_scheduled=true
+
+    ENTRY %main (a: s32[4]) -> s32[4] {
+      %a = s32[4] parameter(0)
+
+      %start = (s32[4]{0}, s32[4]{0}, u32[], u32[]) collective-permute-start(%a),
+        channel_id=555, source_target_pairs={{0,1},{1,0}},
+        backend_config={"collective_backend_config": {"is_sync":true,"no_parallel_custom_call":false}}
+
+      ROOT %done = s32[4]{0} collective-permute-done(%start)
+    })";
+
+  const char* expected = R"(
+    CHECK: %command_buffer ([[P0:.+]]: s32[4]) -> s32[4] {
+    CHECK:   %[[P0]] = s32[4]{0} parameter(0)
+    CHECK:   %[[START:.+]] = {{.*}} collective-permute-start(%[[P0]])
+    CHECK:   ROOT %[[DONE:.+]] = s32[4]{0} collective-permute-done(%[[START]])
+    CHECK: }
+
+    CHECK: ENTRY %main (a: s32[4]) -> s32[4] {
+    CHECK:   %[[A:.+]] = s32[4]{0} parameter(0)
+    CHECK:   ROOT %[[CALL:.+]] = s32[4]{0} call(%[[A]]),
+    CHECK:     to_apply=%command_buffer
+    CHECK: })";
+
+  RunAndFilecheckHloRewrite(
+      hlo, CommandBufferScheduling(device_desc(), kCudaVersion, kCudaVersion),
+      expected, [](HloModule* module) {
+        EXPECT_TRUE(module->has_schedule());
+        TF_CHECK_OK(module->schedule().Verify());
+      });
+}
+
 TEST_F(CommandBufferSchedulingTest, AllReduceStartFollowedByBitcast) {
   const char* hlo = R"(
     HloModule TestModule, is_scheduled=true
@@ -880,6 +950,62 @@ TEST_F(CommandBufferSchedulingTest, While) {
       });
 }
 
+TEST_F(CommandBufferSchedulingTest, CollectWhileBelowMinGraphSize) {
+  const char* hlo = R"(
+    HloModule TestModule, is_scheduled=true
+
+    %fused_computation (param_0: f32[1], param_1: f32[1]) -> f32[1] {
+      %param_0 = f32[1]{0} parameter(0)
+      %param_1 = f32[1]{0} parameter(1)
+      ROOT %add = f32[1]{0} add(f32[1]{0} %param_0, f32[1]{0} %param_1)
+    }
+
+    %fused_computation.1 (param_0: f32[1], param_1: f32[1]) -> pred[1] {
+      %param_0 = f32[1]{0} parameter(0)
+      %param_1 = f32[1]{0} parameter(1)
+      ROOT %compare = pred[1]{0} compare(f32[1]{0} %param_0, f32[1]{0} %param_1), direction=LT
+    }
+
+    %body (p: f32[1]) -> f32[1] {
+      %one = f32[1]{0} constant({1})
+      %p = f32[1]{0} parameter(0)
+      ROOT %add = f32[1]{0} fusion(f32[1]{0} %p, f32[1]{0} %one), kind=kLoop, calls=%fused_computation
+    }
+
+    %cond (p: f32[1]) -> pred[] {
+      %limit = f32[1]{0} constant({100})
+      %p = f32[1]{0} parameter(0)
+      %compare = pred[1]{0} fusion(f32[1]{0} %p, f32[1]{0} %limit), kind=kLoop, calls=%fused_computation.1
+      ROOT %bitcast = pred[] bitcast(pred[1]{0} %compare)
+    }
+
+    ENTRY %main (a: f32[1]) -> f32[1] {
+      %a = f32[1]{0} parameter(0)
+      ROOT %while = f32[1]{0} while(f32[1]{0} %a), condition=%cond, body=%body
+    })";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(hlo));
+
+  HloInstructionSequence seq;
+  for (HloInstruction* x : module->entry_computation()->instructions()) {
+    seq.push_back(x);
+  }
+
+  CommandBufferScheduling::CommandBufferConfig config{
+      {DebugOptions::FUSION, DebugOptions::CONDITIONALS}, device_desc()};
+
+  // A single loop is captured despite the minimum of 5 commands, so that its
+  // condition is evaluated on device.
+  std::vector<HloInstructionSequence> command_buffer_sequences =
+      CommandBufferScheduling::CollectCommandBufferSequences(
+          seq, config, /*min_num_commands=*/5);
+  ASSERT_EQ(command_buffer_sequences.size(), 1);
+  ASSERT_EQ(command_buffer_sequences[0].size(), 1);
+  EXPECT_EQ(command_buffer_sequences[0].instructions()[0]->opcode(),
+            HloOpcode::kWhile);
+}
+
 TEST_F(CommandBufferSchedulingTest, Conditional) {
   const char* hlo = R"(
     HloModule TestModule, is_scheduled=true
@@ -189,7 +189,11 @@ absl::StatusOr<CompileModuleResults> CompileModuleToLlvmIr(
           << results.buffer_assignment->GetStats().ToString();
 
   results.execution_stream_assignment =
-      std::make_unique<ExecutionStreamAssignment>(hlo_module);
+      std::make_unique<ExecutionStreamAssignment>(
+          hlo_module, ExecutionStreamAssignmentOptions{
+                          hlo_module->config()
+                              .debug_options()
+                              .xla_gpu_concurrent_fusion_streams()});
 
   struct GetCcStr {
     std::string operator()(const se::CudaComputeCapability& cc) const {
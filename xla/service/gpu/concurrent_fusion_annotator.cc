@@ -0,0 +1,182 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/service/gpu/concurrent_fusion_annotator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/hlo/ir/hlo_reachability.h"
+#include "xla/service/call_graph.h"
+#include "xla/service/gpu/backend_configs.pb.h"
+#include "xla/service/gpu/hlo_fusion_analysis.h"
+#include "xla/service/gpu/launch_dimensions.h"
+#include "xla/service/gpu/model/gpu_performance_model_base.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "xla/stream_executor/device_description.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+// Fusions that keep more than this fraction of the device's resident threads
+// busy don't leave enough room for a concurrent kernel.
+constexpr double kMaxOccupancy = 0.5;
+
+bool IsSmallFusion(const HloInstruction* instr,
+                   const se::DeviceDescription& device_info) {
+  if (instr->opcode() != HloOpcode::kFusion ||
+      (instr->fusion_kind() != HloInstruction::FusionKind::kLoop &&
+       instr->fusion_kind() != HloInstruction::FusionKind::kInput) ||
+      instr->HasControlDependencies()) {
+    return false;
+  }
+  auto gpu_config = instr->backend_config<GpuBackendConfig>();
+  if (!gpu_config.ok() || gpu_config->operation_queue_id() !=
+                              Thunk::kDefaultExecutionStreamId.value()) {
+    return false;
+  }
+
+  HloFusionAnalysis analysis = AnalyzeFusion(*instr, device_info);
+  LaunchDimensions launch_dimensions =
+      GpuPerformanceModelBase::EstimateFusionLaunchDimensions(analysis);
+  double resident_threads = static_cast<double>(device_info.core_count()) *
+                            device_info.threads_per_core_limit();
+  return launch_dimensions.launch_bound() < kMaxOccupancy * resident_threads;
+}
+
+using Chain = std::vector<HloInstruction*>;
+
+// Returns chains of small fusions in `computation` in post order of their
+// first fusion.
+std::vector<Chain> FindChains(HloComputation* computation,
+                              const se::DeviceDescription& device_info) {
+  std::vector<Chain> chains;
+  // Maps the last fusion of a chain to the chain index.
+  absl::flat_hash_map<const HloInstruction*, int64_t> chain_ends;
+
+  for (HloInstruction* instr : computation->MakeInstructionPostOrder()) {
+    if (!IsSmallFusion(instr, device_info)) continue;
+
+    // A fusion extends the chain of its producer if it is the only user of
+    // the producer. Fusions that join several chains start a new chain.
+    std::vector<HloInstruction*> producers;
+    for (HloInstruction* operand : instr->unique_operands()) {
+      if (chain_ends.contains(operand) && operand->user_count() == 1) {
+        producers.push_back(operand);
+      }
+    }
+    int64_t chain;
+    if (producers.size() == 1) {
+      chain = chain_ends[producers.front()];
+      chain_ends.erase(producers.front());
+    } else {
+      chain = chains.size();
+      chains.emplace_back();
+    }
+    chains[chain].push_back(instr);
+    chain_ends[instr] = chain;
+  }
+  return chains;
+}
+
+}  // namespace
+
+absl::StatusOr<bool> ConcurrentFusionAnnotator::RunOnComputation(
+    HloComputation* computation) {
+  std::vector<Chain> chains = FindChains(computation, device_info_);
+  if (chains.size() < 2) return false;
+
+  std::unique_ptr<HloReachabilityMap> reachability =
+      HloReachabilityMap::Build(computation);
+
+  // Fusions within a chain depend on each other, so two chains are
+  // independent if the first fusion of neither chain is connected to the last
+  // fusion of the other.
+  auto independent = [&](const Chain& a, const Chain& b) {
+    return !reachability->IsConnected(a.front(), b.back()) &&
+           !reachability->IsConnected(b.front(), a.back());
+  };
+
+  bool changed = false;
+  auto assign_streams = [&](const std::vector<size_t>& group) -> absl::Status {
+    // The first chain of a group stays on the default stream.
+    for (size_t i = 1; i < group.size(); ++i) {
+      for (HloInstruction* fusion : chains[group[i]]) {
+        TF_ASSIGN_OR_RETURN(GpuBackendConfig gpu_config,
+                            fusion->backend_config<GpuBackendConfig>());
+        gpu_config.set_operation_queue_id(i);
+        TF_RETURN_IF_ERROR(fusion->set_backend_config(gpu_config));
+        VLOG(3) << "Assigned " << fusion->name() << " to stream " << i;
+      }
+      changed = true;
+    }
+    return absl::OkStatus();
+  };
+
+  std::vector<size_t> group;
+  for (size_t chain = 0; chain < chains.size(); ++chain) {
+    bool fits = static_cast<int64_t>(group.size()) <= num_streams_ &&
+                absl::c_all_of(group, [&](size_t other) {
+                  return independent(chains[chain], chains[other]);
+                });
+    if (!fits) {
+      TF_RETURN_IF_ERROR(assign_streams(group));
+      group.clear();
+    }
+    group.push_back(chain);
+  }
+  TF_RETURN_IF_ERROR(assign_streams(group));
+  return changed;
+}
+
+absl::StatusOr<bool> ConcurrentFusionAnnotator::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  if (num_streams_ <= 0) return false;
+
+  std::unique_ptr<CallGraph> call_graph = CallGraph::Build(module);
+  bool changed = false;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    // Computations called in an embedded context (e.g. reduction
+    // computations) are not launched as kernels.
+    if (computation->IsAsyncComputation() ||
+        call_graph->GetNode(computation).context() !=
+            CallContext::kControlFlow) {
+      continue;
+    }
+    TF_ASSIGN_OR_RETURN(bool result, RunOnComputation(computation));
+    changed |= result;
+  }
+  return changed;
+}
+
+}  // namespace xla::gpu
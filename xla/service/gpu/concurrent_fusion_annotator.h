@@ -0,0 +1,68 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#ifndef XLA_SERVICE_GPU_CONCURRENT_FUSION_ANNOTATOR_H_
+#define XLA_SERVICE_GPU_CONCURRENT_FUSION_ANNOTATOR_H_
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_pass_interface.h"
+#include "xla/stream_executor/device_description.h"
+
+namespace xla::gpu {
+
+// Annotates independent chains of small fusions with non-default
+// "operation_queue_id" attributes, so that they run concurrently on
+// additional execution streams.
+//
+// A fusion is small if its estimated launch dimensions occupy less than half
+// of the threads the device can keep resident, so that a kernel from an
+// independent chain can run next to it. A chain is a sequence of small
+// fusions where every fusion is the only user of its predecessor. Chains that
+// don't depend on each other are grouped together, and all but the first
+// chain of a group are assigned to one of `num_streams` additional streams.
+//
+// The annotated fusions are wrapped into async computations by the
+// StreamAttributeAsyncWrapper pass, and the IR emitter synchronizes the
+// streams with WaitForStreams thunks at async starts and dones.
+class ConcurrentFusionAnnotator : public HloModulePass {
+ public:
+  ConcurrentFusionAnnotator(const se::DeviceDescription& device_info,
+                            int num_streams)
+      : device_info_(device_info), num_streams_(num_streams) {}
+
+  absl::string_view name() const override {
+    return "concurrent-fusion-annotator";
+  }
+
+  using HloPassInterface::Run;
+  absl::StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation);
+
+  const se::DeviceDescription& device_info_;
+  int num_streams_;
+};
+
+}  // namespace xla::gpu
+
+#endif  // XLA_SERVICE_GPU_CONCURRENT_FUSION_ANNOTATOR_H_
@@ -0,0 +1,158 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/service/gpu/concurrent_fusion_annotator.h"
+
+#include <cstdint>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/gpu/backend_configs.pb.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+class ConcurrentFusionAnnotatorTest : public HloTestBase {
+ protected:
+  int64_t OperationQueueId(const HloModule* module, absl::string_view name) {
+    const HloInstruction* instr = FindInstruction(module, name);
+    return instr->backend_config<GpuBackendConfig>()->operation_queue_id();
+  }
+
+  se::DeviceDescription device_info_ = TestGpuDeviceInfo::RTXA6000DeviceInfo();
+};
+
+TEST_F(ConcurrentFusionAnnotatorTest, AnnotatesIndependentChains) {
+  constexpr absl::string_view kHlo = R"(
+  HloModule m
+
+  negate_a {
+    p = f32[1024] parameter(0)
+    ROOT negate = f32[1024] negate(p)
+  }
+  exp_a {
+    p = f32[1024] parameter(0)
+    ROOT exp = f32[1024] exponential(p)
+  }
+  negate_b {
+    p = f32[1024] parameter(0)
+    ROOT negate = f32[1024] negate(p)
+  }
+  exp_b {
+    p = f32[1024] parameter(0)
+    ROOT exp = f32[1024] exponential(p)
+  }
+  join {
+    p0 = f32[1024] parameter(0)
+    p1 = f32[1024] parameter(1)
+    ROOT add = f32[1024] add(p0, p1)
+  }
+
+  ENTRY entry {
+    p0 = f32[1024] parameter(0)
+    p1 = f32[1024] parameter(1)
+    a1 = f32[1024] fusion(p0), kind=kLoop, calls=negate_a
+    a2 = f32[1024] fusion(a1), kind=kLoop, calls=exp_a
+    b1 = f32[1024] fusion(p1), kind=kLoop, calls=negate_b
+    b2 = f32[1024] fusion(b1), kind=kLoop, calls=exp_b
+    ROOT out = f32[1024] fusion(a2, b2), kind=kLoop, calls=join
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  ConcurrentFusionAnnotator annotator(device_info_, /*num_streams=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, annotator.Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  // One chain stays on the default stream and the other one runs next to it.
+  EXPECT_EQ(OperationQueueId(module.get(), "a1"), 0);
+  EXPECT_EQ(OperationQueueId(module.get(), "a2"), 0);
+  EXPECT_EQ(OperationQueueId(module.get(), "b1"), 1);
+  EXPECT_EQ(OperationQueueId(module.get(), "b2"), 1);
+  EXPECT_EQ(OperationQueueId(module.get(), "out"), 0);
+}
+
+TEST_F(ConcurrentFusionAnnotatorTest, IgnoresDependentFusions) {
+  constexpr absl::string_view kHlo = R"(
+  HloModule m
+
+  negate {
+    p = f32[1024] parameter(0)
+    ROOT negate = f32[1024] negate(p)
+  }
+  exp {
+    p = f32[1024] parameter(0)
+    ROOT exp = f32[1024] exponential(p)
+  }
+  join {
+    p0 = f32[1024] parameter(0)
+    p1 = f32[1024] parameter(1)
+    ROOT add = f32[1024] add(p0, p1)
+  }
+
+  ENTRY entry {
+    p0 = f32[1024] parameter(0)
+    a = f32[1024] fusion(p0), kind=kLoop, calls=negate
+    b = f32[1024] fusion(a), kind=kLoop, calls=exp
+    ROOT out = f32[1024] fusion(a, b), kind=kLoop, calls=join
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  ConcurrentFusionAnnotator annotator(device_info_, /*num_streams=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, annotator.Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(ConcurrentFusionAnnotatorTest, IgnoresFusionsThatFillTheDevice) {
+  constexpr absl::string_view kHlo = R"(
+  HloModule m
+
+  negate_a {
+    p = f32[16384,1024] parameter(0)
+    ROOT negate = f32[16384,1024] negate(p)
+  }
+  negate_b {
+    p = f32[16384,1024] parameter(0)
+    ROOT negate = f32[16384,1024] negate(p)
+  }
+  join {
+    p0 = f32[16384,1024] parameter(0)
+    p1 = f32[16384,1024] parameter(1)
+    ROOT add = f32[16384,1024] add(p0, p1)
+  }
+
+  ENTRY entry {
+    p0 = f32[16384,1024] parameter(0)
+    p1 = f32[16384,1024] parameter(1)
+    a = f32[16384,1024] fusion(p0), kind=kLoop, calls=negate_a
+    b = f32[16384,1024] fusion(p1), kind=kLoop, calls=negate_b
+    ROOT out = f32[16384,1024] fusion(a, b), kind=kLoop, calls=join
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  ConcurrentFusionAnnotator annotator(device_info_, /*num_streams=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, annotator.Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+}  // namespace
+}  // namespace xla::gpu
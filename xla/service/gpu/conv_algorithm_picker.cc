@@ -29,12 +29,14 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xla/autotuning.pb.h"
@@ -248,6 +250,22 @@ absl::StatusOr<std::vector<GenericConvRunner>> GetAlgorithms(
   return result;
 }
 
+se::NumericOptions GetNumericOptions(const HloCustomCallInstruction* instr,
+                                     const DebugOptions& debug_options) {
+  const bool deterministic_ops =
+      debug_options.xla_gpu_deterministic_ops() ||
+      debug_options.xla_gpu_exclude_nondeterministic_ops();
+  bool allow_tf32 = true;
+  // TODO(b/284371623): Properly set allow_tf32 even if instr==nullptr, which is
+  // the case when running an AOT compiled executable with runtime autotuning.
+  if (instr) {
+    allow_tf32 = absl::c_all_of(
+        instr->precision_config().operand_precision(),
+        [](int precision) { return precision <= PrecisionConfig::HIGH; });
+  }
+  return se::NumericOptions{deterministic_ops, allow_tf32};
+}
+
 absl::StatusOr<std::vector<std::unique_ptr<const se::dnn::ConvRunner>>>
 GetMIOpenAlgorithms(const HloCustomCallInstruction* instr,
                     absl::Span<se::DeviceMemoryBase> operand_buffers,
@@ -819,18 +837,8 @@ GpuConvAlgorithmPicker::PickBestAlgorithmNoCacheCuda(
 
   const bool cudnn_frontend_enabled =
       debug_options.xla_gpu_enable_cudnn_frontend();
-  const bool deterministic_ops =
-      debug_options.xla_gpu_deterministic_ops() ||
-      debug_options.xla_gpu_exclude_nondeterministic_ops();
-  bool allow_tf32 = true;
-  // TODO(b/284371623): Properly set allow_tf32 even if instr==nullptr, which is
-  // the case when running an AOT compiled executable with runtime autotuning.
-  if (instr) {
-    allow_tf32 = absl::c_all_of(
-        instr->precision_config().operand_precision(),
-        [](int precision) { return precision <= PrecisionConfig::HIGH; });
-  }
-  const se::NumericOptions numeric_options{deterministic_ops, allow_tf32};
+  const se::NumericOptions numeric_options =
+      GetNumericOptions(instr, debug_options);
 
   // Use the first algorithm that's supported as reference. There isn't a
   // particular reason to use it, as any algorithm suffices. It doesn't make
@@ -838,11 +846,16 @@ GpuConvAlgorithmPicker::PickBestAlgorithmNoCacheCuda(
   std::optional<ReferenceResult> reference_result;
 
   TF_ASSIGN_OR_RETURN(se::Stream* const stream, config_.GetStream());
-  TF_ASSIGN_OR_RETURN(
-      std::vector<GenericConvRunner> runners,
-      GetAlgorithms(runtime_arguments.gpu_conv_config, stream,
-                    cudnn_frontend_enabled,
-                    /* use_fallback = */ false, numeric_options));
+  std::vector<GenericConvRunner> runners;
+  if (auto it = prebuilt_runners_.find(instr); it != prebuilt_runners_.end()) {
+    it->second->done.WaitForNotification();
+    TF_ASSIGN_OR_RETURN(runners, std::move(it->second->runners));
+  } else {
+    TF_ASSIGN_OR_RETURN(
+        runners, GetAlgorithms(runtime_arguments.gpu_conv_config, stream,
+                               cudnn_frontend_enabled,
+                               /* use_fallback = */ false, numeric_options));
+  }
 
   std::vector<AutotuneResult> profile_results;
   for (auto& runner_cache : runners) {
@@ -921,6 +934,55 @@ GpuConvAlgorithmPicker::PickBestAlgorithmNoCacheCuda(
                                      runtime_arguments.hlo_module_config));
   return selected_algorithm;
 }
+
+void GpuConvAlgorithmPicker::PrebuildRunners(
+    absl::Span<HloInstruction* const> convs) {
+  if (thread_pool_ == nullptr || thread_pool_->NumThreads() <= 1 ||
+      config_.IsDeviceless() ||
+      config_.GetExecutor()->GetPlatform()->id() != se::cuda::kCudaPlatformId) {
+    return;
+  }
+  absl::StatusOr<se::Stream*> stream = config_.GetStream();
+  if (!stream.ok()) {
+    return;
+  }
+
+  for (HloInstruction* instr : convs) {
+    const auto* conv = Cast<HloCustomCallInstruction>(instr);
+    // Cached convolutions are not profiled, so they don't need any runners.
+    absl::StatusOr<bool> in_cache =
+        AutotunerUtil::IsInCache(AutotunerUtil::GetKey(conv, config_), config_);
+    if (!in_cache.ok() || *in_cache) {
+      continue;
+    }
+    absl::StatusOr<GpuConvConfig> gpu_conv_config = GetGpuConvConfig(conv);
+    if (!gpu_conv_config.ok()) {
+      continue;
+    }
+    auto [it, inserted] =
+        prebuilt_runners_.emplace(conv, std::make_unique<PrebuiltRunners>());
+    if (!inserted) {
+      continue;
+    }
+    // The task must not access `conv`, which may be replaced before the task
+    // runs if an identical convolution has been autotuned in the meantime.
+    const DebugOptions& debug_options =
+        conv->GetModule()->config().debug_options();
+    thread_pool_->Schedule(
+        [prebuilt = it->second.get(), stream = *stream,
+         gpu_conv_config = *std::move(gpu_conv_config),
+         cudnn_frontend_enabled = debug_options.xla_gpu_enable_cudnn_frontend(),
+         numeric_options = GetNumericOptions(conv, debug_options)] {
+          prebuilt->runners = GetAlgorithms(gpu_conv_config, stream,
+                                            cudnn_frontend_enabled,
+                                            /* use_fallback = */ false,
+                                            numeric_options);
+          prebuilt->done.Notify();
+        });
+  }
+  VLOG(2) << "Building cuDNN runners for " << prebuilt_runners_.size()
+          << " convolutions in parallel";
+}
 #endif
 
 absl::StatusOr<AutotuneResult>
@@ -1186,6 +1248,28 @@ absl::StatusOr<bool> GpuConvAlgorithmPicker::Run(
     return false;
   }
 
+#if (defined(GOOGLE_CUDA) && GOOGLE_CUDA)
+  // Building the cuDNN plans of the candidate algorithms doesn't need the GPU,
+  // so do it for all convolutions upfront on the thread pool, while the
+  // convolutions are profiled one after another.
+  std::vector<HloInstruction*> convs;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    for (HloInstruction* instr : computation->instructions()) {
+      if (IsCandidate(instr)) {
+        convs.push_back(instr);
+      }
+    }
+  }
+  PrebuildRunners(convs);
+  absl::Cleanup wait_for_prebuilt_runners = [&] {
+    for (auto& [instr, prebuilt] : prebuilt_runners_) {
+      prebuilt->done.WaitForNotification();
+    }
+    prebuilt_runners_.clear();
+  };
+#endif
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
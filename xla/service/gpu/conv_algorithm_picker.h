@@ -16,13 +16,16 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_CONV_ALGORITHM_PICKER_H_
 #define XLA_SERVICE_GPU_CONV_ALGORITHM_PICKER_H_
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
 #include "absl/types/span.h"
 #include "xla/autotune_results.pb.h"
 #include "xla/autotuning.pb.h"
@@ -41,6 +44,7 @@ limitations under the License.
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/dnn.h"
 #include "xla/stream_executor/stream_executor.h"
+#include "tsl/platform/threadpool.h"
 
 #if (defined(GOOGLE_CUDA) && GOOGLE_CUDA)
 #include "xla/stream_executor/gpu/redzone_allocator.h"
@@ -85,7 +89,11 @@ namespace gpu {
 // result is not stored, then the performance of convolution will be suboptimal.
 class GpuConvAlgorithmPicker : public HloModulePass {
  public:
-  explicit GpuConvAlgorithmPicker(AutotuneConfig config) : config_(config) {}
+  // If `thread_pool` is not null, the cuDNN runners of the candidate
+  // algorithms are built on it, while profiling stays serialized.
+  explicit GpuConvAlgorithmPicker(
+      AutotuneConfig config, tsl::thread::ThreadPool* thread_pool = nullptr)
+      : config_(config), thread_pool_(thread_pool) {}
 
   absl::string_view name() const override {
     return "gpu-conv-algorithm-picker";
@@ -145,6 +153,20 @@ class GpuConvAlgorithmPicker : public HloModulePass {
   // Pick the best algorithm for CUDA platform.
   absl::StatusOr<AutotuneResult> PickBestAlgorithmNoCacheCuda(
       const HloCustomCallInstruction* instr);
+
+  // Runners of the non-fallback algorithms of a convolution, built on the
+  // thread pool.
+  struct PrebuiltRunners {
+    absl::Notification done;
+    absl::StatusOr<std::vector<GenericConvRunner>> runners;
+  };
+
+  // Starts building the runners of the convolutions among `convs` which are
+  // not in the autotune cache on the thread pool, if there is one.
+  void PrebuildRunners(absl::Span<HloInstruction* const> convs);
+
+  absl::flat_hash_map<const HloInstruction*, std::unique_ptr<PrebuiltRunners>>
+      prebuilt_runners_;
 #endif
 
   absl::StatusOr<AutotuneResult> PickBestAlgorithmNoCacheRocm(
@@ -152,6 +174,7 @@ class GpuConvAlgorithmPicker : public HloModulePass {
 
  private:
   AutotuneConfig config_;
+  tsl::thread::ThreadPool* thread_pool_;
 };
 
 }  // namespace gpu
@@ -33,8 +33,10 @@ limitations under the License.
 #include "xla/stream_executor/platform.h"
 #include "xla/tests/hlo_test_base.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla::gpu {
 namespace {
@@ -125,5 +127,37 @@ ENTRY main {
   }
 }
 
+TEST_F(GpuConvAlgorithmPickerTest, BuildsRunnersOnThreadPool) {
+  constexpr absl::string_view kHlo = R"(
+HloModule module
+
+ENTRY main {
+  %arg0 = f32[3,56,56,16]{2,1,0,3} parameter(0)
+  %arg1 = f32[3,3,3,64]{2,1,0,3} parameter(1)
+  %arg2 = f32[3,5,5,64]{2,1,0,3} parameter(2)
+  %conv0 = f32[54,54,16,64]{1,0,3,2} convolution(%arg0, %arg1), window={size=3x3}, dim_labels=f01b_i01o->01bf
+  %conv1 = f32[52,52,16,64]{1,0,3,2} convolution(%arg0, %arg2), window={size=5x5}, dim_labels=f01b_i01o->01bf
+  ROOT %tuple = (f32[54,54,16,64]{1,0,3,2}, f32[52,52,16,64]{1,0,3,2}) tuple(%conv0, %conv1)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto m, ParseAndReturnVerifiedModule(kHlo));
+
+  se::StreamExecutor* stream_exec = backend().default_stream_executor();
+  const se::GpuComputeCapability& cc =
+      stream_exec->GetDeviceDescription().gpu_compute_capability();
+  TF_ASSERT_OK(RunHloPass(GpuConvRewriter(cc), m.get()).status());
+
+  DebugOptions opts = DefaultDebugOptionsIgnoringFlags();
+  AutotuneConfig cfg{DeviceConfig{stream_exec, nullptr}, opts};
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 4);
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      RunHloPass(GpuConvAlgorithmPicker(cfg, &thread_pool), m.get()));
+  EXPECT_TRUE(changed);
+
+  AutotuneResults results;
+  TF_ASSERT_OK(AutotunerUtil::SerializeAutotuneResults(&results));
+  EXPECT_EQ(results.results_size(), 2);
+}
+
 }  // namespace
 }  // namespace xla::gpu
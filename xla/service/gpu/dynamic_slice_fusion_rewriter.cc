@@ -39,6 +39,8 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/ir/hlo_schedule.h"
+#include "xla/layout_util.h"
+#include "xla/primitive_util.h"
 #include "xla/service/custom_call_target_registry.h"
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/gpu/cublas_cudnn.h"
@@ -48,6 +50,7 @@ limitations under the License.
 #include "xla/shape.h"
 #include "xla/shape_util.h"
 #include "xla/util.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
 
@@ -256,6 +259,130 @@ DefUseDataflowPaths GetSlicedUserPaths(const HloInstruction* instr) {
   return sliced_user_paths;
 }
 
+// Paged gemms are executed as one library call per page, after the page table
+// is copied to the host. Launching more gemms than this costs more than
+// gathering the pages into a contiguous buffer for a single batched gemm.
+constexpr int64_t kMaxPagedGemmPages = 16;
+
+// Returns the shape of a single page (i.e. a slice of size 1 along the major
+// dimension) of `shape`.
+Shape PageShape(Shape shape) {
+  shape.set_dimensions(0, 1);
+  return shape;
+}
+
+// Returns true if `shape` is a stack of `num_pages` aligned contiguous pages
+// along its first dimension.
+bool IsPaged(const Shape& shape, int64_t num_pages) {
+  if (!shape.IsArray() || shape.rank() == 0 ||
+      shape.dimensions(0) != num_pages || num_pages == 0) {
+    return false;
+  }
+  return IsAlignedSlice(shape, PageShape(shape), nullptr);
+}
+
+// Returns true if `instr` is a gather that reads whole pages along the first
+// dimension of its operand at the indices of a page table (e.g. a block table
+// of a paged KV cache), i.e. it computes `result[i] = operand[indices[i]]`.
+bool IsPageGather(const HloInstruction* instr) {
+  auto* gather = DynCast<HloGatherInstruction>(instr);
+  if (gather == nullptr) return false;
+
+  const Shape& operand_shape = gather->operand(0)->shape();
+  const Shape& indices_shape = gather->operand(1)->shape();
+  const GatherDimensionNumbers& dims = gather->gather_dimension_numbers();
+
+  // Page table is a vector of page indices, e.g. s32[n] or s32[n,1].
+  if (!primitive_util::IsSignedIntegralType(indices_shape.element_type()) ||
+      primitive_util::ByteWidth(indices_shape.element_type()) < 4 ||
+      dims.index_vector_dim() != 1 ||
+      (indices_shape.rank() != 1 &&
+       (indices_shape.rank() != 2 || indices_shape.dimensions(1) != 1))) {
+    return false;
+  }
+  int64_t num_pages = indices_shape.dimensions(0);
+
+  // Every gathered slice is a whole page of the operand.
+  if (dims.start_index_map_size() != 1 || dims.start_index_map(0) != 0 ||
+      !IsPaged(operand_shape, operand_shape.dimensions(0)) ||
+      gather->gather_slice_sizes().front() != 1 ||
+      !absl::c_equal(gather->gather_slice_sizes().subspan(1),
+                     operand_shape.dimensions().subspan(1))) {
+    return false;
+  }
+
+  // Gathered pages are stacked along the first dimension of the result, in
+  // the same physical layout as in the operand.
+  for (int64_t i = 0; i < dims.offset_dims_size(); ++i) {
+    if (dims.offset_dims(i) != i + 1) return false;
+  }
+  if (!LayoutUtil::IsMonotonicWithDim0Major(operand_shape.layout()) ||
+      !LayoutUtil::IsMonotonicWithDim0Major(gather->shape().layout())) {
+    return false;
+  }
+  return IsPaged(gather->shape(), num_pages) &&
+         ShapeUtil::ByteSizeOf(PageShape(gather->shape())) ==
+             ShapeUtil::ByteSizeOf(PageShape(operand_shape));
+}
+
+// Returns the use-def dataflow paths from page gathers to a batched gemm that
+// can be executed one page at a time, with pages read directly from the
+// gathered buffers, or an empty vector if there is no such gemm. Gemm operands
+// and results must be batched along their first dimension, so that the `i`-th
+// page of the result depends only on the `i`-th pages of the operands.
+UseDefDataflowPaths GetPagedOperandPaths(const HloInstruction* instr) {
+  if (!IsLegacyCublasMatmul(*instr) || instr->operand_count() != 2) return {};
+
+  auto gpu_config = instr->backend_config<GpuBackendConfig>();
+  if (!gpu_config.ok()) return {};
+  const GemmBackendConfig& config = gpu_config->gemm_backend_config();
+  const DotDimensionNumbers& dot_dims = config.dot_dimension_numbers();
+  if (config.beta() != 0 || dot_dims.lhs_batch_dimensions_size() != 1 ||
+      dot_dims.lhs_batch_dimensions(0) != 0 ||
+      dot_dims.rhs_batch_dimensions_size() != 1 ||
+      dot_dims.rhs_batch_dimensions(0) != 0) {
+    return {};
+  }
+
+  const Shape& output_shape = instr->shape().IsTuple()
+                                  ? instr->shape().tuple_shapes(0)
+                                  : instr->shape();
+  int64_t num_pages = output_shape.dimensions(0);
+  if (num_pages > kMaxPagedGemmPages || !IsPaged(output_shape, num_pages)) {
+    return {};
+  }
+
+  UseDefDataflowPaths paged_operand_paths;
+  const HloInstruction* page_table = nullptr;
+  for (const HloInstruction* operand : instr->operands()) {
+    if (!IsPaged(operand->shape(), num_pages)) return {};
+
+    UseDefDataflowPath path;
+    const HloInstruction* cur = operand;
+    for (; cur->opcode() == HloOpcode::kBitcast; cur = cur->operand(0)) {
+      path.push_back(const_cast<HloInstruction*>(cur));
+    }
+    if (!IsPageGather(cur) || cur->shape().dimensions(0) != num_pages) {
+      continue;
+    }
+
+    // All paged operands must be gathered with the same page table.
+    if (page_table != nullptr && page_table != cur->operand(1)) return {};
+    page_table = cur->operand(1);
+
+    path.push_back(const_cast<HloInstruction*>(cur));
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+      if (!absl::c_linear_search(paged_operand_paths, *it)) {
+        paged_operand_paths.push_back(*it);
+      }
+    }
+  }
+
+  if (paged_operand_paths.empty()) return {};
+  paged_operand_paths.push_back(const_cast<HloInstruction*>(instr));
+  return paged_operand_paths;
+}
+
 absl::InlinedVector<HloInstruction*, 4> GetPatternCaptures(
     DataflowPathView matches) {
   absl::InlinedVector<HloInstruction*, 4> captures;
@@ -362,7 +489,7 @@ absl::StatusOr<HloComputation*> CreateFusionBody(
 
 absl::StatusOr<HloInstruction*> CreateFusionInstruction(
     HloModule* module, HloInstruction* orig, DataflowPathView captures,
-    HloComputation* body, bool dynamic) {
+    HloComputation* body, absl::string_view name) {
   HloComputation* parent = orig->parent();
 
   // Add a fusion operation calling outlined fusion computation.
@@ -380,8 +507,7 @@ absl::StatusOr<HloInstruction*> CreateFusionInstruction(
       *gpu_config.mutable_fusion_backend_config();
   backend_config.set_kind("__custom_fusion");
   CustomFusionConfig config;
-  config.set_name(dynamic ? "dynamic_address_computation"
-                          : "address_computation");
+  config.set_name(std::string(name));
   *backend_config.mutable_custom_fusion_config() = config;
   TF_RETURN_IF_ERROR(fusion->set_backend_config(std::move(gpu_config)));
 
@@ -397,12 +523,24 @@ absl::StatusOr<bool> DynamicSliceFusionRewriter::Run(
                       std::pair<UseDefDataflowPaths, DefUseDataflowPaths>>
       matches;
 
+  // Gemms reading pages gathered through a page table.
+  absl::flat_hash_set<HloInstruction*> paged_matches;
+
   // Collect all potential custom call matches in the non-fusion computations.
   for (HloComputation* computation : module->computations()) {
     if (computation->IsFusionComputation()) continue;
     for (HloInstruction* instr : computation->instructions()) {
       if (IsLegacyCublasMatmul(*instr) ||
           (IsCustomCall(instr, platform_name_))) {
+        UseDefDataflowPaths paged_operand_paths = GetPagedOperandPaths(instr);
+        if (!paged_operand_paths.empty()) {
+          matches[instr] =
+              std::make_pair(std::move(paged_operand_paths),
+                             DefUseDataflowPaths());
+          paged_matches.insert(instr);
+          continue;
+        }
+
         UseDefDataflowPaths sliced_operand_paths = GetSlicedOperandPaths(instr);
         bool has_sliced_operand_paths = sliced_operand_paths.size() > 1;
 
@@ -452,10 +590,15 @@ absl::StatusOr<bool> DynamicSliceFusionRewriter::Run(
     bool has_dynamic_slices = absl::c_any_of(matched_instrs, [&](auto* instr) {
       return DynCast<HloDynamicIndexInstruction>(instr) != nullptr;
     });
-    TF_ASSIGN_OR_RETURN(
-        HloInstruction * fusion,
-        CreateFusionInstruction(module, hero, captures, fusion_body,
-                                has_dynamic_slices));
+    absl::string_view name = "address_computation";
+    if (paged_matches.contains(hero)) {
+      name = "paged_address_computation";
+    } else if (has_dynamic_slices) {
+      name = "dynamic_address_computation";
+    }
+    TF_ASSIGN_OR_RETURN(HloInstruction * fusion,
+                        CreateFusionInstruction(module, hero, captures,
+                                                fusion_body, name));
 
     HloComputation* parent = hero->parent();
     if (fusion->shape().IsTuple()) {
@@ -67,6 +67,13 @@ namespace gpu {
 //        }}
 //  }
 //
+// Batched gemms that read pages gathered through a page table (e.g. a block
+// table of a paged KV cache) are rewritten into "paged_address_computation"
+// fusions. Such fusions execute the gemm one page at a time and pass page
+// addresses directly to the library call, so gathered pages are never copied
+// into a contiguous buffer. Gemms over many pages are left as is, since one
+// library call per page would be slower than the gather.
+//
 class DynamicSliceFusionRewriter : public HloModulePass {
  public:
   absl::string_view name() const override {
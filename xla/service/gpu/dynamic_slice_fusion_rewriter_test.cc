@@ -1787,4 +1787,142 @@ TEST_F(DynamicSliceFusionRewriterTest, DUSSimpleGemmWorkspaceIgnored) {
                             expected);
 }
 
+TEST_F(DynamicSliceFusionRewriterTest, PagedGemm) {
+  const char* hlo = R"(
+    HloModule test
+
+    ENTRY %main {
+      %cache = f16[16,8,8]{2,1,0} parameter(0)
+      %block_table = s32[4,1]{1,0} parameter(1)
+      %p2 = f16[4,8,8]{2,1,0} parameter(2)
+      %gather = f16[4,1,8,8]{3,2,1,0} gather(%cache, %block_table),
+        offset_dims={1,2,3}, collapsed_slice_dims={}, start_index_map={0},
+        index_vector_dim=1, slice_sizes={1,8,8}
+      %pages = f16[4,8,8]{2,1,0} bitcast(%gather)
+
+      ROOT %custom-call = (f16[4,8,8]{2,1,0}, s8[256]{0}) custom-call(%pages, %p2),
+        custom_call_target="__cublas$gemm",
+        backend_config={"gemm_backend_config":{
+          "alpha_real":1,
+          "beta":0,
+          "dot_dimension_numbers":{
+            "lhs_contracting_dimensions":["2"],
+            "rhs_contracting_dimensions":["1"],
+            "lhs_batch_dimensions":["0"],
+            "rhs_batch_dimensions":["0"]
+          },
+          "alpha_imag":0,
+          "precision_config":{"operand_precision":["DEFAULT","DEFAULT"]},
+          "epilogue":"DEFAULT",
+          "lhs_stride":"64",
+          "rhs_stride":"64",
+          "grad_x":false,
+          "grad_y":false
+        }}
+    }
+  )";
+
+  const char* expected = R"(
+    ; CHECK:     %address-computation {{.*}} {
+    ; CHECK-DAG:   [[P0:%[^ ]+]] = f16[16,8,8]{2,1,0} parameter(0)
+    ; CHECK-DAG:   [[P1:%[^ ]+]] = s32[4,1]{1,0} parameter(1)
+    ; CHECK-DAG:   [[P2:%[^ ]+]] = f16[4,8,8]{2,1,0} parameter(2)
+    ; CHECK-DAG:   [[G:%[^ ]+]] = f16[4,1,8,8]{3,2,1,0} gather([[P0]], [[P1]])
+    ; CHECK-DAG:   [[B:%[^ ]+]] = f16[4,8,8]{2,1,0} bitcast([[G]])
+    ; CHECK:       [[CC:%[^ ]+]] = (f16[4,8,8]{2,1,0}, s8[256]{0}) custom-call([[B]], [[P2]]),
+    ; CHECK:              custom_call_target="__cublas$gemm"
+    ; CHECK:     }
+
+    ; CHECK:     ENTRY %main{{.*}} {
+    ; CHECK:       ROOT [[FUSION:%[^ ]+]] = (f16[4,8,8]{2,1,0}, s8[256]{0}) fusion
+    ; CHECK:         kind=kCustom, calls=%address-computation,
+    ; CHECK:         backend_config={
+    ; CHECK:           "kind":"__custom_fusion",
+    ; CHECK:           "custom_fusion_config":{"name":"paged_address_computation"}
+    ; CHECK:         }
+    ; CHECK:     }
+  )";
+
+  RunAndFilecheckHloRewrite(hlo, DynamicSliceFusionRewriter(PLATFORM),
+                            expected);
+}
+
+TEST_F(DynamicSliceFusionRewriterTest, PagedGemmUnalignedPages) {
+  const char* hlo = R"(
+    HloModule test
+
+    ENTRY %main {
+      %cache = f16[16,4,4]{2,1,0} parameter(0)
+      %block_table = s32[4,1]{1,0} parameter(1)
+      %p2 = f16[4,4,4]{2,1,0} parameter(2)
+      %gather = f16[4,1,4,4]{3,2,1,0} gather(%cache, %block_table),
+        offset_dims={1,2,3}, collapsed_slice_dims={}, start_index_map={0},
+        index_vector_dim=1, slice_sizes={1,4,4}
+      %pages = f16[4,4,4]{2,1,0} bitcast(%gather)
+
+      ROOT %custom-call = (f16[4,4,4]{2,1,0}, s8[256]{0}) custom-call(%pages, %p2),
+        custom_call_target="__cublas$gemm",
+        backend_config={"gemm_backend_config":{
+          "alpha_real":1,
+          "beta":0,
+          "dot_dimension_numbers":{
+            "lhs_contracting_dimensions":["2"],
+            "rhs_contracting_dimensions":["1"],
+            "lhs_batch_dimensions":["0"],
+            "rhs_batch_dimensions":["0"]
+          },
+          "alpha_imag":0,
+          "precision_config":{"operand_precision":["DEFAULT","DEFAULT"]},
+          "epilogue":"DEFAULT",
+          "lhs_stride":"64",
+          "rhs_stride":"64",
+          "grad_x":false,
+          "grad_y":false
+        }}
+    }
+  )";
+
+  RunAndFilecheckHloRewrite(hlo, DynamicSliceFusionRewriter(PLATFORM),
+                            std::nullopt);
+}
+
+TEST_F(DynamicSliceFusionRewriterTest, PagedGemmTooManyPages) {
+  const char* hlo = R"(
+    HloModule test
+
+    ENTRY %main {
+      %cache = f16[64,8,8]{2,1,0} parameter(0)
+      %block_table = s32[32,1]{1,0} parameter(1)
+      %p2 = f16[32,8,8]{2,1,0} parameter(2)
+      %gather = f16[32,1,8,8]{3,2,1,0} gather(%cache, %block_table),
+        offset_dims={1,2,3}, collapsed_slice_dims={}, start_index_map={0},
+        index_vector_dim=1, slice_sizes={1,8,8}
+      %pages = f16[32,8,8]{2,1,0} bitcast(%gather)
+
+      ROOT %custom-call = (f16[32,8,8]{2,1,0}, s8[256]{0}) custom-call(%pages, %p2),
+        custom_call_target="__cublas$gemm",
+        backend_config={"gemm_backend_config":{
+          "alpha_real":1,
+          "beta":0,
+          "dot_dimension_numbers":{
+            "lhs_contracting_dimensions":["2"],
+            "rhs_contracting_dimensions":["1"],
+            "lhs_batch_dimensions":["0"],
+            "rhs_batch_dimensions":["0"]
+          },
+          "alpha_imag":0,
+          "precision_config":{"operand_precision":["DEFAULT","DEFAULT"]},
+          "epilogue":"DEFAULT",
+          "lhs_stride":"64",
+          "rhs_stride":"64",
+          "grad_x":false,
+          "grad_y":false
+        }}
+    }
+  )";
+
+  RunAndFilecheckHloRewrite(hlo, DynamicSliceFusionRewriter(PLATFORM),
+                            std::nullopt);
+}
+
 }  // namespace xla::gpu
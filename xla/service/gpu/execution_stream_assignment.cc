@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/gpu/execution_stream_assignment.h"
 
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <utility>
@@ -34,14 +35,25 @@ limitations under the License.
 
 namespace xla::gpu {
 
-ExecutionStreamAssignment::ExecutionStreamAssignment(const HloModule* module) {
+ExecutionStreamAssignment::ExecutionStreamAssignment(
+    const HloModule* module, ExecutionStreamAssignmentOptions options) {
   std::unique_ptr<CallGraph> call_graph = CallGraph::Build(module);
 
   // We'll walk the `CallGraph` starting from the entrypoint. The instructions
   // on the entrypoint computation will be assigned `ExecutionStreamId(0)`, and
   // each invocation of `async-start` will result in the target computation
-  // being assigned a new `ExecutionStreamId`.
+  // being assigned a new `ExecutionStreamId`, unless the number of execution
+  // streams is limited, in which case they are reused in round-robin order.
   ExecutionStreamId next_stream_id = ExecutionStreamId(1);
+  auto dispense_stream_id = [&] {
+    ExecutionStreamId stream_id = next_stream_id++;
+    if (options.number_of_execution_streams > 0 &&
+        next_stream_id.value() >
+            static_cast<uint64_t>(options.number_of_execution_streams)) {
+      next_stream_id = ExecutionStreamId(1);
+    }
+    return stream_id;
+  };
 
   // Each `Pending` item represents an `HloComputation` that needs to be
   // processed. We start with the entrypoint and add callees as we discover
@@ -88,7 +100,7 @@ ExecutionStreamAssignment::ExecutionStreamAssignment(const HloModule* module) {
         // Asynchronous calls will result in a new `ExecutionStreamId` being
         // dispensed for the called computations.
         CHECK_EQ(callsite.instruction()->opcode(), HloOpcode::kAsyncStart);
-        const ExecutionStreamId async_stream_id = next_stream_id++;
+        const ExecutionStreamId async_stream_id = dispense_stream_id();
         enqueue_called_computations(callsite, async_stream_id);
 
         AsyncExecutionStreamIds streams;
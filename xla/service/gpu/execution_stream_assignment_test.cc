@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <memory>
 #include <string_view>
+#include <utility>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -123,6 +124,59 @@ TEST_F(ExecutionStreamAssignmentTest, AsyncFusion) {
       ExecutionStreamId(2));
 }
 
+TEST_F(ExecutionStreamAssignmentTest, LimitedNumberOfExecutionStreams) {
+  const char* kModuleStr = R"(
+    HloModule m
+
+    leaf1 {
+      p0 = f32[2,2] parameter(0)
+      ROOT add = f32[2,2] add(p0, p0)
+    }
+    leaf2 {
+      p0 = f32[2,2] parameter(0)
+      ROOT add = f32[2,2] add(p0, p0)
+    }
+    leaf3 {
+      p0 = f32[2,2] parameter(0)
+      ROOT add = f32[2,2] add(p0, p0)
+    }
+
+    ENTRY entry {
+      p0 = f32[2,2] parameter(0)
+      start1 = ((f32[2,2]), f32[2,2], s32[]) fusion-start(p0),
+          kind=kLoop, calls=leaf1
+      start2 = ((f32[2,2]), f32[2,2], s32[]) fusion-start(p0),
+          kind=kLoop, calls=leaf2
+      start3 = ((f32[2,2]), f32[2,2], s32[]) fusion-start(p0),
+          kind=kLoop, calls=leaf3
+      done1 = f32[2,2] fusion-done(start1)
+      done2 = f32[2,2] fusion-done(start2)
+      done3 = f32[2,2] fusion-done(start3)
+      add = f32[2,2] add(done1, done2)
+      ROOT done = f32[2,2] add(add, done3)
+    }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kModuleStr));
+
+  ExecutionStreamAssignment assignment(
+      module.get(), ExecutionStreamAssignmentOptions{
+                        /*number_of_execution_streams=*/2});
+
+  // Asynchronous computations reuse the two execution streams in round-robin
+  // order.
+  for (auto [instruction, stream] :
+       {std::pair<std::string_view, int>{"start1", 1},
+        std::pair<std::string_view, int>{"start2", 2},
+        std::pair<std::string_view, int>{"start3", 1}}) {
+    EXPECT_THAT(assignment.GetAsyncExecutionStreamIds(Cast<HloAsyncInstruction>(
+                    FindInstruction(module.get(), instruction))),
+                IsOkAndHolds(AsyncExecutionStreamIds(
+                    /*source_stream_id=*/ExecutionStreamId(0),
+                    /*destination_stream_id=*/ExecutionStreamId(stream))));
+  }
+}
+
 TEST_F(ExecutionStreamAssignmentTest, FusionComputations) {
   const char* kModuleStr = R"(
     HloModule m
@@ -82,14 +82,19 @@ HloPassPipeline FusionPipeline(
   fusion.AddPass<HloCSE>(/*is_layout_sensitive=*/true,
                          /*only_fusion_computations=*/true);
   fusion.AddPass<HloDCE>();
+  // CSE and the removal of dead instructions in DCE run on each of the (often
+  // thousands of) fusion computations independently.
+  fusion.SetComputationThreadPool(thread_pool);
   return std::move(fusion);
 }
 
 HloPassPipeline HorizontalFusionPipeline(
-    const se::DeviceDescription& gpu_device_info) {
+    const se::DeviceDescription& gpu_device_info,
+    HloCostAnalysis::ShapeSizeFunction shape_size_bytes_function) {
   HloPassFix<HloPassPipeline> horizontal_fusion("horizontal fusion");
   horizontal_fusion.AddPass<GpuHorizontalLoopFusion>();
-  horizontal_fusion.AddPass<GpuHorizontalInputFusion>(gpu_device_info);
+  horizontal_fusion.AddPass<GpuHorizontalInputFusion>(
+      gpu_device_info, shape_size_bytes_function);
   horizontal_fusion.AddPass<HloCSE>(/*is_layout_sensitive=*/true,
                                     /*only_fusion_computations=*/true);
   horizontal_fusion.AddPass<HloDCE>();
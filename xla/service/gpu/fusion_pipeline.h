@@ -35,7 +35,8 @@ HloPassPipeline FusionPipeline(
 
 // Function wrapper around the horizontal XLA GPU fusion pipeline.
 HloPassPipeline HorizontalFusionPipeline(
-    const se::DeviceDescription& gpu_device_info);
+    const se::DeviceDescription& gpu_device_info,
+    HloCostAnalysis::ShapeSizeFunction shape_size_bytes_function);
 
 }  // namespace gpu
 }  // namespace xla
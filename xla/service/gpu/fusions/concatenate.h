@@ -37,6 +37,11 @@ const Shape& GetLargestConcatOperandShape(const HloFusionAnalysis& analysis);
 
 // Emits a kernel for the given hlo instruction where each thread produces
 // one element of each concat operand.
+//
+// TODO: Let buffer assignment place concat operands directly into slices of
+// the output buffer, so that their producers write in place and this kernel
+// and the operand buffers disappear. That needs a way to alias a value with a
+// slice of another buffer, which buffer assignment does not support today.
 class ConcatenateFusion : public KernelFusionEmitterBase {
  public:
   explicit ConcatenateFusion(const HloFusionAnalysis& analysis);
@@ -478,6 +478,159 @@ absl::StatusOr<FusionEmissionResult> EmitGemm(
   return result;
 }
 
+// Emits a batched gemm that reads some of its operands from pages gathered
+// through a page table. The gemm is executed one page at a time, with page
+// addresses passed directly to the library call, so gathered pages are never
+// copied into a contiguous buffer.
+absl::StatusOr<FusionEmissionResult> EmitPagedGemm(
+    IrEmitterContext& ir_emitter_context, const HloFusionInstruction& fusion,
+    const HloCustomCallInstruction& custom_call) {
+  const BufferAssignment& buffer_assignment =
+      ir_emitter_context.buffer_assignment();
+
+  // Returns the shape of a single page of `shape`.
+  auto page_shape = [](Shape shape) {
+    shape.set_dimensions(0, 1);
+    return shape;
+  };
+
+  std::vector<std::optional<BufferAllocation::Slice>> arguments;
+  std::vector<std::optional<Shape>> orig_shapes;
+  std::vector<std::optional<Shape>> sliced_shapes;
+  std::vector<DynamicSliceThunk::PageSlicing> page_slicings;
+  std::optional<DynamicSliceThunk::PageTable> page_table;
+
+  for (const HloInstruction* operand : custom_call.operands()) {
+    const HloInstruction* start = operand;
+    while (start->opcode() == HloOpcode::kBitcast) start = start->operand(0);
+
+    // Operands that are not gathered are batched along the same dimension.
+    if (auto* param = DynCast<HloParameterInstruction>(start)) {
+      TF_ASSIGN_OR_RETURN(
+          arguments.emplace_back(),
+          GetAllocationSlice(buffer_assignment,
+                             fusion.operand(param->parameter_number()),
+                             /*index=*/{}));
+      orig_shapes.push_back(param->shape());
+      sliced_shapes.push_back(page_shape(param->shape()));
+      page_slicings.push_back(DynamicSliceThunk::PageSlicing::kBatched);
+      continue;
+    }
+
+    auto* gather = DynCast<HloGatherInstruction>(start);
+    if (gather == nullptr) {
+      return absl::InternalError(
+          "Paged DynamicSliceFusion expects gemm operands to be parameters or "
+          "page gathers");
+    }
+
+    const auto* pages = Cast<HloParameterInstruction>(gather->operand(0));
+    const auto* indices = Cast<HloParameterInstruction>(gather->operand(1));
+    TF_ASSIGN_OR_RETURN(
+        arguments.emplace_back(),
+        GetAllocationSlice(buffer_assignment,
+                           fusion.operand(pages->parameter_number()),
+                           /*index=*/{}));
+    orig_shapes.push_back(pages->shape());
+    sliced_shapes.push_back(page_shape(pages->shape()));
+    page_slicings.push_back(DynamicSliceThunk::PageSlicing::kPaged);
+
+    TF_ASSIGN_OR_RETURN(
+        BufferAllocation::Slice indices_slice,
+        GetAllocationSlice(buffer_assignment,
+                           fusion.operand(indices->parameter_number()),
+                           /*index=*/{}));
+    if (page_table.has_value() && page_table->indices != indices_slice) {
+      return absl::InternalError(
+          "Paged DynamicSliceFusion expects all pages to be gathered with the "
+          "same page table");
+    }
+    page_table = DynamicSliceThunk::PageTable{
+        indices_slice, gather->shape().dimensions(0),
+        static_cast<uint64_t>(ShapeUtil::ByteSizeOfPrimitiveType(
+            indices->shape().element_type()))};
+  }
+
+  if (!page_table.has_value()) {
+    return absl::InternalError(
+        "Paged DynamicSliceFusion expects at least one page gather");
+  }
+
+  const Shape& output_shape = custom_call.shape().IsTuple()
+                                  ? custom_call.shape().tuple_shapes(0)
+                                  : custom_call.shape();
+  TF_ASSIGN_OR_RETURN(
+      arguments.emplace_back(),
+      GetAllocationSlice(buffer_assignment, &fusion,
+                         fusion.shape().IsTuple()
+                             ? ShapeIndex{kGEMMOutputBufferIndex}
+                             : ShapeIndex{}));
+  orig_shapes.push_back(output_shape);
+  sliced_shapes.push_back(page_shape(output_shape));
+  page_slicings.push_back(DynamicSliceThunk::PageSlicing::kBatched);
+
+  if (fusion.shape().IsTuple()) {
+    TF_ASSIGN_OR_RETURN(
+        arguments.emplace_back(),
+        GetAllocationSlice(buffer_assignment, &fusion,
+                           /*index=*/{kGEMMWorkspaceBufferIndex}));
+    orig_shapes.push_back(std::nullopt);
+    sliced_shapes.push_back(std::nullopt);
+    page_slicings.push_back(DynamicSliceThunk::PageSlicing::kNone);
+  }
+
+  // Embedded gemm reads and writes a single page from fake allocations that
+  // are replaced with page slices at run time.
+  std::vector<std::unique_ptr<BufferAllocation>> fake_allocations;
+  std::vector<BufferAllocation::Slice> fake_slices;
+  for (auto [arg_idx, sliced_shape] : llvm::enumerate(sliced_shapes)) {
+    int64_t size = sliced_shape.has_value()
+                       ? ShapeUtil::ByteSizeOf(*sliced_shape)
+                       : arguments[arg_idx]->size();
+    fake_allocations.push_back(std::make_unique<BufferAllocation>(
+        /*index=*/arg_idx, size, /*color=*/0));
+    fake_slices.emplace_back(fake_allocations.back().get(), 0, size);
+  }
+
+  // Every page is multiplied with an unbatched gemm.
+  TF_ASSIGN_OR_RETURN(
+      GemmConfig config,
+      GemmConfig::For(static_cast<const HloInstruction*>(&custom_call)));
+  for (se::gpu::MatrixLayout* layout :
+       {&config.lhs_layout, &config.rhs_layout, &config.c_layout,
+        &config.output_layout}) {
+    layout->batch_size = 1;
+    layout->batch_stride = 0;
+  }
+
+  bool deterministic_ops =
+      ir_emitter_context.debug_options().xla_gpu_deterministic_ops() ||
+      ir_emitter_context.debug_options().xla_gpu_exclude_nondeterministic_ops();
+
+  auto thunk_info = Thunk::ThunkInfo::WithProfileAnnotation(&custom_call);
+  std::optional<BufferAllocation::Slice> fake_workspace;
+  if (fusion.shape().IsTuple()) fake_workspace = fake_slices.back();
+
+  ThunkSequence seq;
+  seq.emplace_back(std::make_unique<GemmThunk>(
+      thunk_info, std::move(config), fake_slices[0], fake_slices[1],
+      fake_slices[2], fake_workspace, deterministic_ops));
+
+  size_t num_arguments = arguments.size();
+  FusionEmissionResult result;
+  result.thunks.push_back(std::make_unique<DynamicSliceThunk>(
+      thunk_info, std::make_unique<ThunkSequence>(std::move(seq)),
+      std::move(arguments), std::move(fake_allocations),
+      /*offsets=*/
+      std::vector<std::optional<std::vector<DynamicSliceThunk::Offset>>>(
+          num_arguments, std::nullopt),
+      std::move(orig_shapes), std::move(sliced_shapes),
+      /*offset_byte_sizes=*/
+      std::vector<std::optional<uint64_t>>(num_arguments, std::nullopt),
+      std::move(page_table), std::move(page_slicings)));
+  return result;
+}
+
 absl::StatusOr<FusionEmissionResult> EmitCustomCall(
     IrEmitterContext& ir_emitter_context, const HloFusionAdaptor& adaptor,
     const HloFusionInstruction& fusion,
@@ -823,6 +976,12 @@ absl::StatusOr<FusionEmissionResult> DynamicSliceFusion::Emit(
   const auto& custom_call = *static_cast<const HloCustomCallInstruction*>(
       &maybe_custom_call_adaptor->instruction());
   if (IsLegacyCublasMatmul(custom_call)) {
+    TF_ASSIGN_OR_RETURN(auto gpu_config,
+                        fusion.backend_config<GpuBackendConfig>());
+    if (gpu_config.fusion_backend_config().custom_fusion_config().name() ==
+        "paged_address_computation") {
+      return EmitPagedGemm(ir_emitter_context, fusion, custom_call);
+    }
     return EmitGemm(ir_emitter_context, adaptor, fusion, custom_call);
   }
 
@@ -160,6 +160,88 @@ TEST_F(DynamicSliceFusionTest, CublasGemmSimple) {
                                       /*run_hlo_passes=*/false));
 }
 
+TEST_F(DynamicSliceFusionTest, CublasGemmPaged) {
+  ErrorSpec error_spec{/*aabs=*/1e-3, /*arel=*/1e-3};
+
+  const char* hlo_ref = R"(
+  HloModule jit_slice
+
+  ENTRY %main {
+    %cache = bf16[16,8,8]{2,1,0} parameter(0), sharding={replicated}
+    %block_table = s32[4,1]{1,0} parameter(1), sharding={replicated}
+    %p2 = bf16[4,8,8]{2,1,0} parameter(2), sharding={replicated}
+    %gather = bf16[4,1,8,8]{3,2,1,0} gather(%cache, %block_table),
+      offset_dims={1,2,3}, collapsed_slice_dims={}, start_index_map={0},
+      index_vector_dim=1, slice_sizes={1,8,8}
+    %pages = bf16[4,8,8]{2,1,0} bitcast(%gather)
+
+    ROOT %custom-call = bf16[4,8,8]{2,1,0} custom-call(%pages, %p2),
+      custom_call_target="__cublas$gemm",
+      backend_config={"gemm_backend_config":{
+        "alpha_real":1,
+        "beta":0,
+        "dot_dimension_numbers":{
+          "lhs_contracting_dimensions":["2"],
+          "rhs_contracting_dimensions":["1"],
+          "lhs_batch_dimensions":["0"],
+          "rhs_batch_dimensions":["0"]
+        },
+        "alpha_imag":0,
+        "precision_config":{"operand_precision":["DEFAULT","DEFAULT"]},
+        "epilogue":"DEFAULT",
+        "lhs_stride":"64",
+        "rhs_stride":"64",
+        "grad_x":false,
+        "grad_y":false
+      }}
+  })";
+
+  const char* hlo_opt = R"(
+  HloModule jit_slice
+
+  %fused_computation {
+    %param_0_0 = bf16[16,8,8]{2,1,0} parameter(0)
+    %param_1_0 = s32[4,1]{1,0} parameter(1)
+    %param_2_0 = bf16[4,8,8]{2,1,0} parameter(2)
+    %gather = bf16[4,1,8,8]{3,2,1,0} gather(%param_0_0, %param_1_0),
+      offset_dims={1,2,3}, collapsed_slice_dims={}, start_index_map={0},
+      index_vector_dim=1, slice_sizes={1,8,8}
+    %pages = bf16[4,8,8]{2,1,0} bitcast(%gather)
+
+    ROOT %custom-call = bf16[4,8,8]{2,1,0} custom-call(%pages, %param_2_0),
+      custom_call_target="__cublas$gemm",
+      backend_config={"gemm_backend_config":{
+        "alpha_real":1,
+        "beta":0,
+        "dot_dimension_numbers":{
+          "lhs_contracting_dimensions":["2"],
+          "rhs_contracting_dimensions":["1"],
+          "lhs_batch_dimensions":["0"],
+          "rhs_batch_dimensions":["0"]
+        },
+        "alpha_imag":0,
+        "precision_config":{"operand_precision":["DEFAULT","DEFAULT"]},
+        "epilogue":"DEFAULT",
+        "lhs_stride":"64",
+        "rhs_stride":"64",
+        "grad_x":false,
+        "grad_y":false
+      }}
+  }
+
+  ENTRY %main {
+    %cache = bf16[16,8,8]{2,1,0} parameter(0), sharding={replicated}
+    %block_table = s32[4,1]{1,0} parameter(1), sharding={replicated}
+    %p2 = bf16[4,8,8]{2,1,0} parameter(2), sharding={replicated}
+    ROOT %fusion = bf16[4,8,8]{2,1,0} fusion(%cache, %block_table, %p2),
+        kind=kCustom, calls=%fused_computation,
+        backend_config={"fusion_backend_config":{"kind":"__custom_fusion","custom_fusion_config":{"name":"paged_address_computation"}}}
+  })";
+
+  EXPECT_TRUE(RunAndCompareTwoModules(hlo_ref, hlo_opt, error_spec,
+                                      /*run_hlo_passes=*/false));
+}
+
 TEST_F(DynamicSliceFusionTest, CublasGemmWithWorkspace) {
   ErrorSpec error_spec{/*aabs=*/1e-3, /*arel=*/1e-3};
 
@@ -19,11 +19,13 @@ limitations under the License.
 #include <optional>
 #include <tuple>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/numeric/bits.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Type.h"
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
@@ -31,6 +33,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/layout_util.h"
+#include "xla/primitive_util.h"
 #include "xla/service/gpu/elemental_ir_emitter.h"
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/hlo_fusion_analysis.h"
@@ -40,7 +43,11 @@ limitations under the License.
 #include "xla/service/gpu/launch_dimensions.h"
 #include "xla/service/gpu/model/indexing_analysis.h"
 #include "xla/service/gpu/model/indexing_map.h"
+#include "xla/service/gpu/model/symbolic_tile_analysis.h"
+#include "xla/service/gpu/model/tiled_hlo_computation.h"
+#include "xla/service/gpu/model/tiled_hlo_instruction.h"
 #include "xla/service/gpu/parallel_loop_emitter.h"
+#include "xla/service/instruction_fusion.h"
 #include "xla/service/llvm_ir/fused_ir_emitter.h"
 #include "xla/service/llvm_ir/ir_array.h"
 #include "xla/shape.h"
@@ -71,6 +78,47 @@ int ComputeMaxUnrollFactor(int64_t num_elements) {
   return 1;
 }
 
+// Returns the unroll factor with which each thread accesses 128 bits of the
+// widest element type used by the fusion's parameters and outputs. The MLIR
+// emitters turn such unrolled accesses into vector loads and stores if the
+// accessed elements are contiguous and aligned, which requires the minor
+// output dimension to be divisible by the unroll factor.
+int ComputeVectorizedUnrollFactor(const HloFusionAnalysis& analysis,
+                                  const Shape& element_shape) {
+  constexpr int kMaxVectorBytes = 16;
+  if (element_shape.rank() == 0 ||
+      !LayoutUtil::IsMonotonicWithDim0Major(element_shape.layout())) {
+    return 1;
+  }
+  int max_element_bytes = 0;
+  auto update_element_bytes = [&](const Shape& shape) {
+    ShapeUtil::ForEachSubshape(shape, [&](const Shape& subshape, auto) {
+      if (subshape.IsArray()) {
+        max_element_bytes = std::max(
+            max_element_bytes,
+            primitive_util::ByteWidth(subshape.element_type()));
+      }
+    });
+  };
+  for (const HloInstruction* parameter : analysis.fusion().GetParameters()) {
+    update_element_bytes(parameter->shape());
+  }
+  for (const HloInstructionAdaptor& root : analysis.fusion_roots()) {
+    update_element_bytes(root.shape());
+  }
+  if (max_element_bytes == 0) {
+    return 1;
+  }
+  int64_t minor_dim_size = element_shape.dimensions().back();
+  for (int unroll_factor = kMaxVectorBytes / max_element_bytes;
+       unroll_factor > 1; unroll_factor /= 2) {
+    if (minor_dim_size % unroll_factor == 0) {
+      return unroll_factor;
+    }
+  }
+  return 1;
+}
+
 // Determines if we enable the row optimized codegen. When we have a fusion with
 // only pointwise operations, scalar broadcasting and row broadcasting, we can
 // trigger a kernel that vectorizes the row loads. This speeds up the kernel, in
@@ -148,10 +196,94 @@ std::pair<bool /*enabled*/, int> RowVectorizationEnabled(
                         num_big_inputs);
 }
 
+// Returns true if the fusion broadcasts a non-scalar, so that elements of the
+// broadcasted operand are used for several output elements. Broadcasts of
+// scalars are loaded once per thread anyway.
+bool HasNonScalarBroadcast(const HloFusionAdaptor& fusion) {
+  return HloAnyOf(fusion.GetRoots(), fusion, [](auto instr) {
+    return instr.opcode() == HloOpcode::kBroadcast &&
+           !instr.instruction().dimensions().empty();
+  });
+}
+
+// Uses symbolic tiling to find the number of consecutive output elements a
+// thread should compute so that elements of broadcasted inputs are loaded once
+// and reused from registers. For each candidate unroll factor `u`,
+// the output is tiled with [1, ..., 1, u] tiles and the number of input bytes
+// read per output element is derived from the tiles of the fusion parameters.
+// Returns the smallest unroll factor that reads within 5% of the minimum, or
+// nullopt if no tiling improves over computing one element per thread.
+std::optional<int> ComputeReuseUnrollFactor(const HloFusionAnalysis& analysis,
+                                            const Shape& element_shape) {
+  constexpr int kMaxReuseUnrollFactor = 8;
+  if (analysis.fusion_roots().size() != 1 ||
+      analysis.fusion_root(0).shape().IsTuple() || element_shape.rank() == 0 ||
+      !LayoutUtil::IsMonotonicWithDim0Major(element_shape.layout()) ||
+      !HasNonScalarBroadcast(analysis.fusion())) {
+    return std::nullopt;
+  }
+
+  mlir::MLIRContext mlir_context;
+  SymbolicTileAnalysisOrError analysis_or_error =
+      SymbolicTileAnalysis::AnalyzeFusion(analysis.fusion(), &mlir_context);
+  if (const auto* decision = std::get_if<FusionDecision>(&analysis_or_error)) {
+    VLOG(3) << "Symbolic tiling not possible: " << decision->Explain();
+    return std::nullopt;
+  }
+  const auto& tile_analysis = std::get<SymbolicTileAnalysis>(analysis_or_error);
+
+  const int64_t minor_dim_size =
+      element_shape.dimensions(element_shape.rank() - 1);
+  std::vector<std::pair<int, double>> bytes_per_element;
+  for (int unroll = 1;
+       unroll <= kMaxReuseUnrollFactor && minor_dim_size % unroll == 0;
+       unroll *= 2) {
+    std::vector<int64_t> tile_sizes(element_shape.rank(), 1);
+    tile_sizes.back() = unroll;
+    absl::StatusOr<bool> satisfied =
+        tile_analysis.ParametersSatisfyConstraints(tile_sizes);
+    if (!satisfied.ok() || !*satisfied) break;
+    absl::StatusOr<TiledHloComputation> tiled_computation =
+        tile_analysis.ComputeTiledHloInstructions(
+            tile_sizes, /*constraints_are_known_satisfied=*/true);
+    if (!tiled_computation.ok()) break;
+
+    int64_t bytes_read = 0;
+    for (const TiledHloInstruction* tiled_hlo :
+         tiled_computation->instructions()) {
+      if (tiled_hlo->hlo()->opcode() != HloOpcode::kParameter) continue;
+      int64_t tile_elements = 1;
+      for (int64_t size : tiled_hlo->tile_sizes()) tile_elements *= size;
+      bytes_read += tile_elements *
+                    ShapeUtil::ByteSizeOfPrimitiveType(
+                        tiled_hlo->hlo()->shape().element_type());
+    }
+    bytes_per_element.push_back(
+        {unroll, static_cast<double>(bytes_read) / unroll});
+  }
+  if (bytes_per_element.size() < 2) return std::nullopt;
+
+  double min_bytes = bytes_per_element.front().second;
+  for (const auto& [unroll, bytes] : bytes_per_element) {
+    min_bytes = std::min(min_bytes, bytes);
+  }
+  if (min_bytes >= 0.95 * bytes_per_element.front().second) {
+    return std::nullopt;
+  }
+  for (const auto& [unroll, bytes] : bytes_per_element) {
+    if (bytes <= 1.05 * min_bytes) {
+      VLOG(2) << "Unroll factor for input reuse: " << unroll << " ("
+              << bytes << " bytes read per output element)";
+      return unroll;
+    }
+  }
+  return std::nullopt;
+}
+
 }  // namespace
 
 LaunchDimensionsConfig ComputeLoopFusionConfig(
-    const HloFusionAnalysis& analysis) {
+    const HloFusionAnalysis& analysis, bool vectorize_memory_accesses) {
   int unroll_factor = 1;
   // Unrolling is good to read large inputs with small elements
   // due to vector loads, but increases the register pressure when one
@@ -166,6 +298,22 @@ LaunchDimensionsConfig ComputeLoopFusionConfig(
   if (num_elements >= n_threads_max &&
       !MayPreventVectorization(analysis.fusion())) {
     unroll_factor = ComputeMaxUnrollFactor(num_elements);
+    if (analysis.fusion_root(0)
+            .instruction()
+            .GetModule()
+            ->config()
+            .debug_options()
+            .xla_gpu_enable_loop_fusion_reuse_tiling()) {
+      if (std::optional<int> reuse_unroll_factor =
+              ComputeReuseUnrollFactor(analysis, element_shape)) {
+        unroll_factor = std::max(unroll_factor, *reuse_unroll_factor);
+      }
+    }
+    if (vectorize_memory_accesses) {
+      unroll_factor =
+          std::max(unroll_factor,
+                   ComputeVectorizedUnrollFactor(analysis, element_shape));
+    }
   }
   // CHECK that unroll_factor is a power-of-2, as needed by the logic below.
   CHECK(absl::has_single_bit(static_cast<uint64_t>(unroll_factor)));
@@ -59,8 +59,11 @@ class LoopFusion : public KernelFusionEmitterBase {
   LaunchDimensionsConfig config_;
 };
 
+// Computes the launch configuration of a loop fusion. If
+// `vectorize_memory_accesses` is set, fusions of narrow element types are
+// unrolled far enough that the emitter can access memory with 128-bit vectors.
 LaunchDimensionsConfig ComputeLoopFusionConfig(
-    const HloFusionAnalysis& analysis);
+    const HloFusionAnalysis& analysis, bool vectorize_memory_accesses = false);
 
 }  // namespace gpu
 }  // namespace xla
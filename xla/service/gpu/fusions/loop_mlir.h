@@ -36,7 +36,9 @@ namespace gpu {
 class MlirLoopFusion : public MlirFusionEmitterBase {
  public:
   explicit MlirLoopFusion(const HloFusionAnalysis& analysis)
-      : analysis_(analysis), config_(ComputeLoopFusionConfig(analysis)) {}
+      : analysis_(analysis),
+        config_(ComputeLoopFusionConfig(
+            analysis, /*vectorize_memory_accesses=*/true)) {}
   LaunchDimensions launch_dimensions() const override;
 
   std::optional<IndexingMap> ComputeThreadIdToOutputIndexing(
@@ -22,6 +22,7 @@ limitations under the License.
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "xla/service/gpu/fusions/fusion_emitter.h"
 #include "xla/service/gpu/fusions/fusions.h"
+#include "xla/service/gpu/fusions/loop.h"
 #include "xla/service/gpu/gpu_device_info_for_tests.h"
 #include "xla/service/gpu/hlo_fusion_analysis.h"
 #include "xla/service/gpu/model/affine_map_printer.h"
@@ -217,6 +218,64 @@ TEST_F(LoopTest, Broadcast) {
             )"));
 }
 
+TEST_F(LoopTest, ReuseTilingUnrollsColumnBroadcast) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule module
+
+    bcast_add {
+      %p0 = f32[8192] parameter(0)
+      %p1 = f32[8192,1024] parameter(1)
+      %bcast = f32[8192,1024] broadcast(%p0), dimensions={0}
+      ROOT %add = f32[8192,1024] add(%bcast, %p1)
+    }
+
+    ENTRY entry {
+      %p0 = f32[8192] parameter(0)
+      %p1 = f32[8192,1024] parameter(1)
+      ROOT %fusion = f32[8192,1024] fusion(%p0, %p1), kind=kLoop,
+        calls=bcast_add
+    })")
+                    .value();
+
+  auto* root = module->entry_computation()->root_instruction();
+  EXPECT_EQ(ComputeLoopFusionConfig(AnalyzeFusion(*root, device_info_))
+                .unroll_factor,
+            4);
+
+  module->mutable_config()
+      .mutable_debug_options()
+      .set_xla_gpu_enable_loop_fusion_reuse_tiling(true);
+  // Every broadcasted element is reused for 8 output elements of a thread.
+  EXPECT_EQ(ComputeLoopFusionConfig(AnalyzeFusion(*root, device_info_))
+                .unroll_factor,
+            8);
+}
+
+TEST_F(LoopTest, VectorizedUnrollFactorForNarrowTypes) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule module
+
+    neg {
+      %p0 = bf16[8192,1024] parameter(0)
+      ROOT %neg = bf16[8192,1024] negate(%p0)
+    }
+
+    ENTRY entry {
+      %p0 = bf16[8192,1024] parameter(0)
+      ROOT %fusion = bf16[8192,1024] fusion(%p0), kind=kLoop, calls=neg
+    })")
+                    .value();
+
+  auto* root = module->entry_computation()->root_instruction();
+  auto analysis = AnalyzeFusion(*root, device_info_);
+  EXPECT_EQ(ComputeLoopFusionConfig(analysis).unroll_factor, 4);
+  // Eight bf16 elements fill a 128-bit vector.
+  EXPECT_EQ(ComputeLoopFusionConfig(analysis,
+                                    /*vectorize_memory_accesses=*/true)
+                .unroll_factor,
+            8);
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -403,3 +403,57 @@ module {
 
 // CHECK-LABEL: @remainder_with_modulo_misaligned
 // CHECK-NOT: vector.transfer_read
+
+// -----
+
+module {
+  func.func @read_f16x8(%arg0: tensor<64x8xf16>) -> (f16) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c8 = arith.constant 8 : index
+    %c64 = arith.constant 64 : index
+    %cst = arith.constant 0.0 : f16
+    %outer = scf.for %i = %c0 to %c64 step %c1 iter_args(%iter = %cst) -> f16 {
+      %inner = scf.for %j = %c0 to %c8 step %c1 iter_args(%iter1 = %iter) -> f16 {
+        %extracted = tensor.extract %arg0[%i, %j] : tensor<64x8xf16>
+        %added = arith.addf %iter1, %extracted : f16
+        scf.yield %added : f16
+      }
+      scf.yield %inner : f16
+    }
+    return %outer : f16
+  }
+}
+
+// CHECK-LABEL: @read_f16x8
+// CHECK-SAME:     (%[[ARG0:.*]]: tensor
+// CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+// CHECK:       scf.for %[[I:.*]] = %[[C0]]
+// CHECK-NEXT:    %[[V:.*]] = vector.transfer_read %[[ARG0]][%[[I]], %[[C0]]]
+// CHECK-SAME:      vector<8xf16>
+// CHECK-NEXT:    scf.for %[[J:.*]] = %[[C0]]
+// CHECK-NEXT:      vector.extract %[[V]][%[[J]]]
+
+// -----
+
+module {
+  func.func @read_too_wide(%arg0: tensor<64x8xf32>) -> (f32) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c8 = arith.constant 8 : index
+    %c64 = arith.constant 64 : index
+    %cst = arith.constant 0.0 : f32
+    %outer = scf.for %i = %c0 to %c64 step %c1 iter_args(%iter = %cst) -> f32 {
+      %inner = scf.for %j = %c0 to %c8 step %c1 iter_args(%iter1 = %iter) -> f32 {
+        %extracted = tensor.extract %arg0[%i, %j] : tensor<64x8xf32>
+        %added = arith.addf %iter1, %extracted : f32
+        scf.yield %added : f32
+      }
+      scf.yield %inner : f32
+    }
+    return %outer : f32
+  }
+}
+
+// CHECK-LABEL: @read_too_wide
+// CHECK-NOT: vector.transfer_read
@@ -21,6 +21,7 @@ limitations under the License.
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/Dialect/SCF/IR/SCF.h"  // from @llvm-project
@@ -113,10 +114,14 @@ int64_t GetAlignmentOfRemainder(mlir::AffineExpr expr,
   return 1;
 }
 
+// The widest vector load or store that the GPU supports, in bits.
+constexpr int64_t kMaxVectorBits = 128;
+
 // Attempts to extract the vector type for the given loop. This means:
 // - checks that the lower bound is 0
 // - checks that the step is 1
-// - checks that the upper bound is 2 or 4.
+// - checks that the upper bound is a power of 2 between 2 and 16, such that
+//   the vector is at most 128 bits wide.
 // Returns a vector type with the given upper bound and the tensor's element
 // type.
 mlir::VectorType GetVectorType(mlir::RankedTensorType tensor_type,
@@ -132,11 +137,17 @@ mlir::VectorType GetVectorType(mlir::RankedTensorType tensor_type,
       mlir::getConstantIntValue(loop.getLowerBound()) != 0) {
     return nullptr;
   }
-  std::optional<int> vector_size =
+  std::optional<int64_t> vector_size =
       mlir::getConstantIntValue(loop.getUpperBound());
-  if (vector_size != 2 && vector_size != 4) {
+  if (!vector_size || *vector_size < 2 || *vector_size > 16 ||
+      !llvm::isPowerOf2_64(*vector_size)) {
     return nullptr;  // Unsupported vector size.
   }
+  mlir::Type element_type = tensor_type.getElementType();
+  if (element_type.isIntOrFloat() &&
+      *vector_size * element_type.getIntOrFloatBitWidth() > kMaxVectorBits) {
+    return nullptr;  // The vector is too wide for a single access.
+  }
   if (tensor_type.getRank() > 1 &&
       tensor_type.getShape().back() % *vector_size) {
     return nullptr;  // Misaligned start indices.
@@ -707,9 +707,10 @@ void ReductionGroupEmitter::EmitReductionOutputForRowReduction(
 
   ksl.If("thread_in_bounds", is_in_bounds_y, [&] {
     if (num_rows_per_warp > 1) {
-      llvm::Value* is_writing_thread = is_zero(builder->CreateAnd(
-          thread_id_x,
-          constant(reduction_emitter_.ReducedDimensionSize() - 1)));
+      int threads_per_row = RowReductionGetThreadsPerRow(
+          reduction_emitter_.ReducedDimensionSize());
+      llvm::Value* is_writing_thread = is_zero(
+          builder->CreateAnd(thread_id_x, constant(threads_per_row - 1)));
       emit_write_output(is_writing_thread, current_outputs);
       return;
     }
@@ -1134,7 +1135,7 @@ ReductionInfo ReductionInfo::Create(const HloFusionAnalysis& analysis) {
   int64_t num_threads_x = [&] {
     if (reduction_dimensions.is_row_reduction) {
       if (rows_per_warp > 1) {
-        return shape[ReductionDimensions::kRowMinorReducedDimension];
+        return WarpSize() / rows_per_warp;
       }
       int64_t max_block_size =
           MinThreadsXRowReduction(hero_reduction->GetModule()->config());
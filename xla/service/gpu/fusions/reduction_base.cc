@@ -28,6 +28,7 @@ limitations under the License.
 #include "absl/container/node_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/numeric/bits.h"
 #include "absl/types/span.h"
 #include "llvm/ADT/STLExtras.h"
 #include "mlir/IR/AffineExpr.h"  // from @llvm-project
@@ -57,11 +58,18 @@ namespace xla {
 namespace gpu {
 
 int RowReductionGetRowsPerWarp(int reduced_dimension_size) {
-  if (WarpSize() % reduced_dimension_size != 0 ||
-      reduced_dimension_size >= WarpSize()) {
+  if (reduced_dimension_size >= WarpSize()) {
     return 1;
   }
-  return WarpSize() / reduced_dimension_size;
+  // Rows that do not divide the warp are padded to the next power of two, so
+  // that every row is reduced by an aligned segment of lanes. The lanes past
+  // the end of a row only contribute the reduction's init value.
+  return WarpSize() /
+         absl::bit_ceil(static_cast<uint32_t>(reduced_dimension_size));
+}
+
+int RowReductionGetThreadsPerRow(int reduced_dimension_size) {
+  return WarpSize() / RowReductionGetRowsPerWarp(reduced_dimension_size);
 }
 
 int GetVectorSize(const HloFusionAnalysis& analysis,
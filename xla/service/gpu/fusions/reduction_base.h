@@ -41,8 +41,13 @@ struct ReductionGroups {
 ReductionGroups GroupDisjointReductions(const HloFusionAnalysis& analysis,
                                         bool for_mlir);
 
+// Returns the number of rows reduced by each warp of a row reduction. Rows
+// shorter than a warp are reduced by segments of the warp.
 int RowReductionGetRowsPerWarp(int reduced_dimension_size);
 
+// Returns the number of lanes reducing one row of a multi-row reduction.
+int RowReductionGetThreadsPerRow(int reduced_dimension_size);
+
 int GetVectorSize(const HloFusionAnalysis& analysis,
                   const ReductionDimensions& reduction_dimensions,
                   int num_threads, Vector3 reduction_tiling);
@@ -423,7 +423,7 @@ MlirRowReductionFusion::MlirRowReductionFusion(
       shape[ReductionDimensions::kRowMinorReducedDimension]);
   int64_t num_threads_x = [&] {
     if (rows_per_warp > 1) {
-      return shape[ReductionDimensions::kRowMinorReducedDimension];
+      return WarpSize() / rows_per_warp;
     }
     int64_t max_block_size =
         MinThreadsXRowReduction(first_reduce_->GetModule()->config());
@@ -342,6 +342,52 @@ TEST_F(MlirRowReductionTest, MultiRowReduction) {
   EXPECT_TRUE(RunAndCompareNoHloPasses(kHloString, ErrorSpec{1e-3}));
 }
 
+TEST_F(MlirRowReductionTest, MultiRowReductionPaddedRows) {
+  constexpr auto kHloString = R"(
+    HloModule Test, is_scheduled=true
+
+    Add {
+      lhs = f32[] parameter(0)
+      rhs = f32[] parameter(1)
+      ROOT add = f32[] add(lhs, rhs)
+    }
+    fused_computation {
+      param_0 = f32[1024,12] parameter(0)
+      param_1 = f32[] parameter(1)
+      ROOT reduce = f32[1024] reduce(param_0, param_1), dimensions={1}, to_apply=Add
+    }
+    ENTRY main {
+      a = f32[1024,12] parameter(0)
+      c = f32[] constant(0)
+      ROOT fusion = f32[1024] fusion(a, c), kind=kInput, calls=fused_computation
+    })";
+  auto module = ParseAndReturnVerifiedModule(kHloString).value();
+  auto* root = module->entry_computation()->root_instruction();
+  auto analysis = AnalyzeFusion(*root, device_info_);
+  MlirRowReductionFusion fusion(analysis);
+
+  // Rows of 12 elements are padded to 16 lanes, so each warp reduces two rows.
+  EXPECT_THAT(
+      fusion.ComputeThreadIdToOutputIndexing(0, &mlir_context_)->ToString(),
+      MatchIndexingString(R"(
+        (d0, d1, d2, d3, d4, d5) -> (d3 * 16 + d0 floordiv 16)
+        domain:
+        d0 in [0, 255]
+        d1 in [0, 0]
+        d2 in [0, 0]
+        d3 in [0, 63]
+        d4 in [0, 0]
+        d5 in [0, 0]
+        d0 mod 16 in [0, 0]
+        d3 * 16 + d0 floordiv 16 in [0, 1023]
+      )"));
+  TF_ASSERT_OK(EmitAndCheckIR(kHloString, R"(
+    // CHECK: shuffle_reduce {{.*}} to 8
+    // CHECK-NOT: allocate_shared
+  )"));
+  EXPECT_TRUE(RunAndCompareNoHloPasses(kHloString, ErrorSpec{1e-3}));
+}
+
 TEST_F(MlirRowReductionTest, NonPowerOfTwoRowReduction) {
   constexpr auto kHloString = R"(
     HloModule Test, is_scheduled=true
@@ -125,14 +125,32 @@ MlirTransposeFusion::MlirTransposeFusion(const HloFusionAnalysis& analysis)
   // Enable vectorization if we have enough work, enough shared memory and
   // the input dimensions are divisible by the vector size. Vectorizing loads
   // for large data types does not help (there's already enough parallelism).
+  // Both the number of blocks and the shared memory tile scale with the square
+  // of the vector size. Vectors of more than two elements are only used if the
+  // tiled dimensions fill the larger tile.
   const auto& device = analysis_.device_info();
-  bool enough_work = Product(block_counts_) * kNumThreadsPerBlock >=
-                     4 * device.core_count() * device.threads_per_core_limit();
-  bool enough_shmem = shmem_usage * 4 <= device.shared_memory_per_block();
-  bool aligned_dims =
-      (input_shape_[2] % 2 == 0) && (input_shape_[permutation_[2]] % 2 == 0);
-  if (max_element_bytes < 4 && enough_work && enough_shmem && aligned_dims) {
-    compute_block_sizes(2);
+  auto can_vectorize = [&](int vector_size) {
+    int64_t square = vector_size * vector_size;
+    bool enough_work =
+        Product(block_counts_) * kNumThreadsPerBlock >=
+        square * device.core_count() * device.threads_per_core_limit();
+    bool enough_shmem =
+        shmem_usage * square <= device.shared_memory_per_block();
+    bool aligned_dims = (input_shape_[2] % vector_size == 0) &&
+                        (input_shape_[permutation_[2]] % vector_size == 0);
+    bool filled_tile =
+        vector_size <= 2 ||
+        std::min(input_shape_[2], input_shape_[permutation_[2]]) >=
+            kBaseBlockSize * vector_size;
+    return enough_work && enough_shmem && aligned_dims && filled_tile;
+  };
+  if (max_element_bytes < 4) {
+    for (int vector_size : {4, 2}) {
+      if (can_vectorize(vector_size)) {
+        compute_block_sizes(vector_size);
+        break;
+      }
+    }
   }
 }
 
@@ -253,6 +253,44 @@ TEST_F(MlirTransposeFusionTest, ThreadIndexingVectorized210) {
       )"));
 }
 
+TEST_F(MlirTransposeFusionTest, ThreadIndexingVectorized4Elements021) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+    HloModule module
+    fusion {
+      %input = f16[8192,128,128] parameter(0)
+      ROOT transpose = f16[8192,128,128] transpose(%input), dimensions={0,2,1}
+    }
+    ENTRY entry {
+      %input = f16[8192,128,128] parameter(0)
+      ROOT %fusion = f16[8192,128,128] fusion(%input), kind=kInput,
+        calls=fusion
+    }
+  )"));
+
+  auto* root = module->entry_computation()->root_instruction();
+  auto analysis = AnalyzeFusion(*root, device_info_);
+
+  MlirTransposeFusion fusion(analysis);
+  EXPECT_THAT(
+      fusion.ComputeThreadIdToInputIndexing(0, 0, &mlir_context_)->ToString(),
+      MatchIndexingString(R"(
+        (d0, d1, d2, d3, d4, d5)[s0, s1] -> (
+          d3,
+          d0 floordiv 32 + s0 * 4,
+          (d0 mod 32) * 4 + s1
+        )
+        domain:
+        d0 in [0, 127]
+        d1 in [0, 0]
+        d2 in [0, 0]
+        d3 in [0, 8191]
+        d4 in [0, 0]
+        d5 in [0, 0]
+        s0 in [0, 31]
+        s1 in [0, 3]
+      )"));
+}
+
 TEST_F(MlirTransposeFusionTest, FusedTranspose021) {
   auto kHloString = R"(
     HloModule Transpose
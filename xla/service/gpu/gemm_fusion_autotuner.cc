@@ -28,6 +28,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
@@ -70,6 +71,7 @@ limitations under the License.
 #include "xla/service/gpu/ir_emission_utils.h"
 #include "xla/service/gpu/matmul_utils.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/gpu_performance_model_base.h"
 #include "xla/service/gpu/priority_fusion.h"
 #include "xla/service/gpu/split_k_gemm_rewriter.h"
 #include "xla/service/gpu/stream_executor_util.h"
@@ -82,7 +84,10 @@ limitations under the License.
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/gpu/redzone_allocator.h"
+#include "xla/stream_executor/platform.h"
+#include "xla/stream_executor/platform_manager.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
 #include "xla/stream_executor/stream_executor_memory_allocator.h"
 #include "xla/tools/hlo_decomposer.h"
 #include "xla/tsl/util/proto/proto_utils.h"
@@ -91,6 +96,7 @@ limitations under the License.
 #include "xla/xla_data.pb.h"
 #include "tsl/lib/core/bits.h"
 #include "tsl/platform/blocking_counter.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/protobuf.h"
@@ -139,8 +145,13 @@ using AutoTuneCacheKeyCount = absl::flat_hash_map<AutotuneCacheKey, uint64_t>;
 
 class GemmFusionAutotunerVisitor : public DfsHloRewriteVisitor {
  public:
-  explicit GemmFusionAutotunerVisitor(const AutotuneConfig& config)
-      : config_(config) {}
+  // `fallback_results` are used instead of the autotune caches for the fusions
+  // they contain. They are not added to the caches.
+  explicit GemmFusionAutotunerVisitor(
+      const AutotuneConfig& config,
+      absl::flat_hash_map<AutotuneCacheKey, AutotuneResult> fallback_results =
+          {})
+      : config_(config), fallback_results_(std::move(fallback_results)) {}
 
   absl::Status HandleFusion(HloInstruction* hlo) override {
     TF_ASSIGN_OR_RETURN(auto gpu_config,
@@ -155,18 +166,26 @@ class GemmFusionAutotunerVisitor : public DfsHloRewriteVisitor {
     VLOG(4) << "Processing " << hlo->ToString();
     if (!backend_config.has_triton_gemm_config() &&
         !backend_config.has_cudnn_fusion_config()) {
-      TF_ASSIGN_OR_RETURN(
-          AutotuneResult autotune_result,
-          AutotunerUtil::Autotune(
-              hlo, config_, [&]() -> absl::StatusOr<AutotuneResult> {
-                if (config_.IsDeviceless()) {
-                  return absl::InternalError(absl::StrCat(
-                      "Expect autotune result cache hit for deviceless "
-                      "compilation (HLO: ",
-                      hlo->ToString(), ")"));
-                }
-                return absl::InternalError("Expect autotune result cache hit.");
-              }));
+      AutotuneResult autotune_result;
+      if (auto fallback =
+              fallback_results_.find(AutotunerUtil::GetKey(hlo, config_));
+          fallback != fallback_results_.end()) {
+        autotune_result = fallback->second;
+      } else {
+        TF_ASSIGN_OR_RETURN(
+            autotune_result,
+            AutotunerUtil::Autotune(
+                hlo, config_, [&]() -> absl::StatusOr<AutotuneResult> {
+                  if (config_.IsDeviceless()) {
+                    return absl::InternalError(absl::StrCat(
+                        "Expect autotune result cache hit for deviceless "
+                        "compilation (HLO: ",
+                        hlo->ToString(), ")"));
+                  }
+                  return absl::InternalError(
+                      "Expect autotune result cache hit.");
+                }));
+      }
       VLOG(4) << "Result: " << autotune_result.ShortDebugString();
 
       if (autotune_result.has_triton()) {
@@ -205,6 +224,7 @@ class GemmFusionAutotunerVisitor : public DfsHloRewriteVisitor {
 
  private:
   AutotuneConfig config_;
+  absl::flat_hash_map<AutotuneCacheKey, AutotuneResult> fallback_results_;
 };
 
 class GemmConfigSetCollector : public ConstDfsHloVisitorWithDefault {
@@ -326,9 +346,105 @@ absl::StatusOr<TileSizeLimit> GetLimits(const HloDotInstruction& dot) {
 
 int GetLogEveryN() { return VLOG_IS_ON(3) ? 100 : 1000; }
 
-absl::StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneExtractor(
-    const TritonGemmConfig& config,
-    const se::DeviceDescription& gpu_device_info,
+// Estimates the run time of `dot` emitted by Triton with `config`, from the
+// compute throughput and memory bandwidth of `device_info`. The estimate is
+// only meant to rank tilings of the same dot against each other: it accounts
+// for padding to whole tiles, operand re-reads by every tile, split-K partial
+// results and wave quantization, and ignores everything else.
+absl::StatusOr<absl::Duration> EstimateTritonGemmRunTime(
+    const HloDotInstruction& dot, const TritonGemmConfig& config,
+    const se::DeviceDescription& device_info) {
+  TF_ASSIGN_OR_RETURN(int64_t lhs_non_contracting_index,
+                      NonContractingDimensionIndex(dot, /*operand_number=*/0));
+  TF_ASSIGN_OR_RETURN(int64_t rhs_non_contracting_index,
+                      NonContractingDimensionIndex(dot, /*operand_number=*/1));
+  TF_ASSIGN_OR_RETURN(int64_t contracting_index,
+                      ContractingDimensionIndex(dot, /*operand_number=*/0));
+  const Shape& lhs_shape = dot.operand(0)->shape();
+  const Shape& rhs_shape = dot.operand(1)->shape();
+  const int64_t m = lhs_shape.dimensions(lhs_non_contracting_index);
+  const int64_t n = rhs_shape.dimensions(rhs_non_contracting_index);
+  const int64_t k = lhs_shape.dimensions(contracting_index);
+  int64_t batch = 1;
+  for (int64_t dim : dot.dot_dimension_numbers().lhs_batch_dimensions()) {
+    batch *= lhs_shape.dimensions(dim);
+  }
+  const int64_t lhs_element_size =
+      ShapeUtil::ByteSizeOfPrimitiveType(lhs_shape.element_type());
+  const int64_t rhs_element_size =
+      ShapeUtil::ByteSizeOfPrimitiveType(rhs_shape.element_type());
+  const int64_t output_element_size =
+      ShapeUtil::ByteSizeOfPrimitiveType(dot.shape().element_type());
+
+  const int64_t num_blocks = batch * CeilOfRatio<int64_t>(m, config.block_m) *
+                             CeilOfRatio<int64_t>(n, config.block_n) *
+                             config.split_k;
+  const int64_t padded_k = RoundUpTo<int64_t>(
+      CeilOfRatio<int64_t>(k, config.split_k), config.block_k);
+
+  // Every block reads a [block_m, padded_k] slab of the LHS and a
+  // [padded_k, block_n] slab of the RHS.
+  const int64_t bytes_read_net =
+      batch * k * (m * lhs_element_size + n * rhs_element_size);
+  const int64_t bytes_read_total =
+      num_blocks * padded_k *
+      (config.block_m * lhs_element_size + config.block_n * rhs_element_size);
+  // With split-K every split writes a partial result that is reduced later.
+  const int64_t bytes_written =
+      batch * m * n * output_element_size * config.split_k;
+  const absl::Duration memory_access_time =
+      GpuPerformanceModelBase::ReadTime(device_info, num_blocks,
+                                        bytes_read_net, bytes_read_total) +
+      GpuPerformanceModelBase::WriteTime(device_info, bytes_written);
+
+  // Blocks run in waves of at most one block per core, and the last partial
+  // wave takes as long as a full one.
+  const int64_t flops_per_block =
+      2 * int64_t{config.block_m} * config.block_n * padded_k;
+  const int64_t active_blocks =
+      std::min<int64_t>(num_blocks, device_info.core_count());
+  const int64_t num_waves = CeilOfRatio<int64_t>(num_blocks, active_blocks);
+  const absl::Duration compute_time = GpuPerformanceModelBase::ComputeTime(
+      device_info, num_waves * active_blocks * flops_per_block, num_blocks,
+      config.num_warps * WarpSize());
+
+  return GpuPerformanceModelBase::CombineComputeAndMemoryAccessTime(
+      compute_time, memory_access_time, GpuPerformanceModelOptions::Default());
+}
+
+// Keeps only the `max_configs` configs of `configs` with the lowest estimated
+// run time, ordered from fastest to slowest. Configs that the model can not
+// estimate are ranked last.
+absl::Status KeepFastestTritonConfigs(const HloDotInstruction& dot,
+                                      const se::DeviceDescription& device_info,
+                                      int max_configs,
+                                      std::vector<TritonGemmConfig>& configs) {
+  std::vector<std::pair<absl::Duration, TritonGemmConfig>> ranked;
+  ranked.reserve(configs.size());
+  for (const TritonGemmConfig& config : configs) {
+    absl::StatusOr<absl::Duration> run_time =
+        EstimateTritonGemmRunTime(dot, config, device_info);
+    if (!run_time.ok()) {
+      return run_time.status();
+    }
+    ranked.emplace_back(*run_time, config);
+  }
+  absl::c_stable_sort(ranked, [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  ranked.erase(ranked.begin() + max_configs, ranked.end());
+  configs.clear();
+  for (auto& [run_time, config] : ranked) {
+    VLOG(10) << "Keeping " << config.ToString()
+             << ", estimated run time: " << run_time;
+    configs.push_back(std::move(config));
+  }
+  return absl::OkStatus();
+}
+
+// Extracts the fusion into a new module, which doesn't depend on the Triton
+// config yet and can be shared by all Triton candidates of the fusion.
+absl::StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneModule(
     const HloFusionInstruction* fusion, DebugOptions debug_opts,
     bool allow_filtering_kernels_spilling_registers) {
   std::unique_ptr<HloModule> new_module =
@@ -341,7 +457,13 @@ absl::StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneExtractor(
         false);
   }
   new_module->mutable_config().set_debug_options(debug_opts);
+  return new_module;
+}
 
+// Sets `config` on a module created by TritonGemmAutotuneModule.
+absl::Status ApplyTritonGemmConfig(const TritonGemmConfig& config,
+                                   const se::DeviceDescription& gpu_device_info,
+                                   HloModule* new_module) {
   HloComputation* entry_computation = new_module->entry_computation();
   HloInstruction* cloned_dot_fusion = entry_computation->root_instruction();
 
@@ -358,7 +480,7 @@ absl::StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneExtractor(
     GpuFloatSupport bf16_support(gpu_device_info.cuda_compute_capability(),
                                  BF16);
     FloatNormalization float_normalization(&bf16_support);
-    TF_RETURN_IF_ERROR(float_normalization.Run(new_module.get()).status());
+    TF_RETURN_IF_ERROR(float_normalization.Run(new_module).status());
 
     auto shape_size_function = [&](const Shape& shape) {
       // The real pointer size is set in GpuCompiler. In HloCostAnalysis, the
@@ -373,13 +495,27 @@ absl::StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneExtractor(
         GpuHloCostAnalysis::Options{/*shape_size=*/shape_size_function,
                                     /*per_second_rates=*/{},
                                     /*count_multiple_input_accesses=*/true});
-    TF_RETURN_IF_ERROR(priority_fusion.Run(new_module.get()).status());
+    TF_RETURN_IF_ERROR(priority_fusion.Run(new_module).status());
 
     // If the priority fusion pass above skipped some instructions, turn them
     // into fusions.
     FusionWrapper fusion_wrapper;
-    TF_RETURN_IF_ERROR(fusion_wrapper.Run(new_module.get()).status());
+    TF_RETURN_IF_ERROR(fusion_wrapper.Run(new_module).status());
   }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneExtractor(
+    const TritonGemmConfig& config,
+    const se::DeviceDescription& gpu_device_info,
+    const HloFusionInstruction* fusion, DebugOptions debug_opts,
+    bool allow_filtering_kernels_spilling_registers) {
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<HloModule> new_module,
+      TritonGemmAutotuneModule(fusion, std::move(debug_opts),
+                               allow_filtering_kernels_spilling_registers));
+  TF_RETURN_IF_ERROR(
+      ApplyTritonGemmConfig(config, gpu_device_info, new_module.get()));
   return new_module;
 }
 
@@ -428,21 +564,24 @@ absl::StatusOr<std::unique_ptr<HloModule>> FusionExtractor(
   return module;
 }
 
-absl::StatusOr<std::unique_ptr<HloModule>> CuDnnFusionExtractor(
-    const HloFusionInstruction& fusion, const DebugOptions& debug_opts,
-    const int plan_id) {
-  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
-                      FusionExtractor(fusion, debug_opts));
-
+// Sets the cuDNN plan `plan_id` on a module created by FusionExtractor.
+absl::Status ApplyCuDnnPlan(const int plan_id, HloModule* module) {
   GpuBackendConfig gpu_config;
   FusionBackendConfig& backend_config =
       *gpu_config.mutable_fusion_backend_config();
   backend_config.set_kind(std::string(kCuDnnFusionKind));
   // Provided a plan ID the autotuner just compiles one plan.
   backend_config.mutable_cudnn_fusion_config()->set_plan_id(plan_id);
-  TF_RETURN_IF_ERROR(
-      module->entry_computation()->root_instruction()->set_backend_config(
-          gpu_config));
+  return module->entry_computation()->root_instruction()->set_backend_config(
+      gpu_config);
+}
+
+absl::StatusOr<std::unique_ptr<HloModule>> CuDnnFusionExtractor(
+    const HloFusionInstruction& fusion, const DebugOptions& debug_opts,
+    const int plan_id) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                      FusionExtractor(fusion, debug_opts));
+  TF_RETURN_IF_ERROR(ApplyCuDnnPlan(plan_id, module.get()));
   return module;
 }
 
@@ -626,12 +765,69 @@ absl::StatusOr<std::vector<Config>> GemmFusionAutotunerImpl::GenerateConfigs(
   // Add triton configs.
   TF_ASSIGN_OR_RETURN(std::vector<TritonGemmConfig> triton_configs,
                       GenerateTritonConfigs(*dot));
+  const int max_triton_configs =
+      debug_options_.xla_gpu_autotune_max_triton_gemm_configs();
+  if (max_triton_configs > 0 && triton_configs.size() > max_triton_configs &&
+      !config_.IsDeviceless() && IsAutotuningEnabled()) {
+    const int64_t num_generated = triton_configs.size();
+    TF_RETURN_IF_ERROR(KeepFastestTritonConfigs(
+        *dot, config_.GetExecutor()->GetDeviceDescription(),
+        max_triton_configs, triton_configs));
+    const int64_t num_pruned = num_generated - triton_configs.size();
+    num_pruned_configs_[&fusion] = num_pruned;
+    VLOG(1) << "Pruned " << num_pruned << " of " << num_generated
+            << " Triton configs for " << fusion.name() << " ("
+            << 100 * num_pruned / num_generated << "%).";
+  }
   for (TritonGemmConfig& config : triton_configs) {
     configs.push_back(std::move(config));
   }
+
+  if (debug_options_.xla_gpu_autotune_verify_nearest_cached_config() &&
+      IsAutotuningEnabled()) {
+    TF_RETURN_IF_ERROR(KeepNearestCachedConfig(fusion, configs));
+  }
   return configs;
 }
 
+absl::Status GemmFusionAutotunerImpl::KeepNearestCachedConfig(
+    const HloFusionInstruction& fusion, std::vector<Config>& configs) const {
+  std::optional<AutotuneResult> nearest = AutotunerUtil::FindNearestResult(
+      AutotunerUtil::GetKey(&fusion, config_));
+  if (!nearest.has_value() || !nearest->has_triton()) {
+    return absl::OkStatus();
+  }
+  TF_ASSIGN_OR_RETURN(TritonGemmConfig cached,
+                      TritonGemmConfig::FromProto(nearest->triton()));
+  auto is_triton_config = [](const Config& config,
+                             const TritonGemmConfig& triton_config) {
+    return std::holds_alternative<TritonGemmConfig>(config) &&
+           std::get<TritonGemmConfig>(config) == triton_config;
+  };
+  // The cached config was tuned for other shapes, so it's only reused if it's
+  // still valid for this fusion, i.e. among the generated configs.
+  if (absl::c_none_of(configs, [&](const Config& config) {
+        return is_triton_config(config, cached);
+      })) {
+    VLOG(1) << "Nearest cached config " << cached.ToString()
+            << " is not applicable to " << fusion.name();
+    return absl::OkStatus();
+  }
+  const int64_t num_generated = configs.size();
+  configs.erase(
+      std::remove_if(configs.begin(), configs.end(),
+                     [&](const Config& config) {
+                       return !std::holds_alternative<CuBlasConfig>(config) &&
+                              !is_triton_config(config, kDefaultGemmTiling) &&
+                              !is_triton_config(config, cached);
+                     }),
+      configs.end());
+  VLOG(1) << "Verifying nearest cached config " << cached.ToString()
+          << " for " << fusion.name() << " with " << configs.size() << " of "
+          << num_generated << " configs.";
+  return absl::OkStatus();
+}
+
 absl::StatusOr<std::vector<TritonGemmConfig>>
 GemmFusionAutotunerImpl::GenerateTritonConfigs(const HloDotInstruction& dot) {
   bool has_8_bit_operand = HloAnyOf({&dot}, [&](const HloInstruction* node) {
@@ -752,32 +948,75 @@ GemmFusionAutotunerImpl::CompileAll(AutotunerCompileUtil& compile_util,
     }
   };
 
-  auto compile = [&](const HloFusionInstruction* fusion, const Config& config,
-                     bool allow_filtering_kernels_spilling_registers)
-      -> absl::StatusOr<bool> {
+  // Fusions are extracted into new modules once, together with the parts of
+  // the module preparation which don't depend on the config. Every candidate
+  // then only applies its config to a clone of the prepared module.
+  struct PreparedModules {
+    std::unique_ptr<HloModule> triton;
+    std::unique_ptr<HloModule> cudnn;
+    std::unique_ptr<HloModule> cublas;
+  };
+  absl::flat_hash_map<const HloFusionInstruction*, PreparedModules> prepared;
+  for (const auto& [fusion, configs] : task) {
+    PreparedModules& modules = prepared[fusion];
+    for (const Config& config : configs) {
+      if (std::holds_alternative<TritonGemmConfig>(config) &&
+          modules.triton == nullptr) {
+        TF_ASSIGN_OR_RETURN(
+            modules.triton,
+            compile_util.ExtractModule([&](const DebugOptions& opts) {
+              return TritonGemmAutotuneModule(
+                  fusion, opts,
+                  /*allow_filtering_kernels_spilling_registers=*/
+                  configs.size() > 1);
+            }));
+      } else if (std::holds_alternative<CuDnnConfig>(config) &&
+                 modules.cudnn == nullptr) {
+        TF_ASSIGN_OR_RETURN(
+            modules.cudnn,
+            compile_util.ExtractModule([&](const DebugOptions& opts) {
+              return FusionExtractor(*fusion, opts);
+            }));
+      } else if (std::holds_alternative<CuBlasConfig>(config) &&
+                 modules.cublas == nullptr) {
+        TF_ASSIGN_OR_RETURN(
+            modules.cublas,
+            compile_util.ExtractModule([&](const DebugOptions& opts) {
+              return CublasGemmAutotuneExtractor(config_, toolkit_version_,
+                                                 fusion, opts);
+            }));
+      }
+    }
+  }
+
+  auto compile = [&](const HloFusionInstruction* fusion,
+                     const Config& config) -> absl::StatusOr<bool> {
+    const PreparedModules& modules = prepared.at(fusion);
     std::unique_ptr<Executable> executable;
     if (std::holds_alternative<TritonGemmConfig>(config)) {
       TF_ASSIGN_OR_RETURN(
-          executable, compile_util.Compile([&](const DebugOptions& opts) {
-            return TritonGemmAutotuneExtractor(
-                std::get<TritonGemmConfig>(config),
-                config_.GetExecutor()->GetDeviceDescription(), fusion, opts,
-                allow_filtering_kernels_spilling_registers);
-          }));
+          executable, compile_util.CompileCandidate(
+                          *modules.triton, [&](HloModule& module) {
+                            return ApplyTritonGemmConfig(
+                                std::get<TritonGemmConfig>(config),
+                                config_.GetExecutor()->GetDeviceDescription(),
+                                &module);
+                          }));
     } else if (std::holds_alternative<CuDnnConfig>(config)) {
       executable =
           compile_util
-              .Compile([&](const DebugOptions& opts) {
-                return CuDnnFusionExtractor(
-                    *fusion, opts, std::get<CuDnnConfig>(config).plan_id);
-              })
+              .CompileCandidate(*modules.cudnn,
+                                [&](HloModule& module) {
+                                  return ApplyCuDnnPlan(
+                                      std::get<CuDnnConfig>(config).plan_id,
+                                      &module);
+                                })
               .value_or(nullptr);
     } else if (std::holds_alternative<CuBlasConfig>(config)) {
       TF_ASSIGN_OR_RETURN(executable,
-                          compile_util.Compile([&](const DebugOptions& opts) {
-                            return CublasGemmAutotuneExtractor(
-                                config_, toolkit_version_, fusion, opts);
-                          }));
+                          compile_util.CompileCandidate(
+                              *modules.cublas,
+                              [](HloModule&) { return absl::OkStatus(); }));
     } else {
       LOG(FATAL) << "Unsupported config type: " << config.index();
     }
@@ -819,8 +1058,7 @@ GemmFusionAutotunerImpl::CompileAll(AutotunerCompileUtil& compile_util,
                       "last configuration printed out might not be the one "
                       "causing issues! Use "
                       "--xla_gpu_force_compilation_parallelism=1 to fix.";
-          absl::StatusOr<bool> has_executable =
-              compile(fusion, config, gemm_config_set.size() > 1);
+          absl::StatusOr<bool> has_executable = compile(fusion, config);
           TF_CHECK_OK(has_executable.status())
               << "Failure occured when compiling fusion " << fusion->name()
               << " with config '" << ToString(config)
@@ -850,9 +1088,7 @@ GemmFusionAutotunerImpl::CompileAll(AutotunerCompileUtil& compile_util,
         VLOG(10) << "Trying configuration forceable through: "
                     "--xla_gpu_override_gemm_autotuner='"
                  << Serialize(config) << "'";
-        TF_ASSIGN_OR_RETURN(
-            bool has_executable,
-            compile(fusion, config, gemm_config_set.size() > 1));
+        TF_ASSIGN_OR_RETURN(bool has_executable, compile(fusion, config));
         log(has_executable);
       }
     }
@@ -865,9 +1101,16 @@ GemmFusionAutotunerImpl::CompileAll(AutotunerCompileUtil& compile_util,
 absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
     AutotunerCompileUtil& compile_util, const HloFusionInstruction& fusion,
     absl::Span<const ExecutableCandidate> candidates) {
+  return Profile(compile_util, config_, fusion, candidates);
+}
+
+absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
+    AutotunerCompileUtil& compile_util, const AutotuneConfig& config,
+    const HloFusionInstruction& fusion,
+    absl::Span<const ExecutableCandidate> candidates) {
   const HloComputation* fusion_computation = fusion.called_computations().at(0);
 
-  se::StreamExecutor* stream_exec = config_.GetExecutor();
+  se::StreamExecutor* stream_exec = config.GetExecutor();
   if (!stream_exec->SynchronizeAllActivity()) {
     return Internal("Failed to synchronize GPU for autotuning.");
   }
@@ -875,14 +1118,14 @@ absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
     return absl::StrFormat("XlaAutotunerMeasurement:#hlo_op=%s#",
                            fusion.name());
   });
-  se::DeviceMemoryAllocator* allocator = config_.GetAllocator();
+  se::DeviceMemoryAllocator* allocator = config.GetAllocator();
   std::unique_ptr<se::DeviceMemoryAllocator> owned_allocator;
   if (allocator == nullptr) {
     owned_allocator =
         std::make_unique<se::StreamExecutorMemoryAllocator>(stream_exec);
     allocator = owned_allocator.get();
   }
-  TF_ASSIGN_OR_RETURN(se::Stream* const stream, config_.GetStream());
+  TF_ASSIGN_OR_RETURN(se::Stream* const stream, config.GetStream());
 
   const HloInstruction& root = *fusion_computation->root_instruction();
   BufferComparator comparator(root.shape(),
@@ -890,7 +1133,7 @@ absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
 
   TF_ASSIGN_OR_RETURN(auto rz_buffers,
                       RedzoneBuffers::FromInstruction(
-                          *fusion_computation->FusionInstruction(), config_,
+                          *fusion_computation->FusionInstruction(), config,
                           debug_options_, RedzoneBuffers::kAllInputs));
 
   const int log_every_n = GetLogEveryN();
@@ -908,7 +1151,7 @@ absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
                                          rz_buffers.input_buffers(),
                                          rz_buffers.input_shapes()));
       if (std::holds_alternative<CuBlasConfig>(candidate.config) &&
-          config_.should_check_correctness()) {
+          config.should_check_correctness()) {
         reference_buffer = std::move(profiling_output->output);
       }
 
@@ -944,7 +1187,7 @@ absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
         LOG(ERROR) << "Red zone modified";
         res.mutable_failure()->set_kind(AutotuneResult::REDZONE_MODIFIED);
         res.mutable_failure()->set_msg(rz_check_status.RedzoneFailureMsg());
-        CHECK(!config_.should_crash_on_check_failure());
+        CHECK(!config.should_crash_on_check_failure());
         continue;
       }
 
@@ -958,7 +1201,7 @@ absl::StatusOr<std::vector<AutotuneResult>> GemmFusionAutotunerImpl::Profile(
             "Results do not match the reference. This is likely a "
             "bug/unexpected loss of precision.";
         LOG(ERROR) << kMessage;
-        CHECK(!config_.should_crash_on_check_failure());
+        CHECK(!config.should_crash_on_check_failure());
         // WRONG_RESULT is not taken seriously by PickBestResult(), so
         // use DISQUALIFIED.
         res.mutable_failure()->set_kind(AutotuneResult::DISQUALIFIED);
@@ -1078,6 +1321,127 @@ absl::Status DumpAutotuningLogs(const DebugOptions& debug_opts,
   return absl::OkStatus();
 }
 
+std::vector<std::unique_ptr<AutotuneConfig>>
+GemmFusionAutotunerImpl::GetAdditionalProfilingConfigs() const {
+  std::vector<std::unique_ptr<AutotuneConfig>> configs;
+  se::StreamExecutor* compilation_device = config_.GetExecutor();
+  absl::StatusOr<se::Platform*> platform =
+      se::PlatformManager::PlatformWithId(
+          compilation_device->GetPlatform()->id());
+  if (!platform.ok()) {
+    LOG(WARNING) << "Multi-device autotuning disabled: " << platform.status();
+    return configs;
+  }
+  for (int ordinal = 0; ordinal < (*platform)->VisibleDeviceCount();
+       ++ordinal) {
+    if (ordinal == compilation_device->device_ordinal()) {
+      continue;
+    }
+    absl::StatusOr<se::StreamExecutor*> executor =
+        (*platform)->ExecutorForDevice(ordinal);
+    if (!executor.ok()) {
+      VLOG(1) << "Not autotuning on device " << ordinal << ": "
+              << executor.status();
+      continue;
+    }
+    // Results are cached under the model of the compilation device, so only
+    // identical devices may contribute measurements.
+    if ((*executor)->GetDeviceDescription().model_str() !=
+        config_.GetModelStr()) {
+      VLOG(1) << "Not autotuning on device " << ordinal
+              << ": different model "
+              << (*executor)->GetDeviceDescription().model_str();
+      continue;
+    }
+    configs.push_back(std::make_unique<AutotuneConfig>(
+        DeviceConfig{*executor, /*allocator=*/nullptr}, debug_options_));
+  }
+  return configs;
+}
+
+absl::StatusOr<std::vector<std::vector<AutotuneResult>>>
+GemmFusionAutotunerImpl::ProfileAll(
+    AutotunerCompileUtil& compile_util,
+    const absl::flat_hash_map<const HloFusionInstruction*,
+                              std::vector<ExecutableCandidate>>&
+        executable_sets,
+    absl::Span<const HloFusionInstruction* const> fusions) {
+  std::vector<std::unique_ptr<AutotuneConfig>> additional_configs;
+  if (debug_options_.xla_gpu_multi_device_autotuning() && fusions.size() > 1) {
+    additional_configs = GetAdditionalProfilingConfigs();
+  }
+
+  // Each profiling device is described by its config and the compile util
+  // bound to it; the compilation device always comes first.
+  std::vector<std::pair<const AutotuneConfig*, AutotunerCompileUtil*>> devices;
+  devices.emplace_back(&config_, &compile_util);
+  std::vector<AutotunerCompileUtil> additional_compile_utils;
+  additional_compile_utils.reserve(additional_configs.size());
+  for (const std::unique_ptr<AutotuneConfig>& config : additional_configs) {
+    absl::StatusOr<std::optional<AutotunerCompileUtil>> device_compile_util =
+        AutotunerCompileUtil::Create(*config, debug_options_);
+    if (!device_compile_util.ok() || !device_compile_util->has_value()) {
+      LOG(WARNING) << "Not autotuning on device "
+                   << config->GetExecutor()->device_ordinal() << ": "
+                   << device_compile_util.status();
+      continue;
+    }
+    additional_compile_utils.push_back(**std::move(device_compile_util));
+    devices.emplace_back(config.get(), &additional_compile_utils.back());
+  }
+
+  std::vector<std::optional<std::vector<AutotuneResult>>> results(
+      fusions.size());
+  if (devices.size() > 1) {
+    VLOG(1) << "Profiling " << fusions.size() << " fusions on "
+            << devices.size() << " devices.";
+    // Every device pulls the next unprofiled fusion until none are left. A
+    // device that fails stops pulling work; whatever it left unfinished is
+    // profiled on the compilation device below.
+    std::atomic<int> next_fusion = 0;
+    std::vector<absl::Status> statuses(devices.size());
+    {
+      tsl::thread::ThreadPool profiling_pool(
+          tsl::Env::Default(), "gemm_fusion_profiling", devices.size());
+      for (int d = 0; d < devices.size(); ++d) {
+        profiling_pool.Schedule([&, d] {
+          const auto& [config, device_compile_util] = devices[d];
+          for (int i = next_fusion++; i < fusions.size(); i = next_fusion++) {
+            absl::StatusOr<std::vector<AutotuneResult>> fusion_results =
+                Profile(*device_compile_util, *config, *fusions[i],
+                        executable_sets.at(fusions[i]));
+            if (!fusion_results.ok()) {
+              statuses[d] = fusion_results.status();
+              return;
+            }
+            results[i] = *std::move(fusion_results);
+          }
+        });
+      }
+    }  // Waits for all profiling threads to finish.
+    TF_RETURN_IF_ERROR(statuses[0]);
+    for (int d = 1; d < devices.size(); ++d) {
+      if (!statuses[d].ok()) {
+        LOG(WARNING) << "Autotuning on device "
+                     << devices[d].first->GetExecutor()->device_ordinal()
+                     << " failed, falling back to the compilation device: "
+                     << statuses[d];
+      }
+    }
+  }
+
+  std::vector<std::vector<AutotuneResult>> all_results;
+  all_results.reserve(fusions.size());
+  for (int i = 0; i < fusions.size(); ++i) {
+    if (!results[i].has_value()) {
+      TF_ASSIGN_OR_RETURN(results[i], Profile(compile_util, *fusions[i],
+                                              executable_sets.at(fusions[i])));
+    }
+    all_results.push_back(*std::move(results[i]));
+  }
+  return all_results;
+}
+
 absl::Status GemmFusionAutotunerImpl::Autotune(
     AutotunerCompileUtil& compile_util, const TilingConfigs& gemm_config_sets,
     AutoTuneCacheKeyCount fusion_count_map) {
@@ -1092,11 +1456,20 @@ absl::Status GemmFusionAutotunerImpl::Autotune(
     });
   }
 
+  std::vector<const HloFusionInstruction*> fusions;
+  fusions.reserve(executable_sets.size());
+  for (const auto& [fusion, unused] : executable_sets) {
+    fusions.push_back(fusion);
+  }
+  TF_ASSIGN_OR_RETURN(
+      std::vector<std::vector<AutotuneResult>> fusion_results,
+      ProfileAll(compile_util, executable_sets, fusions));
+
   AutotuningLogs autotuning_logs;
   int fusion_id = 0;
-  for (const auto& [fusion, candidates] : executable_sets) {
-    TF_ASSIGN_OR_RETURN(std::vector<AutotuneResult> results,
-                        Profile(compile_util, *fusion, candidates));
+  for (int i = 0; i < fusions.size(); ++i) {
+    const HloFusionInstruction* fusion = fusions[i];
+    std::vector<AutotuneResult>& results = fusion_results[i];
 
     // The reference config (if it exists) will be the first in the results,
     // due to how sorting the variants work.
@@ -1144,6 +1517,11 @@ absl::Status GemmFusionAutotunerImpl::Autotune(
         auto fusion_count = fusion_key_count->second;
         autotuning_log->set_fusion_count(fusion_count);
       }
+
+      if (auto it = num_pruned_configs_.find(fusion);
+          it != num_pruned_configs_.end()) {
+        autotuning_log->set_num_pruned_configs(it->second);
+      }
     }
   }
 
@@ -1193,6 +1571,131 @@ absl::Status ExchangeResults(KeyValueStoreInterface& key_value_store,
   return absl::OkStatus();
 }
 
+namespace {
+
+// Returns the result to compile `fusion` with until it is autotuned: the
+// Triton config ranked fastest by the cost model, or the first config if there
+// is none or the model can not rank them.
+absl::StatusOr<AutotuneResult> PickFallbackResult(
+    const HloFusionInstruction& fusion, const std::vector<Config>& configs,
+    const se::DeviceDescription& device_info) {
+  TF_RET_CHECK(!configs.empty());
+  std::vector<TritonGemmConfig> triton_configs;
+  for (const Config& config : configs) {
+    if (auto* triton_config = std::get_if<TritonGemmConfig>(&config)) {
+      triton_configs.push_back(*triton_config);
+    }
+  }
+  if (triton_configs.empty()) {
+    return FromConfig(configs.front());
+  }
+  const HloDotInstruction* dot =
+      Cast<HloDotInstruction>(hlo_query::GetFirstInstructionWithOpcode(
+          *fusion.called_computations().at(0), HloOpcode::kDot));
+  if (absl::Status status = KeepFastestTritonConfigs(
+          *dot, device_info, /*max_configs=*/1, triton_configs);
+      !status.ok()) {
+    VLOG(1) << "Can not rank the configs of " << fusion.name() << ": "
+            << status;
+    return FromConfig(configs.front());
+  }
+  return FromConfig(triton_configs.front());
+}
+
+// Autotunes the fusions that were compiled with fallback configs, one batch at
+// a time, and adds the results to the autotune caches.
+class BackgroundAutotuner {
+ public:
+  static BackgroundAutotuner& Get() {
+    static auto* const autotuner = new BackgroundAutotuner();
+    return *autotuner;
+  }
+
+  // Schedules autotuning of `gemm_config_sets` on copies of the fusions, so
+  // that the module can be changed or destroyed in the meantime. Fusions that
+  // are already being autotuned are skipped.
+  void Schedule(const AutotuneConfig& config, int32_t toolkit_version,
+                const DebugOptions& debug_options,
+                const TilingConfigs& gemm_config_sets) {
+    auto modules = std::make_shared<std::vector<std::unique_ptr<HloModule>>>();
+    auto config_sets = std::make_shared<TilingConfigs>();
+    std::vector<AutotuneCacheKey> keys;
+    {
+      absl::MutexLock lock(&mu_);
+      for (const auto& [fusion, configs] : gemm_config_sets) {
+        AutotuneCacheKey key = AutotunerUtil::GetKey(fusion, config);
+        if (!pending_keys_.insert(key).second) {
+          continue;
+        }
+        std::unique_ptr<HloModule> module =
+            ExtractInstructionIntoNewModule(*fusion);
+        config_sets->push_back(
+            {Cast<HloFusionInstruction>(
+                 module->entry_computation()->root_instruction()),
+             configs});
+        modules->push_back(std::move(module));
+        keys.push_back(std::move(key));
+      }
+      if (keys.empty()) {
+        return;
+      }
+      ++num_pending_;
+    }
+    VLOG(1) << "Scheduling background autotuning of " << keys.size()
+            << " fusions.";
+
+    // The allocator of `config` may not outlive the compilation.
+    AutotuneConfig background_config(DeviceConfig{config.GetExecutor()},
+                                     debug_options);
+    pool_.Schedule([this, background_config, toolkit_version, debug_options,
+                    modules, config_sets, keys = std::move(keys)] {
+      absl::Status status = [&]() -> absl::Status {
+        TF_ASSIGN_OR_RETURN(
+            std::optional<AutotunerCompileUtil> compile_util,
+            AutotunerCompileUtil::Create(background_config, debug_options));
+        TF_RET_CHECK(compile_util.has_value());
+        GemmFusionAutotunerImpl autotuner(background_config, toolkit_version,
+                                          debug_options,
+                                          /*thread_pool=*/nullptr);
+        return autotuner.Autotune(*compile_util, *config_sets, {});
+      }();
+      if (!status.ok()) {
+        LOG(WARNING) << "Background GEMM fusion autotuning failed: " << status;
+      } else {
+        VLOG(1) << "Autotuned " << keys.size() << " fusions in the background.";
+      }
+      absl::MutexLock lock(&mu_);
+      for (const AutotuneCacheKey& key : keys) {
+        pending_keys_.erase(key);
+      }
+      --num_pending_;
+    });
+  }
+
+  void Wait() {
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(
+        +[](int64_t* num_pending) { return *num_pending == 0; },
+        &num_pending_));
+  }
+
+ private:
+  BackgroundAutotuner()
+      : pool_(tsl::Env::Default(), "xla_background_autotuning",
+              /*num_threads=*/1) {}
+
+  tsl::thread::ThreadPool pool_;
+  absl::Mutex mu_;
+  int64_t num_pending_ ABSL_GUARDED_BY(mu_) = 0;
+  absl::flat_hash_set<AutotuneCacheKey> pending_keys_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+/*static*/ void GemmFusionAutotuner::WaitForBackgroundAutotuning() {
+  BackgroundAutotuner::Get().Wait();
+}
+
 absl::StatusOr<bool> GemmFusionAutotuner::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -1234,6 +1737,26 @@ absl::StatusOr<bool> GemmFusionAutotuner::Run(
           tsl::proto_utils::ToDurationProto(absl::ZeroDuration());
       TF_RETURN_IF_ERROR(AutotunerUtil::AddResult(key, res, config_).status());
     }
+  } else if (!config_.IsDeviceless() &&
+             debug_options.xla_gpu_autotune_fallback_on_cache_miss()) {
+    // Compile with untuned configs right away and autotune in the background.
+    absl::flat_hash_map<AutotuneCacheKey, AutotuneResult> fallback_results;
+    for (const auto& [fusion, configs] : gemm_config_sets) {
+      TF_ASSIGN_OR_RETURN(
+          AutotuneResult result,
+          PickFallbackResult(*fusion, configs,
+                             config_.GetExecutor()->GetDeviceDescription()));
+      VLOG(2) << "Fallback for " << fusion->name() << ": "
+              << result.ShortDebugString();
+      fallback_results[AutotunerUtil::GetKey(fusion, config_)] =
+          std::move(result);
+    }
+    if (!gemm_config_sets.empty()) {
+      BackgroundAutotuner::Get().Schedule(config_, toolkit_version_,
+                                          debug_options, gemm_config_sets);
+    }
+    return GemmFusionAutotunerVisitor(config_, std::move(fallback_results))
+        .RunOnModule(module, execution_threads);
   } else if (!config_.IsDeviceless()) {
     TF_ASSIGN_OR_RETURN(std::optional<AutotunerCompileUtil> opt_compile_util,
                         AutotunerCompileUtil::Create(config_, debug_options));
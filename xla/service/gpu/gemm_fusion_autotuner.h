@@ -64,6 +64,10 @@ class GemmFusionAutotuner : public HloModulePass {
       HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
+  // Blocks until the autotuning scheduled in the background on cache misses
+  // (see xla_gpu_autotune_fallback_on_cache_miss) has finished.
+  static void WaitForBackgroundAutotuning();
+
  private:
   const AutotuneConfig config_;
   const int32_t toolkit_version_;
@@ -115,6 +119,13 @@ class GemmFusionAutotunerImpl {
       AutotunerCompileUtil& compile_util, const HloFusionInstruction& fusion,
       absl::Span<const ExecutableCandidate> candidates);
 
+  // Profile all executables for a fusion on the device of `config`, which
+  // `compile_util` must have been created for.
+  absl::StatusOr<std::vector<AutotuneResult>> Profile(
+      AutotunerCompileUtil& compile_util, const AutotuneConfig& config,
+      const HloFusionInstruction& fusion,
+      absl::Span<const ExecutableCandidate> candidates);
+
   // Autotune and save the results to the autotuning cache.
   absl::Status Autotune(
       AutotunerCompileUtil& compile_util, const TilingConfigs& gemm_config_sets,
@@ -131,14 +142,38 @@ class GemmFusionAutotunerImpl {
         config_.GetGpuComputeCapability());
   }
 
+  // Reduces `configs` to the reference and default configs plus the cached
+  // config of the structurally nearest fusion, if there is one and it's among
+  // `configs`. Otherwise leaves `configs` untouched.
+  absl::Status KeepNearestCachedConfig(const HloFusionInstruction& fusion,
+                                       std::vector<Config>& configs) const;
+
   std::vector<TritonGemmConfig> GetDefaultTritonConfigs() const;
   std::vector<TritonGemmConfig> GetExhaustiveTritonConfigs() const;
 
+  // Profiles the candidates of every fusion in `fusions`. With
+  // xla_gpu_multi_device_autotuning the fusions are spread over all local
+  // devices of the same model as the compilation device.
+  absl::StatusOr<std::vector<std::vector<AutotuneResult>>> ProfileAll(
+      AutotunerCompileUtil& compile_util,
+      const absl::flat_hash_map<const HloFusionInstruction*,
+                                std::vector<ExecutableCandidate>>&
+          executable_sets,
+      absl::Span<const HloFusionInstruction* const> fusions);
+
+  // Returns configs for the other local devices that can run executables
+  // compiled for the compilation device and share its autotuning cache key.
+  std::vector<std::unique_ptr<AutotuneConfig>> GetAdditionalProfilingConfigs()
+      const;
+
   const AutotuneConfig config_;
   const int32_t toolkit_version_;
   const DebugOptions debug_options_;
   tsl::thread::ThreadPool* thread_pool_;
   std::vector<TritonGemmConfig> triton_configs_;
+  // Number of Triton configs dropped by cost-model-based pruning, per fusion.
+  absl::flat_hash_map<const HloFusionInstruction*, int64_t>
+      num_pruned_configs_;
 };
 
 }  // namespace gpu
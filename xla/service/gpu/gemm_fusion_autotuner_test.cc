@@ -23,10 +23,12 @@ limitations under the License.
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/algorithm/container.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "third_party/gpus/cuda/include/cuda.h"
 #include "xla/autotuning.pb.h"
 #include "xla/error_spec.h"
@@ -876,6 +878,134 @@ ENTRY e {
       [](const TritonGemmConfig& config) { return config.split_k == 1; }));
 }
 
+class GemmFusionAutotunerMultiDeviceTest : public GemmFusionAutotunerTest {
+ public:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options =
+        GemmFusionAutotunerTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_multi_device_autotuning(true);
+    return debug_options;
+  }
+};
+
+TEST_F(GemmFusionAutotunerMultiDeviceTest, AutotunesAllFusions) {
+  // Two independent GEMM fusions, so that they can be profiled on different
+  // devices if more than one is available.
+  const std::string kHloText = R"(
+HloModule t
+
+ENTRY e {
+  p0 = f16[64,128] parameter(0)
+  p1 = f16[128,256] parameter(1)
+  p2 = f16[32,512] parameter(2)
+  p3 = f16[512,64] parameter(3)
+  d0 = f16[64,256] dot(p0, p1),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  d1 = f16[32,64] dot(p2, p3),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  ROOT t = (f16[64,256], f16[32,64]) tuple(d0, d1)
+})";
+
+  MatchOptimizedHlo(kHloText, R"(
+; CHECK: ENTRY
+; CHECK: kCustom
+; CHECK-SAME: block_m
+; CHECK: kCustom
+; CHECK-SAME: block_m
+)");
+
+  EXPECT_TRUE(RunAndCompare(kHloText, ErrorSpec{/*aabs=*/1e-2, /*arel=*/1e-2}));
+}
+
+TEST_F(GemmFusionAutotunerTest, CostModelPrunesTritonConfigs) {
+  const std::string kHloText = R"(
+HloModule m
+
+%triton_gemm_dot {
+  %p0 = f16[1024,1024]{1,0} parameter(0)
+  %p1 = f16[1024,1024]{1,0} parameter(1)
+  ROOT %dot = f16[1024,1024]{1,0} dot(%p0, %p1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+}
+
+ENTRY %e {
+  %p0 = f16[1024,1024]{1,0} parameter(0)
+  %p1 = f16[1024,1024]{1,0} parameter(1)
+  ROOT %triton = f16[1024,1024]{1,0} fusion(%p0, %p1), kind=kCustom, calls=%triton_gemm_dot,
+    backend_config={"fusion_backend_config":{"kind":"__triton_gemm"}}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHloText));
+  const auto& fusion = *Cast<HloFusionInstruction>(
+      module->entry_computation()->root_instruction());
+
+  auto count_triton_configs =
+      [](absl::Span<const GemmFusionAutotunerImpl::Config> configs) {
+        return absl::c_count_if(configs, [](const auto& config) {
+          return std::holds_alternative<TritonGemmConfig>(config);
+        });
+      };
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  AutotuneConfig autotune_config{
+      DeviceConfig{backend().default_stream_executor(),
+                   backend().memory_allocator()},
+      debug_options};
+
+  GemmFusionAutotunerImpl unpruned(autotune_config, GetToolkitVersion(),
+                                   debug_options, nullptr);
+  TF_ASSERT_OK_AND_ASSIGN(auto unpruned_configs,
+                          unpruned.GenerateConfigs(fusion));
+  ASSERT_GT(count_triton_configs(unpruned_configs), 4);
+
+  debug_options.set_xla_gpu_autotune_max_triton_gemm_configs(4);
+  GemmFusionAutotunerImpl pruned(autotune_config, GetToolkitVersion(),
+                                 debug_options, nullptr);
+  TF_ASSERT_OK_AND_ASSIGN(auto pruned_configs, pruned.GenerateConfigs(fusion));
+  EXPECT_EQ(count_triton_configs(pruned_configs), 4);
+}
+
+TEST_F(GemmFusionAutotunerTest, FallsBackOnCacheMissAndTunesInBackground) {
+  const std::string kHloText = R"(
+HloModule m
+
+%triton_gemm_dot {
+  %p0 = f16[256,512]{1,0} parameter(0)
+  %p1 = f16[512,128]{1,0} parameter(1)
+  ROOT %dot = f16[256,128]{1,0} dot(%p0, %p1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+}
+
+ENTRY %e {
+  %p0 = f16[256,512]{1,0} parameter(0)
+  %p1 = f16[512,128]{1,0} parameter(1)
+  ROOT %triton = f16[256,128]{1,0} fusion(%p0, %p1), kind=kCustom, calls=%triton_gemm_dot,
+    backend_config={"fusion_backend_config":{"kind":"__triton_gemm"}}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHloText));
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_gpu_autotune_fallback_on_cache_miss(true);
+  module->mutable_config().set_debug_options(debug_options);
+  AutotuneConfig autotune_config{
+      DeviceConfig{backend().default_stream_executor(),
+                   backend().memory_allocator()},
+      debug_options};
+  const AutotuneCacheKey key = AutotunerUtil::GetKey(
+      module->entry_computation()->root_instruction(), autotune_config);
+
+  MultiProcessKeyValueStore key_value_store;
+  GemmFusionAutotuner autotuner(autotune_config, GetToolkitVersion(),
+                                /*thread_pool=*/nullptr, key_value_store);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, autotuner.Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_TRUE(module->entry_computation()
+                  ->root_instruction()
+                  ->backend_config<GpuBackendConfig>()
+                  ->fusion_backend_config()
+                  .has_triton_gemm_config());
+
+  GemmFusionAutotuner::WaitForBackgroundAutotuning();
+  TF_ASSERT_OK_AND_ASSIGN(bool is_in_cache,
+                          AutotunerUtil::IsInCache(key, autotune_config));
+  EXPECT_TRUE(is_in_cache);
+}
+
 class GemmFusionAutotunerConfigTest
     : public StatelessAutotunerTest,
       public ::testing::WithParamInterface<bool> {};
@@ -81,6 +81,7 @@ limitations under the License.
 #include "xla/service/broadcast_canonicalizer.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/call_inliner.h"
+#include "xla/service/change_op_data_type.h"
 #include "xla/service/collective_permute_decomposer.h"
 #include "xla/service/collective_pipeliner.h"
 #include "xla/service/collectives_schedule_linearizer.h"
@@ -115,6 +116,7 @@ limitations under the License.
 #include "xla/service/gpu/collective_permute_cycle_decomposer.h"
 #include "xla/service/gpu/command_buffer_scheduling.h"
 #include "xla/service/gpu/compile_module_to_llvm_ir.h"
+#include "xla/service/gpu/concurrent_fusion_annotator.h"
 #include "xla/service/gpu/conv_layout_normalization.h"
 #include "xla/service/gpu/custom_kernel_fusion_rewriter.h"
 #include "xla/service/gpu/dot_dimension_sorter.h"
@@ -151,8 +153,11 @@ limitations under the License.
 #include "xla/service/gpu/kernel_reuse_cache.h"
 #include "xla/service/gpu/matmul_utils.h"
 #include "xla/service/gpu/metrics.h"
+#include "xla/service/gpu/model/collective_performance_table.h"
 #include "xla/service/gpu/model/gpu_cost_model_stats_collection.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/gpu_performance_calibration.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
 #include "xla/service/gpu/move_copy_to_users.h"
 #include "xla/service/gpu/pipelined_p2p_rewriter.h"
 #include "xla/service/gpu/prepare_hlo_for_ir_emitting_pipeline.h"
@@ -185,10 +190,12 @@ limitations under the License.
 #include "xla/service/hlo_pass_pipeline.h"
 #include "xla/service/hlo_rematerialization.h"
 #include "xla/service/hlo_verifier.h"
+#include "xla/service/host_memory_offload_annotations.h"
 #include "xla/service/host_memory_transfer_asyncifier.h"
 #include "xla/service/host_offload_legalize.h"
 #include "xla/service/host_offloader.h"
 #include "xla/service/layout_assignment.h"
+#include "xla/service/layout_assignment_search.h"
 #include "xla/service/layout_normalization.h"
 #include "xla/service/llvm_ir/llvm_util.h"
 #include "xla/service/logistic_expander.h"
@@ -206,6 +213,7 @@ limitations under the License.
 #include "xla/service/result_caster.h"
 #include "xla/service/rng_bit_generator_expander.h"
 #include "xla/service/rng_expander.h"
+#include "xla/service/scatter_determinism_expander.h"
 #include "xla/service/scatter_expander.h"
 #include "xla/service/scatter_simplifier.h"
 #include "xla/service/sharding_remover.h"
@@ -379,7 +387,12 @@ GpuThunkAotCompilationResult::LoadExecutable(
                                   compiler->BufferSizeBytesFunction(),
                                   /*can_share_buffer=*/nullptr));
 
-  ExecutionStreamAssignment execution_stream_assignment(hlo_module.get());
+  ExecutionStreamAssignment execution_stream_assignment(
+      hlo_module.get(),
+      ExecutionStreamAssignmentOptions{
+          hlo_module->config()
+              .debug_options()
+              .xla_gpu_concurrent_fusion_streams()});
 
   std::vector<uint8_t> binary(proto_.binary().begin(), proto_.binary().end());
 
@@ -540,7 +553,10 @@ absl::Status RunPreSPMDPartitionerPasses(HloModule* hlo_module) {
   // The SPMD partitioner would mess up the sort+slice structure, so we need to
   // rewrite Topk before that happens.
   pre_spmd_pipeline.AddPass<TopkRewriter>(
-      [](const HloSortInstruction*, int64_t) { return true; });
+      [](const HloSortInstruction* sort, int64_t) {
+        PrimitiveType type = sort->operand(0)->shape().element_type();
+        return type == F32 || type == BF16;
+      });
 
   return pre_spmd_pipeline.Run(hlo_module).status();
 }
@@ -664,6 +680,9 @@ absl::Status RunOptimizationPasses(
       debug_options.xla_gpu_exclude_nondeterministic_ops()) {
     // Scatter can be indeterministic if indices are not unique or a non
     // associative combiner function is used. Eliminate these Scatter ops.
+    if (debug_options.xla_gpu_enable_scatter_determinism_expander()) {
+      pipeline.AddPass<ScatterDeterminismExpander>();
+    }
     pipeline.AddPass<ScatterExpander>(
         ScatterExpander::kEliminateIndeterministicScatters);
   }
@@ -874,6 +893,27 @@ absl::Status RunCollectiveOptimizationPasses(
         /*reuse_pipelined_op_buffer=*/HloPredicateFalse};
     collectives_pipeline.AddPass<CollectivePipeliner>(config);
   }
+  if (debug_options.xla_gpu_enable_pipelined_host_offloading()) {
+    // Prefetches slices of host-offloaded buffers (e.g. the weights of the next
+    // layer) one loop iteration ahead, so that the host-to-device transfer
+    // created for them by the HostOffloader overlaps with the current layer.
+    CollectivePipeliner::Config config{
+        /*level_to_operate_on=*/0,
+        /*max_pipelining_per_loop=*/INT64_MAX,
+        /*last_run=*/true,
+        /*pipeline_use_tree=*/false,
+        /*process_different_sized_ops=*/true,
+        /*pipelining_direction=*/
+        CollectivePipeliner::PipeliningDirection::kBackward,
+        /*should_process=*/
+        [](const HloInstruction* instr) {
+          return instr->IsCustomCall(
+              host_memory_offload_annotations::kMoveToDeviceCustomCallTarget);
+        },
+        /*acceptable_formatting=*/HloPredicateTrue,
+        /*reuse_pipelined_op_buffer=*/HloPredicateFalse};
+    collectives_pipeline.AddPass<CollectivePipeliner>(config);
+  }
 
   collectives_pipeline.AddPass<CollectivePermuteCycleDecomposer>(
       hlo_module->config()
@@ -904,6 +944,13 @@ absl::Status RunCollectiveOptimizationPasses(
   const std::pair<PrimitiveType, PrimitiveType> ar_promoted_types[] = {
       {U16, U32}, {S16, S32}};
   collectives_pipeline.AddPass<AllReducePromotion>(ar_promoted_types);
+  if (hlo_module->config().debug_options().xla_gpu_enable_bf16_all_gather()) {
+    // Gather f32 values as bf16 and convert them back after the collective.
+    collectives_pipeline.AddPass<ChangeOpDataType>(
+        F32, BF16, [](const HloInstruction* instr) {
+          return instr->opcode() == HloOpcode::kAllGather;
+        });
+  }
   // Remove dead computations left over after ar/rs promotion.
   collectives_pipeline.AddPass<HloDCE>();
 
@@ -934,9 +981,24 @@ absl::Status RunLayoutAssignmentPasses(HloModule* hlo_module,
   // be flattened.
   pipeline.AddPass<FlattenCallGraph>();
   ChannelLayoutConstraints layout_constraints;
-  pipeline.AddPass<GpuLayoutAssignment>(
-      hlo_module->mutable_entry_computation_layout(), gpu_version, dnn_version,
-      &layout_constraints);
+  const int64_t layout_search_max_candidates =
+      hlo_module->config()
+          .debug_options()
+          .xla_gpu_layout_search_max_candidates();
+  if (layout_search_max_candidates > 0) {
+    pipeline.AddPass<LayoutAssignmentSearch>(
+        [gpu_version, dnn_version](HloModule* module,
+                                   ChannelLayoutConstraints* constraints) {
+          return std::make_unique<GpuLayoutAssignment>(
+              module->mutable_entry_computation_layout(), gpu_version,
+              dnn_version, constraints);
+        },
+        &layout_constraints, layout_search_max_candidates);
+  } else {
+    pipeline.AddPass<GpuLayoutAssignment>(
+        hlo_module->mutable_entry_computation_layout(), gpu_version,
+        dnn_version, &layout_constraints);
+  }
   // Run SubByteNormalization because GpuLayoutAssignment may modify a
   // Layout's element_size_in_bits field.
   pipeline.AddPass<SubByteNormalization>(
@@ -969,8 +1031,15 @@ absl::Status RunFusionPasses(HloModule* hlo_module,
     TF_RETURN_IF_ERROR(post_fusion_analysis.Run(hlo_module).status());
   }
 
-  TF_RETURN_IF_ERROR(
-      HorizontalFusionPipeline(gpu_device_info).Run(hlo_module).status());
+  if (VLOG_IS_ON(2)) {
+    HloFusionStatsVisitor stats;
+    TF_RETURN_IF_ERROR(hlo_module->entry_computation()->Accept(&stats));
+    VLOG(2) << "Before horizontal fusion: " << stats.ToString();
+  }
+
+  TF_RETURN_IF_ERROR(HorizontalFusionPipeline(gpu_device_info, shape_size_fn)
+                         .Run(hlo_module)
+                         .status());
 
   if (VLOG_IS_ON(2)) {
     HloFusionStatsVisitor stats;
@@ -987,17 +1056,35 @@ absl::Status RunPostFusionPasses(
         add_custom_kernel_replacement_passes) {
   const DebugOptions& opts = hlo_module->config().debug_options();
 
+  // Maybe lower combine thresholds to sizes that still benefit from combining
+  // according to the measured collective performance.
+  std::optional<CollectivePerformanceTable> collective_performance_table;
+  if (opts.xla_gpu_enable_profile_guided_combine_threshold()) {
+    collective_performance_table = ReadCollectivePerformanceTable(opts);
+  }
+  auto combine_threshold_bytes = [&](HloOpcode opcode, int64_t threshold) {
+    if (!collective_performance_table.has_value()) return threshold;
+    return GetCombineThresholdBytes(*hlo_module, opcode,
+                                    *collective_performance_table, threshold);
+  };
+
   HloPassPipeline pipeline("post-fusion optimization");
   pipeline.AddPass<RenameFusions>();
   pipeline.AddPass<AllGatherCombiner>(
-      opts.xla_gpu_all_gather_combine_threshold_bytes(),
+      combine_threshold_bytes(
+          HloOpcode::kAllGather,
+          opts.xla_gpu_all_gather_combine_threshold_bytes()),
       /*combine_threshold_count=*/256,
       opts.xla_gpu_enable_all_gather_combine_by_dim());
   pipeline.AddPass<AllReduceCombiner>(
-      opts.xla_gpu_all_reduce_combine_threshold_bytes(),
+      combine_threshold_bytes(
+          HloOpcode::kAllReduce,
+          opts.xla_gpu_all_reduce_combine_threshold_bytes()),
       /*combine_threshold_count=*/256);
   pipeline.AddPass<ReduceScatterCombiner>(
-      opts.xla_gpu_reduce_scatter_combine_threshold_bytes(),
+      combine_threshold_bytes(
+          HloOpcode::kReduceScatter,
+          opts.xla_gpu_reduce_scatter_combine_threshold_bytes()),
       /*combine_threshold_count=*/256,
       opts.xla_gpu_enable_reduce_scatter_combine_by_dim());
 
@@ -1096,7 +1183,8 @@ absl::Status RunPostFusionCollectiveOptimizationPasses(HloModule* hlo_module) {
 absl::Status RunPostFusionSimplificationPasses(
     HloModule* hlo_module,
     const AlgebraicSimplifierOptions& layout_insensitive_algsimp_opts,
-    se::GpuComputeCapability gpu_version) {
+    se::GpuComputeCapability gpu_version,
+    const se::DeviceDescription& device_description) {
   HloPassPipeline pipeline("post-fusion-simplification-pipeline optimization");
   AlgebraicSimplifierOptions options = layout_insensitive_algsimp_opts;
   options.set_is_layout_sensitive(true);
@@ -1108,9 +1196,13 @@ absl::Status RunPostFusionSimplificationPasses(
   pipeline.AddPass<HloComputationDeduplicator>(
       /*mark_fusion_duplications=*/true);
 
-  if (hlo_module->config()
-          .debug_options()
-          .xla_gpu_multi_streamed_windowed_einsum()) {
+  const DebugOptions& debug_options = hlo_module->config().debug_options();
+  if (debug_options.xla_gpu_concurrent_fusion_streams() > 0) {
+    pipeline.AddPass<ConcurrentFusionAnnotator>(
+        device_description, debug_options.xla_gpu_concurrent_fusion_streams());
+  }
+  if (debug_options.xla_gpu_multi_streamed_windowed_einsum() ||
+      debug_options.xla_gpu_concurrent_fusion_streams() > 0) {
     pipeline.AddPass<StreamAttributeAnnotator>();
     pipeline.AddPass<StreamAttributeAsyncWrapper>();
   }
@@ -1238,7 +1330,8 @@ absl::Status GpuCompiler::OptimizeHloModule(
       }));
   TF_RETURN_IF_ERROR(RunPostFusionCollectiveOptimizationPasses(hlo_module));
   TF_RETURN_IF_ERROR(RunPostFusionSimplificationPasses(
-      hlo_module, layout_insensitive_algsimp_opts, gpu_version));
+      hlo_module, layout_insensitive_algsimp_opts, gpu_version,
+      gpu_target_config.device_description));
 
   TF_RETURN_IF_ERROR(RunPostFusionVerificationPasses(
       hlo_module, stream_exec, options, gpu_target_config));
@@ -1389,7 +1482,8 @@ absl::Status GpuCompiler::OptimizeHloPostLayoutAssignment(
     bool ignore_small_reduce_dims =
         !debug_options.xla_gpu_enable_priority_fusion();
     pipeline.AddPass<HloPassFix<ReductionSplitter>>(ignore_small_reduce_dims);
-    pipeline.AddPass<HloPassFix<GpuTreeReductionRewriter>>(gpu_version);
+    pipeline.AddPass<HloPassFix<GpuTreeReductionRewriter>>(
+        gpu_target_config.device_description);
     TF_RETURN_IF_ERROR(pipeline.Run(hlo_module).status());
   }
 
@@ -1450,7 +1544,8 @@ absl::Status GpuCompiler::OptimizeHloPostLayoutAssignment(
   pipeline.AddPass<HloCSE>(/*is_layout_sensitive=*/true);
 
   pipeline.AddPass<HostMemoryTransferAsyncifier>(
-      static_cast<int64_t>(stream_executor::MemoryType::kHost));
+      static_cast<int64_t>(stream_executor::MemoryType::kHost),
+      debug_options.xla_gpu_host_prefetch_slice_count());
 
 #ifdef NDEBUG
   // Verify the module in non-debug builds. For debug builds, the verifier
@@ -1518,6 +1613,7 @@ absl::StatusOr<std::unique_ptr<HloModule>> GpuCompiler::RunHloPasses(
     const CompileOptions& options) {
   const DebugOptions debug_opts = module->config().debug_options();
   TF_RETURN_IF_ERROR(LoadAutotuneResultsFromFile(debug_opts));
+  TF_RETURN_IF_ERROR(LoadPerformanceModelCalibrationFromFile(debug_opts));
   bool is_deviceless = options.target_config.has_value() ||
                        !debug_opts.xla_gpu_target_config_filename().empty();
 
@@ -2418,6 +2514,26 @@ absl::Status GpuCompiler::LoadAutotuneResultsFromFile(
   return absl::OkStatus();
 }
 
+absl::Status GpuCompiler::LoadPerformanceModelCalibrationFromFile(
+    const DebugOptions& debug_options) {
+  if (absl::string_view file_path =
+          debug_options.xla_gpu_performance_model_calibration_file();
+      !file_path.empty()) {
+    static absl::once_flag once;
+    absl::Status status = absl::OkStatus();
+    absl::call_once(once, [&file_path, &status] {
+      DevicePerformanceCalibrations calibrations;
+      status = tsl::ReadTextProto(tsl::Env::Default(), std::string(file_path),
+                                  &calibrations);
+      if (status.ok()) {
+        GpuPerformanceCalibrations::Global().Register(calibrations);
+      }
+    });
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
 absl::Status GpuCompiler::SerializeAutotuneResultsToFile(
     const DebugOptions& debug_options) {
   // We are doing this after the timer is finished.
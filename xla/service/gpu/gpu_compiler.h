@@ -205,6 +205,8 @@ class GpuCompiler : public LLVMCompiler {
       const CompileOptions& options, std::optional<int> shard_number);
 
   absl::Status LoadAutotuneResultsFromFile(const DebugOptions& debug_options);
+  absl::Status LoadPerformanceModelCalibrationFromFile(
+      const DebugOptions& debug_options);
   absl::Status SerializeAutotuneResultsToFile(
       const DebugOptions& debug_options);
 
@@ -25,6 +25,7 @@ limitations under the License.
 #include <gtest/gtest.h>
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "xla/autotune_results.pb.h"
@@ -50,6 +51,7 @@ limitations under the License.
 #include "tsl/platform/errors.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/protobuf.h"
+#include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
 
@@ -62,6 +64,7 @@ namespace m = ::xla::match;
 using ::testing::IsEmpty;
 using ::testing::Not;
 using ::testing::TempDir;
+using ::tsl::testing::IsOkAndHolds;
 using ::tsl::testing::StatusIs;
 
 class GpuCompilerTest : public HloTestBase {
@@ -556,6 +559,44 @@ CHECK-SAME:    frontend_attributes={_xla_send_recv_pipeline="0"}
   EXPECT_TRUE(filecheck_matched);
 }
 
+TEST_F(GpuCompilerTest, GathersF32InBf16OnlyWhenEnabled) {
+  const char* kModuleStr = R"(
+HloModule ag, replica_count=2
+
+ENTRY main {
+  p = f32[8,16] parameter(0)
+  ROOT ag = f32[16,16] all-gather(p), replica_groups={{0,1}}, dimensions={0}
+}
+)";
+
+  auto gathered_type = [&](bool enable_bf16_all_gather)
+      -> absl::StatusOr<PrimitiveType> {
+    HloModuleConfig config;
+    DebugOptions debug_options = GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_bf16_all_gather(enable_bf16_all_gather);
+    config.set_debug_options(debug_options);
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                        ParseAndReturnVerifiedModule(kModuleStr, config));
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> optimized_module,
+                        GetOptimizedModule(std::move(module)));
+    for (const HloComputation* computation :
+         optimized_module->computations()) {
+      for (const HloInstruction* instr : computation->instructions()) {
+        if (instr->opcode() == HloOpcode::kAllGather ||
+            instr->opcode() == HloOpcode::kAllGatherStart) {
+          return instr->operand(0)->shape().element_type();
+        }
+      }
+    }
+    return absl::NotFoundError("No all-gather in the optimized module.");
+  };
+
+  EXPECT_THAT(gathered_type(/*enable_bf16_all_gather=*/false),
+              IsOkAndHolds(F32));
+  EXPECT_THAT(gathered_type(/*enable_bf16_all_gather=*/true),
+              IsOkAndHolds(BF16));
+}
+
 class KernelCacheTest : public HloTestBase {
  public:
   void SetUp() override {
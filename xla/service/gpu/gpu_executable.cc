@@ -26,6 +26,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
@@ -50,13 +51,19 @@ limitations under the License.
 #include "xla/service/executable.h"
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/captured_program.h"
+#include "xla/service/gpu/collective_memory_arena.h"
 #include "xla/service/gpu/gpu_constants.h"
 #include "xla/service/gpu/gpu_executable_run_options.h"
+#include "xla/service/gpu/gpu_memory_space_assignment.h"
+#include "xla/service/gpu/kernel_binary_registry.h"
+#include "xla/service/gpu/metrics.h"
 #include "xla/service/gpu/runtime/annotation.h"
 #include "xla/service/gpu/runtime/for_all_thunks.h"
 #include "xla/service/gpu/runtime/nccl_clique.h"
 #include "xla/service/gpu/runtime/nccl_clique_key.h"
 #include "xla/service/gpu/runtime/thunk.h"
+#include "xla/service/gpu/runtime/thunk_sampler.h"
 #include "xla/service/gpu/stream_executor_util.h"
 #include "xla/service/hlo_execution_profile.h"
 #include "xla/service/hlo_module_config.h"
@@ -145,7 +152,6 @@ absl::StatusOr<std::unique_ptr<GpuExecutable>> GpuExecutable::Create(
 GpuExecutable::GpuExecutable(GpuExecutable::Params params)
     : Executable(std::move(params.debug_module)),
       text_(std::move(params.asm_text)),
-      binary_(std::move(params.binary)),
       dnn_compiled_graphs_(std::move(params.dnn_compiled_graphs)),
       gpu_version_(params.gpu_version),
       thunks_(std::move(params.executable)),
@@ -159,17 +165,50 @@ GpuExecutable::GpuExecutable(GpuExecutable::Params params)
       constants_(std::move(params.constants)),
       output_info_(std::move(params.output_info)),
       enable_debug_info_manager_(params.enable_debug_info_manager) {
+  std::vector<uint8_t> binary = std::move(params.binary);
 #if TENSORFLOW_USE_ROCM
   // ROCm uses hsaco hashes to distinguish between modules.
   // Bad things happen if multiple modules with identical code are loaded.
-  binary_.resize(binary_.size() + 16);
-  *(uint64_t*)(&binary_[binary_.size() - 16]) = tsl::EnvTime::NowNanos();
-  *(uint64_t*)(&binary_[binary_.size() - 8]) = tsl::random::New64();
+  binary.resize(binary.size() + 16);
+  *(uint64_t*)(&binary[binary.size() - 16]) = tsl::EnvTime::NowNanos();
+  *(uint64_t*)(&binary[binary.size() - 8]) = tsl::random::New64();
 #endif
+  // Executables sharing a binary also share its loaded module and therefore
+  // its globals, so constants initialized by XLA at load time rule it out.
+  bool can_share_binary =
+      !binary.empty() &&
+      absl::c_all_of(constants_, [](const ConstantInfo& info) {
+        return info.content.span().empty();
+      });
+  binary_ = can_share_binary
+                ? KernelBinaryRegistry::Global().Intern(std::move(binary))
+                : std::make_shared<const std::vector<uint8_t>>(
+                      std::move(binary));
   if (has_module() && enable_debug_info_manager_) {
     XlaDebugInfoManager::Get()->RegisterModule(shared_module(),
                                                buffer_assignment_->ToProto());
   }
+  if (has_module()) {
+    const DebugOptions& debug_options = module_config().debug_options();
+    int64_t period = debug_options.xla_gpu_thunk_sampling_period();
+    int64_t buffer_size = debug_options.xla_gpu_thunk_sampling_buffer_size();
+    if (period > 0 && buffer_size > 0) {
+      thunk_sampler_ = std::make_unique<ThunkSampler>(period, buffer_size);
+    }
+    online_pgle_profiled_executions_ =
+        debug_options.xla_gpu_online_pgle_profiled_executions();
+    if (online_pgle_profiled_executions_ > 0) {
+      // Only the top level thunks are timed, so the sampler has room for all
+      // of them in every profiled execution.
+      online_pgle_sampler_ = std::make_unique<ThunkSampler>(
+          /*sampling_period=*/1,
+          std::max<size_t>(1, thunks_->size() *
+                                  online_pgle_profiled_executions_));
+    }
+    enable_program_capture_ =
+        debug_options.xla_gpu_enable_whole_program_capture() &&
+        IsCapturable(*thunks_);
+  }
 }
 
 GpuExecutable::~GpuExecutable() {
@@ -178,6 +217,19 @@ GpuExecutable::~GpuExecutable() {
   }
 }
 
+CapturedProgram* GpuExecutable::GetCapturedProgram(
+    se::StreamExecutor* executor) {
+  if (!enable_program_capture_) return nullptr;
+
+  absl::MutexLock lock(&captured_programs_mutex_);
+  std::unique_ptr<CapturedProgram>& captured_program =
+      captured_programs_[executor];
+  if (captured_program == nullptr) {
+    captured_program = std::make_unique<CapturedProgram>();
+  }
+  return captured_program.get();
+}
+
 absl::Status GpuExecutable::CheckCompatibilityWithServiceExecutableRunOptions(
     const ServiceExecutableRunOptions* run_options) {
   se::Stream* main_stream = run_options->stream();
@@ -264,7 +316,9 @@ class ResourceRequests : public Thunk::ResourceRequests {
 
     NcclClique::AcquiredCliquesMap cliques_map;
 
-    for (const CliqueRequest& r : GetOrderedCliqueRequests()) {
+    auto acquire = [&](const CliqueRequest& r,
+                       const NcclClique::AcquiredCliquesMap& acquired_cliques)
+        -> absl::StatusOr<std::shared_ptr<NcclClique::Lock>> {
       std::optional<int64_t> rank = r.key.rank(params.global_device_id);
 
       if (!rank.has_value()) {
@@ -278,15 +332,65 @@ class ResourceRequests : public Thunk::ResourceRequests {
           const NcclCliqueIdCallback* clique_id_callback,
           GetNcclCliqueIdCallback(params.nccl_clique_id_callback, is_local));
 
-      int64_t max_channels = r.key.stream_kind() == AsyncStreamKind::kCollective
-                                 ? params.collective_max_nchannels
-                                 : params.p2p_max_nchannels;
-      TF_ASSIGN_OR_RETURN(std::shared_ptr<NcclClique::Lock> clique,
-                          AcquireNcclClique(params.executor, params.run_id,
-                                            r.key, *clique_id_callback, *rank,
-                                            r.num_local_participants,
-                                            cliques_map, max_channels));
+      bool is_p2p = r.key.stream_kind() == AsyncStreamKind::kP2P0 ||
+                    r.key.stream_kind() == AsyncStreamKind::kP2P1;
+      int64_t max_channels = is_p2p ? params.p2p_max_nchannels
+                                    : params.collective_max_nchannels;
+      return AcquireNcclClique(params.executor, params.run_id, r.key,
+                               *clique_id_callback, *rank,
+                               r.num_local_participants, acquired_cliques,
+                               max_channels);
+    };
+
+    // Cliques that can't be created by splitting other requested cliques are
+    // independent, and we acquire them concurrently first to overlap
+    // communicators creation. We release clique locks right after that and
+    // then acquire all cliques in a deterministic order below, because holding
+    // some of the locks while waiting for others can deadlock with
+    // concurrently running executables.
+    //
+    // Every acquisition joins a rendezvous with all clique participants, so
+    // all of them must acquire a clique the same number of times. Whether a
+    // clique is independent depends only on the requests that include all of
+    // its participants, and is the same for all of them. We must not decide
+    // based on process local state (e.g. whether a clique is already
+    // initialized) or on the number of cliques requested by this device, as
+    // other participants might decide differently and wait forever.
+    std::vector<CliqueRequest> requests = GetOrderedCliqueRequests();
+    std::vector<CliqueRequest> independent =
+        GetIndependentRequests(requests);
+
+    if (independent.size() == 1) {
+      TF_RETURN_IF_ERROR(
+          acquire(independent[0], NcclClique::AcquiredCliquesMap()).status());
+
+    } else if (independent.size() > 1) {
+      VLOG(2) << "Concurrently initialize " << independent.size()
+              << " independent collective cliques for global device id "
+              << params.global_device_id.value();
+
+      std::vector<absl::Status> statuses(independent.size());
+      {
+        // Threads are joined when they go out of scope.
+        std::vector<std::unique_ptr<tsl::Thread>> threads;
+        for (size_t i = 0; i < independent.size(); ++i) {
+          threads.emplace_back(tsl::Env::Default()->StartThread(
+              tsl::ThreadOptions(), "initialize_nccl_clique", [&, i] {
+                statuses[i] =
+                    acquire(independent[i], NcclClique::AcquiredCliquesMap())
+                        .status();
+              }));
+        }
+      }
+
+      for (absl::Status& status : statuses) {
+        TF_RETURN_IF_ERROR(status);
+      }
+    }
 
+    for (const CliqueRequest& r : requests) {
+      TF_ASSIGN_OR_RETURN(std::shared_ptr<NcclClique::Lock> clique,
+                          acquire(r, cliques_map));
       cliques_map[r.key] = std::move(clique);
     }
 
@@ -296,6 +400,7 @@ class ResourceRequests : public Thunk::ResourceRequests {
             << params.global_device_id.value() << " in "
             << (end_micros - start_micros) << " μs"
             << "; run_id=" << params.run_id.ToInt();
+    RecordCollectiveCliquesAcquireDuration(end_micros - start_micros);
 
     return Thunk::CollectiveCliques(std::move(cliques_map));
   }
@@ -342,6 +447,21 @@ class ResourceRequests : public Thunk::ResourceRequests {
     return cliques;
   }
 
+  // Returns clique requests that can't be created by splitting any of the
+  // other requested cliques, preserving the order of `requests`.
+  static std::vector<CliqueRequest> GetIndependentRequests(
+      absl::Span<const CliqueRequest> requests) {
+    std::vector<CliqueRequest> independent;
+    for (size_t i = 0; i < requests.size(); ++i) {
+      bool can_split = IsNcclCommSplittingEnabled() &&
+                       absl::c_any_of(requests.first(i), [&](auto& parent) {
+                         return requests[i].key.IsSubsetOf(parent.key);
+                       });
+      if (!can_split) independent.push_back(requests[i]);
+    }
+    return independent;
+  }
+
   absl::flat_hash_map<NcclCliqueKey, CliqueRequest> cliques_;
 };
 
@@ -353,13 +473,58 @@ absl::Status MaybeSyncAndProfile(
 absl::Status RendezvousAfterInitialization(
     const ServiceExecutableRunOptions* run_options);
 
+// A sampled thunk execution whose device time is read once all thunks of the
+// execution have been launched.
+struct PendingThunkSample {
+  const Thunk* thunk;
+  se::gpu::GpuTimer timer;
+};
+
+// Executes `thunk` between the start and end events of a timer. The host does
+// not wait for the thunk, its device time is read by RecordThunkSamples.
+absl::Status ExecuteAndSampleThunk(
+    Thunk& thunk, const Thunk::ExecuteParams& params,
+    std::vector<PendingThunkSample>& pending_samples) {
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  TF_ASSIGN_OR_RETURN(
+      se::Stream * stream,
+      Thunk::GetStreamForExecution(thunk.execution_stream_id(), params));
+  TF_ASSIGN_OR_RETURN(
+      se::gpu::GpuTimer timer,
+      se::gpu::GpuTimer::Create(stream, /*use_delay_kernel=*/false));
+  TF_RETURN_IF_ERROR(thunk.ExecuteOnStream(params));
+  TF_RETURN_IF_ERROR(timer.Stop());
+  pending_samples.push_back({&thunk, std::move(timer)});
+  return absl::OkStatus();
+#else
+  return thunk.ExecuteOnStream(params);
+#endif
+}
+
+// Waits for the sampled thunks of an execution and records their device time
+// in `thunk_sampler`.
+absl::Status RecordThunkSamples(
+    std::vector<PendingThunkSample>& pending_samples,
+    ThunkSampler& thunk_sampler) {
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  for (PendingThunkSample& sample : pending_samples) {
+    TF_ASSIGN_OR_RETURN(absl::Duration device_time,
+                        sample.timer.GetElapsedDuration());
+    thunk_sampler.AddSample({std::string(sample.thunk->profile_annotation()),
+                             sample.thunk->kind(), device_time});
+  }
+#endif
+  return absl::OkStatus();
+}
+
 absl::Status ExecuteThunks(
     const DebugOptions* debug_options, const std::string& module_name,
     ModuleIdentifier module_id, const ThunkSequence& thunk_sequence,
     Thunk::ExecutableSource executable_source,
     const ServiceExecutableRunOptions* run_options,
     const BufferAllocations& buffer_allocations, bool block_host_until_done,
-    const absl::flat_hash_set<ExecutionStreamId>& execution_stream_ids) {
+    const absl::flat_hash_set<ExecutionStreamId>& execution_stream_ids,
+    ThunkSampler* thunk_sampler, CapturedProgram* captured_program) {
   int64_t collective_max_nchannels =
       debug_options ? debug_options->xla_gpu_nccl_collective_max_nchannels()
                     : 0;
@@ -483,14 +648,33 @@ absl::Status ExecuteThunks(
       command_buffer_trace_stream, &collective_params, &collective_cliques,
       std::move(additional_execution_streams));
 
+  if (captured_program) {
+    TF_ASSIGN_OR_RETURN(bool submitted,
+                        captured_program->Submit(thunk_sequence,
+                                                 execute_params));
+    if (submitted) {
+      return MaybeSyncAndProfile(run_options, std::move(execution_timer),
+                                 block_host_until_done ? main_stream : nullptr);
+    }
+  }
+
+  std::vector<PendingThunkSample> pending_samples;
   for (const std::unique_ptr<Thunk>& thunk : thunk_sequence) {
     // Annotate execution of this op if tracing was enabled when we started
     // running this module.  If tracing is enabled *while* we're running the
     // module, we won't get any data, but that's probably an OK trade-off.
     auto scoped_annotation = GetKernelAnnotation(thunk->profile_annotation());
     VLOG(3) << "Executing the thunk for " << thunk->profile_annotation();
+    if (thunk_sampler && thunk_sampler->ShouldSample()) {
+      TF_RETURN_IF_ERROR(
+          ExecuteAndSampleThunk(*thunk, execute_params, pending_samples));
+      continue;
+    }
     TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(execute_params));
   }
+  if (!pending_samples.empty()) {
+    TF_RETURN_IF_ERROR(RecordThunkSamples(pending_samples, *thunk_sampler));
+  }
   return MaybeSyncAndProfile(run_options, std::move(execution_timer),
                              block_host_until_done ? main_stream : nullptr);
 }
@@ -746,6 +930,13 @@ absl::StatusOr<se::DeviceMemoryBase> GpuExecutable::BufferForAllocation(
   }
 }
 
+// Returns true if allocation is a temp buffer in the collective memory space
+// (see `xla_gpu_enable_nccl_user_buffers`).
+static bool IsCollectiveMemoryTempBuffer(const BufferAllocation& allocation) {
+  return allocation.IsPreallocatedTempBuffer() &&
+         allocation.color() == kCollectiveMemorySpaceColor;
+}
+
 static absl::Status CheckAlignment(const BufferAllocation& allocation,
                                    se::DeviceMemoryBase buffer, int arg_idx) {
   const int64_t expected_alignment = [&] {
@@ -781,15 +972,36 @@ absl::StatusOr<BufferAllocations> GpuExecutable::GenerateBufferAllocations(
   buffers.reserve(num_buffers);
   for (int64_t i = 0; i < num_buffers; ++i) {
     const BufferAllocation& allocation = allocations[i];
-    TF_ASSIGN_OR_RETURN(
-        buffers.emplace_back(),
-        BufferForAllocation(arguments, globals, allocations[i],
-                            memory_allocator, device_ordinal, i));
-    TF_RETURN_IF_ERROR(CheckAlignment(allocation, buffers.back(), i));
+    se::DeviceMemoryBase buffer;
+    if (IsCollectiveMemoryTempBuffer(allocation)) {
+      TF_ASSIGN_OR_RETURN(
+          buffer, collective_memory_arena_.Acquire(
+                      memory_allocator, device_ordinal, allocation.size(),
+                      /*memory_space=*/allocation.color()));
+    }
+    if (buffer.is_null()) {
+      TF_ASSIGN_OR_RETURN(
+          buffer, BufferForAllocation(arguments, globals, allocations[i],
+                                      memory_allocator, device_ordinal, i));
+    }
+    buffers.push_back(buffer);
+    TF_RETURN_IF_ERROR(CheckAlignment(allocation, buffer, i));
   }
   return {{buffers, device_ordinal, memory_allocator}};
 }
 
+void GpuExecutable::ReleaseCollectiveMemory(
+    int device_ordinal, BufferAllocations& buffer_allocations) {
+  for (const BufferAllocation& allocation : GetAllocations()) {
+    if (!IsCollectiveMemoryTempBuffer(allocation)) continue;
+    se::DeviceMemoryBase& buffer =
+        buffer_allocations.GetMutableDeviceAddress(allocation.index());
+    if (collective_memory_arena_.Release(device_ordinal, buffer)) {
+      buffer = se::DeviceMemoryBase();
+    }
+  }
+}
+
 absl::StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStream(
     const ServiceExecutableRunOptions* run_options,
     std::vector<ExecutionInput> arguments,
@@ -806,6 +1018,42 @@ absl::StatusOr<ScopedShapedBuffer> GpuExecutable::ExecuteAsyncOnStream(
   return out.ConsumeResult();
 }
 
+void GpuExecutable::SetOnlinePgleCallback(OnlinePgleCallback callback) {
+  std::optional<tensorflow::profiler::ProfiledInstructionsProto> profile;
+  {
+    absl::MutexLock lock(&online_pgle_mutex_);
+    if (!online_pgle_profile_.has_value()) {
+      online_pgle_callback_ = std::move(callback);
+      return;
+    }
+    profile = online_pgle_profile_;
+  }
+  std::move(callback)(*std::move(profile));
+}
+
+void GpuExecutable::FinishOnlinePgleExecution() {
+  // ExecuteThunks waits for the timers of sampled thunks before it returns, so
+  // all samples of an execution are recorded by now.
+  if (online_pgle_finished_executions_.fetch_add(1) + 1 !=
+      online_pgle_profiled_executions_) {
+    return;
+  }
+
+  tensorflow::profiler::ProfiledInstructionsProto profile =
+      online_pgle_sampler_->GetProfiledInstructions();
+  VLOG(1) << "Collected online PGLE profile for " << module_name_ << " with "
+          << profile.costs_size() << " ops after "
+          << online_pgle_profiled_executions_ << " executions";
+
+  OnlinePgleCallback callback;
+  {
+    absl::MutexLock lock(&online_pgle_mutex_);
+    online_pgle_profile_ = profile;
+    callback = std::move(online_pgle_callback_);
+  }
+  if (callback) std::move(callback)(std::move(profile));
+}
+
 absl::StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
     const ServiceExecutableRunOptions* run_options,
     VariantArguments arguments) {
@@ -856,6 +1104,12 @@ absl::StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
       GenerateBufferAllocations(arguments, globals, memory_allocator,
                                 device_ordinal));
   VLOG(3) << buffer_allocations.ToString();
+
+  // Persistent collective memory must be returned to the executable even if
+  // we fail to launch thunks, and before we tear down buffer allocations.
+  absl::Cleanup release_collective_memory = [&] {
+    ReleaseCollectiveMemory(device_ordinal, buffer_allocations);
+  };
   absl::Span<const BufferAllocation> allocations = GetAllocations();
 
   if (VLOG_IS_ON(5)) {
@@ -1008,15 +1262,37 @@ absl::StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
     ScopedModuleAnnotations module_annotations(&module_annotations_);
 
     ModuleIdentifier unique_id = has_module() ? module().unique_id() : -1;
-    Thunk::ExecutableSource executable_source = {text_, binary_,
+    Thunk::ExecutableSource executable_source = {text_, binary(),
                                                  dnn_compiled_graphs_};
 
+    // Profiled executions of online PGLE time every thunk instead of the
+    // regular thunk sampling.
+    ThunkSampler* thunk_sampler = thunk_sampler_.get();
+    bool online_pgle_execution =
+        online_pgle_sampler_ != nullptr &&
+        online_pgle_started_executions_.fetch_add(1) <
+            online_pgle_profiled_executions_;
+    if (online_pgle_execution) thunk_sampler = online_pgle_sampler_.get();
+    // Thunks of a captured program can't be timed one by one, so profiled
+    // executions always launch thunks individually.
+    CapturedProgram* captured_program =
+        online_pgle_execution
+            ? nullptr
+            : GetCapturedProgram(run_options->stream()->parent());
+    // Count the profiled execution as finished even if it fails, otherwise
+    // the profile would never be published.
+    absl::Cleanup finish_online_pgle_execution = [&] {
+      if (online_pgle_execution) FinishOnlinePgleExecution();
+    };
+
     TF_RETURN_IF_ERROR(ExecuteThunks(
         has_module() ? &module_config().debug_options() : nullptr, module_name_,
         unique_id, *thunks_, executable_source, run_options, buffer_allocations,
-        block_host_until_done, execution_stream_ids_));
+        block_host_until_done, execution_stream_ids_, thunk_sampler,
+        captured_program));
   }
 
+  std::move(release_collective_memory).Invoke();
   TF_RETURN_IF_ERROR(
       buffer_allocations.TearDown(buffers_in_result, GetAllocations()));
 
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_GPU_EXECUTABLE_H_
 #define XLA_SERVICE_GPU_GPU_EXECUTABLE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -26,6 +27,7 @@ limitations under the License.
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
@@ -38,9 +40,12 @@ limitations under the License.
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/executable.h"
 #include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/captured_program.h"
+#include "xla/service/gpu/collective_memory_arena.h"
 #include "xla/service/gpu/ir_emission_utils.h"
 #include "xla/service/gpu/runtime/annotation.h"
 #include "xla/service/gpu/runtime/thunk.h"
+#include "xla/service/gpu/runtime/thunk_sampler.h"
 #include "xla/service/hlo_execution_profile.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/service/service_executable_run_options.h"
@@ -52,6 +57,7 @@ limitations under the License.
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/scoped_module_handle.h"
 #include "xla/stream_executor/stream_executor.h"
+#include "tsl/profiler/protobuf/profiled_instructions.pb.h"
 
 namespace xla {
 namespace gpu {
@@ -127,7 +133,7 @@ class GpuExecutable : public Executable {
   // in which case compilation is left up to the GPU driver. If both text() and
   // binary() are empty, that means the HLO required no custom kernels to be
   // compiled.
-  const std::vector<uint8_t>& binary() const { return binary_; }
+  const std::vector<uint8_t>& binary() const { return *binary_; }
 
   const Thunk::BinaryMap& dnn_compiled_graphs() const {
     return dnn_compiled_graphs_;
@@ -173,6 +179,23 @@ class GpuExecutable : public Executable {
     return buffer_assignment_.get();
   }
 
+  // Returns the top level thunks of the executable.
+  const ThunkSequence& thunks() const { return *thunks_; }
+
+  // Returns device time samples of thunk executions, or nullptr if thunk
+  // sampling is disabled (see `xla_gpu_thunk_sampling_period`).
+  const ThunkSampler* thunk_sampler() const { return thunk_sampler_.get(); }
+
+  using OnlinePgleCallback = absl::AnyInvocable<void(
+      tensorflow::profiler::ProfiledInstructionsProto profile) &&>;
+
+  // Registers a callback that receives the profile collected by online PGLE
+  // (see `xla_gpu_online_pgle_profiled_executions`) once all profiled
+  // executions have finished. The callback runs on the thread that finished
+  // the last profiled execution, or on the calling thread if the profile is
+  // already available. It is never called if online PGLE is disabled.
+  void SetOnlinePgleCallback(OnlinePgleCallback callback);
+
  private:
   // Use GpuExecutable::Create() to create an instance.
   explicit GpuExecutable(Params params);
@@ -210,6 +233,12 @@ class GpuExecutable : public Executable {
       se::DeviceMemoryAllocator* memory_allocator, int device_ordinal,
       int64_t arg_idx);
 
+  // Returns persistent collective memory acquired for `buffer_allocations`
+  // back to the executable, and removes it from `buffer_allocations` so that it
+  // is not deallocated at tear down.
+  void ReleaseCollectiveMemory(int device_ordinal,
+                               BufferAllocations& buffer_allocations);
+
   // The LLVM IR, in string format, of the unoptimized module generated for
   // this GpuExecutable. We save a string instead of an llvm::Module* because
   // leaving llvm::Module* in a singleton can cause the heap checker to emit
@@ -225,7 +254,9 @@ class GpuExecutable : public Executable {
   // compute_capability_.
   //
   // May be empty, in which case we leave compilation up to the GPU driver.
-  std::vector<uint8_t> binary_;
+  // Executables with identical binaries may share them, see
+  // KernelBinaryRegistry.
+  std::shared_ptr<const std::vector<uint8_t>> binary_;
 
   Thunk::BinaryMap dnn_compiled_graphs_;
 
@@ -239,6 +270,25 @@ class GpuExecutable : public Executable {
   // Additional execution streams requested by `thunks_`.
   absl::flat_hash_set<ExecutionStreamId> execution_stream_ids_;
 
+  // Records device time of sampled thunk executions if enabled.
+  std::unique_ptr<ThunkSampler> thunk_sampler_;
+
+  // Called after each profiled execution with online PGLE enabled.
+  void FinishOnlinePgleExecution();
+
+  // Times every thunk of the first `online_pgle_profiled_executions_`
+  // executions if online PGLE is enabled.
+  std::unique_ptr<ThunkSampler> online_pgle_sampler_;
+  int64_t online_pgle_profiled_executions_ = 0;
+  std::atomic<int64_t> online_pgle_started_executions_{0};
+  std::atomic<int64_t> online_pgle_finished_executions_{0};
+
+  absl::Mutex online_pgle_mutex_;
+  std::optional<tensorflow::profiler::ProfiledInstructionsProto>
+      online_pgle_profile_ ABSL_GUARDED_BY(online_pgle_mutex_);
+  OnlinePgleCallback online_pgle_callback_
+      ABSL_GUARDED_BY(online_pgle_mutex_);
+
   std::string module_name_;
 
   xla::Shape output_shape_;
@@ -280,6 +330,20 @@ class GpuExecutable : public Executable {
                       std::vector<se::DeviceMemoryBase>>
       module_allocations_ ABSL_GUARDED_BY(module_handle_mutex_);
 
+  // Temp buffers in the collective memory space kept alive across executions.
+  CollectiveMemoryArena collective_memory_arena_;
+
+  // Returns a captured program for `executor`, or nullptr if the thunk
+  // sequence can't be captured into a single command buffer.
+  CapturedProgram* GetCapturedProgram(se::StreamExecutor* executor);
+
+  // True if whole-program capture is enabled and all thunks can be captured.
+  bool enable_program_capture_ = false;
+
+  absl::Mutex captured_programs_mutex_;
+  absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<CapturedProgram>>
+      captured_programs_ ABSL_GUARDED_BY(captured_programs_mutex_);
+
   std::vector<ConstantInfo> constants_;
   const absl::flat_hash_map<ShapeIndex, OutputInfo> output_info_;
   // Retains shared ownership of on-device constants that are managed by XLA and
@@ -708,7 +708,8 @@ FusionDecision FusionFitsInBudget(const HloInstruction& instr1,
                                   const HloInstruction& instr2,
                                   const se::DeviceDescription& device_info,
                                   bool is_consumer_producer_fusion,
-                                  FusionInfoCache* cache /*=nullptr*/) {
+                                  FusionInfoCache* cache /*=nullptr*/,
+                                  bool limit_unnested_reductions /*=true*/) {
   if (SharedMemoryUsage(instr1, cache) + SharedMemoryUsage(instr2, cache) >
       device_info.shared_memory_per_block()) {
     return FusionDecision{}
@@ -716,9 +717,10 @@ FusionDecision FusionFitsInBudget(const HloInstruction& instr1,
            << device_info.shared_memory_per_block() << "B";
   }
 
-  if (NumUnnestedReductions(instr1, cache) +
-          NumUnnestedReductions(instr2, cache) >
-      kMaxUnnestedReductionOutputsPerFusion) {
+  if (limit_unnested_reductions &&
+      NumUnnestedReductions(instr1, cache) +
+              NumUnnestedReductions(instr2, cache) >
+          kMaxUnnestedReductionOutputsPerFusion) {
     return FusionDecision{} << "over " << kMaxUnnestedReductionOutputsPerFusion
                             << " unnested reductions in fusion";
   }
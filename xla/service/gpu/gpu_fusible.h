@@ -123,11 +123,15 @@ bool IsInputFusibleScatter(const HloInstruction& instr);
 // and outputs than is allowed or occupy too much shared memory. If the fusion
 // is a producer/consumer fusion and `instr1` is the consumer and `instr2` is
 // the producer, set consumer_producer_fusion to true to enable more fusion.
+// Set `limit_unnested_reductions` to false to skip the cap on the number of
+// unnested reductions, e.g. if the reductions are known to be emitted as
+// independent reduction groups.
 FusionDecision FusionFitsInBudget(const HloInstruction& instr1,
                                   const HloInstruction& instr2,
                                   const se::DeviceDescription& device_info,
                                   bool is_consumer_producer_fusion = false,
-                                  FusionInfoCache* cache = nullptr);
+                                  FusionInfoCache* cache = nullptr,
+                                  bool limit_unnested_reductions = true);
 
 // Check if fusing producer and consumer will generate a heavy computation, e.g.
 // producer has a complex computation per output and consumer calls this
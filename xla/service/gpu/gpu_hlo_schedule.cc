@@ -50,8 +50,11 @@ limitations under the License.
 #include "xla/service/gpu/gpu_latency_hiding_scheduler.h"
 #include "xla/service/gpu/gpu_schedule_postprocessing.h"
 #include "xla/service/gpu/model/analytical_latency_estimator.h"
+#include "xla/service/gpu/model/collective_performance_table.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_memory_scheduler.h"
 #include "xla/service/hlo_pass_pipeline.h"
+#include "xla/service/hlo_rematerialization.h"
 #include "xla/service/latency_hiding_scheduler.h"
 #include "xla/service/p2p_schedule_preparation.h"
 #include "xla/service/profile_guided_latency_estimator.h"
@@ -501,6 +504,9 @@ absl::StatusOr<ScheduleMetadata> ScheduleGpuModule(
   std::unique_ptr<LatencyEstimator> latency_estimator;
   std::optional<tensorflow::profiler::ProfiledInstructionsProto> profile =
       ReadPGLEProfile(module, fingerprint);
+  // Profiled latencies are looked up by instruction name, so identical
+  // computations are only costed identically without a profile.
+  config.reuse_schedules_of_identical_computations = !profile.has_value();
 
   const bool enable_analytical_latency_estimator =
       module->config()
@@ -524,7 +530,8 @@ absl::StatusOr<ScheduleMetadata> ScheduleGpuModule(
         [input_pointer_size = pointer_size](const Shape& shape) {
           return GetSizeOfShape(shape, input_pointer_size);
         },
-        module->entry_computation());
+        module->entry_computation(),
+        ReadCollectivePerformanceTable(module->config().debug_options()));
     LOG(INFO) << "Using analytical latency estimator";
   } else {
     latency_estimator = std::move(gpu_latency_estimator);
@@ -541,13 +548,39 @@ absl::StatusOr<ScheduleMetadata> ScheduleGpuModule(
   auto shape_size_in_bytes = [pointer_size](const Shape& shape) {
     return GetSizeOfShape(shape, pointer_size);
   };
+  LatencyHidingScheduler::Rematerializer rematerializer = nullptr;
+  if (module->config()
+          .debug_options()
+          .xla_gpu_lhs_enable_rematerialization()) {
+    // Only recomputes single instructions, which the rematerialization cost
+    // model picks by the memory they free per cost of recomputing them.
+    rematerializer = [shape_size_in_bytes](
+                         HloModule* module,
+                         int64_t memory_limit) -> absl::StatusOr<bool> {
+      HloCostAnalysis::Options cost_analysis_options;
+      cost_analysis_options.shape_size = shape_size_in_bytes;
+      HloCostAnalysis cost_analysis(cost_analysis_options);
+      HloRematerialization::Options options(
+          cost_analysis,
+          HloRematerialization::RematerializationModeConfig(
+              /*recompute=*/true, /*compress=*/false, /*host_offload=*/false),
+          memory_limit, /*block_size_limit=*/1,
+          /*block_rematerialization_factor=*/1, /*min_remat_size=*/0,
+          /*compact_shape_function=*/nullptr);
+      HloRematerialization::RematerializationSizes sizes;
+      return HloRematerialization(std::move(options), sizes)
+          .Run(module, /*execution_threads=*/{});
+    };
+  }
+
   HloPassPipeline pipeline("latency-hiding-scheduler");
   auto scheduler_core = std::make_unique<DefaultSchedulerCore>(
       shape_size_in_bytes, async_tracker.get(), latency_estimator.get(),
       config);
   pipeline.AddPass<LatencyHidingScheduler>(
       std::move(latency_estimator), std::move(async_tracker),
-      std::move(scheduler_core), shape_size_in_bytes);
+      std::move(scheduler_core), shape_size_in_bytes,
+      std::move(rematerializer));
 
   TF_RETURN_IF_ERROR(pipeline.Run(module).status());
 
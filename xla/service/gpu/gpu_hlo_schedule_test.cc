@@ -401,6 +401,133 @@ TEST_F(GpuHloScheduleTest, LHSCostModelCostlyAR) {
   EXPECT_TRUE(HasValidFingerprint(module.get()));
 }
 
+TEST_F(GpuHloScheduleTest, LHSCostModelCheapCollective) {
+  const char* hlo_text = R"(
+  HloModule AsyncAR
+  apply_op {
+    x = f32[] parameter(0)
+    y = f32[] parameter(1)
+    ROOT apply_op = f32[] add(x, y)
+  }
+
+  ENTRY ar {
+    p0 = f32[32] parameter(0)
+    p1 = f32[32, 32] parameter(1)
+    p2 = f32[32, 32] parameter(2)
+
+    dot0 = f32[32,32]{1,0} custom-call(p1, p2), custom_call_target="__cublas$gemm"
+    dot1 = f32[32,32]{1,0} custom-call(dot0, p2), custom_call_target="__cublas$gemm"
+    dot2 = f32[32,32]{1,0} custom-call(dot1, p2), custom_call_target="__cublas$gemm"
+    dot3 = f32[32,32]{1,0} custom-call(dot2, p2), custom_call_target="__cublas$gemm"
+    dot4 = f32[32,32]{1,0} custom-call(dot3, p2), custom_call_target="__cublas$gemm"
+    dot5 = f32[32,32]{1,0} custom-call(dot4, p2), custom_call_target="__cublas$gemm"
+    dot6 = f32[32,32]{1,0} custom-call(dot5, p2), custom_call_target="__cublas$gemm"
+
+    ar-start = f32[32] all-reduce-start(p0), to_apply=apply_op
+    ar-done = f32[32] all-reduce-done(ar-start)
+
+    ROOT t = (f32[32], f32[32,32]) tuple(ar-done, dot6)
+  })";
+
+  auto count_overlapped_custom_calls = [&](bool enable_approx_collectives) {
+    HloModuleConfig config =
+        GetModuleConfig(/*enable_latency_hiding_scheduler=*/true);
+    DebugOptions debug_options = config.debug_options();
+    debug_options.set_xla_gpu_enable_approx_costly_collectives(
+        enable_approx_collectives);
+    config.set_debug_options(debug_options);
+    auto module = ParseAndReturnVerifiedModule(hlo_text, config).value();
+    SequentialHloOrdering order = BuildHloOrdering(module.get());
+
+    int64_t count = 0;
+    bool in_between = false;
+    for (const HloInstruction* inst :
+         order.SequentialOrder(*module->entry_computation())->instructions()) {
+      if (inst->opcode() == HloOpcode::kAllReduceStart) {
+        in_between = true;
+      } else if (inst->opcode() == HloOpcode::kAllReduceDone) {
+        in_between = false;
+      } else if (in_between && inst->opcode() == HloOpcode::kCustomCall) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  // A tiny all-reduce is latency bound, so the approximate cost model does not
+  // keep the collective stream busy by packing compute around it.
+  EXPECT_LT(count_overlapped_custom_calls(/*enable_approx_collectives=*/true),
+            count_overlapped_custom_calls(/*enable_approx_collectives=*/false));
+}
+
+TEST_F(GpuHloScheduleTest, LHSAllToAllStream) {
+  const char* hlo_text = R"(
+  HloModule AsyncA2A
+  apply_op {
+    x = f32[] parameter(0)
+    y = f32[] parameter(1)
+    ROOT apply_op = f32[] add(x, y)
+  }
+
+  all_to_all {
+    p0 = f32[32,32] parameter(0)
+    ROOT a2a = f32[32,32] all-to-all(p0), dimensions={0}, replica_groups={}
+  }
+
+  ENTRY a2a {
+    p0 = f32[32] parameter(0)
+    p1 = f32[32, 32] parameter(1)
+    p2 = f32[32, 32] parameter(2)
+    p3 = f32[32, 32] parameter(3)
+
+    dot0 = f32[32,32]{1,0} custom-call(p1, p2), custom_call_target="__cublas$gemm"
+    dot1 = f32[32,32]{1,0} custom-call(dot0, p2), custom_call_target="__cublas$gemm"
+    dot2 = f32[32,32]{1,0} custom-call(dot1, p2), custom_call_target="__cublas$gemm"
+    dot3 = f32[32,32]{1,0} custom-call(dot2, p2), custom_call_target="__cublas$gemm"
+
+    ar-start = f32[32] all-reduce-start(p0), to_apply=apply_op
+    ar-done = f32[32] all-reduce-done(ar-start)
+
+    a2a-start = ((f32[32,32]), f32[32,32]) async-start(p3), calls=all_to_all
+    a2a-done = f32[32,32] async-done(a2a-start)
+
+    ROOT t = (f32[32], f32[32,32], f32[32,32]) tuple(ar-done, a2a-done, dot3)
+  })";
+
+  // Returns whether the all-reduce and the all-to-all are in flight at the
+  // same time.
+  auto collectives_overlap = [&](bool enable_all_to_all_stream) {
+    HloModuleConfig config =
+        GetModuleConfig(/*enable_latency_hiding_scheduler=*/true,
+                        /*enable_gpu_async_tracker=*/true);
+    DebugOptions debug_options = config.debug_options();
+    debug_options.set_xla_gpu_enable_all_to_all_stream(
+        enable_all_to_all_stream);
+    config.set_debug_options(debug_options);
+    auto module = ParseAndReturnVerifiedModule(hlo_text, config).value();
+    SequentialHloOrdering order = BuildHloOrdering(module.get());
+
+    int64_t in_flight = 0;
+    for (const HloInstruction* inst :
+         order.SequentialOrder(*module->entry_computation())->instructions()) {
+      if (inst->opcode() == HloOpcode::kAllReduceStart ||
+          inst->opcode() == HloOpcode::kAsyncStart) {
+        if (++in_flight == 2) {
+          return true;
+        }
+      } else if (inst->opcode() == HloOpcode::kAllReduceDone ||
+                 inst->opcode() == HloOpcode::kAsyncDone) {
+        --in_flight;
+      }
+    }
+    return false;
+  };
+
+  // On its own stream, the all-to-all does not wait for the all-reduce.
+  EXPECT_FALSE(collectives_overlap(/*enable_all_to_all_stream=*/false));
+  EXPECT_TRUE(collectives_overlap(/*enable_all_to_all_stream=*/true));
+}
+
 TEST_F(GpuHloScheduleTest, ProfileGuidedCostModel) {
   const char* hlo_text = R"(
   HloModule AsyncAR
@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/log/log.h"
 #include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/utils/hlo_query.h"
 #include "xla/service/collective_ops_utils.h"
@@ -43,6 +44,11 @@ static constexpr int64_t kCostlyAllReduceThreshold = 30 * 1024 * 1024;
 // Multiplier which we apply to expand the base cost for the costly AR.
 static constexpr int64_t kCostlyAllReduceMultiplier = 4;
 
+// A threshold below which we consider a collective to be latency bound. Such
+// collectives finish quickly, so overlapping them with compute only keeps the
+// async collective stream busy for larger collectives scheduled around them.
+static constexpr int64_t kCheapCollectiveThreshold = 64 * 1024;
+
 // Classifies `hlo` instruction as noop or not.
 bool IsNopInstruction(const HloInstruction& hlo) {
   HloOpcode op = hlo.opcode();
@@ -89,6 +95,29 @@ std::pair<GpuResourceType, ResourceUsageType> GetP2PResourceAndUsage(
   return {resource, usage};
 }
 
+// Returns the total size of the arrays produced by a collective. Variadic
+// collectives return tuples, for which GetSizeOfShape only counts the index
+// table.
+int64_t GetSizeOfCollectiveResult(const Shape& shape, int pointer_size) {
+  int64_t size = 0;
+  ShapeUtil::ForEachSubshape(
+      shape, [&](const Shape& subshape, const ShapeIndex& index) {
+        if (subshape.IsArray()) {
+          size += GetSizeOfShape(subshape, pointer_size);
+        }
+      });
+  return size;
+}
+
+// Returns true if the async all-to-all `instr` runs on the all-to-all stream
+// rather than on the stream shared by the other collectives.
+bool UsesAllToAllStream(const HloInstruction& instr) {
+  return instr.GetModule()
+      ->config()
+      .debug_options()
+      .xla_gpu_enable_all_to_all_stream();
+}
+
 }  // namespace
 
 int64_t GetSizeOfShape(const Shape& shape, int pointer_size) {
@@ -181,6 +210,9 @@ ResourcesVector GpuAsyncTracker::GetResourcesFromInstruction(
       resource = hlo_query::IsCollectiveCommunicationOp(op.inner)
                      ? GpuResourceType::kGpuAsyncStreamCollectives
                      : GpuResourceType::kGpuAsyncStreamComputes;
+      if (op.inner == HloOpcode::kAllToAll && UsesAllToAllStream(instr)) {
+        resource = GpuResourceType::kGpuAsyncStreamAllToAll;
+      }
     }
     return {std::make_pair(
         GetFirstTargetDefinedResource() + static_cast<int64_t>(resource),
@@ -246,6 +278,8 @@ absl::string_view GpuAsyncTracker::GetResourceName(
       return "kGpuAsyncStreamCollectives";
     case GpuResourceType::kGpuAsyncStreamComputes:
       return "kGpuAsyncStreamComputes";
+    case GpuResourceType::kGpuAsyncStreamAllToAll:
+      return "kGpuAsyncStreamAllToAll";
     default:
       return "kUnsupportedResource";
   }
@@ -361,6 +395,11 @@ ApproximateLatencyEstimator::TimeCost GpuLatencyEstimator::GetLatencyBetween(
       return ApproximateLatencyEstimator::kHighLatency *
              kCostlyAllReduceMultiplier;
     }
+    if (enable_approx_collectives &&
+        GetSizeOfCollectiveResult(to.GetInstr().shape(), pointer_size_) <
+            kCheapCollectiveThreshold) {
+      return ApproximateLatencyEstimator::kLowLatency;
+    }
 
     return ApproximateLatencyEstimator::kHighLatency;
   }
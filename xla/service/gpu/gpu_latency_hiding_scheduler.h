@@ -38,7 +38,9 @@ int64_t GetSizeOfShape(const Shape& shape, int pointer_size);
 // We use two different set of resources to model the scheduling of asynchronous
 // collective operations and P2P Send and Recv operations. This corresponds to
 // the fact that the runtime use a stream to run asynchronous collective
-// operations and two other streams to run P2P Send and Recv operations.
+// operations and two other streams to run P2P Send and Recv operations. With
+// xla_gpu_enable_all_to_all_stream, all-to-all operations run on a stream of
+// their own and use a separate resource.
 enum class GpuResourceType {
   kGpuAsyncStreamSend0 = 0,        // A resource for P2P Send operation.
   kGpuAsyncStreamSend1 = 1,        // Another resource for P2P Send operation.
@@ -46,7 +48,8 @@ enum class GpuResourceType {
   kGpuAsyncStreamRecv1 = 3,        // Another resource for P2P Recv operation.
   kGpuAsyncStreamCollectives = 4,  // The resource for collective operations.
   kGpuAsyncStreamComputes = 5,     // The resource for async compute operations.
-  kNumTargetResources = 6,
+  kGpuAsyncStreamAllToAll = 6,     // The resource for all-to-all operations.
+  kNumTargetResources = 7,
 };
 
 // Base GPU async tracker that enables async tracking only for async collectives
@@ -32,6 +32,9 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/primitive_util.h"
 #include "xla/service/gpu/cublas_cudnn.h"
 #include "xla/service/gpu/runtime/cub_sort_thunk.h"
 #include "xla/service/stable_sort_expander.h"
@@ -51,6 +54,9 @@ namespace {
 struct SortComputationAnalysis {
   int key_operand;  // 0 or 1
   bool descending;
+  // Whether floating point keys are compared with the total order, which
+  // orders -0.0 before +0.0 and NaNs by their bits.
+  bool total_order = false;
 };
 
 std::pair<int64_t, int64_t> ParametersFromCmpOperands(
@@ -97,7 +103,9 @@ std::optional<SortComputationAnalysis> AnalyzeCompareOp(
   bool descending = compare->direction() == ComparisonDirection::kGt ||
                     compare->direction() == ComparisonDirection::kGe;
   bool reverse = first_index != index0;
-  return SortComputationAnalysis{first_index / 2, descending != reverse};
+  return SortComputationAnalysis{
+      first_index / 2, descending != reverse,
+      compare->type() == Comparison::Type::kFloatTotalOrder};
 }
 
 // Detects a sort with these properties:
@@ -162,7 +170,16 @@ std::optional<SortComputationAnalysis> AnalyzeComplexSortComputation(
   }
 
   // At this point only the last operand of the select needs to be verified.
-  return AnalyzeCompareOp(root->operand(2));
+  auto result = AnalyzeCompareOp(root->operand(2));
+  if (result.has_value()) {
+    // Keys that are equal under the tie-break comparison must also be equal
+    // under the sort order of the keys.
+    auto* eq_keys_cmp =
+        p0 < 0 ? DynCast<HloCompareInstruction>(eq_cmp->operand(0)) : eq_cmp;
+    result->total_order &=
+        eq_keys_cmp->type() == Comparison::Type::kFloatTotalOrder;
+  }
+  return result;
 }
 
 std::optional<SortComputationAnalysis> AnalyzeSortOp(
@@ -179,25 +196,88 @@ std::optional<SortComputationAnalysis> AnalyzeSortOp(
   return result;
 }
 
+// Returns true if keys of the given type can be converted to unsigned
+// integers of the same width with an order preserving transformation.
+bool IsConvertibleKeyType(PrimitiveType type) {
+  switch (type) {
+    case S8:
+    case S16:
+    case S32:
+    case S64:
+    case F16:
+    case BF16:
+    case F32:
+    case F64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Describes how a sort operation is lowered to a CUB radix sort.
+struct CubSortPlan {
+  // Element types of the keys and values sorted by CUB.
+  PrimitiveType key_type;
+  std::optional<PrimitiveType> value_type;
+  // Keys are converted to unsigned integers, so that sorting pairs doesn't
+  // need kernels for every key type.
+  bool convert_keys = false;
+  // CUB sorts the indices of the keys, which are then used to gather all
+  // non-key operands.
+  bool gather_values = false;
+};
+
+std::optional<CubSortPlan> PlanCubSort(
+    const HloSortInstruction& sort_op,
+    const SortComputationAnalysis& sort_config) {
+  PrimitiveType key_type =
+      sort_op.operand(sort_config.key_operand)->shape().element_type();
+  CubSortPlan plan{key_type, std::nullopt};
+  if (sort_op.operand_count() == 1) {
+    return plan;
+  }
+
+  // Pairs are only sorted with unsigned keys. Converted floating point keys
+  // are sorted in total order, so they are only converted if the comparator
+  // uses it: otherwise -0.0 and +0.0 (and NaNs) would no longer compare equal,
+  // and ties among them would not be broken by the values.
+  if (!primitive_util::IsUnsignedIntegralType(key_type)) {
+    if (!IsConvertibleKeyType(key_type) ||
+        (primitive_util::IsFloatingPointType(key_type) &&
+         !sort_config.total_order)) {
+      return std::nullopt;
+    }
+    plan.key_type = primitive_util::UnsignedIntegralTypeForBitWidth(
+        primitive_util::BitWidth(key_type));
+    plan.convert_keys = true;
+  }
+
+  // A single value operand is sorted together with the keys if there is a
+  // kernel for its width.
+  if (sort_op.operand_count() == 2) {
+    PrimitiveType value_type =
+        sort_op.operand(1 - sort_config.key_operand)->shape().element_type();
+    int value_width = primitive_util::BitWidth(value_type);
+    if (value_width == 16 || value_width == 32 || value_width == 64) {
+      plan.value_type = value_type;
+      return plan;
+    }
+  }
+
+  plan.value_type = S32;
+  plan.gather_values = true;
+  return plan;
+}
+
 // Create runner for CUB sort operation.
 absl::StatusOr<std::unique_ptr<CubSortRunnerInterface>> CreateRunner(
-    HloSortInstruction* sort_op, const SortComputationAnalysis& sort_config) {
-  int value_index = 1 - sort_config.key_operand;
-  return CubSortRunnerInterface::Create(
-      sort_op->operand(sort_config.key_operand)->shape().element_type(),
-      sort_op->operand_count() == 2
-          ? std::optional(sort_op->operand(value_index)->shape().element_type())
-          : std::nullopt);
+    const CubSortPlan& plan) {
+  return CubSortRunnerInterface::Create(plan.key_type, plan.value_type);
 }
 
 // Verify that the sort tensor shape is supported by CUB.
 bool IsCubCompatibleSort(HloSortInstruction* sort_op) {
   VLOG(1) << "Sort instruction: " << sort_op->name();
-  if (sort_op->operand_count() != 1 && sort_op->operand_count() != 2) {
-    VLOG(2) << "Unsupported operand count: " << sort_op->operand_count();
-    return false;
-  }
-
   const Shape& operand_shape = sort_op->operand(0)->shape();
   if (sort_op->sort_dimension() != operand_shape.rank() - 1) {
     VLOG(2) << "Sort dimension should be the minor one";
@@ -214,7 +294,8 @@ bool IsCubCompatibleSort(HloSortInstruction* sort_op) {
     VLOG(2) << "Only simple compare computations are supported";
     return false;
   }
-  if (!CreateRunner(sort_op, *sort_config).ok()) {
+  auto plan = PlanCubSort(*sort_op, *sort_config);
+  if (!plan.has_value() || !CreateRunner(*plan).ok()) {
     VLOG(2) << "Unsupported operand types (no compiled CUB kernels)";
     return false;
   }
@@ -222,18 +303,107 @@ bool IsCubCompatibleSort(HloSortInstruction* sort_op) {
   return true;
 }
 
-// Restore the result shape after sorting a pair of tensors.
-// The trailing argument is the scratch buffer which should be discarded.
-HloInstruction* UnpackResultPair(HloSortInstruction* sort_op,
-                                 HloInstruction* custom_call, bool swap) {
-  HloComputation* parent = sort_op->parent();
-  HloInstruction* gte0 =
-      parent->AddInstruction(HloInstruction::CreateGetTupleElement(
-          sort_op->operand(0)->shape(), custom_call, swap ? 1 : 0));
-  HloInstruction* gte1 =
-      parent->AddInstruction(HloInstruction::CreateGetTupleElement(
-          sort_op->operand(1)->shape(), custom_call, swap ? 0 : 1));
-  return parent->AddInstruction(HloInstruction::CreateTuple({gte0, gte1}));
+HloInstruction* BroadcastConstant(HloComputation* computation,
+                                  Literal literal, const Shape& shape) {
+  HloInstruction* constant = computation->AddInstruction(
+      HloInstruction::CreateConstant(std::move(literal)));
+  return computation->AddInstruction(
+      HloInstruction::CreateBroadcast(shape, constant, {}));
+}
+
+// Converts keys to unsigned integers of the same width, or back to `type` if
+// `to_unsigned` is false. The order of the unsigned integers is the total order
+// of the keys: the sign bit of integers and positive floats is flipped, and
+// all bits of negative floats are flipped.
+HloInstruction* ConvertKeys(HloInstruction* keys, PrimitiveType type,
+                            bool to_unsigned) {
+  HloComputation* computation = keys->parent();
+  int bit_width = primitive_util::BitWidth(type);
+  PrimitiveType signed_type =
+      primitive_util::SignedIntegralTypeForBitWidth(bit_width);
+  Shape signed_shape = ShapeUtil::ChangeElementType(keys->shape(), signed_type);
+
+  HloInstruction* bits = keys;
+  if (keys->shape().element_type() != signed_type) {
+    bits = computation->AddInstruction(
+        HloInstruction::CreateBitcastConvert(signed_shape, keys));
+  }
+
+  HloInstruction* flip =
+      BroadcastConstant(computation, LiteralUtil::MinValue(signed_type),
+                        signed_shape);
+  if (primitive_util::IsFloatingPointType(type)) {
+    // The sign of a float is the top bit of the converted value when
+    // converting back from unsigned integers.
+    HloInstruction* shift = BroadcastConstant(
+        computation,
+        LiteralUtil::CreateR0<int64_t>(bit_width - 1)
+            .Convert(signed_type)
+            .value(),
+        signed_shape);
+    HloInstruction* sign =
+        computation->AddInstruction(HloInstruction::CreateBinary(
+            signed_shape, HloOpcode::kShiftRightArithmetic, bits, shift));
+    if (!to_unsigned) {
+      sign = computation->AddInstruction(
+          HloInstruction::CreateUnary(signed_shape, HloOpcode::kNot, sign));
+    }
+    flip = computation->AddInstruction(HloInstruction::CreateBinary(
+        signed_shape, HloOpcode::kOr, sign, flip));
+  }
+  HloInstruction* result = computation->AddInstruction(
+      HloInstruction::CreateBinary(signed_shape, HloOpcode::kXor, bits, flip));
+
+  PrimitiveType result_type =
+      to_unsigned ? primitive_util::UnsignedIntegralTypeForBitWidth(bit_width)
+                  : type;
+  if (result_type == signed_type) {
+    return result;
+  }
+  return computation->AddInstruction(HloInstruction::CreateBitcastConvert(
+      ShapeUtil::ChangeElementType(keys->shape(), result_type), result));
+}
+
+// Returns `operand` permuted along the minor dimension by `indices`, i.e.
+// result[..., i] = operand[..., indices[..., i]].
+HloInstruction* GatherAlongMinorDimension(HloInstruction* operand,
+                                          HloInstruction* indices) {
+  HloComputation* computation = operand->parent();
+  const Shape& shape = operand->shape();
+  int64_t rank = shape.rank();
+
+  // Build full start indices for every element, using iotas for the major
+  // dimensions.
+  std::vector<int64_t> index_dims(shape.dimensions().begin(),
+                                  shape.dimensions().end());
+  index_dims.push_back(1);
+  Shape index_shape = ShapeUtil::MakeShape(S32, index_dims);
+  std::vector<HloInstruction*> start_indices;
+  for (int64_t dim = 0; dim < rank - 1; ++dim) {
+    start_indices.push_back(computation->AddInstruction(
+        HloInstruction::CreateIota(index_shape, dim)));
+  }
+  start_indices.push_back(computation->AddInstruction(
+      HloInstruction::CreateReshape(index_shape, indices)));
+
+  HloInstruction* gather_indices = start_indices.front();
+  if (rank > 1) {
+    index_dims.back() = rank;
+    gather_indices =
+        computation->AddInstruction(HloInstruction::CreateConcatenate(
+            ShapeUtil::MakeShape(S32, index_dims), start_indices, rank));
+  }
+
+  GatherDimensionNumbers dnums;
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    dnums.add_collapsed_slice_dims(dim);
+    dnums.add_start_index_map(dim);
+  }
+  dnums.set_index_vector_dim(rank);
+  return computation->AddInstruction(HloInstruction::CreateGather(
+      shape, operand, gather_indices, dnums,
+      /*slice_sizes=*/std::vector<int64_t>(rank, 1),
+      /*indices_are_sorted=*/false));
 }
 
 }  // namespace
@@ -243,13 +413,15 @@ absl::StatusOr<bool> GpuSortRewriter::RunOnInstruction(
     HloSortInstruction* sort_op) {
   // Get the sort tensor index and direction.
   SortComputationAnalysis sort_config = AnalyzeSortOp(*sort_op).value();
+  CubSortPlan plan = PlanCubSort(*sort_op, sort_config).value();
+  HloComputation* computation = sort_op->parent();
 
   // Get scratch size requirements from CUB.
   const Shape& operand_shape = sort_op->operand(0)->shape();
   int64_t batch_size = Product(operand_shape.dimensions()) /
                        operand_shape.dimensions(sort_op->sort_dimension());
 
-  TF_ASSIGN_OR_RETURN(auto runner, CreateRunner(sort_op, sort_config));
+  TF_ASSIGN_OR_RETURN(auto runner, CreateRunner(plan));
   TF_ASSIGN_OR_RETURN(
       int64_t scratch_size,
       runner->GetScratchSize(Product(operand_shape.dimensions()), batch_size));
@@ -260,14 +432,21 @@ absl::StatusOr<bool> GpuSortRewriter::RunOnInstruction(
     scratch_size += (batch_size + 1) * sizeof(int);
   }
 
-  // Values are only present if sorting a pair of tensors.
-  HloInstruction* keys = sort_op->mutable_operand(0);
+  HloInstruction* keys = sort_op->mutable_operand(sort_config.key_operand);
+  PrimitiveType key_type = keys->shape().element_type();
+  if (plan.convert_keys) {
+    keys = ConvertKeys(keys, key_type, /*to_unsigned=*/true);
+  }
+
+  // Values are only present if sorting a pair of tensors. If there are more
+  // operands, the indices of the keys are sorted instead.
   HloInstruction* values = nullptr;
-  if (sort_op->operand_count() == 2) {
-    values = sort_op->mutable_operand(1);
-    if (sort_config.key_operand == 1) {
-      std::swap(keys, values);
-    }
+  if (plan.gather_values) {
+    values = computation->AddInstruction(HloInstruction::CreateIota(
+        ShapeUtil::ChangeElementType(keys->shape(), S32),
+        sort_op->sort_dimension()));
+  } else if (sort_op->operand_count() == 2) {
+    values = sort_op->mutable_operand(1 - sort_config.key_operand);
   }
 
   // Build the resulting shape for the custom call.
@@ -282,7 +461,7 @@ absl::StatusOr<bool> GpuSortRewriter::RunOnInstruction(
 
   // Build the custom call instruction.
   HloInstruction* custom_call =
-      sort_op->parent()->AddInstruction(HloInstruction::CreateCustomCall(
+      computation->AddInstruction(HloInstruction::CreateCustomCall(
           call_shape, absl::MakeSpan(operands), kCubDeviceRadixSortTarget));
 
   xla::SortOptions backend_config;
@@ -290,19 +469,34 @@ absl::StatusOr<bool> GpuSortRewriter::RunOnInstruction(
   TF_RETURN_IF_ERROR(custom_call->set_backend_config(backend_config));
 
   // Build the replacement instruction.
-  HloInstruction* replacement;
-  if (sort_op->operand_count() == 1) {
+  HloInstruction* sorted_keys =
+      computation->AddInstruction(HloInstruction::CreateGetTupleElement(
+          keys->shape(), custom_call, 0));
+  if (plan.convert_keys) {
+    sorted_keys = ConvertKeys(sorted_keys, key_type, /*to_unsigned=*/false);
+  }
+  HloInstruction* replacement = sorted_keys;
+  if (sort_op->operand_count() > 1) {
+    HloInstruction* sorted_values =
+        computation->AddInstruction(HloInstruction::CreateGetTupleElement(
+            values->shape(), custom_call, 1));
+    std::vector<HloInstruction*> results;
+    for (int64_t i = 0; i < sort_op->operand_count(); ++i) {
+      if (i == sort_config.key_operand) {
+        results.push_back(sorted_keys);
+      } else if (plan.gather_values) {
+        results.push_back(GatherAlongMinorDimension(
+            sort_op->mutable_operand(i), sorted_values));
+      } else {
+        results.push_back(sorted_values);
+      }
+    }
     replacement =
-        sort_op->parent()->AddInstruction(HloInstruction::CreateGetTupleElement(
-            sort_op->shape(), custom_call, 0));
-  } else {
-    replacement = UnpackResultPair(sort_op, custom_call,
-                                   /*swap=*/sort_config.key_operand == 1);
+        computation->AddInstruction(HloInstruction::CreateTuple(results));
   }
 
   // Replace sort operation with custom call followed by GTE.
-  TF_RETURN_IF_ERROR(
-      sort_op->parent()->ReplaceInstruction(sort_op, replacement));
+  TF_RETURN_IF_ERROR(computation->ReplaceInstruction(sort_op, replacement));
   return true;
 }
 
@@ -28,8 +28,11 @@ namespace xla {
 namespace gpu {
 
 // Rewrites sort operations into CustomCall HLOs that call into CUB.
-// Only a subset of shapes is supported - either a single tensor with a simple
-// compare function or a pair of tensors where keys are unsigned integers.
+// The sort must be along the minor dimension and use a simple compare function
+// on a single key operand. Non-unsigned keys are sorted as unsigned integers
+// after an order preserving bit transformation. A single value operand with a
+// 16, 32 or 64 bit type is sorted together with the keys; otherwise the sorted
+// indices of the keys are used to gather all value operands.
 
 class GpuSortRewriter : public HloModulePass {
  public:
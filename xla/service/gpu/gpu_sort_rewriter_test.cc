@@ -193,8 +193,8 @@ ENTRY %main {
                                   m::GetTupleElement(m::CustomCall(), 0))));
 }
 
-// CUB sort doesn't support more than two tensors.
-TEST_F(GpuSortRewriterTest, NoRewriteManyTensors) {
+// Sort three tensors: the key indices are sorted and used to gather values.
+TEST_F(GpuSortRewriterTest, SortManyTensors) {
   constexpr char kHlo[] = R"(
 HloModule TestModule
 
@@ -205,7 +205,7 @@ HloModule TestModule
   %unused2 = f64[] parameter(3)
   %unused3 = u64[] parameter(4)
   %unused4 = u64[] parameter(5)
-  ROOT %lt = pred[] compare(%lhs, %rhs), direction=LT
+  ROOT %lt = pred[] compare(%lhs, %rhs), direction=LT, type=TOTALORDER
 }
 
 ENTRY %main {
@@ -216,10 +216,212 @@ ENTRY %main {
       dimensions={0}, to_apply=%compare
 })";
 
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunModuleAndPass(module.get()));
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::Tuple(
+          m::BitcastConvert(),
+          m::Gather(m::Parameter(1), m::Reshape(m::GetTupleElement(
+                                         m::CustomCall(), 1))),
+          m::Gather(m::Parameter(2), m::Reshape(m::GetTupleElement(
+                                         m::CustomCall(), 1))))));
+}
+
+// Sort many tensors with a batch dimension.
+TEST_F(GpuSortRewriterTest, SortManyTensorsWithBatchDim) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs_value1 = s32[] parameter(0)
+  %rhs_value1 = s32[] parameter(1)
+  %lhs_key = u32[] parameter(2)
+  %rhs_key = u32[] parameter(3)
+  %lhs_value2 = f16[] parameter(4)
+  %rhs_value2 = f16[] parameter(5)
+  ROOT %gt = pred[] compare(%lhs_key, %rhs_key), direction=GT
+}
+
+ENTRY %main {
+  %input1 = s32[10,1000] parameter(0)
+  %input2 = u32[10,1000] parameter(1)
+  %input3 = f16[10,1000] parameter(2)
+  ROOT %sort = (s32[10,1000], u32[10,1000], f16[10,1000])
+      sort(%input1, %input2, %input3), dimensions={1}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunModuleAndPass(module.get()));
+  const HloInstruction* custom_call;
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::Tuple(
+          m::Gather(m::Parameter(0), m::Concatenate()),
+          m::GetTupleElement(
+              m::CustomCall(&custom_call, {kCubDeviceRadixSortTarget}), 0),
+          m::Gather(m::Parameter(2), m::Concatenate()))));
+  ExpectDirection(custom_call, /*descending=*/true);
+}
+
+// Signed keys are sorted as unsigned integers with a flipped sign bit.
+TEST_F(GpuSortRewriterTest, SortPairsSignedKeys) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs_key = s32[] parameter(0)
+  %rhs_key = s32[] parameter(1)
+  %lhs_value = f32[] parameter(2)
+  %rhs_value = f32[] parameter(3)
+  ROOT %lt = pred[] compare(%lhs_key, %rhs_key), direction=LT
+}
+
+ENTRY %main {
+  %input_keys = s32[1000] parameter(0)
+  %input_values = f32[1000] parameter(1)
+  ROOT %sort = (s32[1000], f32[1000]) sort(%input_keys, %input_values),
+      dimensions={0}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunModuleAndPass(module.get()));
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Tuple(
+                  m::Xor(m::BitcastConvert(
+                             m::GetTupleElement(m::CustomCall(), 0)),
+                         m::Broadcast()),
+                  m::GetTupleElement(m::CustomCall(), 1))));
+}
+
+// Floating point keys compared in total order are sorted as unsigned integers,
+// also in descending order.
+TEST_F(GpuSortRewriterTest, SortPairsFloatKeysDescending) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs_value = s32[] parameter(0)
+  %rhs_value = s32[] parameter(1)
+  %lhs_key = f32[] parameter(2)
+  %rhs_key = f32[] parameter(3)
+  ROOT %gt = pred[] compare(%lhs_key, %rhs_key), direction=GT, type=TOTALORDER
+}
+
+ENTRY %main {
+  %input_values = s32[1000] parameter(0)
+  %input_keys = f32[1000] parameter(1)
+  ROOT %sort = (s32[1000], f32[1000]) sort(%input_values, %input_keys),
+      dimensions={0}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunModuleAndPass(module.get()));
+  const HloInstruction* custom_call;
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Tuple(
+                  m::GetTupleElement(m::CustomCall(&custom_call), 1),
+                  m::BitcastConvert(m::Xor(
+                      m::BitcastConvert(m::GetTupleElement(m::CustomCall(), 0)),
+                      m::Or())))));
+  ExpectDirection(custom_call, /*descending=*/true);
+}
+
+// Floating point keys compared with the default comparator are not converted:
+// -0.0 and +0.0 compare equal, so their order is decided by the iota.
+TEST_F(GpuSortRewriterTest, NoRewriteFloatKeysWithoutTotalOrder) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs = f32[] parameter(0)
+  %rhs = f32[] parameter(1)
+  %lhs_index = s32[] parameter(2)
+  %rhs_index = s32[] parameter(3)
+
+  cmp_indices = pred[] compare(%lhs_index, %rhs_index), direction=LT
+  cmp_lr = pred[] compare(%lhs, %rhs), direction=LT
+  cmp_eq = pred[] compare(%lhs, %rhs), direction=EQ
+
+  ROOT %lt = pred[] select(cmp_eq, cmp_indices, cmp_lr)
+}
+
+ENTRY %main {
+  %inputs = f32[1000] parameter(0)
+  %iota = s32[1000] iota(), iota_dimension=0
+  ROOT %sort = (f32[1000], s32[1000]) sort(%inputs, %iota),
+      dimensions={0}, to_apply=%compare
+})";
+
   TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
   EXPECT_FALSE(RunModuleAndPass(module.get()));
 }
 
+// Argsort of keys with signed zeros and NaNs in total order matches the
+// reference sort, including the order of the ties.
+TEST_F(GpuSortRewriterTest, SortPairsTotalOrderSignedZerosAndNaNs) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs = f32[] parameter(0)
+  %rhs = f32[] parameter(1)
+  %lhs_index = s32[] parameter(2)
+  %rhs_index = s32[] parameter(3)
+
+  cmp_indices = pred[] compare(%lhs_index, %rhs_index), direction=LT
+  cmp_lr = pred[] compare(%lhs, %rhs), direction=LT, type=TOTALORDER
+  cmp_eq = pred[] compare(%lhs, %rhs), direction=EQ, type=TOTALORDER
+
+  ROOT %lt = pred[] select(cmp_eq, cmp_indices, cmp_lr)
+}
+
+ENTRY %main {
+  %values = f32[5] constant({0.0, -nan, -0.0, nan, 1})
+  %tiled = f32[200,5] broadcast(%values), dimensions={1}
+  %inputs = f32[1000] reshape(%tiled)
+  %iota = s32[1000] iota(), iota_dimension=0
+  ROOT %sort = (f32[1000], s32[1000]) sort(%inputs, %iota),
+      dimensions={0}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunModuleAndPass(module.get()));
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Tuple(m::BitcastConvert(),
+                                  m::GetTupleElement(m::CustomCall(), 1))));
+}
+
+// Values without a compiled kernel are gathered with the sorted key indices.
+TEST_F(GpuSortRewriterTest, SortPairsNarrowValues) {
+  constexpr char kHlo[] = R"(
+HloModule TestModule
+
+%compare {
+  %lhs_key = u32[] parameter(0)
+  %rhs_key = u32[] parameter(1)
+  %lhs_value = s8[] parameter(2)
+  %rhs_value = s8[] parameter(3)
+  ROOT %lt = pred[] compare(%lhs_key, %rhs_key), direction=LT
+}
+
+ENTRY %main {
+  %input_keys = u32[1000] parameter(0)
+  %input_values = s8[1000] parameter(1)
+  ROOT %sort = (u32[1000], s8[1000]) sort(%input_keys, %input_values),
+      dimensions={0}, to_apply=%compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  EXPECT_TRUE(RunModuleAndPass(module.get()));
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::Tuple(
+          m::GetTupleElement(m::CustomCall(), 0),
+          m::Gather(m::Parameter(1), m::Reshape(m::GetTupleElement(
+                                         m::CustomCall(), 1))))));
+}
+
 // Only 1D shapes are supported.
 TEST_F(GpuSortRewriterTest, NoRewriteNonMinorSortDimension) {
   constexpr char kHlo[] = R"(
@@ -105,7 +105,10 @@ void AddSPMDPasses(
           .debug_options()
           .xla_gpu_multi_streamed_windowed_einsum(),
       /*skip_checking_windowed_einsum_users=*/true,
-      /*disable_ag_rewrite_for_multiple_consumers=*/true);
+      /*disable_ag_rewrite_for_multiple_consumers=*/true,
+      hlo_module->config()
+          .debug_options()
+          .xla_gpu_bidirectional_windowed_einsum());
   spmd_pipeline.AddPass<CollectivePermuteMotion>();
 }
 
@@ -306,14 +306,17 @@ GpuTransferManager::StagingBuffer::StagingBuffer(
 absl::StatusOr<GpuTransferManager::StagingBuffer*>
 GpuTransferManager::GetOrCreateStagingBuffer(se::StreamExecutor* executor) {
   absl::MutexLock lock(&mutex_);
-  if (auto it = staging_buffers_.find(executor); it != staging_buffers_.end()) {
+  int64_t& next = next_staging_buffer_[executor];
+  std::pair<se::StreamExecutor*, int64_t> key(executor, next);
+  next = (next + 1) % kNumStagingBuffers;
+  if (auto it = staging_buffers_.find(key); it != staging_buffers_.end()) {
     return &it->second;
   }
 
   VLOG(3) << absl::StreamFormat(
-      "Allocate staging buffer of %s for executor %p (device_ordinal=%d)",
-      tsl::strings::HumanReadableNumBytes(kStagingBufferSize), executor,
-      executor->device_ordinal());
+      "Allocate staging buffer #%d of %s for executor %p (device_ordinal=%d)",
+      key.second, tsl::strings::HumanReadableNumBytes(kStagingBufferSize),
+      executor, executor->device_ordinal());
 
   TF_ASSIGN_OR_RETURN(auto staging_buffer,
                       executor->HostMemoryAllocate(kStagingBufferSize));
@@ -321,7 +324,7 @@ GpuTransferManager::GetOrCreateStagingBuffer(se::StreamExecutor* executor) {
   TF_ASSIGN_OR_RETURN(auto transfer_completed, executor->CreateEvent());
 
   auto emplaced = staging_buffers_.try_emplace(
-      executor, std::move(staging_buffer), std::move(transfer_completed));
+      key, std::move(staging_buffer), std::move(transfer_completed));
   return &emplaced.first->second;
 }
 
@@ -18,9 +18,11 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -58,6 +60,11 @@ class GpuTransferManager : public GenericTransferManager {
   // operations if literal does not fit into it.
   static constexpr int64_t kStagingBufferSize = 128 * 1024 * 1024;
 
+  // Number of staging buffers per device. Transfers of different buffers (or
+  // chunks of a large buffer) alternate between staging buffers, so that a
+  // DMA into one staging buffer overlaps with the host copy out of another.
+  static constexpr int64_t kNumStagingBuffers = 2;
+
   // We use host memory allocation (pinned host memory) as a staging buffer for
   // transfering literals to and from device. We keep a separate staging
   // allocation per device so we don't need to do cross-device synchronization.
@@ -76,10 +83,21 @@ class GpuTransferManager : public GenericTransferManager {
 
   bool PackSubbyteTypes() const override { return true; }
 
-  // Returns or creates the staging buffer for the given executor.
+  // Returns or creates the next staging buffer for the given executor.
+  // Staging buffers of an executor are used in a round-robin order.
   absl::StatusOr<StagingBuffer*> GetOrCreateStagingBuffer(
       se::StreamExecutor* executor);
 
+  // Transfers from device are split into chunks that fit into a staging
+  // buffer, and chunks are transferred on as many streams as there are
+  // staging buffers.
+  int64_t MaxTransferFromDeviceStreams() const override {
+    return kNumStagingBuffers;
+  }
+  int64_t TransferFromDeviceChunkSize() const override {
+    return kStagingBufferSize;
+  }
+
   absl::Status TransferBufferFromDevice(se::Stream* stream,
                                         const se::DeviceMemoryBase& source,
                                         int64_t size,
@@ -145,7 +163,11 @@ class GpuTransferManager : public GenericTransferManager {
 
   // Staging buffers allocated for transfers to and from device.
   absl::Mutex mutex_;
-  absl::node_hash_map<se::StreamExecutor*, StagingBuffer> staging_buffers_
+  absl::node_hash_map<std::pair<se::StreamExecutor*, int64_t>, StagingBuffer>
+      staging_buffers_ ABSL_GUARDED_BY(mutex_);
+
+  // Index of the next staging buffer to use for each executor.
+  absl::flat_hash_map<se::StreamExecutor*, int64_t> next_staging_buffer_
       ABSL_GUARDED_BY(mutex_);
 };
 
@@ -112,7 +112,9 @@ std::string HloFusionStatsVisitor::ToString() {
                       "Number of kLoop fusions: ", num_loop_fusions_, "\n",
                       loop_fusion_opcode_histogram_.ToString(), "\n",
                       "Number of kInput fusions: ", num_input_fusions_, "\n",
-                      input_fusion_opcode_histogram_.ToString());
+                      input_fusion_opcode_histogram_.ToString(), "\n",
+                      "Number of reductions in kInput fusions: ",
+                      num_input_fusion_reductions_, "\n");
 }
 
 absl::Status HloFusionStatsVisitor::DefaultAction(
@@ -130,6 +132,14 @@ absl::Status HloFusionStatsVisitor::HandleFusion(const HloInstruction* fusion) {
   } else if (fusion->fusion_kind() == HloInstruction::FusionKind::kInput) {
     num_input_fusions_++;
     input_fusion_opcode_histogram_[opcodes]++;
+    // Horizontal fusion packs several reductions into one kInput fusion, so
+    // compare this to the number of kInput fusions to see its effect.
+    for (const HloInstruction* instr :
+         fusion->fused_instructions_computation()->instructions()) {
+      if (instr->opcode() == HloOpcode::kReduce) {
+        num_input_fusion_reductions_++;
+      }
+    }
   }
   return absl::OkStatus();
 }
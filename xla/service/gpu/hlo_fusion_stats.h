@@ -51,6 +51,7 @@ class HloFusionStatsVisitor : public ConstDfsHloVisitorWithDefault {
   int64_t num_fusions_ = 0;
   int64_t num_loop_fusions_ = 0;
   int64_t num_input_fusions_ = 0;
+  int64_t num_input_fusion_reductions_ = 0;
   HloOpcodeHistogram loop_fusion_opcode_histogram_;
   HloOpcodeHistogram input_fusion_opcode_histogram_;
 };
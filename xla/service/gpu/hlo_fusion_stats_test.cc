@@ -96,6 +96,8 @@ TEST_F(HloFusionStatsTest, LoopFusionAndReduceFusion) {
   ASSERT_TRUE(absl::StrContains(stats, "{broadcast, compare, select}: 2"));
   ASSERT_TRUE(absl::StrContains(stats, "Number of kInput fusions: 1"));
   ASSERT_TRUE(absl::StrContains(stats, "{cwise, reduce, tuple}: 1"));
+  ASSERT_TRUE(
+      absl::StrContains(stats, "Number of reductions in kInput fusions: 2"));
 }
 
 TEST_F(HloFusionStatsTest, AggregateCwiseOps) {
@@ -17,18 +17,26 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/gpu/gpu_fusible.h"
+#include "xla/service/gpu/hlo_fusion_analysis.h"
+#include "xla/service/gpu/launch_dimensions.h"
+#include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/gpu_performance_model.h"
+#include "xla/service/gpu/model/gpu_performance_model_base.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_creation_utils.h"
 #include "xla/shape.h"
 #include "xla/shape_util.h"
@@ -56,19 +64,54 @@ Shape GetInputShapeForMultiOutputFusion(const HloInstruction& instr) {
 
 class HorizontalInputFusionImpl {
  public:
-  explicit HorizontalInputFusionImpl(HloComputation* computation,
-                                     const se::DeviceDescription& d)
-      : computation_(computation), device_info_(d) {}
+  explicit HorizontalInputFusionImpl(
+      HloComputation* computation, const se::DeviceDescription& d,
+      const HloCostAnalysis::ShapeSizeFunction& shape_size)
+      : computation_(computation),
+        device_info_(d),
+        cost_analysis_({shape_size, /*per_second_rates=*/{},
+                        /*count_multiple_input_accesses=*/true},
+                       &d) {}
 
   ~HorizontalInputFusionImpl() = default;
 
   absl::StatusOr<bool> Run();
 
  private:
+  // Performance model estimates of a fusion candidate.
+  struct CandidateCost {
+    absl::Duration exec_time;
+    int64_t num_blocks;
+  };
+
+  absl::StatusOr<CandidateCost> EstimateCost(HloInstruction* fusion);
+
+  // Returns whether launching `cost` as a kernel of its own would mostly be
+  // launch overhead, and the kernel would leave SMs idle.
+  bool IsSmall(const CandidateCost& cost) const;
+
   HloComputation* computation_;
   const se::DeviceDescription& device_info_;
+  GpuHloCostAnalysis cost_analysis_;
 };  // HorizontalInputFusionImpl
 
+absl::StatusOr<HorizontalInputFusionImpl::CandidateCost>
+HorizontalInputFusionImpl::EstimateCost(HloInstruction* fusion) {
+  TF_RETURN_IF_ERROR(cost_analysis_.RevisitInstruction(fusion));
+  EstimateRunTimeData runtime =
+      GpuPerformanceModel::EstimateRunTimeForInstruction(
+          fusion, &cost_analysis_, GpuPerformanceModelOptions::Default());
+  LaunchDimensions launch_dimensions =
+      GpuPerformanceModel::EstimateFusionLaunchDimensions(
+          AnalyzeFusion(*fusion, device_info_));
+  return CandidateCost{runtime.exec_time, launch_dimensions.num_blocks()};
+}
+
+bool HorizontalInputFusionImpl::IsSmall(const CandidateCost& cost) const {
+  return cost.exec_time <= GpuPerformanceModel::kKernelLaunchOverhead &&
+         cost.num_blocks < device_info_.core_count();
+}
+
 // Compares one-by-one the dimensions of `shape_a` and `shape_b` from left to
 // right.
 bool CompareShapeDimsFromLeftToRight(const Shape& shape_a,
@@ -145,21 +188,45 @@ absl::StatusOr<bool> HorizontalInputFusionImpl::Run() {
       }
     }
 
+    std::vector<CandidateCost> costs;
+    costs.reserve(candidates.size());
+    for (HloInstruction* candidate : candidates) {
+      TF_ASSIGN_OR_RETURN(CandidateCost cost, EstimateCost(candidate));
+      costs.push_back(cost);
+    }
+
+    // The reductions of a horizontal fusion are emitted as independent
+    // reduction groups, each with blocks of its own. As long as all blocks of
+    // a batch of small reductions run in a single wave, packing them into one
+    // kernel saves a launch per reduction without serializing any of them, so
+    // the batch is not subject to the usual cap on unnested reductions.
     size_t fusion_anchor_id = 0;
+    bool batch_is_small = IsSmall(costs[0]);
+    int64_t batch_num_blocks = costs[0].num_blocks;
     for (size_t j = 1; j < candidates.size(); ++j) {
       HloInstruction* fusion_anchor = candidates[fusion_anchor_id];
       HloInstruction* fused = candidates[j];
+      const bool pack_small_reductions =
+          batch_is_small && IsSmall(costs[j]) &&
+          batch_num_blocks + costs[j].num_blocks <= device_info_.core_count();
       if (ShapesCompatibleForMultiOutputFusion(*fusion_anchor, *fused) &&
-          FusionFitsInBudget(*fusion_anchor, *fused, device_info_)) {
+          FusionFitsInBudget(
+              *fusion_anchor, *fused, device_info_,
+              /*is_consumer_producer_fusion=*/false, /*cache=*/nullptr,
+              /*limit_unnested_reductions=*/!pack_small_reductions)) {
         VLOG(3) << "Fuse " << fused->ToString() << " into "
                 << fusion_anchor->ToString();
         fusion_anchor->MergeFusionInstructionIntoMultiOutput(fused);
+        batch_is_small &= IsSmall(costs[j]);
+        batch_num_blocks += costs[j].num_blocks;
         changed = true;
       } else {
         // Update the `fusion_anchor_id` since `fused` is either not
         // compatible or not beneficial to be fused with current fusion anchor.
         VLOG(3) << j - fusion_anchor_id - 1 << " instructions are fused.";
         fusion_anchor_id = j;
+        batch_is_small = IsSmall(costs[j]);
+        batch_num_blocks = costs[j].num_blocks;
       }
     }
   }
@@ -171,7 +238,14 @@ absl::StatusOr<bool> HorizontalInputFusionImpl::Run() {
 
 absl::StatusOr<bool> GpuHorizontalInputFusion::RunOnComputation(
     HloComputation* computation) {
-  HorizontalInputFusionImpl horizontal_fusion_impl(computation, device_info_);
+  HloCostAnalysis::ShapeSizeFunction shape_size = shape_size_;
+  if (!shape_size) {
+    shape_size = [](const Shape& shape) {
+      return ShapeUtil::ByteSizeOf(shape, sizeof(void*));
+    };
+  }
+  HorizontalInputFusionImpl horizontal_fusion_impl(computation, device_info_,
+                                                   shape_size);
   return horizontal_fusion_impl.Run();
 }
 
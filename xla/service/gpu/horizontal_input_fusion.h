@@ -16,11 +16,14 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_HORIZONTAL_INPUT_FUSION_H_
 #define XLA_SERVICE_GPU_HORIZONTAL_INPUT_FUSION_H_
 
+#include <utility>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/stream_executor/device_description.h"
 
@@ -39,10 +42,18 @@ namespace gpu {
 // outputs are all consumed by the same instruction. This catches the typical
 // target cases; often, the candidate instructions are just consumed by the
 // ROOT tuple of the entry computation.
+//
+// The GPU performance model is used to find small reductions, whose kernels
+// would mostly be launch overhead. Such reductions are packed into a single
+// fusion for as long as the blocks of all of them fit in a single wave.
 class GpuHorizontalInputFusion : public HloModulePass {
  public:
-  explicit GpuHorizontalInputFusion(const se::DeviceDescription& d)
-      : device_info_(d) {}
+  // If `shape_size` is null, shape sizes are computed assuming 64-bit
+  // pointers.
+  explicit GpuHorizontalInputFusion(
+      const se::DeviceDescription& d,
+      HloCostAnalysis::ShapeSizeFunction shape_size = nullptr)
+      : device_info_(d), shape_size_(std::move(shape_size)) {}
 
   absl::string_view name() const override {
     return "gpu_horizontal_input_fusion";
@@ -57,6 +68,7 @@ class GpuHorizontalInputFusion : public HloModulePass {
   absl::StatusOr<bool> RunOnComputation(HloComputation*);
 
   const se::DeviceDescription& device_info_;
+  HloCostAnalysis::ShapeSizeFunction shape_size_;
 };
 
 }  // namespace gpu
@@ -16,9 +16,12 @@ limitations under the License.
 #include "xla/service/gpu/horizontal_input_fusion.h"
 
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "xla/error_spec.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -258,6 +261,73 @@ TEST_F(HorizontalInputFusionTest, NonfusionInstrs) {
               GmockMatch(m::Tuple(m::Reduce(), m::Reduce())));
 }
 
+// Returns a module whose root is a tuple of `num_reductions` independent
+// row reductions of f32[rows,1024] parameters.
+std::string ManyReductionsHlo(int num_reductions, int rows) {
+  std::string shape = absl::StrCat("f32[", rows, ",1024]{1,0}");
+  std::string result_shape = absl::StrCat("f32[", rows, "]{0}");
+  std::string hlo = R"(
+ HloModule ManyReductions
+
+ %add_f32 {
+   %x = f32[] parameter(0)
+   %y = f32[] parameter(1)
+   ROOT %add = f32[] add(%x, %y)
+ }
+
+ ENTRY entry_computation {
+   constant0 = f32[] constant(0)
+)";
+  std::vector<std::string> reductions;
+  std::vector<std::string> result_shapes;
+  for (int i = 0; i < num_reductions; ++i) {
+    absl::StrAppend(&hlo, "   arg.", i, " = ", shape, " parameter(", i, ")\n",
+                    "   reduce.", i, " = ", result_shape, " reduce(arg.", i,
+                    ", constant0), dimensions={1}, to_apply=%add_f32\n");
+    reductions.push_back(absl::StrCat("reduce.", i));
+    result_shapes.push_back(result_shape);
+  }
+  absl::StrAppend(&hlo, "   ROOT tuple.0 = (",
+                  absl::StrJoin(result_shapes, ", "), ") tuple(",
+                  absl::StrJoin(reductions, ", "), ")\n }\n");
+  return hlo;
+}
+
+TEST_F(HorizontalInputFusionTest, PacksSmallReductionsIntoOneFusion) {
+  // Each of the reductions is launch-overhead bound, and all of them together
+  // still fit in a single wave, so they are fused beyond the usual limit of 8
+  // unnested reductions per fusion.
+  auto module = ParseAndReturnVerifiedModule(ManyReductionsHlo(16, 2)).value();
+
+  EXPECT_TRUE(horizontal_input_fusion_.Run(module.get()).value());
+
+  const HloInstruction* entry_root =
+      module->entry_computation()->root_instruction();
+  const HloInstruction* fusion = entry_root->operand(0)->operand(0);
+  ASSERT_TRUE(fusion->IsMultiOutputFusion());
+  for (const HloInstruction* operand : entry_root->operands()) {
+    EXPECT_EQ(operand->operand(0), fusion);
+  }
+  EXPECT_EQ(fusion->fused_expression_root()->operand_count(), 16);
+}
+
+TEST_F(HorizontalInputFusionTest, LimitsLargeReductionsPerFusion) {
+  auto module =
+      ParseAndReturnVerifiedModule(ManyReductionsHlo(16, 4096)).value();
+
+  EXPECT_TRUE(horizontal_input_fusion_.Run(module.get()).value());
+
+  const HloInstruction* entry_root =
+      module->entry_computation()->root_instruction();
+  for (const HloInstruction* operand : entry_root->operands()) {
+    const HloInstruction* fusion = operand->operand(0);
+    ASSERT_EQ(fusion->opcode(), HloOpcode::kFusion);
+    if (fusion->IsMultiOutputFusion()) {
+      EXPECT_LE(fusion->fused_expression_root()->operand_count(), 8);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/infeed_manager.h"
 
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -24,12 +25,16 @@ limitations under the License.
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/literal.h"
 #include "xla/service/gpu/xfeed_queue.h"
 #include "xla/shape.h"
 #include "xla/shape_tree.h"
 #include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/device_memory_handle.h"
+#include "xla/stream_executor/event.h"
+#include "xla/stream_executor/stream.h"
 #include "xla/util.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
@@ -42,29 +47,91 @@ limitations under the License.
 namespace xla {
 namespace gpu {
 
-constexpr int kMaxInfeedsInFlight = 8;
+// Alignment of literal leaves packed into a staging buffer.
+constexpr int64_t kStagingBufferAlignment = 256;
 
 InfeedManager::InfeedManager(se::StreamExecutor* executor)
     : BlockingXfeedQueue(/*max_pending_xfeeds=*/kMaxInfeedsInFlight),
+      executor_(executor),
       stream_(executor->CreateStream().value()) {}
 
-static absl::StatusOr<se::DeviceMemoryHandle> CopyBufferToDevice(
-    se::Stream* stream, int64_t size, const void* source) {
-  if (size > std::numeric_limits<int32_t>::max()) {
-    return InvalidArgument("GPU infeed of %d bytes exceeds maximum of %d bytes",
-                           size, std::numeric_limits<int32_t>::max());
+InfeedManager::~InfeedManager() {
+  // Copies into staging buffers must complete before we free them.
+  if (absl::Status status = stream_->BlockHostUntilDone(); !status.ok()) {
+    LOG(ERROR) << "Failed to wait for infeed transfers: " << status;
   }
+}
 
-  if (size == 0) {
-    return InvalidArgument("Infeed shape needs 0 bytes");
+absl::StatusOr<InfeedStagingBuffer*> InfeedManager::AcquireStagingBuffer(
+    int64_t size) {
+  InfeedStagingBuffer* staging = nullptr;
+  {
+    absl::MutexLock lock(&staging_mu_);
+    while (free_staging_buffers_.empty() &&
+           staging_buffers_.size() >= kMaxInfeedsInFlight) {
+      staging_cv_.Wait(&staging_mu_);
+    }
+
+    if (free_staging_buffers_.empty()) {
+      auto new_staging = std::make_unique<InfeedStagingBuffer>();
+      TF_ASSIGN_OR_RETURN(new_staging->copy_done, executor_->CreateEvent());
+      TF_ASSIGN_OR_RETURN(new_staging->consumed, executor_->CreateEvent());
+      staging = staging_buffers_.emplace_back(std::move(new_staging)).get();
+    } else {
+      staging = free_staging_buffers_.front();
+      free_staging_buffers_.pop_front();
+    }
   }
 
-  se::StreamExecutor* executor = stream->parent();
-  se::DeviceMemoryHandle buffer(executor,
-                                executor->AllocateArray<uint8_t>(size));
-  TF_RETURN_IF_ERROR(stream->Memcpy(buffer.memory_ptr(), source, size));
+  auto prepare = [&]() -> absl::Status {
+    // Device memory can't be overwritten until the previous consumer is done
+    // reading it, this doesn't block the host.
+    if (staging->has_consumer) {
+      TF_RETURN_IF_ERROR(stream()->WaitFor(staging->consumed.get()));
+      staging->has_consumer = false;
+    }
+
+    bool pending_copy =
+        staging->has_pending_copy &&
+        staging->copy_done->PollForStatus() != se::Event::Status::kComplete;
+
+    // Growing a staging buffer frees memory that might be still in use, and
+    // writing to host memory requires the previous copy from it to be done.
+    if (staging->size < size || pending_copy) {
+      TF_RETURN_IF_ERROR(stream()->BlockHostUntilDone());
+    }
+    staging->has_pending_copy = false;
+
+    if (staging->size >= size) return absl::OkStatus();
+
+    VLOG(2) << "Allocate infeed staging buffer of " << size << " bytes";
+    staging->host_memory = nullptr;
+    staging->device_memory = se::DeviceMemoryHandle();
+    staging->size = 0;
+
+    TF_ASSIGN_OR_RETURN(staging->host_memory,
+                        executor_->HostMemoryAllocate(size));
+    staging->device_memory = se::DeviceMemoryHandle(
+        executor_, executor_->AllocateArray<uint8_t>(size));
+    if (staging->device_memory.memory().is_null()) {
+      return ResourceExhausted(
+          "Failed to allocate %d bytes for infeed staging buffer", size);
+    }
+    staging->size = size;
+    return absl::OkStatus();
+  };
+
+  if (absl::Status status = prepare(); !status.ok()) {
+    ReturnStagingBuffer(staging);
+    return status;
+  }
+  return staging;
+}
 
-  return std::move(buffer);
+void InfeedManager::ReturnStagingBuffer(InfeedStagingBuffer* staging) {
+  absl::MutexLock lock(&staging_mu_);
+  free_staging_buffers_.push_back(staging);
+  staging_cv_.Signal();
 }
 
 absl::Status InfeedManager::TransferLiteralToInfeed(
@@ -75,31 +142,88 @@ absl::Status InfeedManager::TransferLiteralToInfeed(
 
   BlockUntilEnqueueSlotAvailable();
 
-  // For a tuple, we transfer each of its elements to the device and enqueue the
-  // resulting destination device addresses with the infeed manager.
-  ShapeTree<se::DeviceMemoryHandle> buffer_tree(literal_shape);
-  for (auto& leaf : buffer_tree.leaves()) {
+  // For a tuple, we pack all of its elements into a single staging buffer and
+  // enqueue slices of its device memory with the infeed manager.
+  ShapeTree<int64_t> offsets(literal_shape);
+  int64_t staging_size = 0;
+  for (auto& leaf : offsets.leaves()) {
     const Shape& sub_shape = ShapeUtil::GetSubshape(literal_shape, leaf.first);
     CHECK(sub_shape.IsArray()) << ShapeUtil::HumanStringWithLayout(sub_shape);
-    TF_ASSIGN_OR_RETURN(
-        leaf.second,
-        CopyBufferToDevice(stream(), ShapeUtil::ByteSizeOf(sub_shape),
-                           literal.untyped_data(leaf.first)));
+
+    int64_t size = ShapeUtil::ByteSizeOf(sub_shape);
+    if (size > std::numeric_limits<int32_t>::max()) {
+      return InvalidArgument(
+          "GPU infeed of %d bytes exceeds maximum of %d bytes", size,
+          std::numeric_limits<int32_t>::max());
+    }
+    if (size == 0) {
+      return InvalidArgument("Infeed shape needs 0 bytes");
+    }
+
+    leaf.second = staging_size;
+    staging_size = RoundUpTo(staging_size + size, kStagingBufferAlignment);
   }
 
-  // TODO(b/30467474): Since this stream is shared across different infeed
-  // requests, blocking on the stream might be heavy-handed. Figure out if
-  // finer-grained acknowledgement is possible.
-  absl::Status block_status = stream()->BlockHostUntilDone();
-  if (!block_status.ok()) {
-    return Internal("Failed to complete data transfer on stream %p: %s",
-                    stream(), block_status.message());
+  InfeedBuffers infeed_buffers{ShapeTree<se::DeviceMemoryBase>(literal_shape),
+                               nullptr};
+
+  if (staging_size > 0) {
+    TF_ASSIGN_OR_RETURN(infeed_buffers.staging,
+                        AcquireStagingBuffer(staging_size));
+    InfeedStagingBuffer* staging = infeed_buffers.staging;
+
+    auto* host_memory = static_cast<uint8_t*>(staging->host_memory->opaque());
+    se::DeviceMemoryBase device_memory = staging->device_memory.memory();
+
+    for (auto& leaf : infeed_buffers.buffers.leaves()) {
+      const Shape& sub_shape =
+          ShapeUtil::GetSubshape(literal_shape, leaf.first);
+      int64_t offset = offsets.element(leaf.first);
+      int64_t size = ShapeUtil::ByteSizeOf(sub_shape);
+      std::memcpy(host_memory + offset, literal.untyped_data(leaf.first),
+                  size);
+      leaf.second = device_memory.GetByteSlice(offset, size);
+    }
+
+    se::DeviceMemoryBase dst = device_memory.GetByteSlice(0, staging_size);
+    absl::Status copy_status = stream()->Memcpy(&dst, host_memory,
+                                                staging_size);
+    if (copy_status.ok()) {
+      copy_status = stream()->RecordEvent(staging->copy_done.get());
+    }
+    if (!copy_status.ok()) {
+      ReturnStagingBuffer(staging);
+      return Internal("Failed to enqueue data transfer on stream %p: %s",
+                      stream(), copy_status.message());
+    }
+    staging->has_pending_copy = true;
   }
 
-  EnqueueDestination(std::move(buffer_tree));
+  EnqueueDestination(std::move(infeed_buffers));
   return absl::OkStatus();
 }
 
+absl::Status InfeedManager::WaitForTransfer(const InfeedBuffers& buffers,
+                                            se::Stream* stream) {
+  if (buffers.staging == nullptr) return absl::OkStatus();
+  return stream->WaitFor(buffers.staging->copy_done.get());
+}
+
+absl::Status InfeedManager::Release(InfeedBuffers buffers,
+                                    se::Stream* stream) {
+  InfeedStagingBuffer* staging = buffers.staging;
+  if (staging == nullptr) return absl::OkStatus();
+
+  absl::Status status = stream->RecordEvent(staging->consumed.get());
+  staging->has_consumer = status.ok();
+  if (!status.ok()) {
+    // We don't know when the consumer is done, so wait for it on the host.
+    status = stream->BlockHostUntilDone();
+  }
+  ReturnStagingBuffer(staging);
+  return status;
+}
+
 InfeedManager* GetOrCreateInfeedManager(se::StreamExecutor* executor) {
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   stream_executor::gpu::GpuExecutor* gpu_executor =
@@ -21,13 +21,22 @@ limitations under the License.
 #define XLA_SERVICE_GPU_INFEED_MANAGER_H_
 
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/literal.h"
 #include "xla/service/gpu/xfeed_queue.h"
 #include "xla/shape_tree.h"
+#include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/device_memory_handle.h"
+#include "xla/stream_executor/event.h"
+#include "xla/stream_executor/memory_allocation.h"
+#include "xla/stream_executor/stream.h"
 #include "xla/stream_executor/stream_executor.h"
 
 namespace xla {
@@ -39,26 +48,75 @@ namespace gpu {
 //
 // Current limitations:
 // * Does not handle multiple devices/replicas.
-//
-// * Buffer space on GPU is allocated on every infeed enqueue request,
-// and it does not handle the case when it runs out of
-// memory. Potential solution is to pre-allocate a fixed amount of
-// memory and block when that memory is full.
-
-// Client-side class used to enqueue infeed buffers.
-class InfeedManager
-    : public BlockingXfeedQueue<ShapeTree<se::DeviceMemoryHandle>> {
+
+// Staging memory for a single infeed transfer. Leaves of an infeed literal are
+// packed into a pinned host buffer and copied to device memory with a single
+// asynchronous memcpy. Staging buffers are reused by later transfers, so infeed
+// does not allocate memory once they have grown to the size of infeed literals.
+struct InfeedStagingBuffer {
+  int64_t size = 0;
+  std::unique_ptr<se::MemoryAllocation> host_memory;
+  se::DeviceMemoryHandle device_memory;
+
+  // Recorded on the infeed stream after the copy to device memory.
+  std::unique_ptr<se::Event> copy_done;
+  bool has_pending_copy = false;
+
+  // Recorded on the consumer stream after it read device memory.
+  std::unique_ptr<se::Event> consumed;
+  bool has_consumer = false;
+};
+
+// Device buffers holding an infeed literal. Buffers are slices of a staging
+// buffer that is returned to the infeed manager by `InfeedManager::Release`.
+struct InfeedBuffers {
+  ShapeTree<se::DeviceMemoryBase> buffers;
+  InfeedStagingBuffer* staging = nullptr;
+};
+
+// Client-side class used to enqueue infeed buffers. Transfers are asynchronous:
+// a transfer for the next infeed overlaps with device work consuming the
+// previous one, and consumers wait for the transfer on device.
+class InfeedManager : public BlockingXfeedQueue<InfeedBuffers> {
  public:
+  // Maximum number of pending infeed transfers and staging buffers.
+  static constexpr int kMaxInfeedsInFlight = 8;
+
   explicit InfeedManager(se::StreamExecutor* executor);
+  ~InfeedManager() override;
 
   absl::Status TransferLiteralToInfeed(se::StreamExecutor* executor,
                                        const LiteralSlice& literal);
 
+  // Makes `stream` wait for the transfer of `buffers` to device memory.
+  absl::Status WaitForTransfer(const InfeedBuffers& buffers,
+                               se::Stream* stream);
+
+  // Returns the staging buffer of `buffers` to the infeed manager. It is reused
+  // by later transfers only after all work enqueued into `stream` so far is
+  // done, so `stream` must be the stream that reads from `buffers`.
+  absl::Status Release(InfeedBuffers buffers, se::Stream* stream);
+
  private:
   se::Stream* stream() const { return stream_.get(); }
 
+  // Returns a staging buffer of at least `size` bytes that is safe to write on
+  // the host and to copy into on the infeed stream. Blocks if all staging
+  // buffers are in use.
+  absl::StatusOr<InfeedStagingBuffer*> AcquireStagingBuffer(int64_t size);
+  void ReturnStagingBuffer(InfeedStagingBuffer* staging);
+
+  se::StreamExecutor* executor_;
+
   // Stream used to enqueue infeed device copies.
   std::unique_ptr<se::Stream> stream_;
+
+  absl::Mutex staging_mu_;
+  absl::CondVar staging_cv_;
+  std::vector<std::unique_ptr<InfeedStagingBuffer>> staging_buffers_
+      ABSL_GUARDED_BY(staging_mu_);
+  std::deque<InfeedStagingBuffer*> free_staging_buffers_
+      ABSL_GUARDED_BY(staging_mu_);
 };
 
 // Returns the GPU infeed manager for the given stream executor,
@@ -0,0 +1,230 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/infeed_manager.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/platform_util.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/platform.h"
+#include "xla/stream_executor/platform_manager.h"
+#include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/tests/literal_test_util.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla::gpu {
+namespace {
+
+static se::StreamExecutor* GpuExecutor() {
+  auto name =
+      absl::AsciiStrToUpper(PlatformUtil::CanonicalPlatformName("gpu").value());
+  auto* platform = se::PlatformManager::PlatformWithName(name).value();
+  return platform->ExecutorForDevice(0).value();
+}
+
+class InfeedManagerTest : public ::testing::Test {
+ protected:
+  InfeedManagerTest()
+      : executor_(GpuExecutor()),
+        stream_(executor_->CreateStream().value()),
+        infeed_manager_(std::make_unique<InfeedManager>(executor_)) {}
+
+  // Takes the next infeed destination and makes `stream_` wait for it.
+  InfeedBuffers Consume() {
+    InfeedBuffers buffers = infeed_manager_->BlockingGetNextDestination();
+    CHECK_OK(infeed_manager_->WaitForTransfer(buffers, stream_.get()));
+    return buffers;
+  }
+
+  // Copies the device buffer at `index` of `buffers` into a literal.
+  Literal ToLiteral(const InfeedBuffers& buffers, const ShapeIndex& index) {
+    se::DeviceMemoryBase buffer = buffers.buffers.element(index);
+    Literal literal(ShapeUtil::GetSubshape(buffers.buffers.shape(), index));
+    CHECK_OK(stream_->Memcpy(literal.untyped_data(), buffer, buffer.size()));
+    CHECK_OK(stream_->BlockHostUntilDone());
+    return literal;
+  }
+
+  se::StreamExecutor* executor_;
+  std::unique_ptr<se::Stream> stream_;
+  std::unique_ptr<InfeedManager> infeed_manager_;
+};
+
+TEST_F(InfeedManagerTest, ReusesAndGrowsStagingBuffer) {
+  Literal small = LiteralUtil::CreateR1<float>({1, 2, 3, 4});
+  Literal small2 = LiteralUtil::CreateR1<float>({5, 6, 7, 8});
+  std::vector<float> large_data(4096);
+  for (int i = 0; i < large_data.size(); ++i) large_data[i] = i;
+  Literal large = LiteralUtil::CreateR1<float>(large_data);
+
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, small));
+  InfeedBuffers buffers0 = Consume();
+  InfeedStagingBuffer* staging = buffers0.staging;
+  ASSERT_NE(staging, nullptr);
+  se::DeviceMemoryBase device_memory0 = buffers0.buffers.element({});
+  EXPECT_TRUE(LiteralTestUtil::Equal(small, ToLiteral(buffers0, {})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers0), stream_.get()));
+
+  // Back to back transfer of the same size reuses the staging buffer and its
+  // device memory, and overwrites it only after the consumer is done.
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, small2));
+  InfeedBuffers buffers1 = Consume();
+  EXPECT_EQ(buffers1.staging, staging);
+  EXPECT_EQ(buffers1.buffers.element({}).opaque(), device_memory0.opaque());
+  EXPECT_TRUE(LiteralTestUtil::Equal(small2, ToLiteral(buffers1, {})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers1), stream_.get()));
+
+  // A larger transfer grows the same staging buffer.
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, large));
+  InfeedBuffers buffers2 = Consume();
+  EXPECT_EQ(buffers2.staging, staging);
+  EXPECT_GE(staging->size, large.size_bytes());
+  EXPECT_TRUE(LiteralTestUtil::Equal(large, ToLiteral(buffers2, {})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers2), stream_.get()));
+
+  // A smaller transfer after growing does not shrink the staging buffer.
+  int64_t grown_size = staging->size;
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, small));
+  InfeedBuffers buffers3 = Consume();
+  EXPECT_EQ(buffers3.staging, staging);
+  EXPECT_EQ(staging->size, grown_size);
+  EXPECT_TRUE(LiteralTestUtil::Equal(small, ToLiteral(buffers3, {})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers3), stream_.get()));
+}
+
+TEST_F(InfeedManagerTest, PacksTupleLeavesAtAlignedOffsets) {
+  Literal a = LiteralUtil::CreateR1<float>({1, 2, 3});
+  Literal b = LiteralUtil::CreateR1<int32_t>({4, 5, 6, 7, 8});
+  Literal c = LiteralUtil::CreateR0<uint8_t>(9);
+  Literal tuple = LiteralUtil::MakeTuple({&a, &b, &c});
+
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, tuple));
+  InfeedBuffers buffers = Consume();
+  ASSERT_NE(buffers.staging, nullptr);
+
+  // Leaves are packed into a single staging buffer at 256 byte aligned
+  // offsets in the order of the tuple elements.
+  auto* base =
+      static_cast<char*>(buffers.staging->device_memory.memory().opaque());
+  auto offset = [&](const ShapeIndex& index) {
+    return static_cast<char*>(buffers.buffers.element(index).opaque()) - base;
+  };
+  EXPECT_EQ(offset({0}), 0);
+  EXPECT_EQ(offset({1}), 256);
+  EXPECT_EQ(offset({2}), 512);
+  EXPECT_EQ(buffers.buffers.element({0}).size(), 12);
+  EXPECT_EQ(buffers.buffers.element({1}).size(), 20);
+  EXPECT_EQ(buffers.buffers.element({2}).size(), 1);
+
+  EXPECT_TRUE(LiteralTestUtil::Equal(a, ToLiteral(buffers, {0})));
+  EXPECT_TRUE(LiteralTestUtil::Equal(b, ToLiteral(buffers, {1})));
+  EXPECT_TRUE(LiteralTestUtil::Equal(c, ToLiteral(buffers, {2})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers), stream_.get()));
+}
+
+TEST_F(InfeedManagerTest, BlocksWhenTooManyTransfersAreInFlight) {
+  constexpr int kMaxInFlight = InfeedManager::kMaxInfeedsInFlight;
+
+  // Consumed but not yet released transfers hold on to their staging buffers.
+  std::vector<InfeedBuffers> in_flight;
+  for (int i = 0; i < kMaxInFlight; ++i) {
+    Literal literal = LiteralUtil::CreateR1<int32_t>({i});
+    TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, literal));
+    in_flight.push_back(Consume());
+  }
+
+  absl::Notification transferred;
+  Literal next = LiteralUtil::CreateR1<int32_t>({kMaxInFlight});
+  std::unique_ptr<tsl::Thread> thread(tsl::Env::Default()->StartThread(
+      tsl::ThreadOptions(), "transfer", [&] {
+        CHECK_OK(infeed_manager_->TransferLiteralToInfeed(executor_, next));
+        transferred.Notify();
+      }));
+
+  // All staging buffers are in use, and the transfer waits for one of them.
+  EXPECT_FALSE(transferred.WaitForNotificationWithTimeout(absl::Seconds(1)));
+
+  InfeedStagingBuffer* released = in_flight.front().staging;
+  TF_ASSERT_OK(
+      infeed_manager_->Release(std::move(in_flight.front()), stream_.get()));
+  transferred.WaitForNotification();
+  thread.reset();
+
+  // The transfer reused the released staging buffer instead of allocating a
+  // new one, and consumers see the right data.
+  InfeedBuffers buffers = Consume();
+  EXPECT_EQ(buffers.staging, released);
+  EXPECT_TRUE(LiteralTestUtil::Equal(next, ToLiteral(buffers, {})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers), stream_.get()));
+
+  for (int i = 1; i < kMaxInFlight; ++i) {
+    EXPECT_TRUE(LiteralTestUtil::Equal(
+        LiteralUtil::CreateR1<int32_t>({i}), ToLiteral(in_flight[i], {})));
+    TF_ASSERT_OK(
+        infeed_manager_->Release(std::move(in_flight[i]), stream_.get()));
+  }
+}
+
+TEST_F(InfeedManagerTest, FailedTransferReturnsStagingBuffer) {
+  Literal small = LiteralUtil::CreateR1<float>({1, 2, 3, 4});
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, small));
+  InfeedBuffers buffers = Consume();
+  InfeedStagingBuffer* staging = buffers.staging;
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers), stream_.get()));
+
+  // Occupy almost all device memory, so that growing the staging buffer fails.
+  int64_t free_memory = 0, total_memory = 0;
+  ASSERT_TRUE(executor_->DeviceMemoryUsage(&free_memory, &total_memory));
+  constexpr int64_t kLargeSize = 256 * 1024 * 1024;
+  se::DeviceMemoryBase hog;
+  for (int64_t size = free_memory; size > kLargeSize; size -= kLargeSize / 4) {
+    hog = executor_->Allocate(size - kLargeSize / 2);
+    if (!hog.is_null()) break;
+  }
+  if (hog.is_null()) GTEST_SKIP() << "Failed to occupy device memory";
+
+  Literal large(ShapeUtil::MakeShape(U8, {kLargeSize}));
+  absl::Status status =
+      infeed_manager_->TransferLiteralToInfeed(executor_, large);
+  executor_->Deallocate(&hog);
+  ASSERT_EQ(status.code(), absl::StatusCode::kResourceExhausted);
+
+  // The staging buffer was returned to the pool, and the next transfer reuses
+  // it instead of allocating a new one.
+  TF_ASSERT_OK(infeed_manager_->TransferLiteralToInfeed(executor_, small));
+  buffers = Consume();
+  EXPECT_EQ(buffers.staging, staging);
+  EXPECT_TRUE(LiteralTestUtil::Equal(small, ToLiteral(buffers, {})));
+  TF_ASSERT_OK(infeed_manager_->Release(std::move(buffers), stream_.get()));
+}
+
+}  // namespace
+}  // namespace xla::gpu
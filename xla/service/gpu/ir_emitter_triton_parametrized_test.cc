@@ -2241,6 +2241,56 @@ ENTRY main {
                             ErrorSpec(/*aabs=*/tolerance, /*arel=*/tolerance)));
 }
 
+TEST_F(TritonSoftmaxTest, CanFuseAndEmitLayerNormWithSiblingReductions) {
+  const std::string hlo_text = R"(
+HloModule layernorm
+
+add {
+  Arg_0 = f32[] parameter(0)
+  Arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(Arg_0, Arg_1)
+}
+
+ENTRY main {
+  param_0 = f32[125,127]{1,0} parameter(0)
+  constant_0 = f32[] constant(0)
+  reduce_x = f32[125]{0} reduce(param_0, constant_0), dimensions={1}, to_apply=add
+  constant_n = f32[] constant(0.00787401576)
+  splat_n = f32[125]{0} broadcast(constant_n), dimensions={}
+  mean = f32[125]{0} multiply(reduce_x, splat_n)
+  square = f32[125,127]{1,0} multiply(param_0, param_0)
+  reduce_square = f32[125]{0} reduce(square, constant_0), dimensions={1}, to_apply=add
+  mean_square = f32[125]{0} multiply(reduce_square, splat_n)
+  mean_squared = f32[125]{0} multiply(mean, mean)
+  variance = f32[125]{0} subtract(mean_square, mean_squared)
+  epsilon = f32[] constant(1e-05)
+  splat_epsilon = f32[125]{0} broadcast(epsilon), dimensions={}
+  add_epsilon = f32[125]{0} add(variance, splat_epsilon)
+  rsqrt = f32[125]{0} rsqrt(add_epsilon)
+  broadcast_mean = f32[125,127]{1,0} broadcast(mean), dimensions={0}
+  centered = f32[125,127]{1,0} subtract(param_0, broadcast_mean)
+  broadcast_rsqrt = f32[125,127]{1,0} broadcast(rsqrt), dimensions={0}
+  ROOT normalized = f32[125,127]{1,0} multiply(centered, broadcast_rsqrt)
+}
+)";
+
+  // Both reductions read the same parameter, so the whole normalization is
+  // emitted as a single Triton fusion.
+  const std::string hlo_ref = R"(
+; CHECK:    ENTRY
+; CHECK:      %[[param_0:.*]] = f32[125,127]{1,0} parameter(0)
+; CHECK:      ROOT
+; CHECK-SAME:   f32[125,127]{1,0} fusion(%[[param_0]])
+; CHECK-SAME:   kind=kCustom
+; CHECK-SAME:   triton_softmax
+)";
+  MatchOptimizedHlo(hlo_text, hlo_ref);
+
+  float tolerance = 1e-5;
+  EXPECT_TRUE(RunAndCompare(hlo_text,
+                            ErrorSpec(/*aabs=*/tolerance, /*arel=*/tolerance)));
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -25,6 +25,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -574,11 +575,12 @@ absl::Status IrEmitterUnnested::EmitCommandBufferThunk(
 
   // Maybe serialize all commands in a sequence by forcing barriers between all
   // recorded commands. This guarantees that we execute all device operations
-  // in the exact same order as a thunk sequence.
+  // in the exact same order as a thunk sequence. Otherwise build a dependency
+  // DAG from buffer uses and execute independent commands concurrently.
   CommandBufferCmdSequence::SynchronizationMode synchronization_mode =
       ir_emitter_context_->debug_options()
               .xla_gpu_graph_enable_concurrent_region()
-          ? CommandBufferCmdSequence::SynchronizationMode::kAutomatic
+          ? CommandBufferCmdSequence::SynchronizationMode::kConcurrent
           : CommandBufferCmdSequence::SynchronizationMode::kSerialize;
 
   TF_ASSIGN_OR_RETURN(CommandBufferCmdSequence cmd_sequence,
@@ -2330,6 +2332,27 @@ absl::Status IrEmitterUnnested::EmitNcclThunk(
     auto thunk = std::make_unique<NcclThunkType>(
         Thunk::ThunkInfo::WithProfileAnnotation(inst), NcclApi::Default(), inst,
         /*buffers=*/std::move(buffers));
+    if constexpr (std::is_same_v<NcclThunkType, NcclAllReduceStartThunk>) {
+      // Launch adjacent all-reduces in a single NCCL group by replacing the
+      // previous all-reduce start with a coalesced one. Both done thunks wait
+      // for the async events of the coalesced thunk.
+      Thunk* prev = thunk_sequence_.empty() ? nullptr
+                                            : thunk_sequence_.back().get();
+      if (ir_emitter_context_->debug_options()
+              .xla_gpu_enable_nccl_all_reduce_coalescing() &&
+          prev != nullptr && prev->kind() == Thunk::kNcclAllReduceStart &&
+          static_cast<NcclAllReduceStartThunk*>(prev)->CanCoalesceWith(
+              *thunk)) {
+        VLOG(2) << "Coalesce " << inst->name() << " with all-reduce start "
+                << prev->profile_annotation();
+        auto coalesced = NcclAllReduceStartThunk::Coalesce(
+            *static_cast<NcclAllReduceStartThunk*>(prev), *thunk);
+        GetCollectivesAsyncEvents().insert(
+            {async_start, coalesced->async_events()});
+        thunk_sequence_.back() = std::move(coalesced);
+        return absl::OkStatus();
+      }
+    }
     GetCollectivesAsyncEvents().insert({async_start, thunk->async_events()});
     AddThunkToThunkSequence(std::move(thunk));
     return absl::OkStatus();
@@ -2394,9 +2417,14 @@ absl::Status IrEmitterUnnested::EmitNcclAsyncDone(Thunk::Kind kind,
   // Can be null if no start thunk was created (e.g. if the start op is
   // degenerate), in which case there's nothing to do here.
   if (async_events.mapped()) {
+    AsyncStreamKind stream_kind = AsyncStreamKind::kCollective;
+    if (kind == Thunk::Kind::kNcclAllToAllDone) {
+      stream_kind = GetAllToAllStreamKind(
+          Cast<HloAllToAllInstruction>(start->async_wrapped_instruction()));
+    }
     AddThunkToThunkSequence(std::make_unique<NcclCollectiveDoneThunk>(
         kind, Thunk::ThunkInfo::WithProfileAnnotation(inst),
-        std::move(async_events.mapped()), AsyncStreamKind::kCollective));
+        std::move(async_events.mapped()), stream_kind));
   }
   return absl::OkStatus();
 }
@@ -0,0 +1,77 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/kernel_binary_registry.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tsl/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+
+static absl::string_view AsStringView(const KernelBinaryRegistry::Binary& b) {
+  return absl::string_view(reinterpret_cast<const char*>(b.data()), b.size());
+}
+
+KernelBinaryRegistry& KernelBinaryRegistry::Global() {
+  static auto* registry = new KernelBinaryRegistry();
+  return *registry;
+}
+
+std::shared_ptr<const KernelBinaryRegistry::Binary>
+KernelBinaryRegistry::Intern(Binary binary) {
+  absl::MutexLock lock(&mu_);
+  auto it = binaries_.find(AsStringView(binary));
+  if (it != binaries_.end()) {
+    // The entry may be expired if the last owner is being destroyed
+    // concurrently. Its deleter only erases the entry it was registered with,
+    // so it is safe to replace it below.
+    if (std::shared_ptr<const Binary> existing = it->second.lock()) {
+      VLOG(3) << "Reusing GPU binary of " << binary.size() << " bytes";
+      return existing;
+    }
+    binaries_.erase(it);
+  }
+
+  std::shared_ptr<const Binary> interned(
+      new Binary(std::move(binary)), [this](const Binary* binary) {
+        Erase(binary);
+        delete binary;
+      });
+  binaries_.emplace(AsStringView(*interned), interned);
+  return interned;
+}
+
+int64_t KernelBinaryRegistry::size() const {
+  absl::MutexLock lock(&mu_);
+  return binaries_.size();
+}
+
+void KernelBinaryRegistry::Erase(const Binary* binary) {
+  absl::MutexLock lock(&mu_);
+  absl::string_view key = AsStringView(*binary);
+  auto it = binaries_.find(key);
+  if (it != binaries_.end() && it->first.data() == key.data()) {
+    binaries_.erase(it);
+  }
+}
+
+}  // namespace gpu
+}  // namespace xla
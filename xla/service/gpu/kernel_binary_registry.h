@@ -0,0 +1,66 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_KERNEL_BINARY_REGISTRY_H_
+#define XLA_SERVICE_GPU_KERNEL_BINARY_REGISTRY_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace xla {
+namespace gpu {
+
+// Process-wide, content-addressed registry of GPU binaries.
+//
+// StreamExecutor loads a module once per distinct binary address and
+// reference counts it across kernels. Interning the binaries of all
+// executables makes executables with identical code share one address, so
+// their kernels are loaded into the device only once and the host keeps a
+// single copy of the binary.
+//
+// Thread-safe.
+class KernelBinaryRegistry {
+ public:
+  using Binary = std::vector<uint8_t>;
+
+  static KernelBinaryRegistry& Global();
+
+  // Returns a binary with the same contents as `binary`. If a binary with the
+  // same contents is still alive, it is returned instead of `binary`.
+  std::shared_ptr<const Binary> Intern(Binary binary);
+
+  // Number of distinct binaries that are currently alive.
+  int64_t size() const;
+
+ private:
+  void Erase(const Binary* binary);
+
+  mutable absl::Mutex mu_;
+  // Keys point into the binaries themselves. An entry is erased before its
+  // binary is destroyed.
+  absl::flat_hash_map<absl::string_view, std::weak_ptr<const Binary>> binaries_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_KERNEL_BINARY_REGISTRY_H_
@@ -0,0 +1,52 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/kernel_binary_registry.h"
+
+#include <memory>
+#include <vector>
+
+#include "tsl/platform/test.h"
+
+namespace xla::gpu {
+namespace {
+
+using Binary = KernelBinaryRegistry::Binary;
+
+TEST(KernelBinaryRegistryTest, IdenticalBinariesAreShared) {
+  KernelBinaryRegistry registry;
+  std::shared_ptr<const Binary> a = registry.Intern(Binary{1, 2, 3});
+  std::shared_ptr<const Binary> b = registry.Intern(Binary{1, 2, 3});
+  std::shared_ptr<const Binary> c = registry.Intern(Binary{1, 2, 4});
+
+  EXPECT_EQ(a.get(), b.get());
+  EXPECT_NE(a.get(), c.get());
+  EXPECT_EQ(*c, Binary({1, 2, 4}));
+  EXPECT_EQ(registry.size(), 2);
+}
+
+TEST(KernelBinaryRegistryTest, ReleasedBinariesAreForgotten) {
+  KernelBinaryRegistry registry;
+  std::shared_ptr<const Binary> a = registry.Intern(Binary{1, 2, 3});
+  a.reset();
+  EXPECT_EQ(registry.size(), 0);
+
+  std::shared_ptr<const Binary> b = registry.Intern(Binary{1, 2, 3});
+  EXPECT_EQ(*b, Binary({1, 2, 3}));
+  EXPECT_EQ(registry.size(), 1);
+}
+
+}  // namespace
+}  // namespace xla::gpu
@@ -40,6 +40,16 @@ auto* xla_device_binary_size = tsl::monitoring::Gauge<int64_t, 0>::New(
     "/xla/service/gpu/xla_device_binary_size",
     "The size of the XLA binary loaded onto the GPU device.");
 
+auto* collective_cliques_acquire_time_usecs_histogram =
+    tsl::monitoring::Sampler<0>::New(
+        {"/xla/service/gpu/collective_cliques_acquire_time_usecs_histogram",
+         "The wall-clock time spent on acquiring collective cliques before "
+         "execution in microseconds, including cliques initialization."},
+        // These exponential buckets cover the following range:
+        // Minimum: 1 us
+        // Maximum: 1 us * 2 ^ 34 == ~4.77 hours
+        {tsl::monitoring::Buckets::Exponential(1, 2, 35)});
+
 }  // namespace
 
 void RecordHloPassesDuration(const uint64_t time_usecs) {
@@ -47,6 +57,11 @@ void RecordHloPassesDuration(const uint64_t time_usecs) {
   cell->Add(time_usecs);
 }
 
+void RecordPriorityFusionDuration(const uint64_t time_usecs) {
+  static auto* cell = compile_time_usecs_histogram->GetCell("priority_fusion");
+  cell->Add(time_usecs);
+}
+
 void RecordHloToLlvmDuration(const uint64_t time_usecs) {
   static auto* cell = compile_time_usecs_histogram->GetCell("hlo_to_llvm");
   cell->Add(time_usecs);
@@ -93,4 +108,8 @@ void RecordXlaDeviceBinarySize(const int64_t size) {
   xla_device_binary_size->GetCell()->Set(size);
 }
 
+void RecordCollectiveCliquesAcquireDuration(const uint64_t time_usecs) {
+  collective_cliques_acquire_time_usecs_histogram->GetCell()->Add(time_usecs);
+}
+
 }  // namespace xla
@@ -23,6 +23,9 @@ namespace xla {
 // HLO passes (HLO -> HLO).
 void RecordHloPassesDuration(uint64_t time_usecs);
 
+// The GpuPriorityFusion pass only.
+void RecordPriorityFusionDuration(uint64_t time_usecs);
+
 // Compiling HLO to LLVM.
 void RecordHloToLlvmDuration(uint64_t time_usecs);
 
@@ -52,6 +55,9 @@ int64_t GetCompiledProgramsCount();
 // Records the size of the XLA device binary in bytes.
 void RecordXlaDeviceBinarySize(int64_t size);
 
+// Acquiring (and maybe initializing) collective cliques before execution.
+void RecordCollectiveCliquesAcquireDuration(uint64_t time_usecs);
+
 }  // namespace xla
 
 #endif  // XLA_SERVICE_GPU_METRICS_H_
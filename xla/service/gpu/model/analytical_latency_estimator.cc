@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/model/analytical_latency_estimator.h"
 
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "absl/log/log.h"
@@ -23,6 +24,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/utils/hlo_query.h"
+#include "xla/service/gpu/model/collective_performance_table.h"
 #include "xla/service/gpu/model/gpu_collective_performance_model.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/model/gpu_performance_model.h"
@@ -45,7 +47,10 @@ LatencyEstimator::TimeCost AnalyticalLatencyEstimator::GetLatencyBetween(
   if (IsAsyncPair(from, target)) {
     double coll_time = absl::ToDoubleMicroseconds(
         GpuPerformanceWithCollectiveModel::ComputeCollectiveTime(
-            from.GetInstr(), &*cost_analysis_, gpu_info_));
+            from.GetInstr(), &*cost_analysis_, gpu_info_,
+            collective_performance_table_.has_value()
+                ? &*collective_performance_table_
+                : nullptr));
     VLOG(10) << "Analytical estimator calculated latency between "
              << from.GetInstr().name() << " and " << target.GetInstr().name()
              << " to be: " << coll_time << " us.";
@@ -78,11 +83,13 @@ AnalyticalLatencyEstimator::AnalyticalLatencyEstimator(
     std::unique_ptr<LatencyEstimator> latency_estimator,
     const se::DeviceDescription& gpu_info,
     HloCostAnalysis::ShapeSizeFunction shape_size_function,
-    HloComputation* computation)
+    HloComputation* computation,
+    std::optional<CollectivePerformanceTable> collective_performance_table)
     : config_(config),
       gpu_info_(gpu_info),
       latency_estimator_(std::move(latency_estimator)),
-      shape_size_function_(shape_size_function) {
+      shape_size_function_(shape_size_function),
+      collective_performance_table_(std::move(collective_performance_table)) {
   cost_analysis_.emplace(
       GpuHloCostAnalysis::Options{shape_size_function_,
                                   /*per_second_rates=*/{},
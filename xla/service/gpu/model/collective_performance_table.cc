@@ -0,0 +1,313 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/collective_performance_table.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/collective_performance_profile.pb.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/util.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/env.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Returns the opcode of the synchronous collective performed by `instr`.
+std::optional<HloOpcode> GetSyncCollectiveOpcode(const HloInstruction& instr) {
+  switch (instr.opcode()) {
+    case HloOpcode::kAllGather:
+    case HloOpcode::kAllReduce:
+    case HloOpcode::kAllToAll:
+    case HloOpcode::kCollectivePermute:
+    case HloOpcode::kReduceScatter:
+      return instr.opcode();
+    case HloOpcode::kAllGatherStart:
+      return HloOpcode::kAllGather;
+    case HloOpcode::kAllReduceStart:
+      return HloOpcode::kAllReduce;
+    case HloOpcode::kCollectivePermuteStart:
+      return HloOpcode::kCollectivePermute;
+    case HloOpcode::kAsyncStart:
+      return GetSyncCollectiveOpcode(*instr.async_wrapped_instruction());
+    default:
+      return std::nullopt;
+  }
+}
+
+int64_t GetArrayBytes(const Shape& shape) {
+  int64_t bytes = 0;
+  ShapeUtil::ForEachSubshape(
+      shape, [&](const Shape& subshape, const ShapeIndex& index) {
+        if (subshape.IsArray()) {
+          bytes += ShapeUtil::ByteSizeOfElements(subshape);
+        }
+      });
+  return bytes;
+}
+
+// Returns the size of the larger of the input and output buffers, which is
+// how nccl-tests reports message sizes.
+int64_t GetMessageSizeBytes(const HloInstruction& collective) {
+  int64_t input_bytes = 0;
+  for (const HloInstruction* operand : collective.operands()) {
+    input_bytes += GetArrayBytes(operand->shape());
+  }
+  int64_t output_bytes = 0;
+  switch (collective.opcode()) {
+    case HloOpcode::kAllGatherStart:
+      // The result is a tuple of the operands and the gathered outputs.
+      output_bytes = GetArrayBytes(collective.shape().tuple_shapes(1));
+      break;
+    case HloOpcode::kCollectivePermuteStart:
+      output_bytes = input_bytes;
+      break;
+    default:
+      output_bytes = GetArrayBytes(collective.shape());
+      break;
+  }
+  return std::max(input_bytes, output_bytes);
+}
+
+// Returns the devices of the first replica group (or source-target pair) of
+// the collective, or an empty vector if groups are not specified.
+std::vector<int64_t> GetFirstGroupDevices(const HloInstruction& collective) {
+  if (collective.opcode() == HloOpcode::kCollectivePermute ||
+      collective.opcode() == HloOpcode::kCollectivePermuteStart) {
+    const auto& pairs = collective.source_target_pairs();
+    if (pairs.empty()) return {};
+    return {pairs[0].first, pairs[0].second};
+  }
+  if (collective.replica_groups().empty()) return {};
+  const auto& replica_ids = collective.replica_groups()[0].replica_ids();
+  return std::vector<int64_t>(replica_ids.begin(), replica_ids.end());
+}
+
+}  // namespace
+
+CollectivePerformanceTable::CollectivePerformanceTable(
+    const CollectivePerformanceProfile& profile)
+    : devices_per_host_(profile.devices_per_host()) {
+  for (const auto& curve_proto : profile.curves()) {
+    auto opcode = StringToHloOpcode(curve_proto.opcode());
+    if (!opcode.ok()) {
+      LOG(WARNING) << "Ignoring collective performance curve: "
+                   << opcode.status();
+      continue;
+    }
+    if (curve_proto.measurements().empty()) continue;
+
+    Curve curve{curve_proto.num_devices(),
+                std::max<int64_t>(curve_proto.num_hosts(), 1),
+                /*measurements=*/{}};
+    for (const auto& measurement : curve_proto.measurements()) {
+      curve.measurements.push_back({measurement.message_size_bytes(),
+                                    absl::Nanoseconds(measurement.time_ns())});
+    }
+    absl::c_sort(curve.measurements);
+    curves_[*opcode].push_back(std::move(curve));
+  }
+}
+
+/*static*/ absl::Duration CollectivePerformanceTable::Interpolate(
+    const Curve& curve, int64_t message_size_bytes) {
+  const auto& measurements = curve.measurements;
+  if (message_size_bytes <= measurements.front().first) {
+    return measurements.front().second;
+  }
+
+  auto upper = absl::c_lower_bound(
+      measurements, message_size_bytes,
+      [](const auto& measurement, int64_t size) {
+        return measurement.first < size;
+      });
+  if (upper != measurements.end()) {
+    auto lower = std::prev(upper);
+    double fraction = static_cast<double>(message_size_bytes - lower->first) /
+                      (upper->first - lower->first);
+    return lower->second + (upper->second - lower->second) * fraction;
+  }
+
+  // Extrapolate with the bandwidth of the last segment. Fall back to scaling
+  // the last measurement if there is no segment or the measurements are too
+  // noisy to give a positive bandwidth.
+  const auto& last = measurements.back();
+  if (measurements.size() >= 2) {
+    const auto& second_to_last = measurements[measurements.size() - 2];
+    absl::Duration delta = last.second - second_to_last.second;
+    if (delta > absl::ZeroDuration()) {
+      return last.second +
+             delta * (static_cast<double>(message_size_bytes - last.first) /
+                      (last.first - second_to_last.first));
+    }
+  }
+  if (last.first <= 0) return last.second;
+  return last.second * (static_cast<double>(message_size_bytes) / last.first);
+}
+
+const CollectivePerformanceTable::Curve* CollectivePerformanceTable::FindCurve(
+    HloOpcode opcode, int64_t num_devices, int64_t num_hosts) const {
+  auto it = curves_.find(opcode);
+  if (it == curves_.end()) return nullptr;
+
+  // Among the curves measured on the same number of hosts, pick the one with
+  // the closest number of devices, preferring larger groups on ties.
+  const Curve* best = nullptr;
+  for (const Curve& curve : it->second) {
+    if (curve.num_hosts != num_hosts) continue;
+    if (best == nullptr) {
+      best = &curve;
+      continue;
+    }
+    int64_t distance = std::abs(curve.num_devices - num_devices);
+    int64_t best_distance = std::abs(best->num_devices - num_devices);
+    if (distance < best_distance ||
+        (distance == best_distance && curve.num_devices > best->num_devices)) {
+      best = &curve;
+    }
+  }
+  return best;
+}
+
+int64_t CollectivePerformanceTable::GetNumHosts(
+    const HloInstruction& collective, int64_t num_devices) const {
+  int64_t num_hosts = 1;
+  if (devices_per_host_ > 0) {
+    std::vector<int64_t> devices = GetFirstGroupDevices(collective);
+    if (devices.empty()) {
+      num_hosts = CeilOfRatio(num_devices, devices_per_host_);
+    } else {
+      absl::flat_hash_set<int64_t> hosts;
+      for (int64_t device : devices) hosts.insert(device / devices_per_host_);
+      num_hosts = hosts.size();
+    }
+  }
+  return std::max<int64_t>(num_hosts, 1);
+}
+
+std::optional<absl::Duration> CollectivePerformanceTable::Estimate(
+    HloOpcode opcode, int64_t num_devices, int64_t num_hosts,
+    int64_t message_size_bytes) const {
+  const Curve* curve = FindCurve(opcode, num_devices, num_hosts);
+  if (curve == nullptr) return std::nullopt;
+  return Interpolate(*curve, message_size_bytes);
+}
+
+std::optional<absl::Duration> CollectivePerformanceTable::Estimate(
+    const HloInstruction& instr, int64_t num_devices) const {
+  std::optional<HloOpcode> opcode = GetSyncCollectiveOpcode(instr);
+  if (!opcode.has_value()) return std::nullopt;
+
+  const HloInstruction& collective = instr.opcode() == HloOpcode::kAsyncStart
+                                         ? *instr.async_wrapped_instruction()
+                                         : instr;
+
+  return Estimate(*opcode, num_devices, GetNumHosts(collective, num_devices),
+                  GetMessageSizeBytes(collective));
+}
+
+std::optional<int64_t> CollectivePerformanceTable::CombineThresholdBytes(
+    const HloInstruction& instr, int64_t num_devices,
+    double min_savings) const {
+  std::optional<HloOpcode> opcode = GetSyncCollectiveOpcode(instr);
+  if (!opcode.has_value()) return std::nullopt;
+
+  const HloInstruction& collective = instr.opcode() == HloOpcode::kAsyncStart
+                                         ? *instr.async_wrapped_instruction()
+                                         : instr;
+
+  const Curve* curve = FindCurve(*opcode, num_devices,
+                                 GetNumHosts(collective, num_devices));
+  if (curve == nullptr) return std::nullopt;
+
+  // Savings of combining shrink as messages grow, and beyond the largest
+  // measured message times are extrapolated linearly, so we stop doubling the
+  // message size at twice the largest measurement.
+  const auto& measurements = curve->measurements;
+  int64_t threshold = std::max<int64_t>(measurements.front().first, 1);
+  for (int64_t size = 2 * threshold; size / 2 <= measurements.back().first;
+       size *= 2) {
+    absl::Duration combined = Interpolate(*curve, size);
+    absl::Duration separate = 2 * Interpolate(*curve, size / 2);
+    if (combined > separate * (1.0 - min_savings)) break;
+    threshold = size;
+  }
+  return threshold;
+}
+
+int64_t GetCombineThresholdBytes(const HloModule& module, HloOpcode opcode,
+                                 const CollectivePerformanceTable& table,
+                                 int64_t threshold_bytes) {
+  int64_t combine_threshold_bytes = threshold_bytes;
+  for (const HloComputation* computation : module.computations()) {
+    for (const HloInstruction* instr : computation->instructions()) {
+      if (instr->opcode() != opcode) continue;
+      int64_t num_devices =
+          instr->replica_groups().empty()
+              ? module.config().replica_count()
+              : instr->replica_groups()[0].replica_ids_size();
+      if (std::optional<int64_t> threshold =
+              table.CombineThresholdBytes(*instr, num_devices)) {
+        combine_threshold_bytes = std::min(combine_threshold_bytes, *threshold);
+      }
+    }
+  }
+  if (combine_threshold_bytes != threshold_bytes) {
+    VLOG(1) << "Lower " << HloOpcodeString(opcode)
+            << " combine threshold from " << threshold_bytes << " to "
+            << combine_threshold_bytes << " bytes";
+  }
+  return combine_threshold_bytes;
+}
+
+std::optional<CollectivePerformanceTable> ReadCollectivePerformanceTable(
+    const DebugOptions& debug_options) {
+  const std::string& path =
+      debug_options.xla_gpu_collective_performance_profile_file();
+  if (path.empty()) {
+    return std::nullopt;
+  }
+  CollectivePerformanceProfile profile;
+  absl::Status s = tsl::ReadTextProto(tsl::Env::Default(), path, &profile);
+  if (!s.ok()) {
+    LOG(ERROR) << "Unable to read collective performance profile from "
+               << path << ": " << s.message();
+    return std::nullopt;
+  }
+  LOG(INFO) << "Using collective performance profile from " << path;
+  return CollectivePerformanceTable(profile);
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,109 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_MODEL_COLLECTIVE_PERFORMANCE_TABLE_H_
+#define XLA_SERVICE_GPU_MODEL_COLLECTIVE_PERFORMANCE_TABLE_H_
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/collective_performance_profile.pb.h"
+#include "xla/xla.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Estimates collective execution times by interpolating the measurements of a
+// CollectivePerformanceProfile. Times are interpolated linearly in message
+// size between measurements. Messages smaller than the smallest measured one
+// are assumed to be latency bound, and times of messages larger than the
+// largest measured one are extrapolated with the bandwidth of the last
+// measured segment.
+class CollectivePerformanceTable {
+ public:
+  explicit CollectivePerformanceTable(
+      const CollectivePerformanceProfile& profile);
+
+  // Returns the estimated time of a collective, or nullopt if the profile has
+  // no curve for the collective and number of hosts. `opcode` is the opcode of
+  // the synchronous collective. If there is no curve for `num_devices`, the
+  // curve with the closest number of devices is used.
+  std::optional<absl::Duration> Estimate(HloOpcode opcode, int64_t num_devices,
+                                         int64_t num_hosts,
+                                         int64_t message_size_bytes) const;
+
+  // Same as above for a (sync or async start) collective instruction. The
+  // topology is derived from the first replica group of `instr`, and
+  // `num_devices` is the size of its replica groups.
+  std::optional<absl::Duration> Estimate(const HloInstruction& instr,
+                                         int64_t num_devices) const;
+
+  // Returns the largest message size for which combining collectives like
+  // `instr` still pays off: combining two messages of half that size into one
+  // saves at least `min_savings` of their time. Larger messages are bandwidth
+  // bound, and combining them only delays the start of communication. Returns
+  // nullopt if the profile has no curve for the collective.
+  std::optional<int64_t> CombineThresholdBytes(const HloInstruction& instr,
+                                               int64_t num_devices,
+                                               double min_savings = 0.1) const;
+
+ private:
+  struct Curve {
+    int64_t num_devices;
+    int64_t num_hosts;
+    // Pairs of message size and time sorted by message size.
+    std::vector<std::pair<int64_t, absl::Duration>> measurements;
+  };
+
+  static absl::Duration Interpolate(const Curve& curve,
+                                    int64_t message_size_bytes);
+
+  // Returns the curve measured on `num_hosts` with the closest number of
+  // devices, or nullptr if there is none.
+  const Curve* FindCurve(HloOpcode opcode, int64_t num_devices,
+                         int64_t num_hosts) const;
+
+  // Returns the number of hosts spanned by the replica groups of `collective`.
+  int64_t GetNumHosts(const HloInstruction& collective,
+                      int64_t num_devices) const;
+
+  int64_t devices_per_host_;
+  absl::flat_hash_map<HloOpcode, std::vector<Curve>> curves_;
+};
+
+// Returns `threshold_bytes` lowered to the smallest combine threshold (see
+// `CombineThresholdBytes`) of all collectives with `opcode` in `module`. Returns
+// `threshold_bytes` if the profile has no curves for them.
+int64_t GetCombineThresholdBytes(const HloModule& module, HloOpcode opcode,
+                                 const CollectivePerformanceTable& table,
+                                 int64_t threshold_bytes);
+
+// Reads the collective performance profile given by
+// `xla_gpu_collective_performance_profile_file`. Returns nullopt if no profile
+// is given or it can't be read.
+std::optional<CollectivePerformanceTable> ReadCollectivePerformanceTable(
+    const DebugOptions& debug_options);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_MODEL_COLLECTIVE_PERFORMANCE_TABLE_H_
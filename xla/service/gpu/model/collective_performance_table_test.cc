@@ -0,0 +1,162 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/collective_performance_table.h"
+
+#include <optional>
+
+#include <gtest/gtest.h>
+#include "absl/log/check.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/collective_performance_profile.pb.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/protobuf.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr char kProfile[] = R"pb(
+  devices_per_host: 8
+  curves {
+    opcode: "all-reduce"
+    num_devices: 8
+    num_hosts: 1
+    measurements { message_size_bytes: 1024 time_ns: 10000 }
+    measurements { message_size_bytes: 1048576 time_ns: 20000 }
+    measurements { message_size_bytes: 2097152 time_ns: 30000 }
+  }
+  curves {
+    opcode: "all-reduce"
+    num_devices: 2
+    num_hosts: 2
+    measurements { message_size_bytes: 1024 time_ns: 50000 }
+  }
+)pb";
+
+class CollectivePerformanceTableTest : public HloTestBase {
+ protected:
+  CollectivePerformanceTable MakeTable() {
+    CollectivePerformanceProfile profile;
+    CHECK(tsl::protobuf::TextFormat::ParseFromString(kProfile, &profile));
+    return CollectivePerformanceTable(profile);
+  }
+};
+
+TEST_F(CollectivePerformanceTableTest, InterpolatesBetweenMeasurements) {
+  CollectivePerformanceTable table = MakeTable();
+  // Small messages are latency bound.
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllReduce, 8, 1, 16),
+            absl::Microseconds(10));
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllReduce, 8, 1, 1572864),
+            absl::Microseconds(25));
+  // Large messages are extrapolated with the bandwidth of the last segment.
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllReduce, 8, 1, 3145728),
+            absl::Microseconds(40));
+}
+
+TEST_F(CollectivePerformanceTableTest, MatchesTopology) {
+  CollectivePerformanceTable table = MakeTable();
+  // The closest group size measured on the same number of hosts is used.
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllReduce, 4, 1, 1024),
+            absl::Microseconds(10));
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllReduce, 4, 2, 1024),
+            absl::Microseconds(50));
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllReduce, 16, 4, 1024), std::nullopt);
+  EXPECT_EQ(table.Estimate(HloOpcode::kAllGather, 8, 1, 1024), std::nullopt);
+}
+
+TEST_F(CollectivePerformanceTableTest, EstimatesInstructions) {
+  constexpr char kHlo[] = R"(
+    HloModule m
+
+    add {
+      x = f32[] parameter(0)
+      y = f32[] parameter(1)
+      ROOT add = f32[] add(x, y)
+    }
+
+    ENTRY e {
+      p = f32[256] parameter(0)
+      intra = f32[256] all-reduce-start(p),
+        replica_groups={{0,1,2,3,4,5,6,7},{8,9,10,11,12,13,14,15}},
+        to_apply=add
+      intra-done = f32[256] all-reduce-done(intra)
+      ROOT inter = f32[256] all-reduce(intra-done),
+        replica_groups={{0,8},{1,9},{2,10},{3,11},{4,12},{5,13},{6,14},{7,15}},
+        to_apply=add
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(kHlo, /*replica_count=*/16));
+  CollectivePerformanceTable table = MakeTable();
+
+  const HloInstruction* intra = FindInstruction(module.get(), "intra");
+  EXPECT_EQ(table.Estimate(*intra, /*num_devices=*/8), absl::Microseconds(10));
+
+  // Devices of the group are on different hosts.
+  const HloInstruction* inter = FindInstruction(module.get(), "inter");
+  EXPECT_EQ(table.Estimate(*inter, /*num_devices=*/2), absl::Microseconds(50));
+}
+
+TEST_F(CollectivePerformanceTableTest, CombineThresholdBytes) {
+  constexpr char kHlo[] = R"(
+    HloModule m
+
+    add {
+      x = f32[] parameter(0)
+      y = f32[] parameter(1)
+      ROOT add = f32[] add(x, y)
+    }
+
+    ENTRY e {
+      p = f32[256] parameter(0)
+      ROOT intra = f32[256] all-reduce(p),
+        replica_groups={{0,1,2,3,4,5,6,7},{8,9,10,11,12,13,14,15}},
+        to_apply=add
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(kHlo, /*replica_count=*/16));
+  CollectivePerformanceTable table = MakeTable();
+  const HloInstruction* intra = FindInstruction(module.get(), "intra");
+
+  // Combining two 1 MiB all-reduces into one saves 1 - 30us / 40us = 25%, and
+  // combining two 2 MiB all-reduces saves 1 - 50us / 60us = 17%. Sizes above
+  // twice the largest measurement are not considered.
+  EXPECT_EQ(table.CombineThresholdBytes(*intra, 8, /*min_savings=*/0.1),
+            4194304);
+  EXPECT_EQ(table.CombineThresholdBytes(*intra, 8, /*min_savings=*/0.2),
+            2097152);
+  EXPECT_EQ(table.CombineThresholdBytes(*intra, 8, /*min_savings=*/0.5),
+            1024);
+
+  // The smallest threshold of all collectives of the module is used, and
+  // the flag value is an upper bound.
+  EXPECT_EQ(GetCombineThresholdBytes(*module, HloOpcode::kAllReduce, table,
+                                     /*threshold_bytes=*/1 << 30),
+            4194304);
+  EXPECT_EQ(GetCombineThresholdBytes(*module, HloOpcode::kAllReduce, table,
+                                     /*threshold_bytes=*/1 << 20),
+            1 << 20);
+  EXPECT_EQ(GetCombineThresholdBytes(*module, HloOpcode::kAllGather, table,
+                                     /*threshold_bytes=*/1 << 30),
+            1 << 30);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <optional>
 #include <vector>
 
 #include "absl/log/check.h"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/gpu/backend_configs.pb.h"
+#include "xla/service/gpu/model/collective_performance_table.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/hlo_dataflow_analysis.h"
 #include "xla/stream_executor/device_description.h"
@@ -277,7 +279,8 @@ GpuPerformanceWithCollectiveModel::ComputeAllreduceTime(
 /*static*/ absl::Duration
 GpuPerformanceWithCollectiveModel::ComputeCollectiveTime(
     const HloInstruction& instr, const GpuHloCostAnalysis* cost_analysis,
-    const se::DeviceDescription& gpu_device_info) {
+    const se::DeviceDescription& gpu_device_info,
+    const CollectivePerformanceTable* collective_performance_table) {
   if (cost_analysis->NumOfDevices(instr) == 1) {
     VLOG(8) << "Returning only kernel launch overhead for a single partition.";
     return kNcclKernelLaunchOverhead;
@@ -287,6 +290,16 @@ GpuPerformanceWithCollectiveModel::ComputeCollectiveTime(
     VLOG(8) << "Returning 0 cost for async done op " << instr.name();
     return absl::ZeroDuration();
   }
+
+  if (collective_performance_table != nullptr) {
+    if (std::optional<absl::Duration> measured_time =
+            collective_performance_table->Estimate(
+                instr, cost_analysis->NumOfDevices(instr))) {
+      VLOG(8) << "Using measured collective time for " << instr.name() << ": "
+              << *measured_time;
+      return *measured_time;
+    }
+  }
   switch (instr.opcode()) {
     case HloOpcode::kAllReduce:
     case HloOpcode::kAllReduceStart:
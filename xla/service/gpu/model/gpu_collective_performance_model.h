@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "absl/time/time.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/gpu/model/collective_performance_table.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/model/gpu_performance_model_base.h"
 #include "xla/stream_executor/device_description.h"
@@ -99,9 +100,13 @@ class GpuPerformanceWithCollectiveModel : public GpuPerformanceModelBase {
   static constexpr absl::Duration kNcclKernelLaunchOverhead =
       absl::Microseconds(5);
 
+  // Returns the estimated time of the collective `instr`. If
+  // `collective_performance_table` has measurements for the collective they
+  // are used instead of the analytical estimate.
   static absl::Duration ComputeCollectiveTime(
       const HloInstruction& instr, const GpuHloCostAnalysis* cost_analysis,
-      const se::DeviceDescription& gpu_device_info);
+      const se::DeviceDescription& gpu_device_info,
+      const CollectivePerformanceTable* collective_performance_table = nullptr);
 
   // Returns NVLink bw in GB/s
   static float GetNvlinkBw(se::CudaComputeCapability compute_capability);
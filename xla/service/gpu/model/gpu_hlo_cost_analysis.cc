@@ -19,6 +19,7 @@ limitations under the License.
 #include <cmath>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -40,6 +41,7 @@ limitations under the License.
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/gpu/cublas_cudnn.h"
 #include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/service/gpu/model/gpu_performance_calibration.h"
 #include "xla/service/gpu/model/hlo_op_profiles.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_module_config.h"
@@ -332,9 +334,16 @@ int64_t GpuHloCostAnalysis::GetConvolutionFlops(
 
 int64_t FlopsPerElement(const se::DeviceDescription* device_info,
                         const PrimitiveType type, const HloOpcode opcode) {
-  auto device_profile = HloOpProfiles::Singleton().GetProfile(device_info);
   // Elementwise instructions typically take at least a few clock cycles.
   constexpr int64_t kDefaultFlopsPerElement = 3;
+  if (device_info != nullptr) {
+    if (std::optional<int64_t> clock_cycles =
+            GpuPerformanceCalibrations::Global().GetClockCyclesPerOp(
+                *device_info, opcode, type)) {
+      return *clock_cycles;
+    }
+  }
+  auto device_profile = HloOpProfiles::Singleton().GetProfile(device_info);
   return FindOrDefault(device_profile, std::make_pair(opcode, type),
                        kDefaultFlopsPerElement);
 }
@@ -237,11 +237,13 @@ GpuPerformanceModelWithIndexingAnalysis::EstimateRunTimes(
     absl::Span<const HloInstruction* const> fused_consumers) {
   auto producer_runtime = EstimateRunTimeForInstruction(producer);
 
+  absl::Duration kernel_launch_overhead =
+      GetKernelLaunchOverhead(*device_info_);
   absl::Duration time_unfused =
-      kKernelLaunchOverhead * (fused_consumers.size() + 1) +
+      kernel_launch_overhead * (fused_consumers.size() + 1) +
       producer_runtime.exec_time;
 
-  absl::Duration time_fused = kKernelLaunchOverhead * fused_consumers.size();
+  absl::Duration time_fused = kernel_launch_overhead * fused_consumers.size();
 
   for (const auto& consumer : fused_consumers) {
     time_unfused += EstimateRunTimeForInstruction(consumer).exec_time;
@@ -0,0 +1,115 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/gpu_performance_calibration.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "absl/log/log.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/service/gpu/model/hlo_op_profiles.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+namespace gpu {
+
+/*static*/ GpuPerformanceCalibrations& GpuPerformanceCalibrations::Global() {
+  static auto* calibrations = new GpuPerformanceCalibrations();
+  return *calibrations;
+}
+
+void GpuPerformanceCalibrations::Register(
+    const DevicePerformanceCalibrations& calibrations) {
+  absl::MutexLock lock(&mu_);
+  for (const auto& [profile_name, calibration] : calibrations.entries()) {
+    DeviceCalibration device_calibration;
+    // Non-positive values mean that the parameter was not measured.
+    if (calibration.memory_bandwidth() > 0) {
+      device_calibration.memory_bandwidth = calibration.memory_bandwidth();
+    }
+    if (calibration.kernel_launch_overhead_ns() > 0) {
+      device_calibration.kernel_launch_overhead =
+          absl::Nanoseconds(calibration.kernel_launch_overhead_ns());
+    }
+    if (calibration.dram_to_l2_transaction_size_bytes() > 0) {
+      device_calibration.dram_to_l2_transaction_size_bytes =
+          calibration.dram_to_l2_transaction_size_bytes();
+    }
+    for (const auto& entry : calibration.op_profiles().entries()) {
+      auto op_code = StringToHloOpcode(entry.instruction().opcode()).value();
+      auto element_type = entry.instruction().shape().element_type();
+      device_calibration.op_profile[std::make_pair(op_code, element_type)] =
+          entry.clock_cycles();
+    }
+    VLOG(1) << "Registered performance model calibration for "
+            << profile_name;
+    calibrations_[profile_name] = std::move(device_calibration);
+  }
+}
+
+const GpuPerformanceCalibrations::DeviceCalibration*
+GpuPerformanceCalibrations::Find(
+    const se::DeviceDescription& device_info) const {
+  if (calibrations_.empty()) return nullptr;
+  auto it = calibrations_.find(HloOpProfiles::GetProfileName(&device_info));
+  if (it == calibrations_.end()) return nullptr;
+  return &it->second;
+}
+
+std::optional<int64_t> GpuPerformanceCalibrations::GetMemoryBandwidth(
+    const se::DeviceDescription& device_info) const {
+  absl::ReaderMutexLock lock(&mu_);
+  const DeviceCalibration* calibration = Find(device_info);
+  if (calibration == nullptr) return std::nullopt;
+  return calibration->memory_bandwidth;
+}
+
+std::optional<absl::Duration>
+GpuPerformanceCalibrations::GetKernelLaunchOverhead(
+    const se::DeviceDescription& device_info) const {
+  absl::ReaderMutexLock lock(&mu_);
+  const DeviceCalibration* calibration = Find(device_info);
+  if (calibration == nullptr) return std::nullopt;
+  return calibration->kernel_launch_overhead;
+}
+
+std::optional<int64_t>
+GpuPerformanceCalibrations::GetDramToL2TransactionSizeBytes(
+    const se::DeviceDescription& device_info) const {
+  absl::ReaderMutexLock lock(&mu_);
+  const DeviceCalibration* calibration = Find(device_info);
+  if (calibration == nullptr) return std::nullopt;
+  return calibration->dram_to_l2_transaction_size_bytes;
+}
+
+std::optional<int64_t> GpuPerformanceCalibrations::GetClockCyclesPerOp(
+    const se::DeviceDescription& device_info, HloOpcode opcode,
+    PrimitiveType element_type) const {
+  absl::ReaderMutexLock lock(&mu_);
+  const DeviceCalibration* calibration = Find(device_info);
+  if (calibration == nullptr) return std::nullopt;
+  auto it = calibration->op_profile.find(std::make_pair(opcode, element_type));
+  if (it == calibration->op_profile.end()) return std::nullopt;
+  return it->second;
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,80 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_MODEL_GPU_PERFORMANCE_CALIBRATION_H_
+#define XLA_SERVICE_GPU_MODEL_GPU_PERFORMANCE_CALIBRATION_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/service/gpu/model/hlo_op_profiles.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Hardware parameters measured by hlo_op_profiler_run on the devices we
+// compile for. The GPU performance model and cost analysis prefer calibrated
+// values over the ones derived from se::DeviceDescription and the built-in op
+// profiles. Devices are identified by HloOpProfiles::GetProfileName.
+class GpuPerformanceCalibrations {
+ public:
+  // Returns the process-wide calibrations used by the performance model.
+  // GpuCompiler registers the ones from
+  // --xla_gpu_performance_model_calibration_file.
+  static GpuPerformanceCalibrations& Global();
+
+  // Adds `calibrations`, replacing previously registered calibrations of the
+  // same devices.
+  void Register(const DevicePerformanceCalibrations& calibrations);
+
+  std::optional<int64_t> GetMemoryBandwidth(
+      const se::DeviceDescription& device_info) const;
+  std::optional<absl::Duration> GetKernelLaunchOverhead(
+      const se::DeviceDescription& device_info) const;
+  std::optional<int64_t> GetDramToL2TransactionSizeBytes(
+      const se::DeviceDescription& device_info) const;
+  std::optional<int64_t> GetClockCyclesPerOp(
+      const se::DeviceDescription& device_info, HloOpcode opcode,
+      PrimitiveType element_type) const;
+
+ private:
+  struct DeviceCalibration {
+    std::optional<int64_t> memory_bandwidth;
+    std::optional<absl::Duration> kernel_launch_overhead;
+    std::optional<int64_t> dram_to_l2_transaction_size_bytes;
+    HloOpProfiles::HloOpProfile op_profile;
+  };
+
+  const DeviceCalibration* Find(const se::DeviceDescription& device_info) const
+      ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<std::string, DeviceCalibration> calibrations_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_MODEL_GPU_PERFORMANCE_CALIBRATION_H_
@@ -0,0 +1,90 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/gpu_performance_calibration.h"
+
+#include <optional>
+
+#include <gtest/gtest.h>
+#include "absl/log/check.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/protobuf.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr char kCalibrations[] = R"pb(
+  entries {
+    key: "sm_89"
+    value {
+      memory_bandwidth: 700000000000
+      kernel_launch_overhead_ns: 2500
+      op_profiles {
+        entries {
+          instruction {
+            opcode: "divide"
+            shape { element_type: F32 }
+          }
+          clock_cycles: 40
+        }
+      }
+    }
+  }
+)pb";
+
+DevicePerformanceCalibrations ParseCalibrations() {
+  DevicePerformanceCalibrations calibrations;
+  CHECK(tsl::protobuf::TextFormat::ParseFromString(kCalibrations,
+                                                   &calibrations));
+  return calibrations;
+}
+
+TEST(GpuPerformanceCalibrationsTest, ReturnsCalibratedValues) {
+  GpuPerformanceCalibrations calibrations;
+  calibrations.Register(ParseCalibrations());
+  se::DeviceDescription device_info = TestGpuDeviceInfo::RTXA6000DeviceInfo();
+
+  EXPECT_EQ(calibrations.GetMemoryBandwidth(device_info), 700000000000);
+  EXPECT_EQ(calibrations.GetKernelLaunchOverhead(device_info),
+            absl::Nanoseconds(2500));
+  EXPECT_EQ(calibrations.GetClockCyclesPerOp(device_info, HloOpcode::kDivide,
+                                             F32),
+            40);
+  // Parameters that were not measured are not overridden.
+  EXPECT_EQ(calibrations.GetDramToL2TransactionSizeBytes(device_info),
+            std::nullopt);
+  EXPECT_EQ(calibrations.GetClockCyclesPerOp(device_info,
+                                             HloOpcode::kMultiply, F32),
+            std::nullopt);
+}
+
+TEST(GpuPerformanceCalibrationsTest, IgnoresOtherDevices) {
+  GpuPerformanceCalibrations calibrations;
+  calibrations.Register(ParseCalibrations());
+  se::DeviceDescription device_info = TestGpuDeviceInfo::AMDMI210DeviceInfo();
+
+  EXPECT_EQ(calibrations.GetMemoryBandwidth(device_info), std::nullopt);
+  EXPECT_EQ(calibrations.GetKernelLaunchOverhead(device_info), std::nullopt);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
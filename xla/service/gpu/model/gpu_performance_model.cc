@@ -132,7 +132,7 @@ absl::Duration GpuPerformanceModel::EstimateUnfusedExecTime(
   const se::DeviceDescription* device_info = cost_analysis->device_info_;
 
   absl::Duration time_unfused =
-      kKernelLaunchOverhead * (fused_consumers.size() + 1) +
+      GetKernelLaunchOverhead(*device_info) * (fused_consumers.size() + 1) +
       producer_runtime.exec_time;
 
   for (const HloInstruction* fused_consumer : fused_consumers) {
@@ -287,7 +287,7 @@ absl::Duration GpuPerformanceModel::EstimateFusedExecTime(
   const se::DeviceDescription* device_info = cost_analysis->device_info_;
 
   absl::Duration exec_time_fused =
-      kKernelLaunchOverhead * fused_consumers.size();
+      GetKernelLaunchOverhead(*device_info) * fused_consumers.size();
   for (auto [idx, fused_consumer] : llvm::enumerate(fused_consumers)) {
     VLOG(8) << "Fused consumer: " << fused_consumer->name();
 
@@ -347,11 +347,13 @@ GpuPerformanceModel::EstimateRunTimesForPriorityFusion(
   EstimateRunTimeData producer_runtime =
       EstimateRunTimeForInstructionCached(producer, cost_analysis, config);
 
+  absl::Duration kernel_launch_overhead =
+      GetKernelLaunchOverhead(*cost_analysis->device_info_);
   absl::Duration time_unfused =
-      kKernelLaunchOverhead * (fused_consumers.size() + 1) +
+      kernel_launch_overhead * (fused_consumers.size() + 1) +
       producer_runtime.exec_time;
 
-  absl::Duration time_fused = kKernelLaunchOverhead * fused_consumers.size();
+  absl::Duration time_fused = kernel_launch_overhead * fused_consumers.size();
 
   for (auto fused_consumer : fused_consumers) {
     VLOG(8) << "Fused consumer: " << fused_consumer->name();
@@ -36,6 +36,7 @@ limitations under the License.
 #include "xla/service/gpu/hlo_traversal.h"
 #include "xla/service/gpu/launch_dimensions.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/gpu_performance_calibration.h"
 #include "xla/shape_util.h"
 #include "xla/stream_executor/device_description.h"
 #include "xla/util.h"
@@ -68,8 +69,19 @@ int GetCoalescingWasteFactor(PrimitiveType element_type,
   // Assume we use one element from the cache line and waste the remaining
   // bandwidth. For example, if we're reading f32s, we use 1/16nd of the cache
   // line.
-  return gpu_device_info.dram_to_l2_transaction_size_bytes() /
-         element_size_bytes;
+  int64_t transaction_size_bytes =
+      GpuPerformanceCalibrations::Global()
+          .GetDramToL2TransactionSizeBytes(gpu_device_info)
+          .value_or(gpu_device_info.dram_to_l2_transaction_size_bytes());
+  return std::max<int64_t>(transaction_size_bytes / element_size_bytes, 1);
+}
+
+// Returns the DRAM bandwidth measured on the device if available, and the
+// theoretical one otherwise.
+float GetMemoryBandwidth(const se::DeviceDescription& gpu_device_info) {
+  return GpuPerformanceCalibrations::Global()
+      .GetMemoryBandwidth(gpu_device_info)
+      .value_or(gpu_device_info.memory_bandwidth());
 }
 
 // Limit the bandwidth for low occupancy cases. Each SM can issue at most
@@ -148,6 +160,14 @@ void GpuPerformanceModelCache::Invalidate(const HloInstruction& instruction) {
   }
 }
 
+/*static*/
+absl::Duration GpuPerformanceModelBase::GetKernelLaunchOverhead(
+    const se::DeviceDescription& gpu_device_info) {
+  return GpuPerformanceCalibrations::Global()
+      .GetKernelLaunchOverhead(gpu_device_info)
+      .value_or(kKernelLaunchOverhead);
+}
+
 /*static*/
 LaunchDimensions GpuPerformanceModelBase::EstimateFusionLaunchDimensions(
     const HloFusionAnalysis& fusion_analysis) {
@@ -299,7 +319,7 @@ int64_t GpuPerformanceModelBase::GetSharedOperandBytesAccessed(
 absl::Duration GpuPerformanceModelBase::ReadTime(
     const se::DeviceDescription& gpu_device_info, int64_t num_blocks,
     int64_t n_bytes_net, int64_t n_bytes_total) {
-  float bandwidth = gpu_device_info.memory_bandwidth();
+  float bandwidth = GetMemoryBandwidth(gpu_device_info);
   if (n_bytes_net < gpu_device_info.l2_cache_size()) {
     bandwidth *= kL2CacheSpeedup;
     if (n_bytes_net <
@@ -322,13 +342,13 @@ absl::Duration GpuPerformanceModelBase::ReadTimeWithDRAMHeuristic(
 
   // The first read of the input buffer always happens from DRAM. If reads are
   // no coaleced, bandwidth is reduced by the waste factor.
-  float dram_bandwidth = gpu_device_info.memory_bandwidth() / waste_factor;
+  float dram_bandwidth = GetMemoryBandwidth(gpu_device_info) / waste_factor;
 
   // Two things can happed on re-reading the buffer:
   //   - If the buffer fits into cache, the L1/L2 cache speedup is applied.
   //   - If the buffer doesn't fit, it will be read from DRAM and the same
   //     coalessing waste factor is applied.
-  float rest_bandwidth = gpu_device_info.memory_bandwidth();
+  float rest_bandwidth = GetMemoryBandwidth(gpu_device_info);
   if (n_bytes_net < gpu_device_info.l2_cache_size()) {
     rest_bandwidth *= kL2CacheSpeedup;
     if (n_bytes_net <
@@ -398,7 +418,7 @@ absl::Duration GpuPerformanceModelBase::ReadTimeWithDRAMHeuristic(
 absl::Duration GpuPerformanceModelBase::WriteTime(
     const se::DeviceDescription& gpu_device_info, int64_t bytes_written) {
   return absl::Seconds(1.0f * bytes_written /
-                       gpu_device_info.memory_bandwidth());
+                       GetMemoryBandwidth(gpu_device_info));
 }
 
 /*static*/
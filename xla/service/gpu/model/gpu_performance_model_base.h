@@ -145,6 +145,11 @@ class GpuPerformanceModelBase {
   static constexpr float kL2CacheSpeedup = 2.5;
   static constexpr float kL1CacheSpeedup = 8;
 
+  // Returns the kernel launch overhead measured on the device, or
+  // kKernelLaunchOverhead if the device has not been calibrated.
+  static absl::Duration GetKernelLaunchOverhead(
+      const se::DeviceDescription& gpu_device_info);
+
   // Uses HloFusionAnalysis for computing the actual number of threads and
   // blocks that the IR emitter will use.
   static LaunchDimensions EstimateFusionLaunchDimensions(
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "xla/service/gpu/model/hlo_op_profiler.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <random>
@@ -25,8 +27,12 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xla/debug_options_flags.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
@@ -35,6 +41,7 @@ limitations under the License.
 #include "xla/service/executable.h"
 #include "xla/service/gpu/model/hlo_op_profile.pb.h"
 #include "xla/service/hlo_module_config.h"
+#include "xla/service/hlo_parser.h"
 #include "xla/service/hlo_runner.h"
 #include "xla/shape.h"
 #include "xla/shape_util.h"
@@ -74,21 +81,42 @@ class CuptiKernelTracer : public profiler::CuptiTraceCollector {
       LOG(ERROR) << "No kernel events";
       return 0;
     }
-    std::sort(kernel_times_ns_.begin(), kernel_times_ns_.end());
-    size_t i = kernel_times_ns_.size() / 2;
+    return Median(kernel_times_ns_);
+  }
+
+  // Returns the median time between the starts of consecutive kernels.
+  uint64_t getMedianKernelIntervalNs() && {
+    cupti_tracer_->Disable();  // Also flushes buffer.
+    if (kernel_start_times_ns_.size() < 2) {
+      LOG(ERROR) << "Not enough kernel events";
+      return 0;
+    }
+    std::sort(kernel_start_times_ns_.begin(), kernel_start_times_ns_.end());
+    std::vector<uint64_t> intervals_ns;
+    for (size_t i = 1; i < kernel_start_times_ns_.size(); ++i) {
+      intervals_ns.push_back(kernel_start_times_ns_[i] -
+                             kernel_start_times_ns_[i - 1]);
+    }
+    return Median(intervals_ns);
+  }
+
+ private:
+  static uint64_t Median(std::vector<uint64_t>& values) {
+    std::sort(values.begin(), values.end());
+    size_t i = values.size() / 2;
     // Return median value if number of values is odd.
-    if (kernel_times_ns_.size() % 2 != 0) {
-      return kernel_times_ns_[i];
+    if (values.size() % 2 != 0) {
+      return values[i];
     }
     // Return average of the two middle values if the number of values is even.
-    return (kernel_times_ns_[i - 1] + kernel_times_ns_[i] + 1) / 2;
+    return (values[i - 1] + values[i] + 1) / 2;
   }
 
- private:
   // CuptiTraceCollector
   void AddEvent(profiler::CuptiTracerEvent&& event) override {
     if (event.type == profiler::CuptiTracerEventType::Kernel) {
       kernel_times_ns_.push_back(event.end_time_ns - event.start_time_ns);
+      kernel_start_times_ns_.push_back(event.start_time_ns);
     }
     VLOG(5) << "CuptiTracerEvent: " << event.name << ", "
             << event.end_time_ns - event.start_time_ns << "ns";
@@ -101,6 +129,7 @@ class CuptiKernelTracer : public profiler::CuptiTraceCollector {
 
   profiler::CuptiTracer* cupti_tracer_;
   std::vector<uint64_t> kernel_times_ns_;
+  std::vector<uint64_t> kernel_start_times_ns_;
 };
 #else
 class CuptiKernelTracer {
@@ -108,6 +137,9 @@ class CuptiKernelTracer {
   uint64_t getMedianKernelTimeNs() && {
     LOG(FATAL) << "Not built with --config=cuda";
   }
+  uint64_t getMedianKernelIntervalNs() && {
+    LOG(FATAL) << "Not built with --config=cuda";
+  }
 };
 #endif
 
@@ -191,6 +223,34 @@ absl::StatusOr<absl::Duration> HloOpProfiler::MeasureOpChainDuration(
   return absl::Nanoseconds(std::move(cupti_tracer).getMedianKernelTimeNs());
 }
 
+absl::StatusOr<std::unique_ptr<CuptiKernelTracer>>
+HloOpProfiler::TraceModuleExecution(absl::string_view hlo_text) {
+#ifndef GOOGLE_CUDA
+  return FailedPrecondition("Not built with --config=cuda");
+#endif
+
+  HloModuleConfig config;
+  config.set_debug_options(GetDebugOptionsFromFlags());
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                      ParseAndReturnUnverifiedModule(hlo_text, config));
+
+  std::minstd_rand0 engine;
+  TF_ASSIGN_OR_RETURN(std::vector<Literal> args,
+                      MakeFakeArguments(module.get(), &engine));
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<Executable> ex,
+                      runner_.CreateExecutable(std::move(module),
+                                               /*run_hlo_passes=*/false));
+
+  // Warmup.
+  TF_RETURN_IF_ERROR(runner_.ExecuteWithExecutable(ex.get(), args).status());
+
+  auto cupti_tracer = std::make_unique<CuptiKernelTracer>();
+  for (int i = 0; i < 10; ++i) {  // Run a few times to reduce noise.
+    TF_RETURN_IF_ERROR(runner_.ExecuteWithExecutable(ex.get(), args).status());
+  }
+  return cupti_tracer;
+}
+
 HloOpProfiler::HloOpProfiler(HloRunner& runner)
     : runner_(runner),
       dev_info_(runner.backend().stream_executors()[0]->GetDeviceDescription()),
@@ -246,5 +306,137 @@ absl::StatusOr<HloInstructionProfile> HloOpProfiler::MeasureClockCyclesPerOp(
   return profile;
 }
 
+absl::StatusOr<int64_t> HloOpProfiler::MeasureMemoryBandwidth() {
+  // 256MiB, well above the size of L2 caches.
+  constexpr int64_t kNumElements = int64_t{1} << 26;
+  std::string hlo_text = absl::StrReplaceAll(
+      R"(
+    HloModule memory_bandwidth
+
+    fused_negate {
+      p = f32[$n] parameter(0)
+      ROOT n = f32[$n] negate(p)
+    }
+
+    ENTRY e {
+      p0 = f32[$n] parameter(0)
+      ROOT f = f32[$n] fusion(p0), kind=kLoop, calls=fused_negate
+    })",
+      {{"$n", absl::StrCat(kNumElements)}});
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<CuptiKernelTracer> tracer,
+                      TraceModuleExecution(hlo_text));
+  absl::Duration duration =
+      absl::Nanoseconds(std::move(*tracer).getMedianKernelTimeNs());
+  if (duration <= absl::ZeroDuration()) {
+    return Internal("Failed to measure memory bandwidth");
+  }
+
+  const int64_t bytes_accessed = 2 * kNumElements * sizeof(float);
+  const int64_t bandwidth = bytes_accessed / absl::ToDoubleSeconds(duration);
+  VLOG(2) << "Memory bandwidth: " << bandwidth << " B/s";
+  return bandwidth;
+}
+
+absl::StatusOr<absl::Duration> HloOpProfiler::MeasureKernelLaunchOverhead() {
+  // Kernels depend on each other, so they are launched back-to-back to the
+  // same stream. The gaps between executions are ignored by the median.
+  constexpr int kNumKernels = 64;
+  std::string hlo_text = R"(
+    HloModule kernel_launch_overhead
+
+    fused_negate {
+      p = f32[1] parameter(0)
+      ROOT n = f32[1] negate(p)
+    }
+
+    ENTRY e {
+      f0 = f32[1] parameter(0))";
+  for (int i = 1; i <= kNumKernels; ++i) {
+    absl::StrAppend(&hlo_text, "\n      ", i == kNumKernels ? "ROOT " : "",
+                    "f", i, " = f32[1] fusion(f", i - 1,
+                    "), kind=kLoop, calls=fused_negate");
+  }
+  absl::StrAppend(&hlo_text, "\n    }");
+
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<CuptiKernelTracer> tracer,
+                      TraceModuleExecution(hlo_text));
+  absl::Duration overhead =
+      absl::Nanoseconds(std::move(*tracer).getMedianKernelIntervalNs());
+  VLOG(2) << "Kernel launch overhead: " << overhead;
+  if (overhead <= absl::ZeroDuration()) {
+    return Internal("Failed to measure kernel launch overhead");
+  }
+  return overhead;
+}
+
+absl::StatusOr<int64_t> HloOpProfiler::MeasureDramToL2TransactionSizeBytes(
+    int64_t memory_bandwidth) {
+  // Every element read by the kernel is in its own 128-byte cache line.
+  constexpr int64_t kStride = 128 / sizeof(float);
+  constexpr int64_t kNumElements = int64_t{1} << 21;
+  std::string hlo_text = absl::StrReplaceAll(
+      R"(
+    HloModule strided_read
+
+    fused_slice {
+      p = f32[$m] parameter(0)
+      ROOT s = f32[$n] slice(p), slice={[0:$m:$stride]}
+    }
+
+    ENTRY e {
+      p0 = f32[$m] parameter(0)
+      ROOT f = f32[$n] fusion(p0), kind=kLoop, calls=fused_slice
+    })",
+      {{"$m", absl::StrCat(kNumElements * kStride)},
+       {"$n", absl::StrCat(kNumElements)},
+       {"$stride", absl::StrCat(kStride)}});
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<CuptiKernelTracer> tracer,
+                      TraceModuleExecution(hlo_text));
+  absl::Duration duration =
+      absl::Nanoseconds(std::move(*tracer).getMedianKernelTimeNs());
+  if (duration <= absl::ZeroDuration()) {
+    return Internal("Failed to measure strided read time");
+  }
+
+  // Bytes that could have been transferred at full bandwidth in the measured
+  // time, minus the coalesced writes of the output.
+  const double bytes_transferred =
+      absl::ToDoubleSeconds(duration) * memory_bandwidth;
+  const double bytes_read = bytes_transferred - kNumElements * sizeof(float);
+  const int64_t transaction_size_bytes =
+      std::max<int64_t>(bytes_read / kNumElements, sizeof(float));
+  VLOG(2) << "DRAM to L2 transaction size: " << transaction_size_bytes << " B";
+  return transaction_size_bytes;
+}
+
+absl::StatusOr<DevicePerformanceCalibration>
+HloOpProfiler::MeasureCalibration(absl::Span<const HloOpcode> ops,
+                                  absl::Span<const PrimitiveType> data_types) {
+  DevicePerformanceCalibration calibration;
+  TF_ASSIGN_OR_RETURN(int64_t memory_bandwidth, MeasureMemoryBandwidth());
+  calibration.set_memory_bandwidth(memory_bandwidth);
+
+  TF_ASSIGN_OR_RETURN(absl::Duration kernel_launch_overhead,
+                      MeasureKernelLaunchOverhead());
+  calibration.set_kernel_launch_overhead_ns(
+      absl::ToInt64Nanoseconds(kernel_launch_overhead));
+
+  TF_ASSIGN_OR_RETURN(int64_t transaction_size_bytes,
+                      MeasureDramToL2TransactionSizeBytes(memory_bandwidth));
+  calibration.set_dram_to_l2_transaction_size_bytes(transaction_size_bytes);
+
+  for (const PrimitiveType data_type : data_types) {
+    for (const HloOpcode op : ops) {
+      auto result = MeasureClockCyclesPerOp(op, data_type);
+      if (result.ok()) {
+        calibration.mutable_op_profiles()->add_entries()->Swap(&*result);
+      } else {
+        LOG(ERROR) << result.status();
+      }
+    }
+  }
+  return calibration;
+}
+
 }  // namespace gpu
 }  // namespace xla
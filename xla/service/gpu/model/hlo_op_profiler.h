@@ -16,10 +16,13 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_MODEL_HLO_OP_PROFILER_H_
 #define XLA_SERVICE_GPU_MODEL_HLO_OP_PROFILER_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/gpu/model/hlo_op_profile.pb.h"
@@ -30,6 +33,8 @@ limitations under the License.
 namespace xla {
 namespace gpu {
 
+class CuptiKernelTracer;
+
 class HloOpProfiler {
   static std::unique_ptr<HloModule> MakeModuleForMeasurements(
       HloOpcode op, PrimitiveType data_type, int chain_length);
@@ -38,11 +43,37 @@ class HloOpProfiler {
                                                         PrimitiveType data_type,
                                                         int chain_length);
 
+  // Compiles the module without HLO passes, runs it once to warm up and then
+  // a few more times while tracing the launched kernels.
+  absl::StatusOr<std::unique_ptr<CuptiKernelTracer>> TraceModuleExecution(
+      absl::string_view hlo_text);
+
  public:
   explicit HloOpProfiler(HloRunner& runner);
+
   absl::StatusOr<HloInstructionProfile> MeasureClockCyclesPerOp(
       HloOpcode op, PrimitiveType data_type);
 
+  // Measures the achievable DRAM bandwidth in bytes per second with an
+  // elementwise kernel that reads and writes a buffer much larger than L2.
+  absl::StatusOr<int64_t> MeasureMemoryBandwidth();
+
+  // Measures the time between the starts of back-to-back launches of kernels
+  // that do almost no work.
+  absl::StatusOr<absl::Duration> MeasureKernelLaunchOverhead();
+
+  // Measures how many bytes are transferred from DRAM per element of a read
+  // that touches a single f32 per 128-byte cache line, given the bandwidth of
+  // coalesced accesses.
+  absl::StatusOr<int64_t> MeasureDramToL2TransactionSizeBytes(
+      int64_t memory_bandwidth);
+
+  // Runs all micro-benchmarks above together with MeasureClockCyclesPerOp for
+  // `ops` x `data_types`. Failing op measurements are logged and skipped.
+  absl::StatusOr<DevicePerformanceCalibration> MeasureCalibration(
+      absl::Span<const HloOpcode> ops,
+      absl::Span<const PrimitiveType> data_types);
+
  private:
   HloRunner& runner_;
   const se::DeviceDescription& dev_info_;
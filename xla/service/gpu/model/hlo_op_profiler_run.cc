@@ -17,6 +17,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/log/log.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
@@ -42,6 +43,11 @@ namespace {
 
 constexpr absl::string_view kUsage = R"(
 This tool measures clock cycles per operation on GPU.
+
+With --calibration_output_file it additionally measures memory bandwidth,
+kernel launch overhead and the cost of uncoalesced reads, and writes a
+DevicePerformanceCalibrations text proto that can be passed to the compiler
+with --xla_gpu_performance_model_calibration_file.
 )";
 
 void WriteOutput(const DeviceHloInstructionProfiles& literal,
@@ -65,9 +71,13 @@ void WriteOutput(const DeviceHloInstructionProfiles& literal,
 
 int RunProfiler(int argc, char** argv) {
   std::string output_file;
+  std::string calibration_output_file;
   std::vector<tsl::Flag> flag_list = {
       tsl::Flag("output_file", &output_file,
                 "Output measurements protobuf to the destination file."),
+      tsl::Flag("calibration_output_file", &calibration_output_file,
+                "Measure performance model calibration and write it as a "
+                "DevicePerformanceCalibrations text proto to the given path."),
   };
   // Allow setting flags as command line argument (in addition to XLA_FLAGS
   // environment variable).
@@ -110,22 +120,38 @@ int RunProfiler(int argc, char** argv) {
       HloOpcode::kSubtract,
   };
 
+  auto profile_name = HloOpProfiles::GetProfileName(&dev_info);
   HloInstructionProfileList instr_profiles;
 
-  for (const PrimitiveType data_type : dtypes) {
-    for (const HloOpcode op : ops) {
-      auto result = profiler.MeasureClockCyclesPerOp(op, data_type);
-      if (result.ok()) {
-        instr_profiles.add_entries()->Swap(&*result);
-      } else {
-        LOG(ERROR) << result.status();
+  if (!calibration_output_file.empty()) {
+    absl::StatusOr<DevicePerformanceCalibration> calibration =
+        profiler.MeasureCalibration(ops, dtypes);
+    if (!calibration.ok()) {
+      LOG(QFATAL) << calibration.status();
+    }
+    instr_profiles = calibration->op_profiles();
+
+    DevicePerformanceCalibrations calibrations;
+    calibrations.mutable_entries()->insert({profile_name, *calibration});
+    VLOG(0) << "Writing calibration to " << calibration_output_file;
+    TF_CHECK_OK(tsl::WriteStringToFile(
+        tsl::Env::Default(), calibration_output_file,
+        tsl::LegacyUnredactedDebugString(calibrations)));
+  } else {
+    for (const PrimitiveType data_type : dtypes) {
+      for (const HloOpcode op : ops) {
+        auto result = profiler.MeasureClockCyclesPerOp(op, data_type);
+        if (result.ok()) {
+          instr_profiles.add_entries()->Swap(&*result);
+        } else {
+          LOG(ERROR) << result.status();
+        }
       }
     }
   }
 
   VLOG(1) << "\n" << instr_profiles;
 
-  auto profile_name = HloOpProfiles::GetProfileName(&dev_info);
   DeviceHloInstructionProfiles device_profiles;
   device_profiles.mutable_entries()->insert({profile_name, instr_profiles});
   if (!output_file.empty()) {
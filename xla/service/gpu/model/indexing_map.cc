@@ -30,6 +30,9 @@ limitations under the License.
 #include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
@@ -39,8 +42,10 @@ limitations under the License.
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/AffineExpr.h"  // from @llvm-project
 #include "mlir/IR/AffineMap.h"  // from @llvm-project
+#include "mlir/IR/Dialect.h"  // from @llvm-project
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "mlir/Support/LLVM.h"  // from @llvm-project
+#include "mlir/Support/TypeID.h"  // from @llvm-project
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_instructions.h"
@@ -1271,9 +1276,75 @@ IndexingMap operator*(const IndexingMap& lhs, const IndexingMap& rhs) {
 // RangeEvaluator for every constraint. Note that we start with "expr"
 // simplification, because the ranges of constraints were already optimized once
 // when IndexingMap was constructed.
+// Memoized results of `IndexingMap::Simplify`. The cache is attached to an MLIR
+// context as a dialect, so that cached indexing maps are destroyed together
+// with the affine expressions they reference.
+class IndexingMapSimplificationCache : public mlir::Dialect {
+ public:
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(IndexingMapSimplificationCache)
+
+  explicit IndexingMapSimplificationCache(MLIRContext* mlir_context)
+      : mlir::Dialect(getDialectNamespace(), mlir_context,
+                      mlir::TypeID::get<IndexingMapSimplificationCache>()) {}
+
+  static llvm::StringRef getDialectNamespace() {
+    return "xla_gpu_indexing_map_cache";
+  }
+
+  struct Entry {
+    IndexingMap simplified;
+    bool changed;
+  };
+
+  std::optional<Entry> Find(const IndexingMap& indexing_map) {
+    absl::MutexLock lock(&mu_);
+    auto it = entries_.find(indexing_map);
+    if (it == entries_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  void Insert(const IndexingMap& indexing_map, const IndexingMap& simplified,
+              bool changed) {
+    absl::MutexLock lock(&mu_);
+    // Bound memory usage for long-lived contexts.
+    if (entries_.size() >= kMaxEntries) entries_.clear();
+    entries_.try_emplace(indexing_map, Entry{simplified, changed});
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<IndexingMap, Entry> entries_ ABSL_GUARDED_BY(mu_);
+};
+
+void EnableIndexingMapSimplificationCache(MLIRContext* mlir_context) {
+  mlir_context->getOrLoadDialect<IndexingMapSimplificationCache>();
+}
+
 bool IndexingMap::Simplify() {
   if (IsUndefined() || IsKnownEmpty()) return false;
 
+  // Runtime variables depend on HLO instructions that can be modified or
+  // destroyed during the lifetime of the cache.
+  auto* cache = GetRTVarsCount() == 0
+                    ? GetMLIRContext()
+                          ->getLoadedDialect<IndexingMapSimplificationCache>()
+                    : nullptr;
+  if (cache == nullptr) return SimplifyUncached();
+
+  if (auto entry = cache->Find(*this)) {
+    *this = std::move(entry->simplified);
+    return entry->changed;
+  }
+
+  IndexingMap original = *this;
+  bool changed = SimplifyUncached();
+  cache->Insert(original, *this, changed);
+  return changed;
+}
+
+bool IndexingMap::SimplifyUncached() {
   bool rtvars_were_eliminated = ReplaceConstantRTVars();
 
   // Simplify constraints to shrink the lower/upper bounds of dims and symbols.
@@ -281,7 +281,9 @@ class IndexingMap {
 
   void Print(std::ostream& out, const AffineMapPrinter& printer) const;
 
-  // Returns true if the map was simplified.
+  // Returns true if the map was simplified. Results are memoized if the
+  // simplification cache is enabled for the MLIR context of the map (see
+  // `EnableIndexingMapSimplificationCache`).
   bool Simplify();
 
   // Return MLIRContext.
@@ -385,6 +387,9 @@ class IndexingMap {
  private:
   IndexingMap() = default;
 
+  // Simplifies the map without looking it up in the simplification cache.
+  bool SimplifyUncached();
+
   // Performs AffineExpr simplification for all constraints.
   // Returns true if simplification was performed.
   bool SimplifyConstraintExprs();
@@ -436,6 +441,13 @@ inline bool operator!=(const IndexingMap& lhs, const IndexingMap& rhs) {
 }
 IndexingMap operator*(const IndexingMap& lhs, const IndexingMap& rhs);
 
+// Enables memoization of `IndexingMap::Simplify` for indexing maps created in
+// `mlir_context`: structurally identical maps (affine map, variable ranges and
+// constraints) are simplified once, and later calls reuse the cached result
+// for the lifetime of the context. Must be called before the context is used
+// from multiple threads.
+void EnableIndexingMapSimplificationCache(mlir::MLIRContext* mlir_context);
+
 // Composes affine maps, i.e. second ∘ first.
 IndexingMap ComposeIndexingMaps(const IndexingMap& first,
                                 const IndexingMap& second);
@@ -550,6 +550,32 @@ TEST_F(IndexingMapTest, ConstraintMerge_Mod) {
                         )"));
 }
 
+TEST_F(IndexingMapTest, SimplificationCache) {
+  EnableIndexingMapSimplificationCache(&mlir_context_);
+
+  auto make_indexing_map = [&] {
+    return IndexingMap::FromTensorSizes(
+        ParseAffineMap("(d0, d1) -> ((d0 * 4 + d1) floordiv 4, d1 mod 4)",
+                       &mlir_context_),
+        {8, 4}, {});
+  };
+
+  IndexingMap first = make_indexing_map();
+  EXPECT_TRUE(first.Simplify());
+  EXPECT_FALSE(first.Simplify());
+
+  // Structurally identical maps reuse the cached simplified form.
+  IndexingMap second = make_indexing_map();
+  EXPECT_TRUE(second.Simplify());
+  EXPECT_EQ(first, second);
+  EXPECT_THAT(second.ToString(printer_), MatchIndexingString(R"(
+                                                  (d0, d1) -> (d0, d1)
+                                                  domain:
+                                                  d0 in [0, 7]
+                                                  d1 in [0, 3]
+                                                )"));
+}
+
 TEST_F(IndexingMapTest, AffineMapSimplification_ConstantDims) {
   IndexingMap indexing_map =
       IndexingMap(ParseAffineMap("(d0) -> (d0)", &mlir_context_),
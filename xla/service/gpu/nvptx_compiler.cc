@@ -365,7 +365,7 @@ absl::Status NVPTXCompiler::AddConvAndGemmAutotuningPasses(
     HloPassPipeline* pipeline, HloModule* hlo_module,
     AutotuneConfig& autotune_config, tsl::thread::ThreadPool* thread_pool) {
   if (GpuConvAlgorithmPicker::IsEnabled(hlo_module)) {
-    pipeline->AddPass<GpuConvAlgorithmPicker>(autotune_config);
+    pipeline->AddPass<GpuConvAlgorithmPicker>(autotune_config, thread_pool);
   }
   pipeline->AddPass<GemmAlgorithmPicker>(autotune_config);
   return absl::OkStatus();
@@ -67,7 +67,8 @@ HloPassPipeline PrepareHloModuleForIrEmittingPipeline(
   if (hlo_module.config().alias_passthrough_params()) {
     pipeline.AddPass<AliasPassthroughParams>();
   }
-  pipeline.AddPass<LoopScheduleLinearizer>(can_share_buffer);
+  pipeline.AddPass<LoopScheduleLinearizer>(
+      can_share_buffer, debug_options.xla_gpu_loop_linearization_min_bytes());
 
   if (debug_options.xla_gpu_copy_insertion_use_region_analysis()) {
     constexpr int64_t kNoRegionBasedLiveRangeAnalysisLimit = -1;
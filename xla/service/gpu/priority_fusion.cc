@@ -49,6 +49,7 @@ limitations under the License.
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/hlo_fusion_analysis.h"
 #include "xla/service/gpu/hlo_traversal.h"
+#include "xla/service/gpu/metrics.h"
 #include "xla/service/gpu/model/fusion_analysis_cache.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/model/gpu_performance_model.h"
@@ -207,6 +208,7 @@ class GpuPriorityFusionQueue {
     };
     tsl::BlockingCounter counter(instructions.size());
     std::vector<Priority> priorities(instructions.size());
+    num_priorities_computed_ += instructions.size();
 
     for (size_t i = 0; i < instructions.size(); ++i) {
       schedule_or_run([&, i] {
@@ -248,15 +250,16 @@ class GpuPriorityFusionQueue {
 
   // Update priorities of all affected ops.
   void UpdatePriorities() {
-    // Revisit costs of all updated ops. It's important to update cost analysis
+    // Revisit costs of all modified ops. It's important to update cost analysis
     // before recalculating priorities.
-    for (auto instruction : to_update_priority_) {
+    for (auto instruction : to_revisit_cost_) {
       TF_CHECK_OK(cost_analysis_.RevisitInstruction(instruction));
     }
 
     ComputeAndSetPriorities(std::vector<HloInstruction*>{
         to_update_priority_.begin(), to_update_priority_.end()});
 
+    to_revisit_cost_.clear();
     to_update_priority_.clear();
   }
 
@@ -271,13 +274,23 @@ class GpuPriorityFusionQueue {
           *consumer, producer);
     }
 
-    InvalidateCaches(producer);
+    // The producer is cloned into the consumer, but not modified itself, so
+    // its cost, fusion analysis and run time stay valid for as long as it is
+    // alive. The analyses of the (producer, consumer) pair are invalidated
+    // along with the consumer.
+    InvalidateCanFuseCache(producer);
     InvalidateCaches(consumer);
   }
 
   // Invalidates all cached value related to this instruction. Called before the
-  // instruction is fused. The instruction can be either producer or consumer.
+  // instruction is modified or removed.
   void InvalidateCaches(HloInstruction* instruction) {
+    InvalidateCanFuseCache(instruction);
+    gpu_performance_model_cache_.Invalidate(*instruction);
+    fusion_analysis_cache_.Invalidate(*instruction);
+  }
+
+  void InvalidateCanFuseCache(HloInstruction* instruction) {
     can_fuse_cache_.erase(instruction);
     for (const HloInstruction* operand : instruction->operands()) {
       auto it = can_fuse_cache_.find(operand);
@@ -285,9 +298,6 @@ class GpuPriorityFusionQueue {
         it->second.erase(instruction);
       }
     }
-
-    gpu_performance_model_cache_.Invalidate(*instruction);
-    fusion_analysis_cache_.Invalidate(*instruction);
   }
 
   // Updates data for the new fusion instruction and its users and operands.
@@ -323,12 +333,16 @@ class GpuPriorityFusionQueue {
     // Detach 'original_producer' from its operands if it has no users.
     // This avoids having it appear as a "phantom" user in subsequent priority
     // calculations on 'fusion.operands' below, before it is finally removed
-    // in 'RemoveInstruction'.
+    // in 'RemoveInstruction'. Its caches are keyed by pointer, and must be
+    // invalidated while it still knows its operands.
     if (original_producer->user_count() == 0) {
+      InvalidateCaches(original_producer);
       original_producer->DetachFromOperandsAndUsers();
     }
 
-    // Collect the instructions whose priorities need to be updated.
+    // Collect the instructions whose priorities need to be updated. Only the
+    // fusion itself changed, the operands merely got a different user, so
+    // their costs don't need to be revisited.
     for (HloInstruction* operand : fusion->operands()) {
       if (operand == original_producer ||
           operand->opcode() == HloOpcode::kConstant ||
@@ -344,11 +358,13 @@ class GpuPriorityFusionQueue {
       to_update_priority_.insert(operand);
     }
     to_update_priority_.insert(fusion);
+    to_revisit_cost_.insert(fusion);
   }
 
   // Removes data for the instruction.
   void RemoveInstruction(HloInstruction* instruction) {
     to_update_priority_.erase(instruction);
+    to_revisit_cost_.erase(instruction);
     fusion_analysis_cache_.Invalidate(*instruction);
 
     auto reverse_it = reverse_map_.find(instruction);
@@ -365,6 +381,9 @@ class GpuPriorityFusionQueue {
     return current_consumers_;
   }
 
+  // Returns the number of producer priorities computed so far.
+  int64_t num_priorities_computed() const { return num_priorities_computed_; }
+
  private:
   // Returns the priority of the producer based on its current operands and
   // users.
@@ -616,6 +635,12 @@ class GpuPriorityFusionQueue {
   // producer.
   absl::flat_hash_set<HloInstruction*> to_update_priority_;
 
+  // The subset of `to_update_priority_` which has been modified, and whose
+  // cost analysis therefore needs to be revisited.
+  absl::flat_hash_set<HloInstruction*> to_revisit_cost_;
+
+  int64_t num_priorities_computed_ = 0;
+
   // Proto with structured logs of fusion decisions. Used only for debugging. If
   // null, logging is disabled.
   FusionProcessDumpProto* fusion_process_dump_;
@@ -728,10 +753,13 @@ absl::StatusOr<bool> GpuPriorityFusion::Run(
           .debug_options()
           .xla_gpu_enable_triton_softmax_priority_fusion();
 
+  const absl::Time start_time = absl::Now();
   int changed = false;
   for (auto* computation : fusible_computations) {
     CHECK(!computation->IsFusionComputation());
 
+    const absl::Time computation_start_time = absl::Now();
+    int64_t num_fusions = 0;
     auto fusion_queue = std::make_unique<GpuPriorityFusionQueue>(
         computation, cost_analysis_options_, &device_info_,
         fusion_process_dump_.get(), thread_pool_, &mlir_context_,
@@ -757,6 +785,7 @@ absl::StatusOr<bool> GpuPriorityFusion::Run(
                                           consumer);
 
         changed = true;
+        ++num_fusions;
       }
 
       if (producer->user_count() == 0) {
@@ -791,7 +820,14 @@ absl::StatusOr<bool> GpuPriorityFusion::Run(
         }
       }
     }
+
+    VLOG(1) << "Priority fusion of " << computation->name() << " made "
+            << num_fusions << " fusions and computed "
+            << fusion_queue->num_priorities_computed() << " priorities in "
+            << absl::Now() - computation_start_time;
   }
+  RecordPriorityFusionDuration(
+      absl::ToInt64Microseconds(absl::Now() - start_time));
 
   // FusionAnalysis cache uses unique_id as key. IDs are only unique inside one
   // module. It's important to fully clear the cache if the same instance of the
@@ -32,6 +32,7 @@ limitations under the License.
 #include "xla/service/gpu/fusion_process_dump.pb.h"
 #include "xla/service/gpu/model/fusion_analysis_cache.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/indexing_map.h"
 #include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/service/instruction_fusion.h"
@@ -50,7 +51,11 @@ class GpuPriorityFusion : public InstructionFusion {
         thread_pool_(thread_pool),
         device_info_(device),
         cost_analysis_options_(std::move(cost_analysis_options)),
-        fusion_analysis_cache_(device_info_) {}
+        fusion_analysis_cache_(device_info_) {
+    // Priority fusion recomputes indexing maps of the same fusions many times
+    // while updating priorities.
+    EnableIndexingMapSimplificationCache(&mlir_context_);
+  }
 
   absl::string_view name() const override { return "priority-fusion"; }
 
@@ -52,10 +52,13 @@ limitations under the License.
 #include "xla/service/gpu/runtime/annotation.h"
 #include "xla/service/gpu/runtime/nccl_all_gather_thunk.h"
 #include "xla/service/gpu/runtime/nccl_all_reduce_thunk.h"
+#include "xla/service/gpu/runtime/nccl_all_to_all_thunk.h"
 #include "xla/service/gpu/runtime/nccl_api.h"
 #include "xla/service/gpu/runtime/nccl_clique_key.h"
 #include "xla/service/gpu/runtime/nccl_collective_broadcast_thunk.h"
+#include "xla/service/gpu/runtime/nccl_collective_permute_thunk.h"
 #include "xla/service/gpu/runtime/nccl_collective_thunk.h"
+#include "xla/service/gpu/runtime/nccl_p2p_thunk_common.h"
 #include "xla/service/gpu/runtime/thunk.h"
 #include "xla/service/gpu/stream_executor_util.h"
 #include "xla/service/service_executable_run_options.h"
@@ -143,20 +146,21 @@ static se::CommandBuffer::ExecutionScopeBuilder CreateExecutionScopeBuilder(
 //===----------------------------------------------------------------------===//
 
 CommandBufferCmd::State* CommandBufferCmd::StateManager::GetOrNull(
-    const CommandBufferCmd* cmd) {
-  if (auto it = state_.find(cmd); it != state_.end()) {
+    const CommandBufferCmd* cmd, const void* type_tag) {
+  if (auto it = state_.find(Key(cmd, type_tag)); it != state_.end()) {
     return it->second.get();
   }
   return nullptr;
 }
 
 CommandBufferCmd::State* CommandBufferCmd::StateManager::GetOrCreate(
-    const CommandBufferCmd* cmd,
+    const CommandBufferCmd* cmd, const void* type_tag,
     absl::FunctionRef<std::unique_ptr<State>()> create) {
-  if (auto it = state_.find(cmd); it != state_.end()) {
+  Key key(cmd, type_tag);
+  if (auto it = state_.find(key); it != state_.end()) {
     return it->second.get();
   }
-  return state_.try_emplace(cmd, create()).first->second.get();
+  return state_.try_emplace(key, create()).first->second.get();
 }
 
 se::CommandBuffer::ExecutionScopeId CommandBufferCmd::GetExecutionScope(
@@ -186,6 +190,11 @@ void CommandBufferCmdSequence::Append(std::unique_ptr<CommandBufferCmd> cmd) {
     allocs_indices_.insert(buffer.slice.index());
   }
 
+  if (synchronization_mode_ == SynchronizationMode::kConcurrent) {
+    AppendConcurrent(std::move(cmd));
+    return;
+  }
+
   ExecutionStreamId execution_stream_id = cmd->execution_stream_id();
   CommandBufferCmd::BufferUsageVector buffers = cmd->buffers();
   bool requires_barrier = HasConflicts(execution_stream_id, buffers);
@@ -209,6 +218,70 @@ void CommandBufferCmdSequence::Append(std::unique_ptr<CommandBufferCmd> cmd) {
   TrackBuffers(execution_stream_id, buffers);
 }
 
+void CommandBufferCmdSequence::AppendConcurrent(
+    std::unique_ptr<CommandBufferCmd> cmd) {
+  ExecutionStreamId execution_stream_id = cmd->execution_stream_id();
+  CommandBufferCmd::BufferUsageVector buffers = cmd->buffers();
+
+  // Returns true if buffer usages have a read-write or write-write conflict.
+  auto conflicts = [](const CommandBufferCmd::BufferUsage& a,
+                      const CommandBufferCmd::BufferUsage& b) {
+    if (a.access == MemoryAccess::kRead && b.access == MemoryAccess::kRead) {
+      return false;
+    }
+    return a.slice == b.slice || a.slice.OverlapsWith(b.slice);
+  };
+
+  // Synchronization commands start a new level after all existing commands,
+  // and all other commands are placed at the level following the last
+  // command they have conflicts with.
+  int64_t level = min_level_;
+  if (cmd->IsSynchronizationCmd()) {
+    level = num_levels_;
+    min_level_ = level + 1;
+  } else {
+    for (const LeveledBufferUsage& used :
+         leveled_buffers_[execution_stream_id]) {
+      if (used.level < level) continue;
+      if (absl::c_any_of(buffers, [&](auto& buffer) {
+            return conflicts(buffer, used.buffer);
+          })) {
+        level = used.level + 1;
+      }
+    }
+  }
+  num_levels_ = std::max(num_levels_, level + 1);
+
+  for (const CommandBufferCmd::BufferUsage& buffer : buffers) {
+    leveled_buffers_[execution_stream_id].push_back({buffer, level});
+  }
+
+  // Keep commands sorted by level, commands at the same level are recorded in
+  // the order they were appended.
+  auto it = absl::c_upper_bound(commands_, level,
+                                [](int64_t value, const CommandInfo& info) {
+                                  return value < info.level;
+                                });
+  commands_.insert(it, {std::move(cmd), false, level});
+
+  // Commands appended to the middle of the sequence change barriers of the
+  // following commands, so we recompute them for the whole sequence. We need
+  // a barrier before the first command of each level in the execution scope.
+  absl::flat_hash_map<ExecutionStreamId, int64_t> last_level;
+  for (CommandInfo& info : commands_) {
+    ExecutionStreamId stream_id = info.cmd->execution_stream_id();
+    auto last = last_level.find(stream_id);
+    info.requires_barrier =
+        last != last_level.end() && last->second != info.level;
+    last_level[stream_id] = info.level;
+  }
+
+  // See the CUDA graph bug workaround for nested command buffers in `Append`.
+  if (commands_.size() > 1 && commands_.front().cmd->IsNestedCommandBuffer()) {
+    commands_[1].requires_barrier = true;
+  }
+}
+
 absl::Status CommandBufferCmdSequence::Prepare(
     const Thunk::PrepareParams& params,
     Thunk::ResourceRequests& resource_requests) {
@@ -270,6 +343,43 @@ void CommandBufferCmdSequence::ClearTrackedBuffers(
   read_write_sets_[execution_stream_id] = ReadWriteSet();
 }
 
+namespace {
+// Device addresses of buffers and the number of commands recorded by an
+// elidable command into the command buffer. Addresses are empty if command was
+// not recorded when the command buffer was created, and we can't skip it.
+struct RecordedCmdState : public CommandBufferCmd::State {
+  std::optional<std::vector<const void*>> addresses;
+  int64_t num_commands = 0;
+};
+
+// Command buffer update statistics attached to the state manager. Statistics
+// are shared by all command sequences recorded into the same command buffer,
+// and we attach them to the null command.
+struct UpdateStatsState : public CommandBufferCmd::State {
+  CommandBufferCmdSequence::UpdateStats stats;
+};
+}  // namespace
+
+// Returns device addresses of all buffers used by the command.
+static std::vector<const void*> GetDeviceAddresses(
+    const Thunk::ExecuteParams& execute_params, CommandBufferCmd* cmd) {
+  std::vector<const void*> addresses;
+  for (const CommandBufferCmd::BufferUsage& buffer : cmd->buffers()) {
+    addresses.push_back(
+        execute_params.buffer_allocations->GetDeviceAddress(buffer.slice)
+            .opaque());
+  }
+  return addresses;
+}
+
+CommandBufferCmdSequence::UpdateStats CommandBufferCmdSequence::GetUpdateStats(
+    CommandBufferCmd::StateManager& state) {
+  if (auto* stats = state.GetOrNull<UpdateStatsState>(nullptr)) {
+    return stats->stats;
+  }
+  return UpdateStats();
+}
+
 static std::string_view RecordModeString(
     CommandBufferCmdSequence::RecordMode mode) {
   switch (mode) {
@@ -297,6 +407,10 @@ absl::Status CommandBufferCmdSequence::Record(
   // Track the number of commands recorded between barriers.
   absl::flat_hash_map<ExecutionScopeId, int64_t> num_recorded_commands;
 
+  bool is_update = command_buffer->state() == se::CommandBuffer::State::kUpdate;
+  UpdateStats& stats =
+      record_params.state.GetOrCreate<UpdateStatsState>(nullptr)->stats;
+
   for (auto& command : commands_) {
     ExecutionScopeId execution_scope_id =
         command.cmd->GetExecutionScope(record_params);
@@ -314,8 +428,39 @@ absl::Status CommandBufferCmdSequence::Record(
     VLOG(5) << " Record command buffer with scope id "
             << execution_scope_id.value();
 
-    TF_RETURN_IF_ERROR(
-        command.cmd->Record(execute_params, record_params, command_buffer));
+    // Elidable commands track device addresses they were recorded with, and
+    // skip command buffer update if addresses did not change.
+    if (command.cmd->IsUpdateElidable() && !command.cmd->force_update()) {
+      auto* recorded = record_params.state.GetOrCreate<RecordedCmdState>(
+          command.cmd.get());
+      std::vector<const void*> addresses =
+          GetDeviceAddresses(execute_params, command.cmd.get());
+
+      if (is_update && recorded->addresses == addresses) {
+        TF_RETURN_IF_ERROR(command_buffer->SkipCommands(
+            execution_scope_id, recorded->num_commands));
+        ++stats.num_skipped_commands;
+        ++num_recorded_commands[execution_scope_id];
+        continue;
+      }
+
+      int64_t num_commands = command_buffer->num_commands(execution_scope_id);
+      TF_RETURN_IF_ERROR(
+          command.cmd->Record(execute_params, record_params, command_buffer));
+      if (!is_update) {
+        recorded->num_commands =
+            command_buffer->num_commands(execution_scope_id) - num_commands;
+      }
+      if (!is_update || recorded->addresses.has_value()) {
+        recorded->addresses = std::move(addresses);
+      }
+
+    } else {
+      TF_RETURN_IF_ERROR(
+          command.cmd->Record(execute_params, record_params, command_buffer));
+    }
+
+    if (is_update) ++stats.num_updated_commands;
     ++num_recorded_commands[execution_scope_id];
   }
 
@@ -326,7 +471,9 @@ absl::Status CommandBufferCmdSequence::Record(
   uint64_t end_micros = tsl::Env::Default()->NowMicros();
   VLOG(3) << "Recorded " << commands_.size()
           << " commands into command buffer in " << (end_micros - start_micros)
-          << " μs; mode=" << RecordModeString(mode);
+          << " μs; mode=" << RecordModeString(mode)
+          << "; num_updated_commands=" << stats.num_updated_commands
+          << "; num_skipped_commands=" << stats.num_skipped_commands;
 
   return absl::OkStatus();
 }
@@ -1872,4 +2019,159 @@ CommandBufferCmd::BufferUsageVector CollectiveBroadcastCmd::buffers() {
   return buffer_usage;
 }
 
+//===----------------------------------------------------------------------===//
+// AllToAllCmd
+//===----------------------------------------------------------------------===//
+
+AllToAllCmd::AllToAllCmd(ExecutionStreamId execution_stream_id,
+                         ExecutionStreamId async_from_stream_id,
+                         NcclApi* nccl_api, NcclCollectiveConfig config,
+                         bool has_split_dimension,
+                         absl::Span<const NcclCollectiveThunk::Buffer> buffers,
+                         AsyncStreamKind stream_kind)
+    : CollectiveCmd(execution_stream_id, async_from_stream_id, nccl_api,
+                    std::move(config)),
+      has_split_dimension_(has_split_dimension),
+      buffers_(buffers.begin(), buffers.end()),
+      stream_kind_(stream_kind) {}
+
+absl::Status AllToAllCmd::Record(const Thunk::ExecuteParams& execute_params,
+                                 const RecordParams& record_params,
+                                 se::CommandBuffer* command_buffer) {
+  TF_RETURN_IF_ERROR(BarrierIfAsync(
+      command_buffer, execute_params.stream->parent(), record_params));
+
+  TF_ASSIGN_OR_RETURN(
+      std::vector<DeviceBufferPair> device_buffers,
+      ConvertToDeviceBuffers(execute_params.buffer_allocations, buffers_,
+                             config().operand_element_type));
+
+  ExecutionScopeId execution_scope_id = GetExecutionScope(record_params);
+  VLOG(5) << "AllToAllCmd, has_split_dimension=" << has_split_dimension_
+          << ", execution_scope_id=" << execution_scope_id.value();
+
+  for (size_t i = 0; i < device_buffers.size(); ++i) {
+    VLOG(5) << "  Src: " << buffers_[i].source_buffer << " ("
+            << device_buffers[i].source_buffer.opaque() << ")";
+    VLOG(5) << "  Dst: " << buffers_[i].destination_buffer << " ("
+            << device_buffers[i].destination_buffer.opaque() << ")";
+  }
+
+  if (!execute_params.collective_params || !execute_params.collective_cliques) {
+    return absl::InvalidArgumentError(
+        "AllToAllCmd requires collective parameters and cliques");
+  }
+
+  TF_ASSIGN_OR_RETURN(
+      NcclCommHandleWrapper comm_handle,
+      GetNcclComm(*execute_params.collective_params,
+                  *execute_params.collective_cliques, config().replica_groups,
+                  config().group_mode, nccl_stream_id(), GetAsyncStreamKind()));
+  NcclApi::NcclCommHandle comm = comm_handle.comm_handle;
+  // Use custom allocator for persistent execution plans.
+  NcclApi::ScopedPersistentPlanAllocator scoped_allocator(
+      comm, tsl::MakeRef<NcclApi::PersistentPlanAllocator>(
+                execute_params.buffer_allocations->device_ordinal(),
+                execute_params.buffer_allocations->memory_allocator(),
+                execute_params.stream));
+
+  return AddTracedCommandBuffer(
+      execute_params, record_params, command_buffer, [&](se::Stream* stream) {
+        return RunAllToAll(nccl_api(), has_split_dimension_, device_buffers,
+                           *stream, comm);
+      });
+}
+
+CommandBufferCmd::BufferUsageVector AllToAllCmd::buffers() {
+  BufferUsageVector buffer_usage;
+  for (auto& buffer : buffers_) {
+    buffer_usage.emplace_back(buffer.source_buffer, MemoryAccess::kRead);
+    buffer_usage.emplace_back(buffer.destination_buffer, MemoryAccess::kWrite);
+  }
+  return buffer_usage;
+}
+
+//===----------------------------------------------------------------------===//
+// CollectivePermuteCmd
+//===----------------------------------------------------------------------===//
+
+CollectivePermuteCmd::CollectivePermuteCmd(
+    ExecutionStreamId execution_stream_id,
+    ExecutionStreamId async_from_stream_id, NcclApi* nccl_api,
+    NcclP2PConfig config, const NcclCollectiveThunk::Buffer& buffer)
+    : CollectiveCmd(execution_stream_id, async_from_stream_id, nccl_api,
+                    config.config),
+      p2p_config_(std::move(config)),
+      buffer_(buffer) {}
+
+absl::Status CollectivePermuteCmd::Record(
+    const Thunk::ExecuteParams& execute_params,
+    const RecordParams& record_params, se::CommandBuffer* command_buffer) {
+  TF_RETURN_IF_ERROR(BarrierIfAsync(
+      command_buffer, execute_params.stream->parent(), record_params));
+
+  TF_ASSIGN_OR_RETURN(
+      std::vector<DeviceBufferPair> device_buffers,
+      ConvertToDeviceBuffers(execute_params.buffer_allocations, {buffer_},
+                             config().operand_element_type));
+  TF_RET_CHECK(device_buffers.size() == 1) << "Expected one buffer pair.";
+
+  ExecutionScopeId execution_scope_id = GetExecutionScope(record_params);
+  VLOG(5) << "CollectivePermuteCmd: execution_scope_id="
+          << execution_scope_id.value();
+  VLOG(5) << "  Src: " << buffer_.source_buffer << " ("
+          << device_buffers[0].source_buffer.opaque() << ")";
+  VLOG(5) << "  Dst: " << buffer_.destination_buffer << " ("
+          << device_buffers[0].destination_buffer.opaque() << ")";
+
+  if (!execute_params.collective_params || !execute_params.collective_cliques) {
+    return absl::InvalidArgumentError(
+        "CollectivePermuteCmd requires collective parameters and cliques");
+  }
+
+  const Thunk::CollectiveExecuteParams& collective_params =
+      *execute_params.collective_params;
+  TF_ASSIGN_OR_RETURN(const DeviceAssignment::LogicalID current_logical_id,
+                      collective_params.device_assn->LogicalIdForDevice(
+                          collective_params.global_device_id));
+  const int64_t current_id =
+      config().group_mode == CollectiveOpGroupMode::kCrossReplica
+          ? current_logical_id.replica_id
+          : current_logical_id.computation_id;
+  std::string device_string =
+      NcclCollectiveThunk::GetDeviceString(collective_params);
+
+  const NcclP2PConfig::SourceTargetMapEntry source_target =
+      NcclP2PConfig::GetSourceTarget(p2p_config_.id_to_source_target,
+                                     current_id);
+
+  TF_ASSIGN_OR_RETURN(
+      NcclCommHandleWrapper comm_handle,
+      GetNcclComm(collective_params, *execute_params.collective_cliques,
+                  config().replica_groups, config().group_mode,
+                  nccl_stream_id(), GetAsyncStreamKind()));
+  NcclApi::NcclCommHandle comm = comm_handle.comm_handle;
+  // Use custom allocator for persistent execution plans.
+  NcclApi::ScopedPersistentPlanAllocator scoped_allocator(
+      comm, tsl::MakeRef<NcclApi::PersistentPlanAllocator>(
+                execute_params.buffer_allocations->device_ordinal(),
+                execute_params.buffer_allocations->memory_allocator(),
+                execute_params.stream));
+
+  // Not used without memcpy.
+  NcclCollectivePermuteStartThunk::RecvPtrMap recv_ptr_map;
+  return AddTracedCommandBuffer(
+      execute_params, record_params, command_buffer, [&](se::Stream* stream) {
+        return RunCollectivePermute(nccl_api(), source_target,
+                                    device_buffers[0], *stream, comm,
+                                    device_string, current_id,
+                                    /*use_memcpy=*/false, recv_ptr_map);
+      });
+}
+
+CommandBufferCmd::BufferUsageVector CollectivePermuteCmd::buffers() {
+  return {{buffer_.source_buffer, MemoryAccess::kRead},
+          {buffer_.destination_buffer, MemoryAccess::kWrite}};
+}
+
 }  // namespace xla::gpu
@@ -47,6 +47,7 @@ limitations under the License.
 #include "xla/service/gpu/runtime/nccl_api.h"
 #include "xla/service/gpu/runtime/nccl_clique_key.h"
 #include "xla/service/gpu/runtime/nccl_collective_thunk.h"
+#include "xla/service/gpu/runtime/nccl_p2p_thunk_common.h"
 #include "xla/service/gpu/runtime/thunk.h"
 #include "xla/stream_executor/command_buffer.h"
 #include "xla/stream_executor/device_memory.h"
@@ -115,7 +116,10 @@ class CommandBufferCmd {
     virtual ~State() = default;
   };
 
-  // An external manager for a state attached to commands.
+  // An external manager for a state attached to commands. States are keyed by
+  // the command and the concrete state type, so a command can have multiple
+  // states attached to it (i.e. its own state and the state attached to it by
+  // the command sequence that records it).
   class StateManager {
    public:
     virtual ~StateManager() = default;
@@ -123,7 +127,8 @@ class CommandBufferCmd {
     template <typename ConcreteState>
     ConcreteState* GetOrNull(const CommandBufferCmd* cmd) {
       static_assert(std::is_base_of_v<State, ConcreteState>);
-      return static_cast<ConcreteState*>(GetOrNull(cmd));
+      return static_cast<ConcreteState*>(
+          GetOrNull(cmd, TypeTag<ConcreteState>()));
     }
 
     template <typename ConcreteState>
@@ -131,24 +136,35 @@ class CommandBufferCmd {
         const CommandBufferCmd* cmd,
         absl::FunctionRef<std::unique_ptr<ConcreteState>()> create) {
       static_assert(std::is_base_of_v<State, ConcreteState>);
-      return static_cast<ConcreteState*>(GetOrCreate(
-          cmd, [&]() -> std::unique_ptr<State> { return create(); }));
+      return static_cast<ConcreteState*>(
+          GetOrCreate(cmd, TypeTag<ConcreteState>(),
+                      [&]() -> std::unique_ptr<State> { return create(); }));
     }
 
     template <typename ConcreteState>
     ConcreteState* GetOrCreate(const CommandBufferCmd* cmd) {
       static_assert(std::is_base_of_v<State, ConcreteState>);
       return static_cast<ConcreteState*>(
-          GetOrCreate(cmd, [] { return std::make_unique<ConcreteState>(); }));
+          GetOrCreate(cmd, TypeTag<ConcreteState>(),
+                      [] { return std::make_unique<ConcreteState>(); }));
     }
 
    private:
-    State* GetOrNull(const CommandBufferCmd* cmd);
+    // A unique address for each concrete state type.
+    template <typename ConcreteState>
+    static const void* TypeTag() {
+      static const char tag = 0;
+      return &tag;
+    }
 
-    State* GetOrCreate(const CommandBufferCmd* cmd,
+    using Key = std::pair<const CommandBufferCmd*, const void*>;
+
+    State* GetOrNull(const CommandBufferCmd* cmd, const void* type_tag);
+
+    State* GetOrCreate(const CommandBufferCmd* cmd, const void* type_tag,
                        absl::FunctionRef<std::unique_ptr<State>()> create);
 
-    absl::flat_hash_map<const CommandBufferCmd*, std::unique_ptr<State>> state_;
+    absl::flat_hash_map<Key, std::unique_ptr<State>> state_;
   };
 
   // Parameters for recording commands into the command buffer.
@@ -206,6 +222,18 @@ class CommandBufferCmd {
   // Returns true if command implemented as a nested command buffer.
   virtual bool IsNestedCommandBuffer() const { return false; }
 
+  // Returns true if command synchronizes with other execution scopes or has
+  // ordering requirements not captured by `buffers()` (i.e. collective
+  // operations), and can't be reordered with any other command.
+  virtual bool IsSynchronizationCmd() { return false; }
+
+  // Returns true if command records commands only into its own execution scope
+  // (no barriers and no conditional commands), and recorded parameters depend
+  // only on the device addresses of `buffers()`. Command buffer updates of such
+  // commands are skipped when buffer addresses did not change since the last
+  // time they were recorded.
+  virtual bool IsUpdateElidable() { return false; }
+
   // Returns a command execution scope created from the specified
   // 'execution_stream_id'.
   se::CommandBuffer::ExecutionScopeId GetExecutionScope(
@@ -262,7 +290,15 @@ class CommandBufferCmdSequence {
     // that have read-write conflicts into the same buffers. Conflicts are
     // detected only between commands using the same stream id, and inter-stream
     // synchronization is a user responsibility.
-    kAutomatic
+    kAutomatic,
+
+    // Builds a dependency DAG from the buffer use analysis, and records
+    // commands in topological order grouped into levels, where each command
+    // depends only on commands from previous levels. Commands from the same
+    // level do not have conflicts and execute concurrently, and barriers are
+    // added only between levels. Commands that synchronize execution scopes
+    // (`IsSynchronizationCmd()`) are never reordered with other commands.
+    kConcurrent
   };
 
   enum class RecordMode {
@@ -310,6 +346,17 @@ class CommandBufferCmdSequence {
   // Returns buffer allocations indices referenced by commands in this sequence.
   const absl::flat_hash_set<BufferAllocation::Index>& allocs_indices() const;
 
+  // Number of commands updated and skipped by the command buffer updates. A
+  // command update is skipped if the command is elidable and its buffer
+  // addresses did not change since it was last recorded.
+  struct UpdateStats {
+    int64_t num_updated_commands = 0;
+    int64_t num_skipped_commands = 0;
+  };
+
+  // Returns command buffer update statistics accumulated in a given state.
+  static UpdateStats GetUpdateStats(CommandBufferCmd::StateManager& state);
+
   // Returns a vector that tells if command at the given index requires a
   // barrier.
   std::vector<bool> barriers() const;
@@ -327,8 +374,14 @@ class CommandBufferCmdSequence {
   struct CommandInfo {
     std::unique_ptr<CommandBufferCmd> cmd;
     bool requires_barrier;
+
+    // Level of the command in the dependency DAG (kConcurrent mode only).
+    int64_t level = 0;
   };
 
+  // Appends a command to a sequence in kConcurrent synchronization mode.
+  void AppendConcurrent(std::unique_ptr<CommandBufferCmd> cmd);
+
   // Functions for tracking buffer usage of recorded commands and figuring out
   // when the next command requires a barrier for correctness.
   bool HasConflicts(ExecutionStreamId execution_stream_id,
@@ -355,6 +408,23 @@ class CommandBufferCmdSequence {
   };
 
   absl::flat_hash_map<ExecutionStreamId, ReadWriteSet> read_write_sets_;
+
+  // In kConcurrent mode we track all buffers used by commands together with
+  // the level of the command that used them, to find the level of the next
+  // appended command.
+  struct LeveledBufferUsage {
+    CommandBufferCmd::BufferUsage buffer;
+    int64_t level;
+  };
+
+  absl::flat_hash_map<ExecutionStreamId, std::vector<LeveledBufferUsage>>
+      leveled_buffers_;
+
+  // The number of levels in the dependency DAG and the minimum level of the
+  // next appended command (all commands must follow the last synchronization
+  // command).
+  int64_t num_levels_ = 0;
+  int64_t min_level_ = 0;
 };
 
 //===----------------------------------------------------------------------===//
@@ -462,6 +532,7 @@ class LaunchCmd : public CommandBufferCmd {
                       se::CommandBuffer* command_buffer) override;
 
   BufferUsageVector buffers() override;
+  bool IsUpdateElidable() override { return true; }
 
  private:
   std::string kernel_name_;
@@ -496,6 +567,7 @@ class CustomKernelLaunchCmd : public CommandBufferCmd {
                       se::CommandBuffer* command_buffer) override;
 
   BufferUsageVector buffers() override;
+  bool IsUpdateElidable() override { return true; }
 
  private:
   std::vector<BufferAllocation::Slice> args_;
@@ -524,6 +596,7 @@ class MemcpyDeviceToDeviceCmd : public CommandBufferCmd {
                       se::CommandBuffer* command_buffer) override;
 
   BufferUsageVector buffers() override;
+  bool IsUpdateElidable() override { return true; }
 
  private:
   BufferAllocation::Slice dst_;
@@ -545,6 +618,7 @@ class MemzeroCmd : public CommandBufferCmd {
                       se::CommandBuffer* command_buffer) override;
 
   BufferUsageVector buffers() override;
+  bool IsUpdateElidable() override { return true; }
 
  private:
   BufferAllocation::Slice dst_;
@@ -564,6 +638,7 @@ class Memset32Cmd : public CommandBufferCmd {
                       se::CommandBuffer* command_buffer) override;
 
   BufferUsageVector buffers() override;
+  bool IsUpdateElidable() override { return true; }
 
  private:
   BufferAllocation::Slice dst_;
@@ -921,6 +996,7 @@ class BarrierCmd : public CommandBufferCmd {
                       se::CommandBuffer* command_buffer) override;
 
   BufferUsageVector buffers() override;
+  bool IsSynchronizationCmd() override { return true; }
 
  private:
   const ExecutionStreamId from_stream_id_;
@@ -942,6 +1018,7 @@ class CollectiveCmd : public CommandBufferCmd {
   bool force_update() override { return true; }
 
   bool IsNestedCommandBuffer() const final { return true; }
+  bool IsSynchronizationCmd() override { return true; }
 
   absl::Status AddTracedCommandBuffer(
       const Thunk::ExecuteParams& execute_params,
@@ -1074,6 +1151,60 @@ class CollectiveBroadcastCmd : public CollectiveCmd {
   std::vector<NcclCollectiveThunk::Buffer> buffers_;
 };
 
+//===----------------------------------------------------------------------===//
+// AllToAllCmd
+//===----------------------------------------------------------------------===//
+
+class AllToAllCmd : public CollectiveCmd {
+ public:
+  AllToAllCmd(ExecutionStreamId execution_stream_id,
+              ExecutionStreamId async_from_stream_id, NcclApi* nccl_api,
+              NcclCollectiveConfig config, bool has_split_dimension,
+              absl::Span<const NcclCollectiveThunk::Buffer> buffers,
+              AsyncStreamKind stream_kind = AsyncStreamKind::kCollective);
+
+  absl::Status Record(const Thunk::ExecuteParams& execute_params,
+                      const RecordParams& record_params,
+                      se::CommandBuffer* command_buffer) override;
+
+  BufferUsageVector buffers() override;
+
+  AsyncStreamKind GetAsyncStreamKind() override { return stream_kind_; };
+
+ private:
+  bool has_split_dimension_;
+  std::vector<NcclCollectiveThunk::Buffer> buffers_;
+  AsyncStreamKind stream_kind_;
+};
+
+//===----------------------------------------------------------------------===//
+// CollectivePermuteCmd
+//===----------------------------------------------------------------------===//
+
+// Collective permute recorded into a command buffer always uses NCCL send and
+// receive, as the memcpy path for local peers synchronizes with the host.
+class CollectivePermuteCmd : public CollectiveCmd {
+ public:
+  CollectivePermuteCmd(ExecutionStreamId execution_stream_id,
+                       ExecutionStreamId async_from_stream_id,
+                       NcclApi* nccl_api, NcclP2PConfig config,
+                       const NcclCollectiveThunk::Buffer& buffer);
+
+  absl::Status Record(const Thunk::ExecuteParams& execute_params,
+                      const RecordParams& record_params,
+                      se::CommandBuffer* command_buffer) override;
+
+  BufferUsageVector buffers() override;
+
+  AsyncStreamKind GetAsyncStreamKind() override {
+    return AsyncStreamKind::kCollective;
+  };
+
+ private:
+  NcclP2PConfig p2p_config_;
+  NcclCollectiveThunk::Buffer buffer_;
+};
+
 }  // namespace xla::gpu
 
 #endif  // XLA_SERVICE_GPU_RUNTIME_COMMAND_BUFFER_CMD_H_
@@ -178,6 +178,33 @@ TEST(CommandBufferCmdTest, NoWriteConflictsAcrossStreams) {
   EXPECT_EQ(commands.barriers().at(1), false);
 }
 
+TEST(CommandBufferCmdTest, ConcurrentExecution) {
+  BufferAllocation alloc0(/*index=*/0, /*size=*/1024, /*color=*/0);
+
+  auto slice0 = BufferAllocation::Slice(&alloc0, 0, 100);
+  auto slice1 = BufferAllocation::Slice(&alloc0, 200, 100);
+
+  // Two independent producer-consumer pairs: producers and consumers are
+  // grouped into two levels, with a single barrier between them.
+  auto write0 = BufferUsage(slice0, MemoryAccess::kWrite);
+  auto read0 = BufferUsage(slice0, MemoryAccess::kRead);
+  auto write1 = BufferUsage(slice1, MemoryAccess::kWrite);
+  auto read1 = BufferUsage(slice1, MemoryAccess::kRead);
+
+  CommandBufferCmdSequence commands(
+      CommandBufferCmdSequence::SynchronizationMode::kConcurrent);
+  commands.Emplace<TestOnlyCommandBufferCmd>(s0, BufferUsageVector{write0});
+  commands.Emplace<TestOnlyCommandBufferCmd>(s0, BufferUsageVector{read0});
+  commands.Emplace<TestOnlyCommandBufferCmd>(s0, BufferUsageVector{write1});
+  commands.Emplace<TestOnlyCommandBufferCmd>(s0, BufferUsageVector{read1});
+
+  ASSERT_EQ(commands.barriers().size(), 4);
+  EXPECT_EQ(commands.barriers().at(0), false);
+  EXPECT_EQ(commands.barriers().at(1), false);
+  EXPECT_EQ(commands.barriers().at(2), true);
+  EXPECT_EQ(commands.barriers().at(3), false);
+}
+
 TEST(CommandBufferCmdTest, MemcpyCmd) {
   se::StreamExecutor* executor = GpuExecutor();
 
@@ -228,6 +255,82 @@ TEST(CommandBufferCmdTest, MemcpyCmd) {
   ASSERT_EQ(dst, std::vector<int32_t>(4, 42));
 }
 
+TEST(CommandBufferCmdTest, SkipUpdateOfUnchangedCmds) {
+  se::StreamExecutor* executor = GpuExecutor();
+
+  auto stream = executor->CreateStream().value();
+  int64_t length = 4;
+  int64_t byte_length = sizeof(int32_t) * length;
+
+  // Prepare arguments: a=42, b=0, c=0, d=0
+  se::DeviceMemory<int32_t> a = executor->AllocateArray<int32_t>(length, 0);
+  se::DeviceMemory<int32_t> b = executor->AllocateArray<int32_t>(length, 0);
+  se::DeviceMemory<int32_t> c = executor->AllocateArray<int32_t>(length, 0);
+  se::DeviceMemory<int32_t> d = executor->AllocateArray<int32_t>(length, 0);
+
+  TF_ASSERT_OK(stream->Memset32(&a, 42, byte_length));
+  TF_ASSERT_OK(stream->MemZero(&b, byte_length));
+  TF_ASSERT_OK(stream->MemZero(&c, byte_length));
+  TF_ASSERT_OK(stream->MemZero(&d, byte_length));
+
+  // Prepare buffer allocations for recording command buffer.
+  BufferAllocation alloc_a(/*index=*/0, byte_length, /*color=*/0);
+  BufferAllocation alloc_b(/*index=*/1, byte_length, /*color=*/0);
+  BufferAllocation alloc_c(/*index=*/2, byte_length, /*color=*/0);
+
+  BufferAllocation::Slice slice_a(&alloc_a, 0, byte_length);
+  BufferAllocation::Slice slice_b(&alloc_b, 0, byte_length);
+  BufferAllocation::Slice slice_c(&alloc_c, 0, byte_length);
+
+  // Prepare commands sequence for constructing command buffer.
+  CommandBufferCmdSequence commands;
+  commands.Emplace<MemcpyDeviceToDeviceCmd>(s0, slice_b, slice_a, byte_length);
+  commands.Emplace<MemcpyDeviceToDeviceCmd>(s0, slice_c, slice_a, byte_length);
+
+  ServiceExecutableRunOptions run_options;
+  se::StreamExecutorMemoryAllocator allocator(executor);
+  BufferAllocations allocations({a, b, c}, 0, &allocator);
+
+  CommandBufferCmd::StateManager state;
+
+  Thunk::ExecuteParams params = Thunk::ExecuteParams::Create(
+      run_options, allocations, stream.get(), stream.get(), nullptr, nullptr);
+
+  CommandBufferCmd::RecordParams record_params = {state};
+
+  auto command_buffer =
+      executor->CreateCommandBuffer(se::CommandBuffer::Mode::kPrimary).value();
+  TF_ASSERT_OK(commands.Record(params, record_params, command_buffer.get()));
+
+  // Update command buffer to copy into `d` instead of `c`.
+  BufferAllocations allocations_d({a, b, d}, 0, &allocator);
+  Thunk::ExecuteParams params_d = Thunk::ExecuteParams::Create(
+      run_options, allocations_d, stream.get(), stream.get(), nullptr, nullptr);
+
+  TF_ASSERT_OK(commands.Record(params_d, record_params, command_buffer.get()));
+
+  // Only the second command should be updated.
+  CommandBufferCmdSequence::UpdateStats stats =
+      CommandBufferCmdSequence::GetUpdateStats(state);
+  ASSERT_EQ(stats.num_updated_commands, 1);
+  ASSERT_EQ(stats.num_skipped_commands, 1);
+
+  // Execute command buffer and verify that it copied the memory.
+  TF_ASSERT_OK(executor->Submit(stream.get(), *command_buffer));
+
+  // Copy `b`, `c` and `d` data back to host.
+  std::vector<int32_t> dst_b(4, 0);
+  std::vector<int32_t> dst_c(4, 0);
+  std::vector<int32_t> dst_d(4, 0);
+  TF_ASSERT_OK(stream->Memcpy(dst_b.data(), b, byte_length));
+  TF_ASSERT_OK(stream->Memcpy(dst_c.data(), c, byte_length));
+  TF_ASSERT_OK(stream->Memcpy(dst_d.data(), d, byte_length));
+
+  ASSERT_EQ(dst_b, std::vector<int32_t>(4, 42));
+  ASSERT_EQ(dst_c, std::vector<int32_t>(4, 0));
+  ASSERT_EQ(dst_d, std::vector<int32_t>(4, 42));
+}
+
 TEST(CommandBufferCmdTest, BarrierCmd) {
   se::StreamExecutor* executor = GpuExecutor();
 
@@ -395,6 +498,11 @@ TEST(CommandBufferCmdStateManageTest, GetOrCreateState) {
   auto* state2 = state_manager.GetOrCreate<TestState>(cmd);
   ASSERT_EQ(state2->value, 42);
   ASSERT_EQ(state1, state2);
+
+  // States of different types attached to the same command are independent.
+  struct OtherTestState : public CommandBufferCmd::State {};
+  ASSERT_EQ(state_manager.GetOrNull<OtherTestState>(cmd), nullptr);
+  ASSERT_NE(state_manager.GetOrCreate<OtherTestState>(cmd), nullptr);
 }
 
 TEST(TracedCommandBuffer, GetOrUpdateCommandBuffer) {
@@ -240,8 +240,12 @@ absl::Status CommandBufferThunk::ExecuteOnStream(const ExecuteParams& params) {
                                         cmd_buffer->command_buffer.get()));
 
     uint64_t end_micros = tsl::Env::Default()->NowMicros();
+    CommandBufferCmdSequence::UpdateStats stats =
+        CommandBufferCmdSequence::GetUpdateStats(cmd_buffer->state);
     VLOG(3) << "Updated command buffer in " << (end_micros - start_micros)
-            << " μs; num_commands=" << commands_.size();
+            << " μs; num_commands=" << commands_.size()
+            << "; num_updated_commands=" << stats.num_updated_commands
+            << "; num_skipped_commands=" << stats.num_skipped_commands;
     cmd_buffer->num_executions = 0;
   }
 
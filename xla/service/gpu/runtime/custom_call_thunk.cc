@@ -16,16 +16,21 @@ limitations under the License.
 #include "xla/service/gpu/runtime/custom_call_thunk.h"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xla/executable_run_options.h"
 #include "xla/ffi/api/c_api.h"
 #include "xla/ffi/call_frame.h"
+#include "xla/ffi/execution_state.h"
 #include "xla/ffi/ffi_api.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/service/buffer_assignment.h"
@@ -36,7 +41,9 @@ limitations under the License.
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
 #include "xla/util.h"
+#include "tsl/platform/statusor.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "xla/stream_executor/gpu/gpu_stream.h"
@@ -49,6 +56,33 @@ using xla::ffi::CallFrame;
 using xla::ffi::CallFrameBuilder;
 using xla::ffi::CallOptions;
 
+// Builds a call frame with all the attributes and null buffers of the given
+// shapes. Returns std::nullopt if any operand or result is a token.
+static std::optional<CallFrame> BuildCallFrame(
+    absl::Span<const std::optional<CustomCallThunk::Slice>> operands,
+    absl::Span<const std::optional<CustomCallThunk::Slice>> results,
+    CustomCallThunk::AttributesMap attributes) {
+  CallFrameBuilder builder;
+
+  for (const std::optional<CustomCallThunk::Slice>& operand : operands) {
+    if (!operand.has_value()) return std::nullopt;
+    builder.AddBufferArg(se::DeviceMemoryBase(), operand->shape.element_type(),
+                         operand->shape.dimensions());
+  }
+
+  for (const std::optional<CustomCallThunk::Slice>& result : results) {
+    if (!result.has_value()) return std::nullopt;
+    builder.AddBufferRet(se::DeviceMemoryBase(), result->shape.element_type(),
+                         result->shape.dimensions());
+  }
+
+  CallFrameBuilder::AttributesBuilder attrs;
+  attrs.Append(std::move(attributes));
+  builder.AddAttributes(attrs.Build());
+
+  return builder.Build();
+}
+
 CustomCallThunk::CustomCallThunk(ThunkInfo thunk_info,
                                  CustomCallTarget call_target,
                                  std::vector<std::optional<Slice>> operands,
@@ -70,7 +104,7 @@ CustomCallThunk::CustomCallThunk(ThunkInfo thunk_info,
       operands_(std::move(operands)),
       results_(std::move(results)),
       bundle_(bundle),
-      attributes_(std::move(attributes)),
+      call_frame_(BuildCallFrame(operands_, results_, std::move(attributes))),
       called_computation_(called_computation) {}
 
 absl::Status CustomCallThunk::ExecuteCustomCall(const ExecuteParams& params) {
@@ -115,47 +149,48 @@ absl::Status CustomCallThunk::ExecuteFfiHandler(
     int32_t device_ordinal, se::Stream* stream,
     se::DeviceMemoryAllocator* allocator,
     const ffi::ExecutionContext* execution_context,
+    ffi::ExecutionState* execution_state,
     const BufferAllocations* buffer_allocations) {
   if (handler == nullptr) {
     return absl::InternalError("FFI execute handler is not set");
   }
 
-  // TODO(ezhulenev): This is not the most optimal approach, as we'll be doing
-  // a lot of extra allocation on every call. We have to keep attributes
-  // separate from arguments, as they do not change after thunk is constructed.
-  CallFrameBuilder builder;
+  if (!call_frame_.has_value()) {
+    return Internal("FFI handlers do not support tokens (yet)!");
+  }
 
+  absl::InlinedVector<se::DeviceMemoryBase, 8> arguments;
+  arguments.reserve(operands_.size());
   for (auto& operand : operands_) {
-    if (!operand.has_value())
-      return Internal("FFI handlers do not support tokens (yet)!");
     if (!operand->slice.allocation())
       return Internal("custom call argument missing buffer allocation");
-
-    builder.AddBufferArg(buffer_allocations->GetDeviceAddress(operand->slice),
-                         operand->shape.element_type(),
-                         operand->shape.dimensions());
+    arguments.push_back(buffer_allocations->GetDeviceAddress(operand->slice));
   }
 
+  absl::InlinedVector<se::DeviceMemoryBase, 4> results;
+  results.reserve(results_.size());
   for (auto& result : results_) {
-    if (!result.has_value())
-      return Internal("FFI handlers do not support tokens (yet)!");
     if (!result->slice.allocation())
       return Internal("custom call result missing buffer allocation");
-
-    builder.AddBufferRet(buffer_allocations->GetDeviceAddress(result->slice),
-                         result->shape.element_type(),
-                         result->shape.dimensions());
+    results.push_back(buffer_allocations->GetDeviceAddress(result->slice));
   }
 
-  CallFrameBuilder::AttributesBuilder attrs;
-  attrs.Append(attributes_);
+  // Patch the pre-built call frame with buffers for this execution.
+  TF_ASSIGN_OR_RETURN(CallFrame call_frame,
+                      call_frame_->CopyWithBuffers(arguments, results));
 
-  builder.AddAttributes(attrs.Build());
-  CallFrame call_frame = builder.Build();
+  CallOptions options = {device_ordinal,    stream,
+                         allocator,         called_computation_,
+                         execution_context, execution_state};
+  return Call(handler, call_frame, options, stage);
+}
 
-  CallOptions options = {device_ordinal, stream, allocator, called_computation_,
-                         execution_context};
-  return Call(bundle_->execute, call_frame, options, stage);
+ffi::ExecutionState* CustomCallThunk::GetOrCreateExecutionState(
+    se::StreamExecutor* executor) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = execution_states_.try_emplace(executor);
+  if (inserted) it->second = std::make_unique<ffi::ExecutionState>();
+  return it->second.get();
 }
 
 absl::Status CustomCallThunk::Prepare(const PrepareParams& params,
@@ -167,7 +202,13 @@ absl::Status CustomCallThunk::Prepare(const PrepareParams& params,
 }
 
 absl::Status CustomCallThunk::Initialize(const InitializeParams& params) {
-  if (!bundle_ || !bundle_->initialize) {
+  if (!bundle_) {
+    return absl::OkStatus();
+  }
+
+  ffi::ExecutionState* execution_state =
+      GetOrCreateExecutionState(params.executor);
+  if (!bundle_->initialize) {
     return absl::OkStatus();
   }
 
@@ -175,7 +216,8 @@ absl::Status CustomCallThunk::Initialize(const InitializeParams& params) {
       bundle_->initialize, XLA_FFI_ExecutionStage_INITIALIZE,
       params.buffer_allocations->device_ordinal(), params.stream,
       params.buffer_allocations->memory_allocator(),
-      params.ffi_execution_context, params.buffer_allocations);
+      params.ffi_execution_context, execution_state,
+      params.buffer_allocations);
 }
 
 absl::Status CustomCallThunk::ExecuteOnStream(const ExecuteParams& params) {
@@ -184,7 +226,9 @@ absl::Status CustomCallThunk::ExecuteOnStream(const ExecuteParams& params) {
         bundle_->execute, XLA_FFI_ExecutionStage_EXECUTE,
         params.buffer_allocations->device_ordinal(), params.stream,
         params.buffer_allocations->memory_allocator(),
-        params.ffi_execution_context, params.buffer_allocations);
+        params.ffi_execution_context,
+        GetOrCreateExecutionState(params.stream->parent()),
+        params.buffer_allocations);
   }
   return ExecuteCustomCall(params);
 }
@@ -19,16 +19,21 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/executable_run_options.h"
 #include "xla/ffi/api/c_api.h"
 #include "xla/ffi/call_frame.h"
 #include "xla/ffi/execution_context.h"
+#include "xla/ffi/execution_state.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/custom_call_status.h"
@@ -37,6 +42,7 @@ limitations under the License.
 #include "xla/shape.h"
 #include "xla/stream_executor/device_memory_allocator.h"
 #include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "xla/stream_executor/gpu/gpu_types.h"
@@ -108,8 +114,11 @@ class CustomCallThunk : public Thunk {
                                  int32_t device_ordinal, se::Stream* stream,
                                  se::DeviceMemoryAllocator* allocator,
                                  const ffi::ExecutionContext* execution_context,
+                                 ffi::ExecutionState* execution_state,
                                  const BufferAllocations* buffer_allocations);
 
+  ffi::ExecutionState* GetOrCreateExecutionState(se::StreamExecutor* executor);
+
   std::vector<std::optional<Slice>> operands_;
   std::vector<std::optional<Slice>> results_;
 
@@ -122,7 +131,19 @@ class CustomCallThunk : public Thunk {
   // functions with XLA runtime. It's under construction, and still misses
   // a lot of features. Long term it will replace legacy custom calls.
   std::optional<XLA_FFI_Handler_Bundle> bundle_;
-  AttributesMap attributes_;
+
+  // Reference call frame pre-initialized at construction time with all the
+  // attributes and null buffers. Buffers are patched in for every execution
+  // (see `CallFrame::CopyWithBuffers`), so attributes are encoded only once.
+  // Not set if operands or results have tokens, which FFI does not support.
+  std::optional<ffi::CallFrame> call_frame_;
+
+  // State of the FFI handler for every `StreamExecutor`. It is created before
+  // the first initialize stage on an executor and passed to the handler at
+  // every stage, so handlers can do expensive setup only once.
+  absl::Mutex mutex_;
+  absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<ffi::ExecutionState>>
+      execution_states_ ABSL_GUARDED_BY(mutex_);
 
   // TODO(ezhulenev): Currently we assume that HloModule that owns this
   // computation is owned by a GpuExecutable and stays alive for as long as
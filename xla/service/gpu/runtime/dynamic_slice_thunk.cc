@@ -53,11 +53,14 @@ DynamicSliceThunk::DynamicSliceThunk(
     std::vector<std::optional<std::vector<Offset>>> offsets,
     std::vector<std::optional<Shape>> orig_shapes,
     std::vector<std::optional<Shape>> sliced_shapes,
-    std::vector<std::optional<uint64_t>> offset_byte_sizes)
+    std::vector<std::optional<uint64_t>> offset_byte_sizes,
+    std::optional<PageTable> page_table,
+    std::vector<PageSlicing> page_slicings)
     : Thunk(Kind::kAddressComputation, thunk_info),
       embedded_thunk_(std::make_unique<SequentialThunk>(
           ThunkInfo(), std::move(*embedded_thunk))),
-      fake_allocations_(std::move(fake_allocations)) {
+      fake_allocations_(std::move(fake_allocations)),
+      page_table_(std::move(page_table)) {
   // Zip all arguments together to create a list of SliceDef.
   for (auto [arg, offsets, orig_shape, sliced_shape, offset_byte_size] :
        llvm::zip_equal(arguments, offsets, orig_shapes, sliced_shapes,
@@ -79,6 +82,16 @@ DynamicSliceThunk::DynamicSliceThunk(
       offsets_allocs_size_ += slice.sliced_shape->rank() * sizeof(int64_t);
     }
   }
+
+  // Page indices are transferred from device to host all at once.
+  for (auto [slice, page_slicing] : llvm::zip(slices_, page_slicings)) {
+    slice.page_slicing = page_slicing;
+  }
+  if (page_table_.has_value()) {
+    page_indices_offset_ = offsets_allocs_size_;
+    offsets_allocs_size_ +=
+        page_table_->num_pages * page_table_->index_byte_size;
+  }
 }
 
 absl::Status DynamicSliceThunk::Prepare(const PrepareParams& params,
@@ -96,6 +109,27 @@ absl::Status DynamicSliceThunk::Prepare(const PrepareParams& params,
       TF_RET_CHECK(slice.offsets->size() == slice.orig_shape->rank());
       TF_RET_CHECK(slice.sliced_shape->rank() == slice.orig_shape->rank());
     }
+
+    if (slice.page_slicing != PageSlicing::kNone) {
+      TF_RET_CHECK(page_table_.has_value());
+      TF_RET_CHECK(!slice.offsets.has_value());
+      TF_RET_CHECK(slice.embedded_thunk_argument.has_value());
+      TF_RET_CHECK(slice.orig_shape.has_value());
+      TF_RET_CHECK(slice.sliced_shape.has_value());
+
+      TF_RET_CHECK(slice.sliced_shape->rank() == slice.orig_shape->rank());
+      TF_RET_CHECK(slice.sliced_shape->rank() > 0);
+      TF_RET_CHECK(slice.sliced_shape->dimensions(0) == 1);
+      TF_RET_CHECK(IsContiguousSlice(*slice.orig_shape, *slice.sliced_shape));
+    }
+    if (slice.page_slicing == PageSlicing::kBatched) {
+      TF_RET_CHECK(slice.orig_shape->dimensions(0) == page_table_->num_pages);
+    }
+  }
+
+  if (page_table_.has_value()) {
+    TF_RET_CHECK(page_table_->index_byte_size == sizeof(int32_t) ||
+                 page_table_->index_byte_size == sizeof(int64_t));
   }
 
   TF_RETURN_IF_ERROR(embedded_thunk_->Prepare(params, resource_requests));
@@ -238,6 +272,12 @@ absl::Status DynamicSliceThunk::ExecuteOnStream(const ExecuteParams& params) {
         argument_buffer.GetByteSlice(new_offset, new_size);
   }
 
+  if (page_table_.has_value()) {
+    return ExecuteOnPages(
+        params, slice_buffers,
+        reinterpret_cast<char*>(offsets_alloc) + page_indices_offset_);
+  }
+
   // Safe to create a local BufferAllocations here since buffers are only slices
   // of bigger ones allocated elsewhere.
   BufferAllocations slice_allocations(slice_buffers,
@@ -253,5 +293,65 @@ absl::Status DynamicSliceThunk::ExecuteOnStream(const ExecuteParams& params) {
   return absl::OkStatus();
 }
 
+absl::Status DynamicSliceThunk::ExecuteOnPages(
+    const ExecuteParams& params,
+    absl::InlinedVector<se::DeviceMemoryBase, 8>& slice_buffers,
+    char* page_indices) {
+  se::Stream& stream = *params.stream;
+  const BufferAllocations& orig_allocations = *params.buffer_allocations;
+
+  // Transfer all page indices from device to host with a single copy.
+  se::DeviceMemoryBase page_indices_src =
+      orig_allocations.GetDeviceAddress(page_table_->indices);
+  TF_RETURN_IF_ERROR(stream.Memcpy(
+      page_indices, page_indices_src,
+      page_table_->num_pages * page_table_->index_byte_size));
+  TF_RETURN_IF_ERROR(stream.BlockHostUntilDone());
+
+  auto page_index = [&](int64_t page) -> int64_t {
+    if (page_table_->index_byte_size == sizeof(int32_t)) {
+      return reinterpret_cast<const int32_t*>(page_indices)[page];
+    }
+    return reinterpret_cast<const int64_t*>(page_indices)[page];
+  };
+
+  VLOG(2) << "Execute address computation thunk on "
+          << page_table_->num_pages << " pages";
+  for (int64_t page = 0; page < page_table_->num_pages; ++page) {
+    for (auto [argument_idx, slice] : llvm::enumerate(slices_)) {
+      if (slice.page_slicing == PageSlicing::kNone) continue;
+
+      se::DeviceMemoryBase argument_buffer =
+          orig_allocations.GetDeviceAddress(*slice.embedded_thunk_argument);
+
+      // Clamp page index the same way as gather does:
+      // start = min(max(start, 0), operand.dimension_size[0] - 1)
+      int64_t start = slice.page_slicing == PageSlicing::kPaged
+                          ? page_index(page)
+                          : page;
+      start = std::min(std::max(start, int64_t{0}),
+                       slice.orig_shape->dimensions(0) - 1);
+
+      // Pages are contiguous, so page `start` is at `start * size`.
+      int64_t size = ShapeUtil::ByteSizeOf(*slice.sliced_shape);
+      VLOG(3) << "  - arg " << argument_idx << " page " << page
+              << ": slice at offset " << start * size << " with " << size;
+      slice_buffers[argument_idx] =
+          argument_buffer.GetByteSlice(start * size, size);
+    }
+
+    BufferAllocations page_allocations(slice_buffers,
+                                       orig_allocations.device_ordinal(),
+                                       orig_allocations.memory_allocator());
+
+    Thunk::ExecuteParams new_params =
+        Thunk::ExecuteParams::CloneWithNewAllocations(params,
+                                                      page_allocations);
+    TF_RETURN_IF_ERROR(embedded_thunk_->ExecuteOnStream(new_params));
+  }
+
+  return absl::OkStatus();
+}
+
 }  // namespace gpu
 }  // namespace xla
@@ -24,12 +24,14 @@ limitations under the License.
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/gpu/runtime/sequential_thunk.h"
 #include "xla/service/gpu/runtime/thunk.h"
 #include "xla/shape.h"
+#include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/memory_allocation.h"
 #include "xla/stream_executor/stream_executor.h"
 
@@ -50,6 +52,24 @@ class DynamicSliceThunk : public Thunk {
   // computed on device and have to be transferred to host.
   using Offset = std::variant<uint64_t, LoopIter, BufferAllocation::Slice>;
 
+  // A table of page indices computed on device (e.g. a block table of a paged
+  // KV cache). When a thunk has a page table, the embedded thunk is executed
+  // once for every page, and paged arguments are sliced at the page given by
+  // the table, instead of gathering all pages into a contiguous buffer first.
+  struct PageTable {
+    BufferAllocation::Slice indices;
+    int64_t num_pages;
+    uint64_t index_byte_size;
+  };
+
+  // How an argument is sliced along its major dimension for the `i`-th
+  // execution of the embedded thunk when the thunk has a page table.
+  enum class PageSlicing {
+    kNone,     // argument is passed as is
+    kPaged,    // argument is sliced at `page_table.indices[i]`
+    kBatched,  // argument is sliced at `i`
+  };
+
   DynamicSliceThunk(
       ThunkInfo thunk_info, std::unique_ptr<ThunkSequence> embedded_thunk,
       std::vector<std::optional<BufferAllocation::Slice>> arguments,
@@ -57,7 +77,9 @@ class DynamicSliceThunk : public Thunk {
       std::vector<std::optional<std::vector<Offset>>> offsets,
       std::vector<std::optional<Shape>> orig_shapes,
       std::vector<std::optional<Shape>> sliced_shapes,
-      std::vector<std::optional<uint64_t>> offset_byte_sizes);
+      std::vector<std::optional<uint64_t>> offset_byte_sizes,
+      std::optional<PageTable> page_table = std::nullopt,
+      std::vector<PageSlicing> page_slicings = {});
 
   DynamicSliceThunk(const DynamicSliceThunk&) = delete;
   DynamicSliceThunk& operator=(const DynamicSliceThunk&) = delete;
@@ -73,6 +95,12 @@ class DynamicSliceThunk : public Thunk {
   std::unique_ptr<SequentialThunk> embedded_thunk_;
   std::vector<std::unique_ptr<BufferAllocation>> fake_allocations_;
 
+  // Executes the embedded thunk for every page of the page table.
+  absl::Status ExecuteOnPages(
+      const ExecuteParams& params,
+      absl::InlinedVector<se::DeviceMemoryBase, 8>& slice_buffers,
+      char* page_indices);
+
   // Definition of a dynamic slice that extract a slice from the original buffer
   // defined by `embedded_thunk_argument` at given `offsets`.
   struct SliceDef {
@@ -81,9 +109,11 @@ class DynamicSliceThunk : public Thunk {
     std::optional<Shape> orig_shape;
     std::optional<Shape> sliced_shape;
     std::optional<uint64_t> offset_byte_size;
+    PageSlicing page_slicing = PageSlicing::kNone;
   };
 
   std::vector<SliceDef> slices_;
+  std::optional<PageTable> page_table_;
 
   // Pinned host memory for transferring offset values from device to host.
   absl::Mutex mutex_;
@@ -96,6 +126,9 @@ class DynamicSliceThunk : public Thunk {
 
   // A mapping from argument index to the base offset in the `offsets_allocs_`.
   std::vector<int64_t> offsets_allocs_base_;
+
+  // Byte offset of the page indices in the `offsets_allocs_`.
+  int64_t page_indices_offset_ = 0;
 };
 
 }  // namespace gpu
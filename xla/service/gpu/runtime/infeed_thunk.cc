@@ -30,7 +30,6 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/stream_executor/device_memory.h"
-#include "xla/stream_executor/device_memory_handle.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "xla/util.h"
 #include "tsl/platform/errors.h"
@@ -47,37 +46,45 @@ absl::Status InfeedThunk::ExecuteOnStream(const ExecuteParams& params) {
   const BufferAllocations& buffer_allocations = *params.buffer_allocations;
 
   VLOG(2) << "Infeeding to GPU";
-  ShapeTree<se::DeviceMemoryHandle> source_buffers =
-      GetOrCreateInfeedManager(stream.parent())->BlockingGetNextDestination();
-
-  size_t index = 0;
-  for (auto& source : source_buffers.leaves()) {
-    // Assert that the shapes are compatible.
-    const ShapeIndex& shape_index = source.first;
-    se::DeviceMemoryHandle& buffer = source.second;
-    const Shape& source_shape =
-        ShapeUtil::GetSubshape(source_buffers.shape(), shape_index);
-    TF_RET_CHECK(
-        ShapeUtil::ReshapeIsBitcast(dest_slices_[index].shape, source_shape))
-        << "Mismatch between infeed source buffer shape "
-        << ShapeUtil::HumanStringWithLayout(source_shape)
-        << " and infeed dest buffer shape "
-        << ShapeUtil::HumanStringWithLayout(dest_slices_[index].shape);
-    se::DeviceMemoryBase dest_address =
-        buffer_allocations.GetDeviceAddress(dest_slices_[index++].slice);
+  InfeedManager* infeed_manager = GetOrCreateInfeedManager(stream.parent());
+  InfeedBuffers source_buffers = infeed_manager->BlockingGetNextDestination();
+
+  auto copy_to_destination = [&]() -> absl::Status {
+    // Infeed transfer runs asynchronously on the infeed manager stream.
     TF_RETURN_IF_ERROR(
-        stream.Memcpy(&dest_address, buffer.memory(), buffer.memory().size()));
-  }
-
-  // Make sure that all dest slices have been copied into.
-  CHECK_EQ(index, dest_slices_.size())
-      << "Infeed did not populate all destination buffers";
-
-  absl::Status block_status = stream.BlockHostUntilDone();
-  if (!block_status.ok()) {
-    return Internal("Failed to complete data transfer on stream %p: %s",
-                    &stream, block_status.message());
-  }
+        infeed_manager->WaitForTransfer(source_buffers, &stream));
+
+    size_t index = 0;
+    for (auto& source : source_buffers.buffers.leaves()) {
+      // Assert that the shapes are compatible.
+      const ShapeIndex& shape_index = source.first;
+      se::DeviceMemoryBase& buffer = source.second;
+      const Shape& source_shape =
+          ShapeUtil::GetSubshape(source_buffers.buffers.shape(), shape_index);
+      TF_RET_CHECK(
+          ShapeUtil::ReshapeIsBitcast(dest_slices_[index].shape, source_shape))
+          << "Mismatch between infeed source buffer shape "
+          << ShapeUtil::HumanStringWithLayout(source_shape)
+          << " and infeed dest buffer shape "
+          << ShapeUtil::HumanStringWithLayout(dest_slices_[index].shape);
+      se::DeviceMemoryBase dest_address =
+          buffer_allocations.GetDeviceAddress(dest_slices_[index++].slice);
+      TF_RETURN_IF_ERROR(stream.Memcpy(&dest_address, buffer, buffer.size()));
+    }
+
+    // Make sure that all dest slices have been copied into.
+    CHECK_EQ(index, dest_slices_.size())
+        << "Infeed did not populate all destination buffers";
+    return absl::OkStatus();
+  };
+
+  absl::Status copy_status = copy_to_destination();
+
+  // Source buffers are reused by the infeed manager once the copies enqueued
+  // above are done, so we don't have to wait for them on the host.
+  TF_RETURN_IF_ERROR(
+      infeed_manager->Release(std::move(source_buffers), &stream));
+  TF_RETURN_IF_ERROR(copy_status);
 
   VLOG(2) << "Infeeding to GPU complete";
   return absl::OkStatus();
@@ -92,6 +92,11 @@ absl::Status KernelThunk::Initialize(const InitializeParams& params) {
         CreateKernel(kernel_name_, args_.size(), params.src.text,
                      params.src.binary, params.executor, shmem_bytes_));
 
+    packed_args_cache_.emplace(
+        params.executor,
+        std::make_unique<PackedArgs>(
+            args_.size(),
+            kernel->metadata().shared_memory_bytes().value_or(0)));
     kernel_cache_.emplace(params.executor, std::move(kernel));
   }
 
@@ -121,6 +126,7 @@ absl::Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
   LaunchDimensions launch_dimensions;
   std::optional<se::ClusterDim> cluster_dim;
   const se::Kernel* kernel = nullptr;
+  PackedArgs* packed_args = nullptr;
 
   TF_ASSIGN_OR_RETURN(
       se::Stream * stream,
@@ -134,6 +140,7 @@ absl::Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
     launch_dimensions = launch_dimensions_;
     cluster_dim = cluster_dim_;
     kernel = it->second.get();
+    packed_args = packed_args_cache_.at(executor).get();
   }
 
   VLOG(3) << "Launching " << kernel->name();
@@ -149,6 +156,24 @@ absl::Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
     PrintBufferContents(stream, buffer_args);
   }
 
+  // Reuse the packed arguments unless another execution is launching this
+  // kernel on the same executor right now, in which case we pack a fresh copy.
+  if (packed_args->mutex.TryLock()) {
+    packed_args->args.set_device_memory_arguments(buffer_args);
+    absl::Status status =
+        cluster_dim.has_value()
+            ? executor->Launch(stream,
+                               launch_dimensions.thread_counts_per_block(),
+                               launch_dimensions.block_counts(), *cluster_dim,
+                               *kernel, packed_args->args)
+            : executor->Launch(stream,
+                               launch_dimensions.thread_counts_per_block(),
+                               launch_dimensions.block_counts(), *kernel,
+                               packed_args->args);
+    packed_args->mutex.Unlock();
+    return status;
+  }
+
   if (cluster_dim.has_value()) {
     return ExecuteKernelOnStream(*kernel, buffer_args, launch_dimensions,
                                  cluster_dim.value(), stream);
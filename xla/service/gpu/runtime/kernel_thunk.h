@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_RUNTIME_KERNEL_THUNK_H_
 #define XLA_SERVICE_GPU_RUNTIME_KERNEL_THUNK_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -112,10 +113,23 @@ class KernelThunk : public Thunk {
 
   int64_t shmem_bytes_;
 
+  // Kernel arguments packed once per `StreamExecutor` and reused by every
+  // execution. Only device memory pointers are updated before a launch, and
+  // the mutex is held until the launch has copied the arguments.
+  struct PackedArgs {
+    PackedArgs(size_t num_args, uint32_t shared_memory_bytes)
+        : args(num_args, shared_memory_bytes) {}
+
+    absl::Mutex mutex;
+    se::KernelArgsDeviceMemoryPackedArray args ABSL_GUARDED_BY(mutex);
+  };
+
   // Loaded kernels for each `StreamExecutor`.
   mutable absl::Mutex mutex_;
   absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<se::Kernel>>
       kernel_cache_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<PackedArgs>>
+      packed_args_cache_ ABSL_GUARDED_BY(mutex_);
 };
 
 //===----------------------------------------------------------------------===//
@@ -17,12 +17,18 @@ limitations under the License.
 
 #include <array>
 #include <cstdint>
+#include <iterator>
+#include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "mlir/IR/Block.h"  // from @llvm-project
 #include "mlir/IR/Operation.h"  // from @llvm-project
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -162,6 +168,14 @@ NcclAllReduceStartThunk::NcclAllReduceStartThunk(
           impl::GetNcclAllReduceConfigInst(inst), std::move(buffers),
           IsSyncCollective(inst)) {}
 
+NcclAllReduceStartThunk::NcclAllReduceStartThunk(ThunkInfo thunk_info,
+                                                 NcclApi* nccl_api,
+                                                 NcclAllReduceConfig config,
+                                                 std::vector<Buffer> buffers)
+    : NcclAllReduceReduceScatterThunkBase(
+          Thunk::kNcclAllReduceStart, thunk_info, nccl_api, std::move(config),
+          std::move(buffers), /*is_sync=*/false) {}
+
 absl::Status NcclAllReduceStartThunk::CheckImplementable(
     const HloAllReduceInstruction* inst, int64_t replica_count,
     int64_t partition_count) {
@@ -175,6 +189,49 @@ CollectiveOpGroupMode NcclAllReduceStartThunk::GetGroupMode(
   return impl::GetGroupModeInst(inst);
 }
 
+bool NcclAllReduceStartThunk::CanCoalesceWith(
+    const NcclAllReduceStartThunk& other) const {
+  const NcclCollectiveConfig& a = config();
+  const NcclCollectiveConfig& b = other.config();
+
+  auto same_replica_group = [](const ReplicaGroup& x, const ReplicaGroup& y) {
+    return absl::c_equal(x.replica_ids(), y.replica_ids());
+  };
+
+  return async_events() != nullptr && other.async_events() != nullptr &&
+         execution_stream_id() == other.execution_stream_id() &&
+         nccl_stream_id() == other.nccl_stream_id() &&
+         reduction_kind() == other.reduction_kind() &&
+         a.collective_op_kind == b.collective_op_kind &&
+         a.group_mode == b.group_mode &&
+         absl::c_equal(a.replica_groups, b.replica_groups, same_replica_group);
+}
+
+std::unique_ptr<NcclAllReduceStartThunk> NcclAllReduceStartThunk::Coalesce(
+    const NcclAllReduceStartThunk& first,
+    const NcclAllReduceStartThunk& second) {
+  DCHECK(first.CanCoalesceWith(second));
+
+  NcclAllReduceConfig config = first.config_;
+  config.config.operand_count += second.config_.config.operand_count;
+  absl::c_copy(second.config_.config.operand_element_type,
+               std::back_inserter(config.config.operand_element_type));
+
+  std::vector<Buffer> buffers = first.buffers_;
+  absl::c_copy(second.buffers_, std::back_inserter(buffers));
+
+  ThunkInfo thunk_info;
+  thunk_info.profile_annotation = absl::StrCat(first.profile_annotation(), ",",
+                                               second.profile_annotation());
+  thunk_info.execution_stream_id = first.execution_stream_id();
+
+  auto thunk = absl::WrapUnique(new NcclAllReduceStartThunk(
+      std::move(thunk_info), first.nccl_api(), std::move(config),
+      std::move(buffers)));
+  thunk->set_async_events(first.async_events());
+  return thunk;
+}
+
 absl::Status NcclAllReduceStartThunk::RunNcclCollective(
     const ExecuteParams& params, se::Stream& stream,
     NcclCommHandleWrapper comm_wrapper) {
@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_GPU_RUNTIME_NCCL_ALL_REDUCE_THUNK_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -74,10 +75,30 @@ class NcclAllReduceStartThunk : public NcclAllReduceReduceScatterThunkBase {
   static CollectiveOpGroupMode GetGroupMode(
       const HloAllReduceInstruction* inst);
 
+  // Returns true if `other` can be launched together with this thunk in a
+  // single NCCL group: both are asynchronous, run on the same execution stream
+  // and communicator, and use the same reduction.
+  bool CanCoalesceWith(const NcclAllReduceStartThunk& other) const;
+
+  // Returns a thunk that launches all-reduces of `first` and `second` in a
+  // single NCCL group. The returned thunk shares async events with `first`,
+  // so done thunks of both operations must wait for these events. As the
+  // events are recorded after the whole group, the done of either operation
+  // waits for both reductions. The profile annotation of the returned thunk
+  // lists the annotations of both thunks separated by a comma.
+  static std::unique_ptr<NcclAllReduceStartThunk> Coalesce(
+      const NcclAllReduceStartThunk& first,
+      const NcclAllReduceStartThunk& second);
+
  protected:
   absl::Status RunNcclCollective(const ExecuteParams& params,
                                  se::Stream& stream,
                                  NcclCommHandleWrapper comm_wrapper) override;
+
+ private:
+  NcclAllReduceStartThunk(ThunkInfo thunk_info, NcclApi* nccl_api,
+                          NcclAllReduceConfig config,
+                          std::vector<Buffer> buffers);
 };
 
 // -----------------------------------------------------------------------------
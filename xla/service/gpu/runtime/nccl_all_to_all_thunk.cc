@@ -26,9 +26,11 @@ limitations under the License.
 #include "mlir/IR/Value.h"  // from @llvm-project
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/collective_ops_utils.h"
 #include "xla/service/gpu/ir_emission_utils.h"
 #include "xla/service/gpu/runtime/nccl_api.h"
+#include "xla/service/gpu/runtime/nccl_clique_key.h"
 #include "xla/service/gpu/runtime/nccl_collective_thunk.h"
 #include "xla/shape.h"
 #include "xla/shape_util.h"
@@ -55,6 +57,15 @@ NcclAllToAllConfig GetNcclAllToAllConfig(const HloAllToAllInstruction* instr) {
 
 }  // namespace
 
+AsyncStreamKind GetAllToAllStreamKind(const HloAllToAllInstruction* instr) {
+  return instr->GetModule()
+                 ->config()
+                 .debug_options()
+                 .xla_gpu_enable_all_to_all_stream()
+             ? AsyncStreamKind::kAllToAll
+             : AsyncStreamKind::kCollective;
+}
+
 NcclAllToAllStartThunk::NcclAllToAllStartThunk(
     ThunkInfo thunk_info, NcclApi* nccl_api,
     const HloAllToAllInstruction* instr,
@@ -62,7 +73,8 @@ NcclAllToAllStartThunk::NcclAllToAllStartThunk(
     : NcclCollectiveThunk(Thunk::kNcclAllToAllStart, thunk_info, nccl_api,
                           IsSyncCollective(instr)),
       config_(GetNcclAllToAllConfig(instr)),
-      buffers_(std::move(buffers)) {
+      buffers_(std::move(buffers)),
+      stream_kind_(GetAllToAllStreamKind(instr)) {
   CHECK_EQ(config_.config.operand_count, buffers_.size());
 }
 
@@ -463,6 +463,12 @@ static absl::StatusOr<std::shared_ptr<NcclClique::Lock>> InitializeNcclClique(
 
 using AcquiredCliquesMap = NcclClique::AcquiredCliquesMap;
 
+bool IsNcclCommSplittingEnabled() {
+  static const bool enable_nccl_comm_splitting =
+      xla::GetDebugOptionsFromFlags().xla_gpu_enable_nccl_comm_splitting();
+  return enable_nccl_comm_splitting;
+}
+
 absl::StatusOr<std::shared_ptr<NcclClique::Lock>> AcquireNcclClique(
     se::StreamExecutor* device, RunId run_id, NcclCliqueKey clique_key,
     const NcclCliqueIdCallback& clique_id_callback, int32_t rank,
@@ -497,17 +503,14 @@ absl::StatusOr<std::shared_ptr<NcclClique::Lock>> AcquireNcclClique(
   // If lock is not null return it to the caller.
   if (*clique) return clique;
 
-  // Maybe find if we acquired a clique with communicators that we can split.
-  static const int64_t enable_nccl_comm_splitting =
-      xla::GetDebugOptionsFromFlags().xla_gpu_enable_nccl_comm_splitting();
-
   // We enable resource sharing between parent and split communicators by
   // default because that's the only reason why we use comm splitting.
   NcclApi::Config config;
   config.split_share = true;
   config.max_nchannels = max_nchannels;
 
-  if (enable_nccl_comm_splitting) {
+  // Maybe find if we acquired a clique with communicators that we can split.
+  if (IsNcclCommSplittingEnabled()) {
     for (auto& [acquired_clique_key, acquired_clique] : acquired_cliques) {
       if (clique_key.IsSubsetOf(acquired_clique_key)) {
         return InitializeNcclClique(device, run_id, clique_key, acquired_clique,
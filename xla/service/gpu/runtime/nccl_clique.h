@@ -154,6 +154,10 @@ class NcclClique : public Lockable<NcclCliqueCommunicators, NcclCliqueName> {
   NcclCliqueCommunicators::AsyncErrorChecker async_error_checker_;
 };
 
+// Returns true if new NCCL cliques can be created by splitting communicators of
+// already acquired cliques (see `xla_gpu_enable_nccl_comm_splitting`).
+bool IsNcclCommSplittingEnabled();
+
 // Acquires an shared access to a NCCL clique (NcclClique::Lock collectively
 // owned by `num_local_participants` threads). XLA uses this lock to serialize
 // execution of all collective operations sharing a `clique_id`.
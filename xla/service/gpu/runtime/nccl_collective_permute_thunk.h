@@ -100,6 +100,9 @@ class NcclCollectivePermuteStartThunk : public NcclCollectiveThunk {
 
   static const char* GetHloOpName() { return "collective-permute-start"; }
 
+  const NcclP2PConfig& p2p_config() const { return config_; }
+  const Buffer& buffer() const { return buffer_; }
+
  protected:
   const NcclCollectiveConfig& config() const override { return config_.config; }
   absl::Status RunNcclCollective(const ExecuteParams& params,
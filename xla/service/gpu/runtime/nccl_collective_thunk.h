@@ -232,6 +232,11 @@ class NcclCollectiveDoneThunk : public Thunk {
 
   absl::Status ExecuteOnStream(const ExecuteParams& params) override;
 
+  // Events of the start thunk that this thunk waits for.
+  std::shared_ptr<NcclCollectiveThunk::AsyncEvents> async_events() const {
+    return async_events_;
+  }
+
   // return the execution stream id wheer previous async operator was launched
   // to.
   ExecutionStreamId nccl_execution_stream_id() const {
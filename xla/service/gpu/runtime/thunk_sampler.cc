@@ -0,0 +1,105 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/runtime/thunk_sampler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tsl/platform/logging.h"
+#include "tsl/profiler/protobuf/profiled_instructions.pb.h"
+
+namespace xla::gpu {
+
+ThunkSampler::ThunkSampler(int64_t sampling_period, size_t capacity)
+    : sampling_period_(sampling_period), capacity_(capacity) {
+  CHECK_GT(sampling_period_, 0) << "Sampling period must be positive";
+  CHECK_GT(capacity_, 0) << "Ring buffer capacity must be positive";
+  samples_.reserve(capacity_);
+}
+
+bool ThunkSampler::ShouldSample() {
+  return num_executions_.fetch_add(1, std::memory_order_relaxed) %
+             sampling_period_ ==
+         0;
+}
+
+void ThunkSampler::AddSample(Sample sample) {
+  absl::MutexLock lock(&mu_);
+  if (samples_.size() < capacity_) {
+    samples_.push_back(std::move(sample));
+  } else {
+    samples_[next_sample_] = std::move(sample);
+  }
+  next_sample_ = (next_sample_ + 1) % capacity_;
+}
+
+std::vector<ThunkSampler::Sample> ThunkSampler::GetSamples() const {
+  absl::MutexLock lock(&mu_);
+  std::vector<Sample> samples;
+  samples.reserve(samples_.size());
+
+  // Once the ring buffer is full the oldest sample is the one that will be
+  // overwritten next.
+  size_t oldest = samples_.size() < capacity_ ? 0 : next_sample_;
+  for (size_t i = 0; i < samples_.size(); ++i) {
+    samples.push_back(samples_[(oldest + i) % samples_.size()]);
+  }
+  return samples;
+}
+
+absl::flat_hash_map<std::string, ThunkSampler::OpStats>
+ThunkSampler::GetOpStats() const {
+  absl::MutexLock lock(&mu_);
+  absl::flat_hash_map<std::string, OpStats> stats;
+  for (const Sample& sample : samples_) {
+    OpStats& op_stats = stats[sample.profile_annotation];
+    op_stats.num_samples++;
+    op_stats.total_device_time += sample.device_time;
+    op_stats.max_device_time =
+        std::max(op_stats.max_device_time, sample.device_time);
+  }
+  return stats;
+}
+
+tensorflow::profiler::ProfiledInstructionsProto
+ThunkSampler::GetProfiledInstructions() const {
+  absl::flat_hash_map<std::string, OpStats> stats = GetOpStats();
+
+  // Sort operations by name to produce a deterministic profile.
+  std::vector<std::pair<std::string, OpStats>> sorted_stats(stats.begin(),
+                                                            stats.end());
+  absl::c_sort(sorted_stats,
+               [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  tensorflow::profiler::ProfiledInstructionsProto profile;
+  for (const auto& [name, op_stats] : sorted_stats) {
+    auto* cost = profile.add_costs();
+    cost->set_name(name);
+    cost->set_cost_us(absl::ToDoubleMicroseconds(op_stats.total_device_time) /
+                      op_stats.num_samples);
+  }
+  return profile;
+}
+
+}  // namespace xla::gpu
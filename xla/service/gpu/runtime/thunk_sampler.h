@@ -0,0 +1,91 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_RUNTIME_THUNK_SAMPLER_H_
+#define XLA_SERVICE_GPU_RUNTIME_THUNK_SAMPLER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "tsl/profiler/protobuf/profiled_instructions.pb.h"
+
+namespace xla::gpu {
+
+// Thunk sampler records device execution time of a sampled subset of thunk
+// executions, so that slow kernels can be detected in production jobs without
+// running a profiler. Every `sampling_period`-th thunk execution is timed, and
+// the most recent `capacity` samples are kept in a ring buffer.
+//
+// Thunks are timed on the stream they were launched on, so work that a thunk
+// offloads to other streams (i.e. asynchronous collectives) is not included in
+// its device time.
+class ThunkSampler {
+ public:
+  struct Sample {
+    std::string profile_annotation;
+    Thunk::Kind kind;
+    absl::Duration device_time;
+  };
+
+  // Device time statistics aggregated for a single HLO operation.
+  struct OpStats {
+    int64_t num_samples = 0;
+    absl::Duration total_device_time;
+    absl::Duration max_device_time;
+  };
+
+  ThunkSampler(int64_t sampling_period, size_t capacity);
+
+  // Returns true if the next thunk execution should be timed.
+  bool ShouldSample();
+
+  void AddSample(Sample sample);
+
+  // Returns samples currently stored in the ring buffer from oldest to newest.
+  std::vector<Sample> GetSamples() const;
+
+  // Returns device time statistics of stored samples keyed by the profile
+  // annotation (HLO operation name) of sampled thunks.
+  absl::flat_hash_map<std::string, OpStats> GetOpStats() const;
+
+  // Returns the mean device time of stored samples per HLO operation in the
+  // format consumed by the profile guided latency estimator.
+  tensorflow::profiler::ProfiledInstructionsProto GetProfiledInstructions()
+      const;
+
+  int64_t sampling_period() const { return sampling_period_; }
+
+ private:
+  const int64_t sampling_period_;
+  const size_t capacity_;
+
+  std::atomic<int64_t> num_executions_{0};
+
+  mutable absl::Mutex mu_;
+  std::vector<Sample> samples_ ABSL_GUARDED_BY(mu_);
+  size_t next_sample_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace xla::gpu
+
+#endif  // XLA_SERVICE_GPU_RUNTIME_THUNK_SAMPLER_H_
@@ -0,0 +1,88 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/runtime/thunk_sampler.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "tsl/platform/test.h"
+#include "tsl/profiler/protobuf/profiled_instructions.pb.h"
+
+namespace xla::gpu {
+namespace {
+
+ThunkSampler::Sample MakeSample(std::string name, int64_t micros) {
+  return ThunkSampler::Sample{std::move(name), Thunk::kKernel,
+                              absl::Microseconds(micros)};
+}
+
+TEST(ThunkSamplerTest, SamplesEveryNthExecution) {
+  ThunkSampler sampler(/*sampling_period=*/3, /*capacity=*/8);
+
+  std::vector<bool> sampled;
+  for (int i = 0; i < 7; ++i) sampled.push_back(sampler.ShouldSample());
+
+  EXPECT_EQ(sampled, std::vector<bool>({true, false, false, true, false,
+                                        false, true}));
+}
+
+TEST(ThunkSamplerTest, RingBufferKeepsMostRecentSamples) {
+  ThunkSampler sampler(/*sampling_period=*/1, /*capacity=*/2);
+  sampler.AddSample(MakeSample("a", 1));
+  sampler.AddSample(MakeSample("b", 2));
+  sampler.AddSample(MakeSample("c", 3));
+
+  std::vector<ThunkSampler::Sample> samples = sampler.GetSamples();
+  ASSERT_EQ(samples.size(), 2);
+  EXPECT_EQ(samples[0].profile_annotation, "b");
+  EXPECT_EQ(samples[1].profile_annotation, "c");
+}
+
+TEST(ThunkSamplerTest, AggregatesDeviceTimePerOp) {
+  ThunkSampler sampler(/*sampling_period=*/1, /*capacity=*/8);
+  sampler.AddSample(MakeSample("fusion", 10));
+  sampler.AddSample(MakeSample("gemm", 5));
+  sampler.AddSample(MakeSample("fusion", 30));
+
+  auto stats = sampler.GetOpStats();
+  ASSERT_EQ(stats.size(), 2);
+  EXPECT_EQ(stats["fusion"].num_samples, 2);
+  EXPECT_EQ(stats["fusion"].total_device_time, absl::Microseconds(40));
+  EXPECT_EQ(stats["fusion"].max_device_time, absl::Microseconds(30));
+  EXPECT_EQ(stats["gemm"].num_samples, 1);
+}
+
+TEST(ThunkSamplerTest, ConvertsSamplesToProfile) {
+  ThunkSampler sampler(/*sampling_period=*/1, /*capacity=*/8);
+  sampler.AddSample(MakeSample("gemm", 5));
+  sampler.AddSample(MakeSample("fusion", 10));
+  sampler.AddSample(MakeSample("fusion", 30));
+
+  tensorflow::profiler::ProfiledInstructionsProto profile =
+      sampler.GetProfiledInstructions();
+  ASSERT_EQ(profile.costs_size(), 2);
+  EXPECT_EQ(profile.costs(0).name(), "fusion");
+  EXPECT_DOUBLE_EQ(profile.costs(0).cost_us(), 20.0);
+  EXPECT_EQ(profile.costs(1).name(), "gemm");
+  EXPECT_DOUBLE_EQ(profile.costs(1).cost_us(), 5.0);
+}
+
+}  // namespace
+}  // namespace xla::gpu
@@ -122,6 +122,12 @@ absl::Status WhileThunk::ExecuteOnStream(const ExecuteParams& params) {
     TF_RETURN_IF_ERROR(condition_thunk_sequence_->ExecuteOnStream(params));
 
     // Copy the result of condition computation and break the loop if 'false'.
+    //
+    // TODO: Loops that can't be lowered to a WhileCmd still block the host on
+    // every iteration here. Add a speculative mode that enqueues several
+    // iterations ahead behind a device-side guard that turns the remaining
+    // iterations into no-ops once the predicate is false. That needs thunks
+    // that can be predicated on a device value.
     TF_RETURN_IF_ERROR(
         stream.Memcpy(condition_result, condition_result_data, sizeof(bool)));
 
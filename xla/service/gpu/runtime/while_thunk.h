@@ -42,7 +42,9 @@ namespace gpu {
 //   init, condition.parameter, body.parameter, body.root, while.result
 //
 // WhileThunk synchronizes the stream to test the result of the 'condition'
-// computation.
+// computation. Loops that are captured into command buffers (see CONDITIONALS
+// in `xla_gpu_enable_command_buffer`) are lowered to WhileCmd instead, which
+// tests the condition on device without host round-trips.
 //
 // If `trip_count` is available it means that the while loop trip count is known
 // statically and while loop is actually a for loop, and in this case at run
@@ -12,8 +12,12 @@ limitations under the License.
 
 #include "xla/service/gpu/softmax_rewriter_triton.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -25,6 +29,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -329,6 +334,140 @@ HloInstruction* FindFirstNonFusibleDiamondProducer(
   return diamond_producer;
 }
 
+// A diamond whose root combines the producer with the results of several,
+// possibly dependent, reductions along the last axis, e.g. the mean and the
+// variance of a layer normalization. `instructions` are all the instructions
+// between the root (included) and the producer (excluded), except for splat
+// constants and supported broadcasts of parameters.
+struct MultiReductionDiamond {
+  HloInstruction* producer;
+  absl::flat_hash_set<HloInstruction*> instructions;
+};
+
+// Matches a multi reduction diamond rooted at `root`. All row-shaped values
+// must be computed by elementwise operations from a single producer, from
+// splats, or from broadcasts of reduced rows, and all reduced-row-shaped values
+// must be computed by elementwise operations from reductions of row-shaped
+// values. Every instruction except the root must only be used within the
+// diamond, so that each row of the producer is read from memory once.
+std::variant<FusionDecision, MultiReductionDiamond>
+MatchesTritonCompatibleMultiReductionDiamond(
+    HloInstruction* root, const se::GpuComputeCapability& gpu_version) {
+  if (!root->IsElementwiseBinary() || !HasDefaultLayout(root->shape()) ||
+      root->shape().rank() == 0) {
+    return "Root is not a non-scalar elementwise binary op.";
+  }
+
+  int64_t last_dim = root->shape().rank() - 1;
+  absl::Span<const int64_t> row_dims = root->shape().dimensions();
+  absl::Span<const int64_t> reduced_row_dims =
+      row_dims.subspan(0, row_dims.size() - 1);
+  auto is_row = [&](const HloInstruction* instr) {
+    return instr->shape().IsArray() &&
+           instr->shape().dimensions() == row_dims;
+  };
+  auto is_reduced_row = [&](const HloInstruction* instr) {
+    return instr->shape().IsArray() &&
+           instr->shape().dimensions() == reduced_row_dims;
+  };
+  auto is_supported = [&](const HloInstruction* instr) {
+    return HasDefaultLayout(instr->shape()) &&
+           static_cast<bool>(legacy_triton::IsTritonSupportedInstruction(
+               *instr, gpu_version));
+  };
+
+  // Row-shaped instructions that are used outside of the diamond and must be
+  // treated as producers.
+  absl::flat_hash_set<HloInstruction*> forced_producers;
+
+  while (true) {
+    MultiReductionDiamond diamond{/*producer=*/nullptr, {}};
+    int64_t num_reductions = 0;
+
+    std::vector<HloInstruction*> worklist = {root};
+    absl::flat_hash_set<HloInstruction*> visited;
+    while (!worklist.empty()) {
+      HloInstruction* instr = worklist.back();
+      worklist.pop_back();
+      if (!visited.insert(instr).second) continue;
+
+      bool is_producer = false;
+      if (instr != root && forced_producers.contains(instr)) {
+        is_producer = true;
+      } else if (IsBroadcastOfScalarConstant(*instr) ||
+                 IsSupportedBroadcastOfParameter(*instr) ||
+                 (instr->opcode() == HloOpcode::kConstant &&
+                  ShapeUtil::IsScalar(instr->shape()))) {
+        continue;
+      } else if (is_row(instr)) {
+        if (instr->opcode() == HloOpcode::kBroadcast &&
+            is_reduced_row(instr->operand(0)) &&
+            HasDefaultLayout(instr->shape()) &&
+            !absl::c_linear_search(instr->dimensions(), last_dim)) {
+          diamond.instructions.insert(instr);
+        } else if (instr->IsElementwise() && is_supported(instr)) {
+          diamond.instructions.insert(instr);
+        } else {
+          is_producer = true;
+        }
+      } else if (is_reduced_row(instr)) {
+        if (instr->opcode() == HloOpcode::kReduce &&
+            instr->operand_count() == 2 && is_row(instr->operand(0)) &&
+            instr->dimensions().size() == 1 &&
+            instr->dimensions(0) == last_dim &&
+            is_supported(instr)) {
+          ++num_reductions;
+          diamond.instructions.insert(instr);
+        } else if (instr->IsElementwise() && is_supported(instr)) {
+          diamond.instructions.insert(instr);
+        } else {
+          return "Unsupported instruction on reduced rows.";
+        }
+      } else {
+        return "Unsupported instruction shape.";
+      }
+
+      if (is_producer) {
+        if (diamond.producer != nullptr && diamond.producer != instr) {
+          return "Rows are read from more than one producer.";
+        }
+        diamond.producer = instr;
+        continue;
+      }
+      for (HloInstruction* operand : instr->mutable_operands()) {
+        worklist.push_back(operand);
+      }
+    }
+
+    if (diamond.producer == nullptr || num_reductions == 0) {
+      return "Could not find a producer with reductions along the last axis.";
+    }
+    if (!HasDefaultLayout(diamond.producer->shape())) {
+      return "Producer has non-default layout.";
+    }
+
+    // Look for instructions with users outside of the diamond. Row-shaped
+    // elementwise instructions may still become the producer of the diamond.
+    HloInstruction* used_outside = nullptr;
+    for (HloInstruction* instr : diamond.instructions) {
+      if (instr == root) continue;
+      if (absl::c_any_of(instr->users(), [&](HloInstruction* user) {
+            return !diamond.instructions.contains(user);
+          })) {
+        used_outside = instr;
+        break;
+      }
+    }
+    if (used_outside == nullptr) {
+      return diamond;
+    }
+    if (!is_row(used_outside) || !used_outside->IsElementwise()) {
+      return "Intermediate result is used outside of the diamond.";
+    }
+    forced_producers.insert(used_outside);
+  }
+}
+
 // Creates a fusion corresponding to the input diamond chain. The resulting
 // fusion instruction is added to the module, but is not yet inserted into the
 // graph as a replacement of the original instructions.
@@ -519,6 +658,9 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
     HloModule& module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) const {
   std::vector<DiamondChainDescriptor> matched_diamonds;
+  // Instructions of the matched multi reduction diamonds, keyed by root.
+  absl::flat_hash_map<HloInstruction*, absl::flat_hash_set<HloInstruction*>>
+      multi_reduction_diamonds;
 
   for (HloComputation* comp :
        module.MakeNonfusionComputations(execution_threads)) {
@@ -535,6 +677,16 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
       }
 
       auto producer = MatchesTritonCompatibleClosedReductionDiamond(instr);
+      std::optional<absl::flat_hash_set<HloInstruction*>> multi_reduction;
+      if (!std::holds_alternative<HloInstruction*>(producer)) {
+        auto multi_reduction_diamond =
+            MatchesTritonCompatibleMultiReductionDiamond(instr, gpu_version_);
+        if (auto* diamond =
+                std::get_if<MultiReductionDiamond>(&multi_reduction_diamond)) {
+          producer = diamond->producer;
+          multi_reduction = std::move(diamond->instructions);
+        }
+      }
       if (std::holds_alternative<HloInstruction*>(producer)) {
         DiamondChainDescriptor diamond_chain{
             /*root=*/instr, /*producer=*/std::get<HloInstruction*>(producer)};
@@ -544,6 +696,17 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
             bool can_tile_diamond_chain,
             CanSymbolicTileAnalysisTileDiamondChain(diamond_chain));
         if (can_tile_diamond_chain) {
+          if (multi_reduction.has_value()) {
+            // A multi reduction diamond subsumes the previously matched
+            // diamonds whose roots it contains.
+            matched_diamonds.erase(
+                std::remove_if(matched_diamonds.begin(), matched_diamonds.end(),
+                               [&](const DiamondChainDescriptor& matched) {
+                                 return multi_reduction->contains(matched.root);
+                               }),
+                matched_diamonds.end());
+            multi_reduction_diamonds[instr] = *std::move(multi_reduction);
+          }
           matched_diamonds.push_back(diamond_chain);
         } else {
           VLOG(5) << "Cannot tile the diamond pattern described by "
@@ -565,7 +728,12 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
   }
 
   auto reduction_dimension_size_from_diamond_root =
-      [](HloInstruction* diamond_root) {
+      [&](HloInstruction* diamond_root) {
+        // All reductions of a multi reduction diamond reduce rows of the root
+        // shape.
+        if (multi_reduction_diamonds.contains(diamond_root)) {
+          return diamond_root->shape().dimensions().back();
+        }
         HloInstruction* instr = diamond_root->mutable_operand(1);
         while (instr->opcode() != HloOpcode::kReduce) {
           instr = ChooseOperandForFusionProcessing(instr);
@@ -595,6 +763,17 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
     return instr;
   };
 
+  auto is_only_used_by_diamond = [&](HloInstruction* producer,
+                                     HloInstruction* diamond_root) {
+    auto it = multi_reduction_diamonds.find(diamond_root);
+    if (it == multi_reduction_diamonds.end()) {
+      return producer->user_count() == 2;
+    }
+    return absl::c_all_of(producer->users(), [&](HloInstruction* user) {
+      return it->second.contains(user);
+    });
+  };
+
   // If we matched several diamonds, it may be possible for some of them to be
   // fused together. This is the case if the following conditions hold:
   //   1. The path between the root of diamond n towards the producer of
@@ -605,7 +784,8 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
   //      have
   //        a. exactly one user if it is not exactly the producer of diamond
   //           n+1;
-  //        b/ exactly two users otherwise.
+  //        b/ only users within diamond n+1 otherwise (exactly two users for
+  //           a single reduction diamond).
   //   3. The axis being reduced must have the same length in all the diamonds
   //      being fused together.
   //
@@ -635,7 +815,7 @@ SoftmaxRewriterTriton::FindAllFusibleDiamondChains(
         ((first_non_fusible_diamond_producer != diamond_producer &&
           HasOneUse(first_non_fusible_diamond_producer)) ||  // 2.a
          (first_non_fusible_diamond_producer == diamond_producer &&
-          first_non_fusible_diamond_producer->user_count() == 2)) &&  // 2.b
+          is_only_used_by_diamond(diamond_producer, diamond_root))) &&  // 2.b
         diamond_reduce_dimension_size == current_reduce_dimension_size) {  // 3
       continue;
     }
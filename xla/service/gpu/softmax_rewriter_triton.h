@@ -40,7 +40,9 @@ struct DiamondChainDescriptor {
 using DiamondMatchingDecision = std::variant<FusionDecision, HloInstruction*>;
 
 // Rewrite compatible Softmax into a custom fusion region to be code-generated
-// with the Triton-based Softmax emitter.
+// with the Triton-based Softmax emitter. Row normalizations whose reductions
+// depend on each other or share an input (e.g. layer norm computing the
+// variance as mean(x * x) - mean(x)^2) are fused into a single region as well.
 class SoftmaxRewriterTriton : public HloModulePass {
  public:
   explicit SoftmaxRewriterTriton(se::GpuComputeCapability gpu_version)
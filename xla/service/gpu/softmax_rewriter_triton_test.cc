@@ -2050,6 +2050,84 @@ ENTRY main {
       SoftmaxRewriterTritonMatchAndRewrite(gpu_version_, module.get()).value());
 }
 
+TEST_F(SoftmaxRewriterTritonTest, CanFuseLayerNormWithSiblingReductions) {
+  const std::string hlo_string = R"(
+HloModule layer_norm
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+ENTRY main {
+  param_0 = f32[64,256]{1,0} parameter(0)
+  constant_0 = f32[] constant(0)
+  reduce_x = f32[64]{0} reduce(param_0, constant_0), dimensions={1}, to_apply=add_computation
+  constant_n = f32[] constant(0.00390625)
+  splat_n = f32[64]{0} broadcast(constant_n), dimensions={}
+  mean = f32[64]{0} multiply(reduce_x, splat_n)
+  square = f32[64,256]{1,0} multiply(param_0, param_0)
+  reduce_square = f32[64]{0} reduce(square, constant_0), dimensions={1}, to_apply=add_computation
+  mean_square = f32[64]{0} multiply(reduce_square, splat_n)
+  mean_squared = f32[64]{0} multiply(mean, mean)
+  variance = f32[64]{0} subtract(mean_square, mean_squared)
+  epsilon = f32[] constant(1e-05)
+  splat_epsilon = f32[64]{0} broadcast(epsilon), dimensions={}
+  add_epsilon = f32[64]{0} add(variance, splat_epsilon)
+  rsqrt = f32[64]{0} rsqrt(add_epsilon)
+  broadcast_mean = f32[64,256]{1,0} broadcast(mean), dimensions={0}
+  centered = f32[64,256]{1,0} subtract(param_0, broadcast_mean)
+  broadcast_rsqrt = f32[64,256]{1,0} broadcast(rsqrt), dimensions={0}
+  ROOT normalized = f32[64,256]{1,0} multiply(centered, broadcast_rsqrt)
+})";
+  auto module = ParseAndReturnVerifiedModule(hlo_string).value();
+  EXPECT_TRUE(
+      SoftmaxRewriterTritonMatchAndRewrite(gpu_version_, module.get()).value());
+  EXPECT_TRUE(verifier().Run(module.get()).status().ok());
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Fusion(m::Parameter())));
+}
+
+TEST_F(SoftmaxRewriterTritonTest,
+       DoesNotFuseLayerNormIfReducedValueHasUsersOutsideOfTheNormalization) {
+  const std::string hlo_string = R"(
+HloModule layer_norm
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+ENTRY main {
+  param_0 = f32[64,256]{1,0} parameter(0)
+  constant_0 = f32[] constant(0)
+  reduce_x = f32[64]{0} reduce(param_0, constant_0), dimensions={1}, to_apply=add_computation
+  constant_n = f32[] constant(0.00390625)
+  splat_n = f32[64]{0} broadcast(constant_n), dimensions={}
+  mean = f32[64]{0} multiply(reduce_x, splat_n)
+  square = f32[64,256]{1,0} multiply(param_0, param_0)
+  reduce_square = f32[64]{0} reduce(square, constant_0), dimensions={1}, to_apply=add_computation
+  mean_square = f32[64]{0} multiply(reduce_square, splat_n)
+  mean_squared = f32[64]{0} multiply(mean, mean)
+  variance = f32[64]{0} subtract(mean_square, mean_squared)
+  epsilon = f32[] constant(1e-05)
+  splat_epsilon = f32[64]{0} broadcast(epsilon), dimensions={}
+  add_epsilon = f32[64]{0} add(variance, splat_epsilon)
+  rsqrt = f32[64]{0} rsqrt(add_epsilon)
+  broadcast_mean = f32[64,256]{1,0} broadcast(mean), dimensions={0}
+  centered = f32[64,256]{1,0} subtract(param_0, broadcast_mean)
+  broadcast_rsqrt = f32[64,256]{1,0} broadcast(rsqrt), dimensions={0}
+  normalized = f32[64,256]{1,0} multiply(centered, broadcast_rsqrt)
+  ROOT tuple = (f32[64,256]{1,0}, f32[64]{0}) tuple(normalized, variance)
+})";
+  auto module = ParseAndReturnVerifiedModule(hlo_string).value();
+  ASSERT_TRUE(
+      SoftmaxRewriterTritonMatchAndRewrite(gpu_version_, module.get()).ok());
+  EXPECT_TRUE(verifier().Run(module.get()).status().ok());
+  // The variance is returned from the entry computation, so the two
+  // reductions can not be fused into a single normalization.
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Tuple(m::Op(), m::Subtract())));
+}
+
 INSTANTIATE_TEST_SUITE_P(SoftmaxRewriterTritonTestSuite,
                          SoftmaxRewriterTritonTest,
                          ::testing::Values(F32, F16, BF16));
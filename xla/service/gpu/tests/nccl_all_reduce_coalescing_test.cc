@@ -0,0 +1,170 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "xla/service/executable.h"
+#include "xla/service/gpu/gpu_executable.h"
+#include "xla/service/gpu/runtime/nccl_all_reduce_thunk.h"
+#include "xla/service/gpu/runtime/nccl_collective_thunk.h"
+#include "xla/service/gpu/runtime/thunk.h"
+#include "xla/service/gpu/tests/gpu_codegen_test.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+// Two all-reduce starts followed by their dones. $0 and $1 are appended to the
+// attributes of the first and the second start.
+constexpr absl::string_view kHloTemplate = R"(
+HloModule m, is_scheduled=true
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+ENTRY e {
+  p0 = f32[8] parameter(0)
+  p1 = f32[16] parameter(1)
+  ar0 = f32[8] all-reduce-start(p0), to_apply=add, replica_groups={{0,1,2,3}}$0
+  ar1 = f32[16] all-reduce-start(p1), to_apply=add, replica_groups={{0,1,2,3}}$1
+  d0 = f32[8] all-reduce-done(ar0)
+  d1 = f32[16] all-reduce-done(ar1)
+  ROOT t = (f32[8], f32[16]) tuple(d0, d1)
+})";
+
+class NcclAllReduceCoalescingTest : public GpuCodegenTest {
+ protected:
+  // Compiles `hlo` for four replicas and returns its all-reduce thunks.
+  absl::StatusOr<std::vector<const Thunk*>> CompileAllReduceThunks(
+      absl::string_view hlo, bool coalescing) {
+    HloModuleConfig config = GetModuleConfigForTest(/*replica_count=*/4);
+    DebugOptions debug_options = GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_nccl_all_reduce_coalescing(coalescing);
+    config.set_debug_options(debug_options);
+    TF_ASSIGN_OR_RETURN(auto module, ParseAndReturnVerifiedModule(hlo, config));
+    TF_ASSIGN_OR_RETURN(executable_, backend().compiler()->RunBackend(
+                                         std::move(module),
+                                         backend().default_stream_executor(),
+                                         backend().memory_allocator()));
+
+    std::vector<const Thunk*> thunks;
+    for (const auto& thunk :
+         static_cast<GpuExecutable*>(executable_.get())->thunks()) {
+      if (thunk->kind() == Thunk::kNcclAllReduceStart ||
+          thunk->kind() == Thunk::kNcclAllReduceDone) {
+        thunks.push_back(thunk.get());
+      }
+    }
+    return thunks;
+  }
+
+  std::unique_ptr<Executable> executable_;
+};
+
+TEST_F(NcclAllReduceCoalescingTest, DisabledByDefault) {
+  EXPECT_FALSE(
+      GetDebugOptionsForTest().xla_gpu_enable_nccl_all_reduce_coalescing());
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<const Thunk*> thunks,
+      CompileAllReduceThunks(absl::Substitute(kHloTemplate, "", ""),
+                             /*coalescing=*/false));
+  ASSERT_EQ(thunks.size(), 4);
+  EXPECT_EQ(thunks[0]->kind(), Thunk::kNcclAllReduceStart);
+  EXPECT_EQ(thunks[1]->kind(), Thunk::kNcclAllReduceStart);
+}
+
+TEST_F(NcclAllReduceCoalescingTest, CoalescesAdjacentAsyncAllReduces) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<const Thunk*> thunks,
+      CompileAllReduceThunks(absl::Substitute(kHloTemplate, "", ""),
+                             /*coalescing=*/true));
+  ASSERT_EQ(thunks.size(), 3);
+  ASSERT_EQ(thunks[0]->kind(), Thunk::kNcclAllReduceStart);
+  ASSERT_EQ(thunks[1]->kind(), Thunk::kNcclAllReduceDone);
+  ASSERT_EQ(thunks[2]->kind(), Thunk::kNcclAllReduceDone);
+
+  // The merged start launches both operations and keeps both annotations.
+  auto* start = static_cast<const NcclAllReduceStartThunk*>(thunks[0]);
+  EXPECT_EQ(start->profile_annotation(), "ar0,ar1");
+  EXPECT_EQ(start->buffers().size(), 2);
+  EXPECT_EQ(start->buffers()[0].element_count, 8);
+  EXPECT_EQ(start->buffers()[1].element_count, 16);
+
+  // Both dones wait for the events recorded after the whole NCCL group, i.e.
+  // the first done also waits for the second reduction.
+  ASSERT_NE(start->async_events(), nullptr);
+  EXPECT_EQ(static_cast<const NcclCollectiveDoneThunk*>(thunks[1])
+                ->async_events(),
+            start->async_events());
+  EXPECT_EQ(static_cast<const NcclCollectiveDoneThunk*>(thunks[2])
+                ->async_events(),
+            start->async_events());
+}
+
+TEST_F(NcclAllReduceCoalescingTest, DoesNotCoalesceMismatchedReplicaGroups) {
+  std::string hlo = absl::Substitute(kHloTemplate, "", "");
+  // Two groups of two replicas each for the second all-reduce.
+  hlo.replace(hlo.rfind("{{0,1,2,3}}"), 11, "{{0,1},{2,3}}");
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<const Thunk*> thunks,
+                          CompileAllReduceThunks(hlo, /*coalescing=*/true));
+  ASSERT_EQ(thunks.size(), 4);
+  EXPECT_EQ(thunks[0]->kind(), Thunk::kNcclAllReduceStart);
+  EXPECT_EQ(thunks[1]->kind(), Thunk::kNcclAllReduceStart);
+  EXPECT_EQ(thunks[0]->profile_annotation(), "ar0");
+  EXPECT_EQ(thunks[1]->profile_annotation(), "ar1");
+}
+
+TEST_F(NcclAllReduceCoalescingTest, DoesNotCoalesceDifferentStreams) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<const Thunk*> thunks,
+      CompileAllReduceThunks(
+          absl::Substitute(kHloTemplate, "",
+                           R"(, backend_config={"operation_queue_id":"1"})"),
+          /*coalescing=*/true));
+  ASSERT_EQ(thunks.size(), 4);
+  EXPECT_EQ(thunks[0]->kind(), Thunk::kNcclAllReduceStart);
+  EXPECT_EQ(thunks[1]->kind(), Thunk::kNcclAllReduceStart);
+  EXPECT_NE(thunks[0]->execution_stream_id(), thunks[1]->execution_stream_id());
+}
+
+TEST_F(NcclAllReduceCoalescingTest, DoesNotCoalesceSyncAllReduces) {
+  constexpr absl::string_view kSync =
+      R"(, backend_config={"collective_backend_config":{"is_sync":true}})";
+  for (auto [first, second] : {std::pair(kSync, absl::string_view()),
+                               std::pair(absl::string_view(), kSync),
+                               std::pair(kSync, kSync)}) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::vector<const Thunk*> thunks,
+        CompileAllReduceThunks(absl::Substitute(kHloTemplate, first, second),
+                               /*coalescing=*/true));
+    ASSERT_EQ(thunks.size(), 4);
+    EXPECT_EQ(thunks[0]->kind(), Thunk::kNcclAllReduceStart);
+    EXPECT_EQ(thunks[1]->kind(), Thunk::kNcclAllReduceStart);
+  }
+}
+
+}  // namespace
+}  // namespace xla::gpu
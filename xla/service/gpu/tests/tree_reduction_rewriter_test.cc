@@ -18,6 +18,7 @@ limitations under the License.
 #include <optional>
 
 #include "absl/strings/string_view.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
 #include "xla/stream_executor/device_description.h"
 #include "xla/tests/hlo_test_base.h"
 #include "tsl/platform/test.h"
@@ -533,5 +534,59 @@ ENTRY main {
       )");
 }
 
+TEST_F(TreeReductionRewriterTest, ColumnReductionSplitToFillDevice) {
+  const char* hlo = R"(
+HloModule ReduceTallColumn
+
+add {
+  accum = f32[] parameter(0)
+  op = f32[] parameter(1)
+  ROOT out = f32[] add(accum, op)
+}
+
+ENTRY main {
+  input = f32[4096,32] parameter(0)
+  zero = f32[] constant(0)
+  ROOT out = f32[32] reduce(input, zero), dimensions={0}, to_apply=add
+}
+)";
+
+  // The reduction is race free, but only launches a single block. It is split
+  // as far as possible while keeping 256 rows per block.
+  RunAndFilecheckHloRewrite(
+      hlo,
+      gpu::GpuTreeReductionRewriter{
+          gpu::TestGpuDeviceInfo::RTXA6000DeviceInfo()},
+      R"(
+// CHECK:  [[bitcast_0:%[^ ]+]] = f32[16,256,32]{2,1,0} bitcast([[input_1:%[^ ]+]])
+// CHECK:  [[reduce_2:%[^ ]+]] = f32[16,32]{1,0} reduce([[bitcast_0]], [[zero_3:%[^ ]+]]), dimensions={1}, to_apply=[[add_4:%[^ ]+]]
+// CHECK:  ROOT [[out_1_5:%[^ ]+]] = f32[32]{0} reduce([[reduce_2]], [[zero_3]]), dimensions={0}, to_apply=[[add_4]]
+      )");
+}
+
+TEST_F(TreeReductionRewriterTest, ColumnReductionFillingDeviceIsNotSplit) {
+  const char* hlo = R"(
+HloModule ReduceWideColumn
+
+add {
+  accum = f32[] parameter(0)
+  op = f32[] parameter(1)
+  ROOT out = f32[] add(accum, op)
+}
+
+ENTRY main {
+  input = f32[4096,8192] parameter(0)
+  zero = f32[] constant(0)
+  ROOT out = f32[8192] reduce(input, zero), dimensions={0}, to_apply=add
+}
+)";
+
+  RunAndFilecheckHloRewrite(
+      hlo,
+      gpu::GpuTreeReductionRewriter{
+          gpu::TestGpuDeviceInfo::RTXA6000DeviceInfo()},
+      std::nullopt);
+}
+
 }  // namespace
 }  // namespace xla
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "xla/service/gpu/tree_reduction_rewriter.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <memory>
@@ -38,6 +39,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/collective_ops_utils.h"
+#include "xla/service/gpu/ir_emission_utils.h"
 #include "xla/service/gpu/reduction_utils.h"
 #include "xla/shape.h"
 #include "xla/shape_util.h"
@@ -51,8 +53,10 @@ namespace gpu {
 
 class ReductionRewriterVisitor : public DfsHloRewriteVisitor {
  public:
-  explicit ReductionRewriterVisitor(se::GpuComputeCapability gpu_version)
-      : gpu_version_(gpu_version) {}
+  ReductionRewriterVisitor(se::GpuComputeCapability gpu_version,
+                           int64_t num_blocks_to_fill_device)
+      : gpu_version_(gpu_version),
+        num_blocks_to_fill_device_(num_blocks_to_fill_device) {}
 
   absl::Status HandleReduce(HloInstruction *hlo) override {
     // MLIR emitters only support race-free reductions.
@@ -149,14 +153,24 @@ class ReductionRewriterVisitor : public DfsHloRewriteVisitor {
     }
     bool is_row_reduction = reduction_dimensions.is_row_reduction;
 
+    int64_t n = input_shape_dims[reduced_input_dimension];
+
     // Base case: everything fits.
     if (ReductionIsRaceFree(hlo->GetModule()->config(), reduction_dimensions)) {
+      if (std::optional<uint64_t> k = GetOccupancySplitFactor(
+              reduction_dimensions, n, reduce_batch_dimension)) {
+        VLOG(1) << "Splitting column reduction by " << *k
+                << " to fill the device: " << hlo->ToString();
+        uint64_t padded_n = CeilOfRatio<uint64_t>(n, *k) * *k;
+        return SplitReducedDimension(reduce, reduced_input_dimension, *k,
+                                     padded_n, is_row_reduction,
+                                     reduce_batch_dimension);
+      }
       VLOG(3) << "Base case: dimensions fit";
       return absl::OkStatus();
     }
 
     VLOG(1) << "Input: " << hlo->ToString();
-    int64_t n = input_shape_dims[reduced_input_dimension];
     VLOG(3) << "n = " << n;
 
     // We will do this reduction in two stages.  The first will reduce from n
@@ -208,6 +222,69 @@ class ReductionRewriterVisitor : public DfsHloRewriteVisitor {
             best_k, best_n_div_k, n, race_free_bound, is_row_reduction)) {
       std::swap(best_k, best_n_div_k);
     }
+    return SplitReducedDimension(reduce, reduced_input_dimension, best_k,
+                                 padded_n, is_row_reduction,
+                                 reduce_batch_dimension);
+  }
+
+  // Returns the factor by which a race free column reduction should be split
+  // so that the inner reduction launches enough blocks to fill the device, or
+  // nullopt if the reduction already fills the device or is too short to be
+  // worth splitting.
+  //
+  // The column reduction emitter assigns one block of WarpSize() x WarpSize()
+  // threads to every WarpSize() kept minor elements, so tall reductions with
+  // few kept elements run on a handful of SMs. Splitting the reduced
+  // dimension into [k, n / k] multiplies the number of blocks of the inner
+  // reduction by k, and the outer reduction over k elements is cheap.
+  std::optional<uint64_t> GetOccupancySplitFactor(
+      const ReductionDimensions &reduction_dimensions, int64_t n,
+      bool reduce_batch_dimension) {
+    // Every block of the inner reduction should still loop over at least this
+    // many rows, otherwise the extra pass over the partial results dominates.
+    constexpr int64_t kMinRowsPerBlock = 256;
+    if (num_blocks_to_fill_device_ == 0 ||
+        reduction_dimensions.is_row_reduction || reduce_batch_dimension ||
+        n != reduction_dimensions
+                 .dimensions[ReductionDimensions::kColReducedDimension] ||
+        n <= 2 * kMinRowsPerBlock) {
+      return std::nullopt;
+    }
+    int64_t num_blocks =
+        reduction_dimensions
+            .dimensions[ReductionDimensions::kColMajorKeptDimension] *
+        CeilOfRatio<int64_t>(
+            reduction_dimensions
+                .dimensions[ReductionDimensions::kColMinorKeptDimension],
+            WarpSize());
+    if (num_blocks * 2 > num_blocks_to_fill_device_) {
+      return std::nullopt;
+    }
+    // Use the smallest power of two that fills the device. Capping k by
+    // n / kMinRowsPerBlock guarantees that neither of the generated
+    // reductions is split again.
+    uint64_t k = absl::bit_ceil(static_cast<uint64_t>(
+        CeilOfRatio(num_blocks_to_fill_device_, num_blocks)));
+    k = std::min(
+        k, absl::bit_floor(static_cast<uint64_t>(n / kMinRowsPerBlock)));
+    if (k < 2) {
+      return std::nullopt;
+    }
+    return k;
+  }
+
+  // Splits the reduced dimension of size n into [k, padded_n / k], padding it
+  // to padded_n elements first, and replaces `reduce` with an inner reduction
+  // over the second dimension followed by an outer reduction over k.
+  absl::Status SplitReducedDimension(HloReduceInstruction *reduce,
+                                     int64_t reduced_input_dimension,
+                                     uint64_t best_k, uint64_t padded_n,
+                                     bool is_row_reduction,
+                                     bool reduce_batch_dimension) {
+    HloInstruction *hlo = reduce;
+    absl::Span<int64_t const> input_shape_dims =
+        reduce->inputs()[0]->shape().dimensions();
+    int64_t n = input_shape_dims[reduced_input_dimension];
 
     // Pad reduced dimension to the required number of elements.
     bool no_padding_necessary = n == padded_n;
@@ -343,14 +420,29 @@ class ReductionRewriterVisitor : public DfsHloRewriteVisitor {
   }
 
   se::GpuComputeCapability gpu_version_;
+  // Number of column reduction blocks needed to occupy every SM, or 0 if
+  // reductions should not be split for occupancy.
+  int64_t num_blocks_to_fill_device_;
 };
 
+GpuTreeReductionRewriter::GpuTreeReductionRewriter(
+    const se::DeviceDescription &device_description)
+    : gpu_version_(device_description.gpu_compute_capability()) {
+  // A column reduction block has WarpSize() x WarpSize() threads.
+  int64_t threads_per_block = WarpSize() * WarpSize();
+  num_blocks_to_fill_device_ =
+      device_description.core_count() *
+      std::max<int64_t>(
+          1, device_description.threads_per_core_limit() / threads_per_block);
+}
+
 absl::StatusOr<bool> GpuTreeReductionRewriter::Run(
     HloModule *module,
     const absl::flat_hash_set<absl::string_view> &execution_threads) {
   VLOG(5) << "Rewriter input: " << module->ToString();
   TF_ASSIGN_OR_RETURN(bool changed,
-                      ReductionRewriterVisitor(gpu_version_)
+                      ReductionRewriterVisitor(gpu_version_,
+                                               num_blocks_to_fill_device_)
                           .RunOnModule(module, execution_threads));
   VLOG(5) << "Rewriter output: " << module->ToString();
   return changed;
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_TREE_REDUCTION_REWRITER_H_
 #define XLA_SERVICE_GPU_TREE_REDUCTION_REWRITER_H_
 
+#include <cstdint>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
@@ -74,11 +75,18 @@ namespace gpu {
 // f32[A, Q, C] inner_reduce = reduce(reshaped, dimensions={2})
 // f32[A, C] outer_reduce = reduce(inner_reduce, dimensions={1})
 //
+// When constructed with a device description, race free column reductions
+// that launch too few blocks to occupy every SM are split the same way, with
+// the smallest power of two Q that fills the device.
+//
 class GpuTreeReductionRewriter : public HloModulePass {
  public:
   explicit GpuTreeReductionRewriter(se::GpuComputeCapability gpu_version)
       : gpu_version_(gpu_version) {}
 
+  explicit GpuTreeReductionRewriter(
+      const se::DeviceDescription& device_description);
+
   ~GpuTreeReductionRewriter() override = default;
   absl::string_view name() const override {
     return "gpu-tree-reduction-rewriter";
@@ -91,6 +99,7 @@ class GpuTreeReductionRewriter : public HloModulePass {
 
  private:
   se::GpuComputeCapability gpu_version_;
+  int64_t num_blocks_to_fill_device_ = 0;
 };
 
 }  // end namespace gpu
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/heap_simulator/heap_simulator.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -34,7 +35,9 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -49,6 +52,8 @@ limitations under the License.
 #include "xla/service/memory_space_assignment/repacking.h"
 #include "xla/service/time_utils.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -686,55 +691,170 @@ void GlobalDecreasingSizeBestFitHeap<BufferType>::Free(const BufferType* buffer,
 
 using Chunk = HeapSimulator::Chunk;
 
+namespace {
+
+// The interval tree is kept balanced as a scapegoat tree: a subtree is rebuilt
+// once one of its children holds more than this fraction of its nodes. This
+// bounds the depth of the tree by log(n) / log(1 / kMaxChildFraction), so that
+// the overlap queries made for every placed buffer stay logarithmic even when
+// buffers are added in order of their start times.
+constexpr double kMaxChildFraction = 0.75;
+
+int64_t SubtreeSize(const BufferIntervalTreeNode* node) {
+  int64_t size = 0;
+  absl::InlinedVector<const BufferIntervalTreeNode*, 16> visiting_stack;
+  if (node != nullptr) {
+    visiting_stack.push_back(node);
+  }
+  while (!visiting_stack.empty()) {
+    const BufferIntervalTreeNode* top = visiting_stack.back();
+    visiting_stack.pop_back();
+    ++size;
+    if (top->left != nullptr) {
+      visiting_stack.push_back(top->left);
+    }
+    if (top->right != nullptr) {
+      visiting_stack.push_back(top->right);
+    }
+  }
+  return size;
+}
+
+// Builds a balanced tree out of `nodes`, which are sorted by start time, and
+// returns its root.
+BufferIntervalTreeNode* BuildBalancedSubtree(
+    absl::Span<BufferIntervalTreeNode* const> nodes,
+    BufferIntervalTreeNode* parent) {
+  if (nodes.empty()) {
+    return nullptr;
+  }
+  size_t middle = nodes.size() / 2;
+  BufferIntervalTreeNode* node = nodes[middle];
+  node->parent = parent;
+  node->left = BuildBalancedSubtree(nodes.subspan(0, middle), node);
+  node->right = BuildBalancedSubtree(nodes.subspan(middle + 1), node);
+  node->subtree_end = node->end;
+  if (node->left != nullptr) {
+    node->subtree_end = std::max(node->subtree_end, node->left->subtree_end);
+  }
+  if (node->right != nullptr) {
+    node->subtree_end = std::max(node->subtree_end, node->right->subtree_end);
+  }
+  return node;
+}
+
+}  // namespace
+
 void BufferIntervalTree::Add(int64_t start, int64_t end, const Chunk& chunk) {
   node_storage_.emplace_back(BufferIntervalTreeNode{
       start, end, end, chunk,
       /*left=*/nullptr, /*right=*/nullptr, /*parent=*/nullptr});
+  BufferIntervalTreeNode* node = &node_storage_.back();
+  ++num_nodes_;
   if (root_ == nullptr) {
-    root_ = &node_storage_.back();
+    root_ = node;
     // This is root.
     return;
   }
 
   BufferIntervalTreeNode* parent = root_;
+  int64_t depth = 1;
   while (true) {
     parent->subtree_end = std::max(parent->subtree_end, end);
     if (parent->start > start) {
       if (parent->left == nullptr) {
-        parent->left = &node_storage_.back();
-        node_storage_.back().parent = parent;
-        return;
+        parent->left = node;
+        break;
       }
       parent = parent->left;
     } else {
       if (parent->right == nullptr) {
-        parent->right = &node_storage_.back();
-        node_storage_.back().parent = parent;
-        return;
+        parent->right = node;
+        break;
       }
       parent = parent->right;
     }
+    ++depth;
+  }
+  node->parent = parent;
+  if (depth > std::log(num_nodes_) / -std::log(kMaxChildFraction)) {
+    RebalanceAncestors(node);
+  }
+}
+
+void BufferIntervalTree::RebalanceAncestors(BufferIntervalTreeNode* node) {
+  // Find the lowest ancestor with a child that is too heavy.
+  int64_t child_size = 1;
+  for (BufferIntervalTreeNode* ancestor = node->parent; ancestor != nullptr;
+       node = ancestor, ancestor = ancestor->parent) {
+    BufferIntervalTreeNode* sibling =
+        ancestor->left == node ? ancestor->right : ancestor->left;
+    int64_t size = child_size + 1 + SubtreeSize(sibling);
+    if (child_size > kMaxChildFraction * size) {
+      RebuildSubtree(ancestor);
+      return;
+    }
+    child_size = size;
+  }
+}
+
+void BufferIntervalTree::RebuildSubtree(BufferIntervalTreeNode* subtree_root) {
+  // Collect the nodes in order of their start times.
+  std::vector<BufferIntervalTreeNode*> nodes;
+  std::vector<BufferIntervalTreeNode*> visiting_stack;
+  for (BufferIntervalTreeNode* node = subtree_root;
+       node != nullptr || !visiting_stack.empty();) {
+    if (node != nullptr) {
+      visiting_stack.push_back(node);
+      node = node->left;
+      continue;
+    }
+    node = visiting_stack.back();
+    visiting_stack.pop_back();
+    nodes.push_back(node);
+    node = node->right;
+  }
+
+  BufferIntervalTreeNode* parent = subtree_root->parent;
+  BufferIntervalTreeNode* new_root = BuildBalancedSubtree(nodes, parent);
+  if (parent == nullptr) {
+    root_ = new_root;
+  } else if (parent->left == subtree_root) {
+    parent->left = new_root;
+  } else {
+    parent->right = new_root;
   }
 }
 
 bool BufferIntervalTree::Remove(int64_t start, int64_t end,
                                 const Chunk& chunk) {
-  BufferIntervalTreeNode* to_delete = root_;
-  while (to_delete != nullptr) {
-    if (to_delete->start == start && to_delete->end == end &&
-        to_delete->chunk.offset == chunk.offset) {
+  // Rebalancing may move nodes with the same start time as a node into its
+  // left subtree, so both subtrees are searched on equal start times.
+  BufferIntervalTreeNode* to_delete = nullptr;
+  absl::InlinedVector<BufferIntervalTreeNode*, 16> visiting_stack;
+  if (root_ != nullptr) {
+    visiting_stack.push_back(root_);
+  }
+  while (!visiting_stack.empty()) {
+    BufferIntervalTreeNode* top = visiting_stack.back();
+    visiting_stack.pop_back();
+    if (top->start == start && top->end == end &&
+        top->chunk.offset == chunk.offset) {
+      to_delete = top;
       break;
     }
-    if (start < to_delete->start) {
-      to_delete = to_delete->left;
-    } else {
-      to_delete = to_delete->right;
+    if (start <= top->start && top->left != nullptr) {
+      visiting_stack.push_back(top->left);
+    }
+    if (start >= top->start && top->right != nullptr) {
+      visiting_stack.push_back(top->right);
     }
   }
   if (to_delete == nullptr) {
     // Nothing to delete.
     return false;
   }
+  --num_nodes_;
   // Found the node to be deleted, enter deletion sequence.
 
   // Recursively traverse the parents of node and fix up the `subtree_end`
@@ -776,6 +896,9 @@ bool BufferIntervalTree::Remove(int64_t start, int64_t end,
     if (root_ == to_delete) {
       // Deleting root is simply resetting root;
       root_ = to_delete->left;
+      if (root_ != nullptr) {
+        root_->parent = nullptr;
+      }
       return true;
     }
 
@@ -848,10 +971,18 @@ bool BufferIntervalTree::Remove(int64_t start, int64_t end,
 std::vector<Chunk> BufferIntervalTree::ChunksOverlappingInTime(
     int64_t start, int64_t end) const {
   std::vector<Chunk> result;
+  ForEachChunkOverlappingInTime(
+      start, end, [&](const Chunk& chunk) { result.push_back(chunk); });
+  return result;
+}
+
+void BufferIntervalTree::ForEachChunkOverlappingInTime(
+    int64_t start, int64_t end,
+    absl::FunctionRef<void(const Chunk&)> fn) const {
   if (root_ == nullptr) {
-    return result;
+    return;
   }
-  std::vector<const BufferIntervalTreeNode*> visiting_stack;
+  absl::InlinedVector<const BufferIntervalTreeNode*, 16> visiting_stack;
   visiting_stack.push_back(root_);
   while (!visiting_stack.empty()) {
     const BufferIntervalTreeNode* top = visiting_stack.back();
@@ -863,7 +994,7 @@ std::vector<Chunk> BufferIntervalTree::ChunksOverlappingInTime(
       visiting_stack.push_back(top->left);
     }
     if (top->start <= end && top->end >= start) {
-      result.push_back(top->chunk);
+      fn(top->chunk);
     }
     if (end < top->start) {
       continue;
@@ -872,7 +1003,14 @@ std::vector<Chunk> BufferIntervalTree::ChunksOverlappingInTime(
       visiting_stack.push_back(top->right);
     }
   }
-  return result;
+}
+
+int64_t BufferIntervalTree::NumChunksOverlappingInTime(int64_t start,
+                                                       int64_t end) const {
+  int64_t num_chunks = 0;
+  ForEachChunkOverlappingInTime(start, end,
+                                [&](const Chunk&) { ++num_chunks; });
+  return num_chunks;
 }
 
 template <typename BufferType>
@@ -2179,43 +2317,41 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::MakeFreeChunks(
   FreeChunks free_chunks{
       {0, INT64_MAX}};  // Initialize with "infinite" free memory.
 
-  // Subtract chunks that are in use from the free chunks.
-  auto subtract_used_chunks = [&](const std::vector<Chunk>& used_chunks) {
-    for (const Chunk& used_chunk : used_chunks) {
-      // Find the free chunks containing the start and end of the used chunk.
-      auto it_end = free_chunks.lower_bound(used_chunk.chunk_end());
-      if (it_end == free_chunks.end()) continue;
-      auto it_start = free_chunks.lower_bound(used_chunk.offset);
-
-      // Store original free chunk end, in case `it_start == it_end`.
-      int64_t free_chunk_end = it_end->second;
-
-      // Subtract from free chunk containing start of used range, removing if it
-      // becomes too small for the buffer.
-      if (it_start != free_chunks.end()) {
-        if (used_chunk.offset - it_start->first >= buffer_interval.size) {
-          it_start->second = std::min(it_start->second, used_chunk.offset);
-        } else {
-          ++it_start;  // Increment iterator so that this entry is erased
-                       // below.
-        }
+  // Subtract a chunk that is in use from the free chunks.
+  auto subtract_used_chunk = [&](const Chunk& used_chunk) {
+    // Find the free chunks containing the start and end of the used chunk.
+    auto it_end = free_chunks.lower_bound(used_chunk.chunk_end());
+    if (it_end == free_chunks.end()) return;
+    auto it_start = free_chunks.lower_bound(used_chunk.offset);
+
+    // Store original free chunk end, in case `it_start == it_end`.
+    int64_t free_chunk_end = it_end->second;
+
+    // Subtract from free chunk containing start of used range, removing if it
+    // becomes too small for the buffer.
+    if (it_start != free_chunks.end()) {
+      if (used_chunk.offset - it_start->first >= buffer_interval.size) {
+        it_start->second = std::min(it_start->second, used_chunk.offset);
+      } else {
+        ++it_start;  // Increment iterator so that this entry is erased
+                     // below.
       }
+    }
 
-      // Erase from the start chunk (possibly inclusive) to the end chunk
-      // (always inclusive). We iterate from end to start, as the map is in
-      // reverse order.
-      free_chunks.erase(it_end, it_start);
+    // Erase from the start chunk (possibly inclusive) to the end chunk
+    // (always inclusive). We iterate from end to start, as the map is in
+    // reverse order.
+    free_chunks.erase(it_end, it_start);
 
-      // Create a new free chunk after the used chunk, if it is large enough.
-      int64_t chunk_end_aligned = RoundUpTo(used_chunk.chunk_end(), alignment_);
-      if (free_chunk_end - chunk_end_aligned >= max_colocation_size) {
-        CHECK(free_chunks.insert({chunk_end_aligned, free_chunk_end}).second);
-      }
+    // Create a new free chunk after the used chunk, if it is large enough.
+    int64_t chunk_end_aligned = RoundUpTo(used_chunk.chunk_end(), alignment_);
+    if (free_chunk_end - chunk_end_aligned >= max_colocation_size) {
+      CHECK(free_chunks.insert({chunk_end_aligned, free_chunk_end}).second);
     }
   };
 
-  subtract_used_chunks(interval_tree_.ChunksOverlappingInTime(
-      buffer_interval.start, buffer_interval.end));
+  interval_tree_.ForEachChunkOverlappingInTime(
+      buffer_interval.start, buffer_interval.end, subtract_used_chunk);
 
   for (const BufferType* colocation :
        GetTransitiveColocations(buffer_interval)) {
@@ -2223,8 +2359,8 @@ GlobalDecreasingSizeBestFitHeap<BufferType>::MakeFreeChunks(
     VLOG(1) << "  Alias size " << interval.size << ", start " << interval.start
             << ", end " << interval.end << " " << interval.buffer->ToString();
 
-    subtract_used_chunks(
-        interval_tree_.ChunksOverlappingInTime(interval.start, interval.end));
+    interval_tree_.ForEachChunkOverlappingInTime(interval.start, interval.end,
+                                                 subtract_used_chunk);
   }
 
   return free_chunks;
@@ -2401,19 +2537,34 @@ template <typename BufferType>
 absl::StatusOr<HeapSimulator::Result<BufferType>>
 ChooseBestHeapAlgorithm<BufferType>::Finish() {
   DCHECK(!algorithms_.empty());
-  std::vector<Result> results(algorithms_.size());
+  std::vector<absl::StatusOr<Result>> results(algorithms_.size());
+  if (algorithms_.size() > 1 && num_allocs_ >= kMinAllocsToFinishInParallel) {
+    // The thread pool destructor waits for all scheduled algorithms.
+    tsl::thread::ThreadPool pool(tsl::Env::Default(),
+                                 "choose_best_heap_algorithm",
+                                 algorithms_.size() - 1);
+    for (int i = 1; i < algorithms_.size(); ++i) {
+      pool.Schedule([&, i] { results[i] = algorithms_[i]->Finish(); });
+    }
+    results[0] = algorithms_[0]->Finish();
+  } else {
+    for (int i = 0; i < algorithms_.size(); ++i) {
+      results[i] = algorithms_[i]->Finish();
+    }
+  }
+
   int64_t min_size = INT64_MAX;
   int min_size_index = -1;
-  for (int i = 0; i < algorithms_.size(); ++i) {
-    TF_ASSIGN_OR_RETURN(results[i], algorithms_[i]->Finish());
-    if (results[i].heap_size < min_size) {
-      min_size = results[i].heap_size;
+  for (int i = 0; i < results.size(); ++i) {
+    TF_RETURN_IF_ERROR(results[i].status());
+    if (results[i]->heap_size < min_size) {
+      min_size = results[i]->heap_size;
       min_size_index = i;
     }
   }
 
   DCHECK_GE(min_size_index, 0);
-  return results[min_size_index];
+  return *std::move(results[min_size_index]);
 }
 
 template class GlobalDecreasingSizeBestFitHeap<HloValue>;
@@ -36,6 +36,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -381,10 +382,29 @@ class BufferIntervalTree {
   // interval.
   std::vector<Chunk> ChunksOverlappingInTime(int64_t start, int64_t end) const;
 
+  // Calls `fn` on every allocated chunk that overlaps with the given time
+  // interval, without collecting them first.
+  void ForEachChunkOverlappingInTime(
+      int64_t start, int64_t end,
+      absl::FunctionRef<void(const Chunk&)> fn) const;
+
+  // Returns the number of allocated chunks that overlap with the given time
+  // interval.
+  int64_t NumChunksOverlappingInTime(int64_t start, int64_t end) const;
+
   BufferIntervalTreeNode* GetRoot() { return root_; }
 
  private:
+  // Rebuilds the subtree of the lowest ancestor of the newly added `node`
+  // whose children are out of balance.
+  void RebalanceAncestors(BufferIntervalTreeNode* node);
+
+  // Replaces the subtree rooted at `subtree_root` with a balanced one holding
+  // the same nodes.
+  void RebuildSubtree(BufferIntervalTreeNode* subtree_root);
+
   BufferIntervalTreeNode* root_ = nullptr;
+  int64_t num_nodes_ = 0;
   std::list<BufferIntervalTreeNode> node_storage_;
 };
 
@@ -974,6 +994,7 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
   ~ChooseBestHeapAlgorithm() override {}
 
   void Alloc(const BufferType* buffer, int64_t size) override {
+    ++num_allocs_;
     for (auto& algorithm : algorithms_) {
       algorithm->Alloc(buffer, size);
     }
@@ -981,6 +1002,7 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
 
   void ShareWith(const BufferType* buffer, const BufferType* share_with,
                  int64_t size) override {
+    ++num_allocs_;
     for (auto& algorithm : algorithms_) {
       algorithm->ShareWith(buffer, share_with, size);
     }
@@ -992,10 +1014,18 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
     }
   }
 
+  // Finishes all algorithms and returns the result with the smallest heap,
+  // preferring earlier algorithms on ties. The algorithms are independent, so
+  // with enough buffers for it to pay off they are finished concurrently.
   absl::StatusOr<Result> Finish() override;
 
  private:
+  // The number of allocated buffers from which the algorithms are finished on
+  // a thread pool.
+  static constexpr int64_t kMinAllocsToFinishInParallel = 4096;
+
   std::vector<std::unique_ptr<HeapAlgorithm<BufferType>>> algorithms_;
+  int64_t num_allocs_ = 0;
 };
 
 extern template class GlobalDecreasingSizeBestFitHeap<HloValue>;
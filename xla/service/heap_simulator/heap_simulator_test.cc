@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/heap_simulator/heap_simulator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -1828,6 +1829,51 @@ TEST_F(ConstrainedGlobalDecreasingSizeBestFitHeapTest, ColocatedII) {
   EXPECT_EQ(0, result.heap_results[0].chunk_map.at(buffer_c_).offset);
 }
 
+// A heap algorithm that counts its allocations and reports a fixed heap size.
+class FixedSizeHeap : public HeapAlgorithm<HloValue> {
+ public:
+  FixedSizeHeap(int64_t heap_size, int64_t* num_allocs)
+      : heap_size_(heap_size), num_allocs_(num_allocs) {}
+
+  void Alloc(const HloValue* buffer, int64_t size) override { ++*num_allocs_; }
+  void Free(const HloValue* buffer, int64_t size) override {}
+  absl::StatusOr<Result> Finish() override {
+    Result result;
+    result.heap_size = heap_size_;
+    return result;
+  }
+
+ private:
+  int64_t heap_size_;
+  int64_t* num_allocs_;
+};
+
+class ChooseBestHeapAlgorithmTest
+    : public ::testing::TestWithParam<int64_t> {};
+
+TEST_P(ChooseBestHeapAlgorithmTest, ChoosesFirstSmallestHeap) {
+  std::vector<int64_t> num_allocs(4, 0);
+  auto algorithms =
+      std::make_unique<std::vector<std::unique_ptr<HeapAlgorithm<HloValue>>>>();
+  for (int64_t heap_size : {30, 10, 20, 10}) {
+    algorithms->push_back(std::make_unique<FixedSizeHeap>(
+        heap_size, &num_allocs[algorithms->size()]));
+  }
+  ChooseBestHeapAlgorithm<HloValue> heap(std::move(algorithms));
+  for (int64_t i = 0; i < GetParam(); ++i) {
+    heap.Alloc(/*buffer=*/nullptr, /*size=*/1);
+  }
+  TF_ASSERT_OK_AND_ASSIGN(const HeapSimulator::Result<HloValue> result,
+                          heap.Finish());
+  EXPECT_EQ(result.heap_size, 10);
+  EXPECT_THAT(num_allocs, ::testing::Each(GetParam()));
+}
+
+// With many allocations the algorithms are finished on a thread pool.
+INSTANTIATE_TEST_SUITE_P(ChooseBestHeapAlgorithmTests,
+                         ChooseBestHeapAlgorithmTest,
+                         ::testing::Values(0, 10, 5000));
+
 class IntervalTreeTest : public ::testing::Test {};
 
 TEST_F(IntervalTreeTest, InsertAndRemove) {
@@ -1844,6 +1890,30 @@ TEST_F(IntervalTreeTest, InsertAndRemove) {
   ASSERT_EQ(tree.GetRoot(), nullptr);
 }
 
+TEST_F(IntervalTreeTest, ChunksOverlappingInTime) {
+  BufferIntervalTree tree;
+  tree.Add(5, 10, HeapSimulator::Chunk::FromOffsetSize(0, 1));
+  tree.Add(1, 3, HeapSimulator::Chunk::FromOffsetSize(1, 1));
+  tree.Add(12, 15, HeapSimulator::Chunk::FromOffsetSize(2, 1));
+  tree.Add(2, 20, HeapSimulator::Chunk::FromOffsetSize(3, 1));
+
+  auto offsets = [&](int64_t start, int64_t end) {
+    std::vector<int64_t> offsets;
+    tree.ForEachChunkOverlappingInTime(
+        start, end, [&](const HeapSimulator::Chunk& chunk) {
+          offsets.push_back(chunk.offset);
+        });
+    EXPECT_EQ(offsets.size(), tree.ChunksOverlappingInTime(start, end).size());
+    EXPECT_EQ(offsets.size(), tree.NumChunksOverlappingInTime(start, end));
+    return offsets;
+  };
+  EXPECT_THAT(offsets(0, 0), ::testing::IsEmpty());
+  EXPECT_THAT(offsets(3, 4), ::testing::UnorderedElementsAre(1, 3));
+  EXPECT_THAT(offsets(10, 12), ::testing::UnorderedElementsAre(0, 2, 3));
+  EXPECT_THAT(offsets(16, 30), ::testing::UnorderedElementsAre(3));
+  EXPECT_THAT(offsets(21, 30), ::testing::IsEmpty());
+}
+
 TEST_F(IntervalTreeTest, InsertAndRemoveTwoLevelsLeft) {
   HeapSimulator::Chunk chunk = HeapSimulator::Chunk::FromOffsetSize(
       1, 2);  // Value in chunk doesn't matter here.
@@ -2019,6 +2089,50 @@ TEST_F(IntervalTreeTest, ThreeLevelsRightLeftChunkDifferent) {
   ASSERT_EQ(tree.GetRoot(), nullptr);
 }
 
+TEST_F(IntervalTreeTest, StaysBalancedWhenAddedInOrder) {
+  // Buffers added in order of their start times, many sharing a start time,
+  // would turn an unbalanced tree into a list.
+  constexpr int64_t kNumIntervals = 1 << 14;
+  BufferIntervalTree tree;
+  for (int64_t i = 0; i < kNumIntervals; ++i) {
+    tree.Add(i / 4, i / 4 + i % 7, HeapSimulator::Chunk::FromOffsetSize(i, 1));
+  }
+
+  std::function<int64_t(const BufferIntervalTreeNode*)> height =
+      [&](const BufferIntervalTreeNode* node) -> int64_t {
+    if (node == nullptr) {
+      return 0;
+    }
+    return 1 + std::max(height(node->left), height(node->right));
+  };
+  EXPECT_LE(height(tree.GetRoot()), 40);
+
+  auto expected_offsets = [&](int64_t start, int64_t end) {
+    std::vector<int64_t> offsets;
+    for (int64_t i = 0; i < kNumIntervals; ++i) {
+      if (i / 4 <= end && i / 4 + i % 7 >= start && i % 3 != 0) {
+        offsets.push_back(i);
+      }
+    }
+    return offsets;
+  };
+  // Remove every third interval; the remaining ones must still be found.
+  for (int64_t i = 0; i < kNumIntervals; i += 3) {
+    EXPECT_TRUE(tree.Remove(i / 4, i / 4 + i % 7,
+                            HeapSimulator::Chunk::FromOffsetSize(i, 1)));
+  }
+  for (auto [start, end] : std::vector<std::pair<int64_t, int64_t>>{
+           {0, 0}, {10, 12}, {1000, 1000}, {4000, 5000}}) {
+    std::vector<int64_t> offsets;
+    tree.ForEachChunkOverlappingInTime(
+        start, end, [&](const HeapSimulator::Chunk& chunk) {
+          offsets.push_back(chunk.offset);
+        });
+    EXPECT_THAT(offsets, ::testing::UnorderedElementsAreArray(
+                             expected_offsets(start, end)));
+  }
+}
+
 class SlicedBufferIntervalTest : public ::testing::Test {
  public:
   using HeapTy = GlobalDecreasingSizeBestFitHeap<HloValue>;
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/hlo_alias_analysis.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -35,8 +36,11 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/types.h"
 #include "xla/util.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -46,6 +50,10 @@ namespace {
 
 using FlatValueSet = absl::flat_hash_set<const HloValue*>;
 
+// Modules with at least this many values compute the aliased values of each
+// value in parallel.
+constexpr int64_t kMinValuesToAliasInParallel = 1 << 14;
+
 void ComputeInputOutputAliasedValues(const HloValue& value,
                                      const HloDataflowAnalysis& dataflow,
                                      FlatValueSet& aliased_values) {
@@ -229,13 +237,34 @@ std::vector<HloBuffer> CreateBuffers(const HloDataflowAnalysis& dataflow) {
     value_to_set[values[i]] = &buffer_values[i];
   }
 
+  // Compute the values that each value must be aliased with. This only reads
+  // the dataflow analysis, apart from lazily computing the uses of the value
+  // itself, so values are processed in parallel on large modules. Only the
+  // sets that alias the value with others are kept.
+  std::vector<FlatValueSet> aliased_values_per_value(values.size());
+  auto compute_aliased_values = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      FlatValueSet aliased_values = ComputeAliasedValues(*values[i], dataflow);
+      if (aliased_values.size() >= 2) {
+        aliased_values_per_value[i] = std::move(aliased_values);
+      }
+    }
+  };
+  if (values.size() >= kMinValuesToAliasInParallel) {
+    static auto* pool = new tsl::thread::ThreadPool(
+        tsl::Env::Default(), "alias_analysis", tsl::port::MaxParallelism());
+    pool->ParallelFor(values.size(), /*cost_per_unit=*/1000,
+                      compute_aliased_values);
+  } else {
+    compute_aliased_values(0, values.size());
+  }
+
   // Merge together sets of HloValues which must be in the same HloBuffer
   // because of aliasing rules (e.g. in-place kWhile instruction).
-  for (const HloValue* value : values) {
-    VLOG(3) << "Merging colocated values, value: " << *value;
-
-    FlatValueSet aliased_values = ComputeAliasedValues(*value, dataflow);
+  for (size_t i = 0; i < values.size(); ++i) {
+    const FlatValueSet& aliased_values = aliased_values_per_value[i];
     if (aliased_values.size() < 2) continue;  // Fast path.
+    VLOG(3) << "Merging colocated values, value: " << *values[i];
 
     // The sets of values that are transitively aliased together.
     std::vector<std::pair<FlatValueSet*, HloValue::Id>> aliased_sets;
@@ -29,6 +29,7 @@ limitations under the License.
 #include "xla/hlo/utils/hlo_query.h"
 #include "xla/layout_util.h"
 #include "xla/literal.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/slow_operation_alarm.h"
 #include "xla/shape_util.h"
 #include "xla/types.h"
@@ -64,6 +65,39 @@ static bool IsOrContainsIllegalInstr(const HloInstruction* instr) {
   return false;
 }
 
+// Returns the number of elements the operands of `instr` occupy once
+// materialized. A broadcast of a constant only costs the elements of the
+// broadcasted constant.
+static int64_t MaterializedOperandElements(const HloInstruction* instr) {
+  int64_t elements = 0;
+  for (const HloInstruction* operand : instr->operands()) {
+    if (operand->opcode() == HloOpcode::kBroadcast) {
+      operand = operand->operand(0);
+    }
+    if (operand->shape().IsArray()) {
+      elements += ShapeUtil::ElementsIn(operand->shape());
+    }
+  }
+  return elements;
+}
+
+// Returns the estimated number of flops needed to evaluate `instr`, or 0 if
+// it is not an op whose cost is dominated by its flops.
+static int64_t EstimatedFlops(const HloInstruction* instr) {
+  switch (instr->opcode()) {
+    case HloOpcode::kDot:
+      return HloCostAnalysis::GetDotFlops(instr->operand(0)->shape(),
+                                          instr->shape(),
+                                          instr->dot_dimension_numbers());
+    case HloOpcode::kConvolution:
+      return HloCostAnalysis::GetConvolutionFlops(
+          instr, instr->operand(0)->shape(), instr->operand(1)->shape(),
+          instr->shape());
+    default:
+      return 0;
+  }
+}
+
 /*static*/ std::atomic<int64_t> HloConstantFolding::slow_op_counter_{0};
 
 absl::StatusOr<bool> HloConstantFolding::Run(
@@ -79,6 +113,10 @@ absl::StatusOr<bool> HloConstantFolding::Run(
   // We delay deleting dead instructions so that we can print them out if we are
   // taking too long without use-after-free or other sorts of races.
   std::vector<HloInstruction*> dead_instructions;
+  // Number of instructions skipped because of the size and cost limits below.
+  int64_t skipped_too_large = 0;
+  int64_t skipped_too_much_growth = 0;
+  int64_t skipped_too_many_flops = 0;
 
   for (auto* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -177,10 +215,39 @@ absl::StatusOr<bool> HloConstantFolding::Run(
         static const int64_t kMaximumConstantSizeElements = 45 * 1000 * 1000;
         if (std::max(elements_in_constant, elements_in_operands) >
             kMaximumConstantSizeElements) {
+          ++skipped_too_large;
+          continue;
+        }
+
+        // Don't materialize a constant that is much larger than the constants
+        // it is computed from, e.g. a pad or concatenate of small constants.
+        // Keeping the op is cheap at runtime and keeps the module small.
+        static const int64_t kMinimumGrowthCheckElements = 1000 * 1000;
+        static const int64_t kMaximumGrowthFactor = 64;
+        int64_t materialized_operand_elements =
+            MaterializedOperandElements(instruction);
+        if (elements_in_constant > kMinimumGrowthCheckElements &&
+            elements_in_constant >
+                kMaximumGrowthFactor * materialized_operand_elements) {
+          VLOG(3) << "Not constant folding " << instruction->name()
+                  << ": result has " << elements_in_constant
+                  << " elements, operands have "
+                  << materialized_operand_elements;
+          ++skipped_too_much_growth;
           continue;
         }
       }
 
+      // Don't constant fold dots and convolutions that would take too long to
+      // evaluate.
+      static const int64_t kMaximumFlops = int64_t{10} * 1000 * 1000 * 1000;
+      if (int64_t flops = EstimatedFlops(instruction); flops > kMaximumFlops) {
+        VLOG(3) << "Not constant folding " << instruction->name() << ": "
+                << flops << " estimated flops";
+        ++skipped_too_many_flops;
+        continue;
+      }
+
       VLOG(5) << "Constant folding: " << instruction->ToString();
 
       absl::Duration slow_timeout =
@@ -245,6 +312,16 @@ absl::StatusOr<bool> HloConstantFolding::Run(
       TF_RETURN_IF_ERROR(instruction->ReplaceAllUsesWith(new_constant));
     }
   }
+  if (skipped_too_large + skipped_too_much_growth + skipped_too_many_flops >
+      0) {
+    VLOG(1) << "Constant folding skipped " << skipped_too_large
+            << " instructions with too large operands or results, "
+            << skipped_too_much_growth
+            << " instructions whose result would be much larger than their "
+               "operands, and "
+            << skipped_too_many_flops
+            << " instructions that need too many flops to evaluate.";
+  }
   const bool changed = !dead_instructions.empty();
   for (HloInstruction* dead_instruction : dead_instructions) {
     CHECK(dead_instruction->IsDead());
@@ -301,6 +301,25 @@ TEST_F(HloConstantFoldingTest, DoesNotFoldLargePad) {
               GmockMatch(m::Pad(m::Constant(), m::Constant())));
 }
 
+TEST_F(HloConstantFoldingTest, DoesNotFoldPadThatGrowsConstantTooMuch) {
+  const char* const kModuleStr = R"(
+  HloModule test
+
+  ENTRY r {
+    a = f32[2,2] constant({{1, 2}, {3, 4}})
+    b = f32[] constant(0)
+    ROOT pad = f32[2048,1024] pad(a, b), padding=1023_1023x511_511
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kModuleStr));
+  HloConstantFolding const_folder;
+  TF_ASSERT_OK_AND_ASSIGN(bool result, const_folder.Run(module.get()));
+  EXPECT_FALSE(result);
+
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Pad(m::Constant(), m::Constant())));
+}
+
 TEST_F(HloConstantFoldingTest, DoesNotFoldSlicesWithLargeOperand) {
   const char* const kModuleStr = R"(
   HloModule test
@@ -185,6 +185,35 @@ TEST_F(HloCseTest, NonscalarConstants) {
               op::Tuple(first_operand, first_operand, uncommon_constant));
 }
 
+TEST_F(HloCseTest, LargeConstantsDifferingAfterPrefix) {
+  // Test that large constants which only differ past the hashed prefix of the
+  // literal are kept apart, while identical ones are still merged.
+  auto builder = HloComputation::Builder(TestName());
+  std::vector<float> values(1024, 1.0f);
+  auto common_constant1 = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR1<float>(values)));
+  auto common_constant2 = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR1<float>(values)));
+  values.back() = 2.0f;
+  auto uncommon_constant = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR1<float>(values)));
+  auto tuple = builder.AddInstruction(HloInstruction::CreateTuple(
+      {common_constant1, uncommon_constant, common_constant2}));
+
+  auto module = CreateNewVerifiedModule();
+  auto computation = module->AddEntryComputation(builder.Build());
+
+  HloCSE cse(/*is_layout_sensitive=*/false);
+  EXPECT_TRUE(cse.Run(module.get()).value());
+
+  EXPECT_EQ(3, computation->instruction_count());
+  auto first_operand = tuple->operand(0);
+  EXPECT_THAT(first_operand,
+              ::testing::AnyOf(common_constant1, common_constant2));
+  EXPECT_THAT(tuple,
+              op::Tuple(first_operand, uncommon_constant, first_operand));
+}
+
 TEST_F(HloCseTest, IdenticalInstructions) {
   // Test that three identical instructions are commoned.
   auto builder = HloComputation::Builder(TestName());
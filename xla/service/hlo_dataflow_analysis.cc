@@ -50,11 +50,18 @@ limitations under the License.
 
 namespace xla {
 namespace {
+// Position of an instruction in the propagation worklist order, and whether
+// the instruction is currently in the worklist.
+struct WorklistEntry {
+  int64_t priority = 0;
+  bool in_worklist = false;
+};
+
 // CalculatePostOrderSchedule traverses a module and assign a ordinal to each
 // instruction based the postorder dependency.
 int64_t CalculatePostOrderScheduleHelper(
     const HloComputation* comp, int64_t start_ordinal,
-    absl::flat_hash_map<HloInstruction*, int64_t>* ordinal_map) {
+    absl::flat_hash_map<HloInstruction*, WorklistEntry>* ordinal_map) {
   int64_t ordinal = start_ordinal;
   for (HloInstruction* instruction : comp->MakeInstructionPostOrder()) {
     if (instruction->opcode() == HloOpcode::kCall ||
@@ -75,14 +82,14 @@ int64_t CalculatePostOrderScheduleHelper(
     // flatten (meaning we could have multiple callers for one computation). In
     // that case the oridinal_map will see the instruction multiple times. We
     // consider that case to be ok as it only shows up in unit tests.
-    ordinal_map->insert({instruction, ordinal++});
+    ordinal_map->insert({instruction, WorklistEntry{ordinal++}});
   }
   return ordinal;
 }
 
-absl::flat_hash_map<HloInstruction*, int64_t> CalculatePostOrderSchedule(
+absl::flat_hash_map<HloInstruction*, WorklistEntry> CalculatePostOrderSchedule(
     const HloModule& module) {
-  absl::flat_hash_map<HloInstruction*, int64_t> map;
+  absl::flat_hash_map<HloInstruction*, WorklistEntry> map;
   CalculatePostOrderScheduleHelper(module.entry_computation(), 0, &map);
   return map;
 }
@@ -99,7 +106,7 @@ HloDataflowAnalysis::HloDataflowAnalysis(
       execution_threads_(std::move(execution_threads)),
       ssa_form_(ssa_form),
       bitcast_defines_value_(bitcast_defines_value),
-      call_graph_(CallGraph::Build(&module)),
+      call_graph_(CallGraph::BuildCached(&module)),
       can_share_buffer_(can_share_buffer),
       forwards_value_(forwards_value) {}
 
@@ -1288,12 +1295,15 @@ void HloDataflowAnalysis::Propagate() {
   // schedule. Intuitively, we start from entry parameters and propagate buffers
   // updates throughout the module only once.
   std::priority_queue<Work, std::vector<Work>, std::greater<Work>> worklist;
-  absl::flat_hash_set<HloInstruction*> workset;
-  auto priority_map = CalculatePostOrderSchedule(module_);
-  auto add_to_worklist = [&priority_map, &worklist,
-                          &workset](HloInstruction* instruction) {
-    if (workset.insert(instruction).second) {
-      worklist.emplace(priority_map[instruction], instruction);
+  // Keeping the priorities and the worklist membership in one map needs a
+  // single hash lookup per worklist operation.
+  auto worklist_entries = CalculatePostOrderSchedule(module_);
+  auto add_to_worklist = [&worklist_entries,
+                          &worklist](HloInstruction* instruction) {
+    WorklistEntry& entry = worklist_entries[instruction];
+    if (!entry.in_worklist) {
+      entry.in_worklist = true;
+      worklist.emplace(entry.priority, instruction);
     }
   };
 
@@ -1314,7 +1324,7 @@ void HloDataflowAnalysis::Propagate() {
     HloInstruction* instruction = worklist.top().second;
     worklist.pop();
 
-    workset.erase(workset.find(instruction));
+    worklist_entries[instruction].in_worklist = false;
 
     VLOG(3) << "Worklist top: " << instruction->name();
     XLA_VLOG_LINES(3, ToString());
@@ -1841,6 +1851,11 @@ GetFusionInstructionInPlaceInputOutputPairs(const HloInstruction* instruction) {
         std::tie(output_source_instruction, output_source_index) =
             FollowTupleIndirection(output_source_instruction,
                                    output_source_index);
+        // A bitcast reinterprets its operand's buffer, so an in-place update
+        // feeding a bitcast still writes into the fusion output.
+        if (output_source_instruction->opcode() == HloOpcode::kBitcast) {
+          output_source_instruction = output_source_instruction->operand(0);
+        }
 
         // The aliasing rules of the "output source" instruction determine the
         // aliasing rules for the entire fusion. If we can connect (following
@@ -1867,6 +1882,11 @@ GetFusionInstructionInPlaceInputOutputPairs(const HloInstruction* instruction) {
             std::tie(in_place_input_source, in_place_input_index) =
                 FollowTupleIndirection(in_place_input_source,
                                        in_place_input_index);
+            if (in_place_input_source->opcode() == HloOpcode::kBitcast) {
+              std::tie(in_place_input_source, in_place_input_index) =
+                  FollowTupleIndirection(in_place_input_source->operand(0),
+                                         {});
+            }
             if (in_place_input_source->opcode() == HloOpcode::kFusion) {
               // Nested fusions can have aliasing that allows us to peephole
               // through to their producer.
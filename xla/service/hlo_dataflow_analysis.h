@@ -349,7 +349,7 @@ class HloDataflowAnalysis {
   const bool ssa_form_;
   const bool bitcast_defines_value_;
 
-  std::unique_ptr<CallGraph> call_graph_;
+  std::shared_ptr<const CallGraph> call_graph_;
 
   // The map of all HloValues in the module. We pass around pointers to the
   // mapped HloValues, so the underlying container must keep them valid despite
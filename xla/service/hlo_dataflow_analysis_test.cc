@@ -3139,6 +3139,35 @@ TEST_F(GetInPlaceInputOutputPairsTest, DUSFusion) {
   EXPECT_EQ(in_place_pairs, expected_pairs);
 }
 
+TEST_F(GetInPlaceInputOutputPairsTest, DUSFusionWithBitcasts) {
+  const char* kModule = R"(
+    HloModule test
+
+    fused_computation {
+      p0 = f32[2,10] parameter(0)
+      p1 = f32[5] parameter(1)
+      p2 = s32[] parameter(2)
+      bitcast.0 = f32[20] bitcast(p0)
+      dus = f32[20] dynamic-update-slice(bitcast.0, p1, p2)
+      ROOT bitcast.1 = f32[2,10] bitcast(dus)
+    }
+
+    ENTRY test {
+      p0 = f32[2,10] parameter(0)
+      p1 = f32[5] parameter(1)
+      p2 = s32[] parameter(2)
+      ROOT fusion = f32[2,10] fusion(p0, p1, p2), kind=kLoop, calls=fused_computation
+    }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kModule));
+  HloInstruction* fusion = module->entry_computation()->root_instruction();
+
+  auto in_place_pairs = HloDataflowAnalysis::GetInPlaceInputOutputPairs(fusion);
+  std::vector<std::pair<HloOperandIndex, ShapeIndex>> expected_pairs;
+  expected_pairs.push_back({HloOperandIndex{0, {}}, {}});
+  EXPECT_EQ(in_place_pairs, expected_pairs);
+}
+
 TEST_F(GetInPlaceInputOutputPairsTest, DUSFusionWithOutputOperandAliasing) {
   const char* kModule = R"(
     HloModule test
@@ -17,17 +17,22 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <iterator>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -66,15 +71,11 @@ bool IsRemovableWhile(HloInstruction* instruction,
   return true;
 }
 
-}  // namespace
-
-/*static*/ absl::StatusOr<bool> HloDCE::RunOnComputation(
-    HloComputation* computation, bool remove_cross_partition_collective_ops) {
+// Removes the unused tuple elements of a multi-output fusion root. This
+// changes the users of the fusion instruction in the calling computation and
+// adds instructions to the module.
+absl::StatusOr<bool> RemoveUnusedFusionOutputs(HloComputation* computation) {
   bool changed = false;
-  VLOG(3) << "Before dce:";
-  XLA_VLOG_LINES(3, computation->ToString());
-  // Cleanup unused tuple elements in multi-output fusion roots. We do this
-  // first, because it may create dead roots which we can clean up next.
   if (auto* fusion_instruction = computation->FusionInstruction();
       fusion_instruction != nullptr &&
       computation->root_instruction()->opcode() == HloOpcode::kTuple &&
@@ -154,9 +155,18 @@ bool IsRemovableWhile(HloInstruction* instruction,
     }
   }
 
-  // Remove any dead roots and their dead transitive operands. Collect them
-  // into a separate list first to avoid problems with iterating through the
-  // computation's instruction while simultaneously removing instructions.
+  return changed;
+}
+
+// Removes the dead roots of `computation` and their dead transitive operands.
+// This only modifies `computation`, and reads the computations it calls.
+absl::StatusOr<bool> RemoveDeadRoots(
+    HloComputation* computation, bool remove_cross_partition_collective_ops,
+    std::optional<absl::FunctionRef<void(HloInstruction*)>> cleanup) {
+  bool changed = false;
+  // Collect the dead roots into a separate list first to avoid problems with
+  // iterating through the computation's instruction while simultaneously
+  // removing instructions.
   std::vector<HloInstruction*> dead_roots;
   for (auto* instruction : computation->instructions()) {
     auto maybe_collective_op = DynCast<HloCollectiveInstruction>(instruction);
@@ -178,9 +188,27 @@ bool IsRemovableWhile(HloInstruction* instruction,
     VLOG(1) << "Removing dead root " << dead_root->ToString()
             << " and its unused operands";
     TF_RETURN_IF_ERROR(
-        computation->RemoveInstructionAndUnusedOperands(dead_root));
+        computation->RemoveInstructionAndUnusedOperands(dead_root, cleanup));
     changed = true;
   }
+  return changed;
+}
+
+}  // namespace
+
+/*static*/ absl::StatusOr<bool> HloDCE::RunOnComputation(
+    HloComputation* computation, bool remove_cross_partition_collective_ops,
+    std::optional<absl::FunctionRef<void(HloInstruction*)>> cleanup) {
+  VLOG(3) << "Before dce:";
+  XLA_VLOG_LINES(3, computation->ToString());
+  // Cleanup unused tuple elements in multi-output fusion roots. We do this
+  // first, because it may create dead roots which we can clean up next.
+  TF_ASSIGN_OR_RETURN(bool changed, RemoveUnusedFusionOutputs(computation));
+  TF_ASSIGN_OR_RETURN(
+      bool removed_dead_roots,
+      RemoveDeadRoots(computation, remove_cross_partition_collective_ops,
+                      cleanup));
+  changed |= removed_dead_roots;
   if (changed) {
     VLOG(3) << "After dce:";
     XLA_VLOG_LINES(3, computation->ToString());
@@ -227,43 +255,16 @@ absl::Status HloDCE::RecursivelyRemoveDeadComputation(
   return absl::OkStatus();
 }
 
-absl::StatusOr<bool> HloDCE::RecursivelyRemoveDeadComputations(
-    HloModule* module) {
-  // Tracks whether any dead code is eliminated by this pass.
-  bool module_contains_dead_code = false;
-
-  // First, collect the computations that are
-  // referenced by some remaining instruction. We need to record this as a
-  // refcount map rather than a set since we cannot guarantee that control
-  // flow flattening has been done and there may be multiple call sites.
-  absl::flat_hash_map<HloComputation*, int> live_computation_call_count;
-  if (HloComputation* entry_computation = module->entry_computation()) {
-    ++live_computation_call_count[entry_computation];
-  }
-  // Account for all threads' caller when counting a sub computation's live call
-  // count.
-  for (auto* computation : module->MakeComputationPostOrder()) {
-    for (auto* instruction : computation->instructions()) {
-      for (auto* subcomp : instruction->called_computations()) {
-        ++live_computation_call_count[subcomp];
-      }
-    }
-  }
-
-  // Find dead computations.
-  for (auto* computation : module->MakeComputationPostOrder()) {
-    // Finds all "top-level" dead computations not called by any instructions.
-    // contains(comp) = true and live_computation_call_count[comp] = 0 also
-    // implies that the computation is dead, but is nested in other dead
-    // computations. These inner computations are ignored here since they will
-    // be removed recursing through other computations.
-    if (!live_computation_call_count.contains(computation)) {
-      TF_RETURN_IF_ERROR(RecursivelyRemoveDeadComputation(
-          module, computation, live_computation_call_count));
-      module_contains_dead_code = true;
-    }
+absl::Status HloDCE::RemoveDeadComputations(
+    HloModule* module, const std::vector<HloComputation*>& dead_computations,
+    absl::flat_hash_map<HloComputation*, int>& live_call_counts) {
+  // Computations nested in other dead computations still have a positive live
+  // call count here. They are removed recursing through their callers.
+  for (HloComputation* computation : dead_computations) {
+    TF_RETURN_IF_ERROR(RecursivelyRemoveDeadComputation(module, computation,
+                                                         live_call_counts));
   }
-  return module_contains_dead_code;
+  return absl::OkStatus();
 }
 
 absl::StatusOr<bool> HloDCE::Run(
@@ -274,24 +275,77 @@ absl::StatusOr<bool> HloDCE::Run(
   VLOG(2) << "Before dce:";
   XLA_VLOG_LINES(2, module->ToString());
 
+  // Count the live calls of every computation once. We need to record this as
+  // a refcount map rather than a set since we cannot guarantee that control
+  // flow flattening has been done and there may be multiple call sites.
+  // Account for all threads' callers when counting a sub computation's live
+  // call count.
+  absl::flat_hash_map<HloComputation*, int> live_call_counts;
+  if (HloComputation* entry_computation = module->entry_computation()) {
+    ++live_call_counts[entry_computation];
+  }
+  for (HloComputation* computation : module->computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      for (HloComputation* subcomp : instruction->called_computations()) {
+        ++live_call_counts[subcomp];
+      }
+    }
+  }
+
+  // "Top-level" dead computations are not called by any instruction.
+  std::vector<HloComputation*> dead_computations;
+  for (HloComputation* computation : module->computations()) {
+    if (!live_call_counts.contains(computation)) {
+      dead_computations.push_back(computation);
+    }
+  }
+  // Keep the live call counts up to date while removing instructions, so that
+  // computations that become dead are found without recounting the calls in
+  // the whole module.
+  auto remove_live_call = [&](HloComputation* subcomp) {
+    auto it = live_call_counts.find(subcomp);
+    if (it != live_call_counts.end() && --it->second == 0) {
+      live_call_counts.erase(it);
+      dead_computations.push_back(subcomp);
+    }
+  };
+  auto update_live_call_counts = [&](HloInstruction* removed) {
+    for (HloComputation* subcomp : removed->called_computations()) {
+      remove_live_call(subcomp);
+    }
+  };
+
   // Run DCE on each computation. Use reverse post order so that we cleanup dead
   // get-tuple-element users of MultiOutput fusions before cleaning up the
-  // fusion computation.
+  // fusion computation. Dead computations are removed as a whole below.
   auto computations = module->MakeComputationPostOrder(execution_threads);
   std::reverse(computations.begin(), computations.end());
-  for (auto* computation : computations) {
-    TF_ASSIGN_OR_RETURN(
-        bool changed_for_computation,
-        RunOnComputation(computation, remove_cross_partition_collective_ops_));
-    changed |= changed_for_computation;
+  // Running on a thread of the pool could deadlock while waiting for tasks
+  // scheduled on the same pool.
+  if (thread_pool_ != nullptr && thread_pool_->NumThreads() > 1 &&
+      thread_pool_->CurrentThreadId() == -1 && computations.size() > 1) {
+    TF_ASSIGN_OR_RETURN(bool changed_for_computations,
+                        RunOnComputationsInParallel(
+                            computations, live_call_counts, remove_live_call));
+    changed |= changed_for_computations;
+  } else {
+    for (auto* computation : computations) {
+      if (!live_call_counts.contains(computation)) {
+        continue;
+      }
+      TF_ASSIGN_OR_RETURN(
+          bool changed_for_computation,
+          RunOnComputation(computation, remove_cross_partition_collective_ops_,
+                           update_live_call_counts));
+      changed |= changed_for_computation;
+    }
   }
 
-  // Now DCE HloComputations.  Keep doing passes through the module until no
-  // more computations can be eliminated. The function removes all
-  // subcomputations that can be proved to have no remaining live callers.
-  TF_ASSIGN_OR_RETURN(bool module_contains_dead_code,
-                      RecursivelyRemoveDeadComputations(module));
-  changed |= module_contains_dead_code;
+  // Now DCE HloComputations. Removes all subcomputations that can be proved to
+  // have no remaining live callers.
+  TF_RETURN_IF_ERROR(
+      RemoveDeadComputations(module, dead_computations, live_call_counts));
+  changed |= !dead_computations.empty();
 
   VLOG(2) << "After dce:";
   XLA_VLOG_LINES(2, module->ToString());
@@ -299,4 +353,143 @@ absl::StatusOr<bool> HloDCE::Run(
   return changed;
 }
 
+absl::StatusOr<bool> HloDCE::RunOnComputationsInParallel(
+    absl::Span<HloComputation* const> computations,
+    const absl::flat_hash_map<HloComputation*, int>& live_call_counts,
+    absl::FunctionRef<void(HloComputation*)> remove_live_call) {
+  // Group the computations into levels, such that computations are only called
+  // from computations of lower levels. Callers are cleaned before the
+  // computations they call, like in reverse post order.
+  absl::flat_hash_map<const HloComputation*, int> computation_levels;
+  std::vector<std::vector<HloComputation*>> levels;
+  for (HloComputation* computation : computations) {
+    int level = computation_levels[computation];
+    if (level >= levels.size()) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(computation);
+    for (const HloInstruction* instruction : computation->instructions()) {
+      for (const HloComputation* subcomp : instruction->called_computations()) {
+        int& subcomp_level = computation_levels[subcomp];
+        subcomp_level = std::max(subcomp_level, level + 1);
+      }
+    }
+  }
+
+  bool changed = false;
+  for (const std::vector<HloComputation*>& level : levels) {
+    std::vector<HloComputation*> live_computations;
+    for (HloComputation* computation : level) {
+      if (live_call_counts.contains(computation)) {
+        live_computations.push_back(computation);
+      }
+    }
+    // Removing unused fusion outputs changes the calling computation and adds
+    // instructions to the module, so it runs serially.
+    for (HloComputation* computation : live_computations) {
+      TF_ASSIGN_OR_RETURN(bool changed_for_computation,
+                          RemoveUnusedFusionOutputs(computation));
+      changed |= changed_for_computation;
+    }
+
+    // Dead roots of the computations of a level are removed concurrently. The
+    // calls lost on the way are collected per computation and applied in
+    // order afterwards.
+    std::vector<absl::StatusOr<bool>> results(live_computations.size(), false);
+    std::vector<std::vector<HloComputation*>> lost_calls(
+        live_computations.size());
+    absl::BlockingCounter counter(live_computations.size());
+    for (int i = 0; i < live_computations.size(); ++i) {
+      thread_pool_->Schedule([&, i] {
+        auto on_removed = [&](HloInstruction* removed) {
+          for (HloComputation* subcomp : removed->called_computations()) {
+            lost_calls[i].push_back(subcomp);
+          }
+        };
+        results[i] =
+            RemoveDeadRoots(live_computations[i],
+                            remove_cross_partition_collective_ops_, on_removed);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    for (int i = 0; i < live_computations.size(); ++i) {
+      TF_ASSIGN_OR_RETURN(bool changed_for_computation, std::move(results[i]));
+      changed |= changed_for_computation;
+      for (HloComputation* subcomp : lost_calls[i]) {
+        remove_live_call(subcomp);
+      }
+    }
+  }
+  VLOG(2) << "dce removed dead roots of " << computations.size()
+          << " computations in " << levels.size() << " parallel steps";
+  return changed;
+}
+
+absl::StatusOr<bool> HloDCE::RunOnComputations(
+    HloModule* module, absl::Span<HloComputation* const> computations) {
+  bool changed = false;
+
+  // Clean the dirty computations with a worklist. Removing the last users of
+  // a multi-output fusion's element makes its fusion computation dirty, and
+  // removing instructions that call computations makes those computations
+  // candidates for removal.
+  std::deque<HloComputation*> worklist(computations.begin(),
+                                       computations.end());
+  absl::flat_hash_set<HloComputation*> in_worklist(computations.begin(),
+                                                   computations.end());
+  std::vector<HloComputation*> lost_callers;
+  auto on_removed = [&](HloInstruction* removed) {
+    for (HloComputation* subcomp : removed->called_computations()) {
+      lost_callers.push_back(subcomp);
+    }
+    if (removed->opcode() == HloOpcode::kGetTupleElement &&
+        removed->operand(0)->opcode() == HloOpcode::kFusion) {
+      HloComputation* fused =
+          removed->operand(0)->fused_instructions_computation();
+      if (in_worklist.insert(fused).second) {
+        worklist.push_back(fused);
+      }
+    }
+  };
+  while (!worklist.empty()) {
+    HloComputation* computation = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(computation);
+    TF_ASSIGN_OR_RETURN(
+        bool changed_for_computation,
+        RunOnComputation(computation, remove_cross_partition_collective_ops_,
+                         on_removed));
+    changed |= changed_for_computation;
+  }
+  if (lost_callers.empty()) {
+    return changed;
+  }
+
+  // Some computations lost a caller. Count the remaining calls to find the
+  // ones that are dead now.
+  absl::flat_hash_map<HloComputation*, int> live_call_counts;
+  if (HloComputation* entry_computation = module->entry_computation()) {
+    ++live_call_counts[entry_computation];
+  }
+  for (HloComputation* computation : module->computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      for (HloComputation* subcomp : instruction->called_computations()) {
+        ++live_call_counts[subcomp];
+      }
+    }
+  }
+  std::vector<HloComputation*> dead_computations;
+  absl::flat_hash_set<HloComputation*> seen;
+  for (HloComputation* computation : lost_callers) {
+    if (seen.insert(computation).second &&
+        !live_call_counts.contains(computation)) {
+      dead_computations.push_back(computation);
+    }
+  }
+  TF_RETURN_IF_ERROR(
+      RemoveDeadComputations(module, dead_computations, live_call_counts));
+  return changed || !dead_computations.empty();
+}
+
 }  // namespace xla
@@ -16,15 +16,21 @@ limitations under the License.
 #ifndef XLA_SERVICE_HLO_DCE_H_
 #define XLA_SERVICE_HLO_DCE_H_
 
+#include <optional>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/hlo_pass_interface.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -46,9 +52,12 @@ class HloDCE : public HloModulePass {
   ~HloDCE() override {}
   absl::string_view name() const override { return "dce"; }
 
-  // Run DCE on a computation.
+  // Run DCE on a computation. If given, `cleanup` is called on every removed
+  // instruction before its deallocation.
   static absl::StatusOr<bool> RunOnComputation(
-      HloComputation* computation, bool remove_cross_partition_collective_ops);
+      HloComputation* computation, bool remove_cross_partition_collective_ops,
+      std::optional<absl::FunctionRef<void(HloInstruction*)>> cleanup =
+          std::nullopt);
 
   // Run the pass on the given module. Returns whether the module was changed
   // (instructions were removed).
@@ -57,10 +66,36 @@ class HloDCE : public HloModulePass {
       HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
+  // Like Run(), but only scans the given dirty computations of `module`, i.e.,
+  // the computations that the caller changed since they were last cleaned.
+  // Fusion computations whose outputs become unused on the way are cleaned as
+  // well. Computations are removed only if they lose their last caller here,
+  // and the module's calls are only counted if that may have happened.
+  absl::StatusOr<bool> RunOnComputations(
+      HloModule* module, absl::Span<HloComputation* const> computations);
+
+  // With a thread pool, Run() removes the dead instructions of independent
+  // computations concurrently.
+  void SetComputationThreadPool(
+      tsl::thread::ThreadPool* thread_pool) override {
+    thread_pool_ = thread_pool;
+  }
+
  private:
-  // Finds all computations that are not called by any instruction and removes
-  // them from the module. Returns whether any dead code was removed.
-  absl::StatusOr<bool> RecursivelyRemoveDeadComputations(HloModule* module);
+  // Cleans `computations`, given in reverse post order, like RunOnComputation
+  // but on `thread_pool_`. Computations without live calls when they are
+  // reached are skipped, and `remove_live_call` is called for every call
+  // removed on the way, in a deterministic order.
+  absl::StatusOr<bool> RunOnComputationsInParallel(
+      absl::Span<HloComputation* const> computations,
+      const absl::flat_hash_map<HloComputation*, int>& live_call_counts,
+      absl::FunctionRef<void(HloComputation*)> remove_live_call);
+
+  // Removes the given dead computations and all computations that are only
+  // called from them.
+  absl::Status RemoveDeadComputations(
+      HloModule* module, const std::vector<HloComputation*>& dead_computations,
+      absl::flat_hash_map<HloComputation*, int>& live_call_counts);
 
   // Given a dead computation, decrements the ref count of all its called
   // computations and checks if any of the subcomputations become dead after the
@@ -71,6 +106,7 @@ class HloDCE : public HloModulePass {
       absl::flat_hash_map<HloComputation*, int>& live_call_counts);
 
   bool remove_cross_partition_collective_ops_;
+  tsl::thread::ThreadPool* thread_pool_ = nullptr;
 };
 
 }  // namespace xla
@@ -38,6 +38,9 @@ limitations under the License.
 #include "xla/types.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace {
@@ -616,6 +619,122 @@ TEST_F(HloDceTest, RemovedNestedDeadComputations) {
   EXPECT_EQ(module->MakeComputationPostOrder().size(), 1);
 }
 
+TEST_F(HloDceTest, KeepSubcomputationWithRemainingLiveCaller) {
+  constexpr char kHloString[] = R"(
+  HloModule test
+
+  add {
+    lhs = f32[] parameter(0)
+    rhs = f32[] parameter(1)
+    ROOT add = f32[] add(lhs, rhs)
+  }
+
+  max {
+    lhs = f32[] parameter(0)
+    rhs = f32[] parameter(1)
+    ROOT max = f32[] maximum(lhs, rhs)
+  }
+
+  ENTRY main {
+    p = f32[100] parameter(0)
+    zero = f32[] constant(0)
+    dead_sum = f32[] reduce(p, zero), dimensions={0}, to_apply=add
+    dead_max = f32[] reduce(p, zero), dimensions={0}, to_apply=max
+    ROOT sum = f32[] reduce(p, zero), dimensions={0}, to_apply=add
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HloDCE dce;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&dce, module.get()));
+  EXPECT_TRUE(changed);
+
+  // `max` became dead with the removal of its only caller, `add` is still
+  // called from the root.
+  EXPECT_EQ(module->entry_computation()->instruction_count(), 3);
+  EXPECT_NE(module->GetComputationWithName("add"), nullptr);
+  EXPECT_EQ(module->GetComputationWithName("max"), nullptr);
+}
+
+TEST_F(HloDceTest, RunOnComputationsOnlyScansDirtyComputations) {
+  constexpr char kHloString[] = R"(
+  HloModule test
+
+  add {
+    lhs = f32[] parameter(0)
+    rhs = f32[] parameter(1)
+    dead = f32[] multiply(lhs, rhs)
+    ROOT add = f32[] add(lhs, rhs)
+  }
+
+  callee {
+    p = f32[] parameter(0)
+    ROOT neg = f32[] negate(p)
+  }
+
+  ENTRY main {
+    p = f32[100] parameter(0)
+    zero = f32[] constant(0)
+    dead_call = f32[] call(zero), to_apply=callee
+    ROOT sum = f32[] reduce(p, zero), dimensions={0}, to_apply=add
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HloDCE dce;
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      dce.RunOnComputations(module.get(), {module->entry_computation()}));
+  EXPECT_TRUE(changed);
+
+  // `callee` lost its only caller. The dead code in `add` is left alone since
+  // `add` was not dirty.
+  EXPECT_EQ(module->entry_computation()->instruction_count(), 3);
+  EXPECT_EQ(module->GetComputationWithName("callee"), nullptr);
+  EXPECT_EQ(module->GetComputationWithName("add")->instruction_count(), 4);
+
+  TF_ASSERT_OK_AND_ASSIGN(changed, RunHloPass(&dce, module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(module->GetComputationWithName("add")->instruction_count(), 3);
+}
+
+TEST_F(HloDceTest, RunOnComputationsCleansFusionsThatLoseOutputs) {
+  constexpr char kHloString[] = R"(
+  HloModule test
+
+  fused_computation {
+    p0 = f32[4] parameter(0)
+    p1 = f32[4] parameter(1)
+    neg = f32[4] negate(p0)
+    exp = f32[4] exponential(p1)
+    ROOT tuple = (f32[4], f32[4]) tuple(neg, exp)
+  }
+
+  ENTRY main {
+    p0 = f32[4] parameter(0)
+    p1 = f32[4] parameter(1)
+    fusion = (f32[4], f32[4]) fusion(p0, p1), kind=kLoop,
+      calls=fused_computation
+    gte0 = f32[4] get-tuple-element(fusion), index=0
+    dead_gte1 = f32[4] get-tuple-element(fusion), index=1
+    ROOT result = f32[4] add(gte0, gte0)
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  HloDCE dce;
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      dce.RunOnComputations(module.get(), {module->entry_computation()}));
+  EXPECT_TRUE(changed);
+
+  // Removing `dead_gte1` makes the fusion computation dirty, which drops its
+  // unused output and the parameter that only fed it.
+  HloInstruction* fusion =
+      module->entry_computation()->root_instruction()->mutable_operand(0);
+  ASSERT_EQ(fusion->opcode(), HloOpcode::kFusion);
+  EXPECT_EQ(fusion->operand_count(), 1);
+  EXPECT_THAT(fusion->fused_expression_root(),
+              GmockMatch(m::Negate(m::Parameter(0))));
+}
+
 TEST_F(HloDceTest, MultiOutputFusionRemoveUnusedTupleElementsRemoveTuple) {
   constexpr char kHloString[] = R"(
   HloModule test_module
@@ -725,5 +844,74 @@ TEST_F(HloDceTest,
   EXPECT_EQ(add2->control_predecessors().size(), 1);
   EXPECT_EQ(add2->control_predecessors()[0], fusion);
 }
+
+TEST_F(HloDceTest, RunsOnComputationsInParallel) {
+  constexpr char kHloString[] = R"(
+  HloModule test_module
+  add {
+    lhs = f32[] parameter(0)
+    rhs = f32[] parameter(1)
+    ROOT add = f32[] add(lhs, rhs)
+  }
+
+  dead_callee {
+    p0 = f32[] parameter(0)
+    ROOT neg = f32[] negate(p0)
+  }
+
+  fused_reduce {
+    p0 = f32[32] parameter(0)
+    zero = f32[] constant(0)
+    dead = f32[32] negate(p0)
+    ROOT reduce = f32[] reduce(p0, zero), dimensions={0}, to_apply=add
+  }
+
+  fused_multi_output {
+    p0 = f32[32] parameter(0)
+    neg = f32[32] negate(p0)
+    exp = f32[32] exponential(p0)
+    ROOT res = (f32[32], f32[32], f32[32]) tuple(neg, p0, exp)
+  }
+
+  ENTRY main {
+    param0 = f32[32] parameter(0)
+    param1 = f32[] parameter(1)
+    dead_call = f32[] call(param1), to_apply=dead_callee
+    fusion = (f32[32], f32[32], f32[32]) fusion(param0), kind=kLoop,
+      calls=fused_multi_output
+    gte.0 = f32[32] get-tuple-element(fusion), index=0
+    gte.1 = f32[32] get-tuple-element(fusion), index=1
+    gte.2 = f32[32] get-tuple-element(fusion), index=2
+    reduce = f32[] fusion(gte.0), kind=kInput, calls=fused_reduce
+    ROOT res = (f32[], f32[32]) tuple(reduce, gte.2)
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kHloString));
+  std::unique_ptr<HloModule> serial_module = module->Clone();
+
+  HloDCE serial_dce;
+  TF_ASSERT_OK_AND_ASSIGN(bool serial_changed,
+                          serial_dce.Run(serial_module.get()));
+  EXPECT_TRUE(serial_changed);
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), TestName(),
+                                      /*num_threads=*/4);
+  HloDCE dce;
+  dce.SetComputationThreadPool(&thread_pool);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, dce.Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  // The dead call and its callee, the dead instruction in the reduce fusion,
+  // and the unused output of the multi-output fusion are removed, with the
+  // same result as when running serially.
+  EXPECT_EQ(FindInstruction(module.get(), "dead_call"), nullptr);
+  EXPECT_EQ(FindComputation(module.get(), "dead_callee"), nullptr);
+  EXPECT_EQ(FindInstruction(module.get(), "dead"), nullptr);
+  Shape shape = ShapeUtil::MakeShape(F32, {32});
+  Shape expected_shape = ShapeUtil::MakeTupleShape({shape, shape});
+  EXPECT_THAT(FindInstruction(module.get(), "fusion"),
+              GmockMatch(m::Fusion().WithShapeEqualTo(&expected_shape)));
+  EXPECT_EQ(module->ToString(), serial_module->ToString());
+}
 }  // namespace
 }  // namespace xla
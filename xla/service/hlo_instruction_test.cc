@@ -27,7 +27,10 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/layout.h"
+#include "xla/layout_util.h"
 #include "xla/literal.h"
+#include "xla/literal_util.h"
 #include "xla/protobuf_util.h"
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/pattern_matcher.h"
@@ -763,6 +766,49 @@ TEST_F(HloInstructionTest, PreserveMetadataInFusionAndClone) {
   EXPECT_TRUE(index != std::string::npos);
 }
 
+TEST_F(HloInstructionTest, MetadataOfCloneIsIndependent) {
+  auto constant = HloInstruction::CreateConstant(
+      LiteralUtil::CreateR0<float>(1.1f));
+  auto exp = HloInstruction::CreateUnary(r0f32_, HloOpcode::kExp,
+                                         constant.get());
+  EXPECT_TRUE(protobuf_util::ProtobufEquals(exp->metadata(), OpMetadata()));
+
+  auto clone = exp->Clone();
+  clone->set_metadata_op_name("cloned_op");
+  EXPECT_EQ(clone->metadata().op_name(), "cloned_op");
+  EXPECT_TRUE(exp->metadata().op_name().empty());
+}
+
+TEST_F(HloInstructionTest, CopyMetadataFromSharesUntilUpdated) {
+  auto constant = HloInstruction::CreateConstant(
+      LiteralUtil::CreateR0<float>(1.1f));
+  auto exp = HloInstruction::CreateUnary(r0f32_, HloOpcode::kExp,
+                                         constant.get());
+  OpMetadata metadata;
+  metadata.set_op_name("tf_op");
+  metadata.set_source_file("model.py");
+  exp->set_metadata(metadata);
+
+  auto negate = HloInstruction::CreateUnary(r0f32_, HloOpcode::kNegate,
+                                            constant.get());
+  negate->CopyMetadataFrom(exp.get());
+  EXPECT_EQ(&negate->metadata(), &exp->metadata());
+
+  negate->set_metadata_op_name("negate_op");
+  EXPECT_EQ(negate->metadata().op_name(), "negate_op");
+  EXPECT_EQ(negate->metadata().source_file(), "model.py");
+  EXPECT_EQ(exp->metadata().op_name(), "tf_op");
+
+  // Updating the instruction copied from does not affect the copy either.
+  auto abs = HloInstruction::CreateUnary(r0f32_, HloOpcode::kAbs,
+                                         constant.get());
+  abs->CopyMetadataFrom(exp.get());
+  exp->set_metadata_preserve_layout(true);
+  EXPECT_TRUE(exp->metadata().preserve_layout());
+  EXPECT_FALSE(abs->metadata().preserve_layout());
+  EXPECT_EQ(abs->metadata().op_name(), "tf_op");
+}
+
 TEST_F(HloInstructionTest, BinaryCallOp) {
   HloComputation::Builder builder(TestName());
   // Create a call instruction containing a single binary operation.
@@ -2393,6 +2439,32 @@ TEST_F(HloInstructionTest, CloneWindowOnCustomCall) {
       << clone->window().DebugString();
 }
 
+TEST_F(HloInstructionTest, CloneSharesCustomCallLiteral) {
+  auto instr = HloInstruction::CreateCustomCall(ShapeUtil::MakeShape(F32, {}),
+                                                /*operands=*/{},
+                                                /*custom_call_target=*/"foo");
+  Cast<HloCustomCallInstruction>(instr.get())
+      ->set_literal(LiteralUtil::CreateR1<float>({1, 2, 3}));
+  auto clone = instr->Clone();
+  EXPECT_EQ(&clone->literal(), &instr->literal());
+  EXPECT_TRUE(instr->Identical(*clone));
+}
+
+TEST_F(HloInstructionTest, RelayoutClonedConstant) {
+  auto constant = HloInstruction::CreateConstant(
+      LiteralUtil::CreateR2<float>({{1, 2, 3}, {4, 5, 6}}));
+  auto clone = constant->Clone();
+  EXPECT_EQ(&clone->literal(), &constant->literal());
+
+  Layout new_layout = LayoutUtil::MakeLayout({0, 1});
+  Cast<HloConstantInstruction>(clone.get())->RelayoutConstant(new_layout);
+  EXPECT_EQ(clone->literal().shape().layout(), new_layout);
+  EXPECT_EQ(constant->literal().shape().layout(),
+            LayoutUtil::MakeLayout({1, 0}));
+  EXPECT_TRUE(clone->literal().Equal(constant->literal(),
+                                     /*layout_sensitive=*/false));
+}
+
 TEST_F(HloInstructionTest, CloneDnumsOnCustomCall) {
   auto instr = HloInstruction::CreateCustomCall(ShapeUtil::MakeShape(F32, {}),
                                                 /*operands=*/{},
@@ -388,6 +388,10 @@ TokKind HloLexer::LexPercent() {
 // int ::=  [-]?[0-9]+
 // negative inf ::= '-inf'
 TokKind HloLexer::LexNumberOrPattern() {
+  if (std::optional<TokKind> kind = LexPlainNumber()) {
+    return *kind;
+  }
+
   absl::string_view consumable = StringViewFromPointers(
       token_state_.token_start, buf_.data() + buf_.size());
   static LazyRE2 float_pattern = {
@@ -464,6 +468,68 @@ TokKind HloLexer::LexNumberOrPattern() {
   return TokKind::kError;
 }
 
+// Lexes integers and floating-point values without running the regular
+// expressions in LexNumberOrPattern, which dominate the time spent parsing
+// large literals. Returns nullopt if the token may be a pattern or another
+// number syntax, in which case nothing is consumed.
+std::optional<TokKind> HloLexer::LexPlainNumber() {
+  const char* ptr = token_state_.token_start;
+  const char* end = buf_.data() + buf_.size();
+  auto skip_digits = [&](const char* p) {
+    while (p != end && absl::ascii_isdigit(*p)) ++p;
+    return p;
+  };
+
+  if (ptr != end && *ptr == '-') ++ptr;
+  const char* int_end = skip_digits(ptr);
+  bool has_int_digits = int_end != ptr;
+  ptr = int_end;
+
+  bool is_decimal = false;
+  if (ptr != end && *ptr == '.') {
+    const char* fraction_end = skip_digits(ptr + 1);
+    if (!has_int_digits && fraction_end == ptr + 1) return std::nullopt;
+    is_decimal = true;
+    ptr = fraction_end;
+  }
+  if (!has_int_digits && !is_decimal) return std::nullopt;
+
+  if (ptr != end && (*ptr == 'e' || *ptr == 'E')) {
+    const char* exponent = ptr + 1;
+    if (exponent != end && (*exponent == '+' || *exponent == '-')) ++exponent;
+    const char* exponent_end = skip_digits(exponent);
+    if (exponent_end != exponent) {
+      is_decimal = true;
+      ptr = exponent_end;
+    }
+  }
+
+  absl::string_view slice =
+      StringViewFromPointers(token_state_.token_start, ptr);
+  if (is_decimal) {
+    current_ptr_ = ptr;
+    CHECK(absl::SimpleAtod(slice, &token_state_.decimal_val));
+    return TokKind::kDecimal;
+  }
+
+  // Integers followed by these characters may be dim labels, dxd or pad.
+  if (ptr != end &&
+      (absl::ascii_isalnum(*ptr) || *ptr == '_' || *ptr == '?')) {
+    return std::nullopt;
+  }
+  current_ptr_ = ptr;
+  if (absl::SimpleAtoi(slice, &token_state_.int64_val)) {
+    return TokKind::kInt;
+  }
+  uint64_t uint64_val;
+  if (absl::SimpleAtoi(slice, &uint64_val)) {
+    token_state_.int64_val = absl::bit_cast<int64_t>(uint64_val);
+    return TokKind::kInt;
+  }
+  LOG(ERROR) << "Failed to parse int literal: " << slice;
+  return TokKind::kError;
+}
+
 std::pair<unsigned, unsigned> HloLexer::GetLineAndColumn(LocTy location) const {
   unsigned line_no = 1;
   const char* start = buf_.data();
@@ -196,7 +196,7 @@ void PropagateLivenessThroughWhile(
 void PropagateLivenessToParameterCallers(
     const HloInstruction* instruction,
     HloLivenessAnalysis::HloIndexMap* live_index_map, Worklist* worklist,
-    Workset* workset, CallGraph* call_graph) {
+    Workset* workset, const CallGraph* call_graph) {
   CHECK_EQ(instruction->opcode(), HloOpcode::kParameter);
   const CallGraphNode& call_graph_node =
       call_graph->GetNode(instruction->parent());
@@ -226,7 +226,7 @@ void PropagateLivenessToParameterCallers(
 void PropagateLivenessThroughControlFlow(
     const HloInstruction* instruction,
     HloLivenessAnalysis::HloIndexMap* live_index_map, Worklist* worklist,
-    Workset* workset, CallGraph* call_graph) {
+    Workset* workset, const CallGraph* call_graph) {
   const CallGraphNode& call_graph_node =
       call_graph->GetNode(instruction->parent());
   if (call_graph_node.context() == CallContext::kControlFlow) {
@@ -275,7 +275,7 @@ void PropagateLivenessThroughControlFlow(
 }  // namespace
 
 HloLivenessAnalysis::HloLivenessAnalysis(const HloModule& module)
-    : module_(module), call_graph_(CallGraph::Build(&module)) {}
+    : module_(module), call_graph_(CallGraph::BuildCached(&module)) {}
 
 // Runs liveness analysis on 'module_'.
 // Initializes worklist with entry root instruction (and any instruction with
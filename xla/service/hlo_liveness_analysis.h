@@ -58,7 +58,7 @@ class HloLivenessAnalysis {
   void RunAnalysis();
 
   const HloModule& module_;
-  std::unique_ptr<CallGraph> call_graph_;
+  std::shared_ptr<const CallGraph> call_graph_;
   HloIndexMap live_index_map_;
 };
 
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/hlo_module_dce.h"
 
 #include <deque>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -37,11 +38,14 @@ namespace xla {
 
 namespace {
 
+// Makes dead while tuple elements pass through the while body. Returns whether
+// the module changed, and adds the while bodies that now have dead code to
+// `while_body_comps_to_dce`.
 absl::StatusOr<bool> RunWhileDCE(
     HloModule* module, HloLivenessAnalysis* liveness,
-    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    std::vector<HloComputation*>& while_body_comps_to_dce) {
   bool changed = false;
-  std::vector<HloComputation*> while_body_comps_to_dce;
   for (auto* computation : module->computations(execution_threads)) {
     for (auto* instruction : computation->instructions()) {
       if (instruction->opcode() != HloOpcode::kWhile) {
@@ -91,15 +95,6 @@ absl::StatusOr<bool> RunWhileDCE(
       }
     }
   }
-
-  // Run DCE on while body computations that we modified.
-  for (auto* while_body_comp : while_body_comps_to_dce) {
-    TF_ASSIGN_OR_RETURN(bool changed_for_computation,
-                        HloDCE::RunOnComputation(
-                            while_body_comp,
-                            /*remove_cross_partition_collective_ops=*/false));
-    changed |= changed_for_computation;
-  }
   return changed;
 }
 
@@ -117,8 +112,18 @@ absl::StatusOr<bool> HloModuleDCE::Run(
   // Sweep through while instructions, transforming dead while tuple element
   // computations to pass through tuple values (creating dead roots in while
   // body computation in the process).
+  std::vector<HloComputation*> while_body_comps_to_dce;
   TF_ASSIGN_OR_RETURN(bool hlo_module_dce_changed,
-                      RunWhileDCE(module, liveness.get(), execution_threads));
+                      RunWhileDCE(module, liveness.get(), execution_threads,
+                                  while_body_comps_to_dce));
+
+  // Clean up the while bodies that we modified, so that the while loop
+  // simplifier sees the dead tuple elements as unused.
+  HloDCE hlo_dce;
+  TF_ASSIGN_OR_RETURN(
+      bool while_body_dce_changed,
+      hlo_dce.RunOnComputations(module, while_body_comps_to_dce));
+  hlo_module_dce_changed |= while_body_dce_changed;
 
   // Run the while loop simplifier to remove dead tuple elements.
   WhileLoopSimplifier while_loop_simplifier;
@@ -129,10 +134,15 @@ absl::StatusOr<bool> HloModuleDCE::Run(
   TF_ASSIGN_OR_RETURN(bool tuple_simplifier_changed,
                       tuple_simplifier.Run(module, execution_threads));
 
-  // Run HloDCE to clean up any dead code created during HloModuleDCE.
-  HloDCE hlo_dce;
-  TF_ASSIGN_OR_RETURN(bool hlo_dce_changed,
-                      hlo_dce.Run(module, execution_threads));
+  // Run HloDCE to clean up any dead code created during HloModuleDCE. The
+  // simplifiers do not report which computations they changed, so the whole
+  // module is only scanned if they changed anything. Dead code from the while
+  // bodies was removed above.
+  bool hlo_dce_changed = false;
+  if (while_loop_simplifier_changed || tuple_simplifier_changed) {
+    TF_ASSIGN_OR_RETURN(hlo_dce_changed,
+                        hlo_dce.Run(module, execution_threads));
+  }
 
   VLOG(2) << "After HloModuleDCE:";
   XLA_VLOG_LINES(3, module->ToString());
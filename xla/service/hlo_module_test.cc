@@ -24,7 +24,9 @@ limitations under the License.
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -41,6 +43,7 @@ limitations under the License.
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/lib/strings/proto_serialization.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla {
@@ -408,6 +411,38 @@ ENTRY %axpy.v5 (alpha: f32[], x: f32[2,4], y: f32[2,4]) -> f32[2,4] {
                              op::Broadcast(), op::Multiply(), op::Add()));
 }
 
+TEST_F(HloModuleTest, ProtoSerializationSharesIdenticalMetadata) {
+  const std::string text = R"(
+HloModule axpy_module
+
+ENTRY %axpy.v5 (alpha: f32[], x: f32[2,4], y: f32[2,4]) -> f32[2,4] {
+  %alpha = f32[] parameter(0)
+  %x = f32[2,4]{1,0} parameter(1)
+  %y = f32[2,4]{1,0} parameter(2)
+  %broadcast = f32[2,4]{1,0} broadcast(f32[] %alpha), dimensions={}, metadata={op_name="axpy" source_file="axpy.py" source_line=3}
+  %multiply = f32[2,4]{1,0} multiply(f32[2,4]{1,0} %broadcast, f32[2,4]{1,0} %x), metadata={op_name="axpy" source_file="axpy.py" source_line=3}
+  ROOT %add = f32[2,4]{1,0} add(f32[2,4]{1,0} %multiply, f32[2,4]{1,0} %y), metadata={op_name="axpy" source_file="axpy.py" source_line=4}
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(text));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module_copy,
+      HloModule::CreateFromProto(module->ToProto(), module->config()));
+
+  HloComputation* entry = module_copy->entry_computation();
+  HloInstruction* broadcast = entry->GetInstructionWithName("broadcast");
+  HloInstruction* multiply = entry->GetInstructionWithName("multiply");
+  HloInstruction* add = entry->GetInstructionWithName("add");
+  EXPECT_EQ(&broadcast->metadata(), &multiply->metadata());
+  EXPECT_NE(&multiply->metadata(), &add->metadata());
+  EXPECT_EQ(add->metadata().source_line(), 4);
+
+  // Updating shared metadata doesn't affect the other instructions.
+  multiply->set_metadata_op_name("multiply");
+  EXPECT_EQ(broadcast->metadata().op_name(), "axpy");
+  EXPECT_EQ(multiply->metadata().op_name(), "multiply");
+}
+
 TEST_F(HloModuleTest, ProtoSerializationPreservesIds) {
   // Verify that serializing then deserializing an HLO proto preserves the
   // unique IDs of the instruction and module.
@@ -947,6 +982,53 @@ ENTRY main {
   EXPECT_EQ(stack_frame.column, location->column());
 }
 
+// Builds a module whose printed form is larger than the chunks hashed by
+// FingerprintPrinter.
+std::string MakeLargeModuleText(float last_constant) {
+  std::string text = "HloModule large\n\nENTRY main {\n";
+  text += "  add.0 = f32[] parameter(0)\n";
+  for (int i = 1; i <= 2000; ++i) {
+    float value = i == 2000 ? last_constant : 1.0f;
+    absl::StrAppend(&text, "  constant.", i, " = f32[] constant(", value,
+                    ")\n", "  add.", i, " = f32[] add(add.", i - 1,
+                    ", constant.", i, ")\n");
+  }
+  text += "  ROOT result = f32[] negate(add.2000)\n}\n";
+  return text;
+}
+
+TEST_F(HloModuleTest, Fingerprint128OfSmallModuleHashesPrintedModule) {
+  const char* const hlo_string = R"(
+HloModule small
+
+ENTRY main {
+  p0 = f32[4] parameter(0)
+  ROOT negate = f32[4] negate(p0)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  const tsl::Fprint128 fingerprint = tsl::Fingerprint128(
+      module->ToString(HloPrintOptions::ModuleFingerprint()));
+  EXPECT_EQ(module->GetFingerprint128(),
+            absl::BytesToHexString(absl::string_view(
+                reinterpret_cast<const char*>(&fingerprint),
+                sizeof(fingerprint))));
+}
+
+TEST_F(HloModuleTest, Fingerprint128OfLargeModule) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(MakeLargeModuleText(1)));
+  TF_ASSERT_OK_AND_ASSIGN(auto same_module,
+                          ParseAndReturnVerifiedModule(MakeLargeModuleText(1)));
+  TF_ASSERT_OK_AND_ASSIGN(auto other_module,
+                          ParseAndReturnVerifiedModule(MakeLargeModuleText(2)));
+  ASSERT_GT(module->ToString(HloPrintOptions::ModuleFingerprint()).size(),
+            64 << 10);
+
+  EXPECT_EQ(module->GetFingerprint128(), same_module->GetFingerprint128());
+  EXPECT_NE(module->GetFingerprint128(), other_module->GetFingerprint128());
+}
+
 }  // namespace
 
 }  // namespace xla
@@ -1175,6 +1175,11 @@ bool HloParserImpl::ParseHloModule(HloModule* module,
 }
 
 // computations ::= (computation)+
+//
+// TODO: Split the input at computation boundaries and parse computations in
+// parallel, and decode large constant literals lazily. That needs the lexer and
+// scoped_name_tables_ to be split per computation, and references through
+// computation_pool_ to be resolved after all computations are parsed.
 bool HloParserImpl::ParseComputations(HloModule* module) {
   HloComputation* entry_computation = nullptr;
   do {
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/hlo_parser.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -31,6 +32,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_sharding.h"
+#include "xla/literal_util.h"
 #include "xla/service/pattern_matcher.h"
 #include "xla/service/pattern_matcher_gmock.h"
 #include "xla/shape.h"
@@ -42,6 +44,7 @@ limitations under the License.
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/test_benchmark.h"
 
 namespace xla {
 namespace {
@@ -5306,5 +5309,43 @@ TEST_F(HloParserTest, ReplicaIdWithLayout) {
                    .empty());
 }
 
+TEST_F(HloParserTest, ParseNumbersInLiterals) {
+  const char* const hlo_string = R"(
+  HloModule Numbers
+
+  ENTRY Numbers {
+    ints = s64[5] constant({0, -7, 42, 9223372036854775807, -12})
+    floats = f32[6] constant({1., -.5, 2.5e3, -1E-2, 3e+1, -0})
+    ROOT tuple = (s64[5], f32[6]) tuple(ints, floats)
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnUnverifiedModule(hlo_string));
+  const HloInstruction* root = module->entry_computation()->root_instruction();
+  EXPECT_EQ(root->operand(0)->literal(),
+            LiteralUtil::CreateR1<int64_t>(
+                {0, -7, 42, 9223372036854775807, -12}));
+  EXPECT_EQ(root->operand(1)->literal(),
+            LiteralUtil::CreateR1<float>({1.0f, -0.5f, 2500.0f, -0.01f, 30.0f,
+                                          0.0f}));
+}
+
+void BM_ParseLargeConstant(::testing::benchmark::State& state) {
+  const int64_t num_elements = state.range(0);
+  std::string hlo_string = absl::StrCat(
+      "HloModule LargeConstant\n\nENTRY main {\n  ROOT c = f32[",
+      num_elements, "] constant({");
+  for (int64_t i = 0; i < num_elements; ++i) {
+    absl::StrAppend(&hlo_string, i == 0 ? "" : ", ", i % 1000, ".25");
+  }
+  absl::StrAppend(&hlo_string, "})\n}\n");
+
+  for (auto s : state) {
+    CHECK_OK(ParseAndReturnUnverifiedModule(hlo_string).status());
+  }
+  state.SetBytesProcessed(state.iterations() * hlo_string.size());
+}
+BENCHMARK(BM_ParseLargeConstant)->Range(1 << 10, 1 << 20);
+
 }  // namespace
 }  // namespace xla
@@ -0,0 +1,98 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hlo_pass_interface.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+
+absl::StatusOr<bool> HloComputationPass::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  std::vector<HloComputation*> computations =
+      module->MakeComputationPostOrder(execution_threads);
+
+  // Running on a thread of the pool could deadlock while waiting for tasks
+  // scheduled on the same pool.
+  bool changed = false;
+  if (thread_pool_ == nullptr || thread_pool_->NumThreads() <= 1 ||
+      thread_pool_->CurrentThreadId() != -1 || computations.size() <= 1) {
+    for (HloComputation* computation : computations) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed,
+                          RunOnComputation(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  // Group the computations into levels, such that computations only call
+  // computations of lower levels. The computations of a level are independent
+  // of each other, and those they call have been processed by the time the
+  // level is run.
+  absl::flat_hash_map<const HloComputation*, int> computation_levels;
+  std::vector<std::vector<HloComputation*>> levels;
+  for (HloComputation* computation : computations) {
+    int level = 0;
+    for (const HloInstruction* instruction : computation->instructions()) {
+      for (const HloComputation* callee : instruction->called_computations()) {
+        if (auto it = computation_levels.find(callee);
+            it != computation_levels.end()) {
+          level = std::max(level, it->second + 1);
+        }
+      }
+    }
+    computation_levels[computation] = level;
+    if (level >= levels.size()) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(computation);
+  }
+
+  for (const std::vector<HloComputation*>& level : levels) {
+    std::vector<absl::StatusOr<bool>> results(level.size(), false);
+    absl::BlockingCounter counter(level.size());
+    for (int i = 0; i < level.size(); ++i) {
+      thread_pool_->Schedule([&, i] {
+        results[i] = RunOnComputation(level[i]);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    // Check the results in order, so that the same error is reported for
+    // every run.
+    for (absl::StatusOr<bool>& result : results) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed, std::move(result));
+      changed |= computation_changed;
+    }
+  }
+  VLOG(2) << name() << " ran on " << computations.size() << " computations in "
+          << levels.size() << " parallel steps";
+  return changed;
+}
+
+}  // namespace xla
@@ -23,6 +23,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_module_group.h"
 #include "xla/status_macros.h"
 #include "xla/types.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -140,6 +141,11 @@ class HloPassInterface {
       const absl::flat_hash_set<absl::string_view>& execution_threads) = 0;
 
   virtual bool IsPassPipeline() { return false; }
+
+  // Lets the pass run on independent computations concurrently using
+  // `thread_pool`, if it supports that (see HloComputationPass). Null makes it
+  // run serially again.
+  virtual void SetComputationThreadPool(tsl::thread::ThreadPool* thread_pool) {}
 };
 
 // Base class for passes which are module-scoped.
@@ -168,6 +174,38 @@ class HloModulePass : public HloPassInterface {
   virtual void UpdateLayout(Shape* shape) {}
 };
 
+// A pass which transforms each computation of a module independently of the
+// other computations. Such passes can run on several computations
+// concurrently, with deterministic results, if given a thread pool via
+// SetComputationThreadPool().
+class HloComputationPass : public HloModulePass {
+ public:
+  // Runs the pass on `computation`. Returns whether it changed `computation`.
+  //
+  // This can be called concurrently for different computations of the same
+  // module, so it must only modify `computation` and the instructions in it,
+  // must not add instructions or computations to the module, and may only
+  // read the computations called from `computation`, which have always been
+  // processed before.
+  virtual absl::StatusOr<bool> RunOnComputation(
+      HloComputation* computation) = 0;
+
+  // Runs RunOnComputation on all computations of `module`, callees before
+  // callers.
+  using HloPassInterface::Run;
+  absl::StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+  void SetComputationThreadPool(
+      tsl::thread::ThreadPool* thread_pool) override {
+    thread_pool_ = thread_pool;
+  }
+
+ private:
+  tsl::thread::ThreadPool* thread_pool_ = nullptr;
+};
+
 // Base class for passes which are module-group scoped. These passes cannot run
 // on an HLO module.
 class HloModuleGroupPass : public HloPassInterface {
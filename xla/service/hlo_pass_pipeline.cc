@@ -15,9 +15,14 @@ limitations under the License.
 
 #include "xla/service/hlo_pass_pipeline.h"
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_format.h"
@@ -37,12 +42,27 @@ namespace xla {
 
 namespace {
 
+// Returns the high-water mark of the resident memory of this process in bytes,
+// or 0 if it's not available.
+int64_t PeakMemoryBytes() {
+#if defined(__linux__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is in kilobytes on Linux.
+    return int64_t{usage.ru_maxrss} * 1024;
+  }
+#endif  // defined(__linux__)
+  return 0;
+}
+
 void RecordPassStartMetadata(HloModule& module, const std::string& pass_name,
                              const std::string& pipeline_name) {
   module.metadata()->RecordPassStart();
   // An HloPassMetadata was just created so absl::Status should always be OK.
   TF_CHECK_OK(module.metadata()->set_current_pass_name(pass_name));
   TF_CHECK_OK(module.metadata()->set_current_pass_pipeline_name(pipeline_name));
+  TF_CHECK_OK(module.metadata()->set_current_pass_instruction_count_before(
+      module.instruction_count()));
 }
 
 void RecordPassStartMetadata(HloModuleGroup& module_group,
@@ -62,6 +82,11 @@ absl::Status AttemptRecordPassEndMetadata(HloModule& module,
       module.metadata()->set_current_pass_module_id(module.unique_id()));
   TF_RETURN_IF_ERROR(
       module.metadata()->set_current_pass_module_changed(module_changed));
+  TF_RETURN_IF_ERROR(
+      module.metadata()->set_current_pass_instruction_count_after(
+          module.instruction_count()));
+  TF_RETURN_IF_ERROR(
+      module.metadata()->set_current_pass_peak_memory_bytes(PeakMemoryBytes()));
   TF_RETURN_IF_ERROR(module.metadata()->RecordPassEnd());
   return absl::OkStatus();
 }
@@ -141,6 +166,11 @@ absl::StatusOr<bool> HloPassPipeline::RunPassesInternal(
     HloT* hlo, const DebugOptions& debug_options,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
   auto passes = GetEnabledPasses(debug_options);
+  if (computation_thread_pool_ != nullptr) {
+    for (HloPassInterface* pass : passes) {
+      pass->SetComputationThreadPool(computation_thread_pool_);
+    }
+  }
   // Copy string by value since debug options could get clobbered in an hlo
   // module group pass.
   std::string dump_regex = debug_options.xla_dump_hlo_pass_re();
@@ -27,6 +27,7 @@ limitations under the License.
 #include "xla/service/compilation_stats.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/types.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -89,6 +90,13 @@ class HloPassPipeline : public HloPassInterface {
 
   bool IsPassPipeline() override { return true; }
 
+  // Passes `thread_pool` on to all passes of the pipeline when it runs, so
+  // that the ones which support it run on independent computations
+  // concurrently.
+  void SetComputationThreadPool(tsl::thread::ThreadPool* thread_pool) override {
+    computation_thread_pool_ = thread_pool;
+  }
+
   // Return size of passes_.
   int PassesSize() { return passes_.size(); }
   // Return reference to pass specified by index.
@@ -155,6 +163,7 @@ class HloPassPipeline : public HloPassInterface {
   std::vector<std::unique_ptr<HloPassInterface>> passes_;
   std::vector<std::unique_ptr<HloPassInterface>> invariant_checkers_;
   bool run_called_ = false;
+  tsl::thread::ThreadPool* computation_thread_pool_ = nullptr;
 
   CompilationStats* compilation_stats_;
   // Default stats instance for when one is not passed in the constructor.
@@ -15,13 +15,18 @@ limitations under the License.
 
 #include "xla/service/hlo_pass_pipeline.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/hlo_parser.h"
+#include "xla/service/hlo_pass_interface.h"
 #include "xla/tests/hlo_test_base.h"
 #include "xla/util.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace {
@@ -113,6 +118,26 @@ class BazToQuxModuleGroupPass : public HloModuleGroupPass {
   }
 };
 
+// A computation pass which prefixes the name of the root instruction of each
+// computation with 'done', and fails if a called computation has not been
+// processed yet.
+class MarkDoneComputationPass : public HloComputationPass {
+  absl::string_view name() const override { return "mark-done"; }
+
+  absl::StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    for (HloInstruction* instruction : computation->instructions()) {
+      for (HloComputation* callee : instruction->called_computations()) {
+        if (!absl::StartsWith(callee->root_instruction()->name(), "done")) {
+          return Internal("Callee %s was not processed", callee->name());
+        }
+      }
+    }
+    HloInstruction* root = computation->root_instruction();
+    root->SetAndSanitizeName(absl::StrCat("done_", root->name()));
+    return true;
+  }
+};
+
 // An invariant checker pass which returns an error if there exists an
 // instruction named 'bar'.
 class BarBlowerUpper : public HloModulePass {
@@ -363,6 +388,73 @@ ENTRY main {
       ::testing::HasSubstr("Module group pass cannot be run on a module"));
 }
 
+TEST_F(HloPassPipelineTest, ComputationPassRunsInParallel) {
+  const std::string module_str = R"(
+HloModule ComputationPassRunsInParallel
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT sum = f32[] add(lhs, rhs)
+}
+
+fused_reduce {
+  p0 = f32[16] parameter(0)
+  zero = f32[] constant(0)
+  ROOT r = f32[] reduce(p0, zero), dimensions={0}, to_apply=add
+}
+
+fused_negate {
+  p0 = f32[16] parameter(0)
+  ROOT neg = f32[16] negate(p0)
+}
+
+ENTRY main {
+  a = f32[16] parameter(0)
+  negate = f32[16] fusion(a), kind=kLoop, calls=fused_negate
+  ROOT reduce = f32[] fusion(negate), kind=kInput, calls=fused_reduce
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test",
+                                      /*num_threads=*/4);
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<MarkDoneComputationPass>();
+  pipeline.SetComputationThreadPool(&thread_pool);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pipeline.Run(module.get()));
+  EXPECT_TRUE(changed);
+  for (const HloComputation* computation : module->computations()) {
+    EXPECT_TRUE(
+        absl::StartsWith(computation->root_instruction()->name(), "done_"));
+  }
+}
+
+TEST_F(HloPassPipelineTest, RecordsPassProfile) {
+  const std::string module_str = R"(
+HloModule RecordsPassProfile
+
+ENTRY main {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  ROOT foo = f32[] multiply(a, b)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<FooToBarModulePass>();
+  TF_ASSERT_OK(pipeline.Run(module.get()).status());
+
+  const HloModuleMetadataProto& metadata = module->metadata().proto();
+  ASSERT_THAT(metadata.pass_metadata(), SizeIs(2));
+  const HloPassMetadata& pass_metadata = metadata.pass_metadata(1);
+  EXPECT_THAT(pass_metadata.pass_name(), StrEq("foo2bar"));
+  EXPECT_EQ(pass_metadata.instruction_count_before(), 3);
+  EXPECT_EQ(pass_metadata.instruction_count_after(), 3);
+  EXPECT_GE(pass_metadata.peak_memory_bytes(), 0);
+}
+
 // Test that metadata is set when a module group goes through a pass pipeline.
 TEST_F(HloPassPipelineTest, SetHloModuleMetadata) {
   HloModuleGroup module_group(TestName());
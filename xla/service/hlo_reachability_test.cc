@@ -87,6 +87,41 @@ TEST_F(HloReachabilityTest, Reachability) {
   EXPECT_FALSE(reachability.SetReachabilityToUnion({b, c}, d));
 }
 
+TEST_F(HloReachabilityTest, ReachabilityAcrossManyWords) {
+  // Two independent chains of 100 negates each, so that the reachability sets
+  // span several 64-bit words starting at different offsets.
+  auto builder = HloComputation::Builder(TestName());
+  Shape r0f32 = ShapeUtil::MakeShape(F32, {});
+  HloInstruction* first_chain = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, r0f32, "p0"));
+  HloInstruction* first_start = first_chain;
+  for (int i = 0; i < 100; ++i) {
+    first_chain = builder.AddInstruction(
+        HloInstruction::CreateUnary(r0f32, HloOpcode::kNegate, first_chain));
+  }
+  HloInstruction* second_chain = builder.AddInstruction(
+      HloInstruction::CreateParameter(1, r0f32, "p1"));
+  HloInstruction* second_start = second_chain;
+  for (int i = 0; i < 100; ++i) {
+    second_chain = builder.AddInstruction(
+        HloInstruction::CreateUnary(r0f32, HloOpcode::kNegate, second_chain));
+  }
+  HloInstruction* add = builder.AddInstruction(HloInstruction::CreateBinary(
+      r0f32, HloOpcode::kAdd, first_chain, second_chain));
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(builder.Build(add));
+
+  auto reachability = HloReachabilityMap::Build(computation);
+  EXPECT_TRUE(reachability->IsReachable(first_start, first_chain));
+  EXPECT_TRUE(reachability->IsReachable(second_start, second_chain));
+  EXPECT_TRUE(reachability->IsReachable(first_start, add));
+  EXPECT_TRUE(reachability->IsReachable(second_start, add));
+  EXPECT_FALSE(reachability->IsConnected(first_start, second_chain));
+  EXPECT_FALSE(reachability->IsConnected(second_start, first_chain));
+  EXPECT_FALSE(reachability->IsReachable(add, first_start));
+}
+
 TEST_F(HloReachabilityTest, NonTrivialReachability) {
   // Test reachability of a non-trivial computation:
   //
@@ -265,6 +265,29 @@ class InstructionList {
   Item* prev(Item* item) const { return item->prev; }
   const Item* prev(const Item* item) const { return item->prev; }
 
+  // Returns the first item in the list that is not after any user in 'uses',
+  // or the first item of the list if 'uses' is empty. No user comes before
+  // the returned item, so searches for users can start there.
+  const Item* FirstItemNotAfterUsers(const UsesList& uses) const {
+    const Item* min_position_item = nullptr;
+    for (const ItemUse& use : uses) {
+      if (min_position_item == nullptr ||
+          use.user->position < min_position_item->position) {
+        min_position_item = use.user;
+      }
+    }
+    if (min_position_item == nullptr) {
+      return first_;
+    }
+    // Items with the same position are in no particular order, so move to
+    // the first of them.
+    while (min_position_item->prev != nullptr &&
+           min_position_item->prev->position == min_position_item->position) {
+      min_position_item = min_position_item->prev;
+    }
+    return min_position_item;
+  }
+
   Item* first_skip_node() const { return first_skip_node_; }
   Item* next_skip_node(Item* item) const { return item->next_skip_node; }
 
@@ -1767,8 +1790,9 @@ std::optional<int64_t> MemoryUsageTracker::GetCostOfHostOffload(
       GetPlacedAndUnplacedUsers(output_buffer.users);
   const Item* last_placed_user = nullptr;
   const Item* first_unplaced_user = nullptr;
-  for (const auto* item = instruction_list_.first(); item != nullptr;
-       item = instruction_list_.next(item)) {
+  for (const auto* item =
+           instruction_list_.FirstItemNotAfterUsers(output_buffer.users);
+       item != nullptr; item = instruction_list_.next(item)) {
     if (absl::c_find_if(placed_uses, [&](const auto& use) {
           return use.user == item;
         }) != placed_uses.end()) {
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/host_memory_transfer_asyncifier.h"
 
 #include <cstdint>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
@@ -27,6 +28,10 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/layout.h"
+#include "xla/layout_util.h"
+#include "xla/literal_util.h"
+#include "xla/shape.h"
 #include "xla/shape_util.h"
 #include "xla/util.h"
 #include "tsl/platform/errors.h"
@@ -38,8 +43,10 @@ namespace {
 
 class HostMemoryTransferAsyncifierVisitor : public DfsHloVisitorWithDefault {
  public:
-  explicit HostMemoryTransferAsyncifierVisitor(int64_t host_memory_space_color)
-      : kHostMemorySpaceColor(host_memory_space_color) {}
+  HostMemoryTransferAsyncifierVisitor(int64_t host_memory_space_color,
+                                      int64_t prefetch_slice_count)
+      : kHostMemorySpaceColor(host_memory_space_color),
+        prefetch_slice_count_(prefetch_slice_count) {}
   bool Changed() const { return changed_; }
 
   absl::Status DefaultAction(HloInstruction* hlo_instruction) override {
@@ -175,6 +182,13 @@ class HostMemoryTransferAsyncifierVisitor : public DfsHloVisitorWithDefault {
       return absl::OkStatus();
     }
 
+    if (copy_src_memory_space == kHostMemorySpaceColor) {
+      TF_ASSIGN_OR_RETURN(bool sliced, SlicePrefetch(copy));
+      if (sliced) {
+        return absl::OkStatus();
+      }
+    }
+
     // Everything is as expected. Replace this copy with the async equivalent.
     VLOG(1)
         << "Copy \"" << copy->name()
@@ -189,7 +203,63 @@ class HostMemoryTransferAsyncifierVisitor : public DfsHloVisitorWithDefault {
   }
 
  private:
+  // Replaces a host to device copy with `prefetch_slice_count_` async
+  // dynamic-slices along the most major dimension, concatenated on the device.
+  // Each slice is contiguous in host memory, and consumers fused with the
+  // concatenate read the slices directly. Returns false if the copy is not
+  // sliced.
+  absl::StatusOr<bool> SlicePrefetch(HloInstruction* copy) {
+    HloInstruction* operand = copy->mutable_operand(0);
+    const Shape& shape = copy->shape();
+    if (prefetch_slice_count_ <= 1 || !shape.IsArray() || shape.rank() == 0 ||
+        !Layout::Equal().IgnoreMemorySpace()(operand->shape().layout(),
+                                             shape.layout())) {
+      return false;
+    }
+    const int64_t major_dim = LayoutUtil::Major(shape.layout(), 0);
+    const int64_t major_dim_size = shape.dimensions(major_dim);
+    if (major_dim_size < prefetch_slice_count_ ||
+        major_dim_size % prefetch_slice_count_ != 0) {
+      return false;
+    }
+    const int64_t slice_size = major_dim_size / prefetch_slice_count_;
+
+    VLOG(1) << "Copy \"" << copy->name() << "\" is from host memory. Slicing "
+            << "it into " << prefetch_slice_count_ << " async dynamic-slices.";
+    HloComputation* computation = copy->parent();
+    Shape slice_shape = shape;
+    slice_shape.set_dimensions(major_dim, slice_size);
+    std::vector<int64_t> slice_sizes(slice_shape.dimensions().begin(),
+                                     slice_shape.dimensions().end());
+    HloInstruction* zero = computation->AddInstruction(
+        HloInstruction::CreateConstant(LiteralUtil::CreateR0<int32_t>(0)));
+    const Shape context_shape = ShapeUtil::MakeScalarShape(U32);
+    const Shape transfer_bytes_shape = ShapeUtil::MakeScalarShape(S32);
+    std::vector<HloInstruction*> slices;
+    slices.reserve(prefetch_slice_count_);
+    for (int64_t i = 0; i < prefetch_slice_count_; ++i) {
+      std::vector<HloInstruction*> offsets(shape.rank(), zero);
+      offsets[major_dim] = computation->AddInstruction(
+          HloInstruction::CreateConstant(LiteralUtil::CreateR0<int32_t>(
+              static_cast<int32_t>(i * slice_size))));
+      HloInstruction* slice =
+          computation->AddInstruction(HloInstruction::CreateDynamicSlice(
+              slice_shape, operand, offsets, slice_sizes));
+      TF_ASSIGN_OR_RETURN(
+          HloInstruction * async_done,
+          computation->CreateAsyncInstructions(
+              slice, {context_shape, transfer_bytes_shape}));
+      slices.push_back(async_done);
+    }
+    HloInstruction* concatenate = computation->AddInstruction(
+        HloInstruction::CreateConcatenate(shape, slices, major_dim));
+    TF_RETURN_IF_ERROR(computation->ReplaceInstruction(copy, concatenate));
+    MarkAsChanged();
+    return true;
+  }
+
   const int64_t kHostMemorySpaceColor;
+  const int64_t prefetch_slice_count_;
   bool changed_ = false;
 
   void MarkAsChanged() { changed_ = true; }
@@ -200,7 +270,8 @@ class HostMemoryTransferAsyncifierVisitor : public DfsHloVisitorWithDefault {
 absl::StatusOr<bool> HostMemoryTransferAsyncifier::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
-  HostMemoryTransferAsyncifierVisitor visitor(kHostMemorySpaceColor);
+  HostMemoryTransferAsyncifierVisitor visitor(kHostMemorySpaceColor,
+                                              prefetch_slice_count_);
   for (HloComputation* computation : module->MakeNonfusionComputations()) {
     TF_RETURN_IF_ERROR(computation->Accept(&visitor));
   }
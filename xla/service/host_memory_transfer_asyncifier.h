@@ -28,16 +28,22 @@ This pass finds copies between the host memory and device memory and converts
 them into the async ops. This includes, but is not limited to:
  - device to host DynamicUpdateSlice
  - host to device DynamicSlice
+ - host to device Copy, optionally sliced into several async DynamicSlices
+   along the most major dimension, so that the first slices arrive before the
+   whole buffer has been transferred
+ - device to host Copy
 * The examples below are not yet supported *
  - host to device DynamicUpdateSlice
  - device to host DynamicSlice
- - host to device Copy
- - device to host Copy
 */
 class HostMemoryTransferAsyncifier : public HloModulePass {
  public:
-  explicit HostMemoryTransferAsyncifier(int64_t host_memory_space_color)
-      : kHostMemorySpaceColor(host_memory_space_color) {}
+  // If `prefetch_slice_count` is greater than 1, host to device copies whose
+  // most major dimension is a multiple of it are split into that many slices.
+  explicit HostMemoryTransferAsyncifier(int64_t host_memory_space_color,
+                                        int64_t prefetch_slice_count = 1)
+      : kHostMemorySpaceColor(host_memory_space_color),
+        prefetch_slice_count_(prefetch_slice_count) {}
   ~HostMemoryTransferAsyncifier() override = default;
 
   absl::string_view name() const override {
@@ -51,6 +57,7 @@ class HostMemoryTransferAsyncifier : public HloModulePass {
 
  private:
   const int64_t kHostMemorySpaceColor;
+  const int64_t prefetch_slice_count_;
 };
 
 }  // namespace xla
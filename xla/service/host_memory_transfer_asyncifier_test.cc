@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/host_memory_transfer_asyncifier.h"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 
 #include <gmock/gmock.h>
@@ -46,13 +47,15 @@ class HostMemoryTransferAsyncifierTest : public HloTestBase {
     return changed;
   }
 
-  absl::StatusOr<bool> RunAsyncifier(HloModule* module) {
+  absl::StatusOr<bool> RunAsyncifier(HloModule* module,
+                                     int64_t prefetch_slice_count = 1) {
     TF_EXPECT_OK(verifier().Run(module).status());
     if (module->has_schedule()) {
       return absl::InternalError("Expected a non-scheduled module");
     }
 
-    HostMemoryTransferAsyncifier asyncifier(kHostMemorySpaceColor);
+    HostMemoryTransferAsyncifier asyncifier(kHostMemorySpaceColor,
+                                            prefetch_slice_count);
     return asyncifier.Run(module);
   }
 
@@ -417,6 +420,64 @@ ENTRY main {
                   0, m::Op(&copy_start).WithOpcode(HloOpcode::kCopyStart))));
 }
 
+TEST_F(HostMemoryTransferAsyncifierTest, SlicedCopyFromHostToDevice) {
+  const std::string& hlo_string = R"(
+HloModule MyModule
+
+ENTRY main {
+  host_memory = f32[32,8,16]{2,1,0:S(5)} parameter(0)
+  ROOT copy = f32[32,8,16]{2,1,0} copy(host_memory)
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed, RunAsyncifier(module.get(), /*prefetch_slice_count=*/4));
+
+  EXPECT_TRUE(changed);
+  // copy should have been split into four async dynamic-slices along the most
+  // major dimension, concatenated on the device.
+  const HloInstruction* root = module->entry_computation()->root_instruction();
+  ASSERT_THAT(root, GmockMatch(m::Concatenate()));
+  EXPECT_EQ(root->concatenate_dimension(), 0);
+  ASSERT_EQ(root->operand_count(), 4);
+  for (int64_t i = 0; i < root->operand_count(); ++i) {
+    const HloInstruction* slice_done = root->operand(i);
+    ASSERT_EQ(slice_done->opcode(), HloOpcode::kAsyncDone);
+    const HloInstruction* slice_start = slice_done->operand(0);
+    ASSERT_EQ(slice_start->opcode(), HloOpcode::kAsyncStart);
+    const HloInstruction* dynamic_slice =
+        slice_start->async_wrapped_instruction();
+    EXPECT_EQ(dynamic_slice->opcode(), HloOpcode::kDynamicSlice);
+    EXPECT_EQ(dynamic_slice->shape().dimensions(0), 8);
+    EXPECT_EQ(slice_start->operand(1)->literal().GetFirstInteger(),
+              std::optional<int64_t>(i * 8));
+  }
+}
+
+TEST_F(HostMemoryTransferAsyncifierTest, UnevenSlicedCopyFromHostToDevice) {
+  const std::string& hlo_string = R"(
+HloModule MyModule
+
+ENTRY main {
+  host_memory = f32[30,8]{1,0:S(5)} parameter(0)
+  ROOT copy = f32[30,8]{1,0} copy(host_memory)
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed, RunAsyncifier(module.get(), /*prefetch_slice_count=*/4));
+
+  EXPECT_TRUE(changed);
+  // The most major dimension is not a multiple of the slice count, so the copy
+  // is not sliced.
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              ::testing::Not(GmockMatch(m::Concatenate())));
+}
+
 // =============================================================================
 
 }  // namespace
@@ -112,14 +112,13 @@ bool CustomCallReusesBuffer(const HloInstruction* custom_call,
 // return the call itself as a successor of the ROOT instruction of the
 // computation.
 absl::StatusOr<std::vector<InstructionAndShapeIndex>> GetSuccessors(
-    const InstructionAndShapeIndex& instruction_and_shape_index) {
+    const InstructionAndShapeIndex& instruction_and_shape_index,
+    const CallGraph& call_graph) {
   std::vector<InstructionAndShapeIndex> result;
   HloInstruction* instruction = instruction_and_shape_index.instruction;
   if (instruction->IsRoot()) {
     // Successor of the root is the call instruction(s).
-    std::unique_ptr<CallGraph> call_graph =
-        CallGraph::Build(instruction->GetModule());
-    auto callers = call_graph->GetComputationCallers(instruction->parent());
+    auto callers = call_graph.GetComputationCallers(instruction->parent());
     for (HloInstruction* caller : callers) {
       result.push_back({caller, instruction_and_shape_index.shape_index});
     }
@@ -208,7 +207,8 @@ absl::StatusOr<std::vector<InstructionAndShapeIndex>> GetSuccessors(
 // instruction is a parameter, the returned predecessor will be the appropriate
 // operand of the call (not the call itself, since we already returned it).
 std::vector<InstructionAndShapeIndex> GetPredecessors(
-    const InstructionAndShapeIndex& instruction_and_shape_index) {
+    const InstructionAndShapeIndex& instruction_and_shape_index,
+    const CallGraph& call_graph) {
   std::vector<InstructionAndShapeIndex> result;
   HloInstruction* instruction = instruction_and_shape_index.instruction;
   if (instruction->opcode() == HloOpcode::kGetTupleElement) {
@@ -232,9 +232,7 @@ std::vector<InstructionAndShapeIndex> GetPredecessors(
     result.push_back({called_computation->root_instruction(),
                       instruction_and_shape_index.shape_index});
   } else if (instruction->opcode() == HloOpcode::kParameter) {
-    std::unique_ptr<CallGraph> call_graph =
-        CallGraph::Build(instruction->GetModule());
-    auto callers = call_graph->GetComputationCallers(instruction->parent());
+    auto callers = call_graph.GetComputationCallers(instruction->parent());
     for (HloInstruction* caller : callers) {
       result.push_back(
           {caller->mutable_operand(instruction->parameter_number()),
@@ -367,10 +365,8 @@ absl::StatusOr<bool> HostOffloader::WalkDownHostMemoryOffloadPaths(
         // When setting the memory space of a parameter, also set the memory
         // space of the call site of the computation with this parameter if that
         // caller is an async-start.
-        std::unique_ptr<CallGraph> call_graph =
-            CallGraph::Build(instruction->GetModule());
         std::vector<HloInstruction*> callers =
-            call_graph->GetComputationCallers(instruction->parent());
+            call_graph_->GetComputationCallers(instruction->parent());
         for (HloInstruction* caller : callers) {
           if (caller->opcode() == HloOpcode::kAsyncStart) {
             ShapeIndex tmp_index = instruction_and_shape_index.shape_index;
@@ -432,8 +428,9 @@ absl::StatusOr<bool> HostOffloader::WalkDownHostMemoryOffloadPaths(
       }
     }
     // Push successors onto the queue to be visited.
-    TF_ASSIGN_OR_RETURN(const std::vector<InstructionAndShapeIndex> successors,
-                        GetSuccessors(instruction_and_shape_index));
+    TF_ASSIGN_OR_RETURN(
+        const std::vector<InstructionAndShapeIndex> successors,
+        GetSuccessors(instruction_and_shape_index, *call_graph_));
     for (const InstructionAndShapeIndex& successor : successors) {
       queue.push(successor);
     }
@@ -453,7 +450,8 @@ absl::StatusOr<bool> HostOffloader::WalkDownHostMemoryOffloadPaths(
   }
 
   if (insert_copy_before) {
-    const auto predecessors = GetPredecessors(starting_instruction_and_index);
+    const auto predecessors =
+        GetPredecessors(starting_instruction_and_index, *call_graph_);
     CHECK_EQ(predecessors.size(), 1);
     TF_ASSIGN_OR_RETURN(bool inserted_copy,
                         InsertCopyBetween(predecessors.front(),
@@ -622,10 +620,8 @@ absl::StatusOr<bool> HostOffloader::InsertCopyBetween(
     // To insert a copy between an instruction and a parameter means we actually
     // want to insert a copy between the instruction and the call site of the
     // computation with this parameter.
-    std::unique_ptr<CallGraph> call_graph =
-        CallGraph::Build(after_instruction->GetModule());
     auto callers =
-        call_graph->GetComputationCallers(after_instruction->parent());
+        call_graph_->GetComputationCallers(after_instruction->parent());
     for (HloInstruction* caller : callers) {
       const auto indices =
           caller->OperandIndices(before_instruction_and_index.instruction);
@@ -686,7 +682,8 @@ HostOffloader::GetStartingInstructions(
   std::queue<InstructionAndShapeIndex> queue;
   TF_ASSIGN_OR_RETURN(
       const std::vector<InstructionAndShapeIndex> successors_of_custom_call,
-      GetSuccessors(InstructionAndShapeIndex(custom_call_instruction)));
+      GetSuccessors(InstructionAndShapeIndex(custom_call_instruction),
+                    *call_graph_));
   for (const InstructionAndShapeIndex& successor : successors_of_custom_call) {
     queue.push(successor);
   }
@@ -707,7 +704,7 @@ HostOffloader::GetStartingInstructions(
       // Is a logical bitcast/reshape, we won't offload this yet.
     }
     TF_ASSIGN_OR_RETURN(const std::vector<InstructionAndShapeIndex> successors,
-                        GetSuccessors(instruction_and_shape));
+                        GetSuccessors(instruction_and_shape, *call_graph_));
     for (const InstructionAndShapeIndex& successor : successors) {
       queue.push(successor);
     }
@@ -729,7 +726,7 @@ absl::Status HostOffloader::ValidateSliceLeadsToMoveToDeviceCustomCall(
   std::queue<InstructionAndShapeIndex> queue;
   TF_ASSIGN_OR_RETURN(
       const std::vector<InstructionAndShapeIndex> successors_of_slice,
-      GetSuccessors(InstructionAndShapeIndex(slice)));
+      GetSuccessors(InstructionAndShapeIndex(slice), *call_graph_));
   for (const InstructionAndShapeIndex& successor : successors_of_slice) {
     queue.push(successor);
   }
@@ -751,7 +748,7 @@ absl::Status HostOffloader::ValidateSliceLeadsToMoveToDeviceCustomCall(
           slice->name(), current_instruction->name()));
     }
     TF_ASSIGN_OR_RETURN(const std::vector<InstructionAndShapeIndex> successors,
-                        GetSuccessors(instruction_and_shape));
+                        GetSuccessors(instruction_and_shape, *call_graph_));
     for (const InstructionAndShapeIndex& successor : successors) {
       queue.push(successor);
     }
@@ -790,10 +787,8 @@ absl::Status HostOffloader::CreateAllocateBufferForDynamicUpdateSlice(
       // If this is a parameter of a while_body, we also need to find the
       // matching parameter in the while_condition and set the memory spaces
       // there.
-      std::unique_ptr<CallGraph> call_graph =
-          CallGraph::Build(instruction->GetModule());
       const std::vector<HloInstruction*> callers =
-          call_graph->GetComputationCallers(instruction->parent());
+          call_graph_->GetComputationCallers(instruction->parent());
       for (HloInstruction* caller : callers) {
         if (caller->opcode() == HloOpcode::kWhile) {
           // This parameter belongs to a while.
@@ -837,7 +832,7 @@ absl::Status HostOffloader::CreateAllocateBufferForDynamicUpdateSlice(
                 kHostMemorySpaceColor);
             TF_ASSIGN_OR_RETURN(
                 const std::vector<InstructionAndShapeIndex> successors,
-                GetSuccessors(nested_instruction_and_shape));
+                GetSuccessors(nested_instruction_and_shape, *call_graph_));
             for (const InstructionAndShapeIndex& successor : successors) {
               nested_queue.push(successor);
             }
@@ -850,7 +845,7 @@ absl::Status HostOffloader::CreateAllocateBufferForDynamicUpdateSlice(
       dynamic_update_slices_already_allocated_.insert(instruction);
     }
     const std::vector<InstructionAndShapeIndex> predecessors =
-        GetPredecessors(instruction_and_shape);
+        GetPredecessors(instruction_and_shape, *call_graph_);
     for (const InstructionAndShapeIndex& predecessor : predecessors) {
       HloInstruction* predecessor_instruction = predecessor.instruction;
       if (predecessor_instruction->opcode() == HloOpcode::kBroadcast) {
@@ -978,6 +973,9 @@ absl::StatusOr<bool> HostOffloader::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
   bool changed = false;
+  // The pass never adds or removes callers of computations, so the call graph
+  // is built once and shared by all graph walks.
+  call_graph_ = CallGraph::Build(module);
   TF_ASSIGN_OR_RETURN(const bool input_streaming_changed_module,
                       HandleInputStreaming(module->entry_computation()));
   changed = changed || input_streaming_changed_module;
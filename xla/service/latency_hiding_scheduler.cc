@@ -66,6 +66,79 @@ bool IsNopInstruction(const HloInstruction& hlo) {
          (op == HloOpcode::kTuple && hlo.user_count() == 1 &&
           hlo.users().front()->opcode() == HloOpcode::kWhile);
 }
+
+bool SameFrontendAttributes(const HloInstruction& a, const HloInstruction& b) {
+  const auto& a_attrs = a.frontend_attributes().map();
+  const auto& b_attrs = b.frontend_attributes().map();
+  if (a_attrs.size() != b_attrs.size()) {
+    return false;
+  }
+  for (const auto& [key, value] : a_attrs) {
+    auto it = b_attrs.find(key);
+    if (it == b_attrs.end() || it->second != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Maps `schedule` of `scheduled` onto `computation` by pairing the
+// instructions of the original sequences of the two computations by position.
+// Returns std::nullopt if the paired instructions are not identical up to
+// channel ids, with identical operands and control predecessors.
+std::optional<std::vector<HloInstruction*>> MapScheduleOntoIdenticalComputation(
+    const HloSchedule& module_schedule, const HloComputation* scheduled,
+    absl::Span<HloInstruction* const> schedule,
+    const HloComputation* computation) {
+  if (scheduled->instruction_count() != computation->instruction_count() ||
+      !module_schedule.is_computation_scheduled(scheduled) ||
+      !module_schedule.is_computation_scheduled(computation)) {
+    return std::nullopt;
+  }
+  const std::vector<HloInstruction*>& from =
+      module_schedule.sequence(scheduled).instructions();
+  const std::vector<HloInstruction*>& to =
+      module_schedule.sequence(computation).instructions();
+  if (from.size() != to.size() || from.size() != schedule.size()) {
+    return std::nullopt;
+  }
+  absl::flat_hash_map<const HloInstruction*, HloInstruction*> mapping;
+  mapping.reserve(from.size());
+  for (size_t i = 0; i < from.size(); ++i) {
+    mapping[from[i]] = to[i];
+  }
+  auto eq_instructions = [&mapping](const HloInstruction* a,
+                                    const HloInstruction* b) {
+    auto it = mapping.find(a);
+    return it != mapping.end() && it->second == b;
+  };
+  auto eq_computations = [](const HloComputation* a, const HloComputation* b) {
+    return a == b ||
+           a->EqualIgnoringChannelIdValues(*b, /*is_layout_sensitive=*/true);
+  };
+  for (size_t i = 0; i < from.size(); ++i) {
+    const HloInstruction* a = from[i];
+    const HloInstruction* b = to[i];
+    if (!a->IdenticalIgnoringChannelIdValues(*b, eq_instructions,
+                                             eq_computations) ||
+        !SameFrontendAttributes(*a, *b) ||
+        a->control_predecessors().size() != b->control_predecessors().size()) {
+      return std::nullopt;
+    }
+    for (size_t j = 0; j < a->control_predecessors().size(); ++j) {
+      if (!eq_instructions(a->control_predecessors()[j],
+                           b->control_predecessors()[j])) {
+        return std::nullopt;
+      }
+    }
+  }
+  std::vector<HloInstruction*> mapped_schedule;
+  mapped_schedule.reserve(schedule.size());
+  for (const HloInstruction* instr : schedule) {
+    mapped_schedule.push_back(mapping.at(instr));
+  }
+  return mapped_schedule;
+}
 }  // namespace
 
 CanonicalAsyncOp DefaultGetCanonicalAsyncOp(const HloInstruction& hlo) {
@@ -1419,7 +1492,8 @@ absl::StatusOr<HloGraphNode::TimeCost> DefaultSchedulerCore::ScheduleNode(
       // Adjust the ready time if this edge uses shareable resources
       auto occupied_resources = n->GetShareableResourcesOnEdge(pred);
       for (const int64_t resource : occupied_resources) {
-        auto occupiers = sched_state->shareable_resource_occupiers[resource];
+        const auto& occupiers =
+            sched_state->shareable_resource_occupiers[resource];
         for (auto [occupier_edge, edge_pft] : occupiers) {
           if (occupier_edge == &pred) {
             VLOG(10) << "Ready time of scheduled node " << n->GetInstr().name()
@@ -1505,7 +1579,8 @@ absl::StatusOr<HloGraphNode::TimeCost> DefaultSchedulerCore::ScheduleNode(
         auto occupied_resources =
             edge.Target().GetShareableResourcesOnEdge(pred);
         for (const int64_t resource : occupied_resources) {
-          auto occupiers = sched_state->shareable_resource_occupiers[resource];
+          const auto& occupiers =
+              sched_state->shareable_resource_occupiers[resource];
           for (auto [occupier_edge, edge_pft] : occupiers) {
             if (occupier_edge == &pred) {
               VLOG(10) << "Ready time of predecessor "
@@ -1591,7 +1666,16 @@ HloScheduleGraph::HloScheduleGraph(
     : original_order_(post_order_instructions->begin(),
                       post_order_instructions->end()) {
   HloComputation* comp = (*post_order_instructions)[0]->parent();
-  auto reachability = HloReachabilityMap::Build(comp);
+  // The reachability map is quadratic in the size of the computation and is
+  // only needed for async-done and send-done dependencies, so it is built on
+  // first use.
+  std::unique_ptr<HloReachabilityMap> reachability_map;
+  auto reachability = [&]() -> HloReachabilityMap& {
+    if (reachability_map == nullptr) {
+      reachability_map = HloReachabilityMap::Build(comp);
+    }
+    return *reachability_map;
+  };
   int64_t current_pos = 0;
   std::vector<const HloInstruction*> while_instrs;
   // Allocating the graph nodes. One for each of the instructions in the
@@ -1670,7 +1754,7 @@ HloScheduleGraph::HloScheduleGraph(
                 // identified as use.instruction. Add checks here to avoid
                 // adding dependencies for these instructions.
                 if (use.instruction == async_start ||
-                    reachability->IsReachable(instr, use.instruction)) {
+                    reachability().IsReachable(instr, use.instruction)) {
                   continue;
                 }
                 auto it = nodes_.find(use.instruction);
@@ -1713,7 +1797,7 @@ HloScheduleGraph::HloScheduleGraph(
         }
         const HloInstruction* dependent_while_instr = nullptr;
         for (const auto* while_hlo : while_instrs) {
-          if (!reachability->IsReachable(ctrl_pred, while_hlo)) {
+          if (!reachability().IsReachable(ctrl_pred, while_hlo)) {
             continue;
           }
           if (dependent_while_instr == nullptr) {
@@ -1856,6 +1940,7 @@ absl::Status DefaultSchedulerCore::InitializeScheduler(
       module, alias_analysis_.get(), shape_size_bytes_);
   module_pressure_state_->InitializePressureStates();
   module_pressure_state_->SetMemoryPeak(0);
+  scheduled_computations_.clear();
   return absl::OkStatus();
 }
 
@@ -1877,6 +1962,28 @@ absl::Status DefaultSchedulerCore::SchedulingStep(
 absl::StatusOr<std::vector<HloInstruction*>>
 DefaultSchedulerCore::ScheduleComputation(const HloComputation* computation) {
   const HloSchedule& module_schedule = computation->parent()->schedule();
+  if (config_.reuse_schedules_of_identical_computations) {
+    for (const auto& [scheduled, schedule] : scheduled_computations_) {
+      std::optional<std::vector<HloInstruction*>> mapped_schedule =
+          MapScheduleOntoIdenticalComputation(module_schedule, scheduled,
+                                              schedule, computation);
+      if (!mapped_schedule.has_value()) {
+        continue;
+      }
+      VLOG(1) << "Reusing the schedule of " << scheduled->name() << " for "
+              << computation->name();
+      // The buffers live at the bottom of the computation are its own, only
+      // the peak carries over from the identical computation.
+      MemoryPressureTracker::MemoryPressureState pressure_state =
+          module_pressure_state_->GetPressureStateForComputation(computation);
+      pressure_state.memory_peak =
+          module_pressure_state_->GetPressureStateForComputation(scheduled)
+              .memory_peak;
+      module_pressure_state_->UpdatePressureStateForComputation(
+          computation, std::move(pressure_state));
+      return *std::move(mapped_schedule);
+    }
+  }
   MemoryPressureTracker memory_pressure_tracker(
       alias_analysis_.get(), module_pressure_state_->buffer_tracker(),
       module_pressure_state_->pressure_state_cache());
@@ -1957,6 +2064,10 @@ DefaultSchedulerCore::ScheduleComputation(const HloComputation* computation) {
                               debug_options);
   }
 
+  if (config_.reuse_schedules_of_identical_computations) {
+    scheduled_computations_.emplace_back(computation,
+                                         sched_state.new_sequence_reversed);
+  }
   return std::move(sched_state.new_sequence_reversed);
 }
 
@@ -2217,26 +2328,57 @@ absl::StatusOr<bool> LatencyHidingScheduler::Run(
     saved_schedules[computation] = std::move(new_schedule);
   }
   uint64_t initial_memory_limit = scheduler_core_->GetMemoryLimit();
-  for (int64_t iter = 0;
-       iter < scheduler_core_->GetRerunTimes() &&
-       scheduler_core_->GetMemoryPeak() > initial_memory_limit;
-       iter++) {
+  if (rematerializer_ != nullptr &&
+      scheduler_core_->GetMemoryPeak() > initial_memory_limit) {
+    // Rematerialize cheap producers to make room for the overlap found by the
+    // schedule, and schedule again with the same limit. The rematerialized
+    // module no longer matches the saved schedules, so they are replaced.
     LOG(INFO) << "LatencyHidingScheduler current memory usage: "
               << scheduler_core_->GetMemoryPeak()
-              << " bytes, does not fit in limit: "
+              << " bytes, does not fit in limit: " << initial_memory_limit
+              << ". Rematerializing.";
+    for (HloComputation* computation : computations_to_schedule) {
+      module->schedule().set_sequence(
+          computation, absl::MakeConstSpan(saved_schedules[computation]));
+    }
+    TF_ASSIGN_OR_RETURN(bool rematerialized,
+                        rematerializer_(module, initial_memory_limit));
+    if (rematerialized) {
+      TF_RETURN_IF_ERROR(scheduler_core_->InitializeScheduler(module));
+      for (HloComputation* computation : computations_to_schedule) {
+        TF_ASSIGN_OR_RETURN(std::vector<HloInstruction*> new_schedule,
+                            scheduler_core_->ScheduleComputation(computation));
+        saved_schedules[computation] = std::move(new_schedule);
+      }
+    }
+  }
+  // Lowering the limit trades overlap for memory but does not necessarily
+  // lower the peak, so keep the schedules with the lowest peak seen.
+  int64_t memory_peak = scheduler_core_->GetMemoryPeak();
+  for (int64_t iter = 0; iter < scheduler_core_->GetRerunTimes() &&
+                         memory_peak > initial_memory_limit;
+       iter++) {
+    LOG(INFO) << "LatencyHidingScheduler current memory usage: "
+              << memory_peak << " bytes, does not fit in limit: "
               << scheduler_core_->GetMemoryLimit()
               << ". Setting the new limit to "
               << scheduler_core_->GetMemoryLimit() * 0.9;
     TF_RETURN_IF_ERROR(scheduler_core_->InitializeScheduler(module));
     scheduler_core_->SetMemoryLimit(scheduler_core_->GetMemoryLimit() * 0.9);
+    absl::flat_hash_map<HloComputation*, std::vector<HloInstruction*>>
+        rerun_schedules;
     for (HloComputation* computation : computations_to_schedule) {
       TF_ASSIGN_OR_RETURN(std::vector<HloInstruction*> new_schedule,
                           scheduler_core_->ScheduleComputation(computation));
-      saved_schedules[computation] = std::move(new_schedule);
+      rerun_schedules[computation] = std::move(new_schedule);
+    }
+    if (scheduler_core_->GetMemoryPeak() < memory_peak) {
+      memory_peak = scheduler_core_->GetMemoryPeak();
+      saved_schedules = std::move(rerun_schedules);
     }
   }
-  LOG(INFO) << "LatencyHidingScheduler current memory usage: "
-            << scheduler_core_->GetMemoryPeak() << " bytes.";
+  LOG(INFO) << "LatencyHidingScheduler current memory usage: " << memory_peak
+            << " bytes.";
   for (HloComputation* computation : computations_to_schedule) {
     VLOG(1) << "Statistics before scheduling:";
     LogScheduleStatistics(computation);
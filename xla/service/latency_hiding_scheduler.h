@@ -121,6 +121,11 @@ struct SchedulerConfig {
   bool resource_sharing = false;
   bool resource_serializing = false;
   bool depth_based_memory_pressure_reduction = false;
+  // Schedule only the first of a set of structurally identical computations,
+  // such as the bodies of the loops of repeated layers, and map its schedule
+  // onto the others. Only valid if the latency estimator and the async tracker
+  // treat identical instructions the same way.
+  bool reuse_schedules_of_identical_computations = false;
   int64_t rerun = 0;
 };
 
@@ -897,6 +902,10 @@ class DefaultSchedulerCore : public SchedulerCore {
   TargetSchedulingRule target_scheduling_rule_ = nullptr;
   TargetSchedulingRule early_target_scheduling_rule_ = nullptr;
   PostProcessingFn post_processing_fn_ = nullptr;
+  // Schedules computed since the scheduler was last initialized, which are
+  // reused for identical computations.
+  std::vector<std::pair<const HloComputation*, std::vector<HloInstruction*>>>
+      scheduled_computations_;
 };
 
 // A scheduler oriented to hiding latencies of operations that can run in
@@ -917,15 +926,26 @@ class LatencyHidingScheduler : public HloModulePass {
     int64_t memory_pressure_peak = 0;
   };
 
+  // Rematerializes instructions of the scheduled `module` to bring its peak
+  // memory usage below `memory_limit`, updating the module schedule. Returns
+  // whether the module changed.
+  using Rematerializer = std::function<absl::StatusOr<bool>(
+      HloModule* module, int64_t memory_limit)>;
+
+  // If a `rematerializer` is given and the schedule does not fit in the memory
+  // limit, it is run on the schedule and the module is scheduled again with
+  // the same limit, before the limit is lowered at the expense of overlap.
   LatencyHidingScheduler(
       std::unique_ptr<LatencyEstimator> latency_estimator,
       std::unique_ptr<AsyncTracker> async_tracker,
       std::unique_ptr<SchedulerCore> scheduler_core,
-      const HloCostAnalysis::ShapeSizeFunction& shape_size_bytes)
+      const HloCostAnalysis::ShapeSizeFunction& shape_size_bytes,
+      Rematerializer rematerializer = nullptr)
       : latency_estimator_(std::move(latency_estimator)),
         async_tracker_(std::move(async_tracker)),
         scheduler_core_(std::move(scheduler_core)),
-        shape_size_bytes_(shape_size_bytes) {}
+        shape_size_bytes_(shape_size_bytes),
+        rematerializer_(std::move(rematerializer)) {}
   absl::string_view name() const override { return "latency-hiding-scheduler"; }
 
   // Returns some printable statistics about the latency hiding for
@@ -951,6 +971,7 @@ class LatencyHidingScheduler : public HloModulePass {
   std::unique_ptr<AsyncTracker> async_tracker_;
   std::unique_ptr<SchedulerCore> scheduler_core_;
   const HloCostAnalysis::ShapeSizeFunction shape_size_bytes_;
+  Rematerializer rematerializer_;
   absl::flat_hash_set<HloComputation*> computations_to_schedule_;
 };
 
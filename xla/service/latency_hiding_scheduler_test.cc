@@ -130,7 +130,8 @@ class TestLatencyEstimator : public LatencyEstimator {
 absl::StatusOr<bool> RunScheduler(
     HloModule* module, SchedulerConfig sched_config = GetDefaultSchedConfig(),
     std::unique_ptr<LatencyEstimator> latency_estimator =
-        std::make_unique<ApproximateLatencyEstimator>()) {
+        std::make_unique<ApproximateLatencyEstimator>(),
+    LatencyHidingScheduler::Rematerializer rematerializer = nullptr) {
   AsyncCollectiveCreator::CollectiveCreatorConfig config{
       /*convert_all_reduce=*/HloPredicateTrue,
       /*convert_all_gather=*/HloPredicateTrue,
@@ -156,7 +157,8 @@ absl::StatusOr<bool> RunScheduler(
   TF_ASSIGN_OR_RETURN(
       value, LatencyHidingScheduler(std::move(latency_estimator),
                                     std::move(async_tracker),
-                                    std::move(scheduler_core), shape_size_bytes)
+                                    std::move(scheduler_core), shape_size_bytes,
+                                    std::move(rematerializer))
                  .Run(module));
 
   return value;
@@ -2918,6 +2920,64 @@ TEST_F(LatencyHidingSchedulerTest, RerunWithSmallerMemoryLimit) {
             PositionInVector(new_instruction_sequence, cps));
 }
 
+TEST_F(LatencyHidingSchedulerTest, RematerializeInsteadOfSmallerMemoryLimit) {
+  absl::string_view hlo_string = R"(
+    HloModule rerun_scheduler_test, is_scheduled=true
+    ENTRY main {
+     p0 = bf16[8]{0} parameter(0)
+     c = bf16[] constant(0)
+     b = bf16[43]{0} broadcast(c), dimensions={}
+     s = bf16[1]{0} slice(b), slice={[0:1]}
+     cp = bf16[8]{0} collective-permute(p0), source_target_pairs={{0,1},{1,2},{2,3}}
+    ROOT tuple = (bf16[8]{0}, bf16[1]{0}) tuple(cp, s)
+  }
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module, ParseHloText(hlo_string));
+  auto sched_config = GetDefaultSchedConfig();
+  sched_config.memory_limit = 110;
+  sched_config.rerun = 1;
+  // Recomputes the slice of the large broadcast as a small broadcast, which
+  // brings the peak memory usage below the limit (see
+  // RerunWithSmallerMemoryLimit).
+  int64_t rematerializer_calls = 0;
+  auto rematerializer = [&](HloModule* module,
+                            int64_t memory_limit) -> absl::StatusOr<bool> {
+    ++rematerializer_calls;
+    EXPECT_EQ(memory_limit, 110);
+    HloComputation* entry = module->entry_computation();
+    HloInstruction* s = FindInstruction(module, "s");
+    HloInstruction* remat =
+        entry->AddInstruction(HloInstruction::CreateBroadcast(
+            s->shape(), FindInstruction(module, "c"), {}));
+    remat->SetAndSanitizeName("remat");
+    TF_RETURN_IF_ERROR(entry->ReplaceInstruction(s, remat));
+    TF_RETURN_IF_ERROR(module->schedule().Update());
+    return true;
+  };
+  EXPECT_TRUE(RunScheduler(hlo_module.get(), sched_config,
+                           std::make_unique<ApproximateLatencyEstimator>(),
+                           rematerializer)
+                  .ok());
+  EXPECT_EQ(rematerializer_calls, 1);
+
+  // Unlike with a smaller memory limit, the collective-permute still overlaps
+  // the rematerialized instruction.
+  std::vector<HloInstruction*> new_instruction_sequence =
+      hlo_module->schedule()
+          .sequence(hlo_module->entry_computation())
+          .instructions();
+  const HloInstruction* remat = FindInstruction(hlo_module.get(), "remat");
+  const HloInstruction* cps =
+      FindInstruction(hlo_module.get(), "collective-permute-start");
+  const HloInstruction* cpd =
+      FindInstruction(hlo_module.get(), "collective-permute-done");
+  EXPECT_LT(PositionInVector(new_instruction_sequence, cps),
+            PositionInVector(new_instruction_sequence, remat));
+  EXPECT_LT(PositionInVector(new_instruction_sequence, remat),
+            PositionInVector(new_instruction_sequence, cpd));
+}
+
 TEST_F(LatencyHidingSchedulerTest, MultipleAsyncDoneOperationsDoNotCreateLoop) {
   absl::string_view hlo_string = R"(
 HloModule multiple_async_done_scheduler_test, is_scheduled=true
@@ -3099,4 +3159,77 @@ ENTRY %entry {
             GetIndex(new_instruction_sequence, "while"));
 }
 
+TEST_F(LatencyHidingSchedulerTest, ReuseScheduleOfIdenticalWhileBodies) {
+  absl::string_view hlo_string = R"(
+HloModule module, is_scheduled=true
+
+while_cond {
+  param = (bf16[8]{0}, bf16[8]{0}, pred[]) parameter(0)
+  ROOT gte = pred[] get-tuple-element(param), index=2
+}
+
+while_body_0 {
+  param = (bf16[8]{0}, bf16[8]{0}, pred[]) parameter(0)
+  gte0 = bf16[8]{0} get-tuple-element(param), index=0
+  gte1 = bf16[8]{0} get-tuple-element(param), index=1
+  gte2 = pred[] get-tuple-element(param), index=2
+  cp = bf16[8]{0} collective-permute(gte0), source_target_pairs={{0,1},{1,2},{2,3}}
+  negate = bf16[8]{0} negate(gte1)
+  add = bf16[8]{0} add(negate, gte1)
+  ROOT tuple = (bf16[8]{0}, bf16[8]{0}, pred[]) tuple(cp, add, gte2)
+}
+
+while_body_1 {
+  param = (bf16[8]{0}, bf16[8]{0}, pred[]) parameter(0)
+  gte0 = bf16[8]{0} get-tuple-element(param), index=0
+  gte1 = bf16[8]{0} get-tuple-element(param), index=1
+  gte2 = pred[] get-tuple-element(param), index=2
+  cp = bf16[8]{0} collective-permute(gte0), source_target_pairs={{0,1},{1,2},{2,3}}
+  negate = bf16[8]{0} negate(gte1)
+  add = bf16[8]{0} add(negate, gte1)
+  ROOT tuple = (bf16[8]{0}, bf16[8]{0}, pred[]) tuple(cp, add, gte2)
+}
+
+ENTRY entry {
+  p0 = bf16[8]{0} parameter(0)
+  p1 = bf16[8]{0} parameter(1)
+  p2 = pred[] parameter(2)
+  tuple = (bf16[8]{0}, bf16[8]{0}, pred[]) tuple(p0, p1, p2)
+  while0 = (bf16[8]{0}, bf16[8]{0}, pred[]) while(tuple), condition=while_cond, body=while_body_0
+  ROOT while1 = (bf16[8]{0}, bf16[8]{0}, pred[]) while(while0), condition=while_cond, body=while_body_1
+}
+)";
+
+  // Schedules the module with and without reusing the schedule of the first
+  // loop body for the second one.
+  std::vector<std::vector<HloOpcode>> body_0_opcodes;
+  std::vector<std::vector<std::string>> body_1_names;
+  for (bool reuse : {false, true}) {
+    TF_ASSERT_OK_AND_ASSIGN(auto hlo_module, ParseHloText(hlo_string));
+    SchedulerConfig sched_config = GetDefaultSchedConfig();
+    sched_config.reuse_schedules_of_identical_computations = reuse;
+    EXPECT_TRUE(RunScheduler(hlo_module.get(), sched_config).ok());
+    const HloSchedule& module_schedule = hlo_module->schedule();
+    body_0_opcodes.emplace_back();
+    for (const HloInstruction* instr :
+         module_schedule
+             .sequence(hlo_module->GetComputationWithName("while_body_0"))
+             .instructions()) {
+      body_0_opcodes.back().push_back(instr->opcode());
+    }
+    body_1_names.emplace_back();
+    std::vector<HloOpcode> body_1_opcodes;
+    for (const HloInstruction* instr :
+         module_schedule
+             .sequence(hlo_module->GetComputationWithName("while_body_1"))
+             .instructions()) {
+      body_1_names.back().push_back(instr->name());
+      body_1_opcodes.push_back(instr->opcode());
+    }
+    EXPECT_EQ(body_0_opcodes.back(), body_1_opcodes);
+  }
+  EXPECT_EQ(body_0_opcodes[0], body_0_opcodes[1]);
+  EXPECT_EQ(body_1_names[0], body_1_names[1]);
+}
+
 }  // namespace xla
@@ -2470,6 +2470,26 @@ absl::Status LayoutAssignment::RunOnComputation(
   // Add any backend-specific constraints.
   TF_RETURN_IF_ERROR(AddBackendConstraints(constraints));
 
+  // Add the layouts preferred by the caller where they don't conflict with the
+  // constraints above.
+  if (!layout_hints_.empty()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      auto it = layout_hints_.find(instruction->name());
+      if (it == layout_hints_.end() || !instruction->shape().IsArray()) {
+        continue;
+      }
+      const BufferLayoutConstraint* constraint =
+          GetInstructionBufferLayoutConstraint(instruction);
+      if (constraint != nullptr && constraint->mandatory()) {
+        continue;
+      }
+      TF_RETURN_IF_ERROR(SetInstructionLayout(it->second, instruction,
+                                              /*mandatory=*/false,
+                                              /*dfs=*/true,
+                                              /*allow_alias=*/true));
+    }
+  }
+
   // Propagates layouts from mandatory and backend constraints.
   TF_RETURN_IF_ERROR(PropagateConstraints(constraints));
 
@@ -417,6 +417,14 @@ class LayoutAssignment : public HloModulePass {
                                 int64_t priority);
   bool reverse_computation_order() const { return reverse_computation_order_; }
 
+  // Sets preferred layouts for the results of array-shaped instructions, keyed
+  // by instruction name. They are added as non-mandatory constraints after the
+  // backend constraints, so they only apply where no constraint requires a
+  // different layout. Used by LayoutAssignmentSearch.
+  void set_layout_hints(absl::flat_hash_map<std::string, Layout> layout_hints) {
+    layout_hints_ = std::move(layout_hints);
+  }
+
   ComputationLayout& saved_entry_computation_layout() {
     return saved_entry_computation_layout_;
   }
@@ -746,6 +754,9 @@ class LayoutAssignment : public HloModulePass {
   // Array-shaped buffers which have not yet been constrained.
   std::set<LogicalBuffer::Id> unconstrained_buffer_ids_;
 
+  // Preferred layouts of instruction results, see set_layout_hints().
+  absl::flat_hash_map<std::string, Layout> layout_hints_;
+
   mutable absl::flat_hash_map<const HloInstruction*,
                               std::unique_ptr<PointsToSet::BufferSet>>
       buffer_sets_cache_;
@@ -0,0 +1,279 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/service/layout_assignment_search.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/layout.h"
+#include "xla/layout_util.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/layout_assignment.h"
+#include "xla/service/pattern_matcher.h"
+#include "xla/service/while_loop_analysis.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+namespace m = match;
+
+// A set of instructions whose results share a layout, e.g. all reads of the
+// same element of while loop state.
+struct Candidate {
+  std::vector<std::string> instruction_names;
+  Shape shape;
+  int64_t impact;
+};
+
+int64_t TripCount(const HloInstruction* while_op) {
+  auto backend_config = while_op->backend_config<WhileLoopBackendConfig>();
+  if (backend_config.ok() && backend_config->has_known_trip_count()) {
+    return backend_config->known_trip_count().n();
+  }
+  return ComputeWhileLoopTripCount(while_op).value_or(
+      LayoutAssignmentSearch::kUnknownTripCount);
+}
+
+// Returns the layout of `shape` with its two minor-most dimensions swapped.
+Layout SwapMinorDimensions(const Shape& shape) {
+  std::vector<int64_t> minor_to_major(shape.rank());
+  std::iota(minor_to_major.rbegin(), minor_to_major.rend(), 0);
+  std::swap(minor_to_major[0], minor_to_major[1]);
+  return LayoutUtil::MakeLayout(minor_to_major);
+}
+
+std::vector<Candidate> FindCandidates(
+    const HloModule& module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    const absl::flat_hash_map<std::string, int64_t>& execution_counts,
+    const HloCostAnalysis::ShapeSizeFunction& shape_size) {
+  std::vector<Candidate> candidates;
+  auto add_candidate = [&](std::vector<std::string> instruction_names,
+                           const Shape& shape,
+                           const HloComputation* computation) {
+    if (instruction_names.empty() || !shape.IsArray() || shape.rank() < 2) {
+      return;
+    }
+    auto it = execution_counts.find(computation->name());
+    int64_t count = it == execution_counts.end() ? 1 : it->second;
+    candidates.push_back(
+        {std::move(instruction_names), shape, shape_size(shape) * count});
+  };
+
+  for (const HloComputation* computation :
+       module.MakeNonfusionComputations(execution_threads)) {
+    for (const HloInstruction* instruction : computation->instructions()) {
+      if (HloPredicateIsOp<HloOpcode::kDot, HloOpcode::kConvolution>(
+              instruction)) {
+        add_candidate({instruction->name()}, instruction->shape(),
+                      computation);
+        continue;
+      }
+      if (instruction->opcode() != HloOpcode::kWhile) {
+        continue;
+      }
+      // Loop state is read by get-tuple-elements of the body parameter, which
+      // all alias the same buffer.
+      const HloComputation* body = instruction->while_body();
+      const Shape& state_shape = instruction->shape();
+      if (!state_shape.IsTuple()) {
+        continue;
+      }
+      for (int64_t i = 0; i < state_shape.tuple_shapes_size(); ++i) {
+        std::vector<std::string> reads;
+        for (const HloInstruction* user :
+             body->parameter_instruction(0)->users()) {
+          if (Match(user, m::GetTupleElement(m::Parameter(), i))) {
+            reads.push_back(user->name());
+          }
+        }
+        add_candidate(std::move(reads), state_shape.tuple_shapes(i), body);
+      }
+    }
+  }
+
+  absl::c_stable_sort(candidates, [](const Candidate& a, const Candidate& b) {
+    return a.impact > b.impact;
+  });
+  return candidates;
+}
+
+}  // namespace
+
+LayoutAssignmentSearch::LayoutAssignmentSearch(
+    LayoutAssignmentFactory layout_assignment_factory,
+    ChannelLayoutConstraints* channel_constraints, int64_t max_candidates,
+    HloCostAnalysis::ShapeSizeFunction shape_size)
+    : layout_assignment_factory_(std::move(layout_assignment_factory)),
+      channel_constraints_(channel_constraints),
+      max_candidates_(max_candidates),
+      shape_size_(std::move(shape_size)) {}
+
+/*static*/ int64_t LayoutAssignmentSearch::DefaultShapeSize(
+    const Shape& shape) {
+  return ShapeUtil::ByteSizeOf(shape, sizeof(void*));
+}
+
+/*static*/ absl::flat_hash_map<std::string, int64_t>
+LayoutAssignmentSearch::ComputeExecutionCounts(const HloModule& module) {
+  absl::flat_hash_map<std::string, int64_t> execution_counts;
+  execution_counts[module.entry_computation()->name()] = 1;
+  // Callers come before callees in reverse post order.
+  std::vector<HloComputation*> post_order = module.MakeComputationPostOrder();
+  for (auto it = post_order.rbegin(); it != post_order.rend(); ++it) {
+    const HloComputation* computation = *it;
+    int64_t count = execution_counts[computation->name()];
+    for (const HloInstruction* instruction : computation->instructions()) {
+      int64_t callee_count = count;
+      if (instruction->opcode() == HloOpcode::kWhile) {
+        callee_count = count * TripCount(instruction);
+      }
+      for (const HloComputation* callee : instruction->called_computations()) {
+        execution_counts[callee->name()] += callee_count;
+      }
+    }
+  }
+  return execution_counts;
+}
+
+/*static*/ int64_t LayoutAssignmentSearch::LayoutChangeCost(
+    const HloModule& module,
+    const absl::flat_hash_map<std::string, int64_t>& execution_counts,
+    const HloCostAnalysis::ShapeSizeFunction& shape_size) {
+  int64_t cost = 0;
+  for (const HloComputation* computation : module.computations()) {
+    auto it = execution_counts.find(computation->name());
+    int64_t count = it == execution_counts.end() ? 1 : it->second;
+    for (const HloInstruction* instruction : computation->instructions()) {
+      if (!instruction->shape().IsArray()) {
+        continue;
+      }
+      bool changes_layout = false;
+      if (instruction->opcode() == HloOpcode::kCopy) {
+        changes_layout = true;
+      } else if (instruction->opcode() == HloOpcode::kTranspose) {
+        changes_layout = !ShapeUtil::TransposeIsBitcast(
+            instruction->operand(0)->shape(), instruction->shape(),
+            instruction->dimensions());
+      }
+      if (changes_layout) {
+        cost += shape_size(instruction->shape()) * count;
+      }
+    }
+  }
+  return cost;
+}
+
+absl::StatusOr<int64_t> LayoutAssignmentSearch::EvaluateHints(
+    const HloModule& module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    const absl::flat_hash_map<std::string, Layout>& layout_hints,
+    const absl::flat_hash_map<std::string, int64_t>& execution_counts) {
+  // Instruction and computation names are kept by cloning without a suffix.
+  std::unique_ptr<HloModule> clone = module.Clone(/*suffix=*/"");
+  ChannelLayoutConstraints channel_constraints;
+  if (channel_constraints_ != nullptr) {
+    channel_constraints = *channel_constraints_;
+  }
+  std::unique_ptr<LayoutAssignment> layout_assignment =
+      layout_assignment_factory_(clone.get(), &channel_constraints);
+  layout_assignment->set_layout_hints(layout_hints);
+  TF_RETURN_IF_ERROR(
+      layout_assignment->Run(clone.get(), execution_threads).status());
+  return LayoutChangeCost(*clone, execution_counts, shape_size_);
+}
+
+absl::StatusOr<bool> LayoutAssignmentSearch::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  absl::flat_hash_map<std::string, int64_t> execution_counts =
+      ComputeExecutionCounts(*module);
+  std::vector<Candidate> candidates = FindCandidates(
+      *module, execution_threads, execution_counts, shape_size_);
+  candidates.resize(std::min<size_t>(candidates.size(),
+                                     std::max<int64_t>(max_candidates_, 0)));
+
+  absl::flat_hash_map<std::string, Layout> best_hints;
+  if (!candidates.empty()) {
+    TF_ASSIGN_OR_RETURN(int64_t best_cost,
+                        EvaluateHints(*module, execution_threads, best_hints,
+                                      execution_counts));
+    VLOG(2) << "Layout change cost without hints: " << best_cost;
+
+    // Greedily fix the layout of one candidate at a time, starting with the
+    // candidates with the largest impact.
+    for (const Candidate& candidate : candidates) {
+      absl::flat_hash_map<std::string, Layout> candidate_best_hints =
+          best_hints;
+      for (const Layout& layout :
+           {LayoutUtil::GetDefaultLayoutForShape(candidate.shape),
+            SwapMinorDimensions(candidate.shape)}) {
+        absl::flat_hash_map<std::string, Layout> hints = best_hints;
+        for (const std::string& name : candidate.instruction_names) {
+          hints[name] = layout;
+        }
+        absl::StatusOr<int64_t> cost =
+            EvaluateHints(*module, execution_threads, hints, execution_counts);
+        if (!cost.ok()) {
+          VLOG(2) << "Layout assignment failed with layout "
+                  << layout.ToString() << " for "
+                  << candidate.instruction_names.front() << ": "
+                  << cost.status();
+          continue;
+        }
+        VLOG(2) << "Layout change cost with layout " << layout.ToString()
+                << " for " << candidate.instruction_names.front() << ": "
+                << *cost;
+        if (*cost < best_cost) {
+          best_cost = *cost;
+          candidate_best_hints = std::move(hints);
+        }
+      }
+      best_hints = std::move(candidate_best_hints);
+    }
+    VLOG(1) << "Layout search picked " << best_hints.size()
+            << " layout hints, layout change cost: " << best_cost;
+  }
+
+  std::unique_ptr<LayoutAssignment> layout_assignment =
+      layout_assignment_factory_(module, channel_constraints_);
+  layout_assignment->set_layout_hints(std::move(best_hints));
+  return layout_assignment->Run(module, execution_threads);
+}
+
+}  // namespace xla
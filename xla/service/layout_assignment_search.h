@@ -0,0 +1,114 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#ifndef XLA_SERVICE_LAYOUT_ASSIGNMENT_SEARCH_H_
+#define XLA_SERVICE_LAYOUT_ASSIGNMENT_SEARCH_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/layout.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/hlo_pass_interface.h"
+#include "xla/service/layout_assignment.h"
+
+namespace xla {
+
+// Runs layout assignment with the layouts of a few high-impact instructions
+// chosen by a search over a global cost model, instead of relying only on the
+// greedy propagation of constraints.
+//
+// The cost of a layout assignment is the number of bytes moved by the copies
+// and physical transposes in the module, weighted by how often they execute
+// (i.e. by the trip counts of the enclosing while loops). The search
+// considers the results of dots and convolutions and the array elements of
+// while loop state with the largest weighted sizes. For each of them it tries
+// the row-major layout and the layout with the two minor-most dimensions
+// swapped as hints to layout assignment (see LayoutAssignment::
+// set_layout_hints()), runs layout assignment on a clone of the module and
+// keeps the hint if it lowers the cost. Finally, layout assignment runs on
+// the module with the best hints found.
+//
+// Each candidate layout costs one run of layout assignment, so the search is
+// bounded by `max_candidates`.
+class LayoutAssignmentSearch : public HloModulePass {
+ public:
+  // Creates the layout assignment pass for `module`, e.g. a backend-specific
+  // subclass of LayoutAssignment constructed with the entry computation layout
+  // of `module` and the given channel constraints.
+  using LayoutAssignmentFactory =
+      std::function<std::unique_ptr<LayoutAssignment>(
+          HloModule* module, ChannelLayoutConstraints* channel_constraints)>;
+
+  // `channel_constraints` is passed to the final run of layout assignment, and
+  // copies of it are passed to the runs on module clones. It may be nullptr.
+  LayoutAssignmentSearch(
+      LayoutAssignmentFactory layout_assignment_factory,
+      ChannelLayoutConstraints* channel_constraints, int64_t max_candidates,
+      HloCostAnalysis::ShapeSizeFunction shape_size = DefaultShapeSize);
+
+  absl::string_view name() const override {
+    return "layout-assignment-search";
+  }
+
+  using HloPassInterface::Run;
+  absl::StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+  // Returns how many times each computation of `module` runs per execution
+  // of the module, keyed by computation name. Loops with an unknown trip count
+  // are assumed to run kUnknownTripCount times.
+  static absl::flat_hash_map<std::string, int64_t> ComputeExecutionCounts(
+      const HloModule& module);
+
+  // Returns the cost of the layouts assigned to `module`: the bytes moved by
+  // copies and by transposes that are not bitcasts, weighted by
+  // `execution_counts`.
+  static int64_t LayoutChangeCost(
+      const HloModule& module,
+      const absl::flat_hash_map<std::string, int64_t>& execution_counts,
+      const HloCostAnalysis::ShapeSizeFunction& shape_size);
+
+  static constexpr int64_t kUnknownTripCount = 10;
+
+ private:
+  static int64_t DefaultShapeSize(const Shape& shape);
+
+  // Returns the cost of running layout assignment on a clone of `module` with
+  // the given hints.
+  absl::StatusOr<int64_t> EvaluateHints(
+      const HloModule& module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads,
+      const absl::flat_hash_map<std::string, Layout>& layout_hints,
+      const absl::flat_hash_map<std::string, int64_t>& execution_counts);
+
+  LayoutAssignmentFactory layout_assignment_factory_;
+  ChannelLayoutConstraints* channel_constraints_;
+  int64_t max_candidates_;
+  HloCostAnalysis::ShapeSizeFunction shape_size_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_LAYOUT_ASSIGNMENT_SEARCH_H_
@@ -0,0 +1,133 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "xla/service/layout_assignment_search.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/layout_assignment.h"
+#include "xla/shape_util.h"
+#include "xla/test.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+using LayoutAssignmentSearchTest = HloTestBase;
+
+int64_t ShapeSize(const Shape& shape) {
+  return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+}
+
+std::unique_ptr<LayoutAssignment> MakeLayoutAssignment(
+    HloModule* module, ChannelLayoutConstraints* channel_constraints) {
+  return std::make_unique<LayoutAssignment>(
+      module->mutable_entry_computation_layout(), channel_constraints);
+}
+
+constexpr char kLoopWithTranspose[] = R"(
+  HloModule loop_with_transpose
+
+  body {
+    p = (s32[], f32[64,32], f32[32,64]) parameter(0)
+    i = s32[] get-tuple-element(p), index=0
+    one = s32[] constant(1)
+    next_i = s32[] add(i, one)
+    x = f32[64,32] get-tuple-element(p), index=1
+    y = f32[32,64] get-tuple-element(p), index=2
+    t = f32[32,64] transpose(x), dimensions={1,0}
+    sum = f32[32,64] add(t, y)
+    ROOT tuple = (s32[], f32[64,32], f32[32,64]) tuple(next_i, x, sum)
+  }
+
+  cond {
+    p = (s32[], f32[64,32], f32[32,64]) parameter(0)
+    i = s32[] get-tuple-element(p), index=0
+    n = s32[] constant(5)
+    ROOT lt = pred[] compare(i, n), direction=LT
+  }
+
+  ENTRY main {
+    x = f32[64,32] parameter(0)
+    y = f32[32,64] parameter(1)
+    zero = s32[] constant(0)
+    init = (s32[], f32[64,32], f32[32,64]) tuple(zero, x, y)
+    ROOT while = (s32[], f32[64,32], f32[32,64]) while(init),
+      condition=cond, body=body,
+      backend_config={"known_trip_count":{"n":"5"}}
+  })";
+
+TEST_F(LayoutAssignmentSearchTest, ExecutionCountsUseTripCounts) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kLoopWithTranspose));
+  absl::flat_hash_map<std::string, int64_t> counts =
+      LayoutAssignmentSearch::ComputeExecutionCounts(*module);
+  EXPECT_EQ(counts["main"], 1);
+  EXPECT_EQ(counts["body"], 5);
+  EXPECT_EQ(counts["cond"], 5);
+}
+
+TEST_F(LayoutAssignmentSearchTest, LayoutChangeCostIgnoresBitcasts) {
+  constexpr char kHlo[] = R"(
+    HloModule layout_change_cost
+
+    ENTRY main {
+      p = f32[4,8]{1,0} parameter(0)
+      copy = f32[4,8]{0,1} copy(p)
+      bitcast_transpose = f32[8,4]{1,0} transpose(copy), dimensions={1,0}
+      transpose = f32[8,4]{0,1} transpose(copy), dimensions={1,0}
+      ROOT tuple = (f32[8,4]{1,0}, f32[8,4]{0,1}) tuple(bitcast_transpose,
+        transpose)
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  // Only the copy and the physical transpose move data.
+  EXPECT_EQ(LayoutAssignmentSearch::LayoutChangeCost(
+                *module, {{"main", 3}}, ShapeSize),
+            2 * 3 * 4 * 8 * sizeof(float));
+}
+
+TEST_F(LayoutAssignmentSearchTest, SearchDoesNotIncreaseCost) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kLoopWithTranspose));
+  absl::flat_hash_map<std::string, int64_t> counts =
+      LayoutAssignmentSearch::ComputeExecutionCounts(*module);
+
+  std::unique_ptr<HloModule> greedy_module = module->Clone(/*suffix=*/"");
+  ChannelLayoutConstraints greedy_constraints;
+  TF_ASSERT_OK(MakeLayoutAssignment(greedy_module.get(), &greedy_constraints)
+                   ->Run(greedy_module.get())
+                   .status());
+  int64_t greedy_cost = LayoutAssignmentSearch::LayoutChangeCost(
+      *greedy_module, counts, ShapeSize);
+
+  ChannelLayoutConstraints channel_constraints;
+  LayoutAssignmentSearch search(MakeLayoutAssignment, &channel_constraints,
+                                /*max_candidates=*/4, ShapeSize);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&search, module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_LE(LayoutAssignmentSearch::LayoutChangeCost(*module, counts,
+                                                     ShapeSize),
+            greedy_cost);
+}
+
+}  // namespace
+}  // namespace xla
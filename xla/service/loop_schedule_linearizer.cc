@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/loop_schedule_linearizer.h"
 
+#include <cstdint>
 #include <memory>
 
 #include "absl/algorithm/container.h"
@@ -88,8 +89,10 @@ class ComputationInstructionOrdering {
 
 }  // namespace
 
+// Only loop state elements of at least `min_bytes` bytes are linearized.
 static absl::StatusOr<bool> AddControlEdgesForLoopWrites(
-    HloInstruction* xla_while, HloAliasAnalysis& alias_analysis) {
+    HloInstruction* xla_while, HloAliasAnalysis& alias_analysis,
+    int64_t min_bytes) {
   HloDataflowAnalysis& dataflow = alias_analysis.dataflow_analysis();
   HloComputation* body = xla_while->while_body();
   HloInstruction* root = body->root_instruction();
@@ -123,6 +126,12 @@ static absl::StatusOr<bool> AddControlEdgesForLoopWrites(
         // tuples, as we haven't seen them in the examples we care about.
         continue;
       }
+      if (min_bytes > 0 &&
+          ShapeUtil::ByteSizeOfElements(value_at_root.shape()) < min_bytes) {
+        VLOG(2) << "Index " << index.ToString() << " is smaller than "
+                << min_bytes << " bytes, not linearizing it";
+        continue;
+      }
 
       // TODO(cheshire): This is too conservative and does not take aliasing
       // into account.
@@ -190,7 +199,7 @@ absl::StatusOr<bool> LoopScheduleLinearizer::Run(
                        instr, /*include_send_recv=*/true);
           });
 
-      if (has_async_collectives) {
+      if (has_async_collectives && min_bytes_with_async_collectives_ <= 0) {
         VLOG(2) << "Skipping " << instruction->name()
                 << " since body has async collectives";
         continue;
@@ -200,8 +209,11 @@ absl::StatusOr<bool> LoopScheduleLinearizer::Run(
         TF_ASSIGN_OR_RETURN(alias_analysis,
                             HloAliasAnalysis::Run(module, can_share_buffer_));
       }
-      TF_ASSIGN_OR_RETURN(bool updated_loop, AddControlEdgesForLoopWrites(
-                                                 instruction, *alias_analysis));
+      TF_ASSIGN_OR_RETURN(
+          bool updated_loop,
+          AddControlEdgesForLoopWrites(
+              instruction, *alias_analysis,
+              has_async_collectives ? min_bytes_with_async_collectives_ : 0));
       changed |= updated_loop;
     }
   }
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef XLA_SERVICE_LOOP_SCHEDULE_LINEARIZER_H_
 #define XLA_SERVICE_LOOP_SCHEDULE_LINEARIZER_H_
 
+#include <cstdint>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -36,13 +38,21 @@ namespace xla {
 // example of a dependency cycle is a loop doing `(a, b) = (b, a)`). Thus we
 // take a best-effort approach instead: add dependency edges only if we can show
 // they don't create a cycle.
+//
+// Loops with async collectives are skipped, as the dependency edges can hamper
+// compute and communication overlap, unless `min_bytes_with_async_collectives`
+// is positive. Then only loop state elements of at least that many bytes are
+// linearized in such loops, as copying them on every iteration costs more than
+// the lost overlap.
 class LoopScheduleLinearizer : public HloModulePass {
  public:
   absl::string_view name() const override { return "loop-schedule-linearizer"; }
 
   explicit LoopScheduleLinearizer(
-      const HloDataflowAnalysis::CanShareBuffer& can_share_buffer = nullptr)
-      : can_share_buffer_(can_share_buffer) {}
+      const HloDataflowAnalysis::CanShareBuffer& can_share_buffer = nullptr,
+      int64_t min_bytes_with_async_collectives = 0)
+      : can_share_buffer_(can_share_buffer),
+        min_bytes_with_async_collectives_(min_bytes_with_async_collectives) {}
 
   using HloPassInterface::Run;
   absl::StatusOr<bool> Run(
@@ -53,6 +63,8 @@ class LoopScheduleLinearizer : public HloModulePass {
   // Backend specific function that decides whether an instruction can share
   // buffer with its operand.
   HloDataflowAnalysis::CanShareBuffer can_share_buffer_;
+
+  int64_t min_bytes_with_async_collectives_;
 };
 
 }  // namespace xla
@@ -162,5 +162,69 @@ ENTRY entry {
                           ParseAndReturnVerifiedModule(hlo_string));
   InsertCopies(module.get(), /*expect_change=*/false);
 }
+
+TEST_F(LoopScheduleLinearizerTest, LinearizeLargeBuffersWithAsyncCollectives) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+while_body {
+  input = (s32[], f32[256,256], f32[256,256]) parameter(0)
+  counter = s32[] get-tuple-element(input), index=0
+  cache = f32[256,256] get-tuple-element(input), index=1
+
+  one = s32[] constant(1)
+  updated_counter = s32[] add(counter, one)
+
+  negated_cache = f32[256,256] negate(cache)
+  ar_start = f32[256,256] all-reduce-start(negated_cache), replica_groups={}, to_apply=add
+  ar_done = f32[256,256] all-reduce-done(ar_start)
+
+  counter_f32 = f32[] convert(counter)
+  update = f32[256,256] broadcast(counter_f32), dimensions={}
+  updated_cache = f32[256,256] add(cache, update)
+  ROOT out = (s32[], f32[256,256], f32[256,256]) tuple(updated_counter, updated_cache, ar_done)
+}
+
+while_cond {
+  input = (s32[], f32[256,256], f32[256,256]) parameter(0)
+  counter = s32[] get-tuple-element(input), index=0
+  bound = s32[] constant(100)
+  ROOT cmp = pred[] compare(counter, bound), direction=LT
+}
+
+ENTRY entry {
+  zero = s32[] constant(0)
+  cache = f32[256,256] parameter(0)
+  acc = f32[256,256] parameter(1)
+  while_input = (s32[], f32[256,256], f32[256,256]) tuple(zero, cache, acc)
+  ROOT out = (s32[], f32[256,256], f32[256,256]) while(while_input), condition=while_cond, body=while_body
+}
+
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  LoopScheduleLinearizer loop_schedule_linearizer(
+      /*can_share_buffer=*/nullptr,
+      /*min_bytes_with_async_collectives=*/1024);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          loop_schedule_linearizer.Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  // Only the read of the large cache is ordered before its update, not the
+  // read of the small counter.
+  const HloComputation* body =
+      module->entry_computation()->root_instruction()->while_body();
+  EXPECT_EQ(CountControlEdges(*body), 1);
+  const HloInstruction* negated_cache =
+      FindInstruction(module.get(), "negated_cache");
+  ASSERT_EQ(negated_cache->control_successors().size(), 1);
+  EXPECT_EQ(negated_cache->control_successors()[0]->name(), "updated_cache");
+}
 }  // namespace
 }  // namespace xla
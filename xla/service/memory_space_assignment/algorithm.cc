@@ -3964,17 +3964,15 @@ bool MsaAlgorithm::ViolatesMaximumOutstandingAsyncCopies(
   // Count the prefetches/evictions in the interval tree for the given interval.
   if (is_prefetch) {
     int64_t num_prefetches =
-        prefetch_interval_tree_
-            .ChunksOverlappingInTime(inclusive_start_time, end_time)
-            .size() +
+        prefetch_interval_tree_.NumChunksOverlappingInTime(inclusive_start_time,
+                                                           end_time) +
         num_additional_copies;
     return num_prefetches >=
            options_.max_outstanding_prefetches + extra_async_copy_limit;
   } else {
     int64_t num_evictions =
-        eviction_interval_tree_
-            .ChunksOverlappingInTime(inclusive_start_time, end_time)
-            .size() +
+        eviction_interval_tree_.NumChunksOverlappingInTime(inclusive_start_time,
+                                                           end_time) +
         num_additional_copies;
     return num_evictions >=
            options_.max_outstanding_evictions + extra_async_copy_limit;
@@ -782,18 +782,14 @@ bool MemoryBoundLoopOptimizer::AllocatePrefetch(
     last_use_idx_sentinel = last_use_idx + loop_size_;
     CHECK_LT(last_use_idx, first_use_idx);
   }
-  bool out_of_memory = false;
   for (int i = first_use_idx; i <= last_use_idx_sentinel; ++i) {
     int loop_idx = i % loop_size_;
     if (context.additional_memory_used[loop_idx] + value->size >
         remaining_memory_[loop_idx]) {
       VLOG(3) << "Ran out of memory allocating for uses.";
-      out_of_memory = true;
+      return false;
     }
   }
-  if (out_of_memory) {
-    return false;
-  }
   float copy_resource =
       cost_analysis_.GetAsyncCopyElapsed(value->hlo_values.front()->shape());
   VLOG(3) << "First use: " << value->loop_uses.begin()->second
@@ -1160,13 +1156,20 @@ float MemoryBoundLoopOptimizer::GetBandwidthIdleTime(
   const HloInstruction* inst =
       hlo_live_range_.flattened_instruction_sequence().instructions().at(
           loop_start_ + idx);
+  auto additional_uses_it = additional_uses_in_alternate_mem.find(inst);
+  auto additional_positions_it =
+      additional_positions_in_alternate_mem.find(inst);
+  if (additional_uses_it == additional_uses_in_alternate_mem.end() &&
+      additional_positions_it == additional_positions_in_alternate_mem.end()) {
+    // Nothing to add, avoid copying the existing uses and positions.
+    return GetBandwidthIdleTime(idx);
+  }
   std::vector<std::pair<int64_t, ShapeIndex>> operands_in_alternate_mem;
   std::vector<ShapeIndex> outputs_in_alternate_mem;
   auto uses_it = uses_in_alternate_mem_.find(inst);
   if (uses_it != uses_in_alternate_mem_.end()) {
     operands_in_alternate_mem = uses_it->second;
   }
-  auto additional_uses_it = additional_uses_in_alternate_mem.find(inst);
   if (additional_uses_it != additional_uses_in_alternate_mem.end()) {
     absl::c_copy(additional_uses_it->second,
                  std::back_inserter(operands_in_alternate_mem));
@@ -1175,8 +1178,6 @@ float MemoryBoundLoopOptimizer::GetBandwidthIdleTime(
   if (positions_it != positions_in_alternate_mem_.end()) {
     outputs_in_alternate_mem = positions_it->second;
   }
-  auto additional_positions_it =
-      additional_positions_in_alternate_mem.find(inst);
   if (additional_positions_it != additional_positions_in_alternate_mem.end()) {
     absl::c_copy(additional_positions_it->second,
                  std::back_inserter(outputs_in_alternate_mem));
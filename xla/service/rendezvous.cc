@@ -31,6 +31,14 @@ namespace internal {
 void AwaitAndLogIfStuck(absl::Notification& ready, std::string_view name,
                         size_t num_threads, absl::Duration warn_stuck_timeout,
                         absl::Duration terminate_timeout) {
+  // Participants of a rendezvous usually arrive within a few microseconds of
+  // each other, so poll the notification for a short while before blocking
+  // to avoid the cost of a futex wait and wake-up.
+  static constexpr int32_t kSpinIterations = 2000;
+  for (int32_t i = 0; i < kSpinIterations; ++i) {
+    if (ready.HasBeenNotified()) return;
+  }
+
   if (ready.WaitForNotificationWithTimeout(warn_stuck_timeout)) {
     return;
   }
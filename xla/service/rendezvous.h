@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_RENDEZVOUS_H_
 #define XLA_SERVICE_RENDEZVOUS_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -180,13 +181,34 @@ namespace internal {
 template <typename R, typename V>
 struct RendezvousState {
   explicit RendezvousState(size_t num_threads)
-      : ack(0), rel(0), values(num_threads, nullptr), result(nullptr) {}
+      : ack(0),
+        rel(0),
+        done(0),
+        values(num_threads, nullptr),
+        result(nullptr) {
+    ready.emplace();
+  }
+
+  // Prepares the state of a completed rendezvous for the next round. Must be
+  // called only when no participant of the completed round holds the state.
+  void Reset() {
+    ack.store(0, std::memory_order_relaxed);
+    rel.store(0, std::memory_order_relaxed);
+    done.store(0, std::memory_order_relaxed);
+    std::fill(values.begin(), values.end(), nullptr);
+    ready.emplace();
+    result = RendezvousResult<R>::Empty();
+  }
 
   std::atomic<int32_t> ack;
   std::atomic<int32_t> rel;
+  // Number of participants that copied `result` out of the state.
+  std::atomic<int32_t> done;
   std::vector<const V*> values;
 
-  absl::Notification ready;  // signals availability of `result`
+  // Signals availability of `result`. absl::Notification can't be reset, so
+  // a reused state gets a new one in place.
+  std::optional<absl::Notification> ready;
   RendezvousResultType<R> result;
 };
 
@@ -207,6 +229,14 @@ struct RendezvousState {
 //
 // This process guarantees that all completed rendezvous are removed from a map
 // and a map has records only for rendezvous in progress.
+//
+// States of a few completed rendezvous are kept aside, and a new rendezvous
+// with the same number of participants reuses one of them once all
+// participants of the completed rendezvous released it. The last participant
+// to take the result clears it from the state, so a pooled state never keeps
+// the result (e.g. a lock acquired by the rendezvous) alive. Collectives run the
+// same rendezvous at every step, so in the steady state joining a rendezvous
+// doesn't allocate.
 template <typename K, typename R, typename V>
 class RendezvousMap {
  public:
@@ -219,6 +249,22 @@ class RendezvousMap {
     // Join an in-progress rendezvous.
     if (state) return state;
 
+    // Reuse the state of a completed rendezvous.
+    for (std::shared_ptr<State>& completed : completed_) {
+      if (completed.use_count() != 1 ||
+          completed->values.size() != num_threads) {
+        continue;
+      }
+      // Synchronizes with the release of the last reference by a participant,
+      // so its reads of the completed state happen before the reset.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      state = std::move(completed);
+      completed = std::move(completed_.back());
+      completed_.pop_back();
+      state->Reset();
+      return state;
+    }
+
     // Join a newly created rendezvous.
     return state = std::make_shared<State>(num_threads);
   }
@@ -236,17 +282,25 @@ class RendezvousMap {
       // +1 reference for all participants and a +1 reference we extracted.
       CHECK_EQ(state.use_count(), 1 + state->values.size());  // NOLINT
 
+      // Keep the state for reuse by one of the next rendezvous.
+      if (completed_.size() < kMaxCompletedStates) {
+        completed_.push_back(state);
+      }
+
       return state;
     }();
 
     // Notify awaiting participants without holding a lock.
     state->result = std::move(result);
-    state->ready.Notify();
+    state->ready->Notify();
   }
 
  private:
+  static constexpr size_t kMaxCompletedStates = 16;
+
   absl::Mutex mutex_;
   absl::flat_hash_map<K, std::shared_ptr<State>> state_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<State>> completed_ ABSL_GUARDED_BY(mutex_);
 };
 
 void AwaitAndLogIfStuck(absl::Notification& ready, std::string_view name,
@@ -303,7 +357,7 @@ RendezvousResultType<R> RendezvousSingle(std::string_view name, const K& key,
   if (id < num_threads - 1) {
     // Threads arriving before the last one wait for a result to be computed by
     // the last joining thread.
-    internal::AwaitAndLogIfStuck(state->ready, name, num_threads,
+    internal::AwaitAndLogIfStuck(*state->ready, name, num_threads,
                                  warn_stuck_timeout, terminate_timeout);
   } else {
     // Last thread to arrive executes the function and completes rendezvous by
@@ -315,7 +369,15 @@ RendezvousResultType<R> RendezvousSingle(std::string_view name, const K& key,
     rendezvous.Complete(key, RendezvousResult<R>::Wrap(fn(values)));
   }
 
-  return state->result;
+  // The state can outlive the rendezvous in the pool of completed states, so
+  // the last participant to copy the result drops the state's references to
+  // the result and to the participants' values.
+  RendezvousResultType<R> result = state->result;
+  if (state->done.fetch_add(1, std::memory_order_acq_rel) == num_threads - 1) {
+    state->result = RendezvousResult<R>::Empty();
+    std::fill(state->values.begin(), state->values.end(), nullptr);
+  }
+  return result;
 }
 
 template <typename R, typename K, typename Fn>
@@ -112,6 +112,59 @@ TEST(RendezvousTest, RepeatRendezvous) {
   }
 }
 
+TEST(RendezvousTest, RepeatRendezvousWithSameKey) {
+  auto thread_pool = CreateThreadPool(4);
+
+  auto accumulate = [](absl::Span<const int32_t* const> values) {
+    int32_t result = 0;
+    for (const int32_t* value : values) result += *value;
+    return result;
+  };
+
+  // Rendezvous states are reused across rounds, check that values and results
+  // of a previous round never leak into the next one.
+  for (int32_t i = 0; i < 100; ++i) {
+    absl::BlockingCounter counter(4);
+    std::vector<std::shared_ptr<int32_t>> results(4);
+
+    for (int32_t id = 0; id < 4; ++id) {
+      thread_pool.Schedule([&, id] {
+        results[id] = RendezvousSingle<int32_t>("rendezvous_test", 0, i + id,
+                                                4, accumulate);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+
+    for (const std::shared_ptr<int32_t>& result : results) {
+      ASSERT_EQ(*result, 4 * i + 6);
+    }
+  }
+}
+
+TEST(RendezvousTest, CompletedRendezvousReleasesResult) {
+  auto thread_pool = CreateThreadPool(2);
+
+  absl::BlockingCounter counter(2);
+  std::vector<std::shared_ptr<int32_t>> results(2);
+
+  for (int32_t id = 0; id < 2; ++id) {
+    thread_pool.Schedule([&, id] {
+      results[id] =
+          RendezvousSingle<int32_t>("rendezvous_test", 0, 2, [] { return 42; });
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+
+  // Completed rendezvous states are kept for reuse, but they must not keep the
+  // result alive once all participants have it, e.g. a result holding a lock
+  // would never be released otherwise.
+  std::weak_ptr<int32_t> result = results[0];
+  results.clear();
+  ASSERT_TRUE(result.expired());
+}
+
 TEST(RendezvousTest, ReturningStatusOr) {
   absl::BlockingCounter counter(2);
   std::vector<absl::StatusOr<std::shared_ptr<int32_t>>> results(2);
@@ -0,0 +1,273 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/scatter_determinism_expander.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "xla/comparison_util.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/literal_util.h"
+#include "xla/primitive_util.h"
+#include "xla/service/hlo_creation_utils.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+// Returns true if the combiner is a floating point add or multiply of its two
+// parameters. Other simple combiners are already deterministic: integer
+// arithmetic is associative, and so are minimum and maximum.
+bool IsNonAssociativeBinaryCombiner(const HloComputation* combiner) {
+  if (combiner->instruction_count() != 3) {
+    return false;
+  }
+  const HloInstruction* root = combiner->root_instruction();
+  if (root->opcode() != HloOpcode::kAdd &&
+      root->opcode() != HloOpcode::kMultiply) {
+    return false;
+  }
+  return ShapeUtil::ElementIsFloating(root->shape()) &&
+         root->operand(0)->opcode() == HloOpcode::kParameter &&
+         root->operand(1)->opcode() == HloOpcode::kParameter &&
+         root->operand(0) != root->operand(1);
+}
+
+// Returns true if every update of the scatter is a whole row of the operand,
+// addressed by a single scalar index.
+bool ScattersWholeRows(const HloScatterInstruction* scatter) {
+  const ScatterDimensionNumbers& dnums = scatter->scatter_dimension_numbers();
+  const Shape& operand_shape = scatter->scatter_operands()[0]->shape();
+  const Shape& indices_shape = scatter->scatter_indices()->shape();
+  const Shape& updates_shape = scatter->scatter_updates()[0]->shape();
+  if (!operand_shape.is_static() || !updates_shape.is_static() ||
+      dnums.index_vector_dim() != 1 ||
+      dnums.scatter_dims_to_operand_dims_size() != 1) {
+    return false;
+  }
+  if (indices_shape.rank() != 1 &&
+      (indices_shape.rank() != 2 || indices_shape.dimensions(1) != 1)) {
+    return false;
+  }
+  int64_t scatter_dim = dnums.scatter_dims_to_operand_dims(0);
+  if (dnums.inserted_window_dims_size() != 1 ||
+      dnums.inserted_window_dims(0) != scatter_dim ||
+      updates_shape.rank() != operand_shape.rank()) {
+    return false;
+  }
+  for (int64_t i = 0; i < dnums.update_window_dims_size(); ++i) {
+    if (dnums.update_window_dims(i) != i + 1) {
+      return false;
+    }
+  }
+  int64_t window_dim = 1;
+  for (int64_t i = 0; i < operand_shape.rank(); ++i) {
+    if (i != scatter_dim && updates_shape.dimensions(window_dim++) !=
+                                operand_shape.dimensions(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Creates a comparator that sorts (index, position) pairs by index.
+HloComputation* CreateIndexLessThanComputation(HloModule* module,
+                                               PrimitiveType index_type) {
+  HloComputation::Builder builder("scatter_index_less_than");
+  const Shape key_shape = ShapeUtil::MakeShape(index_type, {});
+  const Shape position_shape = ShapeUtil::MakeShape(S32, {});
+  HloInstruction* lhs = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, key_shape, "lhs_index"));
+  HloInstruction* rhs = builder.AddInstruction(
+      HloInstruction::CreateParameter(1, key_shape, "rhs_index"));
+  builder.AddInstruction(
+      HloInstruction::CreateParameter(2, position_shape, "lhs_position"));
+  builder.AddInstruction(
+      HloInstruction::CreateParameter(3, position_shape, "rhs_position"));
+  builder.AddInstruction(HloInstruction::CreateCompare(
+      ShapeUtil::MakeShape(PRED, {}), lhs, rhs, ComparisonDirection::kLt));
+  return module->AddEmbeddedComputation(builder.Build());
+}
+
+// Returns a padding config that pads the major dimension with `low` elements
+// at the start and `high` elements at the end.
+PaddingConfig MakeMajorDimPaddingConfig(int64_t rank, int64_t low,
+                                        int64_t high) {
+  PaddingConfig config = MakeNoPaddingConfig(rank);
+  config.mutable_dimensions(0)->set_edge_padding_low(low);
+  config.mutable_dimensions(0)->set_edge_padding_high(high);
+  return config;
+}
+
+}  // namespace
+
+bool ScatterDeterminismExpander::InstructionMatchesPattern(
+    HloInstruction* inst) {
+  auto* scatter = DynCast<HloScatterInstruction>(inst);
+  if (scatter == nullptr || scatter->unique_indices() ||
+      scatter->scatter_operand_count() != 1) {
+    return false;
+  }
+  const Shape& indices_shape = scatter->scatter_indices()->shape();
+  if (indices_shape.rank() < 1 || indices_shape.dimensions(0) < 2) {
+    return false;
+  }
+  // Out of bounds updates are redirected to the size of the scatter dimension,
+  // which has to be representable in the index type.
+  if (primitive_util::BitWidth(indices_shape.element_type()) < 32) {
+    return false;
+  }
+  return IsNonAssociativeBinaryCombiner(scatter->to_apply()) &&
+         ScattersWholeRows(scatter);
+}
+
+absl::StatusOr<HloInstruction*> ScatterDeterminismExpander::ExpandInstruction(
+    HloInstruction* inst) {
+  auto* scatter = Cast<HloScatterInstruction>(inst);
+  HloComputation* computation = scatter->parent();
+  HloInstruction* operand = scatter->scatter_operands()[0];
+  HloInstruction* indices = scatter->scatter_indices();
+  HloInstruction* updates = scatter->scatter_updates()[0];
+  const ScatterDimensionNumbers& dnums = scatter->scatter_dimension_numbers();
+  const Shape& indices_shape = indices->shape();
+  const Shape& updates_shape = updates->shape();
+  const int64_t num_updates = updates_shape.dimensions(0);
+  const int64_t rank = updates_shape.rank();
+
+  // Sort the indices together with their positions. The sort is stable, so
+  // updates to the same index keep their original order, and the scan below
+  // combines them in the same order on every run.
+  if (indices_shape.rank() == 2) {
+    TF_ASSIGN_OR_RETURN(indices, MakeReshapeHlo({num_updates}, indices));
+  }
+  HloInstruction* positions =
+      MakeIotaHlo(computation, ShapeUtil::MakeShape(S32, {num_updates}),
+                  /*iota_dimension=*/0);
+  HloInstruction* sort = computation->AddInstruction(HloInstruction::CreateSort(
+      ShapeUtil::MakeTupleShape({indices->shape(), positions->shape()}),
+      /*dimension=*/0, {indices, positions},
+      CreateIndexLessThanComputation(scatter->GetModule(),
+                                     indices_shape.element_type()),
+      /*is_stable=*/true));
+  TF_ASSIGN_OR_RETURN(HloInstruction * sorted_indices,
+                      MakeGetTupleElementHlo(sort, 0));
+  TF_ASSIGN_OR_RETURN(HloInstruction * sorted_positions,
+                      MakeGetTupleElementHlo(sort, 1));
+
+  // Gather the updates into the sorted order.
+  TF_ASSIGN_OR_RETURN(HloInstruction * gather_indices,
+                      MakeReshapeHlo({num_updates, 1}, sorted_positions));
+  std::vector<int64_t> offset_dims;
+  for (int64_t i = 1; i < rank; ++i) {
+    offset_dims.push_back(i);
+  }
+  std::vector<int64_t> slice_sizes(updates_shape.dimensions().begin(),
+                                   updates_shape.dimensions().end());
+  slice_sizes[0] = 1;
+  HloInstruction* values =
+      computation->AddInstruction(HloInstruction::CreateGather(
+          updates_shape, updates, gather_indices,
+          HloGatherInstruction::MakeGatherDimNumbers(
+              offset_dims, /*collapsed_slice_dims=*/{0},
+              /*start_index_map=*/{0}, /*index_vector_dim=*/1),
+          slice_sizes, /*indices_are_sorted=*/false));
+
+  // Inclusive segmented scan: in step k, every update is combined with the
+  // partial result 2^k positions earlier if both belong to the same index.
+  // Since the indices are sorted, equal indices at both ends of a range imply
+  // that the whole range has the same index.
+  HloOpcode combiner_opcode = scatter->to_apply()->root_instruction()->opcode();
+  HloInstruction* zero = computation->AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::Zero(
+          updates_shape.element_type())));
+  HloInstruction* false_value = computation->AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR0<bool>(false)));
+  std::vector<int64_t> slice_start(rank, 0);
+  std::vector<int64_t> slice_strides(rank, 1);
+  for (int64_t offset = 1; offset < num_updates; offset *= 2) {
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * earlier_indices,
+        MakeSliceHlo(sorted_indices, {0}, {num_updates - offset}, {1}));
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * later_indices,
+        MakeSliceHlo(sorted_indices, {offset}, {num_updates}, {1}));
+    TF_ASSIGN_OR_RETURN(HloInstruction * same_index,
+                        MakeCompareHlo(ComparisonDirection::kEq,
+                                       earlier_indices, later_indices));
+    TF_ASSIGN_OR_RETURN(
+        same_index,
+        MakePadHlo(same_index, false_value,
+                   MakeMajorDimPaddingConfig(/*rank=*/1, offset, 0)));
+
+    std::vector<int64_t> slice_limit(updates_shape.dimensions().begin(),
+                                     updates_shape.dimensions().end());
+    slice_limit[0] = num_updates - offset;
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * earlier_values,
+        MakeSliceHlo(values, slice_start, slice_limit, slice_strides));
+    TF_ASSIGN_OR_RETURN(
+        earlier_values,
+        MakePadHlo(earlier_values, zero,
+                   MakeMajorDimPaddingConfig(rank, offset, 0)));
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * combined,
+        MakeBinaryHlo(combiner_opcode, earlier_values, values));
+    HloInstruction* mask =
+        MakeBroadcastHlo(same_index, {0}, updates_shape.dimensions());
+    TF_ASSIGN_OR_RETURN(values, MakeSelectHlo(mask, combined, values));
+  }
+
+  // Only the last update of every index is written. The others are moved out
+  // of bounds, where the scatter drops them.
+  TF_ASSIGN_OR_RETURN(
+      HloInstruction * head_indices,
+      MakeSliceHlo(sorted_indices, {0}, {num_updates - 1}, {1}));
+  TF_ASSIGN_OR_RETURN(HloInstruction * tail_indices,
+                      MakeSliceHlo(sorted_indices, {1}, {num_updates}, {1}));
+  TF_ASSIGN_OR_RETURN(
+      HloInstruction * is_last,
+      MakeCompareHlo(ComparisonDirection::kNe, head_indices, tail_indices));
+  HloInstruction* true_value = computation->AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR0<bool>(true)));
+  TF_ASSIGN_OR_RETURN(
+      is_last, MakePadHlo(is_last, true_value,
+                          MakeMajorDimPaddingConfig(/*rank=*/1, 0, 1)));
+  HloInstruction* out_of_bounds = MakeScalarLike(
+      sorted_indices,
+      operand->shape().dimensions(dnums.scatter_dims_to_operand_dims(0)));
+  TF_ASSIGN_OR_RETURN(HloInstruction * new_indices,
+                      MakeSelectHlo(is_last, sorted_indices, out_of_bounds));
+  if (indices_shape.rank() == 2) {
+    TF_ASSIGN_OR_RETURN(new_indices,
+                        MakeReshapeHlo(indices_shape, new_indices));
+  }
+
+  return computation->AddInstruction(HloInstruction::CreateScatter(
+      scatter->shape(), operand, new_indices, values, scatter->to_apply(),
+      dnums, /*indices_are_sorted=*/false, /*unique_indices=*/true));
+}
+
+}  // namespace xla
@@ -0,0 +1,55 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_SCATTER_DETERMINISM_EXPANDER_H_
+#define XLA_SERVICE_SCATTER_DETERMINISM_EXPANDER_H_
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/op_expander_pass.h"
+
+namespace xla {
+
+// This pass rewrites scatters of whole rows with non-unique indices and a
+// floating point add or multiply combiner into a deterministic form that
+// backends can emit without atomics:
+//
+//   1. The indices are sorted together with their positions, and the updates
+//      are gathered into the sorted order.
+//   2. An inclusive segmented scan combines the updates of equal indices in
+//      log2(N) elementwise steps, so the last update of every run holds the
+//      combination of the whole run.
+//   3. A scatter with unique indices writes the last update of every run. The
+//      other updates are redirected out of bounds and dropped.
+//
+// The result only depends on the sort order, so it is the same on every run.
+// Unlike the while loop generated by ScatterExpander, all steps are parallel.
+class ScatterDeterminismExpander : public OpExpanderPass {
+ public:
+  absl::string_view name() const override {
+    return "scatter_determinism_expander";
+  }
+
+ protected:
+  bool InstructionMatchesPattern(HloInstruction* inst) override;
+
+  absl::StatusOr<HloInstruction*> ExpandInstruction(
+      HloInstruction* inst) override;
+};
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_SCATTER_DETERMINISM_EXPANDER_H_
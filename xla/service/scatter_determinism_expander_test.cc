@@ -0,0 +1,181 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/scatter_determinism_expander.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "xla/hlo/evaluator/hlo_evaluator.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/test.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+using ScatterDeterminismExpanderTest = HloTestBase;
+
+constexpr char kScatterAddRows[] = R"(
+  HloModule scatter_add_rows
+
+  add {
+    lhs = f32[] parameter(0)
+    rhs = f32[] parameter(1)
+    ROOT add = f32[] add(lhs, rhs)
+  }
+
+  ENTRY main {
+    operand = f32[4,3] parameter(0)
+    indices = s32[6,1] parameter(1)
+    updates = f32[6,3] parameter(2)
+    ROOT scatter = f32[4,3] scatter(operand, indices, updates),
+      update_window_dims={1}, inserted_window_dims={0},
+      scatter_dims_to_operand_dims={0}, index_vector_dim=1, to_apply=add
+  })";
+
+TEST_F(ScatterDeterminismExpanderTest, RewritesToScatterWithUniqueIndices) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kScatterAddRows));
+  ScatterDeterminismExpander expander;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&expander, module.get()));
+  EXPECT_TRUE(changed);
+
+  auto* scatter = DynCast<HloScatterInstruction>(
+      module->entry_computation()->root_instruction());
+  ASSERT_NE(scatter, nullptr);
+  EXPECT_TRUE(scatter->unique_indices());
+  EXPECT_NE(FindInstruction(module.get(), HloOpcode::kSort), nullptr);
+}
+
+TEST_F(ScatterDeterminismExpanderTest, PreservesScatterResult) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kScatterAddRows));
+  std::unique_ptr<HloModule> expanded_module = module->Clone();
+  ScatterDeterminismExpander expander;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(&expander, expanded_module.get()));
+  ASSERT_TRUE(changed);
+
+  Literal operand = LiteralUtil::CreateR2<float>(
+      {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}, {10, 11, 12}});
+  // Index 5 is out of bounds and must be dropped.
+  Literal indices =
+      LiteralUtil::CreateR2<int32_t>({{2}, {0}, {2}, {5}, {2}, {0}});
+  Literal updates = LiteralUtil::CreateR2<float>({{1, 1, 1},
+                                                  {2, 2, 2},
+                                                  {3, 3, 3},
+                                                  {4, 4, 4},
+                                                  {5, 5, 5},
+                                                  {6, 6, 6}});
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal expected,
+      HloEvaluator().Evaluate(*module, {&operand, &indices, &updates}));
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal actual,
+      HloEvaluator().Evaluate(*expanded_module,
+                              {&operand, &indices, &updates}));
+  EXPECT_EQ(expected, actual);
+}
+
+TEST_F(ScatterDeterminismExpanderTest, CombinesDuplicateIndicesInOrder) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kScatterAddRows));
+  ScatterDeterminismExpander expander;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&expander, module.get()));
+  ASSERT_TRUE(changed);
+
+  // Updates to the same index must keep their relative order, otherwise the
+  // combination order depends on the sort implementation.
+  auto* sort = DynCast<HloSortInstruction>(
+      FindInstruction(module.get(), HloOpcode::kSort));
+  ASSERT_NE(sort, nullptr);
+  EXPECT_TRUE(sort->is_stable());
+
+  Literal operand = LiteralUtil::CreateR2<float>(
+      {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}, {10, 11, 12}});
+  Literal indices =
+      LiteralUtil::CreateR2<int32_t>({{1}, {1}, {3}, {1}, {1}, {1}});
+  Literal updates = LiteralUtil::CreateR2<float>({{1, 10, 100},
+                                                  {2, 20, 200},
+                                                  {3, 30, 300},
+                                                  {4, 40, 400},
+                                                  {5, 50, 500},
+                                                  {6, 60, 600}});
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal actual,
+      HloEvaluator().Evaluate(*module, {&operand, &indices, &updates}));
+  EXPECT_EQ(actual, LiteralUtil::CreateR2<float>({{1, 2, 3},
+                                                  {22, 185, 1806},
+                                                  {7, 8, 9},
+                                                  {13, 41, 312}}));
+}
+
+TEST_F(ScatterDeterminismExpanderTest, IgnoresScalarIndices) {
+  constexpr char kHlo[] = R"(
+    HloModule scatter_add_row
+
+    add {
+      lhs = f32[] parameter(0)
+      rhs = f32[] parameter(1)
+      ROOT add = f32[] add(lhs, rhs)
+    }
+
+    ENTRY main {
+      operand = f32[4,3] parameter(0)
+      index = s32[] parameter(1)
+      update = f32[3] parameter(2)
+      ROOT scatter = f32[4,3] scatter(operand, index, update),
+        update_window_dims={0}, inserted_window_dims={0},
+        scatter_dims_to_operand_dims={0}, index_vector_dim=0, to_apply=add
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  ScatterDeterminismExpander expander;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&expander, module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(ScatterDeterminismExpanderTest, IgnoresIntegerScatter) {
+  constexpr char kHlo[] = R"(
+    HloModule scatter_add_rows
+
+    add {
+      lhs = s32[] parameter(0)
+      rhs = s32[] parameter(1)
+      ROOT add = s32[] add(lhs, rhs)
+    }
+
+    ENTRY main {
+      operand = s32[4,3] parameter(0)
+      indices = s32[6] parameter(1)
+      updates = s32[6,3] parameter(2)
+      ROOT scatter = s32[4,3] scatter(operand, indices, updates),
+        update_window_dims={1}, inserted_window_dims={0},
+        scatter_dims_to_operand_dims={0}, index_vector_dim=1, to_apply=add
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  ScatterDeterminismExpander expander;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunHloPass(&expander, module.get()));
+  EXPECT_FALSE(changed);
+}
+
+}  // namespace
+}  // namespace xla
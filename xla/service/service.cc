@@ -60,8 +60,10 @@ limitations under the License.
 #include "xla/types.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/lib/strings/proto_serialization.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/protobuf.h"
 #include "tsl/profiler/lib/scoped_annotation.h"
@@ -72,6 +74,23 @@ namespace {
 using absl::StrCat;
 using absl::StrFormat;
 
+// Returns a key identifying the executable compiled from `computation` with
+// `config` for `executor` in the persistent compilation cache.
+std::string PersistentCompilationCacheKey(const HloModuleProto& computation,
+                                          const HloModuleConfig& config,
+                                          se::StreamExecutor* executor) {
+  std::string serialized_computation;
+  std::string serialized_debug_options;
+  tsl::SerializeToStringDeterministic(computation, &serialized_computation);
+  tsl::SerializeToStringDeterministic(config.debug_options(),
+                                      &serialized_debug_options);
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(StrCat(
+      serialized_computation, "::", config.compilation_cache_key(), "::",
+      serialized_debug_options, "::", executor->GetPlatform()->Name(), "::",
+      executor->GetDeviceDescription().name()));
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
 // Records the arguments used to invoke a computation in an HloSnapshot proto.
 absl::Status RecordArguments(
     const absl::Span<const ShapedBuffer* const> arguments, se::Stream* stream,
@@ -134,9 +153,21 @@ const std::optional<std::set<int>>& ServiceOptions::allowed_devices() const {
   return allowed_devices_;
 }
 
+ServiceOptions& ServiceOptions::set_compilation_cache_options(
+    const CompilationCache::Options& options) {
+  compilation_cache_options_ = options;
+  return *this;
+}
+
+const CompilationCache::Options& ServiceOptions::compilation_cache_options()
+    const {
+  return compilation_cache_options_;
+}
+
 Service::Service(const ServiceOptions& options,
                  std::unique_ptr<Backend> execute_backend)
     : options_(options),
+      compilation_cache_(options.compilation_cache_options()),
       allocation_tracker_(execute_backend.get()),
       execute_backend_(std::move(execute_backend)) {
   CHECK_GT(options_.number_of_replicas(), 0);
@@ -816,12 +847,30 @@ absl::StatusOr<ExecutionHandle> Service::Compile(
   VLOG(3) << "Compile created HloModuleConfig computation layout: "
           << module_config->entry_computation_layout().ToString();
 
-  TF_ASSIGN_OR_RETURN(
-      std::unique_ptr<Executable> executable,
-      BuildExecutable(computation.proto(), std::move(module_config),
-                      execute_backend_.get(),
-                      execute_backend_->default_stream_executor(),
-                      {/*device_allocator=*/nullptr}));
+  // Other processes sharing the persistent compilation cache directory might
+  // have already compiled the same computation.
+  se::StreamExecutor* executor = execute_backend_->default_stream_executor();
+  Compiler* compiler = execute_backend_->compiler();
+  std::string persistent_key;
+  std::unique_ptr<Executable> executable;
+  if (!compilation_cache_.options().persistent_cache_dir.empty()) {
+    persistent_key = PersistentCompilationCacheKey(computation.proto(),
+                                                   *module_config, executor);
+    TF_ASSIGN_OR_RETURN(executable, compilation_cache_.LoadFromPersistentCache(
+                                        persistent_key, compiler, executor));
+  }
+
+  if (executable == nullptr) {
+    TF_ASSIGN_OR_RETURN(
+        executable,
+        BuildExecutable(computation.proto(), std::move(module_config),
+                        execute_backend_.get(), executor,
+                        {/*device_allocator=*/nullptr}));
+    if (!persistent_key.empty()) {
+      compilation_cache_.StoreToPersistentCache(persistent_key,
+                                                executable.get(), compiler);
+    }
+  }
 
   VLOG(1) << "successfully completed 'compile' request";
   return compilation_cache_.Insert(std::move(executable));
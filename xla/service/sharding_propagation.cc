@@ -1071,10 +1071,61 @@ bool IsCSEPreventionSharding(const HloSharding& sharding) {
 
 }  // namespace
 
+double EstimateReshardBytes(const HloInstruction& instruction,
+                            const HloSharding& from, const HloSharding& to) {
+  if (from == to) {
+    return 0;
+  }
+  const double bytes = ShapeUtil::ByteSizeOf(instruction.shape());
+  if (to.IsTuple() || from.IsTuple() || to.IsManual() || to.IsUnknown()) {
+    return bytes;
+  }
+  if (!from.HasUniqueDevice() &&
+      hlo_sharding_util::IsSubTilingOrEqualSharding(instruction.shape(), to,
+                                                    from)) {
+    return 0;
+  }
+  return bytes / to.NumTiles();
+}
+
+namespace {
+
+// Returns the cost of resharding the operands of a dot to the shardings
+// required by 'candidate' as the sharding of the dot.
+double DotOperandsReshardCost(
+    HloInstruction* instruction, const HloSharding& candidate,
+    const dot_as_convolution_util::DotConvolutionDimsInfo& dnums,
+    bool may_combine_partial_sharding,
+    const ReshardCostFunction& reshard_cost_function) {
+  std::optional<HloSharding> original_sharding;
+  if (instruction->has_sharding()) {
+    original_sharding = instruction->sharding();
+  }
+  // InferDotOperandSharding reads the candidate from the instruction.
+  instruction->set_sharding(candidate);
+  double cost = 0;
+  for (int64_t operand_index = 0; operand_index < 2; ++operand_index) {
+    const HloInstruction* operand = instruction->operand(operand_index);
+    HloSharding required = hlo_sharding_util::InferDotOperandSharding(
+        instruction, operand_index, dnums,
+        /*consider_other_operand=*/false, may_combine_partial_sharding);
+    cost += reshard_cost_function(*operand, operand->sharding(), required);
+  }
+  if (original_sharding.has_value()) {
+    instruction->set_sharding(*std::move(original_sharding));
+  } else {
+    instruction->clear_sharding();
+  }
+  return cost;
+}
+
+}  // namespace
+
 bool InferDotShardingFromOperands(
     HloInstruction* instruction, const CallGraph& call_graph,
     const dot_as_convolution_util::DotConvolutionDimsInfo& dnums,
-    bool may_combine_partial_sharding, bool is_spmd) {
+    bool may_combine_partial_sharding, bool is_spmd,
+    const ReshardCostFunction& reshard_cost_function) {
   auto from_operand = [&](int64_t operand_index) {
     auto operand = instruction->operand(operand_index);
     const HloSharding& operand_sharding = operand->sharding();
@@ -1167,16 +1218,47 @@ bool InferDotShardingFromOperands(
     // If the sharding from operand 1 is a subtiling of the user, but not the
     // one from operand 0 prioritize that sharding.
     if (!operand_0_is_lookahead_subtiling && operand_1_is_lookahead_subtiling) {
-      instruction->set_sharding(*improved_operand_1);
       std::swap(sharding_priority[0], sharding_priority[1]);
       priority_defined_with_lookahead = true;
     }
   }
-  // If lookahead didn't define a priority then use size.
-  if (!priority_defined_with_lookahead &&
-      ShapeUtil::ByteSizeOf(instruction->operand(0)->shape()) <
-          ShapeUtil::ByteSizeOf(instruction->operand(1)->shape())) {
-    std::swap(sharding_priority[0], sharding_priority[1]);
+  // If lookahead didn't define a priority then ask the cost model which
+  // candidate needs the cheapest resharding of the operands.
+  bool priority_defined_with_cost = false;
+  if (!priority_defined_with_lookahead && reshard_cost_function &&
+      dnums.conv_spatial_dims.empty()) {
+    const double cost_0 = DotOperandsReshardCost(
+        instruction, sharding_priority[0], dnums, may_combine_partial_sharding,
+        reshard_cost_function);
+    const double cost_1 = DotOperandsReshardCost(
+        instruction, sharding_priority[1], dnums, may_combine_partial_sharding,
+        reshard_cost_function);
+    VLOG(2) << "Conflicting operand shardings for " << instruction->name()
+            << ": reshard cost " << cost_0 << " following operand 0, "
+            << cost_1 << " following operand 1";
+    if (cost_0 != cost_1) {
+      if (cost_1 < cost_0) {
+        std::swap(sharding_priority[0], sharding_priority[1]);
+      }
+      priority_defined_with_cost = true;
+    }
+  }
+  // Otherwise follow the operand that is more expensive to reshard. The
+  // partitioner has to reshard the other operand to match, which moves up to
+  // all of its bytes.
+  if (!priority_defined_with_lookahead && !priority_defined_with_cost) {
+    const int64_t operand_0_bytes =
+        ShapeUtil::ByteSizeOf(instruction->operand(0)->shape());
+    const int64_t operand_1_bytes =
+        ShapeUtil::ByteSizeOf(instruction->operand(1)->shape());
+    const bool follow_operand_1 = operand_0_bytes < operand_1_bytes;
+    if (follow_operand_1) {
+      std::swap(sharding_priority[0], sharding_priority[1]);
+    }
+    VLOG(2) << "Conflicting operand shardings for " << instruction->name()
+            << ": following operand " << (follow_operand_1 ? 1 : 0)
+            << ", resharding the other operand moves up to "
+            << std::min(operand_0_bytes, operand_1_bytes) << " bytes";
   }
   // Set primary sharding to the instruction and then try to improve it with
   // the secondary sharding.
@@ -1187,11 +1269,10 @@ bool InferDotShardingFromOperands(
 }
 
 // Convolution handling for InferShardingFromOperands().
-bool InferConvolutionShardingFromOperands(HloInstruction* instruction,
-                                          const CallGraph& call_graph,
-                                          int64_t aggressiveness,
-                                          bool may_combine_partial_sharding,
-                                          bool is_spmd) {
+bool InferConvolutionShardingFromOperands(
+    HloInstruction* instruction, const CallGraph& call_graph,
+    int64_t aggressiveness, bool may_combine_partial_sharding, bool is_spmd,
+    const ReshardCostFunction& reshard_cost_function) {
   auto get_partitions_for_dims =
       [&](const HloInstruction* inst,
           absl::Span<
@@ -1227,7 +1308,8 @@ bool InferConvolutionShardingFromOperands(HloInstruction* instruction,
        instruction->batch_group_count() == 1 &&
        instruction->feature_group_count() == 1)) {
     return InferDotShardingFromOperands(instruction, call_graph, dot_dims,
-                                        may_combine_partial_sharding, is_spmd);
+                                        may_combine_partial_sharding, is_spmd,
+                                        reshard_cost_function);
   }
   const auto& dnums = instruction->convolution_dimension_numbers();
   const HloInstruction* lhs = instruction->operand(0);
@@ -2343,7 +2425,7 @@ bool ShardingPropagation::InferShardingFromOperands(
     case HloOpcode::kConvolution:
       return InferConvolutionShardingFromOperands(
           instruction, call_graph, aggressiveness, may_combine_partial_sharding,
-          is_spmd_);
+          is_spmd_, reshard_cost_function_);
     case HloOpcode::kTranspose: {
       const HloInstruction* input = instruction->operand(0);
       if (!hlo_sharding_util::IsSpatiallyPartitioned(input)) {
@@ -2434,7 +2516,7 @@ bool ShardingPropagation::InferShardingFromOperands(
           dot_as_convolution_util::ParseDotGeneralFromDot(instruction);
       return InferDotShardingFromOperands(instruction, call_graph, dnums,
                                           may_combine_partial_sharding,
-                                          is_spmd_);
+                                          is_spmd_, reshard_cost_function_);
     }
     case HloOpcode::kParameter: {
       auto parent_it = computation_map.find(instruction->parent());
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef XLA_SERVICE_SHARDING_PROPAGATION_H_
 #define XLA_SERVICE_SHARDING_PROPAGATION_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -24,7 +26,9 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_sharding.h"
 #include "xla/service/call_graph.h"
 #include "xla/service/custom_call_sharding_helper.h"
 #include "xla/service/dot_as_convolution_util.h"
@@ -32,20 +36,35 @@ limitations under the License.
 
 namespace xla {
 
+// Returns the estimated cost of resharding the value of 'instruction' from
+// 'from' to 'to'. Backends can plug in a model of their collectives; the units
+// only have to be consistent across calls.
+using ReshardCostFunction =
+    std::function<double(const HloInstruction& instruction,
+                         const HloSharding& from, const HloSharding& to)>;
+
+// A ReshardCostFunction which returns the number of bytes each device has to
+// receive, ignoring which collective implements the resharding. Resharding to
+// a subtiling of the current sharding only slices locally and is free.
+double EstimateReshardBytes(const HloInstruction& instruction,
+                            const HloSharding& from, const HloSharding& to);
+
 // Infers the shardings for a dot HLO op from the shardings on its operands,
-// which are expected to have sharding annotations.
+// which are expected to have sharding annotations. When the operands imply
+// conflicting shardings, 'reshard_cost_function' (if set) picks the one which
+// is cheapest to reshard the operands to.
 bool InferDotShardingFromOperands(
     HloInstruction* instruction, const CallGraph& call_graph,
     const dot_as_convolution_util::DotConvolutionDimsInfo& dnums,
-    bool may_combine_partial_sharding, bool is_spmd);
+    bool may_combine_partial_sharding, bool is_spmd,
+    const ReshardCostFunction& reshard_cost_function = nullptr);
 
 // Infers the shardings for a convolution HLO op from the shardings on its
 // operands, which are expected to have sharding annotations.
-bool InferConvolutionShardingFromOperands(HloInstruction* instruction,
-                                          const CallGraph& call_graph,
-                                          int64_t aggressiveness,
-                                          bool may_combine_partial_sharding,
-                                          bool is_spmd);
+bool InferConvolutionShardingFromOperands(
+    HloInstruction* instruction, const CallGraph& call_graph,
+    int64_t aggressiveness, bool may_combine_partial_sharding, bool is_spmd,
+    const ReshardCostFunction& reshard_cost_function = nullptr);
 
 // Remove Sharding custom-call instruction by folding the sharding attribute
 // to its operand. If the operand already has a different sharding, insert a
@@ -98,7 +117,8 @@ class ShardingPropagation : public HloModulePass {
       absl::Span<const bool> allow_spmd_sharding_propagation_to_parameters =
           {false},
       bool cse_prevention_only = false,
-      std::unique_ptr<CustomCallShardingHelper> sharding_helper = nullptr)
+      std::unique_ptr<CustomCallShardingHelper> sharding_helper = nullptr,
+      ReshardCostFunction reshard_cost_function = nullptr)
       : is_spmd_(is_spmd),
         propagate_metadata_(propagate_metadata),
         allow_spmd_sharding_propagation_to_output_(
@@ -113,7 +133,8 @@ class ShardingPropagation : public HloModulePass {
         allow_spmd_sharding_propagation_to_parameters_vector_(
             allow_spmd_sharding_propagation_to_parameters.begin(),
             allow_spmd_sharding_propagation_to_parameters.end()),
-        cse_prevention_only_(cse_prevention_only) {
+        cse_prevention_only_(cse_prevention_only),
+        reshard_cost_function_(std::move(reshard_cost_function)) {
     if (sharding_helper) {
       sharding_helper_ = std::move(sharding_helper);
     } else {
@@ -165,6 +186,9 @@ class ShardingPropagation : public HloModulePass {
   // instructions to prevent CSE across unrelated subgraphs. (A common case is
   // scalar broadcasts).
   bool cse_prevention_only_;
+  // Resolves conflicting operand shardings of dots and convolutions. If unset
+  // the sharding of the larger operand is kept.
+  ReshardCostFunction reshard_cost_function_;
 };
 
 }  // namespace xla
@@ -11925,5 +11925,63 @@ ENTRY %elementwise {
           "last_tile_dim_replicate}}"));
 }
 
+TEST_F(ShardingPropagationTest, DotConflictResolvedByReshardCost) {
+  const char* const hlo_string = R"(
+HloModule module
+ENTRY %entry {
+  %lhs = f32[64,32] parameter(0)
+  %lhs.copy = f32[64,32] copy(%lhs), sharding={devices=[2,1]0,1}
+  %rhs = f32[32,16] parameter(1)
+  %rhs.copy = f32[32,16] copy(%rhs), sharding={devices=[1,2]0,1}
+  %dot = f32[64,16] dot(%lhs.copy, %rhs.copy),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  ROOT %copy = f32[64,16] copy(%dot)
+})";
+  // By default the sharding of the larger operand is kept, and so does the
+  // byte estimate, since replicating the smaller operand moves fewer bytes.
+  for (const ReshardCostFunction& cost_function :
+       {ReshardCostFunction(nullptr),
+        ReshardCostFunction(EstimateReshardBytes)}) {
+    TF_ASSERT_OK_AND_ASSIGN(auto module,
+                            ParseAndReturnVerifiedModule(hlo_string));
+    TF_ASSERT_OK_AND_ASSIGN(
+        bool changed,
+        ShardingPropagation(
+            /*is_spmd=*/true, /*propagate_metadata=*/false,
+            /*allow_spmd_sharding_propagation_to_output=*/{false},
+            /*allow_spmd_sharding_propagation_to_parameters=*/{false},
+            /*cse_prevention_only=*/false, /*sharding_helper=*/nullptr,
+            cost_function)
+            .Run(module.get()));
+    EXPECT_TRUE(changed);
+    EXPECT_THAT(FindInstruction(module.get(), "dot"),
+                op::Sharding("{devices=[2,1]0,1}"));
+  }
+
+  // A cost model which makes resharding the right-hand side expensive flips
+  // the decision.
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  auto cost_function = [](const HloInstruction& instruction,
+                          const HloSharding& from, const HloSharding& to) {
+    if (from == to) {
+      return 0.0;
+    }
+    return instruction.name() == "rhs.copy" ? 100.0 : 1.0;
+  };
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      ShardingPropagation(
+          /*is_spmd=*/true, /*propagate_metadata=*/false,
+          /*allow_spmd_sharding_propagation_to_output=*/{false},
+          /*allow_spmd_sharding_propagation_to_parameters=*/{false},
+          /*cse_prevention_only=*/false, /*sharding_helper=*/nullptr,
+          cost_function)
+          .Run(module.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_THAT(FindInstruction(module.get(), "dot"),
+              op::Sharding("{devices=[1,2]0,1}"));
+}
+
 }  // namespace
 }  // namespace xla
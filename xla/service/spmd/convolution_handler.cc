@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
@@ -746,6 +748,152 @@ PartitionConvolutionWithSpatialDimensionHaloExchangeOnLHS(
       .hlo();
 }
 
+// Partition a convolution whose LHS is tiled along a single spatial dimension
+// and whose RHS is replicated, such that the halo exchange can be overlapped
+// with computation. The halos are exchanged with collective-permutes while the
+// interior of the output shard, which only depends on local data, is computed.
+// The left and right boundaries of the output shard are computed separately
+// from the received halos and concatenated with the interior.
+//
+// Only stride-1, undilated windows whose padding keeps the spatial size
+// unchanged are supported. Returns nullptr if the convolution does not match.
+absl::StatusOr<HloInstruction*> PartitionConvolutionWithOverlappedHaloExchange(
+    const PartitionedHlo& lhs, HloInstruction* rhs,
+    const Shape& output_base_shape, const HloSharding& output_sharding,
+    absl::FunctionRef<absl::StatusOr<HloInstruction*>(
+        HloInstruction*, HloInstruction*, SpmdBuilder*,
+        const Window& conv_window)>
+        create_sharded_conv,
+    const Window& conv_window, const HloInstruction* original_hlo,
+    SpmdBuilder* b) {
+  const auto& dnums = original_hlo->convolution_dimension_numbers();
+  if (original_hlo->feature_group_count() > 1 ||
+      original_hlo->batch_group_count() > 1) {
+    return nullptr;
+  }
+  const HloSharding& sharding = lhs.sharding();
+  std::optional<int64_t> spatial_index;
+  for (int64_t i = 0; i < dnums.input_spatial_dimensions_size(); ++i) {
+    if (ShardCountAtDim(sharding, dnums.input_spatial_dimensions(i)) > 1) {
+      if (spatial_index.has_value()) {
+        return nullptr;
+      }
+      spatial_index = i;
+    }
+  }
+  if (!spatial_index.has_value()) {
+    return nullptr;
+  }
+
+  const WindowDimension& wd = conv_window.dimensions(*spatial_index);
+  const int64_t dim = dnums.input_spatial_dimensions(*spatial_index);
+  const int64_t shard_count = ShardCountAtDim(sharding, dim);
+  const int64_t shard_size = lhs.hlo()->shape().dimensions(dim);
+  const int64_t left_halo_size = wd.padding_low();
+  const int64_t right_halo_size = wd.padding_high();
+  if (wd.stride() != 1 || wd.window_dilation() != 1 ||
+      wd.base_dilation() != 1 ||
+      lhs.base_shape().dimensions(dim) % shard_count != 0 ||
+      left_halo_size < 0 || right_halo_size < 0 ||
+      left_halo_size + right_halo_size == 0 ||
+      left_halo_size + right_halo_size != wd.size() - 1 ||
+      shard_size < wd.size()) {
+    return nullptr;
+  }
+
+  HloInstruction* operand = lhs.hlo();
+  auto slice = [&](HloInstruction* hlo, int64_t start, int64_t limit) {
+    Shape slice_shape = hlo->shape();
+    slice_shape.set_dimensions(dim, limit - start);
+    std::vector<int64_t> start_indices(slice_shape.rank(), 0);
+    start_indices[dim] = start;
+    std::vector<int64_t> limit_indices(hlo->shape().dimensions().begin(),
+                                       hlo->shape().dimensions().end());
+    limit_indices[dim] = limit;
+    std::vector<int64_t> strides(slice_shape.rank(), 1);
+    return b->AddInstruction(HloInstruction::CreateSlice(
+        slice_shape, hlo, start_indices, limit_indices, strides));
+  };
+  auto concat = [&](HloInstruction* first, HloInstruction* second) {
+    Shape concat_shape = first->shape();
+    concat_shape.set_dimensions(
+        dim, first->shape().dimensions(dim) + second->shape().dimensions(dim));
+    return b->AddInstruction(
+        HloInstruction::CreateConcatenate(concat_shape, {first, second}, dim));
+  };
+  // Receives `hlo` from the partition `offset` tiles away along `dim`.
+  // Partitions without a source receive zeros, which matches the zero padding
+  // of the convolution at the edges of the full shape.
+  auto receive_from_neighbor = [&](HloInstruction* hlo, int64_t offset) {
+    std::vector<std::pair<int64_t, int64_t>> source_target_pairs;
+    sharding.tile_assignment().Each(
+        [&](absl::Span<const int64_t> indices, int64_t device) {
+          int64_t source = indices[dim] + offset;
+          if (source < 0 || source >= shard_count) {
+            return;
+          }
+          std::vector<int64_t> source_indices(indices.begin(), indices.end());
+          source_indices[dim] = source;
+          source_target_pairs.emplace_back(
+              sharding.tile_assignment()(source_indices), device);
+        });
+    return lhs.state()
+        .collective_ops_creator.create_cross_partition_collective_permute(
+            b, hlo, source_target_pairs, (*lhs.state().next_channel_id)++);
+  };
+
+  // Start the halo exchanges before any of the convolutions, so that they are
+  // in flight while the interior is being computed.
+  HloInstruction* left_halo = nullptr;
+  if (left_halo_size > 0) {
+    left_halo = receive_from_neighbor(
+        slice(operand, shard_size - left_halo_size, shard_size), -1);
+  }
+  HloInstruction* right_halo = nullptr;
+  if (right_halo_size > 0) {
+    right_halo = receive_from_neighbor(slice(operand, 0, right_halo_size), 1);
+  }
+
+  Window unpadded_window = conv_window;
+  unpadded_window.mutable_dimensions(*spatial_index)->set_padding_low(0);
+  unpadded_window.mutable_dimensions(*spatial_index)->set_padding_high(0);
+  const int64_t boundary_size = wd.size() - 1;
+
+  TF_ASSIGN_OR_RETURN(
+      HloInstruction * interior,
+      create_sharded_conv(operand, rhs, b, unpadded_window));
+  std::vector<HloInstruction*> pieces;
+  if (left_halo != nullptr) {
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * left_boundary,
+        create_sharded_conv(concat(left_halo, slice(operand, 0, boundary_size)),
+                            rhs, b, unpadded_window));
+    pieces.push_back(left_boundary);
+  }
+  pieces.push_back(interior);
+  if (right_halo != nullptr) {
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * right_boundary,
+        create_sharded_conv(
+            concat(slice(operand, shard_size - boundary_size, shard_size),
+                   right_halo),
+            rhs, b, unpadded_window));
+    pieces.push_back(right_boundary);
+  }
+
+  const int64_t output_dim = dnums.output_spatial_dimensions(*spatial_index);
+  Shape output_shape = interior->shape();
+  int64_t output_size = 0;
+  for (const HloInstruction* piece : pieces) {
+    output_size += piece->shape().dimensions(output_dim);
+  }
+  output_shape.set_dimensions(output_dim, output_size);
+  TF_RET_CHECK(ShapeUtil::Compatible(
+      output_shape, MakePartitionedShape(output_base_shape, output_sharding)));
+  return b->AddInstruction(
+      HloInstruction::CreateConcatenate(output_shape, pieces, output_dim));
+}
+
 // Partition convolution when output is sharded. Will shard LHS with replicated
 // RHS.
 absl::StatusOr<HloInstruction*> PartitionConvolutionTiledOutput(
@@ -755,7 +903,8 @@ absl::StatusOr<HloInstruction*> PartitionConvolutionTiledOutput(
         HloInstruction*, HloInstruction*, SpmdBuilder*,
         const Window& conv_window)>
         create_sharded_conv,
-    const Window& conv_window, HloInstruction* original_hlo, SpmdBuilder* b) {
+    const Window& conv_window, HloInstruction* original_hlo,
+    bool overlap_halo_exchange, SpmdBuilder* b) {
   TF_RET_CHECK(original_hlo->opcode() == HloOpcode::kConvolution);
   const auto& dnums = original_hlo->convolution_dimension_numbers();
   TF_RET_CHECK(!output_sharding.IsTileMaximal());
@@ -795,6 +944,17 @@ absl::StatusOr<HloInstruction*> PartitionConvolutionTiledOutput(
   // Replicate the RHS.
   rhs = rhs.Reshard(HloSharding::Replicate());
 
+  if (overlap_halo_exchange) {
+    TF_ASSIGN_OR_RETURN(
+        auto partitioned_conv,
+        PartitionConvolutionWithOverlappedHaloExchange(
+            lhs, rhs.hlo(), output_base_shape, output_sharding,
+            create_sharded_conv, conv_window, original_hlo, b));
+    if (partitioned_conv) {
+      return partitioned_conv;
+    }
+  }
+
   // Convolution window config does not include batch and feature dimensions,
   // whereas ReshardAsWindowedInput() expects the same number of window
   // dimensions as the rank of the operand. So add two more trivial
@@ -906,7 +1066,8 @@ absl::StatusOr<HloInstruction*> PartitionConvolutionBaseCase(
     TF_ASSIGN_OR_RETURN(auto partitioned_conv,
                         PartitionConvolutionTiledOutput(
                             lhs, rhs, output_base_shape, output_sharding,
-                            create_sharded_conv, conv_window, original_hlo, b));
+                            create_sharded_conv, conv_window, original_hlo,
+                            options.overlap_conv_halo_exchange, b));
     if (partitioned_conv) {
       return partitioned_conv;
     }
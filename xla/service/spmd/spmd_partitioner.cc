@@ -562,6 +562,23 @@ PartitionedHlo PartitionedHlo::ReshardNoCache(
           return PartitionedHlo(resharded, base_shape_, state_)
               .ReshardNoCache(target);
         }
+        // Go through the common tiling of source and target, so each device
+        // gathers only part of the tensor.
+        if (auto intermediate =
+                GetCommonTilingReshardIntermediate(sharding(), target)) {
+          VLOG(5) << "Resharding through common tiling "
+                  << intermediate->ToString();
+          std::optional<PartitionedHlo> gathered =
+              ReshardToPartialReplicateWithAllGather(*intermediate);
+          if (gathered.has_value()) {
+            PartitionedHlo resharded = gathered->ReshardNoCache(
+                target, /*pad_value=*/std::nullopt,
+                /*allow_full_replication=*/false);
+            if (resharded.sharding() == target) {
+              return resharded;
+            }
+          }
+        }
       }
       if (!allow_full_replication) {
         return *this;
@@ -4687,10 +4704,23 @@ absl::StatusOr<bool> SpmdPartitioningVisitor::DoPartition(
   TF_RETURN_IF_ERROR(
       DoCodeMotionForWindowedDotGeneralLoops(new_computation, options));
 
-  // Replace the original computation with the new SPMD computation.
-  absl::flat_hash_map<HloComputation*, HloComputation*> replacement;
-  replacement[computation] = new_computation;
-  module->ReplaceComputations(replacement);
+  // Replace the original computation with the new SPMD computation. The call
+  // graph is flattened, so only its recorded call sites refer to a non-entry
+  // computation. Rewriting them directly avoids scanning the whole module for
+  // every partitioned while body, conditional branch and call.
+  if (computation->IsEntryComputation() || !call_graph_.Contains(computation)) {
+    absl::flat_hash_map<HloComputation*, HloComputation*> replacement;
+    replacement[computation] = new_computation;
+    module->ReplaceComputations(replacement);
+    return changed_;
+  }
+  for (HloInstruction* caller :
+       call_graph_.GetComputationCallers(computation)) {
+    caller->ReplaceCalledComputations([&](HloComputation* called) {
+      return called == computation ? new_computation : called;
+    });
+  }
+  TF_RETURN_IF_ERROR(module->RemoveEmbeddedComputation(computation));
   return changed_;
 }
 
@@ -5048,6 +5078,11 @@ HloInstruction* SpmdPartitioner::AllReduceAlongShardingDimsInternal(
   return result;
 }
 
+// TODO: Partition independent computations, e.g. the condition and body of a
+// while loop or the branches of a conditional, in parallel. That needs channel
+// id ranges handed out to visitors in a deterministic order, and synchronized
+// module updates (new computations and instruction names), so that the output
+// does not depend on thread timing.
 absl::StatusOr<bool> SpmdPartitioner::PartitionComputation(
     HloComputation* computation, const HloSharding& root_sharding,
     int64_t* next_channel_id, SpmdLogger* logger, const CallGraph& call_graph) {
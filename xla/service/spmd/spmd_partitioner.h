@@ -51,6 +51,11 @@ struct SpmdPartitionerOptions {
   // convolution exchanges halo on RHS.
   bool conv_halo_exchange_always_on_lhs = true;
 
+  // Partition spatially tiled convolutions by computing the interior of each
+  // output shard separately from its boundaries, so that the halo exchange
+  // can overlap with the interior computation.
+  bool overlap_conv_halo_exchange = false;
+
   // The number of instructions to be reported for the highest memory profile
   // instructions.
   int64_t report_instruction_count = 5;
@@ -398,9 +403,10 @@ class PartitionedHlo {
     };
     // Use absl::node_hash_map for pointer stability.
     absl::node_hash_map<HloInstruction*, PerHloCache> per_hlo_cache;
-    // Caches for nested partitioning of grouped sharding. Each string key
-    // represents a unique way of grouping devices.
-    absl::flat_hash_map<std::string, std::unique_ptr<ReshardCache>>
+    // Caches for nested partitioning of grouped sharding. Each key represents
+    // a unique way of grouping devices.
+    absl::flat_hash_map<std::vector<std::vector<int64_t>>,
+                        std::unique_ptr<ReshardCache>>
         groupd_caches;
   };
   struct PartitioningState {
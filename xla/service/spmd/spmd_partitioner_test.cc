@@ -67,7 +67,8 @@ class SpmdPartitioningTest
       bool choose_faster_windowed_einsum = false,
       bool unroll_windowed_einsum = false,
       bool bidirectional_windowed_einsum = false,
-      int64_t threshold_for_windowed_einsum_mib = -1) {
+      int64_t threshold_for_windowed_einsum_mib = -1,
+      bool overlap_conv_halo_exchange = false) {
     // Some tests (BackpropFilter convs) set this flag false to test two
     // different paths of the implementation.
     SpmdPartitionerOptions options;
@@ -81,6 +82,7 @@ class SpmdPartitioningTest
       options.threshold_for_windowed_einsum_mib =
           threshold_for_windowed_einsum_mib;
     }
+    options.overlap_conv_halo_exchange = overlap_conv_halo_exchange;
     auto collective_ops_creator =
         GetDefaultCollectiveOpsCreator(num_devices, /*num_replicas=*/1);
     // Do not use all-gather for pattern-matching purpose, as the partitioner
@@ -1272,6 +1274,61 @@ ENTRY entry {
                     op::Shape("f32[128,56,112,64]")));
 }
 
+TEST_P(SpmdPartitioningTest,
+       ConvolutionLhsTiledRhsReplicatedOverlappedHaloExchange) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %lhs = f32[128,224,224,3] parameter(0)
+  %lhs.copy = f32[128,224,224,3] copy(f32[128,224,224,3] %lhs),
+    sharding={devices=[1,2,1,1]0,1}
+  %rhs = f32[3,3,3,64] parameter(1)
+  %rhs.copy = f32[3,3,3,64] copy(f32[3,3,3,64] %rhs),
+    sharding={replicated}
+  ROOT %conv = f32[128,224,224,64] convolution(
+    f32[128,224,224,3] %lhs.copy,
+    f32[3,3,3,64] %rhs.copy),
+    window={size=3x3 pad=1_1x1_1},
+    dim_labels=b01f_01io->b01f,
+    sharding={devices=[1,2,1,1]0,1}
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      PartitionComputation(hlo_string, /*num_devices=*/2,
+                           /*conv_halo_exchange_always_on_lhs=*/true,
+                           /*choose_faster_windowed_einsum=*/false,
+                           /*unroll_windowed_einsum=*/false,
+                           /*bidirectional_windowed_einsum=*/false,
+                           /*threshold_for_windowed_einsum_mib=*/-1,
+                           /*overlap_conv_halo_exchange=*/true));
+  VLOG(1) << module->ToString();
+
+  const auto root = module->entry_computation()->root_instruction();
+  const auto lhs = AllOf(
+      op::Copy(op::DynamicSlice(op::Parameter(), op::Constant(), op::Reshape(),
+                                op::Constant(), op::Constant())),
+      op::Shape("f32[128,112,224,3]"));
+  const auto rhs = AllOf(op::Copy(op::Parameter()), op::Shape("f32[3,3,3,64]"));
+
+  auto left_halo = AllOf(op::CollectivePermute(op::Slice(lhs)),
+                         op::Shape("f32[128,1,224,3]"));
+  auto right_halo = AllOf(op::CollectivePermute(op::Slice(lhs)),
+                          op::Shape("f32[128,1,224,3]"));
+  auto left_boundary = AllOf(
+      op::Convolution(op::Concatenate(left_halo, op::Slice(lhs)), rhs),
+      op::Shape("f32[128,1,224,64]"));
+  auto interior = AllOf(op::Convolution(lhs, rhs),
+                        op::Shape("f32[128,110,224,64]"));
+  auto right_boundary = AllOf(
+      op::Convolution(op::Concatenate(op::Slice(lhs), right_halo), rhs),
+      op::Shape("f32[128,1,224,64]"));
+  EXPECT_THAT(root,
+              AllOf(op::Concatenate(left_boundary, interior, right_boundary),
+                    op::Shape("f32[128,112,224,64]")));
+}
+
 TEST_P(SpmdPartitioningTest, ConvolutionLhsTiledRhsReplicatedNeedReshard) {
   absl::string_view hlo_string = R"(
 HloModule module
@@ -8480,6 +8537,34 @@ ENTRY entry {
   EXPECT_THAT(root, op::Copy(op::CollectivePermute(reshape)));
 }
 
+TEST_P(SpmdPartitioningTest, ReshardThroughCommonTiling) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %param0 = f32[24,24] parameter(0),
+    sharding={devices=[4,3]<=[12]}
+  ROOT %copy = f32[24,24] copy(%param0),
+    sharding={devices=[6,2]<=[12]}
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          PartitionComputation(hlo_string, /*num_devices=*/12));
+  VLOG(1) << module->ToString();
+
+  // Devices gather the [2,1] common tiling instead of the whole tensor.
+  const auto root = module->entry_computation()->root_instruction();
+  EXPECT_THAT(root, op::Shape("f32[4,12]"));
+  bool gathers_common_tile = false;
+  for (const HloInstruction* instruction :
+       module->entry_computation()->instructions()) {
+    EXPECT_THAT(instruction, ::testing::Not(op::Shape("f32[24,24]")));
+    gathers_common_tile |=
+        ::testing::Value(instruction, op::Shape("f32[12,24]"));
+  }
+  EXPECT_TRUE(gathers_common_tile);
+}
+
 TEST_P(SpmdPartitioningTest, SubgroupAllToAllReshard3) {
   absl::string_view hlo_string = R"(
 HloModule module
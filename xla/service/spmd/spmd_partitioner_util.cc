@@ -31,7 +31,6 @@ limitations under the License.
 #include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
-#include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "xla/comparison_util.h"
 #include "xla/hlo/ir/collective_device_list.h"
@@ -1843,6 +1842,45 @@ bool CanReshardWithCollectivePermute(const HloSharding& source,
          source.tile_assignment() != target.tile_assignment();
 }
 
+std::optional<HloSharding> GetCommonTilingReshardIntermediate(
+    const HloSharding& source, const HloSharding& target) {
+  if (!source.IsTiled() || !target.IsTiled() ||
+      source.ReplicateOnLastTileDim() || target.ReplicateOnLastTileDim() ||
+      !source.subgroup_types().empty() || !target.subgroup_types().empty() ||
+      source.tile_assignment().num_dimensions() !=
+          target.tile_assignment().num_dimensions() ||
+      source.tile_assignment().num_elements() !=
+          target.tile_assignment().num_elements()) {
+    return std::nullopt;
+  }
+  const int64_t rank = source.tile_assignment().num_dimensions();
+  // Split each source dimension into the common tile count and the remainder,
+  // then move all the remainders to a trailing replication dimension.
+  std::vector<int64_t> split_dims;
+  std::vector<int64_t> common_dims;
+  std::vector<int> perm(2 * rank);
+  int64_t num_common_tiles = 1;
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    const int64_t common = std::gcd(source.tile_assignment().dim(dim),
+                                    target.tile_assignment().dim(dim));
+    split_dims.push_back(common);
+    split_dims.push_back(source.tile_assignment().dim(dim) / common);
+    common_dims.push_back(common);
+    num_common_tiles *= common;
+    perm[dim] = 2 * dim;
+    perm[rank + dim] = 2 * dim + 1;
+  }
+  const int64_t num_devices = source.tile_assignment().num_elements();
+  if (num_common_tiles == 1 || num_common_tiles == num_devices) {
+    return std::nullopt;
+  }
+  common_dims.push_back(num_devices / num_common_tiles);
+  return HloSharding::PartialTile(source.tile_assignment()
+                                      .Reshape(split_dims)
+                                      .Transpose(perm)
+                                      .Reshape(common_dims));
+}
+
 std::optional<GroupedSharding> AlignGroupsWithInternal(
     GroupedSharding grouped_sharding, const GroupedSharding& reference,
     bool requires_compatibility, bool ignore_group_order) {
@@ -1972,13 +2010,7 @@ PartitionedHlo::PartitioningState CreatePerGroupPartitioningState(
       state.collective_ops_creator, device_groups);
   result.partition_id =
       GetInGroupPartitionId(state.partition_id, device_groups, b);
-  // Create a string key for the groups.
-  std::vector<std::string> per_group_strings(device_groups.size());
-  for (int64_t i = 0; i < per_group_strings.size(); ++i) {
-    per_group_strings[i] = absl::StrJoin(device_groups[i], ",");
-  }
-  auto& grouped_cache =
-      state.reshard_cache->groupd_caches[absl::StrJoin(per_group_strings, ";")];
+  auto& grouped_cache = state.reshard_cache->groupd_caches[device_groups];
   if (!grouped_cache) {
     grouped_cache = std::make_unique<PartitionedHlo::ReshardCache>();
   }
@@ -429,6 +429,18 @@ GetReshardAllToAllSourceTargetDims(const HloSharding& source,
 bool CanReshardWithCollectivePermute(const HloSharding& source,
                                      const HloSharding& target);
 
+// Returns a partially replicated sharding to use as an intermediate step when
+// resharding between two tiled shardings that no single collective handles.
+// Each dimension is tiled by the greatest common divisor of its source and
+// target tile counts, with the devices of a replication group holding
+// neighboring source tiles. The source reaches it with an all-gather within
+// each group, and it reaches the target with a dynamic-slice followed by a
+// collective-permute, so each device receives only its intermediate tile
+// instead of the whole tensor. Returns std::nullopt if the tile counts have no
+// common divisor, i.e. the intermediate would be fully replicated.
+std::optional<HloSharding> GetCommonTilingReshardIntermediate(
+    const HloSharding& source, const HloSharding& target);
+
 // Returns a new GroupedSharding that has the same group definition of
 // `reference`.
 hlo_sharding_util::GroupedSharding AlignGroupsWith(
@@ -50,13 +50,15 @@ class StatefulRngSpmdPartitioner : public spmd::SpmdPartitioner {
       int64_t threshold_for_windowed_einsum_mib = 100000,
       bool windowed_einsum_use_multiple_streams = false,
       bool skip_checking_windowed_einsum_users = false,
-      bool disable_ag_rewrite_for_multiple_consumers = false)
+      bool disable_ag_rewrite_for_multiple_consumers = false,
+      bool bidirectional_windowed_einsum = false)
       : spmd::SpmdPartitioner(num_partitions, num_replicas,
                               GetSpmdPartitionerOptions(
                                   threshold_for_windowed_einsum_mib,
                                   windowed_einsum_use_multiple_streams,
                                   skip_checking_windowed_einsum_users,
-                                  disable_ag_rewrite_for_multiple_consumers)) {}
+                                  disable_ag_rewrite_for_multiple_consumers,
+                                  bidirectional_windowed_einsum)) {}
 
  protected:
   std::unique_ptr<spmd::SpmdPartitioningVisitor> CreateVisitor(
@@ -83,7 +85,8 @@ class StatefulRngSpmdPartitioner : public spmd::SpmdPartitioner {
       int64_t threshold_for_windowed_einsum_mib,
       bool windowed_einsum_use_multiple_streams = false,
       bool skip_checking_windowed_einsum_users = false,
-      bool disable_ag_rewrite_for_multiple_consumers = false) {
+      bool disable_ag_rewrite_for_multiple_consumers = false,
+      bool bidirectional_windowed_einsum = false) {
     spmd::SpmdPartitionerOptions options;
     options.allow_module_signature_change = true;
     options.threshold_for_windowed_einsum_mib =
@@ -93,6 +96,7 @@ class StatefulRngSpmdPartitioner : public spmd::SpmdPartitioner {
         skip_checking_windowed_einsum_users;
     options.disable_ag_rewrite_for_multiple_consumers =
         disable_ag_rewrite_for_multiple_consumers;
+    options.bidirectional_windowed_einsum = bidirectional_windowed_einsum;
     return options;
   }
 };
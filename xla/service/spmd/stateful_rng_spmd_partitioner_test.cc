@@ -193,6 +193,21 @@ TEST_F(StatefulRngSpmdPartitionerTest, VerifyThresholdSetCorrectly) {
   EXPECT_EQ(rng_spmd_partitioner.options().threshold_for_windowed_einsum_mib,
             threshold);
   EXPECT_EQ(rng_spmd_partitioner.options().unroll_windowed_einsum, true);
+  EXPECT_FALSE(rng_spmd_partitioner.options().bidirectional_windowed_einsum);
+}
+
+TEST_F(StatefulRngSpmdPartitionerTest, VerifyBidirectionalSetCorrectly) {
+  auto debug_options = HloTestBase::GetDebugOptionsForTest();
+  debug_options.set_xla_gpu_bidirectional_windowed_einsum(true);
+
+  StatefulRngSpmdPartitioner rng_spmd_partitioner(
+      /*num_partitions=*/4, /*num_replicas*/ 1,
+      debug_options.xla_gpu_threshold_for_windowed_einsum_mib(),
+      debug_options.xla_gpu_multi_streamed_windowed_einsum(),
+      /*skip_checking_windowed_einsum_users=*/false,
+      /*disable_ag_rewrite_for_multiple_consumers=*/false,
+      debug_options.xla_gpu_bidirectional_windowed_einsum());
+  EXPECT_TRUE(rng_spmd_partitioner.options().bidirectional_windowed_einsum);
 }
 
 TEST_F(StatefulRngSpmdPartitionerTest,
@@ -181,7 +181,7 @@ static bool IsNanSafeGt(HloComputation* comp) {
 
   auto match_all_types = [](HloInstruction* root, auto callback) {
     bool result = false;
-    for (auto type : {BF16, F32, S32, U32}) {
+    for (auto type : {BF16, F16, F32, S32, U32}) {
       result = result || Match(root, callback(type));
     }
     return result;
@@ -193,6 +193,9 @@ static bool IsNanSafeGt(HloComputation* comp) {
          Match(comp->root_instruction(),
                m::Gt(match_generic_iec559(0, BF16, S16),
                      match_generic_iec559(1, BF16, S16))) ||
+         Match(comp->root_instruction(),
+               m::Gt(match_generic_iec559(0, F16, S16),
+                     match_generic_iec559(1, F16, S16))) ||
          Match(comp->root_instruction(),
                m::Gt(match_generic_iec559_with_convert(0, BF16, F32, S32),
                      match_generic_iec559_with_convert(1, BF16, F32, S32))) ||
@@ -386,7 +389,8 @@ absl::StatusOr<HloInstruction*> TopkRewriter::TransformPatternToCustomCall(
   HloInstruction* data = sort->mutable_operand(0);
   const PrimitiveType element_type = data->shape().element_type();
 
-  if (element_type != F32 && element_type != BF16) {
+  if (element_type != F32 && element_type != BF16 && element_type != F16 &&
+      element_type != S32) {
     return nullptr;
   }
 
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/while_loop_unroller.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iterator>
 #include <memory>
@@ -68,6 +69,9 @@ using hlo_query::ContainsInstrWithOpcode;
 const int kUnrollTripCountThreshold = 64;
 const int kUnrollInstructionCountThreshold = 800;
 const int kUnrollExpandFactorThreshold = 10000;
+// Partial unrolling makes the unrolled loop body at least this many times more
+// expensive than the loop overhead.
+const int kMinBodyToLoopOverheadRatio = 4;
 
 // Helper function to create a condition for a single iteration while loop in
 // the form of 'i <= init_value' where i is the induction variable.
@@ -241,6 +245,117 @@ bool InitialFeasibilityCheck(HloInstruction* while_op, WhileLoopConfig config) {
   return true;
 }
 
+// Checks the soft conditions of partial unrolling by `unroll_factor`:
+// 1. num instructions in loop body.
+// 2. unroll expansion limit (#_body_instructions * unroll_factor).
+bool PartialUnrollFeasibilityCheck(HloInstruction* while_op,
+                                   int64_t unroll_factor) {
+  int64_t instruction_count = while_op->while_body()->instruction_count();
+  if (instruction_count > kUnrollInstructionCountThreshold) {
+    VLOG(5) << absl::StrCat(
+        "Cannot partially unroll while loop. Too many instructions in the "
+        "body: ",
+        instruction_count);
+    return false;
+  }
+  if (unroll_factor * instruction_count > kUnrollExpandFactorThreshold) {
+    VLOG(5) << absl::StrCat(
+        "Not attempting to partially unroll due to instruction count "
+        "increase explosion. New instruction count: ",
+        unroll_factor * instruction_count, " vs ",
+        kUnrollExpandFactorThreshold);
+    return false;
+  }
+  return true;
+}
+
+// Returns the number of instructions in `body` that do actual work, i.e.
+// excluding the ones that only forward the loop state.
+int64_t LoopBodyCost(const HloComputation* body) {
+  return absl::c_count_if(
+      body->instructions(), [](const HloInstruction* instr) {
+        return !HloPredicateIsOp<HloOpcode::kParameter,
+                                 HloOpcode::kGetTupleElement, HloOpcode::kTuple,
+                                 HloOpcode::kConstant, HloOpcode::kBitcast>(
+            instr);
+      });
+}
+
+// Clones the body of `while_op` to run a single iteration of a partially
+// unrolled loop. Unlike UnrollSingleIterationOfTrivialLoop, the induction
+// variable stays a loop variable, as the clone runs in different iterations.
+std::unique_ptr<HloComputation> CloneLoopBody(HloInstruction* while_op,
+                                              int64_t clone_index) {
+  std::unique_ptr<HloComputation> while_body_clone =
+      while_op->while_body()->Clone(absl::StrCat("unrolled", clone_index));
+
+  // Every clone needs its own channel ids for collectives (see
+  // UnrollSingleIterationOfTrivialLoop).
+  int64_t unique_channel_id = hlo_query::NextChannelId(*while_op->GetModule());
+  for (HloInstruction* body_inst : while_body_clone->instructions()) {
+    HloInstruction* collective = IsOrHasCollectiveWithChannelId(body_inst);
+    if (collective != nullptr) {
+      collective->set_channel_id(unique_channel_id++);
+    }
+  }
+  return while_body_clone;
+}
+
+// Partially unrolls `while_op`: the new loop body runs `unroll_factor`
+// iterations of the original body. The remaining trip_count % unroll_factor
+// iterations run in front of the loop, so the new loop runs a multiple of
+// `unroll_factor` iterations and can reuse the original loop condition.
+absl::StatusOr<bool> UnrollInternalPartial(HloInstruction* while_op,
+                                           WhileLoopConfig config,
+                                           int64_t unroll_factor) {
+  VLOG(3) << "Partially unrolling while instruction "
+          << while_op->ToShortString() << " with unroll factor "
+          << unroll_factor << " and body instruction count "
+          << while_op->while_body()->instruction_count();
+
+  HloModule* module = while_op->GetModule();
+  HloComputation* computation = while_op->parent();
+  int64_t num_peeled_iterations = config.trip_count % unroll_factor;
+
+  HloInstruction* loop_state = while_op->mutable_operand(0);
+  for (int64_t i = 0; i < num_peeled_iterations; ++i) {
+    HloComputation* peeled_body =
+        module->AddEmbeddedComputation(CloneLoopBody(while_op, i));
+    loop_state = computation->AddInstruction(HloInstruction::CreateCall(
+        while_op->shape(), {loop_state}, peeled_body));
+  }
+
+  auto body_builder =
+      HloComputation::Builder(absl::StrCat("unrolled-body-", while_op->name()));
+  absl::StatusOr<HloInstruction*> p = body_builder.AddParameter(
+      while_op->while_body()->parameter_instruction(0)->Clone());
+  HloInstruction* body_state = p.value();
+  for (int64_t i = 0; i < unroll_factor; ++i) {
+    HloComputation* unrolled_body = module->AddEmbeddedComputation(
+        CloneLoopBody(while_op, num_peeled_iterations + i));
+    body_state = body_builder.AddInstruction(HloInstruction::CreateCall(
+        while_op->shape(), {body_state}, unrolled_body));
+  }
+  HloComputation* new_body =
+      module->AddEmbeddedComputation(body_builder.Build(body_state));
+
+  HloInstruction* new_while_op =
+      computation->AddInstruction(HloInstruction::CreateWhile(
+          while_op->shape(), while_op->while_condition(), new_body,
+          loop_state));
+  WhileLoopBackendConfig backend_config;
+  backend_config.mutable_known_trip_count()->set_n(config.trip_count /
+                                                   unroll_factor);
+  TF_RETURN_IF_ERROR(new_while_op->set_backend_config(backend_config));
+
+  TF_RETURN_IF_ERROR(computation->ReplaceInstruction(while_op, new_while_op));
+
+  // Needed for the nested while loops in which the outer loop has been
+  // unrolled which leaves the call graph non-flat.
+  TF_RETURN_IF_ERROR(FlattenCallGraph().Run(module).status());
+  return true;
+}
+
 absl::StatusOr<bool> UnrollInternal(HloInstruction* while_op,
                                     WhileLoopConfig config) {
   VLOG(3) << "Unrolling while instruction " << while_op->ToShortString()
@@ -323,6 +438,31 @@ absl::StatusOr<bool> UnrollInternalWrapped(HloInstruction* while_op,
   return true;
 }
 
+// Unrolls `while_op` by `unroll_factor`, where -1 means full unrolling. Loops
+// whose trip count doesn't exceed the unroll factor are unrolled fully.
+absl::StatusOr<bool> UnrollLoop(HloInstruction* while_op,
+                                WhileLoopConfig config, int64_t unroll_factor,
+                                bool wrap_in_trivial_loop, bool force_unroll) {
+  if (unroll_factor != -1 && unroll_factor < config.trip_count) {
+    if (unroll_factor <= 1) {
+      return false;
+    }
+    if (!force_unroll &&
+        !PartialUnrollFeasibilityCheck(while_op, unroll_factor)) {
+      return false;
+    }
+    return UnrollInternalPartial(while_op, config, unroll_factor);
+  }
+
+  if (!force_unroll && !InitialFeasibilityCheck(while_op, config)) {
+    return false;
+  }
+  if (wrap_in_trivial_loop) {
+    return UnrollInternalWrapped(while_op, config);
+  }
+  return UnrollInternal(while_op, config);
+}
+
 };  // namespace
 
 // Recursively checks if the given instruction points to the induction var of
@@ -500,6 +640,22 @@ std::optional<int64_t> MatchShapeCoveringDynamicIndexInstruction(
   return config;
 }
 
+/*static*/ int64_t WhileLoopUnroller::ChooseUnrollFactor(
+    const HloInstruction* while_op, const WhileLoopConfig& config,
+    int64_t loop_overhead_cost) {
+  int64_t body_cost =
+      std::max<int64_t>(LoopBodyCost(while_op->while_body()), 1);
+  int64_t unroll_factor =
+      CeilOfRatio<int64_t>(kMinBodyToLoopOverheadRatio * loop_overhead_cost,
+                           body_cost);
+  // Don't let the module grow more than full unrolling would be allowed to.
+  unroll_factor = std::min<int64_t>(
+      unroll_factor, kUnrollExpandFactorThreshold /
+                         std::max<int64_t>(
+                             while_op->while_body()->instruction_count(), 1));
+  return std::min(unroll_factor, config.trip_count);
+}
+
 /*static*/ absl::StatusOr<bool> WhileLoopUnroller::PrepareModuleForUnrolling(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -564,14 +720,6 @@ WhileLoopUnroller::GetUnrollableLoops(
     bool force_unroll) {
   bool changed = false;
   HloModule* module = while_op->GetModule();
-  // TODO(b/288130138): For now, we only support full unrolling. Will add
-  // partial unrolling if needed.
-  if (unroll_factor != -1) {
-    VLOG(5) << absl::StrCat(
-        "Currently, only full unrolling is supported, unroll factor: ",
-        unroll_factor);
-    return false;
-  }
 
   // Make sure all the necessary passes are executed before unrolling in order
   // to unroll every possible loop.
@@ -586,17 +734,13 @@ WhileLoopUnroller::GetUnrollableLoops(
     return false;
   }
 
-  if (!force_unroll && !InitialFeasibilityCheck(while_op, config.value())) {
-    return false;
-  }
-
-  bool unrolled = false;
-  if (wrap_in_trivial_loop) {
-    TF_ASSIGN_OR_RETURN(unrolled,
-                        UnrollInternalWrapped(while_op, config.value()));
-  } else {
-    TF_ASSIGN_OR_RETURN(unrolled, UnrollInternal(while_op, config.value()));
+  if (unroll_factor == kAutoUnrollFactor) {
+    unroll_factor =
+        ChooseUnrollFactor(while_op, *config, kDefaultLoopOverheadCost);
   }
+  TF_ASSIGN_OR_RETURN(bool unrolled,
+                      UnrollLoop(while_op, *config, unroll_factor,
+                                 wrap_in_trivial_loop, force_unroll));
 
   // We need to inline the calls created for unrolling since later passes rely
   // on the calls to be inlined.
@@ -609,11 +753,6 @@ WhileLoopUnroller::GetUnrollableLoops(
 absl::StatusOr<bool> WhileLoopUnroller::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
-  // TODO(b/288130138) For now, we only support full unrolling. Will add partial
-  // unrolling if needed.
-  if (unroll_factor_ != -1) {
-    return false;
-  }
   XLA_VLOG_LINES(3, "WhileLoopUnroller::Run(), before:\n" + module->ToString());
   bool changed = false;
 
@@ -634,14 +773,35 @@ absl::StatusOr<bool> WhileLoopUnroller::Run(
   // unroll. We do this ahead of time so we don't have to worry about mutating
   // the lists of computations or instructions while we iterate.
   std::vector<std::pair<HloInstruction*, WhileLoopConfig>>
-      unrollable_while_ops = GetUnrollableLoops(module, execution_threads);
+      unrollable_while_ops;
+  if (unroll_factor_ == -1) {
+    unrollable_while_ops = GetUnrollableLoops(module, execution_threads);
+  } else {
+    // Whether partial unrolling is feasible depends on the unroll factor of
+    // each loop, so it's checked when unrolling.
+    for (HloInstruction* while_op : all_while_ops) {
+      std::optional<WhileLoopConfig> config = IsLoopUnrollable(while_op);
+      if (config.has_value()) {
+        unrollable_while_ops.emplace_back(while_op, *config);
+      }
+    }
+  }
 
   VLOG(3) << "Number of while instructions in the module to unroll: "
           << unrollable_while_ops.size();
 
   bool unrolled = false;
   for (auto& [while_op, config] : unrollable_while_ops) {
-    if (wrap_in_trivial_loop_) {
+    if (unroll_factor_ != -1) {
+      int64_t unroll_factor =
+          unroll_factor_ == kAutoUnrollFactor
+              ? ChooseUnrollFactor(while_op, config, loop_overhead_cost_)
+              : unroll_factor_;
+      TF_ASSIGN_OR_RETURN(unrolled,
+                          UnrollLoop(while_op, config, unroll_factor,
+                                     wrap_in_trivial_loop_,
+                                     /*force_unroll=*/false));
+    } else if (wrap_in_trivial_loop_) {
       TF_ASSIGN_OR_RETURN(unrolled, UnrollInternalWrapped(while_op, config));
     } else {
       TF_ASSIGN_OR_RETURN(unrolled, UnrollInternal(while_op, config));
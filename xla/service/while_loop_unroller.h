@@ -58,7 +58,13 @@ std::optional<int64_t> MatchShapeCoveringDynamicIndexInstruction(
 // This pass unrolls while loops with the given unrolling factor. The value of
 // unroll_factor = -1 will fully unroll the loop.
 //
-// TODO(b/288130138): Currently, we `only` support full unrolling.
+// With unroll_factor > 1 the loop is partially unrolled: the new loop body runs
+// unroll_factor iterations of the original body, and the iterations that
+// remain (trip_count % unroll_factor) are peeled off in front of the loop.
+// With unroll_factor = kAutoUnrollFactor the factor is chosen for every loop
+// from the cost of its body and the per-iteration loop overhead of the target
+// backend, so that loops with small bodies run fewer iterations while the
+// module grows by a bounded number of instructions.
 //
 // The trip count for loops is calculated based on
 // `MatchTrivialLoopTripCount` function in
@@ -69,11 +75,24 @@ class WhileLoopUnroller : public HloModulePass {
  public:
   ~WhileLoopUnroller() override = default;
 
-  // Default unroll_factor of -1 indicates full unrolling
-  explicit WhileLoopUnroller(int64_t unroll_factor = -1,
-                             bool wrap_in_trivial_loop = false)
+  // Value of unroll_factor that chooses a partial unroll factor per loop.
+  static constexpr int64_t kAutoUnrollFactor = 0;
+
+  // Default cost of the control flow of a single loop iteration, in units of
+  // body instructions.
+  static constexpr int64_t kDefaultLoopOverheadCost = 10;
+
+  // Default unroll_factor of -1 indicates full unrolling. loop_overhead_cost is
+  // the cost of the control flow of a single loop iteration on the target
+  // backend (e.g. evaluating the condition and synchronizing with the host on
+  // GPU), in units of body instructions. It's only used with
+  // kAutoUnrollFactor.
+  explicit WhileLoopUnroller(
+      int64_t unroll_factor = -1, bool wrap_in_trivial_loop = false,
+      int64_t loop_overhead_cost = kDefaultLoopOverheadCost)
       : unroll_factor_(unroll_factor),
-        wrap_in_trivial_loop_(wrap_in_trivial_loop) {}
+        wrap_in_trivial_loop_(wrap_in_trivial_loop),
+        loop_overhead_cost_(loop_overhead_cost) {}
 
   absl::string_view name() const override { return "while_loop_unroller"; }
 
@@ -101,7 +120,7 @@ class WhileLoopUnroller : public HloModulePass {
       const absl::flat_hash_set<absl::string_view>& execution_threads);
 
   // Unrolls the given while loop with the default behaviour set to full unroll.
-  // If wrap_in_trivial_loop is set, the unrolled body of the loop will be
+  // If wrap_in_trivial_loop is set, the fully unrolled body of the loop will be
   // wrapped in a loop with trip count of one. Forcing unroll will not perform
   // soft checking of the conditions.
   static absl::StatusOr<bool> Unroll(HloInstruction* while_op,
@@ -109,10 +128,18 @@ class WhileLoopUnroller : public HloModulePass {
                                      bool wrap_in_trivial_loop = false,
                                      bool force_unroll = false);
 
+  // Returns the partial unroll factor for a loop with the given config, chosen
+  // such that the loop overhead is small compared to the cost of the unrolled
+  // body. Returns a value of at most 1 if the loop is not worth unrolling.
+  static int64_t ChooseUnrollFactor(const HloInstruction* while_op,
+                                    const WhileLoopConfig& config,
+                                    int64_t loop_overhead_cost);
+
  private:
   int64_t unroll_factor_;
   // Whether to wrap the unrolled computation in a loop with trip count of one.
   bool wrap_in_trivial_loop_;
+  int64_t loop_overhead_cost_;
 };
 
 }  // namespace xla
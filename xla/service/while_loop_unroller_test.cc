@@ -33,6 +33,7 @@ limitations under the License.
 #include "xla/tests/hlo_test_base.h"
 #include "xla/tests/literal_test_util.h"
 #include "xla/tests/verified_hlo_module.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla {
@@ -720,8 +721,51 @@ TEST_F(WhileLoopUnrollerTest, LoopWithControlDep) {
 }
 
 TEST_F(WhileLoopUnrollerTest, SimpleLoopPartialUnroll) {
-  auto m = MakeModuleWithSimpleLoop(/*num_iters=*/5);
-  EXPECT_FALSE(WhileLoopUnroller(/*unroll_factor=*/3).Run(m.get()).value());
+  UnrollAndCompare(MakeModuleWithSimpleLoop(/*num_iters=*/5), {},
+                   /*unroll_factor=*/3);
+  UnrollAndCompare(MakeModuleWithSimpleLoop(/*num_iters=*/6), {},
+                   /*unroll_factor=*/3);
+
+  auto m = MakeModuleWithSimpleLoop(/*num_iters=*/10);
+  EXPECT_TRUE(WhileLoopUnroller(/*unroll_factor=*/3).Run(m.get()).value());
+  HloInstruction* while_op = FindInstruction(m.get(), HloOpcode::kWhile);
+  ASSERT_NE(while_op, nullptr);
+  TF_ASSERT_OK_AND_ASSIGN(auto backend_config,
+                          while_op->backend_config<WhileLoopBackendConfig>());
+  EXPECT_EQ(backend_config.known_trip_count().n(), 3);
+  auto is_add = [](const HloInstruction* instruction) {
+    return instruction->opcode() == HloOpcode::kAdd;
+  };
+  // One peeled iteration in front of the loop, and three iterations in the
+  // loop body, each incrementing the induction variable and adding.
+  EXPECT_EQ(absl::c_count_if(m->entry_computation()->instructions(), is_add),
+            2);
+  EXPECT_EQ(absl::c_count_if(while_op->while_body()->instructions(), is_add),
+            6);
+}
+
+TEST_F(WhileLoopUnrollerTest, SimpleLoopAutoPartialUnroll) {
+  // The trip count is too large for full unrolling.
+  UnrollAndCompare(MakeModuleWithSimpleLoop(/*num_iters=*/100), {},
+                   WhileLoopUnroller::kAutoUnrollFactor);
+
+  auto m = MakeModuleWithSimpleLoop(/*num_iters=*/100);
+  HloInstruction* while_op = FindInstruction(m.get(), HloOpcode::kWhile);
+  std::optional<WhileLoopConfig> config =
+      WhileLoopUnroller::IsLoopUnrollable(while_op);
+  ASSERT_TRUE(config.has_value());
+  // The body does two additions, so 20 iterations make the unrolled body 4
+  // times as expensive as the loop overhead of 10.
+  EXPECT_EQ(WhileLoopUnroller::ChooseUnrollFactor(
+                while_op, *config, /*loop_overhead_cost=*/10),
+            20);
+  // Loops that have no overhead aren't worth unrolling.
+  EXPECT_TRUE(WhileLoopUnroller(WhileLoopUnroller::kAutoUnrollFactor,
+                                /*wrap_in_trivial_loop=*/false,
+                                /*loop_overhead_cost=*/0)
+                  .Run(m.get())
+                  .ok());
+  EXPECT_EQ(m->entry_computation()->root_instruction(), while_op);
 }
 
 TEST_F(WhileLoopUnrollerTest, IndirectBodyInc) {
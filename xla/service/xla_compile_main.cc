@@ -20,6 +20,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "xla/tools/xla_compile_lib.h"
 #include "xla/tsl/util/command_line_flags.h"
@@ -49,6 +50,15 @@ const char kUsageHeader[] =
     ") by passing --symbol_repository to a linked-in symbol repository "
     "implementation and setting --symbol_reference to a reference of a symbol "
     "understood by that repository."
+    "\n"
+    "To track compile time regressions, --corpus may be set to a "
+    "comma-separated list of module files or glob patterns. Each module is "
+    "compiled (--output_file is ignored) and the compile time, per-pass "
+    "profile and peak memory of all of them are written as a "
+    "CorpusCompilationResult to --result_output_file, which can be passed as "
+    "--baseline_result_file to a later run to log a comparison. Combine with "
+    "--platform=gpu and one of the xla/tools/hlo_opt/gpu_specs as "
+    "--gpu_target_config to compile for GPU without a device."
     "\n";
 
 }  // end namespace xla_compile
@@ -58,6 +68,8 @@ const char kUsageHeader[] =
 // AotCompilationResult or Executable to the output file.
 int main(int argc, char* argv[]) {
   xla::XlaCompileOptions options;
+  std::string corpus;
+  float regression_threshold = options.corpus_options.regression_threshold;
   std::vector<tsl::Flag> flag_list = {
       tsl::Flag("module_file", &options.module_path,
                 "The path to the HLO, MHLO or StableHLO file"),
@@ -95,6 +107,19 @@ int main(int argc, char* argv[]) {
                 "complete. See export_hlo.h for more on uploads."),
       tsl::Flag("result_output_file", &options.result_output_file,
                 "File to write a serialized xla.CompilationResult proto to."),
+      tsl::Flag("corpus", &corpus,
+                "Comma-separated list of module files or glob patterns to "
+                "compile instead of --module_file."),
+      tsl::Flag("corpus_threads", &options.corpus_options.num_threads,
+                "Number of corpus modules compiled concurrently. Peak memory "
+                "is only attributed to individual modules when this is 1."),
+      tsl::Flag("baseline_result_file",
+                &options.corpus_options.baseline_result_file,
+                "A CorpusCompilationResult from a previous --corpus run to "
+                "compare against."),
+      tsl::Flag("regression_threshold", &regression_threshold,
+                "Relative compile time increase over --baseline_result_file "
+                "above which modules and passes are reported."),
   };
 
   tsl::string usage = xla::xla_compile::kUsageHeader;
@@ -109,6 +134,18 @@ int main(int argc, char* argv[]) {
 
   tsl::port::InitMain(usage.c_str(), &argc, &argv);
 
+  if (!corpus.empty()) {
+    options.corpus_options.module_paths =
+        absl::StrSplit(corpus, ',', absl::SkipEmpty());
+    options.corpus_options.regression_threshold = regression_threshold;
+    auto corpus_result = xla::XlaCompileCorpusMain(options);
+    if (!corpus_result.ok()) {
+      LOG(ERROR) << "Corpus compilation failed: " << corpus_result.status();
+      return 1;
+    }
+    return 0;
+  }
+
   absl::Status result = xla::XlaCompileMain(options);
   if (!result.ok()) {
     LOG(ERROR) << "Compilation failed: " << result;
@@ -1917,6 +1917,11 @@ struct ParallelState {
   absl::BlockingCounter counter;
 };
 
+// Number of tasks per thread used by the parallel ForEachIndex* routines. A
+// few tasks per thread balance the load if some chunks are more expensive
+// to visit than others.
+constexpr int64_t kTasksPerThread = 4;
+
 }  // anonymous namespace
 
 /* static */ absl::Status ShapeUtil::ForEachIndexInternalParallel(
@@ -1924,34 +1929,155 @@ struct ParallelState {
     absl::Span<const int64_t> count, absl::Span<const int64_t> incr,
     const ForEachParallelVisitorFunction& visitor_function) {
   ForEachState s(shape, base, count, incr);
-  ParallelState pstate(s.CalculateNumSteps());
   if (s.IsZeroElementArray()) {
-    return pstate.status;
+    return absl::OkStatus();
   }
-  // Allows handling R0 arrays, such that the visitor function will be called
-  // once with the proper empty indexes.
-  int64_t n = -1;
-  while (n < s.rank) {
-    auto indexes_copy = s.indexes;
-    pstate.pool->Schedule([indexes_copy, &visitor_function, &pstate] {
+
+  // Splits the iteration space into contiguous chunks of steps in minor to
+  // major order, and visits every chunk in a single task. This works for R0
+  // arrays as well, which have a single step with empty indexes.
+  const int64_t num_steps = s.CalculateNumSteps();
+  const int64_t num_tasks = std::min<int64_t>(
+      num_steps, GetForEachIndexParallelThreadCount() * kTasksPerThread);
+
+  ParallelState pstate(num_tasks);
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    const int64_t begin = num_steps * task / num_tasks;
+    const int64_t end = num_steps * (task + 1) / num_tasks;
+    pstate.pool->Schedule([&, begin, end] {
       const int thread_id = pstate.pool->CurrentThreadId();
-      absl::StatusOr<bool> result = visitor_function(indexes_copy, thread_id);
-      if (!result.ok()) {
-        absl::MutexLock lock(&pstate.mu);
-        if (pstate.status.ok()) {
-          pstate.status = result.status();
+      ForEachState chunk(shape, base, count, incr);
+      chunk.SetIndexesForStep(begin);
+      for (int64_t step = begin; step < end; ++step) {
+        absl::StatusOr<bool> result =
+            visitor_function(chunk.indexes_span, thread_id);
+        if (!result.ok()) {
+          absl::MutexLock lock(&pstate.mu);
+          if (pstate.status.ok()) {
+            pstate.status = result.status();
+          }
+          break;
         }
+        // Increments dimensions in minor to major order.
+        chunk.IncrementDim();
       }
       pstate.TaskComplete();
     });
-    // Increments dimensions in minor to major order.
-    n = s.IncrementDim();
   }
 
   pstate.Wait();
   return pstate.status;
 }
 
+namespace {
+
+// Visits runs [begin, end) of at most `run_size` consecutive elements along
+// the most minor dimension of `shape`, where every row of the most minor
+// dimension is split into CeilOfRatio(minor_size, run_size) runs.
+void VisitIndexRuns(
+    const Shape& shape, int64_t run_size, int64_t begin, int64_t end,
+    absl::FunctionRef<void(absl::Span<const int64_t>, int64_t, int64_t)>
+        visitor_function) {
+  absl::Span<const int64_t> minor_to_major = shape.layout().minor_to_major();
+  const int64_t minor_dimension = minor_to_major.front();
+  const int64_t minor_size = shape.dimensions(minor_dimension);
+  const int64_t runs_per_row = CeilOfRatio(minor_size, run_size);
+
+  // Index of the first element of the `begin`-th run.
+  DimensionVector indexes(shape.rank(), 0);
+  int64_t row = begin / runs_per_row;
+  indexes[minor_dimension] = (begin % runs_per_row) * run_size;
+  int64_t linear_index = row * minor_size + indexes[minor_dimension];
+  for (int64_t dim : minor_to_major.subspan(1)) {
+    indexes[dim] = row % shape.dimensions(dim);
+    row /= shape.dimensions(dim);
+  }
+
+  for (int64_t run = begin; run < end; ++run) {
+    const int64_t size =
+        std::min(run_size, minor_size - indexes[minor_dimension]);
+    visitor_function(indexes, linear_index, size);
+
+    // Runs are visited in the physical order of the layout, so the next run
+    // starts right after the current one.
+    linear_index += size;
+    indexes[minor_dimension] += size;
+    if (indexes[minor_dimension] < minor_size) continue;
+
+    // Increments major dimensions in minor to major order.
+    indexes[minor_dimension] = 0;
+    for (int64_t dim : minor_to_major.subspan(1)) {
+      if (++indexes[dim] < shape.dimensions(dim)) break;
+      indexes[dim] = 0;
+    }
+  }
+}
+
+}  // namespace
+
+/* static */ void ShapeUtil::ForEachIndexRun(
+    const Shape& shape, const ForEachRunVisitorFunction& visitor_function) {
+  CHECK(LayoutUtil::IsDenseArray(shape)) << HumanString(shape);
+  if (IsZeroElementArray(shape)) {
+    return;
+  }
+  if (shape.rank() == 0) {
+    visitor_function({}, /*linear_index=*/0, /*run_size=*/1);
+    return;
+  }
+
+  const int64_t minor_size =
+      shape.dimensions(LayoutUtil::Minor(shape.layout(), 0));
+  VisitIndexRuns(shape, /*run_size=*/minor_size, /*begin=*/0,
+                 /*end=*/ElementsIn(shape) / minor_size, visitor_function);
+}
+
+/* static */ void ShapeUtil::ForEachIndexRunParallel(
+    const Shape& shape,
+    const ForEachRunParallelVisitorFunction& visitor_function) {
+  CHECK(LayoutUtil::IsDenseArray(shape)) << HumanString(shape);
+  if (IsZeroElementArray(shape)) {
+    return;
+  }
+  if (shape.rank() == 0) {
+    visitor_function({}, /*linear_index=*/0, /*run_size=*/1,
+                     /*thread_id=*/-1);
+    return;
+  }
+
+  const int64_t thread_count = GetForEachIndexParallelThreadCount();
+  const int64_t minor_size =
+      shape.dimensions(LayoutUtil::Minor(shape.layout(), 0));
+  const int64_t num_rows = ElementsIn(shape) / minor_size;
+
+  // Split rows of the most minor dimension only if there are not enough rows
+  // to keep all threads busy.
+  int64_t run_size = minor_size;
+  if (num_rows < thread_count) {
+    run_size = CeilOfRatio(minor_size, CeilOfRatio(thread_count, num_rows));
+  }
+  const int64_t num_runs = num_rows * CeilOfRatio(minor_size, run_size);
+  const int64_t num_tasks =
+      std::min<int64_t>(num_runs, thread_count * kTasksPerThread);
+
+  ParallelState pstate(num_tasks);
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    const int64_t begin = num_runs * task / num_tasks;
+    const int64_t end = num_runs * (task + 1) / num_tasks;
+    pstate.pool->Schedule([&, begin, end] {
+      const int thread_id = pstate.pool->CurrentThreadId();
+      VisitIndexRuns(shape, run_size, begin, end,
+                     [&](absl::Span<const int64_t> indexes,
+                         int64_t linear_index, int64_t size) {
+                       visitor_function(indexes, linear_index, size,
+                                        thread_id);
+                     });
+      pstate.TaskComplete();
+    });
+  }
+  pstate.Wait();
+}
+
 /* static */ int ShapeUtil::GetForEachIndexParallelThreadCount() {
   ParallelState pstate(/*task_count=*/0);
   return pstate.pool->NumThreads();
@@ -2232,4 +2358,15 @@ int64_t ShapeUtil::ForEachState::CalculateNumSteps() const {
   }
   return size;
 }
+
+void ShapeUtil::ForEachState::SetIndexesForStep(int64_t step) {
+  for (int64_t n = 0; n < rank; ++n) {
+    int64_t dim = minor_to_major[n];
+    // Dimensions with zero count are fixed at their base index.
+    int64_t num_dim_steps =
+        count[dim] == 0 ? 1 : 1 + (count[dim] - 1) / incr[dim];
+    indexes_ptr[dim] = base[dim] + (step % num_dim_steps) * incr[dim];
+    step /= num_dim_steps;
+  }
+}
 }  // namespace xla
@@ -976,6 +976,34 @@ class ShapeUtil {
       const Shape& shape,
       const ForEachParallelVisitorFunction& visitor_function);
 
+  using ForEachRunVisitorFunction = absl::FunctionRef<void(
+      absl::Span<const int64_t> indexes, int64_t linear_index,
+      int64_t run_size)>;
+
+  using ForEachRunParallelVisitorFunction = absl::FunctionRef<void(
+      absl::Span<const int64_t> indexes, int64_t linear_index,
+      int64_t run_size, int thread_id)>;
+
+  // Iterates over all elements of the dense array `shape` in the physical order
+  // of its layout, one run of consecutive elements along the most minor
+  // dimension at a time. The visitor function is called with the index of the
+  // first element of the run, the linear index of that element in the layout
+  // of `shape` and the number of elements in the run. Elements of a run are
+  // contiguous in memory, so visitors can process them with a tight loop
+  // instead of paying for a callback and a linear index computation per
+  // element (linear indices are advanced incrementally).
+  static void ForEachIndexRun(
+      const Shape& shape, const ForEachRunVisitorFunction& visitor_function);
+
+  // A parallel version of ForEachIndexRun. Runs are split into contiguous
+  // chunks along the major dimensions, and every chunk is visited by a single
+  // task in the threadpool of ForEachIndexParallel*. If there are not enough
+  // major dimension indices to keep all threads busy, the most minor dimension
+  // is split into multiple runs as well.
+  static void ForEachIndexRunParallel(
+      const Shape& shape,
+      const ForEachRunParallelVisitorFunction& visitor_function);
+
   // In this case, we care about transposes that swap two dimensions of a
   // a shape that can be viewed as three logical components 0-1-2 in the order
   // of major to minor.
@@ -1102,6 +1130,9 @@ class ShapeUtil {
     // Returns the number of visited elements assuming that the iteration will
     // not be interrupted.
     int64_t CalculateNumSteps() const;
+
+    // Sets `indexes` to the index visited at the given step of the iteration.
+    void SetIndexesForStep(int64_t step);
   };
 
   static absl::Status ForEachIndexInternal(
@@ -27,6 +27,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "xla/index_util.h"
 #include "xla/layout.h"
 #include "xla/layout_util.h"
 #include "xla/shape.h"
@@ -768,6 +769,73 @@ TEST(ShapeUtilTest, ForEachIndexParallel_WithSkips) {
   }
 }
 
+TEST(ShapeUtilTest, ForEachIndexRun) {
+  Shape shape = ShapeUtil::MakeShapeWithDenseLayout(F32, {3, 5, 2}, {0, 2, 1});
+  std::vector<int> visited(ShapeUtil::ElementsIn(shape), 0);
+  int64_t expected_linear_index = 0;
+  ShapeUtil::ForEachIndexRun(
+      shape, [&](absl::Span<const int64_t> indexes, int64_t linear_index,
+                 int64_t run_size) {
+        EXPECT_EQ(linear_index, expected_linear_index);
+        EXPECT_EQ(run_size, 3);
+        std::vector<int64_t> index(indexes.begin(), indexes.end());
+        for (int64_t i = 0; i < run_size; ++i, ++index[0]) {
+          EXPECT_EQ(
+              IndexUtil::MultidimensionalIndexToLinearIndex(shape, index),
+              linear_index + i);
+          ++visited[linear_index + i];
+        }
+        expected_linear_index += run_size;
+      });
+  EXPECT_THAT(visited, ::testing::Each(1));
+}
+
+TEST(ShapeUtilTest, ForEachIndexRun_Rank0) {
+  Shape shape = ShapeUtil::MakeShape(F32, {});
+  int num_runs = 0;
+  ShapeUtil::ForEachIndexRun(shape, [&](absl::Span<const int64_t> indexes,
+                                        int64_t linear_index,
+                                        int64_t run_size) {
+    EXPECT_TRUE(indexes.empty());
+    EXPECT_EQ(linear_index, 0);
+    EXPECT_EQ(run_size, 1);
+    ++num_runs;
+  });
+  EXPECT_EQ(num_runs, 1);
+}
+
+TEST(ShapeUtilTest, ForEachIndexRun_Empty) {
+  Shape shape = ShapeUtil::MakeShape(F32, {2, 0});
+  bool called = false;
+  ShapeUtil::ForEachIndexRun(shape, [&](absl::Span<const int64_t>, int64_t,
+                                        int64_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(ShapeUtilTest, ForEachIndexRunParallel) {
+  // Rank-1 shapes and shapes with few rows split the most minor dimension.
+  for (const Shape& shape :
+       {ShapeUtil::MakeShape(F32, {10007}), ShapeUtil::MakeShape(F32, {2, 997}),
+        ShapeUtil::MakeShape(F32, {1000, 7, 3}),
+        ShapeUtil::MakeShapeWithDenseLayout(F32, {5, 131, 2}, {1, 0, 2})}) {
+    // Runs never overlap, so every element is written by a single thread.
+    std::vector<int> visited(ShapeUtil::ElementsIn(shape), 0);
+    const int64_t minor_dimension = LayoutUtil::Minor(shape.layout(), 0);
+    ShapeUtil::ForEachIndexRunParallel(
+        shape, [&](absl::Span<const int64_t> indexes, int64_t linear_index,
+                   int64_t run_size, int /*thread_id*/) {
+          std::vector<int64_t> index(indexes.begin(), indexes.end());
+          for (int64_t i = 0; i < run_size; ++i, ++index[minor_dimension]) {
+            EXPECT_EQ(
+                IndexUtil::MultidimensionalIndexToLinearIndex(shape, index),
+                linear_index + i);
+            ++visited[linear_index + i];
+          }
+        });
+    EXPECT_THAT(visited, ::testing::Each(1)) << shape;
+  }
+}
+
 TEST(ShapeUtilTest, ForEachIndexParallel_CalledTwice) {
   Shape shape = ShapeUtil::MakeShape(F32, {10, 10});
   int64_t output[10][10];
@@ -1658,5 +1726,19 @@ void BM_ForEachIndexNoStatus(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_ForEachIndexNoStatus)->Arg(0)->Arg(1)->Arg(2);
 
+void BM_ForEachIndexRun(::testing::benchmark::State& state) {
+  Shape shape = ShapeForBenchmark(state);
+  for (auto s : state) {
+    int64_t count = 0;
+    ShapeUtil::ForEachIndexRun(
+        shape, [&count](absl::Span<const int64_t> indexes,
+                        int64_t linear_index, int64_t run_size) {
+          count += run_size;
+        });
+    tsl::testing::DoNotOptimize(count);
+  }
+}
+BENCHMARK(BM_ForEachIndexRun)->Arg(0)->Arg(1)->Arg(2);
+
 }  // namespace
 }  // namespace xla
@@ -345,6 +345,17 @@ class CommandBuffer {
   // Returns command buffer state.
   virtual State state() const = 0;
 
+  // Returns the number of commands recorded into the execution scope. Barriers
+  // are not counted as commands.
+  virtual int64_t num_commands(ExecutionScopeId execution_scope_id) const = 0;
+
+  // Skips the next `num_commands` commands of the execution scope while the
+  // command buffer is being updated, leaving them with the parameters they were
+  // last recorded with. Callers are responsible for skipping only commands that
+  // would be updated with the same parameters.
+  virtual absl::Status SkipCommands(ExecutionScopeId execution_scope_id,
+                                    int64_t num_commands) = 0;
+
   //--------------------------------------------------------------------------//
   // Command buffer tracing API
   //--------------------------------------------------------------------------//
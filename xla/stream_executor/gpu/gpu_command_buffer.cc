@@ -1059,6 +1059,34 @@ absl::Status GpuCommandBuffer::Update() {
   return absl::OkStatus();
 }
 
+int64_t GpuCommandBuffer::num_commands(
+    ExecutionScopeId execution_scope_id) const {
+  return nodes(execution_scope_id).size();
+}
+
+absl::Status GpuCommandBuffer::SkipCommands(ExecutionScopeId execution_scope_id,
+                                            int64_t num_commands) {
+  if (state_ != State::kUpdate) {
+    return absl::InternalError(
+        "Command buffer has to be in update state to skip commands");
+  }
+
+  ExecutionScope& execution_scope = execution_scopes_[execution_scope_id];
+  int64_t node_idx = execution_scope.update_state.node_idx + num_commands;
+  if (num_commands < 0 || node_idx > execution_scope.nodes.size()) {
+    return absl::InternalError(absl::StrCat(
+        "Can't skip ", num_commands, " commands in execution scope #",
+        execution_scope_id.value(), " with ", execution_scope.nodes.size(),
+        " recorded nodes and next node index ",
+        execution_scope.update_state.node_idx));
+  }
+
+  VLOG(5) << "Skip update of " << num_commands
+          << " commands in execution scope #" << execution_scope_id.value();
+  execution_scope.update_state.node_idx = node_idx;
+  return absl::OkStatus();
+}
+
 absl::Span<const GpuCommandBuffer::GpuGraphNodeInfo> GpuCommandBuffer::nodes(
     ExecutionScopeId id) const {
   if (auto it = execution_scopes_.find(id); it != execution_scopes_.end())
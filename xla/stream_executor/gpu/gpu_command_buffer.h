@@ -130,6 +130,10 @@ class GpuCommandBuffer : public CommandBuffer {
   Mode mode() const override { return mode_; }
   State state() const override { return state_; }
 
+  int64_t num_commands(ExecutionScopeId execution_scope_id) const override;
+  absl::Status SkipCommands(ExecutionScopeId execution_scope_id,
+                            int64_t num_commands) override;
+
   static GpuCommandBuffer* Cast(CommandBuffer* command_buffer) {
     return static_cast<GpuCommandBuffer*>(command_buffer);
   }
@@ -31,6 +31,7 @@ limitations under the License.
 #include "xla/stream_executor/cuda/cuda_activation.h"
 #endif  // GOOGLE_CUDA
 
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "xla/stream_executor/gpu/gpu_init.h"  // IWYU pragma: keep
@@ -43,6 +44,15 @@ limitations under the License.
 
 namespace stream_executor {
 
+// Requests of up to this many bytes are rounded up to a power of two size
+// class, so that freed blocks can be reused by the small block cache.
+static constexpr size_t kMaxSmallBlockSize = 64 << 10;
+static constexpr size_t kMinSmallBlockSize = 256;
+
+static size_t SmallBlockSizeClass(size_t num_bytes) {
+  return std::max(kMinSmallBlockSize, absl::bit_ceil(num_bytes));
+}
+
 #if GOOGLE_CUDA
 static std::string GetCudaErrorMessage(CUresult result) {
   const char* error;
@@ -73,6 +83,12 @@ void GpuCudaMallocAsyncAllocator::PrintAllocatorStatisticsNoLock() {
   VLOG(8) << "\nThe sorted list of (ptr,size):";
   VLOG(8) << absl::StrJoin(ptr_size_string, ",");
 
+  if (small_block_cache_bytes_ > 0) {
+    LOG(ERROR) << "Small block cache: " << cached_small_block_bytes_
+               << " bytes cached, " << small_block_cache_hits_ << " hits, "
+               << small_block_cache_misses_ << " misses";
+  }
+
 #if CUDA_VERSION >= 11030
   cuuint64_t mem_reserved_current;
   if (auto result = cuMemPoolGetAttribute(
@@ -236,6 +252,16 @@ GpuCudaMallocAsyncAllocator::GpuCudaMallocAsyncAllocator(
     }
   }
 
+  int64_t small_block_cache_bytes = 0;
+  TF_CHECK_OK(tsl::ReadInt64FromEnvVar(
+      "TF_CUDA_MALLOC_ASYNC_SMALL_BLOCK_CACHE_BYTES", 0,
+      &small_block_cache_bytes));
+  // In sync mode every allocation must wait for the stream, which the cache
+  // would bypass.
+  if (small_block_cache_bytes > 0 && !sync_mode_) {
+    small_block_cache_bytes_ = small_block_cache_bytes;
+  }
+
   // Set read/write access to all GPUs.
   static auto* all_pools_ = new std::vector<CUmemoryPool*>();
   static auto* all_ids_ = new std::vector<tsl::PlatformDeviceId>();
@@ -310,6 +336,13 @@ GpuCudaMallocAsyncAllocator::GpuCudaMallocAsyncAllocator(
 
 GpuCudaMallocAsyncAllocator::~GpuCudaMallocAsyncAllocator() {
 #if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  {
+    tsl::mutex_lock lock(lock_);
+    if (!free_small_blocks_.empty()) {
+      cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+      ReleaseCachedSmallBlocks();
+    }
+  }
   if (create_new_pool_) {
     VLOG(2) << "Delete memory pool " << reinterpret_cast<void*>(pool_);
     if (auto status = cuMemPoolDestroy(pool_))
@@ -329,42 +362,68 @@ void* GpuCudaMallocAsyncAllocator::AllocateRaw(size_t alignment,
         << "The instantiation of GpuCudaMallocAsyncAllocator failed."
         << " See previous errors.";
   }
-  // The lock is only needed when stats are enabled, but it must be around
-  // the cuMemAllocFromPoolAsync call as well to ensure consistency of the stats
-  // update.
+  const bool use_small_block_cache = small_block_cache_bytes_ > 0 &&
+                                     num_bytes > 0 &&
+                                     num_bytes <= kMaxSmallBlockSize;
+  const size_t block_size =
+      use_small_block_cache ? SmallBlockSizeClass(num_bytes) : num_bytes;
+
+  // The lock is only needed when stats or the small block cache are enabled,
+  // but it must be around the cuMemAllocFromPoolAsync call as well to ensure
+  // consistency of the stats update.
   std::unique_lock<tsl::mutex> lock(lock_, std::defer_lock);
-  if (stats_) {
+  if (stats_ || small_block_cache_bytes_ > 0) {
     lock.lock();
   }
-  cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
   void* ptr = nullptr;
-  auto result = cuMemAllocFromPoolAsync(reinterpret_cast<CUdeviceptr*>(&ptr),
-                                        num_bytes, pool_, cuda_stream_);
-  if (result == CUDA_ERROR_OUT_OF_MEMORY) {
-    // Doing a stream synchronization give the driver more flexibility
-    // for blocks coalescing and doing memory remapping. So it can
-    // solve some OOM cases when memory is tight.
-    cuStreamSynchronize(cuda_stream_);
-    result = cuMemAllocFromPoolAsync(reinterpret_cast<CUdeviceptr*>(&ptr),
-                                     num_bytes, pool_, cuda_stream_);
-  }
-  if (result) {
-    size_t free, total;
-    cuMemGetInfo(&free, &total);
-    LOG(ERROR) << Name() << " cuMemAllocAsync failed to allocate " << num_bytes
-               << " bytes: " << GetCudaErrorMessage(result)
-               << "\n Reported by CUDA: Free memory/Total memory: " << free
-               << "/" << total;
-    if (stats_) {
-      LOG(ERROR) << "Stats: " << stats_->DebugString();
-      PrintAllocatorStatisticsNoLock();
+  if (use_small_block_cache) {
+    auto it = free_small_blocks_.find(block_size);
+    if (it != free_small_blocks_.end() && !it->second.empty()) {
+      ptr = it->second.back();
+      it->second.pop_back();
+      cached_small_block_bytes_ -= block_size;
+      ++small_block_cache_hits_;
+    } else {
+      ++small_block_cache_misses_;
+    }
+  }
+
+  if (ptr == nullptr) {
+    cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+    auto result = cuMemAllocFromPoolAsync(
+        reinterpret_cast<CUdeviceptr*>(&ptr), block_size, pool_, cuda_stream_);
+    if (result == CUDA_ERROR_OUT_OF_MEMORY) {
+      // Doing a stream synchronization give the driver more flexibility
+      // for blocks coalescing and doing memory remapping. So it can
+      // solve some OOM cases when memory is tight. Blocks held by the small
+      // block cache are returned to the pool first.
+      ReleaseCachedSmallBlocks();
+      cuStreamSynchronize(cuda_stream_);
+      result = cuMemAllocFromPoolAsync(reinterpret_cast<CUdeviceptr*>(&ptr),
+                                       block_size, pool_, cuda_stream_);
+    }
+    if (result) {
+      size_t free, total;
+      cuMemGetInfo(&free, &total);
+      LOG(ERROR) << Name() << " cuMemAllocAsync failed to allocate "
+                 << num_bytes << " bytes: " << GetCudaErrorMessage(result)
+                 << "\n Reported by CUDA: Free memory/Total memory: " << free
+                 << "/" << total;
+      if (stats_) {
+        LOG(ERROR) << "Stats: " << stats_->DebugString();
+        PrintAllocatorStatisticsNoLock();
+      }
+
+      return nullptr;
     }
 
-    return nullptr;
+    if (sync_mode_) {
+      cuStreamSynchronize(cuda_stream_);
+    }
   }
 
-  if (sync_mode_) {
-    cuStreamSynchronize(cuda_stream_);
+  if (use_small_block_cache) {
+    small_block_sizes_[ptr] = block_size;
   }
 
   // Update stats.
@@ -391,34 +450,51 @@ void* GpuCudaMallocAsyncAllocator::AllocateRaw(size_t alignment,
 void GpuCudaMallocAsyncAllocator::DeallocateRaw(void* ptr) {
 #if TF_CUDA_MALLOC_ASYNC_SUPPORTED
   if (ptr == nullptr) return;
-  // The lock is only needed when stats are enabled, but it must be around
-  // the cuMemFreeAsync call as well to ensure consistency of the stats update.
+  // The lock is only needed when stats or the small block cache are enabled,
+  // but it must be around the cuMemFreeAsync call as well to ensure
+  // consistency of the stats update.
   std::unique_lock<tsl::mutex> lock(lock_, std::defer_lock);
-  if (stats_) {
+  if (stats_ || small_block_cache_bytes_ > 0) {
     lock.lock();
   }
-  if (auto result = cuMemFreeAsync(reinterpret_cast<const CUdeviceptr&>(ptr),
-                                   cuda_stream_)) {
-    if (result == CUDA_ERROR_DEINITIALIZED) {
-      // It happens with multi-GPU that TF free the GPU allocation after
-      // the driver is unloaded. It is safe to ignore this error here.
-      // TODO: Find how to fix the shutdown steps in TF.
-      VLOG(1) << "Ignoring CUDA error: " << GetCudaErrorMessage(result);
-    } else {
-      size_t free, total;
-      cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
-      cuMemGetInfo(&free, &total);
-      LOG(ERROR) << "cudaFreeAsync failed to free " << ptr << ": "
-                 << GetCudaErrorMessage(result)
-                 << "\n Free memory/Total memory: " << free << "/" << total;
-      if (stats_) {
-        LOG(ERROR) << "Stats: " << stats_->DebugString();
+  bool cached = false;
+  if (small_block_cache_bytes_ > 0) {
+    auto it = small_block_sizes_.find(ptr);
+    if (it != small_block_sizes_.end()) {
+      const size_t block_size = it->second;
+      small_block_sizes_.erase(it);
+      if (cached_small_block_bytes_ + block_size <= small_block_cache_bytes_) {
+        free_small_blocks_[block_size].push_back(ptr);
+        cached_small_block_bytes_ += block_size;
+        cached = true;
       }
     }
   }
 
-  if (sync_mode_) {
-    cuStreamSynchronize(cuda_stream_);
+  if (!cached) {
+    if (auto result = cuMemFreeAsync(reinterpret_cast<const CUdeviceptr&>(ptr),
+                                     cuda_stream_)) {
+      if (result == CUDA_ERROR_DEINITIALIZED) {
+        // It happens with multi-GPU that TF free the GPU allocation after
+        // the driver is unloaded. It is safe to ignore this error here.
+        // TODO: Find how to fix the shutdown steps in TF.
+        VLOG(1) << "Ignoring CUDA error: " << GetCudaErrorMessage(result);
+      } else {
+        size_t free, total;
+        cuda::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+        cuMemGetInfo(&free, &total);
+        LOG(ERROR) << "cudaFreeAsync failed to free " << ptr << ": "
+                   << GetCudaErrorMessage(result)
+                   << "\n Free memory/Total memory: " << free << "/" << total;
+        if (stats_) {
+          LOG(ERROR) << "Stats: " << stats_->DebugString();
+        }
+      }
+    }
+
+    if (sync_mode_) {
+      cuStreamSynchronize(cuda_stream_);
+    }
   }
 
   // Updates the stats.
@@ -433,6 +509,22 @@ void GpuCudaMallocAsyncAllocator::DeallocateRaw(void* ptr) {
 #endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
 }
 
+void GpuCudaMallocAsyncAllocator::ReleaseCachedSmallBlocks() {
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  for (auto& [block_size, blocks] : free_small_blocks_) {
+    for (void* ptr : blocks) {
+      if (auto result = cuMemFreeAsync(reinterpret_cast<CUdeviceptr>(ptr),
+                                       cuda_stream_)) {
+        VLOG(1) << "Failed to release cached block " << ptr << ": "
+                << GetCudaErrorMessage(result);
+      }
+    }
+  }
+  free_small_blocks_.clear();
+  cached_small_block_bytes_ = 0;
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+}
+
 bool GpuCudaMallocAsyncAllocator::TracksAllocationSizes() const {
   return static_cast<bool>(stats_);
 }
@@ -18,9 +18,11 @@ limitations under the License.
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -64,6 +66,11 @@ namespace stream_executor {
 // Here, the release_threshold isn't the absolute max as for [Gpu]BFCAllocator.
 // The pool can grow above that up to the total GPU memory.  But the
 // driver can return the excess memory to other processes.
+//
+// Workloads with many tiny temporary allocations can set
+// `TF_CUDA_MALLOC_ASYNC_SMALL_BLOCK_CACHE_BYTES=nb_bytes` to keep up to that
+// many bytes of freed small blocks in power-of-two size classes and reuse them
+// without calling into the driver.
 class GpuCudaMallocAsyncAllocator : public tsl::Allocator {
  public:
   // API that uses the default memory pool for cuda malloc async
@@ -109,6 +116,9 @@ class GpuCudaMallocAsyncAllocator : public tsl::Allocator {
  private:
   void PrintAllocatorStatisticsNoLock() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Returns all blocks of the small block cache to the pool.
+  void ReleaseCachedSmallBlocks() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
 #if TF_CUDA_MALLOC_ASYNC_SUPPORTED
   StreamExecutor* stream_exec_;  // Not owned.
 
@@ -147,6 +157,21 @@ class GpuCudaMallocAsyncAllocator : public tsl::Allocator {
   mutable tsl::mutex lock_;
   std::unique_ptr<tsl::AllocatorStats> stats_ ABSL_PT_GUARDED_BY(lock_);
   absl::flat_hash_map<const void*, size_t> size_map_ ABSL_GUARDED_BY(lock_);
+
+  // Small block cache. All blocks are allocated and freed on `cuda_stream_`,
+  // so a cached block can be handed out again without any synchronization:
+  // its previous uses are ordered before all new uses on the same stream.
+  // Disabled if zero.
+  size_t small_block_cache_bytes_ = 0;
+  size_t cached_small_block_bytes_ ABSL_GUARDED_BY(lock_) = 0;
+  // Size class of every live block allocated through the cache.
+  absl::flat_hash_map<const void*, size_t> small_block_sizes_
+      ABSL_GUARDED_BY(lock_);
+  // Free blocks, by size class.
+  absl::flat_hash_map<size_t, std::vector<void*>> free_small_blocks_
+      ABSL_GUARDED_BY(lock_);
+  int64_t small_block_cache_hits_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t small_block_cache_misses_ ABSL_GUARDED_BY(lock_) = 0;
 };
 
 }  // namespace stream_executor
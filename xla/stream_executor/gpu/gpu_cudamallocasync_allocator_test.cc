@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/stream_executor/gpu/gpu_cudamallocasync_allocator.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <string>
 
@@ -125,4 +126,40 @@ TEST(GpuCudaMallocAsyncAllocator, SyncAddressAlignedNewPool) {
   EXPECT_TRUE(stream->ok());
 }
 
+TEST(GpuCudaMallocAsyncAllocator, SmallBlockCacheReusesFreedBlocks) {
+#if CUDA_VERSION < 11030
+  GTEST_SKIP() << "Cuda async memory allocator is not supported for CUDA "
+                  "version less than 11030";
+#endif
+  se::StreamExecutor* executor = GpuExecutor();
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, executor->CreateStream());
+  setenv("TF_CUDA_MALLOC_ASYNC_SMALL_BLOCK_CACHE_BYTES", "1048576",
+         /*overwrite=*/1);
+  auto allocator = GpuCudaMallocAsyncAllocator(
+      /*platform_device_id*/ tsl::PlatformDeviceId(executor->device_ordinal()),
+      /*create_new_pool*/ true,
+      /*new_pool_size*/ 2048,
+      /*reserve_memory*/ true,
+      /*release_threshold*/ 0,
+      /*sync_mode*/ false,
+      /*compute_stats*/ true);
+  unsetenv("TF_CUDA_MALLOC_ASYNC_SMALL_BLOCK_CACHE_BYTES");
+  allocator.SetStreamAndPreallocateMemory(
+      se::gpu::AsGpuStreamValue(stream.get()));
+
+  void* addr1 = allocator.AllocateRaw(128, 1000);
+  allocator.DeallocateRaw(addr1);
+  // 1000 and 700 bytes round up to the same size class, so the freed block
+  // is handed out again.
+  void* addr2 = allocator.AllocateRaw(128, 700);
+  EXPECT_EQ(addr1, addr2);
+  CHECK_EQ((reinterpret_cast<uintptr_t>(addr2) & 127), 0);
+  // A different size class needs a new block.
+  void* addr3 = allocator.AllocateRaw(128, 4096);
+  EXPECT_NE(addr2, addr3);
+  allocator.DeallocateRaw(addr2);
+  allocator.DeallocateRaw(addr3);
+  EXPECT_TRUE(stream->ok());
+}
+
 }  // namespace stream_executor
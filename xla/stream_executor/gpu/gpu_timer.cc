@@ -170,9 +170,9 @@ GpuTimer::~GpuTimer() {
   }
 }
 
-absl::StatusOr<absl::Duration> GpuTimer::GetElapsedDuration() {
+absl::Status GpuTimer::Stop() {
   if (is_stopped_) {
-    return absl::InternalError("Measuring inactive timer");
+    return absl::InternalError("Stopping inactive timer");
   }
   TF_RETURN_IF_ERROR(GpuDriver::RecordEvent(parent_->gpu_context(), stop_event_,
                                             stream_->gpu_stream()));
@@ -188,13 +188,24 @@ absl::StatusOr<absl::Duration> GpuTimer::GetElapsedDuration() {
       *semaphore_ = GpuSemaphoreState::kRelease;
     }
   }
+  is_stopped_ = true;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<absl::Duration> GpuTimer::GetElapsedDuration() {
+  if (is_measured_) {
+    return absl::InternalError("Measuring inactive timer");
+  }
+  if (!is_stopped_) {
+    TF_RETURN_IF_ERROR(Stop());
+  }
   float elapsed_milliseconds = NAN;
   if (!GpuDriver::GetEventElapsedTime(parent_->gpu_context(),
                                       &elapsed_milliseconds, start_event_,
                                       stop_event_)) {
     return absl::InternalError("Error stopping the timer");
   }
-  is_stopped_ = true;
+  is_measured_ = true;
   if (return_random_durations) {
     return RandomDuration();
   }
@@ -73,7 +73,9 @@ class GpuTimer {
         start_event_(std::exchange(other.start_event_, nullptr)),
         stop_event_(std::exchange(other.stop_event_, nullptr)),
         stream_(other.stream_),
-        semaphore_(std::move(other.semaphore_)) {}
+        semaphore_(std::move(other.semaphore_)),
+        is_stopped_(other.is_stopped_),
+        is_measured_(other.is_measured_) {}
 
   GpuTimer& operator=(GpuTimer&& other) {
     if (this != &other) {
@@ -82,14 +84,20 @@ class GpuTimer {
       stop_event_ = std::exchange(other.stop_event_, nullptr);
       stream_ = other.stream_;
       semaphore_ = std::move(other.semaphore_);
+      is_stopped_ = other.is_stopped_;
+      is_measured_ = other.is_measured_;
     }
     return *this;
   }
 
   ~GpuTimer();
 
-  // Stops the timer on the first call and returns the elapsed duration.
-  // Subsequent calls error out.
+  // Queues the end event without waiting for it, so that the elapsed duration
+  // of several timers can be read after all of their work has been launched.
+  absl::Status Stop();
+
+  // Stops the timer if it was not stopped yet, waits for the end event and
+  // returns the elapsed duration. Subsequent calls error out.
   absl::StatusOr<absl::Duration> GetElapsedDuration();
 
  private:
@@ -99,6 +107,7 @@ class GpuTimer {
   GpuStream* stream_;
   GpuSemaphore semaphore_;
   bool is_stopped_ = false;
+  bool is_measured_ = false;
 
   GpuTimer(const GpuTimer&) = delete;
   void operator=(const GpuTimer&) = delete;
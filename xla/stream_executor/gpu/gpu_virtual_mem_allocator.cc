@@ -0,0 +1,203 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/stream_executor/gpu/gpu_virtual_mem_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "xla/stream_executor/gpu/gpu_driver.h"
+#include "xla/stream_executor/gpu/gpu_executor.h"
+#include "xla/stream_executor/gpu/gpu_types.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/tsl/framework/allocator.h"
+#include "xla/tsl/framework/device_id.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace stream_executor {
+namespace {
+
+using gpu::GpuDevicePtr;
+using gpu::GpuDriver;
+
+// Rounds value up to the specified power of two alignment.
+size_t AlignUp(size_t value, size_t alignment) {
+  DCHECK_EQ(alignment & (alignment - 1), 0)
+      << "Alignment must be a power of two; alignment=" << alignment;
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<GpuVirtualMemAllocator>>
+GpuVirtualMemAllocator::Create(
+    const std::vector<Visitor>& alloc_visitors,
+    const std::vector<Visitor>& free_visitors, StreamExecutor* executor,
+    tsl::PlatformDeviceId gpu_id, size_t virtual_address_space_size,
+    const std::vector<tsl::PlatformDeviceId>& peer_gpu_ids) {
+  gpu::GpuExecutor* gpu_executor = gpu::ExtractGpuExecutor(executor);
+  gpu::GpuContext* gpu_context = gpu_executor->gpu_context();
+
+  std::vector<gpu::GpuDeviceHandle> access_gpu_handles;
+  access_gpu_handles.reserve(peer_gpu_ids.size() + 1);
+  access_gpu_handles.push_back(gpu_executor->device());
+  for (tsl::PlatformDeviceId peer_gpu_id : peer_gpu_ids) {
+    if (peer_gpu_id == gpu_id) continue;
+    gpu::GpuDeviceHandle peer_gpu;
+    TF_RETURN_IF_ERROR(GpuDriver::GetDevice(peer_gpu_id.value(), &peer_gpu));
+    access_gpu_handles.push_back(peer_gpu);
+  }
+
+  // Find the min granularity for all devices that have access to this memory;
+  // that is, the maximum min granularity among all devices.
+  size_t max_granularity = 1;
+  for (gpu::GpuDeviceHandle device_handle : access_gpu_handles) {
+    TF_ASSIGN_OR_RETURN(size_t granularity,
+                        GpuDriver::GetMinAllocationGranularity(device_handle));
+    max_granularity = std::max(max_granularity, granularity);
+  }
+
+  // Create the virtual memory reservation. Must be aligned to system page size,
+  // and larger than the CUDA min granularity. Empirically, the granularity
+  // check is sufficient as the granularity is some multiple of the page size.
+  TF_ASSIGN_OR_RETURN(
+      GpuDriver::VmemSpan vmem,
+      GpuDriver::ReserveVirtualMemory(
+          gpu_context, AlignUp(virtual_address_space_size, max_granularity)));
+  VLOG(1) << "Reserved GPU virtual memory at " << vmem.base << " of size "
+          << vmem.size_bytes << " bytes for GPU " << gpu_id.value();
+
+  return absl::WrapUnique(new GpuVirtualMemAllocator(
+      alloc_visitors, free_visitors, gpu_context, gpu_id,
+      std::move(access_gpu_handles), vmem, max_granularity));
+}
+
+GpuVirtualMemAllocator::GpuVirtualMemAllocator(
+    const std::vector<Visitor>& alloc_visitors,
+    const std::vector<Visitor>& free_visitors, gpu::GpuContext* gpu_context,
+    tsl::PlatformDeviceId gpu_id,
+    std::vector<gpu::GpuDeviceHandle> access_device_handles,
+    GpuDriver::VmemSpan vmem, size_t granularity)
+    : SubAllocator(alloc_visitors, free_visitors),
+      gpu_context_(gpu_context),
+      gpu_id_(gpu_id),
+      access_gpu_handles_(std::move(access_device_handles)),
+      vmem_(vmem),
+      granularity_(granularity) {}
+
+GpuVirtualMemAllocator::~GpuVirtualMemAllocator() {
+  for (const Mapping& mapping : mappings_) {
+    GpuDriver::UnmapMemory(gpu_context_, mapping.va, mapping.physical.bytes);
+    GpuDriver::ReleaseMemoryHandle(gpu_context_, mapping.physical);
+  }
+  GpuDriver::FreeVirtualMemory(gpu_context_, vmem_);
+}
+
+void* GpuVirtualMemAllocator::Alloc(size_t alignment, size_t num_bytes,
+                                    size_t* bytes_received) {
+  if (num_bytes == 0) return nullptr;
+  size_t padded_bytes = AlignUp(num_bytes, granularity_);
+
+  GpuDevicePtr next_va = vmem_.base + next_alloc_offset_;
+
+  if (next_va + padded_bytes > vmem_.base + vmem_.size_bytes) {
+    LOG(ERROR) << "OOM in GPU virtual memory allocator when attempting to "
+                  "allocate {request: "
+               << num_bytes << ", padded: " << padded_bytes
+               << "} bytes. Virtual memory already mapped: "
+               << next_alloc_offset_ << " of " << vmem_.size_bytes
+               << " bytes.";
+    return nullptr;
+  }
+
+  // Create physical memory backing allocation.
+  auto maybe_handle =
+      GpuDriver::CreateMemoryHandle(gpu_context_, padded_bytes);
+  if (!maybe_handle.ok()) {
+    LOG(ERROR) << maybe_handle.status();
+    return nullptr;
+  }
+  GpuDriver::GenericMemoryHandle handle = std::move(maybe_handle).value();
+
+  // Map VAs for this physical memory.
+  auto status =
+      GpuDriver::MapMemory(gpu_context_, next_va, handle, access_gpu_handles_);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    GpuDriver::ReleaseMemoryHandle(gpu_context_, std::move(handle));
+    return nullptr;
+  }
+  next_alloc_offset_ += handle.bytes;
+  mappings_.push_back({next_va, std::move(handle)});
+  VisitAlloc(reinterpret_cast<void*>(next_va), gpu_id_.value(), padded_bytes);
+  *bytes_received = padded_bytes;
+  return reinterpret_cast<void*>(next_va);
+}
+
+void GpuVirtualMemAllocator::Free(void* ptr, size_t num_bytes) {
+  if (ptr == nullptr) return;
+
+  auto mapping_it =
+      std::lower_bound(mappings_.begin(), mappings_.end(),
+                       reinterpret_cast<GpuDevicePtr>(ptr),
+                       [](const Mapping& mapping, GpuDevicePtr va) {
+                         return mapping.va < va;
+                       });
+  if (mapping_it == mappings_.end() ||
+      (reinterpret_cast<GpuDevicePtr>(ptr) != mapping_it->va)) {
+    LOG(ERROR) << "Could not find GPU vmem mapping for address at "
+               << reinterpret_cast<uintptr_t>(ptr);
+    return;
+  }
+
+  int num_mappings_to_free = 0;
+  size_t total_bytes = 0;
+  for (auto it = mapping_it; it != mappings_.end() && total_bytes < num_bytes;
+       ++it) {
+    ++num_mappings_to_free;
+    total_bytes += it->physical.bytes;
+  }
+  if (total_bytes != num_bytes) {
+    LOG(ERROR) << "Invalid size requested for freeing GPU vmem mapping. Got "
+               << num_bytes << " but expected " << total_bytes;
+    return;
+  }
+
+  VLOG(1) << "Freeing " << num_mappings_to_free << " mappings for a total of "
+          << total_bytes << " bytes";
+  for (auto it = mapping_it; it < mapping_it + num_mappings_to_free; ++it) {
+    GpuDriver::UnmapMemory(gpu_context_, it->va, it->physical.bytes);
+    GpuDriver::ReleaseMemoryHandle(gpu_context_, std::move(it->physical));
+  }
+
+  // Move back the next_alloc_offset_ if this free was at the end, so the
+  // virtual addresses can be mapped again. Holes freed in the middle of the
+  // span keep their addresses reserved.
+  if (mapping_it + num_mappings_to_free == mappings_.end()) {
+    next_alloc_offset_ = mapping_it->va - vmem_.base;
+  }
+
+  mappings_.erase(mapping_it, mapping_it + num_mappings_to_free);
+  VisitFree(ptr, gpu_id_.value(), num_bytes);
+}
+
+}  // namespace stream_executor
@@ -0,0 +1,113 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_STREAM_EXECUTOR_GPU_GPU_VIRTUAL_MEM_ALLOCATOR_H_
+#define XLA_STREAM_EXECUTOR_GPU_GPU_VIRTUAL_MEM_ALLOCATOR_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "xla/stream_executor/gpu/gpu_driver.h"
+#include "xla/stream_executor/gpu/gpu_types.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/tsl/framework/allocator.h"
+#include "xla/tsl/framework/device_id.h"
+
+namespace stream_executor {
+
+// A GPU memory sub-allocator that reserves a single contiguous range of
+// virtual addresses up front and backs it with physical memory on demand
+// (cuMemAddressReserve, cuMemCreate and cuMemMap).
+//
+// Every chunk handed to the BFC allocator is mapped directly after the
+// previous one, so the arena grows without gaps and the BFC allocator can
+// coalesce adjacent regions (SupportsCoalescing() is true). With a growing
+// arena built on plain device allocations, free chunks at region boundaries
+// can never be merged, which is a common source of fragmentation OOMs in
+// long-running processes.
+//
+// The BFC allocator calls Alloc and Free under its own lock, so this class is
+// not thread-safe by itself.
+class GpuVirtualMemAllocator : public tsl::SubAllocator {
+ public:
+  // Reserves `virtual_address_space_size` bytes of virtual addresses on the
+  // device of `executor`. Mapped memory is accessible from that device and
+  // from the devices in `peer_gpu_ids`.
+  static absl::StatusOr<std::unique_ptr<GpuVirtualMemAllocator>> Create(
+      const std::vector<Visitor>& alloc_visitors,
+      const std::vector<Visitor>& free_visitors, StreamExecutor* executor,
+      tsl::PlatformDeviceId gpu_id, size_t virtual_address_space_size,
+      const std::vector<tsl::PlatformDeviceId>& peer_gpu_ids);
+  ~GpuVirtualMemAllocator() override;
+
+  // Allocates memory at least as large as requested by num_bytes. Will be
+  // aligned to the min allocation granularity (typically 2MiB).
+  // alignment is ignored by this allocator.
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override;
+
+  // Frees should only happen at the granularity of what was allocated, and
+  // may free multiple allocations at once if they were coalesced.
+  void Free(void* ptr, size_t num_bytes) override;
+
+  bool SupportsCoalescing() const override { return true; }
+
+  tsl::AllocatorMemoryType GetMemoryType() const override {
+    return tsl::AllocatorMemoryType::kDevice;
+  }
+
+ private:
+  GpuVirtualMemAllocator(
+      const std::vector<Visitor>& alloc_visitors,
+      const std::vector<Visitor>& free_visitors, gpu::GpuContext* gpu_context,
+      tsl::PlatformDeviceId gpu_id,
+      std::vector<gpu::GpuDeviceHandle> access_device_handles,
+      gpu::GpuDriver::VmemSpan vmem, size_t granularity);
+
+  gpu::GpuContext* gpu_context_;
+  tsl::PlatformDeviceId gpu_id_;
+
+  // Peer access is configured at mmap time so the allocator must be aware of
+  // all gpus that may want to read the memory. This list also includes the
+  // above gpu_id_ to facilitate the invocation of the GpuDriver::MapMemory
+  // function.
+  const std::vector<gpu::GpuDeviceHandle> access_gpu_handles_;
+
+  // The virtual memory span held by this allocator.
+  gpu::GpuDriver::VmemSpan vmem_;
+  // The next offset from the vmem base address that will be allocated. This
+  // corresponds to the size of physically backed memory if no holes have been
+  // freed in the middle of the span.
+  size_t next_alloc_offset_ = 0;
+
+  // Smallest allocation as determined by CUDA.
+  const size_t granularity_;
+
+  struct Mapping {
+    gpu::GpuDevicePtr va;
+    gpu::GpuDriver::GenericMemoryHandle physical;
+  };
+  // List of mappings, sorted by va.
+  std::vector<Mapping> mappings_;
+
+  GpuVirtualMemAllocator(const GpuVirtualMemAllocator&) = delete;
+  void operator=(const GpuVirtualMemAllocator&) = delete;
+};
+
+}  // namespace stream_executor
+
+#endif  // XLA_STREAM_EXECUTOR_GPU_GPU_VIRTUAL_MEM_ALLOCATOR_H_
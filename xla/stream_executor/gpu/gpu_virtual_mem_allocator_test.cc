@@ -0,0 +1,94 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/stream_executor/gpu/gpu_virtual_mem_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/strings/ascii.h"
+#include "xla/service/platform_util.h"
+#include "xla/stream_executor/platform.h"
+#include "xla/stream_executor/platform_manager.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/tsl/framework/device_id.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace stream_executor {
+namespace {
+
+// Leave room for two allocations of the typical 2MiB granularity.
+constexpr size_t kVirtualAddressSpaceSize = 4 << 20;
+
+StreamExecutor* GpuExecutor() {
+  auto name = absl::AsciiStrToUpper(
+      xla::PlatformUtil::CanonicalPlatformName("gpu").value());
+  auto* platform = PlatformManager::PlatformWithName(name).value();
+  return platform->ExecutorForDevice(0).value();
+}
+
+std::unique_ptr<GpuVirtualMemAllocator> CreateAllocator() {
+  StreamExecutor* executor = GpuExecutor();
+  return GpuVirtualMemAllocator::Create(
+             /*alloc_visitors=*/{}, /*free_visitors=*/{}, executor,
+             tsl::PlatformDeviceId(executor->device_ordinal()),
+             kVirtualAddressSpaceSize, /*peer_gpu_ids=*/{})
+      .value();
+}
+
+TEST(GpuVirtualMemAllocatorTest, AllocationsAreContiguous) {
+  std::unique_ptr<GpuVirtualMemAllocator> allocator = CreateAllocator();
+
+  size_t bytes_received_1;
+  void* ptr_1 = allocator->Alloc(/*alignment=*/1, 1, &bytes_received_1);
+  ASSERT_NE(ptr_1, nullptr);
+  size_t bytes_received_2;
+  void* ptr_2 = allocator->Alloc(/*alignment=*/1, 1, &bytes_received_2);
+  ASSERT_NE(ptr_2, nullptr);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr_1) + bytes_received_1,
+            reinterpret_cast<uintptr_t>(ptr_2));
+  EXPECT_TRUE(allocator->SupportsCoalescing());
+
+  // Coalesced regions are freed at once.
+  allocator->Free(ptr_1, bytes_received_1 + bytes_received_2);
+}
+
+TEST(GpuVirtualMemAllocatorTest, FreeAtEndAllowsReuse) {
+  std::unique_ptr<GpuVirtualMemAllocator> allocator = CreateAllocator();
+
+  size_t bytes_received;
+  void* ptr = allocator->Alloc(/*alignment=*/1, 1, &bytes_received);
+  ASSERT_NE(ptr, nullptr);
+  allocator->Free(ptr, bytes_received);
+
+  void* reused = allocator->Alloc(/*alignment=*/1, 1, &bytes_received);
+  EXPECT_EQ(reused, ptr);
+  allocator->Free(reused, bytes_received);
+}
+
+TEST(GpuVirtualMemAllocatorTest, FailsWhenAddressSpaceIsExhausted) {
+  std::unique_ptr<GpuVirtualMemAllocator> allocator = CreateAllocator();
+
+  size_t bytes_received;
+  EXPECT_EQ(allocator->Alloc(/*alignment=*/1, 2 * kVirtualAddressSpaceSize,
+                             &bytes_received),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace stream_executor
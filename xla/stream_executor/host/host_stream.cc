@@ -17,23 +17,28 @@ limitations under the License.
 // the HostExecutor implementation.
 #include "xla/stream_executor/host/host_stream.h"
 
+#include <atomic>
 #include <cfenv>  // NOLINT
+#include <cstddef>
 #include <memory>
-#include <queue>
 #include <utility>
+#include <vector>
 
 #include "absl/functional/any_invocable.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "xla/stream_executor/event.h"
 #include "xla/stream_executor/host/host_event.h"
 #include "xla/stream_executor/stream.h"
 #include "xla/stream_executor/stream_common.h"
+#include "tsl/platform/cpu_info.h"
 #include "tsl/platform/denormal.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/setround.h"
+#include "tsl/platform/threadpool.h"
 
 namespace stream_executor {
 namespace host {
@@ -44,12 +49,12 @@ HostStream::HostStream(StreamExecutor* executor)
                                                [this]() { WorkLoop(); })) {}
 
 HostStream::~HostStream() {
-  {
-    absl::MutexLock lock(&mu_);
-    work_queue_.push(nullptr);
-  }
+  Push(new WorkItem{nullptr});
   // thread_'s destructor blocks until the thread finishes running.
   thread_.reset();
+  for (WorkItem* item = work_queue_.exchange(nullptr); item != nullptr;) {
+    delete std::exchange(item, item->next);
+  }
   parent()->DeallocateStream(this);
 }
 
@@ -75,6 +80,39 @@ absl::Status HostStream::WaitFor(Event* event) {
   return absl::OkStatus();
 }
 
+static tsl::thread::ThreadPool* IndependentTasksThreadPool() {
+  static tsl::thread::ThreadPool* const thread_pool =
+      new tsl::thread::ThreadPool(tsl::Env::Default(),
+                                  "host_stream_independent_tasks",
+                                  tsl::port::MaxParallelism());
+  return thread_pool;
+}
+
+bool HostStream::EnqueueIndependentTasks(
+    std::vector<absl::AnyInvocable<void() &&>> tasks) {
+  if (tasks.size() <= 1) {
+    for (auto& task : tasks) {
+      EnqueueTask(std::move(task));
+    }
+    return true;
+  }
+  // The stream thread runs the first task itself and waits for the others, so
+  // the whole group occupies a single slot in the stream order.
+  return EnqueueTask([tasks = std::move(tasks)]() mutable {
+    absl::BlockingCounter counter(tasks.size() - 1);
+    for (size_t i = 1; i < tasks.size(); ++i) {
+      IndependentTasksThreadPool()->Schedule([&tasks, &counter, i]() {
+        tsl::port::ScopedFlushDenormal flush;
+        tsl::port::ScopedSetRound round(FE_TONEAREST);
+        std::move(tasks[i])();
+        counter.DecrementCount();
+      });
+    }
+    std::move(tasks[0])();
+    counter.Wait();
+  });
+}
+
 bool HostStream::EnqueueTask(absl::AnyInvocable<void() &&> task) {
   return EnqueueTaskWithStatus([task = std::move(task)]() mutable {
     std::move(task)();
@@ -95,12 +133,29 @@ absl::Status HostStream::RecordEvent(Event* event) {
 bool HostStream::EnqueueTaskWithStatus(
     absl::AnyInvocable<absl::Status() &&> task) {
   CHECK(task != nullptr);
-  absl::MutexLock lock(&mu_);
-  work_queue_.push(std::move(task));
+  Push(new WorkItem{std::move(task)});
   return true;
 }
 
-bool HostStream::WorkAvailable() { return !work_queue_.empty(); }
+void HostStream::Push(WorkItem* item) {
+  // 'item' may be run and deleted as soon as it is pushed, so the previous
+  // head is kept in a local.
+  WorkItem* head = work_queue_.load(std::memory_order_relaxed);
+  do {
+    item->next = head;
+  } while (!work_queue_.compare_exchange_weak(head, item,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+  if (head == nullptr) {
+    // The work loop may be waiting in 'mu_.Await'. Releasing the mutex makes
+    // it re-evaluate WorkAvailable().
+    absl::MutexLock lock(&mu_);
+  }
+}
+
+bool HostStream::WorkAvailable() {
+  return work_queue_.load(std::memory_order_acquire) != nullptr;
+}
 
 void HostStream::WorkLoop() {
   // Set denormal and rounding behavior to match the default TF ThreadPool
@@ -109,19 +164,30 @@ void HostStream::WorkLoop() {
   tsl::port::ScopedFlushDenormal flush;
   tsl::port::ScopedSetRound round(FE_TONEAREST);
   while (true) {
-    std::queue<absl::AnyInvocable<absl::Status() &&>> queue;
-    {
+    WorkItem* stack = work_queue_.exchange(nullptr, std::memory_order_acquire);
+    if (stack == nullptr) {
       absl::MutexLock lock(&mu_);
       mu_.Await(absl::Condition(this, &HostStream::WorkAvailable));
-      std::swap(queue, work_queue_);
+      continue;
+    }
+    // Reverse the stack to run the batch in the order it was enqueued.
+    WorkItem* batch = nullptr;
+    while (stack != nullptr) {
+      WorkItem* next = stack->next;
+      stack->next = batch;
+      batch = stack;
+      stack = next;
     }
-    while (!queue.empty()) {
-      absl::AnyInvocable<absl::Status() &&>& fn = queue.front();
-      if (!fn) {
+    while (batch != nullptr) {
+      std::unique_ptr<WorkItem> item(std::exchange(batch, batch->next));
+      if (!item->task) {
+        // Tasks after the sentinel are never run.
+        while (batch != nullptr) {
+          delete std::exchange(batch, batch->next);
+        }
         return;
       }
-      status_.Update(std::move(fn)());
-      queue.pop();
+      status_.Update(std::move(item->task)());
     }
   }
 }
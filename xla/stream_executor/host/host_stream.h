@@ -18,9 +18,10 @@ limitations under the License.
 #ifndef XLA_STREAM_EXECUTOR_HOST_HOST_STREAM_H_
 #define XLA_STREAM_EXECUTOR_HOST_HOST_STREAM_H_
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/functional/any_invocable.h"
@@ -46,6 +47,12 @@ class HostStream : public StreamCommon {
   bool EnqueueTaskWithStatus(absl::AnyInvocable<absl::Status() &&> task);
   // Enqueue a task that doesn't report any status.
   bool EnqueueTask(absl::AnyInvocable<void() &&> task);
+  // Enqueue tasks that do not depend on each other. They run in parallel on a
+  // shared thread pool, but as a whole keep stream order: they start after all
+  // previously enqueued tasks have finished, and later tasks start after all
+  // of them have finished.
+  bool EnqueueIndependentTasks(
+      std::vector<absl::AnyInvocable<void() &&>> tasks);
 
   // Blocks until all tasks are done, returns the first error reported by a task
   // (if any) and clears the error status.
@@ -57,12 +64,25 @@ class HostStream : public StreamCommon {
   absl::Status MemZero(DeviceMemoryBase* location, uint64_t size) override;
 
  private:
+  // A node of the intrusive list of enqueued tasks. A null task stops the
+  // work loop.
+  struct WorkItem {
+    absl::AnyInvocable<absl::Status() &&> task;
+    WorkItem* next = nullptr;
+  };
+
+  // Pushes 'item' onto the work list without taking 'mu_', unless the list
+  // was empty and the work loop may be waiting for it.
+  void Push(WorkItem* item);
+
   bool WorkAvailable() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   void WorkLoop();
 
+  // Producers push onto a lock-free stack of work items, newest first. The
+  // work loop takes the whole stack at once and runs it as a batch in FIFO
+  // order. 'mu_' is only used to wait for work while the stack is empty.
   absl::Mutex mu_;
-  std::queue<absl::AnyInvocable<absl::Status() &&>> work_queue_
-      ABSL_GUARDED_BY(mu_);
+  std::atomic<WorkItem*> work_queue_{nullptr};
   std::unique_ptr<tsl::Thread> thread_;
   absl::Status status_;
 };
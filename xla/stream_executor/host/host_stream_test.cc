@@ -13,14 +13,22 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "xla/stream_executor/host/host_stream.h"
 #include "xla/stream_executor/platform.h"
 #include "xla/stream_executor/platform_manager.h"
 #include "xla/stream_executor/stream.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
 
@@ -74,3 +82,80 @@ TEST(HostStream, ReportsFirstHostCallbackError) {
   // "error 2" is just lost.
   ASSERT_EQ(stream->BlockHostUntilDone().message(), "error 1");
 }
+
+TEST(HostStream, KeepsOrderOfEachProducerThread) {
+  se::Platform* platform =
+      se::PlatformManager::PlatformWithName("Host").value();
+  se::StreamExecutor* executor = platform->ExecutorForDevice(0).value();
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, executor->CreateStream());
+  auto* host_stream = static_cast<se::host::HostStream*>(stream.get());
+
+  // Tasks only run on the stream thread, so they need no synchronization.
+  constexpr int kNumThreads = 8;
+  constexpr int kNumTasks = 1000;
+  std::vector<int> next(kNumThreads, 0);
+  bool ok = true;
+  {
+    std::vector<std::unique_ptr<tsl::Thread>> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back(tsl::Env::Default()->StartThread(
+          {}, "producer", [&, t]() {
+            for (int i = 0; i < kNumTasks; ++i) {
+              host_stream->EnqueueTask([&, t, i]() {
+                if (next[t] != i) {
+                  ok = false;
+                }
+                ++next[t];
+              });
+            }
+          }));
+    }
+  }
+  TF_ASSERT_OK(stream->BlockHostUntilDone());
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(next, std::vector<int>(kNumThreads, kNumTasks));
+}
+
+TEST(HostStream, DropsPendingTasksOnDestruction) {
+  se::Platform* platform =
+      se::PlatformManager::PlatformWithName("Host").value();
+  se::StreamExecutor* executor = platform->ExecutorForDevice(0).value();
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, executor->CreateStream());
+  auto counter = std::make_shared<int>(0);
+  for (int i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(stream->DoHostCallback([counter]() { ++*counter; }));
+  }
+  stream.reset();
+  // All tasks, run or not, have released their captures.
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(HostStream, IndependentTasksKeepStreamOrder) {
+  se::Platform* platform =
+      se::PlatformManager::PlatformWithName("Host").value();
+  se::StreamExecutor* executor = platform->ExecutorForDevice(0).value();
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, executor->CreateStream());
+  auto* host_stream = static_cast<se::host::HostStream*>(stream.get());
+
+  std::atomic<int> started = 0;
+  std::atomic<int> finished = 0;
+  std::atomic<bool> ok = true;
+  TF_ASSERT_OK(stream->DoHostCallback([&]() { started = 1; }));
+
+  constexpr int kNumTasks = 16;
+  std::vector<absl::AnyInvocable<void() &&>> tasks;
+  for (int i = 0; i < kNumTasks; ++i) {
+    tasks.push_back([&]() {
+      if (started != 1) ok = false;
+      ++finished;
+    });
+  }
+  host_stream->EnqueueIndependentTasks(std::move(tasks));
+
+  TF_ASSERT_OK(stream->DoHostCallback([&]() {
+    if (finished != kNumTasks) ok = false;
+  }));
+  TF_ASSERT_OK(stream->BlockHostUntilDone());
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(finished, kNumTasks);
+}
@@ -80,13 +80,15 @@ class TfAllocatorAdapter : public DeviceMemoryAllocator {
 // asynchronous deallocation; see comment on `AllowsAsynchronousDeallocation()`.
 class MultiDeviceAdapter : public DeviceMemoryAllocator {
  public:
+  // The same allocator can back several devices (e.g. a pinned host memory
+  // pool shared by all devices attached to a NUMA node).
   struct AllocatorInfo {
-    std::unique_ptr<tsl::Allocator> allocator;
+    std::shared_ptr<tsl::Allocator> allocator;
     Stream *stream;
     int64_t memory_space;
     std::optional<int> device_ordinal = std::nullopt;
 
-    AllocatorInfo(std::unique_ptr<tsl::Allocator> allocator, Stream *stream,
+    AllocatorInfo(std::shared_ptr<tsl::Allocator> allocator, Stream *stream,
                   int64_t memory_space,
                   std::optional<int> device_ordinal = std::nullopt)
         : allocator(std::move(allocator)),
@@ -182,6 +184,19 @@ class MultiDeviceAdapter : public DeviceMemoryAllocator {
         ->GetAllocator(device_ordinal);
   }
 
+  // Returns the allocator for `memory_space` of the given device.
+  absl::StatusOr<tsl::Allocator *> GetAllocator(int device_ordinal,
+                                                int64_t memory_space) {
+    auto it = memory_space_to_per_device_allocators_.find(memory_space);
+    if (it == memory_space_to_per_device_allocators_.end() ||
+        device_ordinal >= it->second.size() || !it->second[device_ordinal]) {
+      return absl::NotFoundError(absl::StrFormat(
+          "No allocator for memory space %d of device %d", memory_space,
+          device_ordinal));
+    }
+    return it->second[device_ordinal]->GetAllocator(device_ordinal);
+  }
+
  private:
   absl::flat_hash_map<int64_t, std::vector<std::unique_ptr<TfAllocatorAdapter>>>
       memory_space_to_per_device_allocators_;
@@ -191,7 +206,7 @@ class MultiDeviceAdapter : public DeviceMemoryAllocator {
       ABSL_GUARDED_BY(mu_);
   // The wrapped TF allocators backing per_device_allocators_
   // (TfAllocatorAdapter does not take ownership of its underlying Allocator).
-  std::vector<std::unique_ptr<tsl::Allocator>> tf_allocators_;
+  std::vector<std::shared_ptr<tsl::Allocator>> tf_allocators_;
 };
 
 }  // namespace stream_executor
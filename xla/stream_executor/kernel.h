@@ -80,6 +80,7 @@ limitations under the License.
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/meta/type_traits.h"
@@ -550,6 +551,55 @@ PackKernelArgs(absl::Span<const DeviceMemoryBase> args,
   return PackKernelArgs(args, metadata.shared_memory_bytes().value_or(0));
 }
 
+// A packed array of device memory arguments that can be updated in place. It
+// lets a caller that launches the same kernel many times pack arguments once
+// and only patch device memory pointers before each launch, instead of
+// allocating a new packed array for every launch. Argument addresses are stable
+// for the lifetime of the array.
+class KernelArgsDeviceMemoryPackedArray : public KernelArgsPackedArrayBase {
+ public:
+  KernelArgsDeviceMemoryPackedArray(size_t num_args,
+                                    uint32_t shared_memory_bytes)
+      : device_memory_opaque_pointers_(num_args, nullptr),
+        argument_addresses_(num_args),
+        shared_memory_bytes_(shared_memory_bytes) {
+    for (size_t i = 0; i < num_args; ++i) {
+      argument_addresses_[i] = &device_memory_opaque_pointers_[i];
+    }
+  }
+
+  // Not copyable or movable because argument addresses point to owned storage.
+  KernelArgsDeviceMemoryPackedArray(const KernelArgsDeviceMemoryPackedArray &) =
+      delete;
+  KernelArgsDeviceMemoryPackedArray &operator=(
+      const KernelArgsDeviceMemoryPackedArray &) = delete;
+
+  // Updates the device memory arguments. `args` must have as many elements as
+  // the array was constructed with.
+  void set_device_memory_arguments(absl::Span<const DeviceMemoryBase> args) {
+    assert(args.size() == device_memory_opaque_pointers_.size() &&
+           "wrong number of device memory arguments");
+    for (size_t i = 0; i < args.size(); ++i) {
+      device_memory_opaque_pointers_[i] = args[i].opaque();
+    }
+  }
+
+  size_t number_of_arguments() const final {
+    return argument_addresses_.size() + (shared_memory_bytes_ > 0);
+  }
+
+  uint64_t number_of_shared_bytes() const final { return shared_memory_bytes_; }
+
+  absl::Span<const void *const> argument_addresses() const final {
+    return argument_addresses_;
+  }
+
+ private:
+  std::vector<const void *> device_memory_opaque_pointers_;
+  std::vector<const void *> argument_addresses_;
+  uint32_t shared_memory_bytes_;
+};
+
 //===----------------------------------------------------------------------===//
 // Kernel arguments packing for statically know argument types
 //===----------------------------------------------------------------------===//
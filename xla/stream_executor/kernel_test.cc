@@ -89,6 +89,27 @@ TEST(KernelTest, PackDeviceMemoryArguments) {
   ASSERT_EQ(ptr1, b.opaque());
 }
 
+TEST(KernelTest, UpdateDeviceMemoryPackedArray) {
+  DeviceMemoryBase a(reinterpret_cast<void*>(0x12345678));
+  DeviceMemoryBase b(reinterpret_cast<void*>(0x87654321));
+
+  KernelArgsDeviceMemoryPackedArray args(/*num_args=*/2,
+                                         /*shared_memory_bytes=*/16);
+  ASSERT_EQ(args.number_of_arguments(), 3);
+  ASSERT_EQ(args.number_of_shared_bytes(), 16);
+
+  args.set_device_memory_arguments({a, b});
+  auto packed = args.argument_addresses();
+  ASSERT_EQ(*reinterpret_cast<const void* const*>(packed[0]), a.opaque());
+  ASSERT_EQ(*reinterpret_cast<const void* const*>(packed[1]), b.opaque());
+
+  // Argument addresses stay the same when arguments are updated.
+  args.set_device_memory_arguments({b, a});
+  ASSERT_EQ(args.argument_addresses().data(), packed.data());
+  ASSERT_EQ(*reinterpret_cast<const void* const*>(packed[0]), b.opaque());
+  ASSERT_EQ(*reinterpret_cast<const void* const*>(packed[1]), a.opaque());
+}
+
 TEST(KernelTest, PackPodArguments) {
   auto args = std::make_unique<KernelArgsPackedArray<4>>();
   args->add_argument(1);
@@ -520,6 +520,53 @@ XLA_TEST_F(CollectiveOpsTest, AllReduce_ThreeReplicaGroups) {
   EXPECT_TRUE(LiteralTestUtil::Equal(input_literal, results[3]));
 }
 
+// Devices 0 and 2 participate in two cliques that can't be split from each
+// other, and initialize them concurrently. Devices 1 and 3 share a clique with
+// them but request a different number of independent cliques, and all
+// participants must still agree on how many times every clique is acquired.
+XLA_TEST_F(CollectiveOpsTest, AllReduce_IndependentCliques) {
+  const char* const kModuleStr = R"(
+      HloModule test
+
+      apply_op {
+        x = u32[] parameter(0)
+        y = u32[] parameter(1)
+        ROOT apply_op = u32[] add(x, y)
+      }
+
+      ENTRY test_computation {
+        id = u32[] replica-id()
+        ar0 = u32[] all-reduce(id), replica_groups={{0,1},{2,3}}, to_apply=apply_op
+        ar1 = u32[] all-reduce(id), replica_groups={{0,2},{1},{3}}, to_apply=apply_op
+        ROOT tuple = (u32[], u32[]) tuple(ar0, ar1)
+      }
+    )";
+  static constexpr int kNumReplicas = 4;
+  SKIP_TEST_IF_NUM_DEVICES_LESS_THAN(kNumReplicas)
+
+  HloModuleConfig config =
+      GetModuleConfigForTest(/*replica_count=*/kNumReplicas);
+
+  // Second execution acquires cliques initialized by the first one.
+  for (int run = 0; run < 2; ++run) {
+    TF_ASSERT_OK_AND_ASSIGN(auto module,
+                            ParseAndReturnVerifiedModule(kModuleStr, config));
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::vector<Literal> results,
+        ExecuteReplicated(std::move(module), {}, kNumReplicas,
+                          /*use_threads=*/true, /*run_hlo_passes=*/true));
+
+    ASSERT_EQ(results.size(), kNumReplicas);
+    const uint32_t expected[kNumReplicas][2] = {
+        {1, 2}, {1, 1}, {5, 2}, {5, 3}};
+    for (int i = 0; i < kNumReplicas; ++i) {
+      std::vector<Literal> outputs = results[i].DecomposeTuple();
+      LiteralTestUtil::ExpectR0Equal<uint32_t>(expected[i][0], outputs[0]);
+      LiteralTestUtil::ExpectR0Equal<uint32_t>(expected[i][1], outputs[1]);
+    }
+  }
+}
+
 XLA_TEST_F(CollectiveOpsTest, AllReduce_Degenerate) {
   const char* const kModuleStr = R"(
       HloModule test
@@ -587,6 +634,50 @@ XLA_TEST_F(CollectiveOpsTest, DISABLED_ON_CPU(AsyncAllReduce)) {
   }
 }
 
+XLA_TEST_F(CollectiveOpsTest, DISABLED_ON_CPU(AsyncAllReduceCoalesced)) {
+  const absl::string_view kModuleStr = R"(
+      HloModule test, is_scheduled=true
+
+      apply_op {
+        x = u32[] parameter(0)
+        y = u32[] parameter(1)
+        ROOT apply_op = u32[] add(x, y)
+      }
+
+      ENTRY test_computation {
+        id = u32[] replica-id()
+        two = u32[] constant(2)
+        id2 = u32[] multiply(id, two)
+        start0 = u32[] all-reduce-start(id), to_apply=apply_op, backend_config="{\"is_sync\":false}"
+        start1 = u32[] all-reduce-start(id2), to_apply=apply_op, backend_config="{\"is_sync\":false}"
+        done0 = u32[] all-reduce-done(start0)
+        done1 = u32[] all-reduce-done(start1)
+        ROOT tuple = (u32[], u32[]) tuple(done0, done1)
+      }
+    )";
+
+  HloModuleConfig config =
+      GetModuleConfigForTest(/*replica_count=*/num_devices_);
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_gpu_enable_nccl_all_reduce_coalescing(true);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kModuleStr, config));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<Literal> results,
+      ExecuteReplicated(std::move(module), {}, num_devices_,
+                        /*use_threads=*/true, /*run_hlo_passes=*/false));
+
+  ASSERT_EQ(results.size(), num_devices_);
+  // sum [0, num_devices) and twice that.
+  uint32_t expected = num_devices_ * (num_devices_ - 1) / 2;
+  for (int i = 0; i < num_devices_; ++i) {
+    std::vector<Literal> outputs = results[i].DecomposeTuple();
+    LiteralTestUtil::ExpectR0Equal<uint32_t>(expected, outputs[0]);
+    LiteralTestUtil::ExpectR0Equal<uint32_t>(2 * expected, outputs[1]);
+  }
+}
+
 XLA_TEST_F(CollectiveOpsTest, DISABLED_ON_CPU(AsyncAllReduceTwoOperands)) {
   const absl::string_view kModuleStr = R"(
       HloModule test
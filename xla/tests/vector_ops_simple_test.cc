@@ -84,6 +84,61 @@ XLA_TEST_F(VecOpsSimpleTest, ExpManyValues) {
   }
 }
 
+XLA_TEST_F(VecOpsSimpleTest, SinManyValues) {
+  for (int count : {63, 64, 65, 127, 128, 129, 17 * 4096}) {
+    XlaBuilder builder(TestName());
+    std::vector<float> inputs;
+    inputs.reserve(count);
+    for (int i = 0; i < count; ++i) {
+      inputs.push_back(-1000.0f + 2000.0f * i / static_cast<float>(count));
+    }
+    auto x = ConstantR1<float>(&builder, inputs);
+    Sin(x);
+
+    std::vector<float> expected;
+    expected.reserve(inputs.size());
+    for (float input : inputs) {
+      expected.push_back(std::sin(input));
+    }
+
+    ComputeAndCompareR1<float>(&builder, expected, {},
+                               ErrorSpec(/*aabs=*/1e-5, /*arel=*/1e-5));
+  }
+}
+
+XLA_TEST_F(VecOpsSimpleTest, CosManyValues) {
+  for (int count : {63, 64, 65, 127, 128, 129, 17 * 4096}) {
+    XlaBuilder builder(TestName());
+    std::vector<float> inputs;
+    inputs.reserve(count);
+    for (int i = 0; i < count; ++i) {
+      inputs.push_back(-1000.0f + 2000.0f * i / static_cast<float>(count));
+    }
+    auto x = ConstantR1<float>(&builder, inputs);
+    Cos(x);
+
+    std::vector<float> expected;
+    expected.reserve(inputs.size());
+    for (float input : inputs) {
+      expected.push_back(std::cos(input));
+    }
+
+    ComputeAndCompareR1<float>(&builder, expected, {},
+                               ErrorSpec(/*aabs=*/1e-5, /*arel=*/1e-5));
+  }
+}
+
+XLA_TEST_F(VecOpsSimpleTest, SinCosSpecialValues) {
+  XlaBuilder builder(TestName());
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  auto x = ConstantR1<float>(&builder, {0.0f, -0.0f, inf, -inf, nan});
+  Add(Sin(x), Cos(x));
+
+  ComputeAndCompareR1<float>(&builder, {1.0f, 1.0f, nan, nan, nan}, {},
+                             ErrorSpec(/*aabs=*/1e-6, /*arel=*/1e-6));
+}
+
 XLA_TEST_F(VecOpsSimpleTest, ExpIn4D) {
   XlaBuilder builder(TestName());
   Array4D<float> exponents(2, 2, 2, 2);
@@ -15,23 +15,42 @@ limitations under the License.
 
 // A tool for printing compute costs. See kUsage for details.
 
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "xla/debug_options_flags.h"
+#include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/hlo_cost_analysis.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/stream_executor/device_description.pb.h"
+#include "xla/tools/hlo_cost_report.h"
 #include "xla/tools/hlo_module_loader.h"
+#include "xla/tsl/util/command_line_flags.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
 
 namespace {
 const char* const kUsage = R"(
-This tool prints the compute cost (flops and memory traffic) of an HLO module.
+This tool prints the compute cost (flops and memory traffic) of an HLO module,
+followed by the instructions with the highest estimated execution time and
+whether they are compute or memory bound.
 
 The input file can be obtained from XProf graph viewer by clicking
 "Download as short text".
 
+Times are estimated with a roofline using --peak_gflops and
+--peak_memory_bandwidth_gbps, or, if --gpu_spec is set to a GpuTargetConfig
+(see xla/tools/hlo_opt/gpu_specs), with the GPU performance model of XLA for
+that device. The GPU estimates are only meaningful for optimized HLO.
+
 Usage:
 
   bazel run compute_cost -- -input=path/to/hlo_module -format=[hlo|pb|pbtxt]
@@ -39,10 +58,24 @@ Usage:
 }  // namespace
 
 int main(int argc, char** argv) {
-  std::string input, format;
+  std::string input, format, gpu_spec;
+  int32_t top_n = 20;
+  float peak_gflops = 1000;
+  float peak_memory_bandwidth_gbps = 100;
   std::vector<tsl::Flag> flag_list = {
       tsl::Flag("input", &input, "input file"),
-      tsl::Flag("format", &format, "hlo|pb|pbtxt")};
+      tsl::Flag("format", &format, "hlo|pb|pbtxt"),
+      tsl::Flag("top_n", &top_n,
+                "Number of instructions with the highest estimated time to "
+                "print."),
+      tsl::Flag("gpu_spec", &gpu_spec,
+                "Path to a text-format GpuTargetConfig to estimate times for."),
+      tsl::Flag("peak_gflops", &peak_gflops,
+                "Peak compute throughput of the roofline used without "
+                "--gpu_spec."),
+      tsl::Flag("peak_memory_bandwidth_gbps", &peak_memory_bandwidth_gbps,
+                "Peak memory bandwidth of the roofline used without "
+                "--gpu_spec.")};
   xla::AppendDebugOptionsFlags(&flag_list);
   const std::string kUsageString =
       absl::StrCat(kUsage, "\n\n", tsl::Flags::Usage(argv[0], flag_list));
@@ -52,18 +85,27 @@ int main(int argc, char** argv) {
     LOG(QFATAL) << kUsageString;
   }
 
-  xla::HloCostAnalysis analysis([](const xla::Shape& shape) {
-    return xla::ShapeUtil::ByteSizeOf(shape, 8);
-  });
+  xla::HloCostAnalysis analysis(xla::CostReportShapeSize);
 
-  TF_CHECK_OK(xla::LoadModuleFromFile(input, format, {})
-                  .value()
-                  ->entry_computation()
-                  ->root_instruction()
-                  ->Accept(&analysis));
+  std::unique_ptr<xla::HloModule> module =
+      xla::LoadModuleFromFile(input, format, {}).value();
+  TF_CHECK_OK(module->entry_computation()->root_instruction()->Accept(
+      &analysis));
 
   std::cout << std::setw(5) << std::setprecision(4)
             << analysis.flop_count() / (1e9) << " GFLOPS. "
             << analysis.bytes_accessed() / (1e6) << " MiB." << std::endl;
+
+  xla::HloCostReportOptions options;
+  options.flops_per_second = peak_gflops * 1e9;
+  options.bytes_per_second = peak_memory_bandwidth_gbps * 1e9;
+  if (!gpu_spec.empty()) {
+    stream_executor::GpuTargetConfigProto gpu_target_config;
+    TF_CHECK_OK(
+        tsl::ReadTextProto(tsl::Env::Default(), gpu_spec, &gpu_target_config));
+    options.gpu_device_info.emplace(gpu_target_config.gpu_device_info());
+  }
+  std::cout << xla::ComputeHloCostReport(*module, options).value().ToString(
+      top_n);
   return 0;
 }
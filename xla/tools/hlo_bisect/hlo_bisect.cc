@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -36,7 +37,9 @@ computations to further reduce the module.
 Optionally provide the --script argument in order to use an external script for
 verifying the presence of the bug. This should be a path to executable that
 returns a non-zero exit status if the modified HLO module (passed as the command
-line argument path) has a bug.
+line argument path) has a bug. With --parallelism, several candidate modules
+are checked by concurrent invocations of the script, which speeds up bisecting
+large modules (e.g. when each invocation compiles on its own device).
 
 Usage:
 
@@ -56,6 +59,7 @@ struct BisectOptions {
   std::string reference_platform = "Interpreter";
   float abs_error = 0.01;
   float rel_error = 0.1;
+  int32_t parallelism = 1;
 };
 
 int main(int argc, char** argv) {
@@ -91,6 +95,9 @@ int main(int argc, char** argv) {
       tsl::Flag("rel_error", &opts.rel_error,
                 "The relative error bound used when comparing the test and "
                 "reference results."),
+      tsl::Flag("parallelism", &opts.parallelism,
+                "Number of candidate modules checked concurrently. Only used "
+                "with --script."),
   };
   xla::AppendDebugOptionsFlags(&flag_list);
 
@@ -130,7 +137,7 @@ int main(int argc, char** argv) {
   }
 
   auto runner = std::make_unique<xla::bisect::BisectRunner>(
-      std::move(module), std::move(bug_checker));
+      std::move(module), std::move(bug_checker), opts.parallelism);
   xla::bisect::RunBisect(std::move(runner), opts.all_computations,
                          opts.dump_path, opts.output_format);
   return 0;
@@ -15,14 +15,19 @@ limitations under the License.
 
 #include "xla/tools/hlo_bisect/hlo_bisect_state.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -31,6 +36,10 @@ limitations under the License.
 #include "xla/service/hlo_dce.h"
 #include "xla/tests/test_utils.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace bisect {
@@ -145,6 +154,24 @@ bool InstructionNotReplaceableWithConstant(HloInstruction* instruction) {
 
 }  // namespace
 
+HloBisectState::HloBisectState(std::unique_ptr<HloModule> module,
+                               BugCheckerInterface* bug_checker,
+                               int parallelism)
+    : module_(std::move(module)),
+      bug_checker_(bug_checker),
+      parallelism_(std::max(parallelism, 1)) {
+  if (parallelism_ > 1) {
+    if (bug_checker_->SupportsConcurrentRuns()) {
+      thread_pool_ = std::make_unique<tsl::thread::ThreadPool>(
+          tsl::Env::Default(), "hlo_bisect", parallelism_);
+    } else {
+      LOG(WARNING) << "The bug checker does not support concurrent runs, "
+                      "checking one candidate module at a time.";
+      parallelism_ = 1;
+    }
+  }
+}
+
 absl::StatusOr<bool> HloBisectState::ShouldProcess() {
   // Running the unmodified module should trigger the bug checker.
   return RunModule(*module_);
@@ -176,16 +203,20 @@ std::unique_ptr<xla::HloModule>&& HloBisectState::GetResult() {
 absl::StatusOr<bool> HloBisectState::RunModule(const HloModule& module) {
   VLOG(3) << "Modified module: " << module.ToString();
 
+  std::string fingerprint = module.GetFingerprint128();
+  if (auto it = checked_modules_.find(fingerprint);
+      it != checked_modules_.end()) {
+    VLOG(3) << "Reusing bug checker result: " << it->second;
+    return it->second;
+  }
+
   // Run the modified module with the bug checker.
   absl::StatusOr<bool> bug_result = bug_checker_->Run(module);
   TF_RETURN_IF_ERROR(bug_result.status());
   VLOG(3) << "Bug checker result: " << bug_result.value();
+  RecordResult(module, fingerprint, *bug_result);
 
-  // Update foldable instructions data.
   if (!bug_result.value()) {
-    for (HloInstruction* instr : module.entry_computation()->instructions()) {
-      foldable_instructions_.emplace(instr->name());
-    }
     for (auto& [key, value] : bug_checker_->GetResults()) {
       foldable_instructions_values_[key] = std::move(value);
     }
@@ -193,6 +224,59 @@ absl::StatusOr<bool> HloBisectState::RunModule(const HloModule& module) {
   return bug_result;
 }
 
+void HloBisectState::RecordResult(const HloModule& module,
+                                  const std::string& fingerprint,
+                                  bool has_bug) {
+  checked_modules_[fingerprint] = has_bug;
+
+  // Update foldable instructions data.
+  if (!has_bug) {
+    for (HloInstruction* instr : module.entry_computation()->instructions()) {
+      foldable_instructions_.emplace(instr->name());
+    }
+  }
+}
+
+absl::StatusOr<std::optional<int64_t>> HloBisectState::FindFirstModuleWithBug(
+    absl::Span<const std::unique_ptr<HloModule>> modules) {
+  if (thread_pool_ == nullptr) {
+    for (int64_t i = 0; i < modules.size(); ++i) {
+      TF_ASSIGN_OR_RETURN(bool has_bug, RunModule(*modules[i]));
+      if (has_bug) return i;
+    }
+    return std::nullopt;
+  }
+
+  // Run all candidates that were not checked before concurrently.
+  std::vector<std::string> fingerprints;
+  std::vector<absl::StatusOr<bool>> results(modules.size());
+  absl::BlockingCounter counter(modules.size());
+  for (int64_t i = 0; i < modules.size(); ++i) {
+    fingerprints.push_back(modules[i]->GetFingerprint128());
+    if (auto it = checked_modules_.find(fingerprints.back());
+        it != checked_modules_.end()) {
+      results[i] = it->second;
+      counter.DecrementCount();
+      continue;
+    }
+    VLOG(3) << "Modified module: " << modules[i]->ToString();
+    thread_pool_->Schedule([&, i] {
+      results[i] = bug_checker_->Run(*modules[i]);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+
+  std::optional<int64_t> first_with_bug;
+  for (int64_t i = 0; i < modules.size(); ++i) {
+    TF_RETURN_IF_ERROR(results[i].status());
+    VLOG(3) << "Bug checker result for candidate " << i << ": " << *results[i];
+    RecordResult(*modules[i], fingerprints[i], *results[i]);
+    if (*results[i] && !first_with_bug.has_value()) first_with_bug = i;
+  }
+  return first_with_bug;
+}
+
 absl::StatusOr<bool> HloBisectState::TrimByOutputs() {
   // Only available if the root instruction is a tuple.
   HloInstruction* root_instruction =
@@ -202,34 +286,40 @@ absl::StatusOr<bool> HloBisectState::TrimByOutputs() {
     return false;
   }
 
-  // Run the modified module and return the error state.
-  auto run_modified = [&](int64_t start, int64_t end) -> absl::StatusOr<bool> {
+  // Create a modified module that keeps only the given range of outputs.
+  auto make_modified =
+      [&](int64_t start,
+          int64_t end) -> absl::StatusOr<std::unique_ptr<HloModule>> {
     std::unique_ptr<HloModule> new_module = module_->Clone(/*suffix=*/"");
     HloInstruction* const* new_operands =
         new_module->entry_computation()->root_instruction()->operands().begin();
     TF_RETURN_IF_ERROR(MorphModuleWithOutputs(
         new_module.get(),
         absl::MakeSpan(new_operands + start, end - start + 1)));
-    return RunModule(*new_module);
+    return new_module;
   };
 
-  // Binary search for the operands range that exhibits a bug.
+  // Binary search for the operands range that exhibits a bug. The second half
+  // is only run if the first one doesn't have the bug, unless candidates are
+  // checked concurrently.
   int64_t bisect_low = 0;
   int64_t bisect_high = root_instruction->operand_count() - 1;
   while (bisect_low < bisect_high) {
     int64_t cur = bisect_low + (bisect_high - bisect_low) / 2;
     VLOG(2) << "Number of outputs: " << (cur - bisect_low + 1) << " ["
             << bisect_low << ".." << cur << "]";
-    TF_ASSIGN_OR_RETURN(bool has_bug, run_modified(bisect_low, cur));
-    if (has_bug) {
+    std::vector<std::unique_ptr<HloModule>> candidates(2);
+    TF_ASSIGN_OR_RETURN(candidates[0], make_modified(bisect_low, cur));
+    TF_ASSIGN_OR_RETURN(candidates[1], make_modified(cur + 1, bisect_high));
+    TF_ASSIGN_OR_RETURN(std::optional<int64_t> with_bug,
+                        FindFirstModuleWithBug(candidates));
+    if (!with_bug.has_value()) {
+      break;
+    }
+    if (*with_bug == 0) {
       bisect_high = cur;
     } else {
-      TF_ASSIGN_OR_RETURN(has_bug, run_modified(cur + 1, bisect_high));
-      if (has_bug) {
-        bisect_low = cur + 1;
-      } else {
-        break;
-      }
+      bisect_low = cur + 1;
     }
   }
 
@@ -253,20 +343,36 @@ absl::StatusOr<bool> HloBisectState::TrimByInstructions() {
   int64_t upper_bound = computation->instruction_count() -
                         computation->root_instruction()->shape().IsTuple();
 
-  // Binary search for the instructions range that exhibits a bug.
+  // Search for the instructions range that exhibits a bug. The range is split
+  // at `parallelism_` points (i.e. a binary search without parallelism) and
+  // the modules truncated at all of them are checked. This assumes that if a
+  // module truncated after `n` instructions has the bug, so does every module
+  // with more instructions.
   int64_t bisect_low = computation->num_parameters() - 1;
   int64_t bisect_high = upper_bound;
   while (bisect_low + 1 < bisect_high) {
-    int64_t cur = bisect_low + (bisect_high - bisect_low) / 2;
-    VLOG(2) << "Number of instructions: " << cur << " (of "
-            << computation->instruction_count() << ")";
-    std::unique_ptr<HloModule> new_module = module_->Clone(/*suffix=*/"");
-    TF_RETURN_IF_ERROR(MorphModuleWithInstructions(new_module.get(), cur));
-    TF_ASSIGN_OR_RETURN(bool has_bug, RunModule(*new_module));
-    if (has_bug) {
-      bisect_high = cur;
-    } else {
-      bisect_low = cur;
+    int64_t num_splits =
+        std::min<int64_t>(parallelism_, bisect_high - bisect_low - 1);
+    std::vector<int64_t> splits;
+    std::vector<std::unique_ptr<HloModule>> candidates;
+    for (int64_t i = 1; i <= num_splits; ++i) {
+      int64_t cur =
+          bisect_low + (bisect_high - bisect_low) * i / (num_splits + 1);
+      VLOG(2) << "Number of instructions: " << cur << " (of "
+              << computation->instruction_count() << ")";
+      std::unique_ptr<HloModule> new_module = module_->Clone(/*suffix=*/"");
+      TF_RETURN_IF_ERROR(MorphModuleWithInstructions(new_module.get(), cur));
+      splits.push_back(cur);
+      candidates.push_back(std::move(new_module));
+    }
+    TF_ASSIGN_OR_RETURN(std::optional<int64_t> with_bug,
+                        FindFirstModuleWithBug(candidates));
+    int64_t first_with_bug = with_bug.value_or(num_splits);
+    if (first_with_bug < num_splits) {
+      bisect_high = splits[first_with_bug];
+    }
+    if (first_with_bug > 0) {
+      bisect_low = splits[first_with_bug - 1];
     }
   }
 
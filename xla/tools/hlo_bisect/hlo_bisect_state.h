@@ -16,16 +16,21 @@ limitations under the License.
 #ifndef XLA_TOOLS_HLO_BISECT_HLO_BISECT_STATE_H_
 #define XLA_TOOLS_HLO_BISECT_HLO_BISECT_STATE_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/literal.h"
 #include "xla/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace bisect {
@@ -43,15 +48,26 @@ class BugCheckerInterface {
   // Returns mapping of instruction names to their results after the run
   // (empty if this information is unavailable).
   virtual absl::flat_hash_map<std::string, Literal> GetResults() = 0;
+
+  // Returns true if Run can be called concurrently from multiple threads.
+  // GetResults is not called after concurrent runs.
+  virtual bool SupportsConcurrentRuns() const { return false; }
 };
 
 // Trims down an HloModule that manifests a bug to a smaller module that
 // still exhibits a problem. Only the entry computation is reduced.
+//
+// If `parallelism` is larger than one and the bug checker supports concurrent
+// runs, up to `parallelism` candidate modules are checked at the same time:
+// the instruction range is split into parallelism + 1 parts instead of two
+// and both output halves are checked at once. The result of the bug checker
+// is remembered for every checked module, so identical candidates are never
+// compiled and run twice.
 class HloBisectState {
  public:
   explicit HloBisectState(std::unique_ptr<HloModule> module,
-                          BugCheckerInterface* bug_checker)
-      : module_(std::move(module)), bug_checker_(bug_checker) {}
+                          BugCheckerInterface* bug_checker,
+                          int parallelism = 1);
 
   // Returns true if the current module has a bug and should be processed.
   absl::StatusOr<bool> ShouldProcess();
@@ -68,6 +84,16 @@ class HloBisectState {
   // available. Returns true if `module` has a bug.
   absl::StatusOr<bool> RunModule(const HloModule& module);
 
+  // Runs the given candidate modules, concurrently if possible, and returns
+  // the index of the first one that has a bug. Without a thread pool the
+  // candidates are run one by one until a bug is found.
+  absl::StatusOr<std::optional<int64_t>> FindFirstModuleWithBug(
+      absl::Span<const std::unique_ptr<HloModule>> modules);
+
+  // Records the bug checker result for `module` with the given fingerprint.
+  void RecordResult(const HloModule& module, const std::string& fingerprint,
+                    bool has_bug);
+
   // Trims the entry computation by reducing the total number of outputs.
   // Returns a boolean to indicate whether the computation has been reduced.
   absl::StatusOr<bool> TrimByOutputs();
@@ -88,6 +114,12 @@ class HloBisectState {
   BugCheckerInterface* bug_checker_;
   absl::flat_hash_set<std::string> foldable_instructions_;
   absl::flat_hash_map<std::string, Literal> foldable_instructions_values_;
+
+  int parallelism_;
+  std::unique_ptr<tsl::thread::ThreadPool> thread_pool_;
+
+  // Bug checker results by module fingerprint.
+  absl::flat_hash_map<std::string, bool> checked_modules_;
 };
 
 }  // namespace bisect
@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/literal.h"
@@ -112,6 +113,81 @@ TEST_F(HloBisectStateTest, TrimByInstructions) {
       GmockMatch(m::Multiply(m::Broadcast(m::Parameter(0)), m::Parameter(1))));
 }
 
+// A bug checker that can be run concurrently.
+class ConcurrentTestBugSearch : public TestBugSearch {
+ public:
+  using TestBugSearch::TestBugSearch;
+  bool SupportsConcurrentRuns() const override { return true; }
+};
+
+TEST_F(HloBisectStateTest, TrimByInstructionsInParallel) {
+  const char* kModuleStr = R"(
+    HloModule test_module
+    ENTRY test_computation {
+      p0 = f32[10] parameter(0)
+      p1 = f32[10] parameter(1)
+      a = f32[10] add(p0, p1)
+      b = f32[10] multiply(a, p1)
+      c = f32[10] subtract(b, p0)
+      d = f32[10] negate(c)
+      e = f32[10] exponential(d)
+      f = f32[10] log(e)
+      g = f32[10] abs(f)
+      ROOT h = f32[10] sqrt(g)
+    }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kModuleStr));
+  ConcurrentTestBugSearch bug_checker(
+      {HloOpcode::kMultiply, HloOpcode::kSubtract});
+  HloBisectState bisect(std::move(module), &bug_checker, /*parallelism=*/3);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, bisect.TrimEntryComputation());
+  EXPECT_TRUE(changed);
+  auto reduced_module = std::move(bisect).GetResult();
+  EXPECT_THAT(reduced_module->entry_computation()->root_instruction(),
+              GmockMatch(m::Subtract(
+                  m::Multiply(m::Add(m::Parameter(0), m::Parameter(1)),
+                              m::Parameter(1)),
+                  m::Parameter(0))));
+}
+
+TEST_F(HloBisectStateTest, DoesNotRerunCheckedModules) {
+  // Fails the test if the same module is checked more than once.
+  class UniqueModulesBugSearch : public TestBugSearch {
+   public:
+    UniqueModulesBugSearch() : TestBugSearch({HloOpcode::kMultiply}) {}
+
+    absl::StatusOr<bool> Run(const HloModule& module) override {
+      EXPECT_TRUE(fingerprints_.insert(module.GetFingerprint128()).second)
+          << module.ToString();
+      return TestBugSearch::Run(module);
+    }
+
+   private:
+    absl::flat_hash_set<std::string> fingerprints_;
+  };
+
+  const char* kModuleStr = R"(
+    HloModule test_module
+    ENTRY test_computation {
+      p1 = s32[8] parameter(0)
+      p2 = s32[8] parameter(1)
+      a = s32[8] add(p1, p2)
+      b = s32[8] multiply(p1, p2)
+      c = s32[8] subtract(p1, p2)
+      ROOT sum = tuple(a, b, c)
+    }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kModuleStr));
+  UniqueModulesBugSearch bug_checker;
+  HloBisectState bisect(std::move(module), &bug_checker);
+  TF_ASSERT_OK_AND_ASSIGN(bool has_bug, bisect.ShouldProcess());
+  EXPECT_TRUE(has_bug);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, bisect.TrimEntryComputation());
+  EXPECT_TRUE(changed);
+}
+
 TEST_F(HloBisectStateTest, TrimByUsingRandomConstants) {
   const char* kModuleStr = R"(
     HloModule test_module
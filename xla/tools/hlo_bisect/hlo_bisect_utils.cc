@@ -296,7 +296,8 @@ absl::flat_hash_map<std::string, Literal> ScriptChecker::GetResults() {
 }
 
 absl::StatusOr<std::unique_ptr<HloModule>> BisectRunner::RunEntry() {
-  HloBisectState hlo_bisect(std::move(module_), bug_checker_.get());
+  HloBisectState hlo_bisect(std::move(module_), bug_checker_.get(),
+                            parallelism_);
   TF_ASSIGN_OR_RETURN(bool has_bug, hlo_bisect.ShouldProcess());
   if (!has_bug) {
     return InvalidArgument(
@@ -56,24 +56,29 @@ class MiscompareChecker : public BugCheckerInterface {
 };
 
 // Runs a user provided script and considers an HLO module to be buggy if the
-// script exits with a non-zero exit code.
+// script exits with a non-zero exit code. Every run writes the module to its
+// own temporary file and starts a new process, so runs can be concurrent.
 class ScriptChecker : public BugCheckerInterface {
  public:
   explicit ScriptChecker(std::string path_to_script)
       : path_to_script_(std::move(path_to_script)) {}
   absl::StatusOr<bool> Run(const HloModule& module) override;
   absl::flat_hash_map<std::string, Literal> GetResults() override;
+  bool SupportsConcurrentRuns() const override { return true; }
 
  private:
   std::string path_to_script_;
 };
 
-// Runner class for the bisect tool.
+// Runner class for the bisect tool. See HloBisectState for `parallelism`.
 class BisectRunner {
  public:
   BisectRunner(std::unique_ptr<HloModule> module,
-               std::unique_ptr<BugCheckerInterface> bug_checker)
-      : module_(std::move(module)), bug_checker_(std::move(bug_checker)) {}
+               std::unique_ptr<BugCheckerInterface> bug_checker,
+               int parallelism = 1)
+      : module_(std::move(module)),
+        bug_checker_(std::move(bug_checker)),
+        parallelism_(parallelism) {}
 
   absl::StatusOr<std::unique_ptr<HloModule>> RunEntry();
   absl::StatusOr<std::unique_ptr<HloModule>> RunAll();
@@ -81,6 +86,7 @@ class BisectRunner {
  protected:
   std::unique_ptr<HloModule> module_;
   std::unique_ptr<BugCheckerInterface> bug_checker_;
+  int parallelism_;
 };
 
 // Main runner for the bisect tool.
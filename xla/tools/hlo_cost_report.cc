@@ -0,0 +1,172 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tools/hlo_cost_report.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/gpu/model/gpu_performance_model.h"
+#include "xla/service/gpu/model/gpu_performance_model_base.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/errors.h"
+
+namespace xla {
+namespace {
+
+// Returns true if `instr` does not generate any code on its own.
+bool IsNoOp(const HloInstruction* instr) {
+  switch (instr->opcode()) {
+    case HloOpcode::kParameter:
+    case HloOpcode::kConstant:
+    case HloOpcode::kTuple:
+    case HloOpcode::kGetTupleElement:
+    case HloOpcode::kBitcast:
+      return true;
+    default:
+      return false;
+  }
+}
+
+absl::StatusOr<HloCostReport> ComputeGpuCostReport(
+    const HloModule& module, const se::DeviceDescription& device_info) {
+  gpu::GpuHloCostAnalysis::Options cost_analysis_options{
+      CostReportShapeSize, /*per_second_rates=*/{},
+      /*count_multiple_input_accesses=*/true};
+  gpu::GpuHloCostAnalysis cost_analysis(cost_analysis_options, &device_info);
+  TF_RETURN_IF_ERROR(module.entry_computation()->Accept(&cost_analysis));
+
+  gpu::GpuPerformanceModelOptions config =
+      gpu::GpuPerformanceModelOptions::Default();
+  HloCostReport report;
+  for (const HloInstruction* instr :
+       module.entry_computation()->instructions()) {
+    if (IsNoOp(instr)) continue;
+
+    gpu::EstimateRunTimeData data =
+        gpu::GpuPerformanceModel::EstimateRunTimeForInstruction(
+            instr, &cost_analysis, config);
+    InstructionCost cost;
+    cost.name = instr->name();
+    cost.opcode = instr->opcode();
+    cost.flops = data.flops;
+    cost.bytes_accessed = data.bytes_read + data.bytes_written;
+    cost.compute_time = data.compute_time;
+    cost.memory_time = data.read_time + data.write_time;
+    cost.time = data.exec_time;
+    report.instructions.push_back(std::move(cost));
+  }
+  return report;
+}
+
+absl::StatusOr<HloCostReport> ComputeRooflineCostReport(
+    const HloModule& module, const HloCostReportOptions& options) {
+  HloCostAnalysis cost_analysis(CostReportShapeSize);
+  TF_RETURN_IF_ERROR(module.entry_computation()->Accept(&cost_analysis));
+
+  HloCostReport report;
+  for (const HloInstruction* instr :
+       module.entry_computation()->instructions()) {
+    if (IsNoOp(instr)) continue;
+
+    InstructionCost cost;
+    cost.name = instr->name();
+    cost.opcode = instr->opcode();
+    cost.flops = cost_analysis.flop_count(*instr) +
+                 cost_analysis.transcendental_count(*instr);
+    cost.bytes_accessed = cost_analysis.bytes_accessed(*instr);
+    cost.compute_time = absl::Seconds(cost.flops / options.flops_per_second);
+    cost.memory_time =
+        absl::Seconds(cost.bytes_accessed / options.bytes_per_second);
+    cost.time = std::max(cost.compute_time, cost.memory_time);
+    report.instructions.push_back(std::move(cost));
+  }
+  return report;
+}
+
+}  // namespace
+
+int64_t CostReportShapeSize(const Shape& shape) {
+  constexpr int64_t kPointerSize = 8;
+  return ShapeUtil::ByteSizeOf(shape, kPointerSize);
+}
+
+absl::StatusOr<HloCostReport> ComputeHloCostReport(
+    const HloModule& module, const HloCostReportOptions& options) {
+  HloCostReport report;
+  if (options.gpu_device_info.has_value()) {
+    TF_ASSIGN_OR_RETURN(report,
+                        ComputeGpuCostReport(module, *options.gpu_device_info));
+  } else {
+    TF_ASSIGN_OR_RETURN(report, ComputeRooflineCostReport(module, options));
+  }
+
+  for (const InstructionCost& cost : report.instructions) {
+    report.flops += cost.flops;
+    report.bytes_accessed += cost.bytes_accessed;
+    report.time += cost.time;
+  }
+  std::stable_sort(report.instructions.begin(), report.instructions.end(),
+                   [](const InstructionCost& a, const InstructionCost& b) {
+                     return a.time > b.time;
+                   });
+  return report;
+}
+
+std::string HloCostReport::ToString(int64_t top_n) const {
+  int64_t num_compute_bound = 0;
+  for (const InstructionCost& cost : instructions) {
+    num_compute_bound += cost.compute_bound();
+  }
+
+  std::string out = absl::StrFormat(
+      "Estimated time: %s, %.4g GFLOP, %.4g MB accessed, %d of %d "
+      "instructions compute bound.\n",
+      absl::FormatDuration(time), flops / 1e9, bytes_accessed / 1e6,
+      num_compute_bound, instructions.size());
+
+  int64_t n = std::min<int64_t>(top_n, instructions.size());
+  if (n == 0) return out;
+
+  absl::StrAppendFormat(&out, "Top %d instructions by estimated time:\n", n);
+  absl::StrAppendFormat(&out, "%12s %7s %12s %12s %-8s %s\n", "time", "share",
+                        "GFLOP", "MB", "bound", "instruction");
+  for (int64_t i = 0; i < n; ++i) {
+    const InstructionCost& cost = instructions[i];
+    double share = time > absl::ZeroDuration()
+                       ? absl::FDivDuration(cost.time, time)
+                       : 0;
+    absl::StrAppendFormat(&out, "%12s %6.2f%% %12.4g %12.4g %-8s %s (%s)\n",
+                          absl::FormatDuration(cost.time), 100 * share,
+                          cost.flops / 1e9, cost.bytes_accessed / 1e6,
+                          cost.compute_bound() ? "compute" : "memory",
+                          cost.name, HloOpcodeString(cost.opcode));
+  }
+  return out;
+}
+
+}  // namespace xla
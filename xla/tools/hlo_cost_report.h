@@ -0,0 +1,88 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TOOLS_HLO_COST_REPORT_H_
+#define XLA_TOOLS_HLO_COST_REPORT_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/shape.h"
+#include "xla/stream_executor/device_description.h"
+
+namespace xla {
+
+struct HloCostReportOptions {
+  // If set, instruction times are estimated with GpuPerformanceModel for this
+  // device, e.g. one of the GpuTargetConfigs in xla/tools/hlo_opt/gpu_specs.
+  // The module should then be an optimized (fused) GPU module.
+  std::optional<se::DeviceDescription> gpu_device_info;
+
+  // Otherwise a roofline with these peak rates is used, which is roughly what
+  // a CPU can sustain.
+  double flops_per_second = 1e12;
+  double bytes_per_second = 1e11;
+};
+
+// Estimated cost of a single instruction of the entry computation.
+struct InstructionCost {
+  std::string name;
+  HloOpcode opcode;
+  int64_t flops = 0;
+  int64_t bytes_accessed = 0;
+  // Time the instruction would take if it was limited only by compute or only
+  // by memory bandwidth.
+  absl::Duration compute_time;
+  absl::Duration memory_time;
+  // Estimated execution time, at least the larger of the two above.
+  absl::Duration time;
+
+  bool compute_bound() const { return compute_time > memory_time; }
+};
+
+// Per-instruction cost of an HLO module estimated without running it.
+struct HloCostReport {
+  // Sorted by decreasing estimated time.
+  std::vector<InstructionCost> instructions;
+
+  int64_t flops = 0;
+  int64_t bytes_accessed = 0;
+  absl::Duration time;
+
+  // Returns a table of the `top_n` most expensive instructions with their
+  // share of the total time and whether they are compute or memory bound.
+  std::string ToString(int64_t top_n) const;
+};
+
+// Returns the size of `shape` in bytes as seen by the cost analyses behind the
+// report, i.e. with 8 byte pointers for tuples.
+int64_t CostReportShapeSize(const Shape& shape);
+
+// Estimates the cost of every instruction of the entry computation of
+// `module`. Instructions that do not generate code (parameters, constants,
+// tuples, bitcasts) are skipped. Loops are not unrolled, i.e. a while
+// instruction is counted as a single execution of its body.
+absl::StatusOr<HloCostReport> ComputeHloCostReport(
+    const HloModule& module, const HloCostReportOptions& options);
+
+}  // namespace xla
+
+#endif  // XLA_TOOLS_HLO_COST_REPORT_H_
@@ -0,0 +1,100 @@
+/* Copyright 2024 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tools/hlo_cost_report.h"
+
+#include <algorithm>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::SizeIs;
+
+using HloCostReportTest = HloTestBase;
+
+constexpr char kHlo[] = R"(
+  HloModule m
+
+  ENTRY main {
+    p0 = f32[1024,1024] parameter(0)
+    p1 = f32[1024,1024] parameter(1)
+    dot = f32[1024,1024] dot(p0, p1),
+      lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT add = f32[1024,1024] add(dot, p1)
+  })";
+
+TEST_F(HloCostReportTest, ClassifiesRooflineBounds) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  HloCostReportOptions options;
+  options.flops_per_second = 1e12;
+  options.bytes_per_second = 1e11;
+  TF_ASSERT_OK_AND_ASSIGN(HloCostReport report,
+                          ComputeHloCostReport(*module, options));
+
+  // Parameters are skipped and instructions are sorted by time.
+  ASSERT_THAT(report.instructions, SizeIs(2));
+  const InstructionCost& dot = report.instructions[0];
+  const InstructionCost& add = report.instructions[1];
+  EXPECT_EQ(dot.opcode, HloOpcode::kDot);
+  EXPECT_EQ(add.opcode, HloOpcode::kAdd);
+
+  EXPECT_EQ(dot.flops, 2 * 1024 * 1024 * 1024LL);
+  EXPECT_TRUE(dot.compute_bound());
+  EXPECT_EQ(dot.time, absl::Seconds(dot.flops / 1e12));
+
+  EXPECT_EQ(add.bytes_accessed, 3 * 1024 * 1024 * 4);
+  EXPECT_FALSE(add.compute_bound());
+  EXPECT_EQ(add.time, absl::Seconds(add.bytes_accessed / 1e11));
+
+  EXPECT_EQ(report.time, dot.time + add.time);
+  EXPECT_EQ(report.flops, dot.flops + add.flops);
+
+  std::string table = report.ToString(/*top_n=*/1);
+  EXPECT_THAT(table, HasSubstr("1 of 2 instructions compute bound"));
+  EXPECT_THAT(table, HasSubstr("dot (dot)"));
+  EXPECT_THAT(table, Not(HasSubstr("add (add)")));
+}
+
+TEST_F(HloCostReportTest, UsesGpuPerformanceModel) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  HloCostReportOptions options;
+  options.gpu_device_info = gpu::TestGpuDeviceInfo::RTXA6000DeviceInfo();
+  TF_ASSERT_OK_AND_ASSIGN(HloCostReport report,
+                          ComputeHloCostReport(*module, options));
+
+  ASSERT_THAT(report.instructions, SizeIs(2));
+  for (const InstructionCost& cost : report.instructions) {
+    EXPECT_GT(cost.time, absl::ZeroDuration()) << cost.name;
+    EXPECT_GE(cost.time, std::max(cost.compute_time, cost.memory_time))
+        << cost.name;
+  }
+  EXPECT_GE(report.instructions[0].time, report.instructions[1].time);
+}
+
+}  // namespace
+}  // namespace xla
@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "xla/tools/multihost_hlo_runner/functional_hlo_runner.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -32,10 +35,12 @@ limitations under the License.
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xla/client/executable_build_options.h"
@@ -73,6 +78,7 @@ limitations under the License.
 #include "tsl/platform/errors.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -1007,6 +1013,110 @@ absl::Status EnsureSingleTupleForFlattening(const HloModule& module) {
   return absl::OkStatus();
 }
 
+// Runs the benchmark mode: issues `num_repeats` executions from each of
+// `num_benchmark_threads` client threads, with up to `max_inflight_executions`
+// executions in flight per thread, and logs latency percentiles and throughput.
+absl::Status RunBenchmark(
+    PjRtLoadedExecutable* executable, const ExecuteOptions& execute_options,
+    std::function<absl::StatusOr<
+        std::vector<std::vector<std::unique_ptr<PjRtBuffer>>>>()>
+        create_argument_buffers,
+    std::function<std::vector<std::vector<PjRtBuffer*>>(
+        absl::Span<const std::vector<std::unique_ptr<PjRtBuffer>>>,
+        absl::Span<const std::vector<std::unique_ptr<PjRtBuffer>>>)>
+        next_argument_ptrs,
+    const FunctionalHloRunner::RunningOptions& running_options) {
+  const int num_threads = running_options.num_benchmark_threads;
+  const int max_inflight = std::max(1, running_options.max_inflight_executions);
+
+  absl::Mutex mu;
+  std::vector<absl::Duration> latencies;
+  std::vector<absl::Status> statuses(num_threads);
+  std::atomic<int32_t> next_launch_id = 0;
+
+  // Every client thread owns its argument buffers, and keeps them on device
+  // across executions, unless buffers are recreated between repeats.
+  auto run_client = [&](int thread_id) -> absl::Status {
+    std::vector<std::vector<std::unique_ptr<PjRtBuffer>>> device_buffers;
+    std::vector<std::vector<std::unique_ptr<PjRtBuffer>>> output_buffers;
+    std::vector<std::vector<PjRtBuffer*>> argument_ptrs;
+    std::deque<std::pair<absl::Time, PjRtFuture<>>> inflight;
+
+    // Waits for the oldest in-flight execution and records its latency.
+    // Executions complete in order, so the latency is not overestimated.
+    auto await_oldest = [&]() -> absl::Status {
+      auto [start, future] = std::move(inflight.front());
+      inflight.pop_front();
+      TF_RETURN_IF_ERROR(future.Await());
+      absl::MutexLock lock(&mu);
+      latencies.push_back(absl::Now() - start);
+      return absl::OkStatus();
+    };
+
+    for (int repeat = 0; repeat < running_options.num_repeats; ++repeat) {
+      if (inflight.size() >= max_inflight) {
+        TF_RETURN_IF_ERROR(await_oldest());
+      }
+      if (repeat == 0 || running_options.recreate_buffers_between_repeats) {
+        TF_ASSIGN_OR_RETURN(device_buffers, create_argument_buffers());
+        argument_ptrs = CreateArgumentPointersFromDeviceBuffers(device_buffers);
+      }
+
+      ExecuteOptions options = execute_options;
+      options.launch_id = next_launch_id.fetch_add(1);
+
+      std::optional<std::vector<PjRtFuture<>>> futures;
+      futures.emplace();
+      absl::Time start = absl::Now();
+      TF_ASSIGN_OR_RETURN(output_buffers,
+                          executable->Execute(argument_ptrs, options, futures));
+      inflight.emplace_back(start, JoinFutures(*futures));
+
+      argument_ptrs = next_argument_ptrs(output_buffers, device_buffers);
+    }
+
+    while (!inflight.empty()) {
+      TF_RETURN_IF_ERROR(await_oldest());
+    }
+    return absl::OkStatus();
+  };
+
+  absl::Time start = absl::Now();
+  {
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "hlo_runner_benchmark",
+                                 num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      pool.Schedule([&, i] { statuses[i] = run_client(i); });
+    }
+  }
+  absl::Duration elapsed = absl::Now() - start;
+
+  for (const absl::Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+
+  absl::MutexLock lock(&mu);
+  if (latencies.empty()) return absl::OkStatus();
+  absl::c_sort(latencies);
+  auto percentile = [&](double p) {
+    size_t index = static_cast<size_t>(p * latencies.size());
+    return latencies[std::min(index, latencies.size() - 1)];
+  };
+
+  LOG(INFO) << absl::StrFormat(
+      "FunctionalHloRunner benchmark: %d executions from %d threads (up to %d "
+      "in flight per thread) in %s; throughput: %.2f executions/s; latency: "
+      "p50=%s p90=%s p99=%s max=%s",
+      latencies.size(), num_threads, max_inflight,
+      absl::FormatDuration(elapsed),
+      latencies.size() / absl::ToDoubleSeconds(elapsed),
+      absl::FormatDuration(percentile(0.5)),
+      absl::FormatDuration(percentile(0.9)),
+      absl::FormatDuration(percentile(0.99)),
+      absl::FormatDuration(latencies.back()));
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::StatusOr<FunctionalHloRunner::PerDeviceLiteralVecType>
@@ -1096,6 +1206,41 @@ FunctionalHloRunner::RunInternal(
   if (must_untuple_result) {
     execute_options.untuple_result = true;
   }
+
+  // Returns argument pointers for the next execution: outputs aliased with
+  // (donated) inputs are passed back as inputs.
+  auto next_argument_ptrs =
+      [&](absl::Span<const std::vector<std::unique_ptr<PjRtBuffer>>>
+              output_buffers,
+          absl::Span<const std::vector<std::unique_ptr<PjRtBuffer>>>
+              device_buffers) {
+        std::vector<std::vector<PjRtBuffer*>> argument_ptrs;
+        switch (parameter_type) {
+          case ParameterType::kOneTupleOfArrays:
+            argument_ptrs = CreateArgumentPointersBasedOnAliasing(
+                output_buffers, device_buffers,
+                get_output_index_for_one_tuple_of_arrays);
+            break;
+          case ParameterType::kOneListOfArrays:
+            argument_ptrs = CreateArgumentPointersBasedOnAliasing(
+                output_buffers, device_buffers,
+                get_output_index_for_one_list_of_arrays);
+            break;
+          case ParameterType::kOther:
+            argument_ptrs =
+                CreateArgumentPointersFromDeviceBuffers(device_buffers);
+            break;
+        }
+        return argument_ptrs;
+      };
+
+  if (running_options.num_benchmark_threads > 0) {
+    TF_RETURN_IF_ERROR(RunBenchmark(
+        executable, execute_options,
+        [&] { return create_argument_buffers_on_device(flatten_arguments); },
+        next_argument_ptrs, running_options));
+  }
+
   std::optional<std::vector<PjRtFuture<>>> futures;
   futures.emplace();
   std::vector<std::vector<std::unique_ptr<PjRtBuffer>>> device_buffers;
@@ -1128,22 +1273,7 @@ FunctionalHloRunner::RunInternal(
     VLOG(1) << "FunctionalHloRunner: ExecuteOnDevices succeeded (repeat = "
             << repeat << ")";
     if (repeat < running_options.num_repeats - 1) {
-      switch (parameter_type) {
-        case ParameterType::kOneTupleOfArrays:
-          argument_ptrs = CreateArgumentPointersBasedOnAliasing(
-              output_buffers, device_buffers,
-              get_output_index_for_one_tuple_of_arrays);
-          break;
-        case ParameterType::kOneListOfArrays:
-          argument_ptrs = CreateArgumentPointersBasedOnAliasing(
-              output_buffers, device_buffers,
-              get_output_index_for_one_list_of_arrays);
-          break;
-        case ParameterType::kOther:
-          argument_ptrs =
-              CreateArgumentPointersFromDeviceBuffers(device_buffers);
-          break;
-      }
+      argument_ptrs = next_argument_ptrs(output_buffers, device_buffers);
     }
   }
 
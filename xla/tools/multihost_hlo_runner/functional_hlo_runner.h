@@ -211,6 +211,14 @@ class FunctionalHloRunner {
     // Whether to untuple the result of running HLO module into a vector of
     // arrays. If unprovided, use the default in ExecuteOptions.
     std::optional<bool> untuple_result = std::nullopt;
+    // If positive, runs the benchmark mode before the regular run: each of
+    // this many client threads issues `num_repeats` executions, with up to
+    // `max_inflight_executions` executions in flight, and the latency
+    // percentiles and the sustained throughput are logged. Argument buffers
+    // stay on device (unless `recreate_buffers_between_repeats` is set), and
+    // outputs aliased with donated inputs are passed back as inputs.
+    int num_benchmark_threads = 0;
+    int max_inflight_executions = 1;
 
     // Should we log the inputs and outputs to stderr?
     bool log_input_output() const {
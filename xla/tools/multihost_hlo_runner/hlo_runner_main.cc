@@ -100,6 +100,9 @@ struct HloRunnerConfig {
   int32_t while_execution_count = -1;
   bool remove_infeed_outfeed = true;
   int32_t num_repeats = 1;
+  int32_t num_benchmark_threads = 0;
+  int32_t max_inflight_executions = 1;
+  bool recreate_buffers_between_repeats = false;
   std::string execution_options_path = "";
   int64_t gpu_client_initialization_timeout_sec = 300;
 };
@@ -162,6 +165,9 @@ RunningOptionsFromFlags(const HloRunnerConfig& opts) {
   out.module_output_mode =
       FunctionalHloRunner::ModuleOutputMode::kReturnOutputs;
   out.num_repeats = static_cast<size_t>(opts.num_repeats);
+  out.num_benchmark_threads = opts.num_benchmark_threads;
+  out.max_inflight_executions = opts.max_inflight_executions;
+  out.recreate_buffers_between_repeats = opts.recreate_buffers_between_repeats;
   out.log_input_output_mode =
       opts.log_output ? FunctionalHloRunner::LogOutputMode::kLogOutput
                       : FunctionalHloRunner::LogOutputMode::kNotLogOutput;
@@ -311,6 +317,18 @@ int main(int argc, char** argv) {
                 "If set, we will remove all infeed and outfeed operations."),
       tsl::Flag("num_repeats", &opts.num_repeats,
                 "Repeatedly execute the HLO for this many times."),
+      tsl::Flag("num_benchmark_threads", &opts.num_benchmark_threads,
+                "If positive, benchmarks the HLO by issuing num_repeats "
+                "executions from each of this many client threads, and logs "
+                "latency percentiles and throughput."),
+      tsl::Flag("max_inflight_executions", &opts.max_inflight_executions,
+                "The maximum number of in-flight executions per benchmark "
+                "client thread."),
+      tsl::Flag("recreate_buffers_between_repeats",
+                &opts.recreate_buffers_between_repeats,
+                "If set, argument buffers are copied to device for every "
+                "execution, otherwise they stay on device and outputs "
+                "aliased with donated inputs are passed back as inputs."),
       tsl::Flag("execution_options_path", &opts.execution_options_path,
                 "A path to a protobuf text file which stores the "
                 "ExecutionOptions message for this HLO module."),
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "xla/tools/run_hlo_module.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -31,7 +34,9 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
@@ -41,9 +46,12 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/literal.h"
 #include "xla/literal_comparison.h"
+#include "xla/service/executable.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/service/hlo_module_config.h"
+#include "xla/service/hlo_runner.h"
 #include "xla/service/hlo_verifier.h"
+#include "xla/service/shaped_buffer.h"
 #include "xla/tests/test_utils.h"
 #include "xla/tools/hlo_control_flow_flattening.h"
 #include "xla/tools/hlo_decomposer.h"
@@ -168,6 +176,42 @@ absl::StatusOr<Literal> ExecuteWithRunner(
   return std::move(result_status).value();
 }
 
+// Creates the arguments of `module`: the literals in iteration_literals_proto
+// if there are any, fake data otherwise.
+absl::StatusOr<std::vector<Literal>> MakeArguments(
+    HloModule* module, std::minstd_rand0* engine,
+    const RunHloModuleOptions& options,
+    const RunHloModuleIterationLiterals* iteration_literals_proto) {
+  TF_ASSIGN_OR_RETURN(std::vector<Literal> args,
+                      MakeFakeArguments(module, engine,
+                                        options.use_large_float_range,
+                                        options.treat_gte_as_data_formatting));
+  // Use provided input literals as arguments, if any.
+  if (iteration_literals_proto == nullptr ||
+      iteration_literals_proto->arguments_size() == 0) {
+    return args;
+  }
+  if (iteration_literals_proto->arguments_size() != args.size()) {
+    return xla::InvalidArgument(
+        "Failed to use input literals as arguments; mismatched "
+        "number of expected arguments.");
+  }
+  for (int i = 0; i < args.size(); ++i) {
+    if (!literal_comparison::EqualShapes(
+             xla::Shape(args[i].shape()),
+             xla::Shape(iteration_literals_proto->arguments(i).shape()))
+             .ok()) {
+      return xla::InvalidArgument(
+          "Failed to use input literals for argument %d "
+          "because of a shape mismatch.",
+          i);
+    }
+    TF_ASSIGN_OR_RETURN(args[i], xla::Literal::CreateFromProto(
+                                     iteration_literals_proto->arguments(i)));
+  }
+  return args;
+}
+
 absl::Status RunAndCompareInternal(
     std::unique_ptr<HloModule> test_module,
     const BufferAssignmentProto* buffer_assignment_proto,
@@ -203,43 +247,10 @@ absl::Status RunAndCompareInternal(
   }
 
   TF_ASSIGN_OR_RETURN(
-      auto args, copy_result_on_failure(
-                     MakeFakeArguments(test_module.get(), engine,
-                                       options.use_large_float_range,
-                                       options.treat_gte_as_data_formatting),
-                     ModuleResult::kOtherError, test_run_result));
-  // Use provided input literals as arguments, if any.
-  if (iteration_literals_proto != nullptr &&
-      iteration_literals_proto->arguments_size() != 0) {
-    if (iteration_literals_proto->arguments_size() != args.size()) {
-      if (test_run_result != nullptr) {
-        *test_run_result = ModuleResult::kOtherError;
-      }
-      return xla::InvalidArgument(
-          "Failed to use input literals as arguments; mismatched "
-          "number of expected arguments.");
-    } else {
-      for (int i = 0; i < args.size(); ++i) {
-        if (!literal_comparison::EqualShapes(
-                 xla::Shape(args[i].shape()),
-                 xla::Shape(iteration_literals_proto->arguments(i).shape()))
-                 .ok()) {
-          if (test_run_result != nullptr) {
-            *test_run_result = ModuleResult::kOtherError;
-          }
-          return xla::InvalidArgument(
-              "Failed to use input literals for argument %d "
-              "because of a shape mismatch.",
-              i);
-        }
-        TF_ASSIGN_OR_RETURN(
-            args[i],
-            copy_result_on_failure(xla::Literal::CreateFromProto(
-                                       iteration_literals_proto->arguments(i)),
-                                   ModuleResult::kOtherError, test_run_result));
-      }
-    }
-  }
+      auto args,
+      copy_result_on_failure(MakeArguments(test_module.get(), engine, options,
+                                           iteration_literals_proto),
+                             ModuleResult::kOtherError, test_run_result));
   if (options.print_literals) {
     for (int i = 0; i < args.size(); ++i) {
       std::cout << "\n** Argument " << i << " **\n"
@@ -459,6 +470,65 @@ absl::Status RunIsolatedAndCompare(
   return status;
 }
 
+// A module loaded from a file, together with the buffer assignment and the
+// inputs stored in it.
+struct TestModule {
+  std::unique_ptr<HloModule> module;
+  BufferAssignmentProto buffer_assignment_proto;
+  // Only set if the file is a snapshot and load_snapshot_inputs is true.
+  std::unique_ptr<RunHloModuleIterationLiterals> snapshot_inputs;
+};
+
+absl::StatusOr<TestModule> LoadTestModule(
+    const std::string& hlo_filename, const RunHloModuleOptions& options,
+    bool load_snapshot_inputs,
+    std::function<void(HloModuleConfig*)> config_modifier_hook,
+    std::function<absl::Status(const RunHloModuleOptions& options,
+                               HloModule& module)>
+        compilation_env_modifier_hook) {
+  std::string input_format = options.input_format;
+  if (input_format.empty()) {
+    input_format = std::string(tsl::io::Extension(hlo_filename));
+  }
+  TestModule test_module;
+  TF_ASSIGN_OR_RETURN(
+      test_module.module,
+      LoadModuleFromFile(hlo_filename, input_format,
+                         hlo_module_loader_details::Config(),
+                         config_modifier_hook,
+                         options.use_buffer_assignment_from_proto
+                             ? &test_module.buffer_assignment_proto
+                             : nullptr));
+  HloVerifier verifier(
+      HloVerifierOpts{}.WithLayoutSensitive(false).WithAllowMixedPrecision(
+          true));
+  TF_RETURN_IF_ERROR(verifier.Run(test_module.module.get()).status());
+  if (compilation_env_modifier_hook) {
+    TF_CHECK_OK(compilation_env_modifier_hook(options, *test_module.module))
+        << "Could not adjust the compilation environment for user provided "
+           "hlo module.";
+  }
+
+  if (options.print_literals) {
+    std::cout << "\n** Buffer assignment proto **\n"
+              << test_module.buffer_assignment_proto.DebugString() << "\n";
+  }
+  if (load_snapshot_inputs) {
+    // User did not explicitly give input
+    if (!options.force_fake_data && !options.isolate_instructions &&
+        (input_format == "pb" || input_format == "pbtxt")) {
+      // User is giving a snapshot (which contains inputs)
+      LOG(INFO) << "Using input data from the user-provided snapshot.";
+      TF_ASSIGN_OR_RETURN(test_module.snapshot_inputs,
+                          LoadInputFromFile(hlo_filename, input_format));
+    } else if (input_format == "pb" || input_format == "pbtxt") {
+      LOG(INFO)
+          << "Ignoring input data from snapshot and using fake data instead.";
+    }
+  }
+  return test_module;
+}
+
 }  // namespace
 
 absl::Status RunAndCompare(
@@ -495,55 +565,121 @@ absl::Status RunAndCompare(
     std::function<absl::Status(const RunHloModuleOptions& options,
                                HloModule& module)>
         compilation_env_modifier_hook) {
-  std::string input_format = options.input_format;
-  if (input_format.empty()) {
-    input_format = std::string(tsl::io::Extension(hlo_filename));
-  }
-  BufferAssignmentProto buffer_assignment_proto;
   TF_ASSIGN_OR_RETURN(
-      auto test_module,
-      LoadModuleFromFile(
-          hlo_filename, input_format, hlo_module_loader_details::Config(),
-          config_modifier_hook,
-          options.use_buffer_assignment_from_proto ? &buffer_assignment_proto
-                                                   : nullptr));
-  HloVerifier verifier(
-      HloVerifierOpts{}.WithLayoutSensitive(false).WithAllowMixedPrecision(
-          true));
-  TF_RETURN_IF_ERROR(verifier.Run(test_module.get()).status());
-  if (compilation_env_modifier_hook) {
-    TF_CHECK_OK(compilation_env_modifier_hook(options, *test_module))
-        << "Could not adjust the compilation environment for user provided "
-           "hlo module.";
-  }
-
-  if (options.print_literals) {
-    std::cout << "\n** Buffer assignment proto **\n"
-              << buffer_assignment_proto.DebugString() << "\n";
-  }
-  std::unique_ptr<RunHloModuleIterationLiterals> iteration_literals_proto_local;
+      TestModule test_module,
+      LoadTestModule(hlo_filename, options,
+                     /*load_snapshot_inputs=*/iteration_literals_proto ==
+                         nullptr,
+                     config_modifier_hook, compilation_env_modifier_hook));
   if (iteration_literals_proto == nullptr) {
-    // User did not explicitly give input
-    if (!options.force_fake_data && !options.isolate_instructions &&
-        (input_format == "pb" || input_format == "pbtxt")) {
-      // User is giving a snapshot (which contains inputs)
-      LOG(INFO) << "Using input data from the user-provided snapshot.";
-      TF_ASSIGN_OR_RETURN(iteration_literals_proto_local,
-                          LoadInputFromFile(hlo_filename, input_format));
-      iteration_literals_proto = iteration_literals_proto_local.get();
-    } else if (input_format == "pb" || input_format == "pbtxt") {
-      LOG(INFO)
-          << "Ignoring input data from snapshot and using fake data instead.";
-    }
+    iteration_literals_proto = test_module.snapshot_inputs.get();
   }
   return RunAndCompare(
-      std::move(test_module),
-      options.use_buffer_assignment_from_proto ? &buffer_assignment_proto
-                                               : nullptr,
+      std::move(test_module.module),
+      options.use_buffer_assignment_from_proto
+          ? &test_module.buffer_assignment_proto
+          : nullptr,
       test_runner, reference_runner, engine, options, iteration_literals_proto,
       reference_module_modifier_hook, config_modifier_hook);
 }
 
+absl::Status RunTimedReplay(
+    const std::string& hlo_filename, HloRunner* test_runner,
+    std::minstd_rand0* engine, const RunHloModuleOptions& options,
+    const RunHloModuleIterationLiterals* iteration_literals_proto,
+    std::function<void(HloModuleConfig*)> config_modifier_hook,
+    std::function<absl::Status(const RunHloModuleOptions& options,
+                               HloModule& module)>
+        compilation_env_modifier_hook) {
+  if (options.timed_replay_iterations <= 0) {
+    return absl::InvalidArgumentError(
+        "Timed replay requires a positive number of iterations");
+  }
+  if (!config_modifier_hook) {
+    config_modifier_hook = [](HloModuleConfig* config) {
+      config->set_seed(42);
+    };
+  }
+
+  TF_ASSIGN_OR_RETURN(
+      TestModule test_module,
+      LoadTestModule(hlo_filename, options,
+                     /*load_snapshot_inputs=*/iteration_literals_proto ==
+                         nullptr,
+                     config_modifier_hook, compilation_env_modifier_hook));
+  if (iteration_literals_proto == nullptr) {
+    iteration_literals_proto = test_module.snapshot_inputs.get();
+  }
+
+  if (options.flatten_control_flow) {
+    HloControlFlowFlattening control_flow_flattening(
+        HloControlFlowFlattening::Options{/*while_execution_count=*/1});
+    TF_RETURN_IF_ERROR(
+        control_flow_flattening.Run(test_module.module.get()).status());
+  }
+
+  TF_ASSIGN_OR_RETURN(std::vector<Literal> args,
+                      MakeArguments(test_module.module.get(), engine, options,
+                                    iteration_literals_proto));
+
+  // Compile once and keep the arguments on the device, so that the measured
+  // times do not include compilation or host-to-device transfers.
+  std::unique_ptr<Executable> executable;
+  if (options.use_buffer_assignment_from_proto) {
+    TF_ASSIGN_OR_RETURN(executable,
+                        test_runner->CreateExecutableWithBufferAssignment(
+                            std::move(test_module.module),
+                            &test_module.buffer_assignment_proto,
+                            options.run_test_hlo_passes));
+  } else {
+    TF_ASSIGN_OR_RETURN(
+        executable, test_runner->CreateExecutable(
+                        std::move(test_module.module),
+                        options.run_test_hlo_passes));
+  }
+  TF_ASSIGN_OR_RETURN(std::vector<ScopedShapedBuffer> device_args,
+                      test_runner->TransferLiteralsToDevice(args));
+
+  // The executable measures compute_time_ns itself: on GPU with a GpuTimer
+  // around the work enqueued on the device stream, which also hides the launch
+  // latency of the first kernel once a warmup run has been executed.
+  ExecutionProfile profile;
+  for (int i = 0; i < options.timed_replay_warmup_iterations; ++i) {
+    TF_RETURN_IF_ERROR(
+        test_runner->ExecuteWithDeviceBuffers(executable.get(), device_args,
+                                              &profile)
+            .status());
+    profile.set_warmup_run_executed(true);
+  }
+
+  std::vector<double> times_us;
+  times_us.reserve(options.timed_replay_iterations);
+  for (int i = 0; i < options.timed_replay_iterations; ++i) {
+    TF_RETURN_IF_ERROR(
+        test_runner->ExecuteWithDeviceBuffers(executable.get(), device_args,
+                                              &profile)
+            .status());
+    times_us.push_back(profile.compute_time_ns() / 1e3);
+  }
+
+  absl::c_sort(times_us);
+  double mean = 0;
+  for (double time : times_us) mean += time;
+  mean /= times_us.size();
+  double variance = 0;
+  for (double time : times_us) variance += (time - mean) * (time - mean);
+  variance /= std::max<size_t>(times_us.size() - 1, 1);
+  const double stddev = std::sqrt(variance);
+
+  std::cerr << absl::StrFormat(
+      "Timed replay of %s on %s, %d iterations: mean %.3fus, stddev %.3fus "
+      "(%.2f%%), min %.3fus, median %.3fus, max %.3fus\n",
+      hlo_filename, test_runner->Name(), times_us.size(), mean, stddev,
+      mean > 0 ? 100 * stddev / mean : 0, times_us.front(),
+      times_us[times_us.size() / 2], times_us.back());
+  return absl::OkStatus();
+}
+
 void ReadInputLiteralsFromFile(const std::string& file_path,
                                RunHloModuleLiterals* input_literals_proto) {
   if (!tsl::ReadTextOrBinaryProto(tsl::Env::Default(), file_path,
@@ -56,6 +56,8 @@ struct RunHloModuleOptions {
   bool random_init_input_literals{true};
   bool force_fake_data{false};
   bool isolate_instructions{false};
+  int timed_replay_iterations{0};
+  int timed_replay_warmup_iterations{1};
 };
 
 // Runs test_module on the platform with the name
@@ -92,6 +94,25 @@ absl::Status RunAndCompare(
                                HloModule& module)>
         compilation_env_modifier_hook = {});
 
+// Compiles the module in 'hlo_filename' once, transfers its arguments to the
+// device once and then executes it 'options.timed_replay_iterations' times
+// with the device-resident arguments after
+// 'options.timed_replay_warmup_iterations' untimed runs. Prints the mean,
+// standard deviation, min, median and max of the execution times measured by
+// the executable (with a GpuTimer on GPU), which exclude compilation and
+// transfers. Results are not compared against a reference. The arguments are
+// reused by all runs, so modules that alias outputs with inputs run on
+// different data each time.
+absl::Status RunTimedReplay(
+    const std::string& hlo_filename, HloRunner* test_runner,
+    std::minstd_rand0* engine, const RunHloModuleOptions& options,
+    const xla::RunHloModuleIterationLiterals* iteration_literals_proto =
+        nullptr,
+    std::function<void(HloModuleConfig*)> config_modifier_hook = {},
+    std::function<absl::Status(const RunHloModuleOptions& options,
+                               HloModule& module)>
+        compilation_env_modifier_hook = {});
+
 // Read the input literals from 'file_path'. The file can be either a binary
 // proto or a text proto. If it doesn't contain a RunHloModuleLiterals proto, it
 // will fallback to reading a RunHloModuleIterationLiterals proto and use that
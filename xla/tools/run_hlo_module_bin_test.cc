@@ -107,6 +107,17 @@ TEST_F(RunHloModuleTest, MustAliasWithSharding) {
               testing::Not(testing::HasSubstr("memory allocation bug")));
 }
 
+TEST_F(RunHloModuleTest, TimedReplay) {
+  RunHlo("add.hlo", {"--timed_replay_iterations=5"});
+
+  EXPECT_TRUE(exited_normally_);
+  EXPECT_EQ(exit_status_, 0);
+  EXPECT_THAT(stderr_output_,
+              testing::HasSubstr("on Host, 5 iterations: mean"));
+  EXPECT_THAT(stderr_output_,
+              testing::Not(testing::HasSubstr("Running HLO module")));
+}
+
 TEST_F(RunHloModuleTest, AddSnapshot) {
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
                           ParseAndReturnUnverifiedModule(R"(
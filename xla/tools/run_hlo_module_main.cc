@@ -22,6 +22,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "xla/debug_options_flags.h"
 #include "xla/service/hlo_module_config.h"
@@ -55,6 +56,13 @@ Usage:
 Multiple files can be run as well:
 
   bazel run run_hlo_module -- --platform=[CPU|CUDA|Interpreter] /path/*.hlo
+
+To compare the performance of a module between builds, --timed_replay_iterations
+compiles it once, keeps the inputs on the device and reports statistics of the
+device execution time of that many runs, without running the reference:
+
+  bazel run run_hlo_module -- --platform=CUDA --timed_replay_iterations=100 \
+    /path/module.hlo
 )";
 const char kInterpreterPlatformName[] = "Interpreter";
 
@@ -142,6 +150,14 @@ int main(int argc, char** argv) {
       tsl::Flag("different_random_seeds", &different_random_seeds,
                 "Whether each iteration should use a different random seed for "
                 "the HloModuleConfig."),
+      tsl::Flag("timed_replay_iterations", &opts.timed_replay_iterations,
+                "If positive, compile the module once, transfer the inputs to "
+                "the device once and print statistics of the execution time "
+                "of this many runs instead of comparing against the reference "
+                "platform."),
+      tsl::Flag("timed_replay_warmup_iterations",
+                &opts.timed_replay_warmup_iterations,
+                "Number of untimed runs before the timed replay."),
   };
   xla::AppendDebugOptionsFlags(&flag_list);
   // The usage string includes the message at the top of the file, the
@@ -191,6 +207,19 @@ int main(int argc, char** argv) {
                                 &input_literals_proto);
     }
 
+    if (opts.timed_replay_iterations > 0) {
+      absl::Status result = xla::RunTimedReplay(
+          hlo_filename, &test_runner, engine.get(), opts,
+          input_literals_proto.iterations().empty()
+              ? nullptr
+              : &input_literals_proto.iterations(0));
+      if (!result.ok()) {
+        failure_count++;
+        std::cerr << result << "\n";
+      }
+      continue;
+    }
+
     for (int i = 1; i <= iteration_count; ++i) {
       if (iteration_count != 1) {
         std::cerr << "\n=== Iteration " << i << "\n";
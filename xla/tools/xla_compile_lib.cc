@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "xla/tools/xla_compile_lib.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -23,12 +25,17 @@ limitations under the License.
 #include <vector>
 
 #include "google/protobuf/duration.pb.h"
+#include "absl/algorithm/container.h"
 #include "absl/cleanup/cleanup.h"
+#include "absl/container/btree_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
@@ -66,6 +73,8 @@ limitations under the License.
 #include "tsl/platform/status.h"
 #include "tsl/platform/status_to_from_proto.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
+#include "tsl/protobuf/error_codes.pb.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "xla/service/gpu/autotuner_util.h"
@@ -81,13 +90,26 @@ limitations under the License.
 
 namespace xla {
 
+// Copies the per-pass profile that compilation recorded in the metadata of
+// `module` to `result`.
+static void AddPassProfile(const HloModule& module, CompilationResult& result) {
+  CompilerPerfStats& perf_stats = *result.mutable_perf_stats();
+  *perf_stats.mutable_passes() = module.metadata().proto().pass_metadata();
+  int64_t peak_memory_bytes = 0;
+  for (const HloPassMetadata& pass : perf_stats.passes()) {
+    peak_memory_bytes = std::max(peak_memory_bytes, pass.peak_memory_bytes());
+  }
+  perf_stats.set_peak_memory_bytes(peak_memory_bytes);
+}
+
 static absl::StatusOr<std::string> AotCompileCpuExecutable(
-    std::unique_ptr<HloModule> hlo_module) {
+    std::unique_ptr<HloModule> hlo_module, CompilationResult& result) {
   cpu::CpuCompiler cpu_compiler;
   auto module_group = std::make_unique<HloModuleGroup>(std::move(hlo_module));
   TF_ASSIGN_OR_RETURN(
       std::vector<std::unique_ptr<Executable>> executables,
       cpu_compiler.Compile(std::move(module_group), {{nullptr}}, {nullptr}));
+  AddPassProfile(executables[0]->module(), result);
   TF_ASSIGN_OR_RETURN(std::unique_ptr<AotCompilationResult> aot_result,
                       cpu_compiler.Export(executables[0].get()));
   return aot_result->SerializeAsString();
@@ -121,6 +143,7 @@ static absl::StatusOr<std::string> CompileGpuExecutable(
                         aot_results[0]->SerializeAsString());
     *result.mutable_hlo_module() =
         aot_results[0]->optimized_module()->ToProto();
+    AddPassProfile(*aot_results[0]->optimized_module(), result);
     return compile_result;
   }
 
@@ -139,6 +162,7 @@ static absl::StatusOr<std::string> CompileGpuExecutable(
       gpu_compiler.Compile(std::move(module_group), {{stream_executor}},
                            compile_options));
   *result.mutable_hlo_module() = executables[0]->module().ToProto();
+  AddPassProfile(executables[0]->module(), result);
   return executables[0]->module().ToString();
 #else
   LOG(ERROR) << "Neither ROCm nor CUDA present; returning empty.";
@@ -151,7 +175,7 @@ absl::StatusOr<std::string> CompileExecutable(
     std::optional<Compiler::TargetConfig> target_config,
     CompilationResult& result) {
   if (backend == BackendType::kCpu) {
-    return AotCompileCpuExecutable(std::move(hlo_module));
+    return AotCompileCpuExecutable(std::move(hlo_module), result);
   }
   return CompileGpuExecutable(std::move(hlo_module), std::move(target_config),
                               result);
@@ -262,6 +286,23 @@ static std::unique_ptr<Compiler::TargetConfig> ReadTargetConfigFromModule(
   return nullptr;
 }
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+// Parses the text-format GpuTargetConfigProto at `path`.
+static absl::StatusOr<Compiler::TargetConfig> ReadGpuTargetConfig(
+    absl::string_view path) {
+  std::string gpu_target_config_string;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(
+      tsl::Env::Default(), std::string(path), &gpu_target_config_string));
+  stream_executor::GpuTargetConfigProto gpu_target_config_proto;
+
+  if (!tsl::protobuf::TextFormat::ParseFromString(gpu_target_config_string,
+                                                  &gpu_target_config_proto)) {
+    return FailedPrecondition("Failed to parse GpuTargetConfigProto");
+  }
+  return Compiler::TargetConfig(gpu_target_config_proto);
+}
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
 absl::Status XlaCompileMain(const XlaCompileOptions& options) {
   std::unique_ptr<HloModule> hlo_module;
   std::unique_ptr<Compiler::TargetConfig> target_config;
@@ -322,20 +363,10 @@ absl::Status XlaCompileMain(const XlaCompileOptions& options) {
     if (absl::string_view gpu_target_config_path =
             options.gpu_options.gpu_target_config_path;
         !gpu_target_config_path.empty()) {
-      // Parse GpuTargetConfig.
-      std::string gpu_target_config_string;
-      TF_RETURN_IF_ERROR(tsl::ReadFileToString(
-          tsl::Env::Default(), std::string(gpu_target_config_path),
-          &gpu_target_config_string));
-      stream_executor::GpuTargetConfigProto gpu_target_config_proto;
-
-      if (!tsl::protobuf::TextFormat::ParseFromString(
-              gpu_target_config_string, &gpu_target_config_proto)) {
-        return FailedPrecondition("Failed to parse GpuTargetConfigProto");
-      }
-
-      target_config =
-          std::make_unique<Compiler::TargetConfig>(gpu_target_config_proto);
+      TF_ASSIGN_OR_RETURN(Compiler::TargetConfig gpu_target_config,
+                          ReadGpuTargetConfig(gpu_target_config_path));
+      target_config = std::make_unique<Compiler::TargetConfig>(
+          std::move(gpu_target_config));
 
       if (absl::string_view autotune_results_path =
               options.gpu_options.autotune_results_path;
@@ -366,4 +397,278 @@ absl::Status XlaCompileMain(const XlaCompileOptions& options) {
   return absl::OkStatus();
 }
 
+static google::protobuf::Duration ToDurationProto(absl::Duration duration) {
+  absl::Duration remainder;
+  google::protobuf::Duration proto;
+  proto.set_seconds(absl::IDivDuration(duration, absl::Seconds(1), &remainder));
+  proto.set_nanos(absl::ToInt64Nanoseconds(remainder));
+  return proto;
+}
+
+static absl::Duration FromDurationProto(
+    const google::protobuf::Duration& proto) {
+  return absl::Seconds(proto.seconds()) + absl::Nanoseconds(proto.nanos());
+}
+
+// Expands the paths and glob patterns of the corpus into a list of files.
+static absl::StatusOr<std::vector<std::string>> ExpandCorpusPaths(
+    const std::vector<std::string>& patterns) {
+  std::vector<std::string> module_paths;
+  for (const std::string& pattern : patterns) {
+    std::vector<std::string> matches;
+    TF_RETURN_IF_ERROR(
+        tsl::Env::Default()->GetMatchingPaths(pattern, &matches));
+    if (matches.empty()) {
+      return absl::NotFoundError(
+          absl::StrCat("No modules match corpus path ", pattern));
+    }
+    absl::c_sort(matches);
+    module_paths.insert(module_paths.end(), matches.begin(), matches.end());
+  }
+  return module_paths;
+}
+
+absl::StatusOr<CorpusCompilationResult> XlaCompileCorpusMain(
+    const XlaCompileOptions& options) {
+  if (options.platform != "cpu" && options.platform != "gpu") {
+    return absl::UnimplementedError(
+        absl::StrCat("platform", options.platform, " is not supported"));
+  }
+
+  const BackendType backend =
+      (options.platform == "gpu" ? BackendType::kGpu : BackendType::kCpu);
+  const XlaCompileOptions::CorpusOptions& corpus_options =
+      options.corpus_options;
+
+  TF_ASSIGN_OR_RETURN(std::vector<std::string> module_paths,
+                      ExpandCorpusPaths(corpus_options.module_paths));
+
+  std::optional<Compiler::TargetConfig> target_config = std::nullopt;
+  if (backend == BackendType::kGpu &&
+      !options.gpu_options.use_attached_device) {
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+    if (options.gpu_options.gpu_target_config_path.empty()) {
+      return absl::InvalidArgumentError(
+          "Compiling a corpus for GPU requires either a GPU target config or "
+          "an attached device");
+    }
+    TF_ASSIGN_OR_RETURN(
+        target_config,
+        ReadGpuTargetConfig(options.gpu_options.gpu_target_config_path));
+    if (absl::string_view autotune_results_path =
+            options.gpu_options.autotune_results_path;
+        !autotune_results_path.empty()) {
+      TF_RETURN_IF_ERROR(gpu::AutotunerUtil::LoadAutotuneResultsFromFile(
+          autotune_results_path));
+    }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  }
+
+  // Module results are preallocated, so that concurrent compilations write to
+  // disjoint elements of the repeated field.
+  CorpusCompilationResult corpus_result;
+  for (const std::string& module_path : module_paths) {
+    corpus_result.add_modules()->set_module_path(module_path);
+  }
+
+  auto compile_module = [&](CorpusCompilationResult::ModuleResult* module) {
+    CompilationResult& result = *module->mutable_result();
+    absl::StatusOr<std::unique_ptr<HloModule>> hlo_module =
+        LoadModule(module->module_path());
+    if (!hlo_module.ok()) {
+      *result.mutable_status() = tsl::StatusToProto(hlo_module.status());
+      return;
+    }
+
+    absl::Time start = absl::Now();
+    absl::StatusOr<std::string> executable = CompileExecutable(
+        *std::move(hlo_module), backend, target_config, result);
+    absl::Duration duration = absl::Now() - start;
+
+    *result.mutable_status() = tsl::StatusToProto(executable.status());
+    *result.mutable_perf_stats()->mutable_compilation_duration() =
+        ToDurationProto(duration);
+    *result.mutable_perf_stats()->mutable_total_duration() =
+        ToDurationProto(duration);
+    // Optimized modules would dominate the size of the corpus result and are
+    // not needed for comparing compile times.
+    result.clear_hlo_module();
+
+    LOG(INFO) << "Compiled " << module->module_path() << " in "
+              << absl::FormatDuration(duration) << ": "
+              << executable.status();
+  };
+
+  if (corpus_options.num_threads > 1) {
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "xla_compile_corpus",
+                                 corpus_options.num_threads);
+    for (CorpusCompilationResult::ModuleResult& module :
+         *corpus_result.mutable_modules()) {
+      pool.Schedule([&compile_module, &module] { compile_module(&module); });
+    }
+  } else {
+    for (CorpusCompilationResult::ModuleResult& module :
+         *corpus_result.mutable_modules()) {
+      compile_module(&module);
+    }
+  }
+
+  int64_t num_failed = absl::c_count_if(
+      corpus_result.modules(),
+      [](const CorpusCompilationResult::ModuleResult& module) {
+        return module.result().status().code() != tensorflow::error::OK;
+      });
+  LOG(INFO) << "Compiled " << corpus_result.modules_size() - num_failed
+            << " of " << corpus_result.modules_size() << " modules";
+
+  if (!options.result_output_file.empty()) {
+    TF_RETURN_IF_ERROR(tsl::WriteBinaryProto(
+        tsl::Env::Default(), options.result_output_file, corpus_result));
+  }
+
+  if (!corpus_options.baseline_result_file.empty()) {
+    CorpusCompilationResult baseline;
+    TF_RETURN_IF_ERROR(tsl::ReadBinaryProto(
+        tsl::Env::Default(), corpus_options.baseline_result_file, &baseline));
+    LOG(INFO) << "Comparison to " << corpus_options.baseline_result_file
+              << ":\n"
+              << FormatCorpusComparison(baseline, corpus_result,
+                                        corpus_options.regression_threshold);
+  }
+
+  return corpus_result;
+}
+
+namespace {
+
+// Compile time and peak memory of a module or pass.
+struct CompileCost {
+  absl::Duration time;
+  int64_t peak_memory_bytes = 0;
+};
+
+// Successfully compiled modules of a corpus result by their path.
+absl::btree_map<std::string, const CompilationResult*> SucceededModules(
+    const CorpusCompilationResult& corpus_result) {
+  absl::btree_map<std::string, const CompilationResult*> modules;
+  for (const CorpusCompilationResult::ModuleResult& module :
+       corpus_result.modules()) {
+    if (module.result().status().code() == tensorflow::error::OK) {
+      modules[module.module_path()] = &module.result();
+    }
+  }
+  return modules;
+}
+
+// Adds the wall time of every pass of `result` to `passes`, keyed by the
+// pipeline and pass name.
+void AddPassTimes(const CompilationResult& result,
+                  absl::btree_map<std::string, absl::Duration>& passes) {
+  for (const HloPassMetadata& pass : result.perf_stats().passes()) {
+    passes[absl::StrCat(pass.pipeline_name(), "/", pass.pass_name())] +=
+        absl::Microseconds(pass.end_timestamp_usec() -
+                           pass.start_timestamp_usec());
+  }
+}
+
+double RelativeChange(double baseline, double value) {
+  return baseline > 0 ? (value - baseline) / baseline : 0;
+}
+
+std::string FormatChange(absl::Duration baseline, absl::Duration value) {
+  return absl::StrFormat(
+      "%s -> %s (%+.1f%%)", absl::FormatDuration(baseline),
+      absl::FormatDuration(value),
+      100 * RelativeChange(absl::ToDoubleSeconds(baseline),
+                           absl::ToDoubleSeconds(value)));
+}
+
+std::string FormatChange(int64_t baseline_bytes, int64_t bytes) {
+  return absl::StrFormat("%.1fMiB -> %.1fMiB (%+.1f%%)",
+                         baseline_bytes / 1048576.0, bytes / 1048576.0,
+                         100 * RelativeChange(baseline_bytes, bytes));
+}
+
+}  // namespace
+
+std::string FormatCorpusComparison(const CorpusCompilationResult& baseline,
+                                   const CorpusCompilationResult& result,
+                                   double regression_threshold) {
+  auto baseline_modules = SucceededModules(baseline);
+  auto modules = SucceededModules(result);
+
+  CompileCost baseline_total, total;
+  std::string module_regressions;
+  absl::btree_map<std::string, absl::Duration> baseline_passes, passes;
+  std::vector<std::string> only_in_baseline, only_in_result;
+
+  for (const auto& [path, baseline_module] : baseline_modules) {
+    auto it = modules.find(path);
+    if (it == modules.end()) {
+      only_in_baseline.push_back(path);
+      continue;
+    }
+    const CompilerPerfStats& baseline_stats = baseline_module->perf_stats();
+    const CompilerPerfStats& stats = it->second->perf_stats();
+
+    absl::Duration baseline_time =
+        FromDurationProto(baseline_stats.compilation_duration());
+    absl::Duration time = FromDurationProto(stats.compilation_duration());
+    baseline_total.time += baseline_time;
+    total.time += time;
+    baseline_total.peak_memory_bytes = std::max(
+        baseline_total.peak_memory_bytes, baseline_stats.peak_memory_bytes());
+    total.peak_memory_bytes =
+        std::max(total.peak_memory_bytes, stats.peak_memory_bytes());
+
+    if (RelativeChange(absl::ToDoubleSeconds(baseline_time),
+                       absl::ToDoubleSeconds(time)) > regression_threshold) {
+      absl::StrAppend(&module_regressions, "  ", path, ": ",
+                      FormatChange(baseline_time, time), ", peak memory ",
+                      FormatChange(baseline_stats.peak_memory_bytes(),
+                                   stats.peak_memory_bytes()),
+                      "\n");
+    }
+
+    AddPassTimes(*baseline_module, baseline_passes);
+    AddPassTimes(*it->second, passes);
+  }
+  for (const auto& [path, module] : modules) {
+    if (!baseline_modules.contains(path)) only_in_result.push_back(path);
+  }
+
+  std::string pass_regressions;
+  for (const auto& [pass, time] : passes) {
+    auto it = baseline_passes.find(pass);
+    absl::Duration baseline_time =
+        it == baseline_passes.end() ? absl::ZeroDuration() : it->second;
+    if (RelativeChange(absl::ToDoubleSeconds(baseline_time),
+                       absl::ToDoubleSeconds(time)) > regression_threshold) {
+      absl::StrAppend(&pass_regressions, "  ", pass, ": ",
+                      FormatChange(baseline_time, time), "\n");
+    }
+  }
+
+  std::string summary = absl::StrFormat(
+      "Modules compiled in both: %d\n"
+      "Total compile time: %s\n"
+      "Peak memory: %s\n",
+      modules.size() - only_in_result.size(),
+      FormatChange(baseline_total.time, total.time),
+      FormatChange(baseline_total.peak_memory_bytes, total.peak_memory_bytes));
+  absl::StrAppendFormat(&summary, "Module regressions above %.1f%%:\n%s",
+                        100 * regression_threshold, module_regressions);
+  absl::StrAppendFormat(&summary, "Pass regressions above %.1f%%:\n%s",
+                        100 * regression_threshold, pass_regressions);
+  if (!only_in_baseline.empty()) {
+    absl::StrAppend(&summary, "Failed or missing modules:\n  ",
+                    absl::StrJoin(only_in_baseline, "\n  "), "\n");
+  }
+  if (!only_in_result.empty()) {
+    absl::StrAppend(&summary, "Modules not compiled in the baseline:\n  ",
+                    absl::StrJoin(only_in_result, "\n  "), "\n");
+  }
+  return summary;
+}
+
 }  // namespace xla
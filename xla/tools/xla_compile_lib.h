@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -75,8 +76,24 @@ struct XlaCompileOptions {
     std::string autotune_results_path;
   };
 
+  // Options for compiling a corpus of modules, see XlaCompileCorpusMain.
+  struct CorpusOptions {
+    // Paths or glob patterns of the modules to compile.
+    std::vector<std::string> module_paths;
+    // Number of modules compiled concurrently. Peak memory is measured for
+    // the whole process, so it is only per-module when this is 1.
+    int num_threads = 1;
+    // Path to a CorpusCompilationResult written by a previous run, which the
+    // new results are compared against.
+    std::string baseline_result_file;
+    // Relative compile time increase above which a module or pass is
+    // reported as a regression.
+    double regression_threshold = 0.1;
+  };
+
   SymbolRepoOptions repo_options;
   GpuOptions gpu_options;
+  CorpusOptions corpus_options;
 };
 
 // Full entry point if you want to wrap a binary around this functionality. See
@@ -84,6 +101,26 @@ struct XlaCompileOptions {
 // correspond to fields in XlaCompileOptions.
 absl::Status XlaCompileMain(const XlaCompileOptions& compile_options);
 
+// Compiles every module in compile_options.corpus_options.module_paths and
+// records the compile time, per-pass profile and peak memory of each one in a
+// CorpusCompilationResult that is written to result_output_file. Compiled
+// executables are discarded. If a baseline result file is given, logs a
+// summary of the differences to it (see FormatCorpusComparison).
+//
+// For GPU the compilation is deviceless when gpu_target_config_path is set
+// (e.g. to one of the specs in xla/tools/hlo_opt/gpu_specs).
+absl::StatusOr<CorpusCompilationResult> XlaCompileCorpusMain(
+    const XlaCompileOptions& compile_options);
+
+// Returns a human-readable summary of the compile time and peak memory
+// differences between `baseline` and `result`: the total compile time of the
+// modules present in both, the modules and passes (summed over the corpus)
+// whose compile time grew by more than `regression_threshold`, and the
+// modules that only compile in one of them.
+std::string FormatCorpusComparison(const CorpusCompilationResult& baseline,
+                                   const CorpusCompilationResult& result,
+                                   double regression_threshold);
+
 }  // namespace xla
 
 #endif  // XLA_TOOLS_XLA_COMPILE_LIB_H_
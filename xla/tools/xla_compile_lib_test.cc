@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/tools/xla_compile_lib.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -26,6 +27,7 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo.pb.h"
 #include "xla/service/platform_util.h"
 #include "xla/service/symbol_repository.h"
 #include "xla/service/xla_compile_result.pb.h"
@@ -46,9 +48,12 @@ limitations under the License.
 namespace xla {
 namespace {
 
+using ::testing::Gt;
+using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::IsNull;
 using ::testing::Not;
+using ::testing::SizeIs;
 using ::tsl::testing::IsOk;
 using ::tsl::testing::IsOkAndHolds;
 using ::tsl::testing::StatusIs;
@@ -85,6 +90,7 @@ TEST_F(XlaCompileLibTest, DISABLED_ON_GPU(CompilesForCpu)) {
   EXPECT_THAT(CompileExecutable(std::move(module_), BackendType::kCpu,
                                 std::nullopt, result),
               IsOkAndHolds(Not(IsEmpty())));
+  EXPECT_THAT(result.perf_stats().passes(), Not(IsEmpty()));
 }
 
 TEST_F(XlaCompileLibTest, DISABLED_ON_CPU(CompilesForGpuWithDevice)) {
@@ -93,6 +99,7 @@ TEST_F(XlaCompileLibTest, DISABLED_ON_CPU(CompilesForGpuWithDevice)) {
                                 std::nullopt, result),
               IsOkAndHolds(Not(IsEmpty())));
   EXPECT_TRUE(result.has_hlo_module()) << result.DebugString();
+  EXPECT_THAT(result.perf_stats().passes(), Not(IsEmpty()));
 }
 
 TEST_F(XlaCompileLibTest, DISABLED_ON_CPU(CompilesForGpuWithoutDevice)) {
@@ -216,5 +223,103 @@ TEST_F(XlaCompileLibTest, DISABLED_ON_CPU(MainForGpu)) {
   EXPECT_EQ(result.status().code(), tensorflow::error::OK);
 }
 
+TEST_F(XlaCompileLibTest, DISABLED_ON_GPU(CorpusForCpu)) {
+  for (absl::string_view name : {"corpus_a.hlo", "corpus_b.hlo"}) {
+    TF_ASSERT_OK(tsl::WriteStringToFile(
+        tsl::Env::Default(), tsl::io::JoinPath(tsl::testing::TmpDir(), name),
+        module_->ToString()));
+  }
+  const std::string result_file =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "cpu_corpus_result.pb");
+
+  XlaCompileOptions options;
+  options.platform = "cpu";
+  options.result_output_file = result_file;
+  options.corpus_options.module_paths = {
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "corpus_*.hlo")};
+  options.corpus_options.num_threads = 2;
+  TF_ASSERT_OK_AND_ASSIGN(CorpusCompilationResult corpus_result,
+                          XlaCompileCorpusMain(options));
+
+  ASSERT_THAT(corpus_result.modules(), SizeIs(2));
+  for (const auto& module : corpus_result.modules()) {
+    EXPECT_EQ(module.result().status().code(), tensorflow::error::OK);
+    EXPECT_THAT(module.result().perf_stats().passes(), Not(IsEmpty()));
+    EXPECT_THAT(module.result().perf_stats().peak_memory_bytes(), Gt(0));
+    EXPECT_TRUE(module.result().perf_stats().has_compilation_duration());
+  }
+
+  CorpusCompilationResult written_result;
+  TF_ASSERT_OK(tsl::ReadBinaryProto(tsl::Env::Default(), result_file,
+                                    &written_result));
+  EXPECT_THAT(written_result.modules(), SizeIs(2));
+}
+
+TEST_F(XlaCompileLibTest, DISABLED_ON_CPU(CorpusForGpuWithoutDevice)) {
+  const std::string module_file =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "gpu_corpus.hlo");
+  TF_ASSERT_OK(tsl::WriteStringToFile(tsl::Env::Default(), module_file,
+                                      module_->ToString()));
+
+  XlaCompileOptions options;
+  options.platform = "gpu";
+  options.gpu_options.gpu_target_config_path =
+      tsl::io::JoinPath(tsl::testing::XlaSrcRoot(), "tools", "hlo_opt",
+                        "gpu_specs", "a100_80.txtpb");
+  options.corpus_options.module_paths = {module_file};
+  TF_ASSERT_OK_AND_ASSIGN(CorpusCompilationResult corpus_result,
+                          XlaCompileCorpusMain(options));
+
+  ASSERT_THAT(corpus_result.modules(), SizeIs(1));
+  EXPECT_EQ(corpus_result.modules(0).result().status().code(),
+            tensorflow::error::OK);
+  EXPECT_THAT(corpus_result.modules(0).result().perf_stats().passes(),
+              Not(IsEmpty()));
+}
+
+TEST_F(XlaCompileLibTest, CorpusErrorsOnMissingModules) {
+  XlaCompileOptions options;
+  options.platform = "cpu";
+  options.corpus_options.module_paths = {"/does/not/exist/*.hlo"};
+  EXPECT_THAT(XlaCompileCorpusMain(options), Not(IsOk()));
+}
+
+TEST_F(XlaCompileLibTest, FormatCorpusComparisonReportsRegressions) {
+  auto add_module = [](CorpusCompilationResult& corpus_result,
+                       absl::string_view path, int64_t seconds,
+                       int64_t pass_usec) {
+    auto* module = corpus_result.add_modules();
+    module->set_module_path(std::string(path));
+    CompilerPerfStats* stats = module->mutable_result()->mutable_perf_stats();
+    stats->mutable_compilation_duration()->set_seconds(seconds);
+    stats->set_peak_memory_bytes(1 << 20);
+    HloPassMetadata* pass = stats->add_passes();
+    pass->set_pipeline_name("pipeline");
+    pass->set_pass_name("slow-pass");
+    pass->set_start_timestamp_usec(0);
+    pass->set_end_timestamp_usec(pass_usec);
+  };
+
+  CorpusCompilationResult baseline, result;
+  add_module(baseline, "a.hlo", 10, 1000);
+  add_module(baseline, "b.hlo", 10, 1000);
+  add_module(baseline, "removed.hlo", 1, 1000);
+  add_module(result, "a.hlo", 10, 1000);
+  add_module(result, "b.hlo", 20, 5000);
+  add_module(result, "added.hlo", 1, 1000);
+
+  std::string summary = FormatCorpusComparison(baseline, result,
+                                               /*regression_threshold=*/0.1);
+  EXPECT_THAT(summary, HasSubstr("Modules compiled in both: 2"));
+  EXPECT_THAT(summary, HasSubstr("Total compile time: 20s -> 30s (+50.0%)"));
+  EXPECT_THAT(summary, HasSubstr("b.hlo: 10s -> 20s (+100.0%)"));
+  EXPECT_THAT(summary, Not(HasSubstr("a.hlo:")));
+  EXPECT_THAT(summary,
+              HasSubstr("pipeline/slow-pass: 2ms -> 6ms (+200.0%)"));
+  EXPECT_THAT(summary, HasSubstr("Failed or missing modules:\n  removed.hlo"));
+  EXPECT_THAT(summary,
+              HasSubstr("Modules not compiled in the baseline:\n  added.hlo"));
+}
+
 }  // namespace
 }  // namespace xla